@@ -0,0 +1,386 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "nav_msgs/msg/occupancy_grid.hpp"
+#include "nav2_amcl/angleutils.hpp"
+#include "nav2_amcl/map/map.hpp"
+#include "nav2_amcl/motion_model/differential_motion_model.hpp"
+#include "nav2_amcl/pf/pf.hpp"
+#include "nav2_amcl/sensors/laser/laser.hpp"
+#include "nav2_map_server/map_io.hpp"
+
+// A step of a recorded sequence: the odometry and ground truth poses of the robot when
+// its scan was taken
+struct Step
+{
+  pf_vector_t odom;
+  pf_vector_t truth;
+  double angle_min;
+  double angle_increment;
+  double range_max;
+  std::vector<double> ranges;
+};
+
+// Defaults of the AMCL node
+const double g_update_min_d = 0.25;
+const double g_update_min_a = 0.2;
+const double g_laser_likelihood_max_dist = 2.0;
+
+map_t * g_map = nullptr;
+std::vector<Step> g_steps;
+
+// Laser models benchmarked, by their laser_model_type
+const std::vector<std::string> g_laser_models = {
+  "beam", "beam_lut", "likelihood_field", "likelihood_field_prob"};
+
+map_t * convertMap(const nav_msgs::msg::OccupancyGrid & map_msg)
+{
+  map_t * map = map_alloc();
+  map->size_x = map_msg.info.width;
+  map->size_y = map_msg.info.height;
+  map->scale = map_msg.info.resolution;
+  map->origin_x = map_msg.info.origin.position.x + (map->size_x / 2) * map->scale;
+  map->origin_y = map_msg.info.origin.position.y + (map->size_y / 2) * map->scale;
+  map->cells =
+    reinterpret_cast<map_cell_t *>(malloc(sizeof(map_cell_t) * map->size_x * map->size_y));
+  for (int i = 0; i < map->size_x * map->size_y; i++) {
+    if (map_msg.data[i] == 0) {
+      map->cells[i].occ_state = -1;
+    } else if (map_msg.data[i] == 100) {
+      map->cells[i].occ_state = +1;
+    } else {
+      map->cells[i].occ_state = 0;
+    }
+  }
+  return map;
+}
+
+pf_vector_t getPose(double x, double y, double yaw)
+{
+  pf_vector_t pose = pf_vector_zero();
+  pose.v[0] = x;
+  pose.v[1] = y;
+  pose.v[2] = yaw;
+  return pose;
+}
+
+// Only drawn on recovery, which the benchmark disables
+pf_vector_t randomPose(void *)
+{
+  return pf_vector_zero();
+}
+
+// Read a sequence recorded one step per line as
+// odom_x odom_y odom_yaw truth_x truth_y truth_yaw angle_min angle_increment range_max
+// followed by the count of ranges and the ranges, with lines starting with # ignored
+bool readSteps(const std::string & path, std::vector<Step> & steps)
+{
+  std::ifstream file(path);
+  if (!file) {
+    return false;
+  }
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream values(line);
+    Step step;
+    unsigned int count;
+    values >> step.odom.v[0] >> step.odom.v[1] >> step.odom.v[2] >>
+    step.truth.v[0] >> step.truth.v[1] >> step.truth.v[2] >>
+    step.angle_min >> step.angle_increment >> step.range_max >> count;
+    step.ranges.resize(count);
+    for (auto & range : step.ranges) {
+      values >> range;
+    }
+    if (!values) {
+      std::cerr << "Malformed step: " << line << std::endl;
+      return false;
+    }
+    steps.push_back(step);
+  }
+  return !steps.empty();
+}
+
+// Simulate a sequence from a fixed seed, with the robot wandering through the free space
+// of the map at least clearance away from obstacles, noisy odometry and scans ray cast on
+// the map
+std::vector<Step> simulateSteps(map_t * map, unsigned int count, unsigned int seed)
+{
+  std::mt19937 generator(seed);
+  std::normal_distribution<double> noise(0.0, 1.0);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  const double clearance = 0.5;
+  const double step_length = 0.05;
+
+  auto isClear = [map, clearance](double x, double y) {
+      const int i = MAP_GXWX(map, x);
+      const int j = MAP_GYWY(map, y);
+      return MAP_VALID(map, i, j) && map->cells[MAP_INDEX(map, i, j)].occ_state == -1 &&
+             map->cells[MAP_INDEX(map, i, j)].occ_dist > clearance;
+    };
+
+  pf_vector_t truth;
+  do {
+    truth = getPose(
+      MAP_WXGX(map, uniform(generator) * map->size_x),
+      MAP_WYGY(map, uniform(generator) * map->size_y),
+      uniform(generator) * 2 * M_PI - M_PI);
+  } while (!isClear(truth.v[0], truth.v[1]));
+  pf_vector_t odom = pf_vector_zero();
+
+  std::vector<Step> steps;
+  for (unsigned int k = 0; k < count; k++) {
+    Step step;
+    step.odom = odom;
+    step.truth = truth;
+    step.angle_min = -M_PI;
+    step.angle_increment = 2 * M_PI / 360;
+    step.range_max = 12.0;
+    step.ranges.resize(360);
+    for (unsigned int i = 0; i < step.ranges.size(); i++) {
+      const double range = map_calc_range(
+        map, truth.v[0], truth.v[1], truth.v[2] + step.angle_min + i * step.angle_increment,
+        step.range_max);
+      step.ranges[i] = std::min(step.range_max, range + 0.01 * noise(generator));
+    }
+    steps.push_back(step);
+
+    // Turn away from the obstacles ahead, otherwise drift in heading
+    double turn = 0.05 * noise(generator);
+    for (int attempt = 0; attempt < 100; attempt++) {
+      const double yaw = truth.v[2] + turn;
+      if (isClear(truth.v[0] + 0.5 * cos(yaw), truth.v[1] + 0.5 * sin(yaw))) {
+        break;
+      }
+      turn = uniform(generator) * 2 * M_PI - M_PI;
+    }
+    const double length = isClear(
+      truth.v[0] + step_length * cos(truth.v[2] + turn),
+      truth.v[1] + step_length * sin(truth.v[2] + turn)) ? step_length : 0.0;
+
+    // The odometry integrates the motion with a few percents of error
+    truth.v[2] = nav2_amcl::angleutils::normalize(truth.v[2] + turn);
+    truth.v[0] += length * cos(truth.v[2]);
+    truth.v[1] += length * sin(truth.v[2]);
+    const double odom_turn = turn * (1.0 + 0.05 * noise(generator));
+    const double odom_length = length * (1.0 + 0.05 * noise(generator));
+    odom.v[2] = nav2_amcl::angleutils::normalize(odom.v[2] + odom_turn);
+    odom.v[0] += odom_length * cos(odom.v[2]);
+    odom.v[1] += odom_length * sin(odom.v[2]);
+  }
+  return steps;
+}
+
+nav2_amcl::Laser * createLaser(const std::string & type, int max_beams, map_t * map)
+{
+  if (type == "beam") {
+    return new nav2_amcl::BeamModel(0.5, 0.05, 0.05, 0.5, 0.2, 0.1, 0.0, max_beams, map);
+  } else if (type == "beam_lut") {
+    return new nav2_amcl::BeamModel(
+      0.5, 0.05, 0.05, 0.5, 0.2, 0.1, 0.0, max_beams, map, 360, 12.0);
+  } else if (type == "likelihood_field_prob") {
+    return new nav2_amcl::LikelihoodFieldModelProb(
+      0.5, 0.5, 0.2, g_laser_likelihood_max_dist, false, 0.5, 0.3, 0.9, max_beams, map);
+  }
+  return new nav2_amcl::LikelihoodFieldModel(
+    0.5, 0.5, 0.2, g_laser_likelihood_max_dist, max_beams, map);
+}
+
+// Replay the sequence through the filter as the AMCL node does, with its default
+// parameters, timing each stage of the filter updates
+void replay(benchmark::State & state, const std::string & laser_model)
+{
+  const int max_particles = state.range(0);
+  const int max_beams = state.range(1);
+  std::unique_ptr<nav2_amcl::Laser> laser(createLaser(laser_model, max_beams, g_map));
+  pf_vector_t laser_pose = pf_vector_zero();
+  laser->SetLaserPose(laser_pose);
+  nav2_amcl::DifferentialMotionModel motion_model;
+  motion_model.initialize(0.2, 0.2, 0.2, 0.2, 0.2);
+
+  using Clock = std::chrono::steady_clock;
+  Clock::duration motion_time{0}, sensor_time{0}, resample_time{0};
+  double updates = 0.0, position_error = 0.0, yaw_error = 0.0;
+
+  for (auto _ : state) {
+    srand48(0);
+    motion_model.setSeed(0);
+    pf_t * pf = pf_alloc(std::min(500, max_particles), max_particles, 0.0, 0.0, randomPose);
+    pf_matrix_t cov = pf_matrix_zero();
+    cov.m[0][0] = 0.5 * 0.5;
+    cov.m[1][1] = 0.5 * 0.5;
+    cov.m[2][2] = (M_PI / 12.0) * (M_PI / 12.0);
+    pf_init(pf, g_steps.front().truth, cov);
+
+    pf_vector_t pf_odom_pose = g_steps.front().odom;
+    bool first = true;
+    for (const Step & step : g_steps) {
+      pf_vector_t delta;
+      delta.v[0] = step.odom.v[0] - pf_odom_pose.v[0];
+      delta.v[1] = step.odom.v[1] - pf_odom_pose.v[1];
+      delta.v[2] = nav2_amcl::angleutils::angle_diff(step.odom.v[2], pf_odom_pose.v[2]);
+      if (!first && fabs(delta.v[0]) <= g_update_min_d && fabs(delta.v[1]) <= g_update_min_d &&
+        fabs(delta.v[2]) <= g_update_min_a)
+      {
+        continue;
+      }
+
+      auto start = Clock::now();
+      if (!first) {
+        motion_model.odometryUpdate(pf, step.odom, delta);
+      }
+      auto end = Clock::now();
+      motion_time += end - start;
+      first = false;
+      pf_odom_pose = step.odom;
+
+      nav2_amcl::LaserData data;
+      data.laser = laser.get();
+      data.range_count = step.ranges.size();
+      data.range_max = step.range_max;
+      data.ranges = new double[data.range_count][2];
+      for (int i = 0; i < data.range_count; i++) {
+        data.ranges[i][0] = step.ranges[i];
+        data.ranges[i][1] = step.angle_min + i * step.angle_increment;
+      }
+      start = Clock::now();
+      laser->sensorUpdate(pf, &data);
+      end = Clock::now();
+      sensor_time += end - start;
+
+      start = Clock::now();
+      pf_update_resample(pf, g_map);
+      end = Clock::now();
+      resample_time += end - start;
+
+      // Error of the mean of the heaviest cluster
+      double max_weight = -1.0;
+      pf_vector_t estimate = pf_vector_zero();
+      for (int i = 0; i < pf->sets[pf->current_set].cluster_count; i++) {
+        double weight;
+        pf_vector_t mean;
+        pf_matrix_t cluster_cov;
+        if (pf_get_cluster_stats(pf, i, &weight, &mean, &cluster_cov) && weight > max_weight) {
+          max_weight = weight;
+          estimate = mean;
+        }
+      }
+      position_error += std::hypot(
+        estimate.v[0] - step.truth.v[0], estimate.v[1] - step.truth.v[1]);
+      yaw_error += fabs(nav2_amcl::angleutils::angle_diff(estimate.v[2], step.truth.v[2]));
+      updates += 1.0;
+    }
+    pf_free(pf);
+  }
+
+  auto toMs = [updates](Clock::duration duration) {
+      return std::chrono::duration<double, std::milli>(duration).count() / updates;
+    };
+  state.counters["update_hz"] = benchmark::Counter(updates, benchmark::Counter::kIsRate);
+  state.counters["motion_ms"] = toMs(motion_time);
+  state.counters["sensor_ms"] = toMs(sensor_time);
+  state.counters["resample_ms"] = toMs(resample_time);
+  state.counters["error_m"] = position_error / updates;
+  state.counters["error_rad"] = yaw_error / updates;
+}
+
+// Flags of the benchmark, after those of google-benchmark
+struct Options
+{
+  std::string map_yaml;
+  std::string log;
+  unsigned int steps = 1000;
+  unsigned int seed = 0;
+};
+
+bool parseOptions(int argc, char ** argv, Options & options)
+{
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    const auto value = arg.substr(arg.find('=') + 1);
+    if (arg.rfind("--map=", 0) == 0) {
+      options.map_yaml = value;
+    } else if (arg.rfind("--log=", 0) == 0) {
+      options.log = value;
+    } else if (arg.rfind("--steps=", 0) == 0) {
+      options.steps = std::stoul(value);
+    } else if (arg.rfind("--seed=", 0) == 0) {
+      options.seed = std::stoul(value);
+    } else {
+      std::cerr << "Unknown argument: " << arg << std::endl;
+      return false;
+    }
+  }
+  return !options.map_yaml.empty();
+}
+
+int main(int argc, char ** argv)
+{
+  benchmark::Initialize(&argc, argv);
+  Options options;
+  if (!parseOptions(argc, argv, options)) {
+    std::cerr << "Usage: " << argv[0] << " --map=<map yaml> [--log=<recorded sequence>]"
+      " [--steps=1000] [--seed=0] [google-benchmark flags]" << std::endl;
+    return 1;
+  }
+
+  nav_msgs::msg::OccupancyGrid map;
+  if (nav2_map_server::loadMapFromYaml(options.map_yaml, map) !=
+    nav2_map_server::LOAD_MAP_SUCCESS)
+  {
+    std::cerr << "Failed to load map " << options.map_yaml << std::endl;
+    return 1;
+  }
+  g_map = convertMap(map);
+  map_update_cspace(g_map, g_laser_likelihood_max_dist);
+
+  if (!options.log.empty()) {
+    if (!readSteps(options.log, g_steps)) {
+      std::cerr << "Failed to read sequence " << options.log << std::endl;
+      return 1;
+    }
+  } else {
+    g_steps = simulateSteps(g_map, options.steps, options.seed);
+  }
+
+  for (const auto & laser_model : g_laser_models) {
+    benchmark::RegisterBenchmark(
+      laser_model.c_str(),
+      [laser_model](benchmark::State & state) {replay(state, laser_model);})
+    ->ArgNames({"max_particles", "max_beams"})
+    ->ArgsProduct({{500, 2000, 5000}, {30, 60}})
+    ->Unit(benchmark::kMillisecond);
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+
+  map_free(g_map);
+  return 0;
+}
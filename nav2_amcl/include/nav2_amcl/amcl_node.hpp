@@ -31,10 +31,13 @@
 #include "geometry_msgs/msg/pose_stamped.hpp"
 #include "message_filters/subscriber.h"
 #include "nav2_util/lifecycle_node.hpp"
+#include "nav2_util/memory_registry.hpp"
 #include "nav2_amcl/motion_model/motion_model.hpp"
+#include "nav2_amcl/scan_matcher/correlative_scan_matcher.hpp"
 #include "nav2_amcl/sensors/laser/laser.hpp"
 #include "nav2_msgs/msg/particle.hpp"
 #include "nav2_msgs/msg/particle_cloud.hpp"
+#include "nav2_msgs/msg/particle_filter_statistics.hpp"
 #include "nav2_msgs/srv/set_initial_pose.hpp"
 #include "nav_msgs/srv/set_map.hpp"
 #include "sensor_msgs/msg/laser_scan.hpp"
@@ -132,14 +135,26 @@ protected:
    */
   void handleMapMessage(const nav_msgs::msg::OccupancyGrid & msg);
   /*
-   * @brief Creates lookup table of free cells in map
+   * @brief Creates lookup table of free cells in map, as runs of free cells along its rows
+   * @param map Map to index
    */
-  void createFreeSpaceVector();
+  static void createFreeSpaceIndex(map_t * map);
+  /*
+   * @brief Clears the lookup table of free cells, to be created again from the next map
+   * it samples
+   */
+  static void clearFreeSpaceIndex();
   /*
    * @brief Frees allocated map related memory
    */
   void freeMapDependentMemory();
+  /*
+   * @brief Accounts for the bytes of the cells and range lookup table of the map in the
+   * nav2_util::MemoryRegistry
+   */
+  void updateMapMemory();
   map_t * map_{nullptr};
+  nav2_util::MemoryTracker map_memory_{"amcl/map"};
   /*
    * @brief Convert an occupancy grid map to an AMCL map
    * @param map_msg Map message
@@ -152,8 +167,16 @@ protected:
   std::recursive_mutex mutex_;
   rclcpp::Subscription<nav_msgs::msg::OccupancyGrid>::ConstSharedPtr map_sub_;
 #if NEW_UNIFORM_SAMPLING
-  struct Point2D { int32_t x; int32_t y; };
-  static std::vector<Point2D> free_space_indices;
+  // A run of free cells along a row, sampled every free_space_delta cells
+  struct FreeSpaceRun { int32_t x; int32_t y; int32_t count; };
+  // The runs of free cells, with the number of cells up to the end of each run for uniform
+  // sampling by binary search. They are only created when a pose is first sampled from a map,
+  // as most maps are never used for global localization or random particles
+  static std::vector<FreeSpaceRun> free_space_runs;
+  static std::vector<int64_t> free_space_counts;
+  static map_t * free_space_map;
+  static int free_space_delta;
+  static nav2_util::MemoryTracker free_space_memory;
 #endif
 
   // Transforms
@@ -189,6 +212,8 @@ protected:
     pose_pub_;
   rclcpp_lifecycle::LifecyclePublisher<nav2_msgs::msg::ParticleCloud>::SharedPtr
     particle_cloud_pub_;
+  rclcpp_lifecycle::LifecyclePublisher<nav2_msgs::msg::ParticleFilterStatistics>::SharedPtr
+    statistics_pub_;
   /*
    * @brief Handle with an initial pose estimate is received
    */
@@ -266,6 +291,11 @@ protected:
    * @brief Pose-generating function used to uniformly distribute particles over the map
    */
   static pf_vector_t uniformPoseGenerator(void * arg);
+  /*
+   * @brief Pose-generating function used to distribute particles around scan matches,
+   * drawing each match in proportion to its score
+   */
+  static pf_vector_t scanMatchPoseGenerator(void * arg);
   pf_t * pf_{nullptr};
   bool pf_init_;
   pf_vector_t pf_odom_pose_;
@@ -284,7 +314,17 @@ protected:
   std::vector<nav2_amcl::Laser *> lasers_;
   std::vector<bool> lasers_update_;
   std::map<std::string, int> frame_to_laser_;
+  std::vector<sensor_msgs::msg::LaserScan::ConstSharedPtr> fused_scans_;
   rclcpp::Time last_laser_received_ts_;
+  sensor_msgs::msg::LaserScan::ConstSharedPtr last_laser_scan_;
+  int last_laser_index_{-1};
+
+  // Scan matching of the global localization
+  /*
+   * @brief Find the poses at which the last scan matches the map best
+   */
+  std::vector<nav2_amcl::ScanMatch> matchLastScan();
+  std::unique_ptr<nav2_amcl::CorrelativeScanMatcher> scan_matcher_;
 
   /*
    * @brief Check if sufficient time has elapsed to get an update
@@ -311,7 +351,27 @@ protected:
     const sensor_msgs::msg::LaserScan::ConstSharedPtr & laser_scan,
     const pf_vector_t & pose);
   /*
-   * @brief Publish particle cloud
+   * @brief Update the PF in a single sensor update with the fused scans of all lasers
+   */
+  bool updateFilterFused(const pf_vector_t & pose);
+  /*
+   * @brief Keep a scan to fuse, returning whether all lasers have a scan within the
+   * fusion tolerance of it
+   */
+  bool fuseScan(
+    const int & laser_index,
+    const sensor_msgs::msg::LaserScan::ConstSharedPtr & laser_scan);
+  /*
+   * @brief Convert a scan into the laser data of its sensor model
+   */
+  bool getLaserData(
+    const int & laser_index,
+    const sensor_msgs::msg::LaserScan::ConstSharedPtr & laser_scan,
+    nav2_amcl::LaserData & ldata);
+  /*
+   * @brief Publish particle cloud, at most at particle_cloud_rate_, as the particles
+   * decimated to particle_cloud_max_particles_ or as their clusters
+   * @param set Sample set of the filter
    */
   void publishParticleCloud(const pf_sample_set_t * set);
   /*
@@ -360,20 +420,29 @@ protected:
   double alpha4_;
   double alpha5_;
   std::string base_frame_id_;
+  int beam_range_lut_angles_;
   double beam_skip_distance_;
   double beam_skip_error_threshold_;
   double beam_skip_threshold_;
   bool do_beamskip_;
+  bool adaptive_beam_selection_;
   std::string global_frame_id_;
+  bool global_localization_scan_matching_;
   double lambda_short_;
   double laser_likelihood_max_dist_;
+  double laser_fusion_tolerance_;
   double laser_max_range_;
   double laser_min_range_;
   std::string sensor_model_type_;
   int max_beams_;
   int max_particles_;
   int min_particles_;
+  int motion_model_threads_;
   std::string odom_frame_id_;
+  bool particle_cloud_clusters_;
+  int particle_cloud_max_particles_;
+  double particle_cloud_rate_;
+  rclcpp::Time last_particle_cloud_time_{0, 0, RCL_ROS_TIME};
   double pf_err_;
   double pf_z_;
   double alpha_fast_;
@@ -381,6 +450,10 @@ protected:
   int resample_interval_;
   std::string robot_model_type_;
   tf2::Duration save_pose_period_;
+  int scan_matching_max_candidates_;
+  double scan_matching_min_score_;
+  int sensor_model_parallel_particles_;
+  int sensor_model_threads_;
   double sigma_hit_;
   bool tf_broadcast_;
   tf2::Duration transform_tolerance_;
@@ -75,6 +75,14 @@ typedef struct
   // Max distance at which we care about obstacles, for constructing
   // likelihood field
   double max_occ_dist;
+
+  // Ranges from the center of each free cell in a number of evenly spaced
+  // directions, in eighths of a cell, for the beam model. The index gives the
+  // row of each cell in the table, -1 for cells which are not free.
+  int range_lut_angles;
+  double range_lut_max_range;
+  int32_t * range_lut_index;
+  uint16_t * range_lut;
 } map_t;
 
 
@@ -99,6 +107,13 @@ void map_update_cspace(map_t * map, double max_occ_dist);
 // Extract a single range reading from the map
 double map_calc_range(map_t * map, double ox, double oy, double oa, double max_range);
 
+// Precompute the ranges from the free cells in a number of directions, 0 to clear them
+void map_update_range_lut(map_t * map, int num_angles, double max_range);
+
+// Extract a single range reading from the precomputed ranges, at the closest
+// direction, or from the map if they do not cover it
+double map_lookup_range(map_t * map, double ox, double oy, double oa, double max_range);
+
 
 /**************************************************************************
  * GUI/diagnostic functions
@@ -17,9 +17,14 @@
 #ifndef NAV2_AMCL__MOTION_MODEL__MOTION_MODEL_HPP_
 #define NAV2_AMCL__MOTION_MODEL__MOTION_MODEL_HPP_
 
+#include <algorithm>
+#include <random>
 #include <string>
 #include <memory>
+#include <thread>
+#include <vector>
 
+#include "nav2_amcl/motion_model/sample_noise.hpp"
 #include "nav2_amcl/pf/pf.hpp"
 #include "nav2_amcl/pf/pf_pdf.hpp"
 
@@ -33,6 +38,11 @@ namespace nav2_amcl
 class MotionModel
 {
 public:
+  MotionModel()
+  {
+    noise_.seed(std::random_device{}());
+  }
+
   virtual ~MotionModel() = default;
 
   /**
@@ -56,6 +66,57 @@ public:
    * @param delta change in pose in odometry update
    */
   virtual void odometryUpdate(pf_t * pf, const pf_vector_t & pose, const pf_vector_t & delta) = 0;
+
+  /**
+   * @brief Set the number of threads sampling the motion of the samples
+   * @param threads Number of threads
+   */
+  void setThreads(int threads)
+  {
+    threads_ = std::max(threads, 1);
+  }
+
+  /**
+   * @brief Seed the motion noise, so that the same updates give the same samples
+   * @param seed Seed
+   */
+  void setSeed(uint64_t seed)
+  {
+    noise_.seed(seed);
+  }
+
+protected:
+  /**
+   * @brief Update the samples of a set with the noise of a new update, in contiguous
+   * chunks across the threads when there are enough samples to pay for them
+   * @param set Sample set to update
+   * @param update Function updating the samples of indices [begin, end)
+   */
+  template<typename UpdateT>
+  void updateSamples(pf_sample_set_t * set, UpdateT update)
+  {
+    noise_.nextUpdate();
+    const int threads = std::min(threads_, set->sample_count / MIN_SAMPLES_PER_THREAD + 1);
+    if (threads == 1) {
+      update(0, set->sample_count);
+      return;
+    }
+
+    std::vector<std::thread> workers;
+    const int chunk = (set->sample_count + threads - 1) / threads;
+    for (int t = 1; t < threads; t++) {
+      workers.emplace_back(update, t * chunk, std::min((t + 1) * chunk, set->sample_count));
+    }
+    update(0, std::min(chunk, set->sample_count));
+    for (auto & worker : workers) {
+      worker.join();
+    }
+  }
+
+  static constexpr int MIN_SAMPLES_PER_THREAD = 1000;
+
+  SampleNoise noise_;
+  int threads_{1};
 };
 }  // namespace nav2_amcl
 
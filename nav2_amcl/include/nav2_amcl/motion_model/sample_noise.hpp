@@ -0,0 +1,94 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_AMCL__MOTION_MODEL__SAMPLE_NOISE_HPP_
+#define NAV2_AMCL__MOTION_MODEL__SAMPLE_NOISE_HPP_
+
+#include <math.h>
+#include <stdint.h>
+
+namespace nav2_amcl
+{
+
+/**
+ * @class nav2_amcl::SampleNoise
+ * @brief Counter-based generator of standard normal noise for the samples of a filter.
+ * The noise of a sample is a pure function of the seed, the update and the sample's
+ * index, without any shared state, so the samples can be updated in any order across
+ * threads and a seed reproduces the same noise whatever the number of threads.
+ */
+class SampleNoise
+{
+public:
+  /**
+   * @brief Set the seed of the noise and restart from the first update
+   * @param seed Seed
+   */
+  void seed(uint64_t seed)
+  {
+    seed_ = seed;
+    update_ = 0;
+  }
+
+  /**
+   * @brief Move on to the noise of the next update
+   */
+  void nextUpdate() {update_++;}
+
+  /**
+   * @brief Get a pair of independent standard normal values of a sample
+   * @param sample Index of the sample
+   * @param pair Index of the pair among those of the sample in the update
+   * @param n1 First value
+   * @param n2 Second value
+   */
+  inline void normals(uint64_t sample, uint64_t pair, double & n1, double & n2) const
+  {
+    // Box-Muller transform of two uniforms, without the rejection loop of its polar form
+    const uint64_t counter = mix(seed_ ^ mix(update_ ^ mix(sample * 4 + pair)));
+    const double u1 = toUniform(counter);
+    const double u2 = toUniform(mix(counter));
+    const double radius = sqrt(-2.0 * log(u1));
+    const double angle = 2.0 * M_PI * u2;
+    n1 = radius * cos(angle);
+    n2 = radius * sin(angle);
+  }
+
+protected:
+  /**
+   * @brief SplitMix64 finalizer, mixing the bits of a counter into a random value
+   */
+  static inline uint64_t mix(uint64_t x)
+  {
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+  }
+
+  /**
+   * @brief Uniform value in (0, 1] from the upper 53 bits of a random value
+   */
+  static inline double toUniform(uint64_t x)
+  {
+    return (static_cast<double>(x >> 11) + 1.0) * (1.0 / 9007199254740992.0);
+  }
+
+  uint64_t seed_{0};
+  uint64_t update_{0};
+};
+
+}  // namespace nav2_amcl
+
+#endif  // NAV2_AMCL__MOTION_MODEL__SAMPLE_NOISE_HPP_
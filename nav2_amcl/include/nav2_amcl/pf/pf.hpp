@@ -121,6 +121,9 @@ typedef struct _pf_t
   int current_set;
   pf_sample_set_t sets[2];
 
+  // Indices of the samples drawn by the resampler, preallocated for max_samples
+  int * resample_indices;
+
   // Running averages, slow and fast, of likelihood
   double w_slow, w_fast;
 
@@ -33,15 +33,11 @@
 #endif
 
 
-// Info for a node in the tree
+// Info for a bin of the histogram
 typedef struct pf_kdtree_node
 {
-  // Depth in the tree
-  int leaf, depth;
-
-  // Pivot dimension and value
-  int pivot_dim;
-  double pivot_value;
+  // Kept for the drawing code; all bins are leaves
+  int leaf;
 
   // The key for this node
   int key[3];
@@ -51,20 +47,20 @@ typedef struct pf_kdtree_node
 
   // The cluster label (leaf nodes)
   int cluster;
-
-  // Child nodes
-  struct pf_kdtree_node * children[2];
 } pf_kdtree_node_t;
 
 
-// A kd tree
+// A histogram of the poses into a fixed bin size, hashed into a flat table. It keeps the
+// name and interface of the kd tree it replaces.
 typedef struct
 {
   // Cell size
   double size[3];
 
-  // The root node of the tree
-  pf_kdtree_node_t * root;
+  // Open addressing table of the bins, storing their index plus one, 0 for empty slots.
+  // Its size is a power of two
+  int table_size;
+  int * table;
 
   // The number of nodes in the tree
   int node_count, node_max_count;
@@ -72,6 +68,9 @@ typedef struct
 
   // The number of leaf nodes in the tree
   int leaf_count;
+
+  // Workspace of the clustering
+  int * stack;
 } pf_kdtree_t;
 
 
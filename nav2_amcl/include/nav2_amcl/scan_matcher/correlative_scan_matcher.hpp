@@ -0,0 +1,156 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_AMCL__SCAN_MATCHER__CORRELATIVE_SCAN_MATCHER_HPP_
+#define NAV2_AMCL__SCAN_MATCHER__CORRELATIVE_SCAN_MATCHER_HPP_
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "nav2_amcl/map/map.hpp"
+#include "nav2_amcl/pf/pf_vector.hpp"
+
+namespace nav2_amcl
+{
+
+/**
+ * @struct nav2_amcl::ScanMatch
+ * @brief Pose at which a scan matches the map
+ */
+struct ScanMatch
+{
+  pf_vector_t pose;  ///< Pose of the scan's frame in the map
+  double score;  ///< Mean likelihood of the scan's points at the pose, in [0, 1]
+};
+
+/**
+ * @class nav2_amcl::CorrelativeScanMatcher
+ * @brief Global scan matcher finding the poses of the map's free space where a scan
+ * matches best, by branch and bound over a pyramid of the map's likelihood field
+ * (Hess et al., Real-Time Loop Closure in 2D LIDAR SLAM). Level k of the pyramid holds
+ * the maximum likelihood over windows of 2^k x 2^k cells, so the score of a scan over
+ * a level k window of translations bounds that of each of them, and only the windows
+ * which may beat the best matches found are split down to single cells.
+ */
+class CorrelativeScanMatcher
+{
+public:
+  /**
+   * @brief Build the likelihood pyramid of a map
+   * @param map Map to match scans against, which must outlive the matcher's use of it.
+   * Its obstacle distances are computed if no laser model did so.
+   * @param sigma Standard deviation of the likelihood of a point around obstacles (m)
+   * @param depth Number of levels above the cells, the coarsest of 2^depth cells a side
+   */
+  void setMap(map_t * map, double sigma, int depth = 6);
+
+  /**
+   * @brief Whether a map has been set
+   * @return bool If initialized
+   */
+  bool isInitialized() const {return map_ != nullptr;}
+
+  /**
+   * @brief Find the best matches of a scan in the free space of the map
+   * @param points Points of the scan, in its frame (m)
+   * @param max_matches Maximum number of matches to find
+   * @param min_score Minimum score of the matches
+   * @param min_separation Minimum distance between the positions of matches of similar
+   * headings (m), below which only the best one is kept
+   * @return Matches, best first
+   */
+  std::vector<ScanMatch> match(
+    const std::vector<pf_vector_t> & points, int max_matches, double min_score,
+    double min_separation) const;
+
+protected:
+  /**
+   * @brief Maximum likelihoods of a level of the pyramid, padded on their lower side so
+   * that the windows of translations partly out of the map are covered
+   */
+  struct Level
+  {
+    int padding{0};
+    int size_x{0}, size_y{0};
+    std::vector<uint8_t> likelihoods;
+
+    /**
+     * @brief Maximum likelihood of the window of a cell, 0 outside of those stored
+     * @param x X of the lowest cell of the window
+     * @param y Y of the lowest cell of the window
+     * @return Maximum likelihood
+     */
+    inline int likelihood(int x, int y) const
+    {
+      x += padding;
+      y += padding;
+      if (x < 0 || y < 0 || x >= size_x || y >= size_y) {
+        return 0;
+      }
+      return likelihoods[x + y * size_x];
+    }
+  };
+
+  /**
+   * @brief Scan points rotated to a heading, as offsets in cells
+   */
+  struct RotatedScan
+  {
+    double yaw;
+    std::vector<int> offset_x, offset_y;
+  };
+
+  /**
+   * @brief Window of 2^level x 2^level translations of a rotated scan
+   */
+  struct Candidate
+  {
+    int scan;
+    int x, y;
+    int score;
+  };
+
+  /**
+   * @brief Sum of the likelihoods of a scan over a level, at a window of translations
+   * @param level Level of the pyramid
+   * @param scan Rotated scan
+   * @param x Lowest x cell of the window
+   * @param y Lowest y cell of the window
+   * @return Score bounding those of the translations in the window
+   */
+  int score(const Level & level, const RotatedScan & scan, int x, int y) const;
+
+  /**
+   * @brief Split candidates down to single cells, keeping the best matches
+   * @param scans Rotated scans
+   * @param candidates Candidates of a level, best first
+   * @param level Level of the candidates
+   * @param min_score Minimum score of a match, in likelihood units
+   * @param max_matches Maximum number of matches
+   * @param min_separation Minimum distance between matches, in cells
+   * @param matches Matches found so far, best first
+   */
+  void search(
+    const std::vector<RotatedScan> & scans, const std::vector<Candidate> & candidates,
+    int level, int min_score, int max_matches, double min_separation,
+    std::vector<Candidate> & matches) const;
+
+  map_t * map_{nullptr};
+  std::vector<Level> levels_;
+};
+
+}  // namespace nav2_amcl
+
+#endif  // NAV2_AMCL__SCAN_MATCHER__CORRELATIVE_SCAN_MATCHER_HPP_
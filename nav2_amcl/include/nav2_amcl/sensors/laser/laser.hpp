@@ -18,7 +18,11 @@
 #ifndef NAV2_AMCL__SENSORS__LASER__LASER_HPP_
 #define NAV2_AMCL__SENSORS__LASER__LASER_HPP_
 
+#include <cmath>
+#include <cstdint>
+#include <functional>
 #include <string>
+#include <vector>
 #include "nav2_amcl/pf/pf.hpp"
 #include "nav2_amcl/pf/pf_pdf.hpp"
 #include "nav2_amcl/map/map.hpp"
@@ -56,13 +60,149 @@ public:
    */
   virtual bool sensorUpdate(pf_t * pf, LaserData * data) = 0;
 
+  /*
+   * @brief Run a single sensor update on the scans of several lasers, multiplying the
+   * weights of their models before normalizing them once
+   * @param pf Particle filter to use
+   * @param data Laser data of each scan, pointing to the laser of the scan
+   * @return if it was succesful, if any of the lasers could update
+   */
+  static bool fusedSensorUpdate(pf_t * pf, const std::vector<LaserData *> & data);
+
   /*
    * @brief Set the laser pose from an update
    * @param laser_pose Pose of the laser
    */
   void SetLaserPose(pf_vector_t & laser_pose);
 
+  /*
+   * @brief Get the laser pose in the base frame
+   * @return Laser pose
+   */
+  const pf_vector_t & GetLaserPose() const {return laser_pose_;}
+
+  /*
+   * @brief Set the number of threads weighing the samples on a sensor update
+   * @param threads Number of threads
+   */
+  void SetThreads(int threads);
+
+  /*
+   * @brief Set the number of samples from which a sensor update weighs them across all
+   * of the hardware threads, such as after a global localization spreads many particles
+   * @param parallel_particles Number of samples, 0 to only use the threads set
+   */
+  void SetParallelParticles(int parallel_particles);
+
+  /*
+   * @brief Set whether the beams used are selected by the spread of their endpoints,
+   * rather than at a fixed step through the scan
+   * @param adaptive_beam_selection Whether to select the beams adaptively
+   */
+  void SetAdaptiveBeamSelection(bool adaptive_beam_selection);
+
 protected:
+  /*
+   * @brief Multiply the weights of the samples by the model's likelihood of a scan
+   * @param data Laser data to use
+   * @param set Sample set to weigh
+   * @return Total weight of the samples
+   */
+  virtual double applySensorModel(LaserData * data, pf_sample_set_t * set) = 0;
+
+  /*
+   * @brief Sensor function of a fused update, applying the model of each scan in turn
+   * @param data Laser data of each scan, as a std::vector<LaserData *>
+   * @param set Sample set to weigh
+   * @return Total weight of the samples
+   */
+  static double fusedSensorFunction(void * data, pf_sample_set_t * set);
+
+  /*
+   * @brief A beam of a scan used for the update, with its endpoint relative to the laser
+   * rotated into the frame of the robot
+   */
+  struct Beam
+  {
+    int index;
+    double range;
+    double angle;
+    double x;
+    double y;
+  };
+
+  /*
+   * @brief Collect the beams of a scan used for the update, computing the trigonometry
+   * of their bearings once for all samples
+   * @param data Laser data to use
+   * @param step Step between the beams used, unless they are selected adaptively
+   * @param skip_max_range Whether to skip max range readings, as well as NaN readings
+   */
+  void collectBeams(LaserData * data, int step, bool skip_max_range);
+
+  /*
+   * @brief Select max_beams_ of the beams collected by farthest point sampling of their
+   * endpoints, so that the beams cover the distinct parts of the scan (such as corners and
+   * the ends of corridors) rather than mostly repeating the same walls
+   */
+  void selectBeams();
+
+  /*
+   * @brief Weigh the samples of a set in contiguous chunks across the threads
+   * @param set Sample set to weigh
+   * @param weigh Function weighing the samples of indices [begin, end) with the thread index,
+   * returning their total weight
+   * @return Total weight of the samples, summed in the order of the samples' chunks
+   */
+  double weighSamples(
+    pf_sample_set_t * set, const std::function<double(int, int, int)> & weigh) const;
+
+  /*
+   * @brief Number of threads weighSamples uses for a set
+   * @param set Sample set to weigh
+   * @return Number of threads
+   */
+  int getThreadCount(pf_sample_set_t * set) const;
+
+  /*
+   * @brief Compute the likelihood field, the likelihood of a beam ending in each cell
+   * from the distance to its closest obstacle in the cspace of the map. It is kept until
+   * the scans' max range changes, as the random measurements term depends on it
+   * @param range_max Max range of the scans
+   */
+  void updateLikelihoodField(double range_max);
+
+  /*
+   * @brief Transform the probability of a beam's endpoint into the value the model
+   * accumulates, stored in the likelihood field so it is not computed per beam
+   * @param pz Probability of the endpoint
+   * @return Value stored in the likelihood field
+   */
+  virtual double transformLikelihood(double pz) const
+  {
+    return pz;
+  }
+
+  /*
+   * @brief Get the likelihood of a beam's endpoint from the likelihood field
+   * @param x X of the endpoint in the map
+   * @param y Y of the endpoint in the map
+   * @param index Used to return the index of the endpoint's cell, or -1 if off the map
+   * @return Likelihood of the endpoint, that of the max distance off the map
+   */
+  inline double getLikelihood(double x, double y, int & index) const
+  {
+    // MAP_GXWX and MAP_GYWY with the division and offsets folded in
+    const int mi = static_cast<int>(floor(x * map_inv_scale_ + map_offset_x_));
+    const int mj = static_cast<int>(floor(y * map_inv_scale_ + map_offset_y_));
+    if (!MAP_VALID(map_, mi, mj)) {
+      index = -1;
+      return max_occ_dist_likelihood_;
+    }
+    index = MAP_INDEX(map_, mi, mj);
+    return likelihood_field_min_ + likelihood_field_[index] * likelihood_field_step_;
+  }
+
   double z_hit_;
   double z_rand_;
   double sigma_hit_;
@@ -79,6 +219,21 @@ protected:
   int max_samples_;
   int max_obs_;
   double ** temp_obs_;
+  int threads_;
+  int parallel_particles_;
+  bool adaptive_beam_selection_;
+  std::vector<Beam> beams_;
+
+  // Likelihood of each cell in 16 bits fixed point between the likelihoods of the
+  // smallest and largest probabilities, stored densely apart from the map cells
+  std::vector<uint16_t> likelihood_field_;
+  double likelihood_field_min_;
+  double likelihood_field_step_;
+  double likelihood_field_range_max_;
+  double max_occ_dist_likelihood_;
+  double map_inv_scale_;
+  double map_offset_x_;
+  double map_offset_y_;
 };
 
 /*
@@ -114,10 +269,14 @@ class BeamModel : public Laser
 public:
   /*
    * @brief BeamModel constructor
+   * @param range_lut_angles Number of directions in which the ranges from the free cells
+   * of the map are precomputed, 0 to trace each beam
+   * @param range_lut_max_range Maximum range of the precomputed ranges
    */
   BeamModel(
     double z_hit, double z_short, double z_max, double z_rand, double sigma_hit,
-    double lambda_short, double chi_outlier, size_t max_beams, map_t * map);
+    double lambda_short, double chi_outlier, size_t max_beams, map_t * map,
+    int range_lut_angles = 0, double range_lut_max_range = 0.0);
 
   /*
    * @brief Run a sensor update on laser
@@ -129,6 +288,17 @@ public:
 
 private:
   static double sensorFunction(LaserData * data, pf_sample_set_t * set);
+
+  /*
+   * @brief Multiply the weights of the samples by the model's likelihood of a scan
+   * @param data Laser data to use
+   * @param set Sample set to weigh
+   * @return Total weight of the samples
+   */
+  double applySensorModel(LaserData * data, pf_sample_set_t * set) override
+  {
+    return sensorFunction(data, set);
+  }
   double z_short_;
   double z_max_;
   double lambda_short_;
@@ -165,6 +335,27 @@ private:
    * @return if it was succesful
    */
   static double sensorFunction(LaserData * data, pf_sample_set_t * set);
+
+  /*
+   * @brief Multiply the weights of the samples by the model's likelihood of a scan
+   * @param data Laser data to use
+   * @param set Sample set to weigh
+   * @return Total weight of the samples
+   */
+  double applySensorModel(LaserData * data, pf_sample_set_t * set) override
+  {
+    return sensorFunction(data, set);
+  }
+
+  /*
+   * @brief Cube the probability of a beam's endpoint, for the ad-hoc combination of beams
+   * @param pz Probability of the endpoint
+   * @return Value stored in the likelihood field
+   */
+  double transformLikelihood(double pz) const override
+  {
+    return pz * pz * pz;
+  }
 };
 
 /*
@@ -199,6 +390,29 @@ private:
    * @return if it was succesful
    */
   static double sensorFunction(LaserData * data, pf_sample_set_t * set);
+
+  /*
+   * @brief Multiply the weights of the samples by the model's likelihood of a scan
+   * @param data Laser data to use
+   * @param set Sample set to weigh
+   * @return Total weight of the samples
+   */
+  double applySensorModel(LaserData * data, pf_sample_set_t * set) override
+  {
+    return sensorFunction(data, set);
+  }
+
+  /*
+   * @brief Take the log of the probability of a beam's endpoint, for the sum of the log
+   * likelihoods of beams
+   * @param pz Probability of the endpoint
+   * @return Value stored in the likelihood field
+   */
+  double transformLikelihood(double pz) const override
+  {
+    return log(pz);
+  }
+
   bool do_beamskip_;
   double beam_skip_distance_;
   double beam_skip_threshold_;
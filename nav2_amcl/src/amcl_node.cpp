@@ -23,6 +23,8 @@
 #include "nav2_amcl/amcl_node.hpp"
 
 #include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <memory>
 #include <string>
 #include <utility>
@@ -32,7 +34,9 @@
 #include "nav2_amcl/angleutils.hpp"
 #include "nav2_util/geometry_utils.hpp"
 #include "nav2_amcl/pf/pf.hpp"
+#include "nav2_amcl/pf/pf_pdf.hpp"
 #include "nav2_util/string_utils.hpp"
+#include "nav2_util/tracing.hpp"
 #include "nav2_amcl/sensors/laser/laser.hpp"
 #include "tf2/convert.h"
 #include "tf2_geometry_msgs/tf2_geometry_msgs.hpp"
@@ -88,15 +92,32 @@ AmclNode::AmclNode(const rclcpp::NodeOptions & options)
     "base_frame_id", rclcpp::ParameterValue(std::string("base_footprint")),
     "Which frame to use for the robot base");
 
+  add_parameter(
+    "beam_range_lut_angles", rclcpp::ParameterValue(0),
+    "Number of directions in which the beam model precomputes the ranges from each free cell "
+    "of the map, up to laser_max_range, rather than tracing each beam. Uses 2 bytes per free "
+    "cell and direction",
+    "0 to disable");
+
   add_parameter("beam_skip_distance", rclcpp::ParameterValue(0.5));
   add_parameter("beam_skip_error_threshold", rclcpp::ParameterValue(0.9));
   add_parameter("beam_skip_threshold", rclcpp::ParameterValue(0.3));
   add_parameter("do_beamskip", rclcpp::ParameterValue(false));
 
+  add_parameter(
+    "adaptive_beam_selection", rclcpp::ParameterValue(false),
+    "Whether to select the max_beams beams used by the spread of their endpoints, "
+    "rather than evenly through each scan");
+
   add_parameter(
     "global_frame_id", rclcpp::ParameterValue(std::string("map")),
     "The name of the coordinate frame published by the localization system");
 
+  add_parameter(
+    "global_localization_scan_matching", rclcpp::ParameterValue(false),
+    "Whether the global localization service initializes the particles around the poses at "
+    "which the last scan matches the map best, rather than uniformly over the free space");
+
   add_parameter(
     "lambda_short", rclcpp::ParameterValue(0.1),
     "Exponential decay parameter for z_short part of model");
@@ -105,6 +126,11 @@ AmclNode::AmclNode(const rclcpp::NodeOptions & options)
     "laser_likelihood_max_dist", rclcpp::ParameterValue(2.0),
     "Maximum distance to do obstacle inflation on map, for use in likelihood_field model");
 
+  add_parameter(
+    "laser_fusion_tolerance", rclcpp::ParameterValue(0.0),
+    "Maximum time difference (s) between the scans of several lasers fused in a single "
+    "filter update, 0.0 to update the filter with each laser independently");
+
   add_parameter(
     "laser_max_range", rclcpp::ParameterValue(100.0),
     "Maximum scan range to be considered",
@@ -153,10 +179,30 @@ AmclNode::AmclNode(const rclcpp::NodeOptions & options)
     "min_particles", rclcpp::ParameterValue(500),
     "Minimum allowed number of particles");
 
+  add_parameter(
+    "motion_model_threads", rclcpp::ParameterValue(1),
+    "Number of threads sampling the motion of the particles in the odometry update, used "
+    "only with enough particles to pay for them");
+
   add_parameter(
     "odom_frame_id", rclcpp::ParameterValue(std::string("odom")),
     "Which frame to use for odometry");
 
+  add_parameter(
+    "particle_cloud_clusters", rclcpp::ParameterValue(false),
+    "Publish the mean pose and weight of each cluster of particles in the particle cloud, "
+    "rather than the particles");
+
+  add_parameter(
+    "particle_cloud_max_particles", rclcpp::ParameterValue(0),
+    "Maximum number of particles published in the particle cloud, evenly decimated from those "
+    "of the filter", "0 to publish all of them");
+
+  add_parameter(
+    "particle_cloud_rate", rclcpp::ParameterValue(0.0),
+    "Maximum rate (Hz) at which to publish the particle cloud",
+    "0.0 to publish it on every filter update");
+
   add_parameter("pf_err", rclcpp::ParameterValue(0.05));
   add_parameter("pf_z", rclcpp::ParameterValue(0.99));
 
@@ -185,6 +231,26 @@ AmclNode::AmclNode(const rclcpp::NodeOptions & options)
     "on subsequent runs to initialize the filter",
     "-1.0 to disable");
 
+  add_parameter(
+    "scan_matching_max_candidates", rclcpp::ParameterValue(5),
+    "Maximum number of poses around which the global localization scan matching initializes "
+    "the particles");
+
+  add_parameter(
+    "scan_matching_min_score", rclcpp::ParameterValue(0.5),
+    "Minimum mean likelihood, between 0 and 1, of the points of the last scan at a pose for "
+    "the global localization scan matching to keep it");
+
+  add_parameter(
+    "sensor_model_parallel_particles", rclcpp::ParameterValue(0),
+    "Number of particles from which the laser sensor model weighs them across all of the "
+    "hardware threads rather than sensor_model_threads, such as after a global localization",
+    "0 to disable");
+
+  add_parameter(
+    "sensor_model_threads", rclcpp::ParameterValue(1),
+    "Number of threads weighing the particles in the laser sensor model update");
+
   add_parameter("sigma_hit", rclcpp::ParameterValue(0.2));
 
   add_parameter(
@@ -254,7 +320,8 @@ AmclNode::on_configure(const rclcpp_lifecycle::State & /*state*/)
   initOdometry();
   executor_ = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
   executor_->add_callback_group(callback_group_, get_node_base_interface());
-  executor_thread_ = std::make_unique<nav2_util::NodeThread>(executor_);
+  executor_thread_ = std::make_unique<nav2_util::NodeThread>(
+    executor_, nav2_util::declareThreadSettings(this, "executor_thread"));
   return nav2_util::CallbackReturn::SUCCESS;
 }
 
@@ -266,6 +333,7 @@ AmclNode::on_activate(const rclcpp_lifecycle::State & /*state*/)
   // Lifecycle publishers must be explicitly activated
   pose_pub_->on_activate();
   particle_cloud_pub_->on_activate();
+  statistics_pub_->on_activate();
 
   first_pose_sent_ = false;
 
@@ -311,6 +379,7 @@ AmclNode::on_deactivate(const rclcpp_lifecycle::State & /*state*/)
   // Lifecycle publishers must be explicitly deactivated
   pose_pub_->on_deactivate();
   particle_cloud_pub_->on_deactivate();
+  statistics_pub_->on_deactivate();
 
   // reset dynamic parameter handler
   dyn_params_handler_.reset();
@@ -345,8 +414,11 @@ AmclNode::on_cleanup(const rclcpp_lifecycle::State & /*state*/)
     map_free(map_);
     map_ = nullptr;
   }
+  updateMapMemory();
   first_map_received_ = false;
-  free_space_indices.resize(0);
+#if NEW_UNIFORM_SAMPLING
+  clearFreeSpaceIndex();
+#endif
 
   // Transforms
   tf_broadcaster_.reset();
@@ -355,6 +427,7 @@ AmclNode::on_cleanup(const rclcpp_lifecycle::State & /*state*/)
   // PubSub
   pose_pub_.reset();
   particle_cloud_pub_.reset();
+  statistics_pub_.reset();
 
   // Odometry
   motion_model_.reset();
@@ -367,6 +440,7 @@ AmclNode::on_cleanup(const rclcpp_lifecycle::State & /*state*/)
   lasers_.clear();
   lasers_update_.clear();
   frame_to_laser_.clear();
+  fused_scans_.clear();
   force_update_ = true;
 
   if (set_initial_pose_) {
@@ -409,7 +483,11 @@ AmclNode::checkElapsedTime(std::chrono::seconds check_interval, rclcpp::Time las
 }
 
 #if NEW_UNIFORM_SAMPLING
-std::vector<AmclNode::Point2D> AmclNode::free_space_indices;
+std::vector<AmclNode::FreeSpaceRun> AmclNode::free_space_runs;
+std::vector<int64_t> AmclNode::free_space_counts;
+map_t * AmclNode::free_space_map = nullptr;
+int AmclNode::free_space_delta = 1;
+nav2_util::MemoryTracker AmclNode::free_space_memory("amcl/free_space_indices");
 #endif
 
 bool
@@ -450,11 +528,23 @@ AmclNode::uniformPoseGenerator(void * arg)
   map_t * map = reinterpret_cast<map_t *>(arg);
 
 #if NEW_UNIFORM_SAMPLING
-  unsigned int rand_index = drand48() * free_space_indices.size();
-  AmclNode::Point2D free_point = free_space_indices[rand_index];
+  if (free_space_map != map) {
+    createFreeSpaceIndex(map);
+  }
   pf_vector_t p;
-  p.v[0] = MAP_WXGX(map, free_point.x);
-  p.v[1] = MAP_WYGY(map, free_point.y);
+  if (free_space_counts.empty()) {
+    // No free cell to sample from
+    p = pf_vector_zero();
+    return p;
+  }
+  const int64_t total = free_space_counts.back();
+  const int64_t rand_index = std::min(static_cast<int64_t>(drand48() * total), total - 1);
+  const size_t run_index = std::upper_bound(
+    free_space_counts.begin(), free_space_counts.end(), rand_index) - free_space_counts.begin();
+  const AmclNode::FreeSpaceRun & run = free_space_runs[run_index];
+  const int64_t offset = rand_index - (run_index > 0 ? free_space_counts[run_index - 1] : 0);
+  p.v[0] = MAP_WXGX(map, run.x + offset * free_space_delta);
+  p.v[1] = MAP_WYGY(map, run.y);
   p.v[2] = drand48() * 2 * M_PI - M_PI;
 #else
   double min_x, max_x, min_y, max_y;
@@ -483,6 +573,80 @@ AmclNode::uniformPoseGenerator(void * arg)
   return p;
 }
 
+pf_vector_t
+AmclNode::scanMatchPoseGenerator(void * arg)
+{
+  const auto & matches = *reinterpret_cast<std::vector<nav2_amcl::ScanMatch> *>(arg);
+
+  double total = 0.0;
+  for (const auto & match : matches) {
+    total += match.score;
+  }
+  double draw = drand48() * total;
+  size_t i = 0;
+  while (i + 1 < matches.size() && draw >= matches[i].score) {
+    draw -= matches[i].score;
+    i++;
+  }
+
+  // Spread over about a cell and an angular step of the search around the match
+  pf_vector_t p = matches[i].pose;
+  p.v[0] += pf_ran_gaussian(0.25);
+  p.v[1] += pf_ran_gaussian(0.25);
+  p.v[2] = angleutils::normalize(p.v[2] + pf_ran_gaussian(M_PI / 24.0));
+  return p;
+}
+
+std::vector<nav2_amcl::ScanMatch>
+AmclNode::matchLastScan()
+{
+  std::vector<nav2_amcl::ScanMatch> matches;
+  if (map_ == NULL || !last_laser_scan_ || last_laser_index_ < 0 ||
+    last_laser_index_ >= static_cast<int>(lasers_.size()))
+  {
+    RCLCPP_WARN(get_logger(), "No scan received yet to match against the map");
+    return matches;
+  }
+
+  nav2_amcl::LaserData ldata;
+  if (!getLaserData(last_laser_index_, last_laser_scan_, ldata)) {
+    return matches;
+  }
+
+  // Points of the scan in the base frame, evenly decimated as the matching time grows
+  // with their number
+  const int max_points = 100;
+  const int step = std::max(1, ldata.range_count / max_points);
+  const pf_vector_t & laser_pose = lasers_[last_laser_index_]->GetLaserPose();
+  std::vector<pf_vector_t> points;
+  for (int i = 0; i < ldata.range_count; i += step) {
+    const double range = ldata.ranges[i][0];
+    if (!std::isfinite(range) || range >= ldata.range_max) {
+      continue;
+    }
+    pf_vector_t point = pf_vector_zero();
+    point.v[0] = laser_pose.v[0] + range * cos(ldata.ranges[i][1]);
+    point.v[1] = laser_pose.v[1] + range * sin(ldata.ranges[i][1]);
+    points.push_back(point);
+  }
+
+  if (!scan_matcher_) {
+    scan_matcher_ = std::make_unique<nav2_amcl::CorrelativeScanMatcher>();
+    scan_matcher_->setMap(map_, sigma_hit_);
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  matches = scan_matcher_->match(
+    points, scan_matching_max_candidates_, scan_matching_min_score_, 1.0);
+  RCLCPP_DEBUG(
+    get_logger(), "Matched %zu points of the last scan in %.3f s", points.size(),
+    std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+  if (matches.empty()) {
+    RCLCPP_WARN(get_logger(), "No pose found at which the last scan matches the map");
+  }
+  return matches;
+}
+
 void
 AmclNode::globalLocalizationCallback(
   const std::shared_ptr<rmw_request_id_t>/*request_header*/,
@@ -491,11 +655,25 @@ AmclNode::globalLocalizationCallback(
 {
   std::lock_guard<std::recursive_mutex> cfl(mutex_);
 
-  RCLCPP_INFO(get_logger(), "Initializing with uniform distribution");
+  std::vector<nav2_amcl::ScanMatch> matches;
+  if (global_localization_scan_matching_) {
+    matches = matchLastScan();
+  }
 
-  pf_init_model(
-    pf_, (pf_init_model_fn_t)AmclNode::uniformPoseGenerator,
-    reinterpret_cast<void *>(map_));
+  if (!matches.empty()) {
+    RCLCPP_INFO(
+      get_logger(), "Initializing around %zu scan matches, best at (%.3f, %.3f, %.3f) "
+      "with score %.3f", matches.size(), matches[0].pose.v[0], matches[0].pose.v[1],
+      matches[0].pose.v[2], matches[0].score);
+    pf_init_model(
+      pf_, (pf_init_model_fn_t)AmclNode::scanMatchPoseGenerator,
+      reinterpret_cast<void *>(&matches));
+  } else {
+    RCLCPP_INFO(get_logger(), "Initializing with uniform distribution");
+    pf_init_model(
+      pf_, (pf_init_model_fn_t)AmclNode::uniformPoseGenerator,
+      reinterpret_cast<void *>(map_));
+  }
   RCLCPP_INFO(get_logger(), "Global initialisation done!");
   initial_pose_is_known_ = true;
   pf_init_ = false;
@@ -629,6 +807,7 @@ AmclNode::handleInitialPose(geometry_msgs::msg::PoseWithCovarianceStamped & msg)
 void
 AmclNode::laserReceived(sensor_msgs::msg::LaserScan::ConstSharedPtr laser_scan)
 {
+  NAV2_TRACE_SCOPE("AmclNode::laserReceived");
   std::lock_guard<std::recursive_mutex> cfl(mutex_);
 
   // Since the sensor data is continually being published by the simulator or robot,
@@ -642,6 +821,15 @@ AmclNode::laserReceived(sensor_msgs::msg::LaserScan::ConstSharedPtr laser_scan)
     return;
   }
 
+  // Durations of the stages of the update, for the statistics
+  const auto scan_start = std::chrono::steady_clock::now();
+  nav2_msgs::msg::ParticleFilterStatistics statistics;
+  auto time_stage = [](auto && stage) {
+      const auto start = std::chrono::steady_clock::now();
+      stage();
+      return rclcpp::Duration(std::chrono::steady_clock::now() - start);
+    };
+
   std::string laser_scan_frame_id = nav2_util::strip_leading_slash(laser_scan->header.frame_id);
   last_laser_received_ts_ = now();
   int laser_index = -1;
@@ -656,6 +844,20 @@ AmclNode::laserReceived(sensor_msgs::msg::LaserScan::ConstSharedPtr laser_scan)
     // we have the laser pose, retrieve laser index
     laser_index = frame_to_laser_[laser_scan->header.frame_id];
   }
+  last_laser_scan_ = laser_scan;
+  last_laser_index_ = laser_index;
+
+  // With the scans of several lasers fused, the filter is only updated once each laser
+  // has a scan close in time to this one
+  const bool fuse_scans = laser_fusion_tolerance_ > 0.0 && lasers_.size() > 1;
+  if (fuse_scans && !fuseScan(laser_index, laser_scan)) {
+    if (latest_tf_valid_ && tf_broadcast_ == true) {
+      tf2::TimePoint transform_expiration = tf2_ros::fromMsg(laser_scan->header.stamp) +
+        transform_tolerance_;
+      sendMapToOdomTransform(transform_expiration);
+    }
+    return;
+  }
 
   // Where was the robot when this scan was taken?
   pf_vector_t pose;
@@ -688,20 +890,30 @@ AmclNode::laserReceived(sensor_msgs::msg::LaserScan::ConstSharedPtr laser_scan)
       }
     }
     if (lasers_update_[laser_index]) {
-      motion_model_->odometryUpdate(pf_, pose, delta);
+      statistics.motion_update = time_stage(
+        [&]() {motion_model_->odometryUpdate(pf_, pose, delta);});
     }
     force_update_ = false;
   }
 
   bool resampled = false;
+  const bool filter_updated = lasers_update_[laser_index];
 
   // If the robot has moved, update the filter
-  if (lasers_update_[laser_index]) {
-    updateFilter(laser_index, laser_scan, pose);
+  if (filter_updated) {
+    statistics.sensor_update = time_stage(
+      [&]() {
+        if (fuse_scans) {
+          updateFilterFused(pose);
+        } else {
+          updateFilter(laser_index, laser_scan, pose);
+        }
+      });
 
     // Resample the particles
     if (!(++resample_count_ % resample_interval_)) {
-      pf_update_resample(pf_, reinterpret_cast<void *>(map_));
+      statistics.resample = time_stage(
+        [&]() {pf_update_resample(pf_, reinterpret_cast<void *>(map_));});
       resampled = true;
     }
 
@@ -716,18 +928,24 @@ AmclNode::laserReceived(sensor_msgs::msg::LaserScan::ConstSharedPtr laser_scan)
     amcl_hyp_t max_weight_hyps;
     std::vector<amcl_hyp_t> hyps;
     int max_weight_hyp = -1;
-    if (getMaxWeightHyp(hyps, max_weight_hyps, max_weight_hyp)) {
+    bool found_hyp = false;
+    statistics.cluster_stats = time_stage(
+      [&]() {found_hyp = getMaxWeightHyp(hyps, max_weight_hyps, max_weight_hyp);});
+    if (found_hyp) {
       publishAmclPose(laser_scan, hyps, max_weight_hyp);
-      calculateMaptoOdomTransform(laser_scan, hyps, max_weight_hyp);
-
-      if (tf_broadcast_ == true) {
-        // We want to send a transform that is good up until a
-        // tolerance time so that odom can be used
-        auto stamp = tf2_ros::fromMsg(laser_scan->header.stamp);
-        tf2::TimePoint transform_expiration = stamp + transform_tolerance_;
-        sendMapToOdomTransform(transform_expiration);
-        sent_first_transform_ = true;
-      }
+      statistics.tf_publish = time_stage(
+        [&]() {
+          calculateMaptoOdomTransform(laser_scan, hyps, max_weight_hyp);
+
+          if (tf_broadcast_ == true) {
+            // We want to send a transform that is good up until a
+            // tolerance time so that odom can be used
+            auto stamp = tf2_ros::fromMsg(laser_scan->header.stamp);
+            tf2::TimePoint transform_expiration = stamp + transform_tolerance_;
+            sendMapToOdomTransform(transform_expiration);
+            sent_first_transform_ = true;
+          }
+        });
     } else {
       RCLCPP_ERROR(get_logger(), "No pose!");
     }
@@ -740,6 +958,15 @@ AmclNode::laserReceived(sensor_msgs::msg::LaserScan::ConstSharedPtr laser_scan)
       sendMapToOdomTransform(transform_expiration);
     }
   }
+
+  if (filter_updated && statistics_pub_->get_subscription_count() > 0) {
+    statistics.header.stamp = laser_scan->header.stamp;
+    statistics.header.frame_id = global_frame_id_;
+    statistics.particle_count = pf_->sets[pf_->current_set].sample_count;
+    statistics.resampled = resampled;
+    statistics.total = rclcpp::Duration(std::chrono::steady_clock::now() - scan_start);
+    statistics_pub_->publish(statistics);
+  }
 }
 
 bool AmclNode::addNewScanner(
@@ -750,6 +977,8 @@ bool AmclNode::addNewScanner(
 {
   lasers_.push_back(createLaserObject());
   lasers_update_.push_back(true);
+  // The beam model builds the range lookup table of the map
+  updateMapMemory();
   laser_index = frame_to_laser_.size();
 
   geometry_msgs::msg::PoseStamped ident;
@@ -797,6 +1026,59 @@ bool AmclNode::updateFilter(
   const pf_vector_t & pose)
 {
   nav2_amcl::LaserData ldata;
+  if (!getLaserData(laser_index, laser_scan, ldata)) {
+    return false;
+  }
+  lasers_[laser_index]->sensorUpdate(pf_, reinterpret_cast<nav2_amcl::LaserData *>(&ldata));
+  lasers_update_[laser_index] = false;
+  pf_odom_pose_ = pose;
+  return true;
+}
+
+bool AmclNode::updateFilterFused(const pf_vector_t & pose)
+{
+  std::vector<std::unique_ptr<nav2_amcl::LaserData>> ldatas;
+  std::vector<nav2_amcl::LaserData *> fused_data;
+  for (unsigned int i = 0; i < fused_scans_.size(); i++) {
+    ldatas.push_back(std::make_unique<nav2_amcl::LaserData>());
+    if (getLaserData(i, fused_scans_[i], *ldatas.back())) {
+      fused_data.push_back(ldatas.back().get());
+    }
+  }
+  fused_scans_.assign(fused_scans_.size(), nullptr);
+  if (fused_data.empty()) {
+    return false;
+  }
+
+  nav2_amcl::Laser::fusedSensorUpdate(pf_, fused_data);
+  for (unsigned int i = 0; i < lasers_update_.size(); i++) {
+    lasers_update_[i] = false;
+  }
+  pf_odom_pose_ = pose;
+  return true;
+}
+
+bool AmclNode::fuseScan(
+  const int & laser_index,
+  const sensor_msgs::msg::LaserScan::ConstSharedPtr & laser_scan)
+{
+  fused_scans_.resize(lasers_.size());
+  fused_scans_[laser_index] = laser_scan;
+
+  const rclcpp::Time stamp(laser_scan->header.stamp);
+  for (const auto & scan : fused_scans_) {
+    if (!scan || (stamp - rclcpp::Time(scan->header.stamp)).seconds() > laser_fusion_tolerance_) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool AmclNode::getLaserData(
+  const int & laser_index,
+  const sensor_msgs::msg::LaserScan::ConstSharedPtr & laser_scan,
+  nav2_amcl::LaserData & ldata)
+{
   ldata.laser = lasers_[laser_index];
   ldata.range_count = laser_scan->ranges.size();
   // To account for lasers that are mounted upside-down, we determine the
@@ -866,9 +1148,6 @@ bool AmclNode::updateFilter(
     ldata.ranges[i][1] = angle_min +
       (i * angle_increment);
   }
-  lasers_[laser_index]->sensorUpdate(pf_, reinterpret_cast<nav2_amcl::LaserData *>(&ldata));
-  lasers_update_[laser_index] = false;
-  pf_odom_pose_ = pose;
   return true;
 }
 
@@ -877,18 +1156,63 @@ AmclNode::publishParticleCloud(const pf_sample_set_t * set)
 {
   // If initial pose is not known, AMCL does not know the current pose
   if (!initial_pose_is_known_) {return;}
+
+  // Nobody to build the cloud for
+  if (particle_cloud_pub_->get_subscription_count() == 0 &&
+    particle_cloud_pub_->get_intra_process_subscription_count() == 0)
+  {
+    return;
+  }
+
+  const rclcpp::Time stamp = now();
+  if (particle_cloud_rate_ > 0.0 && last_particle_cloud_time_.nanoseconds() > 0 &&
+    (stamp - last_particle_cloud_time_).seconds() < 1.0 / particle_cloud_rate_)
+  {
+    return;
+  }
+  last_particle_cloud_time_ = stamp;
+
   auto cloud_with_weights_msg = std::make_unique<nav2_msgs::msg::ParticleCloud>();
-  cloud_with_weights_msg->header.stamp = this->now();
+  cloud_with_weights_msg->header.stamp = stamp;
   cloud_with_weights_msg->header.frame_id = global_frame_id_;
-  cloud_with_weights_msg->particles.resize(set->sample_count);
 
-  for (int i = 0; i < set->sample_count; i++) {
-    cloud_with_weights_msg->particles[i].pose.position.x = set->samples[i].pose.v[0];
-    cloud_with_weights_msg->particles[i].pose.position.y = set->samples[i].pose.v[1];
-    cloud_with_weights_msg->particles[i].pose.position.z = 0;
-    cloud_with_weights_msg->particles[i].pose.orientation = orientationAroundZAxis(
-      set->samples[i].pose.v[2]);
-    cloud_with_weights_msg->particles[i].weight = set->samples[i].weight;
+  auto add_particle = [&](const pf_vector_t & pose, double weight) {
+      nav2_msgs::msg::Particle particle;
+      particle.pose.position.x = pose.v[0];
+      particle.pose.position.y = pose.v[1];
+      particle.pose.position.z = 0;
+      particle.pose.orientation = orientationAroundZAxis(pose.v[2]);
+      particle.weight = weight;
+      cloud_with_weights_msg->particles.push_back(particle);
+    };
+
+  if (particle_cloud_clusters_) {
+    cloud_with_weights_msg->particles.reserve(set->cluster_count);
+    for (int i = 0; i < set->cluster_count; i++) {
+      double weight;
+      pf_vector_t pose_mean;
+      pf_matrix_t pose_cov;
+      if (pf_get_cluster_stats(pf_, i, &weight, &pose_mean, &pose_cov)) {
+        add_particle(pose_mean, weight);
+      }
+    }
+  } else if (particle_cloud_max_particles_ > 0 &&
+    set->sample_count > particle_cloud_max_particles_)
+  {
+    // Evenly spaced particles, each weighing for those skipped after it so the weights
+    // still sum to that of the filter's
+    const int count = particle_cloud_max_particles_;
+    const double stride = static_cast<double>(set->sample_count) / count;
+    cloud_with_weights_msg->particles.reserve(count);
+    for (int i = 0; i < count; i++) {
+      const pf_sample_t & sample = set->samples[static_cast<int>(i * stride)];
+      add_particle(sample.pose, sample.weight * stride);
+    }
+  } else {
+    cloud_with_weights_msg->particles.reserve(set->sample_count);
+    for (int i = 0; i < set->sample_count; i++) {
+      add_particle(set->samples[i].pose, set->samples[i].weight);
+    }
   }
 
   particle_cloud_pub_->publish(std::move(cloud_with_weights_msg));
@@ -1042,22 +1366,28 @@ AmclNode::createLaserObject()
 {
   RCLCPP_INFO(get_logger(), "createLaserObject");
 
+  nav2_amcl::Laser * laser;
   if (sensor_model_type_ == "beam") {
-    return new nav2_amcl::BeamModel(
+    // Without a configured maximum range, the ranges span the whole map
+    const double range_lut_max_range = laser_max_range_ > 0.0 ? laser_max_range_ :
+      std::hypot(map_->size_x, map_->size_y) * map_->scale;
+    laser = new nav2_amcl::BeamModel(
       z_hit_, z_short_, z_max_, z_rand_, sigma_hit_, lambda_short_,
-      0.0, max_beams_, map_);
-  }
-
-  if (sensor_model_type_ == "likelihood_field_prob") {
-    return new nav2_amcl::LikelihoodFieldModelProb(
+      0.0, max_beams_, map_, beam_range_lut_angles_, range_lut_max_range);
+  } else if (sensor_model_type_ == "likelihood_field_prob") {
+    laser = new nav2_amcl::LikelihoodFieldModelProb(
       z_hit_, z_rand_, sigma_hit_,
       laser_likelihood_max_dist_, do_beamskip_, beam_skip_distance_, beam_skip_threshold_,
       beam_skip_error_threshold_, max_beams_, map_);
+  } else {
+    laser = new nav2_amcl::LikelihoodFieldModel(
+      z_hit_, z_rand_, sigma_hit_,
+      laser_likelihood_max_dist_, max_beams_, map_);
   }
-
-  return new nav2_amcl::LikelihoodFieldModel(
-    z_hit_, z_rand_, sigma_hit_,
-    laser_likelihood_max_dist_, max_beams_, map_);
+  laser->SetThreads(sensor_model_threads_);
+  laser->SetParallelParticles(sensor_model_parallel_particles_);
+  laser->SetAdaptiveBeamSelection(adaptive_beam_selection_);
+  return laser;
 }
 
 void
@@ -1072,13 +1402,17 @@ AmclNode::initParameters()
   get_parameter("alpha4", alpha4_);
   get_parameter("alpha5", alpha5_);
   get_parameter("base_frame_id", base_frame_id_);
+  get_parameter("beam_range_lut_angles", beam_range_lut_angles_);
   get_parameter("beam_skip_distance", beam_skip_distance_);
   get_parameter("beam_skip_error_threshold", beam_skip_error_threshold_);
   get_parameter("beam_skip_threshold", beam_skip_threshold_);
   get_parameter("do_beamskip", do_beamskip_);
+  get_parameter("adaptive_beam_selection", adaptive_beam_selection_);
   get_parameter("global_frame_id", global_frame_id_);
+  get_parameter("global_localization_scan_matching", global_localization_scan_matching_);
   get_parameter("lambda_short", lambda_short_);
   get_parameter("laser_likelihood_max_dist", laser_likelihood_max_dist_);
+  get_parameter("laser_fusion_tolerance", laser_fusion_tolerance_);
   get_parameter("laser_max_range", laser_max_range_);
   get_parameter("laser_min_range", laser_min_range_);
   get_parameter("laser_model_type", sensor_model_type_);
@@ -1090,7 +1424,11 @@ AmclNode::initParameters()
   get_parameter("max_beams", max_beams_);
   get_parameter("max_particles", max_particles_);
   get_parameter("min_particles", min_particles_);
+  get_parameter("motion_model_threads", motion_model_threads_);
   get_parameter("odom_frame_id", odom_frame_id_);
+  get_parameter("particle_cloud_clusters", particle_cloud_clusters_);
+  get_parameter("particle_cloud_max_particles", particle_cloud_max_particles_);
+  get_parameter("particle_cloud_rate", particle_cloud_rate_);
   get_parameter("pf_err", pf_err_);
   get_parameter("pf_z", pf_z_);
   get_parameter("recovery_alpha_fast", alpha_fast_);
@@ -1098,6 +1436,10 @@ AmclNode::initParameters()
   get_parameter("resample_interval", resample_interval_);
   get_parameter("robot_model_type", robot_model_type_);
   get_parameter("save_pose_rate", save_pose_rate);
+  get_parameter("scan_matching_max_candidates", scan_matching_max_candidates_);
+  get_parameter("scan_matching_min_score", scan_matching_min_score_);
+  get_parameter("sensor_model_parallel_particles", sensor_model_parallel_particles_);
+  get_parameter("sensor_model_threads", sensor_model_threads_);
   get_parameter("sigma_hit", sigma_hit_);
   get_parameter("tf_broadcast", tf_broadcast_);
   get_parameter("transform_tolerance", tmp_tol);
@@ -1259,6 +1601,9 @@ AmclNode::dynamicParametersCallback(
       } else if (param_name == "laser_min_range") {
         laser_min_range_ = parameter.as_double();
         reinit_laser = true;
+      } else if (param_name == "laser_fusion_tolerance") {
+        laser_fusion_tolerance_ = parameter.as_double();
+        reinit_laser = true;
       } else if (param_name == "pf_err") {
         pf_err_ = parameter.as_double();
         reinit_pf = true;
@@ -1271,11 +1616,16 @@ AmclNode::dynamicParametersCallback(
       } else if (param_name == "recovery_alpha_slow") {
         alpha_slow_ = parameter.as_double();
         reinit_pf = true;
+      } else if (param_name == "particle_cloud_rate") {
+        particle_cloud_rate_ = parameter.as_double();
       } else if (param_name == "save_pose_rate") {
         save_pose_rate = parameter.as_double();
         save_pose_period_ = tf2::durationFromSec(1.0 / save_pose_rate);
+      } else if (param_name == "scan_matching_min_score") {
+        scan_matching_min_score_ = parameter.as_double();
       } else if (param_name == "sigma_hit") {
         sigma_hit_ = parameter.as_double();
+        scan_matcher_.reset();
         reinit_laser = true;
       } else if (param_name == "transform_tolerance") {
         tmp_tol = parameter.as_double();
@@ -1323,15 +1673,25 @@ AmclNode::dynamicParametersCallback(
       if (param_name == "do_beamskip") {
         do_beamskip_ = parameter.as_bool();
         reinit_laser = true;
+      } else if (param_name == "adaptive_beam_selection") {
+        adaptive_beam_selection_ = parameter.as_bool();
+        reinit_laser = true;
       } else if (param_name == "tf_broadcast") {
         tf_broadcast_ = parameter.as_bool();
       } else if (param_name == "set_initial_pose") {
         set_initial_pose_ = parameter.as_bool();
       } else if (param_name == "first_map_only") {
         first_map_only_ = parameter.as_bool();
+      } else if (param_name == "global_localization_scan_matching") {
+        global_localization_scan_matching_ = parameter.as_bool();
+      } else if (param_name == "particle_cloud_clusters") {
+        particle_cloud_clusters_ = parameter.as_bool();
       }
     } else if (param_type == ParameterType::PARAMETER_INTEGER) {
-      if (param_name == "max_beams") {
+      if (param_name == "beam_range_lut_angles") {
+        beam_range_lut_angles_ = parameter.as_int();
+        reinit_laser = true;
+      } else if (param_name == "max_beams") {
         max_beams_ = parameter.as_int();
         reinit_laser = true;
       } else if (param_name == "max_particles") {
@@ -1340,8 +1700,21 @@ AmclNode::dynamicParametersCallback(
       } else if (param_name == "min_particles") {
         min_particles_ = parameter.as_int();
         reinit_pf = true;
+      } else if (param_name == "motion_model_threads") {
+        motion_model_threads_ = parameter.as_int();
+        reinit_odom = true;
+      } else if (param_name == "particle_cloud_max_particles") {
+        particle_cloud_max_particles_ = parameter.as_int();
       } else if (param_name == "resample_interval") {
         resample_interval_ = parameter.as_int();
+      } else if (param_name == "scan_matching_max_candidates") {
+        scan_matching_max_candidates_ = parameter.as_int();
+      } else if (param_name == "sensor_model_parallel_particles") {
+        sensor_model_parallel_particles_ = parameter.as_int();
+        reinit_laser = true;
+      } else if (param_name == "sensor_model_threads") {
+        sensor_model_threads_ = parameter.as_int();
+        reinit_laser = true;
       }
     }
   }
@@ -1379,6 +1752,7 @@ AmclNode::dynamicParametersCallback(
     lasers_.clear();
     lasers_update_.clear();
     frame_to_laser_.clear();
+    fused_scans_.clear();
     laser_scan_connection_.disconnect();
     laser_scan_filter_.reset();
     laser_scan_sub_.reset();
@@ -1432,28 +1806,57 @@ AmclNode::handleMapMessage(const nav_msgs::msg::OccupancyGrid & msg)
   }
   freeMapDependentMemory();
   map_ = convertMap(msg);
+  updateMapMemory();
 
 #if NEW_UNIFORM_SAMPLING
-  createFreeSpaceVector();
+  // The lookup table of free cells is created from the new map when first sampled
+  clearFreeSpaceIndex();
+  free_space_delta = freespace_downsampling_ ? 2 : 1;
 #endif
 }
 
+#if NEW_UNIFORM_SAMPLING
 void
-AmclNode::createFreeSpaceVector()
+AmclNode::createFreeSpaceIndex(map_t * map)
 {
-  int delta = freespace_downsampling_ ? 2 : 1;
+  const int delta = free_space_delta;
   // Index of free space
-  free_space_indices.resize(0);
-  for (int i = 0; i < map_->size_x; i += delta) {
-    for (int j = 0; j < map_->size_y; j += delta) {
-      if (map_->cells[MAP_INDEX(map_, i, j)].occ_state == -1) {
-        AmclNode::Point2D point = {i, j};
-        free_space_indices.push_back(point);
+  clearFreeSpaceIndex();
+  int64_t count = 0;
+  for (int j = 0; j < map->size_y; j += delta) {
+    const map_cell_t * row = map->cells + MAP_INDEX(map, 0, j);
+    for (int i = 0; i < map->size_x; i += delta) {
+      if (row[i].occ_state != -1) {
+        continue;
+      }
+      const int start = i;
+      while (i + delta < map->size_x && row[i + delta].occ_state == -1) {
+        i += delta;
       }
+      const int32_t run_count = (i - start) / delta + 1;
+      count += run_count;
+      free_space_runs.push_back({start, j, run_count});
+      free_space_counts.push_back(count);
     }
   }
+  free_space_map = map;
+  free_space_memory.update(
+    free_space_runs.capacity() * sizeof(FreeSpaceRun) +
+    free_space_counts.capacity() * sizeof(int64_t));
 }
 
+void
+AmclNode::clearFreeSpaceIndex()
+{
+  free_space_runs.clear();
+  free_space_runs.shrink_to_fit();
+  free_space_counts.clear();
+  free_space_counts.shrink_to_fit();
+  free_space_map = nullptr;
+  free_space_memory.update(0);
+}
+#endif
+
 void
 AmclNode::freeMapDependentMemory()
 {
@@ -1467,6 +1870,32 @@ AmclNode::freeMapDependentMemory()
   lasers_.clear();
   lasers_update_.clear();
   frame_to_laser_.clear();
+  fused_scans_.clear();
+  last_laser_scan_.reset();
+  last_laser_index_ = -1;
+  scan_matcher_.reset();
+  updateMapMemory();
+}
+
+void
+AmclNode::updateMapMemory()
+{
+  if (map_ == NULL) {
+    map_memory_.update(0);
+    return;
+  }
+
+  const size_t num_cells = static_cast<size_t>(map_->size_x) * map_->size_y;
+  size_t bytes = sizeof(map_t) + num_cells * sizeof(map_cell_t);
+  if (map_->range_lut != NULL) {
+    // A row of ranges for each free cell
+    size_t num_rows = 0;
+    for (size_t i = 0; i < num_cells; i++) {
+      num_rows += map_->range_lut_index[i] >= 0;
+    }
+    bytes += num_cells * sizeof(int32_t) + num_rows * map_->range_lut_angles * sizeof(uint16_t);
+  }
+  map_memory_.update(bytes);
 }
 
 // Convert an OccupancyGrid map message into the internal representation. This function
@@ -1550,6 +1979,10 @@ AmclNode::initPubSub()
     "particle_cloud",
     rclcpp::SensorDataQoS());
 
+  statistics_pub_ = create_publisher<nav2_msgs::msg::ParticleFilterStatistics>(
+    "amcl_statistics",
+    rclcpp::SystemDefaultsQoS());
+
   pose_pub_ = create_publisher<geometry_msgs::msg::PoseWithCovarianceStamped>(
     "amcl_pose",
     rclcpp::QoS(rclcpp::KeepLast(1)).transient_local().reliable());
@@ -1604,6 +2037,7 @@ AmclNode::initOdometry()
 
   motion_model_ = plugin_loader_.createSharedInstance(robot_model_type_);
   motion_model_->initialize(alpha1_, alpha2_, alpha3_, alpha4_, alpha5_);
+  motion_model_->setThreads(motion_model_threads_);
 
   latest_odom_pose_ = geometry_msgs::msg::PoseStamped();
 }
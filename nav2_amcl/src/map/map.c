@@ -53,6 +53,15 @@ map_t * map_alloc(void)
   // Allocate storage for main map
   map->cells = (map_cell_t *) NULL;
 
+  // No obstacle distances
+  map->max_occ_dist = 0;
+
+  // No precomputed ranges
+  map->range_lut_angles = 0;
+  map->range_lut_max_range = 0;
+  map->range_lut_index = (int32_t *) NULL;
+  map->range_lut = (uint16_t *) NULL;
+
   return map;
 }
 
@@ -61,5 +70,7 @@ map_t * map_alloc(void)
 void map_free(map_t * map)
 {
   free(map->cells);
+  free(map->range_lut_index);
+  free(map->range_lut);
   free(map);
 }
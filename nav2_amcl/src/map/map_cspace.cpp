@@ -22,127 +22,82 @@
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
-#include <queue>
-#include "nav2_amcl/map/map.hpp"
 
-/*
- * @class CellData
- * @brief Data about map cells
- */
-class CellData
-{
-public:
-  map_t * map_;
-  unsigned int i_, j_;
-  unsigned int src_i_, src_j_;
-};
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "nav2_amcl/map/map.hpp"
 
 /*
- * @class CachedDistanceMap
- * @brief Cached map with distances
+ * @brief Run a function on contiguous chunks of [0, count) across threads
+ * @param count Number of items
+ * @param threads Number of threads
+ * @param fn Function processing the items of indices [begin, end)
  */
-class CachedDistanceMap
+template<typename FunctionT>
+void run_in_chunks(int count, int threads, FunctionT fn)
 {
-public:
-  /*
-   * @brief CachedDistanceMap constructor
-   */
-  CachedDistanceMap(double scale, double max_dist)
-  : distances_(NULL), scale_(scale), max_dist_(max_dist)
-  {
-    cell_radius_ = max_dist / scale;
-    distances_ = new double *[cell_radius_ + 2];
-    for (int i = 0; i <= cell_radius_ + 1; i++) {
-      distances_[i] = new double[cell_radius_ + 2];
-      for (int j = 0; j <= cell_radius_ + 1; j++) {
-        distances_[i][j] = sqrt(i * i + j * j);
-      }
-    }
+  const int chunk = (count + threads - 1) / threads;
+  std::vector<std::thread> workers;
+  for (int t = 1; t < threads && t * chunk < count; t++) {
+    workers.emplace_back(fn, t * chunk, std::min((t + 1) * chunk, count));
   }
-
-  /*
-   * @brief CachedDistanceMap destructor
-   */
-  ~CachedDistanceMap()
-  {
-    if (distances_) {
-      for (int i = 0; i <= cell_radius_ + 1; i++) {
-        delete[] distances_[i];
-      }
-      delete[] distances_;
-    }
+  fn(0, std::min(chunk, count));
+  for (auto & worker : workers) {
+    worker.join();
   }
-  double ** distances_;
-  double scale_;
-  double max_dist_;
-  int cell_radius_;
-};
-
-/*
- * @brief operator<
- */
-bool operator<(const CellData & a, const CellData & b)
-{
-  return a.map_->cells[MAP_INDEX(
-             a.map_, a.i_,
-             a.j_)].occ_dist > a.map_->cells[MAP_INDEX(b.map_, b.i_, b.j_)].occ_dist;
 }
 
 /*
- * @brief get_distance_map
- * @param scale of cost information wrt distance
- * @param max_dist Maximum distance to cache from occupied information
- * @return Pointer to cached distance map
+ * @brief Squared distance transform of a row from the squared distances of its cells to
+ * the closest obstacle of their column, as the lower envelope of their parabolas
+ * (Felzenszwalb and Huttenlocher, Distance Transforms of Sampled Functions)
+ * @param f Squared column distances of the row, replaced with the squared distances
+ * @param n Size of the row
+ * @param v Buffer of the parabolas' locations, of size n
+ * @param z Buffer of the parabolas' boundaries, of size n + 1
+ * @param d Buffer of the squared distances, of size n
+ * @param far Squared distance the row's distances are clipped at
  */
-CachedDistanceMap *
-get_distance_map(double scale, double max_dist)
+void distance_transform_row(
+  float * f, int n, std::vector<int> & v, std::vector<double> & z, std::vector<float> & d,
+  float far)
 {
-  static CachedDistanceMap * cdm = NULL;
-
-  if (!cdm || (cdm->scale_ != scale) || (cdm->max_dist_ != max_dist)) {
-    if (cdm) {
-      delete cdm;
+  // Only the cells within the clipping distance of their column's obstacles have a parabola
+  int k = -1;
+  for (int q = 0; q < n; q++) {
+    if (f[q] >= far) {
+      continue;
+    }
+    double s = -HUGE_VAL;
+    while (k >= 0) {
+      const double p = v[k];
+      s = ((f[q] + static_cast<double>(q) * q) - (f[v[k]] + p * p)) / (2.0 * (q - p));
+      if (s > z[k]) {
+        break;
+      }
+      k--;
     }
-    cdm = new CachedDistanceMap(scale, max_dist);
+    k++;
+    v[k] = q;
+    z[k] = k == 0 ? -HUGE_VAL : s;
+    z[k + 1] = HUGE_VAL;
   }
 
-  return cdm;
-}
-
-/*
- * @brief enqueue cell data for caching
- */
-void enqueue(
-  map_t * map, int i, int j,
-  int src_i, int src_j,
-  std::priority_queue<CellData> & Q,
-  CachedDistanceMap * cdm,
-  unsigned char * marked)
-{
-  if (marked[MAP_INDEX(map, i, j)]) {
+  if (k < 0) {
     return;
   }
 
-  int di = abs(i - src_i);
-  int dj = abs(j - src_j);
-  double distance = cdm->distances_[di][dj];
-
-  if (distance > cdm->cell_radius_) {
-    return;
+  int j = 0;
+  for (int q = 0; q < n; q++) {
+    while (z[j + 1] < q) {
+      j++;
+    }
+    const double dq = q - v[j];
+    d[q] = std::min(static_cast<double>(far), dq * dq + f[v[j]]);
   }
-
-  map->cells[MAP_INDEX(map, i, j)].occ_dist = distance * map->scale;
-
-  CellData cell;
-  cell.map_ = map;
-  cell.i_ = i;
-  cell.j_ = j;
-  cell.src_i_ = src_i;
-  cell.src_j_ = src_j;
-
-  Q.push(cell);
-
-  marked[MAP_INDEX(map, i, j)] = 1;
+  std::copy(d.begin(), d.begin() + n, f);
 }
 
 /*
@@ -152,62 +107,66 @@ void enqueue(
  */
 void map_update_cspace(map_t * map, double max_occ_dist)
 {
-  unsigned char * marked;
-  std::priority_queue<CellData> Q;
-
-  marked = new unsigned char[map->size_x * map->size_y];
-  memset(marked, 0, sizeof(unsigned char) * map->size_x * map->size_y);
-
   map->max_occ_dist = max_occ_dist;
 
-  CachedDistanceMap * cdm = get_distance_map(map->scale, map->max_occ_dist);
-
-  // Enqueue all the obstacle cells
-  CellData cell;
-  cell.map_ = map;
-  for (int i = 0; i < map->size_x; i++) {
-    cell.src_i_ = cell.i_ = i;
-    for (int j = 0; j < map->size_y; j++) {
-      if (map->cells[MAP_INDEX(map, i, j)].occ_state == +1) {
-        map->cells[MAP_INDEX(map, i, j)].occ_dist = 0.0;
-        cell.src_j_ = cell.j_ = j;
-        marked[MAP_INDEX(map, i, j)] = 1;
-        Q.push(cell);
-      } else {
-        map->cells[MAP_INDEX(map, i, j)].occ_dist = max_occ_dist;
-      }
-    }
-  }
-
-  while (!Q.empty()) {
-    CellData current_cell = Q.top();
-    if (current_cell.i_ > 0) {
-      enqueue(
-        map, current_cell.i_ - 1, current_cell.j_,
-        current_cell.src_i_, current_cell.src_j_,
-        Q, cdm, marked);
-    }
-    if (current_cell.j_ > 0) {
-      enqueue(
-        map, current_cell.i_, current_cell.j_ - 1,
-        current_cell.src_i_, current_cell.src_j_,
-        Q, cdm, marked);
-    }
-    if (static_cast<int>(current_cell.i_) < map->size_x - 1) {
-      enqueue(
-        map, current_cell.i_ + 1, current_cell.j_,
-        current_cell.src_i_, current_cell.src_j_,
-        Q, cdm, marked);
-    }
-    if (static_cast<int>(current_cell.j_) < map->size_y - 1) {
-      enqueue(
-        map, current_cell.i_, current_cell.j_ + 1,
-        current_cell.src_i_, current_cell.src_j_,
-        Q, cdm, marked);
-    }
-
-    Q.pop();
+  const int size_x = map->size_x;
+  const int size_y = map->size_y;
+  if (size_x <= 0 || size_y <= 0) {
+    return;
   }
 
-  delete[] marked;
+  // Cells further than the cell radius from obstacles are set to the max distance, so the
+  // squared distances are clipped beyond it. They remain small integers, exact as floats,
+  // and are computed in place in occ_dist
+  const int cell_radius = max_occ_dist / map->scale;
+  const float far = static_cast<float>(cell_radius + 1) * (cell_radius + 1);
+  const float far_column = static_cast<float>(cell_radius + 1);
+
+  // Large maps block the node while loading, so both passes run across threads
+  const int threads = std::max(
+    1, std::min(
+      static_cast<int>(std::thread::hardware_concurrency()),
+      size_x * size_y / (1 << 20) + 1));
+
+  // Distance to the closest obstacle of each column, swept row by row for contiguous access,
+  // with the columns split across threads
+  run_in_chunks(
+    size_x, threads, [map, size_x, size_y, far_column](int begin, int end) {
+      for (int j = 0; j < size_y; j++) {
+        map_cell_t * row = map->cells + j * size_x;
+        const map_cell_t * prev = j > 0 ? row - size_x : nullptr;
+        for (int i = begin; i < end; i++) {
+          row[i].occ_dist = row[i].occ_state == +1 ? 0.0f :
+          (prev ? std::min(prev[i].occ_dist + 1.0f, far_column) : far_column);
+        }
+      }
+      for (int j = size_y - 2; j >= 0; j--) {
+        map_cell_t * row = map->cells + j * size_x;
+        const map_cell_t * next = row + size_x;
+        for (int i = begin; i < end; i++) {
+          row[i].occ_dist = std::min(row[i].occ_dist, next[i].occ_dist + 1.0f);
+        }
+      }
+    });
+
+  // Squared distances along each row, with the rows split across threads
+  const double scale = map->scale;
+  run_in_chunks(
+    size_y, threads, [map, size_x, far, cell_radius, scale, max_occ_dist](int begin, int end) {
+      std::vector<float> f(size_x);
+      std::vector<float> d(size_x);
+      std::vector<int> v(size_x);
+      std::vector<double> z(size_x + 1);
+      for (int j = begin; j < end; j++) {
+        map_cell_t * row = map->cells + j * size_x;
+        for (int i = 0; i < size_x; i++) {
+          f[i] = row[i].occ_dist >= cell_radius + 1 ? far : row[i].occ_dist * row[i].occ_dist;
+        }
+        distance_transform_row(f.data(), size_x, v, z, d, far);
+        for (int i = 0; i < size_x; i++) {
+          const double distance = sqrt(f[i]);
+          row[i].occ_dist = distance > cell_radius ? max_occ_dist : distance * scale;
+        }
+      }
+    });
 }
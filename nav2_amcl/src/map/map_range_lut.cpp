@@ -0,0 +1,130 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <math.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "nav2_amcl/map/map.hpp"
+
+// Ranges are stored in eighths of a cell, the largest value meaning that nothing
+// was hit within the maximum range the table was built for
+static constexpr double RANGE_LUT_UNITS_PER_CELL = 8.0;
+static constexpr uint16_t RANGE_LUT_NO_HIT = UINT16_MAX;
+
+void map_update_range_lut(map_t * map, int num_angles, double max_range)
+{
+  // Ranges beyond what the units can represent are left to the ray casting
+  max_range = std::min(
+    max_range, (RANGE_LUT_NO_HIT - 1) / RANGE_LUT_UNITS_PER_CELL * map->scale);
+
+  // Each laser model of the map asks for the ranges, which are only traced once
+  if (map->range_lut != NULL && map->range_lut_angles == num_angles &&
+    map->range_lut_max_range == max_range)
+  {
+    return;
+  }
+
+  free(map->range_lut_index);
+  free(map->range_lut);
+  map->range_lut_index = NULL;
+  map->range_lut = NULL;
+  map->range_lut_angles = 0;
+  map->range_lut_max_range = 0.0;
+
+  const int num_cells = map->size_x * map->size_y;
+  if (num_angles <= 0 || num_cells <= 0 || max_range <= 0.0) {
+    return;
+  }
+
+  // Only free cells may be the origin of a beam
+  map->range_lut_index = reinterpret_cast<int32_t *>(malloc(sizeof(int32_t) * num_cells));
+  int num_rows = 0;
+  for (int i = 0; i < num_cells; i++) {
+    map->range_lut_index[i] = map->cells[i].occ_state == -1 ? num_rows++ : -1;
+  }
+  map->range_lut = reinterpret_cast<uint16_t *>(
+    malloc(sizeof(uint16_t) * static_cast<size_t>(num_rows) * num_angles));
+  map->range_lut_angles = num_angles;
+  map->range_lut_max_range = max_range;
+
+  // Tracing the rays of a large map blocks the node while loading, so the rows of
+  // cells are shared between threads
+  const int threads = std::max(
+    1, std::min(
+      static_cast<int>(std::thread::hardware_concurrency()),
+      map->size_y / 16 + 1));
+  std::atomic<int> next_row{0};
+  auto trace_rows = [map, num_angles, max_range, &next_row]() {
+      for (int j = next_row++; j < map->size_y; j = next_row++) {
+        for (int i = 0; i < map->size_x; i++) {
+          const int row = map->range_lut_index[MAP_INDEX(map, i, j)];
+          if (row < 0) {
+            continue;
+          }
+          const double ox = MAP_WXGX(map, i);
+          const double oy = MAP_WYGY(map, j);
+          uint16_t * ranges = map->range_lut + static_cast<size_t>(row) * num_angles;
+          for (int a = 0; a < num_angles; a++) {
+            const double angle = 2.0 * M_PI * a / num_angles;
+            const double range = map_calc_range(map, ox, oy, angle, max_range);
+            ranges[a] = range >= max_range ? RANGE_LUT_NO_HIT :
+              static_cast<uint16_t>(lround(range / map->scale * RANGE_LUT_UNITS_PER_CELL));
+          }
+        }
+      }
+    };
+
+  std::vector<std::thread> workers;
+  for (int t = 1; t < threads; t++) {
+    workers.emplace_back(trace_rows);
+  }
+  trace_rows();
+  for (auto & worker : workers) {
+    worker.join();
+  }
+}
+
+double map_lookup_range(map_t * map, double ox, double oy, double oa, double max_range)
+{
+  if (map->range_lut == NULL) {
+    return map_calc_range(map, ox, oy, oa, max_range);
+  }
+
+  // Beams from cells which are not free are stopped right away
+  const int i = MAP_GXWX(map, ox);
+  const int j = MAP_GYWY(map, oy);
+  if (!MAP_VALID(map, i, j) || map->range_lut_index[MAP_INDEX(map, i, j)] < 0) {
+    return map_calc_range(map, ox, oy, oa, max_range);
+  }
+
+  const int num_angles = map->range_lut_angles;
+  int a = static_cast<int>(floor(oa * num_angles / (2.0 * M_PI) + 0.5)) % num_angles;
+  if (a < 0) {
+    a += num_angles;
+  }
+  const uint16_t range = map->range_lut[
+    static_cast<size_t>(map->range_lut_index[MAP_INDEX(map, i, j)]) * num_angles + a];
+
+  if (range == RANGE_LUT_NO_HIT) {
+    // Nothing within the range of the table, which may not cover the requested one
+    return max_range > map->range_lut_max_range ?
+           map_calc_range(map, ox, oy, oa, max_range) : max_range;
+  }
+  return std::min(max_range, range / RANGE_LUT_UNITS_PER_CELL * map->scale);
+}
@@ -49,7 +49,6 @@ DifferentialMotionModel::odometryUpdate(
 
   // Implement sample_motion_odometry (Prob Rob p 136)
   double delta_rot1, delta_trans, delta_rot2;
-  double delta_rot1_hat, delta_trans_hat, delta_rot2_hat;
   double delta_rot1_noise, delta_rot2_noise;
 
   // Avoid computing a bearing from two poses that are extremely near each
@@ -79,36 +78,39 @@ DifferentialMotionModel::odometryUpdate(
     fabs(angleutils::angle_diff(delta_rot2, 0.0)),
     fabs(angleutils::angle_diff(delta_rot2, M_PI)));
 
-  for (int i = 0; i < set->sample_count; i++) {
-    pf_sample_t * sample = set->samples + i;
+  // The spread of the noise is the same for all samples
+  const double rot1_stddev = sqrt(
+    alpha1_ * delta_rot1_noise * delta_rot1_noise +
+    alpha2_ * delta_trans * delta_trans);
+  const double trans_stddev = sqrt(
+    alpha3_ * delta_trans * delta_trans +
+    alpha4_ * delta_rot1_noise * delta_rot1_noise +
+    alpha4_ * delta_rot2_noise * delta_rot2_noise);
+  const double rot2_stddev = sqrt(
+    alpha1_ * delta_rot2_noise * delta_rot2_noise +
+    alpha2_ * delta_trans * delta_trans);
 
-    // Sample pose differences
-    delta_rot1_hat = angleutils::angle_diff(
-      delta_rot1,
-      pf_ran_gaussian(
-        sqrt(
-          alpha1_ * delta_rot1_noise * delta_rot1_noise +
-          alpha2_ * delta_trans * delta_trans)));
-    delta_trans_hat = delta_trans -
-      pf_ran_gaussian(
-      sqrt(
-        alpha3_ * delta_trans * delta_trans +
-        alpha4_ * delta_rot1_noise * delta_rot1_noise +
-        alpha4_ * delta_rot2_noise * delta_rot2_noise));
-    delta_rot2_hat = angleutils::angle_diff(
-      delta_rot2,
-      pf_ran_gaussian(
-        sqrt(
-          alpha1_ * delta_rot2_noise * delta_rot2_noise +
-          alpha2_ * delta_trans * delta_trans)));
+  updateSamples(
+    set, [&](int begin, int end) {
+      for (int i = begin; i < end; i++) {
+        pf_sample_t * sample = set->samples + i;
+        double n_rot1, n_trans, n_rot2, unused;
+        noise_.normals(i, 0, n_rot1, n_trans);
+        noise_.normals(i, 1, n_rot2, unused);
 
-    // Apply sampled update to particle pose
-    sample->pose.v[0] += delta_trans_hat *
-      cos(sample->pose.v[2] + delta_rot1_hat);
-    sample->pose.v[1] += delta_trans_hat *
-      sin(sample->pose.v[2] + delta_rot1_hat);
-    sample->pose.v[2] += delta_rot1_hat + delta_rot2_hat;
-  }
+        // Sample pose differences
+        const double delta_rot1_hat = angleutils::angle_diff(delta_rot1, rot1_stddev * n_rot1);
+        const double delta_trans_hat = delta_trans - trans_stddev * n_trans;
+        const double delta_rot2_hat = angleutils::angle_diff(delta_rot2, rot2_stddev * n_rot2);
+
+        // Apply sampled update to particle pose
+        sample->pose.v[0] += delta_trans_hat *
+          cos(sample->pose.v[2] + delta_rot1_hat);
+        sample->pose.v[1] += delta_trans_hat *
+          sin(sample->pose.v[2] + delta_rot1_hat);
+        sample->pose.v[2] += delta_rot1_hat + delta_rot2_hat;
+      }
+    });
 }
 
 }  // namespace nav2_amcl
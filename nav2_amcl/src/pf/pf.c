@@ -72,6 +72,8 @@ pf_t * pf_alloc(
   pf->pop_z = 3;
   pf->dist_threshold = 0.5;
 
+  pf->resample_indices = calloc(max_samples, sizeof(int));
+
   pf->current_set = 0;
   for (j = 0; j < 2; j++) {
     set = pf->sets + j;
@@ -120,6 +122,7 @@ void pf_free(pf_t * pf)
     pf_kdtree_free(pf->sets[i].kdtree);
     free(pf->sets[i].samples);
   }
+  free(pf->resample_indices);
   free(pf);
 }
 
@@ -292,28 +295,36 @@ void pf_update_sensor(pf_t * pf, pf_sensor_model_fn_t sensor_fn, void * sensor_d
 // Resample the distribution
 void pf_update_resample(pf_t * pf, void * random_pose_data)
 {
-  int i;
+  int i, j, m;
   double total;
   pf_sample_set_t * set_a, * set_b;
   pf_sample_t * sample_a, * sample_b;
 
-  // double r,c,U;
-  // int m;
-  // double count_inv;
-  double * c;
+  double r, c, U;
+  int count;
+  double count_inv;
+  int * indices;
 
   double w_diff;
 
   set_a = pf->sets + pf->current_set;
   set_b = pf->sets + (pf->current_set + 1) % 2;
 
-  // Build up cumulative probability table for resampling.
-  // TODO(?): Replace this with a more efficient procedure
-  // (e.g., http://www.network-theory.co.uk/docs/gslref/GeneralDiscreteDistributions.html)
-  c = (double *)malloc(sizeof(double) * (set_a->sample_count + 1));
-  c[0] = 0.0;
-  for (i = 0; i < set_a->sample_count; i++) {
-    c[i + 1] = c[i] + set_a->samples[i].weight;
+  // Low-variance resampler, taken from Probabilistic Robotics, p110, drawing
+  // max_samples samples of set a at once into the preallocated indices
+  count = pf->max_samples;
+  count_inv = 1.0 / count;
+  indices = pf->resample_indices;
+  r = drand48() * count_inv;
+  c = set_a->samples[0].weight;
+  i = 0;
+  for (m = 0; m < count; m++) {
+    U = r + m * count_inv;
+    while (U >= c && i < set_a->sample_count - 1) {
+      i++;
+      c += set_a->samples[i].weight;
+    }
+    indices[m] = i;
   }
 
   // Create the kd tree for adaptive sampling
@@ -329,60 +340,27 @@ void pf_update_resample(pf_t * pf, void * random_pose_data)
   }
   // printf("w_diff: %9.6f\n", w_diff);
 
-  // Can't (easily) combine low-variance sampler with KLD adaptive
-  // sampling, so we'll take the more traditional route.
-  /*
-  // Low-variance resampler, taken from Probabilistic Robotics, p110
-  count_inv = 1.0/set_a->sample_count;
-  r = drand48() * count_inv;
-  c = set_a->samples[0].weight;
-  i = 0;
-  m = 0;
-  */
+  // KLD adaptive sampling stops after any number of samples, so the drawn samples
+  // are taken in a random order, shuffling them as they are taken, for any prefix
+  // of them to be a fair sample too.
   while (set_b->sample_count < pf->max_samples) {
+    m = set_b->sample_count;
     sample_b = set_b->samples + set_b->sample_count++;
 
     if (drand48() < w_diff) {
       sample_b->pose = (pf->random_pose_fn)(random_pose_data);
     } else {
-      // Can't (easily) combine low-variance sampler with KLD adaptive
-      // sampling, so we'll take the more traditional route.
-      /*
-      // Low-variance resampler, taken from Probabilistic Robotics, p110
-      U = r + m * count_inv;
-      while(U>c)
-      {
-        i++;
-        // Handle wrap-around by resetting counters and picking a new random
-        // number
-        if(i >= set_a->sample_count)
-        {
-          r = drand48() * count_inv;
-          c = set_a->samples[0].weight;
-          i = 0;
-          m = 0;
-          U = r + m * count_inv;
-          continue;
-        }
-        c += set_a->samples[i].weight;
+      // Take one of the drawn samples not taken yet
+      j = m + (int) (drand48() * (count - m));
+      if (j >= count) {
+        j = count - 1;
       }
-      m++;
-      */
-
-      // Naive discrete event sampler
-      double r;
-      r = drand48();
-      for (i = 0; i < set_a->sample_count; i++) {
-        if ((c[i] <= r) && (r < c[i + 1])) {
-          break;
-        }
-      }
-      assert(i < set_a->sample_count);
+      i = indices[j];
+      indices[j] = indices[m];
+      indices[m] = i;
 
       sample_a = set_a->samples + i;
 
-      assert(sample_a->weight > 0);
-
       // Add sample to list
       sample_b->pose = sample_a->pose;
     }
@@ -419,8 +397,6 @@ void pf_update_resample(pf_t * pf, void * random_pose_data)
   pf->current_set = (pf->current_set + 1) % 2;
 
   pf_update_converged(pf);
-
-  free(c);
 }
 
 
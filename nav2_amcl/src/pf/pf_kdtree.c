@@ -35,29 +35,22 @@
 #include "nav2_amcl/pf/pf_kdtree.hpp"
 
 
-// Compare keys to see if they are equal
-static int pf_kdtree_equal(pf_kdtree_t * self, int key_a[], int key_b[]);
+// Compute the key of a pose
+static void pf_kdtree_key(pf_kdtree_t * self, pf_vector_t pose, int key[]);
 
-// Insert a node into the tree
-static pf_kdtree_node_t * pf_kdtree_insert_node(
-  pf_kdtree_t * self, pf_kdtree_node_t * parent,
-  pf_kdtree_node_t * node, int key[], double value);
+// Find the slot of a key in the table, either holding its bin or empty
+static int pf_kdtree_find_slot(pf_kdtree_t * self, int key[]);
 
-// Recursive node search
-static pf_kdtree_node_t * pf_kdtree_find_node(
-  pf_kdtree_t * self, pf_kdtree_node_t * node,
-  int key[]);
+// Find the bin of a key, NULL if there is none
+static pf_kdtree_node_t * pf_kdtree_find_node(pf_kdtree_t * self, int key[]);
 
-// Recursively label nodes in this cluster
-static void pf_kdtree_cluster_node(pf_kdtree_t * self, pf_kdtree_node_t * node, int depth);
-
-// Recursive node printing
-// static void pf_kdtree_print_node(pf_kdtree_t *self, pf_kdtree_node_t *node);
+// Label the bins in the cluster of this one
+static void pf_kdtree_cluster_node(pf_kdtree_t * self, pf_kdtree_node_t * node);
 
 
 #ifdef INCLUDE_RTKGUI
 
-// Recursively draw nodes
+// Draw a bin
 static void pf_kdtree_draw_node(pf_kdtree_t * self, pf_kdtree_node_t * node, rtk_fig_t * fig);
 
 #endif
@@ -75,12 +68,19 @@ pf_kdtree_t * pf_kdtree_alloc(int max_size)
   self->size[1] = 0.50;
   self->size[2] = (10 * M_PI / 180);
 
-  self->root = NULL;
-
   self->node_count = 0;
   self->node_max_count = max_size;
   self->nodes = calloc(self->node_max_count, sizeof(pf_kdtree_node_t));
 
+  // Keep the table at most half full so that probing stays short
+  self->table_size = 1;
+  while (self->table_size < 2 * max_size) {
+    self->table_size *= 2;
+  }
+  self->table = calloc(self->table_size, sizeof(int));
+
+  self->stack = calloc(self->node_max_count, sizeof(int));
+
   self->leaf_count = 0;
 
   return self;
@@ -91,6 +91,8 @@ pf_kdtree_t * pf_kdtree_alloc(int max_size)
 // Destroy a tree
 void pf_kdtree_free(pf_kdtree_t * self)
 {
+  free(self->stack);
+  free(self->table);
   free(self->nodes);
   free(self);
 }
@@ -100,7 +102,14 @@ void pf_kdtree_free(pf_kdtree_t * self)
 // Clear all entries from the tree
 void pf_kdtree_clear(pf_kdtree_t * self)
 {
-  self->root = NULL;
+  int i;
+
+  // Only empty the slots of the bins, rather than the whole table. Going from the last bin
+  // inserted, the probing of each bin finds the same slots as when it was inserted
+  for (i = self->node_count - 1; i >= 0; i--) {
+    self->table[pf_kdtree_find_slot(self, self->nodes[i].key)] = 0;
+  }
+
   self->leaf_count = 0;
   self->node_count = 0;
 }
@@ -110,57 +119,32 @@ void pf_kdtree_clear(pf_kdtree_t * self)
 // Insert a pose into the tree.
 void pf_kdtree_insert(pf_kdtree_t * self, pf_vector_t pose, double value)
 {
+  int i, slot;
   int key[3];
+  pf_kdtree_node_t * node;
 
-  key[0] = floor(pose.v[0] / self->size[0]);
-  key[1] = floor(pose.v[1] / self->size[1]);
-  key[2] = floor(pose.v[2] / self->size[2]);
-
-  self->root = pf_kdtree_insert_node(self, NULL, self->root, key, value);
-
-  // Test code
-  /*
-  printf("find %d %d %d\n", key[0], key[1], key[2]);
-  assert(pf_kdtree_find_node(self, self->root, key) != NULL);
-
-  pf_kdtree_print_node(self, self->root);
+  pf_kdtree_key(self, pose, key);
 
-  printf("\n");
+  slot = pf_kdtree_find_slot(self, key);
+  if (self->table[slot] > 0) {
+    // If the bin exists, increment the value
+    self->nodes[self->table[slot] - 1].value += value;
+    return;
+  }
 
-  for (i = 0; i < self->node_count; i++)
-  {
-    node = self->nodes + i;
-    if (node->leaf)
-    {
-      printf("find %d %d %d\n", node->key[0], node->key[1], node->key[2]);
-      assert(pf_kdtree_find_node(self, self->root, node->key) == node);
-    }
+  assert(self->node_count < self->node_max_count);
+  node = self->nodes + self->node_count++;
+  node->leaf = 1;
+  for (i = 0; i < 3; i++) {
+    node->key[i] = key[i];
   }
-  printf("\n\n");
-  */
+  node->value = value;
+  node->cluster = -1;
+  self->table[slot] = self->node_count;
+  self->leaf_count += 1;
 }
 
 
-////////////////////////////////////////////////////////////////////////////////
-// Determine the probability estimate for the given pose. TODO: this
-// should do a kernel density estimate rather than a simple histogram.
-// double pf_kdtree_get_prob(pf_kdtree_t * self, pf_vector_t pose)
-// {
-//   int key[3];
-//   pf_kdtree_node_t * node;
-
-//   key[0] = floor(pose.v[0] / self->size[0]);
-//   key[1] = floor(pose.v[1] / self->size[1]);
-//   key[2] = floor(pose.v[2] / self->size[2]);
-
-//   node = pf_kdtree_find_node(self, self->root, key);
-//   if (node == NULL) {
-//     return 0.0;
-//   }
-//   return node->value;
-// }
-
-
 ////////////////////////////////////////////////////////////////////////////////
 // Determine the cluster label for the given pose
 int pf_kdtree_get_cluster(pf_kdtree_t * self, pf_vector_t pose)
@@ -168,11 +152,9 @@ int pf_kdtree_get_cluster(pf_kdtree_t * self, pf_vector_t pose)
   int key[3];
   pf_kdtree_node_t * node;
 
-  key[0] = floor(pose.v[0] / self->size[0]);
-  key[1] = floor(pose.v[1] / self->size[1]);
-  key[2] = floor(pose.v[2] / self->size[2]);
+  pf_kdtree_key(self, pose, key);
 
-  node = pf_kdtree_find_node(self, self->root, key);
+  node = pf_kdtree_find_node(self, key);
   if (node == NULL) {
     return -1;
   }
@@ -181,194 +163,68 @@ int pf_kdtree_get_cluster(pf_kdtree_t * self, pf_vector_t pose)
 
 
 ////////////////////////////////////////////////////////////////////////////////
-// Compare keys to see if they are equal
-int pf_kdtree_equal(pf_kdtree_t * self, int key_a[], int key_b[])
+// Compute the key of a pose
+void pf_kdtree_key(pf_kdtree_t * self, pf_vector_t pose, int key[])
 {
-  (void)self;
-  // double a, b;
-
-  if (key_a[0] != key_b[0]) {
-    return 0;
-  }
-  if (key_a[1] != key_b[1]) {
-    return 0;
-  }
-
-  if (key_a[2] != key_b[2]) {
-    return 0;
-  }
-
-  /* TODO: make this work (pivot selection needs fixing, too)
-  // Normalize angles
-  a = key_a[2] * self->size[2];
-  a = atan2(sin(a), cos(a)) / self->size[2];
-  b = key_b[2] * self->size[2];
-  b = atan2(sin(b), cos(b)) / self->size[2];
-
- if ((int) a != (int) b)
-    return 0;
-  */
-
-  return 1;
+  key[0] = floor(pose.v[0] / self->size[0]);
+  key[1] = floor(pose.v[1] / self->size[1]);
+  key[2] = floor(pose.v[2] / self->size[2]);
 }
 
 
 ////////////////////////////////////////////////////////////////////////////////
-// Insert a node into the tree
-pf_kdtree_node_t * pf_kdtree_insert_node(
-  pf_kdtree_t * self, pf_kdtree_node_t * parent,
-  pf_kdtree_node_t * node, int key[], double value)
+// Find the slot of a key in the table, either holding its bin or empty
+int pf_kdtree_find_slot(pf_kdtree_t * self, int key[])
 {
-  int i;
-  int split, max_split;
-
-  // If the node doesnt exist yet...
-  if (node == NULL) {
-    assert(self->node_count < self->node_max_count);
-    node = self->nodes + self->node_count++;
-    memset(node, 0, sizeof(pf_kdtree_node_t));
-
-    node->leaf = 1;
-
-    if (parent == NULL) {
-      node->depth = 0;
-    } else {
-      node->depth = parent->depth + 1;
-    }
-
-    for (i = 0; i < 3; i++) {
-      node->key[i] = key[i];
-    }
-
-    node->value = value;
-    self->leaf_count += 1;
-  } else if (node->leaf) {  // If the node exists, and it is a leaf node...
-    // If the keys are equal, increment the value
-    if (pf_kdtree_equal(self, key, node->key)) {
-      node->value += value;
-    } else {  // The keys are not equal, so split this node
-      // Find the dimension with the largest variance and do a mean
-      // split
-      max_split = 0;
-      node->pivot_dim = -1;
-      for (i = 0; i < 3; i++) {
-        split = abs(key[i] - node->key[i]);
-        if (split > max_split) {
-          max_split = split;
-          node->pivot_dim = i;
-        }
-      }
-      assert(node->pivot_dim >= 0);
-
-      node->pivot_value = (key[node->pivot_dim] + node->key[node->pivot_dim]) / 2.0;
+  unsigned int hash, mask;
+  pf_kdtree_node_t * node;
 
-      if (key[node->pivot_dim] < node->pivot_value) {
-        node->children[0] = pf_kdtree_insert_node(self, node, NULL, key, value);
-        node->children[1] = pf_kdtree_insert_node(self, node, NULL, node->key, node->value);
-      } else {
-        node->children[0] = pf_kdtree_insert_node(self, node, NULL, node->key, node->value);
-        node->children[1] = pf_kdtree_insert_node(self, node, NULL, key, value);
-      }
+  hash = ((unsigned int) key[0] * 73856093u) ^ ((unsigned int) key[1] * 19349663u) ^
+    ((unsigned int) key[2] * 83492791u);
+  mask = (unsigned int) self->table_size - 1;
 
-      node->leaf = 0;
-      self->leaf_count -= 1;
-    }
-  } else {  // If the node exists, and it has children...
-    assert(node->children[0] != NULL);
-    assert(node->children[1] != NULL);
-
-    if (key[node->pivot_dim] < node->pivot_value) {
-      pf_kdtree_insert_node(self, node, node->children[0], key, value);
-    } else {
-      pf_kdtree_insert_node(self, node, node->children[1], key, value);
+  // Linear probing
+  for (hash &= mask; self->table[hash] > 0; hash = (hash + 1) & mask) {
+    node = self->nodes + self->table[hash] - 1;
+    if (node->key[0] == key[0] && node->key[1] == key[1] && node->key[2] == key[2]) {
+      break;
     }
   }
-
-  return node;
+  return (int) hash;
 }
 
 
 ////////////////////////////////////////////////////////////////////////////////
-// Recursive node search
-pf_kdtree_node_t * pf_kdtree_find_node(pf_kdtree_t * self, pf_kdtree_node_t * node, int key[])
+// Find the bin of a key, NULL if there is none
+pf_kdtree_node_t * pf_kdtree_find_node(pf_kdtree_t * self, int key[])
 {
-  if (node->leaf) {
-    // printf("find  : leaf %p %d %d %d\n", node, node->key[0], node->key[1], node->key[2]);
-
-    // If the keys are the same...
-    if (pf_kdtree_equal(self, key, node->key)) {
-      return node;
-    } else {
-      return NULL;
-    }
-  } else {
-    // printf("find  : brch %p %d %f\n", node, node->pivot_dim, node->pivot_value);
-
-    assert(node->children[0] != NULL);
-    assert(node->children[1] != NULL);
+  int slot;
 
-    // If the keys are different...
-    if (key[node->pivot_dim] < node->pivot_value) {
-      return pf_kdtree_find_node(self, node->children[0], key);
-    } else {
-      return pf_kdtree_find_node(self, node->children[1], key);
-    }
+  slot = pf_kdtree_find_slot(self, key);
+  if (self->table[slot] == 0) {
+    return NULL;
   }
-
-  return NULL;
+  return self->nodes + self->table[slot] - 1;
 }
 
 
-////////////////////////////////////////////////////////////////////////////////
-// Recursive node printing
-/*
-void pf_kdtree_print_node(pf_kdtree_t *self, pf_kdtree_node_t *node)
-{
-  if (node->leaf)
-  {
-    printf("(%+02d %+02d %+02d)\n", node->key[0], node->key[1], node->key[2]);
-    printf("%*s", node->depth * 11, "");
-  }
-  else
-  {
-    printf("(%+02d %+02d %+02d) ", node->key[0], node->key[1], node->key[2]);
-    pf_kdtree_print_node(self, node->children[0]);
-    pf_kdtree_print_node(self, node->children[1]);
-  }
-  return;
-}
-*/
-
-
 ////////////////////////////////////////////////////////////////////////////////
 // Cluster the leaves in the tree
 void pf_kdtree_cluster(pf_kdtree_t * self)
 {
   int i;
-  int queue_count, cluster_count;
-  pf_kdtree_node_t ** queue, * node;
-
-  queue_count = 0;
-  queue = calloc(self->node_count, sizeof(queue[0]));
+  int cluster_count;
+  pf_kdtree_node_t * node;
 
-  // Put all the leaves in a queue
   for (i = 0; i < self->node_count; i++) {
-    node = self->nodes + i;
-    if (node->leaf) {
-      node->cluster = -1;
-      assert(queue_count < self->node_count);
-      queue[queue_count++] = node;
-
-      // TESTING; remove
-      assert(node == pf_kdtree_find_node(self, self->root, node->key));
-    }
+    self->nodes[i].cluster = -1;
   }
 
   cluster_count = 0;
 
   // Do connected components for each node
-  while (queue_count > 0) {
-    node = queue[--queue_count];
+  for (i = self->node_count - 1; i >= 0; i--) {
+    node = self->nodes + i;
 
     // If this node has already been labelled, skip it
     if (node->cluster >= 0) {
@@ -378,45 +234,49 @@ void pf_kdtree_cluster(pf_kdtree_t * self)
     // Assign a label to this cluster
     node->cluster = cluster_count++;
 
-    // Recursively label nodes in this cluster
-    pf_kdtree_cluster_node(self, node, 0);
+    // Label nodes in this cluster
+    pf_kdtree_cluster_node(self, node);
   }
-
-  free(queue);
 }
 
 
 ////////////////////////////////////////////////////////////////////////////////
-// Recursively label nodes in this cluster
-void pf_kdtree_cluster_node(pf_kdtree_t * self, pf_kdtree_node_t * node, int depth)
+// Label the bins in the cluster of this one, with a stack rather than recursion
+void pf_kdtree_cluster_node(pf_kdtree_t * self, pf_kdtree_node_t * node)
 {
   int i;
+  int stack_count;
   int nkey[3];
   pf_kdtree_node_t * nnode;
 
-  for (i = 0; i < 3 * 3 * 3; i++) {
-    nkey[0] = node->key[0] + (i / 9) - 1;
-    nkey[1] = node->key[1] + ((i % 9) / 3) - 1;
-    nkey[2] = node->key[2] + ((i % 9) % 3) - 1;
+  stack_count = 0;
+  self->stack[stack_count++] = node - self->nodes;
 
-    nnode = pf_kdtree_find_node(self, self->root, nkey);
-    if (nnode == NULL) {
-      continue;
-    }
+  while (stack_count > 0) {
+    node = self->nodes + self->stack[--stack_count];
 
-    assert(nnode->leaf);
+    for (i = 0; i < 3 * 3 * 3; i++) {
+      nkey[0] = node->key[0] + (i / 9) - 1;
+      nkey[1] = node->key[1] + ((i % 9) / 3) - 1;
+      nkey[2] = node->key[2] + ((i % 9) % 3) - 1;
 
-    // This node already has a label; skip it.  The label should be
-    // consistent, however.
-    if (nnode->cluster >= 0) {
-      assert(nnode->cluster == node->cluster);
-      continue;
-    }
+      nnode = pf_kdtree_find_node(self, nkey);
+      if (nnode == NULL) {
+        continue;
+      }
 
-    // Label this node and recurse
-    nnode->cluster = node->cluster;
+      // This node already has a label; skip it.  The label should be
+      // consistent, however.
+      if (nnode->cluster >= 0) {
+        assert(nnode->cluster == node->cluster);
+        continue;
+      }
 
-    pf_kdtree_cluster_node(self, nnode, depth + 1);
+      // Label this node and visit its neighbours. Each bin is pushed once, when labelled
+      nnode->cluster = node->cluster;
+      assert(stack_count < self->node_max_count);
+      self->stack[stack_count++] = nnode - self->nodes;
+    }
   }
 }
 
@@ -427,36 +287,31 @@ void pf_kdtree_cluster_node(pf_kdtree_t * self, pf_kdtree_node_t * node, int dep
 // Draw the tree
 void pf_kdtree_draw(pf_kdtree_t * self, rtk_fig_t * fig)
 {
-  if (self->root != NULL) {
-    pf_kdtree_draw_node(self, self->root, fig);
+  int i;
+
+  for (i = 0; i < self->node_count; i++) {
+    pf_kdtree_draw_node(self, self->nodes + i, fig);
   }
 }
 
 
 ////////////////////////////////////////////////////////////////////////////////
-// Recursively draw nodes
+// Draw a bin
 void pf_kdtree_draw_node(pf_kdtree_t * self, pf_kdtree_node_t * node, rtk_fig_t * fig)
 {
   double ox, oy;
   char text[64];
 
-  if (node->leaf) {
-    ox = (node->key[0] + 0.5) * self->size[0];
-    oy = (node->key[1] + 0.5) * self->size[1];
+  ox = (node->key[0] + 0.5) * self->size[0];
+  oy = (node->key[1] + 0.5) * self->size[1];
 
-    rtk_fig_rectangle(fig, ox, oy, 0.0, self->size[0], self->size[1], 0);
+  rtk_fig_rectangle(fig, ox, oy, 0.0, self->size[0], self->size[1], 0);
 
-    // snprintf(text, sizeof(text), "%0.3f", node->value);
-    // rtk_fig_text(fig, ox, oy, 0.0, text);
+  // snprintf(text, sizeof(text), "%0.3f", node->value);
+  // rtk_fig_text(fig, ox, oy, 0.0, text);
 
-    snprintf(text, sizeof(text), "%d", node->cluster);
-    rtk_fig_text(fig, ox, oy, 0.0, text);
-  } else {
-    assert(node->children[0] != NULL);
-    assert(node->children[1] != NULL);
-    pf_kdtree_draw_node(self, node->children[0], fig);
-    pf_kdtree_draw_node(self, node->children[1], fig);
-  }
+  snprintf(text, sizeof(text), "%d", node->cluster);
+  rtk_fig_text(fig, ox, oy, 0.0, text);
 }
 
 #endif
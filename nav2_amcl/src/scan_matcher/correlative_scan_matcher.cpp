@@ -0,0 +1,221 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_amcl/scan_matcher/correlative_scan_matcher.hpp"
+
+#include <math.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "nav2_amcl/angleutils.hpp"
+
+namespace nav2_amcl
+{
+
+void CorrelativeScanMatcher::setMap(map_t * map, double sigma, int depth)
+{
+  map_ = map;
+  levels_.clear();
+  if (map->size_x <= 0 || map->size_y <= 0) {
+    return;
+  }
+
+  // The likelihood field models compute the distances to obstacles, otherwise they are
+  // computed far enough for the likelihood to vanish
+  if (map->max_occ_dist <= 0.0) {
+    map_update_cspace(map, std::max(1.0, 4.0 * sigma));
+  }
+
+  // Cells, quantized to a byte so that the levels stay small on large maps
+  levels_.resize(std::max(depth, 0) + 1);
+  Level & cells = levels_[0];
+  cells.size_x = map->size_x;
+  cells.size_y = map->size_y;
+  cells.likelihoods.resize(static_cast<size_t>(cells.size_x) * cells.size_y);
+  const double denominator = 2.0 * sigma * sigma;
+  for (size_t i = 0; i < cells.likelihoods.size(); i++) {
+    const double distance = map->cells[i].occ_dist;
+    cells.likelihoods[i] = static_cast<uint8_t>(lround(255.0 * exp(-distance * distance /
+      denominator)));
+  }
+
+  // Each level from the level below, as the maximum of the four windows of half the size
+  // making up each of its windows
+  for (size_t k = 1; k < levels_.size(); k++) {
+    const Level & below = levels_[k - 1];
+    Level & level = levels_[k];
+    const int width = 1 << k;
+    const int half = width / 2;
+    level.padding = width - 1;
+    level.size_x = map->size_x + level.padding;
+    level.size_y = map->size_y + level.padding;
+    level.likelihoods.resize(static_cast<size_t>(level.size_x) * level.size_y);
+    for (int py = 0; py < level.size_y; py++) {
+      const int y = py - level.padding;
+      for (int px = 0; px < level.size_x; px++) {
+        const int x = px - level.padding;
+        const int likelihood = std::max(
+          std::max(below.likelihood(x, y), below.likelihood(x + half, y)),
+          std::max(below.likelihood(x, y + half), below.likelihood(x + half, y + half)));
+        level.likelihoods[px + py * level.size_x] = static_cast<uint8_t>(likelihood);
+      }
+    }
+  }
+}
+
+int CorrelativeScanMatcher::score(
+  const Level & level, const RotatedScan & scan, int x, int y) const
+{
+  int sum = 0;
+  for (size_t i = 0; i < scan.offset_x.size(); i++) {
+    sum += level.likelihood(x + scan.offset_x[i], y + scan.offset_y[i]);
+  }
+  return sum;
+}
+
+std::vector<ScanMatch> CorrelativeScanMatcher::match(
+  const std::vector<pf_vector_t> & points, int max_matches, double min_score,
+  double min_separation) const
+{
+  std::vector<ScanMatch> results;
+  if (!isInitialized() || levels_.empty() || points.empty() || max_matches <= 0) {
+    return results;
+  }
+
+  // Headings spaced so that the furthest point moves by about a cell between them
+  double max_range = 0.0;
+  for (const auto & point : points) {
+    max_range = std::max(max_range, hypot(point.v[0], point.v[1]));
+  }
+  const double scale = map_->scale;
+  const double angular_step = max_range > scale ?
+    acos(1.0 - scale * scale / (2.0 * max_range * max_range)) : M_PI / 4.0;
+  const int num_headings = static_cast<int>(ceil(2.0 * M_PI / angular_step));
+
+  std::vector<RotatedScan> scans(num_headings);
+  for (int i = 0; i < num_headings; i++) {
+    RotatedScan & scan = scans[i];
+    scan.yaw = -M_PI + 2.0 * M_PI * i / num_headings;
+    const double c = cos(scan.yaw);
+    const double s = sin(scan.yaw);
+    scan.offset_x.reserve(points.size());
+    scan.offset_y.reserve(points.size());
+    for (const auto & point : points) {
+      scan.offset_x.push_back(
+        static_cast<int>(floor((c * point.v[0] - s * point.v[1]) / scale + 0.5)));
+      scan.offset_y.push_back(
+        static_cast<int>(floor((s * point.v[0] + c * point.v[1]) / scale + 0.5)));
+    }
+  }
+
+  // Windows of the coarsest level covering the map at every heading
+  const int top = static_cast<int>(levels_.size()) - 1;
+  const int width = 1 << top;
+  std::vector<Candidate> candidates;
+  for (int i = 0; i < num_headings; i++) {
+    for (int y = 0; y < map_->size_y; y += width) {
+      for (int x = 0; x < map_->size_x; x += width) {
+        candidates.push_back({i, x, y, score(levels_[top], scans[i], x, y)});
+      }
+    }
+  }
+  std::sort(
+    candidates.begin(), candidates.end(),
+    [](const Candidate & a, const Candidate & b) {return a.score > b.score;});
+
+  const int min_units = static_cast<int>(ceil(min_score * 255.0 * points.size()));
+  std::vector<Candidate> matches;
+  search(scans, candidates, top, min_units, max_matches, min_separation / scale, matches);
+
+  for (const auto & match : matches) {
+    ScanMatch result;
+    result.pose.v[0] = MAP_WXGX(map_, match.x);
+    result.pose.v[1] = MAP_WYGY(map_, match.y);
+    result.pose.v[2] = scans[match.scan].yaw;
+    result.score = match.score / (255.0 * points.size());
+    results.push_back(result);
+  }
+  return results;
+}
+
+void CorrelativeScanMatcher::search(
+  const std::vector<RotatedScan> & scans, const std::vector<Candidate> & candidates,
+  int level, int min_score, int max_matches, double min_separation,
+  std::vector<Candidate> & matches) const
+{
+  for (const Candidate & candidate : candidates) {
+    // Candidates are sorted, so none of the next ones may be a better match either
+    const bool full = static_cast<int>(matches.size()) >= max_matches;
+    if (candidate.score < min_score || (full && candidate.score <= matches.back().score)) {
+      return;
+    }
+
+    if (level == 0) {
+      // The scan's frame must be in free space
+      if (map_->cells[MAP_INDEX(map_, candidate.x, candidate.y)].occ_state != -1) {
+        continue;
+      }
+
+      // Only the best of the matches close to each other in position and heading is kept
+      bool dominated = false;
+      for (auto it = matches.begin(); it != matches.end(); ) {
+        const double distance = hypot(candidate.x - it->x, candidate.y - it->y);
+        const double heading_difference = fabs(
+          angleutils::angle_diff(scans[candidate.scan].yaw, scans[it->scan].yaw));
+        if (distance >= min_separation || heading_difference >= M_PI / 4.0) {
+          ++it;
+        } else if (it->score >= candidate.score) {
+          dominated = true;
+          break;
+        } else {
+          it = matches.erase(it);
+        }
+      }
+      if (dominated) {
+        continue;
+      }
+      matches.insert(
+        std::upper_bound(
+          matches.begin(), matches.end(), candidate,
+          [](const Candidate & a, const Candidate & b) {return a.score > b.score;}),
+        candidate);
+      if (static_cast<int>(matches.size()) > max_matches) {
+        matches.pop_back();
+      }
+      continue;
+    }
+
+    // Split the window into its four windows of the level below
+    const Level & below = levels_[level - 1];
+    const int half = 1 << (level - 1);
+    std::vector<Candidate> children;
+    children.reserve(4);
+    for (int dy = 0; dy <= half; dy += half) {
+      for (int dx = 0; dx <= half; dx += half) {
+        const int x = candidate.x + dx;
+        const int y = candidate.y + dy;
+        if (x < map_->size_x && y < map_->size_y) {
+          children.push_back({candidate.scan, x, y, score(below, scans[candidate.scan], x, y)});
+        }
+      }
+    }
+    std::sort(
+      children.begin(), children.end(),
+      [](const Candidate & a, const Candidate & b) {return a.score > b.score;});
+    search(scans, children, level - 1, min_score, max_matches, min_separation, matches);
+  }
+}
+
+}  // namespace nav2_amcl
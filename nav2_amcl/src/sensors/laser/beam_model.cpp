@@ -22,6 +22,8 @@
 #include <math.h>
 #include <assert.h>
 
+#include <vector>
+
 #include "nav2_amcl/sensors/laser/laser.hpp"
 
 namespace nav2_amcl
@@ -29,7 +31,8 @@ namespace nav2_amcl
 
 BeamModel::BeamModel(
   double z_hit, double z_short, double z_max, double z_rand, double sigma_hit,
-  double lambda_short, double chi_outlier, size_t max_beams, map_t * map)
+  double lambda_short, double chi_outlier, size_t max_beams, map_t * map,
+  int range_lut_angles, double range_lut_max_range)
 : Laser(max_beams, map)
 {
   z_hit_ = z_hit;
@@ -39,6 +42,7 @@ BeamModel::BeamModel(
   z_max_ = z_max;
   lambda_short_ = lambda_short;
   chi_outlier_ = chi_outlier;
+  map_update_range_lut(map, range_lut_angles, range_lut_max_range);
 }
 
 // Determine the probability for the given pose
@@ -46,80 +50,86 @@ double
 BeamModel::sensorFunction(LaserData * data, pf_sample_set_t * set)
 {
   BeamModel * self;
-  int i, j, step;
-  double z, pz;
-  double p;
-  double map_range;
-  double obs_range, obs_bearing;
-  double total_weight;
-  pf_sample_t * sample;
-  pf_vector_t pose;
+  int step;
 
   self = reinterpret_cast<BeamModel *>(data->laser);
 
-  total_weight = 0.0;
-
-  // Compute the sample weights
-  for (j = 0; j < set->sample_count; j++) {
-    sample = set->samples + j;
-    pose = sample->pose;
-
-    // Take account of the laser pose relative to the robot
-    pose = pf_vector_coord_add(self->laser_pose_, pose);
-
-    p = 1.0;
-
-    step = (data->range_count - 1) / (self->max_beams_ - 1);
-    for (i = 0; i < data->range_count; i += step) {
-      obs_range = data->ranges[i][0];
-
-      // Check for NaN
-      if (isnan(obs_range)) {
-        continue;
-      }
-
-      obs_bearing = data->ranges[i][1];
-
-      // Compute the range according to the map
-      map_range = map_calc_range(
-        self->map_, pose.v[0], pose.v[1],
-        pose.v[2] + obs_bearing, data->range_max);
-      pz = 0.0;
-
-      // Part 1: good, but noisy, hit
-      z = obs_range - map_range;
-      pz += self->z_hit_ * exp(-(z * z) / (2 * self->sigma_hit_ * self->sigma_hit_));
-
-      // Part 2: short reading from unexpected obstacle (e.g., a person)
-      if (z < 0) {
-        pz += self->z_short_ * self->lambda_short_ * exp(-self->lambda_short_ * obs_range);
-      }
-
-      // Part 3: Failure to detect obstacle, reported as max-range
-      if (obs_range == data->range_max) {
-        pz += self->z_max_ * 1.0;
-      }
-
-      // Part 4: Random measurements
-      if (obs_range < data->range_max) {
-        pz += self->z_rand_ * 1.0 / data->range_max;
-      }
-
-      // TODO(?): outlier rejection for short readings
-
-      assert(pz <= 1.0);
-      assert(pz >= 0.0);
-      //      p *= pz;
-      // here we have an ad-hoc weighting scheme for combining beam probs
-      // works well, though...
-      p += pz * pz * pz;
+  step = (data->range_count - 1) / (self->max_beams_ - 1);
+  self->collectBeams(data, step, false);
+
+  // Pre-compute the terms of each beam which do not depend on the sample
+  const double z_hit_denom = 2 * self->sigma_hit_ * self->sigma_hit_;
+  std::vector<double> pz_short(self->beams_.size());
+  std::vector<double> pz_range(self->beams_.size());
+  for (size_t i = 0; i < self->beams_.size(); i++) {
+    const double obs_range = self->beams_[i].range;
+    pz_short[i] = self->z_short_ * self->lambda_short_ * exp(-self->lambda_short_ * obs_range);
+
+    // Part 3: Failure to detect obstacle, reported as max-range
+    pz_range[i] = 0.0;
+    if (obs_range == data->range_max) {
+      pz_range[i] += self->z_max_ * 1.0;
     }
 
-    sample->weight *= p;
-    total_weight += sample->weight;
+    // Part 4: Random measurements
+    if (obs_range < data->range_max) {
+      pz_range[i] += self->z_rand_ * 1.0 / data->range_max;
+    }
   }
 
-  return total_weight;
+  const pf_vector_t & laser_pose = self->laser_pose_;
+
+  // Compute the sample weights
+  return self->weighSamples(
+    set, [&](int begin, int end, int) {
+      double thread_weight = 0.0;
+      for (int j = begin; j < end; j++) {
+        pf_sample_t * sample = set->samples + j;
+        const pf_vector_t & pose = sample->pose;
+        const double c = cos(pose.v[2]);
+        const double s = sin(pose.v[2]);
+
+        // Take account of the laser pose relative to the robot
+        const double x = pose.v[0] + laser_pose.v[0] * c - laser_pose.v[1] * s;
+        const double y = pose.v[1] + laser_pose.v[0] * s + laser_pose.v[1] * c;
+
+        double p = 1.0;
+
+        for (size_t i = 0; i < self->beams_.size(); i++) {
+          const Beam & beam = self->beams_[i];
+
+          // Compute the range according to the map
+          double map_range = map_lookup_range(
+            self->map_, x, y, pose.v[2] + beam.angle, data->range_max);
+          double pz = 0.0;
+
+          // Part 1: good, but noisy, hit
+          double z = beam.range - map_range;
+          pz += self->z_hit_ * exp(-(z * z) / z_hit_denom);
+
+          // Part 2: short reading from unexpected obstacle (e.g., a person)
+          if (z < 0) {
+            pz += pz_short[i];
+          }
+
+          // Parts 3 and 4
+          pz += pz_range[i];
+
+          // TODO(?): outlier rejection for short readings
+
+          assert(pz <= 1.0);
+          assert(pz >= 0.0);
+          //      p *= pz;
+          // here we have an ad-hoc weighting scheme for combining beam probs
+          // works well, though...
+          p += pz * pz * pz;
+        }
+
+        sample->weight *= p;
+        thread_weight += sample->weight;
+      }
+      return thread_weight;
+    });
 }
 
 bool
@@ -24,13 +24,22 @@
 #include <stdlib.h>
 #include <assert.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <vector>
+
 #include "nav2_amcl/sensors/laser/laser.hpp"
 
 namespace nav2_amcl
 {
 
 Laser::Laser(size_t max_beams, map_t * map)
-: max_samples_(0), max_obs_(0), temp_obs_(NULL)
+: max_samples_(0), max_obs_(0), temp_obs_(NULL), threads_(1), parallel_particles_(0),
+  adaptive_beam_selection_(false),
+  likelihood_field_min_(0.0), likelihood_field_step_(0.0), likelihood_field_range_max_(NAN),
+  max_occ_dist_likelihood_(0.0), map_inv_scale_(1.0), map_offset_x_(0.0), map_offset_y_(0.0)
 {
   max_beams_ = max_beams;
   map_ = map;
@@ -70,4 +79,216 @@ Laser::SetLaserPose(pf_vector_t & laser_pose)
   laser_pose_ = laser_pose;
 }
 
+bool
+Laser::fusedSensorUpdate(pf_t * pf, const std::vector<LaserData *> & data)
+{
+  std::vector<LaserData *> updating;
+  for (LaserData * laser_data : data) {
+    if (laser_data->laser->max_beams_ >= 2) {
+      updating.push_back(laser_data);
+    }
+  }
+  if (updating.empty()) {
+    return false;
+  }
+  pf_update_sensor(pf, fusedSensorFunction, &updating);
+
+  return true;
+}
+
+double
+Laser::fusedSensorFunction(void * data, pf_sample_set_t * set)
+{
+  double total_weight = 0.0;
+  for (LaserData * laser_data : *reinterpret_cast<std::vector<LaserData *> *>(data)) {
+    total_weight = laser_data->laser->applySensorModel(laser_data, set);
+  }
+  return total_weight;
+}
+
+void
+Laser::SetThreads(int threads)
+{
+  threads_ = std::max(threads, 1);
+}
+
+void
+Laser::SetParallelParticles(int parallel_particles)
+{
+  parallel_particles_ = std::max(parallel_particles, 0);
+}
+
+void
+Laser::SetAdaptiveBeamSelection(bool adaptive_beam_selection)
+{
+  adaptive_beam_selection_ = adaptive_beam_selection;
+}
+
+void
+Laser::collectBeams(LaserData * data, int step, bool skip_max_range)
+{
+  // Adaptive selection picks among all of the beams
+  if (adaptive_beam_selection_) {
+    step = 1;
+  }
+
+  beams_.clear();
+  int index = 0;
+  for (int i = 0; i < data->range_count; i += step, index++) {
+    const double obs_range = data->ranges[i][0];
+
+    // Check for NaN
+    if (isnan(obs_range)) {
+      continue;
+    }
+
+    if (skip_max_range && obs_range >= data->range_max) {
+      continue;
+    }
+
+    const double angle = laser_pose_.v[2] + data->ranges[i][1];
+    beams_.push_back(
+      {index, obs_range, angle, obs_range * cos(angle), obs_range * sin(angle)});
+  }
+
+  if (adaptive_beam_selection_) {
+    selectBeams();
+  }
+}
+
+void
+Laser::selectBeams()
+{
+  const int count = static_cast<int>(beams_.size());
+  if (count <= max_beams_ || max_beams_ < 1) {
+    return;
+  }
+
+  // Squared distance of each endpoint to the closest selected one, -1 once selected.
+  // Starting from the farthest endpoint, each next beam is the one whose endpoint is the
+  // farthest from those selected
+  std::vector<double> distances(count, std::numeric_limits<double>::max());
+  std::vector<bool> selected(count, false);
+  int next = 0;
+  for (int i = 1; i < count; i++) {
+    if (beams_[i].range > beams_[next].range) {
+      next = i;
+    }
+  }
+  for (int k = 0; k < max_beams_; k++) {
+    selected[next] = true;
+    distances[next] = -1.0;
+    const Beam & last = beams_[next];
+    next = -1;
+    for (int i = 0; i < count; i++) {
+      if (selected[i]) {
+        continue;
+      }
+      const double dx = beams_[i].x - last.x;
+      const double dy = beams_[i].y - last.y;
+      distances[i] = std::min(distances[i], dx * dx + dy * dy);
+      if (next < 0 || distances[i] > distances[next]) {
+        next = i;
+      }
+    }
+  }
+
+  // Keep the beams in the order of the scan, indexed by their order in the selection
+  int index = 0;
+  for (int i = 0; i < count; i++) {
+    if (selected[i]) {
+      beams_[index] = beams_[i];
+      beams_[index].index = index;
+      index++;
+    }
+  }
+  beams_.resize(index);
+}
+
+int
+Laser::getThreadCount(pf_sample_set_t * set) const
+{
+  // Below a few hundred samples per thread, starting threads costs more than it saves
+  const int min_samples_per_thread = 256;
+  int threads = threads_;
+  if (parallel_particles_ > 0 && set->sample_count >= parallel_particles_) {
+    threads = std::max(threads, static_cast<int>(std::thread::hardware_concurrency()));
+  }
+  return std::max(1, std::min(threads, set->sample_count / min_samples_per_thread));
+}
+
+double
+Laser::weighSamples(
+  pf_sample_set_t * set, const std::function<double(int, int, int)> & weigh) const
+{
+  const int threads = getThreadCount(set);
+  if (threads == 1) {
+    return weigh(0, set->sample_count, 0);
+  }
+
+  std::vector<double> weights(threads, 0.0);
+  std::vector<std::thread> workers;
+  const int chunk = (set->sample_count + threads - 1) / threads;
+  for (int t = 1; t < threads; t++) {
+    workers.emplace_back(
+      [&, t]() {
+        weights[t] = weigh(t * chunk, std::min((t + 1) * chunk, set->sample_count), t);
+      });
+  }
+  weights[0] = weigh(0, std::min(chunk, set->sample_count), 0);
+  for (auto & worker : workers) {
+    worker.join();
+  }
+
+  double total_weight = 0.0;
+  for (const double weight : weights) {
+    total_weight += weight;
+  }
+  return total_weight;
+}
+
+void
+Laser::updateLikelihoodField(double range_max)
+{
+  if (range_max == likelihood_field_range_max_) {
+    return;
+  }
+  likelihood_field_range_max_ = range_max;
+
+  // The probabilities of the cells range from that of the random measurements alone
+  // to that of a hit on an obstacle
+  const double z_hit_denom = 2 * sigma_hit_ * sigma_hit_;
+  const double z_rand = z_rand_ / range_max;
+  likelihood_field_min_ = transformLikelihood(z_rand);
+  const double max_likelihood = transformLikelihood(z_hit_ + z_rand);
+  likelihood_field_step_ = (max_likelihood - likelihood_field_min_) / UINT16_MAX;
+  const double inv_step = likelihood_field_step_ > 0.0 ? 1.0 / likelihood_field_step_ : 0.0;
+
+  // The distances are multiples of the resolution, so most cells share a few likelihoods
+  const int cell_count = map_->size_x * map_->size_y;
+  likelihood_field_.resize(cell_count);
+  float last_occ_dist = -1.0f;
+  uint16_t last_likelihood = 0;
+  for (int i = 0; i < cell_count; i++) {
+    const float z = map_->cells[i].occ_dist;
+    if (z != last_occ_dist) {
+      const double pz = z_hit_ * exp(-(z * z) / z_hit_denom) + z_rand;
+      assert(pz <= 1.0);
+      assert(pz >= 0.0);
+      last_occ_dist = z;
+      last_likelihood = static_cast<uint16_t>(
+        std::lround((transformLikelihood(pz) - likelihood_field_min_) * inv_step));
+    }
+    likelihood_field_[i] = last_likelihood;
+  }
+  const double max_occ_dist_pz =
+    z_hit_ * exp(-(map_->max_occ_dist * map_->max_occ_dist) / z_hit_denom) + z_rand;
+  max_occ_dist_likelihood_ = likelihood_field_min_ + likelihood_field_step_ * std::lround(
+    (transformLikelihood(max_occ_dist_pz) - likelihood_field_min_) * inv_step);
+
+  map_inv_scale_ = 1.0 / map_->scale;
+  map_offset_x_ = 0.5 + map_->size_x / 2 - map_->origin_x * map_inv_scale_;
+  map_offset_y_ = 0.5 + map_->size_y / 2 - map_->origin_y * map_inv_scale_;
+}
+
 }  // namespace nav2_amcl
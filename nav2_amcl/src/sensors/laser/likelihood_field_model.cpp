@@ -42,20 +42,12 @@ double
 LikelihoodFieldModel::sensorFunction(LaserData * data, pf_sample_set_t * set)
 {
   LikelihoodFieldModel * self;
-  int i, j, step;
-  double z, pz;
-  double p;
-  double obs_range, obs_bearing;
-  double total_weight;
-  pf_sample_t * sample;
-  pf_vector_t pose;
-  pf_vector_t hit;
+  int step;
 
   self = reinterpret_cast<LikelihoodFieldModel *>(data->laser);
 
-  // Pre-compute a couple of things
-  double z_hit_denom = 2 * self->sigma_hit_ * self->sigma_hit_;
-  double z_rand_mult = 1.0 / data->range_max;
+  // Pre-compute the cubed probabilities of the beams' endpoints, with the random measurements
+  self->updateLikelihoodField(data->range_max);
 
   step = (data->range_count - 1) / (self->max_beams_ - 1);
 
@@ -64,71 +56,45 @@ LikelihoodFieldModel::sensorFunction(LaserData * data, pf_sample_set_t * set)
     step = 1;
   }
 
-  total_weight = 0.0;
+  // This model ignores max range readings
+  self->collectBeams(data, step, true);
+  const pf_vector_t & laser_pose = self->laser_pose_;
 
   // Compute the sample weights
-  for (j = 0; j < set->sample_count; j++) {
-    sample = set->samples + j;
-    pose = sample->pose;
-
-    // Take account of the laser pose relative to the robot
-    pose = pf_vector_coord_add(self->laser_pose_, pose);
-
-    p = 1.0;
-
-    for (i = 0; i < data->range_count; i += step) {
-      obs_range = data->ranges[i][0];
-      obs_bearing = data->ranges[i][1];
-
-      // This model ignores max range readings
-      if (obs_range >= data->range_max) {
-        continue;
+  return self->weighSamples(
+    set, [&](int begin, int end, int) {
+      double total_weight = 0.0;
+      int index;
+      for (int j = begin; j < end; j++) {
+        pf_sample_t * sample = set->samples + j;
+        const pf_vector_t & pose = sample->pose;
+        const double c = cos(pose.v[2]);
+        const double s = sin(pose.v[2]);
+
+        // Take account of the laser pose relative to the robot
+        const double x = pose.v[0] + laser_pose.v[0] * c - laser_pose.v[1] * s;
+        const double y = pose.v[1] + laser_pose.v[0] * s + laser_pose.v[1] * c;
+
+        double p = 1.0;
+
+        for (const Beam & beam : self->beams_) {
+          // Compute the endpoint of the beam, and get the Gaussian model of the distance from
+          // it to the closest obstacle with the random measurements. Off-map penalized as
+          // max distance
+          // NOTE: this should have a normalization of 1/(sqrt(2pi)*sigma)
+          // TODO(?): outlier rejection for short readings
+          //      p *= pz;
+          // here we have an ad-hoc weighting scheme for combining beam probs
+          // works well, though...
+          p += self->getLikelihood(
+            x + beam.x * c - beam.y * s, y + beam.x * s + beam.y * c, index);
+        }
+
+        sample->weight *= p;
+        total_weight += sample->weight;
       }
-
-      // Check for NaN
-      if (obs_range != obs_range) {
-        continue;
-      }
-
-      pz = 0.0;
-
-      // Compute the endpoint of the beam
-      hit.v[0] = pose.v[0] + obs_range * cos(pose.v[2] + obs_bearing);
-      hit.v[1] = pose.v[1] + obs_range * sin(pose.v[2] + obs_bearing);
-
-      // Convert to map grid coords.
-      int mi, mj;
-      mi = MAP_GXWX(self->map_, hit.v[0]);
-      mj = MAP_GYWY(self->map_, hit.v[1]);
-
-      // Part 1: Get distance from the hit to closest obstacle.
-      // Off-map penalized as max distance
-      if (!MAP_VALID(self->map_, mi, mj)) {
-        z = self->map_->max_occ_dist;
-      } else {
-        z = self->map_->cells[MAP_INDEX(self->map_, mi, mj)].occ_dist;
-      }
-      // Gaussian model
-      // NOTE: this should have a normalization of 1/(sqrt(2pi)*sigma)
-      pz += self->z_hit_ * exp(-(z * z) / z_hit_denom);
-      // Part 2: random measurements
-      pz += self->z_rand_ * z_rand_mult;
-
-      // TODO(?): outlier rejection for short readings
-
-      assert(pz <= 1.0);
-      assert(pz >= 0.0);
-      //      p *= pz;
-      // here we have an ad-hoc weighting scheme for combining beam probs
-      // works well, though...
-      p += pz * pz * pz;
-    }
-
-    sample->weight *= p;
-    total_weight += sample->weight;
-  }
-
-  return total_weight;
+      return total_weight;
+    });
 }
 
 
@@ -23,6 +23,8 @@
 #include <math.h>
 #include <assert.h>
 
+#include <vector>
+
 #include "nav2_amcl/sensors/laser/laser.hpp"
 
 namespace nav2_amcl
@@ -52,14 +54,8 @@ double
 LikelihoodFieldModelProb::sensorFunction(LaserData * data, pf_sample_set_t * set)
 {
   LikelihoodFieldModelProb * self;
-  int i, j, step;
-  double z, pz;
-  double log_p;
-  double obs_range, obs_bearing;
+  int step;
   double total_weight;
-  pf_sample_t * sample;
-  pf_vector_t pose;
-  pf_vector_t hit;
 
   self = reinterpret_cast<LikelihoodFieldModelProb *>(data->laser);
 
@@ -72,11 +68,8 @@ LikelihoodFieldModelProb::sensorFunction(LaserData * data, pf_sample_set_t * set
     step = 1;
   }
 
-  // Pre-compute a couple of things
-  double z_hit_denom = 2 * self->sigma_hit_ * self->sigma_hit_;
-  double z_rand_mult = 1.0 / data->range_max;
-
-  double max_dist_prob = exp(-(self->map_->max_occ_dist * self->map_->max_occ_dist) / z_hit_denom);
+  // Pre-compute the log probabilities of the beams' endpoints, with the random measurements
+  self->updateLikelihoodField(data->range_max);
 
   // Beam skipping - ignores beams for which a majoirty of particles do not agree with the map
   // prevents correct particles from getting down weighted because of unexpected obstacles
@@ -91,8 +84,10 @@ LikelihoodFieldModelProb::sensorFunction(LaserData * data, pf_sample_set_t * set
     do_beamskip = false;
   }
 
-  // we need a count the no of particles for which the beam agreed with the map
-  int * obs_count = new int[self->max_beams_]();
+  // we need a count the no of particles for which the beam agreed with the map,
+  // for each thread to count its own samples
+  const int threads = self->getThreadCount(set);
+  std::vector<std::vector<int>> obs_count(threads, std::vector<int>(self->max_beams_, 0));
 
   // we also need a mask of which observations to integrate (to decide which beams to integrate to
   // all particles)
@@ -118,83 +113,64 @@ LikelihoodFieldModelProb::sensorFunction(LaserData * data, pf_sample_set_t * set
     }
   }
 
-  // Compute the sample weights
-  for (j = 0; j < set->sample_count; j++) {
-    sample = set->samples + j;
-    pose = sample->pose;
-
-    // Take account of the laser pose relative to the robot
-    pose = pf_vector_coord_add(self->laser_pose_, pose);
-
-    log_p = 0;
-
-    beam_ind = 0;
-
-    for (i = 0; i < data->range_count; i += step, beam_ind++) {
-      obs_range = data->ranges[i][0];
-      obs_bearing = data->ranges[i][1];
-
-      // This model ignores max range readings
-      if (obs_range >= data->range_max) {
-        continue;
-      }
+  // This model ignores max range readings
+  self->collectBeams(data, step, true);
+  const pf_vector_t & laser_pose = self->laser_pose_;
 
-      // Check for NaN
-      if (obs_range != obs_range) {
-        continue;
-      }
-
-      pz = 0.0;
-
-      // Compute the endpoint of the beam
-      hit.v[0] = pose.v[0] + obs_range * cos(pose.v[2] + obs_bearing);
-      hit.v[1] = pose.v[1] + obs_range * sin(pose.v[2] + obs_bearing);
-
-      // Convert to map grid coords.
-      int mi, mj;
-      mi = MAP_GXWX(self->map_, hit.v[0]);
-      mj = MAP_GYWY(self->map_, hit.v[1]);
-
-      // Part 1: Get distance from the hit to closest obstacle.
-      // Off-map penalized as max distance
-
-      if (!MAP_VALID(self->map_, mi, mj)) {
-        pz += self->z_hit_ * max_dist_prob;
-      } else {
-        z = self->map_->cells[MAP_INDEX(self->map_, mi, mj)].occ_dist;
-        if (z < beam_skip_distance) {
-          obs_count[beam_ind] += 1;
+  // Compute the sample weights
+  total_weight = self->weighSamples(
+    set, [&](int begin, int end, int thread) {
+      double thread_weight = 0.0;
+      std::vector<int> & thread_obs_count = obs_count[thread];
+      int index;
+      for (int j = begin; j < end; j++) {
+        pf_sample_t * sample = set->samples + j;
+        const pf_vector_t & pose = sample->pose;
+        const double c = cos(pose.v[2]);
+        const double s = sin(pose.v[2]);
+
+        // Take account of the laser pose relative to the robot
+        const double x = pose.v[0] + laser_pose.v[0] * c - laser_pose.v[1] * s;
+        const double y = pose.v[1] + laser_pose.v[0] * s + laser_pose.v[1] * c;
+
+        double log_p = 0;
+
+        for (const Beam & beam : self->beams_) {
+          // Compute the endpoint of the beam, and get the log of the Gaussian model of the
+          // distance from it to the closest obstacle with the random measurements. Off-map
+          // penalized as max distance
+          // NOTE: this should have a normalization of 1/(sqrt(2pi)*sigma)
+          const double log_pz = self->getLikelihood(
+            x + beam.x * c - beam.y * s, y + beam.x * s + beam.y * c, index);
+          if (index >= 0 && self->map_->cells[index].occ_dist < beam_skip_distance) {
+            thread_obs_count[beam.index] += 1;
+          }
+
+          // TODO(?): outlier rejection for short readings
+
+          if (!do_beamskip) {
+            log_p += log_pz;
+          } else {
+            self->temp_obs_[j][beam.index] = log_pz;
+          }
+        }
+        if (!do_beamskip) {
+          sample->weight *= exp(log_p);
+          thread_weight += sample->weight;
         }
-        pz += self->z_hit_ * exp(-(z * z) / z_hit_denom);
-      }
-
-      // Gaussian model
-      // NOTE: this should have a normalization of 1/(sqrt(2pi)*sigma)
-
-      // Part 2: random measurements
-      pz += self->z_rand_ * z_rand_mult;
-
-      assert(pz <= 1.0);
-      assert(pz >= 0.0);
-
-      // TODO(?): outlier rejection for short readings
-
-      if (!do_beamskip) {
-        log_p += log(pz);
-      } else {
-        self->temp_obs_[j][beam_ind] = pz;
       }
-    }
-    if (!do_beamskip) {
-      sample->weight *= exp(log_p);
-      total_weight += sample->weight;
-    }
-  }
+      return thread_weight;
+    });
 
   if (do_beamskip) {
+    total_weight = 0.0;
     int skipped_beam_count = 0;
     for (beam_ind = 0; beam_ind < self->max_beams_; beam_ind++) {
-      if ((obs_count[beam_ind] / static_cast<double>(set->sample_count)) > beam_skip_threshold) {
+      int beam_obs_count = 0;
+      for (const auto & thread_obs_count : obs_count) {
+        beam_obs_count += thread_obs_count[beam_ind];
+      }
+      if ((beam_obs_count / static_cast<double>(set->sample_count)) > beam_skip_threshold) {
         obs_mask[beam_ind] = true;
       } else {
         obs_mask[beam_ind] = false;
@@ -217,25 +193,28 @@ LikelihoodFieldModelProb::sensorFunction(LaserData * data, pf_sample_set_t * set
       error = true;
     }
 
-    for (j = 0; j < set->sample_count; j++) {
-      sample = set->samples + j;
-      pose = sample->pose;
+    total_weight = self->weighSamples(
+      set, [&](int begin, int end, int) {
+        double thread_weight = 0.0;
+        for (int j = begin; j < end; j++) {
+          pf_sample_t * sample = set->samples + j;
 
-      log_p = 0;
+          double log_p = 0;
 
-      for (beam_ind = 0; beam_ind < self->max_beams_; beam_ind++) {
-        if (error || obs_mask[beam_ind]) {
-          log_p += log(self->temp_obs_[j][beam_ind]);
-        }
-      }
+          for (int beam = 0; beam < self->max_beams_; beam++) {
+            if (error || obs_mask[beam]) {
+              log_p += self->temp_obs_[j][beam];
+            }
+          }
 
-      sample->weight *= exp(log_p);
+          sample->weight *= exp(log_p);
 
-      total_weight += sample->weight;
-    }
+          thread_weight += sample->weight;
+        }
+        return thread_weight;
+      });
   }
 
-  delete[] obs_count;
   delete[] obs_mask;
   return total_weight;
 }
@@ -16,7 +16,10 @@
 #ifndef NAV2_BEHAVIOR_TREE__BEHAVIOR_TREE_ENGINE_HPP_
 #define NAV2_BEHAVIOR_TREE__BEHAVIOR_TREE_ENGINE_HPP_
 
+#include <chrono>
+#include <functional>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -45,25 +48,35 @@ public:
   /**
    * @brief A constructor for nav2_behavior_tree::BehaviorTreeEngine
    * @param plugin_libraries vector of BT plugin library names to load
+   * @param lazy_plugin_loading Whether to load the plugin libraries only once a tree
+   * referencing their nodes is created, rather than all of them at once
    */
   explicit BehaviorTreeEngine(
     const std::vector<std::string> & plugin_libraries,
-    rclcpp::Node::SharedPtr node);
+    rclcpp::Node::SharedPtr node,
+    bool lazy_plugin_loading = false);
   virtual ~BehaviorTreeEngine() {}
 
   /**
-   * @brief Function to execute a BT at a specific rate
+   * @brief Function to execute a BT at a specific rate, or on the events waking it up
    * @param tree BT to execute
    * @param onLoop Function to execute on each iteration of BT execution
    * @param cancelRequested Function to check if cancel was requested during BT execution
-   * @param loopTimeout Time period for each iteration of BT execution
+   * @param loopTimeout Time period for each iteration of BT execution, or the maximum time
+   * between two iterations if event driven
+   * @param eventDriven Whether to tick the BT when one of its nodes emits a wake up signal,
+   * e.g. on an action result or feedback, a message or a timer deadline, rather than at a
+   * fixed rate
+   * @param minLoopTimeout Minimum time between two iterations if event driven
    * @return nav2_behavior_tree::BtStatus Status of BT execution
    */
   BtStatus run(
     BT::Tree * tree,
     std::function<void()> onLoop,
     std::function<bool()> cancelRequested,
-    std::chrono::milliseconds loopTimeout = std::chrono::milliseconds(10));
+    std::chrono::milliseconds loopTimeout = std::chrono::milliseconds(10),
+    bool eventDriven = false,
+    std::chrono::milliseconds minLoopTimeout = std::chrono::milliseconds(1));
 
   /**
    * @brief Function to create a BT from a XML string
@@ -91,12 +104,62 @@ public:
    */
   void haltAllActions(BT::Tree & tree);
 
+  /**
+   * @brief Function to share the callback group of the engine with the BT nodes, for their
+   * ROS clients and subscriptions to be spun once before each tick rather than by each node
+   * @param blackboard Blackboard for BT
+   */
+  void shareCallbackGroup(BT::Blackboard::Ptr blackboard);
+
+  /**
+   * @brief Function to get the IDs of the nodes referenced by a BT XML and the files it
+   * includes, other than subtrees and the models of TreeNodesModel
+   * @param xml_string XML string representing BT
+   * @param directory Directory relative to which the included files are read
+   * @param ids Set to add the IDs to
+   * @return False if an included file could not be read, in which case its IDs are missing
+   */
+  static bool getNodeIDs(
+    const std::string & xml_string, const std::string & directory,
+    std::set<std::string> & ids);
+
+  /**
+   * @brief Function to check whether a plugin library is named after a node, as the
+   * snake case of its ID delimited by underscores, like nav2_follow_path_action_bt_node
+   * for FollowPath
+   * @param library Name of the plugin library
+   * @param id ID of the node
+   * @return bool Whether the library is named after the node
+   */
+  static bool isLibraryNamedAfter(const std::string & library, const std::string & id);
+
 protected:
+  /**
+   * @brief Function to load the plugin libraries not loaded yet which register the nodes
+   * of a BT XML. Libraries named after the nodes are loaded first, then the others in order
+   * until all nodes are registered.
+   * @param xml_string XML string representing BT
+   * @param directory Directory relative to which the included files are read
+   */
+  void loadPluginsForTree(const std::string & xml_string, const std::string & directory);
+
+  /**
+   * @brief Function to load the plugin libraries not loaded yet
+   */
+  void loadAllPlugins();
+
+  // Plugin libraries not loaded yet, when lazily loaded
+  std::vector<std::string> pending_plugins_;
+
   // The factory that will be used to dynamically construct the behavior tree
   BT::BehaviorTreeFactory factory_;
 
   // Clock
   rclcpp::Clock::SharedPtr clock_;
+
+  // Callback group shared by the BT nodes, and the executor spinning it before each tick
+  rclcpp::CallbackGroup::SharedPtr callback_group_;
+  std::shared_ptr<rclcpp::executors::SingleThreadedExecutor> callback_group_executor_;
 };
 
 }  // namespace nav2_behavior_tree
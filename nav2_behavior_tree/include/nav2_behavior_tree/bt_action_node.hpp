@@ -50,10 +50,8 @@ public:
   : BT::ActionNodeBase(xml_tag_name, conf), action_name_(action_name), should_send_goal_(true)
   {
     node_ = config().blackboard->template get<rclcpp::Node::SharedPtr>("node");
-    callback_group_ = node_->create_callback_group(
-      rclcpp::CallbackGroupType::MutuallyExclusive,
-      false);
-    callback_group_executor_.add_callback_group(callback_group_, node_->get_node_base_interface());
+    callback_group_shared_ = BT::getCallbackGroupExecutor(
+      config().blackboard, node_, callback_group_, callback_group_executor_);
 
     // Get the required items from the blackboard
     auto bt_loop_duration =
@@ -95,6 +93,9 @@ public:
   {
     // Now that we have the ROS node to use, create the action client for this BT action
     action_client_ = rclcpp_action::create_client<ActionT>(node_, action_name, callback_group_);
+    // Wake the tree up as soon as a response, feedback or status arrives, so that an event
+    // driven tree ticks this node to process it
+    action_client_->set_on_ready_callback([this](size_t, int) {emitWakeUpSignal();});
 
     // Make sure the server is actually there before continuing
     RCLCPP_DEBUG(node_->get_logger(), "Waiting for \"%s\" action server", action_name.c_str());
@@ -259,7 +260,10 @@ public:
           }
         }
 
-        callback_group_executor_.spin_some();
+        // a callback group shared by the tree has already been spun before this tick
+        if (!callback_group_shared_) {
+          callback_group_executor_->spin_some();
+        }
 
         // check if, after invoking spin_some(), we finally received the result
         if (!goal_result_available_) {
@@ -310,7 +314,7 @@ public:
     if (should_cancel_goal()) {
       auto future_result = action_client_->async_get_result(goal_handle_);
       auto future_cancel = action_client_->async_cancel_goal(goal_handle_);
-      if (callback_group_executor_.spin_until_future_complete(future_cancel, server_timeout_) !=
+      if (callback_group_executor_->spin_until_future_complete(future_cancel, server_timeout_) !=
         rclcpp::FutureReturnCode::SUCCESS)
       {
         RCLCPP_ERROR(
@@ -318,7 +322,7 @@ public:
           "Failed to cancel action server for %s", action_name_.c_str());
       }
 
-      if (callback_group_executor_.spin_until_future_complete(future_result, server_timeout_) !=
+      if (callback_group_executor_->spin_until_future_complete(future_result, server_timeout_) !=
         rclcpp::FutureReturnCode::SUCCESS)
       {
         RCLCPP_ERROR(
@@ -351,7 +355,7 @@ protected:
       return false;
     }
 
-    callback_group_executor_.spin_some();
+    callback_group_executor_->spin_some();
     auto status = goal_handle_->get_status();
 
     // Check if the goal is still executing
@@ -379,7 +383,8 @@ protected:
         // TODO(#1652): a work around until rcl_action interface is updated
         // if goal ids are not matched, the older goal call this callback so ignore the result
         // if matched, it must be processed (including aborted)
-        if (this->goal_handle_->get_goal_id() == result.goal_id) {
+        // the callback group may be spun by other nodes sharing it, between two goals
+        if (this->goal_handle_ && this->goal_handle_->get_goal_id() == result.goal_id) {
           goal_result_available_ = true;
           result_ = result;
           emitWakeUpSignal();
@@ -416,7 +421,7 @@ protected:
 
     auto timeout = remaining > max_timeout_ ? max_timeout_ : remaining;
     auto result =
-      callback_group_executor_.spin_until_future_complete(*future_goal_handle_, timeout);
+      callback_group_executor_->spin_until_future_complete(*future_goal_handle_, timeout);
     elapsed += timeout;
 
     if (result == rclcpp::FutureReturnCode::INTERRUPTED) {
@@ -463,7 +468,9 @@ protected:
   // The node that will be used for any ROS operations
   rclcpp::Node::SharedPtr node_;
   rclcpp::CallbackGroup::SharedPtr callback_group_;
-  rclcpp::executors::SingleThreadedExecutor callback_group_executor_;
+  std::shared_ptr<rclcpp::executors::SingleThreadedExecutor> callback_group_executor_;
+  // Whether the callback group is shared by the tree, and spun before each tick
+  bool callback_group_shared_{false};
 
   // The timeout value while waiting for response from a server when a
   // new action goal is sent or canceled
@@ -15,15 +15,21 @@
 #ifndef NAV2_BEHAVIOR_TREE__BT_ACTION_SERVER_HPP_
 #define NAV2_BEHAVIOR_TREE__BT_ACTION_SERVER_HPP_
 
+#include <list>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include "geometry_msgs/msg/pose_stamped.hpp"
 #include "nav2_behavior_tree/behavior_tree_engine.hpp"
+#include "nav2_behavior_tree/robot_pose_cache.hpp"
 #include "nav2_behavior_tree/ros_topic_logger.hpp"
+#include "nav2_behavior_tree/tree_profiler.hpp"
+#include "nav2_msgs/msg/behavior_tree_statistics.hpp"
 #include "nav2_util/lifecycle_node.hpp"
 #include "nav2_util/simple_action_server.hpp"
+#include "std_srvs/srv/trigger.hpp"
 
 namespace nav2_behavior_tree
 {
@@ -202,6 +208,25 @@ protected:
    */
   void cleanErrorCodes();
 
+  /**
+   * @brief Moves the current tree to the front of the cache of loaded trees, if enabled,
+   * dropping the least recently used ones beyond its size
+   */
+  void cacheCurrentTree();
+
+  /**
+   * @brief Publishes the statistics of the profiler of the current tree, if profiling
+   */
+  void publishStatistics();
+
+  /**
+   * @brief Service callback writing the trace of the profiler of the current tree to
+   * bt_profiling_trace_file
+   */
+  void dumpTraceCallback(
+    const std::shared_ptr<std_srvs::srv::Trigger::Request> request,
+    std::shared_ptr<std_srvs::srv::Trigger::Response> response);
+
   // Action name
   std::string action_name_;
 
@@ -242,9 +267,15 @@ protected:
   // To publish BT logs
   std::unique_ptr<RosTopicLogger> topic_logger_;
 
-  // Duration for each iteration of BT execution
+  // Duration for each iteration of BT execution, or maximum one if event driven
   std::chrono::milliseconds bt_loop_duration_;
 
+  // Whether to tick the BT when its nodes wake it up rather than at a fixed rate
+  bool bt_event_driven_ = false;
+
+  // Minimum duration for each iteration of BT execution if event driven
+  std::chrono::milliseconds bt_min_loop_duration_;
+
   // Default timeout value while waiting for response from a server
   std::chrono::milliseconds default_server_timeout_;
 
@@ -254,6 +285,47 @@ protected:
   // should the BT be reloaded even if the same xml filename is requested?
   bool always_reload_bt_xml_ = false;
 
+  // To profile the ticks of the BT, if enabled
+  std::unique_ptr<TreeProfiler> profiler_;
+
+  // Guards the swaps of the profiler against the dumps of its trace
+  std::mutex profiler_mutex_;
+
+  // Whether to profile the ticks of the BT
+  bool bt_profiling_ = false;
+
+  // Period of publication of the profiling statistics
+  std::chrono::milliseconds bt_profiling_period_;
+
+  // Number of ticks kept to be dumped as a trace
+  int bt_profiling_trace_size_ = 0;
+
+  // File the trace is dumped to
+  std::string bt_profiling_trace_file_;
+
+  // Time the profiling statistics were last published
+  std::chrono::steady_clock::time_point last_statistics_time_;
+
+  // To publish the profiling statistics and dump the trace on request
+  rclcpp::Publisher<nav2_msgs::msg::BehaviorTreeStatistics>::SharedPtr statistics_pub_;
+  rclcpp::Service<std_srvs::srv::Trigger>::SharedPtr dump_trace_service_;
+
+  // Trees loaded before the current one, with their loggers, kept to switch back to them
+  // without instantiating their nodes again
+  struct CachedTree
+  {
+    std::string filename;
+    BT::Tree tree;
+    std::unique_ptr<RosTopicLogger> topic_logger;
+    std::unique_ptr<TreeProfiler> profiler;
+  };
+
+  // Cached trees, the most recently used first
+  std::list<CachedTree> tree_cache_;
+
+  // Maximum number of cached trees, 0 to disable the cache
+  int bt_cache_size_ = 0;
+
   // User-provided callbacks
   OnGoalReceivedCallback on_goal_received_callback_;
   OnLoopCallback on_loop_callback_;
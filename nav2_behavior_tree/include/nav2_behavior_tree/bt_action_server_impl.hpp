@@ -15,6 +15,7 @@
 #ifndef NAV2_BEHAVIOR_TREE__BT_ACTION_SERVER_IMPL_HPP_
 #define NAV2_BEHAVIOR_TREE__BT_ACTION_SERVER_IMPL_HPP_
 
+#include <filesystem>
 #include <memory>
 #include <string>
 #include <fstream>
@@ -22,6 +23,8 @@
 #include <exception>
 #include <vector>
 #include <limits>
+#include <algorithm>
+#include <utility>
 
 #include "nav2_msgs/action/navigate_to_pose.hpp"
 #include "nav2_behavior_tree/bt_action_server.hpp"
@@ -58,6 +61,12 @@ BtActionServer<ActionT>::BtActionServer(
   if (!node->has_parameter("bt_loop_duration")) {
     node->declare_parameter("bt_loop_duration", 10);
   }
+  if (!node->has_parameter("bt_event_driven")) {
+    node->declare_parameter("bt_event_driven", false);
+  }
+  if (!node->has_parameter("bt_min_loop_duration")) {
+    node->declare_parameter("bt_min_loop_duration", 1);
+  }
   if (!node->has_parameter("default_server_timeout")) {
     node->declare_parameter("default_server_timeout", 20);
   }
@@ -67,9 +76,27 @@ BtActionServer<ActionT>::BtActionServer(
   if (!node->has_parameter("always_reload_bt_xml")) {
     node->declare_parameter("always_reload_bt_xml", false);
   }
+  if (!node->has_parameter("lazy_plugin_loading")) {
+    node->declare_parameter("lazy_plugin_loading", false);
+  }
+  if (!node->has_parameter("bt_cache_size")) {
+    node->declare_parameter("bt_cache_size", 0);
+  }
   if (!node->has_parameter("wait_for_service_timeout")) {
     node->declare_parameter("wait_for_service_timeout", 1000);
   }
+  if (!node->has_parameter("bt_profiling")) {
+    node->declare_parameter("bt_profiling", false);
+  }
+  if (!node->has_parameter("bt_profiling_period")) {
+    node->declare_parameter("bt_profiling_period", 1000);
+  }
+  if (!node->has_parameter("bt_profiling_trace_size")) {
+    node->declare_parameter("bt_profiling_trace_size", 10000);
+  }
+  if (!node->has_parameter("bt_profiling_trace_file")) {
+    node->declare_parameter("bt_profiling_trace_file", std::string(""));
+  }
 
   std::vector<std::string> error_code_names = {
     "follow_path_error_code",
@@ -161,6 +188,10 @@ bool BtActionServer<ActionT>::on_configure()
   int bt_loop_duration;
   node->get_parameter("bt_loop_duration", bt_loop_duration);
   bt_loop_duration_ = std::chrono::milliseconds(bt_loop_duration);
+  node->get_parameter("bt_event_driven", bt_event_driven_);
+  int bt_min_loop_duration;
+  node->get_parameter("bt_min_loop_duration", bt_min_loop_duration);
+  bt_min_loop_duration_ = std::chrono::milliseconds(bt_min_loop_duration);
   int default_server_timeout;
   node->get_parameter("default_server_timeout", default_server_timeout);
   default_server_timeout_ = std::chrono::milliseconds(default_server_timeout);
@@ -168,12 +199,33 @@ bool BtActionServer<ActionT>::on_configure()
   node->get_parameter("wait_for_service_timeout", wait_for_service_timeout);
   wait_for_service_timeout_ = std::chrono::milliseconds(wait_for_service_timeout);
   node->get_parameter("always_reload_bt_xml", always_reload_bt_xml_);
+  node->get_parameter("bt_cache_size", bt_cache_size_);
+  node->get_parameter("bt_profiling", bt_profiling_);
+  int bt_profiling_period;
+  node->get_parameter("bt_profiling_period", bt_profiling_period);
+  bt_profiling_period_ = std::chrono::milliseconds(bt_profiling_period);
+  node->get_parameter("bt_profiling_trace_size", bt_profiling_trace_size_);
+  node->get_parameter("bt_profiling_trace_file", bt_profiling_trace_file_);
+  if (bt_profiling_trace_file_.empty()) {
+    bt_profiling_trace_file_ =
+      (std::filesystem::temp_directory_path() / (client_node_name + "_bt_trace.json")).string();
+  }
+  if (bt_profiling_) {
+    statistics_pub_ = client_node_->create_publisher<nav2_msgs::msg::BehaviorTreeStatistics>(
+      "behavior_tree_statistics", rclcpp::QoS(10));
+    dump_trace_service_ = node->create_service<std_srvs::srv::Trigger>(
+      "~/" + action_name_ + "/dump_bt_trace",
+      std::bind(
+        &BtActionServer<ActionT>::dumpTraceCallback, this,
+        std::placeholders::_1, std::placeholders::_2));
+  }
 
   // Get error code id names to grab off of the blackboard
   error_code_names_ = node->get_parameter("error_code_names").as_string_array();
 
   // Create the class that registers our custom nodes and executes the BT
-  bt_ = std::make_unique<nav2_behavior_tree::BehaviorTreeEngine>(plugin_lib_names_, client_node_);
+  bt_ = std::make_unique<nav2_behavior_tree::BehaviorTreeEngine>(
+    plugin_lib_names_, client_node_, node->get_parameter("lazy_plugin_loading").as_bool());
 
   // Create the blackboard that will be shared by all of the nodes in the tree
   blackboard_ = BT::Blackboard::create();
@@ -185,6 +237,7 @@ bool BtActionServer<ActionT>::on_configure()
   blackboard_->set<std::chrono::milliseconds>(
     "wait_for_service_timeout",
     wait_for_service_timeout_);
+  bt_->shareCallbackGroup(blackboard_);
 
   return true;
 }
@@ -213,6 +266,13 @@ bool BtActionServer<ActionT>::on_cleanup()
   client_node_.reset();
   action_server_.reset();
   topic_logger_.reset();
+  dump_trace_service_.reset();
+  statistics_pub_.reset();
+  {
+    std::lock_guard<std::mutex> lock(profiler_mutex_);
+    profiler_.reset();
+    tree_cache_.clear();
+  }
   plugin_lib_names_.clear();
   current_bt_xml_filename_.clear();
   blackboard_.reset();
@@ -233,6 +293,27 @@ bool BtActionServer<ActionT>::loadBehaviorTree(const std::string & bt_xml_filena
     return true;
   }
 
+  // Switch back to a previously loaded BT, ready to run again since halted after its last run
+  if (!always_reload_bt_xml_) {
+    auto cached = std::find_if(
+      tree_cache_.begin(), tree_cache_.end(),
+      [&filename](const CachedTree & entry) {return entry.filename == filename;});
+    if (cached != tree_cache_.end()) {
+      RCLCPP_DEBUG(logger_, "Reusing the cached BT of %s", filename.c_str());
+      std::lock_guard<std::mutex> lock(profiler_mutex_);
+      BT::Tree tree = std::move(cached->tree);
+      auto topic_logger = std::move(cached->topic_logger);
+      auto profiler = std::move(cached->profiler);
+      tree_cache_.erase(cached);
+      cacheCurrentTree();
+      tree_ = std::move(tree);
+      topic_logger_ = std::move(topic_logger);
+      profiler_ = std::move(profiler);
+      current_bt_xml_filename_ = filename;
+      return true;
+    }
+  }
+
   // Read the input BT XML from the specified file into a string
   std::ifstream xml_file(filename);
 
@@ -242,9 +323,10 @@ bool BtActionServer<ActionT>::loadBehaviorTree(const std::string & bt_xml_filena
   }
 
   // Create the Behavior Tree from the XML input
+  BT::Tree tree;
   try {
-    tree_ = bt_->createTreeFromFile(filename, blackboard_);
-    for (auto & subtree : tree_.subtrees) {
+    tree = bt_->createTreeFromFile(filename, blackboard_);
+    for (auto & subtree : tree.subtrees) {
       auto & blackboard = subtree->blackboard;
       blackboard->set("node", client_node_);
       blackboard->set<std::chrono::milliseconds>("server_timeout", default_server_timeout_);
@@ -252,18 +334,41 @@ bool BtActionServer<ActionT>::loadBehaviorTree(const std::string & bt_xml_filena
       blackboard->set<std::chrono::milliseconds>(
         "wait_for_service_timeout",
         wait_for_service_timeout_);
+      bt_->shareCallbackGroup(blackboard);
     }
   } catch (const std::exception & e) {
     RCLCPP_ERROR(logger_, "Exception when loading BT: %s", e.what());
     return false;
   }
 
+  std::lock_guard<std::mutex> lock(profiler_mutex_);
+  cacheCurrentTree();
+  tree_ = std::move(tree);
   topic_logger_ = std::make_unique<RosTopicLogger>(client_node_, tree_);
+  profiler_.reset();
+  if (bt_profiling_) {
+    profiler_ = std::make_unique<TreeProfiler>(tree_, bt_profiling_trace_size_);
+  }
 
   current_bt_xml_filename_ = filename;
   return true;
 }
 
+template<class ActionT>
+void BtActionServer<ActionT>::cacheCurrentTree()
+{
+  if (bt_cache_size_ <= 0 || always_reload_bt_xml_ || current_bt_xml_filename_.empty()) {
+    return;
+  }
+
+  tree_cache_.push_front(
+    CachedTree{current_bt_xml_filename_, std::move(tree_), std::move(topic_logger_),
+      std::move(profiler_)});
+  while (tree_cache_.size() > static_cast<size_t>(bt_cache_size_)) {
+    tree_cache_.pop_back();
+  }
+}
+
 template<class ActionT>
 void BtActionServer<ActionT>::executeCallback()
 {
@@ -285,20 +390,32 @@ void BtActionServer<ActionT>::executeCallback()
       return action_server_->is_cancel_requested();
     };
 
+  // The robot pose shared by the nodes of the tree, if any, is looked up once per tick
+  std::shared_ptr<RobotPoseCache> robot_pose_cache;
+  blackboard_->get("robot_pose_cache", robot_pose_cache);
+
   auto on_loop = [&]() {
       if (action_server_->is_preempt_requested() && on_preempt_callback_) {
         on_preempt_callback_(action_server_->get_pending_goal());
       }
       topic_logger_->flush();
       on_loop_callback_();
+      if (robot_pose_cache) {
+        robot_pose_cache->invalidate();
+      }
+      if (std::chrono::steady_clock::now() - last_statistics_time_ >= bt_profiling_period_) {
+        publishStatistics();
+      }
     };
 
   // Execute the BT that was previously created in the configure step
-  nav2_behavior_tree::BtStatus rc = bt_->run(&tree_, on_loop, is_canceling, bt_loop_duration_);
+  nav2_behavior_tree::BtStatus rc = bt_->run(
+    &tree_, on_loop, is_canceling, bt_loop_duration_, bt_event_driven_, bt_min_loop_duration_);
 
   // Make sure that the Bt is not in a running state from a previous execution
   // note: if all the ControlNodes are implemented correctly, this is not needed.
   bt_->haltAllActions(tree_);
+  publishStatistics();
 
   // Give server an opportunity to populate the result message or simple give
   // an indication that the action is complete.
@@ -328,6 +445,35 @@ void BtActionServer<ActionT>::executeCallback()
   cleanErrorCodes();
 }
 
+template<class ActionT>
+void BtActionServer<ActionT>::publishStatistics()
+{
+  last_statistics_time_ = std::chrono::steady_clock::now();
+  if (!profiler_ || !statistics_pub_) {
+    return;
+  }
+  auto msg = std::make_unique<nav2_msgs::msg::BehaviorTreeStatistics>(
+    profiler_->getStatistics(clock_->now(), current_bt_xml_filename_));
+  statistics_pub_->publish(std::move(msg));
+}
+
+template<class ActionT>
+void BtActionServer<ActionT>::dumpTraceCallback(
+  const std::shared_ptr<std_srvs::srv::Trigger::Request>/*request*/,
+  std::shared_ptr<std_srvs::srv::Trigger::Response> response)
+{
+  std::lock_guard<std::mutex> lock(profiler_mutex_);
+  if (!profiler_) {
+    response->success = false;
+    response->message = "No behavior tree loaded";
+    return;
+  }
+  response->success = profiler_->dumpTrace(bt_profiling_trace_file_);
+  response->message = response->success ?
+    "Trace written to " + bt_profiling_trace_file_ :
+    "Failed to write the trace to " + bt_profiling_trace_file_;
+}
+
 template<class ActionT>
 void BtActionServer<ActionT>::populateErrorCode(
   typename std::shared_ptr<typename ActionT::Result> result)
@@ -50,10 +50,8 @@ public:
   : BT::ActionNodeBase(xml_tag_name, conf), action_name_(action_name)
   {
     node_ = config().blackboard->template get<rclcpp::Node::SharedPtr>("node");
-    callback_group_ = node_->create_callback_group(
-      rclcpp::CallbackGroupType::MutuallyExclusive,
-      false);
-    callback_group_executor_.add_callback_group(callback_group_, node_->get_node_base_interface());
+    callback_group_shared_ = BT::getCallbackGroupExecutor(
+      config().blackboard, node_, callback_group_, callback_group_executor_);
 
     // Get the required items from the blackboard
     server_timeout_ =
@@ -147,7 +145,7 @@ public:
 
     auto future_cancel = action_client_->async_cancel_goals_before(goal_expiry_time);
 
-    if (callback_group_executor_.spin_until_future_complete(future_cancel, server_timeout_) !=
+    if (callback_group_executor_->spin_until_future_complete(future_cancel, server_timeout_) !=
       rclcpp::FutureReturnCode::SUCCESS)
     {
       RCLCPP_ERROR(
@@ -165,7 +163,9 @@ protected:
   // The node that will be used for any ROS operations
   rclcpp::Node::SharedPtr node_;
   rclcpp::CallbackGroup::SharedPtr callback_group_;
-  rclcpp::executors::SingleThreadedExecutor callback_group_executor_;
+  std::shared_ptr<rclcpp::executors::SingleThreadedExecutor> callback_group_executor_;
+  // Whether the callback group is shared by the tree, and spun before each tick
+  bool callback_group_shared_{false};
 
   // The timeout value while waiting for response from a server when a
   // new action goal is canceled
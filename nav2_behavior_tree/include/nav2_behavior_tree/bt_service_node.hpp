@@ -51,10 +51,8 @@ public:
       service_node_name)
   {
     node_ = config().blackboard->template get<rclcpp::Node::SharedPtr>("node");
-    callback_group_ = node_->create_callback_group(
-      rclcpp::CallbackGroupType::MutuallyExclusive,
-      false);
-    callback_group_executor_.add_callback_group(callback_group_, node_->get_node_base_interface());
+    callback_group_shared_ = BT::getCallbackGroupExecutor(
+      config().blackboard, node_, callback_group_, callback_group_executor_);
 
     // Get the required items from the blackboard
     auto bt_loop_duration =
@@ -74,6 +72,9 @@ public:
       service_name_,
       rclcpp::SystemDefaultsQoS(),
       callback_group_);
+    // Wake the tree up as soon as the response arrives, so that an event driven tree ticks
+    // this node to process it
+    service_client_->set_on_new_response_callback([this](size_t) {emitWakeUpSignal();});
 
     // Make a request for the service without parameter
     request_ = std::make_shared<typename ServiceT::Request>();
@@ -195,7 +196,7 @@ public:
       auto timeout = remaining > max_timeout_ ? max_timeout_ : remaining;
 
       rclcpp::FutureReturnCode rc;
-      rc = callback_group_executor_.spin_until_future_complete(future_result_, timeout);
+      rc = callback_group_executor_->spin_until_future_complete(future_result_, timeout);
       if (rc == rclcpp::FutureReturnCode::SUCCESS) {
         request_sent_ = false;
         BT::NodeStatus status = on_completion(future_result_.get());
@@ -245,7 +246,9 @@ protected:
   // The node that will be used for any ROS operations
   rclcpp::Node::SharedPtr node_;
   rclcpp::CallbackGroup::SharedPtr callback_group_;
-  rclcpp::executors::SingleThreadedExecutor callback_group_executor_;
+  std::shared_ptr<rclcpp::executors::SingleThreadedExecutor> callback_group_executor_;
+  // Whether the callback group is shared by the tree, and spun before each tick
+  bool callback_group_shared_{false};
 
   // The timeout value while to use in the tick loop while waiting for
   // a result from the server
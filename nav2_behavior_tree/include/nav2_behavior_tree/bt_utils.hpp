@@ -15,11 +15,17 @@
 #ifndef NAV2_BEHAVIOR_TREE__BT_UTILS_HPP_
 #define NAV2_BEHAVIOR_TREE__BT_UTILS_HPP_
 
+#include <chrono>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <set>
+#include <type_traits>
+#include <utility>
 
 #include "rclcpp/time.hpp"
 #include "rclcpp/node.hpp"
+#include "rclcpp/executors/single_threaded_executor.hpp"
 #include "behaviortree_cpp/behavior_tree.h"
 #include "geometry_msgs/msg/point.hpp"
 #include "geometry_msgs/msg/quaternion.hpp"
@@ -200,6 +206,141 @@ bool getInputPortOrBlackboard(
 #define getInputOrBlackboard(name, value) \
   getInputPortOrBlackboard(*this, *(this->config().blackboard), name, value);
 
+/**
+ * @brief Reads the value of an input port holding a large message, such as a path or goals,
+ * in place on the blackboard entry it is remapped to rather than copying it out as getInput
+ * does. The entry is locked while the reader runs, so it must not access the same port.
+ * Falls back to getInput for ports set in the XML or holding another type.
+ * @param bt_node the node
+ * @param key name of the port
+ * @param reader callable taking the value as const T &
+ * @return bool true if the port has a value, false if the reader was not called
+ */
+template<typename T, typename ReaderT> inline
+bool readInputInPlace(BT::TreeNode & bt_node, const std::string & key, ReaderT && reader)
+{
+  if (auto entry = bt_node.getLockedPortContent(key)) {
+    if (const T * value = entry->template castPtr<T>()) {
+      reader(*value);
+      return true;
+    }
+  }
+  T value;
+  if (!bt_node.getInput<T>(key, value)) {
+    return false;
+  }
+  reader(value);
+  return true;
+}
+
+/**
+ * @brief Sets an output port holding a large message by moving the value into the blackboard
+ * entry it is remapped to rather than copying it as setOutput does, which it falls back to
+ * while the entry holds no value of this type yet. The sequence id of the entry is incremented
+ * either way.
+ * @param bt_node the node
+ * @param key name of the port
+ * @param value value to move into the entry
+ */
+template<typename T> inline
+void moveOutput(BT::TreeNode & bt_node, const std::string & key, T && value)
+{
+  using ValueT = std::decay_t<T>;
+  std::shared_ptr<BT::Blackboard::Entry> entry;
+  try {
+    const auto remapped_key = BT::TreeNode::getRemappedKey(key, bt_node.getRawPortValue(key));
+    if (remapped_key) {
+      entry = bt_node.config().blackboard->getEntry(std::string(remapped_key.value()));
+    }
+  } catch (const std::logic_error &) {
+    // Port not set, left to setOutput
+  }
+  if (entry) {
+    std::unique_lock<std::mutex> lock(entry->entry_mutex);
+    if (ValueT * current = entry->value.template castPtr<ValueT>()) {
+      *current = std::move(value);
+      // Bumped as Blackboard::set does, for the readers to detect the update
+      entry->sequence_id++;
+      entry->stamp = std::chrono::steady_clock::now().time_since_epoch();
+      return;
+    }
+  }
+  bt_node.setOutput(key, value);
+}
+
+/**
+ * @brief Gets the sequence id of the blackboard entry read by getInputPortOrBlackboard, which
+ * is incremented at each write of the entry. Nodes detecting updates of large values, such as
+ * goals, compare it first rather than comparing copies of the values at each tick.
+ * @param bt_node the node
+ * @param blackboard the blackboard ovtained with node->config().blackboard
+ * @param param_name std::string
+ * @return uint64_t sequence id of the entry, 0 if there is none or the port is set in the XML
+ */
+inline uint64_t getInputPortOrBlackboardSequenceId(
+  const BT::TreeNode & bt_node,
+  const BT::Blackboard & blackboard,
+  const std::string & param_name)
+{
+  std::shared_ptr<const BT::Blackboard::Entry> entry;
+  try {
+    const auto port_value = bt_node.getRawPortValue(param_name);
+    if (!port_value.empty()) {
+      const auto remapped_key = BT::TreeNode::getRemappedKey(param_name, port_value);
+      if (!remapped_key) {
+        // A value set in the XML never changes
+        return 0;
+      }
+      entry = blackboard.getEntry(std::string(remapped_key.value()));
+    }
+  } catch (const std::logic_error &) {
+    // Port not set, read from the blackboard only
+  }
+
+  if (!entry) {
+    entry = blackboard.getEntry(param_name);
+  }
+  if (!entry) {
+    return 0;
+  }
+  std::unique_lock<std::mutex> lock(entry->entry_mutex);
+  return entry->sequence_id;
+}
+
+// Macro to remove boiler plate when using getInputPortOrBlackboardSequenceId
+#define getInputOrBlackboardSequenceId(name) \
+  getInputPortOrBlackboardSequenceId(*this, *(this->config().blackboard), name)
+
+/**
+ * @brief Gets the callback group of the ROS clients and subscriptions of a BT node and the
+ * executor spinning it: the ones shared by the whole tree if they are on the blackboard,
+ * or new ones for the node otherwise
+ * @param blackboard Blackboard of the BT node
+ * @param node ROS node to create the callback group in
+ * @param callback_group Output callback group
+ * @param executor Output executor spinning the callback group
+ * @return True if shared by the tree, the executor being then spun before each tick
+ */
+inline bool getCallbackGroupExecutor(
+  const BT::Blackboard::Ptr & blackboard,
+  const rclcpp::Node::SharedPtr & node,
+  rclcpp::CallbackGroup::SharedPtr & callback_group,
+  std::shared_ptr<rclcpp::executors::SingleThreadedExecutor> & executor)
+{
+  if (blackboard->get("callback_group", callback_group) &&
+    blackboard->get("callback_group_executor", executor))
+  {
+    return true;
+  }
+
+  callback_group = node->create_callback_group(
+    rclcpp::CallbackGroupType::MutuallyExclusive,
+    false);
+  executor = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+  executor->add_callback_group(callback_group, node->get_node_base_interface());
+  return false;
+}
+
 }  // namespace BT
 
 #endif  // NAV2_BEHAVIOR_TREE__BT_UTILS_HPP_
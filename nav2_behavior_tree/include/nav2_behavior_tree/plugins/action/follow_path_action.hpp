@@ -81,6 +81,9 @@ public:
     return providedBasicPorts(
       {
         BT::InputPort<nav_msgs::msg::Path>("path", "Path to follow"),
+        BT::InputPort<bool>(
+          "use_compact_path", false,
+          "Whether to send the path to the controller server as a compact path"),
         BT::InputPort<std::string>("controller_id", ""),
         BT::InputPort<std::string>("goal_checker_id", ""),
         BT::InputPort<std::string>("progress_checker_id", ""),
@@ -88,6 +91,15 @@ public:
           "error_code_id", "The follow path error code"),
       });
   }
+
+protected:
+  /**
+   * @brief Sets the compact path of the goal from the path to follow
+   */
+  void setGoalPath();
+
+  nav_msgs::msg::Path path_;
+  bool use_compact_path_{false};
 };
 
 }  // namespace nav2_behavior_tree
@@ -23,6 +23,7 @@
 #include "nav2_util/geometry_utils.hpp"
 #include "nav2_util/robot_utils.hpp"
 #include "behaviortree_cpp/action_node.h"
+#include "nav2_behavior_tree/robot_pose_cache.hpp"
 
 namespace nav2_behavior_tree
 {
@@ -58,7 +59,7 @@ private:
 
   double viapoint_achieved_radius_;
   double transform_tolerance_;
-  std::shared_ptr<tf2_ros::Buffer> tf_;
+  std::shared_ptr<RobotPoseCache> robot_pose_cache_;
   std::string robot_base_frame_;
   bool initialized_;
 };
@@ -0,0 +1,69 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_BEHAVIOR_TREE__PLUGINS__ACTION__TRUNCATE_GOALS_ACTION_HPP_
+#define NAV2_BEHAVIOR_TREE__PLUGINS__ACTION__TRUNCATE_GOALS_ACTION_HPP_
+
+#include <vector>
+#include <string>
+
+#include "geometry_msgs/msg/pose_stamped.hpp"
+#include "behaviortree_cpp/action_node.h"
+
+namespace nav2_behavior_tree
+{
+
+/**
+ * @brief A BT::ActionNodeBase that keeps the first goals of a set of goals, as the horizon
+ * of the legs planned ahead while navigating through poses
+ */
+class TruncateGoals : public BT::ActionNodeBase
+{
+public:
+  typedef std::vector<geometry_msgs::msg::PoseStamped> Goals;
+
+  /**
+   * @brief A nav2_behavior_tree::TruncateGoals constructor
+   * @param xml_tag_name Name for the XML tag for this node
+   * @param conf BT node configuration
+   */
+  TruncateGoals(
+    const std::string & xml_tag_name,
+    const BT::NodeConfiguration & conf);
+
+  /**
+   * @brief Creates list of BT ports
+   * @return BT::PortsList Containing node-specific ports
+   */
+  static BT::PortsList providedPorts()
+  {
+    return {
+      BT::InputPort<Goals>("input_goals", "Original goals to keep the first ones of"),
+      BT::OutputPort<Goals>("output_goals", "First goals of the original ones"),
+      BT::InputPort<int>(
+        "number_of_goals", 2, "Number of goals to keep, or all of them if not positive"),
+    };
+  }
+
+private:
+  void halt() override {}
+  BT::NodeStatus tick() override;
+
+  // Sequence id of the blackboard entry of the input goals when last truncated
+  uint64_t input_sequence_id_{0};
+};
+
+}  // namespace nav2_behavior_tree
+
+#endif  // NAV2_BEHAVIOR_TREE__PLUGINS__ACTION__TRUNCATE_GOALS_ACTION_HPP_
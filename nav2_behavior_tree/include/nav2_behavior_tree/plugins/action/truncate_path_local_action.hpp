@@ -23,7 +23,7 @@
 #include "nav_msgs/msg/path.hpp"
 
 #include "behaviortree_cpp/action_node.h"
-#include "tf2_ros/buffer.h"
+#include "nav2_behavior_tree/robot_pose_cache.hpp"
 
 namespace nav2_behavior_tree
 {
@@ -113,7 +113,7 @@ private:
     const geometry_msgs::msg::PoseStamped & pose2,
     const double angular_distance_weight);
 
-  std::shared_ptr<tf2_ros::Buffer> tf_buffer_;
+  std::shared_ptr<RobotPoseCache> robot_pose_cache_;
 
   nav_msgs::msg::Path path_;
   nav_msgs::msg::Path::_poses_type::iterator closest_pose_detection_begin_;
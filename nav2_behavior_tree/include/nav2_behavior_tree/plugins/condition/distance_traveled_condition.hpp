@@ -23,7 +23,7 @@
 
 #include "rclcpp/rclcpp.hpp"
 #include "geometry_msgs/msg/pose_stamped.hpp"
-#include "tf2_ros/buffer.h"
+#include "nav2_behavior_tree/robot_pose_cache.hpp"
 
 namespace nav2_behavior_tree
 {
@@ -72,7 +72,7 @@ public:
 
 private:
   rclcpp::Node::SharedPtr node_;
-  std::shared_ptr<tf2_ros::Buffer> tf_;
+  std::shared_ptr<RobotPoseCache> robot_pose_cache_;
 
   geometry_msgs::msg::PoseStamped start_pose_;
 
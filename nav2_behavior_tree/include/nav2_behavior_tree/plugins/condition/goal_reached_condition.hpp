@@ -20,7 +20,7 @@
 
 #include "rclcpp/rclcpp.hpp"
 #include "behaviortree_cpp/condition_node.h"
-#include "tf2_ros/buffer.h"
+#include "nav2_behavior_tree/robot_pose_cache.hpp"
 
 namespace nav2_behavior_tree
 {
@@ -87,7 +87,7 @@ protected:
 
 private:
   rclcpp::Node::SharedPtr node_;
-  std::shared_ptr<tf2_ros::Buffer> tf_;
+  std::shared_ptr<RobotPoseCache> robot_pose_cache_;
 
   bool initialized_;
   double goal_reached_tol_;
@@ -65,6 +65,9 @@ public:
 private:
   geometry_msgs::msg::PoseStamped goal_;
   std::vector<geometry_msgs::msg::PoseStamped> goals_;
+  // Sequence ids of the blackboard entries of the goals when last compared
+  uint64_t goals_sequence_id_{0};
+  uint64_t goal_sequence_id_{0};
 };
 
 }  // namespace nav2_behavior_tree
@@ -0,0 +1,99 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_BEHAVIOR_TREE__PLUGINS__CONTROL__PARALLEL_JOIN_NODE_HPP_
+#define NAV2_BEHAVIOR_TREE__PLUGINS__CONTROL__PARALLEL_JOIN_NODE_HPP_
+
+#include <string>
+#include <vector>
+
+#include "behaviortree_cpp/control_node.h"
+#include "behaviortree_cpp/bt_factory.h"
+
+namespace nav2_behavior_tree
+{
+
+/** @brief Type of control node that ticks all its children on each tick until they complete,
+ * so that their asynchronous actions run concurrently, and joins their results
+ *
+ * Type of Control Node  | Child Returns Failure | Child Returns Running
+ * ---------------------------------------------------------------------
+ *  ParallelJoin         |  Tick Next Child      | Tick Next Child
+ *
+ * The children that completed are not ticked again. The node returns SUCCESS as soon as
+ * success_threshold children succeeded, all of them by default, and FAILURE as soon as
+ * failure_threshold children failed, one by default, or when too many children failed for
+ * the success threshold to be reached. The children still running are then halted.
+ *
+ * As an example, let's say this node has 2 children with the default thresholds: A, clearing
+ * the local costmap, and B, clearing the global costmap.
+ * |    A    |    B    |
+ * ---------------------
+ * | RUNNING | RUNNING |  - both are ticked and request their clearing, ParallelJoin
+ *                        - returns RUNNING
+ * | SUCCESS | RUNNING |  - B is still running, ParallelJoin returns RUNNING
+ * | SUCCESS | SUCCESS |  - only B is ticked, both succeeded so ParallelJoin returns SUCCESS
+ *
+ * Skipped children are not counted in the default success threshold. If all the children
+ * are skipped, ParallelJoin is skipped.
+ *
+ * Usage in XML: <ParallelJoin success_threshold="-1" failure_threshold="1">
+ */
+class ParallelJoinNode : public BT::ControlNode
+{
+public:
+  /**
+   * @brief A constructor for nav2_behavior_tree::ParallelJoinNode
+   * @param name Name for the XML tag for this node
+   * @param config BT node configuration
+   */
+  ParallelJoinNode(const std::string & name, const BT::NodeConfiguration & config);
+
+  /**
+   * @brief The main override required by a BT action
+   * @return BT::NodeStatus Status of tick execution
+   */
+  BT::NodeStatus tick() override;
+
+  /**
+   * @brief The other (optional) override required by a BT action to reset node state
+   */
+  void halt() override;
+
+  /**
+   * @brief Creates list of BT ports
+   * @return BT::PortsList Containing basic ports along with node-specific ports
+   */
+  static BT::PortsList providedPorts()
+  {
+    return {
+      BT::InputPort<int>(
+        "success_threshold", -1,
+        "Number of children that must succeed, -1 for all of them"),
+      BT::InputPort<int>(
+        "failure_threshold", 1,
+        "Number of children whose failure fails the node")
+    };
+  }
+
+private:
+  /// @brief Status each child completed with, IDLE while it has not completed
+  std::vector<BT::NodeStatus> completed_;
+  int success_threshold_{-1};
+  int failure_threshold_{1};
+};
+
+}  // namespace nav2_behavior_tree
+
+#endif  // NAV2_BEHAVIOR_TREE__PLUGINS__CONTROL__PARALLEL_JOIN_NODE_HPP_
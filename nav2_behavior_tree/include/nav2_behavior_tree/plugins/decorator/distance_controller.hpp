@@ -20,7 +20,7 @@
 #include <string>
 
 #include "geometry_msgs/msg/pose_stamped.hpp"
-#include "tf2_ros/buffer.h"
+#include "nav2_behavior_tree/robot_pose_cache.hpp"
 
 #include "behaviortree_cpp/decorator_node.h"
 
@@ -65,7 +65,7 @@ private:
 
   rclcpp::Node::SharedPtr node_;
 
-  std::shared_ptr<tf2_ros::Buffer> tf_;
+  std::shared_ptr<RobotPoseCache> robot_pose_cache_;
   double transform_tolerance_;
 
   geometry_msgs::msg::PoseStamped start_pose_;
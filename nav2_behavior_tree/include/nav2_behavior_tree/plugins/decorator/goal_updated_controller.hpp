@@ -66,6 +66,9 @@ private:
   bool goal_was_updated_;
   geometry_msgs::msg::PoseStamped goal_;
   std::vector<geometry_msgs::msg::PoseStamped> goals_;
+  // Sequence ids of the blackboard entries of the goals when last compared
+  uint64_t goals_sequence_id_{0};
+  uint64_t goal_sequence_id_{0};
 };
 
 }  // namespace nav2_behavior_tree
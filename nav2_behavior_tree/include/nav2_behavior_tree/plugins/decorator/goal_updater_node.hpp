@@ -24,6 +24,7 @@
 #include "behaviortree_cpp/decorator_node.h"
 
 #include "rclcpp/rclcpp.hpp"
+#include "nav2_behavior_tree/bt_utils.hpp"
 
 namespace nav2_behavior_tree
 {
@@ -74,10 +75,14 @@ private:
   rclcpp::Subscription<geometry_msgs::msg::PoseStamped>::SharedPtr goal_sub_;
 
   geometry_msgs::msg::PoseStamped last_goal_received_;
+  bool goal_received_{false};
+  // Sequence id of the blackboard entry of the input goal when last read
+  uint64_t input_sequence_id_{0};
 
   rclcpp::Node::SharedPtr node_;
   rclcpp::CallbackGroup::SharedPtr callback_group_;
-  rclcpp::executors::SingleThreadedExecutor callback_group_executor_;
+  std::shared_ptr<rclcpp::executors::SingleThreadedExecutor> callback_group_executor_;
+  bool callback_group_shared_{false};
 };
 
 }  // namespace nav2_behavior_tree
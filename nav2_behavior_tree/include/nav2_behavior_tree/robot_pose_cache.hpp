@@ -0,0 +1,135 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_BEHAVIOR_TREE__ROBOT_POSE_CACHE_HPP_
+#define NAV2_BEHAVIOR_TREE__ROBOT_POSE_CACHE_HPP_
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "behaviortree_cpp/blackboard.h"
+#include "geometry_msgs/msg/pose_stamped.hpp"
+#include "nav2_util/robot_utils.hpp"
+#include "tf2_ros/buffer.h"
+
+namespace nav2_behavior_tree
+{
+
+/**
+ * @class nav2_behavior_tree::RobotPoseCache
+ * @brief Cache of the current pose of the robot shared by the nodes of a tree through the
+ * "robot_pose_cache" blackboard entry, so that the pose is looked up in TF once per tick
+ * rather than by each node needing it. The poses are dropped after each tick of the tree
+ * by the BtActionServer, and anyway once older than the maximum age.
+ */
+class RobotPoseCache
+{
+public:
+  /**
+   * @brief A constructor for nav2_behavior_tree::RobotPoseCache
+   * @param tf TF buffer to look up the poses in
+   * @param max_age Maximum age of the poses returned from the cache, 0 to disable it
+   */
+  explicit RobotPoseCache(
+    std::shared_ptr<tf2_ros::Buffer> tf,
+    std::chrono::nanoseconds max_age = std::chrono::milliseconds(10))
+  : tf_(tf), max_age_(max_age)
+  {}
+
+  /**
+   * @brief Gets the current pose of the robot, from the cache if recent enough or TF otherwise
+   * @param global_pose Output pose of the robot
+   * @param global_frame Frame to get the pose in
+   * @param robot_frame Frame of the robot
+   * @param transform_timeout Timeout of the TF lookup
+   * @return bool true if the pose is available
+   */
+  bool getCurrentPose(
+    geometry_msgs::msg::PoseStamped & global_pose,
+    const std::string & global_frame,
+    const std::string & robot_frame,
+    const double transform_timeout)
+  {
+    const auto now = std::chrono::steady_clock::now();
+    for (const auto & entry : entries_) {
+      if (entry.global_frame == global_frame && entry.robot_frame == robot_frame &&
+        now - entry.stamp < max_age_)
+      {
+        global_pose = entry.pose;
+        return true;
+      }
+    }
+
+    if (!nav2_util::getCurrentPose(
+        global_pose, *tf_, global_frame, robot_frame, transform_timeout))
+    {
+      return false;
+    }
+
+    for (auto & entry : entries_) {
+      if (entry.global_frame == global_frame && entry.robot_frame == robot_frame) {
+        entry.pose = global_pose;
+        entry.stamp = now;
+        return true;
+      }
+    }
+    entries_.push_back(Entry{global_frame, robot_frame, global_pose, now});
+    return true;
+  }
+
+  /**
+   * @brief Drops the cached poses, for them to be looked up again
+   */
+  void invalidate()
+  {
+    entries_.clear();
+  }
+
+  /**
+   * @brief Gets the cache of the tree from the blackboard, or a disabled cache looking up
+   * each pose when requested if the tree has none
+   * @param blackboard Blackboard of the BT node
+   * @return std::shared_ptr<RobotPoseCache> The cache
+   */
+  static std::shared_ptr<RobotPoseCache> get(const BT::Blackboard::Ptr & blackboard)
+  {
+    std::shared_ptr<RobotPoseCache> cache;
+    if (!blackboard->get("robot_pose_cache", cache) || !cache) {
+      cache = std::make_shared<RobotPoseCache>(
+        blackboard->get<std::shared_ptr<tf2_ros::Buffer>>("tf_buffer"),
+        std::chrono::nanoseconds::zero());
+    }
+    return cache;
+  }
+
+protected:
+  struct Entry
+  {
+    std::string global_frame;
+    std::string robot_frame;
+    geometry_msgs::msg::PoseStamped pose;
+    std::chrono::steady_clock::time_point stamp;
+  };
+
+  std::shared_ptr<tf2_ros::Buffer> tf_;
+  std::chrono::nanoseconds max_age_;
+  // One entry per pair of frames looked up, most trees using a single one
+  std::vector<Entry> entries_;
+};
+
+}  // namespace nav2_behavior_tree
+
+#endif  // NAV2_BEHAVIOR_TREE__ROBOT_POSE_CACHE_HPP_
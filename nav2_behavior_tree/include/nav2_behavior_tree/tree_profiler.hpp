@@ -0,0 +1,133 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_BEHAVIOR_TREE__TREE_PROFILER_HPP_
+#define NAV2_BEHAVIOR_TREE__TREE_PROFILER_HPP_
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "behaviortree_cpp/bt_factory.h"
+#include "behaviortree_cpp/loggers/abstract_logger.h"
+#include "nav2_msgs/msg/behavior_tree_statistics.hpp"
+#include "rclcpp/time.hpp"
+
+namespace nav2_behavior_tree
+{
+
+/**
+ * @class nav2_behavior_tree::TreeProfiler
+ * @brief Records the tick durations of the nodes of a BT and the duration of their runs,
+ * from their first tick to SUCCESS or FAILURE, which for action nodes is the round trip from
+ * sending their goal to getting its result. The statistics are accumulated until taken,
+ * and the last ticks kept in a ring buffer to be dumped as a Chrome trace, which can be
+ * opened in chrome://tracing or Perfetto.
+ */
+class TreeProfiler : public BT::StatusChangeLogger
+{
+public:
+  /**
+   * @brief A constructor for nav2_behavior_tree::TreeProfiler
+   * @param tree BT to profile, installing a tick monitor on each of its nodes
+   * @param trace_size Number of ticks kept for the trace, 0 to disable it
+   */
+  TreeProfiler(const BT::Tree & tree, size_t trace_size);
+
+  /**
+   * @brief Callback function which is called each time BT changes status,
+   * to time the runs of the nodes
+   * @param timestamp Timestamp of BT status change
+   * @param node Node that changed status
+   * @param prev_status Previous status of the node
+   * @param status Current status of the node
+   */
+  void callback(
+    BT::Duration timestamp,
+    const BT::TreeNode & node,
+    BT::NodeStatus prev_status,
+    BT::NodeStatus status) override;
+
+  /**
+   * @brief Nothing to flush, the statistics being taken with getStatistics
+   */
+  void flush() override {}
+
+  /**
+   * @brief Takes the statistics accumulated since the last call
+   * @param stamp Time of the statistics
+   * @param bt_xml_filename BT the statistics are of
+   * @return nav2_msgs::msg::BehaviorTreeStatistics Statistics of the nodes ticked or run
+   */
+  nav2_msgs::msg::BehaviorTreeStatistics getStatistics(
+    const rclcpp::Time & stamp, const std::string & bt_xml_filename);
+
+  /**
+   * @brief Writes the ticks of the ring buffer as a Chrome trace in JSON
+   * @param filename File to write
+   * @return bool true if written
+   */
+  bool dumpTrace(const std::string & filename) const;
+
+protected:
+  /**
+   * @brief Accounts a tick of a node
+   * @param index Index of the node in statistics_
+   * @param status Status returned by the tick
+   * @param duration Duration of the tick
+   */
+  void onTick(size_t index, BT::NodeStatus status, std::chrono::microseconds duration);
+
+  struct NodeStatistics
+  {
+    std::string name;
+    std::string registration_name;
+    uint16_t uid;
+    uint32_t ticks{0};
+    std::chrono::nanoseconds tick_sum{0};
+    std::chrono::nanoseconds tick_max{0};
+    uint32_t runs{0};
+    std::chrono::nanoseconds run_sum{0};
+    std::chrono::nanoseconds run_max{0};
+    bool running{false};
+    BT::Duration run_start{0};
+  };
+
+  struct TraceEvent
+  {
+    size_t index;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::microseconds duration;
+    BT::NodeStatus status;
+  };
+
+  // Statistics of each node of the tree, in the order of the tree
+  std::vector<NodeStatistics> statistics_;
+  std::unordered_map<uint16_t, size_t> indexes_;
+
+  // Ring buffer of the last ticks, trace_next_ being the oldest once full
+  std::vector<TraceEvent> trace_;
+  size_t trace_size_;
+  size_t trace_next_{0};
+  std::chrono::steady_clock::time_point origin_;
+
+  // The trace is dumped on request from another thread than the one ticking the tree
+  mutable std::mutex mutex_;
+};
+
+}  // namespace nav2_behavior_tree
+
+#endif  // NAV2_BEHAVIOR_TREE__TREE_PROFILER_HPP_
@@ -14,9 +14,11 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "nav2_behavior_tree/plugins/action/compute_path_through_poses_action.hpp"
+#include "nav2_behavior_tree/bt_utils.hpp"
 
 namespace nav2_behavior_tree
 {
@@ -40,7 +42,7 @@ void ComputePathThroughPosesAction::on_tick()
 
 BT::NodeStatus ComputePathThroughPosesAction::on_success()
 {
-  setOutput("path", result_.result->path);
+  BT::moveOutput(*this, "path", std::move(result_.result->path));
   // Set empty error code, action was successful
   setOutput("error_code_id", ActionResult::NONE);
   return BT::NodeStatus::SUCCESS;
@@ -14,8 +14,10 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 
 #include "nav2_behavior_tree/plugins/action/compute_path_to_pose_action.hpp"
+#include "nav2_behavior_tree/bt_utils.hpp"
 
 namespace nav2_behavior_tree
 {
@@ -39,7 +41,7 @@ void ComputePathToPoseAction::on_tick()
 
 BT::NodeStatus ComputePathToPoseAction::on_success()
 {
-  setOutput("path", result_.result->path);
+  BT::moveOutput(*this, "path", std::move(result_.result->path));
   // Set empty error code, action was successful
   setOutput("error_code_id", ActionResult::NONE);
   return BT::NodeStatus::SUCCESS;
@@ -16,6 +16,8 @@
 #include <string>
 
 #include "nav2_behavior_tree/plugins/action/follow_path_action.hpp"
+#include "nav2_behavior_tree/bt_utils.hpp"
+#include "nav2_util/compact_path.hpp"
 
 namespace nav2_behavior_tree
 {
@@ -30,12 +32,26 @@ FollowPathAction::FollowPathAction(
 
 void FollowPathAction::on_tick()
 {
-  getInput("path", goal_.path);
+  getInput("use_compact_path", use_compact_path_);
+  if (use_compact_path_) {
+    getInput("path", path_);
+    setGoalPath();
+  } else {
+    getInput("path", goal_.path);
+    goal_.compact_path = nav2_msgs::msg::CompactPath();
+  }
   getInput("controller_id", goal_.controller_id);
   getInput("goal_checker_id", goal_.goal_checker_id);
   getInput("progress_checker_id", goal_.progress_checker_id);
 }
 
+void FollowPathAction::setGoalPath()
+{
+  // Only the compact path is sent, the full path being kept to detect new ones
+  goal_.path = nav_msgs::msg::Path();
+  nav2_util::toCompactPath(path_, goal_.compact_path);
+}
+
 BT::NodeStatus FollowPathAction::on_success()
 {
   setOutput("error_code_id", ActionResult::NONE);
@@ -58,16 +74,19 @@ BT::NodeStatus FollowPathAction::on_cancelled()
 void FollowPathAction::on_wait_for_result(
   std::shared_ptr<const Action::Feedback>/*feedback*/)
 {
-  // Grab the new path
-  nav_msgs::msg::Path new_path;
-  getInput("path", new_path);
-
-  // Check if it is not same with the current one
-  if (goal_.path != new_path) {
-    // the action server on the next loop iteration
-    goal_.path = new_path;
-    goal_updated_ = true;
-  }
+  // Check if the new path is not same with the current one, comparing it in place
+  BT::readInputInPlace<nav_msgs::msg::Path>(
+    *this, "path", [this](const nav_msgs::msg::Path & new_path) {
+      if (use_compact_path_ && path_ != new_path) {
+        path_ = new_path;
+        setGoalPath();
+        goal_updated_ = true;
+      } else if (!use_compact_path_ && goal_.path != new_path) {
+        // the action server on the next loop iteration
+        goal_.path = new_path;
+        goal_updated_ = true;
+      }
+    });
 
   std::string new_controller_id;
   getInput("controller_id", new_controller_id);
@@ -15,6 +15,7 @@
 #include <string>
 #include <memory>
 #include <limits>
+#include <utility>
 
 #include "nav_msgs/msg/path.hpp"
 #include "nav2_util/geometry_utils.hpp"
@@ -37,7 +38,7 @@ void RemovePassedGoals::initialize()
 {
   getInput("radius", viapoint_achieved_radius_);
 
-  tf_ = config().blackboard->get<std::shared_ptr<tf2_ros::Buffer>>("tf_buffer");
+  robot_pose_cache_ = RobotPoseCache::get(config().blackboard);
   auto node = config().blackboard->get<rclcpp::Node::SharedPtr>("node");
   node->get_parameter("transform_tolerance", transform_tolerance_);
 
@@ -53,37 +54,51 @@ inline BT::NodeStatus RemovePassedGoals::tick()
     initialize();
   }
 
-  Goals goal_poses;
-  getInput("input_goals", goal_poses);
-
-  if (goal_poses.empty()) {
-    setOutput("output_goals", goal_poses);
-    return BT::NodeStatus::SUCCESS;
-  }
+  // Writing the goals back to the same entry when none was passed would only signal an update
+  const bool same_entry = getRawPortValue("input_goals") == getRawPortValue("output_goals");
 
   using namespace nav2_util::geometry_utils;  // NOLINT
 
-  geometry_msgs::msg::PoseStamped current_pose;
-  if (!nav2_util::getCurrentPose(
-      current_pose, *tf_, goal_poses[0].header.frame_id, robot_base_frame_,
-      transform_tolerance_))
-  {
+  Goals goal_poses;
+  size_t passed_goals = 0;
+  bool pose_available = true;
+  BT::readInputInPlace<Goals>(
+    *this, "input_goals", [&](const Goals & goals) {
+      if (goals.empty()) {
+        return;
+      }
+
+      geometry_msgs::msg::PoseStamped current_pose;
+      if (!robot_pose_cache_->getCurrentPose(
+          current_pose, goals[0].header.frame_id, robot_base_frame_,
+          transform_tolerance_))
+      {
+        pose_available = false;
+        return;
+      }
+
+      // Count the passed goals, keeping the last one
+      while (passed_goals + 1 < goals.size() &&
+        euclidean_distance(goals[passed_goals].pose, current_pose.pose) <=
+        viapoint_achieved_radius_)
+      {
+        ++passed_goals;
+      }
+
+      // Only the remaining goals are copied, and only if they are to be written
+      if (passed_goals > 0 || !same_entry) {
+        goal_poses.assign(goals.begin() + passed_goals, goals.end());
+      }
+    });
+
+  if (!pose_available) {
     return BT::NodeStatus::FAILURE;
   }
 
-  double dist_to_goal;
-  while (goal_poses.size() > 1) {
-    dist_to_goal = euclidean_distance(goal_poses[0].pose, current_pose.pose);
-
-    if (dist_to_goal > viapoint_achieved_radius_) {
-      break;
-    }
-
-    goal_poses.erase(goal_poses.begin());
+  if (passed_goals > 0 || !same_entry) {
+    BT::moveOutput(*this, "output_goals", std::move(goal_poses));
   }
 
-  setOutput("output_goals", goal_poses);
-
   return BT::NodeStatus::SUCCESS;
 }
 
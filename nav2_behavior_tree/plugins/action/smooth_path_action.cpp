@@ -15,8 +15,10 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 
 #include "nav2_behavior_tree/plugins/action/smooth_path_action.hpp"
+#include "nav2_behavior_tree/bt_utils.hpp"
 
 namespace nav2_behavior_tree
 {
@@ -41,7 +43,7 @@ void SmoothPathAction::on_tick()
 
 BT::NodeStatus SmoothPathAction::on_success()
 {
-  setOutput("smoothed_path", result_.result->path);
+  BT::moveOutput(*this, "smoothed_path", std::move(result_.result->path));
   setOutput("smoothing_duration", rclcpp::Duration(result_.result->smoothing_duration).seconds());
   setOutput("was_completed", result_.result->was_completed);
   // Set empty error code, action was successful
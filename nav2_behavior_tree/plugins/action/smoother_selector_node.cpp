@@ -34,10 +34,8 @@ SmootherSelector::SmootherSelector(
 : BT::SyncActionNode(name, conf)
 {
   node_ = config().blackboard->get<rclcpp::Node::SharedPtr>("node");
-  callback_group_ = node_->create_callback_group(
-    rclcpp::CallbackGroupType::MutuallyExclusive,
-    false);
-  callback_group_executor_.add_callback_group(callback_group_, node_->get_node_base_interface());
+  callback_group_shared_ = BT::getCallbackGroupExecutor(
+    config().blackboard, node_, callback_group_, callback_group_executor_);
 
   getInput("topic_name", topic_name_);
 
@@ -55,7 +53,10 @@ SmootherSelector::SmootherSelector(
 
 BT::NodeStatus SmootherSelector::tick()
 {
-  callback_group_executor_.spin_some();
+  // a callback group shared by the tree has already been spun before this tick
+  if (!callback_group_shared_) {
+    callback_group_executor_->spin_some();
+  }
 
   // This behavior always use the last selected smoother received from the topic input.
   // When no input is specified it uses the default smoother.
@@ -0,0 +1,65 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <utility>
+
+#include "nav2_behavior_tree/plugins/action/truncate_goals_action.hpp"
+#include "nav2_behavior_tree/bt_utils.hpp"
+
+namespace nav2_behavior_tree
+{
+
+TruncateGoals::TruncateGoals(
+  const std::string & name,
+  const BT::NodeConfiguration & conf)
+: BT::ActionNodeBase(name, conf)
+{}
+
+inline BT::NodeStatus TruncateGoals::tick()
+{
+  setStatus(BT::NodeStatus::RUNNING);
+
+  // The goals kept only change with the input goals, and rewriting them would signal an update
+  const uint64_t sequence_id = BT::getInputOrBlackboardSequenceId("input_goals");
+  if (sequence_id != 0 && sequence_id == input_sequence_id_) {
+    return BT::NodeStatus::SUCCESS;
+  }
+  input_sequence_id_ = sequence_id;
+
+  int number_of_goals = 2;
+  getInput("number_of_goals", number_of_goals);
+
+  // Only the kept goals are copied out of the blackboard
+  Goals output_goals;
+  BT::readInputInPlace<Goals>(
+    *this, "input_goals", [&output_goals, number_of_goals](const Goals & goals) {
+      auto last = goals.end();
+      if (number_of_goals > 0 && static_cast<size_t>(number_of_goals) < goals.size()) {
+        last = goals.begin() + number_of_goals;
+      }
+      output_goals.assign(goals.begin(), last);
+    });
+
+  BT::moveOutput(*this, "output_goals", std::move(output_goals));
+  return BT::NodeStatus::SUCCESS;
+}
+
+}  // namespace nav2_behavior_tree
+
+#include "behaviortree_cpp/bt_factory.h"
+BT_REGISTER_NODES(factory)
+{
+  factory.registerNodeType<nav2_behavior_tree::TruncateGoals>("TruncateGoals");
+}
@@ -16,6 +16,7 @@
 #include <string>
 #include <memory>
 #include <limits>
+#include <utility>
 
 #include "nav_msgs/msg/path.hpp"
 #include "geometry_msgs/msg/pose_stamped.hpp"
@@ -23,6 +24,7 @@
 #include "behaviortree_cpp/decorator_node.h"
 
 #include "nav2_behavior_tree/plugins/action/truncate_path_action.hpp"
+#include "nav2_behavior_tree/bt_utils.hpp"
 
 namespace nav2_behavior_tree
 {
@@ -75,7 +77,7 @@ inline BT::NodeStatus TruncatePath::tick()
   input_path.poses.back().pose.orientation = nav2_util::geometry_utils::orientationAroundZAxis(
     final_angle);
 
-  setOutput("output_path", input_path);
+  BT::moveOutput(*this, "output_path", std::move(input_path));
 
   return BT::NodeStatus::SUCCESS;
 }
@@ -15,6 +15,7 @@
 #include <limits>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "behaviortree_cpp/decorator_node.h"
@@ -25,6 +26,7 @@
 #include "tf2_ros/create_timer_ros.h"
 
 #include "nav2_behavior_tree/plugins/action/truncate_path_local_action.hpp"
+#include "nav2_behavior_tree/bt_utils.hpp"
 
 namespace nav2_behavior_tree
 {
@@ -34,9 +36,7 @@ TruncatePathLocal::TruncatePathLocal(
   const BT::NodeConfiguration & conf)
 : BT::ActionNodeBase(name, conf)
 {
-  tf_buffer_ =
-    config().blackboard->template get<std::shared_ptr<tf2_ros::Buffer>>(
-    "tf_buffer");
+  robot_pose_cache_ = RobotPoseCache::get(config().blackboard);
 }
 
 inline BT::NodeStatus TruncatePathLocal::tick()
@@ -54,11 +54,15 @@ inline BT::NodeStatus TruncatePathLocal::tick()
   getInput("max_robot_pose_search_dist", max_robot_pose_search_dist);
 
   bool path_pruning = std::isfinite(max_robot_pose_search_dist);
-  nav_msgs::msg::Path new_path;
-  getInput("input_path", new_path);
-  if (!path_pruning || new_path != path_) {
-    path_ = new_path;
-    closest_pose_detection_begin_ = path_.poses.begin();
+  // Compare the new path in place, only copying it when updated
+  auto update_path = [this, path_pruning](const nav_msgs::msg::Path & new_path) {
+      if (!path_pruning || new_path != path_) {
+        path_ = new_path;
+        closest_pose_detection_begin_ = path_.poses.begin();
+      }
+    };
+  if (!BT::readInputInPlace<nav_msgs::msg::Path>(*this, "input_path", update_path)) {
+    update_path(nav_msgs::msg::Path());
   }
 
   if (!getRobotPose(path_.header.frame_id, pose)) {
@@ -100,7 +104,7 @@ inline BT::NodeStatus TruncatePathLocal::tick()
   output_path.header = path_.header;
   output_path.poses = std::vector<geometry_msgs::msg::PoseStamped>(
     backward_pose_it.base(), forward_pose_it);
-  setOutput("output_path", output_path);
+  BT::moveOutput(*this, "output_path", std::move(output_path));
 
   return BT::NodeStatus::SUCCESS;
 }
@@ -118,8 +122,8 @@ inline bool TruncatePathLocal::getRobotPose(
     }
     double transform_tolerance;
     getInput("transform_tolerance", transform_tolerance);
-    if (!nav2_util::getCurrentPose(
-        pose, *tf_buffer_, path_frame_id, robot_frame, transform_tolerance))
+    if (!robot_pose_cache_->getCurrentPose(
+        pose, path_frame_id, robot_frame, transform_tolerance))
     {
       RCLCPP_WARN(
         config().blackboard->get<rclcpp::Node::SharedPtr>("node")->get_logger(),
@@ -50,7 +50,7 @@ void GoalReachedCondition::initialize()
     node_, "goal_reached_tol",
     rclcpp::ParameterValue(0.25));
   node_->get_parameter_or<double>("goal_reached_tol", goal_reached_tol_, 0.25);
-  tf_ = config().blackboard->get<std::shared_ptr<tf2_ros::Buffer>>("tf_buffer");
+  robot_pose_cache_ = RobotPoseCache::get(config().blackboard);
 
   node_->get_parameter("transform_tolerance", transform_tolerance_);
 
@@ -75,8 +75,8 @@ bool GoalReachedCondition::isGoalReached()
   getInput("goal", goal);
 
   geometry_msgs::msg::PoseStamped current_pose;
-  if (!nav2_util::getCurrentPose(
-      current_pose, *tf_, goal.header.frame_id, robot_base_frame_, transform_tolerance_))
+  if (!robot_pose_cache_->getCurrentPose(
+      current_pose, goal.header.frame_id, robot_base_frame_, transform_tolerance_))
   {
     RCLCPP_DEBUG(node_->get_logger(), "Current robot pose is not available.");
     return false;
@@ -31,9 +31,20 @@ BT::NodeStatus GoalUpdatedCondition::tick()
   if (!BT::isStatusActive(status())) {
     BT::getInputOrBlackboard("goals", goals_);
     BT::getInputOrBlackboard("goal", goal_);
+    goals_sequence_id_ = BT::getInputOrBlackboardSequenceId("goals");
+    goal_sequence_id_ = BT::getInputOrBlackboardSequenceId("goal");
     return BT::NodeStatus::FAILURE;
   }
 
+  // The goals are only compared when their blackboard entries were written since last checked
+  const uint64_t goals_sequence_id = BT::getInputOrBlackboardSequenceId("goals");
+  const uint64_t goal_sequence_id = BT::getInputOrBlackboardSequenceId("goal");
+  if (goals_sequence_id == goals_sequence_id_ && goal_sequence_id == goal_sequence_id_) {
+    return BT::NodeStatus::FAILURE;
+  }
+  goals_sequence_id_ = goals_sequence_id;
+  goal_sequence_id_ = goal_sequence_id;
+
   std::vector<geometry_msgs::msg::PoseStamped> current_goals;
   geometry_msgs::msg::PoseStamped current_goal;
   BT::getInputOrBlackboard("goals", current_goals);
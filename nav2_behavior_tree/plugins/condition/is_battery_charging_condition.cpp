@@ -28,10 +28,8 @@ IsBatteryChargingCondition::IsBatteryChargingCondition(
 {
   getInput("battery_topic", battery_topic_);
   auto node = config().blackboard->get<rclcpp::Node::SharedPtr>("node");
-  callback_group_ = node->create_callback_group(
-    rclcpp::CallbackGroupType::MutuallyExclusive,
-    false);
-  callback_group_executor_.add_callback_group(callback_group_, node->get_node_base_interface());
+  callback_group_shared_ = BT::getCallbackGroupExecutor(
+    config().blackboard, node, callback_group_, callback_group_executor_);
 
   rclcpp::SubscriptionOptions sub_option;
   sub_option.callback_group = callback_group_;
@@ -40,11 +38,16 @@ IsBatteryChargingCondition::IsBatteryChargingCondition(
     rclcpp::SystemDefaultsQoS(),
     std::bind(&IsBatteryChargingCondition::batteryCallback, this, std::placeholders::_1),
     sub_option);
+  // Wake the tree up on new messages, so that an event driven tree ticks this node
+  battery_sub_->set_on_new_message_callback([this](size_t) {emitWakeUpSignal();});
 }
 
 BT::NodeStatus IsBatteryChargingCondition::tick()
 {
-  callback_group_executor_.spin_some();
+  // a callback group shared by the tree has already been spun before this tick
+  if (!callback_group_shared_) {
+    callback_group_executor_->spin_some();
+  }
   if (is_battery_charging_) {
     return BT::NodeStatus::SUCCESS;
   }
@@ -38,10 +38,8 @@ void IsBatteryLowCondition::initialize()
   getInput("battery_topic", battery_topic_);
   getInput("is_voltage", is_voltage_);
   node_ = config().blackboard->get<rclcpp::Node::SharedPtr>("node");
-  callback_group_ = node_->create_callback_group(
-    rclcpp::CallbackGroupType::MutuallyExclusive,
-    false);
-  callback_group_executor_.add_callback_group(callback_group_, node_->get_node_base_interface());
+  callback_group_shared_ = BT::getCallbackGroupExecutor(
+    config().blackboard, node_, callback_group_, callback_group_executor_);
 
   rclcpp::SubscriptionOptions sub_option;
   sub_option.callback_group = callback_group_;
@@ -50,6 +48,8 @@ void IsBatteryLowCondition::initialize()
     rclcpp::SystemDefaultsQoS(),
     std::bind(&IsBatteryLowCondition::batteryCallback, this, std::placeholders::_1),
     sub_option);
+  // Wake the tree up on new messages, so that an event driven tree ticks this node
+  battery_sub_->set_on_new_message_callback([this](size_t) {emitWakeUpSignal();});
   initialized_ = true;
 }
 
@@ -59,7 +59,10 @@ BT::NodeStatus IsBatteryLowCondition::tick()
     initialize();
   }
 
-  callback_group_executor_.spin_some();
+  // a callback group shared by the tree has already been spun before this tick
+  if (!callback_group_shared_) {
+    callback_group_executor_->spin_some();
+  }
   if (is_battery_low_) {
     return BT::NodeStatus::SUCCESS;
   }
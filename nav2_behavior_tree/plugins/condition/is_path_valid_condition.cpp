@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "nav2_behavior_tree/plugins/condition/is_path_valid_condition.hpp"
+#include "nav2_behavior_tree/bt_utils.hpp"
 #include <chrono>
 #include <memory>
 #include <string>
@@ -44,12 +45,12 @@ BT::NodeStatus IsPathValidCondition::tick()
     initialize();
   }
 
-  nav_msgs::msg::Path path;
-  getInput("path", path);
-
   auto request = std::make_shared<nav2_msgs::srv::IsPathValid::Request>();
 
-  request->path = path;
+  BT::readInputInPlace<nav_msgs::msg::Path>(
+    *this, "path", [&request](const nav_msgs::msg::Path & path) {
+      request->path = path;
+    });
   auto result = client_->async_send_request(request);
 
   if (rclcpp::spin_until_future_complete(node_, result, server_timeout_) ==
@@ -18,6 +18,7 @@
 #include "behaviortree_cpp/condition_node.h"
 
 #include "nav2_behavior_tree/plugins/condition/path_expiring_timer_condition.hpp"
+#include "nav2_behavior_tree/bt_utils.hpp"
 
 namespace nav2_behavior_tree
 {
@@ -42,15 +43,14 @@ BT::NodeStatus PathExpiringTimerCondition::tick()
     return BT::NodeStatus::FAILURE;
   }
 
-  // Grab the new path
-  nav_msgs::msg::Path path;
-  getInput("path", path);
-
-  // Reset timer if the path has been updated
-  if (prev_path_ != path) {
-    prev_path_ = path;
-    start_ = node_->now();
-  }
+  // Reset timer if the path has been updated, comparing the new path in place
+  BT::readInputInPlace<nav_msgs::msg::Path>(
+    *this, "path", [this](const nav_msgs::msg::Path & path) {
+      if (prev_path_ != path) {
+        prev_path_ = path;
+        start_ = node_->now();
+      }
+    });
 
   // Determine how long its been since we've started this iteration
   auto elapsed = node_->now() - start_;
@@ -0,0 +1,100 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <string>
+
+#include "nav2_behavior_tree/plugins/control/parallel_join_node.hpp"
+
+namespace nav2_behavior_tree
+{
+
+ParallelJoinNode::ParallelJoinNode(
+  const std::string & name,
+  const BT::NodeConfiguration & config)
+: BT::ControlNode(name, config)
+{
+}
+
+BT::NodeStatus ParallelJoinNode::tick()
+{
+  const int num_children = children_nodes_.size();
+
+  if (status() != BT::NodeStatus::RUNNING) {
+    // Start of a new run
+    getInput("success_threshold", success_threshold_);
+    getInput("failure_threshold", failure_threshold_);
+    completed_.assign(num_children, BT::NodeStatus::IDLE);
+  }
+
+  setStatus(BT::NodeStatus::RUNNING);
+
+  int num_succeeded = 0, num_failed = 0, num_skipped = 0;
+  for (int i = 0; i < num_children; i++) {
+    if (completed_[i] == BT::NodeStatus::IDLE) {
+      const BT::NodeStatus child_status = children_nodes_[i]->executeTick();
+      switch (child_status) {
+        case BT::NodeStatus::SUCCESS:
+        case BT::NodeStatus::FAILURE:
+        case BT::NodeStatus::SKIPPED:
+          completed_[i] = child_status;
+          break;
+
+        case BT::NodeStatus::RUNNING:
+          break;
+
+        default:
+          throw BT::LogicError("A child node must never return IDLE");
+      }
+    }
+
+    num_succeeded += completed_[i] == BT::NodeStatus::SUCCESS;
+    num_failed += completed_[i] == BT::NodeStatus::FAILURE;
+    num_skipped += completed_[i] == BT::NodeStatus::SKIPPED;
+  }
+
+  const int num_run = num_children - num_skipped;
+  if (num_run == 0) {
+    halt();
+    return BT::NodeStatus::SKIPPED;
+  }
+
+  // Thresholds beyond the number of children run are capped to it
+  const int required_successes =
+    success_threshold_ < 0 ? num_run : std::min(success_threshold_, num_run);
+  if (num_succeeded >= required_successes) {
+    halt();
+    return BT::NodeStatus::SUCCESS;
+  }
+  if (num_failed >= std::max(failure_threshold_, 1) ||
+    num_run - num_failed < required_successes)
+  {
+    halt();
+    return BT::NodeStatus::FAILURE;
+  }
+  return BT::NodeStatus::RUNNING;
+}
+
+void ParallelJoinNode::halt()
+{
+  ControlNode::halt();
+  completed_.clear();
+}
+
+}  // namespace nav2_behavior_tree
+
+BT_REGISTER_NODES(factory)
+{
+  factory.registerNodeType<nav2_behavior_tree::ParallelJoinNode>("ParallelJoin");
+}
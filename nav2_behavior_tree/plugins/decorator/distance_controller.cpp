@@ -40,7 +40,7 @@ DistanceController::DistanceController(
 {
   getInput("distance", distance_);
   node_ = config().blackboard->get<rclcpp::Node::SharedPtr>("node");
-  tf_ = config().blackboard->get<std::shared_ptr<tf2_ros::Buffer>>("tf_buffer");
+  robot_pose_cache_ = RobotPoseCache::get(config().blackboard);
   node_->get_parameter("transform_tolerance", transform_tolerance_);
 
   global_frame_ = BT::deconflictPortAndParamFrame<std::string>(
@@ -54,8 +54,8 @@ inline BT::NodeStatus DistanceController::tick()
   if (!BT::isStatusActive(status())) {
     // Reset the starting position since we're starting a new iteration of
     // the distance controller (moving from IDLE to RUNNING)
-    if (!nav2_util::getCurrentPose(
-        start_pose_, *tf_, global_frame_, robot_base_frame_,
+    if (!robot_pose_cache_->getCurrentPose(
+        start_pose_, global_frame_, robot_base_frame_,
         transform_tolerance_))
     {
       RCLCPP_DEBUG(node_->get_logger(), "Current robot pose is not available.");
@@ -68,8 +68,8 @@ inline BT::NodeStatus DistanceController::tick()
 
   // Determine distance travelled since we've started this iteration
   geometry_msgs::msg::PoseStamped current_pose;
-  if (!nav2_util::getCurrentPose(
-      current_pose, *tf_, global_frame_, robot_base_frame_,
+  if (!robot_pose_cache_->getCurrentPose(
+      current_pose, global_frame_, robot_base_frame_,
       transform_tolerance_))
   {
     RCLCPP_DEBUG(node_->get_logger(), "Current robot pose is not available.");
@@ -95,8 +95,8 @@ inline BT::NodeStatus DistanceController::tick()
         return child_state;
 
       case BT::NodeStatus::SUCCESS:
-        if (!nav2_util::getCurrentPose(
-            start_pose_, *tf_, global_frame_, robot_base_frame_,
+        if (!robot_pose_cache_->getCurrentPose(
+            start_pose_, global_frame_, robot_base_frame_,
             transform_tolerance_))
         {
           RCLCPP_DEBUG(node_->get_logger(), "Current robot pose is not available.");
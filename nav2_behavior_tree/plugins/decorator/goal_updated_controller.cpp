@@ -14,6 +14,7 @@
 
 #include <chrono>
 #include <string>
+#include <utility>
 
 #include "rclcpp/rclcpp.hpp"
 #include "geometry_msgs/msg/pose_stamped.hpp"
@@ -39,21 +40,31 @@ BT::NodeStatus GoalUpdatedController::tick()
 
     BT::getInputOrBlackboard("goals", goals_);
     BT::getInputOrBlackboard("goal", goal_);
+    goals_sequence_id_ = BT::getInputOrBlackboardSequenceId("goals");
+    goal_sequence_id_ = BT::getInputOrBlackboardSequenceId("goal");
 
     goal_was_updated_ = true;
   }
 
   setStatus(BT::NodeStatus::RUNNING);
 
-  std::vector<geometry_msgs::msg::PoseStamped> current_goals;
-  BT::getInputOrBlackboard("goals", current_goals);
-  geometry_msgs::msg::PoseStamped current_goal;
-  BT::getInputOrBlackboard("goal", current_goal);
+  // The goals are only compared when their blackboard entries were written since last checked
+  const uint64_t goals_sequence_id = BT::getInputOrBlackboardSequenceId("goals");
+  const uint64_t goal_sequence_id = BT::getInputOrBlackboardSequenceId("goal");
+  if (goals_sequence_id != goals_sequence_id_ || goal_sequence_id != goal_sequence_id_) {
+    goals_sequence_id_ = goals_sequence_id;
+    goal_sequence_id_ = goal_sequence_id;
 
-  if (goal_ != current_goal || goals_ != current_goals) {
-    goal_ = current_goal;
-    goals_ = current_goals;
-    goal_was_updated_ = true;
+    std::vector<geometry_msgs::msg::PoseStamped> current_goals;
+    BT::getInputOrBlackboard("goals", current_goals);
+    geometry_msgs::msg::PoseStamped current_goal;
+    BT::getInputOrBlackboard("goal", current_goal);
+
+    if (goal_ != current_goal || goals_ != current_goals) {
+      goal_ = std::move(current_goal);
+      goals_ = std::move(current_goals);
+      goal_was_updated_ = true;
+    }
   }
 
   // The child gets ticked the first time through and any time the goal has
@@ -34,10 +34,8 @@ GoalUpdater::GoalUpdater(
 : BT::DecoratorNode(name, conf)
 {
   node_ = config().blackboard->get<rclcpp::Node::SharedPtr>("node");
-  callback_group_ = node_->create_callback_group(
-    rclcpp::CallbackGroupType::MutuallyExclusive,
-    false);
-  callback_group_executor_.add_callback_group(callback_group_, node_->get_node_base_interface());
+  callback_group_shared_ = BT::getCallbackGroupExecutor(
+    config().blackboard, node_, callback_group_, callback_group_executor_);
 
   std::string goal_updater_topic;
   node_->get_parameter_or<std::string>("goal_updater_topic", goal_updater_topic, "goal_update");
@@ -53,12 +51,24 @@ GoalUpdater::GoalUpdater(
 
 inline BT::NodeStatus GoalUpdater::tick()
 {
+  // a callback group shared by the tree has already been spun before this tick
+  if (!callback_group_shared_) {
+    callback_group_executor_->spin_all(std::chrono::milliseconds(50));
+  }
+
+  // Unless the input goal was written or a goal received, the output goal is left as is
+  // rather than rewritten, which would signal an update of it
+  const uint64_t sequence_id = BT::getInputOrBlackboardSequenceId("input_goal");
+  if (sequence_id != 0 && sequence_id == input_sequence_id_ && !goal_received_) {
+    return child_node_->executeTick();
+  }
+  input_sequence_id_ = sequence_id;
+  goal_received_ = false;
+
   geometry_msgs::msg::PoseStamped goal;
 
   getInput("input_goal", goal);
 
-  callback_group_executor_.spin_all(std::chrono::milliseconds(50));
-
   if (last_goal_received_.header.stamp != rclcpp::Time(0)) {
     auto last_goal_received_time = rclcpp::Time(last_goal_received_.header.stamp);
     auto goal_time = rclcpp::Time(goal.header.stamp);
@@ -80,6 +90,7 @@ void
 GoalUpdater::callback_updated_goal(const geometry_msgs::msg::PoseStamped::SharedPtr msg)
 {
   last_goal_received_ = *msg;
+  goal_received_ = true;
 }
 
 }  // namespace nav2_behavior_tree
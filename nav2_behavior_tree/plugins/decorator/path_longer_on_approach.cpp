@@ -14,6 +14,7 @@
 
 #include <string>
 #include <memory>
+#include <utility>
 #include <vector>
 #include "nav2_util/geometry_utils.hpp"
 
@@ -83,15 +84,16 @@ inline BT::NodeStatus PathLongerOnApproach::tick()
         return child_state;
       case BT::NodeStatus::SUCCESS:
       case BT::NodeStatus::FAILURE:
-        old_path_ = new_path_;
+        // The new path is read again on the next tick, so it can be swapped rather than copied
+        std::swap(old_path_, new_path_);
         resetChild();
         return child_state;
       default:
-        old_path_ = new_path_;
+        std::swap(old_path_, new_path_);
         return BT::NodeStatus::FAILURE;
     }
   }
-  old_path_ = new_path_;
+  std::swap(old_path_, new_path_);
   first_time_ = false;
   return BT::NodeStatus::SUCCESS;
 }
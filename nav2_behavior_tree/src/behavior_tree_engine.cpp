@@ -15,27 +15,43 @@
 
 #include "nav2_behavior_tree/behavior_tree_engine.hpp"
 
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
 #include <memory>
+#include <set>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "rclcpp/rclcpp.hpp"
 #include "behaviortree_cpp/utils/shared_library.h"
+#include "nav2_util/tracing.hpp"
 
 namespace nav2_behavior_tree
 {
 
 BehaviorTreeEngine::BehaviorTreeEngine(
-  const std::vector<std::string> & plugin_libraries, rclcpp::Node::SharedPtr node)
+  const std::vector<std::string> & plugin_libraries, rclcpp::Node::SharedPtr node,
+  bool lazy_plugin_loading)
+: pending_plugins_(plugin_libraries)
 {
-  BT::SharedLibrary loader;
-  for (const auto & p : plugin_libraries) {
-    factory_.registerFromPlugin(loader.getOSName(p));
+  if (!lazy_plugin_loading) {
+    loadAllPlugins();
   }
 
   // clock for throttled debug log
   clock_ = node->get_clock();
 
+  callback_group_ = node->create_callback_group(
+    rclcpp::CallbackGroupType::MutuallyExclusive,
+    false);
+  callback_group_executor_ = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+  callback_group_executor_->add_callback_group(callback_group_, node->get_node_base_interface());
+
   // FIXME: the next two line are needed for back-compatibility with BT.CPP 3.8.x
   // Note that the can be removed, once we migrate from BT.CPP 4.5.x to 4.6+
   BT::ReactiveSequence::EnableException(false);
@@ -47,7 +63,9 @@ BehaviorTreeEngine::run(
   BT::Tree * tree,
   std::function<void()> onLoop,
   std::function<bool()> cancelRequested,
-  std::chrono::milliseconds loopTimeout)
+  std::chrono::milliseconds loopTimeout,
+  bool eventDriven,
+  std::chrono::milliseconds minLoopTimeout)
 {
   rclcpp::WallRate loopRate(loopTimeout);
   BT::NodeStatus result = BT::NodeStatus::RUNNING;
@@ -60,11 +78,28 @@ BehaviorTreeEngine::run(
         return BtStatus::CANCELED;
       }
 
-      result = tree->tickOnce();
+      const auto tickStart = std::chrono::steady_clock::now();
+      {
+        NAV2_TRACE_SCOPE("BehaviorTreeEngine::tick");
+        // Deliver the responses and messages to the nodes sharing the callback group at once
+        callback_group_executor_->spin_some();
+        // When event driven, the wake up signals emitted during the tick are left for the sleep
+        // below to keep the minimum time between ticks, instead of ticking again right away
+        result = eventDriven ? tree->tickExactlyOnce() : tree->tickOnce();
 
-      onLoop();
+        onLoop();
+      }
 
-      if (!loopRate.sleep()) {
+      if (eventDriven) {
+        if (result == BT::NodeStatus::RUNNING) {
+          // Sleep until a node wakes the tree up, or for at most loopTimeout
+          std::this_thread::sleep_until(tickStart + minLoopTimeout);
+          const auto remaining = tickStart + loopTimeout - std::chrono::steady_clock::now();
+          if (remaining > std::chrono::steady_clock::duration::zero()) {
+            tree->sleep(std::chrono::duration_cast<std::chrono::system_clock::duration>(remaining));
+          }
+        }
+      } else if (!loopRate.sleep()) {
         RCLCPP_DEBUG_THROTTLE(
           rclcpp::get_logger("BehaviorTreeEngine"),
           *clock_, 1000,
@@ -87,6 +122,9 @@ BehaviorTreeEngine::createTreeFromText(
   const std::string & xml_string,
   BT::Blackboard::Ptr blackboard)
 {
+  if (!pending_plugins_.empty()) {
+    loadPluginsForTree(xml_string, std::filesystem::current_path().string());
+  }
   return factory_.createTreeFromText(xml_string, blackboard);
 }
 
@@ -95,9 +133,170 @@ BehaviorTreeEngine::createTreeFromFile(
   const std::string & file_path,
   BT::Blackboard::Ptr blackboard)
 {
+  if (!pending_plugins_.empty()) {
+    std::ifstream xml_file(file_path);
+    std::stringstream xml_string;
+    xml_string << xml_file.rdbuf();
+    loadPluginsForTree(
+      xml_string.str(), std::filesystem::path(file_path).parent_path().string());
+  }
   return factory_.createTreeFromFile(file_path, blackboard);
 }
 
+void
+BehaviorTreeEngine::loadAllPlugins()
+{
+  for (const auto & p : pending_plugins_) {
+    factory_.registerFromPlugin(BT::SharedLibrary::getOSName(p));
+  }
+  pending_plugins_.clear();
+}
+
+void
+BehaviorTreeEngine::loadPluginsForTree(
+  const std::string & xml_string, const std::string & directory)
+{
+  std::set<std::string> ids;
+  if (!getNodeIDs(xml_string, directory, ids)) {
+    loadAllPlugins();
+    return;
+  }
+
+  const auto & builders = factory_.builders();
+  auto remove_registered = [&]() {
+      for (auto it = ids.begin(); it != ids.end(); ) {
+        it = builders.count(*it) ? ids.erase(it) : std::next(it);
+      }
+    };
+  remove_registered();
+
+  // Libraries named after the nodes first, most of them registering a single node
+  for (auto it = pending_plugins_.begin(); !ids.empty() && it != pending_plugins_.end(); ) {
+    const bool named_after = std::any_of(
+      ids.begin(), ids.end(), [&](const std::string & id) {
+        return isLibraryNamedAfter(*it, id);
+      });
+    if (named_after) {
+      factory_.registerFromPlugin(BT::SharedLibrary::getOSName(*it));
+      it = pending_plugins_.erase(it);
+      remove_registered();
+    } else {
+      ++it;
+    }
+  }
+
+  // Then the others in order until all nodes are registered, or none is left to load
+  while (!ids.empty() && !pending_plugins_.empty()) {
+    factory_.registerFromPlugin(BT::SharedLibrary::getOSName(pending_plugins_.front()));
+    pending_plugins_.erase(pending_plugins_.begin());
+    remove_registered();
+  }
+}
+
+bool
+BehaviorTreeEngine::getNodeIDs(
+  const std::string & xml_string, const std::string & directory,
+  std::set<std::string> & ids)
+{
+  // Reads the value of an attribute of a start tag
+  auto attribute = [](const std::string & tag, const std::string & name) {
+      size_t pos = 0;
+      while ((pos = tag.find(name, pos)) != std::string::npos) {
+        const size_t end = tag.find_first_not_of(" \t\r\n", pos + name.size());
+        const bool delimited = pos > 0 && std::isspace(static_cast<unsigned char>(tag[pos - 1]));
+        pos += name.size();
+        if (!delimited || end == std::string::npos || tag[end] != '=') {
+          continue;
+        }
+        const size_t quote = tag.find_first_of("\"'", end + 1);
+        if (quote == std::string::npos) {
+          break;
+        }
+        const size_t close = tag.find(tag[quote], quote + 1);
+        return tag.substr(quote + 1, close - quote - 1);
+      }
+      return std::string();
+    };
+
+  bool complete = true;
+  bool in_model = false;
+  size_t pos = 0;
+  while ((pos = xml_string.find('<', pos)) != std::string::npos) {
+    if (xml_string.compare(pos, 4, "<!--") == 0) {
+      pos = xml_string.find("-->", pos);
+      continue;
+    }
+    // The end of the tag, skipping quoted attribute values which may hold a '>'
+    size_t end = pos;
+    char quote = 0;
+    while (++end < xml_string.size() && (quote || xml_string[end] != '>')) {
+      if (quote == xml_string[end]) {
+        quote = 0;
+      } else if (!quote && (xml_string[end] == '"' || xml_string[end] == '\'')) {
+        quote = xml_string[end];
+      }
+    }
+    if (end >= xml_string.size()) {
+      break;
+    }
+    const std::string tag = xml_string.substr(pos + 1, end - pos - 1);
+    pos = end;
+    if (tag.empty() || tag[0] == '?' || tag[0] == '!') {
+      continue;
+    }
+    const std::string name = tag.substr(0, tag.find_first_of(" \t\r\n/", 1));
+    if (name[0] == '/') {
+      in_model = in_model && name != "/TreeNodesModel";
+      continue;
+    }
+    if (name == "TreeNodesModel") {
+      in_model = tag.back() != '/';
+    } else if (in_model || name == "root" || name == "BehaviorTree" || name == "SubTree") {
+      continue;
+    } else if (name == "include") {
+      const std::string path = attribute(tag, "path");
+      std::ifstream xml_file((std::filesystem::path(directory) / path).string());
+      if (!attribute(tag, "ros_pkg").empty() || !xml_file.good()) {
+        complete = false;
+        continue;
+      }
+      std::stringstream included;
+      included << xml_file.rdbuf();
+      complete &= getNodeIDs(
+        included.str(), (std::filesystem::path(directory) / path).parent_path().string(), ids);
+    } else if (name == "Action" || name == "Condition" || name == "Control" ||
+      name == "Decorator")
+    {
+      const std::string id = attribute(tag, "ID");
+      if (!id.empty()) {
+        ids.insert(id);
+      }
+    } else if (!name.empty()) {
+      ids.insert(name);
+    }
+  }
+  return complete;
+}
+
+bool
+BehaviorTreeEngine::isLibraryNamedAfter(const std::string & library, const std::string & id)
+{
+  // FollowPath as follow_path, WouldAControllerRecoveryHelp as would_a_controller_recovery_help
+  std::string snake_case;
+  for (size_t i = 0; i < id.size(); i++) {
+    const bool upper = std::isupper(static_cast<unsigned char>(id[i]));
+    if (upper && i > 0 &&
+      (!std::isupper(static_cast<unsigned char>(id[i - 1])) ||
+      (i + 1 < id.size() && std::islower(static_cast<unsigned char>(id[i + 1])))))
+    {
+      snake_case += '_';
+    }
+    snake_case += static_cast<char>(std::tolower(static_cast<unsigned char>(id[i])));
+  }
+  return !snake_case.empty() &&
+         ("_" + library + "_").find("_" + snake_case + "_") != std::string::npos;
+}
+
 // In order to re-run a Behavior Tree, we must be able to reset all nodes to the initial state
 void
 BehaviorTreeEngine::haltAllActions(BT::Tree & tree)
@@ -106,4 +305,12 @@ BehaviorTreeEngine::haltAllActions(BT::Tree & tree)
   tree.haltTree();
 }
 
+void
+BehaviorTreeEngine::shareCallbackGroup(BT::Blackboard::Ptr blackboard)
+{
+  blackboard->set<rclcpp::CallbackGroup::SharedPtr>("callback_group", callback_group_);  // NOLINT
+  blackboard->set<std::shared_ptr<rclcpp::executors::SingleThreadedExecutor>>(  // NOLINT
+    "callback_group_executor", callback_group_executor_);
+}
+
 }  // namespace nav2_behavior_tree
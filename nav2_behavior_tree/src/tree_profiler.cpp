@@ -0,0 +1,195 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_behavior_tree/tree_profiler.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <utility>
+
+#include "rclcpp/duration.hpp"
+
+namespace nav2_behavior_tree
+{
+
+namespace
+{
+
+std::string escapeJson(const std::string & text)
+{
+  std::string escaped;
+  escaped.reserve(text.size());
+  for (const char c : text) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+      escaped += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char code[7];
+      std::snprintf(code, sizeof(code), "\\u%04x", c);
+      escaped += code;
+    } else {
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+
+}  // namespace
+
+TreeProfiler::TreeProfiler(const BT::Tree & tree, size_t trace_size)
+: StatusChangeLogger(tree.rootNode()),
+  trace_size_(trace_size),
+  origin_(std::chrono::steady_clock::now())
+{
+  trace_.reserve(trace_size_);
+  BT::applyRecursiveVisitor(
+    tree.rootNode(), [this](BT::TreeNode * node) {
+      const size_t index = statistics_.size();
+      NodeStatistics statistics;
+      statistics.name = node->name();
+      statistics.registration_name = node->registrationName();
+      statistics.uid = node->UID();
+      statistics_.push_back(std::move(statistics));
+      indexes_[node->UID()] = index;
+      node->setTickMonitorCallback(
+        [this, index](BT::TreeNode &, BT::NodeStatus status, std::chrono::microseconds duration) {
+          onTick(index, status, duration);
+        });
+    });
+}
+
+void TreeProfiler::onTick(
+  size_t index, BT::NodeStatus status, std::chrono::microseconds duration)
+{
+  const auto start = std::chrono::steady_clock::now() - duration;
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto & statistics = statistics_[index];
+  statistics.ticks++;
+  statistics.tick_sum += duration;
+  statistics.tick_max = std::max<std::chrono::nanoseconds>(statistics.tick_max, duration);
+
+  if (trace_size_ == 0) {
+    return;
+  }
+  const TraceEvent event{index, start, duration, status};
+  if (trace_.size() < trace_size_) {
+    trace_.push_back(event);
+  } else {
+    trace_[trace_next_] = event;
+    trace_next_ = (trace_next_ + 1) % trace_size_;
+  }
+}
+
+void TreeProfiler::callback(
+  BT::Duration timestamp,
+  const BT::TreeNode & node,
+  BT::NodeStatus /*prev_status*/,
+  BT::NodeStatus status)
+{
+  auto it = indexes_.find(node.UID());
+  if (it == indexes_.end()) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto & statistics = statistics_[it->second];
+  switch (status) {
+    case BT::NodeStatus::RUNNING:
+      statistics.running = true;
+      statistics.run_start = timestamp;
+      break;
+    case BT::NodeStatus::SUCCESS:
+    case BT::NodeStatus::FAILURE:
+      if (statistics.running) {
+        const auto run = std::chrono::duration_cast<std::chrono::nanoseconds>(
+          timestamp - statistics.run_start);
+        statistics.runs++;
+        statistics.run_sum += run;
+        statistics.run_max = std::max(statistics.run_max, run);
+      }
+      statistics.running = false;
+      break;
+    default:
+      // Halted, or skipped
+      statistics.running = false;
+      break;
+  }
+}
+
+nav2_msgs::msg::BehaviorTreeStatistics TreeProfiler::getStatistics(
+  const rclcpp::Time & stamp, const std::string & bt_xml_filename)
+{
+  nav2_msgs::msg::BehaviorTreeStatistics msg;
+  msg.header.stamp = stamp;
+  msg.bt_xml_filename = bt_xml_filename;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto & statistics : statistics_) {
+    if (statistics.ticks == 0 && statistics.runs == 0) {
+      continue;
+    }
+    nav2_msgs::msg::BehaviorTreeNodeStatistics node_msg;
+    node_msg.node_name = statistics.name;
+    node_msg.registration_name = statistics.registration_name;
+    node_msg.uid = statistics.uid;
+    node_msg.ticks = statistics.ticks;
+    if (statistics.ticks > 0) {
+      node_msg.tick_mean = rclcpp::Duration(statistics.tick_sum / statistics.ticks);
+      node_msg.tick_max = rclcpp::Duration(statistics.tick_max);
+    }
+    node_msg.runs = statistics.runs;
+    if (statistics.runs > 0) {
+      node_msg.run_mean = rclcpp::Duration(statistics.run_sum / statistics.runs);
+      node_msg.run_max = rclcpp::Duration(statistics.run_max);
+    }
+    msg.nodes.push_back(std::move(node_msg));
+
+    // Runs in progress are accounted in the period they complete
+    statistics.ticks = 0;
+    statistics.tick_sum = statistics.tick_max = std::chrono::nanoseconds::zero();
+    statistics.runs = 0;
+    statistics.run_sum = statistics.run_max = std::chrono::nanoseconds::zero();
+  }
+  return msg;
+}
+
+bool TreeProfiler::dumpTrace(const std::string & filename) const
+{
+  std::ofstream file(filename);
+  if (!file) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Complete events of one thread, the ticks of the children nesting in those of their parents
+  file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+  for (size_t i = 0; i < trace_.size(); i++) {
+    const auto & event = trace_[(trace_next_ + i) % trace_.size()];
+    const auto & statistics = statistics_[event.index];
+    const double ts = std::chrono::duration<double, std::micro>(event.start - origin_).count();
+    file << (i > 0 ? ",\n" : "\n") <<
+      "{\"name\": \"" << escapeJson(statistics.name) << "\", " <<
+      "\"cat\": \"" << escapeJson(statistics.registration_name) << "\", " <<
+      "\"ph\": \"X\", \"pid\": 0, \"tid\": 0, " <<
+      "\"ts\": " << std::fixed << ts << ", \"dur\": " << event.duration.count() << ", " <<
+      "\"args\": {\"uid\": " << statistics.uid << ", " <<
+      "\"status\": \"" << BT::toStr(event.status, false) << "\"}}";
+  }
+  file << "\n]}\n";
+  return file.good();
+}
+
+}  // namespace nav2_behavior_tree
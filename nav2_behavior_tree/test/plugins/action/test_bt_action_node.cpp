@@ -24,6 +24,7 @@
 #include "rclcpp_action/rclcpp_action.hpp"
 
 #include "behaviortree_cpp/bt_factory.h"
+#include "nav2_behavior_tree/behavior_tree_engine.hpp"
 #include "nav2_behavior_tree/bt_action_node.hpp"
 
 #include "test_msgs/action/fibonacci.hpp"
@@ -482,6 +483,78 @@ TEST_F(BTActionNodeTestFixture, test_server_cancel)
   EXPECT_EQ(ticks, 7);
 }
 
+TEST_F(BTActionNodeTestFixture, test_event_driven_run)
+{
+  // create tree
+  std::string xml_txt =
+    R"(
+      <root BTCPP_format="4">
+        <BehaviorTree ID="MainTree">
+            <Fibonacci order="5" />
+        </BehaviorTree>
+      </root>)";
+
+  config_->blackboard->set<std::chrono::milliseconds>("server_timeout", 20ms);
+  config_->blackboard->set<std::chrono::milliseconds>("bt_loop_duration", 10ms);
+
+  tree_ = std::make_shared<BT::Tree>(factory_->createTreeFromText(xml_txt, config_->blackboard));
+
+  action_server_->setHandleGoalSleepDuration(2ms);
+  action_server_->setServerLoopRate(10ms);
+
+  // Ticking at least every 5 seconds, the result can only be seen in time if it wakes the tree up
+  nav2_behavior_tree::BehaviorTreeEngine engine({}, node_);
+  int ticks = 0;
+  const auto start = std::chrono::steady_clock::now();
+  auto rc = engine.run(
+    tree_.get(), [&ticks]() {ticks++;}, []() {return false;}, 5000ms, true, 1ms);
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+
+  EXPECT_EQ(rc, nav2_behavior_tree::BtStatus::SUCCEEDED);
+  EXPECT_LT(elapsed, 2500ms);
+  EXPECT_GE(ticks, 2);
+
+  auto sequence = config_->blackboard->get<std::vector<int>>("sequence");
+  std::vector<int> expected = {0, 1, 1, 2, 3, 5};
+  EXPECT_EQ(sequence, expected);
+}
+
+TEST_F(BTActionNodeTestFixture, test_shared_callback_group_run)
+{
+  // create tree
+  std::string xml_txt =
+    R"(
+      <root BTCPP_format="4">
+        <BehaviorTree ID="MainTree">
+          <Sequence>
+            <Fibonacci order="3" />
+            <Fibonacci order="5" />
+          </Sequence>
+        </BehaviorTree>
+      </root>)";
+
+  // the nodes of this tree use the callback group of the engine, spun before each tick
+  nav2_behavior_tree::BehaviorTreeEngine engine({}, node_);
+  auto blackboard = BT::Blackboard::create();
+  blackboard->set("node", node_);
+  blackboard->set<std::chrono::milliseconds>("server_timeout", 20ms);
+  blackboard->set<std::chrono::milliseconds>("bt_loop_duration", 10ms);
+  blackboard->set<std::chrono::milliseconds>("wait_for_service_timeout", 1000ms);
+  engine.shareCallbackGroup(blackboard);
+
+  tree_ = std::make_shared<BT::Tree>(factory_->createTreeFromText(xml_txt, blackboard));
+
+  action_server_->setHandleGoalSleepDuration(2ms);
+  action_server_->setServerLoopRate(10ns);
+
+  auto rc = engine.run(tree_.get(), []() {}, []() {return false;}, 10ms);
+  EXPECT_EQ(rc, nav2_behavior_tree::BtStatus::SUCCEEDED);
+
+  auto sequence = blackboard->get<std::vector<int>>("sequence");
+  std::vector<int> expected = {0, 1, 1, 2, 3, 5};
+  EXPECT_EQ(sequence, expected);
+}
+
 int main(int argc, char ** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -161,6 +161,39 @@ TEST_F(FollowPathActionTestFixture, test_tick)
   EXPECT_EQ(action_server_->getCurrentGoal()->path.poses[0].pose.position.x, -2.5);
 }
 
+TEST_F(FollowPathActionTestFixture, test_tick_compact_path)
+{
+  // create tree
+  std::string xml_txt =
+    R"(
+      <root BTCPP_format="4">
+        <BehaviorTree ID="MainTree">
+            <FollowPath path="{path}" controller_id="FollowPath" use_compact_path="true"/>
+        </BehaviorTree>
+      </root>)";
+
+  tree_ = std::make_shared<BT::Tree>(factory_->createTreeFromText(xml_txt, config_->blackboard));
+
+  // set new path on blackboard
+  nav_msgs::msg::Path path;
+  path.poses.resize(2);
+  path.poses[0].pose.position.x = 1.0;
+  path.poses[1].pose.position.y = 0.5;
+  config_->blackboard->set("path", path);
+
+  while (tree_->rootNode()->status() != BT::NodeStatus::SUCCESS) {
+    tree_->rootNode()->executeTick();
+  }
+
+  // only the compact path should have reached our server
+  auto goal = action_server_->getCurrentGoal();
+  EXPECT_TRUE(goal->path.poses.empty());
+  ASSERT_EQ(goal->compact_path.x.size(), 2u);
+  EXPECT_EQ(goal->compact_path.x[0], 1.0f);
+  EXPECT_EQ(goal->compact_path.y[1], 0.5f);
+  EXPECT_EQ(goal->compact_path.yaw.size(), 2u);
+}
+
 int main(int argc, char ** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
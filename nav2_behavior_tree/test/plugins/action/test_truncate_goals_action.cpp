@@ -0,0 +1,142 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "geometry_msgs/msg/pose_stamped.hpp"
+
+#include "behaviortree_cpp/bt_factory.h"
+
+#include "nav2_behavior_tree/plugins/action/truncate_goals_action.hpp"
+
+class TruncateGoalsTestFixture : public ::testing::Test
+{
+public:
+  static void SetUpTestCase()
+  {
+    factory_ = std::make_shared<BT::BehaviorTreeFactory>();
+
+    config_ = new BT::NodeConfiguration();
+
+    // Create the blackboard that will be shared by all of the nodes in the tree
+    config_->blackboard = BT::Blackboard::create();
+
+    BT::NodeBuilder builder =
+      [](const std::string & name, const BT::NodeConfiguration & config)
+      {
+        return std::make_unique<nav2_behavior_tree::TruncateGoals>(
+          name, config);
+      };
+
+    factory_->registerBuilder<nav2_behavior_tree::TruncateGoals>(
+      "TruncateGoals", builder);
+  }
+
+  static void TearDownTestCase()
+  {
+    delete config_;
+    config_ = nullptr;
+    factory_.reset();
+  }
+
+  void SetUp() override
+  {
+    goals_.resize(4);
+    for (size_t i = 0; i < goals_.size(); i++) {
+      goals_[i].pose.position.x = static_cast<double>(i);
+    }
+    config_->blackboard->set("goals", goals_);
+  }
+
+  void TearDown() override
+  {
+    tree_.reset();
+  }
+
+  std::vector<geometry_msgs::msg::PoseStamped> tick(const std::string & number_of_goals)
+  {
+    std::string xml_txt =
+      R"(
+        <root BTCPP_format="4">
+          <BehaviorTree ID="MainTree">
+            <TruncateGoals input_goals="{goals}" output_goals="{truncated_goals}" number_of_goals=")" +
+      number_of_goals + R"("/>
+          </BehaviorTree>
+        </root>)";
+
+    tree_ = std::make_shared<BT::Tree>(factory_->createTreeFromText(xml_txt, config_->blackboard));
+    EXPECT_EQ(tree_->rootNode()->executeTick(), BT::NodeStatus::SUCCESS);
+
+    std::vector<geometry_msgs::msg::PoseStamped> truncated_goals;
+    EXPECT_TRUE(config_->blackboard->get("truncated_goals", truncated_goals));
+    return truncated_goals;
+  }
+
+protected:
+  static BT::NodeConfiguration * config_;
+  static std::shared_ptr<BT::BehaviorTreeFactory> factory_;
+  static std::shared_ptr<BT::Tree> tree_;
+  std::vector<geometry_msgs::msg::PoseStamped> goals_;
+};
+
+BT::NodeConfiguration * TruncateGoalsTestFixture::config_ = nullptr;
+std::shared_ptr<BT::BehaviorTreeFactory> TruncateGoalsTestFixture::factory_ = nullptr;
+std::shared_ptr<BT::Tree> TruncateGoalsTestFixture::tree_ = nullptr;
+
+TEST_F(TruncateGoalsTestFixture, test_truncate)
+{
+  auto truncated_goals = tick("2");
+  ASSERT_EQ(truncated_goals.size(), 2u);
+  EXPECT_EQ(truncated_goals[0], goals_[0]);
+  EXPECT_EQ(truncated_goals[1], goals_[1]);
+
+  // The input goals are left untouched
+  std::vector<geometry_msgs::msg::PoseStamped> goals;
+  EXPECT_TRUE(config_->blackboard->get("goals", goals));
+  EXPECT_EQ(goals, goals_);
+}
+
+TEST_F(TruncateGoalsTestFixture, test_fewer_goals)
+{
+  EXPECT_EQ(tick("10"), goals_);
+}
+
+TEST_F(TruncateGoalsTestFixture, test_all_goals)
+{
+  EXPECT_EQ(tick("0"), goals_);
+}
+
+TEST_F(TruncateGoalsTestFixture, test_unchanged_goals)
+{
+  tick("2");
+
+  // The goals kept are not rewritten while the input goals are not
+  const uint64_t sequence_id = config_->blackboard->getEntry("truncated_goals")->sequence_id;
+  EXPECT_EQ(tree_->rootNode()->executeTick(), BT::NodeStatus::SUCCESS);
+  EXPECT_EQ(config_->blackboard->getEntry("truncated_goals")->sequence_id, sequence_id);
+
+  config_->blackboard->set("goals", goals_);
+  EXPECT_EQ(tree_->rootNode()->executeTick(), BT::NodeStatus::SUCCESS);
+  EXPECT_GT(config_->blackboard->getEntry("truncated_goals")->sequence_id, sequence_id);
+}
+
+int main(int argc, char ** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  return RUN_ALL_TESTS();
+}
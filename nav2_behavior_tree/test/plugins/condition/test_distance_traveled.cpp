@@ -14,6 +14,7 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <chrono>
 #include <memory>
 
 #include "geometry_msgs/msg/pose_stamped.hpp"
@@ -79,6 +80,35 @@ TEST_F(DistanceTraveledConditionTestFixture, test_behavior)
   }
 }
 
+TEST_F(DistanceTraveledConditionTestFixture, test_robot_pose_cache)
+{
+  // Poses cached by the tree are used until invalidated
+  auto robot_pose_cache = std::make_shared<nav2_behavior_tree::RobotPoseCache>(
+    transform_handler_->getBuffer(), std::chrono::hours(1));
+  config_->blackboard->set("robot_pose_cache", robot_pose_cache);
+  auto bt_node = std::make_shared<nav2_behavior_tree::DistanceTraveledCondition>(
+    "distance_traveled", *config_);
+
+  geometry_msgs::msg::PoseStamped pose;
+  ASSERT_TRUE(nav2_util::getCurrentPose(pose, *transform_handler_->getBuffer()));
+  EXPECT_EQ(bt_node->executeTick(), BT::NodeStatus::FAILURE);
+
+  const double start = pose.pose.position.x;
+  pose.pose.position.x = start + 2.0;
+  transform_handler_->updateRobotPose(pose.pose);
+  while (!nav2_util::getCurrentPose(pose, *transform_handler_->getBuffer()) ||
+    pose.pose.position.x < start + 1.5)
+  {
+  }
+
+  EXPECT_EQ(bt_node->executeTick(), BT::NodeStatus::FAILURE);
+  robot_pose_cache->invalidate();
+  EXPECT_EQ(bt_node->executeTick(), BT::NodeStatus::SUCCESS);
+
+  config_->blackboard->set(
+    "robot_pose_cache", std::shared_ptr<nav2_behavior_tree::RobotPoseCache>());
+}
+
 int main(int argc, char ** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
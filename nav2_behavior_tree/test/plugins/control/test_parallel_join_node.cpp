@@ -0,0 +1,166 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+#include "utils/test_behavior_tree_fixture.hpp"
+#include "utils/test_dummy_tree_node.hpp"
+#include "nav2_behavior_tree/plugins/control/parallel_join_node.hpp"
+
+// Counts its ticks, returning the current status
+class CountingDummy : public nav2_behavior_tree::DummyNode
+{
+public:
+  BT::NodeStatus tick() override
+  {
+    ticks_++;
+    return status();
+  }
+
+  int ticks_{0};
+};
+
+class ParallelJoinNodeTestFixture : public nav2_behavior_tree::BehaviorTreeTestFixture
+{
+public:
+  void SetUp() override
+  {
+    createNode("-1", "1");
+  }
+
+  void TearDown() override
+  {
+    bt_node_.reset();
+    first_child_.reset();
+    second_child_.reset();
+    third_child_.reset();
+  }
+
+  void createNode(const std::string & success_threshold, const std::string & failure_threshold)
+  {
+    BT::NodeConfiguration config = *config_;
+    config.input_ports["success_threshold"] = success_threshold;
+    config.input_ports["failure_threshold"] = failure_threshold;
+    bt_node_ = std::make_shared<nav2_behavior_tree::ParallelJoinNode>("parallel_join", config);
+    first_child_ = std::make_shared<CountingDummy>();
+    second_child_ = std::make_shared<CountingDummy>();
+    third_child_ = std::make_shared<CountingDummy>();
+    bt_node_->addChild(first_child_.get());
+    bt_node_->addChild(second_child_.get());
+    bt_node_->addChild(third_child_.get());
+  }
+
+protected:
+  std::shared_ptr<nav2_behavior_tree::ParallelJoinNode> bt_node_;
+  std::shared_ptr<CountingDummy> first_child_;
+  std::shared_ptr<CountingDummy> second_child_;
+  std::shared_ptr<CountingDummy> third_child_;
+};
+
+TEST_F(ParallelJoinNodeTestFixture, test_failure_on_idle_child)
+{
+  first_child_->changeStatus(BT::NodeStatus::IDLE);
+  EXPECT_THROW(bt_node_->executeTick(), BT::LogicError);
+}
+
+TEST_F(ParallelJoinNodeTestFixture, test_all_succeed)
+{
+  // All the children are ticked on each tick while running
+  first_child_->changeStatus(BT::NodeStatus::RUNNING);
+  second_child_->changeStatus(BT::NodeStatus::RUNNING);
+  third_child_->changeStatus(BT::NodeStatus::RUNNING);
+  EXPECT_EQ(bt_node_->executeTick(), BT::NodeStatus::RUNNING);
+  EXPECT_EQ(first_child_->ticks_, 1);
+  EXPECT_EQ(second_child_->ticks_, 1);
+  EXPECT_EQ(third_child_->ticks_, 1);
+
+  // The completed children are not ticked again
+  first_child_->changeStatus(BT::NodeStatus::SUCCESS);
+  EXPECT_EQ(bt_node_->executeTick(), BT::NodeStatus::RUNNING);
+  second_child_->changeStatus(BT::NodeStatus::SUCCESS);
+  EXPECT_EQ(bt_node_->executeTick(), BT::NodeStatus::RUNNING);
+  EXPECT_EQ(first_child_->ticks_, 2);
+  EXPECT_EQ(second_child_->ticks_, 3);
+  EXPECT_EQ(third_child_->ticks_, 3);
+
+  third_child_->changeStatus(BT::NodeStatus::SUCCESS);
+  EXPECT_EQ(bt_node_->executeTick(), BT::NodeStatus::SUCCESS);
+  EXPECT_EQ(first_child_->status(), BT::NodeStatus::IDLE);
+  EXPECT_EQ(second_child_->status(), BT::NodeStatus::IDLE);
+  EXPECT_EQ(third_child_->status(), BT::NodeStatus::IDLE);
+}
+
+TEST_F(ParallelJoinNodeTestFixture, test_first_failure)
+{
+  first_child_->changeStatus(BT::NodeStatus::SUCCESS);
+  second_child_->changeStatus(BT::NodeStatus::FAILURE);
+  third_child_->changeStatus(BT::NodeStatus::RUNNING);
+  EXPECT_EQ(bt_node_->executeTick(), BT::NodeStatus::FAILURE);
+  EXPECT_EQ(first_child_->status(), BT::NodeStatus::IDLE);
+  EXPECT_EQ(second_child_->status(), BT::NodeStatus::IDLE);
+  EXPECT_EQ(third_child_->status(), BT::NodeStatus::IDLE);
+}
+
+TEST_F(ParallelJoinNodeTestFixture, test_thresholds)
+{
+  // Any child succeeding is enough, the others being halted
+  createNode("1", "3");
+  first_child_->changeStatus(BT::NodeStatus::FAILURE);
+  second_child_->changeStatus(BT::NodeStatus::RUNNING);
+  third_child_->changeStatus(BT::NodeStatus::RUNNING);
+  EXPECT_EQ(bt_node_->executeTick(), BT::NodeStatus::RUNNING);
+  third_child_->changeStatus(BT::NodeStatus::SUCCESS);
+  EXPECT_EQ(bt_node_->executeTick(), BT::NodeStatus::SUCCESS);
+  EXPECT_EQ(second_child_->status(), BT::NodeStatus::IDLE);
+
+  // Two children succeeding out of three, which is impossible after two failures
+  createNode("2", "3");
+  first_child_->changeStatus(BT::NodeStatus::FAILURE);
+  second_child_->changeStatus(BT::NodeStatus::RUNNING);
+  third_child_->changeStatus(BT::NodeStatus::RUNNING);
+  EXPECT_EQ(bt_node_->executeTick(), BT::NodeStatus::RUNNING);
+  second_child_->changeStatus(BT::NodeStatus::FAILURE);
+  EXPECT_EQ(bt_node_->executeTick(), BT::NodeStatus::FAILURE);
+  EXPECT_EQ(third_child_->status(), BT::NodeStatus::IDLE);
+}
+
+TEST_F(ParallelJoinNodeTestFixture, test_skipped)
+{
+  first_child_->changeStatus(BT::NodeStatus::SKIPPED);
+  second_child_->changeStatus(BT::NodeStatus::SUCCESS);
+  third_child_->changeStatus(BT::NodeStatus::SUCCESS);
+  EXPECT_EQ(bt_node_->executeTick(), BT::NodeStatus::SUCCESS);
+
+  first_child_->changeStatus(BT::NodeStatus::SKIPPED);
+  second_child_->changeStatus(BT::NodeStatus::SKIPPED);
+  third_child_->changeStatus(BT::NodeStatus::SKIPPED);
+  EXPECT_EQ(bt_node_->executeTick(), BT::NodeStatus::SKIPPED);
+}
+
+int main(int argc, char ** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  // initialize ROS
+  rclcpp::init(argc, argv);
+
+  int all_successful = RUN_ALL_TESTS();
+
+  // shutdown ROS
+  rclcpp::shutdown();
+
+  return all_successful;
+}
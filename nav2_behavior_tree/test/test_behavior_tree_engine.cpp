@@ -0,0 +1,90 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <string>
+
+#include "nav2_behavior_tree/behavior_tree_engine.hpp"
+
+using nav2_behavior_tree::BehaviorTreeEngine;
+
+TEST(BehaviorTreeEngine, GetNodeIDs)
+{
+  const auto directory = std::filesystem::temp_directory_path();
+  {
+    std::ofstream included(directory / "test_behavior_tree_engine_included.xml");
+    included <<
+      R"(<root BTCPP_format="4">
+           <BehaviorTree ID="Recovery">
+             <Condition ID='IsStuck'/>
+             <Wait wait_duration="1.0"/>
+           </BehaviorTree>
+         </root>)";
+  }
+
+  const std::string xml =
+    R"(<?xml version="1.0"?>
+      <root BTCPP_format="4" main_tree_to_execute="MainTree">
+        <include path="test_behavior_tree_engine_included.xml"/>
+        <!-- <CommentedOut/> -->
+        <BehaviorTree ID="MainTree">
+          <PipelineSequence name="NavigateWithReplanning" _skipIf="a > b">
+            <RateController hz="1.0">
+              <ComputePathToPose goal="{goal}" path="{path}"/>
+            </RateController>
+            <Action ID="FollowPath" path="{path}"/>
+            <SubTree ID="Recovery"/>
+          </PipelineSequence>
+        </BehaviorTree>
+        <TreeNodesModel>
+          <Action ID="Modeled">
+            <input_port name="port">Modeled port</input_port>
+          </Action>
+        </TreeNodesModel>
+      </root>)";
+
+  std::set<std::string> ids;
+  EXPECT_TRUE(BehaviorTreeEngine::getNodeIDs(xml, directory.string(), ids));
+  EXPECT_EQ(
+    ids, (std::set<std::string>{
+      "ComputePathToPose", "FollowPath", "IsStuck", "PipelineSequence", "RateController",
+      "Wait"}));
+
+  // Missing includes are reported
+  ids.clear();
+  EXPECT_FALSE(
+    BehaviorTreeEngine::getNodeIDs(
+      R"(<root><include path="missing.xml"/><Spin/></root>)", directory.string(), ids));
+  EXPECT_EQ(ids, (std::set<std::string>{"Spin"}));
+}
+
+TEST(BehaviorTreeEngine, IsLibraryNamedAfter)
+{
+  EXPECT_TRUE(
+    BehaviorTreeEngine::isLibraryNamedAfter("nav2_follow_path_action_bt_node", "FollowPath"));
+  EXPECT_TRUE(
+    BehaviorTreeEngine::isLibraryNamedAfter(
+      "nav2_would_a_controller_recovery_help_condition_bt_node", "WouldAControllerRecoveryHelp"));
+  EXPECT_TRUE(
+    BehaviorTreeEngine::isLibraryNamedAfter(
+      "nav2_path_expiring_timer_condition", "PathExpiringTimer"));
+  EXPECT_TRUE(BehaviorTreeEngine::isLibraryNamedAfter("nav2_wait_action_bt_node", "Wait"));
+  EXPECT_FALSE(BehaviorTreeEngine::isLibraryNamedAfter("nav2_await_action_bt_node", "Wait"));
+  EXPECT_FALSE(
+    BehaviorTreeEngine::isLibraryNamedAfter(
+      "nav2_clear_costmap_service_bt_node", "ClearEntireCostmap"));
+}
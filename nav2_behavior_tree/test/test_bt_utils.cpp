@@ -17,6 +17,8 @@
 #include <memory>
 #include <chrono>
 #include <set>
+#include <utility>
+#include <vector>
 
 #include "geometry_msgs/msg/point.hpp"
 #include "geometry_msgs/msg/quaternion.hpp"
@@ -277,3 +279,105 @@ TEST(deconflictPortAndParamFrameTest, test_correct_syntax)
 
   EXPECT_EQ(value, 1);
 }
+
+TEST(InPlacePortTest, test_read_and_move)
+{
+  std::string xml_txt =
+    R"(
+      <root BTCPP_format="4">
+        <BehaviorTree ID="MainTree">
+          <Sequence>
+            <InPlacePort test="{values}"/>
+            <InPlacePort test="1;2"/>
+          </Sequence>
+        </BehaviorTree>
+      </root>)";
+
+  BT::BehaviorTreeFactory factory;
+  factory.registerNodeType<TestNode<std::vector<int>>>("InPlacePort");
+  auto blackboard = BT::Blackboard::create();
+  auto tree = factory.createTreeFromText(xml_txt, blackboard);
+  std::vector<BT::TreeNode *> nodes;
+  tree.applyVisitor(
+    [&nodes](BT::TreeNode * node) {
+      if (node->registrationName() == "InPlacePort") {
+        nodes.push_back(node);
+      }
+    });
+  ASSERT_EQ(nodes.size(), 2u);
+
+  // Without a value on the blackboard, the reader is not called
+  bool read = false;
+  EXPECT_FALSE(
+    BT::readInputInPlace<std::vector<int>>(
+      *nodes[0], "test", [&read](const std::vector<int> &) {read = true;}));
+  EXPECT_FALSE(read);
+
+  // The first output is copied to the blackboard, the next ones moved into its entry
+  std::vector<int> values{1, 2, 3};
+  BT::moveOutput(*nodes[0], "test", std::move(values));
+  EXPECT_EQ(blackboard->get<std::vector<int>>("values"), std::vector<int>({1, 2, 3}));
+  values = {4, 5, 6, 7};
+  BT::moveOutput(*nodes[0], "test", std::move(values));
+  EXPECT_TRUE(values.empty());
+  EXPECT_EQ(blackboard->get<std::vector<int>>("values"), std::vector<int>({4, 5, 6, 7}));
+
+  // The value is read in place on the blackboard entry
+  const std::vector<int> * value_read = nullptr;
+  EXPECT_TRUE(
+    BT::readInputInPlace<std::vector<int>>(
+      *nodes[0], "test", [&value_read](const std::vector<int> & value) {value_read = &value;}));
+  EXPECT_EQ(value_read, blackboard->getAnyLocked("values")->castPtr<std::vector<int>>());
+
+  // Values set in the XML are converted as with getInput
+  std::vector<int> literal;
+  EXPECT_TRUE(
+    BT::readInputInPlace<std::vector<int>>(
+      *nodes[1], "test", [&literal](const std::vector<int> & value) {literal = value;}));
+  EXPECT_EQ(literal, std::vector<int>({1, 2}));
+}
+
+TEST(InPlacePortTest, test_sequence_id)
+{
+  std::string xml_txt =
+    R"(
+      <root BTCPP_format="4">
+        <BehaviorTree ID="MainTree">
+          <Sequence>
+            <InPlacePort test="{values}"/>
+            <InPlacePort test="1;2"/>
+          </Sequence>
+        </BehaviorTree>
+      </root>)";
+
+  BT::BehaviorTreeFactory factory;
+  factory.registerNodeType<TestNode<std::vector<int>>>("InPlacePort");
+  auto blackboard = BT::Blackboard::create();
+  auto tree = factory.createTreeFromText(xml_txt, blackboard);
+  std::vector<BT::TreeNode *> nodes;
+  tree.applyVisitor(
+    [&nodes](BT::TreeNode * node) {
+      if (node->registrationName() == "InPlacePort") {
+        nodes.push_back(node);
+      }
+    });
+  ASSERT_EQ(nodes.size(), 2u);
+
+  // Without an entry on the blackboard, the sequence id is 0
+  EXPECT_EQ(BT::getInputPortOrBlackboardSequenceId(*nodes[0], *blackboard, "test"), 0u);
+
+  // Each write of the entry increments it, whether set or moved into the entry
+  blackboard->set("values", std::vector<int>{1, 2, 3});
+  const uint64_t set_id = BT::getInputPortOrBlackboardSequenceId(*nodes[0], *blackboard, "test");
+  EXPECT_GT(set_id, 0u);
+  EXPECT_EQ(BT::getInputPortOrBlackboardSequenceId(*nodes[0], *blackboard, "test"), set_id);
+  BT::moveOutput(*nodes[0], "test", std::vector<int>{4, 5});
+  EXPECT_GT(BT::getInputPortOrBlackboardSequenceId(*nodes[0], *blackboard, "test"), set_id);
+
+  // Values set in the XML never change
+  EXPECT_EQ(BT::getInputPortOrBlackboardSequenceId(*nodes[1], *blackboard, "test"), 0u);
+
+  // Entries not remapped to a port are read from the blackboard
+  blackboard->set("other_values", std::vector<int>{1});
+  EXPECT_GT(BT::getInputPortOrBlackboardSequenceId(*nodes[0], *blackboard, "other_values"), 0u);
+}
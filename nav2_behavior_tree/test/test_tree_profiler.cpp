@@ -0,0 +1,99 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "behaviortree_cpp/bt_factory.h"
+#include "nav2_behavior_tree/tree_profiler.hpp"
+
+// Action running for two ticks, as waiting for the result of a goal
+class TwoTicksAction : public BT::StatefulActionNode
+{
+public:
+  TwoTicksAction(const std::string & name, const BT::NodeConfiguration & config)
+  : BT::StatefulActionNode(name, config)
+  {}
+
+  BT::NodeStatus onStart() override
+  {
+    return BT::NodeStatus::RUNNING;
+  }
+
+  BT::NodeStatus onRunning() override
+  {
+    return BT::NodeStatus::SUCCESS;
+  }
+
+  void onHalted() override {}
+
+  static BT::PortsList providedPorts()
+  {
+    return {};
+  }
+};
+
+TEST(TreeProfilerTest, test_statistics_and_trace)
+{
+  std::string xml_txt =
+    R"(
+      <root BTCPP_format="4">
+        <BehaviorTree ID="MainTree">
+          <Sequence name="root">
+            <AlwaysSuccess name="first"/>
+            <TwoTicksAction name="action"/>
+          </Sequence>
+        </BehaviorTree>
+      </root>)";
+
+  BT::BehaviorTreeFactory factory;
+  factory.registerNodeType<TwoTicksAction>("TwoTicksAction");
+  auto tree = factory.createTreeFromText(xml_txt);
+  nav2_behavior_tree::TreeProfiler profiler(tree, 2);
+
+  EXPECT_EQ(tree.tickExactlyOnce(), BT::NodeStatus::RUNNING);
+  EXPECT_EQ(tree.tickExactlyOnce(), BT::NodeStatus::SUCCESS);
+
+  auto statistics = profiler.getStatistics(rclcpp::Time(1, 0), "tree.xml");
+  EXPECT_EQ(statistics.bt_xml_filename, "tree.xml");
+  ASSERT_EQ(statistics.nodes.size(), 3u);
+  EXPECT_EQ(statistics.nodes[0].node_name, "root");
+  EXPECT_EQ(statistics.nodes[0].ticks, 2u);
+  EXPECT_EQ(statistics.nodes[0].runs, 1u);
+  EXPECT_EQ(statistics.nodes[1].node_name, "first");
+  EXPECT_EQ(statistics.nodes[1].registration_name, "AlwaysSuccess");
+  EXPECT_EQ(statistics.nodes[1].ticks, 1u);
+  EXPECT_EQ(statistics.nodes[1].runs, 0u);
+  EXPECT_EQ(statistics.nodes[2].node_name, "action");
+  EXPECT_EQ(statistics.nodes[2].ticks, 2u);
+  EXPECT_EQ(statistics.nodes[2].runs, 1u);
+
+  // Statistics are reset once taken
+  EXPECT_TRUE(profiler.getStatistics(rclcpp::Time(2, 0), "tree.xml").nodes.empty());
+
+  // Only the last ticks are kept in the trace, the root one ending last
+  const auto filename = (std::filesystem::temp_directory_path() / "test_bt_trace.json").string();
+  ASSERT_TRUE(profiler.dumpTrace(filename));
+  std::ifstream file(filename);
+  std::stringstream trace;
+  trace << file.rdbuf();
+  EXPECT_EQ(trace.str().rfind("{\"displayTimeUnit\"", 0), 0u);
+  EXPECT_EQ(trace.str().find("\"first\""), std::string::npos);
+  EXPECT_NE(trace.str().find("\"name\": \"action\""), std::string::npos);
+  EXPECT_NE(trace.str().find("\"name\": \"root\""), std::string::npos);
+  std::filesystem::remove(filename);
+}
@@ -19,6 +19,7 @@
 #include <chrono>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "nav2_behaviors/timed_behavior.hpp"
 #include "nav2_msgs/action/drive_on_heading.hpp"
@@ -174,7 +175,8 @@ protected:
     const double diff_dist = abs(command_x_) - distance;
     const int max_cycle_count = static_cast<int>(this->cycle_frequency_ * simulate_ahead_time_);
     geometry_msgs::msg::Pose2D init_pose = pose2d;
-    bool fetch_data = true;
+    std::vector<geometry_msgs::msg::Pose2D> poses;
+    poses.reserve(max_cycle_count);
 
     while (cycle_count < max_cycle_count) {
       sim_position_change = cmd_vel.linear.x * (cycle_count / this->cycle_frequency_);
@@ -186,12 +188,11 @@ protected:
         break;
       }
 
-      if (!this->local_collision_checker_->isCollisionFree(pose2d, fetch_data)) {
-        return false;
-      }
-      fetch_data = false;
+      poses.push_back(pose2d);
     }
-    return true;
+
+    // Check the footprint swept along the simulated segment at once
+    return this->local_collision_checker_->isPathCollisionFree(poses);
   }
 
   /**
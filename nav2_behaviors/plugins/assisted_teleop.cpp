@@ -124,7 +124,10 @@ ResultStatus AssistedTeleop::onCycleUpdate()
   {
     projected_pose = projectPose(projected_pose, teleop_twist_.twist, simulation_time_step_);
 
-    if (!local_collision_checker_->isCollisionFree(projected_pose)) {
+    // The costmap and footprint are fetched on the first step only
+    if (!local_collision_checker_->isCollisionFree(
+        projected_pose, time == simulation_time_step_))
+    {
       if (time == simulation_time_step_) {
         RCLCPP_DEBUG_STREAM_THROTTLE(
           logger_,
@@ -17,6 +17,7 @@
 #include <algorithm>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "nav2_behaviors/plugins/spin.hpp"
 #include "tf2/utils.h"
@@ -169,7 +170,8 @@ bool Spin::isCollisionFree(
   double sim_position_change;
   const int max_cycle_count = static_cast<int>(cycle_frequency_ * simulate_ahead_time_);
   geometry_msgs::msg::Pose2D init_pose = pose2d;
-  bool fetch_data = true;
+  std::vector<geometry_msgs::msg::Pose2D> poses;
+  poses.reserve(max_cycle_count);
 
   while (cycle_count < max_cycle_count) {
     sim_position_change = cmd_vel.angular.z * (cycle_count / cycle_frequency_);
@@ -180,12 +182,11 @@ bool Spin::isCollisionFree(
       break;
     }
 
-    if (!local_collision_checker_->isCollisionFree(pose2d, fetch_data)) {
-      return false;
-    }
-    fetch_data = false;
+    poses.push_back(pose2d);
   }
-  return true;
+
+  // Check the footprint swept along the simulated arc at once
+  return local_collision_checker_->isPathCollisionFree(poses);
 }
 
 }  // namespace nav2_behaviors
@@ -0,0 +1,108 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_BT_NAVIGATOR__NAVIGATORS__PATH_PROGRESS_HPP_
+#define NAV2_BT_NAVIGATOR__NAVIGATORS__PATH_PROGRESS_HPP_
+
+#include <string>
+
+#include "behaviortree_cpp/blackboard.h"
+#include "geometry_msgs/msg/pose_stamped.hpp"
+#include "nav_msgs/msg/path.hpp"
+#include "nav2_util/geometry_utils.hpp"
+#include "nav2_util/path_tracker.hpp"
+
+namespace nav2_bt_navigator
+{
+
+/**
+ * @class nav2_bt_navigator::PathProgress
+ * @brief Tracks the progress of the robot along the path on the blackboard for the navigators'
+ * feedback. The path is only copied when replanned, with its cumulative arc length, so that
+ * the distance remaining is looked up rather than integrated over the path at each feedback.
+ */
+class PathProgress
+{
+public:
+  /**
+   * @brief Updates the progress along the path on the blackboard
+   * @param blackboard Blackboard of the navigator's BT
+   * @param path_blackboard_id Blackboard entry of the path
+   * @param pose Current pose of the robot, in the frame of the path
+   * @param distance_remaining Output distance along the path from the robot to its end
+   * @return bool false if there is no path on the blackboard
+   */
+  bool update(
+    const BT::Blackboard::Ptr & blackboard, const std::string & path_blackboard_id,
+    const geometry_msgs::msg::PoseStamped & pose, double & distance_remaining)
+  {
+    {
+      // The path is compared in place, not to copy it out of the blackboard
+      auto entry = blackboard->getAnyLocked(path_blackboard_id);
+      const nav_msgs::msg::Path * path = entry ? entry->castPtr<nav_msgs::msg::Path>() : nullptr;
+      if (!path || path->poses.empty()) {
+        return false;
+      }
+      if (isNewPath(*path)) {
+        tracker_.setPath(*path);
+      }
+    }
+
+    // A pose closer to the robot than the pose reached so far is at most twice as far from that
+    // pose as the robot is, which bounds the search along paths not looping back in between
+    const size_t progress = tracker_.getProgress();
+    const auto & poses = tracker_.getPath().poses;
+    const double search_dist = 2.0 * nav2_util::geometry_utils::euclidean_distance(
+      pose.pose, poses[progress].pose) + kMinSearchDist;
+    const size_t closest = tracker_.findClosestPose(
+      pose.pose, progress, tracker_.getIndexAfterDistance(progress, search_dist));
+    tracker_.setProgress(closest);
+
+    distance_remaining = tracker_.getDistance(closest, poses.size() - 1);
+    return true;
+  }
+
+  /**
+   * @brief Forgets the path tracked, for a new goal
+   */
+  void reset()
+  {
+    tracker_.setPath(nav_msgs::msg::Path());
+  }
+
+protected:
+  /**
+   * @brief Whether a path is another one than the one tracked, which replanning changes the
+   * stamp or the ends of
+   * @param path Path on the blackboard
+   * @return bool true if it is a new path
+   */
+  bool isNewPath(const nav_msgs::msg::Path & path) const
+  {
+    const auto & tracked = tracker_.getPath();
+    return tracked.poses.size() != path.poses.size() ||
+           tracked.header != path.header ||
+           tracked.poses.front() != path.poses.front() ||
+           tracked.poses.back() != path.poses.back();
+  }
+
+  // Minimum distance along the path searched for the closest pose to the robot
+  static constexpr double kMinSearchDist = 1.0;
+
+  nav2_util::PathTracker tracker_;
+};
+
+}  // namespace nav2_bt_navigator
+
+#endif  // NAV2_BT_NAVIGATOR__NAVIGATORS__PATH_PROGRESS_HPP_
@@ -43,6 +43,8 @@ BtNavigator::BtNavigator(rclcpp::NodeOptions options)
     this, "plugin_lib_names", rclcpp::ParameterValue(std::vector<std::string>{}));
   declare_parameter_if_not_declared(
     this, "transform_tolerance", rclcpp::ParameterValue(0.1));
+  declare_parameter_if_not_declared(
+    this, "feedback_rate", rclcpp::ParameterValue(0.0));
   declare_parameter_if_not_declared(
     this, "global_frame", rclcpp::ParameterValue(std::string("map")));
   declare_parameter_if_not_declared(
@@ -87,6 +89,7 @@ BtNavigator::on_configure(const rclcpp_lifecycle::State & /*state*/)
   feedback_utils.global_frame = global_frame_;
   feedback_utils.robot_frame = robot_frame_;
   feedback_utils.transform_tolerance = transform_tolerance_;
+  feedback_utils.feedback_rate = get_parameter("feedback_rate").as_double();
 
   // Odometry smoother object for getting current speed
   auto node = shared_from_this();
@@ -96,16 +96,25 @@ NavigateThroughPosesNavigator::onLoop()
 {
   using namespace nav2_util::geometry_utils;  // NOLINT
 
+  if (!isFeedbackDue()) {
+    return;
+  }
+
   // action server feedback (pose, duration of task,
   // number of recoveries, and distance remaining to goal, etc)
   auto feedback_msg = std::make_shared<ActionT::Feedback>();
 
   auto blackboard = bt_action_server_->getBlackboard();
 
-  Goals goal_poses;
-  [[maybe_unused]] auto res = blackboard->get(goals_blackboard_id_, goal_poses);
+  // Only the number of goals is needed, not to copy them out of the blackboard
+  size_t number_of_goals = 0;
+  if (auto entry = blackboard->getAnyLocked(goals_blackboard_id_)) {
+    if (const Goals * goal_poses = entry->castPtr<Goals>()) {
+      number_of_goals = goal_poses->size();
+    }
+  }
 
-  if (goal_poses.size() == 0) {
+  if (number_of_goals == 0) {
     bt_action_server_->publishFeedback(feedback_msg);
     return;
   }
@@ -121,33 +130,13 @@ NavigateThroughPosesNavigator::onLoop()
   }
 
   try {
-    // Get current path points
-    nav_msgs::msg::Path current_path;
-    if (!blackboard->get(path_blackboard_id_, current_path) || current_path.poses.size() == 0u) {
+    // Get the distance remaining along the current path
+    double distance_remaining = 0.0;
+    if (!path_progress_.update(blackboard, path_blackboard_id_, current_pose, distance_remaining)) {
       // If no path set yet or not meaningful, can't compute ETA or dist remaining yet.
       throw std::exception();
     }
 
-    // Find the closest pose to current pose on global path
-    auto find_closest_pose_idx =
-      [&current_pose, &current_path]() {
-        size_t closest_pose_idx = 0;
-        double curr_min_dist = std::numeric_limits<double>::max();
-        for (size_t curr_idx = 0; curr_idx < current_path.poses.size(); ++curr_idx) {
-          double curr_dist = nav2_util::geometry_utils::euclidean_distance(
-            current_pose, current_path.poses[curr_idx]);
-          if (curr_dist < curr_min_dist) {
-            curr_min_dist = curr_dist;
-            closest_pose_idx = curr_idx;
-          }
-        }
-        return closest_pose_idx;
-      };
-
-    // Calculate distance on the path
-    double distance_remaining =
-      nav2_util::geometry_utils::calculate_path_length(current_path, find_closest_pose_idx());
-
     // Default value for time remaining
     rclcpp::Duration estimated_time_remaining = rclcpp::Duration::from_seconds(0.0);
 
@@ -169,11 +158,11 @@ NavigateThroughPosesNavigator::onLoop()
   }
 
   int recovery_count = 0;
-  res = blackboard->get("number_recoveries", recovery_count);
+  [[maybe_unused]] auto res = blackboard->get("number_recoveries", recovery_count);
   feedback_msg->number_of_recoveries = recovery_count;
   feedback_msg->current_pose = current_pose;
   feedback_msg->navigation_time = clock_->now() - start_time_;
-  feedback_msg->number_of_poses_remaining = goal_poses.size();
+  feedback_msg->number_of_poses_remaining = number_of_goals;
 
   bt_action_server_->publishFeedback(feedback_msg);
 }
@@ -236,6 +225,7 @@ NavigateThroughPosesNavigator::initializeGoalPoses(ActionT::Goal::ConstSharedPtr
   start_time_ = clock_->now();
   auto blackboard = bt_action_server_->getBlackboard();
   blackboard->set("number_recoveries", 0);  // NOLINT
+  path_progress_.reset();
 
   // Update the goal pose on the blackboard
   blackboard->set<Goals>(goals_blackboard_id_, std::move(goal_poses));
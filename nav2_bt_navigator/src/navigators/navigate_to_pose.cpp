@@ -107,6 +107,10 @@ NavigateToPoseNavigator::goalCompleted(
 void
 NavigateToPoseNavigator::onLoop()
 {
+  if (!isFeedbackDue()) {
+    return;
+  }
+
   // action server feedback (pose, duration of task,
   // number of recoveries, and distance remaining to goal)
   auto feedback_msg = std::make_shared<ActionT::Feedback>();
@@ -124,33 +128,13 @@ NavigateToPoseNavigator::onLoop()
   auto blackboard = bt_action_server_->getBlackboard();
 
   try {
-    // Get current path points
-    nav_msgs::msg::Path current_path;
-    if (!blackboard->get(path_blackboard_id_, current_path) || current_path.poses.size() == 0u) {
+    // Get the distance remaining along the current path
+    double distance_remaining = 0.0;
+    if (!path_progress_.update(blackboard, path_blackboard_id_, current_pose, distance_remaining)) {
       // If no path set yet or not meaningful, can't compute ETA or dist remaining yet.
       throw std::exception();
     }
 
-    // Find the closest pose to current pose on global path
-    auto find_closest_pose_idx =
-      [&current_pose, &current_path]() {
-        size_t closest_pose_idx = 0;
-        double curr_min_dist = std::numeric_limits<double>::max();
-        for (size_t curr_idx = 0; curr_idx < current_path.poses.size(); ++curr_idx) {
-          double curr_dist = nav2_util::geometry_utils::euclidean_distance(
-            current_pose, current_path.poses[curr_idx]);
-          if (curr_dist < curr_min_dist) {
-            curr_min_dist = curr_dist;
-            closest_pose_idx = curr_idx;
-          }
-        }
-        return closest_pose_idx;
-      };
-
-    // Calculate distance on the path
-    double distance_remaining =
-      nav2_util::geometry_utils::calculate_path_length(current_path, find_closest_pose_idx());
-
     // Default value for time remaining
     rclcpp::Duration estimated_time_remaining = rclcpp::Duration::from_seconds(0.0);
 
@@ -245,6 +229,7 @@ NavigateToPoseNavigator::initializeGoalPose(ActionT::Goal::ConstSharedPtr goal)
   start_time_ = clock_->now();
   auto blackboard = bt_action_server_->getBlackboard();
   blackboard->set("number_recoveries", 0);  // NOLINT
+  path_progress_.reset();
 
   // Update the goal pose on the blackboard
   blackboard->set(goal_blackboard_id_, goal_pose);
@@ -0,0 +1,324 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "sensor_msgs/msg/point_cloud2.hpp"
+#include "sensor_msgs/point_cloud2_iterator.hpp"
+#include "nav2_collision_monitor/collision_monitor_node.hpp"
+
+// Frame of the robot, in which the clouds are given
+const char g_base_frame[]{"base_link"};
+
+std::vector<sensor_msgs::msg::PointCloud2::SharedPtr> g_clouds;
+
+// Point cloud source fed with the clouds directly instead of through its subscription
+class ReplayPointCloud : public nav2_collision_monitor::PointCloud
+{
+public:
+  using nav2_collision_monitor::PointCloud::PointCloud;
+
+  void setCloud(sensor_msgs::msg::PointCloud2::ConstSharedPtr msg)
+  {
+    dataCallback(msg);
+  }
+};
+
+// Collision monitor running its processing on the replayed clouds on demand
+class BenchmarkMonitor : public nav2_collision_monitor::CollisionMonitor
+{
+public:
+  explicit BenchmarkMonitor(const rclcpp::NodeOptions & options)
+  : nav2_collision_monitor::CollisionMonitor(options)
+  {}
+
+  bool start()
+  {
+    if (on_configure(get_current_state()) != nav2_util::CallbackReturn::SUCCESS ||
+      on_activate(get_current_state()) != nav2_util::CallbackReturn::SUCCESS)
+    {
+      return false;
+    }
+    // Replace the configured source, with the same parameters
+    cloud_ = std::make_shared<ReplayPointCloud>(
+      shared_from_this(), "cloud", tf_buffer_, g_base_frame, "odom",
+      tf2::durationFromSec(0.1), rclcpp::Duration::from_seconds(0.0), false);
+    cloud_->configure();
+    sources_ = {cloud_};
+    return true;
+  }
+
+  void stop()
+  {
+    on_deactivate(get_current_state());
+    on_cleanup(get_current_state());
+    cloud_.reset();
+  }
+
+  void cycle(
+    sensor_msgs::msg::PointCloud2::SharedPtr cloud,
+    const nav2_collision_monitor::Velocity & velocity)
+  {
+    std_msgs::msg::Header header;
+    header.stamp = now();
+    cloud->header.stamp = header.stamp;
+    cloud_->setCloud(cloud);
+    process(velocity, header);
+  }
+
+  const nav2_msgs::msg::CollisionMonitorStatistics & getStatistics()
+  {
+    return statistics_.getMessage();
+  }
+
+protected:
+  std::shared_ptr<ReplayPointCloud> cloud_;
+};
+
+sensor_msgs::msg::PointCloud2::SharedPtr makeCloud(const std::vector<float> & xyz)
+{
+  auto cloud = std::make_shared<sensor_msgs::msg::PointCloud2>();
+  cloud->header.frame_id = g_base_frame;
+  cloud->height = 1;
+  sensor_msgs::PointCloud2Modifier modifier(*cloud);
+  modifier.setPointCloud2FieldsByString(1, "xyz");
+  modifier.resize(xyz.size() / 3);
+  sensor_msgs::PointCloud2Iterator<float> iter_x(*cloud, "x");
+  sensor_msgs::PointCloud2Iterator<float> iter_y(*cloud, "y");
+  sensor_msgs::PointCloud2Iterator<float> iter_z(*cloud, "z");
+  for (size_t i = 0; i < xyz.size(); i += 3, ++iter_x, ++iter_y, ++iter_z) {
+    *iter_x = xyz[i];
+    *iter_y = xyz[i + 1];
+    *iter_z = xyz[i + 2];
+  }
+  return cloud;
+}
+
+// Read clouds recorded in the robot frame one per line as the count of points followed
+// by the x y z of each point, with lines starting with # ignored
+bool readClouds(
+  const std::string & path, std::vector<sensor_msgs::msg::PointCloud2::SharedPtr> & clouds)
+{
+  std::ifstream file(path);
+  if (!file) {
+    return false;
+  }
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream values(line);
+    unsigned int count;
+    values >> count;
+    std::vector<float> xyz(3 * count);
+    for (auto & value : xyz) {
+      values >> value;
+    }
+    if (!values) {
+      std::cerr << "Malformed cloud: " << line.substr(0, 80) << std::endl;
+      return false;
+    }
+    clouds.push_back(makeCloud(xyz));
+  }
+  return !clouds.empty();
+}
+
+// Simulate clouds from a fixed seed, of a robot driving along a 2m wide corridor with
+// obstacles ahead getting closer, the floor and the ceiling returning most of the points
+std::vector<sensor_msgs::msg::PointCloud2::SharedPtr> simulateClouds(
+  unsigned int count, unsigned int points, unsigned int seed)
+{
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<float> uniform(0.0, 1.0);
+  std::normal_distribution<float> noise(0.0, 0.01);
+
+  std::vector<sensor_msgs::msg::PointCloud2::SharedPtr> clouds;
+  for (unsigned int k = 0; k < count; k++) {
+    const float obstacle_x = 4.0f - 3.5f * k / count;
+    std::vector<float> xyz;
+    xyz.reserve(3 * points);
+    for (unsigned int i = 0; i < points; i++) {
+      const float x = 0.2f + 5.0f * uniform(generator);
+      const float surface = uniform(generator);
+      if (surface < 0.4f) {
+        // Floor
+        xyz.insert(xyz.end(), {x, 2.0f * uniform(generator) - 1.0f, noise(generator)});
+      } else if (surface < 0.6f) {
+        // Ceiling
+        xyz.insert(xyz.end(), {x, 2.0f * uniform(generator) - 1.0f, 2.5f + noise(generator)});
+      } else if (surface < 0.9f) {
+        // Walls
+        xyz.insert(
+          xyz.end(),
+          {x, (uniform(generator) < 0.5f ? -1.0f : 1.0f) + noise(generator),
+            2.5f * uniform(generator)});
+      } else {
+        // Obstacle ahead
+        xyz.insert(
+          xyz.end(),
+          {obstacle_x + noise(generator), 0.6f * uniform(generator) - 0.3f,
+            0.5f * uniform(generator)});
+      }
+    }
+    clouds.push_back(makeCloud(xyz));
+  }
+  return clouds;
+}
+
+std::string square(double size)
+{
+  std::ostringstream points;
+  points << "[[" << size << ", " << size << "], [" << size << ", " << -size << "], [" <<
+    -size << ", " << -size << "], [" << -size << ", " << size << "]]";
+  return points.str();
+}
+
+// A polygon of each action type checking the points of a single cloud source
+std::vector<rclcpp::Parameter> getParameters(int polygon_threads, double downsampling_resolution)
+{
+  std::vector<rclcpp::Parameter> parameters{
+    {"base_frame_id", g_base_frame},
+    {"source_timeout", 0.0},
+    {"base_shift_correction", false},
+    {"polygon_threads", polygon_threads},
+    {"polygons", std::vector<std::string>{"Stop", "Slowdown", "Limit", "Approach"}},
+    {"observation_sources", std::vector<std::string>{"cloud"}},
+    {"cloud.type", "pointcloud"},
+    {"cloud.downsampling_resolution", downsampling_resolution},
+    {"Stop.type", "polygon"},
+    {"Stop.action_type", "stop"},
+    {"Stop.points", square(0.4)},
+    {"Slowdown.type", "polygon"},
+    {"Slowdown.action_type", "slowdown"},
+    {"Slowdown.points", square(0.6)},
+    {"Limit.type", "circle"},
+    {"Limit.action_type", "limit"},
+    {"Limit.radius", 1.0},
+    {"Approach.type", "polygon"},
+    {"Approach.action_type", "approach"},
+    {"Approach.points", square(0.3)},
+    {"Approach.time_before_collision", 2.0},
+  };
+  return parameters;
+}
+
+// Feed the clouds through the processing of the collision monitor, as on each cmd_vel_in
+void replay(benchmark::State & state)
+{
+  const int polygon_threads = state.range(0);
+  const double downsampling_resolution = state.range(1) / 100.0;
+  auto monitor = std::make_shared<BenchmarkMonitor>(
+    rclcpp::NodeOptions().parameter_overrides(
+      getParameters(polygon_threads, downsampling_resolution)));
+  if (!monitor->start()) {
+    state.SkipWithError("Failed to start the collision monitor");
+    return;
+  }
+
+  const nav2_collision_monitor::Velocity velocity{0.5, 0.0, 0.0};
+  double cycles = 0.0, points = 0.0, source_time = 0.0, polygons_time = 0.0, total_time = 0.0;
+  for (auto _ : state) {
+    for (const auto & cloud : g_clouds) {
+      monitor->cycle(cloud, velocity);
+
+      const auto & statistics = monitor->getStatistics();
+      points += statistics.source_points[0];
+      source_time += rclcpp::Duration(statistics.source_durations[0]).seconds();
+      polygons_time += rclcpp::Duration(statistics.polygons_duration).seconds();
+      total_time += rclcpp::Duration(statistics.total).seconds();
+      cycles += 1.0;
+    }
+  }
+  monitor->stop();
+
+  state.counters["cycle_hz"] = benchmark::Counter(cycles, benchmark::Counter::kIsRate);
+  state.counters["points"] = points / cycles;
+  state.counters["get_data_ms"] = source_time * 1e3 / cycles;
+  state.counters["polygons_ms"] = polygons_time * 1e3 / cycles;
+  state.counters["cycle_ms"] = total_time * 1e3 / cycles;
+}
+
+// Flags of the benchmark, after those of google-benchmark
+struct Options
+{
+  std::string clouds;
+  unsigned int count = 100;
+  unsigned int points = 30000;
+  unsigned int seed = 0;
+};
+
+bool parseOptions(int argc, char ** argv, Options & options)
+{
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    const auto value = arg.substr(arg.find('=') + 1);
+    if (arg.rfind("--clouds=", 0) == 0) {
+      options.clouds = value;
+    } else if (arg.rfind("--count=", 0) == 0) {
+      options.count = std::stoul(value);
+    } else if (arg.rfind("--points=", 0) == 0) {
+      options.points = std::stoul(value);
+    } else if (arg.rfind("--seed=", 0) == 0) {
+      options.seed = std::stoul(value);
+    } else {
+      std::cerr << "Unknown argument: " << arg << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+int main(int argc, char ** argv)
+{
+  benchmark::Initialize(&argc, argv);
+  Options options;
+  if (!parseOptions(argc, argv, options)) {
+    std::cerr << "Usage: " << argv[0] << " [--clouds=<recorded clouds>]"
+      " [--count=100] [--points=30000] [--seed=0] [google-benchmark flags]" << std::endl;
+    return 1;
+  }
+
+  if (!options.clouds.empty()) {
+    if (!readClouds(options.clouds, g_clouds)) {
+      std::cerr << "Failed to read clouds " << options.clouds << std::endl;
+      return 1;
+    }
+  } else {
+    g_clouds = simulateClouds(options.count, options.points, options.seed);
+  }
+
+  rclcpp::init(0, nullptr);
+
+  benchmark::RegisterBenchmark("collision_monitor", replay)
+  ->ArgNames({"polygon_threads", "downsampling_cm"})
+  ->ArgsProduct({{0, 2, 4}, {0, 5}})
+  ->Unit(benchmark::kMillisecond);
+
+  benchmark::RunSpecifiedBenchmarks();
+
+  g_clouds.clear();
+  rclcpp::shutdown();
+  return 0;
+}
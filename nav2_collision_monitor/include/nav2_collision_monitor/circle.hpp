@@ -68,6 +68,16 @@ public:
    */
   int getPointsInside(const std::vector<Point> & points) const override;
 
+  /**
+   * @brief Gets number of points of the grid inside circle, centered at given pose
+   * @param points Grid of points to be checked
+   * @param pose Pose of the circle in the frame of the points
+   * @param max_points Number of points at which to stop counting
+   * @return Number of points inside circle, at most max_points
+   */
+  int getPointsInside(
+    const PointGrid & points, const Pose & pose, int max_points) const override;
+
   /**
    * @brief Returns true if circle radius is set.
    * Otherwise, prints a warning and returns false.
@@ -75,6 +85,25 @@ public:
   bool isShapeSet() override;
 
 protected:
+  /**
+   * @brief Checks if point is inside circle
+   * @param point Given point to check
+   * @return True if given point is inside circle, otherwise false
+   */
+  bool isPointInside(const Point & point) const override;
+
+  /**
+   * @brief Gets the times at which a point crosses the circle in the robot frame,
+   * while the robot moves at a constant velocity
+   * @param point Point in the robot frame at the current time
+   * @param velocity Robot velocity
+   * @param max_time Time after which crossings are ignored
+   * @param times Output crossing times, in no particular order
+   */
+  void getCrossingTimes(
+    const Point & point, const Velocity & velocity, double max_time,
+    std::vector<double> & times) const override;
+
   /**
    * @brief Supporting routine obtaining polygon-specific ROS-parameters
    * @param polygon_sub_topic Input name of polygon subscription topic
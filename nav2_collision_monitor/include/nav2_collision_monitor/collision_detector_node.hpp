@@ -22,15 +22,19 @@
 
 #include "rclcpp/rclcpp.hpp"
 
+#include "diagnostic_updater/diagnostic_updater.hpp"
 #include "tf2/time.h"
 #include "tf2_ros/buffer.h"
 #include "tf2_ros/transform_listener.h"
 
 #include "nav2_util/lifecycle_node.hpp"
 #include "nav2_msgs/msg/collision_detector_state.hpp"
+#include "nav2_msgs/msg/collision_monitor_statistics.hpp"
 #include "visualization_msgs/msg/marker_array.hpp"
 
 #include "nav2_collision_monitor/types.hpp"
+#include "nav2_collision_monitor/cycle_statistics.hpp"
+#include "nav2_collision_monitor/point_grid.hpp"
 #include "nav2_collision_monitor/polygon.hpp"
 #include "nav2_collision_monitor/circle.hpp"
 #include "nav2_collision_monitor/velocity_polygon.hpp"
@@ -39,6 +43,7 @@
 #include "nav2_collision_monitor/pointcloud.hpp"
 #include "nav2_collision_monitor/range.hpp"
 #include "nav2_collision_monitor/polygon_source.hpp"
+#include "nav2_collision_monitor/costmap_source.hpp"
 
 namespace nav2_collision_monitor
 {
@@ -146,6 +151,10 @@ protected:
   std::vector<std::shared_ptr<Polygon>> polygons_;
   /// @brief Data sources array
   std::vector<std::shared_ptr<Source>> sources_;
+  /// @brief Points of the data sources, kept to reuse the storage
+  std::vector<Point> collision_points_;
+  /// @brief Points of the data sources bucketed for the polygons, kept to reuse the storage
+  PointGrid collision_points_grid_;
 
   /// @brief collision monitor state publisher
   rclcpp_lifecycle::LifecyclePublisher<nav2_msgs::msg::CollisionDetectorState>::SharedPtr
@@ -153,6 +162,13 @@ protected:
   /// @brief Collision points marker publisher
   rclcpp_lifecycle::LifecyclePublisher<visualization_msgs::msg::MarkerArray>::SharedPtr
     collision_points_marker_pub_;
+  /// @brief Load and latency of the cycles
+  CycleStatistics statistics_;
+  /// @brief Publisher of the statistics of each cycle
+  rclcpp_lifecycle::LifecyclePublisher<nav2_msgs::msg::CollisionMonitorStatistics>::SharedPtr
+    statistics_pub_;
+  /// @brief Reporter of the histograms of the cycles in diagnostics
+  diagnostic_updater::Updater diagnostics_updater_;
   /// @brief timer that runs actions
   rclcpp::TimerBase::SharedPtr timer_;
 
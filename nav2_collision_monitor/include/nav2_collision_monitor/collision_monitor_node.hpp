@@ -15,25 +15,34 @@
 #ifndef NAV2_COLLISION_MONITOR__COLLISION_MONITOR_NODE_HPP_
 #define NAV2_COLLISION_MONITOR__COLLISION_MONITOR_NODE_HPP_
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <memory>
+#include <mutex>
 
 #include "rclcpp/rclcpp.hpp"
 #include "geometry_msgs/msg/twist.hpp"
 #include "visualization_msgs/msg/marker_array.hpp"
 #include "geometry_msgs/msg/twist_stamped.hpp"
+#include "std_msgs/msg/float32.hpp"
 
+#include "diagnostic_updater/diagnostic_updater.hpp"
 #include "tf2/time.h"
 #include "tf2_ros/buffer.h"
 #include "tf2_ros/transform_listener.h"
 
 #include "nav2_util/lifecycle_node.hpp"
 #include "nav2_util/twist_publisher.hpp"
+#include "nav2_util/twist_registry.hpp"
 #include "nav2_util/twist_subscriber.hpp"
+#include "nav2_util/thread_pool.hpp"
 #include "nav2_msgs/msg/collision_monitor_state.hpp"
+#include "nav2_msgs/msg/collision_monitor_statistics.hpp"
 
 #include "nav2_collision_monitor/types.hpp"
+#include "nav2_collision_monitor/cycle_statistics.hpp"
+#include "nav2_collision_monitor/point_grid.hpp"
 #include "nav2_collision_monitor/polygon.hpp"
 #include "nav2_collision_monitor/circle.hpp"
 #include "nav2_collision_monitor/velocity_polygon.hpp"
@@ -42,6 +51,7 @@
 #include "nav2_collision_monitor/pointcloud.hpp"
 #include "nav2_collision_monitor/range.hpp"
 #include "nav2_collision_monitor/polygon_source.hpp"
+#include "nav2_collision_monitor/costmap_source.hpp"
 
 namespace nav2_collision_monitor
 {
@@ -102,6 +112,12 @@ protected:
    */
   void cmdVelInCallbackStamped(geometry_msgs::msg::TwistStamped::SharedPtr msg);
   void cmdVelInCallbackUnstamped(geometry_msgs::msg::Twist::SharedPtr msg);
+  /**
+   * @brief Callback for new data of the sources, reevaluating the latest input cmd_vel
+   * when process_on_source_data_ is set
+   * @param stamp Timestamp of the new data
+   */
+  void sourceDataCallback(const rclcpp::Time & stamp);
   /**
    * @brief Publishes output cmd_vel. If robot was stopped more than stop_pub_timeout_ seconds,
    * quit to publish 0-velocity.
@@ -153,34 +169,37 @@ protected:
    * @brief Main processing routine
    * @param cmd_vel_in Input desired robot velocity
    * @param header Twist header
+   * @param stop_only Whether to publish the resulting action only if it newly stops the robot
    */
-  void process(const Velocity & cmd_vel_in, const std_msgs::msg::Header & header);
+  void process(
+    const Velocity & cmd_vel_in, const std_msgs::msg::Header & header,
+    const bool stop_only = false);
 
   /**
    * @brief Processes the polygon of STOP, SLOWDOWN and LIMIT action type
    * @param polygon Polygon to process
-   * @param collision_points Array of 2D obstacle points
+   * @param collision_points Grid of 2D obstacle points
    * @param velocity Desired robot velocity
    * @param robot_action Output processed robot action
    * @return True if returned action is caused by current polygon, otherwise false
    */
   bool processStopSlowdownLimit(
     const std::shared_ptr<Polygon> polygon,
-    const std::vector<Point> & collision_points,
+    const PointGrid & collision_points,
     const Velocity & velocity,
     Action & robot_action) const;
 
   /**
    * @brief Processes APPROACH action type
    * @param polygon Polygon to process
-   * @param collision_points Array of 2D obstacle points
+   * @param collision_points Grid of 2D obstacle points
    * @param velocity Desired robot velocity
    * @param robot_action Output processed robot action
    * @return True if returned action is caused by current polygon, otherwise false
    */
   bool processApproach(
     const std::shared_ptr<Polygon> polygon,
-    const std::vector<Point> & collision_points,
+    const PointGrid & collision_points,
     const Velocity & velocity,
     Action & robot_action) const;
 
@@ -197,6 +216,12 @@ protected:
    */
   void publishPolygons() const;
 
+  /**
+   * @brief Finishes the statistics of the cycle and publishes them
+   * @param curr_time Time at which the cycle started
+   */
+  void publishStatistics(const rclcpp::Time & curr_time);
+
   // ----- Variables -----
 
   /// @brief TF buffer
@@ -206,15 +231,30 @@ protected:
 
   /// @brief Polygons array
   std::vector<std::shared_ptr<Polygon>> polygons_;
+  /// @brief Threads evaluating the polygons
+  std::unique_ptr<nav2_util::ThreadPool> polygons_pool_;
+  /// @brief Action required by each polygon on its own, kept to reuse the storage
+  std::vector<Action> polygon_actions_;
+  /// @brief Whether each polygon requires its action
+  std::vector<uint8_t> polygon_triggered_;
 
   /// @brief Data sources array
   std::vector<std::shared_ptr<Source>> sources_;
+  /// @brief Points of the data sources, kept to reuse the storage
+  std::vector<Point> collision_points_;
+  /// @brief Points of the data sources bucketed for the polygons, kept to reuse the storage
+  PointGrid collision_points_grid_;
 
   // Input/output speed controls
   /// @brief Input cmd_vel subscriber
   std::unique_ptr<nav2_util::TwistSubscriber> cmd_vel_in_sub_;
   /// @brief Output cmd_vel publisher
   std::unique_ptr<nav2_util::TwistPublisher> cmd_vel_out_pub_;
+  /// @brief Input topic registered to take cmd_vel directly from publishers in this process
+  std::string direct_cmd_vel_in_topic_;
+  /// @brief Serializes the processing of cmd_vel_in, which may be handed in directly
+  /// from another thread, with the processing of new source data
+  std::mutex process_mutex_;
 
   /// @brief CollisionMonitor state publisher
   rclcpp_lifecycle::LifecyclePublisher<nav2_msgs::msg::CollisionMonitorState>::SharedPtr
@@ -224,8 +264,29 @@ protected:
   rclcpp_lifecycle::LifecyclePublisher<visualization_msgs::msg::MarkerArray>::SharedPtr
     collision_points_marker_pub_;
 
+  /// @brief Publisher of the time from the source data stamp to the end of its processing
+  rclcpp_lifecycle::LifecyclePublisher<std_msgs::msg::Float32>::SharedPtr
+    decision_latency_pub_;
+
+  /// @brief Load and latency of the cycles
+  CycleStatistics statistics_;
+  /// @brief Publisher of the statistics of each cycle
+  rclcpp_lifecycle::LifecyclePublisher<nav2_msgs::msg::CollisionMonitorStatistics>::SharedPtr
+    statistics_pub_;
+  /// @brief Reporter of the histograms of the cycles in diagnostics
+  diagnostic_updater::Updater diagnostics_updater_;
+
   /// @brief Whether main routine is active
   bool process_active_;
+  /// @brief Whether to also process the latest cmd_vel_in on new data from the sources
+  bool process_on_source_data_;
+
+  /// @brief Whether a cmd_vel_in was received since activation
+  bool cmd_vel_in_received_;
+  /// @brief Latest input cmd_vel
+  Velocity cmd_vel_in_;
+  /// @brief Header of the latest input cmd_vel
+  std_msgs::msg::Header cmd_vel_in_header_;
 
   /// @brief Previous robot action
   Action robot_action_prev_;
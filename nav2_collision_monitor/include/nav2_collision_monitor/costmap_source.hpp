@@ -0,0 +1,147 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_COLLISION_MONITOR__COSTMAP_SOURCE_HPP_
+#define NAV2_COLLISION_MONITOR__COSTMAP_SOURCE_HPP_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "nav2_msgs/msg/costmap.hpp"
+#include "nav2_msgs/msg/costmap_update.hpp"
+#include "tf2/LinearMath/Transform.h"
+
+#include "nav2_collision_monitor/source.hpp"
+
+namespace nav2_collision_monitor
+{
+
+/**
+ * @brief Implementation for costmap source, providing the centers of the occupied cells
+ * of a costmap published by a Costmap2DROS. The occupied cells are tracked incrementally
+ * from the costmap updates, rather than extracted from the whole grid each time.
+ */
+class CostmapSource : public Source
+{
+public:
+  /**
+   * @brief CostmapSource constructor
+   * @param node Collision Monitor node pointer
+   * @param source_name Name of data source
+   * @param tf_buffer Shared pointer to a TF buffer
+   * @param base_frame_id Robot base frame ID. The output data will be transformed into this frame.
+   * @param global_frame_id Global frame ID for correct transform calculation
+   * @param transform_tolerance Transform tolerance
+   * @param source_timeout Maximum time interval in which data is considered valid
+   * @param base_shift_correction Whether to correct source data towards to base frame movement,
+   * considering the difference between current time and latest source time
+   */
+  CostmapSource(
+    const nav2_util::LifecycleNode::WeakPtr & node,
+    const std::string & source_name,
+    const std::shared_ptr<tf2_ros::Buffer> tf_buffer,
+    const std::string & base_frame_id,
+    const std::string & global_frame_id,
+    const tf2::Duration & transform_tolerance,
+    const rclcpp::Duration & source_timeout,
+    const bool base_shift_correction);
+  /**
+   * @brief CostmapSource destructor
+   */
+  ~CostmapSource();
+
+  /**
+   * @brief Data source configuration routine. Obtains ROS-parameters
+   * and creates costmap and costmap updates subscribers.
+   */
+  void configure();
+
+  /**
+   * @brief Adds the centers of the occupied costmap cells to the data array.
+   * @param curr_time Current node time for data interpolation
+   * @param data Array where the data from source to be added.
+   * Added data is transformed to base_frame_id_ coordinate system at curr_time.
+   * @return false if an invalid source should block the robot
+   */
+  bool getData(
+    const rclcpp::Time & curr_time,
+    std::vector<Point> & data);
+
+protected:
+  /**
+   * @brief Getting costmap-specific ROS-parameters
+   * @param source_topic Output name of costmap topic
+   */
+  void getParameters(std::string & source_topic);
+
+  /**
+   * @brief Costmap callback, resetting the occupied cells to the ones of the whole costmap
+   * @param msg Shared pointer to Costmap message
+   */
+  void costmapCallback(nav2_msgs::msg::Costmap::ConstSharedPtr msg);
+
+  /**
+   * @brief Costmap update callback, updating the occupied cells of the updated area
+   * @param msg Shared pointer to CostmapUpdate message
+   */
+  void costmapUpdateCallback(nav2_msgs::msg::CostmapUpdate::ConstSharedPtr msg);
+
+  /**
+   * @brief Sets the cost of a cell, adding or removing its center from the occupied ones
+   * @param index Index of the cell in the costmap
+   * @param cost New cost of the cell
+   */
+  void setCost(unsigned int index, unsigned char cost);
+
+  // ----- Variables -----
+
+  /// @brief Costmap subscriber
+  rclcpp::Subscription<nav2_msgs::msg::Costmap>::SharedPtr costmap_sub_;
+  /// @brief Costmap updates subscriber
+  rclcpp::Subscription<nav2_msgs::msg::CostmapUpdate>::SharedPtr costmap_update_sub_;
+
+  /// @brief Minimum cost of the occupied cells
+  unsigned char cost_threshold_;
+  /// @brief Whether cells of unknown cost are occupied
+  bool treat_unknown_as_obstacle_;
+
+  /// @brief Whether a costmap was received
+  bool costmap_received_;
+  /// @brief Header of the latest costmap or costmap update
+  std_msgs::msg::Header header_;
+  /// @brief Costmap geometry
+  unsigned int size_x_, size_y_;
+  double resolution_, origin_x_, origin_y_;
+  /// @brief Latest cost of each cell
+  std::vector<unsigned char> costs_;
+  /// @brief Index in points_ of the center of each occupied cell, -1 for the other cells
+  std::vector<int32_t> cell_points_;
+  /// @brief Centers of the occupied cells in the costmap frame
+  std::vector<Point> points_;
+  /// @brief Cell of each point of points_
+  std::vector<unsigned int> point_cells_;
+
+  /// @brief Whether points_ changed since the base frame points were computed
+  bool points_changed_;
+  /// @brief Transform the base frame points were computed with
+  tf2::Transform cached_transform_;
+  /// @brief Centers of the occupied cells in the base frame
+  std::vector<Point> base_points_;
+};  // class CostmapSource
+
+}  // namespace nav2_collision_monitor
+
+#endif  // NAV2_COLLISION_MONITOR__COSTMAP_SOURCE_HPP_
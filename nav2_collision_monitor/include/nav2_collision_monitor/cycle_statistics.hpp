@@ -0,0 +1,170 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_COLLISION_MONITOR__CYCLE_STATISTICS_HPP_
+#define NAV2_COLLISION_MONITOR__CYCLE_STATISTICS_HPP_
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "diagnostic_updater/diagnostic_status_wrapper.hpp"
+#include "nav2_msgs/msg/collision_monitor_statistics.hpp"
+
+namespace nav2_collision_monitor
+{
+
+/**
+ * @brief Histogram of durations, in milliseconds
+ */
+class DurationHistogram
+{
+public:
+  /// @brief Upper bounds of the buckets in milliseconds, the last bucket being unbounded
+  static constexpr std::array<unsigned int, 9> BOUNDS{1, 2, 5, 10, 20, 50, 100, 200, 500};
+
+  /**
+   * @brief Adds a duration to the histogram
+   * @param duration Duration to add
+   */
+  void add(const rclcpp::Duration & duration);
+
+  /**
+   * @brief Adds the summary and the buckets of the histogram to a diagnostic status
+   * @param name Name of the durations, prefixing the keys
+   * @param stat Diagnostic status to fill
+   */
+  void fill(const std::string & name, diagnostic_updater::DiagnosticStatusWrapper & stat) const;
+
+  /**
+   * @brief Clears the histogram
+   */
+  void reset();
+
+  /**
+   * @brief Gets the number of durations added since the last reset
+   * @return Number of durations
+   */
+  unsigned int count() const {return count_;}
+
+protected:
+  /// @brief Number of durations in each bucket
+  std::array<unsigned int, BOUNDS.size() + 1> buckets_{};
+  /// @brief Number of durations, their sum and their maximum
+  unsigned int count_{0};
+  double sum_{0.0};
+  double max_{0.0};
+};
+
+/**
+ * @brief Load and latency of the cycles of the collision monitor or collision detector:
+ * the statistics of the last cycle, to be published, and histograms of the cycles since
+ * the last diagnostics report.
+ */
+class CycleStatistics
+{
+public:
+  /**
+   * @brief Sets the data sources, in the order they are processed
+   * @param source_names Names of the data sources
+   */
+  void setSourceNames(const std::vector<std::string> & source_names);
+
+  /**
+   * @brief Starts a new cycle, timing it from now on
+   */
+  void startCycle();
+
+  /**
+   * @brief Records the data obtained from a source in the current cycle
+   * @param index Index of the source
+   * @param points Number of points added by the source
+   * @param duration Time spent getting the data of the source
+   */
+  void setSource(size_t index, size_t points, const rclcpp::Duration & duration);
+
+  /**
+   * @brief Records the timestamp of source data used in the current cycle,
+   * keeping the oldest one
+   * @param stamp Timestamp of the data
+   */
+  void setDataStamp(const rclcpp::Time & stamp);
+
+  /**
+   * @brief Records the time spent evaluating the polygons in the current cycle
+   * @param duration Duration of the evaluation
+   */
+  void setPolygonsDuration(const rclcpp::Duration & duration);
+
+  /**
+   * @brief Records the time from the stamp of the input command to its output
+   * in the current cycle
+   * @param latency Latency of the command
+   */
+  void setCommandLatency(const rclcpp::Duration & latency);
+
+  /**
+   * @brief Finishes the current cycle, adding it to the histograms
+   * @param curr_time Current node time, to which the age of the data is measured
+   */
+  void finishCycle(const rclcpp::Time & curr_time);
+
+  /**
+   * @brief Gets the statistics of the last finished cycle
+   * @return Statistics message, with the header left to the caller
+   */
+  nav2_msgs::msg::CollisionMonitorStatistics & getMessage() {return msg_;}
+
+  /**
+   * @brief Reports the histograms of the cycles since the last report and clears them
+   * @param stat Diagnostic status to fill
+   */
+  void fillDiagnostics(diagnostic_updater::DiagnosticStatusWrapper & stat);
+
+  /**
+   * @brief Gets the duration elapsed since a steady clock time point
+   * @param start Time point
+   * @return Elapsed duration
+   */
+  static rclcpp::Duration elapsed(const std::chrono::steady_clock::time_point & start)
+  {
+    return rclcpp::Duration(std::chrono::steady_clock::now() - start);
+  }
+
+protected:
+  /// @brief Names of the data sources
+  std::vector<std::string> source_names_;
+  /// @brief Statistics of the current or last cycle
+  nav2_msgs::msg::CollisionMonitorStatistics msg_;
+  /// @brief Start of the current cycle
+  std::chrono::steady_clock::time_point cycle_start_;
+  /// @brief Oldest data used in the current cycle, if any
+  rclcpp::Time oldest_stamp_;
+  bool data_used_{false};
+
+  /// @brief Histograms since the last report
+  DurationHistogram total_histogram_;
+  DurationHistogram polygons_histogram_;
+  DurationHistogram data_age_histogram_;
+  DurationHistogram command_latency_histogram_;
+  /// @brief Sums since the last report of the points and durations of each source
+  std::vector<double> source_points_sums_;
+  std::vector<double> source_durations_sums_;
+};
+
+}  // namespace nav2_collision_monitor
+
+#endif  // NAV2_COLLISION_MONITOR__CYCLE_STATISTICS_HPP_
@@ -0,0 +1,189 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_COLLISION_MONITOR__POINT_GRID_HPP_
+#define NAV2_COLLISION_MONITOR__POINT_GRID_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "nav2_collision_monitor/types.hpp"
+
+namespace nav2_collision_monitor
+{
+
+/**
+ * @brief Uniform grid of 2D points, bucketing the collision points once per cycle
+ * so that each shape only checks the points in the cells overlapping its bounding box.
+ * The cell size adapts to the spread of the points, for a few points per cell.
+ */
+class PointGrid
+{
+public:
+  /**
+   * @brief PointGrid constructor
+   */
+  PointGrid() = default;
+
+  /**
+   * @brief Buckets a new set of points, reusing the storage of the previous ones
+   * @param points Points to bucket
+   */
+  void setPoints(const std::vector<Point> & points);
+
+  /**
+   * @brief Gets number of points in the grid
+   * @return Number of points
+   */
+  size_t size() const {return points_.size();}
+
+  /**
+   * @brief Counts the points inside a bounding box for which a predicate holds,
+   * stopping as soon as the count reaches max_count
+   * @param min Lower corner of the bounding box
+   * @param max Upper corner of the bounding box
+   * @param inside Predicate checking whether a point of the box is inside the shape
+   * @param max_count Count at which to stop
+   * @return Number of points counted, at most max_count
+   */
+  template<typename PredicateT>
+  int countPoints(
+    const Point & min, const Point & max, PredicateT && inside, int max_count) const;
+
+  /**
+   * @brief Counts the points of the cells overlapping a bounding box with a counter run
+   * on contiguous ranges of their coordinates, one range per row of cells, stopping as soon
+   * as the count reaches max_count. The ranges may hold points outside of the box.
+   * @param min Lower corner of the bounding box
+   * @param max Upper corner of the bounding box
+   * @param count_range Counter called with the X and Y coordinates of a range of points
+   * and its size, returning how many of them are inside the shape
+   * @param max_count Count at which to stop
+   * @return Number of points counted, at most max_count
+   */
+  template<typename RangeCounterT>
+  int countPointRanges(
+    const Point & min, const Point & max, RangeCounterT && count_range, int max_count) const;
+
+  /**
+   * @brief Visits the points inside a bounding box
+   * @param min Lower corner of the bounding box
+   * @param max Upper corner of the bounding box
+   * @param visit Function called with each point of the box
+   */
+  template<typename VisitorT>
+  void forEachPoint(const Point & min, const Point & max, VisitorT && visit) const
+  {
+    countPoints(
+      min, max, [&visit](const Point & point) {
+        visit(point);
+        return false;
+      }, 1);
+  }
+
+protected:
+  /**
+   * @brief Converts a coordinate to the index of its cell, clamped to the grid
+   * @param value Coordinate
+   * @param origin Coordinate of the grid origin
+   * @param size Number of cells along the coordinate
+   * @return Index of the cell
+   */
+  int toCell(double value, double origin, int size) const
+  {
+    return std::clamp(static_cast<int>(std::floor((value - origin) / cell_size_)), 0, size - 1);
+  }
+
+  /// @brief Lower corner of the grid, on the bounding box of the points
+  Point origin_{0.0, 0.0};
+  /// @brief Upper corner of the grid, on the bounding box of the points
+  Point end_{0.0, 0.0};
+  /// @brief Size of the square cells
+  double cell_size_{1.0};
+  /// @brief Number of cells along X and Y
+  int size_x_{0};
+  int size_y_{0};
+  /// @brief Points sorted by cell, in row-major order of the cells
+  std::vector<Point> points_;
+  /// @brief Coordinates of points_, for the range counters
+  std::vector<double> xs_;
+  std::vector<double> ys_;
+  /// @brief Index in points_ of the first point of each cell, and of the end of points_
+  std::vector<unsigned int> cell_starts_;
+  /// @brief Cell of each input point
+  std::vector<unsigned int> point_cells_;
+};
+
+template<typename PredicateT>
+int PointGrid::countPoints(
+  const Point & min, const Point & max, PredicateT && inside, int max_count) const
+{
+  if (points_.empty() || max_count <= 0 ||
+    max.x < origin_.x || max.y < origin_.y || min.x > end_.x || min.y > end_.y)
+  {
+    return 0;
+  }
+
+  const int x0 = toCell(min.x, origin_.x, size_x_);
+  const int x1 = toCell(max.x, origin_.x, size_x_);
+  const int y0 = toCell(min.y, origin_.y, size_y_);
+  const int y1 = toCell(max.y, origin_.y, size_y_);
+
+  int count = 0;
+  for (int y = y0; y <= y1; y++) {
+    // The cells of a row of the box are contiguous
+    const unsigned int begin = cell_starts_[y * size_x_ + x0];
+    const unsigned int end = cell_starts_[y * size_x_ + x1 + 1];
+    for (unsigned int i = begin; i < end; i++) {
+      const Point & point = points_[i];
+      if (point.x >= min.x && point.x <= max.x && point.y >= min.y && point.y <= max.y &&
+        inside(point) && ++count >= max_count)
+      {
+        return count;
+      }
+    }
+  }
+  return count;
+}
+
+template<typename RangeCounterT>
+int PointGrid::countPointRanges(
+  const Point & min, const Point & max, RangeCounterT && count_range, int max_count) const
+{
+  if (points_.empty() || max_count <= 0 ||
+    max.x < origin_.x || max.y < origin_.y || min.x > end_.x || min.y > end_.y)
+  {
+    return 0;
+  }
+
+  const int x0 = toCell(min.x, origin_.x, size_x_);
+  const int x1 = toCell(max.x, origin_.x, size_x_);
+  const int y0 = toCell(min.y, origin_.y, size_y_);
+  const int y1 = toCell(max.y, origin_.y, size_y_);
+
+  int count = 0;
+  for (int y = y0; y <= y1 && count < max_count; y++) {
+    const unsigned int begin = cell_starts_[y * size_x_ + x0];
+    const unsigned int end = cell_starts_[y * size_x_ + x1 + 1];
+    if (begin < end) {
+      count += count_range(xs_.data() + begin, ys_.data() + begin, end - begin);
+    }
+  }
+  return std::min(count, max_count);
+}
+
+}  // namespace nav2_collision_monitor
+
+#endif  // NAV2_COLLISION_MONITOR__POINT_GRID_HPP_
@@ -15,11 +15,13 @@
 #ifndef NAV2_COLLISION_MONITOR__POINTCLOUD_HPP_
 #define NAV2_COLLISION_MONITOR__POINTCLOUD_HPP_
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 #include <string>
 
 #include "sensor_msgs/msg/point_cloud2.hpp"
+#include "tf2/LinearMath/Transform.h"
 
 #include "nav2_collision_monitor/source.hpp"
 
@@ -66,6 +68,7 @@ public:
 
   /**
    * @brief Adds latest data from pointcloud source to the data array.
+   * The points of a cloud are cached and only recomputed for a new cloud or transform.
    * @param curr_time Current node time for data interpolation
    * @param data Array where the data from source to be added.
    * Added data is transformed to base_frame_id_ coordinate system at curr_time.
@@ -82,6 +85,13 @@ protected:
    */
   void getParameters(std::string & source_topic);
 
+  /**
+   * @brief Reduces the points to the first one of each square cell of
+   * downsampling_resolution_ size, in linear time
+   * @param points Points to downsample in place
+   */
+  void downsample(std::vector<Point> & points);
+
   /**
    * @brief PointCloud data callback
    * @param msg Shared pointer to PointCloud message
@@ -95,9 +105,30 @@ protected:
 
   // Minimum and maximum height of PointCloud projected to 2D space
   double min_height_, max_height_;
+  /// @brief Size of the cells the points are downsampled to, 0 to keep all the points
+  double downsampling_resolution_;
+
+  /// @brief Cell of the downsampling table, occupied if written in the current generation
+  struct Cell
+  {
+    uint64_t key;
+    uint32_t generation;
+  };
+  /// @brief Hash table of the cells occupied by the downsampled points, kept between cycles
+  std::vector<Cell> cells_;
+  /// @brief Generation of the current downsampling
+  uint32_t generation_{0};
 
   /// @brief Latest data obtained from pointcloud
   sensor_msgs::msg::PointCloud2::ConstSharedPtr data_;
+
+  /// @brief Message the cached points were computed from
+  sensor_msgs::msg::PointCloud2::ConstSharedPtr cached_data_;
+  /// @brief Transform the cached points were computed with
+  tf2::Transform cached_transform_;
+  /// @brief Points of the cached message in the base frame within the height range,
+  /// reused while neither the message nor the transform change
+  std::vector<Point> points_;
 };  // class PointCloud
 
 }  // namespace nav2_collision_monitor
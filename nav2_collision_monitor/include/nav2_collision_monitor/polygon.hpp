@@ -29,6 +29,8 @@
 #include "nav2_costmap_2d/footprint_subscriber.hpp"
 
 #include "nav2_collision_monitor/types.hpp"
+#include "nav2_collision_monitor/point_grid.hpp"
+#include "nav2_collision_monitor/polygon_edges.hpp"
 
 namespace nav2_collision_monitor
 {
@@ -146,17 +148,42 @@ public:
   virtual int getPointsInside(const std::vector<Point> & points) const;
 
   /**
-   * @brief Obtains estimated (simulated) time before a collision.
+   * @brief Gets number of points of the grid inside polygon, placed at given pose
+   * @param points Grid of points to be checked
+   * @param pose Pose of the polygon in the frame of the points
+   * @param max_points Number of points at which to stop counting
+   * @return Number of points inside polygon, at most max_points
+   */
+  virtual int getPointsInside(
+    const PointGrid & points, const Pose & pose, int max_points) const;
+
+  /**
+   * @brief Obtains time before a collision, for the robot moving at a constant velocity
+   * along an arc. It is computed from the times at which each point crosses the edges of
+   * the polygon in the robot frame, rather than by simulating the motion step by step.
    * Applicable for APPROACH model.
    * @param collision_points Array of 2D obstacle points
-   * @param velocity Simulated robot velocity
-   * @return Estimated time before a collision. If there is no collision,
+   * @param velocity Robot velocity
+   * @return Time before a collision. If there is no collision,
    * return value will be negative.
    */
   double getCollisionTime(
     const std::vector<Point> & collision_points,
     const Velocity & velocity) const;
 
+  /**
+   * @brief Obtains time before a collision, only for the points of the grid
+   * the robot can reach within the time before collision.
+   * Applicable for APPROACH model.
+   * @param collision_points Grid of 2D obstacle points
+   * @param velocity Robot velocity
+   * @return Time before a collision. If there is no collision,
+   * return value will be negative.
+   */
+  double getCollisionTime(
+    const PointGrid & collision_points,
+    const Velocity & velocity) const;
+
   /**
    * @brief Publishes polygon message into a its own topic
    */
@@ -225,7 +252,46 @@ protected:
    * @param point Given point to check
    * @return True if given point is inside polygon, otherwise false
    */
-  bool isPointInside(const Point & point) const;
+  virtual bool isPointInside(const Point & point) const;
+
+  /**
+   * @brief Gets the times at which a point crosses the boundary of the polygon in the
+   * robot frame, while the robot moves at a constant velocity
+   * @param point Point in the robot frame at the current time
+   * @param velocity Robot velocity
+   * @param max_time Time after which crossings are ignored
+   * @param times Output crossing times, in no particular order
+   */
+  virtual void getCrossingTimes(
+    const Point & point, const Velocity & velocity, double max_time,
+    std::vector<double> & times) const;
+
+  /**
+   * @brief Adds the times at which a point rotating around a center reaches a given angle.
+   * In the robot frame, the points rotate around the instantaneous center of rotation
+   * at the opposite of the robot angular velocity.
+   * @param start_angle Angle of the point around the center at the current time
+   * @param angle Angle around the center to reach
+   * @param angular_velocity Robot angular velocity, non zero
+   * @param max_time Time after which crossings are ignored
+   * @param times Output crossing times
+   */
+  static void addArcCrossingTimes(
+    double start_angle, double angle, double angular_velocity, double max_time,
+    std::vector<double> & times);
+
+  /**
+   * @brief Checks if point is inside given polygon
+   * @param point Given point to check
+   * @param poly Vertices of the polygon
+   * @return True if given point is inside polygon, otherwise false
+   */
+  static bool isPointInside(const Point & point, const std::vector<Point> & poly);
+
+  /**
+   * @brief Precomputes the edges of the polygon after its vertices have changed
+   */
+  void updateEdges();
 
   /**
    * @brief Extracts Polygon points from a string with of the form [[x1,y1],[x2,y2],[x3,y3]...]
@@ -259,7 +325,8 @@ protected:
   double angular_limit_;
   /// @brief Time before collision in seconds
   double time_before_collision_;
-  /// @brief Time step for robot movement simulation
+  /// @brief Time step for robot movement simulation, kept for compatibility since the time
+  /// before collision is computed exactly
   double simulation_time_step_;
   /// @brief Whether polygon is enabled
   bool enabled_;
@@ -288,6 +355,8 @@ protected:
 
   /// @brief Polygon points (vertices) in a base_frame_id_
   std::vector<Point> poly_;
+  /// @brief Edges of poly_, for the point in polygon tests
+  PolygonEdges edges_;
 };  // class Polygon
 
 }  // namespace nav2_collision_monitor
@@ -0,0 +1,188 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_COLLISION_MONITOR__POLYGON_EDGES_HPP_
+#define NAV2_COLLISION_MONITOR__POLYGON_EDGES_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "nav2_collision_monitor/types.hpp"
+
+namespace nav2_collision_monitor
+{
+
+/**
+ * @brief Edges of a polygon precomputed for point in polygon tests, run on blocks of points
+ * in structure of arrays layout so that the compiler vectorizes them across the points.
+ * The points are tested with the ray crossing algorithm, or for convex polygons by their
+ * distance to the half-planes of the edges, falling back to ray crossing near the boundary
+ * so that both agree.
+ */
+class PolygonEdges
+{
+public:
+  /**
+   * @brief Precomputes the edges of a polygon
+   * @param poly Vertices of the polygon
+   */
+  void setPolygon(const std::vector<Point> & poly);
+
+  /**
+   * @brief Checks whether the polygon has no edges
+   * @return True if the polygon is empty
+   */
+  bool empty() const {return x_.empty();}
+
+  /**
+   * @brief Gets the lower corner of the bounding box of the polygon
+   * @return Lower corner
+   */
+  const Point & getMin() const {return min_;}
+
+  /**
+   * @brief Gets the upper corner of the bounding box of the polygon
+   * @return Upper corner
+   */
+  const Point & getMax() const {return max_;}
+
+  /**
+   * @brief Checks whether the polygon is convex, using the half-plane test
+   * @return True if the polygon is convex
+   */
+  bool isConvex() const {return convex_;}
+
+  /**
+   * @brief Checks whether a point is inside the polygon with the ray crossing algorithm
+   * @param point Point to check
+   * @return True if the point is inside the polygon
+   */
+  bool isPointInside(const Point & point) const
+  {
+    return isPointInside(point.x, point.y);
+  }
+
+  /**
+   * @brief Counts the points inside the polygon
+   * @param xs X coordinates of the points
+   * @param ys Y coordinates of the points
+   * @param size Number of points
+   * @return Number of points inside the polygon
+   */
+  int countPointsInside(const double * xs, const double * ys, size_t size) const
+  {
+    int count = 0;
+    size_t i = 0;
+    if (convex_) {
+      for (; i + BLOCK_SIZE <= size; i += BLOCK_SIZE) {
+        count += countBlockConvex(xs + i, ys + i);
+      }
+    } else {
+      for (; i + BLOCK_SIZE <= size; i += BLOCK_SIZE) {
+        count += countBlockCrossing(xs + i, ys + i);
+      }
+    }
+    for (; i < size; i++) {
+      count += isPointInside(xs[i], ys[i]);
+    }
+    return count;
+  }
+
+protected:
+  /// @brief Number of points tested together
+  static constexpr size_t BLOCK_SIZE = 8;
+  /// @brief Distance to the boundary under which the half-plane test defers to ray crossing
+  static constexpr double BOUNDARY_TOLERANCE = 1e-9;
+
+  /**
+   * @brief Ray crossing test of a point: the X+ ray from the point crosses the boundary
+   * an odd number of times if the point is inside
+   */
+  bool isPointInside(double px, double py) const
+  {
+    bool res = false;
+    for (size_t e = 0; e < x_.size(); e++) {
+      // One of the conditions contains equality in order to exclude the edges parallel to the ray
+      if ((py <= y_[e]) == (py > y_next_[e]) && x_[e] + (py - y_[e]) * dx_[e] / dy_[e] > px) {
+        res = !res;
+      }
+    }
+    return res;
+  }
+
+  /**
+   * @brief Ray crossing test of a block of points
+   */
+  int countBlockCrossing(const double * xs, const double * ys) const
+  {
+    uint8_t odd[BLOCK_SIZE] = {};
+    for (size_t e = 0; e < x_.size(); e++) {
+      const double x = x_[e], y = y_[e], y_next = y_next_[e], dx = dx_[e], dy = dy_[e];
+      for (size_t k = 0; k < BLOCK_SIZE; k++) {
+        // The crossing is computed for all the points, and only counted for the straddling ones
+        const bool straddles = (ys[k] <= y) == (ys[k] > y_next);
+        odd[k] ^= straddles & (x + (ys[k] - y) * dx / dy > xs[k]);
+      }
+    }
+    int count = 0;
+    for (size_t k = 0; k < BLOCK_SIZE; k++) {
+      count += odd[k];
+    }
+    return count;
+  }
+
+  /**
+   * @brief Half-plane test of a block of points against a convex polygon
+   */
+  int countBlockConvex(const double * xs, const double * ys) const
+  {
+    // Signed distance to the closest edge line, positive inside
+    double dist[BLOCK_SIZE];
+    std::fill(dist, dist + BLOCK_SIZE, std::numeric_limits<double>::max());
+    for (size_t e = 0; e < a_.size(); e++) {
+      const double a = a_[e], b = b_[e], c = c_[e];
+      for (size_t k = 0; k < BLOCK_SIZE; k++) {
+        dist[k] = std::min(dist[k], a * xs[k] + b * ys[k] + c);
+      }
+    }
+    int count = 0;
+    for (size_t k = 0; k < BLOCK_SIZE; k++) {
+      if (dist[k] > BOUNDARY_TOLERANCE) {
+        count++;
+      } else if (dist[k] >= -BOUNDARY_TOLERANCE) {
+        count += isPointInside(xs[k], ys[k]);
+      }
+    }
+    return count;
+  }
+
+  /// @brief Start vertex of each edge, Y of its end vertex and its extent. The crossings
+  /// are computed as x + (py - y) * dx / dy, rounding as the ray crossing of a single point.
+  std::vector<double> x_, y_, y_next_, dx_, dy_;
+  /// @brief Normalized line equation a * x + b * y + c of each edge of a convex polygon,
+  /// positive inside
+  std::vector<double> a_, b_, c_;
+  /// @brief Whether the polygon is convex
+  bool convex_{false};
+  /// @brief Bounding box of the polygon
+  Point min_{0.0, 0.0};
+  Point max_{0.0, 0.0};
+};
+
+}  // namespace nav2_collision_monitor
+
+#endif  // NAV2_COLLISION_MONITOR__POLYGON_EDGES_HPP_
@@ -20,6 +20,7 @@
 #include <vector>
 
 #include "sensor_msgs/msg/laser_scan.hpp"
+#include "tf2/LinearMath/Transform.h"
 
 #include "nav2_collision_monitor/source.hpp"
 
@@ -66,6 +67,7 @@ public:
 
   /**
    * @brief Adds latest data from laser scanner to the data array.
+   * The points of a scan are cached and only recomputed for a new scan or transform.
    * @param curr_time Current node time for data interpolation
    * @param data Array where the data from source to be added.
    * Added data is transformed to base_frame_id_ coordinate system at curr_time.
@@ -89,6 +91,19 @@ protected:
 
   /// @brief Latest data obtained from laser scanner
   sensor_msgs::msg::LaserScan::ConstSharedPtr data_;
+
+  /// @brief Message the cached points were computed from
+  sensor_msgs::msg::LaserScan::ConstSharedPtr cached_data_;
+  /// @brief Coordinates of the valid readings of the cached message in the source frame
+  std::vector<double> source_x_;
+  std::vector<double> source_y_;
+  /// @brief Transform the cached points were computed with
+  tf2::Transform cached_transform_;
+  /// @brief Whether points_ holds the cached message in the base frame
+  bool points_valid_{false};
+  /// @brief Points of the cached message in the base frame, reused while neither
+  /// the message nor the transform change
+  std::vector<Point> points_;
 };  // class Scan
 
 }  // namespace nav2_collision_monitor
@@ -15,6 +15,7 @@
 #ifndef NAV2_COLLISION_MONITOR__SOURCE_HPP_
 #define NAV2_COLLISION_MONITOR__SOURCE_HPP_
 
+#include <functional>
 #include <memory>
 #include <vector>
 #include <string>
@@ -93,6 +94,18 @@ public:
    */
   rclcpp::Duration getSourceTimeout() const;
 
+  /**
+   * @brief Obtains the timestamp of the oldest data added by the last successful getData() call
+   * @return Timestamp of the data
+   */
+  rclcpp::Time getDataStamp() const;
+
+  /**
+   * @brief Sets the function to call each time new data is received from the source
+   * @param callback Function called with the timestamp of the new data
+   */
+  void setDataReceivedCallback(std::function<void(const rclcpp::Time &)> callback);
+
 protected:
   /**
    * @brief Source configuration routine.
@@ -123,6 +136,12 @@ protected:
   rcl_interfaces::msg::SetParametersResult dynamicParametersCallback(
     std::vector<rclcpp::Parameter> parameters);
 
+  /**
+   * @brief Notifies that new data was received from the source
+   * @param stamp Timestamp of the new data
+   */
+  void notifyDataReceived(const rclcpp::Time & stamp) const;
+
   /**
    * @brief Obtain the transform to get data from source frame and time where it was received to the
    * base frame and current time (if base_shift_correction_ is true) or the transform  without time
@@ -167,6 +186,10 @@ protected:
   bool base_shift_correction_;
   /// @brief Whether source is enabled
   bool enabled_;
+  /// @brief Timestamp of the oldest data added by the last successful getData() call
+  rclcpp::Time data_stamp_;
+  /// @brief Function called each time new data is received, if set
+  std::function<void(const rclcpp::Time &)> data_received_callback_;
 };  // class Source
 
 }  // namespace nav2_collision_monitor
@@ -15,6 +15,7 @@
 #ifndef NAV2_COLLISION_MONITOR__VELOCITY_POLYGON_HPP_
 #define NAV2_COLLISION_MONITOR__VELOCITY_POLYGON_HPP_
 
+#include <limits>
 #include <memory>
 #include <string>
 #include <vector>
@@ -79,6 +80,7 @@ protected:
     * @param theta_max_ The maximum angular velocity
     * @param direction_end_angle_ The end angle of the direction(For holonomic robot only)
     * @param direction_start_angle_ The start angle of the direction(For holonomic robot only)
+    * @param polygon_points_ The points of the sub-polygon for visualization
     */
   struct SubPolygonParameter
   {
@@ -90,6 +92,7 @@ protected:
     double theta_max_;
     double direction_end_angle_;
     double direction_start_angle_;
+    std::vector<geometry_msgs::msg::Point32> polygon_points_;
   };
 
   /**
@@ -100,6 +103,21 @@ protected:
    */
   bool isInRange(const Velocity & cmd_vel_in, const SubPolygonParameter & sub_polygon_param);
 
+  /**
+   * @brief Builds the lookup table of the sub-polygons covering each cell of the velocity space,
+   * delimited by the linear and angular velocity bounds of the sub-polygons
+   */
+  void buildLookupTable();
+
+  /**
+   * @brief Gets the cell of the lookup table containing a velocity component.
+   * Cell 2i + 1 is the bound i itself, cell 2i lies between the bounds i - 1 and i.
+   * @param bounds Sorted bounds of the velocity component
+   * @param value Velocity component
+   * @return Index of the cell along the velocity component
+   */
+  static size_t getBoundsCell(const std::vector<double> & bounds, const double value);
+
   // Clock
   rclcpp::Clock::SharedPtr clock_;
 
@@ -108,6 +126,18 @@ protected:
   bool holonomic_;
   /// @brief Vector to store the parameters of the sub-polygon
   std::vector<SubPolygonParameter> sub_polygons_;
+  /// @brief Index of the sub-polygon set in poly_
+  size_t current_sub_polygon_{std::numeric_limits<size_t>::max()};
+
+  /// @brief Sorted linear and angular velocity bounds of all the sub-polygons
+  std::vector<double> linear_bounds_;
+  std::vector<double> theta_bounds_;
+  /// @brief Index in cell_sub_polygons_ of the first candidate of each cell of the
+  /// velocity space, and of the end of cell_sub_polygons_
+  std::vector<unsigned int> cell_starts_{0, 0};
+  /// @brief Sub-polygons within the linear and angular bounds of each cell, in the
+  /// configured order
+  std::vector<unsigned int> cell_sub_polygons_;
 };  // class VelocityPolygon
 
 }  // namespace nav2_collision_monitor
@@ -23,6 +23,9 @@
 namespace nav2_collision_monitor
 {
 
+// Tolerance on velocities and lengths below which a motion is degenerate
+static constexpr double EPSILON = 1e-9;
+
 Circle::Circle(
   const nav2_util::LifecycleNode::WeakPtr & node,
   const std::string & polygon_name,
@@ -70,6 +73,82 @@ int Circle::getPointsInside(const std::vector<Point> & points) const
   return num;
 }
 
+int Circle::getPointsInside(
+  const PointGrid & points, const Pose & pose, int max_points) const
+{
+  if (radius_squared_ < 0.0) {
+    return 0;
+  }
+
+  const Point min{pose.x - radius_, pose.y - radius_};
+  const Point max{pose.x + radius_, pose.y + radius_};
+  return points.countPointRanges(
+    min, max, [this, &pose](const double * xs, const double * ys, size_t size) {
+      // Branchless, for the compiler to vectorize it
+      int count = 0;
+      for (size_t i = 0; i < size; i++) {
+        const double dx = xs[i] - pose.x;
+        const double dy = ys[i] - pose.y;
+        count += dx * dx + dy * dy < radius_squared_;
+      }
+      return count;
+    }, max_points);
+}
+
+bool Circle::isPointInside(const Point & point) const
+{
+  return point.x * point.x + point.y * point.y < radius_squared_;
+}
+
+void Circle::getCrossingTimes(
+  const Point & point, const Velocity & velocity, double max_time,
+  std::vector<double> & times) const
+{
+  if (radius_squared_ < 0.0) {
+    return;
+  }
+
+  if (std::fabs(velocity.tw) < EPSILON) {
+    // The point moves along a line at the opposite of the robot velocity: |p - v * t|^2 = R^2
+    const double qa = velocity.x * velocity.x + velocity.y * velocity.y;
+    const double qb = -2.0 * (point.x * velocity.x + point.y * velocity.y);
+    const double qc = point.x * point.x + point.y * point.y - radius_squared_;
+    const double disc = qb * qb - 4.0 * qa * qc;
+    if (qa < EPSILON || disc <= 0.0) {
+      return;
+    }
+    const double disc_sqrt = std::sqrt(disc);
+    for (const double t : {(-qb - disc_sqrt) / (2.0 * qa), (-qb + disc_sqrt) / (2.0 * qa)}) {
+      if (t > 0.0 && t <= max_time) {
+        times.push_back(t);
+      }
+    }
+    return;
+  }
+
+  // The point rotates around the instantaneous center of rotation c, on a circle of radius r.
+  // It crosses the footprint where |c + r * (cos(a), sin(a))| = R, that is where
+  // cos(a - angle(c)) = (R^2 - |c|^2 - r^2) / (2 * r * |c|)
+  const Point center{-velocity.y / velocity.tw, velocity.x / velocity.tw};
+  const Point rel{point.x - center.x, point.y - center.y};
+  const double radius = std::hypot(rel.x, rel.y);
+  const double center_dist = std::hypot(center.x, center.y);
+  if (radius < EPSILON || center_dist < EPSILON) {
+    return;
+  }
+  const double cos_angle = (radius_squared_ - center_dist * center_dist - radius * radius) /
+    (2.0 * radius * center_dist);
+  if (std::fabs(cos_angle) >= 1.0) {
+    return;
+  }
+
+  const double start_angle = std::atan2(rel.y, rel.x);
+  const double center_angle = std::atan2(center.y, center.x);
+  const double angle = std::acos(cos_angle);
+  addArcCrossingTimes(start_angle, center_angle + angle, velocity.tw, max_time, times);
+  addArcCrossingTimes(start_angle, center_angle - angle, velocity.tw, max_time, times);
+}
+
 bool Circle::isShapeSet()
 {
   if (radius_squared_ == -1.0) {
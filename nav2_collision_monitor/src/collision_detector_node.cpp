@@ -15,6 +15,7 @@
 
 #include "nav2_collision_monitor/collision_detector_node.hpp"
 
+#include <chrono>
 #include <exception>
 #include <utility>
 #include <functional>
@@ -29,8 +30,15 @@ namespace nav2_collision_monitor
 {
 
 CollisionDetector::CollisionDetector(const rclcpp::NodeOptions & options)
-: nav2_util::LifecycleNode("collision_detector", "", options)
+: nav2_util::LifecycleNode("collision_detector", "", options),
+  diagnostics_updater_(this)
 {
+  diagnostics_updater_.setHardwareID("Nav2");
+  diagnostics_updater_.add(
+    "Collision Detector Statistics",
+    [this](diagnostic_updater::DiagnosticStatusWrapper & stat) {
+      statistics_.fillDiagnostics(stat);
+    });
 }
 
 CollisionDetector::~CollisionDetector()
@@ -58,6 +66,9 @@ CollisionDetector::on_configure(const rclcpp_lifecycle::State & /*state*/)
   collision_points_marker_pub_ = this->create_publisher<visualization_msgs::msg::MarkerArray>(
     "~/collision_points_marker", 1);
 
+  statistics_pub_ = this->create_publisher<nav2_msgs::msg::CollisionMonitorStatistics>(
+    "~/statistics", 1);
+
   // Obtaining ROS parameters
   if (!getParameters()) {
     return nav2_util::CallbackReturn::FAILURE;
@@ -74,6 +85,7 @@ CollisionDetector::on_activate(const rclcpp_lifecycle::State & /*state*/)
   // Activating lifecycle publisher
   state_pub_->on_activate();
   collision_points_marker_pub_->on_activate();
+  statistics_pub_->on_activate();
 
   // Activating polygons
   for (std::shared_ptr<Polygon> polygon : polygons_) {
@@ -102,6 +114,7 @@ CollisionDetector::on_deactivate(const rclcpp_lifecycle::State & /*state*/)
   // Deactivating lifecycle publishers
   state_pub_->on_deactivate();
   collision_points_marker_pub_->on_deactivate();
+  statistics_pub_->on_deactivate();
 
   // Deactivating polygons
   for (std::shared_ptr<Polygon> polygon : polygons_) {
@@ -121,9 +134,11 @@ CollisionDetector::on_cleanup(const rclcpp_lifecycle::State & /*state*/)
 
   state_pub_.reset();
   collision_points_marker_pub_.reset();
+  statistics_pub_.reset();
 
   polygons_.clear();
   sources_.clear();
+  statistics_.setSourceNames({});
 
   tf_listener_.reset();
   tf_buffer_.reset();
@@ -294,6 +309,13 @@ bool CollisionDetector::configureSources(
         ps->configure();
 
         sources_.push_back(ps);
+      } else if (source_type == "costmap") {
+        std::shared_ptr<CostmapSource> cs = std::make_shared<CostmapSource>(
+          node, source_name, tf_buffer_, base_frame_id, odom_frame_id,
+          transform_tolerance, source_timeout, base_shift_correction);
+        cs->configure();
+
+        sources_.push_back(cs);
       } else {  // Error if something else
         RCLCPP_ERROR(
           get_logger(),
@@ -302,6 +324,8 @@ bool CollisionDetector::configureSources(
         return false;
       }
     }
+
+    statistics_.setSourceNames(source_names);
   } catch (const std::exception & ex) {
     RCLCPP_ERROR(get_logger(), "Error while getting parameters: %s", ex.what());
     return false;
@@ -315,18 +339,28 @@ void CollisionDetector::process()
   // Current timestamp for all inner routines prolongation
   rclcpp::Time curr_time = this->now();
 
+  statistics_.startCycle();
+
   // Points array collected from different data sources in a robot base frame
-  std::vector<Point> collision_points;
+  // kept between the cycles to reuse its capacity
+  std::vector<Point> & collision_points = collision_points_;
+  collision_points.clear();
 
   std::unique_ptr<nav2_msgs::msg::CollisionDetectorState> state_msg =
     std::make_unique<nav2_msgs::msg::CollisionDetectorState>();
 
   // Fill collision_points array from different data sources
-  for (std::shared_ptr<Source> source : sources_) {
+  for (size_t i = 0; i < sources_.size(); i++) {
+    const std::shared_ptr<Source> & source = sources_[i];
     if (source->getEnabled()) {
-      if (!source->getData(curr_time, collision_points) &&
-        source->getSourceTimeout().seconds() != 0.0)
-      {
+      const size_t points_num = collision_points.size();
+      const auto source_start = std::chrono::steady_clock::now();
+      const bool source_valid = source->getData(curr_time, collision_points);
+      statistics_.setSource(
+        i, collision_points.size() - points_num, CycleStatistics::elapsed(source_start));
+      if (source_valid) {
+        statistics_.setDataStamp(source->getDataStamp());
+      } else if (source->getSourceTimeout().seconds() != 0.0) {
         RCLCPP_WARN(
           get_logger(),
           "Invalid source %s detected."
@@ -365,20 +399,35 @@ void CollisionDetector::process()
     collision_points_marker_pub_->publish(std::move(marker_array));
   }
 
+  // Bucket the points once for all the polygons
+  const auto polygons_start = std::chrono::steady_clock::now();
+  collision_points_grid_.setPoints(collision_points);
+
   for (std::shared_ptr<Polygon> polygon : polygons_) {
     if (!polygon->getEnabled()) {
       continue;
     }
     state_msg->polygons.push_back(polygon->getName());
+    const int min_points = polygon->getMinPoints();
     state_msg->detections.push_back(
       polygon->getPointsInside(
-        collision_points) >= polygon->getMinPoints());
+        collision_points_grid_, Pose{0.0, 0.0, 0.0}, min_points) >= min_points);
   }
+  statistics_.setPolygonsDuration(CycleStatistics::elapsed(polygons_start));
 
   state_pub_->publish(std::move(state_msg));
 
   // Publish polygons for better visualization
   publishPolygons();
+
+  statistics_.finishCycle(this->now());
+  if (statistics_pub_->get_subscription_count() > 0) {
+    auto statistics_msg =
+      std::make_unique<nav2_msgs::msg::CollisionMonitorStatistics>(statistics_.getMessage());
+    statistics_msg->header.stamp = curr_time;
+    statistics_msg->header.frame_id = get_parameter("base_frame_id").as_string();
+    statistics_pub_->publish(std::move(statistics_msg));
+  }
 }
 
 void CollisionDetector::publishPolygons() const
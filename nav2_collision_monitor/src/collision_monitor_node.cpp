@@ -14,6 +14,8 @@
 
 #include "nav2_collision_monitor/collision_monitor_node.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <exception>
 #include <utility>
 #include <functional>
@@ -22,6 +24,7 @@
 
 #include "nav2_util/node_utils.hpp"
 #include "nav2_util/robot_utils.hpp"
+#include "nav2_util/tracing.hpp"
 
 #include "nav2_collision_monitor/kinematics.hpp"
 
@@ -30,13 +33,24 @@ namespace nav2_collision_monitor
 
 CollisionMonitor::CollisionMonitor(const rclcpp::NodeOptions & options)
 : nav2_util::LifecycleNode("collision_monitor", "", options),
-  process_active_(false), robot_action_prev_{DO_NOTHING, {-1.0, -1.0, -1.0}, ""},
-  stop_stamp_{0, 0, get_clock()->get_clock_type()}, stop_pub_timeout_(1.0, 0.0)
+  process_active_(false), process_on_source_data_(false), cmd_vel_in_received_(false),
+  robot_action_prev_{DO_NOTHING, {-1.0, -1.0, -1.0}, ""},
+  stop_stamp_{0, 0, get_clock()->get_clock_type()}, stop_pub_timeout_(1.0, 0.0),
+  diagnostics_updater_(this)
 {
+  diagnostics_updater_.setHardwareID("Nav2");
+  diagnostics_updater_.add(
+    "Collision Monitor Statistics",
+    [this](diagnostic_updater::DiagnosticStatusWrapper & stat) {
+      statistics_.fillDiagnostics(stat);
+    });
 }
 
 CollisionMonitor::~CollisionMonitor()
 {
+  if (!direct_cmd_vel_in_topic_.empty()) {
+    nav2_util::TwistRegistry::remove(direct_cmd_vel_in_topic_);
+  }
   polygons_.clear();
   sources_.clear();
 }
@@ -80,6 +94,17 @@ CollisionMonitor::on_configure(const rclcpp_lifecycle::State & /*state*/)
 
   collision_points_marker_pub_ = this->create_publisher<visualization_msgs::msg::MarkerArray>(
     "~/collision_points_marker", 1);
+  statistics_pub_ = this->create_publisher<nav2_msgs::msg::CollisionMonitorStatistics>(
+    "~/statistics", 1);
+
+  if (process_on_source_data_) {
+    decision_latency_pub_ = this->create_publisher<std_msgs::msg::Float32>(
+      "~/decision_latency", 1);
+    for (std::shared_ptr<Source> source : sources_) {
+      source->setDataReceivedCallback(
+        std::bind(&CollisionMonitor::sourceDataCallback, this, std::placeholders::_1));
+    }
+  }
 
   nav2_util::declare_parameter_if_not_declared(
     node, "use_realtime_priority", rclcpp::ParameterValue(false));
@@ -108,6 +133,10 @@ CollisionMonitor::on_activate(const rclcpp_lifecycle::State & /*state*/)
     state_pub_->on_activate();
   }
   collision_points_marker_pub_->on_activate();
+  statistics_pub_->on_activate();
+  if (decision_latency_pub_) {
+    decision_latency_pub_->on_activate();
+  }
 
   // Activating polygons
   for (std::shared_ptr<Polygon> polygon : polygons_) {
@@ -121,6 +150,20 @@ CollisionMonitor::on_activate(const rclcpp_lifecycle::State & /*state*/)
   // Activating main worker
   process_active_ = true;
 
+  // Take cmd_vel_in directly from the publishers of this process, such as a composed
+  // velocity smoother, running the checks inside their publish call
+  bool direct_in_process = false;
+  get_parameter("direct_in_process_cmd_vel", direct_in_process);
+  if (direct_in_process) {
+    direct_cmd_vel_in_topic_ = get_node_topics_interface()->resolve_topic_name(
+      get_parameter("cmd_vel_in_topic").as_string());
+    nav2_util::TwistRegistry::add(
+      direct_cmd_vel_in_topic_,
+      [this](std::unique_ptr<geometry_msgs::msg::TwistStamped> msg) {
+        cmdVelInCallbackStamped(geometry_msgs::msg::TwistStamped::SharedPtr(std::move(msg)));
+      });
+  }
+
   // Creating bond connection
   createBond();
 
@@ -132,11 +175,17 @@ CollisionMonitor::on_deactivate(const rclcpp_lifecycle::State & /*state*/)
 {
   RCLCPP_INFO(get_logger(), "Deactivating");
 
+  if (!direct_cmd_vel_in_topic_.empty()) {
+    nav2_util::TwistRegistry::remove(direct_cmd_vel_in_topic_);
+    direct_cmd_vel_in_topic_.clear();
+  }
+
   // Deactivating main worker
   process_active_ = false;
 
   // Reset action type to default after worker deactivating
   robot_action_prev_ = {DO_NOTHING, {-1.0, -1.0, -1.0}, ""};
+  cmd_vel_in_received_ = false;
 
   // Deactivating polygons
   for (std::shared_ptr<Polygon> polygon : polygons_) {
@@ -149,6 +198,10 @@ CollisionMonitor::on_deactivate(const rclcpp_lifecycle::State & /*state*/)
     state_pub_->on_deactivate();
   }
   collision_points_marker_pub_->on_deactivate();
+  statistics_pub_->on_deactivate();
+  if (decision_latency_pub_) {
+    decision_latency_pub_->on_deactivate();
+  }
 
   // Destroying bond connection
   destroyBond();
@@ -165,9 +218,13 @@ CollisionMonitor::on_cleanup(const rclcpp_lifecycle::State & /*state*/)
   cmd_vel_out_pub_.reset();
   state_pub_.reset();
   collision_points_marker_pub_.reset();
+  decision_latency_pub_.reset();
+  statistics_pub_.reset();
 
+  polygons_pool_.reset();
   polygons_.clear();
   sources_.clear();
+  statistics_.setSourceNames({});
 
   tf_listener_.reset();
   tf_buffer_.reset();
@@ -191,7 +248,12 @@ void CollisionMonitor::cmdVelInCallbackStamped(geometry_msgs::msg::TwistStamped:
     return;
   }
 
-  process({msg->twist.linear.x, msg->twist.linear.y, msg->twist.angular.z}, msg->header);
+  std::lock_guard<std::mutex> lock(process_mutex_);
+  cmd_vel_in_ = {msg->twist.linear.x, msg->twist.linear.y, msg->twist.angular.z};
+  cmd_vel_in_header_ = msg->header;
+  cmd_vel_in_received_ = true;
+
+  process(cmd_vel_in_, cmd_vel_in_header_);
 }
 
 void CollisionMonitor::cmdVelInCallbackUnstamped(geometry_msgs::msg::Twist::SharedPtr msg)
@@ -201,6 +263,25 @@ void CollisionMonitor::cmdVelInCallbackUnstamped(geometry_msgs::msg::Twist::Shar
   cmdVelInCallbackStamped(twist_stamped);
 }
 
+void CollisionMonitor::sourceDataCallback(const rclcpp::Time & stamp)
+{
+  std::lock_guard<std::mutex> lock(process_mutex_);
+  if (!process_active_ || !cmd_vel_in_received_) {
+    return;
+  }
+
+  // Reevaluate the latest command against the new data, publishing only a new stop
+  std_msgs::msg::Header header = cmd_vel_in_header_;
+  header.stamp = this->now();
+  process(cmd_vel_in_, header, true);
+
+  if (decision_latency_pub_->get_subscription_count() > 0) {
+    auto latency_msg = std::make_unique<std_msgs::msg::Float32>();
+    latency_msg->data = (this->now() - stamp).seconds();
+    decision_latency_pub_->publish(std::move(latency_msg));
+  }
+}
+
 void CollisionMonitor::publishVelocity(
   const Action & robot_action, const std_msgs::msg::Header & header)
 {
@@ -270,6 +351,15 @@ bool CollisionMonitor::getParameters(
   stop_pub_timeout_ =
     rclcpp::Duration::from_seconds(get_parameter("stop_pub_timeout").as_double());
 
+  nav2_util::declare_parameter_if_not_declared(
+    node, "process_on_source_data", rclcpp::ParameterValue(false));
+  process_on_source_data_ = get_parameter("process_on_source_data").as_bool();
+
+  nav2_util::declare_parameter_if_not_declared(
+    node, "polygon_threads", rclcpp::ParameterValue(0));
+  const int polygon_threads = get_parameter("polygon_threads").as_int();
+  polygons_pool_ = std::make_unique<nav2_util::ThreadPool>(std::max(polygon_threads, 0));
+
   if (!configurePolygons(base_frame_id, transform_tolerance)) {
     return false;
   }
@@ -385,6 +475,13 @@ bool CollisionMonitor::configureSources(
         ps->configure();
 
         sources_.push_back(ps);
+      } else if (source_type == "costmap") {
+        std::shared_ptr<CostmapSource> cs = std::make_shared<CostmapSource>(
+          node, source_name, tf_buffer_, base_frame_id, odom_frame_id,
+          transform_tolerance, source_timeout, base_shift_correction);
+        cs->configure();
+
+        sources_.push_back(cs);
       } else {  // Error if something else
         RCLCPP_ERROR(
           get_logger(),
@@ -393,6 +490,8 @@ bool CollisionMonitor::configureSources(
         return false;
       }
     }
+
+    statistics_.setSourceNames(source_names);
   } catch (const std::exception & ex) {
     RCLCPP_ERROR(get_logger(), "Error while getting parameters: %s", ex.what());
     return false;
@@ -401,8 +500,10 @@ bool CollisionMonitor::configureSources(
   return true;
 }
 
-void CollisionMonitor::process(const Velocity & cmd_vel_in, const std_msgs::msg::Header & header)
+void CollisionMonitor::process(
+  const Velocity & cmd_vel_in, const std_msgs::msg::Header & header, const bool stop_only)
 {
+  NAV2_TRACE_SCOPE("CollisionMonitor::process");
   // Current timestamp for all inner routines prolongation
   rclcpp::Time curr_time = this->now();
 
@@ -411,8 +512,12 @@ void CollisionMonitor::process(const Velocity & cmd_vel_in, const std_msgs::msg:
     return;
   }
 
+  statistics_.startCycle();
+
   // Points array collected from different data sources in a robot base frame
-  std::vector<Point> collision_points;
+  // kept between the cycles to reuse its capacity
+  std::vector<Point> & collision_points = collision_points_;
+  collision_points.clear();
 
   // By default - there is no action
   Action robot_action{DO_NOTHING, cmd_vel_in, ""};
@@ -420,11 +525,17 @@ void CollisionMonitor::process(const Velocity & cmd_vel_in, const std_msgs::msg:
   std::shared_ptr<Polygon> action_polygon;
 
   // Fill collision_points array from different data sources
-  for (std::shared_ptr<Source> source : sources_) {
+  for (size_t i = 0; i < sources_.size(); i++) {
+    const std::shared_ptr<Source> & source = sources_[i];
     if (source->getEnabled()) {
-      if (!source->getData(curr_time, collision_points) &&
-        source->getSourceTimeout().seconds() != 0.0)
-      {
+      const size_t points_num = collision_points.size();
+      const auto source_start = std::chrono::steady_clock::now();
+      const bool source_valid = source->getData(curr_time, collision_points);
+      statistics_.setSource(
+        i, collision_points.size() - points_num, CycleStatistics::elapsed(source_start));
+      if (source_valid) {
+        statistics_.setDataStamp(source->getDataStamp());
+      } else if (source->getSourceTimeout().seconds() != 0.0) {
         action_polygon = nullptr;
         robot_action.polygon_name = "invalid source";
         robot_action.action_type = STOP;
@@ -464,31 +575,65 @@ void CollisionMonitor::process(const Velocity & cmd_vel_in, const std_msgs::msg:
     collision_points_marker_pub_->publish(std::move(marker_array));
   }
 
-  for (std::shared_ptr<Polygon> polygon : polygons_) {
-    if (!polygon->getEnabled()) {
-      continue;
-    }
-    if (robot_action.action_type == STOP) {
-      // If robot already should stop, do nothing
-      break;
-    }
+  // Bucket the points once for all the polygons
+  const auto polygons_start = std::chrono::steady_clock::now();
+  collision_points_grid_.setPoints(collision_points);
 
+  // If robot already should stop, do nothing
+  if (robot_action.action_type != STOP) {
     // Update polygon coordinates
-    polygon->updatePolygon(cmd_vel_in);
+    for (std::shared_ptr<Polygon> polygon : polygons_) {
+      if (polygon->getEnabled()) {
+        polygon->updatePolygon(cmd_vel_in);
+      }
+    }
 
-    const ActionType at = polygon->getActionType();
-    if (at == STOP || at == SLOWDOWN || at == LIMIT) {
-      // Process STOP/SLOWDOWN for the selected polygon
-      if (processStopSlowdownLimit(polygon, collision_points, cmd_vel_in, robot_action)) {
-        action_polygon = polygon;
+    // Evaluate the polygons independently of each other
+    polygon_actions_.resize(polygons_.size());
+    polygon_triggered_.resize(polygons_.size());
+    polygons_pool_->parallelFor(
+      polygons_.size(), [this, &cmd_vel_in](size_t i) {
+        const std::shared_ptr<Polygon> & polygon = polygons_[i];
+        polygon_actions_[i] = Action{DO_NOTHING, cmd_vel_in, ""};
+        polygon_triggered_[i] = false;
+        if (!polygon->getEnabled()) {
+          return;
+        }
+
+        const ActionType at = polygon->getActionType();
+        if (at == STOP || at == SLOWDOWN || at == LIMIT) {
+          // Process STOP/SLOWDOWN for the selected polygon
+          polygon_triggered_[i] = processStopSlowdownLimit(
+            polygon, collision_points_grid_, cmd_vel_in, polygon_actions_[i]);
+        } else if (at == APPROACH) {
+          // Process APPROACH for the selected polygon
+          polygon_triggered_[i] = processApproach(
+            polygon, collision_points_grid_, cmd_vel_in, polygon_actions_[i]);
+        }
+      });
+
+    // Select the safest action, the first polygon winning ties as when evaluated in order
+    for (size_t i = 0; i < polygons_.size(); i++) {
+      if (!polygon_triggered_[i]) {
+        continue;
       }
-    } else if (at == APPROACH) {
-      // Process APPROACH for the selected polygon
-      if (processApproach(polygon, collision_points, cmd_vel_in, robot_action)) {
-        action_polygon = polygon;
+      const Action & polygon_action = polygon_actions_[i];
+      if (polygon_action.action_type == STOP || polygon_action.req_vel < robot_action.req_vel) {
+        robot_action = polygon_action;
+        action_polygon = polygons_[i];
+      }
+      if (robot_action.action_type == STOP) {
+        break;
       }
     }
   }
+  statistics_.setPolygonsDuration(CycleStatistics::elapsed(polygons_start));
+
+  if (stop_only && !(robot_action.req_vel.isZero() && !robot_action_prev_.req_vel.isZero())) {
+    // Other actions are applied to the next command
+    publishStatistics(curr_time);
+    return;
+  }
 
   if (robot_action.polygon_name != robot_action_prev_.polygon_name) {
     // Report changed robot behavior
@@ -497,16 +642,34 @@ void CollisionMonitor::process(const Velocity & cmd_vel_in, const std_msgs::msg:
 
   // Publish required robot velocity
   publishVelocity(robot_action, header);
+  if (!stop_only && (header.stamp.sec != 0 || header.stamp.nanosec != 0)) {
+    statistics_.setCommandLatency(this->now() - rclcpp::Time(header.stamp));
+  }
 
   // Publish polygons for better visualization
   publishPolygons();
 
   robot_action_prev_ = robot_action;
+
+  publishStatistics(curr_time);
+}
+
+void CollisionMonitor::publishStatistics(const rclcpp::Time & curr_time)
+{
+  statistics_.finishCycle(this->now());
+
+  if (statistics_pub_->get_subscription_count() > 0) {
+    auto statistics_msg =
+      std::make_unique<nav2_msgs::msg::CollisionMonitorStatistics>(statistics_.getMessage());
+    statistics_msg->header.stamp = curr_time;
+    statistics_msg->header.frame_id = get_parameter("base_frame_id").as_string();
+    statistics_pub_->publish(std::move(statistics_msg));
+  }
 }
 
 bool CollisionMonitor::processStopSlowdownLimit(
   const std::shared_ptr<Polygon> polygon,
-  const std::vector<Point> & collision_points,
+  const PointGrid & collision_points,
   const Velocity & velocity,
   Action & robot_action) const
 {
@@ -514,7 +677,9 @@ bool CollisionMonitor::processStopSlowdownLimit(
     return false;
   }
 
-  if (polygon->getPointsInside(collision_points) >= polygon->getMinPoints()) {
+  // Stop counting once the polygon is triggered
+  const int min_points = polygon->getMinPoints();
+  if (polygon->getPointsInside(collision_points, Pose{0.0, 0.0, 0.0}, min_points) >= min_points) {
     if (polygon->getActionType() == STOP) {
       // Setting up zero velocity for STOP model
       robot_action.polygon_name = polygon->getName();
@@ -561,7 +726,7 @@ bool CollisionMonitor::processStopSlowdownLimit(
 
 bool CollisionMonitor::processApproach(
   const std::shared_ptr<Polygon> polygon,
-  const std::vector<Point> & collision_points,
+  const PointGrid & collision_points,
   const Velocity & velocity,
   Action & robot_action) const
 {
@@ -0,0 +1,215 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_collision_monitor/costmap_source.hpp"
+
+#include <functional>
+
+#include "nav2_costmap_2d/cost_values.hpp"
+#include "nav2_util/node_utils.hpp"
+
+namespace nav2_collision_monitor
+{
+
+CostmapSource::CostmapSource(
+  const nav2_util::LifecycleNode::WeakPtr & node,
+  const std::string & source_name,
+  const std::shared_ptr<tf2_ros::Buffer> tf_buffer,
+  const std::string & base_frame_id,
+  const std::string & global_frame_id,
+  const tf2::Duration & transform_tolerance,
+  const rclcpp::Duration & source_timeout,
+  const bool base_shift_correction)
+: Source(
+    node, source_name, tf_buffer, base_frame_id, global_frame_id,
+    transform_tolerance, source_timeout, base_shift_correction),
+  costmap_received_(false), size_x_(0), size_y_(0),
+  resolution_(0.0), origin_x_(0.0), origin_y_(0.0), points_changed_(true)
+{
+  RCLCPP_INFO(logger_, "[%s]: Creating CostmapSource", source_name_.c_str());
+}
+
+CostmapSource::~CostmapSource()
+{
+  RCLCPP_INFO(logger_, "[%s]: Destroying CostmapSource", source_name_.c_str());
+  costmap_sub_.reset();
+  costmap_update_sub_.reset();
+}
+
+void CostmapSource::configure()
+{
+  Source::configure();
+  auto node = node_.lock();
+  if (!node) {
+    throw std::runtime_error{"Failed to lock node"};
+  }
+
+  std::string source_topic;
+
+  getParameters(source_topic);
+
+  // Same QoS as the costmap publisher
+  costmap_sub_ = node->create_subscription<nav2_msgs::msg::Costmap>(
+    source_topic, rclcpp::QoS(rclcpp::KeepLast(1)).transient_local().reliable(),
+    std::bind(&CostmapSource::costmapCallback, this, std::placeholders::_1));
+  costmap_update_sub_ = node->create_subscription<nav2_msgs::msg::CostmapUpdate>(
+    source_topic + "_updates", rclcpp::QoS(rclcpp::KeepLast(10)).transient_local().reliable(),
+    std::bind(&CostmapSource::costmapUpdateCallback, this, std::placeholders::_1));
+}
+
+bool CostmapSource::getData(
+  const rclcpp::Time & curr_time,
+  std::vector<Point> & data)
+{
+  // Ignore data from the source if it is not being published yet or
+  // not being published for a long time
+  if (!costmap_received_) {
+    return false;
+  }
+  if (!sourceValid(header_.stamp, curr_time)) {
+    return false;
+  }
+
+  tf2::Transform tf_transform;
+  if (!getTransform(curr_time, header_, tf_transform)) {
+    return false;
+  }
+
+  if (points_changed_ || !(tf_transform == cached_transform_)) {
+    // Transform the cell centers from costmap frame -> to base frame
+    const tf2::Matrix3x3 & basis = tf_transform.getBasis();
+    const double r00 = basis[0][0], r01 = basis[0][1];
+    const double r10 = basis[1][0], r11 = basis[1][1];
+    const double tx = tf_transform.getOrigin().x();
+    const double ty = tf_transform.getOrigin().y();
+    base_points_.resize(points_.size());
+    for (size_t i = 0; i < points_.size(); i++) {
+      base_points_[i].x = r00 * points_[i].x + r01 * points_[i].y + tx;
+      base_points_[i].y = r10 * points_[i].x + r11 * points_[i].y + ty;
+    }
+    cached_transform_ = tf_transform;
+    points_changed_ = false;
+  }
+
+  // Refill data array
+  data.insert(data.end(), base_points_.begin(), base_points_.end());
+  data_stamp_ = header_.stamp;
+  return true;
+}
+
+void CostmapSource::getParameters(std::string & source_topic)
+{
+  auto node = node_.lock();
+  if (!node) {
+    throw std::runtime_error{"Failed to lock node"};
+  }
+
+  getCommonParameters(source_topic);
+
+  nav2_util::declare_parameter_if_not_declared(
+    node, source_name_ + ".cost_threshold",
+    rclcpp::ParameterValue(static_cast<int>(nav2_costmap_2d::LETHAL_OBSTACLE)));
+  cost_threshold_ = static_cast<unsigned char>(
+    node->get_parameter(source_name_ + ".cost_threshold").as_int());
+  nav2_util::declare_parameter_if_not_declared(
+    node, source_name_ + ".treat_unknown_as_obstacle", rclcpp::ParameterValue(false));
+  treat_unknown_as_obstacle_ =
+    node->get_parameter(source_name_ + ".treat_unknown_as_obstacle").as_bool();
+}
+
+void CostmapSource::setCost(unsigned int index, unsigned char cost)
+{
+  costs_[index] = cost;
+  const bool occupied = cost == nav2_costmap_2d::NO_INFORMATION ?
+    treat_unknown_as_obstacle_ : cost >= cost_threshold_;
+
+  if (occupied && cell_points_[index] < 0) {
+    // Add the center of the cell
+    cell_points_[index] = static_cast<int32_t>(points_.size());
+    points_.push_back(
+      {origin_x_ + (index % size_x_ + 0.5) * resolution_,
+        origin_y_ + (index / size_x_ + 0.5) * resolution_});
+    point_cells_.push_back(index);
+    points_changed_ = true;
+  } else if (!occupied && cell_points_[index] >= 0) {
+    // Remove the center of the cell, moving the last point in its place
+    const int32_t point = cell_points_[index];
+    points_[point] = points_.back();
+    point_cells_[point] = point_cells_.back();
+    cell_points_[point_cells_[point]] = point;
+    points_.pop_back();
+    point_cells_.pop_back();
+    cell_points_[index] = -1;
+    points_changed_ = true;
+  }
+}
+
+void CostmapSource::costmapCallback(nav2_msgs::msg::Costmap::ConstSharedPtr msg)
+{
+  const auto & metadata = msg->metadata;
+  if (msg->data.size() != static_cast<size_t>(metadata.size_x) * metadata.size_y) {
+    RCLCPP_WARN(
+      logger_, "[%s]: Costmap data does not match its size, ignoring", source_name_.c_str());
+    return;
+  }
+
+  // Start over from the whole costmap
+  size_x_ = metadata.size_x;
+  size_y_ = metadata.size_y;
+  resolution_ = metadata.resolution;
+  origin_x_ = metadata.origin.position.x;
+  origin_y_ = metadata.origin.position.y;
+  costs_.assign(msg->data.size(), nav2_costmap_2d::FREE_SPACE);
+  cell_points_.assign(msg->data.size(), -1);
+  points_.clear();
+  point_cells_.clear();
+  points_changed_ = true;
+  for (unsigned int i = 0; i < msg->data.size(); i++) {
+    setCost(i, msg->data[i]);
+  }
+
+  header_ = msg->header;
+  costmap_received_ = true;
+  notifyDataReceived(header_.stamp);
+}
+
+void CostmapSource::costmapUpdateCallback(nav2_msgs::msg::CostmapUpdate::ConstSharedPtr msg)
+{
+  if (!costmap_received_) {
+    return;
+  }
+  if (msg->x + msg->size_x > size_x_ || msg->y + msg->size_y > size_y_ ||
+    msg->data.size() != static_cast<size_t>(msg->size_x) * msg->size_y)
+  {
+    RCLCPP_WARN(
+      logger_, "[%s]: Costmap update outside of the costmap, ignoring", source_name_.c_str());
+    return;
+  }
+
+  // Only the cells changing from or to occupied move the points
+  for (unsigned int y = 0; y < msg->size_y; y++) {
+    const unsigned int row = (msg->y + y) * size_x_ + msg->x;
+    for (unsigned int x = 0; x < msg->size_x; x++) {
+      const unsigned char cost = msg->data[y * msg->size_x + x];
+      if (costs_[row + x] != cost) {
+        setCost(row + x, cost);
+      }
+    }
+  }
+
+  header_ = msg->header;
+  notifyDataReceived(header_.stamp);
+}
+
+}  // namespace nav2_collision_monitor
@@ -0,0 +1,147 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_collision_monitor/cycle_statistics.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "diagnostic_msgs/msg/diagnostic_status.hpp"
+
+namespace nav2_collision_monitor
+{
+
+void DurationHistogram::add(const rclcpp::Duration & duration)
+{
+  const double ms = duration.seconds() * 1e3;
+  const size_t bucket = std::lower_bound(BOUNDS.begin(), BOUNDS.end(), ms) - BOUNDS.begin();
+  buckets_[bucket]++;
+  count_++;
+  sum_ += ms;
+  max_ = std::max(max_, ms);
+}
+
+void DurationHistogram::fill(
+  const std::string & name, diagnostic_updater::DiagnosticStatusWrapper & stat) const
+{
+  stat.addf(name + " mean (ms)", "%.3f", count_ > 0 ? sum_ / count_ : 0.0);
+  stat.addf(name + " max (ms)", "%.3f", max_);
+  for (size_t i = 0; i < BOUNDS.size(); i++) {
+    stat.addf(name + " <= " + std::to_string(BOUNDS[i]) + " ms", "%u", buckets_[i]);
+  }
+  stat.addf(name + " > " + std::to_string(BOUNDS.back()) + " ms", "%u", buckets_.back());
+}
+
+void DurationHistogram::reset()
+{
+  buckets_.fill(0);
+  count_ = 0;
+  sum_ = 0.0;
+  max_ = 0.0;
+}
+
+void CycleStatistics::setSourceNames(const std::vector<std::string> & source_names)
+{
+  source_names_ = source_names;
+  source_points_sums_.assign(source_names_.size(), 0.0);
+  source_durations_sums_.assign(source_names_.size(), 0.0);
+}
+
+void CycleStatistics::startCycle()
+{
+  cycle_start_ = std::chrono::steady_clock::now();
+  msg_.source_points.assign(source_names_.size(), 0);
+  msg_.source_durations.assign(source_names_.size(), builtin_interfaces::msg::Duration());
+  msg_.polygons_duration = builtin_interfaces::msg::Duration();
+  msg_.data_age = builtin_interfaces::msg::Duration();
+  msg_.command_latency = builtin_interfaces::msg::Duration();
+  data_used_ = false;
+}
+
+void CycleStatistics::setSource(size_t index, size_t points, const rclcpp::Duration & duration)
+{
+  msg_.source_points[index] = points;
+  msg_.source_durations[index] = duration;
+  source_points_sums_[index] += points;
+  source_durations_sums_[index] += duration.seconds();
+}
+
+void CycleStatistics::setDataStamp(const rclcpp::Time & stamp)
+{
+  if (!data_used_ || stamp < oldest_stamp_) {
+    oldest_stamp_ = stamp;
+    data_used_ = true;
+  }
+}
+
+void CycleStatistics::setPolygonsDuration(const rclcpp::Duration & duration)
+{
+  msg_.polygons_duration = duration;
+  polygons_histogram_.add(duration);
+}
+
+void CycleStatistics::setCommandLatency(const rclcpp::Duration & latency)
+{
+  msg_.command_latency = latency;
+  command_latency_histogram_.add(latency);
+}
+
+void CycleStatistics::finishCycle(const rclcpp::Time & curr_time)
+{
+  const rclcpp::Duration total = elapsed(cycle_start_);
+  msg_.total = total;
+  total_histogram_.add(total);
+
+  if (data_used_) {
+    const rclcpp::Duration data_age = curr_time - oldest_stamp_;
+    msg_.data_age = data_age;
+    data_age_histogram_.add(data_age);
+  }
+}
+
+void CycleStatistics::fillDiagnostics(diagnostic_updater::DiagnosticStatusWrapper & stat)
+{
+  const unsigned int cycles = total_histogram_.count();
+  if (cycles == 0) {
+    stat.summary(diagnostic_msgs::msg::DiagnosticStatus::OK, "No cycles since the last report");
+  } else {
+    stat.summaryf(
+      diagnostic_msgs::msg::DiagnosticStatus::OK, "%u cycles since the last report", cycles);
+  }
+
+  total_histogram_.fill("Cycle", stat);
+  polygons_histogram_.fill("Polygons", stat);
+  data_age_histogram_.fill("Data age", stat);
+  if (command_latency_histogram_.count() > 0) {
+    command_latency_histogram_.fill("Command latency", stat);
+  }
+  for (size_t i = 0; i < source_names_.size(); i++) {
+    stat.addf(
+      source_names_[i] + " mean points", "%.1f",
+      cycles > 0 ? source_points_sums_[i] / cycles : 0.0);
+    stat.addf(
+      source_names_[i] + " mean getData (ms)", "%.3f",
+      cycles > 0 ? source_durations_sums_[i] * 1e3 / cycles : 0.0);
+  }
+
+  total_histogram_.reset();
+  polygons_histogram_.reset();
+  data_age_histogram_.reset();
+  command_latency_histogram_.reset();
+  std::fill(source_points_sums_.begin(), source_points_sums_.end(), 0.0);
+  std::fill(source_durations_sums_.begin(), source_durations_sums_.end(), 0.0);
+}
+
+}  // namespace nav2_collision_monitor
@@ -0,0 +1,79 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_collision_monitor/point_grid.hpp"
+
+namespace nav2_collision_monitor
+{
+
+// Average number of points per cell the grid is sized for
+static constexpr double POINTS_PER_CELL = 4.0;
+
+void PointGrid::setPoints(const std::vector<Point> & points)
+{
+  points_.resize(points.size());
+  xs_.resize(points.size());
+  ys_.resize(points.size());
+  if (points.empty()) {
+    size_x_ = 0;
+    size_y_ = 0;
+    cell_starts_.clear();
+    return;
+  }
+
+  // Bounding box of the points
+  origin_ = end_ = points.front();
+  for (const Point & point : points) {
+    origin_.x = std::min(origin_.x, point.x);
+    origin_.y = std::min(origin_.y, point.y);
+    end_.x = std::max(end_.x, point.x);
+    end_.y = std::max(end_.y, point.y);
+  }
+
+  // Square cells holding a few points each on average, for points spread over the box.
+  // Bounded by the longest side so that points along a line still get a row of cells.
+  const double width = end_.x - origin_.x;
+  const double height = end_.y - origin_.y;
+  const double cells = std::max(1.0, points.size() / POINTS_PER_CELL);
+  cell_size_ = std::max(
+    {std::sqrt(width * height / cells), std::max(width, height) / cells, 1e-6});
+  size_x_ = static_cast<int>(width / cell_size_) + 1;
+  size_y_ = static_cast<int>(height / cell_size_) + 1;
+
+  // Counting sort of the points by cell
+  cell_starts_.assign(size_x_ * size_y_ + 1, 0);
+  point_cells_.resize(points.size());
+  for (size_t i = 0; i < points.size(); i++) {
+    const unsigned int cell = toCell(points[i].y, origin_.y, size_y_) * size_x_ +
+      toCell(points[i].x, origin_.x, size_x_);
+    point_cells_[i] = cell;
+    cell_starts_[cell + 1]++;
+  }
+  for (size_t cell = 1; cell < cell_starts_.size(); cell++) {
+    cell_starts_[cell] += cell_starts_[cell - 1];
+  }
+  for (size_t i = 0; i < points.size(); i++) {
+    // Use the start of each cell as its insertion cursor, restored below
+    const unsigned int index = cell_starts_[point_cells_[i]]++;
+    points_[index] = points[i];
+    xs_[index] = points[i].x;
+    ys_[index] = points[i].y;
+  }
+  for (size_t cell = cell_starts_.size() - 1; cell > 0; cell--) {
+    cell_starts_[cell] = cell_starts_[cell - 1];
+  }
+  cell_starts_[0] = 0;
+}
+
+}  // namespace nav2_collision_monitor
@@ -14,6 +14,8 @@
 
 #include "nav2_collision_monitor/pointcloud.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <functional>
 
 #include "sensor_msgs/point_cloud2_iterator.hpp"
@@ -84,21 +86,39 @@ bool PointCloud::getData(
     return false;
   }
 
-  sensor_msgs::PointCloud2ConstIterator<float> iter_x(*data_, "x");
-  sensor_msgs::PointCloud2ConstIterator<float> iter_y(*data_, "y");
-  sensor_msgs::PointCloud2ConstIterator<float> iter_z(*data_, "z");
-
-  // Refill data array with PointCloud points in base frame
-  for (; iter_x != iter_x.end(); ++iter_x, ++iter_y, ++iter_z) {
-    // Transform point coordinates from source frame -> to base frame
-    tf2::Vector3 p_v3_s(*iter_x, *iter_y, *iter_z);
-    tf2::Vector3 p_v3_b = tf_transform * p_v3_s;
-
-    // Refill data array
-    if (p_v3_b.z() >= min_height_ && p_v3_b.z() <= max_height_) {
-      data.push_back({p_v3_b.x(), p_v3_b.y()});
+  if (data_ != cached_data_ || !(tf_transform == cached_transform_)) {
+    // Transform point coordinates from source frame -> to base frame and filter them
+    // by height in a single pass, with the transform unpacked out of the loop
+    const tf2::Matrix3x3 & basis = tf_transform.getBasis();
+    const tf2::Vector3 & origin = tf_transform.getOrigin();
+    const double r00 = basis[0][0], r01 = basis[0][1], r02 = basis[0][2];
+    const double r10 = basis[1][0], r11 = basis[1][1], r12 = basis[1][2];
+    const double r20 = basis[2][0], r21 = basis[2][1], r22 = basis[2][2];
+
+    sensor_msgs::PointCloud2ConstIterator<float> iter_x(*data_, "x");
+    sensor_msgs::PointCloud2ConstIterator<float> iter_y(*data_, "y");
+    sensor_msgs::PointCloud2ConstIterator<float> iter_z(*data_, "z");
+
+    // Keeps the capacity of the previous clouds
+    points_.clear();
+    for (; iter_x != iter_x.end(); ++iter_x, ++iter_y, ++iter_z) {
+      const double x = *iter_x, y = *iter_y, z = *iter_z;
+      const double z_b = r20 * x + r21 * y + r22 * z + origin.z();
+      if (z_b >= min_height_ && z_b <= max_height_) {
+        points_.push_back(
+          {r00 * x + r01 * y + r02 * z + origin.x(), r10 * x + r11 * y + r12 * z + origin.y()});
+      }
     }
+    if (downsampling_resolution_ > 0.0) {
+      downsample(points_);
+    }
+    cached_data_ = data_;
+    cached_transform_ = tf_transform;
   }
+
+  // Refill data array
+  data.insert(data.end(), points_.begin(), points_.end());
+  data_stamp_ = data_->header.stamp;
   return true;
 }
 
@@ -117,11 +137,55 @@ void PointCloud::getParameters(std::string & source_topic)
   nav2_util::declare_parameter_if_not_declared(
     node, source_name_ + ".max_height", rclcpp::ParameterValue(0.5));
   max_height_ = node->get_parameter(source_name_ + ".max_height").as_double();
+  nav2_util::declare_parameter_if_not_declared(
+    node, source_name_ + ".downsampling_resolution", rclcpp::ParameterValue(0.0));
+  downsampling_resolution_ =
+    node->get_parameter(source_name_ + ".downsampling_resolution").as_double();
+}
+
+void PointCloud::downsample(std::vector<Point> & points)
+{
+  // Open addressing table of the occupied cells, kept at most half full.
+  // Slots written in previous calls are told apart by their generation, so that the table
+  // does not need to be cleared.
+  size_t capacity = 16;
+  while (capacity < 2 * points.size()) {
+    capacity *= 2;
+  }
+  if (cells_.size() < capacity) {
+    cells_.assign(capacity, Cell{0, 0});
+    generation_ = 0;
+  }
+  if (++generation_ == 0) {
+    std::fill(cells_.begin(), cells_.end(), Cell{0, 0});
+    generation_ = 1;
+  }
+  const size_t mask = capacity - 1;
+
+  // Keep the first point of each cell, compacting the array in place
+  size_t kept = 0;
+  for (size_t i = 0; i < points.size(); i++) {
+    const int64_t x = static_cast<int64_t>(std::floor(points[i].x / downsampling_resolution_));
+    const int64_t y = static_cast<int64_t>(std::floor(points[i].y / downsampling_resolution_));
+    const uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) |
+      static_cast<uint32_t>(y);
+    const uint64_t hash = key * 0x9E3779B97F4A7C15ull;
+    size_t slot = (hash ^ (hash >> 32)) & mask;
+    while (cells_[slot].generation == generation_ && cells_[slot].key != key) {
+      slot = (slot + 1) & mask;
+    }
+    if (cells_[slot].generation != generation_) {
+      cells_[slot] = Cell{key, generation_};
+      points[kept++] = points[i];
+    }
+  }
+  points.resize(kept);
 }
 
 void PointCloud::dataCallback(sensor_msgs::msg::PointCloud2::ConstSharedPtr msg)
 {
   data_ = msg;
+  notifyDataReceived(msg->header.stamp);
 }
 
 }  // namespace nav2_collision_monitor
@@ -14,7 +14,10 @@
 
 #include "nav2_collision_monitor/polygon.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <exception>
+#include <limits>
 #include <utility>
 
 #include "geometry_msgs/msg/point.hpp"
@@ -25,11 +28,13 @@
 #include "nav2_util/robot_utils.hpp"
 #include "nav2_util/array_parser.hpp"
 
-#include "nav2_collision_monitor/kinematics.hpp"
 
 namespace nav2_collision_monitor
 {
 
+// Tolerance on velocities and lengths below which a motion or an edge is degenerate
+static constexpr double EPSILON = 1e-9;
+
 Polygon::Polygon(
   const nav2_util::LifecycleNode::WeakPtr & node,
   const std::string & polygon_name,
@@ -65,6 +70,7 @@ bool Polygon::configure()
   if (!getParameters(polygon_sub_topic, polygon_pub_topic, footprint_topic)) {
     return false;
   }
+  updateEdges();
 
   createSubscription(polygon_sub_topic);
 
@@ -191,6 +197,7 @@ void Polygon::updatePolygon(const Velocity & /*cmd_vel_in*/)
       p_s.y = footprint_vec[i].y;
       polygon_.polygon.points[i] = p_s;
     }
+    updateEdges();
   } else if (!polygon_.header.frame_id.empty() && polygon_.header.frame_id != base_frame_id_) {
     // Polygon is published in another frame: correct poly_ vertices to the latest frame state
     std::size_t new_size = polygon_.polygon.points.size();
@@ -215,6 +222,7 @@ void Polygon::updatePolygon(const Velocity & /*cmd_vel_in*/)
       // Fill poly_ array
       poly_[i] = {p_v3_b.x(), p_v3_b.y()};
     }
+    updateEdges();
   }
 }
 
@@ -229,34 +237,102 @@ int Polygon::getPointsInside(const std::vector<Point> & points) const
   return num;
 }
 
+int Polygon::getPointsInside(
+  const PointGrid & points, const Pose & pose, int max_points) const
+{
+  if (poly_.empty()) {
+    return 0;
+  }
+
+  if (pose.x == 0.0 && pose.y == 0.0 && pose.theta == 0.0) {
+    // The polygon in place, with its precomputed edges
+    return points.countPointRanges(
+      edges_.getMin(), edges_.getMax(),
+      [this](const double * xs, const double * ys, size_t size) {
+        return edges_.countPointsInside(xs, ys, size);
+      }, max_points);
+  }
+
+  // Vertices of the polygon moved to the pose, and their bounding box
+  const double cos_theta = std::cos(pose.theta);
+  const double sin_theta = std::sin(pose.theta);
+  std::vector<Point> poly(poly_.size());
+  Point min{std::numeric_limits<double>::max(), std::numeric_limits<double>::max()};
+  Point max{std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest()};
+  for (size_t i = 0; i < poly_.size(); i++) {
+    poly[i].x = pose.x + poly_[i].x * cos_theta - poly_[i].y * sin_theta;
+    poly[i].y = pose.y + poly_[i].x * sin_theta + poly_[i].y * cos_theta;
+    min.x = std::min(min.x, poly[i].x);
+    min.y = std::min(min.y, poly[i].y);
+    max.x = std::max(max.x, poly[i].x);
+    max.y = std::max(max.y, poly[i].y);
+  }
+
+  return points.countPoints(
+    min, max, [&poly](const Point & point) {return isPointInside(point, poly);}, max_points);
+}
+
+double Polygon::getCollisionTime(
+  const PointGrid & collision_points,
+  const Velocity & velocity) const
+{
+  // In the frame of the initial robot pose, the obstacles are still and the robot origin
+  // moves by at most |v| * time_before_collision_, so only the points closer than that
+  // to the polygon can be hit
+  std::vector<Point> poly;
+  getPolygon(poly);
+  double radius = 0.0;
+  for (const Point & vertex : poly) {
+    radius = std::max(radius, std::hypot(vertex.x, vertex.y));
+  }
+  const double reach = radius + std::hypot(velocity.x, velocity.y) * time_before_collision_;
+  const double reach_sq = reach * reach;
+
+  std::vector<Point> points;
+  collision_points.forEachPoint(
+    {-reach, -reach}, {reach, reach}, [&points, reach_sq](const Point & point) {
+      if (point.x * point.x + point.y * point.y <= reach_sq) {
+        points.push_back(point);
+      }
+    });
+  return getCollisionTime(points, velocity);
+}
+
 double Polygon::getCollisionTime(
   const std::vector<Point> & collision_points,
   const Velocity & velocity) const
 {
-  // Initial robot pose is {0,0} in base_footprint coordinates
-  Pose pose = {0.0, 0.0, 0.0};
-  Velocity vel = velocity;
+  // Each point toggles between outside and inside the polygon at each crossing
+  // of its boundary, so the collision occurs at the first crossing leaving
+  // min_points_ points inside the polygon
+  int points_inside = 0;
+  std::vector<std::pair<double, int>> crossings;
+  std::vector<double> times;
+  for (const Point & point : collision_points) {
+    bool inside = isPointInside(point);
+    if (inside) {
+      points_inside++;
+    }
 
-  // Array of points transformed to the frame concerned with pose on each simulation step
-  std::vector<Point> points_transformed = collision_points;
+    times.clear();
+    getCrossingTimes(point, velocity, time_before_collision_, times);
+    std::sort(times.begin(), times.end());
+    for (const double time : times) {
+      inside = !inside;
+      crossings.emplace_back(time, inside ? 1 : -1);
+    }
+  }
 
   // Check static polygon
-  if (getPointsInside(points_transformed) >= min_points_) {
+  if (points_inside >= min_points_) {
     return 0.0;
   }
 
-  // Robot movement simulation
-  for (double time = 0.0; time <= time_before_collision_; time += simulation_time_step_) {
-    // Shift the robot pose towards to the vel during simulation_time_step_ time interval
-    // NOTE: vel is changing during the simulation
-    projectState(simulation_time_step_, pose, vel);
-    // Transform collision_points to the frame concerned with current robot pose
-    points_transformed = collision_points;
-    transformPoints(pose, points_transformed);
-    // If the collision occurred on this stage, return the actual time before a collision
-    // as if robot was moved with given velocity
-    if (getPointsInside(points_transformed) >= min_points_) {
-      return time;
+  std::sort(crossings.begin(), crossings.end());
+  for (const auto & crossing : crossings) {
+    points_inside += crossing.second;
+    if (points_inside >= min_points_) {
+      return crossing.first;
     }
   }
 
@@ -264,6 +340,81 @@ double Polygon::getCollisionTime(
   return -1.0;
 }
 
+void Polygon::getCrossingTimes(
+  const Point & point, const Velocity & velocity, double max_time,
+  std::vector<double> & times) const
+{
+  const size_t poly_size = poly_.size();
+  if (std::fabs(velocity.tw) < EPSILON) {
+    // The point moves along a line at the opposite of the robot velocity: p(t) = p - v * t,
+    // crossing the edge a + s * e when both t and s are within their bounds
+    const Point dir{-velocity.x, -velocity.y};
+    for (size_t i = 0; i < poly_size; i++) {
+      const Point & a = poly_[i];
+      const Point & b = poly_[(i + 1) % poly_size];
+      const Point edge{b.x - a.x, b.y - a.y};
+      const double denom = dir.x * edge.y - dir.y * edge.x;
+      if (std::fabs(denom) < EPSILON) {
+        continue;
+      }
+      const Point ap{a.x - point.x, a.y - point.y};
+      const double t = (ap.x * edge.y - ap.y * edge.x) / denom;
+      const double s = (ap.x * dir.y - ap.y * dir.x) / denom;
+      // Half-open edges, so that crossing at a vertex counts once
+      if (s >= 0.0 && s < 1.0 && t > 0.0 && t <= max_time) {
+        times.push_back(t);
+      }
+    }
+    return;
+  }
+
+  // The point rotates around the instantaneous center of rotation c, on a circle of radius r
+  const Point center{-velocity.y / velocity.tw, velocity.x / velocity.tw};
+  const Point rel{point.x - center.x, point.y - center.y};
+  const double radius_sq = rel.x * rel.x + rel.y * rel.y;
+  const double start_angle = std::atan2(rel.y, rel.x);
+  for (size_t i = 0; i < poly_size; i++) {
+    const Point & a = poly_[i];
+    const Point & b = poly_[(i + 1) % poly_size];
+    const Point edge{b.x - a.x, b.y - a.y};
+    const Point ac{a.x - center.x, a.y - center.y};
+    // |a + s * e - c|^2 = r^2
+    const double qa = edge.x * edge.x + edge.y * edge.y;
+    const double qb = 2.0 * (edge.x * ac.x + edge.y * ac.y);
+    const double qc = ac.x * ac.x + ac.y * ac.y - radius_sq;
+    const double disc = qb * qb - 4.0 * qa * qc;
+    // Tangent arcs touch the edge without crossing it
+    if (qa < EPSILON || disc <= 0.0) {
+      continue;
+    }
+    const double disc_sqrt = std::sqrt(disc);
+    for (const double s : {(-qb - disc_sqrt) / (2.0 * qa), (-qb + disc_sqrt) / (2.0 * qa)}) {
+      if (s >= 0.0 && s < 1.0) {
+        addArcCrossingTimes(
+          start_angle, std::atan2(ac.y + s * edge.y, ac.x + s * edge.x), velocity.tw,
+          max_time, times);
+      }
+    }
+  }
+}
+
+void Polygon::addArcCrossingTimes(
+  double start_angle, double angle, double angular_velocity, double max_time,
+  std::vector<double> & times)
+{
+  // Angle covered until reaching the given angle, rotating at -angular_velocity
+  double covered = angular_velocity > 0.0 ? start_angle - angle : angle - start_angle;
+  covered = std::fmod(covered, 2.0 * M_PI);
+  if (covered <= 0.0) {
+    covered += 2.0 * M_PI;
+  }
+
+  const double period = 2.0 * M_PI / std::fabs(angular_velocity);
+  for (double time = covered / std::fabs(angular_velocity); time <= max_time; time += period) {
+    times.push_back(time);
+  }
+}
+
 void Polygon::publish()
 {
   if (!visualize_) {
@@ -503,6 +654,7 @@ void Polygon::updatePolygon(geometry_msgs::msg::PolygonStamped::ConstSharedPtr m
     // Fill poly_ array
     poly_[i] = {p_v3_b.x(), p_v3_b.y()};
   }
+  updateEdges();
 
   // Store incoming polygon for further (possible) poly_ vertices corrections
   // from PolygonStamped frame -> to base frame
@@ -538,14 +690,19 @@ void Polygon::polygonCallback(geometry_msgs::msg::PolygonStamped::ConstSharedPtr
   updatePolygon(msg);
 }
 
-inline bool Polygon::isPointInside(const Point & point) const
+bool Polygon::isPointInside(const Point & point) const
+{
+  return edges_.isPointInside(point);
+}
+
+bool Polygon::isPointInside(const Point & point, const std::vector<Point> & poly)
 {
   // Adaptation of Shimrat, Moshe. "Algorithm 112: position of point relative to polygon."
   // Communications of the ACM 5.8 (1962): 434.
   // Implementation of ray crossings algorithm for point in polygon task solving.
   // Y coordinate is fixed. Moving the ray on X+ axis starting from given point.
   // Odd number of intersections with polygon boundaries means the point is inside polygon.
-  const int poly_size = poly_.size();
+  const int poly_size = poly.size();
   int i, j;  // Polygon vertex iterators
   bool res = false;  // Final result, initialized with already inverted value
 
@@ -555,11 +712,11 @@ inline bool Polygon::isPointInside(const Point & point) const
     // Checking the edge only if given point is between edge boundaries by Y coordinates.
     // One of the condition should contain equality in order to exclude the edges
     // parallel to X+ ray.
-    if ((point.y <= poly_[i].y) == (point.y > poly_[j].y)) {
+    if ((point.y <= poly[i].y) == (point.y > poly[j].y)) {
       // Calculating the intersection coordinate of X+ ray
-      const double x_inter = poly_[i].x +
-        (point.y - poly_[i].y) * (poly_[j].x - poly_[i].x) /
-        (poly_[j].y - poly_[i].y);
+      const double x_inter = poly[i].x +
+        (point.y - poly[i].y) * (poly[j].x - poly[i].x) /
+        (poly[j].y - poly[i].y);
       // If intersection with checked edge is greater than point.x coordinate, inverting the result
       if (x_inter > point.x) {
         res = !res;
@@ -570,6 +727,11 @@ inline bool Polygon::isPointInside(const Point & point) const
   return res;
 }
 
+void Polygon::updateEdges()
+{
+  edges_.setPolygon(poly_);
+}
+
 bool Polygon::getPolygonFromString(
   std::string & poly_string,
   std::vector<Point> & polygon)
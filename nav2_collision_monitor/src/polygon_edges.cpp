@@ -0,0 +1,89 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_collision_monitor/polygon_edges.hpp"
+
+namespace nav2_collision_monitor
+{
+
+void PolygonEdges::setPolygon(const std::vector<Point> & poly)
+{
+  const size_t size = poly.size();
+  x_.resize(size);
+  y_.resize(size);
+  y_next_.resize(size);
+  dx_.resize(size);
+  dy_.resize(size);
+  a_.clear();
+  b_.clear();
+  c_.clear();
+  convex_ = false;
+  if (size == 0) {
+    return;
+  }
+
+  min_ = max_ = poly.front();
+  double turning = 0.0;
+  double orientation = 0.0;
+  bool turns_one_way = true;
+  for (size_t i = 0; i < size; i++) {
+    // The edge from each vertex to the next one
+    const Point & start = poly[i];
+    const Point & end = poly[(i + 1) % size];
+    const Point & next = poly[(i + 2) % size];
+    x_[i] = start.x;
+    y_[i] = start.y;
+    y_next_[i] = end.y;
+    dx_[i] = end.x - start.x;
+    dy_[i] = end.y - start.y;
+
+    min_.x = std::min(min_.x, start.x);
+    min_.y = std::min(min_.y, start.y);
+    max_.x = std::max(max_.x, start.x);
+    max_.y = std::max(max_.y, start.y);
+
+    // Turn at the end vertex, all the same way and adding up to one revolution if convex
+    const double cross =
+      (end.x - start.x) * (next.y - end.y) - (end.y - start.y) * (next.x - end.x);
+    const double dot =
+      (end.x - start.x) * (next.x - end.x) + (end.y - start.y) * (next.y - end.y);
+    if (cross != 0.0) {
+      turns_one_way &= orientation == 0.0 || (cross > 0.0) == (orientation > 0.0);
+      orientation = cross;
+    }
+    turning += std::atan2(cross, dot);
+  }
+
+  // Half-plane of each edge, oriented towards the inside
+  if (size < 3 || !turns_one_way || std::fabs(std::fabs(turning) - 2.0 * M_PI) > 1e-6) {
+    return;
+  }
+  const double sign = turning > 0.0 ? 1.0 : -1.0;
+  for (size_t i = 0; i < size; i++) {
+    const Point & start = poly[i];
+    const Point & end = poly[(i + 1) % size];
+    const double length = std::hypot(end.x - start.x, end.y - start.y);
+    if (length == 0.0) {
+      continue;
+    }
+    const double a = -sign * (end.y - start.y) / length;
+    const double b = sign * (end.x - start.x) / length;
+    a_.push_back(a);
+    b_.push_back(b);
+    c_.push_back(-(a * start.x + b * start.y));
+  }
+  convex_ = true;
+}
+
+}  // namespace nav2_collision_monitor
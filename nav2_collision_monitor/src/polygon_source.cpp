@@ -14,6 +14,7 @@
 
 #include "nav2_collision_monitor/polygon_source.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <functional>
 
@@ -83,8 +84,10 @@ bool PolygonSource::getData(
         return curr_time - rclcpp::Time(polygon_stamped.header.stamp) > source_timeout_;
       }), data_.end());
 
+  data_stamp_ = curr_time;
   tf2::Stamped<tf2::Transform> tf_transform;
   for (const auto & polygon_instance : data_) {
+    data_stamp_ = std::min(data_stamp_, rclcpp::Time(polygon_instance.header.stamp));
     if (base_shift_correction_) {
       // Obtaining the transform to get data from source frame and time where it was received
       // to the base frame and current time
@@ -177,10 +180,12 @@ void PolygonSource::dataCallback(geometry_msgs::msg::PolygonInstanceStamped::Con
   for (auto & polygon_stamped : data_) {
     if (msg->polygon.id == polygon_stamped.polygon.id) {
       polygon_stamped = *msg;
+      notifyDataReceived(msg->header.stamp);
       return;
     }
   }
   data_.push_back(*msg);
+  notifyDataReceived(msg->header.stamp);
 }
 
 }  // namespace nav2_collision_monitor
@@ -125,6 +125,7 @@ bool Range::getData(
   // Refill data array
   data.push_back({p_v3_b.x(), p_v3_b.y()});
 
+  data_stamp_ = data_->header.stamp;
   return true;
 }
 
@@ -145,6 +146,7 @@ void Range::getParameters(std::string & source_topic)
 void Range::dataCallback(sensor_msgs::msg::Range::ConstSharedPtr msg)
 {
   data_ = msg;
+  notifyDataReceived(msg->header.stamp);
 }
 
 }  // namespace nav2_collision_monitor
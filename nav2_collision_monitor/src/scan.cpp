@@ -84,28 +84,49 @@ bool Scan::getData(
     return false;
   }
 
-  // Calculate poses and refill data array
-  float angle = data_->angle_min;
-  for (size_t i = 0; i < data_->ranges.size(); i++) {
-    if (data_->ranges[i] >= data_->range_min && data_->ranges[i] <= data_->range_max) {
-      // Transform point coordinates from source frame -> to base frame
-      tf2::Vector3 p_v3_s(
-        data_->ranges[i] * std::cos(angle),
-        data_->ranges[i] * std::sin(angle),
-        0.0);
-      tf2::Vector3 p_v3_b = tf_transform * p_v3_s;
-
-      // Refill data array
-      data.push_back({p_v3_b.x(), p_v3_b.y()});
+  if (data_ != cached_data_) {
+    // New scan: convert the valid readings to the source frame once per message
+    source_x_.clear();
+    source_y_.clear();
+    float angle = data_->angle_min;
+    for (size_t i = 0; i < data_->ranges.size(); i++) {
+      if (data_->ranges[i] >= data_->range_min && data_->ranges[i] <= data_->range_max) {
+        source_x_.push_back(data_->ranges[i] * std::cos(angle));
+        source_y_.push_back(data_->ranges[i] * std::sin(angle));
+      }
+      angle += data_->angle_increment;
     }
-    angle += data_->angle_increment;
+    cached_data_ = data_;
+    points_valid_ = false;
   }
+
+  if (!points_valid_ || !(tf_transform == cached_transform_)) {
+    // Transform point coordinates from source frame -> to base frame.
+    // Scan points lie in the source XY plane, so only the planar part of the transform is used.
+    const tf2::Matrix3x3 & basis = tf_transform.getBasis();
+    const double r00 = basis[0][0], r01 = basis[0][1];
+    const double r10 = basis[1][0], r11 = basis[1][1];
+    const double tx = tf_transform.getOrigin().x();
+    const double ty = tf_transform.getOrigin().y();
+    points_.resize(source_x_.size());
+    for (size_t i = 0; i < source_x_.size(); i++) {
+      points_[i].x = r00 * source_x_[i] + r01 * source_y_[i] + tx;
+      points_[i].y = r10 * source_x_[i] + r11 * source_y_[i] + ty;
+    }
+    cached_transform_ = tf_transform;
+    points_valid_ = true;
+  }
+
+  // Refill data array
+  data.insert(data.end(), points_.begin(), points_.end());
+  data_stamp_ = data_->header.stamp;
   return true;
 }
 
 void Scan::dataCallback(sensor_msgs::msg::LaserScan::ConstSharedPtr msg)
 {
   data_ = msg;
+  notifyDataReceived(msg->header.stamp);
 }
 
 }  // namespace nav2_collision_monitor
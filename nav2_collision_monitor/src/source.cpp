@@ -112,6 +112,23 @@ rclcpp::Duration Source::getSourceTimeout() const
   return source_timeout_;
 }
 
+rclcpp::Time Source::getDataStamp() const
+{
+  return data_stamp_;
+}
+
+void Source::setDataReceivedCallback(std::function<void(const rclcpp::Time &)> callback)
+{
+  data_received_callback_ = callback;
+}
+
+void Source::notifyDataReceived(const rclcpp::Time & stamp) const
+{
+  if (data_received_callback_) {
+    data_received_callback_(stamp);
+  }
+}
+
 rcl_interfaces::msg::SetParametersResult
 Source::dynamicParametersCallback(
   std::vector<rclcpp::Parameter> parameters)
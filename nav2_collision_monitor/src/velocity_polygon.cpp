@@ -14,6 +14,8 @@
 
 #include "nav2_collision_monitor/velocity_polygon.hpp"
 
+#include <algorithm>
+
 #include "nav2_util/node_utils.hpp"
 
 namespace nav2_collision_monitor
@@ -124,11 +126,22 @@ bool VelocityPolygon::getParameters(
           .as_double();
       }
 
+      // Visualization polygon
+      std::vector<geometry_msgs::msg::Point32> polygon_points;
+      for (const Point & p : poly) {
+        geometry_msgs::msg::Point32 p_s;
+        p_s.x = p.x;
+        p_s.y = p.y;
+        // p_s.z will remain 0.0
+        polygon_points.push_back(p_s);
+      }
+
       SubPolygonParameter sub_polygon = {
         poly, velocity_polygon_name, linear_min, linear_max, theta_min,
-        theta_max, direction_end_angle, direction_start_angle};
+        theta_max, direction_end_angle, direction_start_angle, polygon_points};
       sub_polygons_.push_back(sub_polygon);
     }
+    buildLookupTable();
   } catch (const std::exception & ex) {
     RCLCPP_ERROR(
       logger_, "[%s]: Error while getting polygon parameters: %s", polygon_name_.c_str(),
@@ -140,19 +153,20 @@ bool VelocityPolygon::getParameters(
 
 void VelocityPolygon::updatePolygon(const Velocity & cmd_vel_in)
 {
-  for (auto & sub_polygon : sub_polygons_) {
-    if (isInRange(cmd_vel_in, sub_polygon)) {
-      // Set the polygon that is within the speed range
-      poly_ = sub_polygon.poly_;
-
-      // Update visualization polygon
-      polygon_.polygon.points.clear();
-      for (const Point & p : poly_) {
-        geometry_msgs::msg::Point32 p_s;
-        p_s.x = p.x;
-        p_s.y = p.y;
-        // p_s.z will remain 0.0
-        polygon_.polygon.points.push_back(p_s);
+  const size_t cell =
+    getBoundsCell(theta_bounds_, cmd_vel_in.tw) * (2 * linear_bounds_.size() + 1) +
+    getBoundsCell(linear_bounds_, cmd_vel_in.x);
+  for (unsigned int i = cell_starts_[cell]; i < cell_starts_[cell + 1]; i++) {
+    const unsigned int id = cell_sub_polygons_[i];
+    // The candidates of the cell are in the velocity bounds, only the direction remains
+    if (!holonomic_ || isInRange(cmd_vel_in, sub_polygons_[id])) {
+      if (id != current_sub_polygon_) {
+        // Set the polygon that is within the speed range
+        poly_ = sub_polygons_[id].poly_;
+        updateEdges();
+        // Update visualization polygon
+        polygon_.polygon.points = sub_polygons_[id].polygon_points_;
+        current_sub_polygon_ = id;
       }
       return;
     }
@@ -166,6 +180,71 @@ void VelocityPolygon::updatePolygon(const Velocity & cmd_vel_in)
   return;
 }
 
+void VelocityPolygon::buildLookupTable()
+{
+  current_sub_polygon_ = std::numeric_limits<size_t>::max();
+  linear_bounds_.clear();
+  theta_bounds_.clear();
+  for (const SubPolygonParameter & sub_polygon : sub_polygons_) {
+    linear_bounds_.push_back(sub_polygon.linear_min_);
+    linear_bounds_.push_back(sub_polygon.linear_max_);
+    theta_bounds_.push_back(sub_polygon.theta_min_);
+    theta_bounds_.push_back(sub_polygon.theta_max_);
+  }
+  for (std::vector<double> * bounds : {&linear_bounds_, &theta_bounds_}) {
+    std::sort(bounds->begin(), bounds->end());
+    bounds->erase(std::unique(bounds->begin(), bounds->end()), bounds->end());
+  }
+
+  // A velocity of the cell, the ranges of the sub-polygons being the same over the whole cell
+  auto cellValue = [](const std::vector<double> & bounds, const size_t cell) {
+      if (bounds.empty()) {
+        return 0.0;
+      }
+      if (cell % 2 == 1) {
+        return bounds[cell / 2];
+      }
+      if (cell == 0) {
+        return bounds.front() - 1.0;
+      }
+      if (cell / 2 == bounds.size()) {
+        return bounds.back() + 1.0;
+      }
+      return (bounds[cell / 2 - 1] + bounds[cell / 2]) / 2.0;
+    };
+
+  const size_t linear_cells = 2 * linear_bounds_.size() + 1;
+  const size_t theta_cells = 2 * theta_bounds_.size() + 1;
+  cell_starts_.assign(1, 0);
+  cell_sub_polygons_.clear();
+  for (size_t theta_cell = 0; theta_cell < theta_cells; theta_cell++) {
+    const double tw = cellValue(theta_bounds_, theta_cell);
+    for (size_t linear_cell = 0; linear_cell < linear_cells; linear_cell++) {
+      const double x = cellValue(linear_bounds_, linear_cell);
+      for (unsigned int id = 0; id < sub_polygons_.size(); id++) {
+        const SubPolygonParameter & sub_polygon = sub_polygons_[id];
+        if (x <= sub_polygon.linear_max_ && x >= sub_polygon.linear_min_ &&
+          tw <= sub_polygon.theta_max_ && tw >= sub_polygon.theta_min_)
+        {
+          cell_sub_polygons_.push_back(id);
+          if (!holonomic_) {
+            // Only the first sub-polygon in range is used
+            break;
+          }
+        }
+      }
+      cell_starts_.push_back(cell_sub_polygons_.size());
+    }
+  }
+}
+
+size_t VelocityPolygon::getBoundsCell(const std::vector<double> & bounds, const double value)
+{
+  const auto it = std::lower_bound(bounds.begin(), bounds.end(), value);
+  const size_t i = it - bounds.begin();
+  return (it != bounds.end() && *it == value) ? 2 * i + 1 : 2 * i;
+}
+
 bool VelocityPolygon::isInRange(
   const Velocity & cmd_vel_in, const SubPolygonParameter & sub_polygon)
 {
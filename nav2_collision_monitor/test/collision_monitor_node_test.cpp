@@ -1305,6 +1305,58 @@ TEST_F(Tester, testCeasePublishZeroVel)
   cm_->stop();
 }
 
+TEST_F(Tester, testProcessOnSourceData)
+{
+  rclcpp::Time curr_time = cm_->now();
+
+  // Configure slowdown and stop zones, reevaluated on new scans
+  setCommonParameters();
+  cm_->declare_parameter("process_on_source_data", rclcpp::ParameterValue(true));
+  cm_->set_parameter(rclcpp::Parameter("process_on_source_data", true));
+  addPolygon("SlowDown", POLYGON, 2.0, "slowdown");
+  addPolygon("Stop", POLYGON, 1.0, "stop");
+  addSource(SCAN_NAME, SCAN);
+  setVectors({"SlowDown", "Stop"}, {SCAN_NAME});
+
+  // Start Collision Monitor node
+  cm_->start();
+
+  // Share TF
+  sendTransforms(curr_time);
+
+  // 1. Obstacle is far away from robot
+  publishScan(4.5, curr_time);
+  ASSERT_TRUE(waitData(4.5, 500ms, curr_time));
+  publishCmdVel(0.5, 0.2, 0.1);
+  ASSERT_TRUE(waitCmdVel(500ms));
+  ASSERT_NEAR(cmd_vel_out_->linear.x, 0.5, EPSILON);
+
+  // 2. Obstacle in slowdown zone: applied to the next command only
+  cmd_vel_out_ = nullptr;
+  publishScan(1.5, curr_time);
+  ASSERT_TRUE(waitData(1.5, 500ms, curr_time));
+  ASSERT_FALSE(waitCmdVel(100ms));
+
+  // 3. Obstacle inside stop zone: robot stops without waiting for a new command
+  publishScan(0.5, curr_time);
+  ASSERT_TRUE(waitData(0.5, 500ms, curr_time));
+  ASSERT_TRUE(waitCmdVel(500ms));
+  ASSERT_NEAR(cmd_vel_out_->linear.x, 0.0, EPSILON);
+  ASSERT_NEAR(cmd_vel_out_->linear.y, 0.0, EPSILON);
+  ASSERT_NEAR(cmd_vel_out_->angular.z, 0.0, EPSILON);
+  ASSERT_TRUE(waitActionState(500ms));
+  ASSERT_EQ(action_state_->action_type, STOP);
+  ASSERT_EQ(action_state_->polygon_name, "Stop");
+
+  // 4. Stop is not published again on the following scans
+  cmd_vel_out_ = nullptr;
+  publishScan(0.5, curr_time);
+  ASSERT_FALSE(waitCmdVel(100ms));
+
+  // Stop Collision Monitor node
+  cm_->stop();
+}
+
 TEST_F(Tester, testPolygonNotEnabled)
 {
   // Set Collision Monitor parameters.
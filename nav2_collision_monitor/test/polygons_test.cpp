@@ -32,7 +32,10 @@
 #include "tf2_ros/transform_broadcaster.h"
 
 #include "nav2_collision_monitor/types.hpp"
+#include "nav2_collision_monitor/kinematics.hpp"
+#include "nav2_collision_monitor/point_grid.hpp"
 #include "nav2_collision_monitor/polygon.hpp"
+#include "nav2_collision_monitor/polygon_edges.hpp"
 #include "nav2_collision_monitor/circle.hpp"
 
 using namespace std::chrono_literals;
@@ -849,6 +852,95 @@ TEST_F(Tester, testCircleGetPointsInside)
   ASSERT_EQ(circle_->getPointsInside(points), 1);
 }
 
+TEST_F(Tester, testGetPointsInsideGrid)
+{
+  createPolygon("stop", true);
+  createCircle("stop", true);
+
+  // Points over a grid spanning both shapes and beyond
+  std::vector<nav2_collision_monitor::Point> points;
+  for (int i = -20; i <= 20; i++) {
+    for (int j = -20; j <= 20; j++) {
+      points.push_back({i * 0.05 + 0.001, j * 0.05 + 0.002});
+    }
+  }
+  nav2_collision_monitor::PointGrid grid;
+  grid.setPoints(points);
+  ASSERT_EQ(grid.size(), points.size());
+
+  // Same count as checking every point, unless stopped at max_points
+  const nav2_collision_monitor::Pose origin{0.0, 0.0, 0.0};
+  const int polygon_points = polygon_->getPointsInside(points);
+  const int circle_points = circle_->getPointsInside(points);
+  ASSERT_GT(polygon_points, 10);
+  ASSERT_GT(circle_points, 10);
+  EXPECT_EQ(polygon_->getPointsInside(grid, origin, points.size()), polygon_points);
+  EXPECT_EQ(circle_->getPointsInside(grid, origin, points.size()), circle_points);
+  EXPECT_EQ(polygon_->getPointsInside(grid, origin, 10), 10);
+  EXPECT_EQ(circle_->getPointsInside(grid, origin, 10), 10);
+
+  // Moving the shapes over the points is the same as transforming the points
+  const nav2_collision_monitor::Pose pose{0.3, -0.2, M_PI / 6.0};
+  std::vector<nav2_collision_monitor::Point> points_transformed = points;
+  nav2_collision_monitor::transformPoints(pose, points_transformed);
+  EXPECT_EQ(
+    polygon_->getPointsInside(grid, pose, points.size()),
+    polygon_->getPointsInside(points_transformed));
+  EXPECT_EQ(
+    circle_->getPointsInside(grid, pose, points.size()),
+    circle_->getPointsInside(points_transformed));
+
+  // Shapes outside of the points
+  const nav2_collision_monitor::Pose far{10.0, 10.0, 0.0};
+  EXPECT_EQ(polygon_->getPointsInside(grid, far, points.size()), 0);
+  EXPECT_EQ(circle_->getPointsInside(grid, far, points.size()), 0);
+
+  // No points
+  grid.setPoints({});
+  EXPECT_EQ(polygon_->getPointsInside(grid, origin, 10), 0);
+}
+
+TEST(PolygonEdgesTest, testCountPointsInside)
+{
+  // Points on a lattice through the vertices and along the edges, with some off it
+  std::vector<double> xs, ys;
+  for (int i = -30; i <= 30; i++) {
+    for (int j = -30; j <= 30; j++) {
+      xs.push_back(i * 0.025);
+      ys.push_back(j * 0.025 + (i % 3 == 0 ? 0.0 : 0.003));
+    }
+  }
+
+  const std::vector<std::vector<nav2_collision_monitor::Point>> polys{
+    // Convex, clockwise and counter-clockwise
+    {{0.5, 0.5}, {0.5, -0.5}, {-0.5, -0.5}, {-0.5, 0.5}},
+    {{-0.5, -0.25}, {0.5, -0.5}, {0.25, 0.5}},
+    // Concave
+    {{0.5, 0.5}, {0.0, 0.0}, {0.5, -0.5}, {-0.5, -0.5}, {-0.5, 0.5}},
+    // Self-intersecting
+    {{0.5, 0.5}, {-0.5, -0.5}, {0.5, -0.5}, {-0.5, 0.5}}};
+  const std::vector<bool> convex{true, true, false, false};
+
+  for (size_t p = 0; p < polys.size(); p++) {
+    nav2_collision_monitor::PolygonEdges edges;
+    edges.setPolygon(polys[p]);
+    EXPECT_EQ(edges.isConvex(), convex[p]);
+
+    // Counting the points by blocks gives the same result as checking each point
+    int expected = 0;
+    for (size_t i = 0; i < xs.size(); i++) {
+      expected += edges.isPointInside({xs[i], ys[i]});
+    }
+    EXPECT_GT(expected, 0);
+    EXPECT_EQ(edges.countPointsInside(xs.data(), ys.data(), xs.size()), expected);
+  }
+
+  nav2_collision_monitor::PolygonEdges edges;
+  edges.setPolygon({});
+  EXPECT_TRUE(edges.empty());
+  EXPECT_EQ(edges.countPointsInside(xs.data(), ys.data(), xs.size()), 0);
+}
+
 TEST_F(Tester, testPolygonGetCollisionTime)
 {
   createPolygon("approach", false);
@@ -917,6 +1009,58 @@ TEST_F(Tester, testPolygonGetCollisionTime)
   EXPECT_LT(polygon_->getCollisionTime(points, vel), 0.0);
 }
 
+TEST_F(Tester, testCircleGetCollisionTime)
+{
+  createCircle("approach", true);
+
+  // Forward movement: points 0.4 m ahead the circle (0.5 m), hit in exactly 0.4 m / 0.5 m/s
+  nav2_collision_monitor::Velocity vel{0.5, 0.0, 0.0};
+  std::vector<nav2_collision_monitor::Point> points{{0.9, 0.0}, {0.9, 0.0}};
+  EXPECT_NEAR(circle_->getCollisionTime(points, vel), 0.8, EPSILON);
+
+  // Rotation in place never reaches points outside the circle
+  vel = {0.0, 0.0, 1.0};
+  EXPECT_LT(circle_->getCollisionTime(points, vel), 0.0);
+
+  // Arc around (0, 1): points at (1, 1) are at |p|^2 = 2 - 2 * sin(1.5 * t) in the robot
+  // frame, entering the circle when sin(1.5 * t) = 0.875
+  vel = {1.5, 0.0, 1.5};
+  points = {{1.0, 1.0}, {1.0, 1.0}};
+  EXPECT_NEAR(circle_->getCollisionTime(points, vel), std::asin(0.875) / 1.5, EPSILON);
+
+  // Points inside
+  points = {{0.1, 0.1}, {-0.1, 0.1}};
+  EXPECT_NEAR(circle_->getCollisionTime(points, vel), 0.0, EPSILON);
+}
+
+TEST_F(Tester, testPolygonGetCollisionTimeGrid)
+{
+  createPolygon("approach", false);
+
+  // Set footprint for Polygon
+  test_node_->publishFootprint();
+  std::vector<nav2_collision_monitor::Point> footprint;
+  ASSERT_TRUE(waitFootprint(500ms, footprint));
+  ASSERT_EQ(footprint.size(), 4u);
+
+  // Moving the footprint over the points gives the same times as moving the points
+  const std::vector<nav2_collision_monitor::Velocity> velocities{
+    {0.5, 0.0, 0.0}, {-0.5, 0.0, 0.0}, {0.0, 0.5, 0.0}, {0.3, 0.0, 0.5}};
+  const std::vector<std::vector<nav2_collision_monitor::Point>> points_sets{
+    {{0.7, -0.01}, {0.7, 0.01}}, {{-0.7, -0.01}, {-0.7, 0.01}},
+    {{-0.01, 0.6}, {0.01, 0.6}}, {{0.1, -0.01}, {0.1, 0.01}},
+    {{1.1, -0.01}, {1.1, 0.01}}, {{0.6, 0.3}, {0.65, 0.35}, {0.7, 0.4}}};
+  nav2_collision_monitor::PointGrid grid;
+  for (const auto & points : points_sets) {
+    grid.setPoints(points);
+    for (const auto & vel : velocities) {
+      EXPECT_NEAR(
+        polygon_->getCollisionTime(grid, vel), polygon_->getCollisionTime(points, vel),
+        SIMULATION_TIME_STEP);
+    }
+  }
+}
+
 TEST_F(Tester, testPolygonPublish)
 {
   createPolygon("stop", true);
@@ -15,12 +15,14 @@
 #include <gtest/gtest.h>
 
 #include <math.h>
+#include <algorithm>
 #include <cmath>
 #include <chrono>
 #include <memory>
 #include <utility>
 #include <vector>
 #include <string>
+#include <thread>
 #include <limits>
 
 #include "rclcpp/rclcpp.hpp"
@@ -39,6 +41,7 @@
 #include "nav2_collision_monitor/pointcloud.hpp"
 #include "nav2_collision_monitor/range.hpp"
 #include "nav2_collision_monitor/polygon_source.hpp"
+#include "nav2_collision_monitor/costmap_source.hpp"
 
 using namespace std::chrono_literals;
 
@@ -55,6 +58,8 @@ static const char RANGE_NAME[]{"Range"};
 static const char RANGE_TOPIC[]{"range"};
 static const char POLYGON_NAME[]{"Polygon"};
 static const char POLYGON_TOPIC[]{"polygon"};
+static const char COSTMAP_NAME[]{"Costmap"};
+static const char COSTMAP_TOPIC[]{"costmap_raw"};
 static const tf2::Duration TRANSFORM_TOLERANCE{tf2::durationFromSec(0.1)};
 static const rclcpp::Duration DATA_TIMEOUT{rclcpp::Duration::from_seconds(5.0)};
 
@@ -243,6 +248,12 @@ public:
   {
     return data_ != nullptr;
   }
+
+  void downsamplePoints(std::vector<nav2_collision_monitor::Point> & points, double resolution)
+  {
+    downsampling_resolution_ = resolution;
+    downsample(points);
+  }
 };  // PointCloudWrapper
 
 class RangeWrapper : public nav2_collision_monitor::Range
@@ -291,6 +302,34 @@ public:
   }
 };  // PolygonWrapper
 
+class CostmapWrapper : public nav2_collision_monitor::CostmapSource
+{
+public:
+  CostmapWrapper(
+    const nav2_util::LifecycleNode::WeakPtr & node,
+    const std::string & source_name,
+    const std::shared_ptr<tf2_ros::Buffer> tf_buffer,
+    const std::string & base_frame_id,
+    const std::string & global_frame_id,
+    const tf2::Duration & transform_tolerance,
+    const rclcpp::Duration & data_timeout,
+    const bool base_shift_correction)
+  : nav2_collision_monitor::CostmapSource(
+      node, source_name, tf_buffer, base_frame_id, global_frame_id,
+      transform_tolerance, data_timeout, base_shift_correction)
+  {}
+
+  void receiveCostmap(nav2_msgs::msg::Costmap::ConstSharedPtr msg)
+  {
+    costmapCallback(msg);
+  }
+
+  void receiveCostmapUpdate(nav2_msgs::msg::CostmapUpdate::ConstSharedPtr msg)
+  {
+    costmapUpdateCallback(msg);
+  }
+};  // CostmapWrapper
+
 class Tester : public ::testing::Test
 {
 public:
@@ -300,6 +339,7 @@ public:
 protected:
   // Data sources creation routine
   void createSources(const bool base_shift_correction = true);
+  void createCostmapSource();
 
   // Setting TF chains
   void sendTransforms(const rclcpp::Time & stamp);
@@ -319,6 +359,7 @@ protected:
   std::shared_ptr<PointCloudWrapper> pointcloud_;
   std::shared_ptr<RangeWrapper> range_;
   std::shared_ptr<PolygonWrapper> polygon_;
+  std::shared_ptr<CostmapWrapper> costmap_;
 
 private:
   std::shared_ptr<tf2_ros::Buffer> tf_buffer_;
@@ -339,6 +380,7 @@ Tester::~Tester()
   scan_.reset();
   pointcloud_.reset();
   range_.reset();
+  costmap_.reset();
 
   test_node_.reset();
 
@@ -411,6 +453,20 @@ void Tester::createSources(const bool base_shift_correction)
   polygon_->configure();
 }
 
+void Tester::createCostmapSource()
+{
+  test_node_->declare_parameter(
+    std::string(COSTMAP_NAME) + ".topic", rclcpp::ParameterValue(COSTMAP_TOPIC));
+  test_node_->set_parameter(
+    rclcpp::Parameter(std::string(COSTMAP_NAME) + ".topic", COSTMAP_TOPIC));
+
+  costmap_ = std::make_shared<CostmapWrapper>(
+    test_node_, COSTMAP_NAME, tf_buffer_,
+    BASE_FRAME_ID, GLOBAL_FRAME_ID,
+    TRANSFORM_TOLERANCE, DATA_TIMEOUT, true);
+  costmap_->configure();
+}
+
 void Tester::sendTransforms(const rclcpp::Time & stamp)
 {
   std::shared_ptr<tf2_ros::TransformBroadcaster> tf_broadcaster =
@@ -741,6 +797,155 @@ TEST_F(Tester, testIgnoreTimeShift)
   checkPolygon(data);
 }
 
+TEST_F(Tester, testGetCachedData)
+{
+  rclcpp::Time curr_time = test_node_->now();
+
+  createSources();
+
+  sendTransforms(curr_time);
+
+  // Publish data for sources
+  test_node_->publishScan(curr_time, 1.0);
+  test_node_->publishPointCloud(curr_time);
+
+  // Wait until all sources will receive the data
+  ASSERT_TRUE(waitScan(500ms));
+  ASSERT_TRUE(waitPointCloud(500ms));
+
+  // Getting the same message again appends the same points
+  std::vector<nav2_collision_monitor::Point> data;
+  ASSERT_TRUE(scan_->getData(curr_time, data));
+  ASSERT_TRUE(scan_->getData(curr_time, data));
+  ASSERT_EQ(data.size(), 8u);
+  checkScan(std::vector<nav2_collision_monitor::Point>(data.begin(), data.begin() + 4));
+  checkScan(std::vector<nav2_collision_monitor::Point>(data.begin() + 4, data.end()));
+
+  data.clear();
+  ASSERT_TRUE(pointcloud_->getData(curr_time, data));
+  ASSERT_TRUE(pointcloud_->getData(curr_time, data));
+  ASSERT_EQ(data.size(), 4u);
+  checkPointCloud(std::vector<nav2_collision_monitor::Point>(data.begin(), data.begin() + 2));
+  checkPointCloud(std::vector<nav2_collision_monitor::Point>(data.begin() + 2, data.end()));
+}
+
+TEST_F(Tester, testPointCloudDownsampling)
+{
+  createSources();
+
+  // Dense points on a 0.01m grid over [-0.5, 0.5)
+  std::vector<nav2_collision_monitor::Point> points;
+  for (int i = -50; i < 50; i++) {
+    for (int j = -50; j < 50; j++) {
+      points.push_back({i * 0.01 + 0.005, j * 0.01 + 0.005});
+    }
+  }
+
+  // One point per 0.1m cell, the first one of each cell
+  pointcloud_->downsamplePoints(points, 0.1);
+  ASSERT_EQ(points.size(), 100u);
+  EXPECT_NEAR(points[0].x, -0.495, EPSILON);
+  EXPECT_NEAR(points[0].y, -0.495, EPSILON);
+  for (size_t i = 0; i < points.size(); i++) {
+    for (size_t j = i + 1; j < points.size(); j++) {
+      EXPECT_FALSE(
+        std::floor(points[i].x / 0.1) == std::floor(points[j].x / 0.1) &&
+        std::floor(points[i].y / 0.1) == std::floor(points[j].y / 0.1));
+    }
+  }
+
+  // Downsampling again reuses the table, with no point left to merge
+  pointcloud_->downsamplePoints(points, 0.1);
+  EXPECT_EQ(points.size(), 100u);
+  pointcloud_->downsamplePoints(points, 1.0);
+  EXPECT_EQ(points.size(), 4u);
+}
+
+TEST_F(Tester, testCostmapSource)
+{
+  rclcpp::Time curr_time = test_node_->now();
+
+  createCostmapSource();
+
+  sendTransforms(curr_time);
+
+  // No costmap received yet
+  std::vector<nav2_collision_monitor::Point> data;
+  ASSERT_FALSE(costmap_->getData(curr_time, data));
+
+  // 4x3 costmap of 0.5m cells from (-1.0, -1.0)
+  auto costmap = std::make_shared<nav2_msgs::msg::Costmap>();
+  costmap->header.frame_id = SOURCE_FRAME_ID;
+  costmap->header.stamp = curr_time;
+  costmap->metadata.resolution = 0.5;
+  costmap->metadata.size_x = 4;
+  costmap->metadata.size_y = 3;
+  costmap->metadata.origin.position.x = -1.0;
+  costmap->metadata.origin.position.y = -1.0;
+  costmap->data.assign(12, 0);
+  costmap->data[0] = 254;  // (0, 0) lethal
+  costmap->data[5] = 253;  // (1, 1) inscribed
+  costmap->data[2] = 255;  // (2, 0) unknown
+  costmap->data[11] = 254;  // (3, 2) lethal
+  costmap_->receiveCostmap(costmap);
+
+  auto getSortedData = [this, &curr_time](std::vector<nav2_collision_monitor::Point> & data) {
+      data.clear();
+      rclcpp::Time start_time = test_node_->now();
+      while (!costmap_->getData(curr_time, data) &&
+        test_node_->now() - start_time <= rclcpp::Duration(500ms))
+      {
+        rclcpp::spin_some(test_node_->get_node_base_interface());
+        std::this_thread::sleep_for(10ms);
+      }
+      std::sort(
+        data.begin(), data.end(),
+        [](const nav2_collision_monitor::Point & a, const nav2_collision_monitor::Point & b) {
+          return a.x < b.x;
+        });
+    };
+
+  // Centers of the lethal cells shifted by the source frame
+  getSortedData(data);
+  ASSERT_EQ(data.size(), 2u);
+  EXPECT_EQ(costmap_->getDataStamp(), curr_time);
+  EXPECT_NEAR(data[0].x, -0.65, EPSILON);
+  EXPECT_NEAR(data[0].y, -0.65, EPSILON);
+  EXPECT_NEAR(data[1].x, 0.85, EPSILON);
+  EXPECT_NEAR(data[1].y, 0.35, EPSILON);
+
+  // Cell (1, 1) becomes lethal, cell (0, 0) is cleared
+  auto update = std::make_shared<nav2_msgs::msg::CostmapUpdate>();
+  update->header = costmap->header;
+  update->x = 1;
+  update->y = 1;
+  update->size_x = 2;
+  update->size_y = 1;
+  update->data = {254, 0};
+  costmap_->receiveCostmapUpdate(update);
+  update->x = 0;
+  update->y = 0;
+  update->size_x = 1;
+  update->data = {0};
+  costmap_->receiveCostmapUpdate(update);
+
+  getSortedData(data);
+  ASSERT_EQ(data.size(), 2u);
+  EXPECT_NEAR(data[0].x, -0.15, EPSILON);
+  EXPECT_NEAR(data[0].y, -0.15, EPSILON);
+  EXPECT_NEAR(data[1].x, 0.85, EPSILON);
+  EXPECT_NEAR(data[1].y, 0.35, EPSILON);
+
+  // Update outside of the costmap is ignored
+  update->x = 3;
+  update->y = 2;
+  update->size_x = 2;
+  update->data = {0, 0};
+  costmap_->receiveCostmapUpdate(update);
+  getSortedData(data);
+  EXPECT_EQ(data.size(), 2u);
+}
+
 int main(int argc, char ** argv)
 {
   // Initialize the system
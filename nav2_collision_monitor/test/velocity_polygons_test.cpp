@@ -133,6 +133,22 @@ public:
   {
     return sub_polygons_;
   }
+
+  // Name of the first sub-polygon in range, checking all of them
+  std::string findSubPolygonName(const nav2_collision_monitor::Velocity & vel)
+  {
+    for (const SubPolygonParameter & sub_polygon : sub_polygons_) {
+      if (isInRange(vel, sub_polygon)) {
+        return sub_polygon.velocity_polygon_name_;
+      }
+    }
+    return "";
+  }
+
+  std::string getCurrentSubPolygonName() const
+  {
+    return sub_polygons_[current_sub_polygon_].velocity_polygon_name_;
+  }
 };  // VelocityPolygonWrapper
 
 class Tester : public ::testing::Test
@@ -560,6 +576,37 @@ TEST_F(Tester, testVelocityPolygonHolonomicVelocitySwitching)
 }
 
 
+// Checks that velocities inside, outside and on the bounds of the sub-polygons select
+// the same sub-polygon as checking all of them in order
+void checkLookupTable(VelocityPolygonWrapper & velocity_polygon)
+{
+  for (int i = -12; i <= 12; i++) {
+    for (int j = -6; j <= 6; j++) {
+      for (const double y : {-0.3, 0.0, 0.3}) {
+        const nav2_collision_monitor::Velocity vel{i * 0.05, y, j * 0.25};
+        const std::string expected = velocity_polygon.findSubPolygonName(vel);
+        if (expected.empty()) {
+          continue;
+        }
+        velocity_polygon.updatePolygon(vel);
+        EXPECT_EQ(velocity_polygon.getCurrentSubPolygonName(), expected);
+      }
+    }
+  }
+}
+
+TEST_F(Tester, testVelocityPolygonLookupTable)
+{
+  createVelocityPolygon("stop", IS_NOT_HOLONOMIC);
+  checkLookupTable(*velocity_polygon_);
+}
+
+TEST_F(Tester, testHolonomicVelocityPolygonLookupTable)
+{
+  createVelocityPolygon("stop", IS_HOLONOMIC);
+  checkLookupTable(*velocity_polygon_);
+}
+
 int main(int argc, char ** argv)
 {
   // Initialize the system
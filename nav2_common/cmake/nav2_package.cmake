@@ -41,6 +41,12 @@ macro(nav2_package)
     add_compile_options("$<$<COMPILE_LANGUAGE:CXX>:-Wnon-virtual-dtor>")
   endif()
 
+  # Trace points of nav2_util/tracing.hpp, emitted as LTTng events
+  option(NAV2_TRACING_ENABLED "Enable Nav2 trace points" FALSE)
+  if(NAV2_TRACING_ENABLED)
+    add_compile_definitions(NAV2_TRACING_ENABLED)
+  endif()
+
   option(COVERAGE_ENABLED "Enable code coverage" FALSE)
   if(COVERAGE_ENABLED)
     add_compile_options(--coverage)
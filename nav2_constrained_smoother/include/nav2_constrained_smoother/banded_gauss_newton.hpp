@@ -0,0 +1,379 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_CONSTRAINED_SMOOTHER__BANDED_GAUSS_NEWTON_HPP_
+#define NAV2_CONSTRAINED_SMOOTHER__BANDED_GAUSS_NEWTON_HPP_
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "nav2_constrained_smoother/smoother_cost_function.hpp"
+
+#include "ceres/jet.h"
+#include "Eigen/Core"
+
+namespace nav2_constrained_smoother
+{
+
+/**
+ * @struct nav2_constrained_smoother::ResidualBlock
+ * @brief A cost function of the smoother and the points of the path it is evaluated on
+ */
+struct ResidualBlock
+{
+  std::unique_ptr<SmootherCostFunction> cost_function;
+  size_t point;
+  size_t next_point;
+  size_t prev_point;
+};
+
+/**
+ * @class nav2_constrained_smoother::BandedGaussNewton
+ * @brief Levenberg-Marquardt (damped Gauss-Newton) solver specialized for the smoother.
+ * Each cost function only involves three consecutive optimized points, so the normal
+ * equations are banded and are factorized by a banded Cholesky decomposition in linear
+ * time, without the general sparse machinery of Ceres.
+ */
+class BandedGaussNewton
+{
+public:
+  /**
+   * @struct nav2_constrained_smoother::BandedGaussNewton::Summary
+   * @brief Outcome of a solve
+   */
+  struct Summary
+  {
+    double initial_cost{0.0};
+    double final_cost{0.0};
+    int iterations{0};
+  };
+
+  /**
+   * @brief A constructor for nav2_constrained_smoother::BandedGaussNewton
+   * @param max_iterations Maximum number of iterations
+   * @param fn_tol Relative decrease of the cost below which the solver stops
+   * @param gradient_tol Maximum norm of the gradient below which the solver stops
+   * @param param_tol Relative norm of the step below which the solver stops
+   */
+  BandedGaussNewton(int max_iterations, double fn_tol, double gradient_tol, double param_tol)
+  : max_iterations_(max_iterations),
+    fn_tol_(fn_tol),
+    gradient_tol_(gradient_tol),
+    param_tol_(param_tol)
+  {
+  }
+
+  /**
+   * @brief Minimize the sum of the squared residuals of the blocks
+   * @param blocks Residual blocks
+   * @param constant Whether each point of the path is held constant
+   * @param max_time Maximum time to solve in seconds
+   * @param points Points of the path, optimized in place
+   * @param summary Output summary of the solve
+   * @return If the solution is usable
+   */
+  bool solve(
+    const std::vector<ResidualBlock> & blocks,
+    const std::vector<bool> & constant,
+    double max_time,
+    std::vector<Eigen::Vector3d> & points,
+    Summary & summary)
+  {
+    const auto start_time = std::chrono::steady_clock::now();
+
+    // Index the coordinates of the points which are optimized
+    variables_.assign(points.size(), -1);
+    std::vector<bool> used(points.size(), false);
+    for (const auto & block : blocks) {
+      used[block.point] = used[block.next_point] = used[block.prev_point] = true;
+    }
+    size_t num_points = 0;
+    for (size_t i = 0; i < points.size(); i++) {
+      if (used[i] && !constant[i]) {
+        variables_[i] = static_cast<int>(num_points++);
+      }
+    }
+    size_ = 2 * num_points;
+    if (size_ == 0) {
+      summary.initial_cost = summary.final_cost = evaluateCost(blocks, points);
+      return std::isfinite(summary.final_cost);
+    }
+
+    // Half bandwidth of the normal equations
+    bandwidth_ = 1;
+    for (const auto & block : blocks) {
+      int lowest = std::numeric_limits<int>::max();
+      int highest = -1;
+      for (size_t p : {block.point, block.next_point, block.prev_point}) {
+        if (variables_[p] != -1) {
+          lowest = std::min(lowest, variables_[p]);
+          highest = std::max(highest, variables_[p]);
+        }
+      }
+      if (highest != -1) {
+        bandwidth_ = std::max(bandwidth_, static_cast<size_t>(2 * (highest - lowest) + 1));
+      }
+    }
+
+    std::vector<double> hessian, gradient, system, step(size_);
+    double cost = evaluate(blocks, points, hessian, gradient);
+    summary.initial_cost = cost;
+    summary.final_cost = cost;
+    summary.iterations = 0;
+    if (!std::isfinite(cost)) {
+      return false;
+    }
+
+    std::vector<Eigen::Vector3d> candidate = points;
+    double damping = 1e-4;  // Ceres' initial trust region radius is 1e4
+    double damping_growth = 2.0;
+    for (int iteration = 0; iteration < max_iterations_; iteration++) {
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+      if (elapsed.count() > max_time) {
+        break;
+      }
+
+      double max_gradient = 0.0;
+      for (double g : gradient) {
+        max_gradient = std::max(max_gradient, std::abs(g));
+      }
+      if (max_gradient <= gradient_tol_) {
+        break;
+      }
+
+      // Damp the normal equations by the scaled diagonal, as Ceres' Levenberg-Marquardt
+      system = hessian;
+      std::vector<double> diagonal(size_);
+      for (size_t i = 0; i < size_; i++) {
+        diagonal[i] = std::min(std::max(hessian[i * (bandwidth_ + 1)], 1e-6), 1e32);
+        system[i * (bandwidth_ + 1)] += damping * diagonal[i];
+      }
+      summary.iterations = iteration + 1;
+      if (!choleskyDecompose(system)) {
+        damping *= damping_growth;
+        damping_growth *= 2.0;
+        continue;
+      }
+      for (size_t i = 0; i < size_; i++) {
+        step[i] = -gradient[i];
+      }
+      choleskySolve(system, step);
+
+      // Stop once the step is negligible with respect to the points
+      double step_norm = 0.0;
+      double points_norm = 0.0;
+      for (size_t i = 0; i < points.size(); i++) {
+        if (variables_[i] != -1) {
+          const size_t v = 2 * variables_[i];
+          step_norm += step[v] * step[v] + step[v + 1] * step[v + 1];
+          points_norm += points[i][0] * points[i][0] + points[i][1] * points[i][1];
+        }
+      }
+      if (std::sqrt(step_norm) <= param_tol_ * (std::sqrt(points_norm) + param_tol_)) {
+        break;
+      }
+
+      for (size_t i = 0; i < points.size(); i++) {
+        if (variables_[i] != -1) {
+          const size_t v = 2 * variables_[i];
+          candidate[i][0] = points[i][0] + step[v];
+          candidate[i][1] = points[i][1] + step[v + 1];
+        }
+      }
+      const double candidate_cost = evaluateCost(blocks, candidate);
+
+      // Decrease predicted by the linearized model, given (H + damping * D) step = -g
+      double predicted = 0.0;
+      for (size_t i = 0; i < size_; i++) {
+        predicted += -0.5 * gradient[i] * step[i] + 0.5 * damping * diagonal[i] * step[i] * step[i];
+      }
+
+      if (!std::isfinite(candidate_cost) || candidate_cost >= cost || predicted <= 0.0) {
+        damping *= damping_growth;
+        damping_growth *= 2.0;
+        continue;
+      }
+
+      const double ratio = (cost - candidate_cost) / predicted;
+      damping *= std::max(1.0 / 3.0, 1.0 - std::pow(2.0 * ratio - 1.0, 3));
+      damping_growth = 2.0;
+      const double relative_decrease = (cost - candidate_cost) / cost;
+      std::swap(points, candidate);
+      cost = evaluate(blocks, points, hessian, gradient);
+      candidate = points;
+      if (relative_decrease <= fn_tol_) {
+        break;
+      }
+    }
+
+    summary.final_cost = cost;
+    return std::isfinite(cost);
+  }
+
+protected:
+  using Jet = ceres::Jet<double, 6>;
+
+  /**
+   * @brief Evaluate the cost only
+   * @param blocks Residual blocks
+   * @param points Points of the path
+   * @return Half the sum of the squared residuals, infinite if a block fails
+   */
+  double evaluateCost(
+    const std::vector<ResidualBlock> & blocks,
+    const std::vector<Eigen::Vector3d> & points) const
+  {
+    double cost = 0.0;
+    double residual[4];
+    for (const auto & block : blocks) {
+      if (!(*block.cost_function)(
+          points[block.point].data(), points[block.next_point].data(),
+          points[block.prev_point].data(), residual))
+      {
+        return std::numeric_limits<double>::infinity();
+      }
+      for (double r : residual) {
+        cost += 0.5 * r * r;
+      }
+    }
+    return cost;
+  }
+
+  /**
+   * @brief Evaluate the cost, the banded normal matrix and the gradient
+   * @param blocks Residual blocks
+   * @param points Points of the path
+   * @param hessian Output lower band of J^T J, row by row
+   * @param gradient Output J^T r
+   * @return Half the sum of the squared residuals, infinite if a block fails
+   */
+  double evaluate(
+    const std::vector<ResidualBlock> & blocks,
+    const std::vector<Eigen::Vector3d> & points,
+    std::vector<double> & hessian,
+    std::vector<double> & gradient) const
+  {
+    hessian.assign(size_ * (bandwidth_ + 1), 0.0);
+    gradient.assign(size_, 0.0);
+
+    double cost = 0.0;
+    Jet pt[2], next[2], prev[2], residual[4];
+    for (const auto & block : blocks) {
+      // Parameter k of the jets is coordinate k % 2 of point, next_point and prev_point
+      const size_t block_points[3] = {block.point, block.next_point, block.prev_point};
+      Jet * block_params[3] = {pt, next, prev};
+      int columns[6];
+      for (int p = 0; p < 3; p++) {
+        const int variable = variables_[block_points[p]];
+        for (int k = 0; k < 2; k++) {
+          block_params[p][k] = Jet(points[block_points[p]][k], 2 * p + k);
+          columns[2 * p + k] = variable == -1 ? -1 : 2 * variable + k;
+        }
+      }
+      if (!(*block.cost_function)(pt, next, prev, residual)) {
+        return std::numeric_limits<double>::infinity();
+      }
+
+      for (const Jet & r : residual) {
+        cost += 0.5 * r.a * r.a;
+        for (int a = 0; a < 6; a++) {
+          if (columns[a] == -1) {
+            continue;
+          }
+          gradient[columns[a]] += r.v[a] * r.a;
+          for (int b = 0; b < 6; b++) {
+            if (columns[b] != -1 && columns[b] <= columns[a]) {
+              hessian[columns[a] * (bandwidth_ + 1) + columns[a] - columns[b]] += r.v[a] * r.v[b];
+            }
+          }
+        }
+      }
+    }
+    return cost;
+  }
+
+  /**
+   * @brief In place Cholesky decomposition of a banded symmetric matrix
+   * @param band Lower band of the matrix row by row, replaced by the lower band of L
+   * @return False if the matrix is not positive definite
+   */
+  bool choleskyDecompose(std::vector<double> & band) const
+  {
+    const size_t w = bandwidth_ + 1;
+    for (size_t j = 0; j < size_; j++) {
+      const size_t first = j > bandwidth_ ? j - bandwidth_ : 0;
+      double diagonal = band[j * w];
+      for (size_t k = first; k < j; k++) {
+        diagonal -= band[j * w + j - k] * band[j * w + j - k];
+      }
+      if (diagonal <= 0.0 || !std::isfinite(diagonal)) {
+        return false;
+      }
+      diagonal = std::sqrt(diagonal);
+      band[j * w] = diagonal;
+
+      const size_t last = std::min(size_ - 1, j + bandwidth_);
+      for (size_t i = j + 1; i <= last; i++) {
+        double value = band[i * w + i - j];
+        for (size_t k = std::max(first, i - std::min(i, bandwidth_)); k < j; k++) {
+          value -= band[i * w + i - k] * band[j * w + j - k];
+        }
+        band[i * w + i - j] = value / diagonal;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Solve L L^T x = b given the banded Cholesky factor L
+   * @param band Lower band of L row by row
+   * @param rhs b, replaced by x
+   */
+  void choleskySolve(const std::vector<double> & band, std::vector<double> & rhs) const
+  {
+    const size_t w = bandwidth_ + 1;
+    for (size_t i = 0; i < size_; i++) {
+      const size_t first = i > bandwidth_ ? i - bandwidth_ : 0;
+      for (size_t k = first; k < i; k++) {
+        rhs[i] -= band[i * w + i - k] * rhs[k];
+      }
+      rhs[i] /= band[i * w];
+    }
+    for (size_t i = size_; i-- > 0; ) {
+      const size_t last = std::min(size_ - 1, i + bandwidth_);
+      for (size_t k = i + 1; k <= last; k++) {
+        rhs[i] -= band[k * w + k - i] * rhs[k];
+      }
+      rhs[i] /= band[i * w];
+    }
+  }
+
+  int max_iterations_;
+  double fn_tol_;
+  double gradient_tol_;
+  double param_tol_;
+  // Index of each point among the optimized ones, -1 if constant or unused
+  std::vector<int> variables_;
+  // Number of optimized coordinates and half bandwidth of the normal equations
+  size_t size_{0};
+  size_t bandwidth_{1};
+};
+
+}  // namespace nav2_constrained_smoother
+
+#endif  // NAV2_CONSTRAINED_SMOOTHER__BANDED_GAUSS_NEWTON_HPP_
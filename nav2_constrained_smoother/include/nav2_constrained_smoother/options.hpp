@@ -134,6 +134,7 @@ struct OptimizerParams
 {
   OptimizerParams()
   : debug(false),
+    warm_start(false),
     max_iterations(50),
     param_tol(1e-8),
     fn_tol(1e-6),
@@ -154,14 +155,14 @@ struct OptimizerParams
     nav2_util::declare_parameter_if_not_declared(
       node, local_name + "linear_solver_type", rclcpp::ParameterValue("SPARSE_NORMAL_CHOLESKY"));
     node->get_parameter(local_name + "linear_solver_type", linear_solver_type);
-    if (solver_types.find(linear_solver_type) == solver_types.end()) {
+    if (linear_solver_type != "BANDED" &&
+      solver_types.find(linear_solver_type) == solver_types.end())
+    {
       std::stringstream valid_types_str;
       for (auto type = solver_types.begin(); type != solver_types.end(); type++) {
-        if (type != solver_types.begin()) {
-          valid_types_str << ", ";
-        }
-        valid_types_str << type->first;
+        valid_types_str << type->first << ", ";
       }
+      valid_types_str << "BANDED";
       RCLCPP_ERROR(
         rclcpp::get_logger("constrained_smoother"),
         "Invalid linear_solver_type. Valid values are %s", valid_types_str.str().c_str());
@@ -182,13 +183,18 @@ struct OptimizerParams
     nav2_util::declare_parameter_if_not_declared(
       node, local_name + "debug_optimizer", rclcpp::ParameterValue(false));
     node->get_parameter(local_name + "debug_optimizer", debug);
+    nav2_util::declare_parameter_if_not_declared(
+      node, local_name + "warm_start", rclcpp::ParameterValue(false));
+    node->get_parameter(local_name + "warm_start", warm_start);
   }
 
+  // Ceres linear solvers, "BANDED" selecting the specialized banded solver instead of Ceres
   const std::map<std::string, ceres::LinearSolverType> solver_types = {
     {"DENSE_QR", ceres::DENSE_QR},
     {"SPARSE_NORMAL_CHOLESKY", ceres::SPARSE_NORMAL_CHOLESKY}};
 
   bool debug;
+  bool warm_start;  // initialize from the last solution where the paths overlap
   std::string linear_solver_type;
   int max_iterations;  // Ceres default: 50
 
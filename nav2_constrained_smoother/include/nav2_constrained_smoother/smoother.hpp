@@ -26,6 +26,7 @@
 #include <limits>
 #include <algorithm>
 
+#include "nav2_constrained_smoother/banded_gauss_newton.hpp"
 #include "nav2_constrained_smoother/smoother_cost_function.hpp"
 #include "nav2_constrained_smoother/utils.hpp"
 #include "nav2_core/smoother_exceptions.hpp"
@@ -60,8 +61,16 @@ public:
   void initialize(const OptimizerParams params)
   {
     debug_ = params.debug;
+    warm_start_ = params.warm_start;
+    last_path_.clear();
 
-    options_.linear_solver_type = params.solver_types.at(params.linear_solver_type);
+    banded_solver_.reset();
+    if (params.linear_solver_type == "BANDED") {
+      banded_solver_ = std::make_unique<BandedGaussNewton>(
+        params.max_iterations, params.fn_tol, params.gradient_tol, params.param_tol);
+    } else {
+      options_.linear_solver_type = params.solver_types.at(params.linear_solver_type);
+    }
 
     options_.max_num_iterations = params.max_iterations;
 
@@ -100,18 +109,56 @@ public:
 
     options_.max_solver_time_in_seconds = params.max_time;
 
-    ceres::Problem problem;
+    std::vector<ResidualBlock> blocks;
     std::vector<Eigen::Vector3d> path_optim;
     std::vector<bool> optimized;
-    if (buildProblem(path, costmap, params, problem, path_optim, optimized)) {
+    std::vector<bool> constant;
+    if (buildProblem(path, costmap, params, blocks, path_optim, optimized, constant)) {
+      if (warm_start_) {
+        warmStart(path, optimized, constant, path_optim);
+      }
+
       // solve the problem
-      ceres::Solver::Summary summary;
-      ceres::Solve(options_, &problem, &summary);
-      if (debug_) {
-        RCLCPP_INFO(rclcpp::get_logger("smoother_server"), "%s", summary.FullReport().c_str());
+      if (banded_solver_) {
+        BandedGaussNewton::Summary summary;
+        bool usable = banded_solver_->solve(blocks, constant, params.max_time, path_optim, summary);
+        if (debug_) {
+          RCLCPP_INFO(
+            rclcpp::get_logger("smoother_server"),
+            "Banded solver: %d iterations, initial cost %f, final cost %f",
+            summary.iterations, summary.initial_cost, summary.final_cost);
+        }
+        if (!usable || summary.initial_cost - summary.final_cost < 0.0) {
+          throw nav2_core::FailedToSmoothPath("Solution is not usable");
+        }
+      } else {
+        ceres::Problem problem;
+        for (auto & block : blocks) {
+          problem.AddResidualBlock(
+            block.cost_function.release()->AutoDiff(), nullptr,
+            path_optim[block.point].data(), path_optim[block.next_point].data(),
+            path_optim[block.prev_point].data());
+        }
+        for (size_t i = 0; i < constant.size(); i++) {
+          if (constant[i]) {
+            problem.SetParameterBlockConstant(path_optim[i].data());
+          }
+        }
+
+        ceres::Solver::Summary summary;
+        ceres::Solve(options_, &problem, &summary);
+        if (debug_) {
+          RCLCPP_INFO(rclcpp::get_logger("smoother_server"), "%s", summary.FullReport().c_str());
+        }
+        if (!summary.IsSolutionUsable() || summary.initial_cost - summary.final_cost < 0.0) {
+          throw nav2_core::FailedToSmoothPath("Solution is not usable");
+        }
       }
-      if (!summary.IsSolutionUsable() || summary.initial_cost - summary.final_cost < 0.0) {
-        throw nav2_core::FailedToSmoothPath("Solution is not usable");
+
+      if (warm_start_) {
+        last_path_ = path;
+        last_path_optim_ = path_optim;
+        last_optimized_ = optimized;
       }
     } else {
       RCLCPP_INFO(rclcpp::get_logger("smoother_server"), "Path too short to optimize");
@@ -128,18 +175,20 @@ private:
    * @param path Reference to path
    * @param costmap Pointer to costmap
    * @param params Smoother parameters
-   * @param problem Output problem to solve
+   * @param blocks Output residual blocks of the problem to solve
    * @param path_optim Output path on which the problem will be solved
    * @param optimized False for points skipped by downsampling
+   * @param constant Output true for the points held constant
    * @return If there is a problem to solve
    */
   bool buildProblem(
     const std::vector<Eigen::Vector3d> & path,
     const nav2_costmap_2d::Costmap2D * costmap,
     const SmootherParams & params,
-    ceres::Problem & problem,
+    std::vector<ResidualBlock> & blocks,
     std::vector<Eigen::Vector3d> & path_optim,
-    std::vector<bool> & optimized)
+    std::vector<bool> & optimized,
+    std::vector<bool> & constant)
   {
     // Create costmap grid
     costmap_grid_ = std::make_shared<ceres::Grid2D<u_char>>(
@@ -149,7 +198,6 @@ private:
 
     // Create residual blocks
     const double cusp_half_length = params.cusp_zone_length / 2;
-    ceres::LossFunction * loss_function = NULL;
     path_optim = path;
     optimized = std::vector<bool>(path.size());
     optimized[0] = true;
@@ -182,7 +230,7 @@ private:
 
       // keep distance inequalities between poses
       // (some might have been downsampled while others might not)
-      double current_segment_len = (path_optim[i] - path_optim[last_i]).block<2, 1>(0, 0).norm();
+      double current_segment_len = (path[i] - path[last_i]).block<2, 1>(0, 0).norm();
 
       // forget cost functions which don't have chance to be part of a cusp zone
       potential_cusp_funcs_len += current_segment_len;
@@ -231,9 +279,9 @@ private:
           params,
           costmap_weight
         );
-        problem.AddResidualBlock(
-          cost_function->AutoDiff(), loss_function,
-          path_optim[last_i].data(), pt.data(), path_optim[prelast_i].data());
+        blocks.push_back(
+          ResidualBlock{std::unique_ptr<SmootherCostFunction>(cost_function),
+            static_cast<size_t>(last_i), i, static_cast<size_t>(prelast_i)});
 
         potential_cusp_funcs.emplace_back(current_segment_len, cost_function);
       }
@@ -247,7 +295,10 @@ private:
       last_segment_len = std::max(EPSILON, current_segment_len);
     }
 
-    int posesToOptimize = problem.NumParameterBlocks() - 2;  // minus start and goal
+    // every optimized point is a parameter block once there is a residual block
+    int posesToOptimize = blocks.empty() ? 0 :
+      static_cast<int>(std::count(optimized.begin(), optimized.end(), true));
+    posesToOptimize -= 2;  // minus start and goal
     if (params.keep_goal_orientation) {
       posesToOptimize -= 1;  // minus goal orientation holder
     }
@@ -258,17 +309,53 @@ private:
       return false;  // nothing to optimize
     }
     // first two and last two points are constant (to keep start and end direction)
-    problem.SetParameterBlockConstant(path_optim.front().data());
+    constant = std::vector<bool>(path.size());
+    constant.front() = true;
     if (params.keep_start_orientation) {
-      problem.SetParameterBlockConstant(path_optim[1].data());
+      constant[1] = true;
     }
     if (params.keep_goal_orientation) {
-      problem.SetParameterBlockConstant(path_optim[path_optim.size() - 2].data());
+      constant[constant.size() - 2] = true;
     }
-    problem.SetParameterBlockConstant(path_optim.back().data());
+    constant.back() = true;
     return true;
   }
 
+  /**
+   * @brief Initialize the optimized points of the overlap between the path and the last
+   * smoothed path from the last solution, the original positions of a replanned path being
+   * mostly the same
+   * @param path Path to smooth
+   * @param optimized False for points skipped by downsampling
+   * @param constant True for the points held constant
+   * @param path_optim Path on which the problem will be solved
+   */
+  void warmStart(
+    const std::vector<Eigen::Vector3d> & path,
+    const std::vector<bool> & optimized,
+    const std::vector<bool> & constant,
+    std::vector<Eigen::Vector3d> & path_optim)
+  {
+    auto same_point = [](const Eigen::Vector3d & a, const Eigen::Vector3d & b) {
+        return (a - b).block<2, 1>(0, 0).squaredNorm() < EPSILON * EPSILON && a[2] * b[2] > 0;
+      };
+
+    // The new path starts further along the last one as the robot moves
+    auto overlap_start = std::find_if(
+      last_path_.begin(), last_path_.end(),
+      [&](const Eigen::Vector3d & pt) {return same_point(pt, path.front());});
+    size_t offset = overlap_start - last_path_.begin();
+    for (size_t i = 0; i < path.size() && offset + i < last_path_.size(); i++) {
+      if (!same_point(path[i], last_path_[offset + i])) {
+        break;
+      }
+      // Downsampling may keep different points when the offset changes
+      if (optimized[i] && !constant[i] && last_optimized_[offset + i]) {
+        path_optim[i].block<2, 1>(0, 0) = last_path_optim_[offset + i].block<2, 1>(0, 0);
+      }
+    }
+  }
+
   /**
    * @brief Populate optimized points to path, assigning orientations and upsampling poses using cubic bezier
    * @param path_optim Path with optimized points
@@ -393,7 +480,13 @@ private:
   }
 
   bool debug_;
+  bool warm_start_{false};
   ceres::Solver::Options options_;
+  std::unique_ptr<BandedGaussNewton> banded_solver_;
+  // Input and solution of the last successful smoothing, to warm start the next one
+  std::vector<Eigen::Vector3d> last_path_;
+  std::vector<Eigen::Vector3d> last_path_optim_;
+  std::vector<bool> last_optimized_;
   std::shared_ptr<ceres::Grid2D<u_char>> costmap_grid_;
 };
 
@@ -81,13 +81,7 @@ public:
 
   void setCostmap(nav2_msgs::msg::Costmap::SharedPtr msg)
   {
-    costmap_msg_ = msg;
-    costmap_ = std::make_shared<nav2_costmap_2d::Costmap2D>(
-      msg->metadata.size_x, msg->metadata.size_y,
-      msg->metadata.resolution, msg->metadata.origin.position.x,
-      msg->metadata.origin.position.y);
-
-    processCurrentCostmapMsg();
+    costmapCallback(msg);
   }
 };
 
@@ -127,9 +121,10 @@ protected:
       "/plan_poses_optimized_cmp", 100);
     path_poses_pub_orig_ = node_lifecycle_->create_publisher<geometry_msgs::msg::PoseArray>(
       "/plan_poses_original", 100);
+    // The publisher takes a mutable costmap, the snapshots of the subscriber are read-only
+    costmap_ = std::make_shared<nav2_costmap_2d::Costmap2D>(*costmap_sub_->getCostmap());
     costmap_pub_ = std::make_shared<nav2_costmap_2d::Costmap2DPublisher>(
-      node_lifecycle_,
-      costmap_sub_->getCostmap().get(), "map", "/costmap", true);
+      node_lifecycle_, costmap_.get(), "map", "/costmap", true);
 
     node_lifecycle_->configure();
     node_lifecycle_->activate();
@@ -399,6 +394,7 @@ protected:
   rclcpp_lifecycle::LifecyclePublisher<geometry_msgs::msg::PoseArray>::SharedPtr path_poses_pub_;
   rclcpp_lifecycle::LifecyclePublisher<geometry_msgs::msg::PoseArray>::SharedPtr
     path_poses_pub_cmp_;
+  std::shared_ptr<nav2_costmap_2d::Costmap2D> costmap_;
   std::shared_ptr<nav2_costmap_2d::Costmap2DPublisher> costmap_pub_;
 
   int cusp_i_ = -1;
@@ -1116,6 +1112,12 @@ TEST_F(SmootherTest, testingLinearSolverTypeParamValidity)
       "DENSE_QR"));
   reloadParams();
 
+  node_lifecycle_->set_parameter(
+    rclcpp::Parameter(
+      "SmoothPath.optimizer.linear_solver_type",
+      "BANDED"));
+  reloadParams();
+
   node_lifecycle_->set_parameter(
     rclcpp::Parameter(
       "SmoothPath.optimizer.linear_solver_type",
@@ -1123,6 +1125,49 @@ TEST_F(SmootherTest, testingLinearSolverTypeParamValidity)
   EXPECT_THROW(reloadParams(), std::runtime_error);
 }
 
+TEST_F(SmootherTest, testingBandedSolverAndWarmStart)
+{
+  node_lifecycle_->set_parameter(rclcpp::Parameter("SmoothPath.w_curve", 0.0));
+  reloadParams();
+
+  std::vector<Eigen::Vector3d> sharp_turn_90 =
+  {{0, 0, 0},
+    {0.1, 0, 0},
+    {0.2, 0, 0},
+    {0.3, 0, M_PI / 4},
+    {0.3, 0.1, M_PI / 2},
+    {0.3, 0.2, M_PI / 2},
+    {0.3, 0.3, M_PI / 2}
+  };
+
+  std::vector<Eigen::Vector3d> ceres_path;
+  EXPECT_TRUE(smoothPath(sharp_turn_90, ceres_path));
+
+  // the banded solver minimizes the same problem
+  node_lifecycle_->set_parameter(
+    rclcpp::Parameter("SmoothPath.optimizer.linear_solver_type", "BANDED"));
+  reloadParams();
+  std::vector<Eigen::Vector3d> banded_path;
+  EXPECT_TRUE(smoothPath(sharp_turn_90, banded_path));
+  ASSERT_EQ(banded_path.size(), ceres_path.size());
+  for (size_t i = 0; i < banded_path.size(); i++) {
+    EXPECT_NEAR(banded_path[i][0], ceres_path[i][0], 0.01);
+    EXPECT_NEAR(banded_path[i][1], ceres_path[i][1], 0.01);
+  }
+
+  // smoothing the same path again from the last solution gives the same result
+  node_lifecycle_->set_parameter(rclcpp::Parameter("SmoothPath.optimizer.warm_start", true));
+  reloadParams();
+  std::vector<Eigen::Vector3d> first_path, warm_started_path;
+  EXPECT_TRUE(smoothPath(sharp_turn_90, first_path));
+  EXPECT_TRUE(smoothPath(sharp_turn_90, warm_started_path));
+  ASSERT_EQ(warm_started_path.size(), first_path.size());
+  for (size_t i = 0; i < warm_started_path.size(); i++) {
+    EXPECT_NEAR(warm_started_path[i][0], first_path[i][0], 0.01);
+    EXPECT_NEAR(warm_started_path[i][1], first_path[i][1], 0.01);
+  }
+}
+
 int main(int argc, char ** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -15,7 +15,10 @@
 #ifndef NAV2_CONTROLLER__CONTROLLER_SERVER_HPP_
 #define NAV2_CONTROLLER__CONTROLLER_SERVER_HPP_
 
+#include <chrono>
+#include <future>
 #include <memory>
+#include <optional>
 #include <string>
 #include <thread>
 #include <unordered_map>
@@ -31,9 +34,12 @@
 #include "nav2_msgs/msg/speed_limit.hpp"
 #include "nav_2d_utils/odom_subscriber.hpp"
 #include "nav2_util/lifecycle_node.hpp"
+#include "nav2_util/node_utils.hpp"
 #include "nav2_util/simple_action_server.hpp"
 #include "nav2_util/robot_utils.hpp"
+#include "nav2_util/seqlock.hpp"
 #include "nav2_util/twist_publisher.hpp"
+#include "nav2_util/worker_thread.hpp"
 #include "pluginlib/class_loader.hpp"
 #include "pluginlib/class_list_macros.hpp"
 
@@ -52,7 +58,6 @@ public:
   using ControllerMap = std::unordered_map<std::string, nav2_core::Controller::Ptr>;
   using GoalCheckerMap = std::unordered_map<std::string, nav2_core::GoalChecker::Ptr>;
   using ProgressCheckerMap = std::unordered_map<std::string, nav2_core::ProgressChecker::Ptr>;
-
   /**
    * @brief Constructor for nav2_controller::ControllerServer
    * @param options Additional options to control creation of the node.
@@ -158,10 +163,80 @@ protected:
    * @param path Path received from action server
    */
   void setPlannerPath(const nav_msgs::msg::Path & path);
+  /**
+   * @brief Assigns the path of a goal to the controller, converting a compact path if the
+   * goal has one rather than a path
+   * @param goal Goal received from action server
+   */
+  void setGoalPath(const Action::Goal & goal);
   /**
    * @brief Calculates velocity and publishes to "cmd_vel" topic
    */
   void computeAndPublishVelocity();
+  /**
+   * @brief Calculates velocity in a worker thread while the goal is checked and the
+   * feedback computed, republishing the last command if the deadline of the cycle passes
+   * @param deadline Time by which the command of this cycle should be published
+   * @return true if the goal is reached
+   */
+  bool computeAndPublishVelocityPipelined(const std::chrono::steady_clock::time_point & deadline);
+  /**
+   * @brief Gets the pose and velocity of the robot for a cycle, checking its progress
+   * @param pose To store current pose of the robot
+   * @param twist To store the thresholded velocity of the robot
+   */
+  void prepareVelocityComputation(
+    geometry_msgs::msg::PoseStamped & pose, nav_2d_msgs::msg::Twist2D & twist);
+  /**
+   * @brief Calculates velocity with the current controller, within the failure tolerance,
+   * using the command of the fallback controller if the current one finds no valid control
+   * @param pose Current pose of the robot
+   * @param twist Current thresholded velocity of the robot
+   * @return Velocity command to publish
+   */
+  geometry_msgs::msg::TwistStamped computeVelocity(
+    const geometry_msgs::msg::PoseStamped & pose, const nav_2d_msgs::msg::Twist2D & twist);
+  /**
+   * @brief Starts computing the command of the fallback controller in its worker, from the
+   * latest pose, once the current controller of the cycle computed its command. The command
+   * is used in the next cycle, and must be waited for before touching the controllers again.
+   * @return Future done once the command is computed, or an invalid future if there is
+   * no fallback controller distinct from the current one
+   */
+  std::future<void> startFallbackVelocity();
+  /**
+   * @brief Publishes the last command of the fallback controller in place of the late command
+   * of the current controller
+   * @return true if the fallback controller computed a command to publish
+   */
+  bool publishFallbackVelocity();
+  /**
+   * @brief Applies thread settings to the calling worker thread, logging any failure
+   * @param settings Thread settings to apply
+   * @param name Name of the thread for the logs
+   */
+  void applyWorkerThreadSettings(
+    const nav2_util::ThreadSettings & settings, const std::string & name);
+  /**
+   * @brief Gets the length of the current path from its closest pose to the robot
+   * @param pose Current pose of the robot
+   * @return Distance to the goal along the path
+   */
+  double getDistanceToGoal(const geometry_msgs::msg::PoseStamped & pose);
+  /**
+   * @brief Publishes the feedback of the action for a cycle
+   * @param cmd_vel Velocity command of the cycle
+   * @param distance_to_goal Distance to the goal along the path
+   */
+  void publishFeedback(const geometry_msgs::msg::TwistStamped & cmd_vel, double distance_to_goal);
+  /**
+   * @brief Logs the timing of the cycles of the pipelined mode for the current goal
+   */
+  void reportCycleStatistics();
+  /**
+   * @brief Passes the latest speed limit to the controllers, if it changed since the last cycle
+   */
+  void applySpeedLimit();
   /**
    * @brief Calls setPlannerPath method with an updated path received from
    * action server
@@ -233,6 +308,16 @@ protected:
   std::unique_ptr<nav2_util::TwistPublisher> vel_publisher_;
   rclcpp::Subscription<nav2_msgs::msg::SpeedLimit>::SharedPtr speed_limit_sub_;
 
+  // Latest speed limit, passed to the controllers by the control loop rather than by
+  // the callback, which would otherwise wait on a controller computing a command
+  struct SpeedLimitValue
+  {
+    double speed_limit;
+    bool percentage;
+  };
+  nav2_util::SeqLock<SpeedLimitValue> speed_limit_{SpeedLimitValue{0.0, true}};
+  uint64_t applied_speed_limit_writes_{1};
+
   // Progress Checker Plugin
   pluginlib::ClassLoader<nav2_core::ProgressChecker> progress_checker_loader_;
   ProgressCheckerMap progress_checkers_;
@@ -267,6 +352,29 @@ protected:
 
   double failure_tolerance_;
   bool use_realtime_priority_;
+  bool use_pipelined_control_;
+
+  // Controller computing a command after the current one each cycle, published in the next
+  // cycle if the current one finds no valid control or misses its deadline. Empty if disabled.
+  std::string fallback_controller_;
+  std::chrono::steady_clock::duration fallback_deadline_;
+  // Last command of the fallback controller, empty if it failed or has not computed one yet
+  std::optional<geometry_msgs::msg::TwistStamped> fallback_cmd_vel_;
+
+  // Threads computing the commands of the current and fallback controllers, created only
+  // when the commands are computed off the thread of the cycles
+  std::unique_ptr<nav2_util::WorkerThread> controller_worker_;
+  std::unique_ptr<nav2_util::WorkerThread> fallback_worker_;
+
+  // Last command published, republished when the controller misses its deadline
+  geometry_msgs::msg::TwistStamped last_cmd_vel_;
+
+  // Timing of the cycles of the current goal in the pipelined mode
+  size_t cycle_count_{0};
+  size_t missed_deadlines_{0};
+  double total_latency_{0.0};
+  double max_latency_{0.0};
+  double max_jitter_{0.0};
 
   // Whether we've published the single controller warning yet
   geometry_msgs::msg::PoseStamped end_pose_;
@@ -12,7 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <chrono>
+#include <future>
 #include <vector>
 #include <memory>
 #include <string>
@@ -23,8 +25,10 @@
 #include "nav2_core/controller_exceptions.hpp"
 #include "nav_2d_utils/conversions.hpp"
 #include "nav_2d_utils/tf_help.hpp"
+#include "nav2_util/compact_path.hpp"
 #include "nav2_util/node_utils.hpp"
 #include "nav2_util/geometry_utils.hpp"
+#include "nav2_util/tracing.hpp"
 #include "nav2_controller/controller_server.hpp"
 
 using namespace std::chrono_literals;
@@ -63,6 +67,9 @@ ControllerServer::ControllerServer(const rclcpp::NodeOptions & options)
 
   declare_parameter("failure_tolerance", rclcpp::ParameterValue(0.0));
   declare_parameter("use_realtime_priority", rclcpp::ParameterValue(false));
+  declare_parameter("use_pipelined_control", rclcpp::ParameterValue(false));
+  declare_parameter("fallback_controller", rclcpp::ParameterValue(std::string("")));
+  declare_parameter("fallback_deadline", rclcpp::ParameterValue(0.0));
 
   // The costmap node is used in the implementation of the controller
   costmap_ros_ = std::make_shared<nav2_costmap_2d::Costmap2DROS>(
@@ -128,10 +135,25 @@ ControllerServer::on_configure(const rclcpp_lifecycle::State & /*state*/)
   get_parameter("speed_limit_topic", speed_limit_topic);
   get_parameter("failure_tolerance", failure_tolerance_);
   get_parameter("use_realtime_priority", use_realtime_priority_);
+  get_parameter("use_pipelined_control", use_pipelined_control_);
+  get_parameter("fallback_controller", fallback_controller_);
+  double fallback_deadline;
+  get_parameter("fallback_deadline", fallback_deadline);
+  if (fallback_deadline <= 0.0) {
+    fallback_deadline = 1.0 / controller_frequency_;
+  }
+  fallback_deadline_ = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+    std::chrono::duration<double>(fallback_deadline));
+
+  const auto costmap_thread_settings = nav2_util::declareThreadSettings(node, "costmap_thread");
+  const auto controller_thread_settings =
+    nav2_util::declareThreadSettings(node, "controller_thread");
+  const auto fallback_thread_settings = nav2_util::declareThreadSettings(node, "fallback_thread");
 
   costmap_ros_->configure();
   // Launch a thread to run the costmap node
-  costmap_thread_ = std::make_unique<nav2_util::NodeThread>(costmap_ros_);
+  costmap_thread_ = std::make_unique<nav2_util::NodeThread>(
+    costmap_ros_->get_node_base_interface(), costmap_thread_settings);
 
   for (size_t i = 0; i != progress_checker_ids_.size(); i++) {
     try {
@@ -214,6 +236,28 @@ ControllerServer::on_configure(const rclcpp_lifecycle::State & /*state*/)
     get_logger(),
     "Controller Server has %s controllers available.", controller_ids_concat_.c_str());
 
+  if (!fallback_controller_.empty()) {
+    if (controllers_.find(fallback_controller_) == controllers_.end()) {
+      RCLCPP_FATAL(
+        get_logger(), "Fallback controller %s is not one of the controller plugins.",
+        fallback_controller_.c_str());
+      return nav2_util::CallbackReturn::FAILURE;
+    }
+    RCLCPP_INFO(get_logger(), "Using %s as fallback controller.", fallback_controller_.c_str());
+    fallback_worker_ = std::make_unique<nav2_util::WorkerThread>(
+      [this, fallback_thread_settings]() {
+        applyWorkerThreadSettings(fallback_thread_settings, "fallback");
+      });
+  }
+
+  // Started once rather than every cycle, to compute the commands off the cycle thread
+  if (use_pipelined_control_ || fallback_worker_) {
+    controller_worker_ = std::make_unique<nav2_util::WorkerThread>(
+      [this, controller_thread_settings]() {
+        applyWorkerThreadSettings(controller_thread_settings, "controller");
+      });
+  }
+
   odom_sub_ = std::make_unique<nav_2d_utils::OdomSubscriber>(node);
   vel_publisher_ = std::make_unique<nav2_util::TwistPublisher>(node, "cmd_vel", 1);
 
@@ -232,6 +276,7 @@ ControllerServer::on_configure(const rclcpp_lifecycle::State & /*state*/)
       nullptr,
       std::chrono::milliseconds(500),
       true /*spin thread*/, server_options, use_realtime_priority_ /*soft realtime*/);
+    action_server_->setWorkerThreadSettings(controller_thread_settings);
   } catch (const std::runtime_error & e) {
     RCLCPP_ERROR(get_logger(), "Error creating action server! %s", e.what());
     return nav2_util::CallbackReturn::FAILURE;
@@ -322,6 +367,8 @@ ControllerServer::on_cleanup(const rclcpp_lifecycle::State & /*state*/)
 
   // Release any allocated resources
   action_server_.reset();
+  controller_worker_.reset();
+  fallback_worker_.reset();
   odom_sub_.reset();
   costmap_thread_.reset();
   vel_publisher_.reset();
@@ -446,11 +493,26 @@ void ControllerServer::computeControl()
       throw nav2_core::ControllerException("Failed to find progress checker name: " + pc_name);
     }
 
-    setPlannerPath(action_server_->get_current_goal()->path);
+    setGoalPath(*action_server_->get_current_goal());
     progress_checkers_[current_progress_checker_]->reset();
 
     last_valid_cmd_time_ = now();
     rclcpp::WallRate loop_rate(controller_frequency_);
+
+    // In the pipelined mode, cycles are scheduled on absolute deadlines rather than
+    // sleeping a period after each one, so the jitter of a cycle does not delay the next
+    const auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(1.0 / controller_frequency_));
+    auto deadline = std::chrono::steady_clock::now() + period;
+    last_cmd_vel_ = geometry_msgs::msg::TwistStamped();
+    last_cmd_vel_.header.frame_id = costmap_ros_->getBaseFrameID();
+    fallback_cmd_vel_.reset();
+    cycle_count_ = 0;
+    missed_deadlines_ = 0;
+    total_latency_ = 0.0;
+    max_latency_ = 0.0;
+    max_jitter_ = 0.0;
+
     while (rclcpp::ok()) {
       auto start_time = this->now();
 
@@ -464,6 +526,7 @@ void ControllerServer::computeControl()
           RCLCPP_INFO(get_logger(), "Cancellation was successful. Stopping the robot.");
           action_server_->terminate_all();
           publishZeroVelocity();
+          reportCycleStatistics();
           return;
         } else {
           RCLCPP_INFO_THROTTLE(
@@ -479,6 +542,28 @@ void ControllerServer::computeControl()
 
       updateGlobalPath();
 
+      applySpeedLimit();
+
+      if (use_pipelined_control_) {
+        if (computeAndPublishVelocityPipelined(deadline)) {
+          RCLCPP_INFO(get_logger(), "Reached the goal!");
+          reportCycleStatistics();
+          break;
+        }
+
+        // Start the next cycle on its deadline, or right away realigning the schedule
+        // if this one ran over a whole period
+        std::this_thread::sleep_until(deadline);
+        const auto cycle_start = std::chrono::steady_clock::now();
+        const double jitter = std::chrono::duration<double>(cycle_start - deadline).count();
+        max_jitter_ = std::max(max_jitter_, jitter);
+        deadline += period;
+        if (deadline <= cycle_start) {
+          deadline = cycle_start + period;
+        }
+        continue;
+      }
+
       computeAndPublishVelocity();
 
       if (isGoalReached()) {
@@ -560,6 +645,21 @@ void ControllerServer::computeControl()
   action_server_->succeeded_current();
 }
 
+void ControllerServer::setGoalPath(const Action::Goal & goal)
+{
+  if (!goal.path.poses.empty() || goal.compact_path.x.empty()) {
+    setPlannerPath(goal.path);
+    return;
+  }
+
+  // Expanded once at the edge of the server, the controllers taking a path
+  nav_msgs::msg::Path path;
+  if (!nav2_util::fromCompactPath(goal.compact_path, path)) {
+    throw nav2_core::InvalidPath("Compact path has arrays of different sizes.");
+  }
+  setPlannerPath(path);
+}
+
 void ControllerServer::setPlannerPath(const nav_msgs::msg::Path & path)
 {
   RCLCPP_DEBUG(
@@ -569,6 +669,9 @@ void ControllerServer::setPlannerPath(const nav_msgs::msg::Path & path)
     throw nav2_core::InvalidPath("Path is empty.");
   }
   controllers_[current_controller_]->setPlan(path);
+  if (!fallback_controller_.empty() && fallback_controller_ != current_controller_) {
+    controllers_[fallback_controller_]->setPlan(path);
+  }
 
   end_pose_ = path.poses.back();
   end_pose_.header.frame_id = path.header.frame_id;
@@ -583,8 +686,102 @@ void ControllerServer::setPlannerPath(const nav_msgs::msg::Path & path)
 
 void ControllerServer::computeAndPublishVelocity()
 {
+  NAV2_TRACE_SCOPE("ControllerServer::computeAndPublishVelocity");
   geometry_msgs::msg::PoseStamped pose;
+  nav_2d_msgs::msg::Twist2D twist;
+  prepareVelocityComputation(pose, twist);
 
+  geometry_msgs::msg::TwistStamped cmd_vel_2d;
+  if (fallback_worker_ && fallback_controller_ != current_controller_) {
+    // The controller runs in its worker so that the fallback command can be published in time.
+    // Its deadline starts once it holds the costmap, not counting the wait for a costmap update
+    auto costmap_locked = std::make_shared<std::promise<std::chrono::steady_clock::time_point>>();
+    auto costmap_locked_time = costmap_locked->get_future();
+    auto costmap_mutex = costmap_ros_->getCostmap()->getMutex();
+    auto cmd_vel_future = controller_worker_->post(
+      [this, pose, twist, costmap_mutex, costmap_locked]() {
+        // Recursive, so the controller locking it again does not wait
+        std::unique_lock<nav2_costmap_2d::Costmap2D::mutex_t> lock(*costmap_mutex);
+        costmap_locked->set_value(std::chrono::steady_clock::now());
+        return computeVelocity(pose, twist);
+      });
+    const auto deadline = costmap_locked_time.get() + fallback_deadline_;
+    if (cmd_vel_future.wait_until(deadline) == std::future_status::timeout) {
+      publishFallbackVelocity();
+    }
+    cmd_vel_2d = cmd_vel_future.get();
+  } else {
+    cmd_vel_2d = computeVelocity(pose, twist);
+  }
+  std::future<void> fallback_done = startFallbackVelocity();
+
+  publishFeedback(cmd_vel_2d, getDistanceToGoal(pose));
+
+  RCLCPP_DEBUG(get_logger(), "Publishing velocity at time %.2f", now().seconds());
+  publishVelocity(cmd_vel_2d);
+
+  if (fallback_done.valid()) {
+    fallback_done.wait();
+  }
+}
+
+bool ControllerServer::computeAndPublishVelocityPipelined(
+  const std::chrono::steady_clock::time_point & deadline)
+{
+  NAV2_TRACE_SCOPE("ControllerServer::computeAndPublishVelocityPipelined");
+  geometry_msgs::msg::PoseStamped pose;
+  nav_2d_msgs::msg::Twist2D twist;
+  prepareVelocityComputation(pose, twist);
+
+  // The controller runs in a worker while the rest of the cycle is processed here,
+  // touching neither the controller nor the path until the command is computed
+  const auto compute_start = std::chrono::steady_clock::now();
+  auto cmd_vel_future = controller_worker_->post(
+    [this, pose, twist]() {
+      return computeVelocity(pose, twist);
+    });
+
+  const double distance_to_goal = getDistanceToGoal(pose);
+  const bool goal_reached = isGoalReached();
+
+  // Keep commanding the base with the fallback or last command if the controller misses its
+  // deadline, then publish the late command as soon as it is computed
+  if (cmd_vel_future.wait_until(deadline) == std::future_status::timeout) {
+    missed_deadlines_++;
+    if (!publishFallbackVelocity()) {
+      RCLCPP_WARN(
+        get_logger(),
+        "Controller missed the deadline of its cycle at %.4f Hz, republishing the last command.",
+        controller_frequency_);
+      last_cmd_vel_.header.stamp = now();
+      publishVelocity(last_cmd_vel_);
+    }
+  }
+  geometry_msgs::msg::TwistStamped cmd_vel_2d = cmd_vel_future.get();
+  std::future<void> fallback_done = startFallbackVelocity();
+
+  const double latency = std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - compute_start).count();
+  cycle_count_++;
+  total_latency_ += latency;
+  max_latency_ = std::max(max_latency_, latency);
+  RCLCPP_DEBUG(
+    get_logger(), "Control cycle %zu computed in %.4f s, %zu missed deadlines so far",
+    cycle_count_, latency, missed_deadlines_);
+
+  publishFeedback(cmd_vel_2d, distance_to_goal);
+  publishVelocity(cmd_vel_2d);
+  last_cmd_vel_ = cmd_vel_2d;
+
+  if (fallback_done.valid()) {
+    fallback_done.wait();
+  }
+  return goal_reached;
+}
+
+void ControllerServer::prepareVelocityComputation(
+  geometry_msgs::msg::PoseStamped & pose, nav_2d_msgs::msg::Twist2D & twist)
+{
   if (!getRobotPose(pose)) {
     throw nav2_core::ControllerTFError("Failed to obtain robot pose");
   }
@@ -593,8 +790,12 @@ void ControllerServer::computeAndPublishVelocity()
     throw nav2_core::FailedToMakeProgress("Failed to make progress");
   }
 
-  nav_2d_msgs::msg::Twist2D twist = getThresholdedTwist(odom_sub_->getTwist());
+  twist = getThresholdedTwist(odom_sub_->getTwist());
+}
 
+geometry_msgs::msg::TwistStamped ControllerServer::computeVelocity(
+  const geometry_msgs::msg::PoseStamped & pose, const nav_2d_msgs::msg::Twist2D & twist)
+{
   geometry_msgs::msg::TwistStamped cmd_vel_2d;
 
   try {
@@ -609,6 +810,15 @@ void ControllerServer::computeAndPublishVelocity()
     // Only no valid control exception types are valid to attempt to have control patience, as
     // other types will not be resolved with more attempts
   } catch (nav2_core::NoValidControl & e) {
+    if (fallback_cmd_vel_) {
+      RCLCPP_WARN(
+        get_logger(), "%s, using the command of fallback controller %s.", e.what(),
+        fallback_controller_.c_str());
+      last_valid_cmd_time_ = now();
+      cmd_vel_2d = *fallback_cmd_vel_;
+      cmd_vel_2d.header.stamp = last_valid_cmd_time_;
+      return cmd_vel_2d;
+    }
     if (failure_tolerance_ > 0 || failure_tolerance_ == -1.0) {
       RCLCPP_WARN(this->get_logger(), "%s", e.what());
       cmd_vel_2d.twist.angular.x = 0;
@@ -629,32 +839,107 @@ void ControllerServer::computeAndPublishVelocity()
     }
   }
 
-  std::shared_ptr<Action::Feedback> feedback = std::make_shared<Action::Feedback>();
-  feedback->speed = std::hypot(cmd_vel_2d.twist.linear.x, cmd_vel_2d.twist.linear.y);
+  return cmd_vel_2d;
+}
 
-  // Find the closest pose to current pose on global path
-  nav_msgs::msg::Path & current_path = current_path_;
-  auto find_closest_pose_idx =
-    [&pose, &current_path]() {
-      size_t closest_pose_idx = 0;
-      double curr_min_dist = std::numeric_limits<double>::max();
-      for (size_t curr_idx = 0; curr_idx < current_path.poses.size(); ++curr_idx) {
-        double curr_dist = nav2_util::geometry_utils::euclidean_distance(
-          pose, current_path.poses[curr_idx]);
-        if (curr_dist < curr_min_dist) {
-          curr_min_dist = curr_dist;
-          closest_pose_idx = curr_idx;
-        }
+std::future<void> ControllerServer::startFallbackVelocity()
+{
+  if (!fallback_worker_ || fallback_controller_ == current_controller_) {
+    fallback_cmd_vel_.reset();
+    return std::future<void>();
+  }
+
+  // Looked up in this thread, as the controllers are looked up in the map concurrently
+  auto controller = controllers_.at(fallback_controller_);
+  auto goal_checker = goal_checkers_.at(current_goal_checker_).get();
+
+  // Computed once the current controller released the costmap, from the latest pose, so the
+  // two controllers do not wait on each other for the costmap they both hold while computing
+  return fallback_worker_->post(
+    [this, controller, goal_checker]() {
+      fallback_cmd_vel_.reset();
+      geometry_msgs::msg::PoseStamped pose;
+      if (!getRobotPose(pose)) {
+        return;
       }
-      return closest_pose_idx;
-    };
+      const nav_2d_msgs::msg::Twist2D twist = getThresholdedTwist(odom_sub_->getTwist());
+      try {
+        auto cmd_vel = controller->computeVelocityCommands(
+          pose, nav_2d_utils::twist2Dto3D(twist), goal_checker);
+        cmd_vel.header.frame_id = costmap_ros_->getBaseFrameID();
+        cmd_vel.header.stamp = now();
+        fallback_cmd_vel_ = cmd_vel;
+      } catch (const std::exception & e) {
+        RCLCPP_DEBUG(
+          get_logger(), "Fallback controller %s failed: %s", fallback_controller_.c_str(),
+          e.what());
+      }
+    });
+}
 
-  feedback->distance_to_goal =
-    nav2_util::geometry_utils::calculate_path_length(current_path_, find_closest_pose_idx());
+bool ControllerServer::publishFallbackVelocity()
+{
+  if (!fallback_cmd_vel_) {
+    return false;
+  }
+
+  RCLCPP_WARN(
+    get_logger(), "Controller %s missed its deadline, publishing the command of fallback %s.",
+    current_controller_.c_str(), fallback_controller_.c_str());
+  geometry_msgs::msg::TwistStamped cmd_vel = *fallback_cmd_vel_;
+  cmd_vel.header.stamp = now();
+  publishVelocity(cmd_vel);
+  return true;
+}
+
+void ControllerServer::applyWorkerThreadSettings(
+  const nav2_util::ThreadSettings & settings, const std::string & name)
+{
+  try {
+    nav2_util::applyThreadSettings(settings);
+  } catch (const std::exception & e) {
+    RCLCPP_ERROR(get_logger(), "Failed to configure the %s thread: %s", name.c_str(), e.what());
+  }
+}
+
+double ControllerServer::getDistanceToGoal(const geometry_msgs::msg::PoseStamped & pose)
+{
+  // Find the closest pose to current pose on global path
+  size_t closest_pose_idx = 0;
+  double curr_min_dist = std::numeric_limits<double>::max();
+  for (size_t curr_idx = 0; curr_idx < current_path_.poses.size(); ++curr_idx) {
+    double curr_dist = nav2_util::geometry_utils::euclidean_distance(
+      pose, current_path_.poses[curr_idx]);
+    if (curr_dist < curr_min_dist) {
+      curr_min_dist = curr_dist;
+      closest_pose_idx = curr_idx;
+    }
+  }
+
+  return nav2_util::geometry_utils::calculate_path_length(current_path_, closest_pose_idx);
+}
+
+void ControllerServer::publishFeedback(
+  const geometry_msgs::msg::TwistStamped & cmd_vel, double distance_to_goal)
+{
+  std::shared_ptr<Action::Feedback> feedback = std::make_shared<Action::Feedback>();
+  feedback->speed = std::hypot(cmd_vel.twist.linear.x, cmd_vel.twist.linear.y);
+  feedback->distance_to_goal = distance_to_goal;
   action_server_->publish_feedback(feedback);
+}
 
-  RCLCPP_DEBUG(get_logger(), "Publishing velocity at time %.2f", now().seconds());
-  publishVelocity(cmd_vel_2d);
+void ControllerServer::reportCycleStatistics()
+{
+  if (cycle_count_ == 0) {
+    return;
+  }
+
+  RCLCPP_INFO(
+    get_logger(),
+    "Pipelined control ran %zu cycles at %.4f Hz: mean latency %.4f s, max latency %.4f s, "
+    "max jitter %.4f s, %zu missed deadlines.",
+    cycle_count_, controller_frequency_, total_latency_ / cycle_count_, max_latency_,
+    max_jitter_, missed_deadlines_);
 }
 
 void ControllerServer::updateGlobalPath()
@@ -698,7 +983,7 @@ void ControllerServer::updateGlobalPath()
       action_server_->terminate_current();
       return;
     }
-    setPlannerPath(goal->path);
+    setGoalPath(*goal);
   }
 }
 
@@ -764,10 +1049,23 @@ bool ControllerServer::getRobotPose(geometry_msgs::msg::PoseStamped & pose)
 
 void ControllerServer::speedLimitCallback(const nav2_msgs::msg::SpeedLimit::SharedPtr msg)
 {
+  speed_limit_.store(SpeedLimitValue{msg->speed_limit, msg->percentage});
+}
+
+void ControllerServer::applySpeedLimit()
+{
+  // Count the writes before reading, so a limit written in between is applied again next cycle
+  const uint64_t writes = speed_limit_.writes();
+  if (writes == applied_speed_limit_writes_) {
+    return;
+  }
+
+  const SpeedLimitValue limit = speed_limit_.load();
   ControllerMap::iterator it;
   for (it = controllers_.begin(); it != controllers_.end(); ++it) {
-    it->second->setSpeedLimit(msg->speed_limit, msg->percentage);
+    it->second->setSpeedLimit(limit.speed_limit, limit.percentage);
   }
+  applied_speed_limit_writes_ = writes;
 }
 
 rcl_interfaces::msg::SetParametersResult
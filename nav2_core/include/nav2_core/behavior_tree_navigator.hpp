@@ -19,6 +19,7 @@
 #include <string>
 #include <vector>
 #include <mutex>
+#include <optional>
 
 #include "nav2_util/odometry_utils.hpp"
 #include "tf2_ros/buffer.h"
@@ -40,6 +41,8 @@ struct FeedbackUtils
   std::string global_frame;
   double transform_tolerance;
   std::shared_ptr<tf2_ros::Buffer> tf;
+  // Maximum rate of the action feedback, 0 to publish it at each iteration through the BT
+  double feedback_rate{0.0};
 };
 
 /**
@@ -221,6 +224,10 @@ public:
 
     BT::Blackboard::Ptr blackboard = bt_action_server_->getBlackboard();
     blackboard->set("tf_buffer", feedback_utils.tf);  // NOLINT
+    blackboard->set(
+      "robot_pose_cache", std::make_shared<nav2_behavior_tree::RobotPoseCache>(
+        feedback_utils.tf,
+        blackboard->get<std::chrono::milliseconds>("bt_loop_duration")));  // NOLINT
     blackboard->set("initial_pose_received", false);  // NOLINT
     blackboard->set("number_recoveries", 0);  // NOLINT
     blackboard->set("odom_smoother", odom_smoother);  // NOLINT
@@ -299,6 +306,7 @@ protected:
 
     if (goal_accepted) {
       plugin_muxer_->startNavigating(getName());
+      last_feedback_time_.reset();
     }
 
     return goal_accepted;
@@ -328,6 +336,26 @@ protected:
    */
   virtual void onLoop() = 0;
 
+  /**
+   * @brief Whether the action feedback is due at this iteration through the BT, limiting it
+   * to the feedback rate so that navigators skip computing feedback in between
+   * @return bool true if the feedback should be computed and published
+   */
+  bool isFeedbackDue()
+  {
+    if (feedback_utils_.feedback_rate <= 0.0) {
+      return true;
+    }
+    const rclcpp::Time now = clock_->now();
+    if (last_feedback_time_ &&
+      (now - *last_feedback_time_).seconds() < 1.0 / feedback_utils_.feedback_rate)
+    {
+      return false;
+    }
+    last_feedback_time_ = now;
+    return true;
+  }
+
   /**
    * @brief A callback that is called when a preempt is requested
    */
@@ -371,6 +399,7 @@ protected:
   rclcpp::Clock::SharedPtr clock_;
   FeedbackUtils feedback_utils_;
   NavigatorMuxer * plugin_muxer_;
+  std::optional<rclcpp::Time> last_feedback_time_;
 };
 
 }  // namespace nav2_core
@@ -15,14 +15,19 @@
 #ifndef NAV2_CORE__GLOBAL_PLANNER_HPP_
 #define NAV2_CORE__GLOBAL_PLANNER_HPP_
 
+#include <exception>
+#include <limits>
 #include <memory>
 #include <string>
+#include <vector>
 #include "rclcpp/rclcpp.hpp"
 #include "nav2_costmap_2d/costmap_2d_ros.hpp"
 #include "tf2_ros/buffer.h"
 #include "nav_msgs/msg/path.hpp"
 #include "geometry_msgs/msg/pose_stamped.hpp"
 #include "nav2_util/lifecycle_node.hpp"
+#include "nav2_util/geometry_utils.hpp"
+#include "nav2_core/planner_exceptions.hpp"
 
 namespace nav2_core
 {
@@ -78,6 +83,52 @@ public:
     const geometry_msgs::msg::PoseStamped & start,
     const geometry_msgs::msg::PoseStamped & goal,
     std::function<bool()> cancel_checker) = 0;
+
+  /**
+   * @brief Method create the plan from a starting pose to the best of a set of goals.
+   * By default, it plans to each goal in turn and keeps the shortest path, planners able
+   * to search to all the goals at once should override it.
+   * @param start The starting pose of the robot
+   * @param goals The set of goal poses to reach any of
+   * @param cancel_checker Function to check if the action has been canceled
+   * @param goal_index Index in the set of the goal reached by the plan
+   * @return      The sequence of poses to get from start to the goal reached, if any
+   */
+  virtual nav_msgs::msg::Path createPlanToGoalSet(
+    const geometry_msgs::msg::PoseStamped & start,
+    const std::vector<geometry_msgs::msg::PoseStamped> & goals,
+    std::function<bool()> cancel_checker,
+    size_t & goal_index)
+  {
+    nav_msgs::msg::Path best_path;
+    double best_length = std::numeric_limits<double>::max();
+    std::exception_ptr failure;
+    for (size_t i = 0; i != goals.size(); i++) {
+      nav_msgs::msg::Path path;
+      try {
+        path = createPlan(start, goals[i], cancel_checker);
+      } catch (const PlannerCancelled &) {
+        throw;
+      } catch (const PlannerException &) {
+        // Another goal may be reachable, report the last failure if none is
+        failure = std::current_exception();
+        continue;
+      }
+
+      const double length = nav2_util::geometry_utils::calculate_path_length(path);
+      if (!path.poses.empty() && length < best_length) {
+        best_length = length;
+        best_path = path;
+        goal_index = i;
+      }
+    }
+
+    if (best_path.poses.empty() && failure) {
+      std::rethrow_exception(failure);
+    }
+
+    return best_path;
+  }
 };
 
 }  // namespace nav2_core
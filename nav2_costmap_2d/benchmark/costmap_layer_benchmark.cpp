@@ -0,0 +1,95 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+#include "nav2_costmap_2d/cost_values.hpp"
+#include "nav2_costmap_2d/costmap_2d.hpp"
+#include "nav2_costmap_2d/costmap_layer.hpp"
+
+// Exposes the combination methods of a layer filled with random costs
+class BenchmarkLayer : public nav2_costmap_2d::CostmapLayer
+{
+public:
+  explicit BenchmarkLayer(unsigned int size)
+  {
+    resizeMap(size, size, 0.05, 0.0, 0.0);
+    enabled_ = true;
+
+    // A third of the cells unknown, a third free, the others random costs
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dist(0, 2);
+    std::uniform_int_distribution<int> cost(1, nav2_costmap_2d::LETHAL_OBSTACLE);
+    for (unsigned int i = 0; i < size * size; ++i) {
+      const int kind = dist(gen);
+      costmap_[i] = kind == 0 ? nav2_costmap_2d::NO_INFORMATION :
+        (kind == 1 ? nav2_costmap_2d::FREE_SPACE : static_cast<unsigned char>(cost(gen)));
+    }
+  }
+
+  void reset() override {}
+  bool isClearable() override {return false;}
+  void updateBounds(double, double, double, double *, double *, double *, double *) override {}
+  void updateCosts(nav2_costmap_2d::Costmap2D &, int, int, int, int) override {}
+
+  using CostmapLayer::updateWithMax;
+  using CostmapLayer::updateWithMaxWithoutUnknownOverwrite;
+  using CostmapLayer::updateWithOverwrite;
+  using CostmapLayer::updateWithTrueOverwrite;
+  using CostmapLayer::updateWithAddition;
+};
+
+enum class Method {Max, MaxWithoutUnknownOverwrite, Overwrite, TrueOverwrite, Addition};
+
+template<Method method>
+static void BM_Combination(benchmark::State & state)
+{
+  const unsigned int size = static_cast<unsigned int>(state.range(0));
+  BenchmarkLayer layer(size);
+  nav2_costmap_2d::Costmap2D master(size, size, 0.05, 0.0, 0.0, nav2_costmap_2d::NO_INFORMATION);
+  const int max = static_cast<int>(size);
+
+  for (auto _ : state) {
+    switch (method) {
+      case Method::Max:
+        layer.updateWithMax(master, 0, 0, max, max);
+        break;
+      case Method::MaxWithoutUnknownOverwrite:
+        layer.updateWithMaxWithoutUnknownOverwrite(master, 0, 0, max, max);
+        break;
+      case Method::Overwrite:
+        layer.updateWithOverwrite(master, 0, 0, max, max);
+        break;
+      case Method::TrueOverwrite:
+        layer.updateWithTrueOverwrite(master, 0, 0, max, max);
+        break;
+      case Method::Addition:
+        layer.updateWithAddition(master, 0, 0, max, max);
+        break;
+    }
+    benchmark::DoNotOptimize(master.getCharMap());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * size * size);
+}
+
+BENCHMARK_TEMPLATE(BM_Combination, Method::Max)->Arg(400)->Arg(4000);
+BENCHMARK_TEMPLATE(BM_Combination, Method::MaxWithoutUnknownOverwrite)->Arg(400)->Arg(4000);
+BENCHMARK_TEMPLATE(BM_Combination, Method::Overwrite)->Arg(400)->Arg(4000);
+BENCHMARK_TEMPLATE(BM_Combination, Method::TrueOverwrite)->Arg(400)->Arg(4000);
+BENCHMARK_TEMPLATE(BM_Combination, Method::Addition)->Arg(400)->Arg(4000);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,152 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_COSTMAP_2D__COST_PYRAMID_HPP_
+#define NAV2_COSTMAP_2D__COST_PYRAMID_HPP_
+
+#include <vector>
+
+#include "nav2_costmap_2d/costmap_2d.hpp"
+
+namespace nav2_costmap_2d
+{
+
+/**
+ * @class nav2_costmap_2d::CostPyramid
+ * @brief Maximum costs of a costmap over blocks of 4x4 cells, of 4x4 of those blocks and
+ * so on, to tell whether a region is below a cost by descending only into the blocks
+ * which are not. Updates only recompute the blocks of a window of changed cells.
+ */
+class CostPyramid
+{
+public:
+  /**
+   * @brief A constructor for nav2_costmap_2d::CostPyramid
+   */
+  CostPyramid() = default;
+
+  /**
+   * @brief Set the number of levels of blocks, the coarsest of 4^levels cells a side.
+   * Forces a full recomputation on the next update.
+   * @param num_levels Number of levels, at least 1
+   */
+  void setNumLevels(unsigned int num_levels);
+
+  /**
+   * @brief Get the number of levels of blocks
+   * @return Number of levels
+   */
+  unsigned int getNumLevels() const {return num_levels_;}
+
+  /**
+   * @brief Recompute all blocks from the costmap
+   * @param costmap Costmap to compute the blocks of, must be locked by the caller and
+   * outlive the queries until the next update
+   */
+  void update(const Costmap2D & costmap);
+
+  /**
+   * @brief Recompute the blocks of a window of cells changed since the previous update,
+   * such as given by LayeredCostmap::getUpdatedWindowSince(). All blocks are recomputed
+   * on the first update or when the costmap geometry changed.
+   * @param costmap Costmap to compute the blocks of, must be locked by the caller and
+   * outlive the queries until the next update
+   * @param x0 Lower x-boundary of the changed cells (inclusive)
+   * @param xn Upper x-boundary of the changed cells (exclusive)
+   * @param y0 Lower y-boundary of the changed cells (inclusive)
+   * @param yn Upper y-boundary of the changed cells (exclusive)
+   */
+  void update(
+    const Costmap2D & costmap, unsigned int x0, unsigned int xn,
+    unsigned int y0, unsigned int yn);
+
+  /**
+   * @brief Whether all cells of a region are below a cost
+   * @param min_x Minimum x of the region (inclusive)
+   * @param min_y Minimum y of the region (inclusive)
+   * @param max_x Maximum x of the region (inclusive)
+   * @param max_y Maximum y of the region (inclusive)
+   * @param cost Cost to compare to
+   * @return False if a cell is at or above the cost or the region leaves the costmap
+   */
+  bool isRegionBelow(
+    unsigned int min_x, unsigned int min_y, unsigned int max_x, unsigned int max_y,
+    unsigned char cost) const;
+
+  /**
+   * @brief Get the maximum cost of the cells of a region
+   * @param min_x Minimum x of the region (inclusive)
+   * @param min_y Minimum y of the region (inclusive)
+   * @param max_x Maximum x of the region (inclusive)
+   * @param max_y Maximum y of the region (inclusive)
+   * @return Maximum cost, or NO_INFORMATION if the region leaves the costmap
+   */
+  unsigned char getMaxCost(
+    unsigned int min_x, unsigned int min_y, unsigned int max_x, unsigned int max_y) const;
+
+  /**
+   * @brief Whether the blocks have been computed for a costmap
+   * @return bool If initialized
+   */
+  bool isInitialized() const {return costmap_ != nullptr;}
+
+protected:
+  /**
+   * @brief Maximum costs of the blocks of a level, row by row
+   */
+  struct Level
+  {
+    unsigned int size_x{0}, size_y{0};
+    std::vector<unsigned char> costs;
+  };
+
+  /**
+   * @brief Recompute the blocks of all levels containing a window of cells
+   * @param x0 Lower x-boundary of the cells (inclusive)
+   * @param xn Upper x-boundary of the cells (exclusive)
+   * @param y0 Lower y-boundary of the cells (inclusive)
+   * @param yn Upper y-boundary of the cells (exclusive)
+   */
+  void computeWindow(unsigned int x0, unsigned int xn, unsigned int y0, unsigned int yn);
+
+  /**
+   * @brief Whether a region of cells is below a cost, checking the blocks of a level
+   * and descending into those which are not below it but only partly in the region
+   * @param level Level of the blocks to check, -1 for the cells themselves
+   */
+  bool isRegionBelow(
+    int level, unsigned int min_x, unsigned int min_y, unsigned int max_x, unsigned int max_y,
+    unsigned char cost) const;
+
+  /**
+   * @brief Raise a maximum cost to that of a region of cells, checking the blocks of a
+   * level and descending into those above it but only partly in the region
+   * @param level Level of the blocks to check, -1 for the cells themselves
+   */
+  void raiseToMaxCost(
+    int level, unsigned int min_x, unsigned int min_y, unsigned int max_x, unsigned int max_y,
+    unsigned char & max_cost) const;
+
+  const Costmap2D * costmap_{nullptr};
+  const unsigned char * charmap_{nullptr};
+  unsigned int size_x_{0}, size_y_{0};
+  double origin_x_{0.0}, origin_y_{0.0};
+  double resolution_{0.0};
+  unsigned int num_levels_{2};
+  std::vector<Level> levels_;
+};
+
+}  // namespace nav2_costmap_2d
+
+#endif  // NAV2_COSTMAP_2D__COST_PYRAMID_HPP_
@@ -49,6 +49,7 @@
 #include <mutex>
 #include "geometry_msgs/msg/point.hpp"
 #include "nav_msgs/msg/occupancy_grid.hpp"
+#include "nav2_util/memory_registry.hpp"
 
 namespace nav2_costmap_2d
 {
@@ -213,6 +214,94 @@ public:
    */
   void worldToMapEnforceBounds(double wx, double wy, int & mx, int & my) const;
 
+  /**
+   * @brief  Convert arrays of world coordinates to map coordinates, giving the same
+   * results as worldToMap() for each point. The loop has no branches on the points so
+   * that the compiler may vectorize it.
+   * @param  wx The x world coordinates
+   * @param  wy The y world coordinates
+   * @param  count The number of points
+   * @param  mx Will be set to the associated map x coordinates, 0 for invalid points
+   * @param  my Will be set to the associated map y coordinates, 0 for invalid points
+   * @param  valid Will be set to 1 for the points in legal bounds, 0 otherwise
+   * @return The number of points in legal bounds
+   */
+  template<typename T>
+  size_t worldToMap(
+    const T * wx, const T * wy, size_t count,
+    unsigned int * mx, unsigned int * my, unsigned char * valid) const
+  {
+    const double size_x = static_cast<double>(size_x_);
+    const double size_y = static_cast<double>(size_y_);
+    size_t num_valid = 0;
+    for (size_t i = 0; i < count; i++) {
+      const double dx = static_cast<double>(wx[i]) - origin_x_;
+      const double dy = static_cast<double>(wy[i]) - origin_y_;
+      const double fx = dx / resolution_;
+      const double fy = dy / resolution_;
+      // Not a number fails all of the comparisons, so is invalid
+      const bool in_bounds = dx >= 0.0 && dy >= 0.0 && fx < size_x && fy < size_y;
+      // Clamp before casting so that invalid points are never out of range of the cast
+      const unsigned int cx = static_cast<unsigned int>(std::min(std::max(0.0, fx), size_x));
+      const unsigned int cy = static_cast<unsigned int>(std::min(std::max(0.0, fy), size_y));
+      mx[i] = in_bounds ? cx : 0u;
+      my[i] = in_bounds ? cy : 0u;
+      valid[i] = static_cast<unsigned char>(in_bounds);
+      num_valid += in_bounds;
+    }
+    return num_valid;
+  }
+
+  /**
+   * @brief  Convert arrays of world coordinates to continuous map coordinates, giving the
+   * same results as worldToMapContinuous() for each point
+   * @param  wx The x world coordinates
+   * @param  wy The y world coordinates
+   * @param  count The number of points
+   * @param  mx Will be set to the associated map x coordinates, meaningful only if valid
+   * @param  my Will be set to the associated map y coordinates, meaningful only if valid
+   * @param  valid Will be set to 1 for the points in legal bounds, 0 otherwise
+   * @return The number of points in legal bounds
+   */
+  template<typename T>
+  size_t worldToMapContinuous(
+    const T * wx, const T * wy, size_t count,
+    float * mx, float * my, unsigned char * valid) const
+  {
+    const float size_x = static_cast<float>(size_x_);
+    const float size_y = static_cast<float>(size_y_);
+    size_t num_valid = 0;
+    for (size_t i = 0; i < count; i++) {
+      const double dx = static_cast<double>(wx[i]) - origin_x_;
+      const double dy = static_cast<double>(wy[i]) - origin_y_;
+      mx[i] = static_cast<float>(dx / resolution_) + 0.5f;
+      my[i] = static_cast<float>(dy / resolution_) + 0.5f;
+      const bool in_bounds = dx >= 0.0 && dy >= 0.0 && mx[i] < size_x && my[i] < size_y;
+      valid[i] = static_cast<unsigned char>(in_bounds);
+      num_valid += in_bounds;
+    }
+    return num_valid;
+  }
+
+  /**
+   * @brief  Convert arrays of map coordinates to world coordinates, giving the same
+   * results as mapToWorld() for each cell
+   * @param  mx The x map coordinates
+   * @param  my The y map coordinates
+   * @param  count The number of cells
+   * @param  wx Will be set to the associated world x coordinates
+   * @param  wy Will be set to the associated world y coordinates
+   */
+  template<typename T>
+  void mapToWorld(
+    const unsigned int * mx, const unsigned int * my, size_t count, T * wx, T * wy) const
+  {
+    for (size_t i = 0; i < count; i++) {
+      wx[i] = static_cast<T>(origin_x_ + (mx[i] + 0.5) * resolution_);
+      wy[i] = static_cast<T>(origin_y_ + (my[i] + 0.5) * resolution_);
+    }
+  }
+
   /**
    * @brief  Given two map coordinates... compute the associated index
    * @param mx The x coordinate
@@ -297,11 +386,18 @@ public:
    * @brief Get the default background value of the costmap
    * @return default value
    */
-  unsigned char getDefaultValue()
+  unsigned char getDefaultValue() const
   {
     return default_value_;
   }
 
+  /**
+   * @brief Set the tag the bytes of the costmap are accounted to in the
+   * nav2_util::MemoryRegistry, "costmap_2d" by default
+   * @param tag Tag of the costmap
+   */
+  void setMemoryTag(const std::string & tag);
+
   /**
    * @brief  Sets the cost of a convex polygon to a desired value
    * @param polygon The polygon to perform the operation on
@@ -409,6 +505,43 @@ protected:
     }
   }
 
+  /**
+   * @brief  Shift the contents of a map in place, for a new origin of the map
+   * @param map The map to shift
+   * @param size_x The x size of the map
+   * @param size_y The y size of the map
+   * @param cell_ox The x coordinate of the new origin in the map (cells)
+   * @param cell_oy The y coordinate of the new origin in the map (cells)
+   * @param value The value of the cells which were outside of the map
+   */
+  template<typename data_type>
+  void shiftMapRegion(
+    data_type * map, unsigned int size_x, unsigned int size_y, int cell_ox, int cell_oy,
+    data_type value)
+  {
+    // cell (x, y) of the shifted map was cell (x + cell_ox, y + cell_oy) of the map
+    const int sx = size_x, sy = size_y;
+    const int min_x = std::min(std::max(-cell_ox, 0), sx);
+    const int max_x = std::max(std::min(sx - cell_ox, sx), min_x);
+    const int min_y = std::min(std::max(-cell_oy, 0), sy);
+    const int max_y = std::max(std::min(sy - cell_oy, sy), min_y);
+
+    // rows are moved in the direction which never overwrites a row still to be moved
+    for (int i = 0; i < max_y - min_y; ++i) {
+      const int y = cell_oy > 0 ? min_y + i : max_y - 1 - i;
+      data_type * row = map + y * size_x;
+      if (min_x < max_x) {
+        memmove(
+          row + min_x, map + (y + cell_oy) * size_x + min_x + cell_ox,
+          (max_x - min_x) * sizeof(data_type));
+      }
+      std::fill(row, row + min_x, value);
+      std::fill(row + max_x, row + size_x, value);
+    }
+    std::fill(map, map + min_y * size_x, value);
+    std::fill(map + max_y * size_x, map + size_y * size_x, value);
+  }
+
   /**
    * @brief  Deletes the costmap, static_map, and markers data structures
    */
@@ -535,6 +668,7 @@ protected:
   double origin_y_;
   unsigned char * costmap_;
   unsigned char default_value_;
+  nav2_util::MemoryTracker memory_tracker_{"costmap_2d"};
 
   // *INDENT-OFF* Uncrustify doesn't handle indented public/private labels
   class MarkCell
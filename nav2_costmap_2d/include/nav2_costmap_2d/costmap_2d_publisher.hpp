@@ -42,6 +42,7 @@
 #include <algorithm>
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "rclcpp_lifecycle/lifecycle_node.hpp"
 #include "nav2_costmap_2d/costmap_2d.hpp"
@@ -49,9 +50,11 @@
 #include "map_msgs/msg/occupancy_grid_update.hpp"
 #include "nav2_msgs/msg/costmap.hpp"
 #include "nav2_msgs/msg/costmap_update.hpp"
+#include "nav2_msgs/msg/costmap_delta.hpp"
 #include "nav2_msgs/srv/get_costmap.hpp"
 #include "tf2/transform_datatypes.h"
 #include "nav2_util/lifecycle_node.hpp"
+#include "nav2_util/translation_table.hpp"
 #include "tf2/LinearMath/Quaternion.h"
 #include "tf2_geometry_msgs/tf2_geometry_msgs.hpp"
 
@@ -93,6 +96,7 @@ public:
     costmap_update_pub_->on_activate();
     costmap_raw_pub_->on_activate();
     costmap_raw_update_pub_->on_activate();
+    costmap_raw_delta_pub_->on_activate();
   }
 
   /**
@@ -104,6 +108,7 @@ public:
     costmap_update_pub_->on_deactivate();
     costmap_raw_pub_->on_deactivate();
     costmap_raw_update_pub_->on_deactivate();
+    costmap_raw_delta_pub_->on_deactivate();
   }
 
   /**
@@ -143,6 +148,8 @@ private:
   std::unique_ptr<map_msgs::msg::OccupancyGridUpdate> createGridUpdateMsg();
   /** @brief Prepare CostmapUpdate msg for publication. */
   std::unique_ptr<nav2_msgs::msg::CostmapUpdate> createCostmapUpdateMsg();
+  /** @brief Prepare CostmapDelta msg with the tiles changed since the last one. */
+  std::unique_ptr<nav2_msgs::msg::CostmapDelta> createCostmapDeltaMsg();
 
   /** @brief Publish the latest full costmap to the new subscriber. */
   // void onNewSubscription(const ros::SingleSubscriberPublisher& pub);
@@ -177,6 +184,16 @@ private:
   rclcpp_lifecycle::LifecyclePublisher<nav2_msgs::msg::CostmapUpdate>::SharedPtr
     costmap_raw_update_pub_;
 
+  // Publisher for tiled, run-length encoded changes of the raw costmap
+  rclcpp_lifecycle::LifecyclePublisher<nav2_msgs::msg::CostmapDelta>::SharedPtr
+    costmap_raw_delta_pub_;
+  // Costs, geometry and subscribers as of the last delta
+  std::vector<unsigned char> delta_reference_;
+  double delta_origin_x_{0.0}, delta_origin_y_{0.0}, delta_resolution_{0.0};
+  size_t delta_subscribers_{0};
+  uint32_t delta_sequence_{0};
+  unsigned int deltas_since_keyframe_{0};
+
   // Service for getting the costmaps
   rclcpp::Service<nav2_msgs::srv::GetCostmap>::SharedPtr costmap_service_;
 
@@ -185,7 +202,7 @@ private:
   std::unique_ptr<nav_msgs::msg::OccupancyGrid> grid_;
   std::unique_ptr<nav2_msgs::msg::Costmap> costmap_raw_;
   // Translate from 0-255 values in costmap to -1 to 100 values in message.
-  static char * cost_translation_table_;
+  static const nav2_util::ByteTranslationTable<int8_t> cost_translation_table_;
 };
 
 }  // namespace nav2_costmap_2d
@@ -39,6 +39,7 @@
 #define NAV2_COSTMAP_2D__COSTMAP_2D_ROS_HPP_
 
 #include <atomic>
+#include <condition_variable>
 #include <memory>
 #include <string>
 #include <vector>
@@ -50,8 +51,12 @@
 #include "nav2_costmap_2d/clear_costmap_service.hpp"
 #include "nav2_costmap_2d/layered_costmap.hpp"
 #include "nav2_costmap_2d/layer.hpp"
+#include "nav2_costmap_2d/multi_resolution_costmap.hpp"
+#include "nav2_msgs/srv/save_costmap_snapshot.hpp"
 #include "nav2_util/lifecycle_node.hpp"
+#include "nav2_util/robot_pose_cache.hpp"
 #include "pluginlib/class_loader.hpp"
+#include "std_msgs/msg/float32.hpp"
 #include "tf2/convert.h"
 #include "tf2/LinearMath/Transform.h"
 #include "tf2_ros/buffer.h"
@@ -161,8 +166,9 @@ public:
    * @brief  Subscribes to sensor topics if necessary and starts costmap
    * updates, can be called to restart the costmap after calls to either
    * stop() or pause()
+   * @param wait_for_update Whether to block until the costmap completed an update
    */
-  void start();
+  void start(bool wait_for_update = true);
 
   /**
    * @brief  Stops costmap updates and unsubscribes from sensor topics
@@ -218,6 +224,15 @@ public:
     return name_;
   }
 
+  /**
+   * @brief Get the load of the update loop, the smoothed ratio of the time taken
+   * by the updates of the costmap to the update period
+   */
+  double getUpdateLoad() const
+  {
+    return update_load_.load();
+  }
+
   /** @brief Returns the delay in transform (tf) data that is tolerable in seconds */
   double getTransformTolerance() const
   {
@@ -234,6 +249,17 @@ public:
     return layered_costmap_->getCostmap();
   }
 
+  /**
+   * @brief Return an immutable snapshot of the "master" costmap as of the last update,
+   * which can be read without locking its mutex.
+   *
+   * Same as calling getLayeredCostmap()->getCostmapSnapshot().
+   */
+  std::shared_ptr<const Costmap2D> getCostmapSnapshot()
+  {
+    return layered_costmap_->getCostmapSnapshot();
+  }
+
   /**
    * @brief  Returns the global frame of the costmap
    * @return The global frame of the costmap
@@ -260,6 +286,25 @@ public:
     return layered_costmap_.get();
   }
 
+  /**
+   * @brief Get the layered costmap of the inner window, if the inner_window parameters set one
+   * @return Inner layered costmap or nullptr
+   */
+  LayeredCostmap * getInnerLayeredCostmap()
+  {
+    return inner_layered_costmap_.get();
+  }
+
+  /**
+   * @brief Get the costmaps to query for costs at the finest resolution available, the
+   * inner window near the robot and the costmap elsewhere
+   * @return Multi-resolution costmap, set while configured
+   */
+  std::shared_ptr<MultiResolutionCostmap> getMultiResolutionCostmap()
+  {
+    return multi_resolution_costmap_;
+  }
+
   /** @brief Returns the current padded footprint as a geometry_msgs::msg::Polygon. */
   geometry_msgs::msg::Polygon getRobotFootprintPolygon()
   {
@@ -344,8 +389,10 @@ protected:
   rclcpp_lifecycle::LifecyclePublisher<geometry_msgs::msg::PolygonStamped>::SharedPtr
     footprint_pub_;
   std::unique_ptr<Costmap2DPublisher> costmap_publisher_;
+  std::unique_ptr<Costmap2DPublisher> inner_costmap_publisher_;
 
   std::vector<std::unique_ptr<Costmap2DPublisher>> layer_publishers_;
+  rclcpp_lifecycle::LifecyclePublisher<std_msgs::msg::Float32>::SharedPtr update_load_pub_;
 
   rclcpp::Subscription<geometry_msgs::msg::Polygon>::SharedPtr footprint_sub_;
   rclcpp::Subscription<rcl_interfaces::msg::ParameterEvent>::SharedPtr parameter_sub_;
@@ -354,12 +401,15 @@ protected:
   rclcpp::CallbackGroup::SharedPtr callback_group_;
   rclcpp::executors::SingleThreadedExecutor::SharedPtr executor_;
   std::unique_ptr<nav2_util::NodeThread> executor_thread_;
+  nav2_util::ThreadSettings executor_thread_settings_;
 
   // Transform listener
   std::shared_ptr<tf2_ros::Buffer> tf_buffer_;
   std::shared_ptr<tf2_ros::TransformListener> tf_listener_;
 
   std::unique_ptr<LayeredCostmap> layered_costmap_{nullptr};
+  std::unique_ptr<LayeredCostmap> inner_layered_costmap_{nullptr};
+  std::shared_ptr<MultiResolutionCostmap> multi_resolution_costmap_;
   std::string name_;
   std::string parent_namespace_;
 
@@ -373,14 +423,66 @@ protected:
   std::atomic<bool> stopped_{true};
   std::mutex _dynamic_parameter_mutex;
   std::unique_ptr<std::thread> map_update_thread_;  ///< @brief A thread for updating the map
+  nav2_util::ThreadSettings map_update_thread_settings_;
   rclcpp::Time last_publish_{0, 0, RCL_ROS_TIME};
   rclcpp::Duration publish_cycle_{1, 0};
+
+  /**
+   * @brief Update the load of the update loop with the time taken by an update, and
+   * decimate the deferrable layers more or less to keep up with the update rate and
+   * within their time budgets
+   * @param update_time Seconds taken by the update
+   * @param period Update period in seconds
+   */
+  void updateLoad(double update_time, double period);
+
+  /**
+   * @brief Publish the costmaps whenever the update loop requests it, when publishing
+   * in its own thread
+   */
+  void publishLoop();
+
+  /**
+   * @brief Publish the master costmap and the costmaps of the layers
+   */
+  void publishCostmaps();
+
+  std::unique_ptr<std::thread> publish_thread_;  ///< @brief A thread publishing the costmaps
+  std::mutex publish_mutex_;
+  std::condition_variable publish_cv_;
+  bool publish_requested_{false};
+  bool publish_thread_shutdown_{false};
+  /// Window of the master costmap updated since the last publication by the publish thread
+  unsigned int publish_x0_, publish_xn_{0}, publish_y0_, publish_yn_{0};
+  std::atomic<double> update_load_{0.0};
+  /// Decimation of the deferrable layers for the load, and of each one with its time budget
+  unsigned int layer_decimation_{1};
+  std::vector<unsigned int> layer_decimations_;
   pluginlib::ClassLoader<Layer> plugin_loader_{"nav2_costmap_2d", "nav2_costmap_2d::Layer"};
 
   /**
    * @brief Get parameters for node
    */
   void getParameters();
+
+  /**
+   * @brief Load the layer plugins and filters into a layered costmap, initializing them in turn
+   * @param layered_costmap Layered costmap to add them to
+   */
+  void initializePlugins(LayeredCostmap * layered_costmap);
+
+  /**
+   * @brief Load the layer plugins and filters into a layered costmap, then initialize them
+   * concurrently
+   * @param layered_costmap Layered costmap to add them to
+   */
+  void initializePluginsInParallel(LayeredCostmap * layered_costmap);
+
+  /**
+   * @brief Get the layered costmaps of the node, the inner one last if any
+   * @return Layered costmaps, none before on_configure
+   */
+  std::vector<LayeredCostmap *> getLayeredCostmaps();
   bool always_send_full_costmap_{false};
   std::string footprint_;
   float footprint_padding_{0};
@@ -391,6 +493,16 @@ protected:
   int map_width_meters_{0};
   double origin_x_{0};
   double origin_y_{0};
+  double inner_window_width_{0.0};
+  double inner_window_height_{0.0};
+  double inner_window_resolution_{0.025};
+  bool parallel_layer_updates_{false};
+  bool parallel_plugin_initialization_{false};
+  bool threaded_publishing_{false};
+  std::vector<std::string> deferrable_layers_;
+  std::vector<double> layer_time_budgets_;  ///< Seconds per update of the deferrable layers
+  int max_layer_decimation_{4};
+  bool wait_for_first_update_{true};
   std::vector<std::string> default_plugins_;
   std::vector<std::string> default_types_;
   std::vector<std::string> plugin_names_;
@@ -401,8 +513,13 @@ protected:
   std::string robot_base_frame_;            ///< The frame_id of the robot base
   double robot_radius_;
   bool rolling_window_{false};          ///< Whether to use a rolling window version of the costmap
+  bool share_costmap_intra_process_{false};
+  std::string shared_topic_name_;  ///< Topic the costmap is registered under, if shared
   bool track_unknown_space_{false};
   double transform_tolerance_{0};           ///< The timeout before transform errors
+  bool use_robot_pose_cache_{false};
+  /// Latest robot pose of the process, read instead of looking it up in TF if used
+  std::shared_ptr<nav2_util::RobotPoseCache> robot_pose_cache_;
   double initial_transform_timeout_{0};   ///< The timeout before activation of the node errors
 
   bool is_lifecycle_follower_{true};   ///< whether is a child-LifecycleNode or an independent node
@@ -413,6 +530,16 @@ protected:
   std::vector<geometry_msgs::msg::Point> padded_footprint_;
 
   std::unique_ptr<ClearCostmapService> clear_costmap_service_;
+  rclcpp::Service<nav2_msgs::srv::SaveCostmapSnapshot>::SharedPtr save_snapshot_service_;
+
+  /**
+   * @brief Save a snapshot of the costmap, its layers, the footprint and the pose of the
+   * robot, with the path of the request, to replay them offline
+   */
+  void saveSnapshotCallback(
+    const std::shared_ptr<rmw_request_id_t> request_header,
+    const std::shared_ptr<nav2_msgs::srv::SaveCostmapSnapshot::Request> request,
+    const std::shared_ptr<nav2_msgs::srv::SaveCostmapSnapshot::Response> response);
 
   // Dynamic parameters handler
   OnSetParametersCallbackHandle::SharedPtr dyn_params_handler;
@@ -0,0 +1,82 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_COSTMAP_2D__COSTMAP_DELTA_HPP_
+#define NAV2_COSTMAP_2D__COSTMAP_DELTA_HPP_
+
+#include <cstddef>
+#include <vector>
+
+#include "nav2_costmap_2d/costmap_2d.hpp"
+#include "nav2_msgs/msg/costmap_delta.hpp"
+
+namespace nav2_costmap_2d
+{
+
+/**
+ * @brief Run-length encode a window of a costmap as (count, cost) pairs
+ * @param costmap Costs of the costmap
+ * @param size_x Width of the costmap (cells)
+ * @param x0 Lower x-boundary of the window (inclusive)
+ * @param y0 Lower y-boundary of the window (inclusive)
+ * @param xn Upper x-boundary of the window (exclusive)
+ * @param yn Upper y-boundary of the window (exclusive)
+ * @param data Output to append the runs to
+ */
+void encodeCostmapWindow(
+  const unsigned char * costmap, unsigned int size_x,
+  unsigned int x0, unsigned int y0, unsigned int xn, unsigned int yn,
+  std::vector<unsigned char> & data);
+
+/**
+ * @brief Decode a window of a costmap encoded by encodeCostmapWindow
+ * @param data Encoded runs
+ * @param offset Offset of the window in data, moved past its runs
+ * @param costmap Costs of the costmap to write the window to
+ * @param size_x Width of the costmap (cells)
+ * @param x0 Lower x-boundary of the window (inclusive)
+ * @param y0 Lower y-boundary of the window (inclusive)
+ * @param xn Upper x-boundary of the window (exclusive)
+ * @param yn Upper y-boundary of the window (exclusive)
+ * @return False if the runs do not match the window
+ */
+bool decodeCostmapWindow(
+  const std::vector<unsigned char> & data, size_t & offset,
+  unsigned char * costmap, unsigned int size_x,
+  unsigned int x0, unsigned int y0, unsigned int xn, unsigned int yn);
+
+/**
+ * @brief Fill a delta with the tiles of a costmap which differ from a reference copy
+ * of it, and update the reference to the costmap
+ * @param costmap Costmap to encode, must be locked by the caller
+ * @param reference Costs at the previous delta, resized to the costmap for keyframes
+ * @param keyframe Whether to include all tiles rather than only changed ones
+ * @param tile_size Width and height of the tiles (cells)
+ * @param msg Delta to fill, apart from the header and sequence
+ */
+void createCostmapDelta(
+  const Costmap2D & costmap, std::vector<unsigned char> & reference, bool keyframe,
+  unsigned int tile_size, nav2_msgs::msg::CostmapDelta & msg);
+
+/**
+ * @brief Write the tiles of a delta to a costmap of the same size
+ * @param msg Delta to apply
+ * @param costmap Costmap to write to, must be locked by the caller
+ * @return False if the sizes differ or the delta is malformed
+ */
+bool applyCostmapDelta(const nav2_msgs::msg::CostmapDelta & msg, Costmap2D & costmap);
+
+}  // namespace nav2_costmap_2d
+
+#endif  // NAV2_COSTMAP_2D__COSTMAP_DELTA_HPP_
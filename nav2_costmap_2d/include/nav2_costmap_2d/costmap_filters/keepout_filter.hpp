@@ -40,11 +40,13 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "nav2_costmap_2d/costmap_filters/costmap_filter.hpp"
 
 #include "rclcpp/rclcpp.hpp"
 #include "nav2_msgs/msg/costmap_filter_info.hpp"
+#include "tf2/LinearMath/Transform.h"
 
 namespace nav2_costmap_2d
 {
@@ -96,12 +98,50 @@ private:
    */
   void maskCallback(const nav_msgs::msg::OccupancyGrid::SharedPtr msg);
 
+  /**
+   * @brief Make the keepout costs resampled to the master grid cover a window of it,
+   * reusing the ones of the previous cycles while the mask, the transform to its frame
+   * and the grid (up to shifts of its origin) remain the same
+   * @param master_grid Grid the costs are aligned to
+   * @param mask_transform Transform from the master grid frame to the mask frame
+   * @param min_i Lower x-boundary of the window (inclusive)
+   * @param min_j Lower y-boundary of the window (inclusive)
+   * @param max_i Upper x-boundary of the window (exclusive)
+   * @param max_j Upper y-boundary of the window (exclusive)
+   */
+  void updateAlignedMask(
+    const nav2_costmap_2d::Costmap2D & master_grid, const tf2::Transform & mask_transform,
+    int min_i, int min_j, int max_i, int max_j);
+
+  /**
+   * @brief Resample the keepout costs of a window of the master grid from the mask
+   * @param master_grid Grid the costs are aligned to
+   * @param mask_transform Transform from the master grid frame to the mask frame
+   * @param min_i Lower x-boundary of the window (inclusive)
+   * @param min_j Lower y-boundary of the window (inclusive)
+   * @param max_i Upper x-boundary of the window (exclusive)
+   * @param max_j Upper y-boundary of the window (exclusive)
+   */
+  void alignMaskWindow(
+    const nav2_costmap_2d::Costmap2D & master_grid, const tf2::Transform & mask_transform,
+    int min_i, int min_j, int max_i, int max_j);
+
   rclcpp::Subscription<nav2_msgs::msg::CostmapFilterInfo>::SharedPtr filter_info_sub_;
   rclcpp::Subscription<nav_msgs::msg::OccupancyGrid>::SharedPtr mask_sub_;
 
   nav_msgs::msg::OccupancyGrid::SharedPtr filter_mask_;
 
   std::string global_frame_;  // Frame of currnet layer (master_grid)
+
+  // Keepout costs of the master_grid cells, NO_INFORMATION outside of the mask, which are
+  // valid in the [aligned_min_x_, aligned_max_x_) x [aligned_min_y_, aligned_max_y_) window
+  std::vector<unsigned char> aligned_mask_, aligned_mask_spare_;
+  int aligned_min_x_{0}, aligned_min_y_{0}, aligned_max_x_{0}, aligned_max_y_{0};
+  // Mask, transform and master_grid geometry the costs were resampled for
+  nav_msgs::msg::OccupancyGrid::SharedPtr aligned_filter_mask_;
+  tf2::Transform aligned_transform_;
+  unsigned int aligned_size_x_{0}, aligned_size_y_{0};
+  double aligned_resolution_{0.0}, aligned_origin_x_{0.0}, aligned_origin_y_{0.0};
 };
 
 }  // namespace nav2_costmap_2d
@@ -60,7 +60,10 @@ public:
   CostmapLayer()
   : has_extra_bounds_(false),
     extra_min_x_(1e6), extra_max_x_(-1e6),
-    extra_min_y_(1e6), extra_max_y_(-1e6) {}
+    extra_min_y_(1e6), extra_max_y_(-1e6)
+  {
+    setMemoryTag("costmap_2d/layers");
+  }
 
   /**
    * @brief If layer is discrete
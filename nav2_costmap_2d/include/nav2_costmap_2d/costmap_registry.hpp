@@ -0,0 +1,63 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_COSTMAP_2D__COSTMAP_REGISTRY_HPP_
+#define NAV2_COSTMAP_2D__COSTMAP_REGISTRY_HPP_
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "nav2_costmap_2d/costmap_2d.hpp"
+
+namespace nav2_costmap_2d
+{
+
+/**
+ * @class CostmapRegistry
+ * @brief Process-wide table of the costmaps published by this process, so that
+ * subscribers composed in the same process can share the producer's read-only
+ * snapshots of its master costmap instead of deserializing copies of it
+ */
+class CostmapRegistry
+{
+public:
+  using SnapshotProvider = std::function<std::shared_ptr<const Costmap2D>()>;
+
+  /**
+   * @brief Register the producer of a costmap topic, replacing any previous one
+   * @param topic_name Fully resolved name of the costmap topic
+   * @param provider Returns the latest snapshot of the costmap, which must not
+   * change after it is returned. Not called after the topic is removed.
+   */
+  static void add(const std::string & topic_name, SnapshotProvider provider);
+
+  /**
+   * @brief Unregister the producer of a costmap topic, waiting for calls
+   * to its provider in progress
+   * @param topic_name Fully resolved name of the costmap topic
+   */
+  static void remove(const std::string & topic_name);
+
+  /**
+   * @brief Get the latest snapshot of a costmap produced by this process
+   * @param topic_name Fully resolved name of the costmap topic
+   * @return The snapshot, or nullptr if no producer in this process is registered
+   */
+  static std::shared_ptr<const Costmap2D> getSnapshot(const std::string & topic_name);
+};
+
+}  // namespace nav2_costmap_2d
+
+#endif  // NAV2_COSTMAP_2D__COSTMAP_REGISTRY_HPP_
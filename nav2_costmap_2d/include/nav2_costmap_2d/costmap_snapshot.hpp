@@ -0,0 +1,70 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef NAV2_COSTMAP_2D__COSTMAP_SNAPSHOT_HPP_
+#define NAV2_COSTMAP_2D__COSTMAP_SNAPSHOT_HPP_
+
+#include <string>
+#include <vector>
+
+#include "nav2_costmap_2d/costmap_2d.hpp"
+#include "nav2_msgs/msg/costmap_meta_data.hpp"
+#include "nav2_msgs/msg/costmap_snapshot.hpp"
+
+namespace nav2_costmap_2d
+{
+
+/**
+ * @brief Encode a costmap as in a nav2_msgs::msg::CostmapSnapshot
+ * @param costmap Costmap to encode, must be locked by the caller
+ * @param metadata Metadata to fill, apart from the times and the layer
+ * @param data Output for the runs of the costs
+ */
+void encodeCostmap(
+  const Costmap2D & costmap, nav2_msgs::msg::CostmapMetaData & metadata,
+  std::vector<unsigned char> & data);
+
+/**
+ * @brief Decode a costmap encoded by encodeCostmap, resizing the costmap to it
+ * @param metadata Metadata of the costmap
+ * @param data Runs of the costs
+ * @param costmap Costmap to write to, must be locked by the caller
+ * @return False if the runs do not match the metadata
+ */
+bool decodeCostmap(
+  const nav2_msgs::msg::CostmapMetaData & metadata, const std::vector<unsigned char> & data,
+  Costmap2D & costmap);
+
+/**
+ * @brief Write a snapshot to a file, serialized as a ROS message
+ * @param snapshot Snapshot to write
+ * @param filename File to write
+ * @return False if the file could not be written
+ */
+bool saveCostmapSnapshot(
+  const nav2_msgs::msg::CostmapSnapshot & snapshot, const std::string & filename);
+
+/**
+ * @brief Read a snapshot written by saveCostmapSnapshot
+ * @param filename File to read
+ * @param snapshot Snapshot to fill
+ * @return False if the file could not be read or deserialized
+ */
+bool loadCostmapSnapshot(
+  const std::string & filename, nav2_msgs::msg::CostmapSnapshot & snapshot);
+
+}  // namespace nav2_costmap_2d
+
+#endif  // NAV2_COSTMAP_2D__COSTMAP_SNAPSHOT_HPP_
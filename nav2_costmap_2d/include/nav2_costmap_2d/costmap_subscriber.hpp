@@ -15,13 +15,16 @@
 #ifndef NAV2_COSTMAP_2D__COSTMAP_SUBSCRIBER_HPP_
 #define NAV2_COSTMAP_2D__COSTMAP_SUBSCRIBER_HPP_
 
+#include <atomic>
 #include <string>
 #include <memory>
+#include <mutex>
 
 #include "rclcpp/rclcpp.hpp"
 #include "nav2_costmap_2d/costmap_2d.hpp"
 #include "nav2_msgs/msg/costmap.hpp"
 #include "nav2_msgs/msg/costmap_update.hpp"
+#include "nav2_msgs/msg/costmap_delta.hpp"
 #include "nav2_util/lifecycle_node.hpp"
 
 namespace nav2_costmap_2d
@@ -35,17 +38,23 @@ class CostmapSubscriber
 public:
   /**
    * @brief A constructor
+   * @param use_deltas Whether to follow the costmap through the <topic_name>_deltas
+   * stream of CostmapDelta messages rather than full costmaps and updates
    */
   CostmapSubscriber(
     const nav2_util::LifecycleNode::WeakPtr & parent,
-    const std::string & topic_name);
+    const std::string & topic_name,
+    bool use_deltas = false);
 
   /**
    * @brief A constructor
+   * @param use_deltas Whether to follow the costmap through the <topic_name>_deltas
+   * stream of CostmapDelta messages rather than full costmaps and updates
    */
   CostmapSubscriber(
     const rclcpp::Node::WeakPtr & parent,
-    const std::string & topic_name);
+    const std::string & topic_name,
+    bool use_deltas = false);
 
   /**
    * @brief A destructor
@@ -54,8 +63,17 @@ public:
 
   /**
    * @brief Get current costmap
+   *
+   * The costmap returned is a snapshot, obtained without locking: the callbacks
+   * publish a new one for every costmap, update or delta received rather than changing
+   * it, so it is read-only and needs no lock. Call this again to get newer costs.
+   *
+   * If a Costmap2DROS in this process shares the costmap of the topic (see its
+   * share_costmap_intra_process parameter), its latest snapshot is returned instead of
+   * the costmap received on the topic, which is shared with the producer and the other
+   * subscribers in the same way.
    */
-  std::shared_ptr<Costmap2D> getCostmap();
+  std::shared_ptr<const Costmap2D> getCostmap();
   /**
    * @brief Callback for the costmap topic
    */
@@ -64,24 +82,44 @@ public:
    * @brief Callback for the costmap's update topic
    */
   void costmapUpdateCallback(const nav2_msgs::msg::CostmapUpdate::SharedPtr update_msg);
+  /**
+   * @brief Callback for the costmap's delta topic
+   */
+  void costmapDeltaCallback(const nav2_msgs::msg::CostmapDelta::SharedPtr delta_msg);
 
 protected:
-  bool isCostmapReceived() {return costmap_ != nullptr;}
-  void processCurrentCostmapMsg();
+  bool isCostmapReceived() {return std::atomic_load(&costmap_) != nullptr;}
 
-  bool haveCostmapParametersChanged();
-  bool hasCostmapSizeChanged();
-  bool hasCostmapResolutionChanged();
-  bool hasCostmapOriginPositionChanged();
+  /**
+   * @brief Get a costmap to build the next snapshot in, reusing the buffer of the
+   * snapshot replaced last if no reader holds it anymore. Its costs and geometry are
+   * those of an older snapshot, or undefined.
+   */
+  std::shared_ptr<Costmap2D> nextCostmap();
+  /**
+   * @brief Make a costmap built by nextCostmap the current snapshot
+   */
+  void publishCostmap(std::shared_ptr<Costmap2D> costmap);
 
   rclcpp::Subscription<nav2_msgs::msg::Costmap>::SharedPtr costmap_sub_;
   rclcpp::Subscription<nav2_msgs::msg::CostmapUpdate>::SharedPtr costmap_update_sub_;
+  rclcpp::Subscription<nav2_msgs::msg::CostmapDelta>::SharedPtr costmap_delta_sub_;
 
+  // Current snapshot, accessed atomically, and the one it replaced
   std::shared_ptr<Costmap2D> costmap_;
-  nav2_msgs::msg::Costmap::SharedPtr costmap_msg_;
+  std::shared_ptr<Costmap2D> spare_costmap_;
+  // Window of the update the current snapshot was built with, the only cells in which it
+  // differs from the spare costmap, if the current snapshot was built with an update
+  bool update_window_valid_{false};
+  unsigned int update_x_{0}, update_y_{0}, update_size_x_{0}, update_size_y_{0};
 
   std::string topic_name_;
-  std::mutex costmap_msg_mutex_;
+  std::string resolved_topic_name_;
+  // Serializes the callbacks, which build the snapshots
+  std::mutex callback_mutex_;
+  // Whether deltas apply to the costmap, until one is missed, and the last sequence applied
+  bool delta_synced_{false};
+  uint32_t delta_sequence_{0};
   rclcpp::Logger logger_{rclcpp::get_logger("nav2_costmap_2d")};
 };
 
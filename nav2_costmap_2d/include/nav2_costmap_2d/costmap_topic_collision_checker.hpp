@@ -75,6 +75,15 @@ public:
     const geometry_msgs::msg::Pose2D & pose,
     bool fetch_costmap_and_footprint = true);
 
+  /**
+   * @brief Returns if the footprint swept along a sequence of poses is collision free
+   *
+   * The costmap and footprint are fetched once for the whole sequence and the footprint
+   * is only rotated again when the heading changes between consecutive poses.
+   * @param poses Poses to check collision at, in order
+   */
+  bool isPathCollisionFree(const std::vector<geometry_msgs::msg::Pose2D> & poses);
+
 protected:
   /**
    * @brief Get a footprint at a set pose
@@ -91,7 +100,7 @@ protected:
   std::string name_;
   CostmapSubscriber & costmap_sub_;
   FootprintSubscriber & footprint_sub_;
-  FootprintCollisionChecker<std::shared_ptr<Costmap2D>> collision_checker_;
+  FootprintCollisionChecker<std::shared_ptr<const Costmap2D>> collision_checker_;
   rclcpp::Clock::SharedPtr clock_;
   Footprint footprint_;
 };
@@ -15,6 +15,8 @@
 #ifndef NAV2_COSTMAP_2D__DENOISE_LAYER_HPP_
 #define NAV2_COSTMAP_2D__DENOISE_LAYER_HPP_
 
+#include <vector>
+
 #include "nav2_costmap_2d/layer.hpp"
 #include "nav2_costmap_2d/denoise/image_processing.hpp"
 
@@ -107,6 +109,30 @@ private:
      * @warning If image.empty() the behavior is undefined
    */
   void removeSinglePixels(Image<uint8_t> & image) const;
+
+  /**
+     * @brief Removes groups of obstacles smaller than minimal_group_size_ from a window of
+     * the master grid, like removeGroups()
+     *
+     * The obstacles and the groups found are kept between calls, so only groups touching
+     * cells whose obstacle state changed since the previous call (or which entered or left the
+     * window) are relabelled. Origin shifts of a rolling costmap are followed, other changes
+     * of the grid start from scratch.
+     * @param master_grid The master costmap grid to update
+     * @param min_x X min map coord of the window to update
+     * @param min_y Y min map coord of the window to update
+     * @param max_x X max map coord of the window to update
+     * @param max_y Y max map coord of the window to update
+   */
+  void removeGroupsIncremental(
+    nav2_costmap_2d::Costmap2D & master_grid, int min_x, int min_y, int max_x, int max_y);
+
+  /**
+     * @brief Moves the cell states kept by removeGroupsIncremental() to the current grid
+     * @return false if the states can't be kept and were reset
+   */
+  bool alignCellStates(const nav2_costmap_2d::Costmap2D & master_grid);
+
   /**
    * @brief Separates image pixels into objects and background
    * @return true if the pixel value is not an obstacle code. False in other case
@@ -124,6 +150,22 @@ private:
   imgproc_impl::GroupsRemover groups_remover_;
   // Interpret NO_INFORMATION code as obstacle
   bool no_information_is_obstacle_{};
+  // Keep groups between updates and relabel only the changed ones
+  bool incremental_{false};
+  // Per master grid cell: obstacle state at the previous update (outside of its window,
+  // free or obstacle) and whether the cell was in a group to remove
+  std::vector<uint8_t> cell_states_;
+  std::vector<uint8_t> cell_states_spare_;
+  // Cells whose state changed, cells to relabel groups from
+  // and the cells of the group being labelled
+  std::vector<unsigned int> changed_;
+  std::vector<unsigned int> seeds_;
+  std::vector<unsigned int> group_;
+  // Window of the previous update and the grid the cell states are aligned to
+  int states_min_x_{0}, states_min_y_{0}, states_max_x_{0}, states_max_y_{0};
+  unsigned int states_size_x_{0}, states_size_y_{0};
+  double states_resolution_{0.0}, states_origin_x_{0.0}, states_origin_y_{0.0};
+  bool states_no_information_is_obstacle_{};
 };
 
 }  // namespace nav2_costmap_2d
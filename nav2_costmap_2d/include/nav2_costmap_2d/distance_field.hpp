@@ -0,0 +1,132 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_COSTMAP_2D__DISTANCE_FIELD_HPP_
+#define NAV2_COSTMAP_2D__DISTANCE_FIELD_HPP_
+
+#include <cstdint>
+#include <vector>
+
+#include "nav2_costmap_2d/costmap_2d.hpp"
+
+namespace nav2_costmap_2d
+{
+
+/**
+ * @class nav2_costmap_2d::DistanceField
+ * @brief Exact Euclidean distance transform of the obstacles in a costmap, truncated
+ * at a maximum distance. Updates only recompute the window affected by cells whose
+ * obstacle status changed since the previous update.
+ */
+class DistanceField
+{
+public:
+  /**
+   * @brief A constructor for nav2_costmap_2d::DistanceField
+   */
+  DistanceField() = default;
+
+  /**
+   * @brief Set the distance beyond which distances are not tracked. Forces a full
+   * recomputation on the next update.
+   * @param max_distance Maximum distance (m)
+   */
+  void setMaxDistance(double max_distance);
+
+  /**
+   * @brief Get the distance beyond which distances are not tracked
+   * @return Maximum distance (m)
+   */
+  double getMaxDistance() const {return max_distance_;}
+
+  /**
+   * @brief Update the field from the costmap. Lethal cells, and unknown cells if
+   * requested, are obstacles. The full field is recomputed on the first update or
+   * when the costmap geometry changed, otherwise only around changed obstacle cells.
+   * @param costmap Costmap to compute the field of, must be locked by the caller
+   * @param unknown_is_obstacle Whether NO_INFORMATION cells are treated as obstacles
+   */
+  void update(const Costmap2D & costmap, bool unknown_is_obstacle);
+
+  /**
+   * @brief Distance from a cell center to the closest obstacle cell center
+   * @param mx The x coordinate of the cell
+   * @param my The y coordinate of the cell
+   * @return Distance (m), truncated at the maximum distance
+   */
+  inline float getDistance(unsigned int mx, unsigned int my) const
+  {
+    return distances_[my * size_x_ + mx];
+  }
+
+  /**
+   * @brief Bilinearly interpolated distance to the closest obstacle at a world point
+   * @param wx The x world coordinate
+   * @param wy The y world coordinate
+   * @param distance Distance (m), truncated at the maximum distance
+   * @return False if the point is outside of the field
+   */
+  bool interpolateDistance(double wx, double wy, float & distance) const;
+
+  /**
+   * @brief Whether the field has been computed for a costmap
+   * @return bool If initialized
+   */
+  bool isInitialized() const {return !distances_.empty();}
+
+protected:
+  /**
+   * @brief Recompute the distances over a window of cells
+   * @param min_x Minimum x of the window (inclusive)
+   * @param min_y Minimum y of the window (inclusive)
+   * @param max_x Maximum x of the window (exclusive)
+   * @param max_y Maximum y of the window (exclusive)
+   */
+  void computeWindow(int min_x, int min_y, int max_x, int max_y);
+
+  /**
+   * @brief Shift the field with the costmap origin, keeping the overlapping region
+   * @param cell_ox Shift of the origin in x (cells)
+   * @param cell_oy Shift of the origin in y (cells)
+   */
+  void shift(int cell_ox, int cell_oy);
+
+  /**
+   * @brief 1D squared distance transform of a sampled function, Felzenszwalb & Huttenlocher
+   * @param f Input function samples
+   * @param d Output squared distances
+   * @param n Number of samples
+   */
+  void transform1D(const double * f, double * d, int n);
+
+  unsigned int size_x_{0}, size_y_{0};
+  double origin_x_{0.0}, origin_y_{0.0};
+  double resolution_{0.0};
+  double max_distance_{1.0};
+  int max_distance_cells_{0};
+  bool force_full_update_{true};
+
+  std::vector<uint8_t> obstacles_;
+  std::vector<float> distances_;
+
+  // Scratch buffers of the windowed transform, kept to avoid reallocations
+  std::vector<double> window_;
+  std::vector<double> envelope_bounds_;
+  std::vector<int> envelope_locations_;
+  std::vector<double> line_in_, line_out_;
+};
+
+}  // namespace nav2_costmap_2d
+
+#endif  // NAV2_COSTMAP_2D__DISTANCE_FIELD_HPP_
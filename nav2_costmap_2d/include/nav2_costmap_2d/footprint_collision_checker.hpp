@@ -26,6 +26,7 @@
 #include "geometry_msgs/msg/pose_stamped.hpp"
 #include "geometry_msgs/msg/pose2_d.hpp"
 #include "nav2_costmap_2d/costmap_2d.hpp"
+#include "nav2_costmap_2d/cost_pyramid.hpp"
 #include "nav2_util/robot_utils.hpp"
 
 namespace nav2_costmap_2d
@@ -56,6 +57,39 @@ public:
    * @brief Find the footprint cost a a post with an unoriented footprint
    */
   double footprintCostAtPose(double x, double y, double theta, const Footprint & footprint);
+  /**
+   * @brief Approximate the footprint cost at a pose with an unoriented footprint by laying
+   * the footprint about the center of the pose's cell, at the nearest of a set of headings.
+   * The cells of its outline at each heading are computed once and reused until the
+   * footprint, the number of headings or the costmap resolution change, so each query only
+   * reads costs.
+   * @param x X of the pose
+   * @param y Y of the pose
+   * @param theta Heading of the pose
+   * @param footprint Unoriented footprint
+   * @param num_headings Number of headings, evenly splitting a full turn
+   * @return Maximum cost of the outline, or LETHAL_OBSTACLE if it leaves the costmap
+   */
+  double footprintCostAtPoseQuantized(
+    double x, double y, double theta, const Footprint & footprint,
+    unsigned int num_headings);
+  /**
+   * @brief Check from the cost pyramid whether all cells of the bounding box of the
+   * footprint at a pose are below a cost, in which case its footprint cost is below it
+   * too. This reads a few blocks of costs rather than the cells of the footprint.
+   * @param x X of the pose
+   * @param y Y of the pose
+   * @param theta Heading of the pose
+   * @param footprint Unoriented footprint
+   * @param cost Cost to compare to
+   * @param num_headings Number of headings of footprintCostAtPoseQuantized() to check the
+   * footprint of, 0 for footprintCostAtPose()
+   * @return False if the box is not below the cost, leaves the costmap or there is no
+   * cost pyramid, in which case the footprint cost is to be checked
+   */
+  bool isFootprintBoxBelowCost(
+    double x, double y, double theta, const Footprint & footprint, unsigned char cost,
+    unsigned int num_headings = 0);
   /**
    * @brief Get the cost for a line segment
    */
@@ -73,6 +107,15 @@ public:
   */
   void setCostmap(CostmapT costmap);
   /**
+  * @brief Set a cost pyramid of the costmap for isFootprintBoxBelowCost(), kept up to
+  * date with the costmap by the caller
+  * @param cost_pyramid Cost pyramid, or nullptr for none
+  */
+  void setCostPyramid(const CostPyramid * cost_pyramid)
+  {
+    cost_pyramid_ = cost_pyramid;
+  }
+  /**
   * @brief Get the current costmap object
   */
   CostmapT getCostmap()
@@ -81,7 +124,60 @@ public:
   }
 
 protected:
+  /**
+   * @brief Outline cells of the footprint at a heading, relative to the pose's cell
+   */
+  struct FootprintKernel
+  {
+    // Offsets of the cells in the costmap's data, for a costmap kernel_size_x_ cells wide
+    std::vector<int> offsets;
+    int min_dx{0}, max_dx{0}, min_dy{0}, max_dy{0};
+  };
+
+  /**
+   * @brief Rasterize the outline of the footprint at each heading into the kernels
+   * @param footprint Unoriented footprint
+   * @param num_headings Number of headings, evenly splitting a full turn
+   */
+  void updateFootprintKernels(const Footprint & footprint, unsigned int num_headings);
+
+  /**
+   * @brief Get the index of the heading nearest to an angle
+   * @param theta Angle
+   * @param num_headings Number of headings, evenly splitting a full turn
+   * @return Index of the heading, in [0, num_headings)
+   */
+  static unsigned int nearestHeading(double theta, unsigned int num_headings);
+
+  /**
+   * @brief Check whether the kernels are valid for the costmap's resolution and width
+   * @return If the kernels need no update for the costmap
+   */
+  bool footprintKernelsMatchCostmap() const
+  {
+    return kernel_resolution_ == costmap_->getResolution() &&
+           kernel_size_x_ == costmap_->getSizeInCellsX();
+  }
+
+  /**
+   * @brief Get the maximum cost of the outline of a kernel about a cell. The cells are
+   * gathered without branching on their cost, so the loop can be vectorized.
+   * @param mx X of the cell
+   * @param my Y of the cell
+   * @param kernel Kernel of the footprint at the heading to check
+   * @return Maximum cost of the outline, or LETHAL_OBSTACLE if it leaves the costmap
+   */
+  double footprintKernelCost(
+    unsigned int mx, unsigned int my, const FootprintKernel & kernel) const;
+
   CostmapT costmap_;
+  const CostPyramid * cost_pyramid_{nullptr};
+
+  // Footprint, resolution, costmap width and headings the kernels were computed for
+  Footprint kernel_footprint_;
+  double kernel_resolution_{0.0};
+  unsigned int kernel_size_x_{0};
+  std::vector<FootprintKernel> kernels_;
 };
 
 }  // namespace nav2_costmap_2d
@@ -0,0 +1,163 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_COSTMAP_2D__INCREMENTAL_INFLATION_HPP_
+#define NAV2_COSTMAP_2D__INCREMENTAL_INFLATION_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace nav2_costmap_2d
+{
+
+/**
+ * @class nav2_costmap_2d::IncrementalInflation
+ * @brief Keeps the closest obstacle source of every cell within an inflation radius
+ * between updates. Changes of the obstacle status of cells are propagated with raise
+ * waves, clearing cells whose source was removed, and lower waves, assigning closer
+ * sources, in the manner of Lau et al.'s dynamic Euclidean distance transform.
+ * Cells whose obstacle status did not change, or that are far from any that did,
+ * are not visited.
+ */
+class IncrementalInflation
+{
+public:
+  /**
+   * @brief A constructor for nav2_costmap_2d::IncrementalInflation
+   */
+  IncrementalInflation() = default;
+
+  /**
+   * @brief Clear all obstacles and sources for a grid of the given size
+   * @param size_x Width of the grid (cells)
+   * @param size_y Height of the grid (cells)
+   * @param cell_radius Distance beyond which sources are not tracked (cells)
+   */
+  void reset(unsigned int size_x, unsigned int size_y, unsigned int cell_radius);
+
+  /**
+   * @brief Whether the sources are tracked for a grid of this size and radius
+   * @param size_x Width of the grid (cells)
+   * @param size_y Height of the grid (cells)
+   * @param cell_radius Distance beyond which sources are not tracked (cells)
+   * @return bool If it matches
+   */
+  bool matches(unsigned int size_x, unsigned int size_y, unsigned int cell_radius) const
+  {
+    return size_x == size_x_ && size_y == size_y_ && cell_radius == cell_radius_ &&
+           !sources_.empty();
+  }
+
+  /**
+   * @brief Shift the grid with its origin. Obstacles shifted out of the grid are removed
+   * and cells that are exposed by the shift have no obstacles.
+   * @param cell_ox Shift of the origin in x (cells)
+   * @param cell_oy Shift of the origin in y (cells)
+   */
+  void shift(int cell_ox, int cell_oy);
+
+  /**
+   * @brief Set the obstacle status of a cell, queueing a wave if it changed
+   * @param index Index of the cell
+   * @param obstacle Whether the cell is an obstacle
+   */
+  inline void setObstacle(unsigned int index, bool obstacle)
+  {
+    if (static_cast<bool>(obstacles_[index]) == obstacle) {
+      return;
+    }
+
+    obstacles_[index] = obstacle;
+    if (obstacle) {
+      sources_[index] = static_cast<int>(index);
+      distances_[index] = 0;
+      push(index, 0);
+    } else {
+      sources_[index] = NO_SOURCE;
+      distances_[index] = NO_DISTANCE;
+      to_raise_[index] = 1;
+      push(index, 0);
+    }
+  }
+
+  /**
+   * @brief Propagate all pending obstacle changes
+   */
+  void propagate();
+
+  /**
+   * @brief Get the closest obstacle within the radius of a cell
+   * @param index Index of the cell
+   * @return Index of the closest obstacle cell, or NO_SOURCE if none is within the radius
+   */
+  inline int getSource(unsigned int index) const
+  {
+    return sources_[index];
+  }
+
+  /**
+   * @brief Get the bytes held by the sources, distances and queue of the grid
+   * @return Number of bytes
+   */
+  size_t getMemoryUsage() const;
+
+  static constexpr int NO_SOURCE = -1;
+
+protected:
+  /**
+   * @brief Queue a cell to be processed with a priority
+   * @param index Index of the cell
+   * @param priority Squared distance (cells) of the wave at the cell
+   */
+  inline void push(unsigned int index, unsigned int priority)
+  {
+    queue_[priority].push_back(index);
+    if (priority < queue_min_) {
+      queue_min_ = priority;
+    }
+  }
+
+  /**
+   * @brief Clear the neighbors of a cell whose source was removed, or queue them to
+   * lower into the cleared region if their source remains
+   * @param index Index of the cell
+   */
+  void raise(unsigned int index);
+
+  /**
+   * @brief Offer the source of a cell to its neighbors
+   * @param index Index of the cell
+   */
+  void lower(unsigned int index);
+
+  static constexpr unsigned int NO_DISTANCE = 0xFFFFFFFF;
+
+  unsigned int size_x_{0}, size_y_{0};
+  unsigned int cell_radius_{0}, max_distance_{0};
+
+  std::vector<uint8_t> obstacles_;
+  std::vector<uint8_t> to_raise_;
+  std::vector<int> sources_;
+  // Squared distance (cells) of each cell to its source
+  std::vector<unsigned int> distances_;
+
+  // Bucketed priority queue by squared distance
+  std::vector<std::vector<unsigned int>> queue_;
+  unsigned int queue_min_{0};
+};
+
+}  // namespace nav2_costmap_2d
+
+#endif  // NAV2_COSTMAP_2D__INCREMENTAL_INFLATION_HPP_
@@ -41,6 +41,7 @@
 #include <map>
 #include <vector>
 #include <mutex>
+#include <utility>
 #include <memory>
 #include <string>
 
@@ -48,6 +49,8 @@
 #include "nav2_costmap_2d/layer.hpp"
 #include "nav2_costmap_2d/layered_costmap.hpp"
 #include "nav2_costmap_2d/costmap_2d_ros.hpp"
+#include "nav2_costmap_2d/incremental_inflation.hpp"
+#include "nav2_util/memory_registry.hpp"
 
 namespace nav2_costmap_2d
 {
@@ -222,7 +225,7 @@ protected:
   {
     unsigned int dx = (mx > src_x) ? mx - src_x : src_x - mx;
     unsigned int dy = (my > src_y) ? my - src_y : src_y - my;
-    return cached_distances_[dx * cache_length_ + dy];
+    return (*cached_distances_)[dx * cache_length_ + dy];
   }
 
   /**
@@ -260,10 +263,74 @@ protected:
     return layered_costmap_->getCostmap()->cellDistance(world_dist);
   }
 
+  /**
+   * @brief Update the costs in the window from the obstacle sources kept between
+   * updates, only propagating the changes of obstacles since the last update
+   * @param master_grid The master costmap grid to update
+   * @param min_i X min map coord of the window to update
+   * @param min_j Y min map coord of the window to update
+   * @param max_i X max map coord of the window to update
+   * @param max_j Y max map coord of the window to update
+   */
+  void updateCostsIncremental(
+    nav2_costmap_2d::Costmap2D & master_grid,
+    int min_i, int min_j, int max_i, int max_j);
+
+  /**
+   * @brief Find the obstacles to inflate in a window of the master costmap
+   * @param master_grid The master costmap grid
+   * @param obstacles The list to append the obstacle cells to
+   * @param min_i X min map coord of the window
+   * @param min_j Y min map coord of the window
+   * @param max_i X max map coord of the window
+   * @param max_j Y max map coord of the window
+   */
+  void seedObstacles(
+    const nav2_costmap_2d::Costmap2D & master_grid, std::vector<CellData> & obstacles,
+    int min_i, int min_j, int max_i, int max_j) const;
+
+  /**
+   * @brief Inflate the obstacles in the first list of inflation cells by increasing
+   * distance, applying the costs inside of the window
+   * @param master_grid The master costmap grid to update
+   * @param inflation_cells The lists of cells pending for inflation by distance
+   * @param seen Which cells were already visited, same size as the master costmap
+   * @param base_min_i X min map coord of the window to update
+   * @param base_min_j Y min map coord of the window to update
+   * @param base_max_i X max map coord of the window to update
+   * @param base_max_j Y max map coord of the window to update
+   * @param min_row First row of the master costmap the inflation may visit
+   * @param max_row Last row (exclusive) of the master costmap the inflation may visit
+   */
+  void propagateCosts(
+    nav2_costmap_2d::Costmap2D & master_grid,
+    std::vector<std::vector<CellData>> & inflation_cells, std::vector<bool> & seen,
+    int base_min_i, int base_min_j, int base_max_i, int base_max_j,
+    unsigned int min_row, unsigned int max_row);
+
+  /**
+   * @brief Update the costs in the window by inflating stripes of it concurrently
+   * @param master_grid The master costmap grid to update
+   * @param base_min_i X min map coord of the window to update
+   * @param base_min_j Y min map coord of the window to update
+   * @param base_max_i X max map coord of the window to update
+   * @param base_max_j Y max map coord of the window to update
+   */
+  void inflateTiled(
+    nav2_costmap_2d::Costmap2D & master_grid, int base_min_i, int base_min_j,
+    int base_max_i, int base_max_j);
+
+  /**
+   * @brief Account for the bytes of the caches and visited cells in the
+   * nav2_util::MemoryRegistry
+   */
+  void updateCacheMemory();
+
   /**
    * @brief Enqueue new cells in cache distance update search
    */
   inline void enqueue(
+    std::vector<std::vector<CellData>> & inflation_cells, const std::vector<bool> & seen,
     unsigned int index, unsigned int mx, unsigned int my,
     unsigned int src_x, unsigned int src_y);
 
@@ -285,13 +352,31 @@ protected:
   std::vector<bool> seen_;
 
   std::vector<unsigned char> cached_costs_;
-  std::vector<double> cached_distances_;
-  std::vector<std::vector<int>> distance_matrix_;
+  // Shared with the other inflation layers of the process with the same radius
+  std::shared_ptr<const std::vector<double>> cached_distances_;
+  std::shared_ptr<const std::vector<std::vector<int>>> distance_matrix_;
   unsigned int cache_length_;
   double last_min_x_, last_min_y_, last_max_x_, last_max_y_;
 
   // Indicates that the entire costmap should be reinflated next time around.
   bool need_reinflation_;
+
+  // Obstacle sources kept between updates when inflating incrementally
+  bool incremental_inflation_enabled_;
+  bool incremental_full_update_;
+  IncrementalInflation incremental_inflation_;
+  double incremental_origin_x_, incremental_origin_y_;
+
+  // Buffers of each thread inflating stripes of large windows
+  struct TileWorkspace
+  {
+    std::vector<bool> seen;
+    std::vector<std::vector<CellData>> inflation_cells;
+  };
+  unsigned int inflation_threads_;
+  std::vector<TileWorkspace> tile_workspaces_;
+  std::vector<std::vector<CellData>> tile_obstacles_;
+  nav2_util::MemoryTracker cache_memory_{"inflation_layer/caches"};
   mutex_t * access_;
   // Dynamic parameters handler
   rclcpp::node_interfaces::OnSetParametersCallbackHandle::SharedPtr dyn_params_handler_;
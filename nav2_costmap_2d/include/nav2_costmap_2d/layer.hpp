@@ -103,6 +103,13 @@ public:
     double * max_x,
     double * max_y) = 0;
 
+  /**
+   * @brief If updateBounds() only touches data owned by this layer and only grows
+   *        the bounds to include its own updates, so that it can run concurrently
+   *        with other such layers
+   */
+  virtual bool hasIndependentBounds() {return false;}
+
   /**
    * @brief Actually update the underlying costmap, only within the bounds
    *        calculated during UpdateBounds().
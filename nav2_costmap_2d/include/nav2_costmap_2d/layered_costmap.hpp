@@ -38,8 +38,12 @@
 #ifndef NAV2_COSTMAP_2D__LAYERED_COSTMAP_HPP_
 #define NAV2_COSTMAP_2D__LAYERED_COSTMAP_HPP_
 
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "nav2_costmap_2d/cost_values.hpp"
@@ -111,6 +115,14 @@ public:
     return &combined_costmap_;
   }
 
+  /**
+   * @brief Get a copy of the master costmap as of the last completed update. It is
+   * never modified, so it can be read without locking the master costmap for as long
+   * as it is held. Snapshots are only taken by updateMap() once this has been called.
+   * @return Snapshot of the master costmap
+   */
+  std::shared_ptr<const Costmap2D> getCostmapSnapshot();
+
   /**
    * @brief If this costmap is rolling or not
    */
@@ -155,6 +167,33 @@ public:
   void addFilter(std::shared_ptr<Layer> filter);
 
 
+  /**
+   * @brief Set whether consecutive plugins with independent bounds updates
+   * run their updateBounds() concurrently. Costs are still updated in order.
+   */
+  void setParallelLayerUpdates(bool parallel_layer_updates)
+  {
+    parallel_layer_updates_ = parallel_layer_updates;
+  }
+
+  /**
+   * @brief Update a layer or filter only once every given number of updates of the costmap.
+   * From the first call for a layer, the costs it sets are recorded as it updates, and its
+   * last costs are put back into the windows of the updates it skips, combined as
+   * CostmapLayer::updateWithMax does. The window of the updates it skipped is updated again
+   * by all layers along with its next update, so that the costmap catches up with it.
+   * @param name Name of the layer or filter
+   * @param decimation Number of updates of the costmap per update of the layer, 1 for all
+   * @return False if there is no layer or filter of this name
+   */
+  bool setLayerDecimation(const std::string & name, unsigned int decimation);
+
+  /**
+   * @brief Get the time taken by each layer and filter in its last update
+   * @return Name and update time in seconds of the layers, then of the filters
+   */
+  std::vector<std::pair<std::string, double>> getLayerUpdateTimes();
+
   /**
    * @brief Get if the size of the costmap is locked
    */
@@ -174,6 +213,33 @@ public:
     *yn = byn_;
   }
 
+  /**
+   * @brief Get the number of changes of the master costmap so far, to later query the
+   * cells changed since with getUpdatedWindowSince()
+   * @return Update count
+   */
+  uint64_t getUpdateCount();
+
+  /**
+   * @brief Get the window of master costmap cells which may have changed since an update
+   * @param update_count Value of getUpdateCount() when the caller last read the costmap
+   * @param x0 Lower x-boundary of the changed cells (inclusive)
+   * @param xn Upper x-boundary of the changed cells (exclusive)
+   * @param y0 Lower y-boundary of the changed cells (inclusive)
+   * @param yn Upper y-boundary of the changed cells (exclusive)
+   * @return False if the changed cells are not known, after a resize, a move of the rolling
+   * window, a reset or too many updates, in which case any cell may have changed
+   */
+  bool getUpdatedWindowSince(
+    uint64_t update_count, unsigned int & x0, unsigned int & xn,
+    unsigned int & y0, unsigned int & yn);
+
+  /**
+   * @brief Mark all cells of the master costmap as changed, for writes to it made
+   * outside of updateMap()
+   */
+  void markAllCellsUpdated();
+
   /**
    * @brief if the costmap is initialized
    */
@@ -212,6 +278,64 @@ public:
   bool isOutofBounds(double robot_x, double robot_y);
 
 private:
+  /**
+   * @brief Update the bounds of the plugins, running consecutive plugins with
+   * independent bounds concurrently when enabled
+   */
+  void updatePluginBounds(double robot_x, double robot_y, double robot_yaw);
+
+  /**
+   * @brief Update state of a layer or filter
+   */
+  struct LayerSchedule
+  {
+    unsigned int decimation{1};  ///< Updates of the costmap per update of the layer
+    unsigned int skipped{0};  ///< Updates skipped since the last update of the layer
+    bool runs{true};  ///< Whether the layer is updated in the current update
+    bool has_skipped_window{false};
+    double skipped_minx, skipped_miny, skipped_maxx, skipped_maxy;
+    double update_time{0.0};  ///< Seconds taken by the last update of the layer
+    bool records{false};  ///< Whether the costs set by the layer are recorded
+    /// Costs set by the layer in its updates, NO_INFORMATION where it set none
+    std::unique_ptr<Costmap2D> costs;
+  };
+
+  /**
+   * @brief Update the costs of a layer or filter in the window, recording the costs it sets
+   * if it may be decimated, or put its recorded costs back if it skips this update
+   * @param layer Layer or filter
+   * @param schedule Update state of the layer
+   * @param costmap Costmap it updates
+   * @param x0 Lower x bound of the window
+   * @param y0 Lower y bound of the window
+   * @param xn Upper x bound of the window, excluded
+   * @param yn Upper y bound of the window, excluded
+   */
+  void updateLayerCosts(
+    const std::shared_ptr<Layer> & layer, LayerSchedule & schedule, Costmap2D & costmap,
+    int x0, int y0, int xn, int yn);
+
+  /**
+   * @brief Grow the bounds of this update by the windows skipped by the layers updated
+   * in it, and record them as skipped by the other layers. Must be called once the bounds
+   * of the layers are updated.
+   */
+  void catchUpSkippedWindows();
+
+  // Costs of the window before the update of a recorded layer, reused across updates
+  std::vector<unsigned char> window_costs_;
+
+  /**
+   * @brief Publish a snapshot of the master costmap, reusing the buffer of the previous
+   * snapshot if no reader holds it anymore. Must be called with the master costmap locked.
+   */
+  void updateSnapshot();
+
+  /**
+   * @brief Record the window of the master costmap written by an update
+   */
+  void recordUpdatedWindow(unsigned int x0, unsigned int xn, unsigned int y0, unsigned int yn);
+
   // primary_costmap_ is a bottom costmap used by plugins when costmap filters were enabled.
   // combined_costmap_ is a final costmap where all results produced by plugins and filters (if any)
   // to be merged.
@@ -228,11 +352,26 @@ private:
 
   std::vector<std::shared_ptr<Layer>> plugins_;
   std::vector<std::shared_ptr<Layer>> filters_;
+  std::vector<LayerSchedule> plugin_schedules_;
+  std::vector<LayerSchedule> filter_schedules_;
 
   bool initialized_;
   bool size_locked_;
+  bool parallel_layer_updates_;
   std::atomic<double> circumscribed_radius_, inscribed_radius_;
   std::shared_ptr<std::vector<geometry_msgs::msg::Point>> footprint_;
+
+  // Last published snapshot, accessed atomically, and the one it replaced
+  std::atomic<bool> snapshots_requested_;
+  std::shared_ptr<const Costmap2D> snapshot_;
+  std::shared_ptr<Costmap2D> spare_snapshot_;
+
+  // Windows written by the last updates, indexed by update count, which are known
+  // for the updates after updates_known_since_
+  static constexpr uint64_t UPDATED_WINDOWS_HISTORY = 32;
+  std::array<std::array<unsigned int, 4>, UPDATED_WINDOWS_HISTORY> updated_windows_;
+  uint64_t update_count_{0};
+  uint64_t updates_known_since_{0};
 };
 
 }  // namespace nav2_costmap_2d
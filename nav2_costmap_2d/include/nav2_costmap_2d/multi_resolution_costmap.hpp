@@ -0,0 +1,114 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef NAV2_COSTMAP_2D__MULTI_RESOLUTION_COSTMAP_HPP_
+#define NAV2_COSTMAP_2D__MULTI_RESOLUTION_COSTMAP_HPP_
+
+#include <mutex>
+#include <vector>
+
+#include "geometry_msgs/msg/point.hpp"
+#include "nav2_costmap_2d/costmap_2d.hpp"
+
+namespace nav2_costmap_2d
+{
+
+/**
+ * @class nav2_costmap_2d::MultiResolutionCostmap
+ * @brief Queries of a coarse outer costmap with a fine inner window nested in it, such as
+ * kept around the robot by a Costmap2DROS with an inner_window, answered in world
+ * coordinates from the finest costmap covering the point or footprint queried.
+ */
+class MultiResolutionCostmap
+{
+public:
+  /**
+   * @brief Locks of the mutexes of both costmaps, outer first
+   */
+  struct Lock
+  {
+    std::unique_lock<Costmap2D::mutex_t> outer;
+    std::unique_lock<Costmap2D::mutex_t> inner;
+  };
+
+  /**
+   * @brief A constructor for nav2_costmap_2d::MultiResolutionCostmap
+   * @param outer Outer costmap
+   * @param inner Inner window, or nullptr to answer all queries from the outer costmap
+   */
+  explicit MultiResolutionCostmap(Costmap2D * outer, Costmap2D * inner = nullptr);
+
+  /**
+   * @brief Lock both costmaps for the queries, which do not lock them
+   * @return Locks held until destroyed
+   */
+  Lock lock() const;
+
+  /**
+   * @brief Get the outer costmap
+   * @return Outer costmap
+   */
+  Costmap2D * getOuterCostmap() const {return outer_;}
+
+  /**
+   * @brief Get the inner window
+   * @return Inner costmap, or nullptr if there is none
+   */
+  Costmap2D * getInnerCostmap() const {return inner_;}
+
+  /**
+   * @brief Get the finest costmap covering a point
+   * @param wx X of the point in the global frame
+   * @param wy Y of the point in the global frame
+   * @return Inner costmap if it covers the point, outer costmap otherwise, even if the point
+   * is outside of it
+   */
+  Costmap2D * getCostmapAt(double wx, double wy) const;
+
+  /**
+   * @brief Get the resolution of the finest costmap covering a point
+   * @param wx X of the point in the global frame
+   * @param wy Y of the point in the global frame
+   * @return Resolution in meters per cell
+   */
+  double getResolutionAt(double wx, double wy) const
+  {
+    return getCostmapAt(wx, wy)->getResolution();
+  }
+
+  /**
+   * @brief Get the cost of a point from the finest costmap covering it
+   * @param wx X of the point in the global frame
+   * @param wy Y of the point in the global frame
+   * @return Cost of the cell of the point, NO_INFORMATION outside of both costmaps
+   */
+  unsigned char getCost(double wx, double wy) const;
+
+  /**
+   * @brief Get the cost of an oriented footprint from the finest costmap covering it whole,
+   * as FootprintCollisionChecker::footprintCost
+   * @param footprint Footprint in the global frame
+   * @return Maximum cost of the outline, or LETHAL_OBSTACLE if it leaves both costmaps
+   */
+  double footprintCost(const std::vector<geometry_msgs::msg::Point> & footprint) const;
+
+protected:
+  Costmap2D * outer_;
+  Costmap2D * inner_;
+};
+
+}  // namespace nav2_costmap_2d
+
+#endif  // NAV2_COSTMAP_2D__MULTI_RESOLUTION_COSTMAP_HPP_
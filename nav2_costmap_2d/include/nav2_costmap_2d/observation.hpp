@@ -32,6 +32,8 @@
 #ifndef NAV2_COSTMAP_2D__OBSERVATION_HPP_
 #define NAV2_COSTMAP_2D__OBSERVATION_HPP_
 
+#include <memory>
+
 #include <geometry_msgs/msg/point.hpp>
 #include <sensor_msgs/msg/point_cloud2.hpp>
 
@@ -40,8 +42,8 @@ namespace nav2_costmap_2d
 
 /**
  * @brief Stores an observation in terms of a point cloud and the origin of the source
- * @note Tried to make members and constructor arguments const but the compiler would not accept the default
- * assignment operator for vector insertion!
+ * @note Copies of an observation share its point cloud, which is not modified once the
+ * observation is buffered, so that observations can be handed out without copying clouds
  */
 class Observation
 {
@@ -50,7 +52,8 @@ public:
    * @brief  Creates an empty observation
    */
   Observation()
-  : cloud_(new sensor_msgs::msg::PointCloud2()), obstacle_max_range_(0.0), obstacle_min_range_(0.0),
+  : cloud_(std::make_shared<sensor_msgs::msg::PointCloud2>()), obstacle_max_range_(0.0),
+    obstacle_min_range_(0.0),
     raytrace_max_range_(0.0),
     raytrace_min_range_(0.0)
   {
@@ -58,26 +61,13 @@ public:
   /**
    * @brief A destructor
    */
-  virtual ~Observation()
-  {
-    delete cloud_;
-  }
+  virtual ~Observation() = default;
 
   /**
-   * @brief  Copy assignment operator
+   * @brief  Copy assignment operator, sharing the point cloud
    * @param obs The observation to copy
    */
-  Observation & operator=(const Observation & obs)
-  {
-    origin_ = obs.origin_;
-    cloud_ = new sensor_msgs::msg::PointCloud2(*(obs.cloud_));
-    obstacle_max_range_ = obs.obstacle_max_range_;
-    obstacle_min_range_ = obs.obstacle_min_range_;
-    raytrace_max_range_ = obs.raytrace_max_range_;
-    raytrace_min_range_ = obs.raytrace_min_range_;
-
-    return *this;
-  }
+  Observation & operator=(const Observation & obs) = default;
 
   /**
    * @brief  Creates an observation from an origin point and a point cloud
@@ -92,7 +82,7 @@ public:
     geometry_msgs::msg::Point & origin, const sensor_msgs::msg::PointCloud2 & cloud,
     double obstacle_max_range, double obstacle_min_range, double raytrace_max_range,
     double raytrace_min_range)
-  : origin_(origin), cloud_(new sensor_msgs::msg::PointCloud2(cloud)),
+  : origin_(origin), cloud_(std::make_shared<sensor_msgs::msg::PointCloud2>(cloud)),
     obstacle_max_range_(obstacle_max_range), obstacle_min_range_(obstacle_min_range),
     raytrace_max_range_(raytrace_max_range), raytrace_min_range_(
       raytrace_min_range)
@@ -100,16 +90,10 @@ public:
   }
 
   /**
-   * @brief  Copy constructor
+   * @brief  Copy constructor, sharing the point cloud
    * @param obs The observation to copy
    */
-  Observation(const Observation & obs)
-  : origin_(obs.origin_), cloud_(new sensor_msgs::msg::PointCloud2(*(obs.cloud_))),
-    obstacle_max_range_(obs.obstacle_max_range_), obstacle_min_range_(obs.obstacle_min_range_),
-    raytrace_max_range_(obs.raytrace_max_range_),
-    raytrace_min_range_(obs.raytrace_min_range_)
-  {
-  }
+  Observation(const Observation & obs) = default;
 
   /**
    * @brief  Creates an observation from a point cloud
@@ -120,14 +104,15 @@ public:
   Observation(
     const sensor_msgs::msg::PointCloud2 & cloud, double obstacle_max_range,
     double obstacle_min_range)
-  : cloud_(new sensor_msgs::msg::PointCloud2(cloud)), obstacle_max_range_(obstacle_max_range),
+  : cloud_(std::make_shared<sensor_msgs::msg::PointCloud2>(cloud)),
+    obstacle_max_range_(obstacle_max_range),
     obstacle_min_range_(obstacle_min_range),
     raytrace_max_range_(0.0), raytrace_min_range_(0.0)
   {
   }
 
   geometry_msgs::msg::Point origin_;
-  sensor_msgs::msg::PointCloud2 * cloud_;
+  std::shared_ptr<sensor_msgs::msg::PointCloud2> cloud_;
   double obstacle_max_range_, obstacle_min_range_, raytrace_max_range_, raytrace_min_range_;
 };
 
@@ -38,7 +38,6 @@
 #define NAV2_COSTMAP_2D__OBSERVATION_BUFFER_HPP_
 
 #include <vector>
-#include <list>
 #include <string>
 
 #include "tf2_geometry_msgs/tf2_geometry_msgs.hpp"
@@ -100,11 +99,26 @@ public:
   void bufferCloud(const sensor_msgs::msg::PointCloud2 & cloud);
 
   /**
-   * @brief  Pushes copies of all current observations onto the end of the vector passed in
+   * @brief  Pushes copies of all current observations onto the end of the vector passed in,
+   * sharing their point clouds
    * @param  observations The vector to be filled
    */
   void getObservations(std::vector<Observation> & observations);
 
+  /**
+   * @brief  Get the latest observation buffered, sharing its point cloud
+   * @param  observation The latest observation
+   * @return True if there is an observation, false otherwise
+   */
+  bool getLatestObservation(Observation & observation) const;
+
+  /**
+   * @brief  Buffers an observation made by another buffer with the same parameters,
+   * sharing its point cloud
+   * @param  observation The observation to be buffered
+   */
+  void bufferObservation(const Observation & observation);
+
   /**
    * @brief  Check if the observation buffer is being update at its expected rate
    * @return True if it is being updated at the expected rate, false otherwise
@@ -134,10 +148,33 @@ public:
 
 private:
   /**
-   * @brief  Removes any stale observations from the buffer list
+   * @brief  Removes any stale observations from the buffer, oldest first
    */
   void purgeStaleObservations();
 
+  /**
+   * @brief  Get the slot after the latest observation, to be filled and pushed with
+   * pushObservation(), growing the ring if it is full. The point cloud of the slot is
+   * reused if no copy of the observation it held is still shared.
+   * @return The slot of the next observation
+   */
+  Observation & nextObservation();
+
+  /**
+   * @brief  Makes the observation filled in nextObservation() the latest one
+   */
+  void pushObservation();
+
+  /**
+   * @brief  Get an observation by its age in the buffer
+   * @param  age The number of observations buffered after it, 0 for the latest
+   * @return The observation
+   */
+  inline Observation & observationAt(size_t age)
+  {
+    return observations_[(latest_ + observations_.size() - age) % observations_.size()];
+  }
+
   rclcpp::Clock::SharedPtr clock_;
   rclcpp::Logger logger_{rclcpp::get_logger("nav2_costmap_2d")};
   tf2_ros::Buffer & tf2_buffer_;
@@ -146,7 +183,11 @@ private:
   rclcpp::Time last_updated_;
   std::string global_frame_;
   std::string sensor_frame_;
-  std::list<Observation> observation_list_;
+  // Ring of the buffered observations, with the latest at latest_ and the
+  // oldest observation_count_ - 1 slots before it
+  std::vector<Observation> observations_;
+  size_t latest_{0};
+  size_t observation_count_{0};
   std::string topic_name_;
   double min_obstacle_height_, max_obstacle_height_;
   std::recursive_mutex lock_;  ///< @brief A lock for accessing data in callbacks safely
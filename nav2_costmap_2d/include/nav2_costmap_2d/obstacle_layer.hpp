@@ -56,6 +56,8 @@
 #include "nav2_costmap_2d/costmap_layer.hpp"
 #include "nav2_costmap_2d/layered_costmap.hpp"
 #include "nav2_costmap_2d/observation_buffer.hpp"
+#include "nav2_costmap_2d/packed_costmap.hpp"
+#include "nav2_costmap_2d/shared_observation_source.hpp"
 #include "nav2_costmap_2d/footprint.hpp"
 
 namespace nav2_costmap_2d
@@ -131,6 +133,23 @@ public:
    */
   virtual bool isClearable() {return true;}
 
+  /**
+   * @brief Bounds are only grown by this layer's own observations
+   */
+  virtual bool hasIndependentBounds() {return true;}
+
+  /**
+   * @brief Clear the cells of the layer inside or outside of an area
+   */
+  virtual void clearArea(int start_x, int start_y, int end_x, int end_y, bool invert);
+
+  /**
+   * @brief Move the origin of the layer, shifting its costs
+   * @param new_origin_x The x coordinate of the new origin
+   * @param new_origin_y The y coordinate of the new origin
+   */
+  virtual void updateOrigin(double new_origin_x, double new_origin_y);
+
   /**
    * @brief Callback executed when a parameter change is detected
    * @param event ParameterEvent message
@@ -205,6 +224,41 @@ protected:
     double * max_x,
     double * max_y);
 
+  /**
+   * @brief  Mark an obstacle seen in a cell of the layer
+   * @param index The index of the cell
+   */
+  virtual void markCell(unsigned int index)
+  {
+    if (packed_storage_) {
+      packed_costmap_.setCost(index, LETHAL_OBSTACLE);
+    } else {
+      costmap_[index] = LETHAL_OBSTACLE;
+    }
+  }
+
+  /**
+   * @brief Whether the layer only ever holds FREE_SPACE, LETHAL_OBSTACLE and
+   * NO_INFORMATION through the methods of this class, so that its costs can be packed
+   */
+  virtual bool canPackStorage() const {return true;}
+
+  /**
+   * @brief Allocate the costs of the layer, packed or not
+   */
+  virtual void initMaps(unsigned int size_x, unsigned int size_y);
+
+  /**
+   * @brief Reset the costs of the layer to the default value
+   */
+  virtual void resetMaps();
+
+  /**
+   * @brief Set the cost of the cells of a convex polygon, packed or not
+   */
+  void setPolygonCost(
+    const std::vector<geometry_msgs::msg::Point> & polygon, unsigned char cost_value);
+
   /**
    * @brief Process update costmap with raytracing the window bounds
    */
@@ -242,6 +296,8 @@ protected:
   std::vector<std::shared_ptr<nav2_costmap_2d::ObservationBuffer>> marking_buffers_;
   /// @brief Used to store observation buffers used for clearing obstacles
   std::vector<std::shared_ptr<nav2_costmap_2d::ObservationBuffer>> clearing_buffers_;
+  /// @brief Used to share the processing of the sensors with the layers of other costmaps
+  std::vector<std::shared_ptr<nav2_costmap_2d::SharedObservationSource>> shared_sources_;
 
   /// @brief Dynamic parameters handler
   rclcpp::node_interfaces::OnSetParametersCallbackHandle::SharedPtr dyn_params_handler_;
@@ -253,6 +309,19 @@ protected:
   bool rolling_window_;
   bool was_reset_;
   nav2_costmap_2d::CombinationMethod combination_method_;
+
+  /// @brief Stamp of the last observation which traced a ray to each endpoint cell
+  std::vector<unsigned int> raytrace_endpoint_stamps_;
+  unsigned int raytrace_stamp_{0};
+
+  /// @brief Points of an observation to mark and their map coordinates, kept between updates
+  std::vector<float> mark_x_, mark_y_;
+  std::vector<unsigned int> mark_mx_, mark_my_;
+  std::vector<unsigned char> mark_valid_;
+
+  /// @brief Costs in 2 bits per cell, replacing those of the costmap with packed_storage
+  bool packed_storage_{false};
+  PackedCostmap packed_costmap_;
 };
 
 }  // namespace nav2_costmap_2d
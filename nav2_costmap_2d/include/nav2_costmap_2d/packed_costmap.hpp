@@ -0,0 +1,163 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_COSTMAP_2D__PACKED_COSTMAP_HPP_
+#define NAV2_COSTMAP_2D__PACKED_COSTMAP_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "nav2_costmap_2d/costmap_2d.hpp"
+#include "nav2_costmap_2d/cost_values.hpp"
+
+namespace nav2_costmap_2d
+{
+
+/**
+ * @class nav2_costmap_2d::PackedCostmap
+ * @brief Costs of a layer which only holds FREE_SPACE, LETHAL_OBSTACLE and NO_INFORMATION,
+ * stored in 2 bits per cell rather than a byte. Cells are indexed as in the Costmap2D of
+ * the same size, and the combination methods of the layers expand the bits straight into
+ * the master grid.
+ */
+class PackedCostmap
+{
+public:
+  // *INDENT-OFF* Uncrustify doesn't handle indented public/private labels
+  /**
+   * @class nav2_costmap_2d::PackedCostmap::MarkCell
+   * @brief Raytracing action setting the cost of the cells traced
+   */
+  class MarkCell
+  {
+  public:
+    MarkCell(PackedCostmap & costmap, unsigned char value)
+    : costmap_(costmap), value_(value)
+    {
+    }
+    inline void operator()(unsigned int offset)
+    {
+      costmap_.setCost(offset, value_);
+    }
+
+  private:
+    PackedCostmap & costmap_;
+    unsigned char value_;
+  };
+  // *INDENT-ON*
+
+  /**
+   * @brief Resize the costs, setting all cells to a cost
+   * @param size_x X size in cells
+   * @param size_y Y size in cells
+   * @param value Cost of the cells
+   */
+  void resize(unsigned int size_x, unsigned int size_y, unsigned char value);
+
+  /**
+   * @brief Set all cells to a cost
+   * @param value Cost of the cells
+   */
+  void reset(unsigned char value);
+
+  /**
+   * @brief Shift the costs for a new origin of the costmap, as Costmap2D::shiftMapRegion
+   * @param cell_ox The x coordinate of the new origin in the costmap (cells)
+   * @param cell_oy The y coordinate of the new origin in the costmap (cells)
+   * @param value Cost of the cells which were outside of the costmap
+   */
+  void shift(int cell_ox, int cell_oy, unsigned char value);
+
+  /**
+   * @brief Get the cost of a cell
+   * @param index Index of the cell
+   * @return FREE_SPACE, LETHAL_OBSTACLE or NO_INFORMATION
+   */
+  inline unsigned char getCost(unsigned int index) const
+  {
+    return toCost((bits_[index >> 2] >> ((index & 3) << 1)) & 3);
+  }
+
+  /**
+   * @brief Set the cost of a cell
+   * @param index Index of the cell
+   * @param cost Cost, stored as LETHAL_OBSTACLE unless FREE_SPACE or NO_INFORMATION
+   */
+  inline void setCost(unsigned int index, unsigned char cost)
+  {
+    const unsigned int shift = (index & 3) << 1;
+    uint8_t & byte = bits_[index >> 2];
+    byte = static_cast<uint8_t>((byte & ~(3u << shift)) | (toCode(cost) << shift));
+  }
+
+  /**
+   * @brief Combine a window of the costs into a master grid of the same size, with the
+   * rules of CostmapLayer::updateWithMax
+   */
+  void updateWithMax(Costmap2D & master_grid, int min_i, int min_j, int max_i, int max_j) const;
+
+  /**
+   * @brief Combine a window of the costs into a master grid of the same size, with the
+   * rules of CostmapLayer::updateWithMaxWithoutUnknownOverwrite
+   */
+  void updateWithMaxWithoutUnknownOverwrite(
+    Costmap2D & master_grid, int min_i, int min_j, int max_i, int max_j) const;
+
+  /**
+   * @brief Combine a window of the costs into a master grid of the same size, with the
+   * rules of CostmapLayer::updateWithOverwrite
+   */
+  void updateWithOverwrite(
+    Costmap2D & master_grid, int min_i, int min_j, int max_i, int max_j) const;
+
+  /**
+   * @brief Get the memory used by the costs
+   * @return Size in bytes
+   */
+  size_t getSizeInBytes() const {return bits_.size();}
+
+protected:
+  /// Codes of the costs in the bits of a cell
+  static constexpr unsigned int FREE_CODE = 0;
+  static constexpr unsigned int LETHAL_CODE = 1;
+  static constexpr unsigned int UNKNOWN_CODE = 2;
+
+  static inline unsigned int toCode(unsigned char cost)
+  {
+    return cost == NO_INFORMATION ? UNKNOWN_CODE :
+           (cost == FREE_SPACE ? FREE_CODE : LETHAL_CODE);
+  }
+
+  static inline unsigned char toCost(unsigned int code)
+  {
+    return code == UNKNOWN_CODE ? NO_INFORMATION :
+           (code == FREE_CODE ? FREE_SPACE : LETHAL_OBSTACLE);
+  }
+
+  /**
+   * @brief Combine a window of the costs into a master grid with a per cell rule
+   */
+  template<typename Combine>
+  void combine(
+    Costmap2D & master_grid, int min_i, int min_j, int max_i, int max_j,
+    Combine combine_cell) const;
+
+  unsigned int size_x_{0}, size_y_{0};
+  std::vector<uint8_t> bits_;
+};
+
+}  // namespace nav2_costmap_2d
+
+#endif  // NAV2_COSTMAP_2D__PACKED_COSTMAP_HPP_
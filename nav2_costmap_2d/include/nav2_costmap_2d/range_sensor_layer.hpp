@@ -123,6 +123,11 @@ public:
    */
   virtual bool isClearable() {return true;}
 
+  /**
+   * @brief Bounds are only grown by this layer's own observations
+   */
+  virtual bool hasIndependentBounds() {return true;}
+
   /**
    * @brief Handle an incoming Range message to populate into costmap
    */
@@ -176,11 +181,12 @@ protected:
   inline void get_deltas(double angle, double * dx, double * dy);
 
   /**
-   * @brief Update the cost in a cell with information
+   * @brief Apply the sensor model to the cone cells collected by updateCostmap() and
+   * update their costs with it
+   * @param r Range of the reading
+   * @param clear Whether the reading clears the whole cone
    */
-  inline void update_cell(
-    double ox, double oy, double ot,
-    double r, double nx, double ny, bool clear);
+  void update_cone(double r, bool clear);
 
   /**
    * @brief Find probability value of a cost
@@ -217,6 +223,11 @@ protected:
   std::vector<rclcpp::Subscription<sensor_msgs::msg::Range>::SharedPtr> range_subs_;
   double min_x_, min_y_, max_x_, max_y_;
 
+  // Cells of the cone of the reading being processed, with their distance and angle
+  // to the sensor and their sensor model value
+  std::vector<unsigned int> cone_cells_;
+  std::vector<double> cone_phi_, cone_theta_, cone_sensor_;
+
   /**
    * @brief Find the area of 3 points of a triangle
    */
@@ -0,0 +1,83 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef NAV2_COSTMAP_2D__SHARED_OBSERVATION_SOURCE_HPP_
+#define NAV2_COSTMAP_2D__SHARED_OBSERVATION_SOURCE_HPP_
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "nav2_costmap_2d/observation_buffer.hpp"
+
+namespace nav2_costmap_2d
+{
+
+/**
+ * @class SharedObservationSource
+ * @brief Observation buffers of a sensor in the layers of the costmaps of this process
+ * which make the same observations from it, i.e. with the same global frame and the same
+ * filtering of its data. Only one of these layers, the processor, transforms and filters
+ * each message of the sensor, and the resulting observation is handed to the buffers of
+ * the others, which share its point cloud.
+ */
+class SharedObservationSource
+{
+public:
+  /**
+   * @brief Get the source of a sensor, creating it if it has no user yet
+   * @param key Identifies the sensor and the parameters of the observations made from it
+   * @return Source of the sensor, existing as long as a user holds it
+   */
+  static std::shared_ptr<SharedObservationSource> acquire(const std::string & key);
+
+  /**
+   * @brief Add the buffer of a layer, to which the observations are handed
+   * @param buffer Observation buffer of the layer
+   */
+  void addBuffer(const std::shared_ptr<ObservationBuffer> & buffer);
+
+  /**
+   * @brief Whether a layer is to process the messages of the sensor, which it becomes if
+   * no other layer is
+   * @param layer Identifies the layer
+   */
+  bool isProcessor(const void * layer);
+
+  /**
+   * @brief Stop a layer from processing the messages, e.g. as it is no longer subscribed,
+   * so that the next layer receiving one takes over
+   * @param layer Identifies the layer
+   */
+  void release(const void * layer);
+
+  /**
+   * @brief Hand the latest observation of a buffer to the other buffers of the source
+   * @param buffer Buffer of the processor
+   */
+  void forward(const std::shared_ptr<ObservationBuffer> & buffer);
+
+protected:
+  std::mutex mutex_;
+  const void * processor_{nullptr};
+  std::vector<std::weak_ptr<ObservationBuffer>> buffers_;
+  // Cloud of the last observation handed over, not to hand it again
+  std::shared_ptr<sensor_msgs::msg::PointCloud2> last_cloud_;
+};
+
+}  // namespace nav2_costmap_2d
+
+#endif  // NAV2_COSTMAP_2D__SHARED_OBSERVATION_SOURCE_HPP_
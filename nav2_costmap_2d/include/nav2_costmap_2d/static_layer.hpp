@@ -38,6 +38,8 @@
 #ifndef NAV2_COSTMAP_2D__STATIC_LAYER_HPP_
 #define NAV2_COSTMAP_2D__STATIC_LAYER_HPP_
 
+#include <atomic>
+#include <limits>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -47,8 +49,10 @@
 #include "nav2_costmap_2d/costmap_layer.hpp"
 #include "nav2_costmap_2d/layered_costmap.hpp"
 #include "nav_msgs/msg/occupancy_grid.hpp"
+#include "nav2_msgs/srv/get_map_region.hpp"
 #include "rclcpp/rclcpp.hpp"
 #include "nav2_costmap_2d/footprint.hpp"
+#include "nav2_util/translation_table.hpp"
 
 namespace nav2_costmap_2d
 {
@@ -135,6 +139,13 @@ protected:
    */
   void processMap(const nav_msgs::msg::OccupancyGrid & new_map);
 
+  /**
+   * @brief Apply the changes of a new map of the same geometry and frame as the
+   * current one, updating only the window of the changed cells
+   * @param new_map The new map
+   */
+  void processMapChanges(const nav_msgs::msg::OccupancyGrid & new_map);
+
   /**
    * @brief  Callback to update the costmap's map from the map_server
    * @param new_map The map to put into the costmap. The origin of the new
@@ -148,12 +159,36 @@ protected:
    */
   void incomingUpdate(map_msgs::msg::OccupancyGridUpdate::ConstSharedPtr update);
 
+  /**
+   * @brief Request the region of the map around the robot from the map server,
+   * once the region loaded no longer covers the costmap with half of the margin
+   * @param robot_x X pose of robot
+   * @param robot_y Y pose of robot
+   */
+  void requestMapRegion(double robot_x, double robot_y);
+
   /**
    * @brief Interpret the value in the static map given on the topic to
    * convert into costs for the costmap to utilize
    */
   unsigned char interpretValue(unsigned char value);
 
+  /**
+   * @brief Tabulate interpretValue() for every value of the static map
+   * with the current parameters
+   * @return Costs of the static map values
+   */
+  nav2_util::ByteTranslationTable<unsigned char> makeCostTable();
+
+  /**
+   * @brief Grow the window of cells updated since the last updateBounds()
+   * @param x0 Lower x-boundary of the updated cells (inclusive)
+   * @param y0 Lower y-boundary of the updated cells (inclusive)
+   * @param xn Upper x-boundary of the updated cells (exclusive)
+   * @param yn Upper y-boundary of the updated cells (exclusive)
+   */
+  void addUpdatedWindow(unsigned int x0, unsigned int y0, unsigned int xn, unsigned int yn);
+
   /**
    * @brief Callback executed when a parameter change is detected
    * @param event ParameterEvent message
@@ -182,13 +217,30 @@ protected:
   unsigned int width_{0};
   unsigned int height_{0};
 
+  // Window of the cells updated since the last updateBounds(), empty if x0 > xn
+  unsigned int update_x0_{std::numeric_limits<unsigned int>::max()};
+  unsigned int update_y0_{std::numeric_limits<unsigned int>::max()};
+  unsigned int update_xn_{0};
+  unsigned int update_yn_{0};
+
   rclcpp::Subscription<nav_msgs::msg::OccupancyGrid>::SharedPtr map_sub_;
   rclcpp::Subscription<map_msgs::msg::OccupancyGridUpdate>::SharedPtr map_update_sub_;
+  rclcpp::Client<nav2_msgs::srv::GetMapRegion>::SharedPtr map_region_client_;
+
+  // Bounds of the region of the map last received, in the map frame
+  double region_min_x_{0.0};
+  double region_min_y_{0.0};
+  double region_max_x_{0.0};
+  double region_max_y_{0.0};
+  std::atomic<bool> map_region_requested_{false};
 
   // Parameters
   std::string map_topic_;
   bool map_subscribe_transient_local_;
   bool subscribe_to_updates_;
+  std::string map_region_service_;
+  std::string map_region_frame_;
+  double map_region_margin_;
   bool track_unknown_space_;
   bool use_maximum_;
   unsigned char lethal_threshold_;
@@ -0,0 +1,140 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef NAV2_COSTMAP_2D__TEMPORAL_OBSTACLE_LAYER_HPP_
+#define NAV2_COSTMAP_2D__TEMPORAL_OBSTACLE_LAYER_HPP_
+
+#include <cstdint>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "nav2_costmap_2d/obstacle_layer.hpp"
+
+namespace nav2_costmap_2d
+{
+
+/**
+ * @class TemporalObstacleLayer
+ * @brief An obstacle layer whose obstacles decay over time once they are no longer seen,
+ * in addition to being cleared by raytracing
+ *
+ * Obstacles stay lethal for persistence_time after they were last seen, then their cost
+ * decreases linearly over decay_time until they are removed. The time each cell was last
+ * seen is kept in a compact array, and the cells are kept in an expiry wheel of buckets by
+ * the tick they were seen in, so that only the cells seen within their lifetime are updated
+ * as they age, and never the whole grid.
+ */
+class TemporalObstacleLayer : public ObstacleLayer
+{
+public:
+  /**
+   * @brief A constructor
+   */
+  TemporalObstacleLayer() = default;
+
+  /**
+   * @brief A destructor
+   */
+  virtual ~TemporalObstacleLayer() = default;
+
+  /**
+   * @brief Initialization process of layer on startup
+   */
+  void onInitialize() override;
+
+  /**
+   * @brief Update the bounds of the master costmap by this layer's update dimensions,
+   * decaying the obstacles which aged since the last update
+   * @param robot_x X pose of robot
+   * @param robot_y Y pose of robot
+   * @param robot_yaw Robot orientation
+   * @param min_x X min map coord of the window to update
+   * @param min_y Y min map coord of the window to update
+   * @param max_x X max map coord of the window to update
+   * @param max_y Y max map coord of the window to update
+   */
+  void updateBounds(
+    double robot_x, double robot_y, double robot_yaw, double * min_x,
+    double * min_y,
+    double * max_x,
+    double * max_y) override;
+
+  /**
+   * @brief Update the layer's origin to a new pose, often when in a rolling costmap
+   */
+  void updateOrigin(double new_origin_x, double new_origin_y) override;
+
+  /**
+   * @brief Match the size of the master costmap
+   */
+  void matchSize() override;
+
+protected:
+  /**
+   * @brief Reset internal maps
+   */
+  void resetMaps() override;
+
+  /**
+   * @brief  Mark an obstacle seen in a cell of the layer, restarting its lifetime
+   * @param index The index of the cell
+   */
+  void markCell(unsigned int index) override;
+
+  /**
+   * @brief Decaying obstacles have costs below LETHAL_OBSTACLE, which can't be packed
+   */
+  bool canPackStorage() const override {return false;}
+
+  /**
+   * @brief  Decay the obstacles of the ticks which passed since the last update
+   * @param min_x
+   * @param min_y
+   * @param max_x
+   * @param max_y
+   */
+  void advanceWheel(double * min_x, double * min_y, double * max_x, double * max_y);
+
+  /**
+   * @brief  Stamp of a tick as kept in last_seen_, never 0
+   */
+  static inline uint16_t tickStamp(int64_t tick)
+  {
+    return static_cast<uint16_t>(tick % 0xFFFF + 1);
+  }
+
+  /// @brief A cell of the wheel, in cells from the origin of the layer when it was sized,
+  /// so that the wheel is kept as the layer rolls
+  struct SeenCell
+  {
+    int x;
+    int y;
+  };
+
+  double tick_period_{1.0};  ///< @brief Duration of a tick of the wheel, in seconds
+  /// @brief Cost of an obstacle by its age in ticks, with its lifetime as size
+  std::vector<unsigned char> age_costs_;
+  /// @brief Buckets of the cells seen in each tick of their lifetime, by tick modulo its size
+  std::vector<std::vector<SeenCell>> wheel_;
+  /// @brief Stamp of the tick each cell was last seen in, 0 if it is not in the wheel
+  std::vector<uint16_t> last_seen_;
+  rclcpp::Time epoch_;
+  int64_t current_tick_{-1};
+  int origin_cell_x_{0}, origin_cell_y_{0};
+};
+
+}  // namespace nav2_costmap_2d
+
+#endif  // NAV2_COSTMAP_2D__TEMPORAL_OBSTACLE_LAYER_HPP_
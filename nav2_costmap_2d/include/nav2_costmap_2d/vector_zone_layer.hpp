@@ -0,0 +1,126 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_COSTMAP_2D__VECTOR_ZONE_LAYER_HPP_
+#define NAV2_COSTMAP_2D__VECTOR_ZONE_LAYER_HPP_
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "nav2_costmap_2d/layer.hpp"
+#include "nav2_costmap_2d/zone_index.hpp"
+#include "nav2_msgs/msg/speed_limit.hpp"
+#include "nav2_msgs/srv/update_costmap_zones.hpp"
+
+namespace nav2_costmap_2d
+{
+
+/**
+ * @class nav2_costmap_2d::VectorZoneLayer
+ * @brief Keepout and speed limit zones given as polygons through a service rather than as
+ * raster masks. The zones are held in a ZoneIndex, so each cycle only rasterizes the zones
+ * intersecting the window updated and finds the speed limit of the robot by a point query.
+ */
+class VectorZoneLayer : public Layer
+{
+public:
+  VectorZoneLayer() = default;
+  ~VectorZoneLayer() = default;
+
+  /**
+   * @brief Activate the speed limit publisher
+   */
+  void activate() override;
+
+  /**
+   * @brief Deactivate the speed limit publisher
+   */
+  void deactivate() override;
+
+  /**
+   * @brief Reset the layer, keeping its zones
+   */
+  void reset() override;
+
+  /**
+   * @brief Zones are not cleared by the costmap clearing services
+   */
+  bool isClearable() override {return false;}
+
+  /**
+   * @brief Expand the bounds by the zones changed since the last update, or by the zones
+   * within the costmap for a rolling costmap, and publish the speed limit of the robot pose
+   */
+  void updateBounds(
+    double robot_x, double robot_y, double robot_yaw,
+    double * min_x, double * min_y, double * max_x, double * max_y) override;
+
+  /**
+   * @brief Rasterize the zones intersecting the window into the master grid
+   * @param master_grid The master costmap grid to update
+   * @param min_i X min map coord of the window to update
+   * @param min_j Y min map coord of the window to update
+   * @param max_i X max map coord of the window to update
+   * @param max_j Y max map coord of the window to update
+   */
+  void updateCosts(
+    nav2_costmap_2d::Costmap2D & master_grid,
+    int min_i, int min_j, int max_i, int max_j) override;
+
+protected:
+  /**
+   * @brief Read the parameters and create the zones service and speed limit publisher
+   */
+  void onInitialize() override;
+
+  /**
+   * @brief Add, replace or remove zones by their id and rebuild the index
+   */
+  void updateZonesCallback(
+    const std::shared_ptr<rmw_request_id_t> request_header,
+    const std::shared_ptr<nav2_msgs::srv::UpdateCostmapZones::Request> request,
+    std::shared_ptr<nav2_msgs::srv::UpdateCostmapZones::Response> response);
+
+  /**
+   * @brief Expand the dirty bounds by the bounding box of a zone
+   */
+  void touchZone(const Zone & zone);
+
+  /**
+   * @brief Publish the speed limit of the zones containing the robot if it changed
+   */
+  void updateSpeedLimit(double robot_x, double robot_y);
+
+  std::mutex mutex_;
+  ZoneIndex index_;
+  std::string global_frame_;
+
+  /// Bounds of the zones added or removed since the last update
+  double dirty_min_x_, dirty_min_y_, dirty_max_x_, dirty_max_y_;
+  bool dirty_{false};
+
+  bool percentage_{false};
+  double speed_limit_prev_{0.0};
+  std::vector<size_t> found_;
+
+  rclcpp::Service<nav2_msgs::srv::UpdateCostmapZones>::SharedPtr zones_service_;
+  rclcpp_lifecycle::LifecyclePublisher<nav2_msgs::msg::SpeedLimit>::SharedPtr speed_limit_pub_;
+};
+
+}  // namespace nav2_costmap_2d
+
+#endif  // NAV2_COSTMAP_2D__VECTOR_ZONE_LAYER_HPP_
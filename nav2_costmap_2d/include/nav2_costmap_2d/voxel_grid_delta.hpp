@@ -0,0 +1,83 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_COSTMAP_2D__VOXEL_GRID_DELTA_HPP_
+#define NAV2_COSTMAP_2D__VOXEL_GRID_DELTA_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "nav2_msgs/msg/voxel_grid.hpp"
+#include "nav2_msgs/msg/voxel_grid_delta.hpp"
+
+namespace nav2_costmap_2d
+{
+
+/**
+ * @brief Run-length encode the voxel statuses of columns of a voxel grid, as packed by
+ * nav2_voxel_grid::VoxelGrid, each from its lowest voxel
+ * @param columns Columns to encode
+ * @param size_z Number of voxels of the columns, at most 16
+ * @param data Output to append the runs to
+ */
+void encodeVoxelColumns(
+  const std::vector<uint32_t> & columns, unsigned int size_z, std::vector<uint8_t> & data);
+
+/**
+ * @brief Decode columns encoded by encodeVoxelColumns. Unknown voxels are set to their lower
+ * bit only and the bits above size_z are cleared, which keeps the status of each voxel.
+ * @param data Encoded runs
+ * @param size_z Number of voxels of the columns, at most 16
+ * @param columns Columns to decode, sized to the number of columns encoded
+ * @return False if the runs do not match the columns
+ */
+bool decodeVoxelColumns(
+  const std::vector<uint8_t> & data, unsigned int size_z, std::vector<uint32_t> & columns);
+
+/**
+ * @brief Fill a delta with the columns of a window of a voxel grid which differ from a
+ * reference copy of the grid, and update the reference to the grid. Only the voxels below
+ * size_z are compared, and columns outside of the window are assumed unchanged.
+ * @param columns Columns of the grid, in row-major order
+ * @param size_x Number of columns along x
+ * @param size_y Number of columns along y
+ * @param size_z Number of voxels of the columns, at most 16
+ * @param x0 Lower x-boundary of the changed window (inclusive)
+ * @param y0 Lower y-boundary of the changed window (inclusive)
+ * @param xn Upper x-boundary of the changed window (exclusive)
+ * @param yn Upper y-boundary of the changed window (exclusive)
+ * @param reference Columns at the previous delta, resized to the grid for keyframes
+ * @param keyframe Whether to include all columns rather than only changed ones
+ * @param msg Delta to fill, apart from the header, sequence, origin and resolutions
+ */
+void createVoxelGridDelta(
+  const uint32_t * columns, unsigned int size_x, unsigned int size_y, unsigned int size_z,
+  unsigned int x0, unsigned int y0, unsigned int xn, unsigned int yn,
+  std::vector<uint32_t> & reference, bool keyframe, nav2_msgs::msg::VoxelGridDelta & msg);
+
+/**
+ * @brief Write the columns of a delta to a voxel grid. Keyframes set the geometry of the
+ * grid, other deltas need the geometry of the grid to match theirs apart from an origin
+ * moved by whole cells, for which the grid is shifted first, clearing the columns shifted in.
+ * @param msg Delta to apply
+ * @param grid Voxel grid to write to, also given the header of the delta
+ * @return False if the geometry differs or the delta is malformed
+ */
+bool applyVoxelGridDelta(
+  const nav2_msgs::msg::VoxelGridDelta & msg, nav2_msgs::msg::VoxelGrid & grid);
+
+}  // namespace nav2_costmap_2d
+
+#endif  // NAV2_COSTMAP_2D__VOXEL_GRID_DELTA_HPP_
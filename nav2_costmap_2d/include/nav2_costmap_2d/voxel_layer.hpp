@@ -39,6 +39,8 @@
 #define NAV2_COSTMAP_2D__VOXEL_LAYER_HPP_
 
 #include <vector>
+#include <array>
+#include <memory>
 #include "message_filters/subscriber.h"
 
 #include <rclcpp/rclcpp.hpp>
@@ -47,12 +49,15 @@
 #include <nav2_costmap_2d/observation_buffer.hpp>
 #include <nav_msgs/msg/occupancy_grid.hpp>
 #include <nav2_msgs/msg/voxel_grid.hpp>
+#include <nav2_msgs/msg/voxel_grid_delta.hpp>
 #include <sensor_msgs/msg/laser_scan.hpp>
 #include <laser_geometry/laser_geometry.hpp>
 #include <sensor_msgs/msg/point_cloud.hpp>
 #include <sensor_msgs/msg/point_cloud2.hpp>
 #include <nav2_costmap_2d/obstacle_layer.hpp>
 #include <nav2_voxel_grid/voxel_grid.hpp>
+#include <nav2_voxel_grid/sparse_voxel_grid.hpp>
+#include "nav2_util/thread_pool.hpp"
 
 namespace nav2_costmap_2d
 {
@@ -68,7 +73,7 @@ public:
    * @brief Voxel Layer constructor
    */
   VoxelLayer()
-  : voxel_grid_(0, 0, 0)
+  : voxel_grid_(0, 0, 0), sparse_voxel_grid_(0, 0, 0)
   {
     costmap_ = NULL;  // this is the unsigned char* member of parent class's parent class Costmap2D
   }
@@ -133,6 +138,11 @@ protected:
    */
   virtual void resetMaps();
 
+  /**
+   * @brief The voxel grid is projected straight into the bytes of the costmap
+   */
+  virtual bool canPackStorage() const {return false;}
+
   /**
    * @brief Use raycasting between 2 points to clear freespace
    */
@@ -142,9 +152,40 @@ protected:
     double * max_x,
     double * max_y);
 
+  /**
+   * @brief Publish the columns of the voxel grid changed since the last delta, looking for
+   * them within the bounds of this update, or a keyframe of all columns when needed
+   * @param min_x X min of the bounds of the update
+   * @param min_y Y min of the bounds of the update
+   * @param max_x X max of the bounds of the update
+   * @param max_y Y max of the bounds of the update
+   */
+  void publishVoxelGridDelta(double min_x, double min_y, double max_x, double max_y);
+
   bool publish_voxel_;
   rclcpp_lifecycle::LifecyclePublisher<nav2_msgs::msg::VoxelGrid>::SharedPtr voxel_pub_;
+  bool publish_voxel_deltas_{false};
+  rclcpp_lifecycle::LifecyclePublisher<nav2_msgs::msg::VoxelGridDelta>::SharedPtr
+    voxel_delta_pub_;
+  /// @brief Columns, geometry and subscribers as of the last voxel grid delta
+  std::vector<uint32_t> delta_reference_, delta_columns_;
+  double delta_origin_x_{0.0}, delta_origin_y_{0.0}, delta_resolution_{0.0};
+  size_t delta_subscribers_{0};
+  uint32_t delta_sequence_{0};
+  unsigned int deltas_since_keyframe_{0};
+  bool delta_grid_moved_{false};
   nav2_voxel_grid::VoxelGrid voxel_grid_;
+  /// @brief Brick-based voxel storage, used instead of voxel_grid_ if sparse_voxel_grid is set
+  nav2_voxel_grid::SparseVoxelGrid sparse_voxel_grid_;
+  bool sparse_voxel_grid_enabled_{false};
+  /// @brief Whether to only keep the height interval of the obstacles of each column and
+  /// clear in 2D the columns whose interval the rays pass through, instead of a voxel grid
+  bool projected_2d_{false};
+  std::vector<float> column_min_z_, column_max_z_;
+  /// @brief Workers clearing the rays of the dense voxel grid with the update thread, if
+  /// clearing_threads is set, and the ends of the rays of an observation in map coordinates
+  std::unique_ptr<nav2_util::ThreadPool> clearing_pool_;
+  std::vector<std::array<double, 3>> clearing_rays_;
   double z_resolution_, origin_z_;
   int unknown_threshold_, mark_threshold_, size_z_;
   rclcpp_lifecycle::LifecyclePublisher<sensor_msgs::msg::PointCloud2>::SharedPtr
@@ -0,0 +1,131 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_COSTMAP_2D__ZONE_INDEX_HPP_
+#define NAV2_COSTMAP_2D__ZONE_INDEX_HPP_
+
+#include <string>
+#include <vector>
+
+#include "geometry_msgs/msg/point.hpp"
+#include "nav2_costmap_2d/costmap_2d.hpp"
+
+namespace nav2_costmap_2d
+{
+
+/**
+ * @struct nav2_costmap_2d::Zone
+ * @brief Polygonal zone with a cost and a speed limit
+ */
+struct Zone
+{
+  std::string id;
+  std::vector<geometry_msgs::msg::Point> polygon;
+  unsigned char cost{0};  ///< Cost of the cells inside of the zone, 0 for none
+  double speed_limit{0.0};  ///< Speed limit inside of the zone, 0.0 for none
+  double min_x{0.0}, min_y{0.0}, max_x{0.0}, max_y{0.0};  ///< Bounding box of the polygon
+
+  /**
+   * @brief Compute the bounding box of the polygon
+   */
+  void updateBounds();
+
+  /**
+   * @brief Whether a point is inside of the polygon
+   * @param x X of the point
+   * @param y Y of the point
+   * @return bool If inside
+   */
+  bool contains(double x, double y) const;
+};
+
+/**
+ * @class nav2_costmap_2d::ZoneIndex
+ * @brief R-tree of the bounding boxes of zones, bulk loaded by Sort-Tile-Recursive packing,
+ * to find the few zones intersecting an update window or containing the robot among many.
+ * Zones are updated rarely, so the tree is rebuilt rather than updated in place.
+ */
+class ZoneIndex
+{
+public:
+  /**
+   * @brief Build the tree of a set of zones, replacing the previous ones
+   * @param zones Zones, with their bounding boxes computed
+   */
+  void build(std::vector<Zone> zones);
+
+  /**
+   * @brief Get the zones indexed
+   * @return Zones, in the order of the indices of the queries
+   */
+  const std::vector<Zone> & getZones() const {return zones_;}
+
+  /**
+   * @brief Find the zones whose bounding box intersects a box
+   * @param min_x X min of the box
+   * @param min_y Y min of the box
+   * @param max_x X max of the box
+   * @param max_y Y max of the box
+   * @param found Indices of the zones found
+   */
+  void query(
+    double min_x, double min_y, double max_x, double max_y, std::vector<size_t> & found) const;
+
+  /**
+   * @brief Find the zones containing a point
+   * @param x X of the point
+   * @param y Y of the point
+   * @param found Indices of the zones found
+   */
+  void queryPoint(double x, double y, std::vector<size_t> & found) const;
+
+  /**
+   * @brief Set the cells of a window of a costmap whose center is inside of a zone to the
+   * maximum of their cost and the costs of the zones, unknown cells taking the zone's cost
+   * @param costmap Costmap, in the frame of the zones
+   * @param min_i X min map coord of the window
+   * @param min_j Y min map coord of the window
+   * @param max_i X max map coord of the window, excluded
+   * @param max_j Y max map coord of the window, excluded
+   */
+  void rasterize(Costmap2D & costmap, int min_i, int min_j, int max_i, int max_j) const;
+
+protected:
+  /**
+   * @brief Node of the tree, whose children are nodes or zones in a contiguous range
+   */
+  struct Node
+  {
+    double min_x, min_y, max_x, max_y;
+    unsigned int first, count;
+    bool leaf;
+  };
+
+  /**
+   * @brief Group nodes into parents of up to NODE_CAPACITY children each by tiling them
+   * along x then along y, reordering the nodes as the children of the parents
+   * @param nodes Nodes to group, reordered
+   * @return Parents, whose children are indices into the reordered nodes
+   */
+  static std::vector<Node> packLevel(std::vector<Node> & nodes);
+
+  static constexpr unsigned int NODE_CAPACITY = 8;
+
+  std::vector<Zone> zones_;
+  std::vector<Node> nodes_;  ///< Nodes of all levels, the root last
+};
+
+}  // namespace nav2_costmap_2d
+
+#endif  // NAV2_COSTMAP_2D__ZONE_INDEX_HPP_
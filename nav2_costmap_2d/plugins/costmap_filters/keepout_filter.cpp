@@ -38,6 +38,8 @@
 #include <string>
 #include <memory>
 #include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #include "tf2/convert.h"
 #include "tf2_geometry_msgs/tf2_geometry_msgs.hpp"
 
@@ -163,8 +165,6 @@ void KeepoutFilter::process(
 
   tf2::Transform tf2_transform;
   tf2_transform.setIdentity();  // initialize by identical transform
-  int mg_min_x, mg_min_y;  // masger_grid indexes of bottom-left window corner
-  int mg_max_x, mg_max_y;  // masger_grid indexes of top-right window corner
 
   const std::string mask_frame = filter_mask_->header.frame_id;
 
@@ -185,91 +185,138 @@ void KeepoutFilter::process(
       return;
     }
     tf2::fromMsg(transform.transform, tf2_transform);
+  }
 
-    mg_min_x = min_i;
-    mg_min_y = min_j;
-    mg_max_x = max_i;
-    mg_max_y = max_j;
-  } else {
-    // Filter mask and current layer are in the same frame:
-    // apply the following optimization - iterate only in overlapped
-    // (min_i, min_j)..(max_i, max_j) & filter_mask_ area.
-    //
-    //           filter_mask_
-    //       *----------------------------*
-    //       |                            |
-    //       |                            |
-    //       |      (2)                   |
-    // *-----+-------*                    |
-    // |     |///////|<- overlapped area  |
-    // |     |///////|   to iterate in    |
-    // |     *-------+--------------------*
-    // |    (1)      |
-    // |             |
-    // *-------------*
-    //  master_grid (min_i, min_j)..(max_i, max_j) window
-    //
-    // ToDo: after costmap rotation will be added, this should be re-worked.
-
-    double wx, wy;  // world coordinates
-
-    // Calculating bounds corresponding to bottom-left overlapping (1) corner
-    // filter_mask_ -> master_grid indexes conversion
-    const double half_cell_size = 0.5 * filter_mask_->info.resolution;
-    wx = filter_mask_->info.origin.position.x + half_cell_size;
-    wy = filter_mask_->info.origin.position.y + half_cell_size;
-    master_grid.worldToMapNoBounds(wx, wy, mg_min_x, mg_min_y);
-    // Calculation of (1) corner bounds
-    if (mg_min_x >= max_i || mg_min_y >= max_j) {
-      // There is no overlapping. Do nothing.
-      return;
+  min_i = std::max(min_i, 0);
+  min_j = std::max(min_j, 0);
+  max_i = std::min(max_i, static_cast<int>(master_grid.getSizeInCellsX()));
+  max_j = std::min(max_j, static_cast<int>(master_grid.getSizeInCellsY()));
+  if (min_i >= max_i || min_j >= max_j) {
+    return;
+  }
+
+  // Resample the mask to master_grid once, rather than transforming
+  // and looking up every cell on every cycle
+  updateAlignedMask(master_grid, tf2_transform, min_i, min_j, max_i, max_j);
+
+  // Main master_grid updating loop
+  // Iterate in costmap window by master_grid indexes
+  unsigned char * master_array = master_grid.getCharMap();
+  for (int j = min_j; j < max_j; j++) {
+    const unsigned int row = master_grid.getIndex(0, j);
+    unsigned char * master_row = master_array + row;
+    const unsigned char * mask_row = aligned_mask_.data() + row;
+    for (int i = min_i; i < max_i; i++) {
+      const unsigned char data = mask_row[i];
+      const unsigned char old_data = master_row[i];
+      // Update if mask_ data is valid and greater than existing master_grid's one
+      if (data != NO_INFORMATION && (data > old_data || old_data == NO_INFORMATION)) {
+        master_row[i] = data;
+      }
     }
-    mg_min_x = std::max(min_i, mg_min_x);
-    mg_min_y = std::max(min_j, mg_min_y);
-
-    // Calculating bounds corresponding to top-right window (2) corner
-    // filter_mask_ -> master_grid intexes conversion
-    wx = filter_mask_->info.origin.position.x +
-      filter_mask_->info.width * filter_mask_->info.resolution + half_cell_size;
-    wy = filter_mask_->info.origin.position.y +
-      filter_mask_->info.height * filter_mask_->info.resolution + half_cell_size;
-    master_grid.worldToMapNoBounds(wx, wy, mg_max_x, mg_max_y);
-    // Calculation of (2) corner bounds
-    if (mg_max_x <= min_i || mg_max_y <= min_j) {
-      // There is no overlapping. Do nothing.
-      return;
+  }
+}
+
+void KeepoutFilter::updateAlignedMask(
+  const nav2_costmap_2d::Costmap2D & master_grid, const tf2::Transform & mask_transform,
+  int min_i, int min_j, int max_i, int max_j)
+{
+  const unsigned int size_x = master_grid.getSizeInCellsX();
+  const unsigned int size_y = master_grid.getSizeInCellsY();
+  const double resolution = master_grid.getResolution();
+  const double origin_x = master_grid.getOriginX();
+  const double origin_y = master_grid.getOriginY();
+
+  if (aligned_filter_mask_ != filter_mask_ || !(aligned_transform_ == mask_transform) ||
+    aligned_size_x_ != size_x || aligned_size_y_ != size_y ||
+    aligned_resolution_ != resolution)
+  {
+    // Nothing can be reused
+    aligned_filter_mask_ = filter_mask_;
+    aligned_transform_ = mask_transform;
+    aligned_size_x_ = size_x;
+    aligned_size_y_ = size_y;
+    aligned_resolution_ = resolution;
+    aligned_origin_x_ = origin_x;
+    aligned_origin_y_ = origin_y;
+    aligned_mask_.assign(size_x * size_y, NO_INFORMATION);
+    aligned_min_x_ = aligned_min_y_ = aligned_max_x_ = aligned_max_y_ = 0;
+  } else if (aligned_origin_x_ != origin_x || aligned_origin_y_ != origin_y) {
+    // A rolling window moved by whole cells: shift the costs which are still valid,
+    // as Costmap2D::updateOrigin() does
+    const double shift_x = (origin_x - aligned_origin_x_) / resolution;
+    const double shift_y = (origin_y - aligned_origin_y_) / resolution;
+    const int cell_ox = static_cast<int>(std::lround(shift_x));
+    const int cell_oy = static_cast<int>(std::lround(shift_y));
+    aligned_origin_x_ = origin_x;
+    aligned_origin_y_ = origin_y;
+
+    const int new_min_x = std::max(aligned_min_x_ - cell_ox, 0);
+    const int new_min_y = std::max(aligned_min_y_ - cell_oy, 0);
+    const int new_max_x = std::min(aligned_max_x_ - cell_ox, static_cast<int>(size_x));
+    const int new_max_y = std::min(aligned_max_y_ - cell_oy, static_cast<int>(size_y));
+    if (std::abs(shift_x - cell_ox) > 1e-3 || std::abs(shift_y - cell_oy) > 1e-3 ||
+      new_min_x >= new_max_x || new_min_y >= new_max_y)
+    {
+      aligned_min_x_ = aligned_min_y_ = aligned_max_x_ = aligned_max_y_ = 0;
+    } else {
+      aligned_mask_spare_.resize(size_x * size_y);
+      for (int y = new_min_y; y < new_max_y; y++) {
+        std::copy_n(
+          aligned_mask_.begin() + (y + cell_oy) * size_x + new_min_x + cell_ox,
+          new_max_x - new_min_x,
+          aligned_mask_spare_.begin() + y * size_x + new_min_x);
+      }
+      aligned_mask_.swap(aligned_mask_spare_);
+      aligned_min_x_ = new_min_x;
+      aligned_min_y_ = new_min_y;
+      aligned_max_x_ = new_max_x;
+      aligned_max_y_ = new_max_y;
     }
-    mg_max_x = std::min(max_i, mg_max_x);
-    mg_max_y = std::min(max_j, mg_max_y);
   }
 
-  // unsigned<-signed conversions.
-  unsigned const int mg_min_x_u = static_cast<unsigned int>(mg_min_x);
-  unsigned const int mg_min_y_u = static_cast<unsigned int>(mg_min_y);
-  unsigned const int mg_max_x_u = static_cast<unsigned int>(mg_max_x);
-  unsigned const int mg_max_y_u = static_cast<unsigned int>(mg_max_y);
+  if (aligned_min_x_ >= aligned_max_x_ || aligned_min_y_ >= aligned_max_y_) {
+    alignMaskWindow(master_grid, mask_transform, min_i, min_j, max_i, max_j);
+  } else {
+    // Grow the valid window to the bounding box of it and the requested one,
+    // resampling the strips around it
+    const int vx0 = aligned_min_x_, vxn = aligned_max_x_;
+    const int vy0 = aligned_min_y_, vyn = aligned_max_y_;
+    const int x0 = std::min(min_i, vx0), xn = std::max(max_i, vxn);
+    const int y0 = std::min(min_j, vy0), yn = std::max(max_j, vyn);
+    alignMaskWindow(master_grid, mask_transform, x0, y0, xn, vy0);
+    alignMaskWindow(master_grid, mask_transform, x0, vyn, xn, yn);
+    alignMaskWindow(master_grid, mask_transform, x0, vy0, vx0, vyn);
+    alignMaskWindow(master_grid, mask_transform, vxn, vy0, xn, vyn);
+    min_i = x0;
+    min_j = y0;
+    max_i = xn;
+    max_j = yn;
+  }
+  aligned_min_x_ = min_i;
+  aligned_min_y_ = min_j;
+  aligned_max_x_ = max_i;
+  aligned_max_y_ = max_j;
+}
 
-  unsigned int i, j;  // master_grid iterators
-  unsigned int index;  // corresponding index of master_grid
+void KeepoutFilter::alignMaskWindow(
+  const nav2_costmap_2d::Costmap2D & master_grid, const tf2::Transform & mask_transform,
+  int min_i, int min_j, int max_i, int max_j)
+{
+  const bool transform_mask = filter_mask_->header.frame_id != global_frame_;
   double gl_wx, gl_wy;  // world coordinates in a global_frame_
   double msk_wx, msk_wy;  // world coordinates in a mask_frame
   unsigned int mx, my;  // filter_mask_ coordinates
-  unsigned char data, old_data;  // master_grid element data
 
-  // Main master_grid updating loop
-  // Iterate in costmap window by master_grid indexes
-  unsigned char * master_array = master_grid.getCharMap();
-  for (i = mg_min_x_u; i < mg_max_x_u; i++) {
-    for (j = mg_min_y_u; j < mg_max_y_u; j++) {
-      index = master_grid.getIndex(i, j);
-      old_data = master_array[index];
+  for (int j = min_j; j < max_j; j++) {
+    for (int i = min_i; i < max_i; i++) {
       // Calculating corresponding to (i, j) point at filter_mask_:
       // Get world coordinates in global_frame_
       master_grid.mapToWorld(i, j, gl_wx, gl_wy);
-      if (mask_frame != global_frame_) {
+      if (transform_mask) {
         // Transform (i, j) point from global_frame_ to mask_frame
         tf2::Vector3 point(gl_wx, gl_wy, 0);
-        point = tf2_transform * point;
+        point = mask_transform * point;
         msk_wx = point.x();
         msk_wy = point.y();
       } else {
@@ -278,16 +325,11 @@ void KeepoutFilter::process(
         msk_wy = gl_wy;
       }
       // Get mask coordinates corresponding to (i, j) point at filter_mask_
+      unsigned char data = NO_INFORMATION;
       if (worldToMask(filter_mask_, msk_wx, msk_wy, mx, my)) {
         data = getMaskCost(filter_mask_, mx, my);
-        // Update if mask_ data is valid and greater than existing master_grid's one
-        if (data == NO_INFORMATION) {
-          continue;
-        }
-        if (data > old_data || old_data == NO_INFORMATION) {
-          master_array[index] = data;
-        }
       }
+      aligned_mask_[master_grid.getIndex(i, j)] = data;
     }
   }
 }
@@ -298,6 +340,10 @@ void KeepoutFilter::resetFilter()
 
   filter_info_sub_.reset();
   mask_sub_.reset();
+
+  aligned_filter_mask_.reset();
+  aligned_mask_.clear();
+  aligned_mask_spare_.clear();
 }
 
 bool KeepoutFilter::isActive()
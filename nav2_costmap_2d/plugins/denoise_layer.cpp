@@ -18,12 +18,27 @@
 #include <vector>
 #include <algorithm>
 #include <memory>
+#include <cmath>
+#include <cstdlib>
 
 #include "rclcpp/rclcpp.hpp"
 
 namespace nav2_costmap_2d
 {
 
+namespace
+{
+// Cell states kept by DenoiseLayer::removeGroupsIncremental()
+constexpr uint8_t CELL_OUTSIDE = 0;
+constexpr uint8_t CELL_FREE = 1;
+constexpr uint8_t CELL_OBSTACLE = 2;
+constexpr uint8_t CELL_STATE_MASK = 3;
+// The cell belongs to a group smaller than minimal_group_size_
+constexpr uint8_t CELL_NOISE = 4;
+// The cell was queued while labelling the current group
+constexpr uint8_t CELL_VISITED = 8;
+}  // namespace
+
 void
 DenoiseLayer::onInitialize()
 {
@@ -33,6 +48,8 @@ DenoiseLayer::onInitialize()
   declareParameter("minimal_group_size", rclcpp::ParameterValue(2));
   // Pixels connectivity type
   declareParameter("group_connectivity_type", rclcpp::ParameterValue(8));
+  // Keep groups between updates
+  declareParameter("incremental", rclcpp::ParameterValue(false));
 
   const auto node = node_.lock();
 
@@ -40,6 +57,7 @@ DenoiseLayer::onInitialize()
     throw std::runtime_error("DenoiseLayer::onInitialize: Failed to lock node");
   }
   node->get_parameter(name_ + "." + "enabled", enabled_);
+  node->get_parameter(name_ + "." + "incremental", incremental_);
 
   auto getInt = [&](const std::string & parameter_name) {
       int param{};
@@ -83,6 +101,7 @@ DenoiseLayer::onInitialize()
 void
 DenoiseLayer::reset()
 {
+  cell_states_.clear();
   current_ = false;
 }
 
@@ -111,6 +130,12 @@ DenoiseLayer::updateCosts(
   }
   no_information_is_obstacle_ = master_grid.getDefaultValue() != NO_INFORMATION;
 
+  if (incremental_ && minimal_group_size_ > 1) {
+    removeGroupsIncremental(master_grid, min_x, min_y, max_x, max_y);
+    current_ = true;
+    return;
+  }
+
   // wrap roi_image over existing costmap2d buffer
   unsigned char * master_array = master_grid.getCharMap();
   const int step = static_cast<int>(master_grid.getSizeInCellsX());
@@ -194,6 +219,177 @@ DenoiseLayer::removeSinglePixels(Image<uint8_t> & image) const
     });
 }
 
+void
+DenoiseLayer::removeGroupsIncremental(
+  nav2_costmap_2d::Costmap2D & master_grid, int min_x, int min_y, int max_x, int max_y)
+{
+  alignCellStates(master_grid);
+
+  const int size_x = static_cast<int>(master_grid.getSizeInCellsX());
+  const int size_y = static_cast<int>(master_grid.getSizeInCellsY());
+  unsigned char * costs = master_grid.getCharMap();
+  uint8_t * states = cell_states_.data();
+
+  // Update the obstacle states over both the previous and the current windows,
+  // cells outside of the window can't be part of any group
+  int scan_min_x = min_x, scan_min_y = min_y, scan_max_x = max_x, scan_max_y = max_y;
+  if (states_min_x_ < states_max_x_ && states_min_y_ < states_max_y_) {
+    scan_min_x = std::min(scan_min_x, states_min_x_);
+    scan_min_y = std::min(scan_min_y, states_min_y_);
+    scan_max_x = std::max(scan_max_x, states_max_x_);
+    scan_max_y = std::max(scan_max_y, states_max_y_);
+  }
+
+  changed_.clear();
+  for (int y = scan_min_y; y < scan_max_y; y++) {
+    const bool row_in_window = y >= min_y && y < max_y;
+    for (int x = scan_min_x; x < scan_max_x; x++) {
+      const unsigned int index = y * size_x + x;
+      uint8_t state = CELL_OUTSIDE;
+      if (row_in_window && x >= min_x && x < max_x) {
+        state = isBackground(costs[index]) ? CELL_FREE : CELL_OBSTACLE;
+      }
+      if ((states[index] & CELL_STATE_MASK) != state) {
+        states[index] = state;
+        changed_.push_back(index);
+      }
+    }
+  }
+
+  states_min_x_ = min_x;
+  states_min_y_ = min_y;
+  states_max_x_ = max_x;
+  states_max_y_ = max_y;
+
+  const bool way8 = group_connectivity_type_ == ConnectivityType::Way8;
+  auto forEachNeighbor = [&](unsigned int index, auto && fn) {
+      const int x = index % size_x;
+      const int y = index / size_x;
+      for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+          if ((dx == 0 && dy == 0) || (!way8 && dx != 0 && dy != 0)) {
+            continue;
+          }
+          const int nx = x + dx;
+          const int ny = y + dy;
+          if (nx >= 0 && nx < size_x && ny >= 0 && ny < size_y) {
+            fn(ny * size_x + nx);
+          }
+        }
+      }
+    };
+
+  // Only the groups containing a changed obstacle, or an obstacle next to a changed cell,
+  // may differ from the previous update
+  seeds_.clear();
+  for (const unsigned int index : changed_) {
+    if (states[index] == CELL_OBSTACLE) {
+      seeds_.push_back(index);
+    }
+    forEachNeighbor(
+      index, [&](unsigned int neighbor) {
+        if ((states[neighbor] & CELL_STATE_MASK) == CELL_OBSTACLE) {
+          seeds_.push_back(neighbor);
+        }
+      });
+  }
+
+  for (const unsigned int seed : seeds_) {
+    if (states[seed] & CELL_VISITED) {
+      continue;
+    }
+
+    group_.clear();
+    group_.push_back(seed);
+    states[seed] |= CELL_VISITED;
+    for (size_t i = 0; i < group_.size(); i++) {
+      forEachNeighbor(
+        group_[i], [&](unsigned int neighbor) {
+          if ((states[neighbor] & (CELL_STATE_MASK | CELL_VISITED)) == CELL_OBSTACLE) {
+            states[neighbor] |= CELL_VISITED;
+            group_.push_back(neighbor);
+          }
+        });
+    }
+
+    const uint8_t state = group_.size() < minimal_group_size_ ?
+      CELL_OBSTACLE | CELL_NOISE : CELL_OBSTACLE;
+    for (const unsigned int index : group_) {
+      states[index] = state;
+    }
+  }
+
+  for (int y = min_y; y < max_y; y++) {
+    for (int x = min_x; x < max_x; x++) {
+      const unsigned int index = y * size_x + x;
+      if (states[index] == (CELL_OBSTACLE | CELL_NOISE)) {
+        costs[index] = FREE_SPACE;
+      }
+    }
+  }
+}
+
+bool
+DenoiseLayer::alignCellStates(const nav2_costmap_2d::Costmap2D & master_grid)
+{
+  const unsigned int size_x = master_grid.getSizeInCellsX();
+  const unsigned int size_y = master_grid.getSizeInCellsY();
+  const double resolution = master_grid.getResolution();
+  const double shift_x = (master_grid.getOriginX() - states_origin_x_) / resolution;
+  const double shift_y = (master_grid.getOriginY() - states_origin_y_) / resolution;
+  const int cell_dx = static_cast<int>(std::lround(shift_x));
+  const int cell_dy = static_cast<int>(std::lround(shift_y));
+
+  const bool same_grid = cell_states_.size() == size_x * size_y &&
+    size_x == states_size_x_ && size_y == states_size_y_ &&
+    resolution == states_resolution_ &&
+    no_information_is_obstacle_ == states_no_information_is_obstacle_ &&
+    std::abs(shift_x - cell_dx) < 1e-3 && std::abs(shift_y - cell_dy) < 1e-3;
+
+  if (!same_grid || std::abs(cell_dx) >= static_cast<int>(size_x) ||
+    std::abs(cell_dy) >= static_cast<int>(size_y))
+  {
+    cell_states_.assign(size_x * size_y, CELL_OUTSIDE);
+    states_min_x_ = states_min_y_ = states_max_x_ = states_max_y_ = 0;
+    states_size_x_ = size_x;
+    states_size_y_ = size_y;
+    states_resolution_ = resolution;
+    states_origin_x_ = master_grid.getOriginX();
+    states_origin_y_ = master_grid.getOriginY();
+    states_no_information_is_obstacle_ = no_information_is_obstacle_;
+    return same_grid;
+  }
+
+  if (cell_dx == 0 && cell_dy == 0) {
+    return true;
+  }
+
+  // Cell (x, y) of the grid was cell (x + cell_dx, y + cell_dy) of the states.
+  // Groups could have continued past the side the grid moved away from,
+  // so the cells on that side are not kept to relabel them
+  const int sx = static_cast<int>(size_x);
+  const int sy = static_cast<int>(size_y);
+  const int min_x = std::max(0, -cell_dx) + (cell_dx > 0 ? 1 : 0);
+  const int max_x = std::min(sx, sx - cell_dx) - (cell_dx < 0 ? 1 : 0);
+  const int min_y = std::max(0, -cell_dy) + (cell_dy > 0 ? 1 : 0);
+  const int max_y = std::min(sy, sy - cell_dy) - (cell_dy < 0 ? 1 : 0);
+
+  cell_states_spare_.assign(size_x * size_y, CELL_OUTSIDE);
+  for (int y = min_y; y < max_y && min_x < max_x; y++) {
+    const uint8_t * src = cell_states_.data() + (y + cell_dy) * sx + cell_dx;
+    std::copy(src + min_x, src + max_x, cell_states_spare_.data() + y * sx + min_x);
+  }
+  cell_states_.swap(cell_states_spare_);
+
+  states_min_x_ = std::max(states_min_x_ - cell_dx, 0);
+  states_min_y_ = std::max(states_min_y_ - cell_dy, 0);
+  states_max_x_ = std::min(states_max_x_ - cell_dx, sx);
+  states_max_y_ = std::min(states_max_y_ - cell_dy, sy);
+  states_origin_x_ += cell_dx * resolution;
+  states_origin_y_ += cell_dy * resolution;
+  return true;
+}
+
 bool DenoiseLayer::isBackground(uint8_t pixel) const
 {
   bool is_obstacle =
@@ -37,10 +37,17 @@
  *********************************************************************/
 #include "nav2_costmap_2d/inflation_layer.hpp"
 
+#include <cmath>
+#include <cstdlib>
 #include <limits>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
 #include <utility>
 
 #include "nav2_costmap_2d/costmap_math.hpp"
@@ -58,6 +65,82 @@ using rcl_interfaces::msg::ParameterType;
 namespace nav2_costmap_2d
 {
 
+namespace
+{
+
+struct InflationDistances
+{
+  // Euclidean distances of the cells, indexed by dx * r + dy
+  std::vector<double> distances;
+  // Ranks of the squared distances of the cells, indexed by [dx + r][dy + r]
+  std::vector<std::vector<int>> matrix;
+  int levels;
+};
+
+InflationDistances computeInflationDistances(int r)
+{
+  const int size = r * 2 + 1;
+
+  std::vector<double> distances(r * r);
+  for (int i = 0; i < r; ++i) {
+    for (int j = 0; j < r; ++j) {
+      distances[i * r + j] = hypot(i, j);
+    }
+  }
+
+  std::vector<std::pair<int, int>> points;
+
+  for (int y = -r; y <= r; y++) {
+    for (int x = -r; x <= r; x++) {
+      if (x * x + y * y <= r * r) {
+        points.emplace_back(x, y);
+      }
+    }
+  }
+
+  std::sort(
+    points.begin(), points.end(),
+    [](const std::pair<int, int> & a, const std::pair<int, int> & b) -> bool {
+      return a.first * a.first + a.second * a.second < b.first * b.first + b.second * b.second;
+    }
+  );
+
+  InflationDistances result{
+    std::move(distances), std::vector<std::vector<int>>(size, std::vector<int>(size, 0)), 0};
+  std::pair<int, int> last = {0, 0};
+  int level = 0;
+  for (auto const & p : points) {
+    if (p.first * p.first + p.second * p.second !=
+      last.first * last.first + last.second * last.second)
+    {
+      level++;
+    }
+    result.matrix[p.first + r][p.second + r] = level;
+    last = p;
+  }
+  result.levels = level;
+  return result;
+}
+
+// The distances only depend on the radius, so that the inflation layers of the costmaps of
+// a process with the same radius in cells, e.g. the local and global costmaps with the same
+// parameters, share them rather than each computing and sorting the cells of the radius
+std::shared_ptr<const InflationDistances> getInflationDistances(int r)
+{
+  static std::mutex mutex;
+  static std::map<int, std::weak_ptr<const InflationDistances>> cache;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto distances = cache[r].lock();
+  if (!distances) {
+    distances = std::make_shared<const InflationDistances>(computeInflationDistances(r));
+    cache[r] = distances;
+  }
+  return distances;
+}
+
+}  // namespace
+
 InflationLayer::InflationLayer()
 : inflation_radius_(0),
   inscribed_radius_(0),
@@ -71,7 +154,12 @@ InflationLayer::InflationLayer()
   last_min_x_(std::numeric_limits<double>::lowest()),
   last_min_y_(std::numeric_limits<double>::lowest()),
   last_max_x_(std::numeric_limits<double>::max()),
-  last_max_y_(std::numeric_limits<double>::max())
+  last_max_y_(std::numeric_limits<double>::max()),
+  incremental_inflation_enabled_(false),
+  incremental_full_update_(true),
+  incremental_origin_x_(0.0),
+  incremental_origin_y_(0.0),
+  inflation_threads_(1)
 {
   access_ = new mutex_t();
 }
@@ -90,6 +178,8 @@ InflationLayer::onInitialize()
   declareParameter("cost_scaling_factor", rclcpp::ParameterValue(10.0));
   declareParameter("inflate_unknown", rclcpp::ParameterValue(false));
   declareParameter("inflate_around_unknown", rclcpp::ParameterValue(false));
+  declareParameter("incremental_inflation", rclcpp::ParameterValue(false));
+  declareParameter("inflation_threads", rclcpp::ParameterValue(1));
 
   {
     auto node = node_.lock();
@@ -101,6 +191,11 @@ InflationLayer::onInitialize()
     node->get_parameter(name_ + "." + "cost_scaling_factor", cost_scaling_factor_);
     node->get_parameter(name_ + "." + "inflate_unknown", inflate_unknown_);
     node->get_parameter(name_ + "." + "inflate_around_unknown", inflate_around_unknown_);
+    node->get_parameter(
+      name_ + "." + "incremental_inflation", incremental_inflation_enabled_);
+    int inflation_threads = 1;
+    node->get_parameter(name_ + "." + "inflation_threads", inflation_threads);
+    inflation_threads_ = static_cast<unsigned int>(std::max(1, inflation_threads));
 
     dyn_params_handler_ = node->add_on_set_parameters_callback(
       std::bind(
@@ -110,8 +205,9 @@ InflationLayer::onInitialize()
 
   current_ = true;
   seen_.clear();
-  cached_distances_.clear();
+  cached_distances_.reset();
   cached_costs_.clear();
+  cached_cell_inflation_radius_ = 0;
   need_reinflation_ = false;
   cell_inflation_radius_ = cellDistance(inflation_radius_);
   matchSize();
@@ -126,6 +222,8 @@ InflationLayer::matchSize()
   cell_inflation_radius_ = cellDistance(inflation_radius_);
   computeCaches();
   seen_ = std::vector<bool>(costmap->getSizeInCellsX() * costmap->getSizeInCellsY(), false);
+  incremental_full_update_ = true;
+  updateCacheMemory();
 }
 
 void
@@ -145,6 +243,7 @@ InflationLayer::updateBounds(
     *max_x = std::numeric_limits<double>::max();
     *max_y = std::numeric_limits<double>::max();
     need_reinflation_ = false;
+    incremental_full_update_ = true;
   } else {
     double tmp_min_x = last_min_x_;
     double tmp_min_y = last_min_y_;
@@ -193,10 +292,18 @@ InflationLayer::updateCosts(
   int max_j)
 {
   std::lock_guard<Costmap2D::mutex_t> guard(*getMutex());
+  // Buffers grown by the previous update, such as the workspaces of the tiles
+  updateCacheMemory();
   if (!enabled_ || (cell_inflation_radius_ == 0)) {
     return;
   }
 
+  if (incremental_inflation_enabled_) {
+    updateCostsIncremental(master_grid, min_i, min_j, max_i, max_j);
+    current_ = true;
+    return;
+  }
+
   // make sure the inflation list is empty at the beginning of the cycle (should always be true)
   for (auto & dist : inflation_cells_) {
     RCLCPP_FATAL_EXPRESSION(
@@ -204,9 +311,17 @@ InflationLayer::updateCosts(
       !dist.empty(), "The inflation list must be empty at the beginning of inflation");
   }
 
-  unsigned char * master_array = master_grid.getCharMap();
   unsigned int size_x = master_grid.getSizeInCellsX(), size_y = master_grid.getSizeInCellsY();
 
+  // Large windows are split in stripes inflated concurrently
+  if (inflation_threads_ > 1 &&
+    max_j - min_j >= 4 * static_cast<int>(cell_inflation_radius_))
+  {
+    inflateTiled(master_grid, min_i, min_j, max_i, max_j);
+    current_ = true;
+    return;
+  }
+
   if (seen_.size() != size_x * size_y) {
     RCLCPP_WARN(
       logger_, "InflationLayer::updateCosts(): seen_ vector size is wrong");
@@ -241,20 +356,45 @@ InflationLayer::updateCosts(
   // Start with lethal obstacles: by definition distance is 0.0
   auto & obs_bin = inflation_cells_[0];
   obs_bin.reserve(200);
+  seedObstacles(master_grid, obs_bin, min_i, min_j, max_i, max_j);
+  propagateCosts(
+    master_grid, inflation_cells_, seen_, base_min_i, base_min_j, base_max_i, base_max_j,
+    0, size_y);
+
+  current_ = true;
+}
+
+void
+InflationLayer::seedObstacles(
+  const nav2_costmap_2d::Costmap2D & master_grid, std::vector<CellData> & obstacles,
+  int min_i, int min_j, int max_i, int max_j) const
+{
+  const unsigned char * master_array = master_grid.getCharMap();
   for (int j = min_j; j < max_j; j++) {
     for (int i = min_i; i < max_i; i++) {
       int index = static_cast<int>(master_grid.getIndex(i, j));
       unsigned char cost = master_array[index];
       if (cost == LETHAL_OBSTACLE || (inflate_around_unknown_ && cost == NO_INFORMATION)) {
-        obs_bin.emplace_back(i, j, i, j);
+        obstacles.emplace_back(i, j, i, j);
       }
     }
   }
+}
+
+void
+InflationLayer::propagateCosts(
+  nav2_costmap_2d::Costmap2D & master_grid,
+  std::vector<std::vector<CellData>> & inflation_cells, std::vector<bool> & seen,
+  int base_min_i, int base_min_j, int base_max_i, int base_max_j,
+  unsigned int min_row, unsigned int max_row)
+{
+  unsigned char * master_array = master_grid.getCharMap();
+  unsigned int size_x = master_grid.getSizeInCellsX();
 
   // Process cells by increasing distance; new cells are appended to the
   // corresponding distance bin, so they
   // can overtake previously inserted but farther away cells
-  for (auto & dist_bin : inflation_cells_) {
+  for (auto & dist_bin : inflation_cells) {
     dist_bin.reserve(200);
     for (std::size_t i = 0; i < dist_bin.size(); ++i) {
       // Do not use iterator or for-range based loops to
@@ -268,11 +408,11 @@ InflationLayer::updateCosts(
       unsigned int index = master_grid.getIndex(mx, my);
 
       // ignore if already visited
-      if (seen_[index]) {
+      if (seen[index]) {
         continue;
       }
 
-      seen_[index] = true;
+      seen[index] = true;
 
       // assign the cost associated with the distance from an obstacle to the cell
       unsigned char cost = costLookup(mx, my, sx, sy);
@@ -296,29 +436,185 @@ InflationLayer::updateCosts(
 
       // attempt to put the neighbors of the current cell onto the inflation list
       if (mx > 0) {
-        enqueue(index - 1, mx - 1, my, sx, sy);
+        enqueue(inflation_cells, seen, index - 1, mx - 1, my, sx, sy);
       }
-      if (my > 0) {
-        enqueue(index - size_x, mx, my - 1, sx, sy);
+      if (my > min_row) {
+        enqueue(inflation_cells, seen, index - size_x, mx, my - 1, sx, sy);
       }
       if (mx < size_x - 1) {
-        enqueue(index + 1, mx + 1, my, sx, sy);
+        enqueue(inflation_cells, seen, index + 1, mx + 1, my, sx, sy);
       }
-      if (my < size_y - 1) {
-        enqueue(index + size_x, mx, my + 1, sx, sy);
+      if (my < max_row - 1) {
+        enqueue(inflation_cells, seen, index + size_x, mx, my + 1, sx, sy);
       }
     }
-    // This level of inflation_cells_ is not needed anymore. We can free the memory
+    // This level of inflation_cells is not needed anymore. We can free the memory
     // Note that dist_bin.clear() is not enough, because it won't free the memory
     dist_bin = std::vector<CellData>();
   }
+}
 
-  current_ = true;
+void
+InflationLayer::inflateTiled(
+  nav2_costmap_2d::Costmap2D & master_grid, int base_min_i, int base_min_j,
+  int base_max_i, int base_max_j)
+{
+  const int size_x = static_cast<int>(master_grid.getSizeInCellsX());
+  const int size_y = static_cast<int>(master_grid.getSizeInCellsY());
+  const int radius = static_cast<int>(cell_inflation_radius_);
+
+  // Split the window into stripes of rows. The costs of a stripe only depend on the
+  // obstacles within the inflation radius of it, so each stripe is inflated on its own
+  // from the obstacles of the stripe and a halo of the inflation radius around it.
+  const int rows = base_max_j - base_min_j;
+  const int num_tiles = std::min(
+    static_cast<int>(inflation_threads_) * 4, std::max(1, rows / (2 * radius)));
+  const int tile_rows = (rows + num_tiles - 1) / num_tiles;
+
+  std::vector<std::pair<int, int>> tiles;
+  for (int j = base_min_j; j < base_max_j; j += tile_rows) {
+    tiles.emplace_back(j, std::min(j + tile_rows, base_max_j));
+  }
+
+  const int min_i = std::max(0, base_min_i - radius);
+  const int max_i = std::min(size_x, base_max_i + radius);
+  const unsigned int num_threads =
+    std::min(static_cast<unsigned int>(tiles.size()), inflation_threads_);
+  if (tile_workspaces_.size() < num_threads) {
+    tile_workspaces_.resize(num_threads);
+  }
+  tile_obstacles_.resize(tiles.size());
+
+  auto run_tiles = [&](const std::function<void(size_t, TileWorkspace &)> & task) {
+      std::atomic<size_t> next_tile{0};
+      auto worker = [&](unsigned int thread) {
+          for (size_t t = next_tile++; t < tiles.size(); t = next_tile++) {
+            task(t, tile_workspaces_[thread]);
+          }
+        };
+      std::vector<std::thread> threads;
+      for (unsigned int thread = 1; thread < num_threads; thread++) {
+        threads.emplace_back(worker, thread);
+      }
+      worker(0);
+      for (auto & thread : threads) {
+        thread.join();
+      }
+    };
+
+  // Find all obstacles before any stripe applies its costs to the master grid
+  run_tiles(
+    [&](size_t t, TileWorkspace &) {
+      tile_obstacles_[t].clear();
+      seedObstacles(
+        master_grid, tile_obstacles_[t], min_i, std::max(0, tiles[t].first - radius),
+        max_i, std::min(size_y, tiles[t].second + radius));
+    });
+
+  run_tiles(
+    [&](size_t t, TileWorkspace & workspace) {
+      if (workspace.seen.size() != static_cast<size_t>(size_x * size_y)) {
+        workspace.seen.assign(size_x * size_y, false);
+      }
+      workspace.inflation_cells.resize(inflation_cells_.size());
+      workspace.inflation_cells[0].swap(tile_obstacles_[t]);
+
+      const int min_row = std::max(0, tiles[t].first - radius);
+      const int max_row = std::min(size_y, tiles[t].second + radius);
+      propagateCosts(
+        master_grid, workspace.inflation_cells, workspace.seen,
+        base_min_i, tiles[t].first, base_max_i, tiles[t].second, min_row, max_row);
+      std::fill(
+        workspace.seen.begin() + min_row * size_x, workspace.seen.begin() + max_row * size_x,
+        false);
+    });
+}
+
+void
+InflationLayer::updateCostsIncremental(
+  nav2_costmap_2d::Costmap2D & master_grid, int min_i, int min_j,
+  int max_i,
+  int max_j)
+{
+  unsigned char * master_array = master_grid.getCharMap();
+  const unsigned int size_x = master_grid.getSizeInCellsX();
+  const unsigned int size_y = master_grid.getSizeInCellsY();
+
+  // Cells outside of the window keep their costs from the last update, so only the
+  // cells inside of it can have changed obstacle status. When the master grid rolled
+  // with the robot, shift the sources along and compare all cells instead.
+  bool compare_all = false;
+  if (!incremental_inflation_.matches(size_x, size_y, cell_inflation_radius_)) {
+    incremental_inflation_.reset(size_x, size_y, cell_inflation_radius_);
+    compare_all = true;
+  } else if (master_grid.getOriginX() != incremental_origin_x_ ||  // NOLINT
+    master_grid.getOriginY() != incremental_origin_y_)
+  {
+    const double shift_x = (master_grid.getOriginX() - incremental_origin_x_) / resolution_;
+    const double shift_y = (master_grid.getOriginY() - incremental_origin_y_) / resolution_;
+    const int cell_ox = static_cast<int>(std::round(shift_x));
+    const int cell_oy = static_cast<int>(std::round(shift_y));
+    if (std::fabs(shift_x - cell_ox) > 1e-3 || std::fabs(shift_y - cell_oy) > 1e-3 ||
+      std::abs(cell_ox) >= static_cast<int>(size_x) ||
+      std::abs(cell_oy) >= static_cast<int>(size_y))
+    {
+      incremental_inflation_.reset(size_x, size_y, cell_inflation_radius_);
+    } else {
+      incremental_inflation_.shift(cell_ox, cell_oy);
+    }
+    compare_all = true;
+  }
+  compare_all |= incremental_full_update_;
+  incremental_full_update_ = false;
+  incremental_origin_x_ = master_grid.getOriginX();
+  incremental_origin_y_ = master_grid.getOriginY();
+
+  min_i = std::max(0, min_i);
+  min_j = std::max(0, min_j);
+  max_i = std::min(static_cast<int>(size_x), max_i);
+  max_j = std::min(static_cast<int>(size_y), max_j);
+
+  const int compare_min_i = compare_all ? 0 : min_i;
+  const int compare_min_j = compare_all ? 0 : min_j;
+  const int compare_max_i = compare_all ? static_cast<int>(size_x) : max_i;
+  const int compare_max_j = compare_all ? static_cast<int>(size_y) : max_j;
+  for (int j = compare_min_j; j < compare_max_j; j++) {
+    for (int i = compare_min_i; i < compare_max_i; i++) {
+      const unsigned int index = master_grid.getIndex(i, j);
+      const unsigned char cost = master_array[index];
+      incremental_inflation_.setObstacle(
+        index, cost == LETHAL_OBSTACLE || (inflate_around_unknown_ && cost == NO_INFORMATION));
+    }
+  }
+
+  incremental_inflation_.propagate();
+
+  // As with the brushfire, costs are only applied inside of the given bounds
+  for (int j = min_j; j < max_j; j++) {
+    for (int i = min_i; i < max_i; i++) {
+      const unsigned int index = master_grid.getIndex(i, j);
+      const int source = incremental_inflation_.getSource(index);
+      if (source == IncrementalInflation::NO_SOURCE) {
+        continue;
+      }
+
+      const unsigned char cost = costLookup(i, j, source % size_x, source / size_x);
+      const unsigned char old_cost = master_array[index];
+      if (old_cost == NO_INFORMATION &&
+        (inflate_unknown_ ? (cost > FREE_SPACE) : (cost >= INSCRIBED_INFLATED_OBSTACLE)))
+      {
+        master_array[index] = cost;
+      } else {
+        master_array[index] = std::max(old_cost, cost);
+      }
+    }
+  }
 }
 
 /**
  * @brief  Given an index of a cell in the costmap, place it into a list pending for obstacle inflation
- * @param  grid The costmap
+ * @param  inflation_cells The lists of cells pending for inflation by distance
+ * @param  seen Which cells were already visited
  * @param  index The index of the cell
  * @param  mx The x coordinate of the cell (can be computed from the index, but saves time to store it)
  * @param  my The y coordinate of the cell (can be computed from the index, but saves time to store it)
@@ -327,10 +623,11 @@ InflationLayer::updateCosts(
  */
 void
 InflationLayer::enqueue(
+  std::vector<std::vector<CellData>> & inflation_cells, const std::vector<bool> & seen,
   unsigned int index, unsigned int mx, unsigned int my,
   unsigned int src_x, unsigned int src_y)
 {
-  if (!seen_[index]) {
+  if (!seen[index]) {
     // we compute our distance table one cell further than the
     // inflation radius dictates so we can make the check below
     double distance = distanceLookup(mx, my, src_x, src_y);
@@ -344,8 +641,8 @@ InflationLayer::enqueue(
     const unsigned int r = cell_inflation_radius_ + 2;
 
     // push the cell data onto the inflation list and mark
-    const auto dist = distance_matrix_[mx - src_x + r][my - src_y + r];
-    inflation_cells_[dist].emplace_back(mx, my, src_x, src_y);
+    const auto dist = (*distance_matrix_)[mx - src_x + r][my - src_y + r];
+    inflation_cells[dist].emplace_back(mx, my, src_x, src_y);
   }
 }
 
@@ -362,20 +659,18 @@ InflationLayer::computeCaches()
   // based on the inflation radius... compute distance and cost caches
   if (cell_inflation_radius_ != cached_cell_inflation_radius_) {
     cached_costs_.resize(cache_length_ * cache_length_);
-    cached_distances_.resize(cache_length_ * cache_length_);
-
-    for (unsigned int i = 0; i < cache_length_; ++i) {
-      for (unsigned int j = 0; j < cache_length_; ++j) {
-        cached_distances_[i * cache_length_ + j] = hypot(i, j);
-      }
-    }
+    auto distances = getInflationDistances(cache_length_);
+    cached_distances_ = std::shared_ptr<const std::vector<double>>(
+      distances, &distances->distances);
 
     cached_cell_inflation_radius_ = cell_inflation_radius_;
   }
 
+  // The costs also depend on the footprint and cost scaling factor, and are cheap to compute
   for (unsigned int i = 0; i < cache_length_; ++i) {
     for (unsigned int j = 0; j < cache_length_; ++j) {
-      cached_costs_[i * cache_length_ + j] = computeCost(cached_distances_[i * cache_length_ + j]);
+      cached_costs_[i * cache_length_ + j] =
+        computeCost((*cached_distances_)[i * cache_length_ + j]);
     }
   }
 
@@ -384,44 +679,31 @@ InflationLayer::computeCaches()
   inflation_cells_.resize(max_dist + 1);
 }
 
-int
-InflationLayer::generateIntegerDistances()
+void
+InflationLayer::updateCacheMemory()
 {
-  const int r = cell_inflation_radius_ + 2;
-  const int size = r * 2 + 1;
-
-  std::vector<std::pair<int, int>> points;
-
-  for (int y = -r; y <= r; y++) {
-    for (int x = -r; x <= r; x++) {
-      if (x * x + y * y <= r * r) {
-        points.emplace_back(x, y);
-      }
+  // The distances are shared with other layers, and small next to the grid sized buffers
+  size_t bytes = seen_.capacity() / 8 + cached_costs_.capacity() +
+    incremental_inflation_.getMemoryUsage();
+  for (const auto & workspace : tile_workspaces_) {
+    bytes += workspace.seen.capacity() / 8;
+    for (const auto & cells : workspace.inflation_cells) {
+      bytes += cells.capacity() * sizeof(CellData);
     }
   }
-
-  std::sort(
-    points.begin(), points.end(),
-    [](const std::pair<int, int> & a, const std::pair<int, int> & b) -> bool {
-      return a.first * a.first + a.second * a.second < b.first * b.first + b.second * b.second;
-    }
-  );
-
-  std::vector<std::vector<int>> distance_matrix(size, std::vector<int>(size, 0));
-  std::pair<int, int> last = {0, 0};
-  int level = 0;
-  for (auto const & p : points) {
-    if (p.first * p.first + p.second * p.second !=
-      last.first * last.first + last.second * last.second)
-    {
-      level++;
-    }
-    distance_matrix[p.first + r][p.second + r] = level;
-    last = p;
+  for (const auto & cells : inflation_cells_) {
+    bytes += cells.capacity() * sizeof(CellData);
   }
+  cache_memory_.update(bytes);
+}
 
-  distance_matrix_ = distance_matrix;
-  return level;
+int
+InflationLayer::generateIntegerDistances()
+{
+  auto distances = getInflationDistances(cell_inflation_radius_ + 2);
+  distance_matrix_ = std::shared_ptr<const std::vector<std::vector<int>>>(
+    distances, &distances->matrix);
+  return distances->levels;
 }
 
 /**
@@ -470,6 +752,11 @@ InflationLayer::dynamicParametersCallback(
       {
         inflate_around_unknown_ = parameter.as_bool();
         need_reinflation_ = true;
+      } else if (param_name == name_ + "." + "incremental_inflation" && // NOLINT
+        incremental_inflation_enabled_ != parameter.as_bool())
+      {
+        incremental_inflation_enabled_ = parameter.as_bool();
+        need_reinflation_ = true;
       }
     }
   }
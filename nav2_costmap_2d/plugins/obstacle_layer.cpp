@@ -39,7 +39,9 @@
 #include "nav2_costmap_2d/obstacle_layer.hpp"
 
 #include <algorithm>
+#include <functional>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -57,6 +59,30 @@ using nav2_costmap_2d::ObservationBuffer;
 using nav2_costmap_2d::Observation;
 using rcl_interfaces::msg::ParameterType;
 
+namespace
+{
+
+// Lets only the layer processing a sensor shared with other layers handle its messages,
+// handing the resulting observations over to the buffers of the other layers
+template<typename MessageT>
+std::function<void(std::shared_ptr<const MessageT>)> processOnce(
+  std::function<void(std::shared_ptr<const MessageT>)> callback,
+  const std::shared_ptr<nav2_costmap_2d::SharedObservationSource> & source,
+  const std::shared_ptr<ObservationBuffer> & buffer, const void * layer)
+{
+  if (!source) {
+    return callback;
+  }
+  return [callback, source, buffer, layer](std::shared_ptr<const MessageT> message) {
+           if (source->isProcessor(layer)) {
+             callback(message);
+             source->forward(buffer);
+           }
+         };
+}
+
+}  // namespace
+
 namespace nav2_costmap_2d
 {
 
@@ -66,6 +92,9 @@ ObstacleLayer::~ObstacleLayer()
   for (auto & notifier : observation_notifiers_) {
     notifier.reset();
   }
+  for (auto & source : shared_sources_) {
+    source->release(this);
+  }
 }
 
 void ObstacleLayer::onInitialize()
@@ -82,6 +111,8 @@ void ObstacleLayer::onInitialize()
   declareParameter("max_obstacle_height", rclcpp::ParameterValue(2.0));
   declareParameter("combination_method", rclcpp::ParameterValue(1));
   declareParameter("observation_sources", rclcpp::ParameterValue(std::string("")));
+  declareParameter("share_observations", rclcpp::ParameterValue(false));
+  declareParameter("packed_storage", rclcpp::ParameterValue(false));
 
   auto node = node_.lock();
   if (!node) {
@@ -95,6 +126,15 @@ void ObstacleLayer::onInitialize()
   node->get_parameter("track_unknown_space", track_unknown_space);
   node->get_parameter("transform_tolerance", transform_tolerance);
   node->get_parameter(name_ + "." + "observation_sources", topics_string);
+  bool share_observations = false;
+  node->get_parameter(name_ + "." + "share_observations", share_observations);
+  node->get_parameter(name_ + "." + "packed_storage", packed_storage_);
+  if (packed_storage_ && !canPackStorage()) {
+    RCLCPP_WARN(
+      logger_, "Layer %s holds costs which can't be packed, ignoring packed_storage",
+      name_.c_str());
+    packed_storage_ = false;
+  }
 
   int combination_method_param{};
   node->get_parameter(name_ + "." + "combination_method", combination_method_param);
@@ -204,6 +244,19 @@ void ObstacleLayer::onInitialize()
           global_frame_,
           sensor_frame, tf2::durationFromSec(transform_tolerance))));
 
+    // layers of other costmaps making the same observations from the sensor share them
+    std::shared_ptr<SharedObservationSource> shared_source;
+    if (share_observations) {
+      std::stringstream key;
+      key << topic << " " << data_type << " " << global_frame_ << " " << sensor_frame << " " <<
+        inf_is_valid << " " << min_obstacle_height << " " << max_obstacle_height << " " <<
+        obstacle_max_range << " " << obstacle_min_range << " " << raytrace_max_range << " " <<
+        raytrace_min_range;
+      shared_source = SharedObservationSource::acquire(key.str());
+      shared_source->addBuffer(observation_buffers_.back());
+      shared_sources_.push_back(shared_source);
+    }
+
     // check if we'll add this buffer to our marking observation buffers
     if (marking) {
       marking_buffers_.push_back(observation_buffers_.back());
@@ -236,18 +289,19 @@ void ObstacleLayer::onInitialize()
         node->get_node_clock_interface(),
         tf2::durationFromSec(transform_tolerance));
 
+      std::function<void(sensor_msgs::msg::LaserScan::ConstSharedPtr)> callback;
       if (inf_is_valid) {
-        filter->registerCallback(
-          std::bind(
-            &ObstacleLayer::laserScanValidInfCallback, this, std::placeholders::_1,
-            observation_buffers_.back()));
+        callback = std::bind(
+          &ObstacleLayer::laserScanValidInfCallback, this, std::placeholders::_1,
+          observation_buffers_.back());
 
       } else {
-        filter->registerCallback(
-          std::bind(
-            &ObstacleLayer::laserScanCallback, this, std::placeholders::_1,
-            observation_buffers_.back()));
+        callback = std::bind(
+          &ObstacleLayer::laserScanCallback, this, std::placeholders::_1,
+          observation_buffers_.back());
       }
+      filter->registerCallback(
+        processOnce(callback, shared_source, observation_buffers_.back(), this));
 
       observation_subscribers_.push_back(sub);
 
@@ -271,10 +325,11 @@ void ObstacleLayer::onInitialize()
         node->get_node_clock_interface(),
         tf2::durationFromSec(transform_tolerance));
 
+      std::function<void(sensor_msgs::msg::PointCloud2::ConstSharedPtr)> callback = std::bind(
+        &ObstacleLayer::pointCloud2Callback, this, std::placeholders::_1,
+        observation_buffers_.back());
       filter->registerCallback(
-        std::bind(
-          &ObstacleLayer::pointCloud2Callback, this, std::placeholders::_1,
-          observation_buffers_.back()));
+        processOnce(callback, shared_source, observation_buffers_.back(), this));
 
       observation_subscribers_.push_back(sub);
       observation_notifiers_.push_back(filter);
@@ -457,6 +512,9 @@ ObstacleLayer::updateBounds(
     sensor_msgs::PointCloud2ConstIterator<float> iter_y(cloud, "y");
     sensor_msgs::PointCloud2ConstIterator<float> iter_z(cloud, "z");
 
+    // Gather the points to mark first, to convert them to map coordinates in one batch
+    mark_x_.clear();
+    mark_y_.clear();
     for (; iter_x != iter_x.end(); ++iter_x, ++iter_y, ++iter_z) {
       double px = *iter_x, py = *iter_y, pz = *iter_z;
 
@@ -490,16 +548,27 @@ ObstacleLayer::updateBounds(
         continue;
       }
 
-      // now we need to compute the map coordinates for the observation
-      unsigned int mx, my;
-      if (!worldToMap(px, py, mx, my)) {
+      mark_x_.push_back(*iter_x);
+      mark_y_.push_back(*iter_y);
+    }
+
+    // now we need to compute the map coordinates for the observation
+    const size_t num_points = mark_x_.size();
+    mark_mx_.resize(num_points);
+    mark_my_.resize(num_points);
+    mark_valid_.resize(num_points);
+    worldToMap(
+      mark_x_.data(), mark_y_.data(), num_points,
+      mark_mx_.data(), mark_my_.data(), mark_valid_.data());
+
+    for (size_t i = 0; i < num_points; ++i) {
+      if (!mark_valid_[i]) {
         RCLCPP_DEBUG(logger_, "Computing map coords failed");
         continue;
       }
 
-      unsigned int index = getIndex(mx, my);
-      costmap_[index] = LETHAL_OBSTACLE;
-      touch(px, py, min_x, min_y, max_x, max_y);
+      markCell(getIndex(mark_mx_[i], mark_my_[i]));
+      touch(mark_x_[i], mark_y_[i], min_x, min_y, max_x, max_y);
     }
   }
 
@@ -539,24 +608,132 @@ ObstacleLayer::updateCosts(
   }
 
   if (footprint_clearing_enabled_) {
-    setConvexPolygonCost(transformed_footprint_, nav2_costmap_2d::FREE_SPACE);
+    setPolygonCost(transformed_footprint_, nav2_costmap_2d::FREE_SPACE);
   }
 
+  // Packed costs are expanded straight into the master grid
   switch (combination_method_) {
     case CombinationMethod::Overwrite:
-      updateWithOverwrite(master_grid, min_i, min_j, max_i, max_j);
+      if (packed_storage_) {
+        packed_costmap_.updateWithOverwrite(master_grid, min_i, min_j, max_i, max_j);
+      } else {
+        updateWithOverwrite(master_grid, min_i, min_j, max_i, max_j);
+      }
       break;
     case CombinationMethod::Max:
-      updateWithMax(master_grid, min_i, min_j, max_i, max_j);
+      if (packed_storage_) {
+        packed_costmap_.updateWithMax(master_grid, min_i, min_j, max_i, max_j);
+      } else {
+        updateWithMax(master_grid, min_i, min_j, max_i, max_j);
+      }
       break;
     case CombinationMethod::MaxWithoutUnknownOverwrite:
-      updateWithMaxWithoutUnknownOverwrite(master_grid, min_i, min_j, max_i, max_j);
+      if (packed_storage_) {
+        packed_costmap_.updateWithMaxWithoutUnknownOverwrite(
+          master_grid, min_i, min_j, max_i, max_j);
+      } else {
+        updateWithMaxWithoutUnknownOverwrite(master_grid, min_i, min_j, max_i, max_j);
+      }
       break;
     default:  // Nothing
       break;
   }
 }
 
+void
+ObstacleLayer::setPolygonCost(
+  const std::vector<geometry_msgs::msg::Point> & polygon, unsigned char cost_value)
+{
+  if (!packed_storage_) {
+    setConvexPolygonCost(polygon, cost_value);
+    return;
+  }
+
+  std::vector<MapLocation> map_polygon;
+  for (const auto & point : polygon) {
+    MapLocation loc;
+    if (!worldToMap(point.x, point.y, loc.x, loc.y)) {
+      // The polygon lies outside of the map bounds, so it can't be filled
+      return;
+    }
+    map_polygon.push_back(loc);
+  }
+
+  std::vector<MapLocation> polygon_cells;
+  convexFillCells(map_polygon, polygon_cells);
+  for (const auto & cell : polygon_cells) {
+    packed_costmap_.setCost(getIndex(cell.x, cell.y), cost_value);
+  }
+}
+
+void
+ObstacleLayer::initMaps(unsigned int size_x, unsigned int size_y)
+{
+  if (!packed_storage_) {
+    CostmapLayer::initMaps(size_x, size_y);
+    return;
+  }
+
+  // Only the packed costs are allocated, the costmap keeps no byte per cell
+  deleteMaps();
+  std::lock_guard<Costmap2D::mutex_t> guard(*getMutex());
+  size_x_ = size_x;
+  size_y_ = size_y;
+  packed_costmap_.resize(size_x, size_y, default_value_);
+}
+
+void
+ObstacleLayer::resetMaps()
+{
+  if (!packed_storage_) {
+    CostmapLayer::resetMaps();
+    return;
+  }
+
+  std::lock_guard<Costmap2D::mutex_t> guard(*getMutex());
+  packed_costmap_.reset(default_value_);
+}
+
+void
+ObstacleLayer::updateOrigin(double new_origin_x, double new_origin_y)
+{
+  if (!packed_storage_) {
+    CostmapLayer::updateOrigin(new_origin_x, new_origin_y);
+    return;
+  }
+
+  // Keep the origin aligned on the grid, as Costmap2D::updateOrigin
+  const int cell_ox = static_cast<int>((new_origin_x - origin_x_) / resolution_);
+  const int cell_oy = static_cast<int>((new_origin_y - origin_y_) / resolution_);
+  {
+    std::lock_guard<Costmap2D::mutex_t> guard(*getMutex());
+    packed_costmap_.shift(cell_ox, cell_oy, default_value_);
+  }
+  origin_x_ += cell_ox * resolution_;
+  origin_y_ += cell_oy * resolution_;
+}
+
+void
+ObstacleLayer::clearArea(int start_x, int start_y, int end_x, int end_y, bool invert)
+{
+  if (!packed_storage_) {
+    CostmapLayer::clearArea(start_x, start_y, end_x, end_y, invert);
+    return;
+  }
+
+  current_ = false;
+  for (int x = 0; x < static_cast<int>(getSizeInCellsX()); x++) {
+    bool xrange = x > start_x && x < end_x;
+
+    for (int y = 0; y < static_cast<int>(getSizeInCellsY()); y++) {
+      if ((xrange && y > start_y && y < end_y) == invert) {
+        continue;
+      }
+      packed_costmap_.setCost(getIndex(x, y), NO_INFORMATION);
+    }
+  }
+}
+
 void
 ObstacleLayer::addStaticObservation(
   nav2_costmap_2d::Observation & obs,
@@ -647,6 +824,25 @@ ObstacleLayer::raytraceFreespace(
 
   touch(ox, oy, min_x, min_y, max_x, max_y);
 
+  unsigned int cell_raytrace_max_range = cellDistance(clearing_observation.raytrace_max_range_);
+  unsigned int cell_raytrace_min_range = cellDistance(clearing_observation.raytrace_min_range_);
+  MarkCell marker(costmap_, FREE_SPACE);
+  PackedCostmap::MarkCell packed_marker(packed_costmap_, FREE_SPACE);
+
+  // The cells cleared by a ray only depend on its endpoint cell, so dense clouds trace each
+  // endpoint cell once per observation. Stamps avoid clearing the buffer between observations.
+  // Packed layers trace every ray, the stamps taking 16 times their memory.
+  if (!packed_storage_) {
+    if (raytrace_endpoint_stamps_.size() != size_x_ * size_y_) {
+      raytrace_endpoint_stamps_.assign(size_x_ * size_y_, 0);
+      raytrace_stamp_ = 0;
+    }
+    if (++raytrace_stamp_ == 0) {
+      std::fill(raytrace_endpoint_stamps_.begin(), raytrace_endpoint_stamps_.end(), 0);
+      raytrace_stamp_ = 1;
+    }
+  }
+
   // for each point in the cloud, we want to trace a line from the origin
   // and clear obstacles along it
   sensor_msgs::PointCloud2ConstIterator<float> iter_x(cloud, "x");
@@ -693,16 +889,25 @@ ObstacleLayer::raytraceFreespace(
       continue;
     }
 
-    unsigned int cell_raytrace_max_range = cellDistance(clearing_observation.raytrace_max_range_);
-    unsigned int cell_raytrace_min_range = cellDistance(clearing_observation.raytrace_min_range_);
-    MarkCell marker(costmap_, FREE_SPACE);
-    // and finally... we can execute our trace to clear obstacles along that line
-    raytraceLine(marker, x0, y0, x1, y1, cell_raytrace_max_range, cell_raytrace_min_range);
-
     updateRaytraceBounds(
       ox, oy, wx, wy, clearing_observation.raytrace_max_range_,
       clearing_observation.raytrace_min_range_, min_x, min_y, max_x,
       max_y);
+
+    if (packed_storage_) {
+      raytraceLine(
+        packed_marker, x0, y0, x1, y1, cell_raytrace_max_range, cell_raytrace_min_range);
+      continue;
+    }
+
+    unsigned int & endpoint_stamp = raytrace_endpoint_stamps_[getIndex(x1, y1)];
+    if (endpoint_stamp == raytrace_stamp_) {
+      continue;
+    }
+    endpoint_stamp = raytrace_stamp_;
+
+    // and finally... we can execute our trace to clear obstacles along that line
+    raytraceLine(marker, x0, y0, x1, y1, cell_raytrace_max_range, cell_raytrace_min_range);
   }
 }
 
@@ -730,6 +935,9 @@ ObstacleLayer::deactivate()
       observation_subscribers_[i]->unsubscribe();
     }
   }
+  for (auto & source : shared_sources_) {
+    source->release(this);
+  }
 }
 
 void
@@ -362,13 +362,20 @@ void RangeSensorLayer::updateCostmap(
   // Limit Bounds to Grid
   bx0 = std::max(0, bx0);
   by0 = std::max(0, by0);
-  bx1 = std::min(static_cast<int>(size_x_), bx1);
-  by1 = std::min(static_cast<int>(size_y_), by1);
-
-  for (unsigned int x = bx0; x <= (unsigned int)bx1; x++) {
-    for (unsigned int y = by0; y <= (unsigned int)by1; y++) {
-      bool update_xy_cell = true;
-
+  bx1 = std::min(static_cast<int>(size_x_) - 1, bx1);
+  by1 = std::min(static_cast<int>(size_y_) - 1, by1);
+
+  // Collect the cells of the cone whose cost the reading changes. Beyond r + delta * r
+  // or outside of the field of view the sensor model is 0.5, which keeps the prior
+  const double r = range_message.range;
+  const double max_phi = r + resolution_ * r;
+  cone_cells_.clear();
+  cone_phi_.clear();
+  cone_theta_.clear();
+
+  for (int y = by0; y <= by1; y++) {
+    const double wy = origin_y_ + (y + 0.5) * resolution_;
+    for (int x = bx0; x <= bx1; x++) {
       // Unless inflate_cone_ is set to 100 %, we update cells only within the
       // (partially inflated) sensor cone, projected on the costmap as a triangle.
       // 0 % corresponds to just the triangle, but if your sensor fov is very
@@ -383,48 +390,58 @@ void RangeSensorLayer::updateCostmap(
         // Barycentric coordinates inside area threshold; this is not mathematically
         // sound at all, but it works!
         float bcciath = -static_cast<float>(inflate_cone_) * area(Ax, Ay, Bx, By, Ox, Oy);
-        update_xy_cell = w0 >= bcciath && w1 >= bcciath && w2 >= bcciath;
+        if (w0 < bcciath || w1 < bcciath || w2 < bcciath) {
+          continue;
+        }
       }
 
-      if (update_xy_cell) {
-        double wx, wy;
-        mapToWorld(x, y, wx, wy);
-        update_cell(ox, oy, theta, range_message.range, wx, wy, clear_sensor_cone);
+      // Clearing sets the whole cone free, whatever the geometry
+      if (clear_sensor_cone) {
+        cone_cells_.push_back(getIndex(x, y));
+        continue;
+      }
+
+      const double wx = origin_x_ + (x + 0.5) * resolution_;
+      const double cdx = wx - ox, cdy = wy - oy;
+      const double phi = sqrt(cdx * cdx + cdy * cdy);
+      if (phi >= max_phi) {
+        continue;
+      }
+      const double cell_theta = angles::normalize_angle(atan2(cdy, cdx) - theta);
+      if (fabs(cell_theta) > max_angle_) {
+        continue;
       }
+
+      cone_cells_.push_back(getIndex(x, y));
+      cone_phi_.push_back(phi);
+      cone_theta_.push_back(cell_theta);
     }
   }
 
+  update_cone(r, clear_sensor_cone);
+
   buffered_readings_++;
   last_reading_time_ = clock_->now();
 }
 
-void RangeSensorLayer::update_cell(
-  double ox, double oy, double ot, double r,
-  double nx, double ny, bool clear)
+void RangeSensorLayer::update_cone(double r, bool clear)
 {
-  unsigned int x, y;
-  if (worldToMap(nx, ny, x, y)) {
-    double dx = nx - ox, dy = ny - oy;
-    double theta = atan2(dy, dx) - ot;
-    theta = angles::normalize_angle(theta);
-    double phi = sqrt(dx * dx + dy * dy);
-    double sensor = 0.0;
-    if (!clear) {
-      sensor = sensor_model(r, phi, theta);
+  const size_t n = cone_cells_.size();
+  cone_sensor_.resize(n);
+  if (clear) {
+    std::fill(cone_sensor_.begin(), cone_sensor_.end(), 0.0);
+  } else {
+    for (size_t i = 0; i < n; i++) {
+      cone_sensor_[i] = sensor_model(r, cone_phi_[i], cone_theta_[i]);
     }
-    double prior = to_prob(getCost(x, y));
-    double prob_occ = sensor * prior;
-    double prob_not = (1 - sensor) * (1 - prior);
-    double new_prob = prob_occ / (prob_occ + prob_not);
+  }
 
-    RCLCPP_DEBUG(
-      logger_,
-      "%f %f | %f %f = %f", dx, dy, theta, phi, sensor);
-    RCLCPP_DEBUG(
-      logger_,
-      "%f | %f %f | %f", prior, prob_occ, prob_not, new_prob);
-    unsigned char c = to_cost(new_prob);
-    setCost(x, y, c);
+  for (size_t i = 0; i < n; i++) {
+    const double sensor = cone_sensor_[i];
+    const double prior = to_prob(costmap_[cone_cells_[i]]);
+    const double prob_occ = sensor * prior;
+    const double prob_not = (1 - sensor) * (1 - prior);
+    costmap_[cone_cells_[i]] = to_cost(prob_occ / (prob_occ + prob_not));
   }
 }
 
@@ -40,7 +40,11 @@
 #include "nav2_costmap_2d/static_layer.hpp"
 
 #include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
 #include <string>
+#include <vector>
 
 #include "pluginlib/class_list_macros.hpp"
 #include "tf2/convert.h"
@@ -73,6 +77,26 @@ StaticLayer::onInitialize()
 
   getParameters();
 
+  auto node = node_.lock();
+  if (!node) {
+    throw std::runtime_error{"Failed to lock node"};
+  }
+
+  if (!map_region_service_.empty() && !layered_costmap_->isRolling()) {
+    RCLCPP_WARN(
+      logger_,
+      "Map regions can only be requested by rolling costmaps, subscribing to the map instead");
+    map_region_service_.clear();
+  }
+  if (!map_region_service_.empty()) {
+    // The map server serves huge maps by regions, loaded around the robot as it moves
+    RCLCPP_INFO(
+      logger_, "Requesting the regions of the map around the robot from %s",
+      map_region_service_.c_str());
+    map_region_client_ = node->create_client<nav2_msgs::srv::GetMapRegion>(map_region_service_);
+    return;
+  }
+
   rclcpp::QoS map_qos(10);  // initialize to default
   if (map_subscribe_transient_local_) {
     map_qos.transient_local();
@@ -86,11 +110,6 @@ StaticLayer::onInitialize()
     map_topic_.c_str(),
     map_subscribe_transient_local_ ? "transient local" : "volatile");
 
-  auto node = node_.lock();
-  if (!node) {
-    throw std::runtime_error{"Failed to lock node"};
-  }
-
   map_sub_ = node->create_subscription<nav_msgs::msg::OccupancyGrid>(
     map_topic_, map_qos,
     std::bind(&StaticLayer::incomingMap, this, std::placeholders::_1));
@@ -118,6 +137,7 @@ StaticLayer::deactivate()
 void
 StaticLayer::reset()
 {
+  addUpdatedWindow(x_, y_, x_ + width_, y_ + height_);
   has_updated_data_ = true;
   current_ = false;
 }
@@ -134,6 +154,9 @@ StaticLayer::getParameters()
   declareParameter("transform_tolerance", rclcpp::ParameterValue(0.0));
   declareParameter("map_topic", rclcpp::ParameterValue(""));
   declareParameter("footprint_clearing_enabled", rclcpp::ParameterValue(false));
+  declareParameter("map_region_service", rclcpp::ParameterValue(""));
+  declareParameter("map_region_frame", rclcpp::ParameterValue("map"));
+  declareParameter("map_region_margin", rclcpp::ParameterValue(5.0));
 
   auto node = node_.lock();
   if (!node) {
@@ -154,6 +177,9 @@ StaticLayer::getParameters()
   node->get_parameter(
     name_ + "." + "map_subscribe_transient_local",
     map_subscribe_transient_local_);
+  node->get_parameter(name_ + "." + "map_region_service", map_region_service_);
+  node->get_parameter(name_ + "." + "map_region_frame", map_region_frame_);
+  node->get_parameter(name_ + "." + "map_region_margin", map_region_margin_);
   node->get_parameter("track_unknown_space", track_unknown_space_);
   node->get_parameter("use_maximum", use_maximum_);
   node->get_parameter("lethal_cost_threshold", temp_lethal_threshold);
@@ -188,6 +214,24 @@ StaticLayer::processMap(const nav_msgs::msg::OccupancyGrid & new_map)
     "StaticLayer: Received a %d X %d map at %f m/pix", size_x, size_y,
     new_map.info.resolution);
 
+  // A new map of the geometry and frame of the current one is diffed against it
+  Costmap2D * master = layered_costmap_->getCostmap();
+  const bool same_layer_geometry = size_x_ == size_x && size_y_ == size_y &&
+    resolution_ == new_map.info.resolution &&
+    origin_x_ == new_map.info.origin.position.x &&
+    origin_y_ == new_map.info.origin.position.y;
+  const bool same_master_geometry = layered_costmap_->isRolling() ||
+    (master->getSizeInCellsX() == size_x && master->getSizeInCellsY() == size_y &&
+    master->getResolution() == new_map.info.resolution &&
+    master->getOriginX() == new_map.info.origin.position.x &&
+    master->getOriginY() == new_map.info.origin.position.y);
+  if (map_received_ && same_layer_geometry && same_master_geometry &&
+    map_frame_ == new_map.header.frame_id)
+  {
+    processMapChanges(new_map);
+    return;
+  }
+
   // resize costmap if size, resolution or origin do not match
   Costmap2D * master = layered_costmap_->getCostmap();
   if (!layered_costmap_->isRolling() && (master->getSizeInCellsX() != size_x ||
@@ -222,30 +266,64 @@ StaticLayer::processMap(const nav_msgs::msg::OccupancyGrid & new_map)
       new_map.info.origin.position.x, new_map.info.origin.position.y);
   }
 
-  unsigned int index = 0;
-
   // we have a new map, update full size of map
   std::lock_guard<Costmap2D::mutex_t> guard(*getMutex());
 
   // initialize the costmap with static data
-  for (unsigned int i = 0; i < size_y; ++i) {
-    for (unsigned int j = 0; j < size_x; ++j) {
-      unsigned char value = new_map.data[index];
-      costmap_[index] = interpretValue(value);
-      ++index;
-    }
-  }
+  nav2_util::translateValues(
+    makeCostTable(), new_map.data.data(), size_x * size_y, costmap_);
 
   map_frame_ = new_map.header.frame_id;
 
   x_ = y_ = 0;
   width_ = size_x_;
   height_ = size_y_;
+  addUpdatedWindow(x_, y_, x_ + width_, y_ + height_);
   has_updated_data_ = true;
 
   current_ = true;
 }
 
+void
+StaticLayer::processMapChanges(const nav_msgs::msg::OccupancyGrid & new_map)
+{
+  std::lock_guard<Costmap2D::mutex_t> guard(*getMutex());
+
+  // Only the cells whose cost changed are written, and the updated window bounds them
+  // tightly so that the layers above, such as inflation, stay incremental
+  const auto cost_table = makeCostTable();
+  std::vector<unsigned char> row(size_x_);
+  unsigned int x0 = size_x_, y0 = size_y_, xn = 0, yn = 0;
+  for (unsigned int y = 0; y < size_y_; y++) {
+    unsigned char * costmap_row = costmap_ + y * size_x_;
+    nav2_util::translateValues(
+      cost_table, new_map.data.data() + y * size_x_, size_x_, row.data());
+    if (std::memcmp(row.data(), costmap_row, size_x_) == 0) {
+      continue;
+    }
+
+    const unsigned int first = std::mismatch(row.begin(), row.end(), costmap_row).first -
+      row.begin();
+    const unsigned int last = size_x_ - (std::mismatch(
+        row.rbegin(), row.rend(),
+        std::reverse_iterator<unsigned char *>(costmap_row + size_x_)).first - row.rbegin());
+    std::copy(row.begin() + first, row.begin() + last, costmap_row + first);
+
+    x0 = std::min(x0, first);
+    xn = std::max(xn, last);
+    y0 = std::min(y0, y);
+    yn = y + 1;
+  }
+
+  if (x0 < xn) {
+    RCLCPP_DEBUG(
+      logger_, "StaticLayer: Map changed in cells [%u, %u) X [%u, %u)", x0, xn, y0, yn);
+    addUpdatedWindow(x0, y0, xn, yn);
+    has_updated_data_ = true;
+  }
+  current_ = true;
+}
+
 void
 StaticLayer::matchSize()
 {
@@ -277,6 +355,13 @@ StaticLayer::interpretValue(unsigned char value)
   return scale * LETHAL_OBSTACLE;
 }
 
+nav2_util::ByteTranslationTable<unsigned char>
+StaticLayer::makeCostTable()
+{
+  return nav2_util::makeByteTranslationTable<unsigned char>(
+    [this](unsigned char value) {return interpretValue(value);});
+}
+
 void
 StaticLayer::incomingMap(const nav_msgs::msg::OccupancyGrid::SharedPtr new_map)
 {
@@ -320,18 +405,95 @@ StaticLayer::incomingUpdate(map_msgs::msg::OccupancyGridUpdate::ConstSharedPtr u
       map_frame_.c_str(), update->header.frame_id.c_str());
   }
 
-  unsigned int di = 0;
+  const auto cost_table = makeCostTable();
   for (unsigned int y = 0; y < update->height; y++) {
     unsigned int index_base = (update->y + y) * size_x_;
-    for (unsigned int x = 0; x < update->width; x++) {
-      unsigned int index = index_base + x + update->x;
-      costmap_[index] = interpretValue(update->data[di++]);
-    }
+    nav2_util::translateValues(
+      cost_table, update->data.data() + y * update->width, update->width,
+      costmap_ + index_base + update->x);
   }
 
+  // Only the updated cells need to be recombined with the other layers
+  addUpdatedWindow(
+    update->x, update->y, update->x + update->width, update->y + update->height);
   has_updated_data_ = true;
 }
 
+void
+StaticLayer::requestMapRegion(double robot_x, double robot_y)
+{
+  if (map_region_requested_ || !map_region_client_->service_is_ready()) {
+    return;
+  }
+
+  geometry_msgs::msg::PointStamped robot, robot_in_map;
+  robot.header.frame_id = global_frame_;
+  robot.point.x = robot_x;
+  robot.point.y = robot_y;
+  try {
+    tf_->transform(robot, robot_in_map, map_region_frame_, transform_tolerance_);
+  } catch (tf2::TransformException & ex) {
+    RCLCPP_ERROR(logger_, "StaticLayer: %s", ex.what());
+    return;
+  }
+
+  // The costmap may have any orientation in the map frame, so cover its circumcircle
+  Costmap2D * master = layered_costmap_->getCostmap();
+  const double radius =
+    std::hypot(master->getSizeInMetersX(), master->getSizeInMetersY()) / 2.0;
+  const double x = robot_in_map.point.x;
+  const double y = robot_in_map.point.y;
+  {
+    // Compared with the bounds requested rather than those received, which stop at
+    // the edges of the map
+    std::lock_guard<Costmap2D::mutex_t> guard(*getMutex());
+    const double covered = radius + map_region_margin_ / 2.0;
+    if (map_received_ &&
+      region_min_x_ <= x - covered && x + covered <= region_max_x_ &&
+      region_min_y_ <= y - covered && y + covered <= region_max_y_)
+    {
+      return;
+    }
+  }
+
+  auto request = std::make_shared<nav2_msgs::srv::GetMapRegion::Request>();
+  const double extent = radius + map_region_margin_;
+  request->min_x = x - extent;
+  request->min_y = y - extent;
+  request->max_x = x + extent;
+  request->max_y = y + extent;
+
+  map_region_requested_ = true;
+  map_region_client_->async_send_request(
+    request,
+    [this, request](rclcpp::Client<nav2_msgs::srv::GetMapRegion>::SharedFuture future) {
+      auto response = future.get();
+      if (response->success) {
+        {
+          std::lock_guard<Costmap2D::mutex_t> guard(*getMutex());
+          region_min_x_ = request->min_x;
+          region_min_y_ = request->min_y;
+          region_max_x_ = request->max_x;
+          region_max_y_ = request->max_y;
+        }
+        incomingMap(std::make_shared<nav_msgs::msg::OccupancyGrid>(std::move(response->map)));
+      } else {
+        RCLCPP_WARN(logger_, "StaticLayer: Failed to get the region of the map around the robot");
+      }
+      map_region_requested_ = false;
+    });
+}
+
+void
+StaticLayer::addUpdatedWindow(
+  unsigned int x0, unsigned int y0, unsigned int xn, unsigned int yn)
+{
+  update_x0_ = std::min(update_x0_, x0);
+  update_y0_ = std::min(update_y0_, y0);
+  update_xn_ = std::max(update_xn_, xn);
+  update_yn_ = std::max(update_yn_, yn);
+}
+
 
 void
 StaticLayer::updateBounds(
@@ -340,6 +502,10 @@ StaticLayer::updateBounds(
   double * max_x,
   double * max_y)
 {
+  if (map_region_client_) {
+    requestMapRegion(robot_x, robot_y);
+  }
+
   if (!map_received_) {
     map_received_in_update_bounds_ = false;
     return;
@@ -360,18 +526,25 @@ StaticLayer::updateBounds(
     }
   }
 
+  // The whole map moves with a rolling costmap and is refreshed for extra bounds
+  if (layered_costmap_->isRolling() || !has_updated_data_) {
+    addUpdatedWindow(x_, y_, x_ + width_, y_ + height_);
+  }
+
   useExtraBounds(min_x, min_y, max_x, max_y);
 
   double wx, wy;
 
-  mapToWorld(x_, y_, wx, wy);
+  mapToWorld(update_x0_, update_y0_, wx, wy);
   *min_x = std::min(wx, *min_x);
   *min_y = std::min(wy, *min_y);
 
-  mapToWorld(x_ + width_, y_ + height_, wx, wy);
+  mapToWorld(update_xn_, update_yn_, wx, wy);
   *max_x = std::max(wx, *max_x);
   *max_y = std::max(wy, *max_y);
 
+  update_x0_ = update_y0_ = std::numeric_limits<unsigned int>::max();
+  update_xn_ = update_yn_ = 0;
   has_updated_data_ = false;
 
   updateFootprint(robot_x, robot_y, robot_yaw, min_x, min_y, max_x, max_y);
@@ -479,7 +652,8 @@ StaticLayer::dynamicParametersCallback(
 
     if (param_name == name_ + "." + "map_subscribe_transient_local" ||
       param_name == name_ + "." + "map_topic" ||
-      param_name == name_ + "." + "subscribe_to_updates")
+      param_name == name_ + "." + "subscribe_to_updates" ||
+      param_name == name_ + "." + "map_region_service")
     {
       RCLCPP_WARN(
         logger_, "%s is not a dynamic parameter "
@@ -495,6 +669,7 @@ StaticLayer::dynamicParametersCallback(
         x_ = y_ = 0;
         width_ = size_x_;
         height_ = size_y_;
+        addUpdatedWindow(x_, y_, x_ + width_, y_ + height_);
         has_updated_data_ = true;
         current_ = false;
       }
@@ -0,0 +1,204 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "nav2_costmap_2d/temporal_obstacle_layer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "pluginlib/class_list_macros.hpp"
+
+PLUGINLIB_EXPORT_CLASS(nav2_costmap_2d::TemporalObstacleLayer, nav2_costmap_2d::Layer)
+
+namespace nav2_costmap_2d
+{
+
+void TemporalObstacleLayer::onInitialize()
+{
+  ObstacleLayer::onInitialize();
+
+  declareParameter("persistence_time", rclcpp::ParameterValue(1.0));
+  declareParameter("decay_time", rclcpp::ParameterValue(4.0));
+  declareParameter("decay_steps", rclcpp::ParameterValue(8));
+
+  auto node = node_.lock();
+  if (!node) {
+    throw std::runtime_error{"Failed to lock node"};
+  }
+
+  double persistence_time, decay_time;
+  int decay_steps;
+  node->get_parameter(name_ + "." + "persistence_time", persistence_time);
+  node->get_parameter(name_ + "." + "decay_time", decay_time);
+  node->get_parameter(name_ + "." + "decay_steps", decay_steps);
+  if (decay_steps < 1) {
+    RCLCPP_WARN(logger_, "decay_steps must be at least 1, using 1.");
+    decay_steps = 1;
+  }
+  persistence_time = std::max(persistence_time, 0.0);
+  decay_time = std::max(decay_time, 0.0);
+  if (persistence_time + decay_time <= 0.0) {
+    RCLCPP_WARN(
+      logger_, "Obstacles need a persistence_time or decay_time, keeping them for 1 second.");
+    persistence_time = 1.0;
+  }
+
+  // the ticks of the wheel are the decay steps, or split the persistence without decay
+  const int decay_ticks = decay_time > 0.0 ? decay_steps : 0;
+  tick_period_ = (decay_time > 0.0 ? decay_time : persistence_time) / decay_steps;
+  const int persistence_ticks =
+    std::max(1, static_cast<int>(std::ceil(persistence_time / tick_period_ - 1e-6)));
+
+  age_costs_.assign(persistence_ticks, LETHAL_OBSTACLE);
+  for (int step = 0; step < decay_ticks; ++step) {
+    age_costs_.push_back(
+      static_cast<unsigned char>(
+        (INSCRIBED_INFLATED_OBSTACLE - 1) * (decay_ticks - step) / decay_ticks));
+  }
+  wheel_.assign(age_costs_.size(), std::vector<SeenCell>());
+  epoch_ = clock_->now();
+  current_tick_ = -1;
+}
+
+void TemporalObstacleLayer::updateBounds(
+  double robot_x, double robot_y, double robot_yaw, double * min_x,
+  double * min_y, double * max_x, double * max_y)
+{
+  std::lock_guard<Costmap2D::mutex_t> guard(*getMutex());
+  if (enabled_) {
+    advanceWheel(min_x, min_y, max_x, max_y);
+  }
+  ObstacleLayer::updateBounds(robot_x, robot_y, robot_yaw, min_x, min_y, max_x, max_y);
+}
+
+void TemporalObstacleLayer::advanceWheel(
+  double * min_x, double * min_y, double * max_x, double * max_y)
+{
+  const int64_t tick =
+    static_cast<int64_t>(std::floor((clock_->now() - epoch_).seconds() / tick_period_));
+  if (tick == current_tick_) {
+    return;
+  }
+  if (tick < current_tick_) {
+    // the ages of the obstacles are lost when time jumps back, so they are all removed
+    RCLCPP_WARN(logger_, "Time jumped back, clearing the obstacles of %s.", name_.c_str());
+    resetMaps();
+    touch(getOriginX(), getOriginY(), min_x, min_y, max_x, max_y);
+    touch(
+      getOriginX() + getSizeInMetersX(), getOriginY() + getSizeInMetersY(),
+      min_x, min_y, max_x, max_y);
+    epoch_ = clock_->now();
+    current_tick_ = 0;
+    return;
+  }
+
+  const int64_t lifetime = static_cast<int64_t>(wheel_.size());
+  auto update_bucket = [&](int64_t bucket_tick, unsigned char cost) {
+      const uint16_t stamp = tickStamp(bucket_tick);
+      for (const SeenCell & cell : wheel_[bucket_tick % lifetime]) {
+        const int mx = cell.x - origin_cell_x_;
+        const int my = cell.y - origin_cell_y_;
+        if (mx < 0 || my < 0 || mx >= static_cast<int>(size_x_) ||
+          my >= static_cast<int>(size_y_))
+        {
+          continue;
+        }
+        const unsigned int index = getIndex(mx, my);
+        // skip the cells seen again since this tick
+        if (last_seen_[index] != stamp) {
+          continue;
+        }
+        if (cost == FREE_SPACE) {
+          last_seen_[index] = 0;
+        }
+        // skip the cells cleared by raytracing since
+        if (costmap_[index] == FREE_SPACE) {
+          continue;
+        }
+        costmap_[index] = cost;
+        double wx, wy;
+        mapToWorld(mx, my, wx, wy);
+        touch(wx, wy, min_x, min_y, max_x, max_y);
+      }
+    };
+
+  // remove the obstacles of the ticks which reached the end of their lifetime
+  const int64_t last_expired = std::min(tick - lifetime, current_tick_);
+  for (int64_t t = std::max<int64_t>(current_tick_ - lifetime + 1, 0); t <= last_expired; ++t) {
+    update_bucket(t, FREE_SPACE);
+    wheel_[t % lifetime].clear();
+  }
+
+  // decay the obstacles of the other ticks, when the cost of their age changed
+  for (int64_t age = 1; age < lifetime; ++age) {
+    const int64_t t = tick - age;
+    if (t < 0 || t > current_tick_ || age_costs_[age] == age_costs_[current_tick_ - t]) {
+      continue;
+    }
+    update_bucket(t, age_costs_[age]);
+  }
+
+  current_tick_ = tick;
+}
+
+void TemporalObstacleLayer::markCell(unsigned int index)
+{
+  costmap_[index] = LETHAL_OBSTACLE;
+  const uint16_t stamp = tickStamp(current_tick_);
+  if (last_seen_[index] != stamp) {
+    last_seen_[index] = stamp;
+    wheel_[current_tick_ % static_cast<int64_t>(wheel_.size())].push_back(
+      SeenCell{static_cast<int>(index % size_x_) + origin_cell_x_,
+        static_cast<int>(index / size_x_) + origin_cell_y_});
+  }
+}
+
+void TemporalObstacleLayer::updateOrigin(double new_origin_x, double new_origin_y)
+{
+  // project the new origin into the grid, as the costmap does
+  const int cell_ox = static_cast<int>((new_origin_x - origin_x_) / resolution_);
+  const int cell_oy = static_cast<int>((new_origin_y - origin_y_) / resolution_);
+  ObstacleLayer::updateOrigin(new_origin_x, new_origin_y);
+
+  // the wheel is kept in cells from the first origin, so only the stamps move
+  shiftMapRegion(last_seen_.data(), size_x_, size_y_, cell_ox, cell_oy, uint16_t{0});
+  origin_cell_x_ += cell_ox;
+  origin_cell_y_ += cell_oy;
+}
+
+void TemporalObstacleLayer::matchSize()
+{
+  std::lock_guard<Costmap2D::mutex_t> guard(*getMutex());
+  ObstacleLayer::matchSize();
+  last_seen_.assign(size_x_ * size_y_, 0);
+  for (auto & bucket : wheel_) {
+    bucket.clear();
+  }
+  origin_cell_x_ = 0;
+  origin_cell_y_ = 0;
+}
+
+void TemporalObstacleLayer::resetMaps()
+{
+  ObstacleLayer::resetMaps();
+  std::fill(last_seen_.begin(), last_seen_.end(), 0);
+  for (auto & bucket : wheel_) {
+    bucket.clear();
+  }
+}
+
+}  // namespace nav2_costmap_2d
@@ -0,0 +1,237 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_costmap_2d/vector_zone_layer.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "nav2_costmap_2d/costmap_filters/filter_values.hpp"
+
+namespace nav2_costmap_2d
+{
+
+void VectorZoneLayer::onInitialize()
+{
+  auto node = node_.lock();
+  if (!node) {
+    throw std::runtime_error{"Failed to lock node"};
+  }
+
+  declareParameter("enabled", rclcpp::ParameterValue(true));
+  declareParameter("speed_limit_topic", rclcpp::ParameterValue("speed_limit"));
+  declareParameter("percentage", rclcpp::ParameterValue(false));
+
+  std::string speed_limit_topic;
+  node->get_parameter(name_ + "." + "enabled", enabled_);
+  node->get_parameter(name_ + "." + "speed_limit_topic", speed_limit_topic);
+  node->get_parameter(name_ + "." + "percentage", percentage_);
+
+  global_frame_ = layered_costmap_->getGlobalFrameID();
+  speed_limit_prev_ = NO_SPEED_LIMIT;
+
+  speed_limit_pub_ = node->create_publisher<nav2_msgs::msg::SpeedLimit>(
+    speed_limit_topic, rclcpp::QoS(10));
+  zones_service_ = node->create_service<nav2_msgs::srv::UpdateCostmapZones>(
+    name_ + "/update_zones",
+    std::bind(
+      &VectorZoneLayer::updateZonesCallback, this,
+      std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
+
+  current_ = true;
+}
+
+void VectorZoneLayer::activate()
+{
+  speed_limit_pub_->on_activate();
+}
+
+void VectorZoneLayer::deactivate()
+{
+  speed_limit_pub_->on_deactivate();
+}
+
+void VectorZoneLayer::reset()
+{
+  // The master grid is rebuilt from scratch, so all zones are drawn again
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto & zone : index_.getZones()) {
+    touchZone(zone);
+  }
+  current_ = true;
+}
+
+void VectorZoneLayer::touchZone(const Zone & zone)
+{
+  if (!dirty_) {
+    dirty_min_x_ = dirty_min_y_ = std::numeric_limits<double>::max();
+    dirty_max_x_ = dirty_max_y_ = std::numeric_limits<double>::lowest();
+    dirty_ = true;
+  }
+  dirty_min_x_ = std::min(dirty_min_x_, zone.min_x);
+  dirty_min_y_ = std::min(dirty_min_y_, zone.min_y);
+  dirty_max_x_ = std::max(dirty_max_x_, zone.max_x);
+  dirty_max_y_ = std::max(dirty_max_y_, zone.max_y);
+}
+
+void VectorZoneLayer::updateZonesCallback(
+  const std::shared_ptr<rmw_request_id_t>/*request_header*/,
+  const std::shared_ptr<nav2_msgs::srv::UpdateCostmapZones::Request> request,
+  std::shared_ptr<nav2_msgs::srv::UpdateCostmapZones::Response> response)
+{
+  response->success = false;
+  if (!request->header.frame_id.empty() && request->header.frame_id != global_frame_) {
+    RCLCPP_WARN(
+      logger_, "VectorZoneLayer: Zones in frame %s rather than %s are rejected",
+      request->header.frame_id.c_str(), global_frame_.c_str());
+    return;
+  }
+
+  std::vector<Zone> added;
+  added.reserve(request->zones.size());
+  for (const auto & msg : request->zones) {
+    if (msg.polygon.points.size() < 3) {
+      RCLCPP_WARN(
+        logger_, "VectorZoneLayer: Zone %s has less than 3 points, rejecting the update",
+        msg.id.c_str());
+      return;
+    }
+    Zone zone;
+    zone.id = msg.id;
+    zone.cost = msg.cost;
+    zone.speed_limit = msg.speed_limit;
+    for (const auto & point : msg.polygon.points) {
+      geometry_msgs::msg::Point p;
+      p.x = point.x;
+      p.y = point.y;
+      zone.polygon.push_back(p);
+    }
+    zone.updateBounds();
+    added.push_back(std::move(zone));
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  // Zones removed, or replaced by a zone of the same id, are redrawn as well
+  std::unordered_set<std::string> removed(
+    request->remove_ids.begin(), request->remove_ids.end());
+  for (const auto & zone : added) {
+    removed.insert(zone.id);
+  }
+
+  std::vector<Zone> zones;
+  for (const auto & zone : index_.getZones()) {
+    if (request->clear || removed.count(zone.id)) {
+      touchZone(zone);
+    } else {
+      zones.push_back(zone);
+    }
+  }
+  for (auto & zone : added) {
+    touchZone(zone);
+    zones.push_back(std::move(zone));
+  }
+  index_.build(std::move(zones));
+
+  RCLCPP_INFO(
+    logger_, "VectorZoneLayer: Holding %zu zones", index_.getZones().size());
+  response->success = true;
+}
+
+void VectorZoneLayer::updateBounds(
+  double robot_x, double robot_y, double /*robot_yaw*/,
+  double * min_x, double * min_y, double * max_x, double * max_y)
+{
+  if (!enabled_) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (layered_costmap_->isRolling()) {
+    // The window of a rolling costmap moves over the zones, which are then drawn again
+    const Costmap2D * costmap = layered_costmap_->getCostmap();
+    const double origin_x = costmap->getOriginX();
+    const double origin_y = costmap->getOriginY();
+    index_.query(
+      origin_x, origin_y,
+      origin_x + costmap->getSizeInMetersX(), origin_y + costmap->getSizeInMetersY(), found_);
+    for (const size_t i : found_) {
+      touchZone(index_.getZones()[i]);
+    }
+  }
+
+  if (dirty_) {
+    *min_x = std::min(*min_x, dirty_min_x_);
+    *min_y = std::min(*min_y, dirty_min_y_);
+    *max_x = std::max(*max_x, dirty_max_x_);
+    *max_y = std::max(*max_y, dirty_max_y_);
+    dirty_ = false;
+  }
+
+  updateSpeedLimit(robot_x, robot_y);
+}
+
+void VectorZoneLayer::updateSpeedLimit(double robot_x, double robot_y)
+{
+  // The lowest speed limit of the zones containing the robot
+  double speed_limit = NO_SPEED_LIMIT;
+  index_.queryPoint(robot_x, robot_y, found_);
+  for (const size_t i : found_) {
+    const double zone_limit = index_.getZones()[i].speed_limit;
+    if (zone_limit > 0.0 && (speed_limit == NO_SPEED_LIMIT || zone_limit < speed_limit)) {
+      speed_limit = zone_limit;
+    }
+  }
+
+  if (speed_limit == speed_limit_prev_) {
+    return;
+  }
+  if (speed_limit != NO_SPEED_LIMIT) {
+    RCLCPP_DEBUG(logger_, "VectorZoneLayer: Speed limit is set to %f", speed_limit);
+  } else {
+    RCLCPP_DEBUG(logger_, "VectorZoneLayer: Speed limit is set to its default value");
+  }
+
+  std::unique_ptr<nav2_msgs::msg::SpeedLimit> msg =
+    std::make_unique<nav2_msgs::msg::SpeedLimit>();
+  msg->header.frame_id = global_frame_;
+  msg->header.stamp = clock_->now();
+  msg->percentage = percentage_;
+  msg->speed_limit = speed_limit;
+  speed_limit_pub_->publish(std::move(msg));
+
+  speed_limit_prev_ = speed_limit;
+}
+
+void VectorZoneLayer::updateCosts(
+  nav2_costmap_2d::Costmap2D & master_grid,
+  int min_i, int min_j, int max_i, int max_j)
+{
+  if (!enabled_) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  index_.rasterize(master_grid, min_i, min_j, max_i, max_j);
+}
+
+}  // namespace nav2_costmap_2d
+
+#include "pluginlib/class_list_macros.hpp"
+PLUGINLIB_EXPORT_CLASS(nav2_costmap_2d::VectorZoneLayer, nav2_costmap_2d::Layer)
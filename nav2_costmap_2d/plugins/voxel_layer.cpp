@@ -40,12 +40,14 @@
 
 #include <algorithm>
 #include <cassert>
+#include <limits>
 #include <vector>
 #include <memory>
 #include <utility>
 
 #include "pluginlib/class_list_macros.hpp"
 #include "sensor_msgs/point_cloud2_iterator.hpp"
+#include "nav2_costmap_2d/voxel_grid_delta.hpp"
 
 #define VOXEL_BITS 16
 PLUGINLIB_EXPORT_CLASS(nav2_costmap_2d::VoxelLayer, nav2_costmap_2d::Layer)
@@ -58,6 +60,66 @@ using rcl_interfaces::msg::ParameterType;
 namespace nav2_costmap_2d
 {
 
+namespace
+{
+
+constexpr float no_column_min = std::numeric_limits<float>::infinity();
+constexpr float no_column_max = -std::numeric_limits<float>::infinity();
+
+// Deltas between keyframes, bounds how long a receiver which missed one stays out of sync
+constexpr unsigned int delta_keyframe_interval = 100;
+
+// Rays cleared by a thread at a time, so that threads take work from the pool once per block
+constexpr size_t clearing_block_size = 256;
+
+/**
+ * @brief Clears the cells a ray passes over in 2D, and the obstacles of their
+ * column only if the ray passes through the height interval of the column
+ */
+class ColumnClearer
+{
+public:
+  ColumnClearer(
+    unsigned char * costmap, float * column_min_z, float * column_max_z, unsigned int size_x,
+    double x0, double y0, double z0, double x1, double y1, double z1)
+  : costmap_(costmap), column_min_z_(column_min_z), column_max_z_(column_max_z),
+    size_x_(size_x), x0_(x0), y0_(y0), z0_(z0), dx_(x1 - x0), dy_(y1 - y0), dz_(z1 - z0),
+    sq_length_(dx_ * dx_ + dy_ * dy_)
+  {
+  }
+
+  inline void operator()(unsigned int offset)
+  {
+    if (column_min_z_[offset] > column_max_z_[offset]) {
+      costmap_[offset] = FREE_SPACE;
+      return;
+    }
+
+    // height of the ray, in cells, over the center of the cell
+    double t = 0.0;
+    if (sq_length_ > 0.0) {
+      const double cx = (offset % size_x_) + 0.5 - x0_;
+      const double cy = (offset / size_x_) + 0.5 - y0_;
+      t = std::min(std::max((cx * dx_ + cy * dy_) / sq_length_, 0.0), 1.0);
+    }
+    const double z = z0_ + t * dz_;
+    if (z >= column_min_z_[offset] && z < column_max_z_[offset] + 1.0) {
+      costmap_[offset] = FREE_SPACE;
+      column_min_z_[offset] = no_column_min;
+      column_max_z_[offset] = no_column_max;
+    }
+  }
+
+private:
+  unsigned char * costmap_;
+  float * column_min_z_;
+  float * column_max_z_;
+  unsigned int size_x_;
+  double x0_, y0_, z0_, dx_, dy_, dz_, sq_length_;
+};
+
+}  // namespace
+
 void VoxelLayer::onInitialize()
 {
   ObstacleLayer::onInitialize();
@@ -72,6 +134,10 @@ void VoxelLayer::onInitialize()
   declareParameter("mark_threshold", rclcpp::ParameterValue(0));
   declareParameter("combination_method", rclcpp::ParameterValue(1));
   declareParameter("publish_voxel_map", rclcpp::ParameterValue(false));
+  declareParameter("publish_voxel_map_deltas", rclcpp::ParameterValue(false));
+  declareParameter("sparse_voxel_grid", rclcpp::ParameterValue(false));
+  declareParameter("projected_2d", rclcpp::ParameterValue(false));
+  declareParameter("clearing_threads", rclcpp::ParameterValue(0));
 
   auto node = node_.lock();
   if (!node) {
@@ -87,6 +153,21 @@ void VoxelLayer::onInitialize()
   node->get_parameter(name_ + "." + "unknown_threshold", unknown_threshold_);
   node->get_parameter(name_ + "." + "mark_threshold", mark_threshold_);
   node->get_parameter(name_ + "." + "publish_voxel_map", publish_voxel_);
+  node->get_parameter(name_ + "." + "publish_voxel_map_deltas", publish_voxel_deltas_);
+  node->get_parameter(name_ + "." + "sparse_voxel_grid", sparse_voxel_grid_enabled_);
+  node->get_parameter(name_ + "." + "projected_2d", projected_2d_);
+  if (projected_2d_ && (publish_voxel_ || publish_voxel_deltas_)) {
+    RCLCPP_WARN(
+      logger_, "No voxel map is kept with projected_2d, only the layer costmap is published.");
+    publish_voxel_ = false;
+    publish_voxel_deltas_ = false;
+  }
+
+  int clearing_threads = 0;
+  node->get_parameter(name_ + "." + "clearing_threads", clearing_threads);
+  if (clearing_threads > 0 && !sparse_voxel_grid_enabled_ && !projected_2d_) {
+    clearing_pool_ = std::make_unique<nav2_util::ThreadPool>(clearing_threads);
+  }
 
   int combination_method_param{};
   node->get_parameter(name_ + "." + "combination_method", combination_method_param);
@@ -100,11 +181,24 @@ void VoxelLayer::onInitialize()
     voxel_pub_->on_activate();
   }
 
+  if (publish_voxel_deltas_) {
+    voxel_delta_pub_ = node->create_publisher<nav2_msgs::msg::VoxelGridDelta>(
+      "voxel_grid_deltas", custom_qos);
+    voxel_delta_pub_->on_activate();
+  }
+
   clearing_endpoints_pub_ = node->create_publisher<sensor_msgs::msg::PointCloud2>(
     "clearing_endpoints", custom_qos);
   clearing_endpoints_pub_->on_activate();
 
-  unknown_threshold_ += (VOXEL_BITS - size_z_);
+  // The dense grid counts its levels above z_voxels as unknown, the sparse one does not
+  if (!sparse_voxel_grid_enabled_) {
+    unknown_threshold_ += (VOXEL_BITS - size_z_);
+  } else if ((publish_voxel_ || publish_voxel_deltas_) && size_z_ > VOXEL_BITS) {
+    RCLCPP_WARN(
+      logger_, "Only the lowest %d of the %d z voxels are published in the voxel map.",
+      VOXEL_BITS, size_z_);
+  }
   matchSize();
 
   // Add callback for dynamic parameters
@@ -123,6 +217,15 @@ void VoxelLayer::matchSize()
 {
   std::lock_guard<Costmap2D::mutex_t> guard(*getMutex());
   ObstacleLayer::matchSize();
+  if (projected_2d_) {
+    column_min_z_.assign(size_x_ * size_y_, no_column_min);
+    column_max_z_.assign(size_x_ * size_y_, no_column_max);
+    return;
+  }
+  if (sparse_voxel_grid_enabled_) {
+    sparse_voxel_grid_.resize(size_x_, size_y_, size_z_);
+    return;
+  }
   voxel_grid_.resize(size_x_, size_y_, size_z_);
   assert(voxel_grid_.sizeX() == size_x_ && voxel_grid_.sizeY() == size_y_);
 }
@@ -141,7 +244,16 @@ void VoxelLayer::resetMaps()
   // resetMaps so this goes to the next layer down Costmap2DLayer which also
   // doesn't implement this, so it actually goes all the way to Costmap2D
   ObstacleLayer::resetMaps();
-  voxel_grid_.reset();
+  if (projected_2d_) {
+    std::fill(column_min_z_.begin(), column_min_z_.end(), no_column_min);
+    std::fill(column_max_z_.begin(), column_max_z_.end(), no_column_max);
+  } else if (sparse_voxel_grid_enabled_) {
+    sparse_voxel_grid_.reset();
+  } else {
+    voxel_grid_.reset();
+  }
+  // The next delta is a keyframe
+  delta_reference_.clear();
 }
 
 void VoxelLayer::updateBounds(
@@ -221,8 +333,23 @@ void VoxelLayer::updateBounds(
         continue;
       }
 
+      if (projected_2d_) {
+        // only keep the height interval of the obstacles in the column
+        unsigned int index = getIndex(mx, my);
+        column_min_z_[index] = std::min(column_min_z_[index], static_cast<float>(mz));
+        column_max_z_[index] = std::max(column_max_z_[index], static_cast<float>(mz));
+        costmap_[index] = LETHAL_OBSTACLE;
+        touch(
+          static_cast<double>(*iter_x), static_cast<double>(*iter_y),
+          min_x, min_y, max_x, max_y);
+        continue;
+      }
+
       // mark the cell in the voxel grid and check if we should also mark it in the costmap
-      if (voxel_grid_.markVoxelInMap(mx, my, mz, mark_threshold_)) {
+      const bool column_marked = sparse_voxel_grid_enabled_ ?
+        sparse_voxel_grid_.markVoxelInMap(mx, my, mz, mark_threshold_) :
+        voxel_grid_.markVoxelInMap(mx, my, mz, mark_threshold_);
+      if (column_marked) {
         unsigned int index = getIndex(mx, my);
 
         costmap_[index] = LETHAL_OBSTACLE;
@@ -235,12 +362,21 @@ void VoxelLayer::updateBounds(
 
   if (publish_voxel_) {
     auto grid_msg = std::make_unique<nav2_msgs::msg::VoxelGrid>();
-    unsigned int size = voxel_grid_.sizeX() * voxel_grid_.sizeY();
-    grid_msg->size_x = voxel_grid_.sizeX();
-    grid_msg->size_y = voxel_grid_.sizeY();
-    grid_msg->size_z = voxel_grid_.sizeZ();
-    grid_msg->data.resize(size);
-    memcpy(&grid_msg->data[0], voxel_grid_.getData(), size * sizeof(unsigned int));
+    if (sparse_voxel_grid_enabled_) {
+      grid_msg->size_x = sparse_voxel_grid_.sizeX();
+      grid_msg->size_y = sparse_voxel_grid_.sizeY();
+      grid_msg->size_z =
+        std::min(sparse_voxel_grid_.sizeZ(), static_cast<unsigned int>(VOXEL_BITS));
+      grid_msg->data.resize(grid_msg->size_x * grid_msg->size_y);
+      sparse_voxel_grid_.getColumnData(&grid_msg->data[0]);
+    } else {
+      unsigned int size = voxel_grid_.sizeX() * voxel_grid_.sizeY();
+      grid_msg->size_x = voxel_grid_.sizeX();
+      grid_msg->size_y = voxel_grid_.sizeY();
+      grid_msg->size_z = voxel_grid_.sizeZ();
+      grid_msg->data.resize(size);
+      memcpy(&grid_msg->data[0], voxel_grid_.getData(), size * sizeof(unsigned int));
+    }
 
     grid_msg->origin.x = origin_x_;
     grid_msg->origin.y = origin_y_;
@@ -255,9 +391,84 @@ void VoxelLayer::updateBounds(
     voxel_pub_->publish(std::move(grid_msg));
   }
 
+  if (publish_voxel_deltas_) {
+    publishVoxelGridDelta(*min_x, *min_y, *max_x, *max_y);
+  }
+
   updateFootprint(robot_x, robot_y, robot_yaw, min_x, min_y, max_x, max_y);
 }
 
+void VoxelLayer::publishVoxelGridDelta(
+  double min_x, double min_y, double max_x, double max_y)
+{
+  const size_t subscribers = voxel_delta_pub_->get_subscription_count();
+  if (subscribers == 0) {
+    // The next subscriber starts with a keyframe
+    if (!delta_reference_.empty()) {
+      delta_reference_.clear();
+      delta_reference_.shrink_to_fit();
+    }
+    delta_subscribers_ = 0;
+    return;
+  }
+
+  // New subscribers, receivers that missed a delta and resized grids need a keyframe
+  const bool keyframe = subscribers > delta_subscribers_ ||
+    deltas_since_keyframe_ + 1 >= delta_keyframe_interval ||
+    delta_origin_x_ != origin_x_ || delta_origin_y_ != origin_y_ ||
+    delta_resolution_ != resolution_;
+  delta_subscribers_ = subscribers;
+  delta_origin_x_ = origin_x_;
+  delta_origin_y_ = origin_y_;
+  delta_resolution_ = resolution_;
+
+  // The voxels marked or cleared by this update are within its bounds, while all columns
+  // shifted in or out of a moved grid are compared
+  const bool moved = delta_grid_moved_;
+  delta_grid_moved_ = false;
+  int x0 = 0, y0 = 0, xn = -1, yn = -1;
+  if (moved) {
+    xn = size_x_ - 1;
+    yn = size_y_ - 1;
+  } else if (min_x <= max_x && min_y <= max_y) {
+    worldToMapEnforceBounds(min_x, min_y, x0, y0);
+    worldToMapEnforceBounds(max_x, max_y, xn, yn);
+  }
+
+  const uint32_t * columns;
+  unsigned int size_z;
+  if (sparse_voxel_grid_enabled_) {
+    delta_columns_.resize(size_x_ * size_y_);
+    sparse_voxel_grid_.getColumnData(delta_columns_.data());
+    columns = delta_columns_.data();
+    size_z = std::min(sparse_voxel_grid_.sizeZ(), static_cast<unsigned int>(VOXEL_BITS));
+  } else {
+    columns = voxel_grid_.getData();
+    size_z = voxel_grid_.sizeZ();
+  }
+
+  auto delta_msg = std::make_unique<nav2_msgs::msg::VoxelGridDelta>();
+  createVoxelGridDelta(
+    columns, size_x_, size_y_, size_z, x0, y0, xn + 1, yn + 1, delta_reference_, keyframe,
+    *delta_msg);
+  // Receivers only shift their columns with the next delta, so moves are always published
+  if (!delta_msg->keyframe && !moved && delta_msg->column_ranges.empty()) {
+    return;
+  }
+
+  delta_msg->origin.x = origin_x_;
+  delta_msg->origin.y = origin_y_;
+  delta_msg->origin.z = origin_z_;
+  delta_msg->resolutions.x = resolution_;
+  delta_msg->resolutions.y = resolution_;
+  delta_msg->resolutions.z = z_resolution_;
+  delta_msg->header.frame_id = global_frame_;
+  delta_msg->header.stamp = clock_->now();
+  delta_msg->sequence = delta_sequence_++;
+  deltas_since_keyframe_ = delta_msg->keyframe ? 0 : deltas_since_keyframe_ + 1;
+  voxel_delta_pub_->publish(std::move(delta_msg));
+}
+
 void VoxelLayer::raytraceFreespace(
   const Observation & clearing_observation, double * min_x,
   double * min_y,
@@ -320,6 +531,10 @@ void VoxelLayer::raytraceFreespace(
   double map_end_y = origin_y_ + getSizeInMetersY();
   double map_end_z = origin_z_ + getSizeInMetersZ();
 
+  unsigned int cell_raytrace_max_range = cellDistance(clearing_observation.raytrace_max_range_);
+  unsigned int cell_raytrace_min_range = cellDistance(clearing_observation.raytrace_min_range_);
+  clearing_rays_.clear();
+
   sensor_msgs::PointCloud2ConstIterator<float> iter_x(*(clearing_observation.cloud_), "x");
   sensor_msgs::PointCloud2ConstIterator<float> iter_y(*(clearing_observation.cloud_), "y");
   sensor_msgs::PointCloud2ConstIterator<float> iter_z(*(clearing_observation.cloud_), "z");
@@ -373,16 +588,30 @@ void VoxelLayer::raytraceFreespace(
 
     double point_x, point_y, point_z;
     if (worldToMap3DFloat(wpx, wpy, wpz, point_x, point_y, point_z)) {
-      unsigned int cell_raytrace_max_range = cellDistance(clearing_observation.raytrace_max_range_);
-      unsigned int cell_raytrace_min_range = cellDistance(clearing_observation.raytrace_min_range_);
-
-
       // voxel_grid_.markVoxelLine(sensor_x, sensor_y, sensor_z, point_x, point_y, point_z);
-      voxel_grid_.clearVoxelLineInMap(
-        sensor_x, sensor_y, sensor_z, point_x, point_y, point_z,
-        costmap_,
-        unknown_threshold_, mark_threshold_, FREE_SPACE, NO_INFORMATION,
-        cell_raytrace_max_range, cell_raytrace_min_range);
+      if (projected_2d_) {
+        ColumnClearer clearer(
+          costmap_, column_min_z_.data(), column_max_z_.data(), size_x_,
+          sensor_x, sensor_y, sensor_z, point_x, point_y, point_z);
+        raytraceLine(
+          clearer, static_cast<unsigned int>(sensor_x), static_cast<unsigned int>(sensor_y),
+          static_cast<unsigned int>(point_x), static_cast<unsigned int>(point_y),
+          cell_raytrace_max_range, cell_raytrace_min_range);
+      } else if (sparse_voxel_grid_enabled_) {
+        sparse_voxel_grid_.clearVoxelLineInMap(
+          sensor_x, sensor_y, sensor_z, point_x, point_y, point_z,
+          costmap_,
+          unknown_threshold_, mark_threshold_, FREE_SPACE, NO_INFORMATION,
+          cell_raytrace_max_range, cell_raytrace_min_range);
+      } else if (clearing_pool_) {
+        clearing_rays_.push_back({point_x, point_y, point_z});
+      } else {
+        voxel_grid_.clearVoxelLineInMap(
+          sensor_x, sensor_y, sensor_z, point_x, point_y, point_z,
+          costmap_,
+          unknown_threshold_, mark_threshold_, FREE_SPACE, NO_INFORMATION,
+          cell_raytrace_max_range, cell_raytrace_min_range);
+      }
 
       updateRaytraceBounds(
         ox, oy, wpx, wpy, clearing_observation.raytrace_max_range_,
@@ -402,6 +631,24 @@ void VoxelLayer::raytraceFreespace(
     }
   }
 
+  // The rays are cleared by blocks across the threads, then the costmap cells of the columns
+  // they crossed are set as clearing them one after the other would
+  if (!clearing_rays_.empty()) {
+    const size_t blocks = (clearing_rays_.size() + clearing_block_size - 1) / clearing_block_size;
+    clearing_pool_->parallelFor(
+      blocks, [&](size_t block) {
+        const size_t end = std::min(clearing_rays_.size(), (block + 1) * clearing_block_size);
+        for (size_t i = block * clearing_block_size; i < end; ++i) {
+          voxel_grid_.clearVoxelLineConcurrently(
+            sensor_x, sensor_y, sensor_z,
+            clearing_rays_[i][0], clearing_rays_[i][1], clearing_rays_[i][2],
+            cell_raytrace_max_range, cell_raytrace_min_range);
+        }
+      });
+    voxel_grid_.updateClearedColumnsInMap(
+      costmap_, unknown_threshold_, mark_threshold_, FREE_SPACE, NO_INFORMATION);
+  }
+
   if (publish_clearing_points) {
     clearing_endpoints_->header.frame_id = global_frame_;
     clearing_endpoints_->header.stamp = clearing_observation.cloud_->header.stamp;
@@ -423,58 +670,31 @@ void VoxelLayer::updateOrigin(double new_origin_x, double new_origin_y)
   new_grid_ox = origin_x_ + cell_ox * resolution_;
   new_grid_oy = origin_y_ + cell_oy * resolution_;
 
-  // To save casting from unsigned int to int a bunch of times
-  int size_x = size_x_;
-  int size_y = size_y_;
-
-  // we need to compute the overlap of the new and existing windows
-  int lower_left_x, lower_left_y, upper_right_x, upper_right_y;
-  lower_left_x = std::min(std::max(cell_ox, 0), size_x);
-  lower_left_y = std::min(std::max(cell_oy, 0), size_y);
-  upper_right_x = std::min(std::max(cell_ox + size_x, 0), size_x);
-  upper_right_y = std::min(std::max(cell_oy + size_y, 0), size_y);
-
-  unsigned int cell_size_x = upper_right_x - lower_left_x;
-  unsigned int cell_size_y = upper_right_y - lower_left_y;
-
-  // we need a map to store the obstacles in the window temporarily
-  unsigned char * local_map = new unsigned char[cell_size_x * cell_size_y];
-  unsigned int * local_voxel_map = new unsigned int[cell_size_x * cell_size_y];
-  unsigned int * voxel_map = voxel_grid_.getData();
-
-  // copy the local window in the costmap to the local map
-  copyMapRegion(
-    costmap_, lower_left_x, lower_left_y, size_x_, local_map, 0, 0, cell_size_x,
-    cell_size_x,
-    cell_size_y);
-  copyMapRegion(
-    voxel_map, lower_left_x, lower_left_y, size_x_, local_voxel_map, 0, 0, cell_size_x,
-    cell_size_x,
-    cell_size_y);
-
-  // we'll reset our maps to unknown space if appropriate
-  resetMaps();
+  // move the overlapping information to its new location in place, the cells
+  // which were outside of the maps become unknown space if appropriate
+  shiftMapRegion(costmap_, size_x_, size_y_, cell_ox, cell_oy, default_value_);
+  if (projected_2d_) {
+    shiftMapRegion(column_min_z_.data(), size_x_, size_y_, cell_ox, cell_oy, no_column_min);
+    shiftMapRegion(column_max_z_.data(), size_x_, size_y_, cell_ox, cell_oy, no_column_max);
+  } else if (sparse_voxel_grid_enabled_) {
+    sparse_voxel_grid_.shift(cell_ox, cell_oy);
+  } else {
+    assert(voxel_grid_.sizeX() == size_x_ && voxel_grid_.sizeY() == size_y_);
+    shiftMapRegion(
+      voxel_grid_.getData(), size_x_, size_y_, cell_ox, cell_oy, ~((uint32_t)0) >> 16);
+  }
 
   // update the origin with the appropriate world coordinates
   origin_x_ = new_grid_ox;
   origin_y_ = new_grid_oy;
 
-  // compute the starting cell location for copying data back in
-  int start_x = lower_left_x - cell_ox;
-  int start_y = lower_left_y - cell_oy;
-
-  // now we want to copy the overlapping information back into the map, but in its new location
-  copyMapRegion(
-    local_map, 0, 0, cell_size_x, costmap_, start_x, start_y, size_x_, cell_size_x,
-    cell_size_y);
-  copyMapRegion(
-    local_voxel_map, 0, 0, cell_size_x, voxel_map, start_x, start_y, size_x_,
-    cell_size_x,
-    cell_size_y);
-
-  // make sure to clean up
-  delete[] local_map;
-  delete[] local_voxel_map;
+  if (!delta_reference_.empty() && (cell_ox != 0 || cell_oy != 0)) {
+    // Receivers of deltas shift their columns alike, clearing those shifted in
+    shiftMapRegion(delta_reference_.data(), size_x_, size_y_, cell_ox, cell_oy, 0u);
+    delta_origin_x_ = origin_x_;
+    delta_origin_y_ = origin_y_;
+    delta_grid_moved_ = true;
+  }
 }
 
 /**
@@ -514,6 +734,21 @@ VoxelLayer::dynamicParametersCallback(
           logger_, "publish voxel map is not a dynamic parameter "
           "cannot be changed while running. Rejecting parameter update.");
         continue;
+      } else if (param_name == name_ + "." + "publish_voxel_map_deltas") {
+        RCLCPP_WARN(
+          logger_, "publish voxel map deltas is not a dynamic parameter "
+          "cannot be changed while running. Rejecting parameter update.");
+        continue;
+      } else if (param_name == name_ + "." + "sparse_voxel_grid") {
+        RCLCPP_WARN(
+          logger_, "sparse voxel grid is not a dynamic parameter "
+          "cannot be changed while running. Rejecting parameter update.");
+        continue;
+      } else if (param_name == name_ + "." + "projected_2d") {
+        RCLCPP_WARN(
+          logger_, "projected 2d is not a dynamic parameter "
+          "cannot be changed while running. Rejecting parameter update.");
+        continue;
       }
 
     } else if (param_type == ParameterType::PARAMETER_INTEGER) {
@@ -521,11 +756,19 @@ VoxelLayer::dynamicParametersCallback(
         size_z_ = parameter.as_int();
         resize_map_needed = true;
       } else if (param_name == name_ + "." + "unknown_threshold") {
-        unknown_threshold_ = parameter.as_int() + (VOXEL_BITS - size_z_);
+        unknown_threshold_ = parameter.as_int();
+        if (!sparse_voxel_grid_enabled_) {
+          unknown_threshold_ += (VOXEL_BITS - size_z_);
+        }
       } else if (param_name == name_ + "." + "mark_threshold") {
         mark_threshold_ = parameter.as_int();
       } else if (param_name == name_ + "." + "combination_method") {
         combination_method_ = combination_method_from_int(parameter.as_int());
+      } else if (param_name == name_ + "." + "clearing_threads") {
+        RCLCPP_WARN(
+          logger_, "clearing threads is not a dynamic parameter "
+          "cannot be changed while running. Rejecting parameter update.");
+        continue;
       }
     }
   }
@@ -0,0 +1,241 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_costmap_2d/cost_pyramid.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "nav2_costmap_2d/cost_values.hpp"
+
+namespace nav2_costmap_2d
+{
+
+// Blocks of each level are 4x4 blocks of the level below
+static constexpr unsigned int BLOCK_SHIFT = 2;
+static constexpr unsigned int BLOCK_MASK = (1u << BLOCK_SHIFT) - 1;
+
+// Shift from cell coordinates to the coordinates of the blocks of a level
+static inline unsigned int levelShift(int level)
+{
+  return BLOCK_SHIFT * static_cast<unsigned int>(level + 1);
+}
+
+void CostPyramid::setNumLevels(unsigned int num_levels)
+{
+  num_levels = std::max(1u, num_levels);
+  if (num_levels != num_levels_) {
+    num_levels_ = num_levels;
+    costmap_ = nullptr;
+  }
+}
+
+void CostPyramid::update(const Costmap2D & costmap)
+{
+  costmap_ = nullptr;
+  update(costmap, 0, costmap.getSizeInCellsX(), 0, costmap.getSizeInCellsY());
+}
+
+void CostPyramid::update(
+  const Costmap2D & costmap, unsigned int x0, unsigned int xn,
+  unsigned int y0, unsigned int yn)
+{
+  if (costmap_ != &costmap || charmap_ != costmap.getCharMap() ||
+    size_x_ != costmap.getSizeInCellsX() || size_y_ != costmap.getSizeInCellsY() ||
+    resolution_ != costmap.getResolution() || origin_x_ != costmap.getOriginX() ||
+    origin_y_ != costmap.getOriginY())
+  {
+    costmap_ = &costmap;
+    charmap_ = costmap.getCharMap();
+    size_x_ = costmap.getSizeInCellsX();
+    size_y_ = costmap.getSizeInCellsY();
+    resolution_ = costmap.getResolution();
+    origin_x_ = costmap.getOriginX();
+    origin_y_ = costmap.getOriginY();
+
+    levels_.resize(num_levels_);
+    for (unsigned int level = 0; level != num_levels_; level++) {
+      const unsigned int shift = levelShift(level);
+      levels_[level].size_x = size_x_ == 0 ? 0 : ((size_x_ - 1) >> shift) + 1;
+      levels_[level].size_y = size_y_ == 0 ? 0 : ((size_y_ - 1) >> shift) + 1;
+      levels_[level].costs.assign(levels_[level].size_x * levels_[level].size_y, 0);
+    }
+    x0 = y0 = 0;
+    xn = size_x_;
+    yn = size_y_;
+  }
+
+  xn = std::min(xn, size_x_);
+  yn = std::min(yn, size_y_);
+  if (x0 < xn && y0 < yn) {
+    computeWindow(x0, xn, y0, yn);
+  }
+}
+
+void CostPyramid::computeWindow(
+  unsigned int x0, unsigned int xn, unsigned int y0, unsigned int yn)
+{
+  // Blocks of the first level from the cells
+  Level & first = levels_[0];
+  for (unsigned int by = y0 >> BLOCK_SHIFT; by <= (yn - 1) >> BLOCK_SHIFT; by++) {
+    const unsigned int cy0 = by << BLOCK_SHIFT;
+    const unsigned int cyn = std::min(cy0 + BLOCK_MASK + 1, size_y_);
+    for (unsigned int bx = x0 >> BLOCK_SHIFT; bx <= (xn - 1) >> BLOCK_SHIFT; bx++) {
+      const unsigned int cx0 = bx << BLOCK_SHIFT;
+      const unsigned int cxn = std::min(cx0 + BLOCK_MASK + 1, size_x_);
+      unsigned char block_cost = 0;
+      for (unsigned int cy = cy0; cy != cyn; cy++) {
+        const unsigned char * row = charmap_ + cy * size_x_;
+        for (unsigned int cx = cx0; cx != cxn; cx++) {
+          block_cost = std::max(block_cost, row[cx]);
+        }
+      }
+      first.costs[by * first.size_x + bx] = block_cost;
+    }
+  }
+
+  // Blocks of the other levels from those of the level below
+  for (unsigned int level = 1; level != num_levels_; level++) {
+    const Level & below = levels_[level - 1];
+    Level & current = levels_[level];
+    const unsigned int shift = levelShift(level);
+    for (unsigned int by = y0 >> shift; by <= (yn - 1) >> shift; by++) {
+      const unsigned int cy0 = by << BLOCK_SHIFT;
+      const unsigned int cyn = std::min(cy0 + BLOCK_MASK + 1, below.size_y);
+      for (unsigned int bx = x0 >> shift; bx <= (xn - 1) >> shift; bx++) {
+        const unsigned int cx0 = bx << BLOCK_SHIFT;
+        const unsigned int cxn = std::min(cx0 + BLOCK_MASK + 1, below.size_x);
+        unsigned char block_cost = 0;
+        for (unsigned int cy = cy0; cy != cyn; cy++) {
+          const unsigned char * row = below.costs.data() + cy * below.size_x;
+          for (unsigned int cx = cx0; cx != cxn; cx++) {
+            block_cost = std::max(block_cost, row[cx]);
+          }
+        }
+        current.costs[by * current.size_x + bx] = block_cost;
+      }
+    }
+  }
+}
+
+bool CostPyramid::isRegionBelow(
+  unsigned int min_x, unsigned int min_y, unsigned int max_x, unsigned int max_y,
+  unsigned char cost) const
+{
+  if (!isInitialized() || min_x > max_x || min_y > max_y ||
+    max_x >= size_x_ || max_y >= size_y_)
+  {
+    return false;
+  }
+  return isRegionBelow(static_cast<int>(num_levels_) - 1, min_x, min_y, max_x, max_y, cost);
+}
+
+bool CostPyramid::isRegionBelow(
+  int level, unsigned int min_x, unsigned int min_y, unsigned int max_x, unsigned int max_y,
+  unsigned char cost) const
+{
+  if (level < 0) {
+    for (unsigned int y = min_y; y <= max_y; y++) {
+      const unsigned char * row = charmap_ + y * size_x_;
+      for (unsigned int x = min_x; x <= max_x; x++) {
+        if (row[x] >= cost) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  const Level & blocks = levels_[level];
+  const unsigned int shift = levelShift(level);
+  const unsigned int block_size = 1u << shift;
+  for (unsigned int by = min_y >> shift; by <= max_y >> shift; by++) {
+    for (unsigned int bx = min_x >> shift; bx <= max_x >> shift; bx++) {
+      if (blocks.costs[by * blocks.size_x + bx] < cost) {
+        continue;
+      }
+
+      // A block at or above the cost entirely in the region has a cell at or above it,
+      // otherwise it may be in the part of the block out of the region
+      const unsigned int cx0 = bx << shift;
+      const unsigned int cy0 = by << shift;
+      const unsigned int cx1 = std::min(cx0 + block_size, size_x_) - 1;
+      const unsigned int cy1 = std::min(cy0 + block_size, size_y_) - 1;
+      if (cx0 >= min_x && cx1 <= max_x && cy0 >= min_y && cy1 <= max_y) {
+        return false;
+      }
+      if (!isRegionBelow(
+          level - 1, std::max(cx0, min_x), std::max(cy0, min_y),
+          std::min(cx1, max_x), std::min(cy1, max_y), cost))
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+unsigned char CostPyramid::getMaxCost(
+  unsigned int min_x, unsigned int min_y, unsigned int max_x, unsigned int max_y) const
+{
+  if (!isInitialized() || min_x > max_x || min_y > max_y ||
+    max_x >= size_x_ || max_y >= size_y_)
+  {
+    return NO_INFORMATION;
+  }
+  unsigned char max_cost = 0;
+  raiseToMaxCost(static_cast<int>(num_levels_) - 1, min_x, min_y, max_x, max_y, max_cost);
+  return max_cost;
+}
+
+void CostPyramid::raiseToMaxCost(
+  int level, unsigned int min_x, unsigned int min_y, unsigned int max_x, unsigned int max_y,
+  unsigned char & max_cost) const
+{
+  if (level < 0) {
+    for (unsigned int y = min_y; y <= max_y; y++) {
+      const unsigned char * row = charmap_ + y * size_x_;
+      for (unsigned int x = min_x; x <= max_x; x++) {
+        max_cost = std::max(max_cost, row[x]);
+      }
+    }
+    return;
+  }
+
+  const Level & blocks = levels_[level];
+  const unsigned int shift = levelShift(level);
+  const unsigned int block_size = 1u << shift;
+  for (unsigned int by = min_y >> shift; by <= max_y >> shift; by++) {
+    for (unsigned int bx = min_x >> shift; bx <= max_x >> shift; bx++) {
+      const unsigned char block_cost = blocks.costs[by * blocks.size_x + bx];
+      if (block_cost <= max_cost) {
+        continue;
+      }
+
+      const unsigned int cx0 = bx << shift;
+      const unsigned int cy0 = by << shift;
+      const unsigned int cx1 = std::min(cx0 + block_size, size_x_) - 1;
+      const unsigned int cy1 = std::min(cy0 + block_size, size_y_) - 1;
+      if (cx0 >= min_x && cx1 <= max_x && cy0 >= min_y && cy1 <= max_y) {
+        max_cost = block_cost;
+      } else {
+        raiseToMaxCost(
+          level - 1, std::max(cx0, min_x), std::max(cy0, min_y),
+          std::min(cx1, max_x), std::min(cy1, max_y), max_cost);
+      }
+    }
+  }
+}
+
+}  // namespace nav2_costmap_2d
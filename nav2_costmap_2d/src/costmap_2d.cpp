@@ -73,6 +73,7 @@ Costmap2D::Costmap2D(const nav_msgs::msg::OccupancyGrid & map)
 
   // create the costmap
   costmap_ = new unsigned char[size_x_ * size_y_];
+  memory_tracker_.update(size_x_ * size_y_);
 
   // fill the costmap with a data
   int8_t data;
@@ -96,15 +97,28 @@ void Costmap2D::deleteMaps()
   std::unique_lock<mutex_t> lock(*access_);
   delete[] costmap_;
   costmap_ = NULL;
+  memory_tracker_.update(0);
 }
 
 void Costmap2D::initMaps(unsigned int size_x, unsigned int size_y)
 {
   std::unique_lock<mutex_t> lock(*access_);
-  delete[] costmap_;
+  // keep the old data if it has the same number of cells, it is reset or overwritten
+  if (costmap_ == NULL || size_x_ * size_y_ != size_x * size_y) {
+    delete[] costmap_;
+    costmap_ = new unsigned char[size_x * size_y];
+    memory_tracker_.update(size_x * size_y);
+  }
   size_x_ = size_x;
   size_y_ = size_y;
-  costmap_ = new unsigned char[size_x * size_y];
+}
+
+void Costmap2D::setMemoryTag(const std::string & tag)
+{
+  std::unique_lock<mutex_t> lock(*access_);
+  const size_t bytes = memory_tracker_.bytes();
+  memory_tracker_ = nav2_util::MemoryTracker(tag);
+  memory_tracker_.update(bytes);
 }
 
 void Costmap2D::resizeMap(
@@ -211,8 +225,12 @@ Costmap2D & Costmap2D::operator=(const Costmap2D & map)
     return *this;
   }
 
-  // clean up old data
-  deleteMaps();
+  // keep the old data if it has the same size, e.g. when refreshing a copy every update
+  const bool reuse_maps = costmap_ != NULL && size_x_ * size_y_ == map.size_x_ * map.size_y_;
+  if (!reuse_maps) {
+    // clean up old data
+    deleteMaps();
+  }
 
   size_x_ = map.size_x_;
   size_y_ = map.size_y_;
@@ -220,8 +238,10 @@ Costmap2D & Costmap2D::operator=(const Costmap2D & map)
   origin_x_ = map.origin_x_;
   origin_y_ = map.origin_y_;
 
-  // initialize our various maps
-  initMaps(size_x_, size_y_);
+  if (!reuse_maps) {
+    // initialize our various maps
+    initMaps(size_x_, size_y_);
+  }
 
   // copy the cost map
   memcpy(costmap_, map.costmap_, size_x_ * size_y_ * sizeof(unsigned char));
@@ -352,47 +372,16 @@ void Costmap2D::updateOrigin(double new_origin_x, double new_origin_y)
   new_grid_ox = origin_x_ + cell_ox * resolution_;
   new_grid_oy = origin_y_ + cell_oy * resolution_;
 
-  // To save casting from unsigned int to int a bunch of times
-  int size_x = size_x_;
-  int size_y = size_y_;
-
-  // we need to compute the overlap of the new and existing windows
-  int lower_left_x, lower_left_y, upper_right_x, upper_right_y;
-  lower_left_x = std::min(std::max(cell_ox, 0), size_x);
-  lower_left_y = std::min(std::max(cell_oy, 0), size_y);
-  upper_right_x = std::min(std::max(cell_ox + size_x, 0), size_x);
-  upper_right_y = std::min(std::max(cell_oy + size_y, 0), size_y);
-
-  unsigned int cell_size_x = upper_right_x - lower_left_x;
-  unsigned int cell_size_y = upper_right_y - lower_left_y;
-
-  // we need a map to store the obstacles in the window temporarily
-  unsigned char * local_map = new unsigned char[cell_size_x * cell_size_y];
-
-  // copy the local window in the costmap to the local map
-  copyMapRegion(
-    costmap_, lower_left_x, lower_left_y, size_x_, local_map, 0, 0, cell_size_x,
-    cell_size_x,
-    cell_size_y);
-
-  // now we'll set the costmap to be completely unknown if we track unknown space
-  resetMaps();
+  // move the overlapping information to its new location in place, the cells
+  // which were outside of the map become unknown space if we track it
+  {
+    std::unique_lock<mutex_t> lock(*access_);
+    shiftMapRegion(costmap_, size_x_, size_y_, cell_ox, cell_oy, default_value_);
+  }
 
   // update the origin with the appropriate world coordinates
   origin_x_ = new_grid_ox;
   origin_y_ = new_grid_oy;
-
-  // compute the starting cell location for copying data back in
-  int start_x = lower_left_x - cell_ox;
-  int start_y = lower_left_y - cell_oy;
-
-  // now we want to copy the overlapping information back into the map, but in its new location
-  copyMapRegion(
-    local_map, 0, 0, cell_size_x, costmap_, start_x, start_y, size_x_, cell_size_x,
-    cell_size_y);
-
-  // make sure to clean up
-  delete[] local_map;
 }
 
 bool Costmap2D::setConvexPolygonCost(
@@ -35,6 +35,8 @@
 #include "sensor_msgs/point_cloud2_iterator.hpp"
 #include "nav2_voxel_grid/voxel_grid.hpp"
 #include "nav2_msgs/msg/voxel_grid.hpp"
+#include "nav2_msgs/msg/voxel_grid_delta.hpp"
+#include "nav2_costmap_2d/voxel_grid_delta.hpp"
 #include "nav2_util/execution_timer.hpp"
 
 static inline void mapToWorld3D(
@@ -128,29 +130,24 @@ void pointCloud2Helper(
   }
 }
 
-void voxelCallback(const nav2_msgs::msg::VoxelGrid::ConstSharedPtr grid)
+void publishVoxelCloud(const nav2_msgs::msg::VoxelGrid & grid)
 {
-  if (grid->data.empty()) {
-    RCLCPP_ERROR(g_node->get_logger(), "Received empty voxel grid");
-    return;
-  }
-
   nav2_util::ExecutionTimer timer;
   timer.start();
 
   RCLCPP_DEBUG(g_node->get_logger(), "Received voxel grid");
-  const std::string frame_id = grid->header.frame_id;
-  const rclcpp::Time stamp = grid->header.stamp;
-  const uint32_t * data = &grid->data.front();
-  const double x_origin = grid->origin.x;
-  const double y_origin = grid->origin.y;
-  const double z_origin = grid->origin.z;
-  const double x_res = grid->resolutions.x;
-  const double y_res = grid->resolutions.y;
-  const double z_res = grid->resolutions.z;
-  const uint32_t x_size = grid->size_x;
-  const uint32_t y_size = grid->size_y;
-  const uint32_t z_size = grid->size_z;
+  const std::string frame_id = grid.header.frame_id;
+  const rclcpp::Time stamp = grid.header.stamp;
+  const uint32_t * data = grid.data.data();
+  const double x_origin = grid.origin.x;
+  const double y_origin = grid.origin.y;
+  const double z_origin = grid.origin.z;
+  const double x_res = grid.resolutions.x;
+  const double y_res = grid.resolutions.y;
+  const double z_res = grid.resolutions.z;
+  const uint32_t x_size = grid.size_x;
+  const uint32_t y_size = grid.size_y;
+  const uint32_t z_size = grid.size_z;
 
   g_marked.clear();
   g_unknown.clear();
@@ -210,6 +207,43 @@ void voxelCallback(const nav2_msgs::msg::VoxelGrid::ConstSharedPtr grid)
     num_marked + num_unknown, timer.elapsed_time_in_seconds());
 }
 
+void voxelCallback(const nav2_msgs::msg::VoxelGrid::ConstSharedPtr grid)
+{
+  if (grid->data.empty()) {
+    RCLCPP_ERROR(g_node->get_logger(), "Received empty voxel grid");
+    return;
+  }
+
+  publishVoxelCloud(*grid);
+}
+
+// Voxel grid built from the deltas received since the last keyframe
+nav2_msgs::msg::VoxelGrid g_delta_grid;
+bool g_delta_synced = false;
+uint32_t g_delta_sequence = 0;
+
+void voxelDeltaCallback(const nav2_msgs::msg::VoxelGridDelta::ConstSharedPtr delta)
+{
+  // A delta only applies to the grid built from all previous ones
+  if (!delta->keyframe && (!g_delta_synced || delta->sequence != g_delta_sequence + 1)) {
+    if (g_delta_synced) {
+      RCLCPP_WARN(g_node->get_logger(), "Missed a voxel grid delta, waiting for a keyframe");
+      g_delta_synced = false;
+    }
+    return;
+  }
+
+  g_delta_synced = nav2_costmap_2d::applyVoxelGridDelta(*delta, g_delta_grid);
+  g_delta_sequence = delta->sequence;
+  if (!g_delta_synced) {
+    RCLCPP_WARN(
+      g_node->get_logger(), "Received a malformed voxel grid delta, waiting for a keyframe");
+    return;
+  }
+
+  publishVoxelCloud(g_delta_grid);
+}
+
 int main(int argc, char ** argv)
 {
   rclcpp::init(argc, argv);
@@ -223,6 +257,9 @@ int main(int argc, char ** argv)
     "voxel_unknown_cloud", 1);
   auto sub = g_node->create_subscription<nav2_msgs::msg::VoxelGrid>(
     "voxel_grid", rclcpp::SystemDefaultsQoS(), voxelCallback);
+  auto delta_sub = g_node->create_subscription<nav2_msgs::msg::VoxelGridDelta>(
+    "voxel_grid_deltas", rclcpp::QoS(rclcpp::KeepLast(1)).transient_local().reliable(),
+    voxelDeltaCallback);
 
   rclcpp::spin(g_node->get_node_base_interface());
 
@@ -44,6 +44,8 @@
 #include "rclcpp/rclcpp.hpp"
 #include "visualization_msgs/msg/marker.hpp"
 #include "nav2_msgs/msg/voxel_grid.hpp"
+#include "nav2_msgs/msg/voxel_grid_delta.hpp"
+#include "nav2_costmap_2d/voxel_grid_delta.hpp"
 #include "nav2_voxel_grid/voxel_grid.hpp"
 #include "nav2_util/execution_timer.hpp"
 
@@ -65,30 +67,25 @@ V_Cell g_cells;
 rclcpp::Node::SharedPtr g_node;
 rclcpp::Publisher<visualization_msgs::msg::Marker>::SharedPtr pub;
 
-void voxelCallback(const nav2_msgs::msg::VoxelGrid::ConstSharedPtr grid)
+void publishVoxelMarkers(const nav2_msgs::msg::VoxelGrid & grid)
 {
-  if (grid->data.empty()) {
-    RCLCPP_ERROR(g_node->get_logger(), "Received voxel grid");
-    return;
-  }
-
   nav2_util::ExecutionTimer timer;
   timer.start();
 
   RCLCPP_DEBUG(g_node->get_logger(), "Received voxel grid");
 
-  const std::string frame_id = grid->header.frame_id;
-  const rclcpp::Time stamp = grid->header.stamp;
-  const uint32_t * data = &grid->data.front();
-  const double x_origin = grid->origin.x;
-  const double y_origin = grid->origin.y;
-  const double z_origin = grid->origin.z;
-  const double x_res = grid->resolutions.x;
-  const double y_res = grid->resolutions.y;
-  const double z_res = grid->resolutions.z;
-  const uint32_t x_size = grid->size_x;
-  const uint32_t y_size = grid->size_y;
-  const uint32_t z_size = grid->size_z;
+  const std::string frame_id = grid.header.frame_id;
+  const rclcpp::Time stamp = grid.header.stamp;
+  const uint32_t * data = grid.data.data();
+  const double x_origin = grid.origin.x;
+  const double y_origin = grid.origin.y;
+  const double z_origin = grid.origin.z;
+  const double x_res = grid.resolutions.x;
+  const double y_res = grid.resolutions.y;
+  const double z_res = grid.resolutions.z;
+  const uint32_t x_size = grid.size_x;
+  const uint32_t y_size = grid.size_y;
+  const uint32_t z_size = grid.size_z;
 
   g_cells.clear();
   uint32_t num_markers = 0;
@@ -145,6 +142,43 @@ void voxelCallback(const nav2_msgs::msg::VoxelGrid::ConstSharedPtr grid)
     num_markers, timer.elapsed_time_in_seconds());
 }
 
+void voxelCallback(const nav2_msgs::msg::VoxelGrid::ConstSharedPtr grid)
+{
+  if (grid->data.empty()) {
+    RCLCPP_ERROR(g_node->get_logger(), "Received empty voxel grid");
+    return;
+  }
+
+  publishVoxelMarkers(*grid);
+}
+
+// Voxel grid built from the deltas received since the last keyframe
+nav2_msgs::msg::VoxelGrid g_delta_grid;
+bool g_delta_synced = false;
+uint32_t g_delta_sequence = 0;
+
+void voxelDeltaCallback(const nav2_msgs::msg::VoxelGridDelta::ConstSharedPtr delta)
+{
+  // A delta only applies to the grid built from all previous ones
+  if (!delta->keyframe && (!g_delta_synced || delta->sequence != g_delta_sequence + 1)) {
+    if (g_delta_synced) {
+      RCLCPP_WARN(g_node->get_logger(), "Missed a voxel grid delta, waiting for a keyframe");
+      g_delta_synced = false;
+    }
+    return;
+  }
+
+  g_delta_synced = nav2_costmap_2d::applyVoxelGridDelta(*delta, g_delta_grid);
+  g_delta_sequence = delta->sequence;
+  if (!g_delta_synced) {
+    RCLCPP_WARN(
+      g_node->get_logger(), "Received a malformed voxel grid delta, waiting for a keyframe");
+    return;
+  }
+
+  publishVoxelMarkers(g_delta_grid);
+}
+
 int main(int argc, char ** argv)
 {
   rclcpp::init(argc, argv);
@@ -157,6 +191,9 @@ int main(int argc, char ** argv)
 
   auto sub = g_node->create_subscription<nav2_msgs::msg::VoxelGrid>(
     "voxel_grid", rclcpp::SystemDefaultsQoS(), voxelCallback);
+  auto delta_sub = g_node->create_subscription<nav2_msgs::msg::VoxelGridDelta>(
+    "voxel_grid_deltas", rclcpp::QoS(rclcpp::KeepLast(1)).transient_local().reliable(),
+    voxelDeltaCallback);
 
   rclcpp::spin(g_node->get_node_base_interface());
 }
@@ -38,16 +38,40 @@
  *********************************************************************/
 #include "nav2_costmap_2d/costmap_2d_publisher.hpp"
 
+#include <algorithm>
 #include <string>
 #include <memory>
 #include <utility>
 
 #include "nav2_costmap_2d/cost_values.hpp"
+#include "nav2_costmap_2d/costmap_delta.hpp"
 
 namespace nav2_costmap_2d
 {
 
-char * Costmap2DPublisher::cost_translation_table_ = NULL;
+const nav2_util::ByteTranslationTable<int8_t> Costmap2DPublisher::cost_translation_table_ =
+  nav2_util::makeByteTranslationTable<int8_t>(
+  [](unsigned char cost) -> int {
+    // special values:
+    switch (cost) {
+      case FREE_SPACE:
+        return 0;  // NO obstacle
+      case INSCRIBED_INFLATED_OBSTACLE:
+        return 99;  // INSCRIBED obstacle
+      case LETHAL_OBSTACLE:
+        return 100;  // LETHAL obstacle
+      case NO_INFORMATION:
+        return -1;  // UNKNOWN
+    }
+    // regular cost values scale the range 1 to 252 (inclusive) to fit
+    // into 1 to 98 (inclusive).
+    return 1 + (97 * (cost - 1)) / 251;
+  });
+
+// Tiles are small enough to keep sparse changes cheap and large enough to amortize their index
+static constexpr unsigned int DELTA_TILE_SIZE = 32;
+// Deltas between keyframes, bounds how long a receiver which missed one stays out of sync
+static constexpr unsigned int DELTA_KEYFRAME_INTERVAL = 100;
 
 Costmap2DPublisher::Costmap2DPublisher(
   const nav2_util::LifecycleNode::WeakPtr & parent,
@@ -78,6 +102,8 @@ Costmap2DPublisher::Costmap2DPublisher(
     topic_name + "_updates", custom_qos);
   costmap_raw_update_pub_ = node->create_publisher<nav2_msgs::msg::CostmapUpdate>(
     topic_name + "_raw_updates", custom_qos);
+  costmap_raw_delta_pub_ = node->create_publisher<nav2_msgs::msg::CostmapDelta>(
+    topic_name + "_raw_deltas", custom_qos);
 
   // Create a service that will use the callback function to handle requests.
   costmap_service_ = node->create_service<nav2_msgs::srv::GetCostmap>(
@@ -86,22 +112,6 @@ Costmap2DPublisher::Costmap2DPublisher(
       this, std::placeholders::_1, std::placeholders::_2,
       std::placeholders::_3));
 
-  if (cost_translation_table_ == NULL) {
-    cost_translation_table_ = new char[256];
-
-    // special values:
-    cost_translation_table_[0] = 0;  // NO obstacle
-    cost_translation_table_[253] = 99;  // INSCRIBED obstacle
-    cost_translation_table_[254] = 100;  // LETHAL obstacle
-    cost_translation_table_[255] = -1;  // UNKNOWN
-
-    // regular cost values scale the range 1 to 252 (inclusive) to fit
-    // into 1 to 98 (inclusive).
-    for (int i = 1; i < 253; i++) {
-      cost_translation_table_[i] = static_cast<char>(1 + (97 * (i - 1)) / 251);
-    }
-  }
-
   xn_ = yn_ = 0;
   x0_ = costmap_->getSizeInCellsX();
   y0_ = costmap_->getSizeInCellsY();
@@ -151,10 +161,8 @@ void Costmap2DPublisher::prepareGrid()
 
   grid_->data.resize(grid_->info.width * grid_->info.height);
 
-  unsigned char * data = costmap_->getCharMap();
-  for (unsigned int i = 0; i < grid_->data.size(); i++) {
-    grid_->data[i] = cost_translation_table_[data[i]];
-  }
+  nav2_util::translateValues(
+    cost_translation_table_, costmap_->getCharMap(), grid_->data.size(), grid_->data.data());
 }
 
 void Costmap2DPublisher::prepareCostmap()
@@ -183,9 +191,7 @@ void Costmap2DPublisher::prepareCostmap()
   costmap_raw_->data.resize(costmap_raw_->metadata.size_x * costmap_raw_->metadata.size_y);
 
   unsigned char * data = costmap_->getCharMap();
-  for (unsigned int i = 0; i < costmap_raw_->data.size(); i++) {
-    costmap_raw_->data[i] = data[i];
-  }
+  std::copy_n(data, costmap_raw_->data.size(), costmap_raw_->data.begin());
 }
 
 std::unique_ptr<map_msgs::msg::OccupancyGridUpdate> Costmap2DPublisher::createGridUpdateMsg()
@@ -200,11 +206,12 @@ std::unique_ptr<map_msgs::msg::OccupancyGridUpdate> Costmap2DPublisher::createGr
   update->height = yn_ - y0_;
   update->data.resize(update->width * update->height);
 
-  std::uint32_t i = 0;
+  const unsigned char * data = costmap_->getCharMap();
+  const unsigned int size_x = costmap_->getSizeInCellsX();
   for (std::uint32_t y = y0_; y < yn_; y++) {
-    for (std::uint32_t x = x0_; x < xn_; x++) {
-      update->data[i++] = cost_translation_table_[costmap_->getCost(x, y)];
-    }
+    nav2_util::translateValues(
+      cost_translation_table_, data + y * size_x + x0_, update->width,
+      update->data.data() + (y - y0_) * update->width);
   }
   return update;
 }
@@ -230,6 +237,30 @@ std::unique_ptr<nav2_msgs::msg::CostmapUpdate> Costmap2DPublisher::createCostmap
   return msg;
 }
 
+std::unique_ptr<nav2_msgs::msg::CostmapDelta> Costmap2DPublisher::createCostmapDeltaMsg()
+{
+  auto msg = std::make_unique<nav2_msgs::msg::CostmapDelta>();
+
+  // New subscribers and receivers that missed a delta need a keyframe to start from
+  const size_t subscribers = costmap_raw_delta_pub_->get_subscription_count();
+  const bool keyframe = subscribers > delta_subscribers_ ||
+    deltas_since_keyframe_ + 1 >= DELTA_KEYFRAME_INTERVAL ||
+    delta_origin_x_ != costmap_->getOriginX() || delta_origin_y_ != costmap_->getOriginY() ||
+    delta_resolution_ != costmap_->getResolution();
+  delta_subscribers_ = subscribers;
+  delta_origin_x_ = costmap_->getOriginX();
+  delta_origin_y_ = costmap_->getOriginY();
+  delta_resolution_ = costmap_->getResolution();
+
+  msg->header.stamp = clock_->now();
+  msg->header.frame_id = global_frame_;
+  msg->sequence = delta_sequence_++;
+  createCostmapDelta(*costmap_, delta_reference_, keyframe, DELTA_TILE_SIZE, *msg);
+  msg->metadata.update_time = msg->header.stamp;
+  deltas_since_keyframe_ = msg->keyframe ? 0 : deltas_since_keyframe_ + 1;
+  return msg;
+}
+
 void Costmap2DPublisher::publishCostmap()
 {
   float resolution = costmap_->getResolution();
@@ -259,6 +290,16 @@ void Costmap2DPublisher::publishCostmap()
     }
   }
 
+  if (costmap_raw_delta_pub_->get_subscription_count() > 0) {
+    std::unique_lock<Costmap2D::mutex_t> lock(*(costmap_->getMutex()));
+    costmap_raw_delta_pub_->publish(createCostmapDeltaMsg());
+  } else if (!delta_reference_.empty()) {
+    // The next subscriber starts with a keyframe
+    delta_reference_.clear();
+    delta_reference_.shrink_to_fit();
+    delta_subscribers_ = 0;
+  }
+
   xn_ = yn_ = 0;
   x0_ = costmap_->getSizeInCellsX();
   y0_ = costmap_->getSizeInCellsY();
@@ -38,15 +38,21 @@
 
 #include "nav2_costmap_2d/costmap_2d_ros.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <memory>
 #include <chrono>
+#include <future>
 #include <string>
 #include <vector>
 #include <utility>
 
+#include "nav2_costmap_2d/costmap_registry.hpp"
+#include "nav2_costmap_2d/costmap_snapshot.hpp"
 #include "nav2_costmap_2d/layered_costmap.hpp"
 #include "nav2_util/execution_timer.hpp"
 #include "nav2_util/node_utils.hpp"
+#include "nav2_util/tracing.hpp"
 #include "tf2_geometry_msgs/tf2_geometry_msgs.hpp"
 #include "tf2_ros/create_timer_ros.h"
 #include "nav2_util/robot_utils.hpp"
@@ -114,11 +120,19 @@ void Costmap2DROS::init()
   declare_parameter("footprint", rclcpp::ParameterValue(std::string("[]")));
   declare_parameter("global_frame", rclcpp::ParameterValue(std::string("map")));
   declare_parameter("height", rclcpp::ParameterValue(5));
+  declare_parameter("inner_window.width", rclcpp::ParameterValue(0.0));
+  declare_parameter("inner_window.height", rclcpp::ParameterValue(0.0));
+  declare_parameter("inner_window.resolution", rclcpp::ParameterValue(0.025));
   declare_parameter("width", rclcpp::ParameterValue(5));
   declare_parameter("lethal_cost_threshold", rclcpp::ParameterValue(100));
   declare_parameter("observation_sources", rclcpp::ParameterValue(std::string("")));
   declare_parameter("origin_x", rclcpp::ParameterValue(0.0));
   declare_parameter("origin_y", rclcpp::ParameterValue(0.0));
+  declare_parameter("parallel_layer_updates", rclcpp::ParameterValue(false));
+  declare_parameter("parallel_plugin_initialization", rclcpp::ParameterValue(false));
+  declare_parameter("threaded_publishing", rclcpp::ParameterValue(false));
+  declare_parameter("deferrable_layers", rclcpp::ParameterValue(std::vector<std::string>()));
+  declare_parameter("max_layer_decimation", rclcpp::ParameterValue(4));
   declare_parameter("plugins", rclcpp::ParameterValue(default_plugins_));
   declare_parameter("filters", rclcpp::ParameterValue(std::vector<std::string>()));
   declare_parameter("publish_frequency", rclcpp::ParameterValue(1.0));
@@ -126,8 +140,11 @@ void Costmap2DROS::init()
   declare_parameter("robot_base_frame", rclcpp::ParameterValue(std::string("base_link")));
   declare_parameter("robot_radius", rclcpp::ParameterValue(0.1));
   declare_parameter("rolling_window", rclcpp::ParameterValue(false));
+  declare_parameter("share_costmap_intra_process", rclcpp::ParameterValue(false));
   declare_parameter("track_unknown_space", rclcpp::ParameterValue(false));
   declare_parameter("transform_tolerance", rclcpp::ParameterValue(0.3));
+  declare_parameter("use_robot_pose_cache", rclcpp::ParameterValue(false));
+  declare_parameter("wait_for_first_update", rclcpp::ParameterValue(true));
   declare_parameter("initial_transform_timeout", rclcpp::ParameterValue(60.0));
   declare_parameter("trinary_costmap", rclcpp::ParameterValue(true));
   declare_parameter("unknown_cost_value", rclcpp::ParameterValue(static_cast<unsigned char>(0xff)));
@@ -137,6 +154,9 @@ void Costmap2DROS::init()
 
 Costmap2DROS::~Costmap2DROS()
 {
+  if (!shared_topic_name_.empty()) {
+    CostmapRegistry::remove(shared_topic_name_);
+  }
 }
 
 nav2_util::CallbackReturn
@@ -157,6 +177,7 @@ Costmap2DROS::on_configure(const rclcpp_lifecycle::State & /*state*/)
   // Create the costmap itself
   layered_costmap_ = std::make_unique<LayeredCostmap>(
     global_frame_, rolling_window_, track_unknown_space_);
+  layered_costmap_->setParallelLayerUpdates(parallel_layer_updates_);
 
   if (!layered_costmap_->isSizeLocked()) {
     layered_costmap_->resizeMap(
@@ -164,6 +185,21 @@ Costmap2DROS::on_configure(const rclcpp_lifecycle::State & /*state*/)
       (unsigned int)(map_height_meters_ / resolution_), resolution_, origin_x_, origin_y_);
   }
 
+  // The inner window rolls with the robot at a finer resolution, updated by instances of
+  // the same layers and filters of its own, configured by the same parameters
+  if (inner_window_width_ > 0.0 && inner_window_height_ > 0.0) {
+    inner_layered_costmap_ = std::make_unique<LayeredCostmap>(
+      global_frame_, true, track_unknown_space_);
+    inner_layered_costmap_->setParallelLayerUpdates(parallel_layer_updates_);
+    inner_layered_costmap_->resizeMap(
+      (unsigned int)(inner_window_width_ / inner_window_resolution_),
+      (unsigned int)(inner_window_height_ / inner_window_resolution_),
+      inner_window_resolution_, 0.0, 0.0);
+  }
+  multi_resolution_costmap_ = std::make_shared<MultiResolutionCostmap>(
+    layered_costmap_->getCostmap(),
+    inner_layered_costmap_ ? inner_layered_costmap_->getCostmap() : nullptr);
+
   // Create the transform-related objects
   tf_buffer_ = std::make_shared<tf2_ros::Buffer>(get_clock());
   auto timer_interface = std::make_shared<tf2_ros::CreateTimerROS>(
@@ -172,45 +208,24 @@ Costmap2DROS::on_configure(const rclcpp_lifecycle::State & /*state*/)
     callback_group_);
   tf_buffer_->setCreateTimerInterface(timer_interface);
   tf_listener_ = std::make_shared<tf2_ros::TransformListener>(*tf_buffer_);
-
-  // Then load and add the plug-ins to the costmap
-  for (unsigned int i = 0; i < plugin_names_.size(); ++i) {
-    RCLCPP_INFO(get_logger(), "Using plugin \"%s\"", plugin_names_[i].c_str());
-
-    std::shared_ptr<Layer> plugin = plugin_loader_.createSharedInstance(plugin_types_[i]);
-
-    // lock the costmap because no update is allowed until the plugin is initialized
-    std::unique_lock<Costmap2D::mutex_t> lock(*(layered_costmap_->getCostmap()->getMutex()));
-
-    layered_costmap_->addPlugin(plugin);
-
-    // TODO(mjeronimo): instead of get(), use a shared ptr
-    plugin->initialize(
-      layered_costmap_.get(), plugin_names_[i], tf_buffer_.get(),
-      shared_from_this(), callback_group_);
-
-    lock.unlock();
-
-    RCLCPP_INFO(get_logger(), "Initialized plugin \"%s\"", plugin_names_[i].c_str());
+  if (use_robot_pose_cache_) {
+    std::atomic_store(
+      &robot_pose_cache_,
+      nav2_util::RobotPoseCache::acquire(
+        get_node_topics_interface(), get_clock(), global_frame_, robot_base_frame_));
   }
-  // and costmap filters as well
-  for (unsigned int i = 0; i < filter_names_.size(); ++i) {
-    RCLCPP_INFO(get_logger(), "Using costmap filter \"%s\"", filter_names_[i].c_str());
-
-    std::shared_ptr<Layer> filter = plugin_loader_.createSharedInstance(filter_types_[i]);
 
-    // lock the costmap because no update is allowed until the filter is initialized
-    std::unique_lock<Costmap2D::mutex_t> lock(*(layered_costmap_->getCostmap()->getMutex()));
-
-    layered_costmap_->addFilter(filter);
-
-    filter->initialize(
-      layered_costmap_.get(), filter_names_[i], tf_buffer_.get(),
-      shared_from_this(), callback_group_);
-
-    lock.unlock();
-
-    RCLCPP_INFO(get_logger(), "Initialized costmap filter \"%s\"", filter_names_[i].c_str());
+  for (LayeredCostmap * layered_costmap : getLayeredCostmaps()) {
+    if (parallel_plugin_initialization_) {
+      try {
+        initializePluginsInParallel(layered_costmap);
+      } catch (const std::exception & e) {
+        RCLCPP_ERROR(get_logger(), "Failed to initialize costmap plugins! %s.", e.what());
+        return nav2_util::CallbackReturn::FAILURE;
+      }
+    } else {
+      initializePlugins(layered_costmap);
+    }
   }
 
   // Create the publishers and subscribers
@@ -222,16 +237,42 @@ Costmap2DROS::on_configure(const rclcpp_lifecycle::State & /*state*/)
   footprint_pub_ = create_publisher<geometry_msgs::msg::PolygonStamped>(
     "published_footprint", rclcpp::SystemDefaultsQoS());
 
+  update_load_pub_ = create_publisher<std_msgs::msg::Float32>(
+    "update_load", rclcpp::SystemDefaultsQoS());
+
+  // Only the layers listed may be decimated under load, the others are updated every cycle
+  layer_decimation_ = 1;
+  layer_decimations_.assign(deferrable_layers_.size(), 1);
+  for (const auto & layer_name : deferrable_layers_) {
+    if (inner_layered_costmap_) {
+      inner_layered_costmap_->setLayerDecimation(layer_name, 1);
+    }
+    if (!layered_costmap_->setLayerDecimation(layer_name, 1)) {
+      RCLCPP_WARN(
+        get_logger(), "Deferrable layer \"%s\" is not a layer or filter of the costmap",
+        layer_name.c_str());
+    }
+  }
+
   costmap_publisher_ = std::make_unique<Costmap2DPublisher>(
     shared_from_this(),
     layered_costmap_->getCostmap(), global_frame_,
     "costmap", always_send_full_costmap_);
 
+  // Sent whole, being small
+  if (inner_layered_costmap_) {
+    inner_costmap_publisher_ = std::make_unique<Costmap2DPublisher>(
+      shared_from_this(),
+      inner_layered_costmap_->getCostmap(), global_frame_,
+      "inner_costmap", true);
+  }
+
   auto layers = layered_costmap_->getPlugins();
 
   for (auto & layer : *layers) {
     auto costmap_layer = std::dynamic_pointer_cast<CostmapLayer>(layer);
-    if (costmap_layer != nullptr) {
+    // Layers keeping packed costs have no bytes to publish
+    if (costmap_layer != nullptr && costmap_layer->getCharMap() != nullptr) {
       layer_publishers_.emplace_back(
         std::make_unique<Costmap2DPublisher>(
           shared_from_this(),
@@ -252,10 +293,16 @@ Costmap2DROS::on_configure(const rclcpp_lifecycle::State & /*state*/)
 
   // Add cleaning service
   clear_costmap_service_ = std::make_unique<ClearCostmapService>(shared_from_this(), *this);
+  save_snapshot_service_ = create_service<nav2_msgs::srv::SaveCostmapSnapshot>(
+    std::string("save_snapshot_") + get_name(),
+    std::bind(
+      &Costmap2DROS::saveSnapshotCallback, this,
+      std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
 
   executor_ = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
   executor_->add_callback_group(callback_group_, get_node_base_interface());
-  executor_thread_ = std::make_unique<nav2_util::NodeThread>(executor_);
+  executor_thread_ = std::make_unique<nav2_util::NodeThread>(
+    executor_, executor_thread_settings_);
   return nav2_util::CallbackReturn::SUCCESS;
 }
 
@@ -302,12 +349,34 @@ Costmap2DROS::on_activate(const rclcpp_lifecycle::State & /*state*/)
 
   // Activate publishers
   footprint_pub_->on_activate();
+  update_load_pub_->on_activate();
   costmap_publisher_->on_activate();
+  if (inner_costmap_publisher_) {
+    inner_costmap_publisher_->on_activate();
+  }
 
   for (auto & layer_pub : layer_publishers_) {
     layer_pub->on_activate();
   }
 
+  if (threaded_publishing_) {
+    publish_thread_shutdown_ = false;
+    publish_requested_ = false;
+    publish_thread_ = std::make_unique<std::thread>(&Costmap2DROS::publishLoop, this);
+  }
+
+  // Let subscribers in this process read the master costmap's snapshots in place
+  if (share_costmap_intra_process_) {
+    shared_topic_name_ = get_node_topics_interface()->resolve_topic_name("costmap_raw");
+    CostmapRegistry::add(
+      shared_topic_name_, [this]() -> std::shared_ptr<const Costmap2D> {
+        if (!layered_costmap_->isInitialized()) {
+          return nullptr;
+        }
+        return layered_costmap_->getCostmapSnapshot();
+      });
+  }
+
   // Create a thread to handle updating the map
   stopped_ = true;  // to active plugins
   stop_updates_ = false;
@@ -315,7 +384,8 @@ Costmap2DROS::on_activate(const rclcpp_lifecycle::State & /*state*/)
   map_update_thread_ = std::make_unique<std::thread>(
     std::bind(&Costmap2DROS::mapUpdateLoop, this, map_update_frequency_));
 
-  start();
+  // Without waiting, the costmap is not current until the update thread completed an update
+  start(wait_for_first_update_);
 
   // Add callback for dynamic parameters
   dyn_params_handler = this->add_on_set_parameters_callback(
@@ -331,6 +401,11 @@ Costmap2DROS::on_deactivate(const rclcpp_lifecycle::State & /*state*/)
 
   dyn_params_handler.reset();
 
+  if (!shared_topic_name_.empty()) {
+    CostmapRegistry::remove(shared_topic_name_);
+    shared_topic_name_.clear();
+  }
+
   stop();
 
   // Map thread stuff
@@ -340,8 +415,22 @@ Costmap2DROS::on_deactivate(const rclcpp_lifecycle::State & /*state*/)
     map_update_thread_->join();
   }
 
+  if (publish_thread_) {
+    {
+      std::lock_guard<std::mutex> lock(publish_mutex_);
+      publish_thread_shutdown_ = true;
+    }
+    publish_cv_.notify_one();
+    publish_thread_->join();
+    publish_thread_.reset();
+  }
+
   footprint_pub_->on_deactivate();
+  update_load_pub_->on_deactivate();
   costmap_publisher_->on_deactivate();
+  if (inner_costmap_publisher_) {
+    inner_costmap_publisher_->on_deactivate();
+  }
 
   for (auto & layer_pub : layer_publishers_) {
     layer_pub->on_deactivate();
@@ -357,17 +446,23 @@ Costmap2DROS::on_cleanup(const rclcpp_lifecycle::State & /*state*/)
   executor_thread_.reset();
 
   costmap_publisher_.reset();
+  inner_costmap_publisher_.reset();
   clear_costmap_service_.reset();
+  save_snapshot_service_.reset();
 
   layer_publishers_.clear();
 
+  multi_resolution_costmap_.reset();
+  inner_layered_costmap_.reset();
   layered_costmap_.reset();
 
+  std::atomic_store(&robot_pose_cache_, std::shared_ptr<nav2_util::RobotPoseCache>());
   tf_listener_.reset();
   tf_buffer_.reset();
 
   footprint_sub_.reset();
   footprint_pub_.reset();
+  update_load_pub_.reset();
 
   return nav2_util::CallbackReturn::SUCCESS;
 }
@@ -390,20 +485,33 @@ Costmap2DROS::getParameters()
   get_parameter("footprint_padding", footprint_padding_);
   get_parameter("global_frame", global_frame_);
   get_parameter("height", map_height_meters_);
+  get_parameter("inner_window.width", inner_window_width_);
+  get_parameter("inner_window.height", inner_window_height_);
+  get_parameter("inner_window.resolution", inner_window_resolution_);
   get_parameter("origin_x", origin_x_);
   get_parameter("origin_y", origin_y_);
+  get_parameter("parallel_layer_updates", parallel_layer_updates_);
+  get_parameter("parallel_plugin_initialization", parallel_plugin_initialization_);
+  get_parameter("threaded_publishing", threaded_publishing_);
+  get_parameter("deferrable_layers", deferrable_layers_);
+  get_parameter("max_layer_decimation", max_layer_decimation_);
   get_parameter("publish_frequency", map_publish_frequency_);
   get_parameter("resolution", resolution_);
   get_parameter("robot_base_frame", robot_base_frame_);
   get_parameter("robot_radius", robot_radius_);
   get_parameter("rolling_window", rolling_window_);
+  get_parameter("share_costmap_intra_process", share_costmap_intra_process_);
   get_parameter("track_unknown_space", track_unknown_space_);
   get_parameter("transform_tolerance", transform_tolerance_);
+  get_parameter("use_robot_pose_cache", use_robot_pose_cache_);
+  get_parameter("wait_for_first_update", wait_for_first_update_);
   get_parameter("initial_transform_timeout", initial_transform_timeout_);
   get_parameter("update_frequency", map_update_frequency_);
   get_parameter("width", map_width_meters_);
   get_parameter("plugins", plugin_names_);
   get_parameter("filters", filter_names_);
+  executor_thread_settings_ = nav2_util::declareThreadSettings(this, "executor_thread");
+  map_update_thread_settings_ = nav2_util::declareThreadSettings(this, "map_update_thread");
 
   auto node = shared_from_this();
 
@@ -424,6 +532,14 @@ Costmap2DROS::getParameters()
     filter_types_[i] = nav2_util::get_plugin_type_param(node, filter_names_[i]);
   }
 
+  // Deferrable layers may be given a time budget per update, 0 for none
+  layer_time_budgets_.assign(deferrable_layers_.size(), 0.0);
+  for (size_t i = 0; i < deferrable_layers_.size(); ++i) {
+    nav2_util::declare_parameter_if_not_declared(
+      node, deferrable_layers_[i] + ".time_budget", rclcpp::ParameterValue(0.0));
+    get_parameter(deferrable_layers_[i] + ".time_budget", layer_time_budgets_[i]);
+  }
+
   // 2. The map publish frequency cannot be 0 (to avoid a divde-by-zero)
   if (map_publish_frequency_ > 0) {
     publish_cycle_ = rclcpp::Duration::from_seconds(1 / map_publish_frequency_);
@@ -459,6 +575,16 @@ Costmap2DROS::getParameters()
       get_logger(), "You try to set height of map to be negative or zero,"
       " this isn't allowed, please give a positive value.");
   }
+
+  // 5. The inner window rolls with the robot, within a rolling costmap
+  if (inner_window_width_ > 0.0 && inner_window_height_ > 0.0) {
+    if (!rolling_window_ || inner_window_resolution_ <= 0.0) {
+      RCLCPP_ERROR(
+        get_logger(), "An inner window needs a rolling window and a positive resolution, "
+        "using the costmap without it.");
+      inner_window_width_ = inner_window_height_ = 0.0;
+    }
+  }
 }
 
 void
@@ -467,7 +593,9 @@ Costmap2DROS::setRobotFootprint(const std::vector<geometry_msgs::msg::Point> & p
   unpadded_footprint_ = points;
   padded_footprint_ = points;
   padFootprint(padded_footprint_, footprint_padding_);
-  layered_costmap_->setFootprint(padded_footprint_);
+  for (LayeredCostmap * layered_costmap : getLayeredCostmaps()) {
+    layered_costmap->setFootprint(padded_footprint_);
+  }
 }
 
 void
@@ -503,10 +631,19 @@ Costmap2DROS::mapUpdateLoop(double frequency)
 
   RCLCPP_DEBUG(get_logger(), "Entering loop");
 
+  try {
+    nav2_util::applyThreadSettings(map_update_thread_settings_);
+  } catch (const std::runtime_error & ex) {
+    RCLCPP_ERROR(get_logger(), "Failed to set the map update thread scheduling: %s", ex.what());
+  }
+
   rclcpp::WallRate r(frequency);    // 200ms by default
+  const double period = 1.0 / frequency;
 
   while (rclcpp::ok() && !map_update_thread_shutdown_) {
     nav2_util::ExecutionTimer timer;
+    nav2_util::ExecutionTimer cycle_timer;
+    cycle_timer.start();
 
     // Execute after start() will complete plugins activation
     if (!stopped_) {
@@ -519,50 +656,176 @@ Costmap2DROS::mapUpdateLoop(double frequency)
       timer.end();
 
       RCLCPP_DEBUG(get_logger(), "Map update time: %.9f", timer.elapsed_time_in_seconds());
+      updateLoad(timer.elapsed_time_in_seconds(), period);
+
       if (publish_cycle_ > rclcpp::Duration(0s) && layered_costmap_->isInitialized()) {
         unsigned int x0, y0, xn, yn;
         layered_costmap_->getBounds(&x0, &xn, &y0, &yn);
-        costmap_publisher_->updateBounds(x0, xn, y0, yn);
-
-        for (auto & layer_pub : layer_publishers_) {
-          layer_pub->updateBounds(x0, xn, y0, yn);
-        }
 
         auto current_time = now();
-        if ((last_publish_ + publish_cycle_ < current_time) ||  // publish_cycle_ is due
-          (current_time <
-          last_publish_))      // time has moved backwards, probably due to a switch to sim_time // NOLINT
-        {
-          RCLCPP_DEBUG(get_logger(), "Publish costmap at %s", name_.c_str());
-          costmap_publisher_->publishCostmap();
-
+        const bool publish_due = (last_publish_ + publish_cycle_ < current_time) ||  // NOLINT
+          // time has moved backwards, probably due to a switch to sim_time
+          (current_time < last_publish_);
+
+        if (threaded_publishing_) {
+          // The publish thread publishes the window updated since its last publication
+          {
+            std::lock_guard<std::mutex> publish_lock(publish_mutex_);
+            if (publish_xn_ == 0 && publish_yn_ == 0) {
+              publish_x0_ = x0;
+              publish_y0_ = y0;
+            }
+            publish_x0_ = std::min(publish_x0_, x0);
+            publish_xn_ = std::max(publish_xn_, xn);
+            publish_y0_ = std::min(publish_y0_, y0);
+            publish_yn_ = std::max(publish_yn_, yn);
+            publish_requested_ = publish_requested_ || publish_due;
+          }
+          if (publish_due) {
+            publish_cv_.notify_one();
+          }
+        } else {
+          costmap_publisher_->updateBounds(x0, xn, y0, yn);
           for (auto & layer_pub : layer_publishers_) {
-            layer_pub->publishCostmap();
+            layer_pub->updateBounds(x0, xn, y0, yn);
+          }
+          if (inner_costmap_publisher_) {
+            inner_layered_costmap_->getBounds(&x0, &xn, &y0, &yn);
+            inner_costmap_publisher_->updateBounds(x0, xn, y0, yn);
           }
+          if (publish_due) {
+            publishCostmaps();
+          }
+        }
 
+        if (publish_due) {
+          auto load = std::make_unique<std_msgs::msg::Float32>();
+          load->data = static_cast<float>(update_load_.load());
+          update_load_pub_->publish(std::move(load));
           last_publish_ = current_time;
         }
       }
     }
 
+    cycle_timer.end();
+    if (!stopped_ && cycle_timer.elapsed_time_in_seconds() > period) {
+      RCLCPP_WARN_THROTTLE(
+        get_logger(), *get_clock(), 5000,
+        "Costmap2DROS: Map update loop missed its desired rate of %.4fHz... "
+        "the loop actually took %.4f seconds", frequency, cycle_timer.elapsed_time_in_seconds());
+    }
+
     // Make sure to sleep for the remainder of our cycle time
     r.sleep();
+  }
+}
 
-#if 0
-    // TODO(bpwilcox): find ROS2 equivalent or port for r.cycletime()
-    if (r.period() > tf2::durationFromSec(1 / frequency)) {
-      RCLCPP_WARN(
-        get_logger(),
-        "Costmap2DROS: Map update loop missed its desired rate of %.4fHz... "
-        "the loop actually took %.4f seconds", frequency, r.period());
+void
+Costmap2DROS::updateLoad(double update_time, double period)
+{
+  const double load = 0.8 * update_load_.load() + 0.2 * update_time / period;
+  update_load_ = load;
+  if (deferrable_layers_.empty()) {
+    return;
+  }
+
+  // Decimate the deferrable layers more when the updates take most of the period, and
+  // less once they leave plenty of it, so that the other layers keep up with the rate
+  const auto max_decimation = static_cast<unsigned int>(std::max(max_layer_decimation_, 1));
+  unsigned int decimation = layer_decimation_;
+  if (load > 0.9) {
+    decimation = std::min(decimation * 2, max_decimation);
+  } else if (load < 0.5) {
+    decimation = std::max(decimation / 2, 1u);
+  }
+  if (decimation != layer_decimation_) {
+    RCLCPP_INFO(
+      get_logger(), "Update load is %.2f, updating deferrable layers once every %u updates",
+      load, decimation);
+    layer_decimation_ = decimation;
+  }
+
+  // A layer whose updates take longer than its time budget is decimated further, to stay
+  // within it on average over the updates of the costmap
+  std::vector<unsigned int> decimations(deferrable_layers_.size(), layer_decimation_);
+  if (std::any_of(
+      layer_time_budgets_.begin(), layer_time_budgets_.end(),
+      [](double budget) {return budget > 0.0;}))
+  {
+    for (LayeredCostmap * layered_costmap : getLayeredCostmaps()) {
+      for (const auto & layer_time : layered_costmap->getLayerUpdateTimes()) {
+        for (size_t i = 0; i < deferrable_layers_.size(); ++i) {
+          if (deferrable_layers_[i] != layer_time.first || layer_time_budgets_[i] <= 0.0) {
+            continue;
+          }
+          const double over_budget = std::ceil(layer_time.second / layer_time_budgets_[i]);
+          decimations[i] = std::max(
+            decimations[i],
+            static_cast<unsigned int>(std::min(over_budget, static_cast<double>(max_decimation))));
+        }
+      }
+    }
+  }
+
+  for (size_t i = 0; i < deferrable_layers_.size(); ++i) {
+    if (decimations[i] == layer_decimations_[i]) {
+      continue;
+    }
+    RCLCPP_DEBUG(
+      get_logger(), "Updating deferrable layer %s once every %u updates",
+      deferrable_layers_[i].c_str(), decimations[i]);
+    layer_decimations_[i] = decimations[i];
+    for (LayeredCostmap * layered_costmap : getLayeredCostmaps()) {
+      layered_costmap->setLayerDecimation(deferrable_layers_[i], decimations[i]);
     }
-#endif
+  }
+}
+
+void
+Costmap2DROS::publishLoop()
+{
+  while (true) {
+    unsigned int x0, xn, y0, yn;
+    {
+      std::unique_lock<std::mutex> lock(publish_mutex_);
+      publish_cv_.wait(lock, [this]() {return publish_requested_ || publish_thread_shutdown_;});
+      if (publish_thread_shutdown_) {
+        return;
+      }
+      x0 = publish_x0_;
+      xn = publish_xn_;
+      y0 = publish_y0_;
+      yn = publish_yn_;
+      publish_xn_ = publish_yn_ = 0;
+      publish_requested_ = false;
+    }
+
+    costmap_publisher_->updateBounds(x0, xn, y0, yn);
+    for (auto & layer_pub : layer_publishers_) {
+      layer_pub->updateBounds(x0, xn, y0, yn);
+    }
+    publishCostmaps();
+  }
+}
+
+void
+Costmap2DROS::publishCostmaps()
+{
+  RCLCPP_DEBUG(get_logger(), "Publish costmap at %s", name_.c_str());
+  costmap_publisher_->publishCostmap();
+  if (inner_costmap_publisher_) {
+    inner_costmap_publisher_->publishCostmap();
+  }
+
+  for (auto & layer_pub : layer_publishers_) {
+    layer_pub->publishCostmap();
   }
 }
 
 void
 Costmap2DROS::updateMap()
 {
+  NAV2_TRACE_SCOPE("Costmap2DROS::updateMap");
   RCLCPP_DEBUG(get_logger(), "Updating map...");
 
   if (!stop_updates_) {
@@ -573,6 +836,9 @@ Costmap2DROS::updateMap()
       const double & y = pose.pose.position.y;
       const double yaw = tf2::getYaw(pose.pose.orientation);
       layered_costmap_->updateMap(x, y, yaw);
+      if (inner_layered_costmap_) {
+        inner_layered_costmap_->updateMap(x, y, yaw);
+      }
 
       auto footprint = std::make_unique<geometry_msgs::msg::PolygonStamped>();
       footprint->header = pose.header;
@@ -586,31 +852,114 @@ Costmap2DROS::updateMap()
 }
 
 void
-Costmap2DROS::start()
+Costmap2DROS::initializePlugins(LayeredCostmap * layered_costmap)
+{
+  // Load and add the plug-ins to the costmap
+  for (unsigned int i = 0; i < plugin_names_.size(); ++i) {
+    RCLCPP_INFO(get_logger(), "Using plugin \"%s\"", plugin_names_[i].c_str());
+
+    std::shared_ptr<Layer> plugin = plugin_loader_.createSharedInstance(plugin_types_[i]);
+
+    // lock the costmap because no update is allowed until the plugin is initialized
+    std::unique_lock<Costmap2D::mutex_t> lock(*(layered_costmap->getCostmap()->getMutex()));
+
+    layered_costmap->addPlugin(plugin);
+
+    // TODO(mjeronimo): instead of get(), use a shared ptr
+    plugin->initialize(
+      layered_costmap, plugin_names_[i], tf_buffer_.get(),
+      shared_from_this(), callback_group_);
+
+    lock.unlock();
+
+    RCLCPP_INFO(get_logger(), "Initialized plugin \"%s\"", plugin_names_[i].c_str());
+  }
+  // and costmap filters as well
+  for (unsigned int i = 0; i < filter_names_.size(); ++i) {
+    RCLCPP_INFO(get_logger(), "Using costmap filter \"%s\"", filter_names_[i].c_str());
+
+    std::shared_ptr<Layer> filter = plugin_loader_.createSharedInstance(filter_types_[i]);
+
+    // lock the costmap because no update is allowed until the filter is initialized
+    std::unique_lock<Costmap2D::mutex_t> lock(*(layered_costmap->getCostmap()->getMutex()));
+
+    layered_costmap->addFilter(filter);
+
+    filter->initialize(
+      layered_costmap, filter_names_[i], tf_buffer_.get(),
+      shared_from_this(), callback_group_);
+
+    lock.unlock();
+
+    RCLCPP_INFO(get_logger(), "Initialized costmap filter \"%s\"", filter_names_[i].c_str());
+  }
+}
+
+void
+Costmap2DROS::initializePluginsInParallel(LayeredCostmap * layered_costmap)
+{
+  // Loaded and added in order, since the order of the layers matters and the class loader
+  // is not thread safe, then initialized concurrently. No lock of the costmap is needed,
+  // as it is not updated before activation.
+  std::vector<std::pair<std::shared_ptr<Layer>, std::string>> layers;
+  for (unsigned int i = 0; i < plugin_names_.size(); ++i) {
+    RCLCPP_INFO(get_logger(), "Using plugin \"%s\"", plugin_names_[i].c_str());
+    std::shared_ptr<Layer> plugin = plugin_loader_.createSharedInstance(plugin_types_[i]);
+    layered_costmap->addPlugin(plugin);
+    layers.emplace_back(plugin, plugin_names_[i]);
+  }
+  for (unsigned int i = 0; i < filter_names_.size(); ++i) {
+    RCLCPP_INFO(get_logger(), "Using costmap filter \"%s\"", filter_names_[i].c_str());
+    std::shared_ptr<Layer> filter = plugin_loader_.createSharedInstance(filter_types_[i]);
+    layered_costmap->addFilter(filter);
+    layers.emplace_back(filter, filter_names_[i]);
+  }
+
+  std::vector<std::future<void>> initializations;
+  auto node = shared_from_this();
+  for (auto & layer : layers) {
+    initializations.push_back(
+      std::async(
+        std::launch::async, [this, &layer, node, layered_costmap]() {
+          layer.first->initialize(
+            layered_costmap, layer.second, tf_buffer_.get(), node, callback_group_);
+          RCLCPP_INFO(get_logger(), "Initialized \"%s\"", layer.second.c_str());
+        }));
+  }
+
+  // Wait for all of them before rethrowing the first failure, as they reference this node
+  for (auto & initialization : initializations) {
+    initialization.wait();
+  }
+  for (auto & initialization : initializations) {
+    initialization.get();
+  }
+}
+
+void
+Costmap2DROS::start(bool wait_for_update)
 {
   RCLCPP_INFO(get_logger(), "start");
-  std::vector<std::shared_ptr<Layer>> * plugins = layered_costmap_->getPlugins();
-  std::vector<std::shared_ptr<Layer>> * filters = layered_costmap_->getFilters();
 
   // check if we're stopped or just paused
   if (stopped_) {
     // if we're stopped we need to re-subscribe to topics
-    for (std::vector<std::shared_ptr<Layer>>::iterator plugin = plugins->begin();
-      plugin != plugins->end();
-      ++plugin)
-    {
-      (*plugin)->activate();
-    }
-    for (std::vector<std::shared_ptr<Layer>>::iterator filter = filters->begin();
-      filter != filters->end();
-      ++filter)
-    {
-      (*filter)->activate();
+    for (LayeredCostmap * layered_costmap : getLayeredCostmaps()) {
+      for (auto & plugin : *layered_costmap->getPlugins()) {
+        plugin->activate();
+      }
+      for (auto & filter : *layered_costmap->getFilters()) {
+        filter->activate();
+      }
     }
     stopped_ = false;
   }
   stop_updates_ = false;
 
+  if (!wait_for_update) {
+    return;
+  }
+
   // block until the costmap is re-initialized.. meaning one update cycle has run
   rclcpp::Rate r(20.0);
   while (rclcpp::ok() && !initialized_) {
@@ -625,20 +974,13 @@ Costmap2DROS::stop()
   stop_updates_ = true;
 
   // layered_costmap_ is set only if on_configure has been called
-  if (layered_costmap_) {
-    std::vector<std::shared_ptr<Layer>> * plugins = layered_costmap_->getPlugins();
-    std::vector<std::shared_ptr<Layer>> * filters = layered_costmap_->getFilters();
-
+  for (LayeredCostmap * layered_costmap : getLayeredCostmaps()) {
     // unsubscribe from topics
-    for (std::vector<std::shared_ptr<Layer>>::iterator plugin = plugins->begin();
-      plugin != plugins->end(); ++plugin)
-    {
-      (*plugin)->deactivate();
+    for (auto & plugin : *layered_costmap->getPlugins()) {
+      plugin->deactivate();
     }
-    for (std::vector<std::shared_ptr<Layer>>::iterator filter = filters->begin();
-      filter != filters->end(); ++filter)
-    {
-      (*filter)->deactivate();
+    for (auto & filter : *layered_costmap->getFilters()) {
+      filter->deactivate();
     }
   }
   initialized_ = false;
@@ -667,27 +1009,96 @@ Costmap2DROS::resume()
 void
 Costmap2DROS::resetLayers()
 {
-  Costmap2D * top = layered_costmap_->getCostmap();
-  top->resetMap(0, 0, top->getSizeInCellsX(), top->getSizeInCellsY());
-
-  // Reset each of the plugins
-  std::vector<std::shared_ptr<Layer>> * plugins = layered_costmap_->getPlugins();
-  std::vector<std::shared_ptr<Layer>> * filters = layered_costmap_->getFilters();
-  for (std::vector<std::shared_ptr<Layer>>::iterator plugin = plugins->begin();
-    plugin != plugins->end(); ++plugin)
-  {
-    (*plugin)->reset();
+  for (LayeredCostmap * layered_costmap : getLayeredCostmaps()) {
+    Costmap2D * top = layered_costmap->getCostmap();
+    top->resetMap(0, 0, top->getSizeInCellsX(), top->getSizeInCellsY());
+    layered_costmap->markAllCellsUpdated();
+
+    // Reset each of the plugins
+    for (auto & plugin : *layered_costmap->getPlugins()) {
+      plugin->reset();
+    }
+    for (auto & filter : *layered_costmap->getFilters()) {
+      filter->reset();
+    }
   }
-  for (std::vector<std::shared_ptr<Layer>>::iterator filter = filters->begin();
-    filter != filters->end(); ++filter)
+}
+
+void
+Costmap2DROS::saveSnapshotCallback(
+  const std::shared_ptr<rmw_request_id_t>/*request_header*/,
+  const std::shared_ptr<nav2_msgs::srv::SaveCostmapSnapshot::Request> request,
+  const std::shared_ptr<nav2_msgs::srv::SaveCostmapSnapshot::Response> response)
+{
+  nav2_msgs::msg::CostmapSnapshot snapshot;
+  snapshot.header.frame_id = global_frame_;
+  snapshot.header.stamp = now();
   {
-    (*filter)->reset();
+    Costmap2D * costmap = layered_costmap_->getCostmap();
+    std::unique_lock<Costmap2D::mutex_t> lock(*(costmap->getMutex()));
+    encodeCostmap(*costmap, snapshot.metadata, snapshot.data);
+  }
+  snapshot.metadata.update_time = snapshot.header.stamp;
+  snapshot.metadata.layer = "master";
+
+  for (auto & layer : *layered_costmap_->getPlugins()) {
+    auto costmap_layer = std::dynamic_pointer_cast<CostmapLayer>(layer);
+    // Layers keeping packed costs have no bytes to save
+    if (costmap_layer == nullptr || costmap_layer->getCharMap() == nullptr) {
+      continue;
+    }
+    nav2_msgs::msg::Costmap layer_msg;
+    layer_msg.header = snapshot.header;
+    {
+      std::unique_lock<Costmap2D::mutex_t> lock(*(costmap_layer->getMutex()));
+      encodeCostmap(*costmap_layer, layer_msg.metadata, layer_msg.data);
+    }
+    layer_msg.metadata.update_time = snapshot.header.stamp;
+    layer_msg.metadata.layer = layer->getName();
+    snapshot.layers.push_back(std::move(layer_msg));
+  }
+
+  snapshot.footprint = getRobotFootprintPolygon();
+  if (!getRobotPose(snapshot.robot_pose)) {
+    RCLCPP_WARN(get_logger(), "Saving a costmap snapshot without the pose of the robot");
+    snapshot.robot_pose = geometry_msgs::msg::PoseStamped();
   }
+  snapshot.path = request->path;
+
+  response->success = saveCostmapSnapshot(snapshot, request->filename);
+  if (response->success) {
+    RCLCPP_INFO(get_logger(), "Saved a costmap snapshot to %s", request->filename.c_str());
+  } else {
+    RCLCPP_ERROR(
+      get_logger(), "Failed to save a costmap snapshot to %s", request->filename.c_str());
+  }
+}
+
+std::vector<LayeredCostmap *>
+Costmap2DROS::getLayeredCostmaps()
+{
+  std::vector<LayeredCostmap *> layered_costmaps;
+  if (layered_costmap_) {
+    layered_costmaps.push_back(layered_costmap_.get());
+  }
+  if (inner_layered_costmap_) {
+    layered_costmaps.push_back(inner_layered_costmap_.get());
+  }
+  return layered_costmaps;
 }
 
 bool
 Costmap2DROS::getRobotPose(geometry_msgs::msg::PoseStamped & global_pose)
 {
+  // Serve the latest pose of the process if it is recent enough
+  auto robot_pose_cache = std::atomic_load(&robot_pose_cache_);
+  if (robot_pose_cache &&
+    robot_pose_cache->getPose(
+      global_pose, now(), rclcpp::Duration::from_seconds(transform_tolerance_)))
+  {
+    return true;
+  }
+
   return nav2_util::getCurrentPose(
     global_pose, *tf_buffer_,
     global_frame_, robot_base_frame_, transform_tolerance_);
@@ -730,7 +1141,9 @@ Costmap2DROS::dynamicParametersCallback(std::vector<rclcpp::Parameter> parameter
         footprint_padding_ = parameter.as_double();
         padded_footprint_ = unpadded_footprint_;
         padFootprint(padded_footprint_, footprint_padding_);
-        layered_costmap_->setFootprint(padded_footprint_);
+        for (LayeredCostmap * layered_costmap : getLayeredCostmaps()) {
+          layered_costmap->setFootprint(padded_footprint_);
+        }
       } else if (name == "transform_tolerance") {
         transform_tolerance_ = parameter.as_double();
       } else if (name == "publish_frequency") {
@@ -801,6 +1214,12 @@ Costmap2DROS::dynamicParametersCallback(std::vector<rclcpp::Parameter> parameter
           return result;
         }
         robot_base_frame_ = parameter.as_string();
+        if (use_robot_pose_cache_) {
+          std::atomic_store(
+            &robot_pose_cache_,
+            nav2_util::RobotPoseCache::acquire(
+              get_node_topics_interface(), get_clock(), global_frame_, robot_base_frame_));
+        }
       }
     }
   }
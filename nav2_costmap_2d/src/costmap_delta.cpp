@@ -0,0 +1,158 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_costmap_2d/costmap_delta.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace nav2_costmap_2d
+{
+
+void encodeCostmapWindow(
+  const unsigned char * costmap, unsigned int size_x,
+  unsigned int x0, unsigned int y0, unsigned int xn, unsigned int yn,
+  std::vector<unsigned char> & data)
+{
+  unsigned int count = 0;
+  unsigned char value = 0;
+  for (unsigned int y = y0; y < yn; y++) {
+    const unsigned char * row = costmap + y * size_x;
+    for (unsigned int x = x0; x < xn; x++) {
+      if (count != 0 && (row[x] != value || count == 255)) {
+        data.push_back(static_cast<unsigned char>(count));
+        data.push_back(value);
+        count = 0;
+      }
+      value = row[x];
+      count++;
+    }
+  }
+  if (count != 0) {
+    data.push_back(static_cast<unsigned char>(count));
+    data.push_back(value);
+  }
+}
+
+bool decodeCostmapWindow(
+  const std::vector<unsigned char> & data, size_t & offset,
+  unsigned char * costmap, unsigned int size_x,
+  unsigned int x0, unsigned int y0, unsigned int xn, unsigned int yn)
+{
+  unsigned int count = 0;
+  unsigned char value = 0;
+  for (unsigned int y = y0; y < yn; y++) {
+    unsigned char * row = costmap + y * size_x;
+    unsigned int x = x0;
+    while (x < xn) {
+      if (count == 0) {
+        if (offset + 2 > data.size() || data[offset] == 0) {
+          return false;
+        }
+        count = data[offset];
+        value = data[offset + 1];
+        offset += 2;
+      }
+      const unsigned int n = std::min(count, xn - x);
+      std::memset(row + x, value, n);
+      x += n;
+      count -= n;
+    }
+  }
+  // Runs never continue past the window
+  return count == 0;
+}
+
+void createCostmapDelta(
+  const Costmap2D & costmap, std::vector<unsigned char> & reference, bool keyframe,
+  unsigned int tile_size, nav2_msgs::msg::CostmapDelta & msg)
+{
+  const unsigned int size_x = costmap.getSizeInCellsX();
+  const unsigned int size_y = costmap.getSizeInCellsY();
+  const double resolution = costmap.getResolution();
+  const unsigned char * data = costmap.getCharMap();
+
+  msg.keyframe = keyframe || reference.size() != size_x * size_y;
+  msg.metadata.layer = "master";
+  msg.metadata.resolution = resolution;
+  msg.metadata.size_x = size_x;
+  msg.metadata.size_y = size_y;
+  msg.metadata.origin.position.x = costmap.getOriginX();
+  msg.metadata.origin.position.y = costmap.getOriginY();
+  msg.metadata.origin.position.z = 0.0;
+  msg.metadata.origin.orientation.w = 1.0;
+  msg.tile_size = tile_size;
+  msg.tiles.clear();
+  msg.data.clear();
+
+  if (msg.keyframe) {
+    reference.resize(size_x * size_y);
+  }
+
+  const unsigned int tiles_x = (size_x + tile_size - 1) / tile_size;
+  const unsigned int tiles_y = (size_y + tile_size - 1) / tile_size;
+  for (unsigned int ty = 0; ty < tiles_y; ty++) {
+    const unsigned int y0 = ty * tile_size;
+    const unsigned int yn = std::min(y0 + tile_size, size_y);
+    for (unsigned int tx = 0; tx < tiles_x; tx++) {
+      const unsigned int x0 = tx * tile_size;
+      const unsigned int xn = std::min(x0 + tile_size, size_x);
+
+      bool changed = msg.keyframe;
+      for (unsigned int y = y0; y < yn && !changed; y++) {
+        changed = std::memcmp(data + y * size_x + x0, &reference[y * size_x + x0], xn - x0) != 0;
+      }
+      if (!changed) {
+        continue;
+      }
+
+      msg.tiles.push_back(ty * tiles_x + tx);
+      encodeCostmapWindow(data, size_x, x0, y0, xn, yn, msg.data);
+      for (unsigned int y = y0; y < yn; y++) {
+        std::memcpy(&reference[y * size_x + x0], data + y * size_x + x0, xn - x0);
+      }
+    }
+  }
+}
+
+bool applyCostmapDelta(const nav2_msgs::msg::CostmapDelta & msg, Costmap2D & costmap)
+{
+  const unsigned int size_x = costmap.getSizeInCellsX();
+  const unsigned int size_y = costmap.getSizeInCellsY();
+  if (msg.metadata.size_x != size_x || msg.metadata.size_y != size_y || msg.tile_size == 0) {
+    return false;
+  }
+
+  const unsigned int tile_size = msg.tile_size;
+  const unsigned int tiles_x = (size_x + tile_size - 1) / tile_size;
+  const unsigned int tiles_y = (size_y + tile_size - 1) / tile_size;
+  unsigned char * data = costmap.getCharMap();
+  size_t offset = 0;
+  for (const unsigned int tile : msg.tiles) {
+    if (tile >= tiles_x * tiles_y) {
+      return false;
+    }
+    const unsigned int x0 = (tile % tiles_x) * tile_size;
+    const unsigned int y0 = (tile / tiles_x) * tile_size;
+    const unsigned int xn = std::min(x0 + tile_size, size_x);
+    const unsigned int yn = std::min(y0 + tile_size, size_y);
+    if (!decodeCostmapWindow(msg.data, offset, data, size_x, x0, y0, xn, yn)) {
+      return false;
+    }
+  }
+  return offset == msg.data.size();
+}
+
+}  // namespace nav2_costmap_2d
@@ -40,9 +40,165 @@
 #include <stdexcept>
 #include <algorithm>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 namespace nav2_costmap_2d
 {
 
+namespace
+{
+
+// Unknown cells are found with a bytewise compare against the all ones value
+static_assert(NO_INFORMATION == 255, "Combination kernels expect NO_INFORMATION to be 255");
+
+#if defined(__SSE2__)
+constexpr unsigned int VECTOR_WIDTH = 16;
+
+// Bytes of a where mask is set, of b elsewhere
+inline __m128i select(__m128i mask, __m128i a, __m128i b)
+{
+  return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+#elif defined(__ARM_NEON)
+constexpr unsigned int VECTOR_WIDTH = 16;
+#endif
+
+// Each kernel combines a row of n cells of a layer into the master, branch free so the
+// unknown cells are handled by selects over whole vectors, with a scalar tail
+inline void maxRow(unsigned char * master, const unsigned char * layer, unsigned int n)
+{
+  unsigned int k = 0;
+#if defined(__SSE2__)
+  const __m128i unknown = _mm_set1_epi8(static_cast<char>(NO_INFORMATION));
+  for (; k + VECTOR_WIDTH <= n; k += VECTOR_WIDTH) {
+    const __m128i old_cost = _mm_loadu_si128(reinterpret_cast<const __m128i *>(master + k));
+    const __m128i cost = _mm_loadu_si128(reinterpret_cast<const __m128i *>(layer + k));
+    const __m128i combined =
+      select(_mm_cmpeq_epi8(old_cost, unknown), cost, _mm_max_epu8(old_cost, cost));
+    _mm_storeu_si128(
+      reinterpret_cast<__m128i *>(master + k),
+      select(_mm_cmpeq_epi8(cost, unknown), old_cost, combined));
+  }
+#elif defined(__ARM_NEON)
+  const uint8x16_t unknown = vdupq_n_u8(NO_INFORMATION);
+  for (; k + VECTOR_WIDTH <= n; k += VECTOR_WIDTH) {
+    const uint8x16_t old_cost = vld1q_u8(master + k);
+    const uint8x16_t cost = vld1q_u8(layer + k);
+    const uint8x16_t combined =
+      vbslq_u8(vceqq_u8(old_cost, unknown), cost, vmaxq_u8(old_cost, cost));
+    vst1q_u8(master + k, vbslq_u8(vceqq_u8(cost, unknown), old_cost, combined));
+  }
+#endif
+  for (; k < n; k++) {
+    const unsigned char old_cost = master[k];
+    const unsigned char cost = layer[k];
+    const unsigned char combined = old_cost == NO_INFORMATION ? cost : std::max(old_cost, cost);
+    master[k] = cost == NO_INFORMATION ? old_cost : combined;
+  }
+}
+
+inline void maxWithoutUnknownOverwriteRow(
+  unsigned char * master, const unsigned char * layer, unsigned int n)
+{
+  unsigned int k = 0;
+#if defined(__SSE2__)
+  const __m128i unknown = _mm_set1_epi8(static_cast<char>(NO_INFORMATION));
+  for (; k + VECTOR_WIDTH <= n; k += VECTOR_WIDTH) {
+    const __m128i old_cost = _mm_loadu_si128(reinterpret_cast<const __m128i *>(master + k));
+    const __m128i cost = _mm_loadu_si128(reinterpret_cast<const __m128i *>(layer + k));
+    const __m128i keep =
+      _mm_or_si128(_mm_cmpeq_epi8(old_cost, unknown), _mm_cmpeq_epi8(cost, unknown));
+    _mm_storeu_si128(
+      reinterpret_cast<__m128i *>(master + k),
+      select(keep, old_cost, _mm_max_epu8(old_cost, cost)));
+  }
+#elif defined(__ARM_NEON)
+  const uint8x16_t unknown = vdupq_n_u8(NO_INFORMATION);
+  for (; k + VECTOR_WIDTH <= n; k += VECTOR_WIDTH) {
+    const uint8x16_t old_cost = vld1q_u8(master + k);
+    const uint8x16_t cost = vld1q_u8(layer + k);
+    const uint8x16_t keep = vorrq_u8(vceqq_u8(old_cost, unknown), vceqq_u8(cost, unknown));
+    vst1q_u8(master + k, vbslq_u8(keep, old_cost, vmaxq_u8(old_cost, cost)));
+  }
+#endif
+  for (; k < n; k++) {
+    const unsigned char old_cost = master[k];
+    const unsigned char cost = layer[k];
+    const bool keep = old_cost == NO_INFORMATION || cost == NO_INFORMATION;
+    master[k] = keep ? old_cost : std::max(old_cost, cost);
+  }
+}
+
+inline void overwriteRow(unsigned char * master, const unsigned char * layer, unsigned int n)
+{
+  unsigned int k = 0;
+#if defined(__SSE2__)
+  const __m128i unknown = _mm_set1_epi8(static_cast<char>(NO_INFORMATION));
+  for (; k + VECTOR_WIDTH <= n; k += VECTOR_WIDTH) {
+    const __m128i old_cost = _mm_loadu_si128(reinterpret_cast<const __m128i *>(master + k));
+    const __m128i cost = _mm_loadu_si128(reinterpret_cast<const __m128i *>(layer + k));
+    _mm_storeu_si128(
+      reinterpret_cast<__m128i *>(master + k),
+      select(_mm_cmpeq_epi8(cost, unknown), old_cost, cost));
+  }
+#elif defined(__ARM_NEON)
+  const uint8x16_t unknown = vdupq_n_u8(NO_INFORMATION);
+  for (; k + VECTOR_WIDTH <= n; k += VECTOR_WIDTH) {
+    const uint8x16_t old_cost = vld1q_u8(master + k);
+    const uint8x16_t cost = vld1q_u8(layer + k);
+    vst1q_u8(master + k, vbslq_u8(vceqq_u8(cost, unknown), old_cost, cost));
+  }
+#endif
+  for (; k < n; k++) {
+    const unsigned char cost = layer[k];
+    master[k] = cost == NO_INFORMATION ? master[k] : cost;
+  }
+}
+
+inline void additionRow(unsigned char * master, const unsigned char * layer, unsigned int n)
+{
+  // Sums reaching the inscribed cost are capped just below it
+  constexpr unsigned char max_sum = INSCRIBED_INFLATED_OBSTACLE - 1;
+  unsigned int k = 0;
+#if defined(__SSE2__)
+  const __m128i unknown = _mm_set1_epi8(static_cast<char>(NO_INFORMATION));
+  const __m128i cap = _mm_set1_epi8(static_cast<char>(max_sum));
+  for (; k + VECTOR_WIDTH <= n; k += VECTOR_WIDTH) {
+    const __m128i old_cost = _mm_loadu_si128(reinterpret_cast<const __m128i *>(master + k));
+    const __m128i cost = _mm_loadu_si128(reinterpret_cast<const __m128i *>(layer + k));
+    const __m128i sum = _mm_min_epu8(_mm_adds_epu8(old_cost, cost), cap);
+    const __m128i combined = select(_mm_cmpeq_epi8(old_cost, unknown), cost, sum);
+    _mm_storeu_si128(
+      reinterpret_cast<__m128i *>(master + k),
+      select(_mm_cmpeq_epi8(cost, unknown), old_cost, combined));
+  }
+#elif defined(__ARM_NEON)
+  const uint8x16_t unknown = vdupq_n_u8(NO_INFORMATION);
+  const uint8x16_t cap = vdupq_n_u8(max_sum);
+  for (; k + VECTOR_WIDTH <= n; k += VECTOR_WIDTH) {
+    const uint8x16_t old_cost = vld1q_u8(master + k);
+    const uint8x16_t cost = vld1q_u8(layer + k);
+    const uint8x16_t sum = vminq_u8(vqaddq_u8(old_cost, cost), cap);
+    const uint8x16_t combined = vbslq_u8(vceqq_u8(old_cost, unknown), cost, sum);
+    vst1q_u8(master + k, vbslq_u8(vceqq_u8(cost, unknown), old_cost, combined));
+  }
+#endif
+  for (; k < n; k++) {
+    const unsigned char old_cost = master[k];
+    const unsigned char cost = layer[k];
+    const unsigned int sum = old_cost + cost;
+    const unsigned char capped = sum >= max_sum ? max_sum : static_cast<unsigned char>(sum);
+    const unsigned char combined = old_cost == NO_INFORMATION ? cost : capped;
+    master[k] = cost == NO_INFORMATION ? old_cost : combined;
+  }
+}
+
+}  // namespace
+
 void CostmapLayer::touch(
   double x, double y, double * min_x, double * min_y, double * max_x,
   double * max_y)
@@ -118,21 +274,13 @@ void CostmapLayer::updateWithMax(
 
   unsigned char * master_array = master_grid.getCharMap();
   unsigned int span = master_grid.getSizeInCellsX();
+  if (max_i <= min_i) {
+    return;
+  }
 
   for (int j = min_j; j < max_j; j++) {
     unsigned int it = j * span + min_i;
-    for (int i = min_i; i < max_i; i++) {
-      if (costmap_[it] == NO_INFORMATION) {
-        it++;
-        continue;
-      }
-
-      unsigned char old_cost = master_array[it];
-      if (old_cost == NO_INFORMATION || old_cost < costmap_[it]) {
-        master_array[it] = costmap_[it];
-      }
-      it++;
-    }
+    maxRow(master_array + it, costmap_ + it, max_i - min_i);
   }
 }
 
@@ -147,21 +295,13 @@ void CostmapLayer::updateWithMaxWithoutUnknownOverwrite(
 
   unsigned char * master_array = master_grid.getCharMap();
   unsigned int span = master_grid.getSizeInCellsX();
+  if (max_i <= min_i) {
+    return;
+  }
 
   for (int j = min_j; j < max_j; j++) {
     unsigned int it = j * span + min_i;
-    for (int i = min_i; i < max_i; i++) {
-      if (costmap_[it] == NO_INFORMATION) {
-        it++;
-        continue;
-      }
-
-      unsigned char old_cost = master_array[it];
-      if (old_cost != NO_INFORMATION && old_cost < costmap_[it]) {
-        master_array[it] = costmap_[it];
-      }
-      it++;
-    }
+    maxWithoutUnknownOverwriteRow(master_array + it, costmap_ + it, max_i - min_i);
   }
 }
 
@@ -182,12 +322,13 @@ void CostmapLayer::updateWithTrueOverwrite(
   unsigned char * master = master_grid.getCharMap();
   unsigned int span = master_grid.getSizeInCellsX();
 
+  if (max_i <= min_i) {
+    return;
+  }
+
   for (int j = min_j; j < max_j; j++) {
     unsigned int it = span * j + min_i;
-    for (int i = min_i; i < max_i; i++) {
-      master[it] = costmap_[it];
-      it++;
-    }
+    std::copy(costmap_ + it, costmap_ + it + (max_i - min_i), master + it);
   }
 }
 
@@ -200,15 +341,13 @@ void CostmapLayer::updateWithOverwrite(
   }
   unsigned char * master = master_grid.getCharMap();
   unsigned int span = master_grid.getSizeInCellsX();
+  if (max_i <= min_i) {
+    return;
+  }
 
   for (int j = min_j; j < max_j; j++) {
-    unsigned int it = span * j + min_i;
-    for (int i = min_i; i < max_i; i++) {
-      if (costmap_[it] != NO_INFORMATION) {
-        master[it] = costmap_[it];
-      }
-      it++;
-    }
+    unsigned int it = j * span + min_i;
+    overwriteRow(master + it, costmap_ + it, max_i - min_i);
   }
 }
 
@@ -221,28 +360,13 @@ void CostmapLayer::updateWithAddition(
   }
   unsigned char * master_array = master_grid.getCharMap();
   unsigned int span = master_grid.getSizeInCellsX();
+  if (max_i <= min_i) {
+    return;
+  }
 
   for (int j = min_j; j < max_j; j++) {
     unsigned int it = j * span + min_i;
-    for (int i = min_i; i < max_i; i++) {
-      if (costmap_[it] == NO_INFORMATION) {
-        it++;
-        continue;
-      }
-
-      unsigned char old_cost = master_array[it];
-      if (old_cost == NO_INFORMATION) {
-        master_array[it] = costmap_[it];
-      } else {
-        int sum = old_cost + costmap_[it];
-        if (sum >= nav2_costmap_2d::INSCRIBED_INFLATED_OBSTACLE) {
-          master_array[it] = nav2_costmap_2d::INSCRIBED_INFLATED_OBSTACLE - 1;
-        } else {
-          master_array[it] = sum;
-        }
-      }
-      it++;
-    }
+    additionRow(master_array + it, costmap_ + it, max_i - min_i);
   }
 }
 
@@ -0,0 +1,69 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_costmap_2d/costmap_registry.hpp"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace nav2_costmap_2d
+{
+
+namespace
+{
+
+struct Registry
+{
+  // Held while calling providers so that removing one waits for its calls
+  std::mutex mutex;
+  std::unordered_map<std::string, CostmapRegistry::SnapshotProvider> providers;
+};
+
+Registry & registry()
+{
+  static Registry instance;
+  return instance;
+}
+
+}  // namespace
+
+void CostmapRegistry::add(const std::string & topic_name, SnapshotProvider provider)
+{
+  Registry & reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  reg.providers[topic_name] = std::move(provider);
+}
+
+void CostmapRegistry::remove(const std::string & topic_name)
+{
+  Registry & reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  reg.providers.erase(topic_name);
+}
+
+std::shared_ptr<const Costmap2D> CostmapRegistry::getSnapshot(const std::string & topic_name)
+{
+  Registry & reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  auto it = reg.providers.find(topic_name);
+  if (it == reg.providers.end()) {
+    return nullptr;
+  }
+  return it->second();
+}
+
+}  // namespace nav2_costmap_2d
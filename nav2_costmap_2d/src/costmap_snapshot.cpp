@@ -0,0 +1,95 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "nav2_costmap_2d/costmap_snapshot.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "nav2_costmap_2d/costmap_delta.hpp"
+#include "rclcpp/serialization.hpp"
+#include "rclcpp/serialized_message.hpp"
+
+namespace nav2_costmap_2d
+{
+
+void encodeCostmap(
+  const Costmap2D & costmap, nav2_msgs::msg::CostmapMetaData & metadata,
+  std::vector<unsigned char> & data)
+{
+  metadata.resolution = costmap.getResolution();
+  metadata.size_x = costmap.getSizeInCellsX();
+  metadata.size_y = costmap.getSizeInCellsY();
+  metadata.origin.position.x = costmap.getOriginX();
+  metadata.origin.position.y = costmap.getOriginY();
+  metadata.origin.position.z = 0.0;
+  metadata.origin.orientation.w = 1.0;
+  data.clear();
+  encodeCostmapWindow(
+    costmap.getCharMap(), metadata.size_x, 0, 0, metadata.size_x, metadata.size_y, data);
+}
+
+bool decodeCostmap(
+  const nav2_msgs::msg::CostmapMetaData & metadata, const std::vector<unsigned char> & data,
+  Costmap2D & costmap)
+{
+  costmap.resizeMap(
+    metadata.size_x, metadata.size_y, metadata.resolution,
+    metadata.origin.position.x, metadata.origin.position.y);
+  size_t offset = 0;
+  return decodeCostmapWindow(
+    data, offset, costmap.getCharMap(), metadata.size_x,
+    0, 0, metadata.size_x, metadata.size_y) && offset == data.size();
+}
+
+bool saveCostmapSnapshot(
+  const nav2_msgs::msg::CostmapSnapshot & snapshot, const std::string & filename)
+{
+  rclcpp::SerializedMessage serialized;
+  rclcpp::Serialization<nav2_msgs::msg::CostmapSnapshot>().serialize_message(
+    &snapshot, &serialized);
+
+  std::ofstream stream(filename, std::ios::binary);
+  const auto & buffer = serialized.get_rcl_serialized_message();
+  stream.write(reinterpret_cast<const char *>(buffer.buffer), buffer.buffer_length);
+  return static_cast<bool>(stream);
+}
+
+bool loadCostmapSnapshot(
+  const std::string & filename, nav2_msgs::msg::CostmapSnapshot & snapshot)
+{
+  std::ifstream stream(filename, std::ios::binary);
+  if (!stream) {
+    return false;
+  }
+  const std::vector<char> bytes{std::istreambuf_iterator<char>(stream), {}};
+
+  rclcpp::SerializedMessage serialized(bytes.size());
+  auto & buffer = serialized.get_rcl_serialized_message();
+  std::memcpy(buffer.buffer, bytes.data(), bytes.size());
+  buffer.buffer_length = bytes.size();
+  try {
+    rclcpp::Serialization<nav2_msgs::msg::CostmapSnapshot>().deserialize_message(
+      &serialized, &snapshot);
+  } catch (const std::exception &) {
+    return false;
+  }
+  return true;
+}
+
+}  // namespace nav2_costmap_2d
@@ -12,24 +12,82 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <atomic>
+#include <cstring>
 #include <string>
 #include <memory>
 #include <mutex>
 
 #include "nav2_costmap_2d/costmap_subscriber.hpp"
+#include "nav2_costmap_2d/cost_values.hpp"
+#include "nav2_costmap_2d/costmap_delta.hpp"
+#include "nav2_costmap_2d/costmap_registry.hpp"
 
 namespace nav2_costmap_2d
 {
 
 constexpr int costmapUpdateQueueDepth = 10;
 
+namespace
+{
+
+bool hasGeometry(const Costmap2D & costmap, const nav2_msgs::msg::CostmapMetaData & metadata)
+{
+  return costmap.getSizeInCellsX() == metadata.size_x &&
+         costmap.getSizeInCellsY() == metadata.size_y &&
+         costmap.getResolution() == metadata.resolution &&
+         costmap.getOriginX() == metadata.origin.position.x &&
+         costmap.getOriginY() == metadata.origin.position.y;
+}
+
+void setGeometry(Costmap2D & costmap, const nav2_msgs::msg::CostmapMetaData & metadata)
+{
+  if (!hasGeometry(costmap, metadata)) {
+    // Reuses the allocation if the number of cells is the same
+    costmap.resizeMap(
+      metadata.size_x, metadata.size_y, metadata.resolution,
+      metadata.origin.position.x, metadata.origin.position.y);
+  }
+}
+
+bool hasSameGeometry(const Costmap2D & costmap, const Costmap2D & other)
+{
+  return costmap.getSizeInCellsX() == other.getSizeInCellsX() &&
+         costmap.getSizeInCellsY() == other.getSizeInCellsY() &&
+         costmap.getResolution() == other.getResolution() &&
+         costmap.getOriginX() == other.getOriginX() &&
+         costmap.getOriginY() == other.getOriginY();
+}
+
+// Copy a window of rows of the same geometry, the window being inside of both costmaps
+void copyRows(
+  const unsigned char * source, unsigned char * destination, unsigned int size_x,
+  unsigned int x, unsigned int y, unsigned int window_size_x, unsigned int window_size_y)
+{
+  for (size_t row = y; row < static_cast<size_t>(y) + window_size_y; ++row) {
+    std::memcpy(
+      destination + row * size_x + x, source + row * size_x + x, window_size_x);
+  }
+}
+
+}  // namespace
+
 CostmapSubscriber::CostmapSubscriber(
   const nav2_util::LifecycleNode::WeakPtr & parent,
-  const std::string & topic_name)
+  const std::string & topic_name,
+  bool use_deltas)
 : topic_name_(topic_name)
 {
   auto node = parent.lock();
   logger_ = node->get_logger();
+  resolved_topic_name_ = node->get_node_topics_interface()->resolve_topic_name(topic_name_);
+  if (use_deltas) {
+    costmap_delta_sub_ = node->create_subscription<nav2_msgs::msg::CostmapDelta>(
+      topic_name_ + "_deltas",
+      rclcpp::QoS(rclcpp::KeepLast(costmapUpdateQueueDepth)).transient_local().reliable(),
+      std::bind(&CostmapSubscriber::costmapDeltaCallback, this, std::placeholders::_1));
+    return;
+  }
   costmap_sub_ = node->create_subscription<nav2_msgs::msg::Costmap>(
     topic_name_,
     rclcpp::QoS(rclcpp::KeepLast(1)).transient_local().reliable(),
@@ -42,11 +100,20 @@ CostmapSubscriber::CostmapSubscriber(
 
 CostmapSubscriber::CostmapSubscriber(
   const rclcpp::Node::WeakPtr & parent,
-  const std::string & topic_name)
+  const std::string & topic_name,
+  bool use_deltas)
 : topic_name_(topic_name)
 {
   auto node = parent.lock();
   logger_ = node->get_logger();
+  resolved_topic_name_ = node->get_node_topics_interface()->resolve_topic_name(topic_name_);
+  if (use_deltas) {
+    costmap_delta_sub_ = node->create_subscription<nav2_msgs::msg::CostmapDelta>(
+      topic_name_ + "_deltas",
+      rclcpp::QoS(rclcpp::KeepLast(costmapUpdateQueueDepth)).transient_local().reliable(),
+      std::bind(&CostmapSubscriber::costmapDeltaCallback, this, std::placeholders::_1));
+    return;
+  }
   costmap_sub_ = node->create_subscription<nav2_msgs::msg::Costmap>(
     topic_name_,
     rclcpp::QoS(rclcpp::KeepLast(1)).transient_local().reliable(),
@@ -57,108 +124,140 @@ CostmapSubscriber::CostmapSubscriber(
     std::bind(&CostmapSubscriber::costmapUpdateCallback, this, std::placeholders::_1));
 }
 
-std::shared_ptr<Costmap2D> CostmapSubscriber::getCostmap()
+std::shared_ptr<const Costmap2D> CostmapSubscriber::getCostmap()
 {
-  if (!isCostmapReceived()) {
-    throw std::runtime_error("Costmap is not available");
+  // Share the snapshot of a producer in this process rather than copying its messages
+  auto snapshot = CostmapRegistry::getSnapshot(resolved_topic_name_);
+  if (snapshot) {
+    return snapshot;
   }
-  if (costmap_msg_) {
-    processCurrentCostmapMsg();
+  std::shared_ptr<const Costmap2D> costmap = std::atomic_load(&costmap_);
+  if (!costmap) {
+    throw std::runtime_error("Costmap is not available");
   }
-  return costmap_;
+  return costmap;
 }
 
 void CostmapSubscriber::costmapCallback(const nav2_msgs::msg::Costmap::SharedPtr msg)
 {
-  {
-    std::lock_guard<std::mutex> lock(costmap_msg_mutex_);
-    costmap_msg_ = msg;
+  std::lock_guard<std::mutex> lock(callback_mutex_);
+  const auto & metadata = msg->metadata;
+  if (msg->data.size() != static_cast<size_t>(metadata.size_x) * metadata.size_y) {
+    RCLCPP_WARN(
+      logger_, "Costmap of %zu cells does not match its bounds: %d X %d",
+      msg->data.size(), metadata.size_x, metadata.size_y);
+    return;
   }
-  if (!isCostmapReceived()) {
-    costmap_ = std::make_shared<Costmap2D>(
-      msg->metadata.size_x, msg->metadata.size_y,
-      msg->metadata.resolution, msg->metadata.origin.position.x,
-      msg->metadata.origin.position.y);
 
-    processCurrentCostmapMsg();
-  }
+  // The whole costmap is replaced, there is nothing to keep from the current one
+  auto costmap = nextCostmap();
+  setGeometry(*costmap, metadata);
+  std::memcpy(costmap->getCharMap(), msg->data.data(), msg->data.size());
+  publishCostmap(std::move(costmap));
+  update_window_valid_ = false;
 }
 
 void CostmapSubscriber::costmapUpdateCallback(
   const nav2_msgs::msg::CostmapUpdate::SharedPtr update_msg)
 {
-  if (isCostmapReceived()) {
-    if (costmap_msg_) {
-      processCurrentCostmapMsg();
-    }
+  std::lock_guard<std::mutex> lock(callback_mutex_);
+  auto current = std::atomic_load(&costmap_);
+  if (!current) {
+    RCLCPP_WARN(logger_, "No costmap received.");
+    return;
+  }
 
-    std::lock_guard<Costmap2D::mutex_t> lock(*(costmap_->getMutex()));
+  auto map_cell_size_x = current->getSizeInCellsX();
+  auto map_call_size_y = current->getSizeInCellsY();
 
-    auto map_cell_size_x = costmap_->getSizeInCellsX();
-    auto map_call_size_y = costmap_->getSizeInCellsY();
+  if (map_cell_size_x < update_msg->x + update_msg->size_x ||
+    map_call_size_y < update_msg->y + update_msg->size_y)
+  {
+    RCLCPP_WARN(
+      logger_, "Update area outside of original map area. Costmap bounds: %d X %d, "
+      "Update origin: %d, %d  bounds: %d X %d", map_cell_size_x, map_call_size_y,
+      update_msg->x, update_msg->y, update_msg->size_x, update_msg->size_y);
+    return;
+  }
 
-    if (map_cell_size_x < update_msg->x + update_msg->size_x ||
-      map_call_size_y < update_msg->y + update_msg->size_y)
-    {
-      RCLCPP_WARN(
-        logger_, "Update area outside of original map area. Costmap bounds: %d X %d, "
-        "Update origin: %d, %d  bounds: %d X %d", map_cell_size_x, map_call_size_y,
-        update_msg->x, update_msg->y, update_msg->size_x, update_msg->size_y);
-      return;
-    }
-    unsigned char * master_array = costmap_->getCharMap();
-    // copy update msg row-wise
-    for (size_t y = 0; y < update_msg->size_y; ++y) {
-      auto starting_index_of_row_update_in_costmap = (y + update_msg->y) * map_cell_size_x +
-        update_msg->x;
-
-      std::copy_n(
-        update_msg->data.begin() + (y * update_msg->size_x),
-        update_msg->size_x, &master_array[starting_index_of_row_update_in_costmap]);
-    }
+  // The spare costmap lags the current one by the previous update only, replaying it
+  // keeps updates proportional to their size rather than to the size of the costmap
+  auto costmap = nextCostmap();
+  if (update_window_valid_ && hasSameGeometry(*costmap, *current)) {
+    copyRows(
+      current->getCharMap(), costmap->getCharMap(), map_cell_size_x,
+      update_x_, update_y_, update_size_x_, update_size_y_);
   } else {
-    RCLCPP_WARN(logger_, "No costmap received.");
+    *costmap = *current;
   }
-}
 
-void CostmapSubscriber::processCurrentCostmapMsg()
-{
-  std::scoped_lock lock(*(costmap_->getMutex()), costmap_msg_mutex_);
-  if (haveCostmapParametersChanged()) {
-    costmap_->resizeMap(
-      costmap_msg_->metadata.size_x, costmap_msg_->metadata.size_y,
-      costmap_msg_->metadata.resolution,
-      costmap_msg_->metadata.origin.position.x,
-      costmap_msg_->metadata.origin.position.y);
-  }
+  unsigned char * master_array = costmap->getCharMap();
+  // copy update msg row-wise
+  for (size_t y = 0; y < update_msg->size_y; ++y) {
+    auto starting_index_of_row_update_in_costmap = (y + update_msg->y) * map_cell_size_x +
+      update_msg->x;
 
-  unsigned char * master_array = costmap_->getCharMap();
-  std::copy(costmap_msg_->data.begin(), costmap_msg_->data.end(), master_array);
-  costmap_msg_.reset();
+    std::memcpy(
+      &master_array[starting_index_of_row_update_in_costmap],
+      update_msg->data.data() + y * update_msg->size_x, update_msg->size_x);
+  }
+  publishCostmap(std::move(costmap));
+  update_window_valid_ = true;
+  update_x_ = update_msg->x;
+  update_y_ = update_msg->y;
+  update_size_x_ = update_msg->size_x;
+  update_size_y_ = update_msg->size_y;
 }
 
-bool CostmapSubscriber::haveCostmapParametersChanged()
+void CostmapSubscriber::costmapDeltaCallback(
+  const nav2_msgs::msg::CostmapDelta::SharedPtr delta_msg)
 {
-  return hasCostmapSizeChanged() ||
-         hasCostmapResolutionChanged() ||
-         hasCostmapOriginPositionChanged();
-}
+  std::lock_guard<std::mutex> lock(callback_mutex_);
+  if (!delta_msg->keyframe && (!delta_synced_ || delta_msg->sequence != delta_sequence_ + 1)) {
+    if (delta_synced_) {
+      RCLCPP_WARN(logger_, "Missed a costmap delta, waiting for the next keyframe.");
+      delta_synced_ = false;
+    }
+    return;
+  }
 
-bool CostmapSubscriber::hasCostmapSizeChanged()
-{
-  return costmap_->getSizeInCellsX() != costmap_msg_->metadata.size_x ||
-         costmap_->getSizeInCellsY() != costmap_msg_->metadata.size_y;
+  // Deltas apply to the current costmap, keyframes reset it if its geometry changed
+  auto current = std::atomic_load(&costmap_);
+  auto costmap = nextCostmap();
+  if (current && (!delta_msg->keyframe || hasGeometry(*current, delta_msg->metadata))) {
+    *costmap = *current;
+  } else {
+    setGeometry(*costmap, delta_msg->metadata);
+    costmap->resetMaps();
+  }
+
+  delta_synced_ = applyCostmapDelta(*delta_msg, *costmap);
+  delta_sequence_ = delta_msg->sequence;
+  if (!delta_synced_) {
+    RCLCPP_WARN(logger_, "Received a malformed costmap delta, waiting for the next keyframe.");
+    return;
+  }
+  publishCostmap(std::move(costmap));
+  update_window_valid_ = false;
 }
 
-bool CostmapSubscriber::hasCostmapResolutionChanged()
+std::shared_ptr<Costmap2D> CostmapSubscriber::nextCostmap()
 {
-  return costmap_->getResolution() != costmap_msg_->metadata.resolution;
+  // Readers holding the spare costmap keep it alive, a new buffer is needed then
+  if (spare_costmap_ && spare_costmap_.use_count() == 1) {
+    // Order the writes after the reads of the last reader which released it
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return std::move(spare_costmap_);
+  }
+  spare_costmap_.reset();
+  auto costmap = std::make_shared<Costmap2D>();
+  costmap->setDefaultValue(FREE_SPACE);
+  return costmap;
 }
 
-bool CostmapSubscriber::hasCostmapOriginPositionChanged()
+void CostmapSubscriber::publishCostmap(std::shared_ptr<Costmap2D> costmap)
 {
-  return costmap_->getOriginX() != costmap_msg_->metadata.origin.position.x ||
-         costmap_->getOriginY() != costmap_msg_->metadata.origin.position.y;
+  spare_costmap_ = std::atomic_exchange(&costmap_, std::move(costmap));
 }
 
 }  // namespace nav2_costmap_2d
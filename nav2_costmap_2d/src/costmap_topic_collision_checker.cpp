@@ -14,6 +14,7 @@
 //
 // Modified by: Shivang Patel (shivaan14@gmail.com)
 
+#include <cmath>
 #include <memory>
 #include <string>
 #include <vector>
@@ -63,6 +64,70 @@ bool CostmapTopicCollisionChecker::isCollisionFree(
   }
 }
 
+bool CostmapTopicCollisionChecker::isPathCollisionFree(
+  const std::vector<geometry_msgs::msg::Pose2D> & poses)
+{
+  if (poses.empty()) {
+    return true;
+  }
+
+  try {
+    try {
+      collision_checker_.setCostmap(costmap_sub_.getCostmap());
+    } catch (const std::runtime_error & e) {
+      throw CollisionCheckerException(e.what());
+    }
+
+    std_msgs::msg::Header header;
+    if (!footprint_sub_.getFootprintInRobotFrame(footprint_, header)) {
+      throw CollisionCheckerException("Current footprint not available.");
+    }
+
+    // Footprint rotated to the heading of the last pose, translated to each pose
+    Footprint oriented_footprint = footprint_;
+    Footprint footprint = footprint_;
+    double theta = 0.0;
+
+    for (unsigned int i = 0; i < poses.size(); ++i) {
+      const geometry_msgs::msg::Pose2D & pose = poses[i];
+      unsigned int cell_x, cell_y;
+      if (!collision_checker_.worldToMap(pose.x, pose.y, cell_x, cell_y)) {
+        RCLCPP_DEBUG(rclcpp::get_logger(name_), "Map Cell: [%d, %d]", cell_x, cell_y);
+        throw IllegalPoseException(name_, "Pose Goes Off Grid.");
+      }
+
+      if (i == 0 || pose.theta != theta) {
+        theta = pose.theta;
+        const double cos_th = cos(theta);
+        const double sin_th = sin(theta);
+        for (unsigned int j = 0; j < footprint_.size(); ++j) {
+          oriented_footprint[j].x = footprint_[j].x * cos_th - footprint_[j].y * sin_th;
+          oriented_footprint[j].y = footprint_[j].x * sin_th + footprint_[j].y * cos_th;
+        }
+      }
+
+      for (unsigned int j = 0; j < oriented_footprint.size(); ++j) {
+        footprint[j].x = pose.x + oriented_footprint[j].x;
+        footprint[j].y = pose.y + oriented_footprint[j].y;
+      }
+
+      if (collision_checker_.footprintCost(footprint) >= LETHAL_OBSTACLE) {
+        return false;
+      }
+    }
+    return true;
+  } catch (const IllegalPoseException & e) {
+    RCLCPP_ERROR(rclcpp::get_logger(name_), "%s", e.what());
+    return false;
+  } catch (const CollisionCheckerException & e) {
+    RCLCPP_ERROR(rclcpp::get_logger(name_), "%s", e.what());
+    return false;
+  } catch (...) {
+    RCLCPP_ERROR(rclcpp::get_logger(name_), "Failed to check path score!");
+    return false;
+  }
+}
+
 double CostmapTopicCollisionChecker::scorePose(
   const geometry_msgs::msg::Pose2D & pose,
   bool fetch_costmap_and_footprint)
@@ -0,0 +1,281 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_costmap_2d/distance_field.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "nav2_costmap_2d/cost_values.hpp"
+
+namespace nav2_costmap_2d
+{
+
+// Squared distance of cells without any obstacle, finite to keep the envelope math stable
+static constexpr double FAR_DISTANCE_SQ = 1e20;
+
+void DistanceField::setMaxDistance(double max_distance)
+{
+  if (max_distance != max_distance_) {
+    max_distance_ = max_distance;
+    force_full_update_ = true;
+  }
+}
+
+void DistanceField::update(const Costmap2D & costmap, bool unknown_is_obstacle)
+{
+  const unsigned int cells_x = costmap.getSizeInCellsX();
+  const unsigned int cells_y = costmap.getSizeInCellsY();
+  const double resolution = costmap.getResolution();
+
+  // Exposed strips of a rolling costmap whose distances were never computed
+  int exposed_min_x = 0, exposed_max_x = 0, exposed_min_y = 0, exposed_max_y = 0;
+
+  if (cells_x != size_x_ || cells_y != size_y_ || resolution != resolution_) {
+    size_x_ = cells_x;
+    size_y_ = cells_y;
+    resolution_ = resolution;
+    obstacles_.assign(size_x_ * size_y_, 0);
+    distances_.assign(size_x_ * size_y_, static_cast<float>(max_distance_));
+    force_full_update_ = true;
+  } else if (costmap.getOriginX() != origin_x_ || costmap.getOriginY() != origin_y_) {
+    const double shift_x = (costmap.getOriginX() - origin_x_) / resolution_;
+    const double shift_y = (costmap.getOriginY() - origin_y_) / resolution_;
+    const int cell_ox = static_cast<int>(std::round(shift_x));
+    const int cell_oy = static_cast<int>(std::round(shift_y));
+
+    if (std::fabs(shift_x - cell_ox) > 1e-3 || std::fabs(shift_y - cell_oy) > 1e-3 ||
+      std::abs(cell_ox) >= static_cast<int>(size_x_) ||
+      std::abs(cell_oy) >= static_cast<int>(size_y_))
+    {
+      force_full_update_ = true;
+    } else {
+      shift(cell_ox, cell_oy);
+      exposed_min_x = cell_ox > 0 ? size_x_ - cell_ox : 0;
+      exposed_max_x = cell_ox > 0 ? size_x_ : -cell_ox;
+      exposed_min_y = cell_oy > 0 ? size_y_ - cell_oy : 0;
+      exposed_max_y = cell_oy > 0 ? size_y_ : -cell_oy;
+    }
+  }
+  origin_x_ = costmap.getOriginX();
+  origin_y_ = costmap.getOriginY();
+  max_distance_cells_ = static_cast<int>(std::ceil(max_distance_ / resolution_)) + 1;
+
+  // Find the bounds of the cells whose obstacle status changed since the last update
+  const unsigned char * charmap = costmap.getCharMap();
+  int min_x = size_x_, min_y = size_y_, max_x = -1, max_y = -1;
+  for (unsigned int y = 0; y != size_y_; y++) {
+    const bool exposed_row = static_cast<int>(y) >= exposed_min_y &&
+      static_cast<int>(y) < exposed_max_y;
+    const unsigned int row = y * size_x_;
+    for (unsigned int x = 0; x != size_x_; x++) {
+      const unsigned char cost = charmap[row + x];
+      const uint8_t obstacle = cost == LETHAL_OBSTACLE ||
+        (unknown_is_obstacle && cost == NO_INFORMATION);
+      if (obstacle == obstacles_[row + x]) {
+        continue;
+      }
+      obstacles_[row + x] = obstacle;
+
+      // Exposed cells are recomputed as a whole below
+      if (exposed_row || (static_cast<int>(x) >= exposed_min_x &&
+        static_cast<int>(x) < exposed_max_x))
+      {
+        continue;
+      }
+      min_x = std::min(min_x, static_cast<int>(x));
+      max_x = std::max(max_x, static_cast<int>(x));
+      min_y = std::min(min_y, static_cast<int>(y));
+      max_y = std::max(max_y, static_cast<int>(y));
+    }
+  }
+
+  if (force_full_update_) {
+    computeWindow(0, 0, size_x_, size_y_);
+    force_full_update_ = false;
+    return;
+  }
+
+  // Cells near the exposed strips are also affected by their obstacles, and cells near
+  // the opposite edges by obstacles which have been shifted out of the costmap
+  const int r = max_distance_cells_;
+  const int size_x = size_x_;
+  const int size_y = size_y_;
+  if (exposed_max_x > exposed_min_x) {
+    computeWindow(exposed_min_x - r, 0, exposed_max_x + r, size_y);
+    if (exposed_min_x == 0) {
+      computeWindow(size_x - r, 0, size_x, size_y);
+    } else {
+      computeWindow(0, 0, r, size_y);
+    }
+  }
+  if (exposed_max_y > exposed_min_y) {
+    computeWindow(0, exposed_min_y - r, size_x, exposed_max_y + r);
+    if (exposed_min_y == 0) {
+      computeWindow(0, size_y - r, size_x, size_y);
+    } else {
+      computeWindow(0, 0, size_x, r);
+    }
+  }
+  if (max_x >= min_x) {
+    // Only distances within the truncation radius of a changed cell may change
+    computeWindow(min_x - r, min_y - r, max_x + r + 1, max_y + r + 1);
+  }
+}
+
+void DistanceField::shift(int cell_ox, int cell_oy)
+{
+  const int size_x = size_x_;
+  const int size_y = size_y_;
+  std::vector<uint8_t> obstacles(obstacles_.size(), 0);
+  std::vector<float> distances(distances_.size(), static_cast<float>(max_distance_));
+
+  // Cell (x, y) in the new frame was cell (x + cell_ox, y + cell_oy) in the old frame
+  const int min_x = std::max(0, -cell_ox), max_x = std::min(size_x, size_x - cell_ox);
+  const int min_y = std::max(0, -cell_oy), max_y = std::min(size_y, size_y - cell_oy);
+  for (int y = min_y; y < max_y; y++) {
+    const int old_row = (y + cell_oy) * size_x + cell_ox;
+    std::copy(
+      obstacles_.begin() + old_row + min_x, obstacles_.begin() + old_row + max_x,
+      obstacles.begin() + y * size_x + min_x);
+    std::copy(
+      distances_.begin() + old_row + min_x, distances_.begin() + old_row + max_x,
+      distances.begin() + y * size_x + min_x);
+  }
+
+  obstacles_.swap(obstacles);
+  distances_.swap(distances);
+}
+
+void DistanceField::computeWindow(int min_x, int min_y, int max_x, int max_y)
+{
+  const int size_x = size_x_;
+  const int size_y = size_y_;
+  min_x = std::max(min_x, 0);
+  min_y = std::max(min_y, 0);
+  max_x = std::min(max_x, size_x);
+  max_y = std::min(max_y, size_y);
+  if (min_x >= max_x || min_y >= max_y) {
+    return;
+  }
+
+  // Obstacles within the truncation radius of the window are needed for exact results
+  const int r = max_distance_cells_;
+  const int src_min_x = std::max(min_x - r, 0);
+  const int src_min_y = std::max(min_y - r, 0);
+  const int src_max_x = std::min(max_x + r, size_x);
+  const int src_max_y = std::min(max_y + r, size_y);
+  const int width = src_max_x - src_min_x;
+  const int height = src_max_y - src_min_y;
+
+  window_.resize(width * height);
+  for (int y = 0; y != height; y++) {
+    const uint8_t * obstacles = &obstacles_[(y + src_min_y) * size_x + src_min_x];
+    double * window = &window_[y * width];
+    for (int x = 0; x != width; x++) {
+      window[x] = obstacles[x] ? 0.0 : FAR_DISTANCE_SQ;
+    }
+  }
+
+  const int max_len = std::max(width, height);
+  line_in_.resize(max_len);
+  line_out_.resize(max_len);
+  envelope_locations_.resize(max_len);
+  envelope_bounds_.resize(max_len + 1);
+
+  // Columns first, then rows, of the separable squared distance transform
+  for (int x = 0; x != width; x++) {
+    for (int y = 0; y != height; y++) {
+      line_in_[y] = window_[y * width + x];
+    }
+    transform1D(line_in_.data(), line_out_.data(), height);
+    for (int y = 0; y != height; y++) {
+      window_[y * width + x] = line_out_[y];
+    }
+  }
+
+  const float max_distance = static_cast<float>(max_distance_);
+  for (int y = min_y; y != max_y; y++) {
+    const double * window = &window_[(y - src_min_y) * width];
+    std::copy(window, window + width, line_in_.begin());
+    transform1D(line_in_.data(), line_out_.data(), width);
+
+    float * distances = &distances_[y * size_x];
+    for (int x = min_x; x != max_x; x++) {
+      const float distance =
+        static_cast<float>(std::sqrt(line_out_[x - src_min_x]) * resolution_);
+      distances[x] = std::min(distance, max_distance);
+    }
+  }
+}
+
+void DistanceField::transform1D(const double * f, double * d, int n)
+{
+  int * v = envelope_locations_.data();
+  double * z = envelope_bounds_.data();
+  int k = 0;
+  v[0] = 0;
+  z[0] = -std::numeric_limits<double>::max();
+  z[1] = std::numeric_limits<double>::max();
+
+  // Lower envelope of the parabolas rooted at each sample
+  for (int q = 1; q < n; q++) {
+    double s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2.0 * (q - v[k]));
+    while (s <= z[k]) {
+      k--;
+      s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2.0 * (q - v[k]));
+    }
+    k++;
+    v[k] = q;
+    z[k] = s;
+    z[k + 1] = std::numeric_limits<double>::max();
+  }
+
+  k = 0;
+  for (int q = 0; q < n; q++) {
+    while (z[k + 1] < q) {
+      k++;
+    }
+    const double dq = q - v[k];
+    d[q] = dq * dq + f[v[k]];
+  }
+}
+
+bool DistanceField::interpolateDistance(double wx, double wy, float & distance) const
+{
+  // Distances are sampled at cell centers
+  const double mx = (wx - origin_x_) / resolution_ - 0.5;
+  const double my = (wy - origin_y_) / resolution_ - 0.5;
+  if (mx < -0.5 || my < -0.5 || mx >= size_x_ - 0.5 || my >= size_y_ - 0.5) {
+    return false;
+  }
+
+  const int x0 = std::clamp(static_cast<int>(std::floor(mx)), 0, static_cast<int>(size_x_) - 1);
+  const int y0 = std::clamp(static_cast<int>(std::floor(my)), 0, static_cast<int>(size_y_) - 1);
+  const int x1 = std::min(x0 + 1, static_cast<int>(size_x_) - 1);
+  const int y1 = std::min(y0 + 1, static_cast<int>(size_y_) - 1);
+  const float tx = static_cast<float>(std::clamp(mx - x0, 0.0, 1.0));
+  const float ty = static_cast<float>(std::clamp(my - y0, 0.0, 1.0));
+
+  const float d00 = distances_[y0 * size_x_ + x0];
+  const float d10 = distances_[y0 * size_x_ + x1];
+  const float d01 = distances_[y1 * size_x_ + x0];
+  const float d11 = distances_[y1 * size_x_ + x1];
+  distance = (d00 * (1.0f - tx) + d10 * tx) * (1.0f - ty) + (d01 * (1.0f - tx) + d11 * tx) * ty;
+  return true;
+}
+
+}  // namespace nav2_costmap_2d
@@ -14,8 +14,11 @@
 //
 // Modified by: Shivang Patel (shivaang14@gmail.com)
 
+#include <cmath>
+#include <limits>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 #include <algorithm>
 
@@ -143,8 +146,176 @@ double FootprintCollisionChecker<CostmapT>::footprintCostAtPose(
   return footprintCost(oriented_footprint);
 }
 
+template<typename CostmapT>
+double FootprintCollisionChecker<CostmapT>::footprintCostAtPoseQuantized(
+  double x, double y, double theta, const Footprint & footprint,
+  unsigned int num_headings)
+{
+  if (num_headings == 0) {
+    return footprintCostAtPose(x, y, theta, footprint);
+  }
+
+  unsigned int mx, my;
+  if (!worldToMap(x, y, mx, my)) {
+    return static_cast<double>(LETHAL_OBSTACLE);
+  }
+
+  if (kernels_.size() != num_headings || !footprintKernelsMatchCostmap() ||
+    kernel_footprint_ != footprint)
+  {
+    updateFootprintKernels(footprint, num_headings);
+  }
+
+  return footprintKernelCost(mx, my, kernels_[nearestHeading(theta, num_headings)]);
+}
+
+template<typename CostmapT>
+bool FootprintCollisionChecker<CostmapT>::isFootprintBoxBelowCost(
+  double x, double y, double theta, const Footprint & footprint, unsigned char cost,
+  unsigned int num_headings)
+{
+  if (!cost_pyramid_ || !cost_pyramid_->isInitialized() || footprint.empty()) {
+    return false;
+  }
+
+  unsigned int mx, my;
+  if (num_headings > 0) {
+    // Bounds of the outline cells laid about the pose's cell
+    if (!worldToMap(x, y, mx, my)) {
+      return false;
+    }
+    if (kernels_.size() != num_headings || !footprintKernelsMatchCostmap() ||
+      kernel_footprint_ != footprint)
+    {
+      updateFootprintKernels(footprint, num_headings);
+    }
+    const FootprintKernel & kernel = kernels_[nearestHeading(theta, num_headings)];
+    const int cx = static_cast<int>(mx);
+    const int cy = static_cast<int>(my);
+    if (cx + kernel.min_dx < 0 || cy + kernel.min_dy < 0) {
+      return false;
+    }
+    return cost_pyramid_->isRegionBelow(
+      cx + kernel.min_dx, cy + kernel.min_dy, cx + kernel.max_dx, cy + kernel.max_dy, cost);
+  }
+
+  // Bounds of the cells of the vertices, which contain the edges rasterized between them
+  const double cos_th = cos(theta);
+  const double sin_th = sin(theta);
+  unsigned int min_x = std::numeric_limits<unsigned int>::max(), max_x = 0;
+  unsigned int min_y = std::numeric_limits<unsigned int>::max(), max_y = 0;
+  for (const geometry_msgs::msg::Point & point : footprint) {
+    if (!worldToMap(
+        x + (point.x * cos_th - point.y * sin_th),
+        y + (point.x * sin_th + point.y * cos_th), mx, my))
+    {
+      return false;
+    }
+    min_x = std::min(min_x, mx);
+    max_x = std::max(max_x, mx);
+    min_y = std::min(min_y, my);
+    max_y = std::max(max_y, my);
+  }
+  return cost_pyramid_->isRegionBelow(min_x, min_y, max_x, max_y, cost);
+}
+
+template<typename CostmapT>
+unsigned int FootprintCollisionChecker<CostmapT>::nearestHeading(
+  double theta, unsigned int num_headings)
+{
+  // Wrapped to [0, num_headings)
+  const double turns = theta / (2.0 * M_PI);
+  return static_cast<unsigned int>(
+    std::lround((turns - std::floor(turns)) * num_headings)) % num_headings;
+}
+
+template<typename CostmapT>
+double FootprintCollisionChecker<CostmapT>::footprintKernelCost(
+  unsigned int mx, unsigned int my, const FootprintKernel & kernel) const
+{
+  const int cx = static_cast<int>(mx);
+  const int cy = static_cast<int>(my);
+  const int size_x = static_cast<int>(costmap_->getSizeInCellsX());
+  const int size_y = static_cast<int>(costmap_->getSizeInCellsY());
+  if (cx + kernel.min_dx < 0 || cx + kernel.max_dx >= size_x ||
+    cy + kernel.min_dy < 0 || cy + kernel.max_dy >= size_y)
+  {
+    return static_cast<double>(LETHAL_OBSTACLE);
+  }
+
+  // A lethal cell makes the footprint lethal even when unknown cells cost more
+  const unsigned char * center = costmap_->getCharMap() + cy * size_x + cx;
+  const int * offsets = kernel.offsets.data();
+  const size_t num_offsets = kernel.offsets.size();
+  unsigned char footprint_cost = 0;
+  unsigned char lethal = 0;
+  for (size_t i = 0; i < num_offsets; ++i) {
+    const unsigned char cost = center[offsets[i]];
+    footprint_cost = std::max(footprint_cost, cost);
+    lethal |= static_cast<unsigned char>(cost == LETHAL_OBSTACLE);
+  }
+
+  return static_cast<double>(lethal ? LETHAL_OBSTACLE : footprint_cost);
+}
+
+template<typename CostmapT>
+void FootprintCollisionChecker<CostmapT>::updateFootprintKernels(
+  const Footprint & footprint, unsigned int num_headings)
+{
+  kernel_footprint_ = footprint;
+  kernel_resolution_ = costmap_->getResolution();
+  kernel_size_x_ = costmap_->getSizeInCellsX();
+  const int size_x = static_cast<int>(kernel_size_x_);
+  kernels_.assign(num_headings, FootprintKernel());
+
+  std::vector<std::pair<int, int>> vertices(footprint.size());
+  std::vector<std::pair<int, int>> cells;
+  for (unsigned int heading = 0; heading < num_headings; ++heading) {
+    const double theta = 2.0 * M_PI * heading / num_headings;
+    const double cos_th = cos(theta);
+    const double sin_th = sin(theta);
+
+    // Cell of each vertex relative to the pose's cell, with the pose at its center
+    for (unsigned int i = 0; i < footprint.size(); ++i) {
+      const double vx = footprint[i].x * cos_th - footprint[i].y * sin_th;
+      const double vy = footprint[i].x * sin_th + footprint[i].y * cos_th;
+      vertices[i].first = static_cast<int>(std::floor(0.5 + vx / kernel_resolution_));
+      vertices[i].second = static_cast<int>(std::floor(0.5 + vy / kernel_resolution_));
+    }
+
+    // Edges are rasterized in the directions footprintCost() walks them, the closing
+    // edge from the first vertex to the last, so both check the same cells
+    cells.clear();
+    for (unsigned int i = 0; i < vertices.size(); ++i) {
+      const bool closing = i + 1 == vertices.size();
+      const auto & start = closing ? vertices[0] : vertices[i];
+      const auto & end = closing ? vertices[i] : vertices[i + 1];
+      for (nav2_util::LineIterator line(start.first, start.second, end.first, end.second);
+        line.isValid(); line.advance())
+      {
+        cells.emplace_back(line.getY(), line.getX());
+      }
+    }
+
+    // Read each cell once, row by row
+    std::sort(cells.begin(), cells.end());
+    cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+
+    FootprintKernel & kernel = kernels_[heading];
+    kernel.offsets.reserve(cells.size());
+    for (const auto & cell : cells) {
+      kernel.offsets.push_back(cell.first * size_x + cell.second);
+      kernel.min_dx = std::min(kernel.min_dx, cell.second);
+      kernel.max_dx = std::max(kernel.max_dx, cell.second);
+      kernel.min_dy = std::min(kernel.min_dy, cell.first);
+      kernel.max_dy = std::max(kernel.max_dy, cell.first);
+    }
+  }
+}
+
 // declare our valid template parameters
 template class FootprintCollisionChecker<std::shared_ptr<nav2_costmap_2d::Costmap2D>>;
+template class FootprintCollisionChecker<std::shared_ptr<const nav2_costmap_2d::Costmap2D>>;
 template class FootprintCollisionChecker<nav2_costmap_2d::Costmap2D *>;
 
 }  // namespace nav2_costmap_2d
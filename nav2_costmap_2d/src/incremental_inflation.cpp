@@ -0,0 +1,176 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_costmap_2d/incremental_inflation.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+namespace nav2_costmap_2d
+{
+
+void IncrementalInflation::reset(
+  unsigned int size_x, unsigned int size_y, unsigned int cell_radius)
+{
+  size_x_ = size_x;
+  size_y_ = size_y;
+  cell_radius_ = cell_radius;
+  max_distance_ = cell_radius * cell_radius;
+
+  const unsigned int size = size_x * size_y;
+  obstacles_.assign(size, 0);
+  to_raise_.assign(size, 0);
+  sources_.assign(size, NO_SOURCE);
+  distances_.assign(size, NO_DISTANCE);
+
+  queue_.clear();
+  queue_.resize(max_distance_ + 1);
+  queue_min_ = queue_.size();
+}
+
+size_t IncrementalInflation::getMemoryUsage() const
+{
+  size_t bytes = obstacles_.capacity() + to_raise_.capacity() +
+    sources_.capacity() * sizeof(int) + distances_.capacity() * sizeof(unsigned int) +
+    queue_.capacity() * sizeof(std::vector<unsigned int>);
+  for (const auto & bucket : queue_) {
+    bytes += bucket.capacity() * sizeof(unsigned int);
+  }
+  return bytes;
+}
+
+void IncrementalInflation::shift(int cell_ox, int cell_oy)
+{
+  const int size_x = size_x_;
+  const int size_y = size_y_;
+  const unsigned int size = size_x_ * size_y_;
+  std::vector<uint8_t> obstacles(size, 0);
+  std::vector<int> sources(size, NO_SOURCE);
+  std::vector<unsigned int> distances(size, NO_DISTANCE);
+
+  // Cell (x, y) in the new frame was cell (x + cell_ox, y + cell_oy) in the old frame
+  const int min_x = std::max(0, -cell_ox), max_x = std::min(size_x, size_x - cell_ox);
+  const int min_y = std::max(0, -cell_oy), max_y = std::min(size_y, size_y - cell_oy);
+  for (int y = min_y; y < max_y; y++) {
+    for (int x = min_x; x < max_x; x++) {
+      const unsigned int index = y * size_x + x;
+      const unsigned int old_index = (y + cell_oy) * size_x + (x + cell_ox);
+      obstacles[index] = obstacles_[old_index];
+
+      const int old_source = sources_[old_index];
+      if (old_source == NO_SOURCE) {
+        continue;
+      }
+
+      const int src_x = old_source % size_x - cell_ox;
+      const int src_y = old_source / size_x - cell_oy;
+      if (src_x < 0 || src_y < 0 || src_x >= size_x || src_y >= size_y) {
+        // Source was shifted out of the grid, clear this cell with a raise wave
+        to_raise_[index] = 1;
+        push(index, distances_[old_index]);
+        continue;
+      }
+
+      sources[index] = src_y * size_x + src_x;
+      distances[index] = distances_[old_index];
+
+      // Sources of cells bordering the exposed region need to be propagated into it
+      if (x == min_x || x == max_x - 1 || y == min_y || y == max_y - 1) {
+        push(index, distances[index]);
+      }
+    }
+  }
+
+  obstacles_.swap(obstacles);
+  sources_.swap(sources);
+  distances_.swap(distances);
+}
+
+void IncrementalInflation::propagate()
+{
+  const unsigned int queue_size = queue_.size();
+  while (true) {
+    while (queue_min_ < queue_size && queue_[queue_min_].empty()) {
+      queue_min_++;
+    }
+    if (queue_min_ >= queue_size) {
+      break;
+    }
+
+    auto & bucket = queue_[queue_min_];
+    const unsigned int index = bucket.back();
+    bucket.pop_back();
+
+    if (to_raise_[index]) {
+      raise(index);
+    } else if (sources_[index] != NO_SOURCE && obstacles_[sources_[index]]) {
+      lower(index);
+    }
+  }
+}
+
+void IncrementalInflation::raise(unsigned int index)
+{
+  const int x = index % size_x_;
+  const int y = index / size_x_;
+  for (int ny = std::max(y - 1, 0); ny <= std::min(y + 1, static_cast<int>(size_y_) - 1); ny++) {
+    for (int nx = std::max(x - 1, 0); nx <= std::min(x + 1, static_cast<int>(size_x_) - 1);
+      nx++)
+    {
+      const unsigned int n = ny * size_x_ + nx;
+      if (sources_[n] == NO_SOURCE || to_raise_[n]) {
+        continue;
+      }
+
+      push(n, distances_[n]);
+      if (!obstacles_[sources_[n]]) {
+        sources_[n] = NO_SOURCE;
+        distances_[n] = NO_DISTANCE;
+        to_raise_[n] = 1;
+      }
+    }
+  }
+  to_raise_[index] = 0;
+}
+
+void IncrementalInflation::lower(unsigned int index)
+{
+  const int source = sources_[index];
+  const int src_x = source % size_x_;
+  const int src_y = source / size_x_;
+  const int x = index % size_x_;
+  const int y = index / size_x_;
+  for (int ny = std::max(y - 1, 0); ny <= std::min(y + 1, static_cast<int>(size_y_) - 1); ny++) {
+    for (int nx = std::max(x - 1, 0); nx <= std::min(x + 1, static_cast<int>(size_x_) - 1);
+      nx++)
+    {
+      const unsigned int n = ny * size_x_ + nx;
+      if (to_raise_[n]) {
+        continue;
+      }
+
+      const unsigned int dx = std::abs(nx - src_x);
+      const unsigned int dy = std::abs(ny - src_y);
+      const unsigned int distance = dx * dx + dy * dy;
+      if (distance <= max_distance_ && distance < distances_[n]) {
+        distances_[n] = distance;
+        sources_[n] = source;
+        push(n, distance);
+      }
+    }
+  }
+}
+
+}  // namespace nav2_costmap_2d
@@ -38,13 +38,19 @@
 #include "nav2_costmap_2d/layered_costmap.hpp"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <cstdio>
+#include <future>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 #include <limits>
 
 #include "nav2_costmap_2d/footprint.hpp"
+#include "nav2_util/tracing.hpp"
 
 
 using std::vector;
@@ -52,6 +58,16 @@ using std::vector;
 namespace nav2_costmap_2d
 {
 
+namespace
+{
+
+double secondsSince(const std::chrono::steady_clock::time_point & start)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
 LayeredCostmap::LayeredCostmap(std::string global_frame, bool rolling_window, bool track_unknown)
 : primary_costmap_(), combined_costmap_(),
   global_frame_(global_frame),
@@ -67,9 +83,11 @@ LayeredCostmap::LayeredCostmap(std::string global_frame, bool rolling_window, bo
   byn_(0),
   initialized_(false),
   size_locked_(false),
+  parallel_layer_updates_(false),
   circumscribed_radius_(1.0),
   inscribed_radius_(0.1),
-  footprint_(std::make_shared<std::vector<geometry_msgs::msg::Point>>())
+  footprint_(std::make_shared<std::vector<geometry_msgs::msg::Point>>()),
+  snapshots_requested_(false)
 {
   if (track_unknown) {
     primary_costmap_.setDefaultValue(255);
@@ -78,6 +96,8 @@ LayeredCostmap::LayeredCostmap(std::string global_frame, bool rolling_window, bo
     primary_costmap_.setDefaultValue(0);
     combined_costmap_.setDefaultValue(0);
   }
+  primary_costmap_.setMemoryTag("costmap_2d/master");
+  combined_costmap_.setMemoryTag("costmap_2d/master");
 }
 
 LayeredCostmap::~LayeredCostmap()
@@ -94,12 +114,48 @@ void LayeredCostmap::addPlugin(std::shared_ptr<Layer> plugin)
 {
   std::unique_lock<Costmap2D::mutex_t> lock(*(combined_costmap_.getMutex()));
   plugins_.push_back(plugin);
+  plugin_schedules_.emplace_back();
 }
 
 void LayeredCostmap::addFilter(std::shared_ptr<Layer> filter)
 {
   std::unique_lock<Costmap2D::mutex_t> lock(*(combined_costmap_.getMutex()));
   filters_.push_back(filter);
+  filter_schedules_.emplace_back();
+}
+
+bool LayeredCostmap::setLayerDecimation(const std::string & name, unsigned int decimation)
+{
+  std::unique_lock<Costmap2D::mutex_t> lock(*(combined_costmap_.getMutex()));
+  bool found = false;
+  for (size_t i = 0; i < plugins_.size(); ++i) {
+    if (plugins_[i]->getName() == name) {
+      plugin_schedules_[i].decimation = std::max(decimation, 1u);
+      plugin_schedules_[i].records = true;
+      found = true;
+    }
+  }
+  for (size_t i = 0; i < filters_.size(); ++i) {
+    if (filters_[i]->getName() == name) {
+      filter_schedules_[i].decimation = std::max(decimation, 1u);
+      filter_schedules_[i].records = true;
+      found = true;
+    }
+  }
+  return found;
+}
+
+std::vector<std::pair<std::string, double>> LayeredCostmap::getLayerUpdateTimes()
+{
+  std::unique_lock<Costmap2D::mutex_t> lock(*(combined_costmap_.getMutex()));
+  std::vector<std::pair<std::string, double>> times;
+  for (size_t i = 0; i < plugins_.size(); ++i) {
+    times.emplace_back(plugins_[i]->getName(), plugin_schedules_[i].update_time);
+  }
+  for (size_t i = 0; i < filters_.size(); ++i) {
+    times.emplace_back(filters_[i]->getName(), filter_schedules_[i].update_time);
+  }
+  return times;
 }
 
 void LayeredCostmap::resizeMap(
@@ -112,6 +168,13 @@ void LayeredCostmap::resizeMap(
   size_locked_ = size_locked;
   primary_costmap_.resizeMap(size_x, size_y, resolution, origin_x, origin_y);
   combined_costmap_.resizeMap(size_x, size_y, resolution, origin_x, origin_y);
+  markAllCellsUpdated();
+  // The layers set their costs again over the new map
+  for (auto * schedules : {&plugin_schedules_, &filter_schedules_}) {
+    for (LayerSchedule & schedule : *schedules) {
+      schedule.costs.reset();
+    }
+  }
   for (vector<std::shared_ptr<Layer>>::iterator plugin = plugins_.begin();
     plugin != plugins_.end(); ++plugin)
   {
@@ -132,6 +195,8 @@ bool LayeredCostmap::isOutofBounds(double robot_x, double robot_y)
 
 void LayeredCostmap::updateMap(double robot_x, double robot_y, double robot_yaw)
 {
+  NAV2_TRACE_SCOPE("LayeredCostmap::updateMap");
+
   // Lock for the remainder of this function, some plugins (e.g. VoxelLayer)
   // implement thread unsafe updateBounds() functions.
   std::unique_lock<Costmap2D::mutex_t> lock(*(combined_costmap_.getMutex()));
@@ -141,8 +206,20 @@ void LayeredCostmap::updateMap(double robot_x, double robot_y, double robot_yaw)
   if (rolling_window_) {
     double new_origin_x = robot_x - combined_costmap_.getSizeInMetersX() / 2;
     double new_origin_y = robot_y - combined_costmap_.getSizeInMetersY() / 2;
+    const double origin_x = combined_costmap_.getOriginX();
+    const double origin_y = combined_costmap_.getOriginY();
     primary_costmap_.updateOrigin(new_origin_x, new_origin_y);
     combined_costmap_.updateOrigin(new_origin_x, new_origin_y);
+    if (combined_costmap_.getOriginX() != origin_x || combined_costmap_.getOriginY() != origin_y) {
+      markAllCellsUpdated();
+      for (auto * schedules : {&plugin_schedules_, &filter_schedules_}) {
+        for (LayerSchedule & schedule : *schedules) {
+          if (schedule.costs) {
+            schedule.costs->updateOrigin(new_origin_x, new_origin_y);
+          }
+        }
+      }
+    }
   }
 
   if (isOutofBounds(robot_x, robot_y)) {
@@ -152,38 +229,47 @@ void LayeredCostmap::updateMap(double robot_x, double robot_y, double robot_yaw)
   }
 
   if (plugins_.size() == 0 && filters_.size() == 0) {
+    if (snapshots_requested_) {
+      updateSnapshot();
+    }
     return;
   }
 
   minx_ = miny_ = std::numeric_limits<double>::max();
   maxx_ = maxy_ = std::numeric_limits<double>::lowest();
 
-  for (vector<std::shared_ptr<Layer>>::iterator plugin = plugins_.begin();
-    plugin != plugins_.end(); ++plugin)
-  {
-    double prev_minx = minx_;
-    double prev_miny = miny_;
-    double prev_maxx = maxx_;
-    double prev_maxy = maxy_;
-    (*plugin)->updateBounds(robot_x, robot_y, robot_yaw, &minx_, &miny_, &maxx_, &maxy_);
-    if (minx_ > prev_minx || miny_ > prev_miny || maxx_ < prev_maxx || maxy_ < prev_maxy) {
-      RCLCPP_WARN(
-        rclcpp::get_logger(
-          "nav2_costmap_2d"), "Illegal bounds change, was [tl: (%f, %f), br: (%f, %f)], but "
-        "is now [tl: (%f, %f), br: (%f, %f)]. The offending layer is %s",
-        prev_minx, prev_miny, prev_maxx, prev_maxy,
-        minx_, miny_, maxx_, maxy_,
-        (*plugin)->getName().c_str());
+  // decimated layers are only updated once every so many updates
+  for (auto * schedules : {&plugin_schedules_, &filter_schedules_}) {
+    for (LayerSchedule & schedule : *schedules) {
+      if (schedule.records && !schedule.costs) {
+        schedule.costs = std::make_unique<Costmap2D>(
+          combined_costmap_.getSizeInCellsX(), combined_costmap_.getSizeInCellsY(),
+          combined_costmap_.getResolution(), combined_costmap_.getOriginX(),
+          combined_costmap_.getOriginY(), NO_INFORMATION);
+        schedule.costs->setMemoryTag("costmap_2d/decimated_layers");
+      }
+      schedule.runs = schedule.skipped + 1 >= schedule.decimation;
+      schedule.skipped = schedule.runs ? 0 : schedule.skipped + 1;
     }
   }
-  for (vector<std::shared_ptr<Layer>>::iterator filter = filters_.begin();
-    filter != filters_.end(); ++filter)
+
   {
+    NAV2_TRACE_SCOPE("LayeredCostmap::updateBounds");
+    updatePluginBounds(robot_x, robot_y, robot_yaw);
+  }
+
+  for (size_t i = 0; i < filters_.size(); ++i) {
+    if (!filter_schedules_[i].runs) {
+      continue;
+    }
+    const std::shared_ptr<Layer> & filter = filters_[i];
     double prev_minx = minx_;
     double prev_miny = miny_;
     double prev_maxx = maxx_;
     double prev_maxy = maxy_;
-    (*filter)->updateBounds(robot_x, robot_y, robot_yaw, &minx_, &miny_, &maxx_, &maxy_);
+    const auto start = std::chrono::steady_clock::now();
+    filter->updateBounds(robot_x, robot_y, robot_yaw, &minx_, &miny_, &maxx_, &maxy_);
+    filter_schedules_[i].update_time = secondsSince(start);
     if (minx_ > prev_minx || miny_ > prev_miny || maxx_ < prev_maxx || maxy_ < prev_maxy) {
       RCLCPP_WARN(
         rclcpp::get_logger(
@@ -191,10 +277,12 @@ void LayeredCostmap::updateMap(double robot_x, double robot_y, double robot_yaw)
         "is now [tl: (%f, %f), br: (%f, %f)]. The offending filter is %s",
         prev_minx, prev_miny, prev_maxx, prev_maxy,
         minx_, miny_, maxx_, maxy_,
-        (*filter)->getName().c_str());
+        filter->getName().c_str());
     }
   }
 
+  catchUpSkippedWindows();
+
   int x0, xn, y0, yn;
   combined_costmap_.worldToMapEnforceBounds(minx_, miny_, x0, y0);
   combined_costmap_.worldToMapEnforceBounds(maxx_, maxy_, xn, yn);
@@ -209,25 +297,24 @@ void LayeredCostmap::updateMap(double robot_x, double robot_y, double robot_yaw)
       "nav2_costmap_2d"), "Updating area x: [%d, %d] y: [%d, %d]", x0, xn, y0, yn);
 
   if (xn < x0 || yn < y0) {
+    if (snapshots_requested_) {
+      updateSnapshot();
+    }
     return;
   }
 
   if (filters_.size() == 0) {
     // If there are no filters enabled just update costmap sequentially by each plugin
     combined_costmap_.resetMap(x0, y0, xn, yn);
-    for (vector<std::shared_ptr<Layer>>::iterator plugin = plugins_.begin();
-      plugin != plugins_.end(); ++plugin)
-    {
-      (*plugin)->updateCosts(combined_costmap_, x0, y0, xn, yn);
+    for (size_t i = 0; i < plugins_.size(); ++i) {
+      updateLayerCosts(plugins_[i], plugin_schedules_[i], combined_costmap_, x0, y0, xn, yn);
     }
   } else {
     // Costmap Filters enabled
     // 1. Update costmap by plugins
     primary_costmap_.resetMap(x0, y0, xn, yn);
-    for (vector<std::shared_ptr<Layer>>::iterator plugin = plugins_.begin();
-      plugin != plugins_.end(); ++plugin)
-    {
-      (*plugin)->updateCosts(primary_costmap_, x0, y0, xn, yn);
+    for (size_t i = 0; i < plugins_.size(); ++i) {
+      updateLayerCosts(plugins_[i], plugin_schedules_[i], primary_costmap_, x0, y0, xn, yn);
     }
 
     // 2. Copy processed costmap window to a final costmap.
@@ -242,10 +329,8 @@ void LayeredCostmap::updateMap(double robot_x, double robot_y, double robot_yaw)
 
     // 3. Apply filters over the plugins in order to make filters' work
     // not being considered by plugins on next updateMap() calls
-    for (vector<std::shared_ptr<Layer>>::iterator filter = filters_.begin();
-      filter != filters_.end(); ++filter)
-    {
-      (*filter)->updateCosts(combined_costmap_, x0, y0, xn, yn);
+    for (size_t i = 0; i < filters_.size(); ++i) {
+      updateLayerCosts(filters_[i], filter_schedules_[i], combined_costmap_, x0, y0, xn, yn);
     }
   }
 
@@ -253,8 +338,250 @@ void LayeredCostmap::updateMap(double robot_x, double robot_y, double robot_yaw)
   bxn_ = xn;
   by0_ = y0;
   byn_ = yn;
+  recordUpdatedWindow(x0, xn, y0, yn);
 
   initialized_ = true;
+
+  if (snapshots_requested_) {
+    updateSnapshot();
+  }
+}
+
+uint64_t LayeredCostmap::getUpdateCount()
+{
+  std::unique_lock<Costmap2D::mutex_t> lock(*(combined_costmap_.getMutex()));
+  return update_count_;
+}
+
+bool LayeredCostmap::getUpdatedWindowSince(
+  uint64_t update_count, unsigned int & x0, unsigned int & xn,
+  unsigned int & y0, unsigned int & yn)
+{
+  std::unique_lock<Costmap2D::mutex_t> lock(*(combined_costmap_.getMutex()));
+  if (update_count < updates_known_since_ || update_count > update_count_ ||
+    update_count_ - update_count > UPDATED_WINDOWS_HISTORY)
+  {
+    return false;
+  }
+
+  x0 = y0 = std::numeric_limits<unsigned int>::max();
+  xn = yn = 0;
+  for (uint64_t i = update_count + 1; i <= update_count_; i++) {
+    const std::array<unsigned int, 4> & window = updated_windows_[i % UPDATED_WINDOWS_HISTORY];
+    x0 = std::min(x0, window[0]);
+    xn = std::max(xn, window[1]);
+    y0 = std::min(y0, window[2]);
+    yn = std::max(yn, window[3]);
+  }
+  if (x0 >= xn || y0 >= yn) {
+    x0 = xn = y0 = yn = 0;
+  }
+  return true;
+}
+
+void LayeredCostmap::markAllCellsUpdated()
+{
+  std::unique_lock<Costmap2D::mutex_t> lock(*(combined_costmap_.getMutex()));
+  updates_known_since_ = ++update_count_;
+}
+
+void LayeredCostmap::recordUpdatedWindow(
+  unsigned int x0, unsigned int xn, unsigned int y0, unsigned int yn)
+{
+  updated_windows_[++update_count_ % UPDATED_WINDOWS_HISTORY] = {x0, xn, y0, yn};
+}
+
+std::shared_ptr<const Costmap2D> LayeredCostmap::getCostmapSnapshot()
+{
+  if (!snapshots_requested_) {
+    std::unique_lock<Costmap2D::mutex_t> lock(*(combined_costmap_.getMutex()));
+    if (!snapshots_requested_) {
+      updateSnapshot();
+      snapshots_requested_ = true;
+    }
+  }
+  return std::atomic_load(&snapshot_);
+}
+
+void LayeredCostmap::updateSnapshot()
+{
+  // Readers holding the spare snapshot keep it alive, a new buffer is needed then
+  std::shared_ptr<Costmap2D> snapshot;
+  if (spare_snapshot_ && spare_snapshot_.use_count() == 1) {
+    // Order the copy after the reads of the last reader which released it
+    std::atomic_thread_fence(std::memory_order_acquire);
+    snapshot.swap(spare_snapshot_);
+    *snapshot = combined_costmap_;
+  } else {
+    spare_snapshot_.reset();
+    snapshot = std::make_shared<Costmap2D>(combined_costmap_);
+    snapshot->setMemoryTag("costmap_2d/snapshots");
+  }
+  snapshot->setDefaultValue(combined_costmap_.getDefaultValue());
+
+  std::shared_ptr<const Costmap2D> previous = std::atomic_exchange(
+    &snapshot_, std::shared_ptr<const Costmap2D>(snapshot));
+  spare_snapshot_ = std::const_pointer_cast<Costmap2D>(previous);
+}
+
+void LayeredCostmap::updatePluginBounds(double robot_x, double robot_y, double robot_yaw)
+{
+  using Bounds = std::array<double, 4>;
+  auto check_bounds = [](
+    const std::shared_ptr<Layer> & plugin, const Bounds & prev, const Bounds & bounds) {
+      if (bounds[0] > prev[0] || bounds[1] > prev[1] || bounds[2] < prev[2] ||
+        bounds[3] < prev[3])
+      {
+        RCLCPP_WARN(
+          rclcpp::get_logger(
+            "nav2_costmap_2d"), "Illegal bounds change, was [tl: (%f, %f), br: (%f, %f)], but "
+          "is now [tl: (%f, %f), br: (%f, %f)]. The offending layer is %s",
+          prev[0], prev[1], prev[2], prev[3],
+          bounds[0], bounds[1], bounds[2], bounds[3],
+          plugin->getName().c_str());
+      }
+    };
+
+  size_t i = 0;
+  while (i < plugins_.size()) {
+    size_t group_end = i + 1;
+    if (parallel_layer_updates_ && plugins_[i]->hasIndependentBounds()) {
+      while (group_end < plugins_.size() && plugins_[group_end]->hasIndependentBounds()) {
+        group_end++;
+      }
+    }
+
+    const Bounds prev = {minx_, miny_, maxx_, maxy_};
+    if (group_end - i == 1) {
+      if (plugin_schedules_[i].runs) {
+        const auto start = std::chrono::steady_clock::now();
+        plugins_[i]->updateBounds(robot_x, robot_y, robot_yaw, &minx_, &miny_, &maxx_, &maxy_);
+        plugin_schedules_[i].update_time = secondsSince(start);
+        check_bounds(plugins_[i], prev, {minx_, miny_, maxx_, maxy_});
+      }
+      i = group_end;
+      continue;
+    }
+
+    // Independent plugins only grow the bounds by their own updates, so they can all
+    // start from the bounds so far and be merged afterwards for the same result
+    std::vector<Bounds> bounds(group_end - i, prev);
+    auto update_bounds = [&](size_t j) {
+        if (!plugin_schedules_[j].runs) {
+          return;
+        }
+        Bounds & b = bounds[j - i];
+        const auto start = std::chrono::steady_clock::now();
+        plugins_[j]->updateBounds(robot_x, robot_y, robot_yaw, &b[0], &b[1], &b[2], &b[3]);
+        plugin_schedules_[j].update_time = secondsSince(start);
+      };
+    std::vector<std::future<void>> updates;
+    for (size_t j = i + 1; j < group_end; ++j) {
+      updates.push_back(std::async(std::launch::async, update_bounds, j));
+    }
+    update_bounds(i);
+    for (auto & update : updates) {
+      update.get();
+    }
+
+    for (size_t j = i; j < group_end; ++j) {
+      const Bounds & b = bounds[j - i];
+      check_bounds(plugins_[j], prev, b);
+      minx_ = std::min(minx_, b[0]);
+      miny_ = std::min(miny_, b[1]);
+      maxx_ = std::max(maxx_, b[2]);
+      maxy_ = std::max(maxy_, b[3]);
+    }
+    i = group_end;
+  }
+}
+
+void LayeredCostmap::updateLayerCosts(
+  const std::shared_ptr<Layer> & layer, LayerSchedule & schedule, Costmap2D & costmap,
+  int x0, int y0, int xn, int yn)
+{
+  unsigned char * master = costmap.getCharMap();
+  const unsigned int size_x = costmap.getSizeInCellsX();
+
+  if (!schedule.runs) {
+    // The window was reset, so put back the costs the layer set in its last updates
+    if (schedule.costs) {
+      const unsigned char * costs = schedule.costs->getCharMap();
+      for (int j = y0; j < yn; j++) {
+        for (unsigned int it = j * size_x + x0; it < j * size_x + xn; it++) {
+          const unsigned char cost = costs[it];
+          if (cost != NO_INFORMATION && (master[it] == NO_INFORMATION || master[it] < cost)) {
+            master[it] = cost;
+          }
+        }
+      }
+    }
+    return;
+  }
+
+  if (schedule.costs) {
+    window_costs_.resize(static_cast<size_t>(xn - x0) * (yn - y0));
+    auto window_it = window_costs_.begin();
+    for (int j = y0; j < yn; j++) {
+      window_it = std::copy(master + j * size_x + x0, master + j * size_x + xn, window_it);
+    }
+  }
+
+  {
+    NAV2_TRACE_SCOPE(layer->getName().c_str());
+    const auto start = std::chrono::steady_clock::now();
+    layer->updateCosts(costmap, x0, y0, xn, yn);
+    schedule.update_time += secondsSince(start);
+  }
+
+  if (schedule.costs) {
+    // The costs the layer set are those it changed
+    unsigned char * costs = schedule.costs->getCharMap();
+    auto window_it = window_costs_.cbegin();
+    for (int j = y0; j < yn; j++) {
+      for (unsigned int it = j * size_x + x0; it < j * size_x + xn; it++, window_it++) {
+        costs[it] = master[it] != *window_it ? master[it] : NO_INFORMATION;
+      }
+    }
+  }
+}
+
+void LayeredCostmap::catchUpSkippedWindows()
+{
+  for (auto * schedules : {&plugin_schedules_, &filter_schedules_}) {
+    for (LayerSchedule & schedule : *schedules) {
+      if (schedule.runs && schedule.has_skipped_window) {
+        minx_ = std::min(minx_, schedule.skipped_minx);
+        miny_ = std::min(miny_, schedule.skipped_miny);
+        maxx_ = std::max(maxx_, schedule.skipped_maxx);
+        maxy_ = std::max(maxy_, schedule.skipped_maxy);
+        schedule.has_skipped_window = false;
+      }
+    }
+  }
+
+  if (minx_ > maxx_ || miny_ > maxy_) {
+    return;
+  }
+  for (auto * schedules : {&plugin_schedules_, &filter_schedules_}) {
+    for (LayerSchedule & schedule : *schedules) {
+      if (schedule.runs) {
+        continue;
+      }
+      if (!schedule.has_skipped_window) {
+        schedule.skipped_minx = minx_;
+        schedule.skipped_miny = miny_;
+        schedule.skipped_maxx = maxx_;
+        schedule.skipped_maxy = maxy_;
+        schedule.has_skipped_window = true;
+      } else {
+        schedule.skipped_minx = std::min(schedule.skipped_minx, minx_);
+        schedule.skipped_miny = std::min(schedule.skipped_miny, miny_);
+        schedule.skipped_maxx = std::max(schedule.skipped_maxx, maxx_);
+        schedule.skipped_maxy = std::max(schedule.skipped_maxy, maxy_);
+      }
+    }
+  }
 }
 
 bool LayeredCostmap::isCurrent()
@@ -0,0 +1,81 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "nav2_costmap_2d/multi_resolution_costmap.hpp"
+
+#include <vector>
+
+#include "nav2_costmap_2d/cost_values.hpp"
+#include "nav2_costmap_2d/footprint_collision_checker.hpp"
+
+namespace nav2_costmap_2d
+{
+
+MultiResolutionCostmap::MultiResolutionCostmap(Costmap2D * outer, Costmap2D * inner)
+: outer_(outer), inner_(inner)
+{
+}
+
+MultiResolutionCostmap::Lock MultiResolutionCostmap::lock() const
+{
+  Lock lock;
+  lock.outer = std::unique_lock<Costmap2D::mutex_t>(*outer_->getMutex());
+  if (inner_) {
+    lock.inner = std::unique_lock<Costmap2D::mutex_t>(*inner_->getMutex());
+  }
+  return lock;
+}
+
+Costmap2D * MultiResolutionCostmap::getCostmapAt(double wx, double wy) const
+{
+  unsigned int mx, my;
+  if (inner_ && inner_->worldToMap(wx, wy, mx, my)) {
+    return inner_;
+  }
+  return outer_;
+}
+
+unsigned char MultiResolutionCostmap::getCost(double wx, double wy) const
+{
+  unsigned int mx, my;
+  if (inner_ && inner_->worldToMap(wx, wy, mx, my)) {
+    return inner_->getCost(mx, my);
+  }
+  if (outer_->worldToMap(wx, wy, mx, my)) {
+    return outer_->getCost(mx, my);
+  }
+  return NO_INFORMATION;
+}
+
+double MultiResolutionCostmap::footprintCost(
+  const std::vector<geometry_msgs::msg::Point> & footprint) const
+{
+  // The windows are rectangles, so they cover the footprint if they cover its vertices
+  Costmap2D * costmap = inner_;
+  unsigned int mx, my;
+  for (const auto & point : footprint) {
+    if (costmap && !costmap->worldToMap(point.x, point.y, mx, my)) {
+      costmap = nullptr;
+    }
+  }
+  if (!costmap) {
+    costmap = outer_;
+  }
+
+  FootprintCollisionChecker<Costmap2D *> collision_checker(costmap);
+  return collision_checker.footprintCost(footprint);
+}
+
+}  // namespace nav2_costmap_2d
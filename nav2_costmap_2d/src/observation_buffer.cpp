@@ -37,11 +37,12 @@
 #include "nav2_costmap_2d/observation_buffer.hpp"
 
 #include <algorithm>
-#include <list>
+#include <memory>
 #include <string>
 #include <vector>
 #include <chrono>
 
+#include "Eigen/Geometry"
 #include "tf2/convert.h"
 #include "sensor_msgs/point_cloud2_iterator.hpp"
 using namespace std::chrono_literals;
@@ -74,6 +75,11 @@ ObservationBuffer::ObservationBuffer(
   clock_ = node->get_clock();
   logger_ = node->get_logger();
   last_updated_ = node->now();
+
+  // Only the latest observation is kept without a keep time, next to the slot of the
+  // one being made, otherwise the ring grows to the number of observations made within it
+  observations_.resize(observation_keep_time_ == rclcpp::Duration(0.0s) ? 2 : 4);
+  latest_ = observations_.size() - 1;
 }
 
 ObservationBuffer::~ObservationBuffer()
@@ -84,8 +90,9 @@ void ObservationBuffer::bufferCloud(const sensor_msgs::msg::PointCloud2 & cloud)
 {
   geometry_msgs::msg::PointStamped global_origin;
 
-  // create a new observation on the list to be populated
-  observation_list_.push_front(Observation());
+  // get the slot of the new observation to be populated, which is only
+  // pushed into the buffer once it is complete
+  Observation & observation = nextObservation();
 
   // check whether the origin frame has been set explicitly
   // or whether we should get it from the cloud
@@ -101,50 +108,61 @@ void ObservationBuffer::bufferCloud(const sensor_msgs::msg::PointCloud2 & cloud)
     local_origin.point.y = 0;
     local_origin.point.z = 0;
     tf2_buffer_.transform(local_origin, global_origin, global_frame_, tf_tolerance_);
-    tf2::convert(global_origin.point, observation_list_.front().origin_);
+    tf2::convert(global_origin.point, observation.origin_);
 
     // make sure to pass on the raytrace/obstacle range
     // of the observation buffer to the observations
-    observation_list_.front().raytrace_max_range_ = raytrace_max_range_;
-    observation_list_.front().raytrace_min_range_ = raytrace_min_range_;
-    observation_list_.front().obstacle_max_range_ = obstacle_max_range_;
-    observation_list_.front().obstacle_min_range_ = obstacle_min_range_;
-
-    sensor_msgs::msg::PointCloud2 global_frame_cloud;
-
-    // transform the point cloud
-    tf2_buffer_.transform(cloud, global_frame_cloud, global_frame_, tf_tolerance_);
-    global_frame_cloud.header.stamp = cloud.header.stamp;
-
-    // now we need to remove observations from the cloud that are below
-    // or above our height thresholds
-    sensor_msgs::msg::PointCloud2 & observation_cloud = *(observation_list_.front().cloud_);
-    observation_cloud.height = global_frame_cloud.height;
-    observation_cloud.width = global_frame_cloud.width;
-    observation_cloud.fields = global_frame_cloud.fields;
-    observation_cloud.is_bigendian = global_frame_cloud.is_bigendian;
-    observation_cloud.point_step = global_frame_cloud.point_step;
-    observation_cloud.row_step = global_frame_cloud.row_step;
-    observation_cloud.is_dense = global_frame_cloud.is_dense;
-
-    unsigned int cloud_size = global_frame_cloud.height * global_frame_cloud.width;
+    observation.raytrace_max_range_ = raytrace_max_range_;
+    observation.raytrace_min_range_ = raytrace_min_range_;
+    observation.obstacle_max_range_ = obstacle_max_range_;
+    observation.obstacle_min_range_ = obstacle_min_range_;
+
+    // transform the points, and remove those that are below or above our height
+    // thresholds, in a single pass into the observation cloud
+    geometry_msgs::msg::TransformStamped transform = tf2_buffer_.lookupTransform(
+      global_frame_, tf2::getFrameId(cloud), tf2::getTimestamp(cloud), tf_tolerance_);
+    const Eigen::Transform<float, 3, Eigen::Affine> global_transform =
+      Eigen::Translation3f(
+      transform.transform.translation.x, transform.transform.translation.y,
+      transform.transform.translation.z) *
+      Eigen::Quaternion<float>(
+      transform.transform.rotation.w, transform.transform.rotation.x,
+      transform.transform.rotation.y, transform.transform.rotation.z);
+
+    sensor_msgs::msg::PointCloud2 & observation_cloud = *(observation.cloud_);
+    observation_cloud.height = cloud.height;
+    observation_cloud.width = cloud.width;
+    observation_cloud.fields = cloud.fields;
+    observation_cloud.is_bigendian = cloud.is_bigendian;
+    observation_cloud.point_step = cloud.point_step;
+    observation_cloud.row_step = cloud.row_step;
+    observation_cloud.is_dense = cloud.is_dense;
+
+    unsigned int cloud_size = cloud.height * cloud.width;
     sensor_msgs::PointCloud2Modifier modifier(observation_cloud);
     modifier.resize(cloud_size);
     unsigned int point_count = 0;
 
-    // copy over the points that are within our height bounds
-    sensor_msgs::PointCloud2Iterator<float> iter_z(global_frame_cloud, "z");
-    std::vector<unsigned char>::const_iterator iter_global = global_frame_cloud.data.begin(),
-      iter_global_end = global_frame_cloud.data.end();
+    // copy over the points that are within our height bounds, with their transformed x, y, z
+    sensor_msgs::PointCloud2ConstIterator<float> iter_x(cloud, "x");
+    sensor_msgs::PointCloud2ConstIterator<float> iter_y(cloud, "y");
+    sensor_msgs::PointCloud2ConstIterator<float> iter_z(cloud, "z");
+    sensor_msgs::PointCloud2Iterator<float> iter_obs_x(observation_cloud, "x");
+    sensor_msgs::PointCloud2Iterator<float> iter_obs_y(observation_cloud, "y");
+    sensor_msgs::PointCloud2Iterator<float> iter_obs_z(observation_cloud, "z");
+    std::vector<unsigned char>::const_iterator iter_cloud = cloud.data.begin();
     std::vector<unsigned char>::iterator iter_obs = observation_cloud.data.begin();
-    for (; iter_global != iter_global_end; ++iter_z, iter_global +=
-      global_frame_cloud.point_step)
-    {
-      if ((*iter_z) <= max_obstacle_height_ &&
-        (*iter_z) >= min_obstacle_height_)
-      {
-        std::copy(iter_global, iter_global + global_frame_cloud.point_step, iter_obs);
-        iter_obs += global_frame_cloud.point_step;
+    for (; iter_x != iter_x.end(); ++iter_x, ++iter_y, ++iter_z, iter_cloud += cloud.point_step) {
+      const Eigen::Vector3f point = global_transform * Eigen::Vector3f(*iter_x, *iter_y, *iter_z);
+      if (point.z() <= max_obstacle_height_ && point.z() >= min_obstacle_height_) {
+        std::copy(iter_cloud, iter_cloud + cloud.point_step, iter_obs);
+        *iter_obs_x = point.x();
+        *iter_obs_y = point.y();
+        *iter_obs_z = point.z();
+        iter_obs += cloud.point_step;
+        ++iter_obs_x;
+        ++iter_obs_y;
+        ++iter_obs_z;
         ++point_count;
       }
     }
@@ -152,10 +170,9 @@ void ObservationBuffer::bufferCloud(const sensor_msgs::msg::PointCloud2 & cloud)
     // resize the cloud for the number of legal points
     modifier.resize(point_count);
     observation_cloud.header.stamp = cloud.header.stamp;
-    observation_cloud.header.frame_id = global_frame_cloud.header.frame_id;
+    observation_cloud.header.frame_id = transform.header.frame_id;
   } catch (tf2::TransformException & ex) {
-    // if an exception occurs, we need to remove the empty observation from the list
-    observation_list_.pop_front();
+    // if an exception occurs, the observation is left out of the buffer
     RCLCPP_ERROR(
       logger_,
       "TF Exception that should never happen for sensor frame: %s, cloud frame: %s, %s",
@@ -164,48 +181,92 @@ void ObservationBuffer::bufferCloud(const sensor_msgs::msg::PointCloud2 & cloud)
     return;
   }
 
-  // if the update was successful, we want to update the last updated time
+  // if the update was successful, we want to buffer the observation
+  // and update the last updated time
+  pushObservation();
   last_updated_ = clock_->now();
 
   // we'll also remove any stale observations from the list
   purgeStaleObservations();
 }
 
-// returns a copy of the observations
+// returns copies of the observations, sharing their point clouds
 void ObservationBuffer::getObservations(std::vector<Observation> & observations)
 {
   // first... let's make sure that we don't have any stale observations
   purgeStaleObservations();
 
-  // now we'll just copy the observations for the caller
-  std::list<Observation>::iterator obs_it;
-  for (obs_it = observation_list_.begin(); obs_it != observation_list_.end(); ++obs_it) {
-    observations.push_back(*obs_it);
+  // now we'll just copy the observations for the caller, latest first
+  observations.reserve(observations.size() + observation_count_);
+  for (size_t age = 0; age < observation_count_; ++age) {
+    observations.push_back(observationAt(age));
   }
 }
 
-void ObservationBuffer::purgeStaleObservations()
+bool ObservationBuffer::getLatestObservation(Observation & observation) const
 {
-  if (!observation_list_.empty()) {
-    std::list<Observation>::iterator obs_it = observation_list_.begin();
-    // if we're keeping observations for no time... then we'll only keep one observation
-    if (observation_keep_time_ == rclcpp::Duration(0.0s)) {
-      observation_list_.erase(++obs_it, observation_list_.end());
-      return;
-    }
+  if (observation_count_ == 0) {
+    return false;
+  }
+  observation = observations_[latest_];
+  return true;
+}
 
-    // otherwise... we'll have to loop through the observations to see which ones are stale
-    for (obs_it = observation_list_.begin(); obs_it != observation_list_.end(); ++obs_it) {
-      Observation & obs = *obs_it;
-      // check if the observation is out of date... and if it is,
-      // remove it and those that follow from the list
-      if ((clock_->now() - obs.cloud_->header.stamp) >
-        observation_keep_time_)
-      {
-        observation_list_.erase(obs_it, observation_list_.end());
-        return;
-      }
+void ObservationBuffer::bufferObservation(const Observation & observation)
+{
+  nextObservation() = observation;
+  pushObservation();
+  last_updated_ = clock_->now();
+  purgeStaleObservations();
+}
+
+Observation & ObservationBuffer::nextObservation()
+{
+  if (observation_count_ == observations_.size() &&
+    observation_keep_time_ != rclcpp::Duration(0.0s))
+  {
+    // the ring is full of observations which are not stale yet, so double it,
+    // keeping them in order from the oldest at its start
+    std::vector<Observation> observations(observations_.size() * 2);
+    for (size_t age = 0; age < observation_count_; ++age) {
+      observations[observation_count_ - 1 - age] = std::move(observationAt(age));
     }
+    observations_ = std::move(observations);
+    latest_ = observation_count_ - 1;
+  }
+
+  Observation & observation = observations_[(latest_ + 1) % observations_.size()];
+  if (observation.cloud_.use_count() != 1) {
+    // a copy of the observation in this slot is still in use, or it was
+    // moved out of the slot, so its point cloud can't be reused
+    observation.cloud_ = std::make_shared<sensor_msgs::msg::PointCloud2>();
+  }
+  return observation;
+}
+
+void ObservationBuffer::pushObservation()
+{
+  latest_ = (latest_ + 1) % observations_.size();
+  if (observation_keep_time_ == rclcpp::Duration(0.0s)) {
+    observation_count_ = 1;
+  } else {
+    observation_count_ = std::min(observation_count_ + 1, observations_.size());
+  }
+}
+
+void ObservationBuffer::purgeStaleObservations()
+{
+  // if we're keeping observations for no time... then the ring only holds the latest one
+  if (observation_keep_time_ == rclcpp::Duration(0.0s)) {
+    return;
+  }
+
+  // otherwise... drop the oldest observations while they are out of date
+  const rclcpp::Time now = clock_->now();
+  while (observation_count_ > 0 &&
+    (now - observationAt(observation_count_ - 1).cloud_->header.stamp) > observation_keep_time_)
+  {
+    --observation_count_;
   }
 }
 
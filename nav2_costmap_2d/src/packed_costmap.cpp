@@ -0,0 +1,128 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_costmap_2d/packed_costmap.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace nav2_costmap_2d
+{
+
+void PackedCostmap::resize(unsigned int size_x, unsigned int size_y, unsigned char value)
+{
+  size_x_ = size_x;
+  size_y_ = size_y;
+  bits_.resize((static_cast<size_t>(size_x) * size_y + 3) / 4);
+  reset(value);
+}
+
+void PackedCostmap::reset(unsigned char value)
+{
+  // The code repeated in the four cells of each byte
+  std::fill(bits_.begin(), bits_.end(), static_cast<uint8_t>(toCode(value) * 0x55));
+}
+
+void PackedCostmap::shift(int cell_ox, int cell_oy, unsigned char value)
+{
+  // cell (x, y) of the shifted costs was cell (x + cell_ox, y + cell_oy) of the costs
+  const int sx = size_x_, sy = size_y_;
+  const int min_x = std::min(std::max(-cell_ox, 0), sx);
+  const int max_x = std::max(std::min(sx - cell_ox, sx), min_x);
+  const int min_y = std::min(std::max(-cell_oy, 0), sy);
+  const int max_y = std::max(std::min(sy - cell_oy, sy), min_y);
+
+  // Rows are not aligned on bytes, so the cells are copied into new costs
+  const std::vector<uint8_t> bits = bits_;
+  reset(value);
+  for (int y = min_y; y < max_y; y++) {
+    for (int x = min_x; x < max_x; x++) {
+      const unsigned int from = (y + cell_oy) * sx + x + cell_ox;
+      setCost(y * sx + x, toCost((bits[from >> 2] >> ((from & 3) << 1)) & 3));
+    }
+  }
+}
+
+template<typename Combine>
+void PackedCostmap::combine(
+  Costmap2D & master_grid, int min_i, int min_j, int max_i, int max_j,
+  Combine combine_cell) const
+{
+  if (max_i <= min_i) {
+    return;
+  }
+
+  // Bytes of cells all unknown leave the master as is whatever the rule
+  constexpr uint8_t all_unknown = UNKNOWN_CODE * 0x55;
+  unsigned char * master = master_grid.getCharMap();
+  for (int j = min_j; j < max_j; j++) {
+    unsigned int it = j * size_x_ + min_i;
+    const unsigned int end = j * size_x_ + max_i;
+    for (; it < end && (it & 3) != 0; it++) {
+      master[it] = combine_cell(master[it], (bits_[it >> 2] >> ((it & 3) << 1)) & 3);
+    }
+    for (; it + 4 <= end; it += 4) {
+      const uint8_t byte = bits_[it >> 2];
+      if (byte == all_unknown) {
+        continue;
+      }
+      master[it] = combine_cell(master[it], byte & 3);
+      master[it + 1] = combine_cell(master[it + 1], (byte >> 2) & 3);
+      master[it + 2] = combine_cell(master[it + 2], (byte >> 4) & 3);
+      master[it + 3] = combine_cell(master[it + 3], byte >> 6);
+    }
+    for (; it < end; it++) {
+      master[it] = combine_cell(master[it], (bits_[it >> 2] >> ((it & 3) << 1)) & 3);
+    }
+  }
+}
+
+void PackedCostmap::updateWithMax(
+  Costmap2D & master_grid, int min_i, int min_j, int max_i, int max_j) const
+{
+  // A lethal cell is the maximum of any known cost, a free cell only replaces unknown ones
+  combine(
+    master_grid, min_i, min_j, max_i, max_j,
+    [](unsigned char old_cost, unsigned int code) -> unsigned char {
+      if (code == LETHAL_CODE) {
+        return LETHAL_OBSTACLE;
+      }
+      if (code == FREE_CODE && old_cost == NO_INFORMATION) {
+        return FREE_SPACE;
+      }
+      return old_cost;
+    });
+}
+
+void PackedCostmap::updateWithMaxWithoutUnknownOverwrite(
+  Costmap2D & master_grid, int min_i, int min_j, int max_i, int max_j) const
+{
+  combine(
+    master_grid, min_i, min_j, max_i, max_j,
+    [](unsigned char old_cost, unsigned int code) -> unsigned char {
+      return code == LETHAL_CODE && old_cost != NO_INFORMATION ? LETHAL_OBSTACLE : old_cost;
+    });
+}
+
+void PackedCostmap::updateWithOverwrite(
+  Costmap2D & master_grid, int min_i, int min_j, int max_i, int max_j) const
+{
+  combine(
+    master_grid, min_i, min_j, max_i, max_j,
+    [](unsigned char old_cost, unsigned int code) -> unsigned char {
+      return code == UNKNOWN_CODE ? old_cost : toCost(code);
+    });
+}
+
+}  // namespace nav2_costmap_2d
@@ -0,0 +1,95 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "nav2_costmap_2d/shared_observation_source.hpp"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace nav2_costmap_2d
+{
+
+std::shared_ptr<SharedObservationSource> SharedObservationSource::acquire(const std::string & key)
+{
+  static std::mutex mutex;
+  static std::map<std::string, std::weak_ptr<SharedObservationSource>> sources;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto source = sources[key].lock();
+  if (!source) {
+    source = std::make_shared<SharedObservationSource>();
+    sources[key] = source;
+  }
+  return source;
+}
+
+void SharedObservationSource::addBuffer(const std::shared_ptr<ObservationBuffer> & buffer)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  buffers_.erase(
+    std::remove_if(
+      buffers_.begin(), buffers_.end(),
+      [](const std::weak_ptr<ObservationBuffer> & b) {return b.expired();}),
+    buffers_.end());
+  buffers_.push_back(buffer);
+}
+
+bool SharedObservationSource::isProcessor(const void * layer)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (processor_ == nullptr) {
+    processor_ = layer;
+  }
+  return processor_ == layer;
+}
+
+void SharedObservationSource::release(const void * layer)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (processor_ == layer) {
+    processor_ = nullptr;
+  }
+}
+
+void SharedObservationSource::forward(const std::shared_ptr<ObservationBuffer> & buffer)
+{
+  Observation observation;
+  buffer->lock();
+  bool has_observation = buffer->getLatestObservation(observation);
+  buffer->unlock();
+  if (!has_observation) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (observation.cloud_ == last_cloud_) {
+    return;
+  }
+  last_cloud_ = observation.cloud_;
+  for (auto & weak_buffer : buffers_) {
+    auto other = weak_buffer.lock();
+    if (other && other != buffer) {
+      other->lock();
+      other->bufferObservation(observation);
+      other->unlock();
+    }
+  }
+}
+
+}  // namespace nav2_costmap_2d
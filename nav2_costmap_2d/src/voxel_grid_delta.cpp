@@ -0,0 +1,206 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_costmap_2d/voxel_grid_delta.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace nav2_costmap_2d
+{
+
+// Runs are bytes of a 2 bit status and a 6 bit length
+static constexpr unsigned int MAX_RUN_LENGTH = 63;
+static constexpr unsigned int MAX_SIZE_Z = 16;
+
+// Voxels below size_z of a column, both their unknown and marked bits
+static uint32_t columnMask(unsigned int size_z)
+{
+  return ((1u << std::min(size_z, MAX_SIZE_Z)) - 1u) * 0x10001u;
+}
+
+// Move the columns of a grid to a new origin, by whole cells, clearing the columns moved in
+static bool shiftVoxelColumns(
+  nav2_msgs::msg::VoxelGrid & grid, const geometry_msgs::msg::Point32 & origin)
+{
+  const double cells_x = (origin.x - grid.origin.x) / grid.resolutions.x;
+  const double cells_y = (origin.y - grid.origin.y) / grid.resolutions.y;
+  const int cell_ox = static_cast<int>(std::lround(cells_x));
+  const int cell_oy = static_cast<int>(std::lround(cells_y));
+  if (std::abs(cells_x - cell_ox) > 0.01 || std::abs(cells_y - cell_oy) > 0.01 ||
+    origin.z != grid.origin.z)
+  {
+    return false;
+  }
+
+  // Column (x, y) of the shifted grid was column (x + cell_ox, y + cell_oy) of the grid
+  const int size_x = grid.size_x, size_y = grid.size_y;
+  std::vector<uint32_t> shifted(grid.data.size(), 0);
+  for (int y = std::max(-cell_oy, 0); y < std::min(size_y - cell_oy, size_y); y++) {
+    for (int x = std::max(-cell_ox, 0); x < std::min(size_x - cell_ox, size_x); x++) {
+      shifted[y * size_x + x] = grid.data[(y + cell_oy) * size_x + x + cell_ox];
+    }
+  }
+  grid.data.swap(shifted);
+  grid.origin = origin;
+  return true;
+}
+
+void encodeVoxelColumns(
+  const std::vector<uint32_t> & columns, unsigned int size_z, std::vector<uint8_t> & data)
+{
+  size_z = std::min(size_z, MAX_SIZE_Z);
+  unsigned int count = 0;
+  uint8_t status = 0;
+  for (const uint32_t column : columns) {
+    for (unsigned int z = 0; z < size_z; z++) {
+      // As nav2_voxel_grid::VoxelGrid::getVoxel, free with no bit set, marked with both
+      const uint8_t voxel = ((column >> z) & 1u) + ((column >> (z + 16)) & 1u);
+      if (count != 0 && (voxel != status || count == MAX_RUN_LENGTH)) {
+        data.push_back(static_cast<uint8_t>(status << 6 | count));
+        count = 0;
+      }
+      status = voxel;
+      count++;
+    }
+  }
+  if (count != 0) {
+    data.push_back(static_cast<uint8_t>(status << 6 | count));
+  }
+}
+
+bool decodeVoxelColumns(
+  const std::vector<uint8_t> & data, unsigned int size_z, std::vector<uint32_t> & columns)
+{
+  size_z = std::min(size_z, MAX_SIZE_Z);
+  size_t offset = 0;
+  unsigned int count = 0;
+  uint8_t status = 0;
+  for (uint32_t & column : columns) {
+    column = 0;
+    for (unsigned int z = 0; z < size_z; z++) {
+      if (count == 0) {
+        if (offset >= data.size() || (data[offset] & MAX_RUN_LENGTH) == 0 ||
+          (data[offset] >> 6) > 2)
+        {
+          return false;
+        }
+        count = data[offset] & MAX_RUN_LENGTH;
+        status = data[offset] >> 6;
+        offset++;
+      }
+      if (status == 1) {
+        column |= 1u << z;
+      } else if (status == 2) {
+        column |= 0x10001u << z;
+      }
+      count--;
+    }
+  }
+  return count == 0 && offset == data.size();
+}
+
+void createVoxelGridDelta(
+  const uint32_t * columns, unsigned int size_x, unsigned int size_y, unsigned int size_z,
+  unsigned int x0, unsigned int y0, unsigned int xn, unsigned int yn,
+  std::vector<uint32_t> & reference, bool keyframe, nav2_msgs::msg::VoxelGridDelta & msg)
+{
+  const size_t size = static_cast<size_t>(size_x) * size_y;
+  msg.keyframe = keyframe || reference.size() != size;
+  msg.size_x = size_x;
+  msg.size_y = size_y;
+  msg.size_z = size_z;
+  msg.column_ranges.clear();
+  msg.data.clear();
+
+  if (msg.keyframe) {
+    reference.resize(size);
+    x0 = y0 = 0;
+    xn = size_x;
+    yn = size_y;
+  } else {
+    xn = std::min(xn, size_x);
+    yn = std::min(yn, size_y);
+  }
+
+  const uint32_t mask = columnMask(size_z);
+  std::vector<uint32_t> changed;
+  for (unsigned int y = y0; y < yn; y++) {
+    for (unsigned int x = x0; x < xn; x++) {
+      const unsigned int index = y * size_x + x;
+      if (!msg.keyframe && (columns[index] & mask) == (reference[index] & mask)) {
+        continue;
+      }
+
+      // Consecutive columns share a range, such as whole rows of keyframes
+      auto & ranges = msg.column_ranges;
+      if (!ranges.empty() && ranges[ranges.size() - 2] + ranges.back() == index) {
+        ranges.back()++;
+      } else {
+        ranges.push_back(index);
+        ranges.push_back(1);
+      }
+      changed.push_back(columns[index]);
+      reference[index] = columns[index];
+    }
+  }
+  encodeVoxelColumns(changed, size_z, msg.data);
+}
+
+bool applyVoxelGridDelta(
+  const nav2_msgs::msg::VoxelGridDelta & msg, nav2_msgs::msg::VoxelGrid & grid)
+{
+  const size_t size = static_cast<size_t>(msg.size_x) * msg.size_y;
+  if (msg.keyframe) {
+    grid.size_x = msg.size_x;
+    grid.size_y = msg.size_y;
+    grid.size_z = msg.size_z;
+    grid.origin = msg.origin;
+    grid.resolutions = msg.resolutions;
+    grid.data.assign(size, 0);
+  } else if (grid.size_x != msg.size_x || grid.size_y != msg.size_y ||
+    grid.size_z != msg.size_z || grid.resolutions != msg.resolutions ||
+    grid.data.size() != size)
+  {
+    return false;
+  } else if (grid.origin != msg.origin && !shiftVoxelColumns(grid, msg.origin)) {
+    return false;
+  }
+  grid.header = msg.header;
+
+  if (msg.column_ranges.size() % 2 != 0) {
+    return false;
+  }
+  size_t num_columns = 0;
+  for (size_t i = 0; i < msg.column_ranges.size(); i += 2) {
+    if (static_cast<size_t>(msg.column_ranges[i]) + msg.column_ranges[i + 1] > size) {
+      return false;
+    }
+    num_columns += msg.column_ranges[i + 1];
+  }
+
+  std::vector<uint32_t> columns(num_columns);
+  if (!decodeVoxelColumns(msg.data, msg.size_z, columns)) {
+    return false;
+  }
+  auto column = columns.begin();
+  for (size_t i = 0; i < msg.column_ranges.size(); i += 2) {
+    std::copy_n(column, msg.column_ranges[i + 1], grid.data.begin() + msg.column_ranges[i]);
+    column += msg.column_ranges[i + 1];
+  }
+  return true;
+}
+
+}  // namespace nav2_costmap_2d
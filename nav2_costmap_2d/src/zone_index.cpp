@@ -0,0 +1,229 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_costmap_2d/zone_index.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "nav2_costmap_2d/cost_values.hpp"
+
+namespace nav2_costmap_2d
+{
+
+void Zone::updateBounds()
+{
+  min_x = min_y = std::numeric_limits<double>::max();
+  max_x = max_y = std::numeric_limits<double>::lowest();
+  for (const auto & point : polygon) {
+    min_x = std::min(min_x, point.x);
+    min_y = std::min(min_y, point.y);
+    max_x = std::max(max_x, point.x);
+    max_y = std::max(max_y, point.y);
+  }
+}
+
+bool Zone::contains(double x, double y) const
+{
+  // Crossings of a ray towards +x with the edges, with the edges including their lower end
+  bool inside = false;
+  for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++) {
+    const auto & a = polygon[i];
+    const auto & b = polygon[j];
+    if ((a.y > y) != (b.y > y) && x < a.x + (y - a.y) * (b.x - a.x) / (b.y - a.y)) {
+      inside = !inside;
+    }
+  }
+  return inside;
+}
+
+std::vector<ZoneIndex::Node> ZoneIndex::packLevel(std::vector<Node> & nodes)
+{
+  const size_t num_parents = (nodes.size() + NODE_CAPACITY - 1) / NODE_CAPACITY;
+  const size_t num_slices = static_cast<size_t>(std::ceil(std::sqrt(num_parents)));
+  const size_t slice_size = num_slices * NODE_CAPACITY;
+
+  // Vertical slices of nodes by the x of their center, each sorted by the y of their center
+  std::sort(
+    nodes.begin(), nodes.end(), [](const Node & a, const Node & b) {
+      return a.min_x + a.max_x < b.min_x + b.max_x;
+    });
+  std::vector<Node> parents;
+  parents.reserve(num_parents);
+  for (size_t slice = 0; slice < nodes.size(); slice += slice_size) {
+    const size_t slice_end = std::min(slice + slice_size, nodes.size());
+    std::sort(
+      nodes.begin() + slice, nodes.begin() + slice_end, [](const Node & a, const Node & b) {
+        return a.min_y + a.max_y < b.min_y + b.max_y;
+      });
+
+    for (size_t first = slice; first < slice_end; first += NODE_CAPACITY) {
+      Node parent;
+      parent.first = first;
+      parent.count = std::min<size_t>(NODE_CAPACITY, slice_end - first);
+      parent.leaf = false;
+      parent.min_x = parent.min_y = std::numeric_limits<double>::max();
+      parent.max_x = parent.max_y = std::numeric_limits<double>::lowest();
+      for (size_t k = first; k < first + parent.count; k++) {
+        parent.min_x = std::min(parent.min_x, nodes[k].min_x);
+        parent.min_y = std::min(parent.min_y, nodes[k].min_y);
+        parent.max_x = std::max(parent.max_x, nodes[k].max_x);
+        parent.max_y = std::max(parent.max_y, nodes[k].max_y);
+      }
+      parents.push_back(parent);
+    }
+  }
+  return parents;
+}
+
+void ZoneIndex::build(std::vector<Zone> zones)
+{
+  zones_.clear();
+  nodes_.clear();
+  if (zones.empty()) {
+    return;
+  }
+
+  // The zones are ordered as the children of the leaves
+  std::vector<Node> items(zones.size());
+  for (size_t i = 0; i < zones.size(); i++) {
+    items[i] = {zones[i].min_x, zones[i].min_y, zones[i].max_x, zones[i].max_y,
+      static_cast<unsigned int>(i), 0, false};
+  }
+  std::vector<Node> level = packLevel(items);
+  zones_.reserve(zones.size());
+  for (const auto & item : items) {
+    zones_.push_back(std::move(zones[item.first]));
+  }
+  for (auto & leaf : level) {
+    leaf.leaf = true;
+  }
+
+  // Each level is stored before its parents, which point at its nodes
+  while (level.size() > 1) {
+    std::vector<Node> parents = packLevel(level);
+    const unsigned int offset = nodes_.size();
+    nodes_.insert(nodes_.end(), level.begin(), level.end());
+    for (auto & parent : parents) {
+      parent.first += offset;
+    }
+    level = std::move(parents);
+  }
+  nodes_.push_back(level.front());
+}
+
+void ZoneIndex::query(
+  double min_x, double min_y, double max_x, double max_y, std::vector<size_t> & found) const
+{
+  found.clear();
+  if (nodes_.empty()) {
+    return;
+  }
+
+  std::vector<unsigned int> stack{static_cast<unsigned int>(nodes_.size() - 1)};
+  while (!stack.empty()) {
+    const Node & node = nodes_[stack.back()];
+    stack.pop_back();
+    if (node.max_x < min_x || node.min_x > max_x || node.max_y < min_y || node.min_y > max_y) {
+      continue;
+    }
+
+    for (unsigned int k = node.first; k < node.first + node.count; k++) {
+      if (!node.leaf) {
+        stack.push_back(k);
+        continue;
+      }
+      const Zone & zone = zones_[k];
+      if (zone.max_x >= min_x && zone.min_x <= max_x && zone.max_y >= min_y &&
+        zone.min_y <= max_y)
+      {
+        found.push_back(k);
+      }
+    }
+  }
+}
+
+void ZoneIndex::queryPoint(double x, double y, std::vector<size_t> & found) const
+{
+  query(x, y, x, y, found);
+  found.erase(
+    std::remove_if(
+      found.begin(), found.end(), [this, x, y](size_t i) {return !zones_[i].contains(x, y);}),
+    found.end());
+}
+
+void ZoneIndex::rasterize(Costmap2D & costmap, int min_i, int min_j, int max_i, int max_j) const
+{
+  if (max_i <= min_i || max_j <= min_j) {
+    return;
+  }
+
+  const double resolution = costmap.getResolution();
+  const double origin_x = costmap.getOriginX();
+  const double origin_y = costmap.getOriginY();
+  std::vector<size_t> found;
+  query(
+    origin_x + min_i * resolution, origin_y + min_j * resolution,
+    origin_x + max_i * resolution, origin_y + max_j * resolution, found);
+
+  unsigned char * grid = costmap.getCharMap();
+  const unsigned int size_x = costmap.getSizeInCellsX();
+  std::vector<double> crossings;
+  for (const size_t index : found) {
+    const Zone & zone = zones_[index];
+    if (zone.cost == 0 || zone.polygon.size() < 3) {
+      continue;
+    }
+
+    // Only the rows whose center may be inside of the zone are scanned
+    const int first_row = std::max(
+      min_j, static_cast<int>(std::floor((zone.min_y - origin_y) / resolution - 0.5)));
+    const int last_row = std::min(
+      max_j, static_cast<int>(std::ceil((zone.max_y - origin_y) / resolution + 0.5)));
+    for (int j = first_row; j < last_row; j++) {
+      // The cells of the row whose center is between pairs of crossings of the edges, with
+      // the same rule as Zone::contains
+      const double y = origin_y + (j + 0.5) * resolution;
+      crossings.clear();
+      for (size_t a = 0, b = zone.polygon.size() - 1; a < zone.polygon.size(); b = a++) {
+        const auto & p = zone.polygon[a];
+        const auto & q = zone.polygon[b];
+        if ((p.y > y) != (q.y > y)) {
+          crossings.push_back(p.x + (y - p.y) * (q.x - p.x) / (q.y - p.y));
+        }
+      }
+      std::sort(crossings.begin(), crossings.end());
+
+      unsigned char * row = grid + j * size_x;
+      for (size_t k = 0; k + 1 < crossings.size(); k += 2) {
+        const double begin = (crossings[k] - origin_x) / resolution - 0.5;
+        const double end = (crossings[k + 1] - origin_x) / resolution - 0.5;
+        const int first = std::max(
+          static_cast<double>(min_i), std::min(std::ceil(begin), static_cast<double>(max_i)));
+        const int last = std::max(
+          static_cast<double>(first), std::min(std::ceil(end), static_cast<double>(max_i)));
+        for (int i = first; i < last; i++) {
+          if (row[i] == NO_INFORMATION || row[i] < zone.cost) {
+            row[i] = zone.cost;
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace nav2_costmap_2d
@@ -33,6 +33,7 @@
  */
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <cmath>
 #include <map>
 #include <memory>
@@ -599,6 +600,113 @@ TEST_F(TestNode, testInflation3)
   ASSERT_EQ(countValues(*costmap, nav2_costmap_2d::INSCRIBED_INFLATED_OBSTACLE), 4u);
 }
 
+/**
+ * Test that incremental inflation gives the same costs as reinflating the window
+ */
+TEST_F(TestNode, testIncrementalInflation)
+{
+  std::vector<rclcpp::Parameter> parameters;
+  parameters.push_back(rclcpp::Parameter("inflation.cost_scaling_factor", 1.0));
+  parameters.push_back(rclcpp::Parameter("inflation.inflation_radius", 3.0));
+  parameters.push_back(rclcpp::Parameter("inflation.incremental_inflation", true));
+  initNode(parameters);
+
+  tf2_ros::Buffer tf(node_->get_clock());
+  nav2_costmap_2d::LayeredCostmap layers("frame", false, false);
+  layers.resizeMap(10, 10, 1, 0, 0);
+  std::vector<Point> polygon = setRadii(layers, 1, 1.75);
+
+  std::shared_ptr<nav2_costmap_2d::ObstacleLayer> olayer = nullptr;
+  addObstacleLayer(layers, tf, node_, olayer);
+
+  std::shared_ptr<nav2_costmap_2d::InflationLayer> ilayer = nullptr;
+  addInflationLayer(layers, tf, node_, ilayer);
+  layers.setFootprint(polygon);
+
+  nav2_costmap_2d::Costmap2D * costmap = layers.getCostmap();
+  addObservation(olayer, 5, 5, MAX_Z);
+  layers.updateMap(0, 0, 0);
+
+  ASSERT_EQ(countValues(*costmap, nav2_costmap_2d::FREE_SPACE, false), 29u);
+  ASSERT_EQ(countValues(*costmap, nav2_costmap_2d::LETHAL_OBSTACLE), 1u);
+  ASSERT_EQ(countValues(*costmap, nav2_costmap_2d::INSCRIBED_INFLATED_OBSTACLE), 4u);
+  for (unsigned int i = 0; i < 10; ++i) {
+    for (unsigned int j = 0; j < 10; ++j) {
+      double dist = std::hypot(static_cast<double>(i) - 5.0, static_cast<double>(j) - 5.0);
+      if (dist <= 3.0) {
+        ASSERT_EQ(costmap->getCost(i, j), ilayer->computeCost(dist));
+      }
+    }
+  }
+
+  // Update again - should see no change
+  layers.updateMap(0, 0, 0);
+  ASSERT_EQ(countValues(*costmap, nav2_costmap_2d::FREE_SPACE, false), 29u);
+  ASSERT_EQ(countValues(*costmap, nav2_costmap_2d::LETHAL_OBSTACLE), 1u);
+  ASSERT_EQ(countValues(*costmap, nav2_costmap_2d::INSCRIBED_INFLATED_OBSTACLE), 4u);
+
+  // A new obstacle only changes the cells closer to it than to the existing one
+  addObservation(olayer, 2, 2, MAX_Z);
+  layers.updateMap(0, 0, 0);
+  ASSERT_EQ(countValues(*costmap, nav2_costmap_2d::LETHAL_OBSTACLE), 2u);
+  for (unsigned int i = 0; i < 10; ++i) {
+    for (unsigned int j = 0; j < 10; ++j) {
+      double dist = std::min(
+        std::hypot(static_cast<double>(i) - 5.0, static_cast<double>(j) - 5.0),
+        std::hypot(static_cast<double>(i) - 2.0, static_cast<double>(j) - 2.0));
+      if (dist <= 3.0) {
+        ASSERT_EQ(costmap->getCost(i, j), ilayer->computeCost(dist));
+      }
+    }
+  }
+}
+
+/**
+ * Test that inflating stripes of the window concurrently gives the same costs as serially
+ */
+TEST_F(TestNode, testTiledInflation)
+{
+  std::vector<std::shared_ptr<nav2_costmap_2d::LayeredCostmap>> costmaps;
+  std::vector<nav2_util::LifecycleNode::SharedPtr> nodes;
+  std::vector<std::shared_ptr<tf2_ros::Buffer>> buffers;
+  for (int threads : {1, 4}) {
+    std::vector<rclcpp::Parameter> parameters;
+    parameters.push_back(rclcpp::Parameter("inflation.cost_scaling_factor", 1.0));
+    parameters.push_back(rclcpp::Parameter("inflation.inflation_radius", 4.0));
+    parameters.push_back(rclcpp::Parameter("inflation.inflation_threads", threads));
+    initNode(parameters);
+    nodes.push_back(node_);
+
+    buffers.push_back(std::make_shared<tf2_ros::Buffer>(node_->get_clock()));
+    auto layers = std::make_shared<nav2_costmap_2d::LayeredCostmap>("frame", false, false);
+    layers->resizeMap(60, 60, 1, 0, 0);
+    std::vector<Point> polygon = setRadii(*layers, 1, 1);
+
+    std::shared_ptr<nav2_costmap_2d::ObstacleLayer> olayer = nullptr;
+    addObstacleLayer(*layers, *buffers.back(), node_, olayer);
+
+    std::shared_ptr<nav2_costmap_2d::InflationLayer> ilayer = nullptr;
+    addInflationLayer(*layers, *buffers.back(), node_, ilayer);
+    layers->setFootprint(polygon);
+
+    for (unsigned int i = 0; i < 60; i += 7) {
+      addObservation(olayer, i, (i * 13) % 60, MAX_Z, i, 0.0);
+      addObservation(olayer, (i * 17) % 60, i, MAX_Z, 0.0, i);
+    }
+    layers->updateMap(0, 0, 0);
+    costmaps.push_back(layers);
+  }
+
+  nav2_costmap_2d::Costmap2D * serial = costmaps[0]->getCostmap();
+  nav2_costmap_2d::Costmap2D * tiled = costmaps[1]->getCostmap();
+  ASSERT_GT(countValues(*serial, nav2_costmap_2d::LETHAL_OBSTACLE), 0u);
+  for (unsigned int i = 0; i < 60; ++i) {
+    for (unsigned int j = 0; j < 60; ++j) {
+      ASSERT_EQ(serial->getCost(i, j), tiled->getCost(i, j));
+    }
+  }
+}
+
 /**
  * Test dynamic parameter setting of inflation layer
  */
@@ -32,10 +32,13 @@
  * Test harness for ObstacleLayer for Costmap2D
  */
 
+#include <chrono>
 #include <memory>
 #include <string>
+#include <thread>
 #include <algorithm>
 #include <utility>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "nav2_costmap_2d/costmap_2d.hpp"
@@ -43,6 +46,7 @@
 #include "nav2_costmap_2d/observation_buffer.hpp"
 #include "../testing_helper.hpp"
 #include "nav2_costmap_2d/costmap_2d_ros.hpp"
+#include "nav2_costmap_2d/temporal_obstacle_layer.hpp"
 
 using std::begin;
 using std::end;
@@ -580,6 +584,199 @@ TEST_F(TestNode, testMaxCombinationMethod) {
   ASSERT_EQ(unknown_count, 99);
 }
 
+/**
+ * Test that obstacle layers updating their bounds concurrently give the same costmap
+ */
+TEST_F(TestNode, testParallelLayerUpdates) {
+  tf2_ros::Buffer tf(node_->get_clock());
+  nav2_costmap_2d::LayeredCostmap layers("frame", false, false);
+  layers.resizeMap(10, 10, 1, 0, 0);
+  layers.setParallelLayerUpdates(true);
+
+  std::shared_ptr<nav2_costmap_2d::ObstacleLayer> olayer = nullptr;
+  addObstacleLayer(layers, tf, node_, olayer);
+
+  auto olayer2 = std::make_shared<nav2_costmap_2d::ObstacleLayer>();
+  olayer2->initialize(&layers, "obstacles_2", &tf, node_, nullptr);
+  layers.addPlugin(std::shared_ptr<nav2_costmap_2d::Layer>(olayer2));
+  ASSERT_TRUE(olayer->hasIndependentBounds());
+
+  addObservation(olayer, 2.0, 3.0, MAX_Z / 2, 2.0, 3.0, MAX_Z / 2);
+  addObservation(olayer2, 7.0, 8.0, MAX_Z / 2, 7.0, 8.0, MAX_Z / 2);
+  layers.updateMap(0, 0, 0);
+
+  nav2_costmap_2d::Costmap2D * costmap = layers.getCostmap();
+  ASSERT_EQ(countValues(*costmap, nav2_costmap_2d::LETHAL_OBSTACLE), 2);
+  ASSERT_EQ(costmap->getCost(2, 3), nav2_costmap_2d::LETHAL_OBSTACLE);
+  ASSERT_EQ(costmap->getCost(7, 8), nav2_costmap_2d::LETHAL_OBSTACLE);
+
+  // The updated bounds cover the observations of both layers
+  double minx, miny, maxx, maxy;
+  layers.getUpdatedBounds(minx, miny, maxx, maxy);
+  ASSERT_LE(minx, 2.0);
+  ASSERT_LE(miny, 3.0);
+  ASSERT_GE(maxx, 7.0);
+  ASSERT_GE(maxy, 8.0);
+}
+
+/**
+ * Test that clearing with a dense cloud, whose points share endpoint cells, clears
+ * the same cells as clearing with each point on its own
+ */
+TEST_F(TestNode, testRaytracingSharedEndpoints) {
+  tf2_ros::Buffer tf(node_->get_clock());
+  nav2_costmap_2d::LayeredCostmap batched_layers("frame", false, false);
+  batched_layers.resizeMap(10, 10, 1, 0, 0);
+  nav2_costmap_2d::LayeredCostmap single_layers("frame", false, false);
+  single_layers.resizeMap(10, 10, 1, 0, 0);
+
+  std::shared_ptr<nav2_costmap_2d::ObstacleLayer> batched = nullptr;
+  addObstacleLayer(batched_layers, tf, node_, batched);
+  auto single = std::make_shared<nav2_costmap_2d::ObstacleLayer>();
+  single->initialize(&single_layers, "obstacles_single", &tf, node_, nullptr);
+  single_layers.addPlugin(std::shared_ptr<nav2_costmap_2d::Layer>(single));
+
+  // Mark every cell of both layers
+  for (unsigned int i = 0; i < 10; ++i) {
+    for (unsigned int j = 0; j < 10; ++j) {
+      addObservation(batched, i + 0.5, j + 0.5, MAX_Z / 2, 0.0, 0.0, MAX_Z / 2, true, false);
+      addObservation(single, i + 0.5, j + 0.5, MAX_Z / 2, 0.0, 0.0, MAX_Z / 2, true, false);
+    }
+  }
+  batched_layers.updateMap(0, 0, 0);
+  single_layers.updateMap(0, 0, 0);
+  batched->clearStaticObservations(true, false);
+  single->clearStaticObservations(true, false);
+  ASSERT_EQ(countValues(*batched, nav2_costmap_2d::LETHAL_OBSTACLE), 100);
+
+  // Several points per endpoint cell, some of them beyond the map
+  std::vector<std::pair<double, double>> points;
+  for (double y = 0.1; y < 12.0; y += 0.45) {
+    points.emplace_back(9.2, y);
+    points.emplace_back(9.7, y);
+    points.emplace_back(4.1, y / 2.0);
+  }
+
+  sensor_msgs::msg::PointCloud2 cloud;
+  sensor_msgs::PointCloud2Modifier modifier(cloud);
+  modifier.setPointCloud2FieldsByString(1, "xyz");
+  modifier.resize(points.size());
+  sensor_msgs::PointCloud2Iterator<float> iter_x(cloud, "x");
+  sensor_msgs::PointCloud2Iterator<float> iter_y(cloud, "y");
+  sensor_msgs::PointCloud2Iterator<float> iter_z(cloud, "z");
+  for (const auto & point : points) {
+    *iter_x = point.first;
+    *iter_y = point.second;
+    *iter_z = MAX_Z / 2;
+    ++iter_x;
+    ++iter_y;
+    ++iter_z;
+  }
+  geometry_msgs::msg::Point origin;
+  origin.x = 0.5;
+  origin.y = 0.5;
+  origin.z = MAX_Z / 2;
+  nav2_costmap_2d::Observation obs(origin, cloud, 100.0, 0.0, 100.0, 0.0);
+  batched->addStaticObservation(obs, false, true);
+
+  for (const auto & point : points) {
+    addObservation(
+      single, point.first, point.second, MAX_Z / 2, origin.x, origin.y, origin.z, false, true);
+  }
+
+  batched_layers.updateMap(0, 0, 0);
+  single_layers.updateMap(0, 0, 0);
+
+  int lethal_count = countValues(*batched, nav2_costmap_2d::LETHAL_OBSTACLE);
+  ASSERT_GT(lethal_count, 0);
+  ASSERT_LT(lethal_count, 100);
+  for (unsigned int i = 0; i < 10; ++i) {
+    for (unsigned int j = 0; j < 10; ++j) {
+      ASSERT_EQ(batched->getCost(i, j), single->getCost(i, j));
+    }
+  }
+}
+
+/**
+ * Test that a layer with packed costs combines the same costs into the master grid
+ */
+TEST_F(TestNode, testPackedStorage) {
+  tf2_ros::Buffer tf(node_->get_clock());
+  nav2_costmap_2d::LayeredCostmap packed_layers("frame", false, false);
+  packed_layers.resizeMap(10, 10, 1, 0, 0);
+  nav2_costmap_2d::LayeredCostmap byte_layers("frame", false, false);
+  byte_layers.resizeMap(10, 10, 1, 0, 0);
+
+  node_->declare_parameter("packed.packed_storage", rclcpp::ParameterValue(true));
+  auto packed = std::make_shared<nav2_costmap_2d::ObstacleLayer>();
+  packed->initialize(&packed_layers, "packed", &tf, node_, nullptr);
+  packed_layers.addPlugin(std::shared_ptr<nav2_costmap_2d::Layer>(packed));
+  std::shared_ptr<nav2_costmap_2d::ObstacleLayer> bytes = nullptr;
+  addObstacleLayer(byte_layers, tf, node_, bytes);
+  ASSERT_EQ(packed->getCharMap(), nullptr);
+
+  // Mark a wall and some obstacles, then clear through part of the wall
+  for (auto layer : {packed, bytes}) {
+    for (unsigned int j = 0; j < 10; ++j) {
+      addObservation(layer, 7.5, j + 0.5, MAX_Z / 2, 0.0, 0.0, MAX_Z / 2, true, false);
+    }
+    addObservation(layer, 2.5, 3.5, MAX_Z / 2, 0.0, 0.0, MAX_Z / 2, true, false);
+    addObservation(layer, 4.5, 8.5, MAX_Z / 2, 0.0, 0.0, MAX_Z / 2, true, false);
+  }
+  packed_layers.updateMap(0, 0, 0);
+  byte_layers.updateMap(0, 0, 0);
+  for (auto layer : {packed, bytes}) {
+    layer->clearStaticObservations(true, false);
+    addObservation(layer, 9.5, 4.5, MAX_Z / 2, 0.5, 4.5, MAX_Z / 2, false, true);
+  }
+  packed_layers.updateMap(0, 0, 0);
+  byte_layers.updateMap(0, 0, 0);
+
+  int lethal_count = countValues(*byte_layers.getCostmap(), nav2_costmap_2d::LETHAL_OBSTACLE);
+  ASSERT_GT(lethal_count, 0);
+  for (unsigned int i = 0; i < 10; ++i) {
+    for (unsigned int j = 0; j < 10; ++j) {
+      ASSERT_EQ(
+        packed_layers.getCostmap()->getCost(i, j), byte_layers.getCostmap()->getCost(i, j));
+    }
+  }
+}
+
+/**
+ * Test that the obstacles of the temporal obstacle layer decay once they are no longer seen
+ */
+TEST_F(TestNode, testTemporalDecay) {
+  tf2_ros::Buffer tf(node_->get_clock());
+  nav2_costmap_2d::LayeredCostmap layers("frame", false, false);
+  layers.resizeMap(10, 10, 1, 0, 0);
+
+  // Lethal for 0.2 s, then decaying over 0.2 s in 2 steps
+  node_->declare_parameter("temporal.persistence_time", rclcpp::ParameterValue(0.2));
+  node_->declare_parameter("temporal.decay_time", rclcpp::ParameterValue(0.2));
+  node_->declare_parameter("temporal.decay_steps", rclcpp::ParameterValue(2));
+  auto tlayer = std::make_shared<nav2_costmap_2d::TemporalObstacleLayer>();
+  tlayer->initialize(&layers, "temporal", &tf, node_, nullptr);
+  layers.addPlugin(std::shared_ptr<nav2_costmap_2d::Layer>(tlayer));
+
+  addObservation(tlayer, 5.5, 5.5, MAX_Z / 2, 5.5, 5.5, MAX_Z / 2, true, false);
+  layers.updateMap(0, 0, 0);
+  tlayer->clearStaticObservations(true, false);
+  ASSERT_EQ(tlayer->getCost(5, 5), nav2_costmap_2d::LETHAL_OBSTACLE);
+
+  // Decaying, but not removed yet
+  std::this_thread::sleep_for(std::chrono::milliseconds(250));
+  layers.updateMap(0, 0, 0);
+  ASSERT_LT(tlayer->getCost(5, 5), nav2_costmap_2d::INSCRIBED_INFLATED_OBSTACLE);
+  ASSERT_GT(tlayer->getCost(5, 5), nav2_costmap_2d::FREE_SPACE);
+  ASSERT_EQ(layers.getCostmap()->getCost(5, 5), tlayer->getCost(5, 5));
+
+  // Removed at the end of its lifetime
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  layers.updateMap(0, 0, 0);
+  ASSERT_EQ(tlayer->getCost(5, 5), nav2_costmap_2d::FREE_SPACE);
+  ASSERT_EQ(countValues(*tlayer, nav2_costmap_2d::FREE_SPACE, false), 0);
+}
+
 class TestNodeWithoutUnknownOverwrite : public ::testing::Test
 {
 public:
@@ -190,6 +190,90 @@ TEST_F(TestCostmapSubscriberShould, handleCostmapUpdateMsgs)
   costmapPublisher->on_deactivate();
 }
 
+TEST_F(TestCostmapSubscriberShould, keepCostmapsReturnedUnchangedByUpdates)
+{
+  bool always_send_full_costmap = false;
+
+  auto costmapPublisher = std::make_shared<nav2_costmap_2d::Costmap2DPublisher>(
+    node, costmapToSend.get(), "", topicName, always_send_full_costmap);
+  costmapPublisher->on_activate();
+
+  std::vector<std::shared_ptr<const nav2_costmap_2d::Costmap2D>> heldCostmaps;
+  std::vector<std::vector<std::uint8_t>> expectedCostmaps;
+
+  for (const auto & mapChange : mapChanges) {
+    for (const auto & observation : mapChange.observations) {
+      costmapToSend->setCost(observation.x, observation.y, observation.cost);
+    }
+
+    expectedCostmaps.emplace_back(getCurrentCharMapToSend());
+
+    costmapPublisher->updateBounds(mapChange.x0, mapChange.xn, mapChange.y0, mapChange.yn);
+    costmapPublisher->publishCostmap();
+
+    rclcpp::spin_some(node->get_node_base_interface());
+
+    heldCostmaps.push_back(costmapSubscriber->getCostmap());
+  }
+
+  // Every update is applied to a new snapshot, those held by readers stay as they were
+  for (size_t i = 0; i < heldCostmaps.size(); ++i) {
+    auto costmap = heldCostmaps[i];
+    ASSERT_EQ(
+      expectedCostmaps[i], std::vector<std::uint8_t>(
+        costmap->getCharMap(),
+        costmap->getCharMap() + costmap->getSizeInCellsX() * costmap->getSizeInCellsY()));
+    if (i > 0) {
+      EXPECT_NE(heldCostmaps[i - 1], costmap);
+    }
+  }
+
+  // Without readers, the buffer of the snapshot replaced last is reused
+  const auto * replaced = heldCostmaps[heldCostmaps.size() - 2].get();
+  heldCostmaps.clear();
+  costmapToSend->setCost(5, 5, 255);
+  costmapPublisher->updateBounds(5, 6, 5, 6);
+  costmapPublisher->publishCostmap();
+  rclcpp::spin_some(node->get_node_base_interface());
+  EXPECT_EQ(replaced, costmapSubscriber->getCostmap().get());
+  EXPECT_EQ(255, costmapSubscriber->getCostmap()->getCost(5, 5));
+
+  costmapPublisher->on_deactivate();
+}
+
+TEST_F(TestCostmapSubscriberShould, replayUpdatesIntoReusedBuffers)
+{
+  auto costmapMsg = std::make_shared<nav2_msgs::msg::Costmap>();
+  costmapMsg->metadata.size_x = 10;
+  costmapMsg->metadata.size_y = 10;
+  costmapMsg->metadata.resolution = 0.1;
+  costmapMsg->data.assign(100, 0);
+  costmapSubscriber->costmapCallback(costmapMsg);
+
+  // Updates of disjoint windows, each buffer missing the one applied to the other
+  auto update = [this](unsigned int x, unsigned int y, unsigned char cost) {
+      auto updateMsg = std::make_shared<nav2_msgs::msg::CostmapUpdate>();
+      updateMsg->x = x;
+      updateMsg->y = y;
+      updateMsg->size_x = 2;
+      updateMsg->size_y = 2;
+      updateMsg->data.assign(4, cost);
+      costmapSubscriber->costmapUpdateCallback(updateMsg);
+    };
+  update(0, 0, 10);
+  update(4, 4, 20);
+  const auto * second = costmapSubscriber->getCostmap().get();
+  update(8, 8, 30);
+  update(0, 0, 40);
+
+  auto costmap = costmapSubscriber->getCostmap();
+  EXPECT_EQ(second, costmap.get());
+  EXPECT_EQ(40, costmap->getCost(1, 1));
+  EXPECT_EQ(20, costmap->getCost(5, 5));
+  EXPECT_EQ(30, costmap->getCost(9, 9));
+  EXPECT_EQ(0, costmap->getCost(2, 2));
+}
+
 TEST_F(
   TestCostmapSubscriberShould,
   throwExceptionIfGetCostmapMethodIsCalledBeforeAnyCostmapMsgReceived)
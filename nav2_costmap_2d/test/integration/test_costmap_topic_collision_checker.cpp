@@ -62,13 +62,7 @@ public:
 
   void setCostmap(nav2_msgs::msg::Costmap::SharedPtr msg)
   {
-    costmap_msg_ = msg;
-    costmap_ = std::make_shared<nav2_costmap_2d::Costmap2D>(
-      msg->metadata.size_x, msg->metadata.size_y,
-      msg->metadata.resolution, msg->metadata.origin.position.x,
-      msg->metadata.origin.position.y);
-
-    processCurrentCostmapMsg();
+    costmapCallback(msg);
   }
 };
 
@@ -203,6 +197,24 @@ public:
     return collision_checker_->isCollisionFree(pose);
   }
 
+  bool testPath(double x, double y, double theta, double dx, double dy, int steps)
+  {
+    rclcpp::Time stamp = now();
+    publishPose(x, y, theta, stamp);
+    std::vector<geometry_msgs::msg::Pose2D> poses(steps);
+    for (int i = 0; i < steps; ++i) {
+      poses[i].x = x + i * dx;
+      poses[i].y = y + i * dy;
+      poses[i].theta = theta;
+    }
+
+    setPose(x, y, theta, stamp);
+    publishFootprint();
+    publishCostmap();
+    rclcpp::sleep_for(std::chrono::milliseconds(1000));
+    return collision_checker_->isPathCollisionFree(poses);
+  }
+
   void setFootprint(double footprint_padding, double robot_radius)
   {
     std::vector<geometry_msgs::msg::Point> new_footprint;
@@ -362,3 +374,14 @@ TEST_F(TestNode, CollisionSpace)
   // Partially in obstacle
   ASSERT_EQ(collision_checker_->testPose(4.5, 4.5, 0), false);
 }
+
+TEST_F(TestNode, PathCollision)
+{
+  collision_checker_->setFootprint(0, 1);
+
+  // Staying in free space
+  ASSERT_EQ(collision_checker_->testPath(2, 8.5, 0, 0.0, 0.0, 5), true);
+
+  // Sweeping from free space into the obstacle
+  ASSERT_EQ(collision_checker_->testPath(2, 8.5, 0, 0.5, -0.25, 14), false);
+}
@@ -0,0 +1,99 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "nav2_costmap_2d/costmap_2d.hpp"
+
+TEST(BatchCoordinates, worldToMapMatchesScalar)
+{
+  nav2_costmap_2d::Costmap2D costmap(40, 30, 0.05, -1.0, 0.5);
+
+  std::mt19937 generator(7);
+  std::uniform_real_distribution<double> x_dist(-1.5, 1.5);
+  std::uniform_real_distribution<double> y_dist(0.0, 2.5);
+  std::vector<double> wx, wy;
+  for (unsigned int i = 0; i != 1000; i++) {
+    wx.push_back(x_dist(generator));
+    wy.push_back(y_dist(generator));
+  }
+  // Points on the edges of the map and not a number
+  wx.insert(wx.end(), {-1.0, 1.0, -1.0, 0.0, std::nan("")});
+  wy.insert(wy.end(), {0.5, 0.5, 2.0, 1.999, 1.0});
+
+  const size_t count = wx.size();
+  std::vector<unsigned int> mx(count), my(count);
+  std::vector<unsigned char> valid(count);
+  const size_t num_valid =
+    costmap.worldToMap(wx.data(), wy.data(), count, mx.data(), my.data(), valid.data());
+
+  size_t expected_num_valid = 0;
+  for (size_t i = 0; i != count; i++) {
+    unsigned int x = 0, y = 0;
+    const bool expected_valid = !std::isnan(wx[i]) && costmap.worldToMap(wx[i], wy[i], x, y);
+    EXPECT_EQ(static_cast<bool>(valid[i]), expected_valid);
+    if (expected_valid) {
+      expected_num_valid++;
+      EXPECT_EQ(mx[i], x);
+      EXPECT_EQ(my[i], y);
+    } else {
+      EXPECT_EQ(mx[i], 0u);
+      EXPECT_EQ(my[i], 0u);
+    }
+  }
+  EXPECT_EQ(num_valid, expected_num_valid);
+  EXPECT_FALSE(valid[count - 1]);
+
+  // Single precision points
+  std::vector<float> wx_f(wx.begin(), wx.end()), wy_f(wy.begin(), wy.end());
+  costmap.worldToMap(wx_f.data(), wy_f.data(), count, mx.data(), my.data(), valid.data());
+  for (size_t i = 0; i + 1 != count; i++) {
+    unsigned int x = 0, y = 0;
+    ASSERT_EQ(static_cast<bool>(valid[i]), costmap.worldToMap(wx_f[i], wy_f[i], x, y));
+    if (valid[i]) {
+      EXPECT_EQ(mx[i], x);
+      EXPECT_EQ(my[i], y);
+    }
+  }
+
+  // Continuous coordinates
+  std::vector<float> cx(count), cy(count);
+  costmap.worldToMapContinuous(wx.data(), wy.data(), count, cx.data(), cy.data(), valid.data());
+  for (size_t i = 0; i + 1 != count; i++) {
+    float x = 0.0f, y = 0.0f;
+    ASSERT_EQ(static_cast<bool>(valid[i]), costmap.worldToMapContinuous(wx[i], wy[i], x, y));
+    if (valid[i]) {
+      EXPECT_EQ(cx[i], x);
+      EXPECT_EQ(cy[i], y);
+    }
+  }
+}
+
+TEST(BatchCoordinates, mapToWorldMatchesScalar)
+{
+  nav2_costmap_2d::Costmap2D costmap(40, 30, 0.05, -1.0, 0.5);
+  std::vector<unsigned int> mx{0, 39, 17, 5}, my{0, 29, 3, 28};
+  std::vector<double> wx(mx.size()), wy(mx.size());
+  costmap.mapToWorld(mx.data(), my.data(), mx.size(), wx.data(), wy.data());
+  for (size_t i = 0; i != mx.size(); i++) {
+    double x, y;
+    costmap.mapToWorld(mx[i], my[i], x, y);
+    EXPECT_EQ(wx[i], x);
+    EXPECT_EQ(wy[i], y);
+  }
+}
@@ -0,0 +1,119 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <utility>
+
+#include "nav2_costmap_2d/costmap_2d.hpp"
+#include "nav2_costmap_2d/cost_values.hpp"
+#include "nav2_costmap_2d/cost_pyramid.hpp"
+
+// Brute force maximum cost of a region, bounds inclusive
+unsigned char bruteForceMaxCost(
+  const nav2_costmap_2d::Costmap2D & costmap, unsigned int min_x, unsigned int min_y,
+  unsigned int max_x, unsigned int max_y)
+{
+  unsigned char max_cost = 0;
+  for (unsigned int y = min_y; y <= max_y; y++) {
+    for (unsigned int x = min_x; x <= max_x; x++) {
+      max_cost = std::max(max_cost, costmap.getCost(x, y));
+    }
+  }
+  return max_cost;
+}
+
+void expectMatchesBruteForce(
+  const nav2_costmap_2d::CostPyramid & pyramid, const nav2_costmap_2d::Costmap2D & costmap,
+  std::mt19937 & generator)
+{
+  const unsigned int size_x = costmap.getSizeInCellsX();
+  const unsigned int size_y = costmap.getSizeInCellsY();
+  for (unsigned int i = 0; i != 500; i++) {
+    unsigned int min_x = generator() % size_x, max_x = generator() % size_x;
+    unsigned int min_y = generator() % size_y, max_y = generator() % size_y;
+    if (min_x > max_x) {
+      std::swap(min_x, max_x);
+    }
+    if (min_y > max_y) {
+      std::swap(min_y, max_y);
+    }
+    const unsigned char max_cost = bruteForceMaxCost(costmap, min_x, min_y, max_x, max_y);
+    const unsigned char cost = generator() % 256;
+    EXPECT_EQ(pyramid.getMaxCost(min_x, min_y, max_x, max_y), max_cost);
+    EXPECT_EQ(pyramid.isRegionBelow(min_x, min_y, max_x, max_y, cost), max_cost < cost);
+  }
+}
+
+TEST(CostPyramid, fullComputation)
+{
+  std::mt19937 generator(42);
+  for (unsigned int num_levels = 1; num_levels != 4; num_levels++) {
+    // Sizes which are not multiples of the blocks
+    nav2_costmap_2d::Costmap2D costmap(77, 53, 0.05, 0.0, 0.0);
+    for (unsigned int i = 0; i != 200; i++) {
+      costmap.setCost(generator() % 77, generator() % 53, generator() % 256);
+    }
+
+    nav2_costmap_2d::CostPyramid pyramid;
+    EXPECT_FALSE(pyramid.isInitialized());
+    EXPECT_FALSE(pyramid.isRegionBelow(0, 0, 1, 1, nav2_costmap_2d::LETHAL_OBSTACLE));
+    pyramid.setNumLevels(num_levels);
+    pyramid.update(costmap);
+    EXPECT_TRUE(pyramid.isInitialized());
+    expectMatchesBruteForce(pyramid, costmap, generator);
+
+    // Regions leaving the costmap
+    EXPECT_FALSE(pyramid.isRegionBelow(70, 0, 77, 10, nav2_costmap_2d::NO_INFORMATION));
+    EXPECT_EQ(pyramid.getMaxCost(0, 50, 10, 53), nav2_costmap_2d::NO_INFORMATION);
+  }
+}
+
+TEST(CostPyramid, incrementalUpdates)
+{
+  std::mt19937 generator(7);
+  nav2_costmap_2d::Costmap2D costmap(100, 100, 0.05, 0.0, 0.0);
+  nav2_costmap_2d::CostPyramid pyramid;
+  pyramid.update(costmap);
+  EXPECT_TRUE(pyramid.isRegionBelow(0, 0, 99, 99, 1));
+
+  for (unsigned int i = 0; i != 20; i++) {
+    unsigned int x0 = generator() % 100, xn = generator() % 100;
+    unsigned int y0 = generator() % 100, yn = generator() % 100;
+    if (x0 > xn) {
+      std::swap(x0, xn);
+    }
+    if (y0 > yn) {
+      std::swap(y0, yn);
+    }
+    xn++;
+    yn++;
+    for (unsigned int y = y0; y != yn; y++) {
+      for (unsigned int x = x0; x != xn; x++) {
+        costmap.setCost(x, y, generator() % 8 == 0 ? generator() % 256 : 0);
+      }
+    }
+    pyramid.update(costmap, x0, xn, y0, yn);
+    expectMatchesBruteForce(pyramid, costmap, generator);
+  }
+
+  // A resize is a full recomputation
+  costmap.resizeMap(30, 20, 0.05, 0.0, 0.0);
+  costmap.setCost(29, 19, nav2_costmap_2d::LETHAL_OBSTACLE);
+  pyramid.update(costmap, 0, 0, 0, 0);
+  EXPECT_EQ(pyramid.getMaxCost(0, 0, 29, 19), nav2_costmap_2d::LETHAL_OBSTACLE);
+  EXPECT_TRUE(pyramid.isRegionBelow(0, 0, 28, 19, 1));
+}
@@ -0,0 +1,102 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "nav2_costmap_2d/costmap_2d.hpp"
+#include "nav2_costmap_2d/costmap_delta.hpp"
+
+bool sameCosts(const nav2_costmap_2d::Costmap2D & a, const nav2_costmap_2d::Costmap2D & b)
+{
+  return a.getSizeInCellsX() == b.getSizeInCellsX() &&
+         a.getSizeInCellsY() == b.getSizeInCellsY() &&
+         std::memcmp(
+    a.getCharMap(), b.getCharMap(), a.getSizeInCellsX() * a.getSizeInCellsY()) == 0;
+}
+
+TEST(CostmapDelta, WindowRoundTrip)
+{
+  // Long runs and values changing every cell, across rows of the window
+  const unsigned int size_x = 70, size_y = 9;
+  std::vector<unsigned char> costmap(size_x * size_y, 0);
+  for (unsigned int i = 0; i < costmap.size(); i++) {
+    costmap[i] = i < 400 ? 7 : static_cast<unsigned char>(i * 13);
+  }
+
+  std::vector<unsigned char> data;
+  nav2_costmap_2d::encodeCostmapWindow(costmap.data(), size_x, 3, 1, 69, 8, data);
+  std::vector<unsigned char> decoded(size_x * size_y, 0);
+  size_t offset = 0;
+  ASSERT_TRUE(
+    nav2_costmap_2d::decodeCostmapWindow(data, offset, decoded.data(), size_x, 3, 1, 69, 8));
+  EXPECT_EQ(offset, data.size());
+  for (unsigned int y = 0; y < size_y; y++) {
+    for (unsigned int x = 0; x < size_x; x++) {
+      const bool inside = x >= 3 && x < 69 && y >= 1 && y < 8;
+      EXPECT_EQ(decoded[y * size_x + x], inside ? costmap[y * size_x + x] : 0);
+    }
+  }
+
+  // Truncated runs are rejected
+  data.pop_back();
+  data.pop_back();
+  offset = 0;
+  EXPECT_FALSE(
+    nav2_costmap_2d::decodeCostmapWindow(data, offset, decoded.data(), size_x, 3, 1, 69, 8));
+}
+
+TEST(CostmapDelta, DeltasTrackCostmap)
+{
+  nav2_costmap_2d::Costmap2D costmap(100, 75, 0.05, 1.0, -2.0);
+  nav2_costmap_2d::Costmap2D received(1, 1, 0.05, 1.0, -2.0);
+  std::vector<unsigned char> reference;
+  std::mt19937 rng(7);
+
+  nav2_msgs::msg::CostmapDelta msg;
+  nav2_costmap_2d::createCostmapDelta(costmap, reference, false, 32, msg);
+  // No reference yet, so everything is sent
+  ASSERT_TRUE(msg.keyframe);
+  EXPECT_EQ(msg.tiles.size(), 4u * 3u);
+  EXPECT_EQ(msg.metadata.size_x, 100u);
+  EXPECT_EQ(msg.metadata.size_y, 75u);
+  EXPECT_DOUBLE_EQ(msg.metadata.origin.position.x, 1.0);
+  received.resizeMap(100, 75, 0.05, 1.0, -2.0);
+  ASSERT_TRUE(nav2_costmap_2d::applyCostmapDelta(msg, received));
+  EXPECT_TRUE(sameCosts(costmap, received));
+
+  for (int i = 0; i < 20; i++) {
+    for (int j = 0; j < 5; j++) {
+      costmap.setCost(rng() % 100, rng() % 75, rng() % 256);
+    }
+    nav2_costmap_2d::createCostmapDelta(costmap, reference, false, 32, msg);
+    EXPECT_FALSE(msg.keyframe);
+    EXPECT_LE(msg.tiles.size(), 5u);
+    ASSERT_TRUE(nav2_costmap_2d::applyCostmapDelta(msg, received));
+    EXPECT_TRUE(sameCosts(costmap, received));
+  }
+
+  // Nothing changed
+  nav2_costmap_2d::createCostmapDelta(costmap, reference, false, 32, msg);
+  EXPECT_TRUE(msg.tiles.empty());
+  EXPECT_TRUE(msg.data.empty());
+
+  // Mismatched sizes are rejected
+  nav2_costmap_2d::Costmap2D other(10, 10, 0.05, 0.0, 0.0);
+  nav2_costmap_2d::createCostmapDelta(costmap, reference, true, 32, msg);
+  EXPECT_FALSE(nav2_costmap_2d::applyCostmapDelta(msg, other));
+}
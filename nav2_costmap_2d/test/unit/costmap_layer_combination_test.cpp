@@ -0,0 +1,147 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <functional>
+
+#include "nav2_costmap_2d/cost_values.hpp"
+#include "nav2_costmap_2d/costmap_2d.hpp"
+#include "nav2_costmap_2d/costmap_layer.hpp"
+
+using nav2_costmap_2d::NO_INFORMATION;
+using nav2_costmap_2d::INSCRIBED_INFLATED_OBSTACLE;
+
+// 256 x 256 cells so that every pair of master and layer costs is combined once
+static constexpr unsigned int SIZE = 256;
+
+class CombinationLayer : public nav2_costmap_2d::CostmapLayer
+{
+public:
+  CombinationLayer()
+  {
+    resizeMap(SIZE, SIZE, 1.0, 0.0, 0.0);
+    enabled_ = true;
+    for (unsigned int i = 0; i < SIZE * SIZE; ++i) {
+      costmap_[i] = static_cast<unsigned char>(i / SIZE);
+    }
+  }
+
+  void reset() override {}
+  bool isClearable() override {return false;}
+  void updateBounds(double, double, double, double *, double *, double *, double *) override {}
+  void updateCosts(nav2_costmap_2d::Costmap2D &, int, int, int, int) override {}
+
+  using CostmapLayer::updateWithMax;
+  using CostmapLayer::updateWithMaxWithoutUnknownOverwrite;
+  using CostmapLayer::updateWithOverwrite;
+  using CostmapLayer::updateWithTrueOverwrite;
+  using CostmapLayer::updateWithAddition;
+};
+
+void fillMaster(nav2_costmap_2d::Costmap2D & master)
+{
+  unsigned char * master_array = master.getCharMap();
+  for (unsigned int i = 0; i < SIZE * SIZE; ++i) {
+    master_array[i] = static_cast<unsigned char>(i % SIZE);
+  }
+}
+
+// Combines the layer into the master over odd bounds, comparing to the expected cell rule
+void checkCombination(
+  const std::function<void(CombinationLayer &, nav2_costmap_2d::Costmap2D &, int, int, int,
+  int)> & combine,
+  const std::function<unsigned char(unsigned char, unsigned char)> & expected)
+{
+  CombinationLayer layer;
+  nav2_costmap_2d::Costmap2D master(SIZE, SIZE, 1.0, 0.0, 0.0);
+  fillMaster(master);
+
+  const int min_i = 3, min_j = 0, max_i = SIZE - 2, max_j = SIZE;
+  combine(layer, master, min_i, min_j, max_i, max_j);
+
+  for (unsigned int j = 0; j < SIZE; ++j) {
+    for (unsigned int i = 0; i < SIZE; ++i) {
+      const unsigned char old_cost = static_cast<unsigned char>(i);
+      const unsigned char cost = static_cast<unsigned char>(j);
+      const bool inside = static_cast<int>(i) >= min_i && static_cast<int>(i) < max_i;
+      ASSERT_EQ(master.getCost(i, j), inside ? expected(old_cost, cost) : old_cost) <<
+        "master cost " << i << ", layer cost " << j;
+    }
+  }
+}
+
+TEST(CostmapLayerCombination, updateWithMax)
+{
+  checkCombination(
+    [](CombinationLayer & layer, nav2_costmap_2d::Costmap2D & master, int a, int b, int c,
+    int d) {layer.updateWithMax(master, a, b, c, d);},
+    [](unsigned char old_cost, unsigned char cost) -> unsigned char {
+      if (cost == NO_INFORMATION) {
+        return old_cost;
+      }
+      return (old_cost == NO_INFORMATION || old_cost < cost) ? cost : old_cost;
+    });
+}
+
+TEST(CostmapLayerCombination, updateWithMaxWithoutUnknownOverwrite)
+{
+  checkCombination(
+    [](CombinationLayer & layer, nav2_costmap_2d::Costmap2D & master, int a, int b, int c,
+    int d) {layer.updateWithMaxWithoutUnknownOverwrite(master, a, b, c, d);},
+    [](unsigned char old_cost, unsigned char cost) -> unsigned char {
+      if (cost == NO_INFORMATION) {
+        return old_cost;
+      }
+      return (old_cost != NO_INFORMATION && old_cost < cost) ? cost : old_cost;
+    });
+}
+
+TEST(CostmapLayerCombination, updateWithOverwrite)
+{
+  checkCombination(
+    [](CombinationLayer & layer, nav2_costmap_2d::Costmap2D & master, int a, int b, int c,
+    int d) {layer.updateWithOverwrite(master, a, b, c, d);},
+    [](unsigned char old_cost, unsigned char cost) -> unsigned char {
+      return cost == NO_INFORMATION ? old_cost : cost;
+    });
+}
+
+TEST(CostmapLayerCombination, updateWithTrueOverwrite)
+{
+  checkCombination(
+    [](CombinationLayer & layer, nav2_costmap_2d::Costmap2D & master, int a, int b, int c,
+    int d) {layer.updateWithTrueOverwrite(master, a, b, c, d);},
+    [](unsigned char, unsigned char cost) -> unsigned char {
+      return cost;
+    });
+}
+
+TEST(CostmapLayerCombination, updateWithAddition)
+{
+  checkCombination(
+    [](CombinationLayer & layer, nav2_costmap_2d::Costmap2D & master, int a, int b, int c,
+    int d) {layer.updateWithAddition(master, a, b, c, d);},
+    [](unsigned char old_cost, unsigned char cost) -> unsigned char {
+      if (cost == NO_INFORMATION) {
+        return old_cost;
+      }
+      if (old_cost == NO_INFORMATION) {
+        return cost;
+      }
+      const int sum = old_cost + cost;
+      return sum >= INSCRIBED_INFLATED_OBSTACLE ? INSCRIBED_INFLATED_OBSTACLE - 1 : sum;
+    });
+}
@@ -0,0 +1,60 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+#include "rclcpp/rclcpp.hpp"
+#include "nav2_costmap_2d/cost_values.hpp"
+#include "nav2_costmap_2d/costmap_registry.hpp"
+#include "nav2_costmap_2d/layered_costmap.hpp"
+
+class RclCppFixture
+{
+public:
+  RclCppFixture() {rclcpp::init(0, nullptr);}
+  ~RclCppFixture() {rclcpp::shutdown();}
+};
+RclCppFixture g_rclcppfixture;
+
+TEST(CostmapRegistry, SharesSnapshots)
+{
+  nav2_costmap_2d::LayeredCostmap layers("frame", false, false);
+  layers.resizeMap(10, 10, 0.05, 0.0, 0.0);
+  const std::string topic = "/local_costmap/costmap_raw";
+
+  EXPECT_EQ(nav2_costmap_2d::CostmapRegistry::getSnapshot(topic), nullptr);
+
+  nav2_costmap_2d::CostmapRegistry::add(
+    topic, [&layers]() -> std::shared_ptr<const nav2_costmap_2d::Costmap2D> {
+      return layers.getCostmapSnapshot();
+    });
+  auto snapshot = nav2_costmap_2d::CostmapRegistry::getSnapshot(topic);
+  ASSERT_NE(snapshot, nullptr);
+  EXPECT_EQ(snapshot, layers.getCostmapSnapshot());
+  EXPECT_EQ(snapshot->getSizeInCellsX(), 10u);
+  EXPECT_EQ(nav2_costmap_2d::CostmapRegistry::getSnapshot("/global_costmap/costmap_raw"), nullptr);
+
+  // Updates replace the snapshot held by the registry, not the ones handed out
+  layers.getCostmap()->setCost(1, 2, nav2_costmap_2d::LETHAL_OBSTACLE);
+  layers.updateMap(0.0, 0.0, 0.0);
+  auto updated = nav2_costmap_2d::CostmapRegistry::getSnapshot(topic);
+  EXPECT_NE(updated, snapshot);
+  EXPECT_EQ(snapshot->getCost(1, 2), nav2_costmap_2d::FREE_SPACE);
+
+  nav2_costmap_2d::CostmapRegistry::remove(topic);
+  EXPECT_EQ(nav2_costmap_2d::CostmapRegistry::getSnapshot(topic), nullptr);
+}
@@ -0,0 +1,67 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "nav2_costmap_2d/costmap_2d.hpp"
+#include "nav2_costmap_2d/costmap_snapshot.hpp"
+
+TEST(CostmapSnapshot, SaveAndLoad)
+{
+  nav2_costmap_2d::Costmap2D costmap(50, 30, 0.05, -1.0, 2.0);
+  for (unsigned int i = 0; i < 30; i++) {
+    costmap.setCost(i + 10, i, 254);
+    costmap.setCost(i, 20, 100);
+  }
+
+  nav2_msgs::msg::CostmapSnapshot snapshot;
+  snapshot.header.frame_id = "map";
+  nav2_costmap_2d::encodeCostmap(costmap, snapshot.metadata, snapshot.data);
+  EXPECT_EQ(snapshot.metadata.size_x, 50u);
+  EXPECT_EQ(snapshot.metadata.size_y, 30u);
+  EXPECT_LT(snapshot.data.size(), 50u * 30u);
+
+  nav2_msgs::msg::Costmap layer;
+  layer.metadata.layer = "obstacle_layer";
+  nav2_costmap_2d::encodeCostmap(costmap, layer.metadata, layer.data);
+  snapshot.layers.push_back(layer);
+  snapshot.robot_pose.pose.position.x = 0.3;
+  snapshot.path.poses.resize(3);
+
+  const std::string filename = "/tmp/costmap_snapshot_test.snapshot";
+  ASSERT_TRUE(nav2_costmap_2d::saveCostmapSnapshot(snapshot, filename));
+  nav2_msgs::msg::CostmapSnapshot loaded;
+  ASSERT_TRUE(nav2_costmap_2d::loadCostmapSnapshot(filename, loaded));
+  std::remove(filename.c_str());
+  EXPECT_EQ(loaded, snapshot);
+
+  nav2_costmap_2d::Costmap2D replayed;
+  ASSERT_TRUE(nav2_costmap_2d::decodeCostmap(loaded.metadata, loaded.data, replayed));
+  EXPECT_EQ(replayed.getSizeInCellsX(), 50u);
+  EXPECT_EQ(replayed.getSizeInCellsY(), 30u);
+  EXPECT_DOUBLE_EQ(replayed.getResolution(), 0.05);
+  EXPECT_DOUBLE_EQ(replayed.getOriginX(), -1.0);
+  EXPECT_DOUBLE_EQ(replayed.getOriginY(), 2.0);
+  EXPECT_EQ(std::memcmp(replayed.getCharMap(), costmap.getCharMap(), 50 * 30), 0);
+
+  // Truncated costs and missing files are rejected
+  loaded.data.resize(loaded.data.size() - 2);
+  EXPECT_FALSE(nav2_costmap_2d::decodeCostmap(loaded.metadata, loaded.data, replayed));
+  EXPECT_FALSE(nav2_costmap_2d::loadCostmapSnapshot("/tmp/no_such_snapshot", loaded));
+}
@@ -19,6 +19,7 @@
 #include <tuple>
 #include <stdexcept>
 #include <algorithm>
+#include <random>
 
 #include "nav2_costmap_2d/denoise_layer.hpp"
 #include "image_tests_helper.hpp"
@@ -87,6 +88,13 @@ public:
     d.minimal_group_size_ = minimal_group_size;
   }
 
+  static void configureIncremental(
+    nav2_costmap_2d::DenoiseLayer & d, ConnectivityType connectivity, size_t minimal_group_size)
+  {
+    configure(d, connectivity, minimal_group_size);
+    d.incremental_ = true;
+  }
+
   static std::tuple<bool, ConnectivityType, size_t> getParameters(
     const nav2_costmap_2d::DenoiseLayer & d)
   {
@@ -452,6 +460,44 @@ TEST_F(DenoiseLayerTester, updateCosts) {
   ASSERT_EQ(costmap.getCost(0), FREE_SPACE);
 }
 
+TEST_F(DenoiseLayerTester, updateCostsIncremental) {
+  for (const auto connectivity : {ConnectivityType::Way4, ConnectivityType::Way8}) {
+    nav2_costmap_2d::DenoiseLayer full, incremental;
+    DenoiseLayerTester::configure(full, connectivity, 4);
+    DenoiseLayerTester::configureIncremental(incremental, connectivity, 4);
+
+    std::mt19937 rng(7);
+    nav2_costmap_2d::Costmap2D input(40, 30, 1., 0., 0., FREE_SPACE);
+    for (unsigned int i = 0; i < input.getSizeInCellsX() * input.getSizeInCellsY(); i++) {
+      input.getCharMap()[i] = rng() % 3 ? FREE_SPACE : LETHAL_OBSTACLE;
+    }
+
+    for (int step = 0; step < 60; step++) {
+      // Toggle a few cells, sometimes roll the costmap or shrink the window
+      for (int i = 0; i < 5; i++) {
+        unsigned char & cost = input.getCharMap()[rng() % (40 * 30)];
+        cost = cost == FREE_SPACE ? LETHAL_OBSTACLE : FREE_SPACE;
+      }
+      if (step % 7 == 3) {
+        input.updateOrigin(
+          input.getOriginX() + static_cast<int>(rng() % 7) - 3,
+          input.getOriginY() + static_cast<int>(rng() % 7) - 3);
+      }
+      const int min_x = step % 5 == 4 ? rng() % 10 : 0;
+      const int min_y = step % 5 == 4 ? rng() % 10 : 0;
+
+      nav2_costmap_2d::Costmap2D expected = input;
+      nav2_costmap_2d::Costmap2D actual = input;
+      full.updateCosts(expected, min_x, min_y, 40, 30);
+      incremental.updateCosts(actual, min_x, min_y, 40, 30);
+      ASSERT_TRUE(
+        std::equal(
+          expected.getCharMap(), expected.getCharMap() + 40 * 30, actual.getCharMap())) <<
+        "step " << step;
+    }
+  }
+}
+
 // Copy paste from declare_parameter_test.cpp
 class RclCppFixture
 {
@@ -0,0 +1,148 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "rclcpp/rclcpp.hpp"
+#include "nav2_costmap_2d/costmap_2d.hpp"
+#include "nav2_costmap_2d/cost_values.hpp"
+#include "nav2_costmap_2d/distance_field.hpp"
+
+class RclCppFixture
+{
+public:
+  RclCppFixture() {rclcpp::init(0, nullptr);}
+  ~RclCppFixture() {rclcpp::shutdown();}
+};
+RclCppFixture g_rclcppfixture;
+
+// Brute force distance from a cell to the closest lethal cell, truncated
+float bruteForceDistance(
+  const nav2_costmap_2d::Costmap2D & costmap, unsigned int mx, unsigned int my,
+  double max_distance)
+{
+  double best = std::numeric_limits<double>::max();
+  for (unsigned int y = 0; y != costmap.getSizeInCellsY(); y++) {
+    for (unsigned int x = 0; x != costmap.getSizeInCellsX(); x++) {
+      if (costmap.getCost(x, y) == nav2_costmap_2d::LETHAL_OBSTACLE) {
+        best = std::min(
+          best, std::hypot(
+            static_cast<double>(x) - mx, static_cast<double>(y) - my) * costmap.getResolution());
+      }
+    }
+  }
+  return static_cast<float>(std::min(best, max_distance));
+}
+
+void expectMatchesBruteForce(
+  const nav2_costmap_2d::DistanceField & field, const nav2_costmap_2d::Costmap2D & costmap)
+{
+  for (unsigned int y = 0; y != costmap.getSizeInCellsY(); y++) {
+    for (unsigned int x = 0; x != costmap.getSizeInCellsX(); x++) {
+      EXPECT_NEAR(
+        field.getDistance(x, y),
+        bruteForceDistance(costmap, x, y, field.getMaxDistance()), 1e-5);
+    }
+  }
+}
+
+TEST(DistanceField, fullComputation)
+{
+  nav2_costmap_2d::Costmap2D costmap(40, 30, 0.1, 0.0, 0.0);
+  costmap.setCost(10, 10, nav2_costmap_2d::LETHAL_OBSTACLE);
+  costmap.setCost(25, 5, nav2_costmap_2d::LETHAL_OBSTACLE);
+  costmap.setCost(30, 20, nav2_costmap_2d::INSCRIBED_INFLATED_OBSTACLE);
+
+  nav2_costmap_2d::DistanceField field;
+  EXPECT_FALSE(field.isInitialized());
+  field.setMaxDistance(0.8);
+  field.update(costmap, false);
+  EXPECT_TRUE(field.isInitialized());
+
+  EXPECT_NEAR(field.getDistance(10, 10), 0.0, 1e-6);
+  EXPECT_NEAR(field.getDistance(13, 14), 0.5, 1e-6);
+  // Inflated costs are not obstacles, and far cells are truncated
+  EXPECT_NEAR(field.getDistance(30, 20), 0.8, 1e-6);
+  expectMatchesBruteForce(field, costmap);
+}
+
+TEST(DistanceField, incrementalUpdates)
+{
+  nav2_costmap_2d::Costmap2D costmap(40, 30, 0.1, 0.0, 0.0);
+  costmap.setCost(10, 10, nav2_costmap_2d::LETHAL_OBSTACLE);
+  nav2_costmap_2d::DistanceField field;
+  field.setMaxDistance(0.5);
+  field.update(costmap, false);
+
+  // Adding and removing obstacles should only need a window update
+  costmap.setCost(20, 15, nav2_costmap_2d::LETHAL_OBSTACLE);
+  costmap.setCost(10, 10, nav2_costmap_2d::FREE_SPACE);
+  field.update(costmap, false);
+  expectMatchesBruteForce(field, costmap);
+
+  // Unknown space is only an obstacle if requested
+  costmap.setCost(35, 25, nav2_costmap_2d::NO_INFORMATION);
+  field.update(costmap, false);
+  EXPECT_NEAR(field.getDistance(35, 25), 0.5, 1e-6);
+  field.update(costmap, true);
+  EXPECT_NEAR(field.getDistance(35, 25), 0.0, 1e-6);
+}
+
+TEST(DistanceField, rollingUpdates)
+{
+  nav2_costmap_2d::Costmap2D costmap(40, 30, 0.1, 0.0, 0.0);
+  for (unsigned int i = 0; i < 40 * 30; i += 37) {
+    costmap.setCost(i % 40, i / 40, nav2_costmap_2d::LETHAL_OBSTACLE);
+  }
+  nav2_costmap_2d::DistanceField field;
+  field.setMaxDistance(0.5);
+  field.update(costmap, false);
+
+  // Shift the costmap origin and mark some new obstacles in the exposed area
+  costmap.updateOrigin(0.3, -0.2);
+  costmap.setCost(39, 0, nav2_costmap_2d::LETHAL_OBSTACLE);
+  costmap.setCost(38, 1, nav2_costmap_2d::LETHAL_OBSTACLE);
+  field.update(costmap, false);
+  expectMatchesBruteForce(field, costmap);
+
+  costmap.updateOrigin(-0.2, 0.1);
+  field.update(costmap, false);
+  expectMatchesBruteForce(field, costmap);
+}
+
+TEST(DistanceField, interpolation)
+{
+  nav2_costmap_2d::Costmap2D costmap(20, 20, 0.1, 1.0, 2.0);
+  costmap.setCost(10, 10, nav2_costmap_2d::LETHAL_OBSTACLE);
+  nav2_costmap_2d::DistanceField field;
+  field.setMaxDistance(1.0);
+  field.update(costmap, false);
+
+  float distance = 0.0f;
+  // Cell centers are sampled exactly
+  ASSERT_TRUE(field.interpolateDistance(2.05, 3.05, distance));
+  EXPECT_NEAR(distance, 0.0, 1e-6);
+  ASSERT_TRUE(field.interpolateDistance(2.35, 3.05, distance));
+  EXPECT_NEAR(distance, 0.3, 1e-6);
+  // Half way between cell centers is the average of both
+  ASSERT_TRUE(field.interpolateDistance(2.30, 3.05, distance));
+  EXPECT_NEAR(distance, 0.25, 1e-6);
+
+  EXPECT_FALSE(field.interpolateDistance(0.9, 2.5, distance));
+  EXPECT_FALSE(field.interpolateDistance(1.5, 4.05, distance));
+}
@@ -158,6 +158,116 @@ TEST(collision_footprint, test_point_and_line_cost)
   EXPECT_NEAR(right_value, 254.0, 0.001);
 }
 
+TEST(collision_footprint, test_quantized_footprint_cost)
+{
+  std::shared_ptr<nav2_costmap_2d::Costmap2D> costmap_ =
+    std::make_shared<nav2_costmap_2d::Costmap2D>(100, 100, 0.1, 0.0, 0.0, 0);
+  for (unsigned int i = 0; i < 100; ++i) {
+    for (unsigned int j = 0; j < 100; ++j) {
+      costmap_->setCost(i, j, (i * 7 + j * 13) % 253);
+    }
+  }
+
+  geometry_msgs::msg::Point p1;
+  p1.x = -0.33;
+  p1.y = 0.27;
+  geometry_msgs::msg::Point p2;
+  p2.x = 0.41;
+  p2.y = 0.23;
+  geometry_msgs::msg::Point p3;
+  p3.x = 0.37;
+  p3.y = -0.29;
+  geometry_msgs::msg::Point p4;
+  p4.x = -0.31;
+  p4.y = -0.26;
+  nav2_costmap_2d::Footprint footprint = {p1, p2, p3, p4};
+
+  nav2_costmap_2d::FootprintCollisionChecker<std::shared_ptr<nav2_costmap_2d::Costmap2D>>
+  collision_checker(costmap_);
+
+  // Poses at cell centers and on the headings are exact
+  for (unsigned int heading = 0; heading < 16; ++heading) {
+    const double theta = 2.0 * M_PI * heading / 16 - 2.0 * M_PI;
+    for (double x = 1.05; x < 9.0; x += 0.7) {
+      for (double y = 1.05; y < 9.0; y += 0.9) {
+        EXPECT_NEAR(
+          collision_checker.footprintCostAtPoseQuantized(x, y, theta, footprint, 16),
+          collision_checker.footprintCostAtPose(x, y, theta, footprint), 0.001);
+      }
+    }
+  }
+
+  costmap_->setCost(54, 50, 254);
+  EXPECT_NEAR(
+    collision_checker.footprintCostAtPoseQuantized(5.05, 5.05, 0.0, footprint, 16),
+    254.0, 0.001);
+
+  // The outline leaves the costmap
+  EXPECT_NEAR(
+    collision_checker.footprintCostAtPoseQuantized(0.15, 5.05, 0.0, footprint, 16),
+    254.0, 0.001);
+
+  // The kernels follow changes of the footprint
+  footprint[1].x = 1.41;
+  EXPECT_NEAR(
+    collision_checker.footprintCostAtPoseQuantized(3.05, 3.05, 0.0, footprint, 16),
+    collision_checker.footprintCostAtPose(3.05, 3.05, 0.0, footprint), 0.001);
+}
+
+TEST(collision_footprint, test_footprint_box_below_cost)
+{
+  std::shared_ptr<nav2_costmap_2d::Costmap2D> costmap_ =
+    std::make_shared<nav2_costmap_2d::Costmap2D>(100, 100, 0.1, 0.0, 0.0, 0);
+  costmap_->setCost(60, 50, 254);
+
+  geometry_msgs::msg::Point p1;
+  p1.x = -0.3;
+  p1.y = 0.2;
+  geometry_msgs::msg::Point p2;
+  p2.x = 0.4;
+  p2.y = 0.2;
+  geometry_msgs::msg::Point p3;
+  p3.x = 0.4;
+  p3.y = -0.2;
+  geometry_msgs::msg::Point p4;
+  p4.x = -0.3;
+  p4.y = -0.2;
+  nav2_costmap_2d::Footprint footprint = {p1, p2, p3, p4};
+
+  nav2_costmap_2d::FootprintCollisionChecker<std::shared_ptr<nav2_costmap_2d::Costmap2D>>
+  collision_checker(costmap_);
+
+  // No cost pyramid, the footprint is to be checked
+  EXPECT_FALSE(collision_checker.isFootprintBoxBelowCost(2.05, 2.05, 0.0, footprint, 254));
+
+  nav2_costmap_2d::CostPyramid pyramid;
+  pyramid.update(*costmap_);
+  collision_checker.setCostPyramid(&pyramid);
+  for (const unsigned int num_headings : {0u, 16u}) {
+    // Far from the obstacle
+    EXPECT_TRUE(
+      collision_checker.isFootprintBoxBelowCost(2.05, 2.05, 0.0, footprint, 254, num_headings));
+    // The footprint reaches the obstacle, or only its bounding box does when rotated
+    EXPECT_FALSE(
+      collision_checker.isFootprintBoxBelowCost(5.65, 5.05, 0.0, footprint, 254, num_headings));
+    EXPECT_FALSE(
+      collision_checker.isFootprintBoxBelowCost(
+        5.75, 5.05, M_PI / 4.0, footprint, 254, num_headings));
+    // The footprint leaves the costmap
+    EXPECT_FALSE(
+      collision_checker.isFootprintBoxBelowCost(0.05, 5.05, 0.0, footprint, 254, num_headings));
+  }
+
+  // Whenever the box is below the cost, so is the footprint
+  for (double x = 4.05; x < 7.0; x += 0.1) {
+    for (double theta = 0.0; theta < 2.0 * M_PI; theta += 0.3) {
+      if (collision_checker.isFootprintBoxBelowCost(x, 5.05, theta, footprint, 254)) {
+        EXPECT_LT(collision_checker.footprintCostAtPose(x, 5.05, theta, footprint), 254.0);
+      }
+    }
+  }
+}
+
 TEST(collision_footprint, not_enough_points)
 {
   geometry_msgs::msg::Point p1;
@@ -0,0 +1,153 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "nav2_costmap_2d/incremental_inflation.hpp"
+
+using nav2_costmap_2d::IncrementalInflation;
+
+static constexpr unsigned int SIZE_X = 40;
+static constexpr unsigned int SIZE_Y = 30;
+static constexpr unsigned int RADIUS = 5;
+
+// Brute force squared distance from a cell to the closest obstacle, or max if none in radius
+unsigned int bruteForceDistance(
+  const std::vector<bool> & obstacles, unsigned int mx, unsigned int my)
+{
+  unsigned int best = std::numeric_limits<unsigned int>::max();
+  for (unsigned int y = 0; y != SIZE_Y; y++) {
+    for (unsigned int x = 0; x != SIZE_X; x++) {
+      if (obstacles[y * SIZE_X + x]) {
+        const int dx = static_cast<int>(x) - static_cast<int>(mx);
+        const int dy = static_cast<int>(y) - static_cast<int>(my);
+        best = std::min(best, static_cast<unsigned int>(dx * dx + dy * dy));
+      }
+    }
+  }
+  return best <= RADIUS * RADIUS ? best : std::numeric_limits<unsigned int>::max();
+}
+
+void expectMatchesBruteForce(
+  const IncrementalInflation & inflation, const std::vector<bool> & obstacles)
+{
+  for (unsigned int y = 0; y != SIZE_Y; y++) {
+    for (unsigned int x = 0; x != SIZE_X; x++) {
+      const unsigned int expected = bruteForceDistance(obstacles, x, y);
+      const int source = inflation.getSource(y * SIZE_X + x);
+      if (expected == std::numeric_limits<unsigned int>::max()) {
+        EXPECT_EQ(source, IncrementalInflation::NO_SOURCE);
+        continue;
+      }
+
+      ASSERT_NE(source, IncrementalInflation::NO_SOURCE);
+      EXPECT_TRUE(obstacles[source]);
+      const int dx = source % static_cast<int>(SIZE_X) - static_cast<int>(x);
+      const int dy = source / static_cast<int>(SIZE_X) - static_cast<int>(y);
+      EXPECT_EQ(static_cast<unsigned int>(dx * dx + dy * dy), expected);
+    }
+  }
+}
+
+TEST(IncrementalInflation, addAndRemoveObstacles)
+{
+  IncrementalInflation inflation;
+  EXPECT_FALSE(inflation.matches(SIZE_X, SIZE_Y, RADIUS));
+  inflation.reset(SIZE_X, SIZE_Y, RADIUS);
+  EXPECT_TRUE(inflation.matches(SIZE_X, SIZE_Y, RADIUS));
+  EXPECT_FALSE(inflation.matches(SIZE_X, SIZE_Y, RADIUS + 1));
+
+  std::vector<bool> obstacles(SIZE_X * SIZE_Y, false);
+  for (unsigned int index : {10u * SIZE_X + 10u, 12u * SIZE_X + 14u, 25u * SIZE_X + 30u}) {
+    obstacles[index] = true;
+    inflation.setObstacle(index, true);
+  }
+  inflation.propagate();
+  expectMatchesBruteForce(inflation, obstacles);
+  EXPECT_EQ(inflation.getSource(10 * SIZE_X + 10), static_cast<int>(10 * SIZE_X + 10));
+
+  // Removing an obstacle hands its cells over to the remaining ones, or clears them
+  obstacles[10 * SIZE_X + 10] = false;
+  inflation.setObstacle(10 * SIZE_X + 10, false);
+  inflation.propagate();
+  expectMatchesBruteForce(inflation, obstacles);
+}
+
+TEST(IncrementalInflation, randomUpdates)
+{
+  IncrementalInflation inflation;
+  inflation.reset(SIZE_X, SIZE_Y, RADIUS);
+  std::vector<bool> obstacles(SIZE_X * SIZE_Y, false);
+
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<unsigned int> cell(0, SIZE_X * SIZE_Y - 1);
+  for (int update = 0; update != 20; update++) {
+    for (int change = 0; change != 15; change++) {
+      const unsigned int index = cell(gen);
+      obstacles[index] = !obstacles[index];
+      inflation.setObstacle(index, obstacles[index]);
+    }
+    inflation.propagate();
+    expectMatchesBruteForce(inflation, obstacles);
+  }
+}
+
+TEST(IncrementalInflation, shift)
+{
+  IncrementalInflation inflation;
+  inflation.reset(SIZE_X, SIZE_Y, RADIUS);
+  std::vector<bool> obstacles(SIZE_X * SIZE_Y, false);
+
+  std::mt19937 gen(7);
+  std::uniform_int_distribution<unsigned int> cell(0, SIZE_X * SIZE_Y - 1);
+  for (int change = 0; change != 40; change++) {
+    const unsigned int index = cell(gen);
+    obstacles[index] = true;
+    inflation.setObstacle(index, true);
+  }
+  inflation.propagate();
+
+  for (auto offset : std::vector<std::pair<int, int>>{{3, 0}, {0, -4}, {-6, 2}, {2, 7}}) {
+    inflation.shift(offset.first, offset.second);
+
+    std::vector<bool> shifted(SIZE_X * SIZE_Y, false);
+    for (int y = 0; y != static_cast<int>(SIZE_Y); y++) {
+      for (int x = 0; x != static_cast<int>(SIZE_X); x++) {
+        const int old_x = x + offset.first;
+        const int old_y = y + offset.second;
+        if (old_x >= 0 && old_y >= 0 && old_x < static_cast<int>(SIZE_X) &&
+          old_y < static_cast<int>(SIZE_Y))
+        {
+          shifted[y * SIZE_X + x] = obstacles[old_y * SIZE_X + old_x];
+        }
+      }
+    }
+    obstacles.swap(shifted);
+
+    // New obstacles may appear anywhere, including the exposed cells
+    for (int change = 0; change != 10; change++) {
+      const unsigned int index = cell(gen);
+      obstacles[index] = !obstacles[index];
+      inflation.setObstacle(index, obstacles[index]);
+    }
+    inflation.propagate();
+    expectMatchesBruteForce(inflation, obstacles);
+  }
+}
@@ -465,6 +465,46 @@ TEST_F(TestNode, testDifferentFrames)
   reset();
 }
 
+TEST_F(TestNode, testRollingWindow)
+{
+  // Initialize test system
+  createMaps(nav2_costmap_2d::FREE_SPACE, nav2_util::OCC_GRID_OCCUPIED, "map");
+  publishMaps();
+  createKeepoutFilter("map");
+
+  geometry_msgs::msg::Pose2D pose;
+  keepout_filter_->process(*master_grid_, 0, 0, 10, 10, pose);
+  for (unsigned int x = 3; x < 6; x++) {
+    for (unsigned int y = 3; y < 6; y++) {
+      keepout_points_.push_back(Point{x, y});
+    }
+  }
+  verifyMasterGrid(nav2_costmap_2d::FREE_SPACE, nav2_costmap_2d::LETHAL_OBSTACLE);
+
+  // Move the window as a rolling costmap does: the mask stays in place in the world
+  master_grid_->updateOrigin(2.0, 1.0);
+  master_grid_->resetMap(0, 0, 10, 10);
+  keepout_filter_->process(*master_grid_, 0, 0, 10, 10, pose);
+  keepout_points_.clear();
+  for (unsigned int x = 1; x < 4; x++) {
+    for (unsigned int y = 2; y < 5; y++) {
+      keepout_points_.push_back(Point{x, y});
+    }
+  }
+  verifyMasterGrid(nav2_costmap_2d::FREE_SPACE, nav2_costmap_2d::LETHAL_OBSTACLE);
+
+  // Move the mask out of the window
+  master_grid_->updateOrigin(-8.0, 1.0);
+  master_grid_->resetMap(0, 0, 10, 10);
+  keepout_filter_->process(*master_grid_, 0, 0, 10, 10, pose);
+  keepout_points_.clear();
+  verifyMasterGrid(nav2_costmap_2d::FREE_SPACE, nav2_costmap_2d::LETHAL_OBSTACLE);
+
+  // Clean-up
+  keepout_filter_->resetFilter();
+  reset();
+}
+
 int main(int argc, char ** argv)
 {
   // Initialize the system
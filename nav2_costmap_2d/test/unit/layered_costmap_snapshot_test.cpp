@@ -0,0 +1,92 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "rclcpp/rclcpp.hpp"
+#include "nav2_costmap_2d/cost_values.hpp"
+#include "nav2_costmap_2d/layered_costmap.hpp"
+
+class RclCppFixture
+{
+public:
+  RclCppFixture() {rclcpp::init(0, nullptr);}
+  ~RclCppFixture() {rclcpp::shutdown();}
+};
+RclCppFixture g_rclcppfixture;
+
+TEST(LayeredCostmapSnapshot, SnapshotsAreImmutable)
+{
+  nav2_costmap_2d::LayeredCostmap layers("frame", false, false);
+  layers.resizeMap(10, 20, 0.5, 1.0, 2.0);
+  layers.getCostmap()->setCost(3, 4, nav2_costmap_2d::LETHAL_OBSTACLE);
+
+  auto first = layers.getCostmapSnapshot();
+  ASSERT_NE(first, nullptr);
+  EXPECT_EQ(first->getSizeInCellsX(), 10u);
+  EXPECT_EQ(first->getSizeInCellsY(), 20u);
+  EXPECT_DOUBLE_EQ(first->getResolution(), 0.5);
+  EXPECT_DOUBLE_EQ(first->getOriginX(), 1.0);
+  EXPECT_DOUBLE_EQ(first->getOriginY(), 2.0);
+  EXPECT_EQ(first->getCost(3, 4), nav2_costmap_2d::LETHAL_OBSTACLE);
+
+  // Nothing changes before the next update
+  layers.getCostmap()->setCost(5, 6, nav2_costmap_2d::LETHAL_OBSTACLE);
+  EXPECT_EQ(layers.getCostmapSnapshot(), first);
+  EXPECT_EQ(first->getCost(5, 6), nav2_costmap_2d::FREE_SPACE);
+
+  layers.updateMap(0, 0, 0);
+  auto second = layers.getCostmapSnapshot();
+  EXPECT_NE(second, first);
+  EXPECT_EQ(second->getCost(5, 6), nav2_costmap_2d::LETHAL_OBSTACLE);
+  EXPECT_EQ(first->getCost(5, 6), nav2_costmap_2d::FREE_SPACE);
+
+  // The first snapshot is still held, so it is not reused
+  layers.getCostmap()->setCost(7, 8, nav2_costmap_2d::LETHAL_OBSTACLE);
+  layers.updateMap(0, 0, 0);
+  auto third = layers.getCostmapSnapshot();
+  EXPECT_NE(third, first);
+  EXPECT_EQ(first->getCost(7, 8), nav2_costmap_2d::FREE_SPACE);
+  EXPECT_EQ(third->getCost(7, 8), nav2_costmap_2d::LETHAL_OBSTACLE);
+
+  // Once released, the buffer of the replaced snapshot is reused
+  const nav2_costmap_2d::Costmap2D * second_buffer = second.get();
+  first.reset();
+  second.reset();
+  layers.updateMap(0, 0, 0);
+  auto fourth = layers.getCostmapSnapshot();
+  EXPECT_EQ(fourth.get(), second_buffer);
+  EXPECT_EQ(fourth->getCost(3, 4), nav2_costmap_2d::LETHAL_OBSTACLE);
+  EXPECT_EQ(fourth->getCost(7, 8), nav2_costmap_2d::LETHAL_OBSTACLE);
+}
+
+TEST(LayeredCostmapSnapshot, SnapshotFollowsResize)
+{
+  nav2_costmap_2d::LayeredCostmap layers("frame", false, true);
+  layers.resizeMap(10, 10, 1.0, 0.0, 0.0);
+  auto first = layers.getCostmapSnapshot();
+  first.reset();
+  layers.updateMap(0, 0, 0);
+
+  layers.resizeMap(30, 5, 0.1, -1.0, 0.0);
+  layers.updateMap(0, 0, 0);
+  auto snapshot = layers.getCostmapSnapshot();
+  EXPECT_EQ(snapshot->getSizeInCellsX(), 30u);
+  EXPECT_EQ(snapshot->getSizeInCellsY(), 5u);
+  EXPECT_DOUBLE_EQ(snapshot->getOriginX(), -1.0);
+  EXPECT_EQ(snapshot->getDefaultValue(), nav2_costmap_2d::NO_INFORMATION);
+  EXPECT_EQ(snapshot->getCost(29, 4), nav2_costmap_2d::NO_INFORMATION);
+}
@@ -0,0 +1,255 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
+#include "rclcpp/rclcpp.hpp"
+#include "nav2_costmap_2d/layer.hpp"
+#include "nav2_costmap_2d/layered_costmap.hpp"
+
+class RclCppFixture
+{
+public:
+  RclCppFixture() {rclcpp::init(0, nullptr);}
+  ~RclCppFixture() {rclcpp::shutdown();}
+};
+RclCppFixture g_rclcppfixture;
+
+// Layer updating the bounds of a box set by the test
+class BoxLayer : public nav2_costmap_2d::Layer
+{
+public:
+  void reset() {}
+  bool isClearable() {return false;}
+
+  void updateBounds(
+    double, double, double, double * min_x, double * min_y, double * max_x, double * max_y)
+  {
+    *min_x = std::min(*min_x, box_[0]);
+    *min_y = std::min(*min_y, box_[1]);
+    *max_x = std::max(*max_x, box_[2]);
+    *max_y = std::max(*max_y, box_[3]);
+  }
+
+  void updateCosts(nav2_costmap_2d::Costmap2D &, int, int, int, int) {}
+
+  void setBox(double min_x, double min_y, double max_x, double max_y)
+  {
+    box_[0] = min_x;
+    box_[1] = min_y;
+    box_[2] = max_x;
+    box_[3] = max_y;
+  }
+
+protected:
+  double box_[4];
+};
+
+TEST(LayeredCostmapUpdatedWindow, WindowsAreMergedSinceUpdate)
+{
+  nav2_costmap_2d::LayeredCostmap layers("frame", false, false);
+  auto layer = std::make_shared<BoxLayer>();
+  layers.addPlugin(layer);
+  layers.resizeMap(100, 100, 1.0, 0.0, 0.0);
+
+  unsigned int x0, xn, y0, yn;
+  const uint64_t start = layers.getUpdateCount();
+  EXPECT_FALSE(layers.getUpdatedWindowSince(start - 1, x0, xn, y0, yn));
+  ASSERT_TRUE(layers.getUpdatedWindowSince(start, x0, xn, y0, yn));
+  EXPECT_EQ(x0, xn);
+  EXPECT_EQ(y0, yn);
+
+  layer->setBox(10.5, 20.5, 12.5, 21.5);
+  layers.updateMap(0, 0, 0);
+  const uint64_t first = layers.getUpdateCount();
+  layer->setBox(50.5, 5.5, 60.5, 6.5);
+  layers.updateMap(0, 0, 0);
+
+  ASSERT_TRUE(layers.getUpdatedWindowSince(first, x0, xn, y0, yn));
+  EXPECT_EQ(x0, 50u);
+  EXPECT_EQ(xn, 61u);
+  EXPECT_EQ(y0, 5u);
+  EXPECT_EQ(yn, 7u);
+
+  ASSERT_TRUE(layers.getUpdatedWindowSince(start, x0, xn, y0, yn));
+  EXPECT_EQ(x0, 10u);
+  EXPECT_EQ(xn, 61u);
+  EXPECT_EQ(y0, 5u);
+  EXPECT_EQ(yn, 22u);
+
+  // Updates more than the history holds are not known
+  for (int i = 0; i != 40; i++) {
+    layers.updateMap(0, 0, 0);
+  }
+  EXPECT_FALSE(layers.getUpdatedWindowSince(start, x0, xn, y0, yn));
+  EXPECT_TRUE(layers.getUpdatedWindowSince(layers.getUpdateCount() - 1, x0, xn, y0, yn));
+}
+
+TEST(LayeredCostmapUpdatedWindow, ChangesOfTheWholeMapAreNotKnown)
+{
+  nav2_costmap_2d::LayeredCostmap layers("frame", false, false);
+  auto layer = std::make_shared<BoxLayer>();
+  layer->setBox(1.5, 1.5, 2.5, 2.5);
+  layers.addPlugin(layer);
+  layers.resizeMap(10, 10, 1.0, 0.0, 0.0);
+
+  unsigned int x0, xn, y0, yn;
+  uint64_t count = layers.getUpdateCount();
+  layers.resizeMap(20, 10, 1.0, 0.0, 0.0);
+  EXPECT_FALSE(layers.getUpdatedWindowSince(count, x0, xn, y0, yn));
+
+  count = layers.getUpdateCount();
+  layers.markAllCellsUpdated();
+  EXPECT_FALSE(layers.getUpdatedWindowSince(count, x0, xn, y0, yn));
+
+  count = layers.getUpdateCount();
+  layers.updateMap(0, 0, 0);
+  EXPECT_TRUE(layers.getUpdatedWindowSince(count, x0, xn, y0, yn));
+
+  // Moving a rolling window shifts all cells
+  nav2_costmap_2d::LayeredCostmap rolling("frame", true, false);
+  rolling.addPlugin(layer);
+  rolling.resizeMap(10, 10, 1.0, 0.0, 0.0);
+  rolling.updateMap(5.0, 5.0, 0);
+  count = rolling.getUpdateCount();
+  rolling.updateMap(5.2, 5.2, 0);
+  EXPECT_TRUE(rolling.getUpdatedWindowSince(count, x0, xn, y0, yn));
+  count = rolling.getUpdateCount();
+  rolling.updateMap(8.0, 5.0, 0);
+  EXPECT_FALSE(rolling.getUpdatedWindowSince(count, x0, xn, y0, yn));
+}
+
+// Box layer with a name, counting its updates
+class NamedBoxLayer : public BoxLayer
+{
+public:
+  explicit NamedBoxLayer(const std::string & name)
+  {
+    name_ = name;
+  }
+
+  void updateCosts(nav2_costmap_2d::Costmap2D &, int, int, int, int)
+  {
+    updates_++;
+  }
+
+  int updates_{0};
+};
+
+TEST(LayeredCostmapUpdatedWindow, DecimatedLayersCatchUpOnSkippedWindows)
+{
+  nav2_costmap_2d::LayeredCostmap layers("frame", false, false);
+  auto obstacles = std::make_shared<NamedBoxLayer>("obstacles");
+  auto denoise = std::make_shared<NamedBoxLayer>("denoise");
+  layers.addPlugin(obstacles);
+  layers.addPlugin(denoise);
+  layers.resizeMap(100, 100, 1.0, 0.0, 0.0);
+  EXPECT_FALSE(layers.setLayerDecimation("unknown", 2));
+  ASSERT_TRUE(layers.setLayerDecimation("denoise", 2));
+
+  denoise->setBox(80.5, 80.5, 81.5, 81.5);
+  obstacles->setBox(10.5, 10.5, 11.5, 11.5);
+  layers.updateMap(0, 0, 0);
+  EXPECT_EQ(obstacles->updates_, 1);
+  EXPECT_EQ(denoise->updates_, 0);
+
+  // The update of the decimated layer also updates the window it skipped
+  obstacles->setBox(30.5, 30.5, 31.5, 31.5);
+  const uint64_t count = layers.getUpdateCount();
+  layers.updateMap(0, 0, 0);
+  EXPECT_EQ(obstacles->updates_, 2);
+  EXPECT_EQ(denoise->updates_, 1);
+  unsigned int x0, xn, y0, yn;
+  ASSERT_TRUE(layers.getUpdatedWindowSince(count, x0, xn, y0, yn));
+  EXPECT_EQ(x0, 10u);
+  EXPECT_EQ(y0, 10u);
+  EXPECT_EQ(xn, 82u);
+  EXPECT_EQ(yn, 82u);
+
+  auto times = layers.getLayerUpdateTimes();
+  ASSERT_EQ(times.size(), 2u);
+  EXPECT_EQ(times[0].first, "obstacles");
+  EXPECT_EQ(times[1].first, "denoise");
+  EXPECT_GE(times[1].second, 0.0);
+}
+
+// Named box layer setting a cost in its box
+class CostBoxLayer : public NamedBoxLayer
+{
+public:
+  CostBoxLayer(const std::string & name, unsigned char cost)
+  : NamedBoxLayer(name), cost_(cost) {}
+
+  void updateCosts(nav2_costmap_2d::Costmap2D & master_grid, int x0, int y0, int xn, int yn)
+  {
+    updates_++;
+    const int min_x = std::max(x0, static_cast<int>(box_[0]));
+    const int min_y = std::max(y0, static_cast<int>(box_[1]));
+    const int max_x = std::min(xn, static_cast<int>(box_[2]) + 1);
+    const int max_y = std::min(yn, static_cast<int>(box_[3]) + 1);
+    for (int j = min_y; j < max_y; j++) {
+      for (int i = min_x; i < max_x; i++) {
+        master_grid.setCost(i, j, cost_);
+      }
+    }
+  }
+
+protected:
+  unsigned char cost_;
+};
+
+TEST(LayeredCostmapUpdatedWindow, DecimatedLayersKeepTheirCostsOnSkippedUpdates)
+{
+  nav2_costmap_2d::LayeredCostmap layers("frame", false, false);
+  auto obstacles = std::make_shared<CostBoxLayer>("obstacles", 100);
+  auto lethal = std::make_shared<CostBoxLayer>("lethal", nav2_costmap_2d::LETHAL_OBSTACLE);
+  auto denoise = std::make_shared<CostBoxLayer>("denoise", 200);
+  layers.addPlugin(obstacles);
+  layers.addPlugin(lethal);
+  layers.addPlugin(denoise);
+  layers.resizeMap(100, 100, 1.0, 0.0, 0.0);
+  ASSERT_TRUE(layers.setLayerDecimation("denoise", 2));
+  nav2_costmap_2d::Costmap2D * master = layers.getCostmap();
+
+  obstacles->setBox(10.5, 10.5, 11.5, 11.5);
+  lethal->setBox(90.5, 90.5, 90.5, 90.5);
+  denoise->setBox(40.5, 40.5, 41.5, 41.5);
+  layers.updateMap(0, 0, 0);
+  layers.updateMap(0, 0, 0);
+  ASSERT_EQ(denoise->updates_, 1);
+  EXPECT_EQ(master->getCost(40, 40), 200);
+  EXPECT_EQ(master->getCost(10, 10), 100);
+
+  // The window of a skipped update covers the costs of the decimated layer, which stay
+  obstacles->setBox(30.5, 30.5, 45.5, 45.5);
+  layers.updateMap(0, 0, 0);
+  ASSERT_EQ(denoise->updates_, 1);
+  EXPECT_EQ(master->getCost(40, 40), 200);
+  EXPECT_EQ(master->getCost(41, 41), 200);
+  EXPECT_EQ(master->getCost(35, 35), 100);
+
+  // Higher costs of the other layers are kept over them
+  lethal->setBox(40.5, 40.5, 40.5, 40.5);
+  layers.updateMap(0, 0, 0);
+  ASSERT_EQ(denoise->updates_, 2);
+  EXPECT_EQ(master->getCost(40, 40), 200);
+  layers.updateMap(0, 0, 0);
+  ASSERT_EQ(denoise->updates_, 2);
+  EXPECT_EQ(master->getCost(40, 40), nav2_costmap_2d::LETHAL_OBSTACLE);
+  EXPECT_EQ(master->getCost(41, 41), 200);
+}
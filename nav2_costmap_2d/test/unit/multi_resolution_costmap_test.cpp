@@ -0,0 +1,85 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "geometry_msgs/msg/point.hpp"
+#include "nav2_costmap_2d/costmap_2d.hpp"
+#include "nav2_costmap_2d/cost_values.hpp"
+#include "nav2_costmap_2d/multi_resolution_costmap.hpp"
+
+using nav2_costmap_2d::Costmap2D;
+using nav2_costmap_2d::MultiResolutionCostmap;
+
+std::vector<geometry_msgs::msg::Point> squareFootprint(double x, double y, double half_size)
+{
+  std::vector<geometry_msgs::msg::Point> footprint(4);
+  footprint[0].x = x - half_size;
+  footprint[0].y = y - half_size;
+  footprint[1].x = x + half_size;
+  footprint[1].y = y - half_size;
+  footprint[2].x = x + half_size;
+  footprint[2].y = y + half_size;
+  footprint[3].x = x - half_size;
+  footprint[3].y = y + half_size;
+  return footprint;
+}
+
+TEST(MultiResolutionCostmap, queriesTheFinestCostmap)
+{
+  // 10 m at 0.1 m with a 2 m window at 0.025 m in its middle
+  Costmap2D outer(100, 100, 0.1, 0.0, 0.0);
+  Costmap2D inner(80, 80, 0.025, 4.0, 4.0);
+  outer.setCost(50, 50, 100);
+  outer.setCost(10, 10, 200);
+  inner.setCost(40, 40, 50);
+
+  MultiResolutionCostmap costmaps(&outer, &inner);
+  auto lock = costmaps.lock();
+  EXPECT_EQ(costmaps.getCostmapAt(5.01, 5.01), &inner);
+  EXPECT_EQ(costmaps.getCostmapAt(1.05, 1.05), &outer);
+  EXPECT_DOUBLE_EQ(costmaps.getResolutionAt(5.01, 5.01), 0.025);
+  EXPECT_DOUBLE_EQ(costmaps.getResolutionAt(1.05, 1.05), 0.1);
+
+  // The window hides the cost of the outer costmap under it
+  EXPECT_EQ(costmaps.getCost(5.01, 5.01), 50);
+  EXPECT_EQ(costmaps.getCost(5.05, 5.05), 0);
+  EXPECT_EQ(costmaps.getCost(1.05, 1.05), 200);
+  EXPECT_EQ(costmaps.getCost(-1.0, 5.0), nav2_costmap_2d::NO_INFORMATION);
+
+  // Footprints inside the window are checked at its resolution, others in the outer costmap
+  EXPECT_EQ(costmaps.footprintCost(squareFootprint(5.0, 5.0, 0.01)), 50);
+  EXPECT_EQ(costmaps.footprintCost(squareFootprint(5.0, 5.0, 0.5)), 0);
+  EXPECT_EQ(costmaps.footprintCost(squareFootprint(5.0, 5.0, 1.5)), 0);
+  EXPECT_EQ(costmaps.footprintCost(squareFootprint(5.05, 5.05, 0.0)), 0);
+  EXPECT_EQ(costmaps.footprintCost(squareFootprint(1.05, 1.05, 0.0)), 200);
+  EXPECT_EQ(
+    costmaps.footprintCost(squareFootprint(0.0, 0.0, 0.5)), nav2_costmap_2d::LETHAL_OBSTACLE);
+}
+
+TEST(MultiResolutionCostmap, withoutInnerWindow)
+{
+  Costmap2D outer(100, 100, 0.1, 0.0, 0.0);
+  outer.setCost(50, 50, 100);
+
+  MultiResolutionCostmap costmaps(&outer);
+  auto lock = costmaps.lock();
+  EXPECT_EQ(costmaps.getInnerCostmap(), nullptr);
+  EXPECT_EQ(costmaps.getCostmapAt(5.05, 5.05), &outer);
+  EXPECT_EQ(costmaps.getCost(5.05, 5.05), 100);
+  EXPECT_EQ(costmaps.footprintCost(squareFootprint(5.05, 5.05, 0.0)), 100);
+}
@@ -0,0 +1,221 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "nav2_util/lifecycle_node.hpp"
+#include "nav2_costmap_2d/observation_buffer.hpp"
+#include "nav2_costmap_2d/shared_observation_source.hpp"
+#include "sensor_msgs/point_cloud2_iterator.hpp"
+#include "tf2_ros/buffer.h"
+
+class RclCppFixture
+{
+public:
+  RclCppFixture() {rclcpp::init(0, nullptr);}
+  ~RclCppFixture() {rclcpp::shutdown();}
+};
+RclCppFixture g_rclcppfixture;
+
+sensor_msgs::msg::PointCloud2 makeCloud(
+  const std::vector<std::vector<float>> & points, const rclcpp::Time & stamp)
+{
+  sensor_msgs::msg::PointCloud2 cloud;
+  cloud.header.frame_id = "sensor";
+  cloud.header.stamp = stamp;
+  sensor_msgs::PointCloud2Modifier modifier(cloud);
+  modifier.setPointCloud2Fields(
+    4, "x", 1, sensor_msgs::msg::PointField::FLOAT32,
+    "y", 1, sensor_msgs::msg::PointField::FLOAT32,
+    "z", 1, sensor_msgs::msg::PointField::FLOAT32,
+    "intensity", 1, sensor_msgs::msg::PointField::FLOAT32);
+  modifier.resize(points.size());
+
+  sensor_msgs::PointCloud2Iterator<float> iter_x(cloud, "x");
+  sensor_msgs::PointCloud2Iterator<float> iter_y(cloud, "y");
+  sensor_msgs::PointCloud2Iterator<float> iter_z(cloud, "z");
+  sensor_msgs::PointCloud2Iterator<float> iter_i(cloud, "intensity");
+  for (const auto & point : points) {
+    *iter_x = point[0];
+    *iter_y = point[1];
+    *iter_z = point[2];
+    *iter_i = point[3];
+    ++iter_x;
+    ++iter_y;
+    ++iter_z;
+    ++iter_i;
+  }
+  return cloud;
+}
+
+TEST(ObservationBuffer, transformsAndFiltersInOnePass)
+{
+  auto node = std::make_shared<nav2_util::LifecycleNode>("observation_buffer_test");
+  tf2_ros::Buffer tf(node->get_clock());
+
+  // The sensor is 1 m ahead and 0.5 m above the map origin
+  geometry_msgs::msg::TransformStamped transform;
+  transform.header.frame_id = "map";
+  transform.child_frame_id = "sensor";
+  transform.transform.translation.x = 1.0;
+  transform.transform.translation.z = 0.5;
+  transform.transform.rotation.w = 1.0;
+  tf.setTransform(transform, "test", true);
+
+  nav2_costmap_2d::ObservationBuffer buffer(
+    node, "cloud", 0.0, 0.0, 0.0, 2.0, 3.0, 0.0, 4.0, 0.0, tf, "map", "",
+    tf2::durationFromSec(0.1));
+
+  buffer.bufferCloud(
+    makeCloud(
+      {{0.0, 0.0, 0.0, 1.0}, {1.0, 2.0, -1.0, 2.0}, {2.0, 1.0, 1.0, 3.0}, {0.5, 0.5, 2.0, 4.0}},
+      node->now()));
+
+  std::vector<nav2_costmap_2d::Observation> observations;
+  buffer.getObservations(observations);
+  ASSERT_EQ(observations.size(), 1u);
+
+  const nav2_costmap_2d::Observation & obs = observations[0];
+  EXPECT_DOUBLE_EQ(obs.origin_.x, 1.0);
+  EXPECT_DOUBLE_EQ(obs.origin_.z, 0.5);
+  EXPECT_EQ(obs.cloud_->header.frame_id, "map");
+
+  // Points below 0 m or above 2 m in the map frame are removed, others are
+  // transformed and keep their other fields
+  ASSERT_EQ(obs.cloud_->width * obs.cloud_->height, 2u);
+  sensor_msgs::PointCloud2ConstIterator<float> iter_x(*obs.cloud_, "x");
+  sensor_msgs::PointCloud2ConstIterator<float> iter_y(*obs.cloud_, "y");
+  sensor_msgs::PointCloud2ConstIterator<float> iter_z(*obs.cloud_, "z");
+  sensor_msgs::PointCloud2ConstIterator<float> iter_i(*obs.cloud_, "intensity");
+  EXPECT_FLOAT_EQ(*iter_x, 1.0f);
+  EXPECT_FLOAT_EQ(*iter_y, 0.0f);
+  EXPECT_FLOAT_EQ(*iter_z, 0.5f);
+  EXPECT_FLOAT_EQ(*iter_i, 1.0f);
+  ++iter_x;
+  ++iter_y;
+  ++iter_z;
+  ++iter_i;
+  EXPECT_FLOAT_EQ(*iter_x, 3.0f);
+  EXPECT_FLOAT_EQ(*iter_y, 1.0f);
+  EXPECT_FLOAT_EQ(*iter_z, 1.5f);
+  EXPECT_FLOAT_EQ(*iter_i, 3.0f);
+
+  // Handing out the observations again shares the same cloud
+  std::vector<nav2_costmap_2d::Observation> observations_again;
+  buffer.getObservations(observations_again);
+  ASSERT_EQ(observations_again.size(), 1u);
+  EXPECT_EQ(observations_again[0].cloud_, obs.cloud_);
+}
+
+TEST(ObservationBuffer, sharedSourceHandsObservationsOver)
+{
+  auto node = std::make_shared<nav2_util::LifecycleNode>("shared_observation_test");
+  tf2_ros::Buffer tf(node->get_clock());
+
+  geometry_msgs::msg::TransformStamped transform;
+  transform.header.frame_id = "map";
+  transform.child_frame_id = "sensor";
+  transform.transform.rotation.w = 1.0;
+  tf.setTransform(transform, "test", true);
+
+  auto make_buffer = [&]() {
+      return std::make_shared<nav2_costmap_2d::ObservationBuffer>(
+        node, "cloud", 0.0, 0.0, 0.0, 2.0, 3.0, 0.0, 4.0, 0.0, tf, "map", "",
+        tf2::durationFromSec(0.1));
+    };
+  auto first = make_buffer();
+  auto second = make_buffer();
+
+  auto source = nav2_costmap_2d::SharedObservationSource::acquire("cloud map");
+  EXPECT_EQ(source, nav2_costmap_2d::SharedObservationSource::acquire("cloud map"));
+  EXPECT_NE(source, nav2_costmap_2d::SharedObservationSource::acquire("cloud odom"));
+  source->addBuffer(first);
+  source->addBuffer(second);
+
+  // The first layer asking processes the messages until it releases the source
+  int first_layer, second_layer;
+  EXPECT_TRUE(source->isProcessor(&first_layer));
+  EXPECT_FALSE(source->isProcessor(&second_layer));
+
+  first->bufferCloud(makeCloud({{1.0, 0.0, 1.0, 1.0}}, node->now()));
+  source->forward(first);
+  // Nothing new to hand over
+  source->forward(first);
+
+  std::vector<nav2_costmap_2d::Observation> first_observations, second_observations;
+  first->getObservations(first_observations);
+  second->getObservations(second_observations);
+  ASSERT_EQ(first_observations.size(), 1u);
+  ASSERT_EQ(second_observations.size(), 1u);
+  EXPECT_EQ(first_observations[0].cloud_, second_observations[0].cloud_);
+
+  source->release(&first_layer);
+  EXPECT_TRUE(source->isProcessor(&second_layer));
+  EXPECT_FALSE(source->isProcessor(&first_layer));
+}
+
+TEST(ObservationBuffer, expiresOldestAndReusesClouds)
+{
+  auto node = std::make_shared<nav2_util::LifecycleNode>("observation_ring_test");
+  tf2_ros::Buffer tf(node->get_clock());
+
+  geometry_msgs::msg::TransformStamped transform;
+  transform.header.frame_id = "map";
+  transform.child_frame_id = "sensor";
+  transform.transform.rotation.w = 1.0;
+  tf.setTransform(transform, "test", true);
+
+  // Observations are kept for 1 s, the ring grows past its initial capacity
+  nav2_costmap_2d::ObservationBuffer buffer(
+    node, "cloud", 1.0, 0.0, 0.0, 2.0, 3.0, 0.0, 4.0, 0.0, tf, "map", "",
+    tf2::durationFromSec(0.1));
+  const rclcpp::Time now = node->now();
+  buffer.bufferCloud(
+    makeCloud({{0.0, 0.0, 1.0, 0.0}}, now - rclcpp::Duration::from_seconds(5.0)));
+  for (int i = 1; i <= 6; ++i) {
+    buffer.bufferCloud(makeCloud({{static_cast<float>(i), 0.0, 1.0, 0.0}}, now));
+  }
+
+  std::vector<nav2_costmap_2d::Observation> observations;
+  buffer.getObservations(observations);
+  ASSERT_EQ(observations.size(), 6u);
+  for (int i = 0; i < 6; ++i) {
+    sensor_msgs::PointCloud2ConstIterator<float> iter_x(*observations[i].cloud_, "x");
+    EXPECT_FLOAT_EQ(*iter_x, static_cast<float>(6 - i));
+  }
+
+  // Only the latest observation is kept without a keep time, and clouds
+  // no longer shared are reused for the next observations
+  nav2_costmap_2d::ObservationBuffer latest_buffer(
+    node, "cloud", 0.0, 0.0, 0.0, 2.0, 3.0, 0.0, 4.0, 0.0, tf, "map", "",
+    tf2::durationFromSec(0.1));
+  latest_buffer.bufferCloud(makeCloud({{1.0, 0.0, 1.0, 0.0}}, now));
+  nav2_costmap_2d::Observation first;
+  ASSERT_TRUE(latest_buffer.getLatestObservation(first));
+  const sensor_msgs::msg::PointCloud2 * first_cloud = first.cloud_.get();
+  first = nav2_costmap_2d::Observation();
+  latest_buffer.bufferCloud(makeCloud({{2.0, 0.0, 1.0, 0.0}}, now));
+  latest_buffer.bufferCloud(makeCloud({{3.0, 0.0, 1.0, 0.0}}, now));
+
+  observations.clear();
+  latest_buffer.getObservations(observations);
+  ASSERT_EQ(observations.size(), 1u);
+  EXPECT_EQ(observations[0].cloud_.get(), first_cloud);
+  sensor_msgs::PointCloud2ConstIterator<float> iter_x(*observations[0].cloud_, "x");
+  EXPECT_FLOAT_EQ(*iter_x, 3.0f);
+}
@@ -0,0 +1,158 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "nav2_costmap_2d/costmap_2d.hpp"
+#include "nav2_costmap_2d/cost_values.hpp"
+#include "nav2_costmap_2d/packed_costmap.hpp"
+
+using nav2_costmap_2d::FREE_SPACE;
+using nav2_costmap_2d::LETHAL_OBSTACLE;
+using nav2_costmap_2d::NO_INFORMATION;
+
+// Fill a layer with random binary costs, kept both packed and as bytes
+void fillLayer(
+  nav2_costmap_2d::PackedCostmap & packed, nav2_costmap_2d::Costmap2D & bytes,
+  std::mt19937 & generator)
+{
+  const unsigned char costs[] = {FREE_SPACE, LETHAL_OBSTACLE, NO_INFORMATION};
+  for (unsigned int y = 0; y < bytes.getSizeInCellsY(); y++) {
+    for (unsigned int x = 0; x < bytes.getSizeInCellsX(); x++) {
+      // Runs of unknown cells, as left by unobserved areas
+      const unsigned char cost = y % 7 == 3 ? NO_INFORMATION : costs[generator() % 3];
+      packed.setCost(bytes.getIndex(x, y), cost);
+      bytes.setCost(x, y, cost);
+    }
+  }
+}
+
+// Fill a master grid with random costs of any value
+void fillMaster(nav2_costmap_2d::Costmap2D & master, std::mt19937 & generator)
+{
+  for (unsigned int y = 0; y < master.getSizeInCellsY(); y++) {
+    for (unsigned int x = 0; x < master.getSizeInCellsX(); x++) {
+      master.setCost(x, y, generator() % 4 == 0 ? NO_INFORMATION : generator() % 256);
+    }
+  }
+}
+
+TEST(PackedCostmapTest, testGetSetCost)
+{
+  nav2_costmap_2d::PackedCostmap packed;
+  packed.resize(13, 7, NO_INFORMATION);
+  EXPECT_EQ(packed.getSizeInBytes(), (13u * 7u + 3u) / 4u);
+  for (unsigned int i = 0; i < 13 * 7; i++) {
+    EXPECT_EQ(packed.getCost(i), NO_INFORMATION);
+  }
+
+  std::mt19937 generator(7);
+  std::vector<unsigned char> costs(13 * 7);
+  for (unsigned int round = 0; round < 5; round++) {
+    for (unsigned int i = 0; i < costs.size(); i++) {
+      const unsigned int draw = generator() % 4;
+      costs[i] = draw == 0 ? FREE_SPACE : (draw == 1 ? NO_INFORMATION : LETHAL_OBSTACLE);
+      packed.setCost(i, draw == 3 ? 128 : costs[i]);
+    }
+    for (unsigned int i = 0; i < costs.size(); i++) {
+      EXPECT_EQ(packed.getCost(i), costs[i]);
+    }
+  }
+
+  packed.reset(FREE_SPACE);
+  for (unsigned int i = 0; i < costs.size(); i++) {
+    EXPECT_EQ(packed.getCost(i), FREE_SPACE);
+  }
+}
+
+TEST(PackedCostmapTest, testShift)
+{
+  std::mt19937 generator(3);
+  nav2_costmap_2d::PackedCostmap packed;
+  packed.resize(11, 9, FREE_SPACE);
+  nav2_costmap_2d::Costmap2D bytes(11, 9, 1.0, 0.0, 0.0, FREE_SPACE);
+
+  const int shifts[][2] = {{0, 0}, {3, -2}, {-5, 4}, {1, 1}, {-2, -7}, {12, 0}, {0, -9}};
+  for (const auto & shift : shifts) {
+    fillLayer(packed, bytes, generator);
+    packed.shift(shift[0], shift[1], NO_INFORMATION);
+
+    // Cell (x, y) of the shifted costs was cell (x + shift_x, y + shift_y) of the costs
+    for (int y = 0; y < 9; y++) {
+      for (int x = 0; x < 11; x++) {
+        const int from_x = x + shift[0], from_y = y + shift[1];
+        const bool inside = from_x >= 0 && from_x < 11 && from_y >= 0 && from_y < 9;
+        EXPECT_EQ(
+          packed.getCost(bytes.getIndex(x, y)),
+          inside ? bytes.getCost(from_x, from_y) : NO_INFORMATION);
+      }
+    }
+  }
+}
+
+TEST(PackedCostmapTest, testCombinationMethods)
+{
+  std::mt19937 generator(11);
+  const unsigned int size_x = 37, size_y = 11;
+  nav2_costmap_2d::PackedCostmap packed;
+  packed.resize(size_x, size_y, NO_INFORMATION);
+  nav2_costmap_2d::Costmap2D layer(size_x, size_y, 1.0, 0.0, 0.0);
+  nav2_costmap_2d::Costmap2D packed_master(size_x, size_y, 1.0, 0.0, 0.0);
+  nav2_costmap_2d::Costmap2D master(size_x, size_y, 1.0, 0.0, 0.0);
+
+  // Windows starting and ending inside of the bytes of the packed cells
+  const int windows[][4] = {{0, 0, 37, 11}, {1, 2, 30, 9}, {5, 0, 6, 11}, {3, 4, 3, 8}};
+  for (unsigned int method = 0; method < 3; method++) {
+    for (const auto & window : windows) {
+      fillLayer(packed, layer, generator);
+      fillMaster(master, generator);
+      std::copy_n(master.getCharMap(), size_x * size_y, packed_master.getCharMap());
+
+      const int min_i = window[0], min_j = window[1], max_i = window[2], max_j = window[3];
+      if (method == 0) {
+        packed.updateWithMax(packed_master, min_i, min_j, max_i, max_j);
+      } else if (method == 1) {
+        packed.updateWithMaxWithoutUnknownOverwrite(packed_master, min_i, min_j, max_i, max_j);
+      } else {
+        packed.updateWithOverwrite(packed_master, min_i, min_j, max_i, max_j);
+      }
+
+      // The rules of the byte combination methods of CostmapLayer
+      for (int j = min_j; j < max_j; j++) {
+        for (int i = min_i; i < max_i; i++) {
+          const unsigned char old_cost = master.getCost(i, j);
+          const unsigned char cost = layer.getCost(i, j);
+          if (cost == NO_INFORMATION) {
+            continue;
+          }
+          if (method == 0) {
+            master.setCost(i, j, old_cost == NO_INFORMATION ? cost : std::max(old_cost, cost));
+          } else if (method == 1) {
+            master.setCost(i, j, old_cost == NO_INFORMATION ? old_cost : std::max(old_cost, cost));
+          } else {
+            master.setCost(i, j, cost);
+          }
+        }
+      }
+
+      for (unsigned int i = 0; i < size_x * size_y; i++) {
+        EXPECT_EQ(packed_master.getCharMap()[i], master.getCharMap()[i]);
+      }
+    }
+  }
+}
@@ -0,0 +1,155 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <memory>
+
+#include "rclcpp/rclcpp.hpp"
+#include "nav2_costmap_2d/static_layer.hpp"
+#include "nav2_costmap_2d/layered_costmap.hpp"
+#include "nav2_util/lifecycle_node.hpp"
+#include "tf2_ros/buffer.h"
+
+class RclCppFixture
+{
+public:
+  RclCppFixture() {rclcpp::init(0, nullptr);}
+  ~RclCppFixture() {rclcpp::shutdown();}
+};
+RclCppFixture g_rclcppfixture;
+
+class StaticLayerWrapper : public nav2_costmap_2d::StaticLayer
+{
+public:
+  using StaticLayer::incomingMap;
+  using StaticLayer::incomingUpdate;
+};
+
+struct Bounds
+{
+  double min_x{std::numeric_limits<double>::max()};
+  double min_y{std::numeric_limits<double>::max()};
+  double max_x{std::numeric_limits<double>::lowest()};
+  double max_y{std::numeric_limits<double>::lowest()};
+};
+
+static Bounds updateBounds(nav2_costmap_2d::Layer & layer)
+{
+  Bounds b;
+  layer.updateBounds(0.0, 0.0, 0.0, &b.min_x, &b.min_y, &b.max_x, &b.max_y);
+  return b;
+}
+
+TEST(StaticLayer, mapUpdatesOnlyReportUpdatedCells)
+{
+  auto node = std::make_shared<nav2_util::LifecycleNode>("static_layer_test");
+  tf2_ros::Buffer tf(node->get_clock());
+  nav2_costmap_2d::LayeredCostmap layers("map", false, false);
+  auto layer = std::make_shared<StaticLayerWrapper>();
+  layers.addPlugin(layer);
+  layer->initialize(&layers, "static", &tf, node, nullptr);
+
+  auto map = std::make_shared<nav_msgs::msg::OccupancyGrid>();
+  map->header.frame_id = "map";
+  map->info.width = 20;
+  map->info.height = 20;
+  map->info.resolution = 1.0;
+  map->info.origin.orientation.w = 1.0;
+  map->data.assign(20 * 20, 0);
+  layer->incomingMap(map);
+
+  // A new map updates all of it
+  Bounds b = updateBounds(*layer);
+  EXPECT_DOUBLE_EQ(b.min_x, 0.5);
+  EXPECT_DOUBLE_EQ(b.min_y, 0.5);
+  EXPECT_DOUBLE_EQ(b.max_x, 20.5);
+  EXPECT_DOUBLE_EQ(b.max_y, 20.5);
+
+  // Nothing changed since
+  b = updateBounds(*layer);
+  EXPECT_GT(b.min_x, b.max_x);
+
+  auto update = std::make_shared<map_msgs::msg::OccupancyGridUpdate>();
+  update->header.frame_id = "map";
+  update->x = 4;
+  update->y = 6;
+  update->width = 3;
+  update->height = 2;
+  update->data.assign(3 * 2, 100);
+  layer->incomingUpdate(update);
+  EXPECT_EQ(layer->getCost(5, 7), nav2_costmap_2d::LETHAL_OBSTACLE);
+
+  // Only the updated cells are reported
+  b = updateBounds(*layer);
+  EXPECT_DOUBLE_EQ(b.min_x, 4.5);
+  EXPECT_DOUBLE_EQ(b.min_y, 6.5);
+  EXPECT_DOUBLE_EQ(b.max_x, 7.5);
+  EXPECT_DOUBLE_EQ(b.max_y, 8.5);
+
+  // Reset updates the whole map again
+  layer->reset();
+  b = updateBounds(*layer);
+  EXPECT_DOUBLE_EQ(b.min_x, 0.5);
+  EXPECT_DOUBLE_EQ(b.max_y, 20.5);
+}
+
+TEST(StaticLayer, newMapsOnlyReportChangedCells)
+{
+  auto node = std::make_shared<nav2_util::LifecycleNode>("static_layer_test");
+  tf2_ros::Buffer tf(node->get_clock());
+  nav2_costmap_2d::LayeredCostmap layers("map", false, false);
+  auto layer = std::make_shared<StaticLayerWrapper>();
+  layers.addPlugin(layer);
+  layer->initialize(&layers, "static", &tf, node, nullptr);
+
+  auto map = std::make_shared<nav_msgs::msg::OccupancyGrid>();
+  map->header.frame_id = "map";
+  map->info.width = 20;
+  map->info.height = 20;
+  map->info.resolution = 1.0;
+  map->info.origin.orientation.w = 1.0;
+  map->data.assign(20 * 20, 0);
+  layer->incomingMap(map);
+  updateBounds(*layer);
+
+  // A new map of the same geometry is diffed against the current one
+  auto new_map = std::make_shared<nav_msgs::msg::OccupancyGrid>(*map);
+  new_map->data[8 * 20 + 3] = 100;
+  new_map->data[10 * 20 + 12] = 100;
+  layer->incomingMap(new_map);
+  Bounds b = updateBounds(*layer);
+  EXPECT_DOUBLE_EQ(b.min_x, 3.5);
+  EXPECT_DOUBLE_EQ(b.min_y, 8.5);
+  EXPECT_DOUBLE_EQ(b.max_x, 13.5);
+  EXPECT_DOUBLE_EQ(b.max_y, 11.5);
+  EXPECT_EQ(layer->getCost(3, 8), nav2_costmap_2d::LETHAL_OBSTACLE);
+  EXPECT_EQ(layer->getCost(12, 10), nav2_costmap_2d::LETHAL_OBSTACLE);
+  EXPECT_EQ(layer->getCost(4, 8), nav2_costmap_2d::FREE_SPACE);
+
+  // An identical map changes nothing
+  layer->incomingMap(std::make_shared<nav_msgs::msg::OccupancyGrid>(*new_map));
+  b = updateBounds(*layer);
+  EXPECT_GT(b.min_x, b.max_x);
+
+  // A map of another size is reloaded whole
+  auto larger_map = std::make_shared<nav_msgs::msg::OccupancyGrid>(*map);
+  larger_map->info.width = 30;
+  larger_map->data.assign(30 * 20, 0);
+  layer->incomingMap(larger_map);
+  b = updateBounds(*layer);
+  EXPECT_DOUBLE_EQ(b.min_x, 0.5);
+  EXPECT_DOUBLE_EQ(b.max_x, 30.5);
+}
@@ -0,0 +1,68 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "rclcpp/rclcpp.hpp"
+#include "nav2_costmap_2d/costmap_2d.hpp"
+#include "nav2_costmap_2d/cost_values.hpp"
+
+class RclCppFixture
+{
+public:
+  RclCppFixture() {rclcpp::init(0, nullptr);}
+  ~RclCppFixture() {rclcpp::shutdown();}
+};
+RclCppFixture g_rclcppfixture;
+
+// Cost of the cell at world cell coordinates (wx, wy)
+static unsigned char worldCost(int wx, int wy)
+{
+  return static_cast<unsigned char>((wx * 7 + wy * 13) % 250 + 1);
+}
+
+TEST(UpdateOrigin, shiftsCellsInPlace)
+{
+  const int size_x = 13, size_y = 9;
+  const int shifts[][2] = {
+    {0, 0}, {1, 0}, {0, 1}, {-1, 0}, {0, -1}, {3, -2}, {-4, 5}, {12, 8}, {-12, -8},
+    {13, 0}, {0, -9}, {40, 40}};
+
+  for (const auto & shift : shifts) {
+    nav2_costmap_2d::Costmap2D costmap(
+      size_x, size_y, 0.5, 1.0, 2.0, nav2_costmap_2d::NO_INFORMATION);
+    for (int y = 0; y < size_y; y++) {
+      for (int x = 0; x < size_x; x++) {
+        costmap.setCost(x, y, worldCost(x, y));
+      }
+    }
+
+    // The new origin is truncated towards the current one
+    const double off_x = shift[0] < 0 ? -0.1 : 0.1, off_y = shift[1] < 0 ? -0.1 : 0.1;
+    costmap.updateOrigin(1.0 + shift[0] * 0.5 + off_x, 2.0 + shift[1] * 0.5 + off_y);
+    EXPECT_DOUBLE_EQ(costmap.getOriginX(), 1.0 + shift[0] * 0.5);
+    EXPECT_DOUBLE_EQ(costmap.getOriginY(), 2.0 + shift[1] * 0.5);
+
+    for (int y = 0; y < size_y; y++) {
+      for (int x = 0; x < size_x; x++) {
+        const int wx = x + shift[0], wy = y + shift[1];
+        const bool was_in_map = wx >= 0 && wx < size_x && wy >= 0 && wy < size_y;
+        EXPECT_EQ(
+          costmap.getCost(x, y),
+          was_in_map ? worldCost(wx, wy) : nav2_costmap_2d::NO_INFORMATION) <<
+          "shift (" << shift[0] << ", " << shift[1] << ") cell (" << x << ", " << y << ")";
+      }
+    }
+  }
+}
@@ -0,0 +1,161 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "nav2_costmap_2d/voxel_grid_delta.hpp"
+
+// Status of a voxel, as nav2_voxel_grid::VoxelGrid::getVoxel
+unsigned int voxelStatus(uint32_t column, unsigned int z)
+{
+  return ((column >> z) & 1u) + ((column >> (z + 16)) & 1u);
+}
+
+bool sameVoxels(
+  const std::vector<uint32_t> & a, const std::vector<uint32_t> & b, unsigned int size_z)
+{
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.size(); i++) {
+    for (unsigned int z = 0; z < size_z; z++) {
+      if (voxelStatus(a[i], z) != voxelStatus(b[i], z)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Mostly free columns with a few unknown or marked voxels, either bit set for unknown ones
+uint32_t randomColumn(std::mt19937 & rng)
+{
+  uint32_t column = 0;
+  for (unsigned int z = 0; z < 16; z++) {
+    switch (rng() % 8) {
+      case 0:
+        column |= 1u << z;
+        break;
+      case 1:
+        column |= 1u << (z + 16);
+        break;
+      case 2:
+        column |= 0x10001u << z;
+        break;
+    }
+  }
+  return column;
+}
+
+TEST(VoxelGridDelta, ColumnsRoundTrip)
+{
+  // Free columns whose runs continue across them, then random ones
+  std::mt19937 rng(3);
+  std::vector<uint32_t> columns(40, 0);
+  for (unsigned int i = 20; i < columns.size(); i++) {
+    columns[i] = randomColumn(rng);
+  }
+
+  for (const unsigned int size_z : {1u, 10u, 16u}) {
+    std::vector<uint8_t> data;
+    nav2_costmap_2d::encodeVoxelColumns(columns, size_z, data);
+    std::vector<uint32_t> decoded(columns.size());
+    ASSERT_TRUE(nav2_costmap_2d::decodeVoxelColumns(data, size_z, decoded));
+    EXPECT_TRUE(sameVoxels(columns, decoded, size_z));
+    // The bits above size_z are not sent
+    for (const uint32_t column : decoded) {
+      EXPECT_EQ(column & ~(((1u << size_z) - 1u) * 0x10001u), 0u);
+    }
+
+    // Truncated runs are rejected
+    data.pop_back();
+    EXPECT_FALSE(nav2_costmap_2d::decodeVoxelColumns(data, size_z, decoded));
+  }
+
+  // The 20 free columns of 16 voxels take a few bytes
+  std::vector<uint8_t> data;
+  nav2_costmap_2d::encodeVoxelColumns(
+    std::vector<uint32_t>(columns.begin(), columns.begin() + 20), 16, data);
+  EXPECT_EQ(data.size(), 6u);
+}
+
+TEST(VoxelGridDelta, DeltasTrackGrid)
+{
+  const unsigned int size_x = 60, size_y = 45, size_z = 12;
+  std::vector<uint32_t> grid(size_x * size_y, 0xFFFFu);
+  std::vector<uint32_t> reference;
+  nav2_msgs::msg::VoxelGrid received;
+  std::mt19937 rng(7);
+
+  nav2_msgs::msg::VoxelGridDelta msg;
+  msg.resolutions.x = msg.resolutions.y = 0.05;
+  msg.resolutions.z = 0.2;
+  nav2_costmap_2d::createVoxelGridDelta(
+    grid.data(), size_x, size_y, size_z, 0, 0, 0, 0, reference, false, msg);
+  // No reference yet, so everything is sent as a single range
+  ASSERT_TRUE(msg.keyframe);
+  ASSERT_EQ(msg.column_ranges.size(), 2u);
+  EXPECT_EQ(msg.column_ranges[1], size_x * size_y);
+  ASSERT_TRUE(nav2_costmap_2d::applyVoxelGridDelta(msg, received));
+  EXPECT_EQ(received.size_x, size_x);
+  EXPECT_TRUE(sameVoxels(grid, received.data, size_z));
+
+  for (int i = 0; i < 20; i++) {
+    // Changes within a window, and changes above size_z which are not sent
+    const unsigned int x0 = rng() % 50, y0 = rng() % 35;
+    for (int j = 0; j < 5; j++) {
+      grid[(y0 + rng() % 10) * size_x + x0 + rng() % 10] = randomColumn(rng);
+      grid[rng() % grid.size()] ^= 0x80008000u;
+    }
+    nav2_costmap_2d::createVoxelGridDelta(
+      grid.data(), size_x, size_y, size_z, x0, y0, x0 + 10, y0 + 10, reference, false, msg);
+    EXPECT_FALSE(msg.keyframe);
+    EXPECT_LE(msg.column_ranges.size(), 10u);
+    ASSERT_TRUE(nav2_costmap_2d::applyVoxelGridDelta(msg, received));
+    EXPECT_TRUE(sameVoxels(grid, received.data, size_z));
+  }
+
+  // Nothing changed
+  nav2_costmap_2d::createVoxelGridDelta(
+    grid.data(), size_x, size_y, size_z, 0, 0, size_x, size_y, reference, false, msg);
+  EXPECT_TRUE(msg.column_ranges.empty());
+  EXPECT_TRUE(msg.data.empty());
+
+  // A grid moved by (3, -2) cells is shifted by the receiver, with cleared columns moved in
+  std::vector<uint32_t> moved(grid.size(), 0xFFFFu);
+  std::vector<uint32_t> moved_reference(grid.size(), 0);
+  for (unsigned int y = 2; y < size_y; y++) {
+    for (unsigned int x = 0; x < size_x - 3; x++) {
+      moved[y * size_x + x] = grid[(y - 2) * size_x + x + 3];
+      moved_reference[y * size_x + x] = reference[(y - 2) * size_x + x + 3];
+    }
+  }
+  msg.origin.x = 3 * 0.05;
+  msg.origin.y = -2 * 0.05;
+  nav2_costmap_2d::createVoxelGridDelta(
+    moved.data(), size_x, size_y, size_z, 0, 0, size_x, size_y, moved_reference, false, msg);
+  EXPECT_FALSE(msg.keyframe);
+  ASSERT_TRUE(nav2_costmap_2d::applyVoxelGridDelta(msg, received));
+  EXPECT_TRUE(sameVoxels(moved, received.data, size_z));
+
+  // Mismatched sizes are rejected
+  nav2_msgs::msg::VoxelGrid other;
+  other.size_x = 10;
+  other.size_y = 10;
+  other.data.resize(100);
+  EXPECT_FALSE(nav2_costmap_2d::applyVoxelGridDelta(msg, other));
+}
@@ -0,0 +1,161 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "nav2_costmap_2d/costmap_2d.hpp"
+#include "nav2_costmap_2d/cost_values.hpp"
+#include "nav2_costmap_2d/zone_index.hpp"
+
+using nav2_costmap_2d::NO_INFORMATION;
+
+geometry_msgs::msg::Point makePoint(double x, double y)
+{
+  geometry_msgs::msg::Point point;
+  point.x = x;
+  point.y = y;
+  return point;
+}
+
+// Random triangles and quadrilaterals, some of them concave, scattered over a square
+std::vector<nav2_costmap_2d::Zone> makeZones(unsigned int count, std::mt19937 & generator)
+{
+  std::uniform_real_distribution<double> position(0.0, 100.0), extent(0.5, 6.0);
+  std::vector<nav2_costmap_2d::Zone> zones(count);
+  for (unsigned int i = 0; i < count; i++) {
+    auto & zone = zones[i];
+    zone.id = std::to_string(i);
+    const double x = position(generator), y = position(generator);
+    const double w = extent(generator), h = extent(generator);
+    zone.polygon.push_back(makePoint(x, y));
+    zone.polygon.push_back(makePoint(x + w, y));
+    if (i % 3 == 0) {
+      zone.polygon.push_back(makePoint(x + w * 0.3, y + h * 0.3));
+    }
+    zone.polygon.push_back(makePoint(x + w * 0.5, y + h));
+    zone.cost = 1 + generator() % 254;
+    zone.speed_limit = i % 2 == 0 ? 0.0 : 10.0 + i;
+    zone.updateBounds();
+  }
+  return zones;
+}
+
+TEST(ZoneIndexTest, testContains)
+{
+  // A concave polygon, with a notch between two prongs
+  nav2_costmap_2d::Zone zone;
+  zone.polygon = {makePoint(0.0, 0.0), makePoint(4.0, 0.0), makePoint(4.0, 4.0),
+    makePoint(3.0, 4.0), makePoint(2.0, 1.0), makePoint(1.0, 4.0), makePoint(0.0, 4.0)};
+  zone.updateBounds();
+  EXPECT_EQ(zone.min_x, 0.0);
+  EXPECT_EQ(zone.max_y, 4.0);
+
+  EXPECT_TRUE(zone.contains(0.5, 3.5));
+  EXPECT_TRUE(zone.contains(3.5, 3.5));
+  EXPECT_TRUE(zone.contains(2.0, 0.5));
+  EXPECT_FALSE(zone.contains(2.0, 3.0));
+  EXPECT_FALSE(zone.contains(-0.5, 2.0));
+  EXPECT_FALSE(zone.contains(2.0, 4.5));
+}
+
+TEST(ZoneIndexTest, testQuery)
+{
+  std::mt19937 generator(5);
+  for (const unsigned int count : {0u, 1u, 7u, 8u, 9u, 100u, 1000u}) {
+    const auto zones = makeZones(count, generator);
+    nav2_costmap_2d::ZoneIndex index;
+    index.build(zones);
+    ASSERT_EQ(index.getZones().size(), count);
+
+    std::uniform_real_distribution<double> position(-10.0, 110.0), extent(0.0, 20.0);
+    std::vector<size_t> found;
+    for (unsigned int round = 0; round < 50; round++) {
+      const double min_x = position(generator), min_y = position(generator);
+      const double max_x = min_x + extent(generator), max_y = min_y + extent(generator);
+      index.query(min_x, min_y, max_x, max_y, found);
+
+      // The same zones as a check of all of them
+      std::vector<std::string> ids, expected_ids;
+      for (const size_t i : found) {
+        ids.push_back(index.getZones()[i].id);
+      }
+      for (const auto & zone : zones) {
+        if (zone.max_x >= min_x && zone.min_x <= max_x && zone.max_y >= min_y &&
+          zone.min_y <= max_y)
+        {
+          expected_ids.push_back(zone.id);
+        }
+      }
+      std::sort(ids.begin(), ids.end());
+      std::sort(expected_ids.begin(), expected_ids.end());
+      EXPECT_EQ(ids, expected_ids);
+
+      index.queryPoint(min_x, min_y, found);
+      unsigned int containing = 0;
+      for (const auto & zone : zones) {
+        containing += zone.contains(min_x, min_y);
+      }
+      EXPECT_EQ(found.size(), containing);
+      for (const size_t i : found) {
+        EXPECT_TRUE(index.getZones()[i].contains(min_x, min_y));
+      }
+    }
+  }
+}
+
+TEST(ZoneIndexTest, testRasterize)
+{
+  std::mt19937 generator(9);
+  const auto zones = makeZones(200, generator);
+  nav2_costmap_2d::ZoneIndex index;
+  index.build(zones);
+
+  // Windows inside of, across the edge of and beyond the costmap
+  nav2_costmap_2d::Costmap2D costmap(200, 160, 0.5, 2.0, 10.0);
+  const int windows[][4] = {{0, 0, 200, 160}, {13, 7, 91, 150}, {150, 100, 200, 160},
+    {40, 40, 40, 90}};
+  for (const auto & window : windows) {
+    std::vector<unsigned char> expected(200 * 160);
+    for (size_t i = 0; i < expected.size(); i++) {
+      expected[i] = generator() % 4 == 0 ? NO_INFORMATION : generator() % 256;
+      costmap.getCharMap()[i] = expected[i];
+    }
+
+    const int min_i = window[0], min_j = window[1], max_i = window[2], max_j = window[3];
+    index.rasterize(costmap, min_i, min_j, max_i, max_j);
+
+    // The cells whose center is inside of a zone
+    for (int j = min_j; j < max_j; j++) {
+      for (int i = min_i; i < max_i; i++) {
+        double wx, wy;
+        costmap.mapToWorld(i, j, wx, wy);
+        unsigned char & cost = expected[costmap.getIndex(i, j)];
+        for (const auto & zone : zones) {
+          if (zone.contains(wx, wy) && (cost == NO_INFORMATION || cost < zone.cost)) {
+            cost = zone.cost;
+          }
+        }
+      }
+    }
+
+    for (size_t i = 0; i < expected.size(); i++) {
+      EXPECT_EQ(costmap.getCharMap()[i], expected[i]);
+    }
+  }
+}
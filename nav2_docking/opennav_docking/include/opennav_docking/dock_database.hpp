@@ -15,9 +15,12 @@
 #ifndef OPENNAV_DOCKING__DOCK_DATABASE_HPP_
 #define OPENNAV_DOCKING__DOCK_DATABASE_HPP_
 
+#include <filesystem>
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 
 #include "rclcpp/rclcpp.hpp"
 #include "pluginlib/class_loader.hpp"
@@ -28,6 +31,7 @@
 #include "nav2_util/simple_action_server.hpp"
 #include "opennav_docking/utils.hpp"
 #include "opennav_docking/types.hpp"
+#include "opennav_docking/dock_index.hpp"
 #include "nav2_msgs/srv/reload_dock_database.hpp"
 
 namespace opennav_docking
@@ -82,6 +86,27 @@ public:
    */
   ChargingDock::Ptr findDockPlugin(const std::string & type);
 
+  /**
+   * @brief Find the nearest dock to a pose, among the docks in the frame of the pose
+   * @param pose Pose to find the nearest dock to
+   * @param type Dock type to find, any if empty
+   * @return Dock pointer, nullptr if none was found. Its plugin is populated if the
+   * database has one for its type.
+   */
+  Dock * findNearestDock(
+    const geometry_msgs::msg::PoseStamped & pose, const std::string & type = "");
+
+  /**
+   * @brief Find the docks within a radius of a pose, among the docks in the frame of the pose
+   * @param pose Pose to find the docks around
+   * @param radius Radius to find the docks within
+   * @param type Dock type to find, any if empty
+   * @return Dock pointers, ordered by distance, with their plugin populated as for
+   * findNearestDock()
+   */
+  std::vector<Dock *> findDocksWithinRadius(
+    const geometry_msgs::msg::PoseStamped & pose, double radius, const std::string & type = "");
+
   /**
    * @brief Get the number of docks in the database
    * @return unsigned int Number of dock instances in the database
@@ -117,6 +142,25 @@ protected:
    */
   Dock * findDockInstance(const std::string & dock_id);
 
+  /**
+   * @brief Populate the dock plugin of a dock instance
+   * @param dock Dock to populate
+   * @return If the dock has a valid plugin
+   */
+  bool populateDockPlugin(Dock * dock);
+
+  /**
+   * @brief Rebuild the spatial indices of the dock instances, per frame
+   */
+  void indexDocks();
+
+  /**
+   * @brief Update the dock instances to a new set, only changing and reindexing the
+   * docks added, removed or modified. Pointers to the other docks remain valid.
+   * @param dock_instances New dock instances
+   */
+  void updateDocks(const DockMap & dock_instances);
+
   /**
    * @brief Service request to reload database of docks
    * @param request Service request
@@ -129,6 +173,14 @@ protected:
   rclcpp_lifecycle::LifecycleNode::WeakPtr node_;
   DockPluginMap dock_plugins_;
   DockMap dock_instances_;
+  // Spatial indices of the dock instances, per frame
+  std::unordered_map<std::string, DockIndex> dock_indices_;
+  double index_cell_size_{10.0};
+  // Guards the dock instances and their indices against reloads
+  std::mutex instances_mutex_;
+  // Dock file last loaded, to skip reloading it unchanged
+  std::string dock_filepath_;
+  std::filesystem::file_time_type dock_file_time_;
   pluginlib::ClassLoader<opennav_docking_core::ChargingDock> dock_loader_;
   rclcpp::Service<nav2_msgs::srv::ReloadDockDatabase>::SharedPtr reload_db_service_;
 };
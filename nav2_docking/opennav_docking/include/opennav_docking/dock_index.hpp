@@ -0,0 +1,142 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPENNAV_DOCKING__DOCK_INDEX_HPP_
+#define OPENNAV_DOCKING__DOCK_INDEX_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace opennav_docking
+{
+
+/**
+ * @class opennav_docking::DockIndex
+ * @brief A spatial hash grid over the positions of the docks of one frame,
+ * for nearest and within-radius queries touching only the cells around the query
+ */
+class DockIndex
+{
+public:
+  /**
+   * @brief Create a dock index
+   * @param cell_size Size of the grid cells (m), about the typical spacing of docks
+   */
+  explicit DockIndex(double cell_size);
+
+  /**
+   * @brief Add a dock to the index
+   * @param id Dock ID
+   * @param x X position of the dock
+   * @param y Y position of the dock
+   */
+  void insert(const std::string & id, double x, double y);
+
+  /**
+   * @brief Remove a dock from the index
+   * @param id Dock ID
+   */
+  void erase(const std::string & id);
+
+  /**
+   * @brief Find the nearest dock to a position
+   * @param x X position to query
+   * @param y Y position to query
+   * @param accept Returns whether a dock ID can be returned
+   * @param id Nearest accepted dock ID
+   * @return If an accepted dock was found
+   */
+  template<typename AcceptT>
+  bool nearest(double x, double y, AcceptT accept, std::string & id) const;
+
+  /**
+   * @brief Find the docks within a radius of a position
+   * @param x X position to query
+   * @param y Y position to query
+   * @param radius Radius to query within
+   * @return IDs of the docks within the radius, ordered by distance
+   */
+  std::vector<std::string> withinRadius(double x, double y, double radius) const;
+
+  /**
+   * @brief Get the number of docks in the index
+   */
+  unsigned int size() const {return entries_.size();}
+
+protected:
+  struct Entry
+  {
+    std::string id;
+    double x;
+    double y;
+  };
+
+  int64_t cellKey(int cx, int cy) const;
+  int cellCoord(double v) const;
+
+  double cell_size_;
+  std::unordered_map<int64_t, std::vector<Entry>> cells_;
+  std::unordered_map<std::string, int64_t> entries_;
+  // Bounds of the occupied cells, to end the search of the nearest dock
+  int min_cx_{0}, max_cx_{-1}, min_cy_{0}, max_cy_{-1};
+};
+
+template<typename AcceptT>
+bool DockIndex::nearest(double x, double y, AcceptT accept, std::string & id) const
+{
+  if (entries_.empty()) {
+    return false;
+  }
+
+  const int cx = cellCoord(x);
+  const int cy = cellCoord(y);
+  const int max_ring = std::max(
+    std::max(cx - min_cx_, max_cx_ - cx), std::max(cy - min_cy_, max_cy_ - cy));
+
+  double best_sq_dist = -1.0;
+  for (int ring = 0; ring <= max_ring; ++ring) {
+    // Docks in further rings are at least this far
+    const double ring_dist = (ring - 1) * cell_size_;
+    if (best_sq_dist >= 0.0 && ring_dist > 0.0 && ring_dist * ring_dist > best_sq_dist) {
+      break;
+    }
+
+    for (int ix = cx - ring; ix <= cx + ring; ++ix) {
+      // Only the border of the ring is new
+      const int step = (ix == cx - ring || ix == cx + ring) ? 1 : 2 * ring;
+      for (int iy = cy - ring; iy <= cy + ring; iy += std::max(step, 1)) {
+        auto it = cells_.find(cellKey(ix, iy));
+        if (it == cells_.end()) {
+          continue;
+        }
+        for (const Entry & entry : it->second) {
+          const double sq_dist =
+            (entry.x - x) * (entry.x - x) + (entry.y - y) * (entry.y - y);
+          if ((best_sq_dist < 0.0 || sq_dist < best_sq_dist) && accept(entry.id)) {
+            best_sq_dist = sq_dist;
+            id = entry.id;
+          }
+        }
+      }
+    }
+  }
+  return best_sq_dist >= 0.0;
+}
+
+}  // namespace opennav_docking
+
+#endif  // OPENNAV_DOCKING__DOCK_INDEX_HPP_
@@ -17,6 +17,7 @@
 
 #include <string>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 #include "geometry_msgs/msg/pose_stamped.hpp"
@@ -113,6 +114,9 @@ protected:
   rclcpp::Publisher<geometry_msgs::msg::PoseStamped>::SharedPtr staging_pose_pub_;
   // If subscribed to a detected pose topic, will contain latest message
   geometry_msgs::msg::PoseStamped detected_dock_pose_;
+  std::mutex detected_dock_pose_mutex_;
+  // Stamp of the detection dock_pose_ was refined from, to only refine new detections
+  rclcpp::Time refined_detection_stamp_{0, 0, RCL_ROS_TIME};
   // This is the actual dock pose once it has the specified translation/rotation applied
   // If not subscribed to a topic, this is simply the database dock pose
   geometry_msgs::msg::PoseStamped dock_pose_;
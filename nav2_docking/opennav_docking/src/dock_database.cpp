@@ -14,6 +14,10 @@
 
 #include "opennav_docking/dock_database.hpp"
 
+#include <string>
+#include <utility>
+#include <vector>
+
 namespace opennav_docking
 {
 
@@ -34,6 +38,10 @@ bool DockDatabase::initialize(
   node_ = parent;
   auto node = node_.lock();
 
+  nav2_util::declare_parameter_if_not_declared(
+    node, "dock_index_cell_size", rclcpp::ParameterValue(10.0));
+  node->get_parameter("dock_index_cell_size", index_cell_size_);
+
   if (!getDockPlugins(node, tf)) {
     RCLCPP_ERROR(
       node->get_logger(),
@@ -47,6 +55,7 @@ bool DockDatabase::initialize(
       "An error occurred while getting the dock instances!");
     return false;
   }
+  indexDocks();
 
   RCLCPP_INFO(
     node->get_logger(),
@@ -83,9 +92,23 @@ void DockDatabase::reloadDbCb(
   std::shared_ptr<nav2_msgs::srv::ReloadDockDatabase::Response> response)
 {
   auto node = node_.lock();
+
+  // An unchanged file does not need to be parsed again
+  std::error_code ec;
+  auto file_time = std::filesystem::last_write_time(request->filepath, ec);
+  if (!ec && request->filepath == dock_filepath_ && file_time == dock_file_time_) {
+    response->success = true;
+    RCLCPP_INFO(
+      node->get_logger(),
+      "Dock database file %s unchanged, not reloaded.", request->filepath.c_str());
+    return;
+  }
+
   DockMap dock_instances;
   if (utils::parseDockFile(request->filepath, node, dock_instances)) {
-    dock_instances_ = dock_instances;
+    updateDocks(dock_instances);
+    dock_filepath_ = request->filepath;
+    dock_file_time_ = file_time;
     response->success = true;
     RCLCPP_INFO(
       node->get_logger(),
@@ -97,14 +120,11 @@ void DockDatabase::reloadDbCb(
 
 Dock * DockDatabase::findDock(const std::string & dock_id)
 {
+  std::lock_guard<std::mutex> lock(instances_mutex_);
   Dock * dock_instance = findDockInstance(dock_id);
-  ChargingDock::Ptr dock_plugin{nullptr};
 
   if (dock_instance) {
-    dock_plugin = findDockPlugin(dock_instance->type);
-    if (dock_plugin) {
-      // Populate the plugin shared pointer
-      dock_instance->plugin = dock_plugin;
+    if (populateDockPlugin(dock_instance)) {
       return dock_instance;
     }
     throw opennav_docking_core::DockNotValid("Dock requested has no valid plugin!");
@@ -112,6 +132,115 @@ Dock * DockDatabase::findDock(const std::string & dock_id)
   throw opennav_docking_core::DockNotInDB("Dock ID requested is not in database!");
 }
 
+bool DockDatabase::populateDockPlugin(Dock * dock)
+{
+  ChargingDock::Ptr dock_plugin = findDockPlugin(dock->type);
+  if (dock_plugin) {
+    // Populate the plugin shared pointer
+    dock->plugin = dock_plugin;
+    return true;
+  }
+  return false;
+}
+
+Dock * DockDatabase::findNearestDock(
+  const geometry_msgs::msg::PoseStamped & pose, const std::string & type)
+{
+  std::lock_guard<std::mutex> lock(instances_mutex_);
+  auto index_it = dock_indices_.find(pose.header.frame_id);
+  if (index_it == dock_indices_.end()) {
+    return nullptr;
+  }
+
+  std::string dock_id;
+  auto accept = [&](const std::string & id) {
+      return type.empty() || dock_instances_.at(id).type == type;
+    };
+  if (!index_it->second.nearest(pose.pose.position.x, pose.pose.position.y, accept, dock_id)) {
+    return nullptr;
+  }
+
+  Dock * dock = findDockInstance(dock_id);
+  populateDockPlugin(dock);
+  return dock;
+}
+
+std::vector<Dock *> DockDatabase::findDocksWithinRadius(
+  const geometry_msgs::msg::PoseStamped & pose, double radius, const std::string & type)
+{
+  std::lock_guard<std::mutex> lock(instances_mutex_);
+  std::vector<Dock *> docks;
+  auto index_it = dock_indices_.find(pose.header.frame_id);
+  if (index_it == dock_indices_.end()) {
+    return docks;
+  }
+
+  for (const auto & dock_id : index_it->second.withinRadius(
+      pose.pose.position.x, pose.pose.position.y, radius))
+  {
+    Dock * dock = findDockInstance(dock_id);
+    if (type.empty() || dock->type == type) {
+      populateDockPlugin(dock);
+      docks.push_back(dock);
+    }
+  }
+  return docks;
+}
+
+void DockDatabase::indexDocks()
+{
+  std::lock_guard<std::mutex> lock(instances_mutex_);
+  dock_indices_.clear();
+  for (const auto & dock : dock_instances_) {
+    auto index_it = dock_indices_.try_emplace(dock.second.frame, index_cell_size_).first;
+    index_it->second.insert(dock.first, dock.second.pose.position.x, dock.second.pose.position.y);
+  }
+}
+
+void DockDatabase::updateDocks(const DockMap & dock_instances)
+{
+  std::lock_guard<std::mutex> lock(instances_mutex_);
+
+  // Remove the docks no longer present
+  for (auto it = dock_instances_.begin(); it != dock_instances_.end(); ) {
+    if (dock_instances.find(it->first) == dock_instances.end()) {
+      auto index_it = dock_indices_.find(it->second.frame);
+      if (index_it != dock_indices_.end()) {
+        index_it->second.erase(it->first);
+      }
+      it = dock_instances_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  // Add the new docks and update the modified ones in place
+  for (const auto & new_dock : dock_instances) {
+    auto it = dock_instances_.find(new_dock.first);
+    if (it != dock_instances_.end()) {
+      Dock & dock = it->second;
+      if (dock.pose == new_dock.second.pose && dock.frame == new_dock.second.frame &&
+        dock.type == new_dock.second.type)
+      {
+        continue;
+      }
+      auto index_it = dock_indices_.find(dock.frame);
+      if (index_it != dock_indices_.end()) {
+        index_it->second.erase(new_dock.first);
+      }
+      dock.pose = new_dock.second.pose;
+      dock.frame = new_dock.second.frame;
+      dock.type = new_dock.second.type;
+    } else {
+      dock_instances_.insert(new_dock);
+    }
+
+    auto index_it = dock_indices_.try_emplace(new_dock.second.frame, index_cell_size_).first;
+    index_it->second.insert(
+      new_dock.first, new_dock.second.pose.position.x, new_dock.second.pose.position.y);
+  }
+}
+
 Dock * DockDatabase::findDockInstance(const std::string & dock_id)
 {
   auto it = dock_instances_.find(dock_id);
@@ -0,0 +1,115 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "opennav_docking/dock_index.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace opennav_docking
+{
+
+DockIndex::DockIndex(double cell_size)
+: cell_size_(cell_size > 0.0 ? cell_size : 1.0)
+{
+}
+
+int64_t DockIndex::cellKey(int cx, int cy) const
+{
+  return (static_cast<int64_t>(cx) << 32) | static_cast<uint32_t>(cy);
+}
+
+int DockIndex::cellCoord(double v) const
+{
+  return static_cast<int>(std::floor(v / cell_size_));
+}
+
+void DockIndex::insert(const std::string & id, double x, double y)
+{
+  erase(id);
+
+  const int cx = cellCoord(x);
+  const int cy = cellCoord(y);
+  const int64_t key = cellKey(cx, cy);
+  cells_[key].push_back(Entry{id, x, y});
+  entries_[id] = key;
+
+  if (entries_.size() == 1u) {
+    min_cx_ = max_cx_ = cx;
+    min_cy_ = max_cy_ = cy;
+  } else {
+    min_cx_ = std::min(min_cx_, cx);
+    max_cx_ = std::max(max_cx_, cx);
+    min_cy_ = std::min(min_cy_, cy);
+    max_cy_ = std::max(max_cy_, cy);
+  }
+}
+
+void DockIndex::erase(const std::string & id)
+{
+  auto entry_it = entries_.find(id);
+  if (entry_it == entries_.end()) {
+    return;
+  }
+
+  auto cell_it = cells_.find(entry_it->second);
+  std::vector<Entry> & cell = cell_it->second;
+  cell.erase(
+    std::remove_if(
+      cell.begin(), cell.end(), [&id](const Entry & entry) {return entry.id == id;}),
+    cell.end());
+  if (cell.empty()) {
+    cells_.erase(cell_it);
+  }
+  entries_.erase(entry_it);
+  // The bounds are left as they are, they only limit how far searches go
+}
+
+std::vector<std::string> DockIndex::withinRadius(double x, double y, double radius) const
+{
+  std::vector<std::pair<double, std::string>> found;
+  const double sq_radius = radius * radius;
+  const int min_cx = std::max(cellCoord(x - radius), min_cx_);
+  const int max_cx = std::min(cellCoord(x + radius), max_cx_);
+  const int min_cy = std::max(cellCoord(y - radius), min_cy_);
+  const int max_cy = std::min(cellCoord(y + radius), max_cy_);
+
+  for (int ix = min_cx; ix <= max_cx; ++ix) {
+    for (int iy = min_cy; iy <= max_cy; ++iy) {
+      auto it = cells_.find(cellKey(ix, iy));
+      if (it == cells_.end()) {
+        continue;
+      }
+      for (const Entry & entry : it->second) {
+        const double sq_dist = (entry.x - x) * (entry.x - x) + (entry.y - y) * (entry.y - y);
+        if (sq_dist <= sq_radius) {
+          found.emplace_back(sq_dist, entry.id);
+        }
+      }
+    }
+  }
+
+  std::sort(found.begin(), found.end());
+  std::vector<std::string> ids;
+  ids.reserve(found.size());
+  for (auto & match : found) {
+    ids.push_back(std::move(match.second));
+  }
+  return ids;
+}
+
+}  // namespace opennav_docking
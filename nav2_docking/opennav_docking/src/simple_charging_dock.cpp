@@ -115,6 +115,7 @@ void SimpleChargingDock::configure(
     dock_pose_sub_ = node_->create_subscription<geometry_msgs::msg::PoseStamped>(
       "detected_dock_pose", 1,
       [this](const geometry_msgs::msg::PoseStamped::SharedPtr pose) {
+        std::lock_guard<std::mutex> lock(detected_dock_pose_mutex_);
         detected_dock_pose_ = *pose;
       });
   }
@@ -170,13 +171,20 @@ bool SimpleChargingDock::getRefinedPose(geometry_msgs::msg::PoseStamped & pose)
 {
   // If using not detection, set the dock pose to the static fixed-frame version
   if (!use_external_detection_pose_) {
-    dock_pose_pub_->publish(pose);
-    dock_pose_ = pose;
+    // It only changes with the estimate given, not on each control cycle
+    if (pose != dock_pose_) {
+      dock_pose_pub_->publish(pose);
+      dock_pose_ = pose;
+    }
     return true;
   }
 
   // If using detections, get current detections, transform to frame, and apply offsets
-  geometry_msgs::msg::PoseStamped detected = detected_dock_pose_;
+  geometry_msgs::msg::PoseStamped detected;
+  {
+    std::lock_guard<std::mutex> lock(detected_dock_pose_mutex_);
+    detected = detected_dock_pose_;
+  }
 
   // Validate that external pose is new enough
   auto timeout = rclcpp::Duration::from_seconds(external_detection_timeout_);
@@ -185,6 +193,17 @@ bool SimpleChargingDock::getRefinedPose(geometry_msgs::msg::PoseStamped & pose)
     return false;
   }
 
+  // The dock does not move in the fixed frame, so the pose refined from the last detection
+  // holds until the next one, while the robot motion is accounted for by the transform of
+  // the fixed frame. This keeps the control loop free of detection rate lookups and filtering.
+  const rclcpp::Time detection_stamp(detected.header.stamp, RCL_ROS_TIME);
+  if (detection_stamp == refined_detection_stamp_ &&
+    dock_pose_.header.frame_id == pose.header.frame_id)
+  {
+    pose = dock_pose_;
+    return true;
+  }
+
   // Transform detected pose into fixed frame. Note that the argument pose
   // is the output of detection, but also acts as the initial estimate
   // and contains the frame_id of docking
@@ -232,6 +251,7 @@ bool SimpleChargingDock::getRefinedPose(geometry_msgs::msg::PoseStamped & pose)
   // Publish & return dock pose for debugging purposes
   dock_pose_pub_->publish(dock_pose_);
   pose = dock_pose_;
+  refined_detection_stamp_ = detection_stamp;
   return true;
 }
 
@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #include <chrono>
+#include <cmath>
+#include <string>
 #include "gtest/gtest.h"
 #include "rclcpp/rclcpp.hpp"
 #include "opennav_docking/dock_database.hpp"
@@ -57,6 +59,32 @@ public:
     dock_plugins_.insert({"second_dock_t", nullptr});
     dock_instances_.insert({"second_dock", dock});
   }
+
+  void populateGrid(int n)
+  {
+    dock_plugins_.insert({"grid_dock_t", nullptr});
+    for (int i = 0; i < n; ++i) {
+      for (int j = 0; j < n; ++j) {
+        Dock dock;
+        dock.type = (i + j) % 2 ? "odd_dock_t" : "grid_dock_t";
+        dock.frame = "map";
+        dock.pose.position.x = 4.0 * i;
+        dock.pose.position.y = 4.0 * j;
+        dock_instances_.insert({std::to_string(i) + "_" + std::to_string(j), dock});
+      }
+    }
+    indexDocks();
+  }
+
+  void update(const DockMap & docks)
+  {
+    updateDocks(docks);
+  }
+
+  DockMap & instances()
+  {
+    return dock_instances_;
+  }
 };
 
 TEST(DatabaseTests, ObjectLifecycle)
@@ -99,6 +127,58 @@ TEST(DatabaseTests, findTests)
   db.findDockPlugin("");
 }
 
+TEST(DatabaseTests, spatialQueries)
+{
+  DbShim db;
+  db.populateGrid(20);
+
+  geometry_msgs::msg::PoseStamped pose;
+  pose.header.frame_id = "map";
+  pose.pose.position.x = 13.0;
+  pose.pose.position.y = 21.0;
+
+  Dock * dock = db.findNearestDock(pose);
+  ASSERT_NE(dock, nullptr);
+  EXPECT_EQ(dock->pose.position.x, 12.0);
+  EXPECT_EQ(dock->pose.position.y, 20.0);
+
+  dock = db.findNearestDock(pose, "odd_dock_t");
+  ASSERT_NE(dock, nullptr);
+  EXPECT_EQ(dock->type, "odd_dock_t");
+  EXPECT_NEAR(
+    std::hypot(dock->pose.position.x - 13.0, dock->pose.position.y - 21.0),
+    std::sqrt(10.0), 1e-6);
+
+  auto docks = db.findDocksWithinRadius(pose, 6.0);
+  ASSERT_EQ(docks.size(), 8u);
+  EXPECT_EQ(docks[0]->pose.position.x, 12.0);
+  EXPECT_EQ(docks[0]->pose.position.y, 20.0);
+  EXPECT_EQ(db.findDocksWithinRadius(pose, 6.0, "odd_dock_t").size(), 4u);
+
+  // Far from all docks, and in another frame
+  pose.pose.position.x = -100.0;
+  dock = db.findNearestDock(pose);
+  ASSERT_NE(dock, nullptr);
+  EXPECT_EQ(dock->pose.position.x, 0.0);
+  EXPECT_TRUE(db.findDocksWithinRadius(pose, 6.0).empty());
+  pose.header.frame_id = "other_map";
+  EXPECT_EQ(db.findNearestDock(pose), nullptr);
+
+  // Incremental updates keep the unchanged docks in place
+  DockMap docks_map = db.instances();
+  Dock * unchanged = &db.instances().at("0_0");
+  docks_map.erase("3_5");
+  docks_map.at("1_1").pose.position.x = -50.0;
+  db.update(docks_map);
+  EXPECT_EQ(&db.instances().at("0_0"), unchanged);
+  EXPECT_EQ(db.instance_size(), 399u);
+
+  pose.header.frame_id = "map";
+  dock = db.findNearestDock(pose);
+  ASSERT_NE(dock, nullptr);
+  EXPECT_EQ(dock->pose.position.x, -50.0);
+}
+
 TEST(DatabaseTests, reloadDbService)
 {
   auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("test");
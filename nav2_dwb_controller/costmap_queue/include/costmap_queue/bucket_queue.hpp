@@ -0,0 +1,156 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2024, Open Navigation LLC
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef COSTMAP_QUEUE__BUCKET_QUEUE_HPP_
+#define COSTMAP_QUEUE__BUCKET_QUEUE_HPP_
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace costmap_queue
+{
+/**
+ * @brief Templatized priority queue over a flat array of buckets of integer priorities
+ *
+ * Items are stored in the bucket of their priority, and the queue keeps an index of the
+ * first non-empty bucket, so enqueuing and iterating is constant time for dense priorities
+ * (e.g. the distances between cells). Resetting the queue keeps the memory of the buckets,
+ * so that a queue used each cycle stops allocating after the first one.
+ *
+ * As for the MapBasedQueue, items with the same priority are returned last in, first out,
+ * and items may be enqueued with a priority below the current front.
+ */
+template<class item_t>
+class BucketQueue
+{
+public:
+  /**
+   * @brief Default Constructor
+   */
+  BucketQueue()
+  : item_count_(0), current_bucket_(0), max_bucket_(0)
+  {
+  }
+
+  /**
+   * @brief Default virtual Destructor
+   */
+  virtual ~BucketQueue() = default;
+
+  /**
+   * @brief Clear the queue, keeping the capacity of the buckets
+   */
+  virtual void reset()
+  {
+    if (item_count_ > 0) {
+      for (unsigned int bucket = current_bucket_; bucket <= max_bucket_; bucket++) {
+        buckets_[bucket].clear();
+      }
+    }
+    item_count_ = 0;
+    current_bucket_ = 0;
+    max_bucket_ = 0;
+  }
+
+  /**
+   * @brief Add a new item to the queue with a set priority
+   * @param priority Priority of the item, the index of its bucket
+   * @param item Payload item
+   */
+  void enqueue(const unsigned int priority, item_t item)
+  {
+    if (priority >= buckets_.size()) {
+      buckets_.resize(priority + 1);
+    }
+    buckets_[priority].push_back(item);
+
+    if (item_count_ == 0 || priority < current_bucket_) {
+      current_bucket_ = priority;
+    }
+    if (item_count_ == 0 || priority > max_bucket_) {
+      max_bucket_ = priority;
+    }
+    item_count_++;
+  }
+
+  /**
+   * @brief Check to see if there is anything in the queue
+   * @return True if there is nothing in the queue
+   *
+   * Must be called prior to front/pop.
+   */
+  bool isEmpty()
+  {
+    return item_count_ == 0;
+  }
+
+  /**
+   * @brief Return the item at the front of the queue
+   * @return The item at the front of the queue
+   */
+  item_t & front()
+  {
+    if (item_count_ == 0) {
+      throw std::out_of_range("front() called on empty costmap_queue::BucketQueue!");
+    }
+
+    return buckets_[current_bucket_].back();
+  }
+
+  /**
+   * @brief Remove (and destroy) the item at the front of the queue
+   */
+  void pop()
+  {
+    if (item_count_ == 0) {
+      return;
+    }
+
+    buckets_[current_bucket_].pop_back();
+    item_count_--;
+    while (item_count_ > 0 && buckets_[current_bucket_].empty()) {
+      current_bucket_++;
+    }
+  }
+
+protected:
+  std::vector<std::vector<item_t>> buckets_;
+  unsigned int item_count_;
+  unsigned int current_bucket_;
+  unsigned int max_bucket_;
+};
+}  // namespace costmap_queue
+
+#endif  // COSTMAP_QUEUE__BUCKET_QUEUE_HPP_
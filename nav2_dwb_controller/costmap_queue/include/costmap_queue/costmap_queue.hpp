@@ -40,7 +40,7 @@
 #include <limits>
 #include <memory>
 #include "nav2_costmap_2d/costmap_2d.hpp"
-#include "costmap_queue/map_based_queue.hpp"
+#include "costmap_queue/bucket_queue.hpp"
 
 namespace costmap_queue
 {
@@ -101,11 +101,14 @@ public:
  * the distance between them. By default, the Euclidean distance is used for ordering, but passing in
  * manhattan=true to the constructor will use the Manhattan distance.
  *
+ * The cells are kept in a BucketQueue, with a bucket for each distance a cell can have from
+ * its source, so that the expansion does not search or allocate bins as it goes.
+ *
  * The validCellToQueue overridable-function allows for deriving classes to limit the queue traversal
  * to a subset of all costmap cells. LimitedCostmapQueue does this by ignoring distances above a limit.
  *
  */
-class CostmapQueue : public MapBasedQueue<CellData>
+class CostmapQueue : public BucketQueue<CellData>
 {
 public:
   /**
@@ -155,7 +158,7 @@ protected:
     unsigned int src_y);
 
   /**
-   * @brief Compute the cached distances
+   * @brief Compute the cached distances, and the bucket of each distance
    */
   void computeCache();
 
@@ -181,7 +184,25 @@ protected:
     unsigned int dy = CellData::absolute_difference(cur_y, src_y);
     return cached_distances_[dx][dy];
   }
+
+  /**
+   * @brief  Lookup the pre-computed bucket of the distance between two cells
+   * @param cur_x The x coordinate of the current cell
+   * @param cur_y The y coordinate of the current cell
+   * @param src_x The x coordinate of the source cell
+   * @param src_y The y coordinate of the source cell
+   * @return Rank of the distance among all the cached distances
+   */
+  inline unsigned int bucketLookup(
+    const unsigned int cur_x, const unsigned int cur_y,
+    const unsigned int src_x, const unsigned int src_y)
+  {
+    unsigned int dx = CellData::absolute_difference(cur_x, src_x);
+    unsigned int dy = CellData::absolute_difference(cur_y, src_y);
+    return cached_buckets_[dx][dy];
+  }
   std::vector<std::vector<double>> cached_distances_;
+  std::vector<std::vector<unsigned int>> cached_buckets_;
   int cached_max_distance_;
 };
 }  // namespace costmap_queue
@@ -42,7 +42,7 @@ namespace costmap_queue
 {
 
 CostmapQueue::CostmapQueue(nav2_costmap_2d::Costmap2D & costmap, bool manhattan)
-: MapBasedQueue(), costmap_(costmap), max_distance_(-1), manhattan_(manhattan),
+: BucketQueue(), costmap_(costmap), max_distance_(-1), manhattan_(manhattan),
   cached_max_distance_(-1)
 {
   reset();
@@ -56,7 +56,7 @@ void CostmapQueue::reset()
   }
   std::fill(seen_.begin(), seen_.end(), false);
   computeCache();
-  MapBasedQueue::reset();
+  BucketQueue::reset();
 }
 
 void CostmapQueue::enqueueCell(unsigned int x, unsigned int y)
@@ -77,7 +77,7 @@ void CostmapQueue::enqueueCell(
   CellData data(distance, index, cur_x, cur_y, src_x, src_y);
   if (validCellToQueue(data)) {
     seen_[index] = true;
-    enqueue(distance, data);
+    enqueue(bucketLookup(cur_x, cur_y, src_x, src_y), data);
   }
 }
 
@@ -131,6 +131,30 @@ void CostmapQueue::computeCache()
       }
     }
   }
+
+  // Rank the distances by their squared (or Manhattan) length in integers, so that equal
+  // distances share a bucket regardless of the rounding of hypot
+  auto length = [this](unsigned int i, unsigned int j) {
+      return manhattan_ ? i + j : i * i + j * j;
+    };
+  std::vector<unsigned int> lengths;
+  lengths.reserve(cached_distances_.size() * cached_distances_.size());
+  for (unsigned int i = 0; i < cached_distances_.size(); ++i) {
+    for (unsigned int j = 0; j < cached_distances_[i].size(); ++j) {
+      lengths.push_back(length(i, j));
+    }
+  }
+  std::sort(lengths.begin(), lengths.end());
+  lengths.erase(std::unique(lengths.begin(), lengths.end()), lengths.end());
+
+  cached_buckets_.resize(cached_distances_.size());
+  for (unsigned int i = 0; i < cached_buckets_.size(); ++i) {
+    cached_buckets_[i].resize(cached_distances_[i].size());
+    for (unsigned int j = 0; j < cached_buckets_[i].size(); ++j) {
+      cached_buckets_[i][j] = std::lower_bound(
+        lengths.begin(), lengths.end(), length(i, j)) - lengths.begin();
+    }
+  }
   cached_max_distance_ = max_distance_;
 }
 
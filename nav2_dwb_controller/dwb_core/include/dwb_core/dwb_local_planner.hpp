@@ -35,6 +35,8 @@
 #ifndef DWB_CORE__DWB_LOCAL_PLANNER_HPP_
 #define DWB_CORE__DWB_LOCAL_PLANNER_HPP_
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -46,6 +48,7 @@
 #include "dwb_core/trajectory_generator.hpp"
 #include "nav_2d_msgs/msg/pose2_d_stamped.hpp"
 #include "nav_2d_msgs/msg/twist2_d_stamped.hpp"
+#include "nav2_util/thread_pool.hpp"
 #include "rclcpp/rclcpp.hpp"
 #include "rclcpp_lifecycle/lifecycle_node.hpp"
 #include "pluginlib/class_loader.hpp"
@@ -171,13 +174,43 @@ protected:
     nav_2d_msgs::msg::Pose2DStamped & goal_pose, bool publish_plan = true);
 
   /**
-   * @brief Iterate through all the twists and find the best one
+   * @brief Iterate through all the twists and find the best one, generating and
+   * scoring the trajectories on trajectory_pool_ if there is one
    */
   virtual dwb_msgs::msg::TrajectoryScore coreScoringAlgorithm(
     const geometry_msgs::msg::Pose2D & pose,
     const nav_2d_msgs::msg::Twist2D velocity,
     std::shared_ptr<dwb_msgs::msg::LocalPlanEvaluation> & results);
 
+  /**
+   * @brief Score the trajectory of a TrajectoryScore in place, without copying it
+   *
+   * Replaces the critic scores and total of score, reusing their buffers.
+   * Throws an IllegalTrajectoryException if the trajectory is illegal.
+   *
+   * @param best_score Best total so far, to short circuit the scoring if enabled
+   * @param score [in,out] Score whose traj is scored
+   */
+  virtual void scoreTrajectory(double best_score, dwb_msgs::msg::TrajectoryScore & score);
+
+  /**
+   * @brief Score a trajectory running the critics in critic_order_, measuring them
+   *
+   * The critic scores are in the order of critics_, and the total is summed in that order
+   * unless the scoring is short circuited. The critics not run by a short circuited scoring
+   * have a raw score of 0.
+   *
+   * @param best_score Best total so far, to short circuit the scoring if enabled
+   * @param score [in,out] Score whose traj is scored
+   */
+  void scoreTrajectoryInCriticOrder(double best_score, dwb_msgs::msg::TrajectoryScore & score);
+
+  /**
+   * @brief Order the critics by increasing time spent per trajectory rejected, from their
+   * measurements since the last cycles
+   */
+  void updateCriticOrder();
+
   /**
    * @brief Transforms global plan into same frame as pose, clips far away poses and possibly prunes passed poses
    *
@@ -237,6 +270,29 @@ protected:
   std::string dwb_plugin_name_;
 
   bool short_circuit_trajectory_evaluation_;
+  int trajectory_threads_;
+  // Threads scoring the trajectories along with the thread of the controller, created once
+  // if trajectory_threads_ is above 1
+  std::unique_ptr<nav2_util::ThreadPool> trajectory_pool_;
+
+  /**
+   * @brief Time spent in a critic and trajectories it rejected, by an illegal trajectory or
+   * by short circuiting the scoring, updated by the scoring threads
+   */
+  struct CriticStats
+  {
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> rejections{0};
+    std::atomic<uint64_t> nanoseconds{0};
+  };
+
+  bool adaptive_critic_order_;
+  std::unique_ptr<CriticStats[]> critic_stats_;
+  std::vector<size_t> critic_order_;  ///< Indices of critics_ in the order they are run
+
+  // Scores of the trajectories of a cycle, kept to reuse their buffers across cycles
+  dwb_msgs::msg::TrajectoryScore score_buffer_;
+  std::vector<dwb_msgs::msg::TrajectoryScore> twist_scores_;
 };
 
 }  // namespace dwb_core
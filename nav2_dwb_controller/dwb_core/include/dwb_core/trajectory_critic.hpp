@@ -67,6 +67,8 @@ namespace dwb_core
  *       and there may be some shared work that can be done beforehand to optimize
  *       the scoring of each individual trajectory.
  *  3) scoreTrajectory is called once per trajectory and returns the score.
+ *       With trajectory_threads above 1 it is called concurrently for different
+ *       trajectories, so it should only read the state set up by prepare.
  *  4) debrief is called after each set of trajectories with the chosen trajectory.
  *       This can be used for stateful critics that monitor the trajectory through time.
  *
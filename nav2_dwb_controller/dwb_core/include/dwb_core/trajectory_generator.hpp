@@ -94,6 +94,17 @@ public:
    */
   virtual nav_2d_msgs::msg::Twist2D nextTwist() = 0;
 
+  /**
+   * @brief Report the score of a twist returned by nextTwist, in the order they were returned
+   *
+   * Generators refining their samples around the best twists wait for the scores of the
+   * twists returned so far before returning more of them.
+   *
+   * @param twist The twist scored
+   * @param score Total score of its trajectory, negative if illegal
+   */
+  virtual void setTwistScore(const nav_2d_msgs::msg::Twist2D & /*twist*/, double /*score*/) {}
+
   /**
    * @brief Get all the twists for an iteration.
    *
@@ -124,6 +135,22 @@ public:
     const nav_2d_msgs::msg::Twist2D & start_vel,
     const nav_2d_msgs::msg::Twist2D & cmd_vel) = 0;
 
+  /**
+   * @brief Generate a Trajectory2D into an existing one, so that its buffers can be reused
+   * @param start_pose Current robot location
+   * @param start_vel Current robot velocity
+   * @param cmd_vel The desired command velocity
+   * @param traj [out] The generated trajectory
+   */
+  virtual void generateTrajectory(
+    const geometry_msgs::msg::Pose2D & start_pose,
+    const nav_2d_msgs::msg::Twist2D & start_vel,
+    const nav_2d_msgs::msg::Twist2D & cmd_vel,
+    dwb_msgs::msg::Trajectory2D & traj)
+  {
+    traj = generateTrajectory(start_pose, start_vel, cmd_vel);
+  }
+
   /**
    * @brief Limits the maximum linear speed of the robot.
    * @param speed_limit expressed in absolute value (in m/s)
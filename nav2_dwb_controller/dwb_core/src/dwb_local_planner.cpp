@@ -33,7 +33,11 @@
  */
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <mutex>
+#include <numeric>
 #include <string>
 #include <utility>
 #include <vector>
@@ -48,10 +52,12 @@
 #include "nav2_util/geometry_utils.hpp"
 #include "nav2_util/lifecycle_node.hpp"
 #include "nav2_util/node_utils.hpp"
+#include "nav2_util/robot_utils.hpp"
 #include "nav2_core/controller_exceptions.hpp"
 #include "pluginlib/class_list_macros.hpp"
 #include "nav_msgs/msg/path.hpp"
 #include "geometry_msgs/msg/twist_stamped.hpp"
+#include "tf2/utils.h"
 
 using nav2_util::declare_parameter_if_not_declared;
 using nav2_util::geometry_utils::euclidean_distance;
@@ -108,6 +114,12 @@ void DWBLocalPlanner::configure(
   declare_parameter_if_not_declared(
     node, dwb_plugin_name_ + ".short_circuit_trajectory_evaluation",
     rclcpp::ParameterValue(true));
+  declare_parameter_if_not_declared(
+    node, dwb_plugin_name_ + ".trajectory_threads",
+    rclcpp::ParameterValue(1));
+  declare_parameter_if_not_declared(
+    node, dwb_plugin_name_ + ".adaptive_critic_order",
+    rclcpp::ParameterValue(false));
 
   std::string traj_generator_name;
 
@@ -131,6 +143,11 @@ void DWBLocalPlanner::configure(
     dwb_plugin_name_ + ".short_circuit_trajectory_evaluation",
     short_circuit_trajectory_evaluation_);
   node->get_parameter(dwb_plugin_name_ + ".shorten_transformed_plan", shorten_transformed_plan_);
+  node->get_parameter(dwb_plugin_name_ + ".trajectory_threads", trajectory_threads_);
+  if (trajectory_threads_ > 1) {
+    trajectory_pool_ = std::make_unique<nav2_util::ThreadPool>(trajectory_threads_ - 1);
+  }
+  node->get_parameter(dwb_plugin_name_ + ".adaptive_critic_order", adaptive_critic_order_);
 
   pub_ = std::make_unique<DWBPublisher>(node, dwb_plugin_name_);
   pub_->on_configure();
@@ -232,6 +249,10 @@ DWBLocalPlanner::loadCritics()
     }
     RCLCPP_INFO(logger_, "Critic plugin initialized");
   }
+
+  critic_stats_ = std::make_unique<CriticStats[]>(critics_.size());
+  critic_order_.resize(critics_.size());
+  std::iota(critic_order_.begin(), critic_order_.end(), 0);
 }
 
 void
@@ -368,20 +389,15 @@ DWBLocalPlanner::coreScoringAlgorithm(
   const nav_2d_msgs::msg::Twist2D velocity,
   std::shared_ptr<dwb_msgs::msg::LocalPlanEvaluation> & results)
 {
-  nav_2d_msgs::msg::Twist2D twist;
-  dwb_msgs::msg::Trajectory2D traj;
   dwb_msgs::msg::TrajectoryScore best, worst;
   best.total = -1;
   worst.total = -1;
   IllegalTrajectoryTracker tracker;
+  if (adaptive_critic_order_) {
+    updateCriticOrder();
+  }
 
-  traj_generator_->startNewIteration(velocity);
-  while (traj_generator_->hasMoreTwists()) {
-    twist = traj_generator_->nextTwist();
-    traj = traj_generator_->generateTrajectory(pose, velocity, twist);
-
-    try {
-      dwb_msgs::msg::TrajectoryScore score = scoreTrajectory(traj, best.total);
+  auto addLegalTrajectory = [&](const dwb_msgs::msg::TrajectoryScore & score) {
       tracker.addLegalTrajectory();
       if (results) {
         results->twists.push_back(score);
@@ -398,7 +414,10 @@ DWBLocalPlanner::coreScoringAlgorithm(
           results->worst_index = results->twists.size() - 1;
         }
       }
-    } catch (const dwb_core::IllegalTrajectoryException & e) {
+    };
+
+  auto addIllegalTrajectory = [&](
+    const dwb_msgs::msg::Trajectory2D & traj, const IllegalTrajectoryException & e) {
       if (results) {
         dwb_msgs::msg::TrajectoryScore failed_score;
         failed_score.traj = traj;
@@ -411,6 +430,69 @@ DWBLocalPlanner::coreScoringAlgorithm(
         results->twists.push_back(failed_score);
       }
       tracker.addIllegalTrajectory(e);
+    };
+
+  if (trajectory_pool_) {
+    std::vector<nav_2d_msgs::msg::Twist2D> twists;
+    auto & scores = twist_scores_;
+    std::vector<std::unique_ptr<IllegalTrajectoryException>> illegal;
+    std::atomic<double> best_total{-1.0};
+
+    // The best total so far bounds the short circuit of every thread. Only
+    // trajectories worse than the best one are cut short, so the best twist does
+    // not depend on the scheduling of the threads
+    auto scoreTwist = [&](size_t i) {
+        traj_generator_->generateTrajectory(pose, velocity, twists[i], scores[i].traj);
+        try {
+          scoreTrajectory(best_total.load(), scores[i]);
+          double total = best_total.load();
+          while ((total < 0 || scores[i].total < total) &&
+            !best_total.compare_exchange_weak(total, scores[i].total))
+          {
+          }
+        } catch (const IllegalTrajectoryException & e) {
+          illegal[i] = std::make_unique<IllegalTrajectoryException>(e);
+        }
+      };
+
+    // Generators refining around the best twists only return more of them once the
+    // scores of the previous ones are reported, so the twists are scored in rounds
+    traj_generator_->startNewIteration(velocity);
+    while (traj_generator_->hasMoreTwists()) {
+      twists.clear();
+      while (traj_generator_->hasMoreTwists()) {
+        twists.push_back(traj_generator_->nextTwist());
+      }
+      scores.resize(twists.size());
+      illegal.clear();
+      illegal.resize(twists.size());
+      trajectory_pool_->parallelFor(twists.size(), scoreTwist);
+
+      // Accounted in the order of the twists, as when scored one by one
+      for (size_t i = 0; i != twists.size(); i++) {
+        if (illegal[i]) {
+          addIllegalTrajectory(scores[i].traj, *illegal[i]);
+          traj_generator_->setTwistScore(twists[i], -1.0);
+        } else {
+          addLegalTrajectory(scores[i]);
+          traj_generator_->setTwistScore(twists[i], scores[i].total);
+        }
+      }
+    }
+  } else {
+    traj_generator_->startNewIteration(velocity);
+    while (traj_generator_->hasMoreTwists()) {
+      nav_2d_msgs::msg::Twist2D twist = traj_generator_->nextTwist();
+      traj_generator_->generateTrajectory(pose, velocity, twist, score_buffer_.traj);
+
+      try {
+        scoreTrajectory(best.total, score_buffer_);
+        addLegalTrajectory(score_buffer_);
+        traj_generator_->setTwistScore(twist, score_buffer_.total);
+      } catch (const dwb_core::IllegalTrajectoryException & e) {
+        addIllegalTrajectory(score_buffer_.traj, e);
+        traj_generator_->setTwistScore(twist, -1.0);
+      }
     }
   }
 
@@ -437,6 +519,21 @@ DWBLocalPlanner::scoreTrajectory(
 {
   dwb_msgs::msg::TrajectoryScore score;
   score.traj = traj;
+  scoreTrajectory(best_score, score);
+  return score;
+}
+
+void
+DWBLocalPlanner::scoreTrajectory(double best_score, dwb_msgs::msg::TrajectoryScore & score)
+{
+  if (adaptive_critic_order_) {
+    scoreTrajectoryInCriticOrder(best_score, score);
+    return;
+  }
+
+  const dwb_msgs::msg::Trajectory2D & traj = score.traj;
+  score.scores.clear();
+  score.total = 0.0;
 
   for (TrajectoryCritic::Ptr & critic : critics_) {
     dwb_msgs::msg::CriticScore cs;
@@ -457,8 +554,87 @@ DWBLocalPlanner::scoreTrajectory(
       break;
     }
   }
+}
+
+void
+DWBLocalPlanner::scoreTrajectoryInCriticOrder(
+  double best_score, dwb_msgs::msg::TrajectoryScore & score)
+{
+  const dwb_msgs::msg::Trajectory2D & traj = score.traj;
+  score.scores.resize(critics_.size());
+  for (size_t i = 0; i != critics_.size(); i++) {
+    dwb_msgs::msg::CriticScore & cs = score.scores[i];
+    cs.name = critics_[i]->getName();
+    cs.scale = critics_[i]->getScale();
+    cs.raw_score = 0.0;
+  }
+
+  score.total = 0.0;
+  for (const size_t i : critic_order_) {
+    dwb_msgs::msg::CriticScore & cs = score.scores[i];
+    if (cs.scale == 0.0) {
+      continue;
+    }
+
+    CriticStats & stats = critic_stats_[i];
+    const auto start = std::chrono::steady_clock::now();
+    auto measure = [&](bool rejected) {
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        stats.calls.fetch_add(1, std::memory_order_relaxed);
+        stats.rejections.fetch_add(rejected, std::memory_order_relaxed);
+        stats.nanoseconds.fetch_add(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+          std::memory_order_relaxed);
+      };
+    try {
+      cs.raw_score = critics_[i]->scoreTrajectory(traj);
+    } catch (const IllegalTrajectoryException &) {
+      measure(true);
+      throw;
+    }
+
+    score.total += cs.raw_score * cs.scale;
+    const bool short_circuit =
+      short_circuit_trajectory_evaluation_ && best_score > 0 && score.total > best_score;
+    measure(short_circuit);
+    if (short_circuit) {
+      return;
+    }
+  }
 
-  return score;
+  // The total of a trajectory fully scored does not depend on the order of the critics
+  score.total = 0.0;
+  for (const dwb_msgs::msg::CriticScore & cs : score.scores) {
+    score.total += cs.raw_score * cs.scale;
+  }
+}
+
+void
+DWBLocalPlanner::updateCriticOrder()
+{
+  // Running the critics by increasing expected time per rejection minimizes the expected
+  // time to reject a trajectory, for independent rejections. Critics not measured yet run
+  // first, so that critics moved to the end are measured again once their measurements fade.
+  std::vector<double> keys(critics_.size(), 0.0);
+  for (size_t i = 0; i != critics_.size(); i++) {
+    CriticStats & stats = critic_stats_[i];
+    const uint64_t calls = stats.calls.load();
+    const uint64_t rejections = stats.rejections.load();
+    const uint64_t nanoseconds = stats.nanoseconds.load();
+    if (calls > 0) {
+      const double rejection_rate = (rejections + 1.0) / (calls + 2.0);
+      keys[i] = nanoseconds / static_cast<double>(calls) / rejection_rate;
+    }
+
+    // Halved each cycle, to follow the changes of the scene
+    stats.calls = calls / 2;
+    stats.rejections = rejections / 2;
+    stats.nanoseconds = nanoseconds / 2;
+  }
+
+  std::stable_sort(
+    critic_order_.begin(), critic_order_.end(),
+    [&keys](size_t a, size_t b) {return keys[a] < keys[b];});
 }
 
 nav_2d_msgs::msg::Path2D
@@ -535,16 +711,27 @@ DWBLocalPlanner::transformGlobalPlan(
   transformed_plan.header.frame_id = costmap_ros_->getGlobalFrameID();
   transformed_plan.header.stamp = pose.header.stamp;
 
+  // Look up the transform from the global frame to local once for all the poses
+  tf2::Transform global_to_local;
+  if (!nav2_util::getTransform(
+      global_plan_.header.frame_id, transformed_plan.header.frame_id,
+      tf2_ros::fromRclcpp(transform_tolerance_), tf_, global_to_local))
+  {
+    throw nav2_core::ControllerTFError("Unable to transform plan pose into local frame");
+  }
+
   // Helper function for the transform below. Converts a pose2D from global
   // frame to local
   auto transformGlobalPoseToLocal = [&](const auto & global_plan_pose) {
-      nav_2d_msgs::msg::Pose2DStamped stamped_pose, transformed_pose;
-      stamped_pose.header.frame_id = global_plan_.header.frame_id;
-      stamped_pose.pose = global_plan_pose;
-      nav_2d_utils::transformPose(
-        tf_, transformed_plan.header.frame_id,
-        stamped_pose, transformed_pose, transform_tolerance_);
-      return transformed_pose.pose;
+      const tf2::Vector3 position =
+        global_to_local * tf2::Vector3(global_plan_pose.x, global_plan_pose.y, 0.0);
+      tf2::Quaternion orientation;
+      orientation.setRPY(0.0, 0.0, global_plan_pose.theta);
+      geometry_msgs::msg::Pose2D transformed_pose;
+      transformed_pose.x = position.x();
+      transformed_pose.y = position.y();
+      transformed_pose.theta = tf2::getYaw(global_to_local.getRotation() * orientation);
+      return transformed_pose;
     };
 
   std::transform(
@@ -154,6 +154,13 @@ DWBPublisher::on_cleanup()
   return nav2_util::CallbackReturn::SUCCESS;
 }
 
+bool
+DWBPublisher::shouldRecordEvaluation()
+{
+  return (publish_evaluation_ && eval_pub_->get_subscription_count() > 0) ||
+         (publish_trajectories_ && marker_pub_->get_subscription_count() > 0);
+}
+
 void
 DWBPublisher::publishEvaluation(std::shared_ptr<dwb_msgs::msg::LocalPlanEvaluation> results)
 {
@@ -235,23 +242,20 @@ DWBPublisher::publishLocalPlan(
   const std_msgs::msg::Header & header,
   const dwb_msgs::msg::Trajectory2D & traj)
 {
-  if (!publish_local_plan_) {return;}
+  if (!publish_local_plan_ || local_pub_->get_subscription_count() < 1) {return;}
 
   auto path =
     std::make_unique<nav_msgs::msg::Path>(
     nav_2d_utils::poses2DToPath(
       traj.poses, header.frame_id,
       header.stamp));
-
-  if (local_pub_->get_subscription_count() > 0) {
-    local_pub_->publish(std::move(path));
-  }
+  local_pub_->publish(std::move(path));
 }
 
 void
 DWBPublisher::publishCostGrid(
   const std::shared_ptr<nav2_costmap_2d::Costmap2DROS> costmap_ros,
-  const std::vector<TrajectoryCritic::Ptr> critics)
+  const std::vector<TrajectoryCritic::Ptr> & critics)
 {
   if (cost_grid_pc_pub_->get_subscription_count() < 1) {return;}
 
@@ -269,7 +273,7 @@ DWBPublisher::publishCostGrid(
   std::vector<std::pair<std::string, std::vector<float>>> cost_channels;
   std::vector<float> total_cost(size_x * size_y, 0.0);
 
-  for (TrajectoryCritic::Ptr critic : critics) {
+  for (const TrajectoryCritic::Ptr & critic : critics) {
     unsigned int channel_index = cost_channels.size();
     critic->addCriticVisualization(cost_channels);
     if (channel_index == cost_channels.size()) {
@@ -338,26 +342,26 @@ DWBPublisher::publishCostGrid(
 }
 
 void
-DWBPublisher::publishGlobalPlan(const nav_2d_msgs::msg::Path2D plan)
+DWBPublisher::publishGlobalPlan(const nav_2d_msgs::msg::Path2D & plan)
 {
   publishGenericPlan(plan, *global_pub_, publish_global_plan_);
 }
 
 void
-DWBPublisher::publishTransformedPlan(const nav_2d_msgs::msg::Path2D plan)
+DWBPublisher::publishTransformedPlan(const nav_2d_msgs::msg::Path2D & plan)
 {
   publishGenericPlan(plan, *transformed_pub_, publish_transformed_);
 }
 
 void
-DWBPublisher::publishLocalPlan(const nav_2d_msgs::msg::Path2D plan)
+DWBPublisher::publishLocalPlan(const nav_2d_msgs::msg::Path2D & plan)
 {
   publishGenericPlan(plan, *local_pub_, publish_local_plan_);
 }
 
 void
 DWBPublisher::publishGenericPlan(
-  const nav_2d_msgs::msg::Path2D plan,
+  const nav_2d_msgs::msg::Path2D & plan,
   rclcpp::Publisher<nav_msgs::msg::Path> & pub, bool flag)
 {
   if (pub.get_subscription_count() < 1) {return;}
@@ -0,0 +1,140 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "dwb_core/dwb_local_planner.hpp"
+#include "dwb_core/exceptions.hpp"
+#include "dwb_core/illegal_trajectory_tracker.hpp"
+
+namespace dwb_core
+{
+
+// Twists on a grid, in a single round
+class GridGenerator : public TrajectoryGenerator
+{
+public:
+  void initialize(const nav2_util::LifecycleNode::SharedPtr &, const std::string &) override {}
+  void startNewIteration(const nav_2d_msgs::msg::Twist2D &) override {index_ = 0;}
+  bool hasMoreTwists() override {return index_ < 21 * 21;}
+  nav_2d_msgs::msg::Twist2D nextTwist() override
+  {
+    nav_2d_msgs::msg::Twist2D twist;
+    twist.x = 0.05 * (index_ % 21);
+    twist.theta = -0.5 + 0.05 * (index_ / 21);
+    index_++;
+    return twist;
+  }
+  dwb_msgs::msg::Trajectory2D generateTrajectory(
+    const geometry_msgs::msg::Pose2D & start_pose,
+    const nav_2d_msgs::msg::Twist2D &,
+    const nav_2d_msgs::msg::Twist2D & cmd_vel) override
+  {
+    dwb_msgs::msg::Trajectory2D traj;
+    traj.velocity = cmd_vel;
+    traj.poses.push_back(start_pose);
+    return traj;
+  }
+  void setSpeedLimit(const double &, const bool &) override {}
+
+protected:
+  int index_{0};
+};
+
+// Scores the squared distance of the twist to a target twist, rejecting the twists turning too fast
+class TargetCritic : public TrajectoryCritic
+{
+public:
+  TargetCritic(const std::string & name, double x, double theta, double max_theta)
+  : x_(x), theta_(theta), max_theta_(max_theta)
+  {
+    name_ = name;
+    scale_ = 1.0;
+  }
+  double scoreTrajectory(const dwb_msgs::msg::Trajectory2D & traj) override
+  {
+    if (std::abs(traj.velocity.theta) > max_theta_) {
+      throw IllegalTrajectoryException(name_, "Turning too fast");
+    }
+    return std::pow(traj.velocity.x - x_, 2) + std::pow(traj.velocity.theta - theta_, 2);
+  }
+
+protected:
+  double x_, theta_, max_theta_;
+};
+
+class ScoringPlanner : public DWBLocalPlanner
+{
+public:
+  explicit ScoringPlanner(int threads)
+  {
+    trajectory_threads_ = threads;
+    if (threads > 1) {
+      trajectory_pool_ = std::make_unique<nav2_util::ThreadPool>(threads - 1);
+    }
+    traj_generator_ = std::make_shared<GridGenerator>();
+    critics_.push_back(std::make_shared<TargetCritic>("Near", 0.62, 0.31, 0.4));
+    critics_.push_back(std::make_shared<TargetCritic>("Far", 0.9, -0.2, 10.0));
+    short_circuit_trajectory_evaluation_ = true;
+    adaptive_critic_order_ = false;
+  }
+
+  void rejectAll()
+  {
+    critics_.push_back(std::make_shared<TargetCritic>("Wall", 0.0, 0.0, -1.0));
+  }
+
+  dwb_msgs::msg::TrajectoryScore score(
+    std::shared_ptr<dwb_msgs::msg::LocalPlanEvaluation> & results)
+  {
+    return coreScoringAlgorithm(geometry_msgs::msg::Pose2D(), nav_2d_msgs::msg::Twist2D(), results);
+  }
+};
+
+}  // namespace dwb_core
+
+TEST(DWBLocalPlannerThreads, SameBestTwistWithAnyNumberOfThreads)
+{
+  dwb_core::ScoringPlanner single(1);
+  auto single_results = std::make_shared<dwb_msgs::msg::LocalPlanEvaluation>();
+  const auto expected = single.score(single_results);
+
+  for (int threads : {2, 4, 8}) {
+    dwb_core::ScoringPlanner multi(threads);
+    // Repeated, as the scheduling of the threads differs from one cycle to the next
+    for (int cycle = 0; cycle < 20; cycle++) {
+      auto results = std::make_shared<dwb_msgs::msg::LocalPlanEvaluation>();
+      const auto best = multi.score(results);
+      EXPECT_EQ(best.traj.velocity, expected.traj.velocity);
+      EXPECT_DOUBLE_EQ(best.total, expected.total);
+      EXPECT_EQ(results->best_index, single_results->best_index);
+      EXPECT_EQ(results->twists.size(), single_results->twists.size());
+    }
+  }
+}
+
+TEST(DWBLocalPlannerThreads, NoLegalTrajectoriesWithAnyNumberOfThreads)
+{
+  for (int threads : {1, 4}) {
+    dwb_core::ScoringPlanner planner(threads);
+    planner.rejectAll();
+    std::shared_ptr<dwb_msgs::msg::LocalPlanEvaluation> results;
+    EXPECT_THROW(planner.score(results), dwb_core::NoLegalTrajectoriesException);
+  }
+}
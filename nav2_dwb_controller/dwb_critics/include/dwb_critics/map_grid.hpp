@@ -57,10 +57,16 @@ namespace dwb_critics
  *
  * This approach was chosen for computational efficiency, such that each trajectory
  * need not be compared to the list of source points.
+ *
+ * The distances only depend on the source cells and the size of the costmap, so they are
+ * reused while those are unchanged, and shared between the critics of a costmap with the
+ * same source cells (e.g. PathDist and PathAlign).
  */
 class MapGridCritic : public dwb_core::TrajectoryCritic
 {
 public:
+  ~MapGridCritic() override;
+
   // Standard TrajectoryCritic Interface
   void onInit() override;
   double scoreTrajectory(const dwb_msgs::msg::Trajectory2D & traj) override;
@@ -130,12 +136,28 @@ protected:
    */
   void propogateManhattanDistances();
 
+  /**
+   * @brief Set the cells to the Manhattan distance from the closest source cell
+   *
+   * Reuses the distances of the last call, or copies those of another critic of the
+   * costmap, if they were propagated from the same source cells on a costmap of the same size.
+   *
+   * @param sources Indices of the source cells
+   */
+  void propagateManhattanDistances(const std::vector<unsigned int> & sources);
+
   std::shared_ptr<MapGridQueue> queue_;
   nav2_costmap_2d::Costmap2D * costmap_;
   std::vector<double> cell_values_;
   double obstacle_score_, unreachable_score_;  ///< Special cell_values
   bool stop_on_failure_;
   ScoreAggregationType aggregationType_;
+
+  // Source cells of the current distances, filled by the subclasses before propagating
+  std::vector<unsigned int> sources_;
+  std::vector<unsigned int> propagated_sources_;
+  unsigned int propagated_size_x_{0}, propagated_size_y_{0};
+  bool propagated_{false};
 };
 }  // namespace dwb_critics
 
@@ -52,6 +52,16 @@ Footprint getOrientedFootprint(
   const geometry_msgs::msg::Pose2D & pose,
   const Footprint & footprint_spec);
 
+/**
+ * @brief Transform the footprint spec to be centered at the given pose, reusing the given footprint
+ * @param pose Robot pose
+ * @param footprint_spec List of points that make up the footprint spec, centered at 0,0
+ * @param oriented_footprint [out] oriented footprint
+ */
+void getOrientedFootprint(
+  const geometry_msgs::msg::Pose2D & pose,
+  const Footprint & footprint_spec, Footprint & oriented_footprint);
+
 /**
  * @class ObstacleFootprintCritic
  * @brief Uses costmap 2d to assign negative costs if robot footprint is in obstacle on any point of the trajectory.
@@ -61,6 +71,9 @@ Footprint getOrientedFootprint(
  *
  * A more robust class could check every cell within the robot's footprint without inflating the obstacles,
  * at some computational cost. That is left as an excercise to the reader.
+ *
+ * Trajectories are scored by sweeping the footprint along their poses, looking up the cost of each cell of
+ * the sweep once, and skipping the poses whose footprint covers the same cells as the previous pose.
  */
 class ObstacleFootprintCritic : public BaseObstacleCritic
 {
@@ -68,6 +81,7 @@ public:
   bool prepare(
     const geometry_msgs::msg::Pose2D & pose, const nav_2d_msgs::msg::Twist2D & vel,
     const geometry_msgs::msg::Pose2D & goal, const nav_2d_msgs::msg::Path2D & global_plan) override;
+  double scoreTrajectory(const dwb_msgs::msg::Trajectory2D & traj) override;
   double scorePose(const geometry_msgs::msg::Pose2D & pose) override;
   virtual double scorePose(
     const geometry_msgs::msg::Pose2D & pose,
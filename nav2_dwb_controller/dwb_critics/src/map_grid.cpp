@@ -39,6 +39,7 @@
 #include <utility>
 #include <algorithm>
 #include <memory>
+#include <mutex>
 #include "dwb_core/exceptions.hpp"
 #include "nav2_costmap_2d/cost_values.hpp"
 #include "nav2_util/node_utils.hpp"
@@ -49,16 +50,30 @@ using costmap_queue::CellData;
 namespace dwb_critics
 {
 
+// Critics which may share their distances, guarded along with the distances they propagate
+static std::mutex g_critics_mutex;
+static std::vector<MapGridCritic *> g_critics;
+
 // Customization of the CostmapQueue validCellToQueue method
 bool MapGridCritic::MapGridQueue::validCellToQueue(const costmap_queue::CellData & /*cell*/)
 {
   return true;
 }
 
+MapGridCritic::~MapGridCritic()
+{
+  std::lock_guard<std::mutex> guard(g_critics_mutex);
+  g_critics.erase(std::remove(g_critics.begin(), g_critics.end(), this), g_critics.end());
+}
+
 void MapGridCritic::onInit()
 {
   costmap_ = costmap_ros_->getCostmap();
   queue_ = std::make_shared<MapGridQueue>(*costmap_, *this);
+  {
+    std::lock_guard<std::mutex> guard(g_critics_mutex);
+    g_critics.push_back(this);
+  }
 
   // Always set to true, but can be overriden by subclasses
   stop_on_failure_ = true;
@@ -98,6 +113,7 @@ void MapGridCritic::setAsObstacle(unsigned int index)
 
 void MapGridCritic::reset()
 {
+  propagated_ = false;
   queue_->reset();
   cell_values_.resize(costmap_->getSizeInCellsX() * costmap_->getSizeInCellsY());
   obstacle_score_ = static_cast<double>(cell_values_.size());
@@ -114,6 +130,45 @@ void MapGridCritic::propogateManhattanDistances()
   }
 }
 
+void MapGridCritic::propagateManhattanDistances(const std::vector<unsigned int> & sources)
+{
+  std::lock_guard<std::mutex> guard(g_critics_mutex);
+  const unsigned int size_x = costmap_->getSizeInCellsX();
+  const unsigned int size_y = costmap_->getSizeInCellsY();
+  auto sameDistances = [&](const MapGridCritic & critic) {
+      return critic.propagated_ && critic.propagated_size_x_ == size_x &&
+             critic.propagated_size_y_ == size_y && critic.propagated_sources_ == sources;
+    };
+
+  if (sameDistances(*this)) {
+    return;
+  }
+
+  auto shared = std::find_if(
+    g_critics.begin(), g_critics.end(), [&](const MapGridCritic * critic) {
+      return critic != this && sameDistances(*critic);
+    });
+  if (shared != g_critics.end()) {
+    cell_values_ = (*shared)->cell_values_;
+    obstacle_score_ = (*shared)->obstacle_score_;
+    unreachable_score_ = (*shared)->unreachable_score_;
+  } else {
+    reset();
+    for (unsigned int index : sources) {
+      unsigned int x, y;
+      costmap_->indexToCells(index, x, y);
+      cell_values_[index] = 0.0;
+      queue_->enqueueCell(x, y);
+    }
+    propogateManhattanDistances();
+  }
+
+  propagated_sources_ = sources;
+  propagated_size_x_ = size_x;
+  propagated_size_y_ = size_y;
+  propagated_ = true;
+}
+
 double MapGridCritic::scoreTrajectory(const dwb_msgs::msg::Trajectory2D & traj)
 {
   double score = 0.0;
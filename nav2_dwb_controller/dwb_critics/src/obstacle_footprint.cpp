@@ -34,6 +34,9 @@
 
 #include "dwb_critics/obstacle_footprint.hpp"
 #include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
 #include <vector>
 #include "dwb_critics/line_iterator.hpp"
 #include "dwb_core/exceptions.hpp"
@@ -44,11 +47,39 @@ PLUGINLIB_EXPORT_CLASS(dwb_critics::ObstacleFootprintCritic, dwb_core::Trajector
 
 namespace dwb_critics
 {
+
+namespace
+{
+// Scratch of the sweeps of a thread, as trajectories may be scored concurrently
+struct SweepScratch
+{
+  // For each cell of the costmap, the stamp of the last sweep which looked up the cell
+  // in the upper 24 bits, and the cost it found in the lower 8 bits
+  std::vector<uint32_t> cells;
+  uint32_t stamp{0};
+  Footprint footprint;
+  // Cell index of each footprint point, for the current and the previous pose
+  std::vector<unsigned int> points, previous_points;
+};
+
+thread_local SweepScratch sweep_scratch;
+constexpr uint32_t max_sweep_stamp = 0xffffff;
+constexpr unsigned int off_grid = std::numeric_limits<unsigned int>::max();
+}  // namespace
+
 Footprint getOrientedFootprint(
   const geometry_msgs::msg::Pose2D & pose,
   const Footprint & footprint_spec)
 {
-  std::vector<geometry_msgs::msg::Point> oriented_footprint;
+  Footprint oriented_footprint;
+  getOrientedFootprint(pose, footprint_spec, oriented_footprint);
+  return oriented_footprint;
+}
+
+void getOrientedFootprint(
+  const geometry_msgs::msg::Pose2D & pose,
+  const Footprint & footprint_spec, Footprint & oriented_footprint)
+{
   oriented_footprint.resize(footprint_spec.size());
   double cos_th = cos(pose.theta);
   double sin_th = sin(pose.theta);
@@ -57,7 +88,6 @@ Footprint getOrientedFootprint(
     new_pt.x = pose.x + footprint_spec[i].x * cos_th - footprint_spec[i].y * sin_th;
     new_pt.y = pose.y + footprint_spec[i].x * sin_th + footprint_spec[i].y * cos_th;
   }
-  return oriented_footprint;
 }
 
 bool ObstacleFootprintCritic::prepare(
@@ -74,6 +104,71 @@ bool ObstacleFootprintCritic::prepare(
   return true;
 }
 
+double ObstacleFootprintCritic::scoreTrajectory(const dwb_msgs::msg::Trajectory2D & traj)
+{
+  SweepScratch & scratch = sweep_scratch;
+  const unsigned int size = costmap_->getSizeInCellsX() * costmap_->getSizeInCellsY();
+  if (scratch.cells.size() != size || scratch.stamp == max_sweep_stamp) {
+    scratch.cells.assign(size, 0);
+    scratch.stamp = 0;
+  }
+  const uint32_t stamp = ++scratch.stamp << 8;
+
+  // Same as scorePose for each edge of the footprint, in the same order, but looking
+  // up each cell of the sweep once
+  auto footprintCost = [&](const std::vector<unsigned int> & points) {
+      double footprint_cost = 0.0;
+      for (unsigned int i = 0; i < points.size(); ++i) {
+        const unsigned int start = points[i];
+        const unsigned int end = points[(i + 1) % points.size()];
+        if (start == off_grid || end == off_grid) {
+          throw dwb_core::
+                IllegalTrajectoryException(name_, "Footprint Goes Off Grid.");
+        }
+
+        unsigned int x0, y0, x1, y1;
+        costmap_->indexToCells(start, x0, y0);
+        costmap_->indexToCells(end, x1, y1);
+        for (LineIterator line(x0, y0, x1, y1); line.isValid(); line.advance()) {
+          const unsigned int index = costmap_->getIndex(line.getX(), line.getY());
+          uint32_t & cell = scratch.cells[index];
+          if ((cell & ~0xffu) != stamp) {
+            cell = stamp | static_cast<uint32_t>(pointCost(line.getX(), line.getY()));
+          }
+          footprint_cost = std::max(footprint_cost, static_cast<double>(cell & 0xffu));
+        }
+      }
+      return footprint_cost;
+    };
+
+  double score = 0.0;
+  double pose_score = 0.0;
+  scratch.previous_points.clear();
+  for (const geometry_msgs::msg::Pose2D & pose : traj.poses) {
+    unsigned int cell_x, cell_y;
+    if (!costmap_->worldToMap(pose.x, pose.y, cell_x, cell_y)) {
+      throw dwb_core::
+            IllegalTrajectoryException(name_, "Trajectory Goes Off Grid.");
+    }
+
+    getOrientedFootprint(pose, footprint_spec_, scratch.footprint);
+    scratch.points.resize(scratch.footprint.size());
+    for (unsigned int i = 0; i < scratch.footprint.size(); ++i) {
+      scratch.points[i] =
+        costmap_->worldToMap(scratch.footprint[i].x, scratch.footprint[i].y, cell_x, cell_y) ?
+        costmap_->getIndex(cell_x, cell_y) : off_grid;
+    }
+
+    // A footprint on the same cells as the previous pose has the same cost
+    if (scratch.points != scratch.previous_points) {
+      pose_score = footprintCost(scratch.points);
+      std::swap(scratch.points, scratch.previous_points);
+    }
+    score = static_cast<double>(sum_scores_) * score + pose_score;
+  }
+  return score;
+}
+
 double ObstacleFootprintCritic::scorePose(const geometry_msgs::msg::Pose2D & pose)
 {
   unsigned int cell_x, cell_y;
@@ -45,7 +45,7 @@ bool PathDistCritic::prepare(
   const geometry_msgs::msg::Pose2D &,
   const nav_2d_msgs::msg::Path2D & global_plan)
 {
-  reset();
+  sources_.clear();
   bool started_path = false;
 
   nav_2d_msgs::msg::Path2D adjusted_global_plan =
@@ -68,15 +68,17 @@ bool PathDistCritic::prepare(
         g_x, g_y, map_x,
         map_y) && costmap_->getCost(map_x, map_y) != nav2_costmap_2d::NO_INFORMATION)
     {
-      int index = costmap_->getIndex(map_x, map_y);
-      cell_values_[index] = 0.0;
-      queue_->enqueueCell(map_x, map_y);
+      unsigned int index = costmap_->getIndex(map_x, map_y);
+      if (sources_.empty() || sources_.back() != index) {
+        sources_.push_back(index);
+      }
       started_path = true;
     } else if (started_path) {
       break;
     }
   }
   if (!started_path) {
+    reset();
     RCLCPP_ERROR(
       rclcpp::get_logger("PathDistCritic"),
       "None of the %d first of %zu (%zu) points of the global plan were in "
@@ -85,7 +87,7 @@ bool PathDistCritic::prepare(
     return false;
   }
 
-  propogateManhattanDistances();
+  propagateManhattanDistances(sources_);
 
   return true;
 }
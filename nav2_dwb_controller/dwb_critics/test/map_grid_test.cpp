@@ -0,0 +1,119 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2024, Open Navigation LLC
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "rclcpp/rclcpp.hpp"
+#include "dwb_critics/goal_dist.hpp"
+#include "dwb_critics/path_dist.hpp"
+#include "nav2_costmap_2d/cost_values.hpp"
+
+// Plan along the row y = 2 of the costmap, from x = 0 to x = last_x
+nav_2d_msgs::msg::Path2D makePlan(unsigned int last_x)
+{
+  nav_2d_msgs::msg::Path2D plan;
+  for (unsigned int x = 0; x <= last_x; x++) {
+    geometry_msgs::msg::Pose2D pose;
+    pose.x = 0.1 * x + 0.05;
+    pose.y = 0.25;
+    plan.poses.push_back(pose);
+  }
+  return plan;
+}
+
+TEST(MapGrid, SharedDistances)
+{
+  auto node = nav2_util::LifecycleNode::make_shared("map_grid_tester");
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>("test_global_costmap");
+  costmap_ros->configure();
+  auto costmap = costmap_ros->getCostmap();
+  for (unsigned int x = 0; x < costmap->getSizeInCellsX(); x++) {
+    for (unsigned int y = 0; y < costmap->getSizeInCellsY(); y++) {
+      costmap->setCost(x, y, nav2_costmap_2d::FREE_SPACE);
+    }
+  }
+
+  auto critic = std::make_shared<dwb_critics::PathDistCritic>();
+  auto other_critic = std::make_shared<dwb_critics::PathDistCritic>();
+  auto goal_critic = std::make_shared<dwb_critics::GoalDistCritic>();
+  critic->initialize(node, "path", "ns", costmap_ros);
+  other_critic->initialize(node, "other_path", "ns", costmap_ros);
+  goal_critic->initialize(node, "goal", "ns", costmap_ros);
+
+  geometry_msgs::msg::Pose2D pose;
+  nav_2d_msgs::msg::Twist2D vel;
+  ASSERT_TRUE(critic->prepare(pose, vel, pose, makePlan(10)));
+  ASSERT_TRUE(other_critic->prepare(pose, vel, pose, makePlan(10)));
+  ASSERT_TRUE(goal_critic->prepare(pose, vel, pose, makePlan(10)));
+
+  // Manhattan distances to the path, and to its last pose
+  EXPECT_EQ(critic->getScore(5, 2), 0.0);
+  EXPECT_EQ(critic->getScore(5, 6), 4.0);
+  EXPECT_EQ(critic->getScore(14, 2), 4.0);
+  EXPECT_EQ(goal_critic->getScore(10, 5), 3.0);
+  EXPECT_EQ(goal_critic->getScore(5, 2), 5.0);
+
+  for (unsigned int x = 0; x < costmap->getSizeInCellsX(); x++) {
+    for (unsigned int y = 0; y < costmap->getSizeInCellsY(); y++) {
+      EXPECT_EQ(critic->getScore(x, y), other_critic->getScore(x, y));
+    }
+  }
+
+  // Distances are propagated again from a new plan, without changing the other critic
+  ASSERT_TRUE(critic->prepare(pose, vel, pose, makePlan(5)));
+  EXPECT_EQ(critic->getScore(10, 2), 5.0);
+  EXPECT_EQ(other_critic->getScore(10, 2), 0.0);
+
+  // And reused on the same plan
+  ASSERT_TRUE(critic->prepare(pose, vel, pose, makePlan(5)));
+  EXPECT_EQ(critic->getScore(10, 2), 5.0);
+  EXPECT_EQ(critic->getScore(5, 6), 4.0);
+}
+
+int main(int argc, char ** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  // initialize ROS
+  rclcpp::init(argc, argv);
+
+  bool all_successful = RUN_ALL_TESTS();
+
+  // shutdown ROS
+  rclcpp::shutdown();
+
+  return all_successful;
+}
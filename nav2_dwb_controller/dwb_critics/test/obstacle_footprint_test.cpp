@@ -176,6 +176,55 @@ TEST(ObstacleFootprint, Prepare)
   ASSERT_THROW(critic->scorePose(pose), dwb_core::IllegalTrajectoryException);
 }
 
+TEST(ObstacleFootprint, ScoreTrajectory)
+{
+  std::shared_ptr<dwb_critics::ObstacleFootprintCritic> critic =
+    std::make_shared<dwb_critics::ObstacleFootprintCritic>();
+
+  auto node = nav2_util::LifecycleNode::make_shared("costmap_tester");
+
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>("test_global_costmap");
+  costmap_ros->configure();
+
+  std::string name = "name";
+  std::string ns = "ns";
+  critic->initialize(node, name, ns, costmap_ros);
+
+  std::vector<geometry_msgs::msg::Point> footprint = {
+    getPoint(0.3, 0.2), getPoint(0.3, -0.2), getPoint(-0.3, -0.2), getPoint(-0.3, 0.2)};
+  costmap_ros->setRobotFootprint(footprint);
+  geometry_msgs::msg::Pose2D pose;
+  nav_2d_msgs::msg::Twist2D vel;
+  nav_2d_msgs::msg::Path2D global_plan;
+  ASSERT_TRUE(critic->prepare(pose, vel, pose, global_plan));
+
+  // Poses closer than a cell, so that consecutive footprints cover the same cells
+  dwb_msgs::msg::Trajectory2D traj;
+  for (unsigned int i = 0; i < 40; i++) {
+    pose.x = 1.0 + 0.025 * i;
+    pose.y = 2.5;
+    pose.theta = 0.01 * i;
+    traj.poses.push_back(pose);
+  }
+  auto costmap = costmap_ros->getCostmap();
+  costmap->setCost(16, 27, 50);
+  costmap->setCost(18, 23, 100);
+  costmap->setCost(26, 27, 75);
+
+  // Same as the last pose without summing the scores, as the sum of the poses otherwise
+  EXPECT_EQ(critic->scoreTrajectory(traj), critic->scorePose(traj.poses.back()));
+  EXPECT_EQ(critic->scoreTrajectory(traj), critic->scoreTrajectory(traj));
+
+  // An obstacle on the footprint of any pose makes the trajectory illegal
+  costmap->setCost(18, 23, nav2_costmap_2d::LETHAL_OBSTACLE);
+  ASSERT_THROW(critic->scoreTrajectory(traj), dwb_core::IllegalTrajectoryException);
+  costmap->setCost(18, 23, 100);
+  EXPECT_EQ(critic->scoreTrajectory(traj), critic->scorePose(traj.poses.back()));
+
+  traj.poses.back().x = costmap->getSizeInMetersX() - 0.1;
+  ASSERT_THROW(critic->scoreTrajectory(traj), dwb_core::IllegalTrajectoryException);
+}
+
 // todo: wilcobonestroo Add tests for other footprint shapes and costmaps.
 
 TEST(ObstacleFootprint, PointCost)
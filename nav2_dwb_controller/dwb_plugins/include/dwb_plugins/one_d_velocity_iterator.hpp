@@ -151,6 +151,16 @@ public:
     return_zero_now_ = false;
   }
 
+  /**
+   * @brief Get the lowest velocity reachable
+   */
+  double getMinVelocity() const {return min_vel_;}
+
+  /**
+   * @brief Get the highest velocity reachable
+   */
+  double getMaxVelocity() const {return max_vel_;}
+
   /**
    * If we have returned all the velocities for this iteration
    */
@@ -56,6 +56,7 @@ public:
   virtual void startNewIteration(const nav_2d_msgs::msg::Twist2D & current_velocity, double dt) = 0;
   virtual bool hasMoreTwists() = 0;
   virtual nav_2d_msgs::msg::Twist2D nextTwist() = 0;
+  virtual void setTwistScore(const nav_2d_msgs::msg::Twist2D & /*twist*/, double /*score*/) {}
 };
 }  // namespace dwb_plugins
 
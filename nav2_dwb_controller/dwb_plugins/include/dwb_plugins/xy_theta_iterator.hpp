@@ -37,6 +37,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "dwb_plugins/velocity_iterator.hpp"
 #include "dwb_plugins/one_d_velocity_iterator.hpp"
@@ -44,6 +45,16 @@
 
 namespace dwb_plugins
 {
+/**
+ * @class XYThetaIterator
+ * @brief Iterates over a grid of vx_samples x vy_samples x vtheta_samples twists
+ *
+ * With adaptive_sampling, a grid of coarse_vx_samples x coarse_vy_samples x
+ * coarse_vtheta_samples twists is returned first. Each of the refinement_levels levels then
+ * returns the neighbors of the refinement_best_k best twists scored so far on a grid of half
+ * the previous step, once the scores of all the twists returned before are reported. At most
+ * max_samples twists are returned in all, if positive.
+ */
 class XYThetaIterator : public VelocityIterator
 {
 public:
@@ -56,11 +67,37 @@ public:
   void startNewIteration(const nav_2d_msgs::msg::Twist2D & current_velocity, double dt) override;
   bool hasMoreTwists() override;
   nav_2d_msgs::msg::Twist2D nextTwist() override;
+  void setTwistScore(const nav_2d_msgs::msg::Twist2D & twist, double score) override;
 
 protected:
   virtual bool isValidVelocity();
   void iterateToValidVelocity();
+
+  /**
+   * @brief Queue the neighbors of the best twists scored for the next refinement level
+   * @return False if all levels or the sample budget are used up
+   */
+  bool queueRefinement();
+
+  /**
+   * @brief Queue a twist unless it is invalid, already sampled or beyond the sample budget
+   */
+  void queueSample(double x, double y, double theta);
+
   int vx_samples_, vy_samples_, vtheta_samples_;
+
+  bool adaptive_sampling_{false};
+  int coarse_vx_samples_, coarse_vy_samples_, coarse_vtheta_samples_;
+  int refinement_best_k_, refinement_levels_, max_samples_;
+
+  // Twists of the iteration in the order returned, and the scores reported for them
+  std::vector<nav_2d_msgs::msg::Twist2D> samples_;
+  std::vector<double> scores_;
+  size_t next_sample_{0};
+  int level_{0};
+  // Reachable range and coarse step of each axis
+  double min_x_, max_x_, min_y_, max_y_, min_theta_, max_theta_;
+  double step_x_, step_y_, step_theta_;
   KinematicsHandler::Ptr kinematics_handler_;
 
   std::shared_ptr<OneDVelocityIterator> x_it_, y_it_, th_it_;
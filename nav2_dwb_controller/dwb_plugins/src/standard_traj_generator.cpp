@@ -114,6 +114,12 @@ nav_2d_msgs::msg::Twist2D StandardTrajectoryGenerator::nextTwist()
   return velocity_iterator_->nextTwist();
 }
 
+void StandardTrajectoryGenerator::setTwistScore(
+  const nav_2d_msgs::msg::Twist2D & twist, double score)
+{
+  velocity_iterator_->setTwistScore(twist, score);
+}
+
 std::vector<double> StandardTrajectoryGenerator::getTimeSteps(
   const nav_2d_msgs::msg::Twist2D & cmd_vel)
 {
@@ -149,6 +155,19 @@ dwb_msgs::msg::Trajectory2D StandardTrajectoryGenerator::generateTrajectory(
   const nav_2d_msgs::msg::Twist2D & cmd_vel)
 {
   dwb_msgs::msg::Trajectory2D traj;
+  generateTrajectory(start_pose, start_vel, cmd_vel, traj);
+  return traj;
+}
+
+void StandardTrajectoryGenerator::generateTrajectory(
+  const geometry_msgs::msg::Pose2D & start_pose,
+  const nav_2d_msgs::msg::Twist2D & start_vel,
+  const nav_2d_msgs::msg::Twist2D & cmd_vel,
+  dwb_msgs::msg::Trajectory2D & traj)
+{
+  // Clearing keeps the capacity of the poses and offsets of the previous trajectory
+  traj.poses.clear();
+  traj.time_offsets.clear();
   traj.velocity = cmd_vel;
   //  simulate the trajectory
   geometry_msgs::msg::Pose2D pose = start_pose;
@@ -172,8 +191,6 @@ dwb_msgs::msg::Trajectory2D StandardTrajectoryGenerator::generateTrajectory(
     traj.poses.push_back(pose);
     traj.time_offsets.push_back(rclcpp::Duration::from_seconds(running_time));
   }
-
-  return traj;
 }
 
 /**
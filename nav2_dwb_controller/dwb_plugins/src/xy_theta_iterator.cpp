@@ -34,9 +34,11 @@
 
 #include "dwb_plugins/xy_theta_iterator.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "nav_2d_utils/parameters.hpp"
 #include "nav2_util/node_utils.hpp"
@@ -63,6 +65,36 @@ void XYThetaIterator::initialize(
   nh->get_parameter(plugin_name + ".vx_samples", vx_samples_);
   nh->get_parameter(plugin_name + ".vy_samples", vy_samples_);
   nh->get_parameter(plugin_name + ".vtheta_samples", vtheta_samples_);
+
+  nav2_util::declare_parameter_if_not_declared(
+    nh,
+    plugin_name + ".adaptive_sampling", rclcpp::ParameterValue(false));
+  nav2_util::declare_parameter_if_not_declared(
+    nh,
+    plugin_name + ".coarse_vx_samples", rclcpp::ParameterValue(5));
+  nav2_util::declare_parameter_if_not_declared(
+    nh,
+    plugin_name + ".coarse_vy_samples", rclcpp::ParameterValue(3));
+  nav2_util::declare_parameter_if_not_declared(
+    nh,
+    plugin_name + ".coarse_vtheta_samples", rclcpp::ParameterValue(5));
+  nav2_util::declare_parameter_if_not_declared(
+    nh,
+    plugin_name + ".refinement_best_k", rclcpp::ParameterValue(3));
+  nav2_util::declare_parameter_if_not_declared(
+    nh,
+    plugin_name + ".refinement_levels", rclcpp::ParameterValue(2));
+  nav2_util::declare_parameter_if_not_declared(
+    nh,
+    plugin_name + ".max_samples", rclcpp::ParameterValue(0));
+
+  nh->get_parameter(plugin_name + ".adaptive_sampling", adaptive_sampling_);
+  nh->get_parameter(plugin_name + ".coarse_vx_samples", coarse_vx_samples_);
+  nh->get_parameter(plugin_name + ".coarse_vy_samples", coarse_vy_samples_);
+  nh->get_parameter(plugin_name + ".coarse_vtheta_samples", coarse_vtheta_samples_);
+  nh->get_parameter(plugin_name + ".refinement_best_k", refinement_best_k_);
+  nh->get_parameter(plugin_name + ".refinement_levels", refinement_levels_);
+  nh->get_parameter(plugin_name + ".max_samples", max_samples_);
 }
 
 void XYThetaIterator::startNewIteration(
@@ -70,24 +102,50 @@ void XYThetaIterator::startNewIteration(
   double dt)
 {
   KinematicParameters kinematics = kinematics_handler_->getKinematics();
+  const int x_samples = adaptive_sampling_ ? coarse_vx_samples_ : vx_samples_;
+  const int y_samples = adaptive_sampling_ ? coarse_vy_samples_ : vy_samples_;
+  const int theta_samples = adaptive_sampling_ ? coarse_vtheta_samples_ : vtheta_samples_;
   x_it_ = std::make_shared<OneDVelocityIterator>(
     current_velocity.x,
     kinematics.getMinX(), kinematics.getMaxX(),
     kinematics.getAccX(), kinematics.getDecelX(),
-    dt, vx_samples_);
+    dt, x_samples);
   y_it_ = std::make_shared<OneDVelocityIterator>(
     current_velocity.y,
     kinematics.getMinY(), kinematics.getMaxY(),
     kinematics.getAccY(), kinematics.getDecelY(),
-    dt, vy_samples_);
+    dt, y_samples);
   th_it_ = std::make_shared<OneDVelocityIterator>(
     current_velocity.theta,
     kinematics.getMinTheta(), kinematics.getMaxTheta(),
     kinematics.getAccTheta(), kinematics.getDecelTheta(),
-    dt, vtheta_samples_);
+    dt, theta_samples);
   if (!isValidVelocity()) {
     iterateToValidVelocity();
   }
+  if (!adaptive_sampling_) {
+    return;
+  }
+
+  min_x_ = x_it_->getMinVelocity();
+  max_x_ = x_it_->getMaxVelocity();
+  min_y_ = y_it_->getMinVelocity();
+  max_y_ = y_it_->getMaxVelocity();
+  min_theta_ = th_it_->getMinVelocity();
+  max_theta_ = th_it_->getMaxVelocity();
+  step_x_ = (max_x_ - min_x_) / (std::max(2, x_samples) - 1);
+  step_y_ = (max_y_ - min_y_) / (std::max(2, y_samples) - 1);
+  step_theta_ = (max_theta_ - min_theta_) / (std::max(2, theta_samples) - 1);
+
+  // The coarse grid is the grid of the dense iteration with fewer samples
+  samples_.clear();
+  scores_.clear();
+  next_sample_ = 0;
+  level_ = 0;
+  while (!x_it_->isFinished()) {
+    queueSample(x_it_->getVelocity(), y_it_->getVelocity(), th_it_->getVelocity());
+    iterateToValidVelocity();
+  }
 }
 
 bool XYThetaIterator::isValidVelocity()
@@ -98,11 +156,28 @@ bool XYThetaIterator::isValidVelocity()
 
 bool XYThetaIterator::hasMoreTwists()
 {
-  return x_it_ && !x_it_->isFinished();
+  if (!adaptive_sampling_) {
+    return x_it_ && !x_it_->isFinished();
+  }
+
+  if (next_sample_ < samples_.size()) {
+    return true;
+  }
+  // A level refines around the best twists, so it waits for the scores of all the previous ones
+  while (scores_.size() == samples_.size() && queueRefinement()) {
+    if (next_sample_ < samples_.size()) {
+      return true;
+    }
+  }
+  return false;
 }
 
 nav_2d_msgs::msg::Twist2D XYThetaIterator::nextTwist()
 {
+  if (adaptive_sampling_) {
+    return samples_[next_sample_++];
+  }
+
   nav_2d_msgs::msg::Twist2D velocity;
   velocity.x = x_it_->getVelocity();
   velocity.y = y_it_->getVelocity();
@@ -116,7 +191,7 @@ nav_2d_msgs::msg::Twist2D XYThetaIterator::nextTwist()
 void XYThetaIterator::iterateToValidVelocity()
 {
   bool valid = false;
-  while (!valid && hasMoreTwists()) {
+  while (!valid && !x_it_->isFinished()) {
     ++(*th_it_);
     if (th_it_->isFinished()) {
       th_it_->reset();
@@ -130,4 +205,73 @@ void XYThetaIterator::iterateToValidVelocity()
   }
 }
 
+void XYThetaIterator::setTwistScore(const nav_2d_msgs::msg::Twist2D & /*twist*/, double score)
+{
+  if (adaptive_sampling_ && scores_.size() < next_sample_) {
+    scores_.push_back(score);
+  }
+}
+
+bool XYThetaIterator::queueRefinement()
+{
+  if (level_ >= refinement_levels_ ||
+    (max_samples_ > 0 && samples_.size() >= static_cast<size_t>(max_samples_)))
+  {
+    return false;
+  }
+  level_++;
+
+  // The best legal twists scored so far, lower scores being better
+  std::vector<size_t> best;
+  for (size_t i = 0; i < scores_.size(); i++) {
+    if (scores_[i] >= 0.0) {
+      best.push_back(i);
+    }
+  }
+  const size_t k = std::min(best.size(), static_cast<size_t>(std::max(0, refinement_best_k_)));
+  std::partial_sort(
+    best.begin(), best.begin() + k, best.end(),
+    [this](size_t a, size_t b) {return scores_[a] < scores_[b];});
+
+  // Their neighbors on a grid of half the step of the previous level
+  const double scale = std::ldexp(1.0, -level_);
+  for (size_t n = 0; n < k; n++) {
+    const nav_2d_msgs::msg::Twist2D center = samples_[best[n]];
+    for (int dx = -1; dx <= 1; dx++) {
+      for (int dy = -1; dy <= 1; dy++) {
+        for (int dtheta = -1; dtheta <= 1; dtheta++) {
+          const double theta = center.theta + dtheta * step_theta_ * scale;
+          queueSample(
+            std::min(max_x_, std::max(min_x_, center.x + dx * step_x_ * scale)),
+            std::min(max_y_, std::max(min_y_, center.y + dy * step_y_ * scale)),
+            std::min(max_theta_, std::max(min_theta_, theta)));
+        }
+      }
+    }
+  }
+  return true;
+}
+
+void XYThetaIterator::queueSample(double x, double y, double theta)
+{
+  if ((max_samples_ > 0 && samples_.size() >= static_cast<size_t>(max_samples_)) ||
+    !kinematics_handler_->getKinematics().isValidSpeed(x, y, theta))
+  {
+    return;
+  }
+  for (const auto & sample : samples_) {
+    if (std::fabs(sample.x - x) < EPSILON && std::fabs(sample.y - y) < EPSILON &&
+      std::fabs(sample.theta - theta) < EPSILON)
+    {
+      return;
+    }
+  }
+
+  nav_2d_msgs::msg::Twist2D sample;
+  sample.x = x;
+  sample.y = y;
+  sample.theta = theta;
+  samples_.push_back(sample);
+}
+
 }  // namespace dwb_plugins
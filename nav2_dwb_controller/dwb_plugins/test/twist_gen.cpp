@@ -293,6 +293,71 @@ TEST(VelocityIterator, nonzero)
     0.24622144504490268, 0.0, 0.1);
 }
 
+// A smooth score around a twist off the sample grids, illegal at low speeds
+double targetScore(const nav_2d_msgs::msg::Twist2D & twist)
+{
+  if (twist.x < 0.05) {
+    return -1.0;
+  }
+  return std::pow(twist.x - 0.331, 2) + std::pow(twist.y - 0.023, 2) +
+         0.3 * std::pow(twist.theta - 0.373, 2);
+}
+
+// Iterate over the twists reporting their scores, as the local planner does
+double bestTargetScore(StandardTrajectoryGenerator & gen, unsigned int & count)
+{
+  double best = -1.0;
+  count = 0;
+  gen.startNewIteration(zero);
+  while (gen.hasMoreTwists()) {
+    nav_2d_msgs::msg::Twist2D twist = gen.nextTwist();
+    double score = targetScore(twist);
+    if (score >= 0.0 && (best < 0.0 || score < best)) {
+      best = score;
+    }
+    gen.setTwistScore(twist, score);
+    count++;
+  }
+  return best;
+}
+
+TEST(VelocityIterator, adaptive_gen)
+{
+  auto dense_nh = makeTestNode("dense_gen");
+  StandardTrajectoryGenerator dense_gen;
+  dense_gen.initialize(dense_nh, "dwb");
+  auto nh = makeTestNode("adaptive_gen", {rclcpp::Parameter("dwb.adaptive_sampling", true)});
+  StandardTrajectoryGenerator gen;
+  gen.initialize(nh, "dwb");
+
+  // Without scores, only the coarse grid is sampled, over the same limits
+  std::vector<nav_2d_msgs::msg::Twist2D> twists = gen.getTwists(zero);
+  EXPECT_LT(twists.size(), 5u * 3u * 5u);
+  checkLimits(twists, 0.0, 0.55, -0.1, 0.1, -1.0, 1.0, 0.55, 0.1, 0.4);
+
+  unsigned int dense_count, count;
+  double dense_best = bestTargetScore(dense_gen, dense_count);
+  double best = bestTargetScore(gen, count);
+  EXPECT_EQ(dense_count, 1926u);
+  EXPECT_LT(count, dense_count / 4);
+  EXPECT_GE(best, 0.0);
+  EXPECT_LE(best, dense_best);
+}
+
+TEST(VelocityIterator, adaptive_gen_budget)
+{
+  auto nh = makeTestNode(
+    "adaptive_gen_budget", {
+    rclcpp::Parameter("dwb.adaptive_sampling", true),
+    rclcpp::Parameter("dwb.max_samples", 60)});
+  StandardTrajectoryGenerator gen;
+  gen.initialize(nh, "dwb");
+
+  unsigned int count;
+  EXPECT_GE(bestTargetScore(gen, count), 0.0);
+  EXPECT_EQ(count, 60u);
+}
+
 void matchPose(const geometry_msgs::msg::Pose2D & a, const geometry_msgs::msg::Pose2D & b)
 {
   EXPECT_DOUBLE_EQ(a.x, b.x);
@@ -343,6 +408,32 @@ TEST(TrajectoryGenerator, basic)
   matchPose(res.poses[n - 1], DEFAULT_SIM_TIME * forward.x, 0, 0);
 }
 
+TEST(TrajectoryGenerator, reused_trajectory)
+{
+  auto nh = makeTestNode("reused_trajectory", {rclcpp::Parameter("dwb.linear_granularity", 0.5)});
+  StandardTrajectoryGenerator gen;
+  gen.initialize(nh, "dwb");
+  dwb_msgs::msg::Trajectory2D expected = gen.generateTrajectory(origin, forward, forward);
+
+  // Generating into a longer trajectory replaces all of its poses
+  nav_2d_msgs::msg::Twist2D fast = forward;
+  fast.x = 2.0 * forward.x;
+  dwb_msgs::msg::Trajectory2D res;
+  gen.generateTrajectory(origin, fast, fast, res);
+  ASSERT_GT(res.poses.size(), expected.poses.size());
+  gen.generateTrajectory(origin, forward, forward, res);
+
+  matchTwist(res.velocity, forward);
+  ASSERT_EQ(res.poses.size(), expected.poses.size());
+  ASSERT_EQ(res.time_offsets.size(), expected.time_offsets.size());
+  for (unsigned int i = 0; i < res.poses.size(); i++) {
+    matchPose(res.poses[i], expected.poses[i]);
+  }
+  for (unsigned int i = 0; i < res.time_offsets.size(); i++) {
+    EXPECT_DOUBLE_EQ(durationToSec(res.time_offsets[i]), durationToSec(expected.time_offsets[i]));
+  }
+}
+
 TEST(TrajectoryGenerator, basic_no_last_point)
 {
   auto nh = makeTestNode(
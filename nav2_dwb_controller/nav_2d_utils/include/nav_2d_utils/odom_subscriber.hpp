@@ -35,7 +35,10 @@
 #ifndef NAV_2D_UTILS__ODOM_SUBSCRIBER_HPP_
 #define NAV_2D_UTILS__ODOM_SUBSCRIBER_HPP_
 
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -44,26 +47,35 @@
 #include "nav2_util/lifecycle_node.hpp"
 #include "rclcpp/rclcpp.hpp"
 #include "nav2_util/node_utils.hpp"
+#include "nav2_util/seqlock.hpp"
 
 namespace nav_2d_utils
 {
 
 /**
  * @class OdomSubscriber
- * Wrapper for some common odometry operations. Subscribes to the topic with a mutex.
+ * Wrapper for some common odometry operations. Subscribes to the topic with a mutex,
+ * the latest velocity and its recent history being read without it.
  */
 class OdomSubscriber
 {
 public:
+  // Largest number of odometry velocities kept for interpolation
+  static constexpr size_t kMaxHistorySize = 32;
+
   /**
    * @brief Constructor that subscribes to an Odometry topic
    *
    * @param nh NodeHandle for creating subscriber
    * @param default_topic Name of the topic that will be loaded of the odom_topic param is not set.
+   * @param history_size Number of the latest velocities kept to interpolate them with
+   * getTwistAt, up to kMaxHistorySize, none by default
    */
   explicit OdomSubscriber(
     nav2_util::LifecycleNode::SharedPtr nh,
-    std::string default_topic = "odom")
+    std::string default_topic = "odom",
+    size_t history_size = 0)
+  : history_size_(std::min(history_size, kMaxHistorySize))
   {
     nav2_util::declare_parameter_if_not_declared(
       nh, "odom_topic", rclcpp::ParameterValue(default_topic));
@@ -77,10 +89,92 @@ public:
       std::bind(&OdomSubscriber::odomCallback, this, std::placeholders::_1));
   }
 
-  inline nav_2d_msgs::msg::Twist2D getTwist() {return odom_vel_.velocity;}
-  inline nav_2d_msgs::msg::Twist2DStamped getTwistStamped() {return odom_vel_;}
+  /**
+   * @brief Get the latest velocity, without waiting for the odometry callback
+   * @return Latest velocity
+   */
+  inline nav_2d_msgs::msg::Twist2D getTwist() const {return toTwist(latest_.load());}
+
+  /**
+   * @brief Get the latest velocity with the header of its odometry
+   * @return Latest stamped velocity
+   */
+  inline nav_2d_msgs::msg::Twist2DStamped getTwistStamped()
+  {
+    std::lock_guard<std::mutex> lock(odom_mutex_);
+    return odom_vel_;
+  }
+
+  /**
+   * @brief Get the velocity at a time, linearly interpolated between the velocities
+   * kept in the history, without waiting for the odometry callback. Times out of the
+   * history get its oldest or latest velocity, and the latest velocity is returned
+   * if no history is kept.
+   * @param stamp Time of the velocity, such as the time of the robot pose
+   * @return Velocity at the time
+   */
+  nav_2d_msgs::msg::Twist2D getTwistAt(const rclcpp::Time & stamp) const
+  {
+    if (history_size_ == 0) {
+      return getTwist();
+    }
+
+    const History history = history_.load();
+    if (history.size == 0) {
+      return getTwist();
+    }
+
+    // Walk the ring from the oldest velocity to the first one not before the time
+    const int64_t time = stamp.nanoseconds();
+    const size_t oldest = (history.next + kMaxHistorySize - history.size) % kMaxHistorySize;
+    const TwistSample * previous = nullptr;
+    for (size_t i = 0; i != history.size; i++) {
+      const TwistSample & sample = history.samples[(oldest + i) % kMaxHistorySize];
+      if (sample.stamp >= time) {
+        if (previous == nullptr || sample.stamp == previous->stamp) {
+          return toTwist(sample);
+        }
+        const double ratio =
+          static_cast<double>(time - previous->stamp) / (sample.stamp - previous->stamp);
+        TwistSample interpolated;
+        interpolated.stamp = time;
+        interpolated.x = previous->x + ratio * (sample.x - previous->x);
+        interpolated.y = previous->y + ratio * (sample.y - previous->y);
+        interpolated.theta = previous->theta + ratio * (sample.theta - previous->theta);
+        return toTwist(interpolated);
+      }
+      previous = &sample;
+    }
+    return toTwist(*previous);
+  }
 
 protected:
+  // Velocity of an odometry message, stamped in nanoseconds
+  struct TwistSample
+  {
+    int64_t stamp;
+    double x;
+    double y;
+    double theta;
+  };
+
+  // Ring of the latest velocities, next being the index of the next one to write
+  struct History
+  {
+    std::array<TwistSample, kMaxHistorySize> samples;
+    size_t size;
+    size_t next;
+  };
+
+  static nav_2d_msgs::msg::Twist2D toTwist(const TwistSample & sample)
+  {
+    nav_2d_msgs::msg::Twist2D twist;
+    twist.x = sample.x;
+    twist.y = sample.y;
+    twist.theta = sample.theta;
+    return twist;
+  }
+
   void odomCallback(const nav_msgs::msg::Odometry::SharedPtr msg)
   {
     // ROS_INFO_ONCE("odom received!");
@@ -89,11 +183,29 @@ protected:
     odom_vel_.velocity.x = msg->twist.twist.linear.x;
     odom_vel_.velocity.y = msg->twist.twist.linear.y;
     odom_vel_.velocity.theta = msg->twist.twist.angular.z;
+
+    const TwistSample sample{rclcpp::Time(msg->header.stamp).nanoseconds(),
+      odom_vel_.velocity.x, odom_vel_.velocity.y, odom_vel_.velocity.theta};
+    latest_.store(sample);
+
+    if (history_size_ != 0) {
+      // Forget the velocities beyond the size of the history
+      writer_history_.samples[writer_history_.next] = sample;
+      writer_history_.next = (writer_history_.next + 1) % kMaxHistorySize;
+      writer_history_.size = std::min(writer_history_.size + 1, history_size_);
+      history_.store(writer_history_);
+    }
   }
 
   rclcpp::Subscription<nav_msgs::msg::Odometry>::SharedPtr odom_sub_;
   nav_2d_msgs::msg::Twist2DStamped odom_vel_;
   std::mutex odom_mutex_;
+
+  // Copies of the velocities for readers not to wait on the mutex
+  size_t history_size_;
+  nav2_util::SeqLock<TwistSample> latest_{TwistSample{0, 0.0, 0.0, 0.0}};
+  History writer_history_{};
+  nav2_util::SeqLock<History> history_{History{}};
 };
 
 }  // namespace nav_2d_utils
@@ -0,0 +1,101 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2024, Open Navigation LLC
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "nav_2d_utils/odom_subscriber.hpp"
+
+class OdomSubscriberWrapper : public nav_2d_utils::OdomSubscriber
+{
+public:
+  OdomSubscriberWrapper(nav2_util::LifecycleNode::SharedPtr node, size_t history_size)
+  : nav_2d_utils::OdomSubscriber(node, "odom", history_size)
+  {
+  }
+
+  void addOdometry(double seconds, double x, double theta)
+  {
+    auto msg = std::make_shared<nav_msgs::msg::Odometry>();
+    msg->header.frame_id = "odom";
+    msg->header.stamp = rclcpp::Time(static_cast<int64_t>(seconds * 1e9));
+    msg->twist.twist.linear.x = x;
+    msg->twist.twist.angular.z = theta;
+    odomCallback(msg);
+  }
+};
+
+TEST(OdomSubscriber, LatestTwist)
+{
+  auto node = std::make_shared<nav2_util::LifecycleNode>("odom_subscriber_test");
+  OdomSubscriberWrapper odom_sub(node, 0);
+  EXPECT_EQ(odom_sub.getTwist().x, 0.0);
+
+  odom_sub.addOdometry(1.0, 0.5, 0.1);
+  odom_sub.addOdometry(2.0, 1.0, 0.2);
+  EXPECT_EQ(odom_sub.getTwist().x, 1.0);
+  EXPECT_EQ(odom_sub.getTwist().theta, 0.2);
+  EXPECT_EQ(odom_sub.getTwistStamped().header.frame_id, "odom");
+  EXPECT_EQ(odom_sub.getTwistStamped().velocity.x, 1.0);
+
+  // Without history, the latest twist is returned at any time
+  EXPECT_EQ(odom_sub.getTwistAt(rclcpp::Time(static_cast<int64_t>(1.5e9))).x, 1.0);
+}
+
+TEST(OdomSubscriber, InterpolatedTwist)
+{
+  auto node = std::make_shared<nav2_util::LifecycleNode>("odom_subscriber_test");
+  OdomSubscriberWrapper odom_sub(node, 3);
+  for (int i = 0; i != 5; i++) {
+    odom_sub.addOdometry(1.0 + i * 0.1, i * 1.0, -i * 0.5);
+  }
+
+  // Velocities at 1.2s, 1.3s and 1.4s are kept
+  auto twist = odom_sub.getTwistAt(rclcpp::Time(static_cast<int64_t>(1.25e9)));
+  EXPECT_NEAR(twist.x, 2.5, 1e-6);
+  EXPECT_NEAR(twist.theta, -1.25, 1e-6);
+  EXPECT_NEAR(odom_sub.getTwistAt(rclcpp::Time(static_cast<int64_t>(1.3e9))).x, 3.0, 1e-6);
+  EXPECT_NEAR(odom_sub.getTwistAt(rclcpp::Time(static_cast<int64_t>(1.0e9))).x, 2.0, 1e-6);
+  EXPECT_NEAR(odom_sub.getTwistAt(rclcpp::Time(static_cast<int64_t>(2.0e9))).x, 4.0, 1e-6);
+}
+
+int main(int argc, char ** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  rclcpp::init(argc, argv);
+  int result = RUN_ALL_TESTS();
+  rclcpp::shutdown();
+  return result;
+}
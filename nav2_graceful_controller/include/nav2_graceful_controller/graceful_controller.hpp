@@ -121,10 +121,14 @@ protected:
    * @brief Simulate trajectory calculating in every step the new velocity command based on
    * a new curvature value and checking for collisions.
    *
+   * The whole trajectory is generated before any collision check, and its poses are then
+   * checked coarse to fine, so that a collision far along the trajectory is found without
+   * checking every pose before it.
+   *
    * @param robot_pose Robot pose
    * @param motion_target Motion target point
    * @param costmap_transform Transform between global and local costmap
-   * @param trajectory Simulated trajectory
+   * @param trajectory Simulated trajectory in the robot frame, reused between calls
    * @param backward Flag to indicate if the robot is moving backward
    * @return true if the trajectory is collision free, false otherwise
    */
@@ -132,7 +136,7 @@ protected:
     const geometry_msgs::msg::PoseStamped & robot_pose,
     const geometry_msgs::msg::PoseStamped & motion_target,
     const geometry_msgs::msg::TransformStamped & costmap_transform,
-    nav_msgs::msg::Path & trajectory,
+    std::vector<geometry_msgs::msg::Pose> & trajectory,
     const bool & backward);
 
   /**
@@ -173,6 +177,8 @@ protected:
   std::unique_ptr<nav2_graceful_controller::PathHandler> path_handler_;
   std::unique_ptr<nav2_graceful_controller::ParameterHandler> param_handler_;
   std::unique_ptr<nav2_graceful_controller::SmoothControlLaw> control_law_;
+  // Poses of the last simulated trajectory, kept to reuse their storage
+  std::vector<geometry_msgs::msg::Pose> local_trajectory_;
 };
 
 }  // namespace nav2_graceful_controller
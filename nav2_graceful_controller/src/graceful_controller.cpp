@@ -199,13 +199,21 @@ geometry_msgs::msg::TwistStamped GracefulController::computeVelocityCommands(
     return cmd_vel;
   }
 
-  // Generate and publish local plan for debugging / visualization
-  nav_msgs::msg::Path local_plan;
-  if (!simulateTrajectory(pose, motion_target, costmap_transform, local_plan, reversing)) {
+  if (!simulateTrajectory(pose, motion_target, costmap_transform, local_trajectory_, reversing)) {
     throw nav2_core::NoValidControl("Collision detected in the trajectory");
   }
-  local_plan.header = transformed_plan.header;
-  local_plan_pub_->publish(local_plan);
+
+  // Publish local plan for debugging / visualization
+  if (local_plan_pub_->get_subscription_count() > 0) {
+    auto local_plan = std::make_unique<nav_msgs::msg::Path>();
+    local_plan->header = transformed_plan.header;
+    local_plan->poses.resize(local_trajectory_.size());
+    for (size_t i = 0; i < local_trajectory_.size(); ++i) {
+      local_plan->poses[i].header.frame_id = costmap_ros_->getBaseFrameID();
+      local_plan->poses[i].pose = local_trajectory_[i];
+    }
+    local_plan_pub_->publish(std::move(local_plan));
+  }
 
   return cmd_vel;
 }
@@ -262,7 +270,7 @@ bool GracefulController::simulateTrajectory(
   const geometry_msgs::msg::PoseStamped & robot_pose,
   const geometry_msgs::msg::PoseStamped & motion_target,
   const geometry_msgs::msg::TransformStamped & costmap_transform,
-  nav_msgs::msg::Path & trajectory, const bool & backward)
+  std::vector<geometry_msgs::msg::Pose> & trajectory, const bool & backward)
 {
   // Check for collision before moving
   if (inCollision(
@@ -273,10 +281,10 @@ bool GracefulController::simulateTrajectory(
   }
 
   // First pose
-  geometry_msgs::msg::PoseStamped next_pose;
-  next_pose.header.frame_id = costmap_ros_->getBaseFrameID();
-  next_pose.pose.orientation.w = 1.0;
-  trajectory.poses.push_back(next_pose);
+  geometry_msgs::msg::Pose next_pose;
+  next_pose.orientation.w = 1.0;
+  trajectory.clear();
+  trajectory.push_back(next_pose);
 
   double distance = std::numeric_limits<double>::max();
   double resolution_ = costmap_ros_->getCostmap()->getResolution();
@@ -290,25 +298,35 @@ bool GracefulController::simulateTrajectory(
   // Generate path
   do{
     // Apply velocities to calculate next pose
-    next_pose.pose = control_law_->calculateNextPose(
-      dt, motion_target.pose, next_pose.pose, backward);
-
-    // Add the pose to the trajectory for visualization
-    trajectory.poses.push_back(next_pose);
-
-    // Check for collision
-    geometry_msgs::msg::PoseStamped global_pose;
-    tf2::doTransform(next_pose, global_pose, costmap_transform);
-    if (inCollision(
-        global_pose.pose.position.x, global_pose.pose.position.y,
-        tf2::getYaw(global_pose.pose.orientation)))
-    {
-      return false;
-    }
+    next_pose = control_law_->calculateNextPose(dt, motion_target.pose, next_pose, backward);
+    trajectory.push_back(next_pose);
 
     // Check if we reach the goal
-    distance = nav2_util::geometry_utils::euclidean_distance(motion_target.pose, next_pose.pose);
-  }while(distance > resolution_ && trajectory.poses.size() < max_iter);
+    distance = nav2_util::geometry_utils::euclidean_distance(motion_target.pose, next_pose);
+  }while(distance > resolution_ && trajectory.size() < max_iter);
+
+  // Check for collisions coarse to fine: every pose at the largest stride first, then the
+  // poses halfway between those already checked, visiting each pose once
+  tf2::Transform transform;
+  tf2::fromMsg(costmap_transform.transform, transform);
+  const double transform_yaw = tf2::getYaw(transform.getRotation());
+  size_t stride = 1;
+  while (2 * stride < trajectory.size()) {
+    stride *= 2;
+  }
+  for (size_t step = stride; step > 0; step /= 2) {
+    const size_t increment = (step == stride) ? step : 2 * step;
+    for (size_t i = step; i < trajectory.size(); i += increment) {
+      const auto & local_pose = trajectory[i];
+      const tf2::Vector3 position = transform *
+        tf2::Vector3(local_pose.position.x, local_pose.position.y, 0.0);
+      if (inCollision(
+          position.x(), position.y(), tf2::getYaw(local_pose.orientation) + transform_yaw))
+      {
+        return false;
+      }
+    }
+  }
 
   return true;
 }
@@ -90,7 +90,7 @@ public:
     const geometry_msgs::msg::PoseStamped & robot_pose,
     const geometry_msgs::msg::PoseStamped & motion_target,
     const geometry_msgs::msg::TransformStamped & costmap_transform,
-    nav_msgs::msg::Path & trajectory, const bool & backward)
+    std::vector<geometry_msgs::msg::Pose> & trajectory, const bool & backward)
   {
     return nav2_graceful_controller::GracefulController::simulateTrajectory(
       robot_pose, motion_target, costmap_transform, trajectory, backward);
@@ -1039,6 +1039,60 @@ TEST(GracefulControllerTest, computeVelocityCommandRegular) {
   EXPECT_EQ(cmd_vel.twist.angular.z, 0.0);
 }
 
+TEST(GracefulControllerTest, simulateTrajectoryCollision) {
+  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("testGraceful");
+  auto tf = std::make_shared<tf2_ros::Buffer>(node->get_clock());
+
+  // Create a costmap of 10x10 meters
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>("test_costmap");
+  auto results = costmap_ros->set_parameters(
+    {rclcpp::Parameter("global_frame", "test_global_frame"),
+      rclcpp::Parameter("robot_base_frame", "test_robot_frame"),
+      rclcpp::Parameter("width", 10),
+      rclcpp::Parameter("height", 10),
+      rclcpp::Parameter("resolution", 0.1)});
+  for (const auto & result : results) {
+    EXPECT_TRUE(result.successful) << result.reason;
+  }
+  costmap_ros->on_configure(rclcpp_lifecycle::State());
+
+  // Create controller
+  auto controller = std::make_shared<GMControllerFixture>();
+  controller->configure(node, "test", tf, costmap_ros);
+  controller->activate();
+
+  // Robot at (1, 1) in the global frame, with a target 2 meters ahead
+  geometry_msgs::msg::PoseStamped robot_pose;
+  robot_pose.header.frame_id = "test_global_frame";
+  robot_pose.pose.position.x = 1.0;
+  robot_pose.pose.position.y = 1.0;
+  robot_pose.pose.orientation.w = 1.0;
+  geometry_msgs::msg::TransformStamped costmap_transform;
+  costmap_transform.transform.translation.x = 1.0;
+  costmap_transform.transform.translation.y = 1.0;
+  costmap_transform.transform.rotation.w = 1.0;
+  geometry_msgs::msg::PoseStamped motion_target;
+  motion_target.pose.position.x = 2.0;
+  motion_target.pose.orientation.w = 1.0;
+
+  // Free costmap: the trajectory reaches the target
+  std::vector<geometry_msgs::msg::Pose> trajectory;
+  EXPECT_TRUE(
+    controller->simulateTrajectory(
+      robot_pose, motion_target, costmap_transform, trajectory, false));
+  ASSERT_GT(trajectory.size(), 2u);
+  EXPECT_NEAR(trajectory.back().position.x, 2.0, 0.1);
+  EXPECT_NEAR(trajectory.back().position.y, 0.0, 0.1);
+
+  // Obstacle along the trajectory, the storage of the trajectory is reused
+  const size_t capacity = trajectory.capacity();
+  costmap_ros->getCostmap()->setCost(25, 10, nav2_costmap_2d::LETHAL_OBSTACLE);
+  EXPECT_FALSE(
+    controller->simulateTrajectory(
+      robot_pose, motion_target, costmap_transform, trajectory, false));
+  EXPECT_EQ(trajectory.capacity(), capacity);
+}
+
 TEST(GracefulControllerTest, computeVelocityCommandRegularBackwards) {
   auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("testGraceful");
   auto tf = std::make_shared<tf2_ros::Buffer>(node->get_clock());
@@ -16,15 +16,21 @@
 #ifndef NAV2_LIFECYCLE_MANAGER__LIFECYCLE_MANAGER_HPP_
 #define NAV2_LIFECYCLE_MANAGER__LIFECYCLE_MANAGER_HPP_
 
+#include <chrono>
+#include <cstdint>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <unordered_map>
 #include <vector>
 
+#include "nav2_util/heartbeat_registry.hpp"
 #include "nav2_util/lifecycle_service_client.hpp"
+#include "nav2_util/memory_registry.hpp"
 #include "nav2_util/node_thread.hpp"
+#include "nav2_util/thread_pool.hpp"
 #include "rclcpp/rclcpp.hpp"
 #include "std_srvs/srv/empty.hpp"
 #include "nav2_msgs/srv/manage_lifecycle_nodes.hpp"
@@ -183,6 +189,17 @@ protected:
    */
   void checkBondConnections();
 
+  /**
+   * @brief Whether the bond or in-process heartbeat of a node is alive, if it has one
+   */
+  bool isConnectionAlive(const std::string & node_name);
+
+  /**
+   * @brief Get the fully qualified name of a managed node, as registered
+   * in the nav2_util::HeartbeatRegistry
+   */
+  std::string getFullyQualifiedName(const std::string & node_name) const;
+
   // Support function for checking if bond connections come back after respawn
   /**
    * @ brief Support function for checking on bond connections
@@ -198,10 +215,30 @@ protected:
     std::uint8_t transition);
 
   /**
-   * @brief For each node in the map, transition to the new target state
+   * @brief For each node in the map, transition to the new target state.
+   * The levels are transitioned in order for bringup transitions and in reverse
+   * order otherwise, the nodes of a level concurrently.
    */
   bool changeStateForAllNodes(std::uint8_t transition, bool hard_change = false);
 
+  /**
+   * @brief Transition the nodes of a level to the new target state concurrently
+   * @return true if all of them reached it
+   */
+  bool changeStateForLevel(
+    const std::vector<std::string> & level, std::uint8_t transition, bool hard_change);
+
+  /**
+   * @brief Group the managed nodes by bring-up level from the node_levels parameter
+   */
+  void setNodeLevels(const std::vector<int64_t> & node_levels);
+
+  /**
+   * @brief Log the time each node took to configure and activate in the last startup
+   * @param duration Duration of the whole startup
+   */
+  void reportStartupTimes(const rclcpp::Duration & duration);
+
   // Convenience function to highlight the output on the console
   /**
    * @brief Helper function to highlight the output on the console
@@ -214,6 +251,11 @@ protected:
    */
   void CreateDiagnostic(diagnostic_updater::DiagnosticStatusWrapper & stat);
 
+  /**
+   * @brief function to report the current and peak bytes of the tracked buffers
+   */
+  void CreateMemoryDiagnostic(diagnostic_updater::DiagnosticStatusWrapper & stat);
+
   /**
    * Register our preshutdown callback for this Node's rcl Context.
    * The callback fires before this Node's Context is shutdown.
@@ -236,6 +278,18 @@ protected:
   // A map of all nodes to check bond connection
   std::map<std::string, std::shared_ptr<bond::Bond>> bond_map_;
 
+  // In-process heartbeat of a node composed in the same process, replacing its bond
+  struct Heartbeat
+  {
+    std::shared_ptr<const nav2_util::HeartbeatRegistry::Counter> counter;
+    uint64_t last_count;
+    std::chrono::steady_clock::time_point last_beat;
+  };
+  // A map of the nodes to check by in-process heartbeat rather than bond
+  std::map<std::string, Heartbeat> heartbeat_map_;
+  // Whether to check the nodes composed in the same process by in-process heartbeat
+  bool in_process_heartbeat_;
+
   // A map of all nodes to be controlled
   std::map<std::string, std::shared_ptr<nav2_util::LifecycleServiceClient>> node_map_;
 
@@ -247,6 +301,20 @@ protected:
   // The names of the nodes to be managed, in the order of desired bring-up
   std::vector<std::string> node_names_;
 
+  // The nodes grouped by bring-up level, in the order of the levels. The nodes of a level
+  // do not depend on each other and are transitioned concurrently.
+  std::vector<std::vector<std::string>> node_levels_;
+  // Threads transitioning the nodes of a level together with the calling thread
+  std::unique_ptr<nav2_util::ThreadPool> transition_pool_;
+
+  // Time in seconds each node took for its last transitions, by node and transition
+  std::map<std::string, std::map<std::uint8_t, double>> transition_durations_;
+  std::mutex transition_durations_mutex_;
+  // Guards the bond map while the nodes of a level are activated or deactivated concurrently
+  std::mutex bond_mutex_;
+  // Duration in seconds of the last successful startup, guarded by transition_durations_mutex_
+  double startup_duration_{0.0};
+
   // Whether to automatically start up the system
   bool autostart_;
   bool attempt_respawn_reconnection_;
@@ -15,7 +15,10 @@
 
 #include "nav2_lifecycle_manager/lifecycle_manager.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <cstdio>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -44,6 +47,8 @@ LifecycleManager::LifecycleManager(const rclcpp::NodeOptions & options)
   declare_parameter("bond_timeout", 4.0);
   declare_parameter("bond_respawn_max_duration", 10.0);
   declare_parameter("attempt_respawn_reconnection", true);
+  declare_parameter("node_levels", std::vector<int64_t>());
+  declare_parameter("in_process_heartbeat", false);
 
   registerRclPreshutdownCallback();
 
@@ -60,6 +65,17 @@ LifecycleManager::LifecycleManager(const rclcpp::NodeOptions & options)
 
   get_parameter("attempt_respawn_reconnection", attempt_respawn_reconnection_);
 
+  setNodeLevels(get_parameter("node_levels").as_integer_array());
+
+  // Let the managed nodes composed in this process beat a counter in memory
+  // rather than create a bond
+  get_parameter("in_process_heartbeat", in_process_heartbeat_);
+  if (in_process_heartbeat_ && bond_timeout_.count() > 0) {
+    for (const auto & node_name : node_names_) {
+      nav2_util::HeartbeatRegistry::manage(getFullyQualifiedName(node_name));
+    }
+  }
+
   callback_group_ = create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive, false);
   manager_srv_ = create_service<ManageLifecycleNodes>(
     get_name() + std::string("/manage_nodes"),
@@ -107,12 +123,18 @@ LifecycleManager::LifecycleManager(const rclcpp::NodeOptions & options)
     });
   diagnostics_updater_.setHardwareID("Nav2");
   diagnostics_updater_.add("Nav2 Health", this, &LifecycleManager::CreateDiagnostic);
+  diagnostics_updater_.add("Nav2 Memory", this, &LifecycleManager::CreateMemoryDiagnostic);
 }
 
 LifecycleManager::~LifecycleManager()
 {
   RCLCPP_INFO(get_logger(), "Destroying %s", get_name());
   service_thread_.reset();
+  if (in_process_heartbeat_ && bond_timeout_.count() > 0) {
+    for (const auto & node_name : get_parameter("node_names").as_string_array()) {
+      nav2_util::HeartbeatRegistry::unmanage(getFullyQualifiedName(node_name));
+    }
+  }
 }
 
 void
@@ -189,6 +211,65 @@ LifecycleManager::CreateDiagnostic(diagnostic_updater::DiagnosticStatusWrapper &
       break;
   }
   stat.summary(error_level, message);
+
+  std::lock_guard<std::mutex> lock(transition_durations_mutex_);
+  if (startup_duration_ > 0.0) {
+    stat.addf("Startup (s)", "%.3f", startup_duration_);
+  }
+  for (const auto & node_durations : transition_durations_) {
+    const auto & durations = node_durations.second;
+    auto configure = durations.find(Transition::TRANSITION_CONFIGURE);
+    auto activate = durations.find(Transition::TRANSITION_ACTIVATE);
+    if (configure != durations.end() && activate != durations.end()) {
+      stat.addf(
+        node_durations.first + " startup (s)", "%.3f", configure->second + activate->second);
+    }
+  }
+}
+
+void
+LifecycleManager::CreateMemoryDiagnostic(diagnostic_updater::DiagnosticStatusWrapper & stat)
+{
+  // Only the buffers of the nodes composed in the process of the lifecycle manager
+  stat.summary(diagnostic_msgs::msg::DiagnosticStatus::OK, "Tracked buffers of this process");
+  for (const auto & usage : nav2_util::MemoryRegistry::snapshot()) {
+    if (usage.peak == 0) {
+      continue;
+    }
+    stat.addf(usage.tag + " current (MiB)", "%.2f", usage.current / 1048576.0);
+    stat.addf(usage.tag + " peak (MiB)", "%.2f", usage.peak / 1048576.0);
+  }
+}
+
+void
+LifecycleManager::setNodeLevels(const std::vector<int64_t> & node_levels)
+{
+  node_levels_.clear();
+  if (node_levels.empty() || node_levels.size() != node_names_.size()) {
+    if (!node_levels.empty()) {
+      RCLCPP_WARN(
+        get_logger(), "node_levels has %zu entries for %zu nodes, "
+        "transitioning the nodes one at a time in the order of node_names.",
+        node_levels.size(), node_names_.size());
+    }
+    for (const auto & node_name : node_names_) {
+      node_levels_.push_back({node_name});
+    }
+    return;
+  }
+
+  // Nodes of the same level keep their order in node_names
+  std::map<int64_t, std::vector<std::string>> levels;
+  for (size_t i = 0; i < node_names_.size(); i++) {
+    levels[node_levels[i]].push_back(node_names_[i]);
+  }
+
+  size_t max_level_size = 1;
+  for (auto & level : levels) {
+    max_level_size = std::max(max_level_size, level.second.size());
+    node_levels_.push_back(std::move(level.second));
+  }
+  transition_pool_ = std::make_unique<nav2_util::ThreadPool>(max_level_size - 1);
 }
 
 void
@@ -217,14 +298,34 @@ LifecycleManager::createBondConnection(const std::string & node_name)
     std::chrono::duration_cast<std::chrono::nanoseconds>(bond_timeout_).count();
   const double timeout_s = timeout_ns / 1e9;
 
-  if (bond_map_.find(node_name) == bond_map_.end() && bond_timeout_.count() > 0.0) {
-    bond_map_[node_name] =
-      std::make_shared<bond::Bond>("bond", node_name, shared_from_this());
-    bond_map_[node_name]->setHeartbeatTimeout(timeout_s);
-    bond_map_[node_name]->setHeartbeatPeriod(0.10);
-    bond_map_[node_name]->start();
+  // Nodes composed in this process beat a counter in memory when asked to
+  if (in_process_heartbeat_ && bond_timeout_.count() > 0) {
+    auto counter = nav2_util::HeartbeatRegistry::get(getFullyQualifiedName(node_name));
+    if (counter) {
+      std::lock_guard<std::mutex> lock(bond_mutex_);
+      heartbeat_map_[node_name] = {counter, counter->load(), std::chrono::steady_clock::now()};
+      RCLCPP_INFO(
+        get_logger(), "Server %s connected with in-process heartbeat.", node_name.c_str());
+      return true;
+    }
+  }
+
+  std::shared_ptr<bond::Bond> bond;
+  {
+    std::lock_guard<std::mutex> lock(bond_mutex_);
+    if (bond_map_.find(node_name) == bond_map_.end() && bond_timeout_.count() > 0.0) {
+      bond = std::make_shared<bond::Bond>("bond", node_name, shared_from_this());
+      bond_map_[node_name] = bond;
+    }
+  }
+
+  // Wait for the bond without holding the map, as nodes of a level are activated concurrently
+  if (bond) {
+    bond->setHeartbeatTimeout(timeout_s);
+    bond->setHeartbeatPeriod(0.10);
+    bond->start();
     if (
-      !bond_map_[node_name]->waitUntilFormed(
+      !bond->waitUntilFormed(
         rclcpp::Duration(rclcpp::Duration::from_nanoseconds(timeout_ns / 2))))
     {
       RCLCPP_ERROR(
@@ -243,19 +344,29 @@ LifecycleManager::createBondConnection(const std::string & node_name)
 bool
 LifecycleManager::changeStateForNode(const std::string & node_name, std::uint8_t transition)
 {
-  message(transition_label_map_[transition] + node_name);
+  message(transition_label_map_.at(transition) + node_name);
 
-  if (!node_map_[node_name]->change_state(transition) ||
-    !(node_map_[node_name]->get_state() == transition_state_map_[transition]))
+  const auto start = std::chrono::steady_clock::now();
+  auto & client = node_map_.at(node_name);
+  if (!client->change_state(transition) ||
+    !(client->get_state() == transition_state_map_.at(transition)))
   {
     RCLCPP_ERROR(get_logger(), "Failed to change state for node: %s", node_name.c_str());
     return false;
   }
 
+  {
+    std::lock_guard<std::mutex> lock(transition_durations_mutex_);
+    transition_durations_[node_name][transition] =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
   if (transition == Transition::TRANSITION_ACTIVATE) {
     return createBondConnection(node_name);
   } else if (transition == Transition::TRANSITION_DEACTIVATE) {
+    std::lock_guard<std::mutex> lock(bond_mutex_);
     bond_map_.erase(node_name);
+    heartbeat_map_.erase(node_name);
   }
 
   return true;
@@ -268,36 +379,79 @@ LifecycleManager::changeStateForAllNodes(std::uint8_t transition, bool hard_chan
   if (transition == Transition::TRANSITION_CONFIGURE ||
     transition == Transition::TRANSITION_ACTIVATE)
   {
-    for (auto & node_name : node_names_) {
-      try {
-        if (!changeStateForNode(node_name, transition) && !hard_change) {
-          return false;
-        }
-      } catch (const std::runtime_error & e) {
-        RCLCPP_ERROR(
-          get_logger(),
-          "Failed to change state for node: %s. Exception: %s.", node_name.c_str(), e.what());
+    for (auto & level : node_levels_) {
+      if (!changeStateForLevel(level, transition, hard_change)) {
         return false;
       }
     }
   } else {
-    std::vector<std::string>::reverse_iterator rit;
-    for (rit = node_names_.rbegin(); rit != node_names_.rend(); ++rit) {
+    for (auto rit = node_levels_.rbegin(); rit != node_levels_.rend(); ++rit) {
+      if (!changeStateForLevel(*rit, transition, hard_change)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool
+LifecycleManager::changeStateForLevel(
+  const std::vector<std::string> & level, std::uint8_t transition, bool hard_change)
+{
+  // Each node has its own lifecycle service clients, so that they can be called concurrently
+  std::vector<char> changed(level.size(), false);
+  std::vector<char> failed_with_exception(level.size(), false);
+  auto change_state = [&](size_t i) {
       try {
-        if (!changeStateForNode(*rit, transition) && !hard_change) {
-          return false;
-        }
+        changed[i] = changeStateForNode(level[i], transition);
       } catch (const std::runtime_error & e) {
         RCLCPP_ERROR(
           get_logger(),
-          "Failed to change state for node: %s. Exception: %s.", (*rit).c_str(), e.what());
+          "Failed to change state for node: %s. Exception: %s.", level[i].c_str(), e.what());
+        failed_with_exception[i] = true;
+      }
+    };
+
+  if (level.size() == 1 || !transition_pool_) {
+    for (size_t i = 0; i < level.size(); i++) {
+      change_state(i);
+      if (failed_with_exception[i] || (!changed[i] && !hard_change)) {
         return false;
       }
     }
+    return true;
+  }
+
+  transition_pool_->parallelFor(level.size(), change_state);
+  for (size_t i = 0; i < level.size(); i++) {
+    if (failed_with_exception[i] || (!changed[i] && !hard_change)) {
+      return false;
+    }
   }
   return true;
 }
 
+void
+LifecycleManager::reportStartupTimes(const rclcpp::Duration & duration)
+{
+  std::lock_guard<std::mutex> lock(transition_durations_mutex_);
+  startup_duration_ = duration.seconds();
+  std::string report = "Managed nodes started up in " + std::to_string(startup_duration_) + " s:";
+
+  for (size_t i = 0; i < node_levels_.size(); i++) {
+    for (const auto & node_name : node_levels_[i]) {
+      auto & durations = transition_durations_[node_name];
+      char line[256];
+      snprintf(
+        line, sizeof(line), "\n  [level %zu] %s: configure %.3f s, activate %.3f s",
+        i, node_name.c_str(), durations[Transition::TRANSITION_CONFIGURE],
+        durations[Transition::TRANSITION_ACTIVATE]);
+      report += line;
+    }
+  }
+  RCLCPP_INFO(get_logger(), "%s", report.c_str());
+}
+
 void
 LifecycleManager::shutdownAllNodes()
 {
@@ -312,6 +466,7 @@ bool
 LifecycleManager::startup()
 {
   message("Starting managed nodes bringup...");
+  const auto start = std::chrono::steady_clock::now();
   if (!changeStateForAllNodes(Transition::TRANSITION_CONFIGURE) ||
     !changeStateForAllNodes(Transition::TRANSITION_ACTIVATE))
   {
@@ -319,6 +474,7 @@ LifecycleManager::startup()
     managed_nodes_state_ = NodeState::UNKNOWN;
     return false;
   }
+  reportStartupTimes(rclcpp::Duration(std::chrono::steady_clock::now() - start));
   message("Managed nodes are active");
   managed_nodes_state_ = NodeState::ACTIVE;
   createBondTimer();
@@ -459,8 +615,10 @@ LifecycleManager::onRclPreshutdown()
    */
   service_thread_.reset();
   node_names_.clear();
+  node_levels_.clear();
   node_map_.clear();
   bond_map_.clear();
+  heartbeat_map_.clear();
 }
 
 void
@@ -476,7 +634,7 @@ LifecycleManager::registerRclPreshutdownCallback()
 void
 LifecycleManager::checkBondConnections()
 {
-  if (!isActive() || !rclcpp::ok() || bond_map_.empty()) {
+  if (!isActive() || !rclcpp::ok() || (bond_map_.empty() && heartbeat_map_.empty())) {
     return;
   }
 
@@ -485,7 +643,7 @@ LifecycleManager::checkBondConnections()
       return;
     }
 
-    if (bond_map_[node_name]->isBroken()) {
+    if (!isConnectionAlive(node_name)) {
       message(
         std::string(
           "Have not received a heartbeat from " + node_name + "."));
@@ -499,6 +657,7 @@ LifecycleManager::checkBondConnections()
       reset(true);  // hard reset to transition all still active down
       // if a server crashed, it won't get cleared due to failed transition, clear manually
       bond_map_.clear();
+      heartbeat_map_.clear();
 
       // Initialize the bond respawn timer to check if server comes back online
       // after a failure, within a maximum timeout period.
@@ -513,6 +672,35 @@ LifecycleManager::checkBondConnections()
   }
 }
 
+bool
+LifecycleManager::isConnectionAlive(const std::string & node_name)
+{
+  auto heartbeat = heartbeat_map_.find(node_name);
+  if (heartbeat != heartbeat_map_.end()) {
+    const uint64_t count = heartbeat->second.counter->load(std::memory_order_relaxed);
+    const auto now = std::chrono::steady_clock::now();
+    if (count != heartbeat->second.last_count) {
+      heartbeat->second.last_count = count;
+      heartbeat->second.last_beat = now;
+      return true;
+    }
+    return now - heartbeat->second.last_beat <= bond_timeout_;
+  }
+
+  auto bond = bond_map_.find(node_name);
+  return bond == bond_map_.end() || !bond->second->isBroken();
+}
+
+std::string
+LifecycleManager::getFullyQualifiedName(const std::string & node_name) const
+{
+  if (!node_name.empty() && node_name.front() == '/') {
+    return node_name;
+  }
+  const std::string ns = get_namespace();
+  return (ns.back() == '/' ? ns : ns + "/") + node_name;
+}
+
 void
 LifecycleManager::checkBondRespawnConnection()
 {
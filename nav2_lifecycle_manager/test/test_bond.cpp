@@ -16,6 +16,7 @@
 #include <memory>
 #include <chrono>
 #include <string>
+#include <vector>
 #include "rclcpp/rclcpp.hpp"
 #include "nav2_util/lifecycle_node.hpp"
 #include "nav2_util/node_thread.hpp"
@@ -108,6 +109,16 @@ public:
     return bondAllocated() ? !bond_->isBroken() : false;
   }
 
+  bool heartbeatAllocated()
+  {
+    return heartbeat_ ? true : false;
+  }
+
+  void stallHeartbeat()
+  {
+    heartbeat_timer_->cancel();
+  }
+
   std::string state;
   bool enable_bond;
 };
@@ -183,6 +194,49 @@ TEST(LifecycleBondTest, NEGATIVE)
     client.is_active(std::chrono::nanoseconds(1000000000)));
 }
 
+TEST(LifecycleBondTest, STALLED_HEARTBEAT)
+{
+  // A lifecycle manager composed with the node, which beats a counter in memory
+  rclcpp::NodeOptions options;
+  options.arguments({"--ros-args", "-r", "__node:=heartbeat_manager"});
+  options.parameter_overrides(
+    {{"node_names", std::vector<std::string>({"heartbeat_tester"})},
+      {"autostart", false}, {"bond_timeout", 1.0}, {"attempt_respawn_reconnection", false},
+      {"in_process_heartbeat", true}});
+  auto manager = std::make_shared<nav2_lifecycle_manager::LifecycleManager>(options);
+  nav2_util::NodeThread manager_thread(manager->get_node_base_interface());
+
+  auto node = std::make_shared<rclcpp::Node>("heartbeat_manager_service_client");
+  nav2_lifecycle_manager::LifecycleManagerClient client("heartbeat_manager", node);
+
+  auto fixture = TestFixture(true, "heartbeat_tester");
+  auto heartbeat_tester = fixture.lf_node_;
+
+  EXPECT_TRUE(client.startup());
+  EXPECT_TRUE(heartbeat_tester->heartbeatAllocated());
+  EXPECT_FALSE(heartbeat_tester->bondAllocated());
+
+  // A beating counter keeps the connection alive past the bond timeout
+  rclcpp::Rate(0.5).sleep();
+  EXPECT_EQ(
+    nav2_lifecycle_manager::SystemStatus::ACTIVE,
+    client.is_active(std::chrono::nanoseconds(1000000000)));
+
+  // A stalled counter is only reported as a lost connection once the bond timeout elapsed
+  heartbeat_tester->stallHeartbeat();
+  rclcpp::Rate(2.5).sleep();
+  EXPECT_EQ(
+    nav2_lifecycle_manager::SystemStatus::ACTIVE,
+    client.is_active(std::chrono::nanoseconds(1000000000)));
+  EXPECT_EQ(heartbeat_tester->getState(), "activated");
+
+  rclcpp::Rate(0.5).sleep();
+  EXPECT_EQ(
+    nav2_lifecycle_manager::SystemStatus::INACTIVE,
+    client.is_active(std::chrono::nanoseconds(1000000000)));
+  EXPECT_EQ(heartbeat_tester->getState(), "cleaned up");
+}
+
 int main(int argc, char ** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -13,11 +13,17 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <memory>
 #include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 #include "rclcpp/rclcpp.hpp"
 #include "rclcpp_lifecycle/lifecycle_node.hpp"
 #include "nav2_util/node_thread.hpp"
+#include "nav2_lifecycle_manager/lifecycle_manager.hpp"
 #include "nav2_lifecycle_manager/lifecycle_manager_client.hpp"
 
 using CallbackReturn = rclcpp_lifecycle::node_interfaces::LifecycleNodeInterface::CallbackReturn;
@@ -114,6 +120,205 @@ TEST(LifecycleClientTest, WithoutFixture)
     client.is_active(std::chrono::nanoseconds(1000)));
 }
 
+// The transitions of the nodes of a test, with the time each one started and ended
+class TransitionLog
+{
+public:
+  struct Record
+  {
+    std::string node;
+    std::string transition;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point end;
+  };
+
+  void add(const Record & record)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    records_.push_back(record);
+  }
+
+  // The records of a transition, in the order the transitions ended
+  std::vector<Record> get(const std::string & transition)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<Record> records;
+    for (const auto & record : records_) {
+      if (record.transition == transition) {
+        records.push_back(record);
+      }
+    }
+    return records;
+  }
+
+  std::vector<std::string> nodes(const std::string & transition)
+  {
+    std::vector<std::string> names;
+    for (const auto & record : get(transition)) {
+      names.push_back(record.node);
+    }
+    return names;
+  }
+
+private:
+  std::mutex mutex_;
+  std::vector<Record> records_;
+};
+
+// Whether two transitions ran at the same time
+bool overlap(const TransitionLog::Record & a, const TransitionLog::Record & b)
+{
+  return a.start < b.end && b.start < a.end;
+}
+
+// Logs its transitions, each taking a while so that concurrent transitions overlap
+class LoggingLifecycleNode : public rclcpp_lifecycle::LifecycleNode
+{
+public:
+  LoggingLifecycleNode(
+    const std::string & name, std::shared_ptr<TransitionLog> log, bool fail_configure)
+  : rclcpp_lifecycle::LifecycleNode(name), log_(log), fail_configure_(fail_configure) {}
+
+  CallbackReturn on_configure(const rclcpp_lifecycle::State & /*state*/) override
+  {
+    return log("configure", fail_configure_ ? CallbackReturn::FAILURE : CallbackReturn::SUCCESS);
+  }
+
+  CallbackReturn on_activate(const rclcpp_lifecycle::State & /*state*/) override
+  {
+    return log("activate", CallbackReturn::SUCCESS);
+  }
+
+  CallbackReturn on_deactivate(const rclcpp_lifecycle::State & /*state*/) override
+  {
+    return log("deactivate", CallbackReturn::SUCCESS);
+  }
+
+  CallbackReturn on_cleanup(const rclcpp_lifecycle::State & /*state*/) override
+  {
+    return log("cleanup", CallbackReturn::SUCCESS);
+  }
+
+  CallbackReturn on_shutdown(const rclcpp_lifecycle::State & /*state*/) override
+  {
+    return log("shutdown", CallbackReturn::SUCCESS);
+  }
+
+private:
+  CallbackReturn log(const std::string & transition, CallbackReturn result)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    log_->add({get_name(), transition, start, std::chrono::steady_clock::now()});
+    return result;
+  }
+
+  std::shared_ptr<TransitionLog> log_;
+  bool fail_configure_;
+};
+
+// A lifecycle manager composed with the nodes it manages, each spun on its own thread
+class LevelsFixture
+{
+public:
+  LevelsFixture(
+    const std::string & manager_name, const std::vector<std::string> & node_names,
+    const std::vector<int64_t> & node_levels, const std::string & failing_node = "")
+  : log_(std::make_shared<TransitionLog>())
+  {
+    for (const auto & node_name : node_names) {
+      auto node = std::make_shared<LoggingLifecycleNode>(
+        node_name, log_, node_name == failing_node);
+      node_threads_.push_back(
+        std::make_unique<nav2_util::NodeThread>(node->get_node_base_interface()));
+      nodes_.push_back(node);
+    }
+
+    rclcpp::NodeOptions options;
+    options.arguments({"--ros-args", "-r", "__node:=" + manager_name});
+    options.parameter_overrides(
+      {{"node_names", node_names}, {"node_levels", node_levels},
+        {"autostart", false}, {"bond_timeout", 0.0}});
+    manager_ = std::make_shared<nav2_lifecycle_manager::LifecycleManager>(options);
+    manager_thread_ = std::make_unique<nav2_util::NodeThread>(manager_->get_node_base_interface());
+
+    client_node_ = std::make_shared<rclcpp::Node>(manager_name + "_client");
+    client_ = std::make_unique<nav2_lifecycle_manager::LifecycleManagerClient>(
+      manager_name, client_node_);
+  }
+
+  std::shared_ptr<TransitionLog> log_;
+  std::vector<std::shared_ptr<LoggingLifecycleNode>> nodes_;
+  std::vector<std::unique_ptr<nav2_util::NodeThread>> node_threads_;
+  std::shared_ptr<nav2_lifecycle_manager::LifecycleManager> manager_;
+  std::unique_ptr<nav2_util::NodeThread> manager_thread_;
+  rclcpp::Node::SharedPtr client_node_;
+  std::unique_ptr<nav2_lifecycle_manager::LifecycleManagerClient> client_;
+};
+
+TEST(LifecycleManagerLevelsTest, NodesOfALevelTransitionTogether)
+{
+  LevelsFixture fix("levels_manager", {"level_a", "level_b", "level_c"}, {0, 1, 0});
+  EXPECT_TRUE(fix.client_->startup(std::chrono::seconds(10)));
+
+  for (const std::string transition : {"configure", "activate"}) {
+    auto records = fix.log_->get(transition);
+    ASSERT_EQ(records.size(), 3u);
+    // level_a and level_c share level 0, and level_b waits for both of them
+    EXPECT_TRUE(overlap(records[0], records[1]));
+    EXPECT_EQ(records[2].node, "level_b");
+    EXPECT_GE(records[2].start, std::max(records[0].end, records[1].end));
+  }
+
+  EXPECT_TRUE(fix.client_->shutdown(std::chrono::seconds(10)));
+}
+
+TEST(LifecycleManagerLevelsTest, WrongSizeOfLevelsTransitionsOneAtATime)
+{
+  LevelsFixture fix("fallback_manager", {"fallback_a", "fallback_b", "fallback_c"}, {0, 0});
+  EXPECT_TRUE(fix.client_->startup(std::chrono::seconds(10)));
+
+  for (const std::string transition : {"configure", "activate"}) {
+    auto records = fix.log_->get(transition);
+    ASSERT_EQ(records.size(), 3u);
+    EXPECT_EQ(
+      fix.log_->nodes(transition),
+      std::vector<std::string>({"fallback_a", "fallback_b", "fallback_c"}));
+    EXPECT_GE(records[1].start, records[0].end);
+    EXPECT_GE(records[2].start, records[1].end);
+  }
+
+  EXPECT_TRUE(fix.client_->shutdown(std::chrono::seconds(10)));
+}
+
+TEST(LifecycleManagerLevelsTest, ShutdownInReverseOrderOfLevels)
+{
+  LevelsFixture fix("reverse_manager", {"reverse_a", "reverse_b", "reverse_c"}, {0, 1, 2});
+  EXPECT_TRUE(fix.client_->startup(std::chrono::seconds(10)));
+  EXPECT_TRUE(fix.client_->shutdown(std::chrono::seconds(10)));
+
+  const std::vector<std::string> reverse({"reverse_c", "reverse_b", "reverse_a"});
+  EXPECT_EQ(fix.log_->nodes("deactivate"), reverse);
+  EXPECT_EQ(fix.log_->nodes("cleanup"), reverse);
+  EXPECT_EQ(fix.log_->nodes("shutdown"), reverse);
+}
+
+TEST(LifecycleManagerLevelsTest, FailingNodeOfALevelAbortsBringup)
+{
+  LevelsFixture fix(
+    "failing_manager", {"failing_a", "failing_b", "failing_c"}, {0, 0, 1}, "failing_b");
+  EXPECT_FALSE(fix.client_->startup(std::chrono::seconds(10)));
+
+  // failing_a is configured along with failing_b, and the next level is not brought up
+  auto configured = fix.log_->nodes("configure");
+  std::sort(configured.begin(), configured.end());
+  EXPECT_EQ(configured, std::vector<std::string>({"failing_a", "failing_b"}));
+  EXPECT_TRUE(fix.log_->get("activate").empty());
+  EXPECT_NE(
+    nav2_lifecycle_manager::SystemStatus::ACTIVE,
+    fix.client_->is_active(std::chrono::seconds(1)));
+}
+
 int main(int argc, char ** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,94 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_MAP_SERVER__MAP_CACHE_HPP_
+#define NAV2_MAP_SERVER__MAP_CACHE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "nav_msgs/msg/occupancy_grid.hpp"
+
+namespace nav2_map_server
+{
+
+/**
+ * @class nav2_map_server::MapCache
+ * @brief Least recently used cache of decoded maps, by the name of their YAML file, so
+ * that switching between them doesn't read and decode them again. The data of the maps
+ * can be kept run-length encoded, occupancy grids being made of long runs of free,
+ * unknown or occupied cells.
+ */
+class MapCache
+{
+public:
+  /**
+   * @brief A constructor for nav2_map_server::MapCache
+   * @param capacity Number of maps kept, 0 to keep none
+   * @param compress Whether to keep the data of the maps run-length encoded
+   */
+  MapCache(size_t capacity, bool compress);
+
+  /**
+   * @brief Get a map, making it the most recently used
+   * @param yaml_file Name of the YAML file of the map
+   * @param map Output map
+   * @return bool true if the map is cached
+   */
+  bool get(const std::string & yaml_file, nav_msgs::msg::OccupancyGrid & map);
+
+  /**
+   * @brief Cache a map as the most recently used, evicting the least recently used
+   * map when full
+   * @param yaml_file Name of the YAML file of the map
+   * @param map Map to cache
+   */
+  void put(const std::string & yaml_file, const nav_msgs::msg::OccupancyGrid & map);
+
+  /**
+   * @brief Remove all the maps
+   */
+  void clear();
+
+  /**
+   * @brief Get the number of maps cached
+   * @return Number of maps
+   */
+  size_t size() const {return maps_.size();}
+
+protected:
+  struct CachedMap
+  {
+    std::string yaml_file;
+    // The map, without its data if compressed
+    nav_msgs::msg::OccupancyGrid map;
+    // Runs of the data of a compressed map, as their values and lengths
+    std::vector<int8_t> run_values;
+    std::vector<uint32_t> run_lengths;
+  };
+
+  size_t capacity_;
+  bool compress_;
+  // Maps from the most to the least recently used
+  std::list<CachedMap> maps_;
+  std::unordered_map<std::string, std::list<CachedMap>::iterator> index_;
+};
+
+}  // namespace nav2_map_server
+
+#endif  // NAV2_MAP_SERVER__MAP_CACHE_HPP_
@@ -21,6 +21,7 @@
 #include <vector>
 
 #include "nav2_map_server/map_mode.hpp"
+#include "nav2_map_server/tiled_map.hpp"
 #include "nav_msgs/msg/occupancy_grid.hpp"
 
 /* Map input part */
@@ -59,26 +60,36 @@ LoadParameters loadMapYaml(const std::string & yaml_filename);
  * @brief Load the image from map file and generate an OccupancyGrid
  * @param load_parameters Parameters of loading map
  * @param map Output loaded map
+ * @param tiled_map If given, tiled map files are memory-mapped in it rather than
+ * loaded, leaving the data of map empty. It is closed for other map files
  * @throw std::exception
  */
 void loadMapFromFile(
   const LoadParameters & load_parameters,
-  nav_msgs::msg::OccupancyGrid & map);
+  nav_msgs::msg::OccupancyGrid & map,
+  TiledMap * tiled_map = nullptr);
 
 /**
  * @brief Load the map YAML, image from map file and
  * generate an OccupancyGrid
  * @param yaml_file Name of input YAML file
  * @param map Output loaded map
+ * @param tiled_map If given, tiled map files are memory-mapped in it rather than
+ * loaded, leaving the data of map empty. It is closed for other map files
  * @return status of map loaded
  */
 LOAD_MAP_STATUS loadMapFromYaml(
   const std::string & yaml_file,
-  nav_msgs::msg::OccupancyGrid & map);
+  nav_msgs::msg::OccupancyGrid & map,
+  TiledMap * tiled_map = nullptr);
 
 
 /* Map output part */
 
+// Image format of the tiled map files, memory-mapped by the map server to serve regions of
+// huge maps rather than publishing them whole
+const char TILED_MAP_FORMAT[] = "tmap";
+
 struct SaveParameters
 {
   std::string map_file_name{""};
@@ -86,6 +97,11 @@ struct SaveParameters
   double free_thresh{0.0};
   double occupied_thresh{0.0};
   MapMode mode{MapMode::Trinary};
+  // Whether to write PNG images with the fastest compression, rather than the smallest
+  bool fast_compression{false};
+  // Whether to encode and write the map in threads of the lowest priority, so as not to
+  // compete with the other nodes of the robot when saving maps periodically
+  bool low_priority{false};
 };
 
 /**
@@ -106,6 +106,10 @@ protected:
   double occupied_thresh_default_;
   // param for handling QoS configuration
   bool map_subscribe_transient_local_;
+  // Whether to write PNG maps with the fastest compression
+  bool fast_png_compression_;
+  // Whether to save maps in threads of the lowest priority
+  bool save_at_low_priority_;
 
   // The name of the service for saving a map from topic
   const std::string save_map_service_name_{"save_map"};
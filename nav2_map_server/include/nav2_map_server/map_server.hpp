@@ -18,12 +18,16 @@
 #include <string>
 #include <memory>
 #include <functional>
+#include <vector>
 
 #include "rclcpp/rclcpp.hpp"
 #include "nav2_util/lifecycle_node.hpp"
 #include "nav_msgs/msg/occupancy_grid.hpp"
 #include "nav_msgs/srv/get_map.hpp"
 #include "nav2_msgs/srv/load_map.hpp"
+#include "nav2_msgs/srv/get_map_region.hpp"
+#include "nav2_map_server/map_cache.hpp"
+#include "nav2_map_server/tiled_map.hpp"
 
 namespace nav2_map_server
 {
@@ -91,6 +95,12 @@ protected:
     const std::string & yaml_file,
     std::shared_ptr<nav2_msgs::srv::LoadMap::Response> response);
 
+  /**
+   * @brief Load the maps to switch to without reading them, into the map cache
+   * @param yaml_files Names of the YAML files of the maps
+   */
+  void preloadMaps(const std::vector<std::string> & yaml_files);
+
   /**
    * @brief Method correcting msg_ header when it belongs to instantiated object
    */
@@ -107,6 +117,18 @@ protected:
     const std::shared_ptr<nav_msgs::srv::GetMap::Request> request,
     std::shared_ptr<nav_msgs::srv::GetMap::Response> response);
 
+  /**
+   * @brief Map region getting service callback, reading the region from the tiles
+   * of a tiled map
+   * @param request_header Service request header
+   * @param request Service request
+   * @param response Service response
+   */
+  void getMapRegionCallback(
+    const std::shared_ptr<rmw_request_id_t> request_header,
+    const std::shared_ptr<nav2_msgs::srv::GetMapRegion::Request> request,
+    std::shared_ptr<nav2_msgs::srv::GetMapRegion::Response> response);
+
   /**
    * @brief Map loading service callback
    * @param request_header Service request header
@@ -124,12 +146,18 @@ protected:
   // The name of the service for loading a map
   const std::string load_map_service_name_{"load_map"};
 
+  // The name of the service for getting a region of the map
+  const std::string map_region_service_name_{"map_region"};
+
   // A service to provide the occupancy grid (GetMap) and the message to return
   rclcpp::Service<nav_msgs::srv::GetMap>::SharedPtr occ_service_;
 
   // A service to load the occupancy grid from file at run time (LoadMap)
   rclcpp::Service<nav2_msgs::srv::LoadMap>::SharedPtr load_map_service_;
 
+  // A service to provide a region of the occupancy grid (GetMapRegion)
+  rclcpp::Service<nav2_msgs::srv::GetMapRegion>::SharedPtr map_region_service_;
+
   // A topic on which the occupancy grid will be published
   rclcpp_lifecycle::LifecyclePublisher<nav_msgs::msg::OccupancyGrid>::SharedPtr occ_pub_;
 
@@ -141,6 +169,12 @@ protected:
 
   // true if msg_ was initialized
   bool map_available_;
+
+  // The memory-mapped tiles of a tiled map, whose data isn't held in msg_ then
+  TiledMap tiled_map_;
+
+  // The maps loaded, switched to without reading and decoding them again
+  std::unique_ptr<MapCache> map_cache_;
 };
 
 }  // namespace nav2_map_server
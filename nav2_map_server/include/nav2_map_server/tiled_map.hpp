@@ -0,0 +1,139 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/* Tiled map files, memory-mapped to read regions of huge maps */
+
+#ifndef NAV2_MAP_SERVER__TILED_MAP_HPP_
+#define NAV2_MAP_SERVER__TILED_MAP_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "nav_msgs/msg/occupancy_grid.hpp"
+
+namespace nav2_map_server
+{
+
+/**
+ * @class nav2_map_server::TiledMap
+ * @brief Read access to a tiled map file, which holds the occupancy values of a map in
+ * square tiles of raw cells rather than as an image. The file is memory-mapped, so that
+ * only the tiles of the regions read are loaded from disk.
+ *
+ * The file starts with a header of the magic "NAV2TMAP", then the version, width,
+ * height and tile size of the map as little-endian uint32. The tiles follow, row by row
+ * of tiles from the origin of the map, each of tile size x tile size int8 occupancy
+ * values stored row by row, the cells beyond the edges of the map being unknown. The
+ * offset of each tile is thus its index times the size of a tile.
+ */
+class TiledMap
+{
+public:
+  /**
+   * @brief A constructor for nav2_map_server::TiledMap, with no file open
+   */
+  TiledMap() = default;
+
+  /**
+   * @brief A destructor for nav2_map_server::TiledMap, unmapping the file
+   */
+  ~TiledMap();
+
+  TiledMap(const TiledMap &) = delete;
+  TiledMap & operator=(const TiledMap &) = delete;
+
+  /**
+   * @brief Memory-maps a tiled map file, replacing the one open
+   * @param file_name Name of the tiled map file
+   * @throw std::runtime_error if the file can't be mapped or isn't a valid tiled map file
+   */
+  void open(const std::string & file_name);
+
+  /**
+   * @brief Unmaps the file open, if any
+   */
+  void close();
+
+  /**
+   * @brief Whether a file is open
+   * @return bool true if open
+   */
+  bool isOpen() const {return data_ != nullptr;}
+
+  /**
+   * @brief Get the width of the map
+   * @return Number of cells along X
+   */
+  uint32_t getWidth() const {return width_;}
+
+  /**
+   * @brief Get the height of the map
+   * @return Number of cells along Y
+   */
+  uint32_t getHeight() const {return height_;}
+
+  /**
+   * @brief Get the size of the tiles of the map
+   * @return Number of cells along each side of the tiles
+   */
+  uint32_t getTileSize() const {return tile_size_;}
+
+  /**
+   * @brief Copies the occupancy values of a region of the map
+   * @param x0 First column of the region
+   * @param y0 First row of the region
+   * @param width Number of columns of the region, within the map
+   * @param height Number of rows of the region, within the map
+   * @param data Output values of the region, row by row
+   */
+  void getRegion(
+    uint32_t x0, uint32_t y0, uint32_t width, uint32_t height, int8_t * data) const;
+
+  /**
+   * @brief Whether a file is a tiled map file, from its magic
+   * @param file_name Name of the file
+   * @return bool true if it is a tiled map file
+   */
+  static bool isTiledMapFile(const std::string & file_name);
+
+  /**
+   * @brief Writes an occupancy grid as a tiled map file
+   * @param map Occupancy grid to write
+   * @param file_name Name of the tiled map file
+   * @param tile_size Number of cells along each side of the tiles
+   * @throw std::runtime_error if the file can't be written
+   */
+  static void write(
+    const nav_msgs::msg::OccupancyGrid & map, const std::string & file_name,
+    uint32_t tile_size = 256);
+
+protected:
+  const int8_t * data_{nullptr};
+  size_t file_size_{0};
+  uint32_t width_{0};
+  uint32_t height_{0};
+  uint32_t tile_size_{0};
+  // Number of tiles along X
+  uint32_t tiles_x_{0};
+#ifdef _WIN32
+  // Without mmap, the file is read into memory
+  std::vector<char> buffer_;
+#endif
+};
+
+}  // namespace nav2_map_server
+
+#endif  // NAV2_MAP_SERVER__TILED_MAP_HPP_
@@ -34,12 +34,21 @@
 #ifndef _WIN32
 #include <libgen.h>
 #endif
+#ifdef __linux__
+#include <sys/resource.h>
+#endif
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <exception>
 #include <iostream>
 #include <string>
 #include <vector>
 #include <fstream>
 #include <stdexcept>
 #include <cstdlib>
+#include <algorithm>
+#include <thread>
 
 #include "Magick++.h"
 #include "nav2_util/geometry_utils.hpp"
@@ -48,6 +57,8 @@
 #include "tf2/LinearMath/Matrix3x3.h"
 #include "tf2/LinearMath/Quaternion.h"
 #include "nav2_util/occ_grid_values.hpp"
+#include "nav2_util/translation_table.hpp"
+#include "nav2_util/thread_pool.hpp"
 
 #ifdef _WIN32
 // https://github.com/rtv/Stage/blob/master/replace/dirname.c
@@ -98,6 +109,9 @@ namespace nav2_map_server
 {
 using nav2_util::geometry_utils::orientationAroundZAxis;
 
+// Maps with fewer pixels are converted in the calling thread only, not being worth starting threads
+constexpr size_t kParallelLoadMinPixels = 1000000;
+
 // === Map input part ===
 
 /// Get the given subnode value.
@@ -194,10 +208,66 @@ LoadParameters loadMapYaml(const std::string & yaml_filename)
   return load_parameters;
 }
 
+/**
+ * @brief Load a tiled map file, assembling the whole map or leaving it memory-mapped
+ * @param load_parameters Parameters of loading map
+ * @param map Output loaded map, only its info if tiled_map is given
+ * @param tiled_map Tiled map to memory-map the file in, if any
+ * @throw std::exception
+ */
+void loadTiledMapFromFile(
+  const LoadParameters & load_parameters,
+  nav_msgs::msg::OccupancyGrid & map,
+  TiledMap * tiled_map)
+{
+  nav_msgs::msg::OccupancyGrid msg;
+
+  std::cout << "[INFO] [map_io]: Loading tiled map file: " <<
+    load_parameters.image_file_name << std::endl;
+  // The tiles hold occupancy values, so mode, negate and thresholds don't apply
+  TiledMap local_tiled_map;
+  TiledMap & tiles = tiled_map ? *tiled_map : local_tiled_map;
+  tiles.open(load_parameters.image_file_name);
+
+  msg.info.width = tiles.getWidth();
+  msg.info.height = tiles.getHeight();
+  msg.info.resolution = load_parameters.resolution;
+  msg.info.origin.position.x = load_parameters.origin[0];
+  msg.info.origin.position.y = load_parameters.origin[1];
+  msg.info.origin.position.z = 0.0;
+  msg.info.origin.orientation = orientationAroundZAxis(load_parameters.origin[2]);
+
+  if (!tiled_map) {
+    msg.data.resize(static_cast<size_t>(msg.info.width) * msg.info.height);
+    tiles.getRegion(0, 0, msg.info.width, msg.info.height, msg.data.data());
+  }
+
+  rclcpp::Clock clock(RCL_SYSTEM_TIME);
+  msg.info.map_load_time = clock.now();
+  msg.header.frame_id = "map";
+  msg.header.stamp = clock.now();
+
+  std::cout <<
+    "[DEBUG] [map_io]: Read tiled map " << load_parameters.image_file_name << ": " <<
+    msg.info.width << " X " << msg.info.height << " map @ " << msg.info.resolution <<
+    " m/cell in tiles of " << tiles.getTileSize() << " cells" << std::endl;
+
+  map = msg;
+}
+
 void loadMapFromFile(
   const LoadParameters & load_parameters,
-  nav_msgs::msg::OccupancyGrid & map)
+  nav_msgs::msg::OccupancyGrid & map,
+  TiledMap * tiled_map)
 {
+  if (TiledMap::isTiledMapFile(load_parameters.image_file_name)) {
+    loadTiledMapFromFile(load_parameters, map, tiled_map);
+    return;
+  }
+  if (tiled_map) {
+    tiled_map->close();
+  }
+
   Magick::InitializeMagick(nullptr);
   nav_msgs::msg::OccupancyGrid msg;
 
@@ -218,71 +288,102 @@ void loadMapFromFile(
   // Allocate space to hold the data
   msg.data.resize(msg.info.width * msg.info.height);
 
-  // Copy pixel data into the map structure
-  for (size_t y = 0; y < msg.info.height; y++) {
-    for (size_t x = 0; x < msg.info.width; x++) {
-      auto pixel = img.pixelColor(x, y);
-
-      std::vector<Magick::Quantum> channels = {pixel.redQuantum(), pixel.greenQuantum(),
-        pixel.blueQuantum()};
-      if (load_parameters.mode == MapMode::Trinary && img.matte()) {
-        // To preserve existing behavior, average in alpha with color channels in Trinary mode.
-        // CAREFUL. alpha is inverted from what you might expect. High = transparent, low = opaque
-        channels.push_back(MaxRGB - pixel.alphaQuantum());
-      }
-      double sum = 0;
-      for (auto c : channels) {
-        sum += c;
-      }
-      /// on a scale from 0.0 to 1.0 how bright is the pixel?
-      double shade = Magick::ColorGray::scaleQuantumToDouble(sum / channels.size());
-
-      // If negate is true, we consider blacker pixels free, and whiter
-      // pixels occupied. Otherwise, it's vice versa.
-      /// on a scale from 0.0 to 1.0, how occupied is the map cell (before thresholding)?
-      double occ = (load_parameters.negate ? shade : 1.0 - shade);
-
-      int8_t map_cell;
-      switch (load_parameters.mode) {
-        case MapMode::Trinary:
-          if (load_parameters.occupied_thresh < occ) {
-            map_cell = nav2_util::OCC_GRID_OCCUPIED;
-          } else if (occ < load_parameters.free_thresh) {
-            map_cell = nav2_util::OCC_GRID_FREE;
+  // To preserve existing behavior, average in alpha with color channels in Trinary mode.
+  const bool average_alpha = load_parameters.mode == MapMode::Trinary && img.matte();
+  const size_t num_channels = average_alpha ? 4 : 3;
+
+  // Map cells only depend on the sum of the channels of their pixel (and on its
+  // alpha in Scale mode), so tabulate them for every sum
+  std::vector<int8_t> cell_table(num_channels * MaxRGB + 1);
+  for (size_t sum = 0; sum < cell_table.size(); sum++) {
+    /// on a scale from 0.0 to 1.0 how bright is the pixel?
+    double shade = Magick::ColorGray::scaleQuantumToDouble(
+      static_cast<double>(sum) / num_channels);
+
+    // If negate is true, we consider blacker pixels free, and whiter
+    // pixels occupied. Otherwise, it's vice versa.
+    /// on a scale from 0.0 to 1.0, how occupied is the map cell (before thresholding)?
+    double occ = (load_parameters.negate ? shade : 1.0 - shade);
+
+    int8_t map_cell;
+    switch (load_parameters.mode) {
+      case MapMode::Trinary:
+        if (load_parameters.occupied_thresh < occ) {
+          map_cell = nav2_util::OCC_GRID_OCCUPIED;
+        } else if (occ < load_parameters.free_thresh) {
+          map_cell = nav2_util::OCC_GRID_FREE;
+        } else {
+          map_cell = nav2_util::OCC_GRID_UNKNOWN;
+        }
+        break;
+      case MapMode::Scale:
+        if (load_parameters.occupied_thresh < occ) {
+          map_cell = nav2_util::OCC_GRID_OCCUPIED;
+        } else if (occ < load_parameters.free_thresh) {
+          map_cell = nav2_util::OCC_GRID_FREE;
+        } else {
+          map_cell = std::rint(
+            (occ - load_parameters.free_thresh) /
+            (load_parameters.occupied_thresh - load_parameters.free_thresh) * 100.0);
+        }
+        break;
+      case MapMode::Raw: {
+          double occ_percent = std::round(shade * 255);
+          if (nav2_util::OCC_GRID_FREE <= occ_percent &&
+            occ_percent <= nav2_util::OCC_GRID_OCCUPIED)
+          {
+            map_cell = static_cast<int8_t>(occ_percent);
           } else {
             map_cell = nav2_util::OCC_GRID_UNKNOWN;
           }
           break;
-        case MapMode::Scale:
-          if (pixel.alphaQuantum() != OpaqueOpacity) {
-            map_cell = nav2_util::OCC_GRID_UNKNOWN;
-          } else if (load_parameters.occupied_thresh < occ) {
-            map_cell = nav2_util::OCC_GRID_OCCUPIED;
-          } else if (occ < load_parameters.free_thresh) {
-            map_cell = nav2_util::OCC_GRID_FREE;
-          } else {
-            map_cell = std::rint(
-              (occ - load_parameters.free_thresh) /
-              (load_parameters.occupied_thresh - load_parameters.free_thresh) * 100.0);
+        }
+      default:
+        throw std::runtime_error("Invalid map mode");
+    }
+    cell_table[sum] = map_cell;
+  }
+
+  const Magick::PixelPacket * pixels =
+    img.getConstPixels(0, 0, msg.info.width, msg.info.height);
+  if (pixels == nullptr && !msg.data.empty()) {
+    throw std::runtime_error("Failed to read the pixels of " + load_parameters.image_file_name);
+  }
+
+  // Copy pixel data into the map structure, the rows being converted in blocks split
+  // across the cores for large maps
+  const size_t num_pixels = static_cast<size_t>(msg.info.width) * msg.info.height;
+  const size_t num_threads = num_pixels < kParallelLoadMinPixels ?
+    0 : std::max(1u, std::thread::hardware_concurrency()) - 1;
+  nav2_util::ThreadPool thread_pool(num_threads);
+  const size_t num_blocks = 4 * (num_threads + 1);
+  const size_t block_rows = (msg.info.height + num_blocks - 1) / num_blocks;
+
+  thread_pool.parallelFor(
+    num_blocks, [&](size_t block) {
+      std::vector<uint32_t> sums(msg.info.width);
+      const size_t end_row = std::min<size_t>((block + 1) * block_rows, msg.info.height);
+      for (size_t y = block * block_rows; y < end_row; y++) {
+        const Magick::PixelPacket * row = pixels + y * msg.info.width;
+        for (size_t x = 0; x < msg.info.width; x++) {
+          sums[x] = row[x].red + row[x].green + row[x].blue;
+          if (average_alpha) {
+            // CAREFUL. alpha is inverted from what you might expect. High = transparent, low = opaque
+            sums[x] += MaxRGB - row[x].opacity;
           }
-          break;
-        case MapMode::Raw: {
-            double occ_percent = std::round(shade * 255);
-            if (nav2_util::OCC_GRID_FREE <= occ_percent &&
-              occ_percent <= nav2_util::OCC_GRID_OCCUPIED)
-            {
-              map_cell = static_cast<int8_t>(occ_percent);
-            } else {
-              map_cell = nav2_util::OCC_GRID_UNKNOWN;
+        }
+
+        int8_t * map_row = msg.data.data() + msg.info.width * (msg.info.height - y - 1);
+        nav2_util::translateValues(cell_table.data(), sums.data(), msg.info.width, map_row);
+        if (load_parameters.mode == MapMode::Scale) {
+          for (size_t x = 0; x < msg.info.width; x++) {
+            if (row[x].opacity != OpaqueOpacity) {
+              map_row[x] = nav2_util::OCC_GRID_UNKNOWN;
             }
-            break;
           }
-        default:
-          throw std::runtime_error("Invalid map mode");
+        }
       }
-      msg.data[msg.info.width * (msg.info.height - y - 1) + x] = map_cell;
-    }
-  }
+    });
 
   // Since loadMapFromFile() does not belong to any node, publishing in a system time.
   rclcpp::Clock clock(RCL_SYSTEM_TIME);
@@ -299,7 +400,8 @@ void loadMapFromFile(
 
 LOAD_MAP_STATUS loadMapFromYaml(
   const std::string & yaml_file,
-  nav_msgs::msg::OccupancyGrid & map)
+  nav_msgs::msg::OccupancyGrid & map,
+  TiledMap * tiled_map)
 {
   if (yaml_file.empty()) {
     std::cerr << "[ERROR] [map_io]: YAML file name is empty, can't load!" << std::endl;
@@ -321,7 +423,7 @@ LOAD_MAP_STATUS loadMapFromYaml(
     return INVALID_MAP_METADATA;
   }
   try {
-    loadMapFromFile(load_parameters, map);
+    loadMapFromFile(load_parameters, map, tiled_map);
   } catch (std::exception & e) {
     std::cerr <<
       "[ERROR] [map_io]: Failed to load image file " << load_parameters.image_file_name <<
@@ -392,6 +494,11 @@ void checkSaveParameters(SaveParameters & save_parameters)
     save_parameters.image_format.begin(),
     [](unsigned char c) {return std::tolower(c);});
 
+  // Tiled map files are written without Magick, in any mode
+  if (save_parameters.image_format == TILED_MAP_FORMAT) {
+    return;
+  }
+
   const std::vector<std::string> BLESSED_FORMATS{"bmp", "pgm", "png"};
   if (
     std::find(BLESSED_FORMATS.begin(), BLESSED_FORMATS.end(), save_parameters.image_format) ==
@@ -441,6 +548,35 @@ void checkSaveParameters(SaveParameters & save_parameters)
   }
 }
 
+/**
+ * @brief Lowers the scheduling priority of the calling thread to the lowest, where supported
+ */
+void lowerThreadPriority()
+{
+#ifdef __linux__
+  // On Linux, the nice value of PRIO_PROCESS 0 is that of the calling thread only
+  if (setpriority(PRIO_PROCESS, 0, 19) != 0) {
+    std::cout << "[WARN] [map_io]: Failed to lower the priority of the map writing thread" <<
+      std::endl;
+  }
+#endif
+}
+
+/**
+ * @brief Renames a file written under a temporary name to its final name, atomically
+ * replacing any file of that name so that readers never see a partially written map
+ * @param tmp_file_name Temporary name of the file
+ * @param file_name Final name of the file
+ * @throw std::runtime_error if the file can't be renamed
+ */
+void commitFile(const std::string & tmp_file_name, const std::string & file_name)
+{
+  if (std::rename(tmp_file_name.c_str(), file_name.c_str()) != 0) {
+    std::remove(tmp_file_name.c_str());
+    throw std::runtime_error("Failed to rename " + tmp_file_name + " to " + file_name);
+  }
+}
+
 /**
  * @brief Tries to write map data into a file
  * @param map Occupancy grid data
@@ -456,74 +592,105 @@ void tryWriteMapToFile(
     map.info.resolution << " m/pix" << std::endl;
 
   std::string mapdatafile = save_parameters.map_file_name + "." + save_parameters.image_format;
-  {
-    // should never see this color, so the initialization value is just for debugging
-    Magick::Image image({map.info.width, map.info.height}, "red");
-
-    // In scale mode, we need the alpha (matte) channel. Else, we don't.
-    // NOTE: GraphicsMagick seems to have trouble loading the alpha channel when saved with
-    // Magick::GreyscaleMatte, so we use TrueColorMatte instead.
-    image.type(
-      save_parameters.mode == MapMode::Scale ?
-      Magick::TrueColorMatteType : Magick::GrayscaleType);
-
-    // Since we only need to support 100 different pixel levels, 8 bits is fine
-    image.depth(8);
-
+  const std::string tmp_suffix = ".tmp";
+  if (save_parameters.image_format == TILED_MAP_FORMAT) {
+    std::cout << "[INFO] [map_io]: Writing tiled map occupancy data to " << mapdatafile <<
+      std::endl;
+    TiledMap::write(map, mapdatafile + tmp_suffix);
+    commitFile(mapdatafile + tmp_suffix, mapdatafile);
+  } else {
+    // Pixels only depend on the value of their cell, so tabulate them for every value, as
+    // gray levels, or as gray levels and alphas in Scale mode which needs the alpha channel
+    using ScalePixel = std::array<uint8_t, 2>;
     int free_thresh_int = std::rint(save_parameters.free_thresh * 100.0);
     int occupied_thresh_int = std::rint(save_parameters.occupied_thresh * 100.0);
-
-    for (size_t y = 0; y < map.info.height; y++) {
-      for (size_t x = 0; x < map.info.width; x++) {
-        int8_t map_cell = map.data[map.info.width * (map.info.height - y - 1) + x];
-
-        Magick::Color pixel;
-
+    auto gray_table = nav2_util::makeByteTranslationTable<uint8_t>(
+      [&](uint8_t value) -> uint8_t {
+        const int8_t map_cell = static_cast<int8_t>(value);
         switch (save_parameters.mode) {
           case MapMode::Trinary:
             if (map_cell < 0 || 100 < map_cell) {
-              pixel = Magick::ColorGray(205 / 255.0);
+              return 205;
             } else if (map_cell <= free_thresh_int) {
-              pixel = Magick::ColorGray(254 / 255.0);
+              return 254;
             } else if (occupied_thresh_int <= map_cell) {
-              pixel = Magick::ColorGray(0 / 255.0);
-            } else {
-              pixel = Magick::ColorGray(205 / 255.0);
-            }
-            break;
-          case MapMode::Scale:
-            if (map_cell < 0 || 100 < map_cell) {
-              pixel = Magick::ColorGray{0.5};
-              pixel.alphaQuantum(TransparentOpacity);
-            } else {
-              pixel = Magick::ColorGray{(100.0 - map_cell) / 100.0};
+              return 0;
             }
-            break;
+            return 205;
           case MapMode::Raw:
-            Magick::Quantum q;
             if (map_cell < 0 || 100 < map_cell) {
-              q = MaxRGB;
-            } else {
-              q = map_cell / 255.0 * MaxRGB;
+              return 255;
             }
-            pixel = Magick::Color(q, q, q);
-            break;
+            return map_cell;
           default:
-            std::cerr << "[ERROR] [map_io]: Map mode should be Trinary, Scale or Raw" << std::endl;
-            throw std::runtime_error("Invalid map mode");
+            return 0;
         }
-        image.pixelColor(x, y, pixel);
-      }
+      });
+    auto scale_table = nav2_util::makeByteTranslationTable<ScalePixel>(
+      [](uint8_t value) -> ScalePixel {
+        const int8_t map_cell = static_cast<int8_t>(value);
+        if (map_cell < 0 || 100 < map_cell) {
+          return {128, 0};
+        }
+        return {static_cast<uint8_t>(std::lround((100.0 - map_cell) / 100.0 * 255.0)), 255};
+      });
+    if (save_parameters.mode != MapMode::Trinary && save_parameters.mode != MapMode::Scale &&
+      save_parameters.mode != MapMode::Raw)
+    {
+      std::cerr << "[ERROR] [map_io]: Map mode should be Trinary, Scale or Raw" << std::endl;
+      throw std::runtime_error("Invalid map mode");
     }
 
+    // Encode the rows of the image from the bottom row of the map, in blocks split across
+    // the cores for large maps
+    const bool scale = save_parameters.mode == MapMode::Scale;
+    const size_t width = map.info.width;
+    const size_t height = map.info.height;
+    std::vector<uint8_t> pixels(width * height * (scale ? sizeof(ScalePixel) : 1));
+    const size_t num_threads = width * height < kParallelLoadMinPixels ?
+      0 : std::max(1u, std::thread::hardware_concurrency()) - 1;
+    nav2_util::ThreadPool thread_pool(num_threads);
+    const size_t num_blocks = 4 * (num_threads + 1);
+    const size_t block_rows = (height + num_blocks - 1) / num_blocks;
+    thread_pool.parallelFor(
+      num_blocks, [&](size_t block) {
+        const size_t end_row = std::min((block + 1) * block_rows, height);
+        for (size_t y = block * block_rows; y < end_row; y++) {
+          const int8_t * map_row = map.data.data() + width * (height - y - 1);
+          if (scale) {
+            nav2_util::translateValues(
+              scale_table, map_row, width,
+              reinterpret_cast<ScalePixel *>(pixels.data()) + width * y);
+          } else {
+            nav2_util::translateValues(gray_table, map_row, width, pixels.data() + width * y);
+          }
+        }
+      });
+
+    Magick::Image image(
+      width, height, scale ? "IA" : "I", Magick::CharPixel, pixels.data());
+
+    // In scale mode, we need the alpha (matte) channel. Else, we don't.
+    // NOTE: GraphicsMagick seems to have trouble loading the alpha channel when saved with
+    // Magick::GreyscaleMatte, so we use TrueColorMatte instead.
+    image.type(scale ? Magick::TrueColorMatteType : Magick::GrayscaleType);
+
+    // Since we only need to support 100 different pixel levels, 8 bits is fine
+    image.depth(8);
+
+    if (save_parameters.fast_compression && save_parameters.image_format == "png") {
+      // zlib level 1 (tens digit) with adaptive filtering (units digit)
+      image.quality(15);
+    }
+
+    // The format is given explicitly, not being guessed from the temporary file name
     std::cout << "[INFO] [map_io]: Writing map occupancy data to " << mapdatafile << std::endl;
-    image.write(mapdatafile);
+    image.write(save_parameters.image_format + ":" + mapdatafile + tmp_suffix);
+    commitFile(mapdatafile + tmp_suffix, mapdatafile);
   }
 
   std::string mapmetadatafile = save_parameters.map_file_name + ".yaml";
   {
-    std::ofstream yaml(mapmetadatafile);
-
     geometry_msgs::msg::Quaternion orientation = map.info.origin.orientation;
     tf2::Matrix3x3 mat(tf2::Quaternion(orientation.x, orientation.y, orientation.z, orientation.w));
     double yaw, pitch, roll;
@@ -551,7 +718,14 @@ void tryWriteMapToFile(
     }
 
     std::cout << "[INFO] [map_io]: Writing map metadata to " << mapmetadatafile << std::endl;
-    std::ofstream(mapmetadatafile) << e.c_str();
+    {
+      std::ofstream yaml_file(mapmetadatafile + tmp_suffix);
+      yaml_file << e.c_str();
+      if (!yaml_file.good()) {
+        throw std::runtime_error("Failed to write " + mapmetadatafile + tmp_suffix);
+      }
+    }
+    commitFile(mapmetadatafile + tmp_suffix, mapmetadatafile);
   }
   std::cout << "[INFO] [map_io]: Map saved" << std::endl;
 }
@@ -567,7 +741,24 @@ bool saveMapToFile(
     // Checking map parameters for consistency
     checkSaveParameters(save_parameters_loc);
 
-    tryWriteMapToFile(map, save_parameters_loc);
+    if (save_parameters_loc.low_priority) {
+      // Written from a thread of its own, whose priority the encoding threads inherit
+      std::exception_ptr error;
+      std::thread writer([&]() {
+          lowerThreadPriority();
+          try {
+            tryWriteMapToFile(map, save_parameters_loc);
+          } catch (...) {
+            error = std::current_exception();
+          }
+        });
+      writer.join();
+      if (error) {
+        std::rethrow_exception(error);
+      }
+    } else {
+      tryWriteMapToFile(map, save_parameters_loc);
+    }
   } catch (std::exception & e) {
     std::cout << "[ERROR] [map_io]: Failed to write map for reason: " << e.what() << std::endl;
     return false;
@@ -51,6 +51,8 @@ MapSaver::MapSaver(const rclcpp::NodeOptions & options)
   declare_parameter("free_thresh_default", 0.25);
   declare_parameter("occupied_thresh_default", 0.65);
   declare_parameter("map_subscribe_transient_local", true);
+  declare_parameter("fast_png_compression", false);
+  declare_parameter("save_at_low_priority", true);
 }
 
 MapSaver::~MapSaver()
@@ -70,6 +72,8 @@ MapSaver::on_configure(const rclcpp_lifecycle::State & /*state*/)
   free_thresh_default_ = get_parameter("free_thresh_default").as_double();
   occupied_thresh_default_ = get_parameter("occupied_thresh_default").as_double();
   map_subscribe_transient_local_ = get_parameter("map_subscribe_transient_local").as_bool();
+  fast_png_compression_ = get_parameter("fast_png_compression").as_bool();
+  save_at_low_priority_ = get_parameter("save_at_low_priority").as_bool();
 
   // Create a service that saves the occupancy grid from map topic to a file
   save_map_service_ = create_service<nav2_msgs::srv::SaveMap>(
@@ -129,6 +133,8 @@ void MapSaver::saveMapCallback(
   save_parameters.image_format = request->image_format;
   save_parameters.free_thresh = request->free_thresh;
   save_parameters.occupied_thresh = request->occupied_thresh;
+  save_parameters.fast_compression = fast_png_compression_;
+  save_parameters.low_priority = save_at_low_priority_;
   try {
     save_parameters.mode = map_mode_from_string(request->map_mode);
   } catch (std::invalid_argument &) {
@@ -0,0 +1,94 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_map_server/map_cache.hpp"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+namespace nav2_map_server
+{
+
+MapCache::MapCache(size_t capacity, bool compress)
+: capacity_(capacity), compress_(compress)
+{
+}
+
+bool MapCache::get(const std::string & yaml_file, nav_msgs::msg::OccupancyGrid & map)
+{
+  auto it = index_.find(yaml_file);
+  if (it == index_.end()) {
+    return false;
+  }
+  maps_.splice(maps_.begin(), maps_, it->second);
+
+  const CachedMap & cached = maps_.front();
+  map = cached.map;
+  if (compress_) {
+    map.data.resize(static_cast<size_t>(map.info.width) * map.info.height);
+    auto out = map.data.begin();
+    for (size_t i = 0; i < cached.run_values.size(); i++) {
+      out = std::fill_n(out, cached.run_lengths[i], cached.run_values[i]);
+    }
+  }
+  return true;
+}
+
+void MapCache::put(const std::string & yaml_file, const nav_msgs::msg::OccupancyGrid & map)
+{
+  if (capacity_ == 0) {
+    return;
+  }
+
+  auto it = index_.find(yaml_file);
+  if (it != index_.end()) {
+    maps_.erase(it->second);
+    index_.erase(it);
+  } else if (maps_.size() == capacity_) {
+    index_.erase(maps_.back().yaml_file);
+    maps_.pop_back();
+  }
+
+  CachedMap cached;
+  cached.yaml_file = yaml_file;
+  if (compress_) {
+    cached.map.header = map.header;
+    cached.map.info = map.info;
+    for (size_t i = 0; i < map.data.size(); ) {
+      size_t end = i + 1;
+      while (end < map.data.size() && map.data[end] == map.data[i]) {
+        end++;
+      }
+      cached.run_values.push_back(map.data[i]);
+      cached.run_lengths.push_back(static_cast<uint32_t>(end - i));
+      i = end;
+    }
+    cached.run_values.shrink_to_fit();
+    cached.run_lengths.shrink_to_fit();
+  } else {
+    cached.map = map;
+  }
+
+  maps_.push_front(std::move(cached));
+  index_[yaml_file] = maps_.begin();
+}
+
+void MapCache::clear()
+{
+  maps_.clear();
+  index_.clear();
+}
+
+}  // namespace nav2_map_server
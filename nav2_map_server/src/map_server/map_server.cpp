@@ -47,6 +47,8 @@
 #include "nav2_map_server/map_server.hpp"
 
 #include <string>
+#include <algorithm>
+#include <cmath>
 #include <memory>
 #include <fstream>
 #include <stdexcept>
@@ -71,6 +73,9 @@ MapServer::MapServer(const rclcpp::NodeOptions & options)
   declare_parameter("yaml_filename", rclcpp::PARAMETER_STRING);
   declare_parameter("topic_name", "map");
   declare_parameter("frame_id", "map");
+  declare_parameter("preload_maps", std::vector<std::string>());
+  declare_parameter("map_cache_size", 0);
+  declare_parameter("compress_cached_maps", false);
 }
 
 MapServer::~MapServer()
@@ -87,6 +92,14 @@ MapServer::on_configure(const rclcpp_lifecycle::State & /*state*/)
   std::string topic_name = get_parameter("topic_name").as_string();
   frame_id_ = get_parameter("frame_id").as_string();
 
+  // The cache holds at least the preloaded maps, the least recently used being evicted
+  const auto preload_maps = get_parameter("preload_maps").as_string_array();
+  const int map_cache_size = get_parameter("map_cache_size").as_int();
+  map_cache_ = std::make_unique<MapCache>(
+    std::max<size_t>(std::max(map_cache_size, 0), preload_maps.size()),
+    get_parameter("compress_cached_maps").as_bool());
+  preloadMaps(preload_maps);
+
   // only try to load map if parameter was set
   if (!yaml_filename.empty()) {
     // Shared pointer to LoadMap::Response is also should be initialized
@@ -122,6 +135,11 @@ MapServer::on_configure(const rclcpp_lifecycle::State & /*state*/)
     service_prefix + std::string(load_map_service_name_),
     std::bind(&MapServer::loadMapCallback, this, _1, _2, _3));
 
+  // Create a service that provides regions of the occupancy grid
+  map_region_service_ = create_service<nav2_msgs::srv::GetMapRegion>(
+    service_prefix + std::string(map_region_service_name_),
+    std::bind(&MapServer::getMapRegionCallback, this, _1, _2, _3));
+
   return nav2_util::CallbackReturn::SUCCESS;
 }
 
@@ -132,7 +150,7 @@ MapServer::on_activate(const rclcpp_lifecycle::State & /*state*/)
 
   // Publish the map using the latched topic
   occ_pub_->on_activate();
-  if (map_available_) {
+  if (map_available_ && !tiled_map_.isOpen()) {
     auto occ_grid = std::make_unique<nav_msgs::msg::OccupancyGrid>(msg_);
     occ_pub_->publish(std::move(occ_grid));
   }
@@ -164,8 +182,11 @@ MapServer::on_cleanup(const rclcpp_lifecycle::State & /*state*/)
   occ_pub_.reset();
   occ_service_.reset();
   load_map_service_.reset();
+  map_region_service_.reset();
   map_available_ = false;
   msg_ = nav_msgs::msg::OccupancyGrid();
+  tiled_map_.close();
+  map_cache_.reset();
 
   return nav2_util::CallbackReturn::SUCCESS;
 }
@@ -191,6 +212,73 @@ void MapServer::getMapCallback(
   }
   RCLCPP_INFO(get_logger(), "Handling GetMap request");
   response->map = msg_;
+  if (tiled_map_.isOpen()) {
+    // Only requested for the whole map, the tiles are assembled on demand
+    response->map.data.resize(static_cast<size_t>(msg_.info.width) * msg_.info.height);
+    tiled_map_.getRegion(0, 0, msg_.info.width, msg_.info.height, response->map.data.data());
+  }
+}
+
+void MapServer::getMapRegionCallback(
+  const std::shared_ptr<rmw_request_id_t>/*request_header*/,
+  const std::shared_ptr<nav2_msgs::srv::GetMapRegion::Request> request,
+  std::shared_ptr<nav2_msgs::srv::GetMapRegion::Response> response)
+{
+  // if not in ACTIVE state, ignore request
+  if (get_current_state().id() != lifecycle_msgs::msg::State::PRIMARY_STATE_ACTIVE) {
+    RCLCPP_WARN(
+      get_logger(),
+      "Received GetMapRegion request but not in ACTIVE state, ignoring!");
+    response->success = false;
+    return;
+  }
+  if (!map_available_) {
+    RCLCPP_WARN(get_logger(), "Received GetMapRegion request but no map is loaded");
+    response->success = false;
+    return;
+  }
+
+  // Cells of the map within the bounds, the map orientation being ignored as by the costmap
+  const auto & info = msg_.info;
+  auto toCell = [&info](double cell, uint32_t size) {
+      return static_cast<uint32_t>(std::clamp(cell, 0.0, static_cast<double>(size)));
+    };
+  const double resolution = info.resolution;
+  const uint32_t x0 = toCell(
+    std::floor((request->min_x - info.origin.position.x) / resolution), info.width);
+  const uint32_t y0 = toCell(
+    std::floor((request->min_y - info.origin.position.y) / resolution), info.height);
+  const uint32_t xn = toCell(
+    std::ceil((request->max_x - info.origin.position.x) / resolution), info.width);
+  const uint32_t yn = toCell(
+    std::ceil((request->max_y - info.origin.position.y) / resolution), info.height);
+  if (xn <= x0 || yn <= y0) {
+    RCLCPP_WARN(get_logger(), "Received GetMapRegion request for a region outside of the map");
+    response->success = false;
+    return;
+  }
+
+  RCLCPP_DEBUG(
+    get_logger(), "Handling GetMapRegion request for cells [%u, %u) X [%u, %u)",
+    x0, xn, y0, yn);
+  auto & map = response->map;
+  map.header = msg_.header;
+  map.info = info;
+  map.info.width = xn - x0;
+  map.info.height = yn - y0;
+  map.info.origin.position.x = info.origin.position.x + x0 * info.resolution;
+  map.info.origin.position.y = info.origin.position.y + y0 * info.resolution;
+  map.data.resize(static_cast<size_t>(map.info.width) * map.info.height);
+  if (tiled_map_.isOpen()) {
+    tiled_map_.getRegion(x0, y0, map.info.width, map.info.height, map.data.data());
+  } else {
+    for (uint32_t y = 0; y < map.info.height; y++) {
+      std::copy_n(
+        msg_.data.begin() + static_cast<size_t>(y0 + y) * info.width + x0, map.info.width,
+        map.data.begin() + static_cast<size_t>(y) * map.info.width);
+    }
+  }
+  response->success = true;
 }
 
 void MapServer::loadMapCallback(
@@ -208,17 +296,48 @@ void MapServer::loadMapCallback(
   }
   RCLCPP_INFO(get_logger(), "Handling LoadMap request");
   // Load from file
-  if (loadMapResponseFromYaml(request->map_url, response)) {
+  if (loadMapResponseFromYaml(request->map_url, response) && !tiled_map_.isOpen()) {
     auto occ_grid = std::make_unique<nav_msgs::msg::OccupancyGrid>(msg_);
     occ_pub_->publish(std::move(occ_grid));  // publish new map
   }
 }
 
+void MapServer::preloadMaps(const std::vector<std::string> & yaml_files)
+{
+  for (const auto & yaml_file : yaml_files) {
+    nav_msgs::msg::OccupancyGrid map;
+    TiledMap tiled_map;
+    if (loadMapFromYaml(yaml_file, map, &tiled_map) != LOAD_MAP_SUCCESS) {
+      RCLCPP_WARN(get_logger(), "Failed to preload map %s", yaml_file.c_str());
+      continue;
+    }
+    if (tiled_map.isOpen()) {
+      // Already memory-mapped rather than decoded when switched to
+      RCLCPP_INFO(get_logger(), "Not preloading the tiled map %s", yaml_file.c_str());
+      continue;
+    }
+    map_cache_->put(yaml_file, map);
+    RCLCPP_INFO(get_logger(), "Preloaded map %s", yaml_file.c_str());
+  }
+}
+
 bool MapServer::loadMapResponseFromYaml(
   const std::string & yaml_file,
   std::shared_ptr<nav2_msgs::srv::LoadMap::Response> response)
 {
-  switch (loadMapFromYaml(yaml_file, msg_)) {
+  LOAD_MAP_STATUS status;
+  if (map_cache_ && map_cache_->get(yaml_file, msg_)) {
+    RCLCPP_INFO(get_logger(), "Switching to the cached map %s", yaml_file.c_str());
+    tiled_map_.close();
+    status = LOAD_MAP_SUCCESS;
+  } else {
+    status = loadMapFromYaml(yaml_file, msg_, &tiled_map_);
+    if (status == LOAD_MAP_SUCCESS && map_cache_ && !tiled_map_.isOpen()) {
+      map_cache_->put(yaml_file, msg_);
+    }
+  }
+
+  switch (status) {
     case MAP_DOES_NOT_EXIST:
       response->result = nav2_msgs::srv::LoadMap::Response::RESULT_MAP_DOES_NOT_EXIST;
       return false;
@@ -233,7 +352,13 @@ bool MapServer::loadMapResponseFromYaml(
       updateMsgHeader();
 
       map_available_ = true;
+      // Only the info of a tiled map, its regions being served on request
       response->map = msg_;
+      if (tiled_map_.isOpen()) {
+        RCLCPP_INFO(
+          get_logger(), "Serving the tiled map %s by regions on the '%s' service",
+          yaml_file.c_str(), map_region_service_name_.c_str());
+      }
       response->result = nav2_msgs::srv::LoadMap::Response::RESULT_SUCCESS;
   }
 
@@ -0,0 +1,220 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_map_server/tiled_map.hpp"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "nav2_util/occ_grid_values.hpp"
+
+namespace nav2_map_server
+{
+
+namespace
+{
+
+constexpr char kMagic[8] = {'N', 'A', 'V', '2', 'T', 'M', 'A', 'P'};
+constexpr uint32_t kVersion = 1;
+constexpr size_t kHeaderSize = sizeof(kMagic) + 4 * sizeof(uint32_t);
+
+uint32_t readUint32(const char * bytes)
+{
+  return static_cast<uint32_t>(static_cast<uint8_t>(bytes[0])) |
+         static_cast<uint32_t>(static_cast<uint8_t>(bytes[1])) << 8 |
+         static_cast<uint32_t>(static_cast<uint8_t>(bytes[2])) << 16 |
+         static_cast<uint32_t>(static_cast<uint8_t>(bytes[3])) << 24;
+}
+
+void writeUint32(std::ofstream & file, uint32_t value)
+{
+  const char bytes[4] = {
+    static_cast<char>(value & 0xff),
+    static_cast<char>((value >> 8) & 0xff),
+    static_cast<char>((value >> 16) & 0xff),
+    static_cast<char>((value >> 24) & 0xff)};
+  file.write(bytes, sizeof(bytes));
+}
+
+}  // namespace
+
+TiledMap::~TiledMap()
+{
+  close();
+}
+
+void TiledMap::open(const std::string & file_name)
+{
+  close();
+
+#ifndef _WIN32
+  const int fd = ::open(file_name.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Failed to open tiled map file " + file_name);
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 || static_cast<size_t>(file_stat.st_size) < kHeaderSize) {
+    ::close(fd);
+    throw std::runtime_error("Invalid tiled map file " + file_name);
+  }
+  const size_t file_size = static_cast<size_t>(file_stat.st_size);
+  void * mapped = mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+  // The mapping stays valid once the file is closed
+  ::close(fd);
+  if (mapped == MAP_FAILED) {
+    throw std::runtime_error("Failed to memory-map tiled map file " + file_name);
+  }
+  const char * bytes = static_cast<const char *>(mapped);
+#else
+  std::ifstream file(file_name, std::ios::binary);
+  buffer_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  if (!file.good() && !file.eof()) {
+    throw std::runtime_error("Failed to read tiled map file " + file_name);
+  }
+  const size_t file_size = buffer_.size();
+  if (file_size < kHeaderSize) {
+    buffer_.clear();
+    throw std::runtime_error("Invalid tiled map file " + file_name);
+  }
+  const char * bytes = buffer_.data();
+#endif
+
+  data_ = reinterpret_cast<const int8_t *>(bytes);
+  file_size_ = file_size;
+
+  const uint32_t version = readUint32(bytes + sizeof(kMagic));
+  width_ = readUint32(bytes + sizeof(kMagic) + 4);
+  height_ = readUint32(bytes + sizeof(kMagic) + 8);
+  tile_size_ = readUint32(bytes + sizeof(kMagic) + 12);
+  if (std::memcmp(bytes, kMagic, sizeof(kMagic)) != 0 || version != kVersion ||
+    tile_size_ == 0)
+  {
+    close();
+    throw std::runtime_error("Invalid tiled map file " + file_name);
+  }
+
+  tiles_x_ = (width_ + tile_size_ - 1) / tile_size_;
+  const size_t tiles_y = (height_ + tile_size_ - 1) / tile_size_;
+  const size_t expected_size =
+    kHeaderSize + static_cast<size_t>(tiles_x_) * tiles_y * tile_size_ * tile_size_;
+  if (file_size_ < expected_size) {
+    close();
+    throw std::runtime_error("Truncated tiled map file " + file_name);
+  }
+}
+
+void TiledMap::close()
+{
+  if (data_ == nullptr) {
+    return;
+  }
+#ifndef _WIN32
+  munmap(const_cast<int8_t *>(data_), file_size_);
+#else
+  buffer_.clear();
+#endif
+  data_ = nullptr;
+  file_size_ = 0;
+  width_ = height_ = tile_size_ = tiles_x_ = 0;
+}
+
+void TiledMap::getRegion(
+  uint32_t x0, uint32_t y0, uint32_t width, uint32_t height, int8_t * data) const
+{
+  const int8_t * tiles = data_ + kHeaderSize;
+  const size_t tile_cells = static_cast<size_t>(tile_size_) * tile_size_;
+  for (uint32_t y = 0; y < height; y++) {
+    const uint32_t map_y = y0 + y;
+    const size_t tile_row = map_y / tile_size_;
+    const size_t row_in_tile = map_y % tile_size_;
+    int8_t * out = data + static_cast<size_t>(y) * width;
+
+    // Copy the part of the row in each tile it crosses
+    uint32_t x = 0;
+    while (x < width) {
+      const uint32_t map_x = x0 + x;
+      const size_t tile = tile_row * tiles_x_ + map_x / tile_size_;
+      const uint32_t col_in_tile = map_x % tile_size_;
+      const uint32_t count = std::min(width - x, tile_size_ - col_in_tile);
+      std::memcpy(
+        out + x, tiles + tile * tile_cells + row_in_tile * tile_size_ + col_in_tile, count);
+      x += count;
+    }
+  }
+}
+
+bool TiledMap::isTiledMapFile(const std::string & file_name)
+{
+  std::ifstream file(file_name, std::ios::binary);
+  char magic[sizeof(kMagic)];
+  return file.read(magic, sizeof(magic)) && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
+
+void TiledMap::write(
+  const nav_msgs::msg::OccupancyGrid & map, const std::string & file_name,
+  uint32_t tile_size)
+{
+  if (tile_size == 0) {
+    throw std::runtime_error("The tile size of a tiled map must be positive");
+  }
+
+  std::ofstream file(file_name, std::ios::binary | std::ios::trunc);
+  if (!file) {
+    throw std::runtime_error("Failed to open " + file_name + " for writing");
+  }
+
+  const uint32_t width = map.info.width;
+  const uint32_t height = map.info.height;
+  file.write(kMagic, sizeof(kMagic));
+  writeUint32(file, kVersion);
+  writeUint32(file, width);
+  writeUint32(file, height);
+  writeUint32(file, tile_size);
+
+  const uint32_t tiles_x = (width + tile_size - 1) / tile_size;
+  const uint32_t tiles_y = (height + tile_size - 1) / tile_size;
+  std::vector<int8_t> tile(static_cast<size_t>(tile_size) * tile_size);
+  for (uint32_t ty = 0; ty < tiles_y; ty++) {
+    for (uint32_t tx = 0; tx < tiles_x; tx++) {
+      std::fill(tile.begin(), tile.end(), nav2_util::OCC_GRID_UNKNOWN);
+      const uint32_t x0 = tx * tile_size;
+      const uint32_t y0 = ty * tile_size;
+      const uint32_t tile_width = std::min(tile_size, width - x0);
+      const uint32_t tile_height = std::min(tile_size, height - y0);
+      for (uint32_t y = 0; y < tile_height; y++) {
+        std::memcpy(
+          tile.data() + static_cast<size_t>(y) * tile_size,
+          map.data.data() + static_cast<size_t>(y0 + y) * width + x0, tile_width);
+      }
+      file.write(reinterpret_cast<const char *>(tile.data()), tile.size());
+    }
+  }
+
+  if (!file.good()) {
+    throw std::runtime_error("Failed to write tiled map file " + file_name);
+  }
+}
+
+}  // namespace nav2_map_server
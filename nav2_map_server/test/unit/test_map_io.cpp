@@ -232,6 +232,57 @@ TEST_F(MapIOTester, loadSaveMapModes)
   verifyMapMsg(map_msg);
 }
 
+// Load map from a valid file. Save it as a tiled map with tiles smaller than the map,
+// then load it back whole and by regions from its memory-mapped tiles.
+// Succeeds all steps were passed without a problem or expection.
+TEST_F(MapIOTester, loadSaveTiledMap)
+{
+  // 1. Load map from YAML file
+  nav_msgs::msg::OccupancyGrid map_msg;
+  LOAD_MAP_STATUS status = loadMapFromYaml(path(TEST_DIR) / path(g_valid_yaml_file), map_msg);
+  ASSERT_EQ(status, LOAD_MAP_SUCCESS);
+
+  // 2. Save map as a tiled map
+  SaveParameters saveParameters;
+  fillSaveParameters(path(g_tmp_dir) / path(g_valid_map_name), TILED_MAP_FORMAT, saveParameters);
+
+  ASSERT_TRUE(saveMapToFile(map_msg, saveParameters));
+
+  // 3. Load the whole saved map and verify it
+  status = loadMapFromYaml(path(g_tmp_dir) / path(g_valid_yaml_file), map_msg);
+  ASSERT_EQ(status, LOAD_MAP_SUCCESS);
+
+  verifyMapMsg(map_msg);
+
+  // 4. Rewrite it in tiles crossed by the regions, and memory-map it
+  const std::string tiled_file = path(g_tmp_dir) / path(std::string(g_valid_map_name) + ".tmap");
+  ASSERT_NO_THROW(TiledMap::write(map_msg, tiled_file, 3));
+  TiledMap tiled_map;
+  status = loadMapFromYaml(path(g_tmp_dir) / path(g_valid_yaml_file), map_msg, &tiled_map);
+  ASSERT_EQ(status, LOAD_MAP_SUCCESS);
+  ASSERT_TRUE(tiled_map.isOpen());
+  ASSERT_TRUE(map_msg.data.empty());
+  ASSERT_EQ(map_msg.info.width, g_valid_image_width);
+  ASSERT_EQ(map_msg.info.height, g_valid_image_height);
+
+  // 5. Read regions and verify them
+  for (unsigned int y0 = 0; y0 < g_valid_image_height; y0++) {
+    for (unsigned int x0 = 0; x0 < g_valid_image_width; x0++) {
+      const unsigned int width = g_valid_image_width - x0;
+      const unsigned int height = g_valid_image_height - y0;
+      std::vector<int8_t> region(width * height);
+      tiled_map.getRegion(x0, y0, width, height, region.data());
+      for (unsigned int y = 0; y < height; y++) {
+        for (unsigned int x = 0; x < width; x++) {
+          ASSERT_EQ(
+            g_valid_image_content[(y0 + y) * g_valid_image_width + x0 + x],
+            region[y * width + x]);
+        }
+      }
+    }
+  }
+}
+
 // Try to load an invalid file with different ways.
 // Succeeds if all cases are got expected fail behaviours.
 TEST_F(MapIOTester, loadInvalidFile)
@@ -0,0 +1,95 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <geometry_msgs/msg/twist_stamped.hpp>
+#include <nav2_core/goal_checker.hpp>
+
+#include "nav2_mppi_controller/optimizer.hpp"
+#include "nav2_mppi_controller/tools/parameters_handler.hpp"
+
+#include "utils.hpp"
+
+// Compares the Float and Int16 storages of the noises, in the time of the optimizer
+// and in the difference of the command it returns from the one with float noises
+
+class RosLockGuard
+{
+public:
+  RosLockGuard() {rclcpp::init(0, nullptr);}
+  ~RosLockGuard() {rclcpp::shutdown();}
+};
+
+RosLockGuard g_rclcpp;
+
+geometry_msgs::msg::Twist evalCommand(
+  const std::string & noise_storage, int batch_size, benchmark::State * state)
+{
+  TestCostmapSettings costmap_settings{};
+  auto costmap_ros = getDummyCostmapRos(costmap_settings);
+  auto costmap = costmap_ros->getCostmap();
+
+  TestPose start_pose = costmap_settings.getCenterPose();
+  double path_step = costmap_settings.resolution;
+  TestPathSettings path_settings{start_pose, 50u, path_step, path_step};
+  TestOptimizerSettings optimizer_settings{batch_size, 56, 1, 10.0, "DiffDrive", true};
+  std::vector<std::string> critics = {{"GoalCritic"}, {"GoalAngleCritic"}, {"ObstaclesCritic"},
+    {"PathAngleCritic"}, {"PathFollowCritic"}, {"PreferForwardCritic"}};
+
+  auto [obst_x, obst_y] = costmap_settings.getCenterIJ();
+  addObstacle(costmap, {obst_x - 4, obst_y - 4, 8, 250});
+
+  auto options = getOptimizerOptions(optimizer_settings, critics);
+  options.parameter_overrides().emplace_back("dummy.noise_storage", noise_storage);
+  auto node = getDummyNode(options);
+  auto parameters_handler = std::make_unique<mppi::ParametersHandler>(node);
+  auto optimizer = getDummyOptimizer(node, costmap_ros, parameters_handler.get());
+
+  auto pose = getDummyPointStamped(node, start_pose);
+  auto velocity = getDummyTwist();
+  auto path = getIncrementalDummyPath(node, path_settings);
+  nav2_core::GoalChecker * dummy_goal_checker{nullptr};
+
+  geometry_msgs::msg::TwistStamped command;
+  if (state == nullptr) {
+    return optimizer->evalControl(pose, velocity, path, dummy_goal_checker).twist;
+  }
+  for (auto _ : *state) {
+    command = optimizer->evalControl(pose, velocity, path, dummy_goal_checker);
+  }
+  return command.twist;
+}
+
+static void BM_NoiseStorage(benchmark::State & state, const std::string & noise_storage)
+{
+  const int batch_size = state.range(0);
+  const auto reference = evalCommand("Float", batch_size, nullptr);
+  const auto command = evalCommand(noise_storage, batch_size, &state);
+
+  // Noises are seeded identically, so the difference only comes from their storage
+  state.counters["vx_error"] = std::fabs(command.linear.x - reference.linear.x);
+  state.counters["wz_error"] = std::fabs(command.angular.z - reference.angular.z);
+}
+
+BENCHMARK_CAPTURE(BM_NoiseStorage, Float, std::string("Float"))
+->Arg(1000)->Arg(2000)->Arg(4000)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_NoiseStorage, Int16, std::string("Int16"))
+->Arg(1000)->Arg(2000)->Arg(4000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
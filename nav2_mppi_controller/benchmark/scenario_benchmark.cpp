@@ -0,0 +1,367 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Sweeps the optimizer over a library of scenarios, motion models, critic sets,
+// batch sizes and time steps, reporting the nanoseconds of each stage of an
+// iteration and the heap allocations per cycle.
+//
+// Scenarios are loaded from the directory in the MPPI_BENCHMARK_SCENARIOS
+// environment variable, as pairs of <name>.costmap and <name>.path files holding
+// a serialized nav2_msgs/msg/Costmap and nav_msgs/msg/Path (e.g. as recorded
+// from the costmap_raw and plan topics). The robot starts at the first pose of
+// the path. <name>.snapshot files saved by the save_snapshot service of a costmap
+// are scenarios too, with the saved pose of the robot and footprint when known.
+// Synthetic scenarios are used when no directory is set.
+//
+// Each critic is also swept alone, giving the cost of each critic in the
+// critics stage. Cache misses are reported where perf events are available,
+// with a benchmark library built with libpfm, by passing
+// --benchmark_perf_counters=CYCLES,CACHE-MISSES.
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <geometry_msgs/msg/polygon.hpp>
+#include <geometry_msgs/msg/pose_stamped.hpp>
+#include <geometry_msgs/msg/twist.hpp>
+#include <nav_msgs/msg/path.hpp>
+#include <nav2_costmap_2d/cost_values.hpp>
+#include <nav2_costmap_2d/costmap_snapshot.hpp>
+#include <nav2_costmap_2d/footprint.hpp>
+#include <nav2_msgs/msg/costmap.hpp>
+#include <rclcpp/serialization.hpp>
+
+#include "nav2_mppi_controller/optimizer.hpp"
+#include "nav2_mppi_controller/tools/parameters_handler.hpp"
+
+#include "utils.hpp"
+
+// Count heap allocations by interposing the allocation functions of glibc,
+// which operator new and the aligned allocator of xtensor both end up in
+static std::atomic<size_t> g_allocations{0};
+
+#ifdef __GLIBC__
+extern "C" {
+void * __libc_malloc(size_t size);
+void * __libc_calloc(size_t count, size_t size);
+void * __libc_realloc(void * ptr, size_t size);
+void * __libc_memalign(size_t alignment, size_t size);
+
+void * malloc(size_t size)
+{
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_malloc(size);
+}
+
+void * calloc(size_t count, size_t size)
+{
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_calloc(count, size);
+}
+
+void * realloc(void * ptr, size_t size)
+{
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_realloc(ptr, size);
+}
+
+int posix_memalign(void ** ptr, size_t alignment, size_t size)
+{
+  if (alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0) {
+    return EINVAL;
+  }
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  *ptr = __libc_memalign(alignment, size);
+  return *ptr == nullptr && size != 0 ? ENOMEM : 0;
+}
+
+void * aligned_alloc(size_t alignment, size_t size)
+{
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_memalign(alignment, size);
+}
+}
+#endif
+
+class RosLockGuard
+{
+public:
+  RosLockGuard() {rclcpp::init(0, nullptr);}
+  ~RosLockGuard() {rclcpp::shutdown();}
+};
+
+RosLockGuard g_rclcpp;
+
+struct Scenario
+{
+  std::string name;
+  nav2_msgs::msg::Costmap costmap;
+  nav_msgs::msg::Path path;
+  geometry_msgs::msg::PoseStamped robot_pose;
+  geometry_msgs::msg::Polygon footprint;
+};
+
+struct StageTimes
+{
+  double noise{0.0};
+  double motion_model{0.0};
+  double rollout{0.0};
+  double critics{0.0};
+  double update{0.0};
+};
+
+/**
+ * Optimizer running the same steps as evalControl, timing the stages of each iteration
+ */
+class ProfilingOptimizer : public mppi::Optimizer
+{
+public:
+  void profile(
+    const geometry_msgs::msg::PoseStamped & robot_pose,
+    const geometry_msgs::msg::Twist & robot_speed,
+    const nav_msgs::msg::Path & plan, StageTimes & times)
+  {
+    using Clock = std::chrono::steady_clock;
+    auto elapsed = [](Clock::time_point & last) {
+        const auto now = Clock::now();
+        const double duration = std::chrono::duration<double, std::nano>(now - last).count();
+        last = now;
+        return duration;
+      };
+
+    prepare(robot_pose, robot_speed, plan, nullptr);
+    for (size_t i = 0; i < settings_.iteration_count; ++i) {
+      auto last = Clock::now();
+      noise_generator_.setNoisedControls(state_, control_sequence_);
+      noise_generator_.generateNextNoises();
+      times.noise += elapsed(last);
+      updateStateVelocities(state_);
+      times.motion_model += elapsed(last);
+      integrateStateVelocities(generated_trajectories_, state_);
+      times.rollout += elapsed(last);
+      critic_manager_.evalTrajectoriesScores(critics_data_);
+      times.critics += elapsed(last);
+      updateControlSequence();
+      times.update += elapsed(last);
+    }
+
+    if (settings_.shift_control_sequence) {
+      shiftControlSequence();
+    }
+  }
+};
+
+template<typename MessageT>
+bool loadMessage(const std::filesystem::path & file, MessageT & message)
+{
+  std::ifstream stream(file, std::ios::binary);
+  if (!stream) {
+    return false;
+  }
+  const std::vector<char> bytes{std::istreambuf_iterator<char>(stream), {}};
+
+  rclcpp::SerializedMessage serialized(bytes.size());
+  auto & buffer = serialized.get_rcl_serialized_message();
+  std::memcpy(buffer.buffer, bytes.data(), bytes.size());
+  buffer.buffer_length = bytes.size();
+  rclcpp::Serialization<MessageT>().deserialize_message(&serialized, &message);
+  return true;
+}
+
+bool loadSnapshot(const std::filesystem::path & file, Scenario & scenario)
+{
+  nav2_msgs::msg::CostmapSnapshot snapshot;
+  nav2_costmap_2d::Costmap2D costmap;
+  if (!nav2_costmap_2d::loadCostmapSnapshot(file.string(), snapshot) ||
+    !nav2_costmap_2d::decodeCostmap(snapshot.metadata, snapshot.data, costmap) ||
+    snapshot.path.poses.empty())
+  {
+    return false;
+  }
+
+  scenario.costmap.header = snapshot.header;
+  scenario.costmap.metadata = snapshot.metadata;
+  const unsigned char * costs = costmap.getCharMap();
+  scenario.costmap.data.assign(
+    costs, costs + costmap.getSizeInCellsX() * costmap.getSizeInCellsY());
+  scenario.path = snapshot.path;
+  const bool has_pose = rclcpp::Time(snapshot.robot_pose.header.stamp).nanoseconds() != 0;
+  scenario.robot_pose = has_pose ? snapshot.robot_pose : snapshot.path.poses.front();
+  scenario.footprint = snapshot.footprint;
+  return true;
+}
+
+std::vector<Scenario> getSyntheticScenarios()
+{
+  // A diagonal path across a free costmap, and the same path along an aisle of lethal walls
+  std::vector<Scenario> scenarios(2);
+  scenarios[0].name = "open";
+  scenarios[1].name = "aisle";
+  for (auto & scenario : scenarios) {
+    scenario.costmap.metadata.size_x = 200;
+    scenario.costmap.metadata.size_y = 200;
+    scenario.costmap.metadata.resolution = 0.05;
+    scenario.costmap.data.assign(200 * 200, nav2_costmap_2d::FREE_SPACE);
+    scenario.path.header.frame_id = "odom";
+    for (unsigned int i = 20; i < 180; i++) {
+      geometry_msgs::msg::PoseStamped pose;
+      pose.header.frame_id = "odom";
+      pose.pose.position.x = i * 0.05;
+      pose.pose.position.y = i * 0.05;
+      pose.pose.orientation.w = 1.0;
+      scenario.path.poses.push_back(pose);
+    }
+    scenario.robot_pose = scenario.path.poses.front();
+  }
+
+  for (unsigned int i = 0; i < 200; i++) {
+    for (int side : {-8, 8}) {
+      const int j = static_cast<int>(i) + side;
+      if (j >= 0 && j < 200) {
+        scenarios[1].costmap.data[j * 200 + i] = nav2_costmap_2d::LETHAL_OBSTACLE;
+      }
+    }
+  }
+  return scenarios;
+}
+
+std::vector<Scenario> getScenarios()
+{
+  const char * directory = std::getenv("MPPI_BENCHMARK_SCENARIOS");
+  if (directory == nullptr) {
+    return getSyntheticScenarios();
+  }
+
+  std::vector<Scenario> scenarios;
+  for (const auto & entry : std::filesystem::directory_iterator(directory)) {
+    Scenario scenario;
+    scenario.name = entry.path().stem().string();
+    if (entry.path().extension() == ".snapshot") {
+      if (loadSnapshot(entry.path(), scenario)) {
+        scenarios.push_back(scenario);
+      } else {
+        std::cerr << "Skipping snapshot " << scenario.name << " without a path\n";
+      }
+      continue;
+    }
+    if (entry.path().extension() != ".costmap") {
+      continue;
+    }
+
+    auto path_file = entry.path();
+    path_file.replace_extension(".path");
+    if (loadMessage(entry.path(), scenario.costmap) && loadMessage(path_file, scenario.path) &&
+      !scenario.path.poses.empty())
+    {
+      scenario.robot_pose = scenario.path.poses.front();
+      scenarios.push_back(scenario);
+    } else {
+      std::cerr << "Skipping scenario " << scenario.name << " without a path\n";
+    }
+  }
+  return scenarios;
+}
+
+void runScenario(
+  benchmark::State & state, const Scenario & scenario, const std::string & motion_model,
+  const std::vector<std::string> & critics)
+{
+  const int batch_size = state.range(0);
+  const int time_steps = state.range(1);
+
+  auto costmap_ros = getDummyCostmapRos();
+  auto costmap = costmap_ros->getCostmap();
+  const auto & metadata = scenario.costmap.metadata;
+  costmap->resizeMap(
+    metadata.size_x, metadata.size_y, metadata.resolution,
+    metadata.origin.position.x, metadata.origin.position.y);
+  std::memcpy(costmap->getCharMap(), scenario.costmap.data.data(), scenario.costmap.data.size());
+  if (scenario.footprint.points.empty()) {
+    costmap_ros->setRobotFootprint(getDummySquareFootprint(0.15));
+  } else {
+    costmap_ros->setRobotFootprint(
+      nav2_costmap_2d::toPointVector(
+        std::make_shared<geometry_msgs::msg::Polygon>(scenario.footprint)));
+  }
+
+  TestOptimizerSettings optimizer_settings{batch_size, time_steps, 1, 10.0, motion_model, true};
+  auto node = getDummyNode(getOptimizerOptions(optimizer_settings, critics));
+  auto parameters_handler = std::make_unique<mppi::ParametersHandler>(node);
+  ProfilingOptimizer optimizer;
+  optimizer.initialize(node, node->get_name(), costmap_ros, parameters_handler.get());
+
+  const auto & pose = scenario.robot_pose;
+  auto velocity = getDummyTwist();
+
+  StageTimes times;
+  const size_t allocations = g_allocations.load();
+  for (auto _ : state) {
+    optimizer.profile(pose, velocity, scenario.path, times);
+  }
+
+  const auto average = benchmark::Counter::kAvgIterations;
+  state.counters["noise_ns"] = benchmark::Counter(times.noise, average);
+  state.counters["motion_model_ns"] = benchmark::Counter(times.motion_model, average);
+  state.counters["rollout_ns"] = benchmark::Counter(times.rollout, average);
+  state.counters["critics_ns"] = benchmark::Counter(times.critics, average);
+  state.counters["update_ns"] = benchmark::Counter(times.update, average);
+  state.counters["allocations"] =
+    benchmark::Counter(static_cast<double>(g_allocations.load() - allocations), average);
+}
+
+int main(int argc, char ** argv)
+{
+  benchmark::Initialize(&argc, argv);
+
+  const std::vector<std::string> critics = {"ConstraintCritic", "CostCritic", "GoalCritic",
+    "GoalAngleCritic", "PathAlignCritic", "PathFollowCritic", "PathAngleCritic",
+    "PreferForwardCritic"};
+  std::vector<std::pair<std::string, std::vector<std::string>>> critic_sets = {
+    {"Default", critics}};
+  for (const auto & critic : critics) {
+    critic_sets.push_back({critic, {critic}});
+  }
+
+  for (const auto & scenario : getScenarios()) {
+    for (const std::string motion_model : {"DiffDrive", "Omni", "Ackermann"}) {
+      for (const auto & [set_name, set] : critic_sets) {
+        benchmark::RegisterBenchmark(
+          (scenario.name + "/" + motion_model + "/" + set_name).c_str(),
+          [scenario, motion_model, set = set](benchmark::State & state) {
+            runScenario(state, scenario, motion_model, set);
+          })
+        ->ArgsProduct({{500, 1000, 2000}, {28, 56}})
+        ->ArgNames({"batch_size", "time_steps"})
+        ->Unit(benchmark::kMillisecond);
+      }
+    }
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
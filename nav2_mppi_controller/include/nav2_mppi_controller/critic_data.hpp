@@ -15,6 +15,7 @@
 #ifndef NAV2_MPPI_CONTROLLER__CRITIC_DATA_HPP_
 #define NAV2_MPPI_CONTROLLER__CRITIC_DATA_HPP_
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -31,6 +32,7 @@
 #include "nav2_mppi_controller/models/trajectories.hpp"
 #include "nav2_mppi_controller/models/path.hpp"
 #include "nav2_mppi_controller/motion_models.hpp"
+#include "nav2_mppi_controller/tools/costmap_view.hpp"
 
 
 namespace mppi
@@ -55,6 +57,8 @@ struct CriticData
   std::shared_ptr<MotionModel> motion_model;
   std::optional<std::vector<bool>> path_pts_valid;
   std::optional<size_t> furthest_reached_path_point;
+  const CostmapView * costmap_view{nullptr};  ///< Costs of the cycle, if taken by the optimizer
+  std::vector<uint8_t> * collisions{nullptr};  ///< Trajectories found in collision, if culling
 };
 
 }  // namespace mppi
@@ -89,6 +89,28 @@ public:
     */
   virtual void score(CriticData & data) = 0;
 
+  /**
+    * @brief Whether the critic scores each trajectory independently of the others
+    * in the batch, so that it may be scored over chunks of the batch. The state
+    * of a chunk only holds the pose, speed and velocities, not the controls
+    * @return If the critic may be scored over chunks
+    */
+  virtual bool isChunkable() const
+  {
+    return false;
+  }
+
+  /**
+    * @brief Whether the critic flags the trajectories it finds in collision in
+    * CriticData::collisions when set, so that it is scored first and the critics
+    * scored over chunks only score the trajectories out of collision
+    * @return If the critic gates the other critics
+    */
+  virtual bool isGating() const
+  {
+    return false;
+  }
+
   /**
     * @brief Initialize critic
     */
@@ -103,11 +125,27 @@ public:
   }
 
 protected:
+  /**
+    * @brief Get the costs of the cycle taken by the optimizer, or of the costmap now
+    * when scored outside of the optimizer
+    * @param data Critic data to use in scoring
+    * @return Costmap view
+    */
+  const CostmapView & getCostmapView(const CriticData & data)
+  {
+    if (data.costmap_view) {
+      return *data.costmap_view;
+    }
+    costmap_view_.update(*costmap_);
+    return costmap_view_;
+  }
+
   bool enabled_;
   std::string name_, parent_name_;
   rclcpp_lifecycle::LifecycleNode::WeakPtr parent_;
   std::shared_ptr<nav2_costmap_2d::Costmap2DROS> costmap_ros_;
   nav2_costmap_2d::Costmap2D * costmap_{nullptr};
+  CostmapView costmap_view_;
 
   ParametersHandler * parameters_handler_;
   rclcpp::Logger logger_{rclcpp::get_logger("MPPIController")};
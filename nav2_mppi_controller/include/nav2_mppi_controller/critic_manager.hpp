@@ -15,8 +15,12 @@
 #ifndef NAV2_MPPI_CONTROLLER__CRITIC_MANAGER_HPP_
 #define NAV2_MPPI_CONTROLLER__CRITIC_MANAGER_HPP_
 
+#include <condition_variable>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 #include <pluginlib/class_loader.hpp>
 
@@ -58,7 +62,7 @@ public:
   /**
     * @brief Virtual Destructor for mppi::CriticManager
     */
-  virtual ~CriticManager() = default;
+  virtual ~CriticManager() {stopWorkers();}
 
   /**
     * @brief Configure critic manager on bringup and load plugins
@@ -77,6 +81,11 @@ public:
     */
   void evalTrajectoriesScores(CriticData & data) const;
 
+  /**
+    * @brief Shutdown the critic worker threads, if any
+    */
+  void stopWorkers();
+
 protected:
   /**
     * @brief Get parameters (critics to load)
@@ -93,6 +102,56 @@ protected:
     */
   std::string getFullName(const std::string & name);
 
+  /**
+    * @brief Split the critics between the gating ones, those scored over chunks of the batch
+    * and the others
+    */
+  void splitChunkedCritics();
+
+  /**
+    * @brief Score the gating critics and list the trajectories they found out of collision
+    * @param data Critic data to use in scoring
+    */
+  void scoreGatingCritics(CriticData & data) const;
+
+  /**
+    * @brief Raise the costs of the trajectories in collision to at least the highest cost of
+    * the others, as they were not scored by all critics
+    * @param data Critic data scored
+    */
+  void raiseCulledCosts(CriticData & data) const;
+
+  /**
+    * @brief Start the worker threads used to score critics concurrently
+    */
+  void startWorkers();
+
+  /**
+    * @brief Thread to execute critic scoring requests
+    */
+  void workerThread();
+
+  /**
+    * @brief Score critics from the pending request until none are left to claim
+    * @param guard Lock on the pool, held on entry and exit
+    */
+  void scorePendingCritics(std::unique_lock<std::mutex> & guard) const;
+
+  /**
+    * @brief Score the chunkable critics together, one chunk of the batch at a
+    * time, so each chunk is read from memory once for all of them. Only the
+    * trajectories out of collision are scored if some were culled
+    * @param data Critic data to use in scoring
+    */
+  void scoreChunks(CriticData & data) const;
+
+  /**
+    * @brief Score a single critic into its own cost buffer
+    * @param idx Index of the critic to score
+    * @param data Shared critic data of the current request
+    */
+  void scoreCritic(size_t idx, const CriticData & data) const;
+
 protected:
   rclcpp_lifecycle::LifecycleNode::WeakPtr parent_;
   std::shared_ptr<nav2_costmap_2d::Costmap2DROS> costmap_ros_;
@@ -103,6 +162,31 @@ protected:
   std::unique_ptr<pluginlib::ClassLoader<critics::CriticFunction>> loader_;
   Critics critics_;
 
+  // Critics scored over chunks of the batch, and the others, by index in critics_
+  unsigned int critic_chunk_size_{0};
+  std::vector<size_t> chunked_critics_, unchunked_critics_;
+  mutable models::State chunk_state_;
+  mutable models::Trajectories chunk_trajectories_;
+  mutable xt::xtensor<float, 1> chunk_costs_;
+
+  // Gating critics, scored first, and the trajectories they found out of collision
+  bool cull_colliding_trajectories_{false};
+  std::vector<size_t> gating_critics_;
+  mutable std::vector<uint8_t> collisions_;
+  mutable std::vector<size_t> surviving_rows_;
+  mutable bool culled_{false};
+
+  // Pool of workers to score critics concurrently, each into its own cost buffer
+  unsigned int critic_threads_{1};
+  std::vector<std::thread> workers_;
+  mutable std::mutex pool_lock_;
+  mutable std::condition_variable work_cond_, done_cond_;
+  mutable CriticData * pending_data_{nullptr};
+  mutable size_t next_critic_{0}, completed_critics_{0};
+  mutable std::vector<xt::xtensor<float, 1>> critic_costs_;
+  mutable std::vector<uint8_t> critic_fail_flags_;
+  bool active_{false};
+
   rclcpp::Logger logger_{rclcpp::get_logger("MPPIController")};
 };
 
@@ -41,6 +41,11 @@ public:
    */
   void score(CriticData & data) override;
 
+  /**
+   * @brief Trajectories are scored independently, so may be scored over chunks
+   */
+  bool isChunkable() const override {return true;}
+
   float getMaxVelConstraint() {return max_vel_;}
   float getMinVelConstraint() {return min_vel_;}
 
@@ -17,6 +17,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "nav2_costmap_2d/footprint_collision_checker.hpp"
 #include "nav2_costmap_2d/inflation_layer.hpp"
@@ -47,6 +48,8 @@ public:
    */
   void score(CriticData & data) override;
 
+  bool isGating() const override {return true;}
+
 protected:
   /**
     * @brief Checks if cost represents a collision
@@ -63,9 +66,9 @@ protected:
     if (consider_footprint_ &&
       (cost >= possible_collision_cost_ || possible_collision_cost_ < 1.0f))
     {
-      score_cost = static_cast<float>(collision_checker_.footprintCostAtPose(
+      score_cost = static_cast<float>(collision_checker_.footprintCostAtPoseQuantized(
           static_cast<double>(x), static_cast<double>(y), static_cast<double>(theta),
-          costmap_ros_->getRobotFootprint()));
+          costmap_ros_->getRobotFootprint(), footprint_headings_));
     }
 
     switch (static_cast<unsigned char>(score_cost)) {
@@ -89,45 +92,12 @@ protected:
     */
   inline float findCircumscribedCost(std::shared_ptr<nav2_costmap_2d::Costmap2DROS> costmap);
 
-  /**
-    * @brief An implementation of worldToMap fully using floats
-    * @param wx Float world X coord
-    * @param wy Float world Y coord
-    * @param mx unsigned int map X coord
-    * @param my unsigned into map Y coord
-    * @return if successsful
-    */
-  inline bool worldToMapFloat(float wx, float wy, unsigned int & mx, unsigned int & my) const
-  {
-    if (wx < origin_x_ || wy < origin_y_) {
-      return false;
-    }
-
-    mx = static_cast<unsigned int>((wx - origin_x_) / resolution_);
-    my = static_cast<unsigned int>((wy - origin_y_) / resolution_);
-
-    if (mx < size_x_ && my < size_y_) {
-      return true;
-    }
-    return false;
-  }
-
-  /**
-    * @brief A local implementation of getIndex
-    * @param mx unsigned int map X coord
-    * @param my unsigned into map Y coord
-    * @return Index
-    */
-  inline unsigned int getIndex(unsigned int mx, unsigned int my) const
-  {
-    return my * size_x_ + mx;
-  }
-
   nav2_costmap_2d::FootprintCollisionChecker<nav2_costmap_2d::Costmap2D *>
   collision_checker_{nullptr};
   float possible_collision_cost_;
 
   bool consider_footprint_{true};
+  unsigned int footprint_headings_{0};
   bool is_tracking_unknown_{true};
   float circumscribed_radius_{0.0f};
   float circumscribed_cost_{0.0f};
@@ -136,8 +106,8 @@ protected:
   float weight_{0};
   unsigned int trajectory_point_step_;
 
-  float origin_x_, origin_y_, resolution_;
-  unsigned int size_x_, size_y_;
+  // Center costs of the sampled points of a trajectory, kept to avoid reallocations
+  std::vector<float> pose_costs_;
 
   float near_goal_distance_;
   std::string inflation_layer_name_;
@@ -42,6 +42,11 @@ public:
    */
   void score(CriticData & data) override;
 
+  /**
+   * @brief Trajectories are scored independently, so may be scored over chunks
+   */
+  bool isChunkable() const override {return true;}
+
 protected:
   unsigned int power_{0};
   float weight_{0};
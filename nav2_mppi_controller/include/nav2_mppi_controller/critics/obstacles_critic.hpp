@@ -17,7 +17,9 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "nav2_costmap_2d/distance_field.hpp"
 #include "nav2_costmap_2d/footprint_collision_checker.hpp"
 #include "nav2_costmap_2d/inflation_layer.hpp"
 #include "nav2_mppi_controller/critic_function.hpp"
@@ -49,6 +51,8 @@ public:
    */
   void score(CriticData & data) override;
 
+  bool isGating() const override {return true;}
+
 protected:
   /**
     * @brief Checks if cost represents a collision
@@ -59,12 +63,23 @@ protected:
 
   /**
     * @brief cost at a robot pose
+    * @param center_cost Cost at the center of the pose, CostmapView::OUTSIDE if outside
     * @param x X of pose
     * @param y Y of pose
     * @param theta theta of pose
     * @return Collision information at pose
     */
-  inline CollisionCost costAtPose(float x, float y, float theta);
+  inline CollisionCost costAtPose(float center_cost, float x, float y, float theta);
+
+  /**
+    * @brief Distance to obstacle at a robot pose, sampled from the distance field
+    * @param x X of pose
+    * @param y Y of pose
+    * @param theta theta of pose
+    * @return float Distance from the robot's inscribed radius to the closest obstacle,
+    * negative if the pose is in collision
+    */
+  inline float distanceAtPose(float x, float y, float theta);
 
   /**
     * @brief Distance to obstacle from cost
@@ -87,14 +102,23 @@ protected:
   collision_checker_{nullptr};
 
   bool consider_footprint_{true};
+  unsigned int footprint_headings_{0};
   float collision_cost_{0};
   float inflation_scale_factor_{0}, inflation_radius_{0};
 
+  bool use_distance_field_{false};
+  nav2_costmap_2d::DistanceField distance_field_;
+  float inscribed_radius_{0};
+  bool is_tracking_unknown_{true};
+
   float possible_collision_cost_;
   float collision_margin_distance_;
   float near_goal_distance_;
   float circumscribed_cost_{0}, circumscribed_radius_{0};
 
+  // Center costs of the points of a trajectory, kept to avoid reallocations
+  std::vector<float> pose_costs_;
+
   unsigned int power_{0};
   float repulsion_weight_, critical_weight_{0};
   std::string inflation_layer_name_;
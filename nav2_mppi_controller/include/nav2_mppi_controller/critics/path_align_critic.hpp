@@ -15,8 +15,11 @@
 #ifndef NAV2_MPPI_CONTROLLER__CRITICS__PATH_ALIGN_CRITIC_HPP_
 #define NAV2_MPPI_CONTROLLER__CRITICS__PATH_ALIGN_CRITIC_HPP_
 
+#include <vector>
+
 #include "nav2_mppi_controller/critic_function.hpp"
 #include "nav2_mppi_controller/models/state.hpp"
+#include "nav2_mppi_controller/tools/path_point_field.hpp"
 #include "nav2_mppi_controller/tools/utils.hpp"
 
 namespace mppi::critics
@@ -44,14 +47,38 @@ public:
    */
   void score(CriticData & data) override;
 
+  /**
+   * @brief Trajectories are scored independently, so may be scored over chunks
+   */
+  bool isChunkable() const override {return true;}
+
 protected:
+  /**
+   * @brief Score trajectories by their distance to the nearest valid path point,
+   * looked up in a field precomputed around the path
+   * @param data Critic data to use in scoring
+   * @param path Poses of the path up to the furthest reached point
+   * @param path_pts_valid Whether each path point is free of obstacles
+   * @param cost [out] Cost of each trajectory
+   */
+  void scoreWithPathPointField(
+    const CriticData & data, const std::vector<utils::Pose2D> & path,
+    const std::vector<bool> & path_pts_valid, xt::xtensor<float, 1> & cost);
+
   size_t offset_from_furthest_{0};
   int trajectory_point_step_{0};
   float threshold_to_consider_{0};
   float max_path_occupancy_ratio_{0};
   bool use_path_orientations_{false};
+  bool use_path_point_field_{false};
   unsigned int power_{0};
   float weight_{0};
+
+  // Nearest path points around the path they were computed for
+  PathPointField field_;
+  std::vector<utils::Pose2D> field_path_;
+  std::vector<bool> field_valid_;
+  float field_margin_{1.0f};
 };
 
 }  // namespace mppi::critics
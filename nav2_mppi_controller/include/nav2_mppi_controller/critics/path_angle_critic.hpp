@@ -71,6 +71,11 @@ public:
    */
   void score(CriticData & data) override;
 
+  /**
+   * @brief Trajectories are scored independently, so may be scored over chunks
+   */
+  bool isChunkable() const override {return true;}
+
 protected:
   float max_angle_to_furthest_{0};
   float threshold_to_consider_{0};
@@ -47,6 +47,11 @@ public:
    */
   void score(CriticData & data) override;
 
+  /**
+   * @brief Trajectories are scored independently, so may be scored over chunks
+   */
+  bool isChunkable() const override {return true;}
+
 protected:
   float threshold_to_consider_{0};
   size_t offset_from_furthest_{0};
@@ -44,11 +44,15 @@ struct ControlSequence
   xt::xtensor<float, 1> vy;
   xt::xtensor<float, 1> wz;
 
+  /**
+    * @brief Reset the controls to zero, in place when their size is unchanged
+    */
   void reset(unsigned int time_steps)
   {
-    vx = xt::zeros<float>({time_steps});
-    vy = xt::zeros<float>({time_steps});
-    wz = xt::zeros<float>({time_steps});
+    for (auto * controls : {&vx, &vy, &wz}) {
+      controls->resize({time_steps});
+      controls->fill(0.0f);
+    }
   }
 };
 
@@ -46,17 +46,14 @@ struct State
   geometry_msgs::msg::Twist speed;
 
   /**
-    * @brief Reset state data
+    * @brief Reset state data, in place when its shape is unchanged
     */
   void reset(unsigned int batch_size, unsigned int time_steps)
   {
-    vx = xt::zeros<float>({batch_size, time_steps});
-    vy = xt::zeros<float>({batch_size, time_steps});
-    wz = xt::zeros<float>({batch_size, time_steps});
-
-    cvx = xt::zeros<float>({batch_size, time_steps});
-    cvy = xt::zeros<float>({batch_size, time_steps});
-    cwz = xt::zeros<float>({batch_size, time_steps});
+    for (auto * data : {&vx, &vy, &wz, &cvx, &cvy, &cwz}) {
+      data->resize({batch_size, time_steps});
+      data->fill(0.0f);
+    }
   }
 };
 }  // namespace mppi::models
@@ -37,13 +37,14 @@ struct Trajectories
   xt::xtensor<float, 2> yaws;
 
   /**
-    * @brief Reset state data
+    * @brief Reset state data, in place when its shape is unchanged
     */
   void reset(unsigned int batch_size, unsigned int time_steps)
   {
-    x = xt::zeros<float>({batch_size, time_steps});
-    y = xt::zeros<float>({batch_size, time_steps});
-    yaws = xt::zeros<float>({batch_size, time_steps});
+    for (auto * data : {&x, &y, &yaws}) {
+      data->resize({batch_size, time_steps});
+      data->fill(0.0f);
+    }
   }
 };
 
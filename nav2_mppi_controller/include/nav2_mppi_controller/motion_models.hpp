@@ -15,6 +15,7 @@
 #ifndef NAV2_MPPI_CONTROLLER__MOTION_MODELS_HPP_
 #define NAV2_MPPI_CONTROLLER__MOTION_MODELS_HPP_
 
+#include <cmath>
 #include <cstdint>
 #include <string>
 
@@ -161,11 +162,16 @@ public:
    */
   void applyConstraints(models::ControlSequence & control_sequence) override
   {
-    auto & vx = control_sequence.vx;
-    auto & wz = control_sequence.wz;
-
-    auto view = xt::masked_view(wz, xt::fabs(vx) / xt::fabs(wz) < min_turning_r_);
-    view = xt::sign(wz) * vx / min_turning_r_;
+    const float * vx = control_sequence.vx.data();
+    float * wz = control_sequence.wz.data();
+    const size_t size = control_sequence.vx.size();
+
+    for (size_t i = 0; i != size; i++) {
+      if (std::fabs(vx[i]) / std::fabs(wz[i]) < min_turning_r_) {
+        const float wz_sign = wz[i] > 0.0f ? 1.0f : (wz[i] < 0.0f ? -1.0f : 0.0f);
+        wz[i] = wz_sign * vx[i] / min_turning_r_;
+      }
+    }
   }
 
   /**
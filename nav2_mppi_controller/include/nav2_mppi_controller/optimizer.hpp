@@ -31,6 +31,7 @@
 #include "nav2_costmap_2d/costmap_2d_ros.hpp"
 #include "nav2_core/goal_checker.hpp"
 #include "nav2_core/controller_exceptions.hpp"
+#include "nav2_util/memory_registry.hpp"
 
 #include "geometry_msgs/msg/twist.hpp"
 #include "geometry_msgs/msg/pose_stamped.hpp"
@@ -106,9 +107,9 @@ public:
 
   /**
    * @brief Get the optimal trajectory for a cycle for visualization
-   * @return Optimal trajectory
+   * @return Optimal trajectory, valid until the next call
    */
-  xt::xtensor<float, 2> getOptimizedTrajectory();
+  const xt::xtensor<float, 2> & getOptimizedTrajectory();
 
   /**
    * @brief Set the maximum speed based on the speed limits callback
@@ -124,10 +125,23 @@ public:
 
 protected:
   /**
-   * @brief Main function to generate, score, and return trajectories
+   * @brief Main function to generate, score, and return trajectories, iterating
+   * until iteration_count or until the control sequence converges
    */
   void optimize();
 
+  /**
+   * @brief Get the largest change of a control in the last iteration
+   * @return Largest absolute difference from the previous control sequence
+   */
+  float getControlSequenceChange() const;
+
+  /**
+   * @brief Scale the batch size towards the target compute time, if adaptive
+   * @param compute_time Time taken to optimize this cycle (s)
+   */
+  void adaptBatchSize(double compute_time);
+
   /**
    * @brief Prepare state information on new request for trajectory rollouts
    * @param robot_pose Pose of the robot at given time
@@ -168,6 +182,11 @@ protected:
    */
   void applyControlSequenceConstraints();
 
+  /**
+   * @brief Account for the bytes of the batch tensors in the nav2_util::MemoryRegistry
+   */
+  void updateTensorMemory();
+
   /**
    * @brief  Update velocities in state
    * @param state fill state with velocities on each step
@@ -188,7 +207,7 @@ protected:
   void propagateStateVelocitiesFromInitials(models::State & state) const;
 
   /**
-   * @brief Rollout velocities in state to poses
+   * @brief Rollout velocities in state to poses, split over rollout_threads_ threads
    * @param trajectories to rollout
    * @param state fill state
    */
@@ -250,6 +269,18 @@ protected:
   NoiseGenerator noise_generator_;
 
   models::OptimizerSettings settings_;
+  unsigned int rollout_threads_{1};
+  double controller_period_{0.0};
+
+  // Convergence of the iterations, from the control sequence before the last update
+  float convergence_threshold_{0.0f};
+  models::ControlSequence previous_control_sequence_;
+  size_t iterations_{0};
+
+  bool adaptive_batch_size_{false};
+  unsigned int min_batch_size_{500};
+  unsigned int max_batch_size_{4000};
+  double compute_time_ratio_{0.5};
 
   models::State state_;
   models::ControlSequence control_sequence_;
@@ -257,10 +288,14 @@ protected:
   models::Trajectories generated_trajectories_;
   models::Path path_;
   xt::xtensor<float, 1> costs_;
+  xt::xtensor<float, 2> optimal_sequence_;
+  xt::xtensor<float, 2> optimal_trajectory_;
+  CostmapView costmap_view_;
+  nav2_util::MemoryTracker tensor_memory_{"mppi/tensors"};
 
   CriticData critics_data_ =
   {state_, generated_trajectories_, path_, costs_, settings_.model_dt, false, nullptr, nullptr,
-    std::nullopt, std::nullopt};  /// Caution, keep references
+    std::nullopt, std::nullopt, &costmap_view_};  /// Caution, keep references
 
   rclcpp::Logger logger_{rclcpp::get_logger("MPPIController")};
 };
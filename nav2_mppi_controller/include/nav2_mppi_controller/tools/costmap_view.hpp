@@ -0,0 +1,129 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_MPPI_CONTROLLER__TOOLS__COSTMAP_VIEW_HPP_
+#define NAV2_MPPI_CONTROLLER__TOOLS__COSTMAP_VIEW_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "nav2_costmap_2d/costmap_2d.hpp"
+
+namespace mppi
+{
+
+/**
+ * @class mppi::CostmapView
+ * @brief Copy of the costs of a costmap as floats, surrounded by a border of cells
+ * outside of it, taken once per cycle for the critics. Points are converted to cells
+ * with a precomputed inverse resolution and clamped into the border rather than bounds
+ * checked, so the costs of a row of points are gathered without branching.
+ */
+class CostmapView
+{
+public:
+  /// Cost read at points outside of the costmap
+  static constexpr float OUTSIDE = -1.0f;
+
+  /**
+    * @brief Copy the costs and geometry of a costmap
+    * @param costmap Costmap to copy, must be locked by the caller
+    */
+  void update(const nav2_costmap_2d::Costmap2D & costmap)
+  {
+    size_x_ = costmap.getSizeInCellsX();
+    size_y_ = costmap.getSizeInCellsY();
+    origin_x_ = static_cast<float>(costmap.getOriginX());
+    origin_y_ = static_cast<float>(costmap.getOriginY());
+    inv_resolution_ = static_cast<float>(1.0 / costmap.getResolution());
+    max_x_ = static_cast<float>(size_x_);
+    max_y_ = static_cast<float>(size_y_);
+    padded_size_x_ = size_x_ + 2;
+
+    costs_.resize(padded_size_x_ * (size_y_ + 2));
+    std::fill_n(costs_.begin(), padded_size_x_, OUTSIDE);
+    std::fill_n(costs_.end() - padded_size_x_, padded_size_x_, OUTSIDE);
+    const unsigned char * charmap = costmap.getCharMap();
+    for (unsigned int y = 0; y != size_y_; y++) {
+      float * row = costs_.data() + (y + 1) * padded_size_x_;
+      const unsigned char * costmap_row = charmap + y * size_x_;
+      row[0] = OUTSIDE;
+      for (unsigned int x = 0; x != size_x_; x++) {
+        row[x + 1] = static_cast<float>(costmap_row[x]);
+      }
+      row[size_x_ + 1] = OUTSIDE;
+    }
+  }
+
+  /**
+    * @brief Get the cost at a point
+    * @param wx X of the point
+    * @param wy Y of the point
+    * @return Cost, or OUTSIDE if the point is outside of the costmap
+    */
+  inline float getCost(float wx, float wy) const
+  {
+    return costs_[getIndex(wx, wy)];
+  }
+
+  /**
+    * @brief Get the costs at points spaced by a stride in arrays of coordinates,
+    * such as a row of trajectory points
+    * @param wx X of the first point
+    * @param wy Y of the first point
+    * @param count Number of points
+    * @param stride Distance between consecutive points in the arrays
+    * @param costs Costs of the points, or OUTSIDE for those outside of the costmap
+    */
+  inline void getCosts(
+    const float * wx, const float * wy, size_t count, size_t stride, float * costs) const
+  {
+    const float * data = costs_.data();
+    for (size_t i = 0; i != count; i++) {
+      costs[i] = data[getIndex(wx[i * stride], wy[i * stride])];
+    }
+  }
+
+  /**
+    * @brief Whether a costmap has been copied
+    * @return bool If initialized
+    */
+  bool isInitialized() const {return !costs_.empty();}
+
+protected:
+  /**
+    * @brief Get the index of the padded cell of a point, in the border for points
+    * outside of the costmap, not a number included
+    * @param wx X of the point
+    * @param wy Y of the point
+    * @return Index of the padded cell
+    */
+  inline int getIndex(float wx, float wy) const
+  {
+    const float mx = std::min(max_x_, std::max(-1.0f, (wx - origin_x_) * inv_resolution_));
+    const float my = std::min(max_y_, std::max(-1.0f, (wy - origin_y_) * inv_resolution_));
+    return static_cast<int>(my + 1.0f) * static_cast<int>(padded_size_x_) +
+           static_cast<int>(mx + 1.0f);
+  }
+
+  std::vector<float> costs_;
+  unsigned int size_x_{0}, size_y_{0}, padded_size_x_{2};
+  float origin_x_{0.0f}, origin_y_{0.0f}, inv_resolution_{1.0f};
+  float max_x_{0.0f}, max_y_{0.0f};
+};
+
+}  // namespace mppi
+
+#endif  // NAV2_MPPI_CONTROLLER__TOOLS__COSTMAP_VIEW_HPP_
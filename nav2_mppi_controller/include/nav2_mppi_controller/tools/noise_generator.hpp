@@ -15,10 +15,13 @@
 #ifndef NAV2_MPPI_CONTROLLER__TOOLS__NOISE_GENERATOR_HPP_
 #define NAV2_MPPI_CONTROLLER__TOOLS__NOISE_GENERATOR_HPP_
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <memory>
 #include <thread>
 #include <mutex>
+#include <vector>
 #include <condition_variable>
 
 // xtensor creates warnings that needs to be ignored as we are building with -Werror
@@ -33,10 +36,24 @@
 #include "nav2_mppi_controller/tools/parameters_handler.hpp"
 #include "nav2_mppi_controller/models/control_sequence.hpp"
 #include "nav2_mppi_controller/models/state.hpp"
+#include "nav2_mppi_controller/tools/normal_generator.hpp"
 
 namespace mppi
 {
 
+/**
+ * @brief Strategies to sample the noises of the controls
+ * GAUSSIAN samples each time step independently, CORRELATED filters them over
+ * time as an Ornstein-Uhlenbeck process and HALTON interpolates knots placed by
+ * a randomly shifted Halton sequence
+ */
+enum class NoiseMode
+{
+  GAUSSIAN,
+  CORRELATED,
+  HALTON
+};
+
 /**
  * @class mppi::NoiseGenerator
  * @brief Generates noise trajectories from optimal trajectory
@@ -84,6 +101,12 @@ public:
    */
   void reset(mppi::models::OptimizerSettings & settings, bool is_holonomic);
 
+  /**
+   * @brief Get the bytes of the noise tensors
+   * @return Number of bytes
+   */
+  size_t getMemoryUsage();
+
 protected:
   /**
    * @brief Thread to execute noise generation process
@@ -92,20 +115,54 @@ protected:
 
   /**
    * @brief Generate random controls by gaussian noise with mean in
-   * control_sequence_
+   * control_sequence_, split over noise_threads_ threads
    *
    * @return tensor of shape [ batch_size_, time_steps_, 2]
    * where 2 stands for v, w
    */
   void generateNoisedControls();
 
+  /**
+   * @brief Generate the noises of a control for a range of batches
+   * @param noises [out] Noises of the control, from the first batch to generate
+   * @param time_steps Number of time steps of each batch
+   * @param std Standard deviation of the noises
+   * @param stream Index of the stream of the control in this generation
+   * @param shifts Random shifts of the Halton knots of the control
+   * @param batch_begin First batch to generate
+   * @param batch_end Batch after the last one to generate
+   */
+  void generateNoises(
+    float * noises, size_t time_steps, float std, uint64_t stream,
+    const std::vector<float> & shifts, size_t batch_begin, size_t batch_end) const;
+
   xt::xtensor<float, 2> noises_vx_;
   xt::xtensor<float, 2> noises_vy_;
   xt::xtensor<float, 2> noises_wz_;
 
+  // Noises stored as steps of their standard deviation in 16 bits, halving the
+  // memory read every iteration, used instead of the floats when quantize_noises_
+  bool quantize_noises_{false};
+  static constexpr float quantization_steps_{4096.0f};
+  xt::xtensor<int16_t, 2> quantized_noises_vx_;
+  xt::xtensor<int16_t, 2> quantized_noises_vy_;
+  xt::xtensor<int16_t, 2> quantized_noises_wz_;
+
   mppi::models::OptimizerSettings settings_;
   bool is_holonomic_;
 
+  // Each generation samples new streams of the normal generator, so noises
+  // only depend on the seed and the number of generations
+  NormalGenerator normal_generator_;
+  uint64_t generations_{0};
+  unsigned int noise_threads_{1};
+
+  NoiseMode noise_mode_{NoiseMode::GAUSSIAN};
+  float noise_correlation_{0.8f};
+  unsigned int noise_knots_{4};
+  // Prime base of the Halton sequence for each knot of each control
+  std::vector<unsigned int> halton_bases_;
+
   std::thread noise_thread_;
   std::condition_variable noise_cond_;
   std::mutex noise_lock_;
@@ -0,0 +1,88 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_MPPI_CONTROLLER__TOOLS__NORMAL_GENERATOR_HPP_
+#define NAV2_MPPI_CONTROLLER__TOOLS__NORMAL_GENERATOR_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace mppi
+{
+
+/**
+ * @class mppi::NormalGenerator
+ * @brief Generates standard normal samples from a Philox4x32-10 counter based
+ * generator and the Box-Muller transform. Sample i of a stream only depends on
+ * the seed, the stream and i, so any part of a stream can be generated on any
+ * thread in any order with the same results.
+ */
+class NormalGenerator
+{
+public:
+  /**
+    * @brief Constructor for mppi::NormalGenerator
+    * @param seed Seed of the streams
+    */
+  explicit NormalGenerator(uint64_t seed = 0)
+  : seed_(seed) {}
+
+  /**
+    * @brief Set the seed of the streams
+    * @param seed Seed of the streams
+    */
+  void seed(uint64_t seed) {seed_ = seed;}
+
+  /**
+    * @brief Fill a buffer with samples of a normal distribution centered on zero
+    * @param data Buffer receiving samples begin to end of the stream
+    * @param begin Index in the stream of the first sample
+    * @param end Index in the stream after the last sample
+    * @param std Standard deviation of the samples
+    * @param stream Index of the stream to sample
+    */
+  void fill(float * data, size_t begin, size_t end, float std, uint64_t stream) const;
+
+  /**
+    * @brief Sample a uniform distribution over (0, 1)
+    * @param index Index in the stream of the sample
+    * @param stream Index of the stream to sample
+    * @return Sample of the stream
+    */
+  float uniform(uint64_t index, uint64_t stream) const;
+
+  /**
+    * @brief Quantile function of the standard normal distribution
+    * @param probability Probability in (0, 1)
+    * @return Value under which a sample falls with this probability
+    */
+  static float quantile(float probability);
+
+  /**
+    * @brief Philox4x32-10 bijection of a counter under a key
+    * @param counter Counter to encrypt
+    * @param key Key to encrypt with
+    * @return Four random words
+    */
+  static std::array<uint32_t, 4> philox(
+    std::array<uint32_t, 4> counter, std::array<uint32_t, 2> key);
+
+protected:
+  uint64_t seed_;
+};
+
+}  // namespace mppi
+
+#endif  // NAV2_MPPI_CONTROLLER__TOOLS__NORMAL_GENERATOR_HPP_
@@ -16,6 +16,7 @@
 #define NAV2_MPPI_CONTROLLER__TOOLS__PARAMETERS_HANDLER_HPP_
 
 #include <functional>
+#include <mutex>
 #include <string>
 #include <type_traits>
 #include <unordered_map>
@@ -63,13 +64,21 @@ public:
   void start();
 
   /**
-    * @brief Dynamic parameter callback
+    * @brief Dynamic parameter callback. The changes are applied right away if the
+    * parameters are not locked, or staged for applyStagedParameters() otherwise, so that
+    * the callback never waits on the controller computing a command
     * @param parameter Parameter changes to process
     * @return Set Parameter Result
     */
   rcl_interfaces::msg::SetParametersResult dynamicParamsCallback(
     std::vector<rclcpp::Parameter> parameters);
 
+  /**
+    * @brief Apply the parameter changes staged while the parameters were locked,
+    * to be called with the lock of getLock() held, at the start of a control cycle
+    */
+  void applyStagedParameters();
+
   /**
     * @brief Get an object to retreive parameters
     * @param ns Namespace to get parameters within
@@ -138,6 +147,13 @@ protected:
   template<typename ParamT, typename SettingT, typename NodeT>
   void setParam(SettingT & setting, const std::string & name, NodeT node) const;
 
+  /**
+    * @brief Apply parameter changes, running the pre and post callbacks around them,
+    * with the lock of getLock() held
+    * @param parameters Parameter changes to apply
+    */
+  void applyParameters(const std::vector<rclcpp::Parameter> & parameters);
+
   /**
     * @brief Converts parameter type to real types
     * @param parameter Parameter to convert into real type
@@ -147,6 +163,9 @@ protected:
   static auto as(const rclcpp::Parameter & parameter);
 
   std::mutex parameters_change_mutex_;
+  // Changes received while the parameters were locked, applied at the next cycle
+  std::mutex staged_parameters_mutex_;
+  std::vector<rclcpp::Parameter> staged_parameters_;
   rclcpp::Logger logger_{rclcpp::get_logger("MPPIController")};
   rclcpp::node_interfaces::OnSetParametersCallbackHandle::SharedPtr
     on_set_param_handler_;
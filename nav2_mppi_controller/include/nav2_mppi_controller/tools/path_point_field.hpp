@@ -0,0 +1,141 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_MPPI_CONTROLLER__TOOLS__PATH_POINT_FIELD_HPP_
+#define NAV2_MPPI_CONTROLLER__TOOLS__PATH_POINT_FIELD_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <vector>
+
+#include "nav2_mppi_controller/tools/utils.hpp"
+
+namespace mppi
+{
+
+/**
+ * @class mppi::PathPointField
+ * @brief Grid around a path holding the index of the nearest path point of each
+ * cell, propagated from the path points as a wavefront, so the nearest path
+ * point of a position is looked up in constant time
+ */
+class PathPointField
+{
+public:
+  /**
+    * @brief Compute the field of a path
+    * @param path Poses of the path
+    * @param valid Whether each pose may be the nearest of a cell
+    * @param resolution Size of the cells
+    * @param margin Distance around the valid poses the grid covers
+    */
+  void update(
+    const std::vector<utils::Pose2D> & path, const std::vector<bool> & valid,
+    float resolution, float margin)
+  {
+    nearest_.clear();
+    float min_x = std::numeric_limits<float>::max(), min_y = min_x;
+    float max_x = std::numeric_limits<float>::lowest(), max_y = max_x;
+    for (size_t i = 0; i != path.size(); i++) {
+      if (valid[i]) {
+        min_x = std::min(min_x, path[i].x);
+        min_y = std::min(min_y, path[i].y);
+        max_x = std::max(max_x, path[i].x);
+        max_y = std::max(max_y, path[i].y);
+      }
+    }
+    if (min_x > max_x) {
+      return;
+    }
+
+    resolution_ = resolution;
+    origin_x_ = min_x - margin;
+    origin_y_ = min_y - margin;
+    size_x_ = static_cast<unsigned int>((max_x - min_x + 2.0f * margin) / resolution) + 1;
+    size_y_ = static_cast<unsigned int>((max_y - min_y + 2.0f * margin) / resolution) + 1;
+    nearest_.assign(size_x_ * size_y_, -1);
+    std::vector<float> distances(nearest_.size(), std::numeric_limits<float>::max());
+
+    // Seed the cells of the path points, then propagate each cell's nearest point
+    // to its neighbors while it is nearer than theirs
+    std::queue<unsigned int> wavefront;
+    auto relax = [&](unsigned int mx, unsigned int my, int point) {
+        const unsigned int index = my * size_x_ + mx;
+        const float dx = origin_x_ + (mx + 0.5f) * resolution_ - path[point].x;
+        const float dy = origin_y_ + (my + 0.5f) * resolution_ - path[point].y;
+        const float distance = dx * dx + dy * dy;
+        if (distance < distances[index]) {
+          distances[index] = distance;
+          nearest_[index] = point;
+          wavefront.push(index);
+        }
+      };
+
+    for (size_t i = 0; i != path.size(); i++) {
+      if (valid[i]) {
+        relax(cellX(path[i].x), cellY(path[i].y), static_cast<int>(i));
+      }
+    }
+
+    while (!wavefront.empty()) {
+      const unsigned int index = wavefront.front();
+      wavefront.pop();
+      const unsigned int mx = index % size_x_;
+      const unsigned int my = index / size_x_;
+      const int point = nearest_[index];
+      for (unsigned int ny = my > 0 ? my - 1 : my; ny <= std::min(my + 1, size_y_ - 1); ny++) {
+        for (unsigned int nx = mx > 0 ? mx - 1 : mx; nx <= std::min(mx + 1, size_x_ - 1); nx++) {
+          relax(nx, ny, point);
+        }
+      }
+    }
+  }
+
+  /**
+    * @brief Get the nearest path point of a position, from the closest cell of the grid
+    * @param x X coordinate of the position
+    * @param y Y coordinate of the position
+    * @return Index of the nearest path point, or -1 if the path has no valid point
+    */
+  int nearestPoint(float x, float y) const
+  {
+    if (nearest_.empty()) {
+      return -1;
+    }
+    return nearest_[cellY(y) * size_x_ + cellX(x)];
+  }
+
+protected:
+  unsigned int cellX(float x) const
+  {
+    const int mx = static_cast<int>(std::floor((x - origin_x_) / resolution_));
+    return static_cast<unsigned int>(std::clamp(mx, 0, static_cast<int>(size_x_) - 1));
+  }
+
+  unsigned int cellY(float y) const
+  {
+    const int my = static_cast<int>(std::floor((y - origin_y_) / resolution_));
+    return static_cast<unsigned int>(std::clamp(my, 0, static_cast<int>(size_y_) - 1));
+  }
+
+  float origin_x_{0.0f}, origin_y_{0.0f}, resolution_{1.0f};
+  unsigned int size_x_{0}, size_y_{0};
+  std::vector<int> nearest_;
+};
+
+}  // namespace mppi
+
+#endif  // NAV2_MPPI_CONTROLLER__TOOLS__PATH_POINT_FIELD_HPP_
@@ -15,8 +15,11 @@
 #ifndef NAV2_MPPI_CONTROLLER__TOOLS__TRAJECTORY_VISUALIZER_HPP_
 #define NAV2_MPPI_CONTROLLER__TOOLS__TRAJECTORY_VISUALIZER_HPP_
 
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 
 // xtensor creates warnings that needs to be ignored as we are building with -Werror
 #pragma GCC diagnostic push
@@ -39,7 +42,9 @@ namespace mppi
 
 /**
  * @class mppi::TrajectoryVisualizer
- * @brief Visualizes trajectories for debugging
+ * @brief Visualizes trajectories for debugging. Markers are reused between cycles
+ * and published from a thread of their own, so the controller only pays for
+ * filling them.
  */
 class TrajectoryVisualizer
 {
@@ -49,6 +54,11 @@ public:
     */
   TrajectoryVisualizer() = default;
 
+  /**
+    * @brief Destructor for mppi::TrajectoryVisualizer
+    */
+  ~TrajectoryVisualizer() {stopPublishing();}
+
   /**
     * @brief Configure trajectory visualizer
     * @param parent WeakPtr to node
@@ -82,7 +92,8 @@ public:
   void add(const xt::xtensor<float, 2> & trajectory, const std::string & marker_namespace);
 
   /**
-    * @brief Add candidate trajectories to visualize
+    * @brief Add candidate trajectories to visualize, every trajectory_step_
+    * trajectory as a single line list through every time_step_ point
     * @param trajectories Candidate trajectories
     */
   void add(const models::Trajectories & trajectories, const std::string & marker_namespace);
@@ -99,14 +110,39 @@ public:
   void reset();
 
 protected:
+  /**
+    * @brief Get the next marker to fill, reusing the one of the previous cycle
+    * @return Marker with the next ID
+    */
+  visualization_msgs::msg::Marker & nextMarker();
+
+  /**
+    * @brief Thread publishing the markers handed over by visualize
+    */
+  void publishThread();
+
+  /**
+    * @brief Stop the publishing thread, if running
+    */
+  void stopPublishing();
+
   std::string frame_id_;
   std::shared_ptr<rclcpp_lifecycle::LifecyclePublisher<visualization_msgs::msg::MarkerArray>>
   trajectories_publisher_;
   std::shared_ptr<rclcpp_lifecycle::LifecyclePublisher<nav_msgs::msg::Path>> transformed_path_pub_;
 
-  std::unique_ptr<visualization_msgs::msg::MarkerArray> points_;
+  // Markers filled this cycle, handed over to publish and being published, swapped
+  // between each other so that their allocations are reused
+  visualization_msgs::msg::MarkerArray points_;
+  visualization_msgs::msg::MarkerArray publish_points_;
+  visualization_msgs::msg::MarkerArray published_points_;
   int marker_id_ = 0;
 
+  std::thread publish_thread_;
+  std::condition_variable publish_cond_;
+  std::mutex publish_lock_;
+  bool publishing_{false}, publish_ready_{false};
+
   ParametersHandler * parameters_handler_;
 
   size_t trajectory_step_{0};
@@ -355,17 +355,24 @@ inline void findPathCosts(
   std::shared_ptr<nav2_costmap_2d::Costmap2DROS> costmap_ros)
 {
   auto * costmap = costmap_ros->getCostmap();
-  unsigned int map_x, map_y;
   const size_t path_segments_count = data.path.x.shape(0) - 1;
   data.path_pts_valid = std::vector<bool>(path_segments_count, false);
   const bool tracking_unknown = costmap_ros->getLayeredCostmap()->isTrackingUnknown();
+
+  // Convert all path points to map coordinates in one batch
+  std::vector<unsigned int> map_x(path_segments_count), map_y(path_segments_count);
+  std::vector<unsigned char> in_map(path_segments_count);
+  costmap->worldToMap(
+    data.path.x.data(), data.path.y.data(), path_segments_count,
+    map_x.data(), map_y.data(), in_map.data());
+
   for (unsigned int idx = 0; idx < path_segments_count; idx++) {
-    if (!costmap->worldToMap(data.path.x(idx), data.path.y(idx), map_x, map_y)) {
+    if (!in_map[idx]) {
       (*data.path_pts_valid)[idx] = false;
       continue;
     }
 
-    switch (costmap->getCost(map_x, map_y)) {
+    switch (costmap->getCost(map_x[idx], map_y[idx])) {
       case (nav2_costmap_2d::LETHAL_OBSTACLE):
         (*data.path_pts_valid)[idx] = false;
         continue;
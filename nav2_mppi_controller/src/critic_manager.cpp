@@ -14,6 +14,13 @@
 
 #include "nav2_mppi_controller/critic_manager.hpp"
 
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include <xtensor/xnoalias.hpp>
+#include <xtensor/xview.hpp>
+
 namespace mppi
 {
 
@@ -30,6 +37,8 @@ void CriticManager::on_configure(
 
   getParams();
   loadCritics();
+  splitChunkedCritics();
+  startWorkers();
 }
 
 void CriticManager::getParams()
@@ -37,6 +46,10 @@ void CriticManager::getParams()
   auto node = parent_.lock();
   auto getParam = parameters_handler_->getParamGetter(name_);
   getParam(critic_names_, "critics", std::vector<std::string>{}, ParameterType::Static);
+  getParam(critic_threads_, "critic_threads", 1, ParameterType::Static);
+  getParam(critic_chunk_size_, "critic_chunk_size", 0, ParameterType::Static);
+  getParam(
+    cull_colliding_trajectories_, "cull_colliding_trajectories", false, ParameterType::Static);
 }
 
 void CriticManager::loadCritics()
@@ -59,6 +72,48 @@ void CriticManager::loadCritics()
   }
 }
 
+void CriticManager::splitChunkedCritics()
+{
+  gating_critics_.clear();
+  chunked_critics_.clear();
+  unchunked_critics_.clear();
+  for (size_t i = 0; i != critics_.size(); i++) {
+    if (cull_colliding_trajectories_ && critics_[i]->isGating()) {
+      gating_critics_.push_back(i);
+    } else if ((critic_chunk_size_ > 0 || cull_colliding_trajectories_) &&
+      critics_[i]->isChunkable())
+    {
+      chunked_critics_.push_back(i);
+    } else {
+      unchunked_critics_.push_back(i);
+    }
+  }
+
+  // Culling is only of use if gating critics spare the work of chunkable ones
+  if (gating_critics_.empty() || chunked_critics_.empty()) {
+    unchunked_critics_.insert(
+      unchunked_critics_.end(), gating_critics_.begin(), gating_critics_.end());
+    gating_critics_.clear();
+    if (critic_chunk_size_ == 0) {
+      unchunked_critics_.insert(
+        unchunked_critics_.end(), chunked_critics_.begin(), chunked_critics_.end());
+      chunked_critics_.clear();
+    }
+    std::sort(unchunked_critics_.begin(), unchunked_critics_.end());
+  }
+
+  if (!gating_critics_.empty()) {
+    RCLCPP_INFO(
+      logger_, "Culling the trajectories in collision found by %zu critics "
+      "before scoring %zu critics", gating_critics_.size(), chunked_critics_.size());
+  }
+  if (!chunked_critics_.empty() && critic_chunk_size_ > 0) {
+    RCLCPP_INFO(
+      logger_, "Scoring %zu critics over chunks of %u trajectories",
+      chunked_critics_.size(), critic_chunk_size_);
+  }
+}
+
 std::string CriticManager::getFullName(const std::string & name)
 {
   return "mppi::critics::" + name;
@@ -67,12 +122,238 @@ std::string CriticManager::getFullName(const std::string & name)
 void CriticManager::evalTrajectoriesScores(
   CriticData & data) const
 {
-  for (const auto & critic : critics_) {
+  if (data.fail_flag) {
+    return;
+  }
+
+  // Lazily evaluated shared data depends on the whole batch, so must be populated
+  // before critics run over chunks of the batch or concurrently
+  if ((!chunked_critics_.empty() || !workers_.empty()) && data.path.x.shape(0) > 0) {
+    utils::setPathFurthestPointIfNotSet(data);
+    utils::setPathCostsIfNotSet(data, costmap_ros_);
+  }
+
+  culled_ = false;
+  if (!gating_critics_.empty()) {
+    scoreGatingCritics(data);
+    if (data.fail_flag) {
+      return;
+    }
+  }
+
+  if (!chunked_critics_.empty()) {
+    scoreChunks(data);
+  }
+
+  if (workers_.empty()) {
+    for (size_t idx : unchunked_critics_) {
+      if (data.fail_flag) {
+        break;
+      }
+      critics_[idx]->score(data);
+    }
+  } else if (!data.fail_flag) {
+    std::unique_lock<std::mutex> guard(pool_lock_);
+    critic_costs_.resize(critics_.size());
+    critic_fail_flags_.assign(critics_.size(), 0);
+    pending_data_ = &data;
+    next_critic_ = 0;
+    completed_critics_ = 0;
+    work_cond_.notify_all();
+
+    // Score on this thread as well, rather than idle waiting for the workers
+    scorePendingCritics(guard);
+    done_cond_.wait(
+      guard, [this]() {return completed_critics_ == unchunked_critics_.size();});
+    pending_data_ = nullptr;
+
+    // Accumulate in critic order so results do not depend on thread scheduling
+    for (size_t idx : unchunked_critics_) {
+      data.costs += critic_costs_[idx];
+      data.fail_flag = data.fail_flag || critic_fail_flags_[idx];
+    }
+  }
+
+  if (culled_) {
+    raiseCulledCosts(data);
+  }
+}
+
+void CriticManager::scoreGatingCritics(CriticData & data) const
+{
+  const size_t batch_size = data.costs.shape(0);
+  collisions_.assign(batch_size, 0);
+  data.collisions = &collisions_;
+  for (size_t idx : gating_critics_) {
     if (data.fail_flag) {
       break;
     }
-    critic->score(data);
+    critics_[idx]->score(data);
+  }
+  data.collisions = nullptr;
+
+  surviving_rows_.clear();
+  for (size_t i = 0; i != batch_size; i++) {
+    if (!collisions_[i]) {
+      surviving_rows_.push_back(i);
+    }
+  }
+  culled_ = surviving_rows_.size() < batch_size;
+}
+
+void CriticManager::raiseCulledCosts(CriticData & data) const
+{
+  // The softmax weights of the trajectories in collision stay below those of the others,
+  // and are still finite, whatever the costs the critics skipped would have added
+  float max_cost = std::numeric_limits<float>::lowest();
+  for (size_t i : surviving_rows_) {
+    max_cost = std::max(max_cost, data.costs(i));
+  }
+  for (size_t i = 0; i != collisions_.size(); i++) {
+    if (collisions_[i]) {
+      data.costs(i) = std::max(data.costs(i), max_cost);
+    }
+  }
+}
+
+void CriticManager::scoreChunks(CriticData & data) const
+{
+  // Without culling nor chunks, the critics may as well score the batch in place
+  if (!culled_ && critic_chunk_size_ == 0) {
+    for (size_t idx : chunked_critics_) {
+      critics_[idx]->score(data);
+    }
+    return;
   }
+
+  chunk_state_.pose = data.state.pose;
+  chunk_state_.speed = data.state.speed;
+  CriticData chunk_data =
+  {chunk_state_, chunk_trajectories_, data.path, chunk_costs_, data.model_dt, false,
+    data.goal_checker, data.motion_model, data.path_pts_valid, data.furthest_reached_path_point,
+    data.costmap_view};
+
+  const size_t batch_size = culled_ ? surviving_rows_.size() : data.costs.shape(0);
+  const size_t chunk_size = critic_chunk_size_ > 0 ? critic_chunk_size_ : batch_size;
+  for (size_t begin = 0; begin < batch_size; begin += chunk_size) {
+    const size_t end = std::min(begin + chunk_size, batch_size);
+
+    // Copy the chunk once, then all critics read it from cache
+    if (culled_) {
+      // The trajectories out of collision, gathered into a compact chunk
+      const std::vector<size_t> rows(
+        surviving_rows_.begin() + begin, surviving_rows_.begin() + end);
+      xt::noalias(chunk_state_.vx) = xt::view(data.state.vx, xt::keep(rows), xt::all());
+      xt::noalias(chunk_state_.vy) = xt::view(data.state.vy, xt::keep(rows), xt::all());
+      xt::noalias(chunk_state_.wz) = xt::view(data.state.wz, xt::keep(rows), xt::all());
+      xt::noalias(chunk_trajectories_.x) =
+        xt::view(data.trajectories.x, xt::keep(rows), xt::all());
+      xt::noalias(chunk_trajectories_.y) =
+        xt::view(data.trajectories.y, xt::keep(rows), xt::all());
+      xt::noalias(chunk_trajectories_.yaws) =
+        xt::view(data.trajectories.yaws, xt::keep(rows), xt::all());
+    } else {
+      const auto rows = xt::range(begin, end);
+      xt::noalias(chunk_state_.vx) = xt::view(data.state.vx, rows, xt::all());
+      xt::noalias(chunk_state_.vy) = xt::view(data.state.vy, rows, xt::all());
+      xt::noalias(chunk_state_.wz) = xt::view(data.state.wz, rows, xt::all());
+      xt::noalias(chunk_trajectories_.x) = xt::view(data.trajectories.x, rows, xt::all());
+      xt::noalias(chunk_trajectories_.y) = xt::view(data.trajectories.y, rows, xt::all());
+      xt::noalias(chunk_trajectories_.yaws) = xt::view(data.trajectories.yaws, rows, xt::all());
+    }
+    chunk_costs_.resize({end - begin});
+    chunk_costs_.fill(0.0f);
+
+    for (size_t idx : chunked_critics_) {
+      critics_[idx]->score(chunk_data);
+    }
+    if (culled_) {
+      for (size_t i = begin; i != end; i++) {
+        data.costs(surviving_rows_[i]) += chunk_costs_(i - begin);
+      }
+    } else {
+      xt::noalias(xt::view(data.costs, xt::range(begin, end))) += chunk_costs_;
+    }
+  }
+  data.fail_flag = data.fail_flag || chunk_data.fail_flag;
+}
+
+void CriticManager::startWorkers()
+{
+  stopWorkers();
+  if (critic_threads_ <= 1 || unchunked_critics_.size() <= 1) {
+    return;
+  }
+
+  // The calling thread scores critics as well, so one less worker is needed
+  const size_t worker_count = std::min<size_t>(critic_threads_, unchunked_critics_.size()) - 1;
+  active_ = true;
+  for (size_t i = 0; i != worker_count; i++) {
+    workers_.emplace_back(std::bind(&CriticManager::workerThread, this));
+  }
+  RCLCPP_INFO(
+    logger_, "Scoring critics concurrently on %zu threads", worker_count + 1);
+}
+
+void CriticManager::stopWorkers()
+{
+  {
+    std::unique_lock<std::mutex> guard(pool_lock_);
+    active_ = false;
+  }
+  work_cond_.notify_all();
+  for (auto & worker : workers_) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+  workers_.clear();
+}
+
+void CriticManager::workerThread()
+{
+  std::unique_lock<std::mutex> guard(pool_lock_);
+  while (true) {
+    work_cond_.wait(
+      guard, [this]() {
+        return !active_ ||
+        (pending_data_ != nullptr && next_critic_ < unchunked_critics_.size());
+      });
+    if (!active_) {
+      return;
+    }
+    scorePendingCritics(guard);
+  }
+}
+
+void CriticManager::scorePendingCritics(std::unique_lock<std::mutex> & guard) const
+{
+  while (pending_data_ != nullptr && next_critic_ < unchunked_critics_.size()) {
+    const size_t idx = unchunked_critics_[next_critic_++];
+    const CriticData & data = *pending_data_;
+    guard.unlock();
+    scoreCritic(idx, data);
+    guard.lock();
+    if (++completed_critics_ == unchunked_critics_.size()) {
+      done_cond_.notify_all();
+    }
+  }
+}
+
+void CriticManager::scoreCritic(size_t idx, const CriticData & data) const
+{
+  auto & costs = critic_costs_[idx];
+  if (costs.shape(0) != data.costs.shape(0)) {
+    costs = xt::zeros<float>({data.costs.shape(0)});
+  } else {
+    costs.fill(0.0f);
+  }
+
+  CriticData critic_data =
+  {data.state, data.trajectories, data.path, costs, data.model_dt, false, data.goal_checker,
+    data.motion_model, data.path_pts_valid, data.furthest_reached_path_point, data.costmap_view};
+  critics_[idx]->score(critic_data);
+  critic_fail_flags_[idx] = critic_data.fail_flag;
 }
 
 }  // namespace mppi
@@ -23,6 +23,7 @@ void CostCritic::initialize()
 {
   auto getParam = parameters_handler_->getParamGetter(name_);
   getParam(consider_footprint_, "consider_footprint", false);
+  getParam(footprint_headings_, "footprint_headings", 0);
   getParam(power_, "cost_power", 1);
   getParam(weight_, "cost_weight", 3.81f);
   getParam(critical_cost_, "critical_cost", 300.0f);
@@ -104,12 +105,7 @@ void CostCritic::score(CriticData & data)
 
   // Setup cost information for various parts of the critic
   is_tracking_unknown_ = costmap_ros_->getLayeredCostmap()->isTrackingUnknown();
-  auto * costmap = collision_checker_.getCostmap();
-  origin_x_ = static_cast<float>(costmap->getOriginX());
-  origin_y_ = static_cast<float>(costmap->getOriginY());
-  resolution_ = static_cast<float>(costmap->getResolution());
-  size_x_ = costmap->getSizeInCellsX();
-  size_y_ = costmap->getSizeInCellsY();
+  const CostmapView & costmap_view = getCostmapView(data);
 
   if (consider_footprint_) {
     // footprint may have changed since initialization if user has dynamic footprints
@@ -132,6 +128,7 @@ void CostCritic::score(CriticData & data)
     xt::view(data.trajectories.y, xt::all(), xt::range(0, _, trajectory_point_step_));
   const auto traj_yaw = xt::view(
     data.trajectories.yaws, xt::all(), xt::range(0, _, trajectory_point_step_));
+  pose_costs_.resize(traj_len);
 
   for (size_t i = 0; i < data.trajectories.x.shape(0); ++i) {
     bool trajectory_collide = false;
@@ -139,15 +136,20 @@ void CostCritic::score(CriticData & data)
     float & traj_cost = repulsive_cost[i];
     traj_cost = 0.0f;
 
+    // Gather the center costs of the whole trajectory first, without branching on them
+    costmap_view.getCosts(
+      &data.trajectories.x(i, 0), &data.trajectories.y(i, 0), traj_len,
+      trajectory_point_step_, pose_costs_.data());
+
     for (size_t j = 0; j < traj_len; j++) {
       float Tx = traj_x(i, j);
       float Ty = traj_y(i, j);
-      unsigned int x_i = 0u, y_i = 0u;
 
       // The getCost doesn't use orientation
       // The footprintCostAtPose will always return "INSCRIBED" if footprint is over it
       // So the center point has more information than the footprint
-      if (!worldToMapFloat(Tx, Ty, x_i, y_i)) {
+      pose_cost = pose_costs_[j];
+      if (pose_cost == CostmapView::OUTSIDE) {
         if (!is_tracking_unknown_) {
           traj_cost = collision_cost_;
           trajectory_collide = true;
@@ -155,7 +157,6 @@ void CostCritic::score(CriticData & data)
         }
         pose_cost = 255.0f;  // NO_INFORMATION in float
       } else {
-        pose_cost = static_cast<float>(costmap->getCost(getIndex(x_i, y_i)));
         if (pose_cost < 1.0f) {
           continue;  // In free space
         }
@@ -178,6 +179,8 @@ void CostCritic::score(CriticData & data)
 
     if (!trajectory_collide) {
       all_trajectories_collide = false;
+    } else if (data.collisions) {
+      (*data.collisions)[i] = 1;
     }
   }
 
@@ -13,7 +13,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
 #include "nav2_mppi_controller/critics/obstacles_critic.hpp"
 #include "nav2_costmap_2d/inflation_layer.hpp"
 namespace mppi::critics
@@ -23,6 +25,7 @@ void ObstaclesCritic::initialize()
 {
   auto getParam = parameters_handler_->getParamGetter(name_);
   getParam(consider_footprint_, "consider_footprint", false);
+  getParam(footprint_headings_, "footprint_headings", 0);
   getParam(power_, "cost_power", 1);
   getParam(repulsion_weight_, "repulsion_weight", 1.5f);
   getParam(critical_weight_, "critical_weight", 20.0f);
@@ -30,6 +33,7 @@ void ObstaclesCritic::initialize()
   getParam(collision_margin_distance_, "collision_margin_distance", 0.10f);
   getParam(near_goal_distance_, "near_goal_distance", 0.5f);
   getParam(inflation_layer_name_, "inflation_layer_name", std::string(""));
+  getParam(use_distance_field_, "use_distance_field", false);
 
   collision_checker_.setCostmap(costmap_);
   possible_collision_cost_ = findCircumscribedCost(costmap_ros_);
@@ -50,6 +54,10 @@ void ObstaclesCritic::initialize()
     "Critic will collision check based on %s cost.",
     power_, critical_weight_, repulsion_weight_, consider_footprint_ ?
     "footprint" : "circular");
+
+  if (use_distance_field_) {
+    RCLCPP_INFO(logger_, "ObstaclesCritic will use a distance field of the costmap obstacles.");
+  }
 }
 
 float ObstaclesCritic::findCircumscribedCost(
@@ -120,10 +128,21 @@ void ObstaclesCritic::score(CriticData & data)
     near_goal = true;
   }
 
+  if (use_distance_field_) {
+    // Only distances within the inflation and circumscribed radii are ever queried
+    inscribed_radius_ = costmap_ros_->getLayeredCostmap()->getInscribedRadius();
+    is_tracking_unknown_ = costmap_ros_->getLayeredCostmap()->isTrackingUnknown();
+    distance_field_.setMaxDistance(
+      std::max(inflation_radius_, circumscribed_radius_) + costmap_->getResolution());
+    distance_field_.update(*costmap_, !is_tracking_unknown_);
+  }
+
   auto && raw_cost = xt::xtensor<float, 1>::from_shape({data.costs.shape(0)});
   auto && repulsive_cost = xt::xtensor<float, 1>::from_shape({data.costs.shape(0)});
 
   const size_t traj_len = data.trajectories.x.shape(1);
+  const CostmapView * costmap_view = use_distance_field_ ? nullptr : &getCostmapView(data);
+  pose_costs_.resize(traj_len);
   bool all_trajectories_collide = true;
   for (size_t i = 0; i < data.trajectories.x.shape(0); ++i) {
     bool trajectory_collide = false;
@@ -133,22 +152,40 @@ void ObstaclesCritic::score(CriticData & data)
     raw_cost[i] = 0.0f;
     repulsive_cost[i] = 0.0f;
 
-    for (size_t j = 0; j < traj_len; j++) {
-      pose_cost = costAtPose(traj.x(i, j), traj.y(i, j), traj.yaws(i, j));
-      if (pose_cost.cost < 1.0f) {continue;}  // In free space
-
-      if (inCollision(pose_cost.cost)) {
-        trajectory_collide = true;
-        break;
-      }
+    // Gather the center costs of the whole trajectory first, without branching on them
+    if (costmap_view) {
+      costmap_view->getCosts(
+        &traj.x(i, 0), &traj.y(i, 0), traj_len, 1, pose_costs_.data());
+    }
 
-      // Cannot process repulsion if inflation layer does not exist
-      if (inflation_radius_ == 0.0f || inflation_scale_factor_ == 0.0f) {
-        continue;
+    for (size_t j = 0; j < traj_len; j++) {
+      float dist_to_obj;
+      if (use_distance_field_) {
+        dist_to_obj = distanceAtPose(traj.x(i, j), traj.y(i, j), traj.yaws(i, j));
+        if (dist_to_obj < 0.0f) {
+          trajectory_collide = true;
+          break;
+        }
+
+        // In free space, or cannot process repulsion if inflation layer does not exist
+        if (dist_to_obj + inscribed_radius_ >= inflation_radius_) {continue;}
+      } else {
+        pose_cost = costAtPose(pose_costs_[j], traj.x(i, j), traj.y(i, j), traj.yaws(i, j));
+        if (pose_cost.cost < 1.0f) {continue;}  // In free space
+
+        if (inCollision(pose_cost.cost)) {
+          trajectory_collide = true;
+          break;
+        }
+
+        // Cannot process repulsion if inflation layer does not exist
+        if (inflation_radius_ == 0.0f || inflation_scale_factor_ == 0.0f) {
+          continue;
+        }
+
+        dist_to_obj = distanceToObstacle(pose_cost);
       }
 
-      const float dist_to_obj = distanceToObstacle(pose_cost);
-
       // Let near-collision trajectory points be punished severely
       if (dist_to_obj < collision_margin_distance_) {
         traj_cost += (collision_margin_distance_ - dist_to_obj);
@@ -162,6 +199,9 @@ void ObstaclesCritic::score(CriticData & data)
 
     if (!trajectory_collide) {all_trajectories_collide = false;}
     raw_cost[i] = trajectory_collide ? collision_cost_ : traj_cost;
+    if (data.collisions && trajectory_collide) {
+      (*data.collisions)[i] = 1;
+    }
   }
 
   // Normalize repulsive cost by trajectory length & lowest score to not overweight importance
@@ -205,29 +245,55 @@ bool ObstaclesCritic::inCollision(float cost) const
   return false;
 }
 
-CollisionCost ObstaclesCritic::costAtPose(float x, float y, float theta)
+CollisionCost ObstaclesCritic::costAtPose(float center_cost, float x, float y, float theta)
 {
   CollisionCost collision_cost;
   float & cost = collision_cost.cost;
   collision_cost.using_footprint = false;
-  unsigned int x_i, y_i;
-  if (!collision_checker_.worldToMap(x, y, x_i, y_i)) {
+  if (center_cost == CostmapView::OUTSIDE) {
     cost = nav2_costmap_2d::NO_INFORMATION;
     return collision_cost;
   }
-  cost = collision_checker_.pointCost(x_i, y_i);
+  cost = center_cost;
 
   if (consider_footprint_ &&
     (cost >= possible_collision_cost_ || possible_collision_cost_ < 1.0f))
   {
-    cost = static_cast<float>(collision_checker_.footprintCostAtPose(
-        x, y, theta, costmap_ros_->getRobotFootprint()));
+    cost = static_cast<float>(collision_checker_.footprintCostAtPoseQuantized(
+        x, y, theta, costmap_ros_->getRobotFootprint(), footprint_headings_));
     collision_cost.using_footprint = true;
   }
 
   return collision_cost;
 }
 
+float ObstaclesCritic::distanceAtPose(float x, float y, float theta)
+{
+  constexpr float collision = std::numeric_limits<float>::lowest();
+  float dist;
+  if (!distance_field_.interpolateDistance(x, y, dist)) {
+    return is_tracking_unknown_ ? distance_field_.getMaxDistance() : collision;
+  }
+
+  // An obstacle within the inscribed radius is within the footprint in any orientation
+  if (dist <= inscribed_radius_) {
+    return collision;
+  }
+
+  // Only between the inscribed and circumscribed radii can it depend on the orientation
+  if (consider_footprint_ && dist < circumscribed_radius_) {
+    const float cost = static_cast<float>(collision_checker_.footprintCostAtPoseQuantized(
+        x, y, theta, costmap_ros_->getRobotFootprint(), footprint_headings_));
+    if (cost == nav2_costmap_2d::LETHAL_OBSTACLE ||
+      (!is_tracking_unknown_ && cost == nav2_costmap_2d::NO_INFORMATION))
+    {
+      return collision;
+    }
+  }
+
+  return dist - inscribed_radius_;
+}
+
 }  // namespace mppi::critics
 
 #include <pluginlib/class_list_macros.hpp>
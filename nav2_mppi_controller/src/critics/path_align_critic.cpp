@@ -33,6 +33,7 @@ void PathAlignCritic::initialize()
     threshold_to_consider_,
     "threshold_to_consider", 0.5f);
   getParam(use_path_orientations_, "use_path_orientations", false);
+  getParam(use_path_point_field_, "use_path_point_field", false);
 
   RCLCPP_INFO(
     logger_,
@@ -93,6 +94,16 @@ void PathAlignCritic::score(CriticData & data)
   final_pose.y = data.path.y(path_segments_count - 1);
   final_pose.theta = data.path.yaws(path_segments_count - 1);
 
+  if (use_path_point_field_) {
+    scoreWithPathPointField(data, path, path_pts_valid, cost);
+    if (power_ > 1u) {
+      data.costs += xt::pow(std::move(cost) * weight_, power_);
+    } else {
+      data.costs += std::move(cost) * weight_;
+    }
+    return;
+  }
+
   float summed_path_dist = 0.0f, dyaw = 0.0f;
   unsigned int num_samples = 0u;
   unsigned int path_pt = 0u;
@@ -157,6 +168,59 @@ void PathAlignCritic::score(CriticData & data)
   }
 }
 
+void PathAlignCritic::scoreWithPathPointField(
+  const CriticData & data, const std::vector<utils::Pose2D> & path,
+  const std::vector<bool> & path_pts_valid, xt::xtensor<float, 1> & cost)
+{
+  // The field only changes with the path, so is kept over evaluations of the same path
+  const std::vector<bool> valid(path_pts_valid.begin(), path_pts_valid.begin() + path.size());
+  const bool path_changed = valid != field_valid_ || !std::equal(
+    path.begin(), path.end(), field_path_.begin(), field_path_.end(),
+    [](const utils::Pose2D & a, const utils::Pose2D & b) {
+      return a.x == b.x && a.y == b.y && a.theta == b.theta;
+    });
+  if (path_changed) {
+    field_.update(path, valid, costmap_->getResolution(), field_margin_);
+    field_path_ = path;
+    field_valid_ = valid;
+  }
+
+  const auto T_x = xt::view(
+    data.trajectories.x, xt::all(),
+    xt::range(0, _, trajectory_point_step_));
+  const auto T_y = xt::view(
+    data.trajectories.y, xt::all(),
+    xt::range(0, _, trajectory_point_step_));
+  const auto T_yaw = xt::view(
+    data.trajectories.yaws, xt::all(),
+    xt::range(0, _, trajectory_point_step_));
+  const auto traj_sampled_size = T_x.shape(1);
+
+  for (size_t t = 0; t < T_x.shape(0); ++t) {
+    float summed_path_dist = 0.0f;
+    unsigned int num_samples = 0u;
+    for (size_t p = 1; p < traj_sampled_size; p++) {
+      const float Tx = T_x(t, p);
+      const float Ty = T_y(t, p);
+      const int path_pt = field_.nearestPoint(Tx, Ty);
+      if (path_pt < 0) {
+        continue;
+      }
+      const auto & pose = path[path_pt];
+      const float dx = pose.x - Tx;
+      const float dy = pose.y - Ty;
+      num_samples++;
+      if (use_path_orientations_) {
+        const float dyaw = angles::shortest_angular_distance(pose.theta, T_yaw(t, p));
+        summed_path_dist += sqrtf(dx * dx + dy * dy + dyaw * dyaw);
+      } else {
+        summed_path_dist += sqrtf(dx * dx + dy * dy);
+      }
+    }
+    cost[t] = num_samples > 0u ? summed_path_dist / static_cast<float>(num_samples) : 0.0f;
+  }
+}
+
 }  // namespace mppi::critics
 
 #include <pluginlib/class_list_macros.hpp>
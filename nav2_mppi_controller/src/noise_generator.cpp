@@ -14,12 +14,17 @@
 
 #include "nav2_mppi_controller/tools/noise_generator.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <memory>
 #include <mutex>
+#include <utility>
+#include <vector>
 #include <xtensor/xmath.hpp>
-#include <xtensor/xrandom.hpp>
 #include <xtensor/xnoalias.hpp>
 
+#include "nav2_core/controller_exceptions.hpp"
+
 namespace mppi
 {
 
@@ -33,6 +38,51 @@ void NoiseGenerator::initialize(
 
   auto getParam = param_handler->getParamGetter(name);
   getParam(regenerate_noises_, "regenerate_noises", false);
+  getParam(noise_threads_, "noise_threads", 1, ParameterType::Static);
+  int noise_seed;
+  getParam(noise_seed, "noise_seed", 0, ParameterType::Static);
+  normal_generator_.seed(static_cast<uint64_t>(noise_seed));
+  std::string noise_mode;
+  getParam(noise_mode, "noise_mode", std::string("Gaussian"), ParameterType::Static);
+  getParam(noise_correlation_, "noise_correlation", 0.8f, ParameterType::Static);
+  getParam(noise_knots_, "noise_knots", 4, ParameterType::Static);
+  std::string noise_storage;
+  getParam(noise_storage, "noise_storage", std::string("Float"), ParameterType::Static);
+
+  if (noise_mode == "Gaussian") {
+    noise_mode_ = NoiseMode::GAUSSIAN;
+  } else if (noise_mode == "Correlated") {
+    noise_mode_ = NoiseMode::CORRELATED;
+  } else if (noise_mode == "Halton") {
+    noise_mode_ = NoiseMode::HALTON;
+  } else {
+    throw nav2_core::ControllerException(
+            std::string(
+              "Noise mode " + noise_mode + " is not valid! Valid options are Gaussian, "
+              "Correlated, or Halton"));
+  }
+  if (noise_storage == "Float" || noise_storage == "Int16") {
+    quantize_noises_ = noise_storage == "Int16";
+  } else {
+    throw nav2_core::ControllerException(
+            std::string(
+              "Noise storage " + noise_storage + " is not valid! Valid options are Float, "
+              "or Int16"));
+  }
+  noise_correlation_ = std::clamp(noise_correlation_, 0.0f, 0.99f);
+  noise_knots_ = std::max(2u, noise_knots_);
+
+  // A prime base per dimension of the Halton sequence, that is per knot of each control
+  halton_bases_.clear();
+  for (unsigned int candidate = 2; halton_bases_.size() != 3 * noise_knots_; candidate++) {
+    bool prime = true;
+    for (unsigned int base : halton_bases_) {
+      prime = prime && candidate % base != 0;
+    }
+    if (prime) {
+      halton_bases_.push_back(candidate);
+    }
+  }
 
   if (regenerate_noises_) {
     noise_thread_ = std::thread(std::bind(&NoiseGenerator::noiseThread, this));
@@ -68,6 +118,18 @@ void NoiseGenerator::setNoisedControls(
 {
   std::unique_lock<std::mutex> guard(noise_lock_);
 
+  if (quantize_noises_) {
+    // Widen the quantized noises to floats while adding them
+    const auto & std = settings_.sampling_std;
+    xt::noalias(state.cvx) = control_sequence.vx +
+      xt::cast<float>(quantized_noises_vx_) * (std.vx / quantization_steps_);
+    xt::noalias(state.cvy) = control_sequence.vy +
+      xt::cast<float>(quantized_noises_vy_) * (std.vy / quantization_steps_);
+    xt::noalias(state.cwz) = control_sequence.wz +
+      xt::cast<float>(quantized_noises_wz_) * (std.wz / quantization_steps_);
+    return;
+  }
+
   xt::noalias(state.cvx) = control_sequence.vx + noises_vx_;
   xt::noalias(state.cvy) = control_sequence.vy + noises_vy_;
   xt::noalias(state.cwz) = control_sequence.wz + noises_wz_;
@@ -81,9 +143,17 @@ void NoiseGenerator::reset(mppi::models::OptimizerSettings & settings, bool is_h
   // Recompute the noises on reset, initialization, and fallback
   {
     std::unique_lock<std::mutex> guard(noise_lock_);
-    xt::noalias(noises_vx_) = xt::zeros<float>({settings_.batch_size, settings_.time_steps});
-    xt::noalias(noises_vy_) = xt::zeros<float>({settings_.batch_size, settings_.time_steps});
-    xt::noalias(noises_wz_) = xt::zeros<float>({settings_.batch_size, settings_.time_steps});
+    if (quantize_noises_) {
+      for (auto * noises : {&quantized_noises_vx_, &quantized_noises_vy_, &quantized_noises_wz_}) {
+        noises->resize({settings_.batch_size, settings_.time_steps});
+        noises->fill(0);
+      }
+    } else {
+      for (auto * noises : {&noises_vx_, &noises_vy_, &noises_wz_}) {
+        noises->resize({settings_.batch_size, settings_.time_steps});
+        noises->fill(0.0f);
+      }
+    }
     ready_ = true;
   }
 
@@ -94,6 +164,14 @@ void NoiseGenerator::reset(mppi::models::OptimizerSettings & settings, bool is_h
   }
 }
 
+size_t NoiseGenerator::getMemoryUsage()
+{
+  std::unique_lock<std::mutex> guard(noise_lock_);
+  return (noises_vx_.size() + noises_vy_.size() + noises_wz_.size()) * sizeof(float) +
+         (quantized_noises_vx_.size() + quantized_noises_vy_.size() +
+         quantized_noises_wz_.size()) * sizeof(int16_t);
+}
+
 void NoiseGenerator::noiseThread()
 {
   do {
@@ -108,16 +186,125 @@ void NoiseGenerator::generateNoisedControls()
 {
   auto & s = settings_;
 
-  xt::noalias(noises_vx_) = xt::random::randn<float>(
-    {s.batch_size, s.time_steps}, 0.0f,
-    s.sampling_std.vx);
-  xt::noalias(noises_wz_) = xt::random::randn<float>(
-    {s.batch_size, s.time_steps}, 0.0f,
-    s.sampling_std.wz);
+  // Noises with the stream of the normal generator for each control, fixed so
+  // that vx and wz noises do not depend on whether the base is holonomic
+  std::vector<std::pair<xt::xtensor<float, 2> *, float>> noises = {
+    {&noises_vx_, s.sampling_std.vx}, {&noises_wz_, s.sampling_std.wz}};
+  std::vector<xt::xtensor<int16_t, 2> *> quantized_noises = {
+    &quantized_noises_vx_, &quantized_noises_wz_};
+  std::vector<uint64_t> streams = {0, 2};
   if (is_holonomic_) {
-    xt::noalias(noises_vy_) = xt::random::randn<float>(
-      {s.batch_size, s.time_steps}, 0.0f,
-      s.sampling_std.vy);
+    noises.emplace_back(&noises_vy_, s.sampling_std.vy);
+    quantized_noises.push_back(&quantized_noises_vy_);
+    streams.push_back(1);
+  }
+  for (size_t i = 0; i != noises.size(); i++) {
+    if (quantize_noises_) {
+      quantized_noises[i]->resize({s.batch_size, s.time_steps});
+    } else {
+      noises[i].first->resize({s.batch_size, s.time_steps});
+    }
+  }
+  const uint64_t first_stream = 3 * generations_++;
+
+  // Shift the Halton sequence of each generation by random offsets, so that
+  // generations differ while keeping the low discrepancy of the knots
+  std::vector<std::vector<float>> shifts(noises.size());
+  if (noise_mode_ == NoiseMode::HALTON) {
+    for (size_t i = 0; i != noises.size(); i++) {
+      for (unsigned int k = 0; k != noise_knots_; k++) {
+        shifts[i].push_back(normal_generator_.uniform(k, first_stream + streams[i]));
+      }
+    }
+  }
+
+  // Samples only depend on their batch and index in the stream, so splitting
+  // the batches over threads does not change the noises
+  const unsigned int parts = std::max(1u, noise_threads_);
+  auto generate = [&](unsigned int part) {
+      const size_t batch_begin = s.batch_size * part / parts;
+      const size_t batch_end = s.batch_size * (part + 1) / parts;
+      const size_t offset = batch_begin * s.time_steps;
+      const size_t size = (batch_end - batch_begin) * s.time_steps;
+      std::vector<float> buffer(quantize_noises_ ? size : 0);
+      for (size_t i = 0; i != noises.size(); i++) {
+        if (!quantize_noises_) {
+          generateNoises(
+            noises[i].first->data() + offset, s.time_steps, noises[i].second,
+            first_stream + streams[i], shifts[i], batch_begin, batch_end);
+          continue;
+        }
+
+        // Generate in floats, then keep steps of the standard deviation, saturated
+        generateNoises(
+          buffer.data(), s.time_steps, 1.0f, first_stream + streams[i], shifts[i],
+          batch_begin, batch_end);
+        int16_t * quantized = quantized_noises[i]->data() + offset;
+        for (size_t j = 0; j != size; j++) {
+          quantized[j] = static_cast<int16_t>(
+            std::clamp(std::round(buffer[j] * quantization_steps_), -32767.0f, 32767.0f));
+        }
+      }
+    };
+
+  std::vector<std::thread> workers;
+  for (unsigned int part = 1; part < parts; part++) {
+    workers.emplace_back(generate, part);
+  }
+  generate(0);
+  for (auto & worker : workers) {
+    worker.join();
+  }
+}
+
+void NoiseGenerator::generateNoises(
+  float * noises, size_t time_steps, float std, uint64_t stream,
+  const std::vector<float> & shifts, size_t batch_begin, size_t batch_end) const
+{
+  if (noise_mode_ != NoiseMode::HALTON) {
+    normal_generator_.fill(
+      noises, batch_begin * time_steps, batch_end * time_steps, std, stream);
+  }
+
+  if (noise_mode_ == NoiseMode::CORRELATED) {
+    // Discretized Ornstein-Uhlenbeck process, keeping the variance of the noises
+    const float a = noise_correlation_;
+    const float b = std::sqrt(1.0f - a * a);
+    for (size_t batch = batch_begin; batch != batch_end; batch++) {
+      float * row = noises + (batch - batch_begin) * time_steps;
+      for (size_t t = 1; t < time_steps; t++) {
+        row[t] = a * row[t - 1] + b * row[t];
+      }
+    }
+  } else if (noise_mode_ == NoiseMode::HALTON) {
+    // Knots spread evenly over the time steps, linearly interpolated between
+    const unsigned int control = static_cast<unsigned int>(stream % 3);
+    const float knot_spacing =
+      std::max(static_cast<float>(time_steps) - 1.0f, 1.0f) / (noise_knots_ - 1);
+    std::vector<float> knots(noise_knots_);
+    for (size_t batch = batch_begin; batch != batch_end; batch++) {
+      for (unsigned int k = 0; k != noise_knots_; k++) {
+        // Radical inverse of the batch index in the base of the knot
+        const unsigned int base = halton_bases_[control * noise_knots_ + k];
+        double halton = 0.0, scale = 1.0 / base;
+        for (size_t index = batch + 1; index != 0; index /= base, scale /= base) {
+          halton += (index % base) * scale;
+        }
+        float probability = static_cast<float>(halton) + shifts[k];
+        probability -= std::floor(probability);
+        probability = std::clamp(probability, 1e-6f, 1.0f - 1e-6f);
+        knots[k] = std * NormalGenerator::quantile(probability);
+      }
+
+      float * row = noises + (batch - batch_begin) * time_steps;
+      for (size_t t = 0; t != time_steps; t++) {
+        const float position = t / knot_spacing;
+        const unsigned int k = std::min(
+          static_cast<unsigned int>(position), noise_knots_ - 2);
+        const float ratio = position - k;
+        row[t] = (1.0f - ratio) * knots[k] + ratio * knots[k + 1];
+      }
+    }
   }
 }
 
@@ -0,0 +1,151 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_mppi_controller/tools/normal_generator.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// xtensor creates warnings that needs to be ignored as we are building with -Werror
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Warray-bounds"
+#pragma GCC diagnostic ignored "-Wstringop-overflow"
+#include <xtensor/xtensor.hpp>
+#include <xtensor/xmath.hpp>
+#include <xtensor/xnoalias.hpp>
+#pragma GCC diagnostic pop
+
+namespace mppi
+{
+
+namespace
+{
+
+// Pairs of samples transformed at once, even so chunks hold whole Philox blocks
+constexpr size_t chunk_pairs = 512;
+
+// Uniform in (0, 1) from the top 24 bits of a word, so its logarithm is finite
+inline float toUniform(uint32_t word)
+{
+  return (static_cast<float>(word >> 8) + 0.5f) * (1.0f / 16777216.0f);
+}
+
+}  // namespace
+
+std::array<uint32_t, 4> NormalGenerator::philox(
+  std::array<uint32_t, 4> counter, std::array<uint32_t, 2> key)
+{
+  for (int round = 0; round != 10; round++) {
+    const uint64_t product0 = static_cast<uint64_t>(0xD2511F53u) * counter[0];
+    const uint64_t product1 = static_cast<uint64_t>(0xCD9E8D57u) * counter[2];
+    counter = {
+      static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+      static_cast<uint32_t>(product1),
+      static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+      static_cast<uint32_t>(product0)};
+    key[0] += 0x9E3779B9u;
+    key[1] += 0xBB67AE85u;
+  }
+  return counter;
+}
+
+float NormalGenerator::uniform(uint64_t index, uint64_t stream) const
+{
+  const auto words = philox(
+    {static_cast<uint32_t>(index), static_cast<uint32_t>(index >> 32),
+      static_cast<uint32_t>(stream), static_cast<uint32_t>(stream >> 32)},
+    {static_cast<uint32_t>(seed_), static_cast<uint32_t>(seed_ >> 32)});
+  return toUniform(words[0]);
+}
+
+float NormalGenerator::quantile(float probability)
+{
+  // Rational approximations of Acklam, with a relative error under 1.2e-9
+  static constexpr double a[] = {
+    -3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+    1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+  static constexpr double b[] = {
+    -5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+    6.680131188771972e+01, -1.328068155288572e+01};
+  static constexpr double c[] = {
+    -7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+    -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+  static constexpr double d[] = {
+    7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+    3.754408661907416e+00};
+  constexpr double low = 0.02425;
+
+  const double p = probability;
+  if (p < low || p > 1.0 - low) {
+    const double q = std::sqrt(-2.0 * std::log(p < low ? p : 1.0 - p));
+    const double x = (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+      ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+    return static_cast<float>(p < low ? x : -x);
+  }
+  const double q = p - 0.5;
+  const double r = q * q;
+  return static_cast<float>(
+    (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+    (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1.0));
+}
+
+void NormalGenerator::fill(
+  float * data, size_t begin, size_t end, float std, uint64_t stream) const
+{
+  if (begin >= end) {
+    return;
+  }
+
+  const std::array<uint32_t, 2> key = {
+    static_cast<uint32_t>(seed_), static_cast<uint32_t>(seed_ >> 32)};
+  xt::xtensor<float, 1> u1 = xt::empty<float>({chunk_pairs});
+  xt::xtensor<float, 1> u2 = xt::empty<float>({chunk_pairs});
+  xt::xtensor<float, 1> radius = xt::empty<float>({chunk_pairs});
+  xt::xtensor<float, 1> cos_samples = xt::empty<float>({chunk_pairs});
+  xt::xtensor<float, 1> sin_samples = xt::empty<float>({chunk_pairs});
+
+  // Each Philox block of 4 words gives 2 pairs of uniforms, each pair 2 samples
+  const size_t end_pair = (end + 1) / 2;
+  for (size_t first = (begin / 2) & ~size_t{1}; first < end_pair; first += chunk_pairs) {
+    const size_t count = std::min(chunk_pairs, end_pair - first);
+    for (size_t i = 0; i < count; i += 2) {
+      const uint64_t block = (first + i) / 2;
+      const auto words = philox(
+        {static_cast<uint32_t>(block), static_cast<uint32_t>(block >> 32),
+          static_cast<uint32_t>(stream), static_cast<uint32_t>(stream >> 32)}, key);
+      u1(i) = toUniform(words[0]);
+      u2(i) = toUniform(words[1]);
+      u1(i + 1) = toUniform(words[2]);
+      u2(i + 1) = toUniform(words[3]);
+    }
+
+    // Box-Muller transform of the chunk, vectorized by xtensor
+    xt::noalias(radius) = std * xt::sqrt(-2.0f * xt::log(u1));
+    xt::noalias(u2) = static_cast<float>(2.0 * M_PI) * u2;
+    xt::noalias(cos_samples) = radius * xt::cos(u2);
+    xt::noalias(sin_samples) = radius * xt::sin(u2);
+
+    for (size_t i = 0; i != count; i++) {
+      const size_t idx = 2 * (first + i);
+      if (idx >= begin && idx < end) {
+        data[idx - begin] = cos_samples(i);
+      }
+      if (idx + 1 >= begin && idx + 1 < end) {
+        data[idx + 1 - begin] = sin_samples(i);
+      }
+    }
+  }
+}
+
+}  // namespace mppi
@@ -14,10 +14,13 @@
 
 #include "nav2_mppi_controller/optimizer.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <limits>
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 #include <cmath>
 #include <xtensor/xmath.hpp>
@@ -85,6 +88,12 @@ void Optimizer::getParams()
   getParam(s.sampling_std.vy, "vy_std", 0.2f);
   getParam(s.sampling_std.wz, "wz_std", 0.4f);
   getParam(s.retry_attempt_limit, "retry_attempt_limit", 1);
+  getParam(rollout_threads_, "rollout_threads", 1, ParameterType::Static);
+  getParam(convergence_threshold_, "convergence_threshold", 0.0f);
+  getParam(adaptive_batch_size_, "adaptive_batch_size", false);
+  getParam(min_batch_size_, "min_batch_size", 500);
+  getParam(max_batch_size_, "max_batch_size", 4000);
+  getParam(compute_time_ratio_, "compute_time_ratio", 0.5);
 
   s.base_constraints.ax_max = std::abs(s.base_constraints.ax_max);
   if (s.base_constraints.ax_min > 0.0) {
@@ -103,6 +112,7 @@ void Optimizer::getParams()
   double controller_frequency;
   getParentParam(controller_frequency, "controller_frequency", 0.0, ParameterType::Static);
   setOffset(controller_frequency);
+  controller_period_ = 1.0 / controller_frequency;
 }
 
 void Optimizer::setOffset(double controller_frequency)
@@ -137,13 +147,25 @@ void Optimizer::reset()
 
   settings_.constraints = settings_.base_constraints;
 
-  costs_ = xt::zeros<float>({settings_.batch_size});
+  costs_.resize({settings_.batch_size});
+  costs_.fill(0.0f);
   generated_trajectories_.reset(settings_.batch_size, settings_.time_steps);
 
   noise_generator_.reset(settings_, isHolonomic());
+  updateTensorMemory();
   RCLCPP_INFO(logger_, "Optimizer reset");
 }
 
+void Optimizer::updateTensorMemory()
+{
+  const size_t batch_tensors =
+    state_.vx.size() + state_.vy.size() + state_.wz.size() +
+    state_.cvx.size() + state_.cvy.size() + state_.cwz.size() +
+    generated_trajectories_.x.size() + generated_trajectories_.y.size() +
+    generated_trajectories_.yaws.size() + costs_.size();
+  tensor_memory_.update(batch_tensors * sizeof(float) + noise_generator_.getMemoryUsage());
+}
+
 bool Optimizer::isHolonomic() const
 {
   return motion_model_->isHolonomic();
@@ -156,9 +178,12 @@ geometry_msgs::msg::TwistStamped Optimizer::evalControl(
 {
   prepare(robot_pose, robot_speed, plan, goal_checker);
 
+  const auto start = std::chrono::steady_clock::now();
   do {
     optimize();
   } while (fallback(critics_data_.fail_flag));
+  adaptBatchSize(
+    std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
 
   utils::savitskyGolayFilter(control_sequence_, control_history_, settings_);
   auto control = getControlFromSequenceAsTwist(plan.header.stamp);
@@ -172,13 +197,70 @@ geometry_msgs::msg::TwistStamped Optimizer::evalControl(
 
 void Optimizer::optimize()
 {
-  for (size_t i = 0; i < settings_.iteration_count; ++i) {
+  const bool check_convergence = convergence_threshold_ > 0.0f;
+  iterations_ = 0;
+  while (iterations_ < settings_.iteration_count) {
     generateNoisedTrajectories();
     critic_manager_.evalTrajectoriesScores(critics_data_);
+    if (check_convergence) {
+      xt::noalias(previous_control_sequence_.vx) = control_sequence_.vx;
+      xt::noalias(previous_control_sequence_.vy) = control_sequence_.vy;
+      xt::noalias(previous_control_sequence_.wz) = control_sequence_.wz;
+    }
     updateControlSequence();
+    iterations_++;
+
+    if (check_convergence && getControlSequenceChange() < convergence_threshold_) {
+      break;
+    }
   }
 }
 
+float Optimizer::getControlSequenceChange() const
+{
+  float change = std::max(
+    xt::amax(xt::abs(control_sequence_.vx - previous_control_sequence_.vx), immediate)(),
+    xt::amax(xt::abs(control_sequence_.wz - previous_control_sequence_.wz), immediate)());
+  if (isHolonomic()) {
+    change = std::max(
+      change,
+      xt::amax(xt::abs(control_sequence_.vy - previous_control_sequence_.vy), immediate)());
+  }
+  return change;
+}
+
+void Optimizer::adaptBatchSize(double compute_time)
+{
+  if (!adaptive_batch_size_ || compute_time <= 0.0 || settings_.batch_size == 0) {
+    return;
+  }
+
+  // Scale the batch towards the target time, by at most a factor of 2 per cycle
+  // so that a single slow cycle does not collapse it
+  const double scale =
+    std::clamp(compute_time_ratio_ * controller_period_ / compute_time, 0.5, 2.0);
+  const unsigned int min_batch_size = std::max(1u, min_batch_size_);
+  const unsigned int batch_size = std::clamp(
+    static_cast<unsigned int>(settings_.batch_size * scale),
+    min_batch_size, std::max(min_batch_size, max_batch_size_));
+
+  // Changing the batch size regenerates the noises, so skip small changes
+  const unsigned int change = batch_size > settings_.batch_size ?
+    batch_size - settings_.batch_size : settings_.batch_size - batch_size;
+  if (change * 10 < settings_.batch_size) {
+    return;
+  }
+
+  settings_.batch_size = batch_size;
+  state_.reset(settings_.batch_size, settings_.time_steps);
+  costs_.resize({settings_.batch_size});
+  costs_.fill(0.0f);
+  generated_trajectories_.reset(settings_.batch_size, settings_.time_steps);
+  noise_generator_.reset(settings_, isHolonomic());
+  updateTensorMemory();
+  RCLCPP_DEBUG(logger_, "Optimizer batch size set to %u", settings_.batch_size);
+}
+
 bool Optimizer::fallback(bool fail)
 {
   static size_t counter = 0;
@@ -207,6 +289,7 @@ void Optimizer::prepare(
   state_.speed = robot_speed;
   path_ = utils::toTensor(plan);
   costs_.fill(0.0f);
+  costmap_view_.update(*costmap_);
 
   critics_data_.fail_flag = false;
   critics_data_.goal_checker = goal_checker;
@@ -217,22 +300,17 @@ void Optimizer::prepare(
 
 void Optimizer::shiftControlSequence()
 {
-  using namespace xt::placeholders;  // NOLINT
-  control_sequence_.vx = xt::roll(control_sequence_.vx, -1);
-  control_sequence_.wz = xt::roll(control_sequence_.wz, -1);
-
-
-  xt::view(control_sequence_.vx, -1) =
-    xt::view(control_sequence_.vx, -2);
-
-  xt::view(control_sequence_.wz, -1) =
-    xt::view(control_sequence_.wz, -2);
-
-
+  // Shift in place repeating the last control, so no buffer is reallocated
+  auto shift = [](xt::xtensor<float, 1> & controls) {
+      if (controls.size() > 1) {
+        std::copy(controls.begin() + 1, controls.end(), controls.begin());
+      }
+    };
+
+  shift(control_sequence_.vx);
+  shift(control_sequence_.wz);
   if (isHolonomic()) {
-    control_sequence_.vy = xt::roll(control_sequence_.vy, -1);
-    xt::view(control_sequence_.vy, -1) =
-      xt::view(control_sequence_.vy, -2);
+    shift(control_sequence_.vy);
   }
 }
 
@@ -309,79 +387,134 @@ void Optimizer::integrateStateVelocities(
   xt::xtensor<float, 2> & trajectory,
   const xt::xtensor<float, 2> & sequence) const
 {
-  float initial_yaw = static_cast<float>(tf2::getYaw(state_.pose.pose.orientation));
-
-  const auto vx = xt::view(sequence, xt::all(), 0);
-  const auto wz = xt::view(sequence, xt::all(), 1);
-
-  auto traj_x = xt::view(trajectory, xt::all(), 0);
-  auto traj_y = xt::view(trajectory, xt::all(), 1);
-  auto traj_yaws = xt::view(trajectory, xt::all(), 2);
-
-  xt::noalias(traj_yaws) = xt::cumsum(wz * settings_.model_dt, 0) + initial_yaw;
+  // Rolled out in a single pass like the batches, so no temporaries are allocated
+  const float initial_yaw = static_cast<float>(tf2::getYaw(state_.pose.pose.orientation));
+  const double initial_x = state_.pose.pose.position.x;
+  const double initial_y = state_.pose.pose.position.y;
+  const float dt = settings_.model_dt;
+  const bool is_holo = isHolonomic();
 
-  auto yaw_cos = xt::roll(xt::eval(xt::cos(traj_yaws)), 1);
-  auto yaw_sin = xt::roll(xt::eval(xt::sin(traj_yaws)), 1);
-  xt::view(yaw_cos, 0) = cosf(initial_yaw);
-  xt::view(yaw_sin, 0) = sinf(initial_yaw);
+  float yaw_sum = 0.0f;
+  float x_sum = 0.0f;
+  float y_sum = 0.0f;
+  float yaw_cos = cosf(initial_yaw);
+  float yaw_sin = sinf(initial_yaw);
+  for (size_t i = 0; i != sequence.shape(0); i++) {
+    const float vx = sequence(i, 0);
+    yaw_sum += sequence(i, 1) * dt;
+    const float yaw = yaw_sum + initial_yaw;
+    trajectory(i, 2) = yaw;
+
+    float dx = vx * yaw_cos;
+    float dy = vx * yaw_sin;
+    if (is_holo) {
+      const float vy = sequence(i, 2);
+      dx = dx - vy * yaw_sin;
+      dy = dy + vy * yaw_cos;
+    }
 
-  auto && dx = xt::eval(vx * yaw_cos);
-  auto && dy = xt::eval(vx * yaw_sin);
+    x_sum += dx * dt;
+    y_sum += dy * dt;
+    trajectory(i, 0) = static_cast<float>(initial_x + x_sum);
+    trajectory(i, 1) = static_cast<float>(initial_y + y_sum);
 
-  if (isHolonomic()) {
-    const auto vy = xt::view(sequence, xt::all(), 2);
-    dx = dx - vy * yaw_sin;
-    dy = dy + vy * yaw_cos;
+    yaw_cos = cosf(yaw);
+    yaw_sin = sinf(yaw);
   }
-
-  xt::noalias(traj_x) = state_.pose.pose.position.x + xt::cumsum(dx * settings_.model_dt, 0);
-  xt::noalias(traj_y) = state_.pose.pose.position.y + xt::cumsum(dy * settings_.model_dt, 0);
 }
 
 void Optimizer::integrateStateVelocities(
   models::Trajectories & trajectories,
   const models::State & state) const
 {
+  // Previously completed via chains of tensor expressions (cumsum, roll, cos, sin),
+  // which allocated several batch_size x time_steps temporaries per call. Rolling out
+  // each batch in a single pass over the contiguous row-major buffers avoids those
+  // and keeps the same order of floating point operations per element.
   const float initial_yaw = static_cast<float>(tf2::getYaw(state.pose.pose.orientation));
+  const float initial_yaw_cos = cosf(initial_yaw);
+  const float initial_yaw_sin = sinf(initial_yaw);
+  const double initial_x = state.pose.pose.position.x;
+  const double initial_y = state.pose.pose.position.y;
+  const float dt = settings_.model_dt;
+  const bool is_holo = isHolonomic();
 
-  xt::noalias(trajectories.yaws) =
-    xt::cumsum(state.wz * settings_.model_dt, {1}) + initial_yaw;
-
-  auto yaw_cos = xt::roll(xt::eval(xt::cos(trajectories.yaws)), 1, 1);
-  auto yaw_sin = xt::roll(xt::eval(xt::sin(trajectories.yaws)), 1, 1);
-  xt::view(yaw_cos, xt::all(), 0) = cosf(initial_yaw);
-  xt::view(yaw_sin, xt::all(), 0) = sinf(initial_yaw);
-
-  auto && dx = xt::eval(state.vx * yaw_cos);
-  auto && dy = xt::eval(state.vx * yaw_sin);
-
-  if (isHolonomic()) {
-    dx = dx - state.vy * yaw_sin;
-    dy = dy + state.vy * yaw_cos;
+  const size_t batch_size = state.vx.shape(0);
+  const size_t time_steps = state.vx.shape(1);
+  trajectories.x.resize(state.vx.shape());
+  trajectories.y.resize(state.vx.shape());
+  trajectories.yaws.resize(state.vx.shape());
+
+  const float * vx = state.vx.data();
+  const float * vy = state.vy.data();
+  const float * wz = state.wz.data();
+  float * traj_x = trajectories.x.data();
+  float * traj_y = trajectories.y.data();
+  float * traj_yaws = trajectories.yaws.data();
+
+  // Batches roll out independently, so they are split over threads without
+  // changing the trajectories
+  auto rollout = [&](size_t batch_begin, size_t batch_end) {
+      for (size_t i = batch_begin; i != batch_end; i++) {
+        const size_t row = i * time_steps;
+        float yaw_sum = 0.0f;
+        float x_sum = 0.0f;
+        float y_sum = 0.0f;
+        float yaw_cos = initial_yaw_cos;
+        float yaw_sin = initial_yaw_sin;
+        for (size_t j = 0; j != time_steps; j++) {
+          const size_t idx = row + j;
+          yaw_sum += wz[idx] * dt;
+          const float yaw = yaw_sum + initial_yaw;
+          traj_yaws[idx] = yaw;
+
+          // Poses are integrated with the heading of the previous time step
+          float dx = vx[idx] * yaw_cos;
+          float dy = vx[idx] * yaw_sin;
+          if (is_holo) {
+            dx = dx - vy[idx] * yaw_sin;
+            dy = dy + vy[idx] * yaw_cos;
+          }
+
+          x_sum += dx * dt;
+          y_sum += dy * dt;
+          traj_x[idx] = static_cast<float>(initial_x + x_sum);
+          traj_y[idx] = static_cast<float>(initial_y + y_sum);
+
+          yaw_cos = cosf(yaw);
+          yaw_sin = sinf(yaw);
+        }
+      }
+    };
+
+  const size_t parts = std::clamp<size_t>(rollout_threads_, 1, std::max<size_t>(batch_size, 1));
+  std::vector<std::thread> workers;
+  for (size_t part = 1; part < parts; part++) {
+    workers.emplace_back(
+      rollout, batch_size * part / parts, batch_size * (part + 1) / parts);
+  }
+  rollout(0, batch_size / parts);
+  for (auto & worker : workers) {
+    worker.join();
   }
-
-  xt::noalias(trajectories.x) = state.pose.pose.position.x +
-    xt::cumsum(dx * settings_.model_dt, {1});
-  xt::noalias(trajectories.y) = state.pose.pose.position.y +
-    xt::cumsum(dy * settings_.model_dt, {1});
 }
 
-xt::xtensor<float, 2> Optimizer::getOptimizedTrajectory()
+const xt::xtensor<float, 2> & Optimizer::getOptimizedTrajectory()
 {
+  // Reuses the buffers of the previous call, resized only if the shape changed
   const bool is_holo = isHolonomic();
-  auto && sequence =
-    xt::xtensor<float, 2>::from_shape({settings_.time_steps, is_holo ? 3u : 2u});
-  auto && trajectories = xt::xtensor<float, 2>::from_shape({settings_.time_steps, 3});
+  optimal_sequence_.resize({settings_.time_steps, is_holo ? 3u : 2u});
+  optimal_trajectory_.resize({settings_.time_steps, 3});
 
-  xt::noalias(xt::view(sequence, xt::all(), 0)) = control_sequence_.vx;
-  xt::noalias(xt::view(sequence, xt::all(), 1)) = control_sequence_.wz;
+  xt::noalias(xt::view(optimal_sequence_, xt::all(), 0)) = control_sequence_.vx;
+  xt::noalias(xt::view(optimal_sequence_, xt::all(), 1)) = control_sequence_.wz;
 
   if (is_holo) {
-    xt::noalias(xt::view(sequence, xt::all(), 2)) = control_sequence_.vy;
+    xt::noalias(xt::view(optimal_sequence_, xt::all(), 2)) = control_sequence_.vy;
   }
 
-  integrateStateVelocities(trajectories, sequence);
-  return std::move(trajectories);
+  integrateStateVelocities(optimal_trajectory_, optimal_sequence_);
+  return optimal_trajectory_;
 }
 
 void Optimizer::updateControlSequence()
@@ -43,8 +43,37 @@ ParametersHandler::dynamicParamsCallback(
   std::vector<rclcpp::Parameter> parameters)
 {
   rcl_interfaces::msg::SetParametersResult result;
-  std::lock_guard<std::mutex> lock(parameters_change_mutex_);
+  result.successful = true;
+
+  std::unique_lock<std::mutex> lock(parameters_change_mutex_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    // The controller is computing a command, so stage the changes for its next cycle
+    // rather than stalling both the callback and the control loop on the lock
+    std::lock_guard<std::mutex> staged_lock(staged_parameters_mutex_);
+    staged_parameters_.insert(staged_parameters_.end(), parameters.begin(), parameters.end());
+    return result;
+  }
+
+  applyStagedParameters();
+  applyParameters(parameters);
+  return result;
+}
+
+void ParametersHandler::applyStagedParameters()
+{
+  std::vector<rclcpp::Parameter> parameters;
+  {
+    std::lock_guard<std::mutex> staged_lock(staged_parameters_mutex_);
+    parameters.swap(staged_parameters_);
+  }
+
+  if (!parameters.empty()) {
+    applyParameters(parameters);
+  }
+}
 
+void ParametersHandler::applyParameters(const std::vector<rclcpp::Parameter> & parameters)
+{
   for (auto & pre_cb : pre_callbacks_) {
     pre_cb();
   }
@@ -64,9 +93,6 @@ ParametersHandler::dynamicParamsCallback(
   for (auto & post_cb : post_callbacks_) {
     post_cb();
   }
-
-  result.successful = true;
-  return result;
 }
 
 }  // namespace mppi
@@ -14,9 +14,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+
 #include "nav2_mppi_controller/tools/path_handler.hpp"
 #include "nav2_mppi_controller/tools/utils.hpp"
 #include "nav2_costmap_2d/costmap_2d_ros.hpp"
+#include "nav2_util/path_tracker.hpp"
 
 namespace mppi
 {
@@ -74,30 +77,25 @@ PathHandler::getGlobalPlanConsideringBoundsInCostmapFrame(
     nav2_util::geometry_utils::first_after_integrated_distance(
     closest_point, global_plan_up_to_inversion_.poses.end(), prune_distance_);
 
-  unsigned int mx, my;
-  // Find the furthest relevent pose on the path to consider within costmap
-  // bounds
-  // Transforming it to the costmap frame in the same loop
-  for (auto global_plan_pose = closest_point; global_plan_pose != pruned_plan_end;
-    ++global_plan_pose)
+  // Transform the poses up to the prune distance to the costmap frame with a single transform
+  if (!nav2_util::transformPoses(
+      closest_point, pruned_plan_end, global_plan_.header.frame_id,
+      costmap_->getGlobalFrameID(), global_pose.header.stamp,
+      tf2::durationFromSec(transform_tolerance_), tf_buffer_, transformed_plan.poses))
   {
-    // Transform from global plan frame to costmap frame
-    geometry_msgs::msg::PoseStamped costmap_plan_pose;
-    global_plan_pose->header.stamp = global_pose.header.stamp;
-    global_plan_pose->header.frame_id = global_plan_.header.frame_id;
-    transformPose(costmap_->getGlobalFrameID(), *global_plan_pose, costmap_plan_pose);
-
-    // Check if pose is inside the costmap
-    if (!costmap_->getCostmap()->worldToMap(
-        costmap_plan_pose.pose.position.x, costmap_plan_pose.pose.position.y, mx, my))
-    {
-      return {transformed_plan, closest_point};
-    }
-
-    // Filling the transformed plan to return with the transformed pose
-    transformed_plan.poses.push_back(costmap_plan_pose);
+    throw nav2_core::ControllerTFError("Unable to transform plan poses into costmap frame");
   }
 
+  // Find the furthest relevent pose on the path to consider within costmap bounds
+  unsigned int mx, my;
+  auto outside_costmap = std::find_if(
+    transformed_plan.poses.begin(), transformed_plan.poses.end(),
+    [&](const geometry_msgs::msg::PoseStamped & costmap_plan_pose) {
+      return !costmap_->getCostmap()->worldToMap(
+        costmap_plan_pose.pose.position.x, costmap_plan_pose.pose.position.y, mx, my);
+    });
+  transformed_plan.poses.erase(outside_costmap, transformed_plan.poses.end());
+
   return {transformed_plan, closest_point};
 }
 
@@ -12,7 +12,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <functional>
 #include <memory>
+#include <utility>
+
 #include "nav2_mppi_controller/tools/trajectory_visualizer.hpp"
 
 namespace mppi
@@ -40,6 +44,7 @@ void TrajectoryVisualizer::on_configure(
 
 void TrajectoryVisualizer::on_cleanup()
 {
+  stopPublishing();
   trajectories_publisher_.reset();
   transformed_path_pub_.reset();
 }
@@ -48,10 +53,15 @@ void TrajectoryVisualizer::on_activate()
 {
   trajectories_publisher_->on_activate();
   transformed_path_pub_->on_activate();
+
+  stopPublishing();
+  publishing_ = true;
+  publish_thread_ = std::thread(std::bind(&TrajectoryVisualizer::publishThread, this));
 }
 
 void TrajectoryVisualizer::on_deactivate()
 {
+  stopPublishing();
   trajectories_publisher_->on_deactivate();
   transformed_path_pub_->on_deactivate();
 }
@@ -64,22 +74,20 @@ void TrajectoryVisualizer::add(
     return;
   }
 
-  auto add_marker = [&](auto i) {
-      float component = static_cast<float>(i) / static_cast<float>(size);
-
-      auto pose = utils::createPose(trajectory(i, 0), trajectory(i, 1), 0.06);
-      auto scale =
-        i != size - 1 ?
-        utils::createScale(0.03, 0.03, 0.07) :
-        utils::createScale(0.07, 0.07, 0.09);
-      auto color = utils::createColor(0, component, component, 1);
-      auto marker = utils::createMarker(
-        marker_id_++, pose, scale, color, frame_id_, marker_namespace);
-      points_->markers.push_back(marker);
-    };
-
   for (size_t i = 0; i < size; i++) {
-    add_marker(i);
+    float component = static_cast<float>(i) / static_cast<float>(size);
+
+    auto & marker = nextMarker();
+    marker.type = visualization_msgs::msg::Marker::SPHERE;
+    marker.ns = marker_namespace;
+    marker.pose = utils::createPose(trajectory(i, 0), trajectory(i, 1), 0.06);
+    marker.scale =
+      i != size - 1 ?
+      utils::createScale(0.03, 0.03, 0.07) :
+      utils::createScale(0.07, 0.07, 0.09);
+    marker.color = utils::createColor(0, component, component, 1);
+    marker.points.clear();
+    marker.colors.clear();
   }
 }
 
@@ -88,35 +96,77 @@ void TrajectoryVisualizer::add(
 {
   auto & shape = trajectories.x.shape();
   const float shape_1 = static_cast<float>(shape[1]);
-  points_->markers.reserve(floor(shape[0] / trajectory_step_) * floor(shape[1] * time_step_));
+  if (!shape[0] || shape[1] < 2) {
+    return;
+  }
 
-  for (size_t i = 0; i < shape[0]; i += trajectory_step_) {
-    for (size_t j = 0; j < shape[1]; j += time_step_) {
+  auto & marker = nextMarker();
+  marker.type = visualization_msgs::msg::Marker::LINE_LIST;
+  marker.ns = marker_namespace;
+  marker.pose = utils::createPose(0.0, 0.0, 0.03);
+  marker.scale = utils::createScale(0.01, 0.0, 0.0);
+  marker.color = utils::createColor(0, 1, 0, 1);
+
+  // Each pair of consecutive points is a segment of the list
+  const size_t trajectory_step = std::max<size_t>(trajectory_step_, 1);
+  const size_t time_step = std::max<size_t>(time_step_, 1);
+  const size_t trajectory_count = (shape[0] + trajectory_step - 1) / trajectory_step;
+  const size_t point_count = (shape[1] + time_step - 1) / time_step;
+  const size_t size = trajectory_count * 2 * (point_count - 1);
+  marker.points.resize(size);
+  marker.colors.resize(size);
+
+  size_t idx = 0;
+  auto add_point = [&](size_t i, size_t j) {
       const float j_flt = static_cast<float>(j);
-      float blue_component = 1.0f - j_flt / shape_1;
-      float green_component = j_flt / shape_1;
-
-      auto pose = utils::createPose(trajectories.x(i, j), trajectories.y(i, j), 0.03);
-      auto scale = utils::createScale(0.03, 0.03, 0.03);
-      auto color = utils::createColor(0, green_component, blue_component, 1);
-      auto marker = utils::createMarker(
-        marker_id_++, pose, scale, color, frame_id_, marker_namespace);
+      auto & point = marker.points[idx];
+      point.x = trajectories.x(i, j);
+      point.y = trajectories.y(i, j);
+      point.z = 0.0;
+      marker.colors[idx] = utils::createColor(0, j_flt / shape_1, 1.0f - j_flt / shape_1, 1);
+      idx++;
+    };
 
-      points_->markers.push_back(marker);
+  for (size_t i = 0; i < shape[0]; i += trajectory_step) {
+    for (size_t j = time_step; j < shape[1]; j += time_step) {
+      add_point(i, j - time_step);
+      add_point(i, j);
     }
   }
 }
 
+visualization_msgs::msg::Marker & TrajectoryVisualizer::nextMarker()
+{
+  if (static_cast<size_t>(marker_id_) == points_.markers.size()) {
+    points_.markers.emplace_back();
+  }
+
+  auto & marker = points_.markers[marker_id_];
+  marker.header.frame_id = frame_id_;
+  marker.header.stamp = rclcpp::Time(0, 0);
+  marker.id = marker_id_++;
+  marker.action = visualization_msgs::msg::Marker::ADD;
+  return marker;
+}
+
 void TrajectoryVisualizer::reset()
 {
   marker_id_ = 0;
-  points_ = std::make_unique<visualization_msgs::msg::MarkerArray>();
 }
 
 void TrajectoryVisualizer::visualize(const nav_msgs::msg::Path & plan)
 {
   if (trajectories_publisher_->get_subscription_count() > 0) {
-    trajectories_publisher_->publish(std::move(points_));
+    points_.markers.resize(marker_id_);
+
+    // Hand the markers over to the publishing thread, unless it has not taken the
+    // previous ones yet, in which case these are dropped rather than waited for
+    std::unique_lock<std::mutex> guard(publish_lock_);
+    if (publishing_ && !publish_ready_) {
+      std::swap(points_, publish_points_);
+      publish_ready_ = true;
+      publish_cond_.notify_all();
+    }
   }
 
   reset();
@@ -127,4 +177,35 @@ void TrajectoryVisualizer::visualize(const nav_msgs::msg::Path & plan)
   }
 }
 
+void TrajectoryVisualizer::publishThread()
+{
+  std::unique_lock<std::mutex> guard(publish_lock_);
+  while (true) {
+    publish_cond_.wait(guard, [this]() {return publish_ready_ || !publishing_;});
+    if (!publishing_) {
+      return;
+    }
+
+    // Serialize and publish without holding the lock, so visualize never waits
+    std::swap(publish_points_, published_points_);
+    publish_ready_ = false;
+    guard.unlock();
+    trajectories_publisher_->publish(published_points_);
+    guard.lock();
+  }
+}
+
+void TrajectoryVisualizer::stopPublishing()
+{
+  {
+    std::unique_lock<std::mutex> guard(publish_lock_);
+    publishing_ = false;
+    publish_ready_ = false;
+  }
+  publish_cond_.notify_all();
+  if (publish_thread_.joinable()) {
+    publish_thread_.join();
+  }
+}
+
 }  // namespace mppi
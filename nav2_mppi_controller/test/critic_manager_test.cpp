@@ -12,12 +12,14 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <chrono>
 #include <thread>
 
 #include "gtest/gtest.h"
 #include "rclcpp/rclcpp.hpp"
 #include "nav2_mppi_controller/critic_manager.hpp"
+#include "xtensor/xview.hpp"
 
 // Tests critic manager
 
@@ -84,6 +86,125 @@ public:
   }
 };
 
+class ConstantCritic : public CriticFunction
+{
+public:
+  explicit ConstantCritic(float cost)
+  : cost_(cost) {}
+  virtual void initialize() {}
+  virtual void score(CriticData & data) {data.costs += cost_;}
+  float cost_;
+};
+
+class CriticManagerWrapperThreaded : public CriticManager
+{
+public:
+  CriticManagerWrapperThreaded()
+  : CriticManager() {}
+
+  virtual ~CriticManagerWrapperThreaded() = default;
+
+  virtual void loadCritics()
+  {
+    critics_.clear();
+    for (unsigned int i = 1; i != 5; i++) {
+      critics_.push_back(std::make_unique<ConstantCritic>(static_cast<float>(i)));
+      critics_.back()->on_configure(
+        parent_, name_, name_ + "." + "ConstantCritic" + std::to_string(i), costmap_ros_,
+        parameters_handler_);
+    }
+  }
+
+  size_t getWorkersNum()
+  {
+    return workers_.size();
+  }
+};
+
+class RowCritic : public CriticFunction
+{
+public:
+  virtual void initialize() {}
+  virtual void score(CriticData & data)
+  {
+    max_rows_ = std::max(max_rows_, data.trajectories.x.shape(0));
+    data.costs += xt::view(data.trajectories.x, xt::all(), 0);
+  }
+  bool isChunkable() const override {return true;}
+  size_t max_rows_{0};
+};
+
+class CriticManagerWrapperChunked : public CriticManager
+{
+public:
+  CriticManagerWrapperChunked()
+  : CriticManager() {}
+
+  virtual ~CriticManagerWrapperChunked() = default;
+
+  virtual void loadCritics()
+  {
+    critics_.clear();
+    critics_.push_back(std::make_unique<RowCritic>());
+    critics_.push_back(std::make_unique<ConstantCritic>(2.0f));
+    for (auto & critic : critics_) {
+      critic->on_configure(parent_, name_, name_ + ".Critic", costmap_ros_, parameters_handler_);
+    }
+  }
+
+  size_t getMaxChunkRows()
+  {
+    return dynamic_cast<RowCritic *>(critics_[0].get())->max_rows_;
+  }
+};
+
+class GatingCritic : public CriticFunction
+{
+public:
+  explicit GatingCritic(float collision_cost)
+  : collision_cost_(collision_cost) {}
+  virtual void initialize() {}
+  virtual void score(CriticData & data)
+  {
+    // Odd trajectories are in collision
+    for (size_t i = 1; i < data.costs.shape(0); i += 2) {
+      data.costs(i) += collision_cost_;
+      if (data.collisions) {
+        (*data.collisions)[i] = 1;
+      }
+    }
+  }
+  bool isGating() const override {return true;}
+  float collision_cost_;
+};
+
+class CriticManagerWrapperCulled : public CriticManager
+{
+public:
+  explicit CriticManagerWrapperCulled(float collision_cost)
+  : CriticManager(), collision_cost_(collision_cost) {}
+
+  virtual ~CriticManagerWrapperCulled() = default;
+
+  virtual void loadCritics()
+  {
+    critics_.clear();
+    critics_.push_back(std::make_unique<RowCritic>());
+    critics_.push_back(std::make_unique<ConstantCritic>(2.0f));
+    critics_.push_back(std::make_unique<GatingCritic>(collision_cost_));
+    for (auto & critic : critics_) {
+      critic->on_configure(parent_, name_, name_ + ".Critic", costmap_ros_, parameters_handler_);
+    }
+  }
+
+  size_t getMaxChunkRows()
+  {
+    return dynamic_cast<RowCritic *>(critics_[0].get())->max_rows_;
+  }
+
+  float collision_cost_;
+};
+
 class CriticManagerWrapperEnum : public CriticManager
 {
 public:
@@ -150,3 +271,123 @@ TEST(CriticManagerTests, CriticLoadingTest)
   critic_manager.on_configure(node, "critic_manager", costmap_ros, &param_handler);
   EXPECT_EQ(critic_manager.getCriticNum(), 2u);
 }
+
+TEST(CriticManagerTests, ThreadedCriticScoring)
+{
+  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("my_node");
+  node->declare_parameter("critic_manager.critic_threads", rclcpp::ParameterValue(3));
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>(
+    "dummy_costmap", "", "dummy_costmap", true);
+  ParametersHandler param_handler(node);
+  rclcpp_lifecycle::State lstate;
+  costmap_ros->on_configure(lstate);
+
+  // The calling thread scores critics too, so one less worker should be started
+  CriticManagerWrapperThreaded critic_manager;
+  critic_manager.on_configure(node, "critic_manager", costmap_ros, &param_handler);
+  EXPECT_EQ(critic_manager.getWorkersNum(), 2u);
+
+  models::State state;
+  models::Trajectories generated_trajectories;
+  models::Path path;
+  xt::xtensor<float, 1> costs = xt::ones<float>({100});
+  float model_dt = 0.1;
+  CriticData data =
+  {state, generated_trajectories, path, costs, model_dt, false, nullptr, nullptr,
+    std::nullopt, std::nullopt};
+
+  // Each critic's contribution should be accumulated over repeated evaluations
+  for (unsigned int i = 0; i != 10; i++) {
+    critic_manager.evalTrajectoriesScores(data);
+  }
+  EXPECT_FALSE(data.fail_flag);
+  for (unsigned int i = 0; i != costs.shape(0); i++) {
+    EXPECT_NEAR(costs(i), 1.0f + 10.0f * (1.0f + 2.0f + 3.0f + 4.0f), 1e-6);
+  }
+
+  // Workers should cleanly shut down
+  critic_manager.stopWorkers();
+  EXPECT_EQ(critic_manager.getWorkersNum(), 0u);
+}
+
+TEST(CriticManagerTests, ChunkedCriticScoring)
+{
+  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("my_node");
+  node->declare_parameter("critic_manager.critic_chunk_size", rclcpp::ParameterValue(16));
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>(
+    "dummy_costmap", "", "dummy_costmap", true);
+  ParametersHandler param_handler(node);
+  rclcpp_lifecycle::State lstate;
+  costmap_ros->on_configure(lstate);
+
+  CriticManagerWrapperChunked critic_manager;
+  critic_manager.on_configure(node, "critic_manager", costmap_ros, &param_handler);
+
+  models::State state;
+  state.reset(100, 10);
+  models::Trajectories generated_trajectories;
+  generated_trajectories.reset(100, 10);
+  for (unsigned int i = 0; i != 100; i++) {
+    xt::view(generated_trajectories.x, i, xt::all()) = static_cast<float>(i);
+  }
+  models::Path path;
+  xt::xtensor<float, 1> costs = xt::ones<float>({100});
+  float model_dt = 0.1;
+  CriticData data =
+  {state, generated_trajectories, path, costs, model_dt, false, nullptr, nullptr,
+    std::nullopt, std::nullopt};
+
+  // Chunked critics should score each trajectory of its chunk into its own cost
+  critic_manager.evalTrajectoriesScores(data);
+  EXPECT_FALSE(data.fail_flag);
+  EXPECT_EQ(critic_manager.getMaxChunkRows(), 16u);
+  for (unsigned int i = 0; i != costs.shape(0); i++) {
+    EXPECT_NEAR(costs(i), 1.0f + i + 2.0f, 1e-6);
+  }
+}
+
+TEST(CriticManagerTests, CulledCriticScoring)
+{
+  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("my_node");
+  node->declare_parameter(
+    "critic_manager.cull_colliding_trajectories", rclcpp::ParameterValue(true));
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>(
+    "dummy_costmap", "", "dummy_costmap", true);
+  ParametersHandler param_handler(node);
+  rclcpp_lifecycle::State lstate;
+  costmap_ros->on_configure(lstate);
+
+  models::State state;
+  state.reset(100, 10);
+  models::Trajectories generated_trajectories;
+  generated_trajectories.reset(100, 10);
+  for (unsigned int i = 0; i != 100; i++) {
+    xt::view(generated_trajectories.x, i, xt::all()) = static_cast<float>(i);
+  }
+  models::Path path;
+  float model_dt = 0.1;
+
+  for (const float collision_cost : {1000.0f, 10.0f}) {
+    CriticManagerWrapperCulled critic_manager(collision_cost);
+    critic_manager.on_configure(node, "critic_manager", costmap_ros, &param_handler);
+
+    xt::xtensor<float, 1> costs = xt::ones<float>({100});
+    CriticData data =
+    {state, generated_trajectories, path, costs, model_dt, false, nullptr, nullptr,
+      std::nullopt, std::nullopt};
+    critic_manager.evalTrajectoriesScores(data);
+    EXPECT_FALSE(data.fail_flag);
+
+    // The chunkable critic only scores the trajectories out of collision, and those in
+    // collision cost at least as much as any of them
+    EXPECT_EQ(critic_manager.getMaxChunkRows(), 50u);
+    const float max_cost = 1.0f + 98.0f + 2.0f;
+    for (unsigned int i = 0; i != costs.shape(0); i++) {
+      if (i % 2 == 0) {
+        EXPECT_NEAR(costs(i), 1.0f + i + 2.0f, 1e-6);
+      } else {
+        EXPECT_NEAR(costs(i), std::max(1.0f + collision_cost + 2.0f, max_cost), 1e-6);
+      }
+    }
+  }
+}
@@ -53,6 +53,13 @@ TEST(ModelsTest, ControlSequenceTest)
   EXPECT_EQ(sequence.vx.shape(0), 20u);
   EXPECT_EQ(sequence.vy.shape(0), 20u);
   EXPECT_EQ(sequence.wz.shape(0), 20u);
+
+  // Show resets to the same size keep the memory in place
+  const float * vx_data = sequence.vx.data();
+  sequence.vx(4) = 1;
+  sequence.reset(20);
+  EXPECT_EQ(sequence.vx.data(), vx_data);
+  EXPECT_EQ(sequence.vx(4), 0);
 }
 
 TEST(ModelsTest, PathTest)
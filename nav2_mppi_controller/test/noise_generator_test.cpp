@@ -13,12 +13,18 @@
 // limitations under the License.
 
 #include <chrono>
+#include <cmath>
 #include <thread>
+#include <utility>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "rclcpp/rclcpp.hpp"
 #include "rclcpp_lifecycle/lifecycle_node.hpp"
+#include "xtensor/xmath.hpp"
 #include "nav2_mppi_controller/tools/noise_generator.hpp"
+#include "nav2_mppi_controller/tools/normal_generator.hpp"
+#include "nav2_core/controller_exceptions.hpp"
 #include "nav2_mppi_controller/tools/parameters_handler.hpp"
 #include "nav2_mppi_controller/models/optimizer_settings.hpp"
 #include "nav2_mppi_controller/models/state.hpp"
@@ -129,3 +135,186 @@ TEST(NoiseGeneratorTest, NoiseGeneratorMain)
 
   generator.shutdown();
 }
+
+TEST(NoiseGeneratorTest, NormalGeneratorPhilox)
+{
+  // Known answers of the Philox4x32-10 reference implementation
+  auto words = NormalGenerator::philox({0, 0, 0, 0}, {0, 0});
+  EXPECT_EQ(words[0], 0x6627e8d5u);
+  EXPECT_EQ(words[1], 0xe169c58du);
+  EXPECT_EQ(words[2], 0xbc57ac4cu);
+  EXPECT_EQ(words[3], 0x9b00dbd8u);
+  words = NormalGenerator::philox(
+    {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff});
+  EXPECT_EQ(words[0], 0x408f276du);
+  EXPECT_EQ(words[1], 0x41c83b0eu);
+  EXPECT_EQ(words[2], 0xa20bc7c6u);
+  EXPECT_EQ(words[3], 0x6d5451fdu);
+}
+
+TEST(NoiseGeneratorTest, NormalGeneratorStreams)
+{
+  NormalGenerator generator(42);
+  const size_t size = 10007;
+  std::vector<float> samples(size), other(size);
+
+  // Samples have the requested distribution
+  generator.fill(samples.data(), 0, size, 2.0f, 0);
+  double sum = 0.0, sum_squares = 0.0;
+  for (float sample : samples) {
+    EXPECT_TRUE(std::isfinite(sample));
+    sum += sample;
+    sum_squares += sample * sample;
+  }
+  EXPECT_NEAR(sum / size, 0.0, 0.1);
+  EXPECT_NEAR(std::sqrt(sum_squares / size), 2.0, 0.1);
+
+  // Streams are reproducible, whatever the ranges they are generated in
+  generator.fill(other.data(), 0, 3, 2.0f, 0);
+  generator.fill(other.data() + 3, 3, 1500, 2.0f, 0);
+  generator.fill(other.data() + 1500, 1500, size, 2.0f, 0);
+  EXPECT_EQ(samples, other);
+
+  // Other streams and seeds differ
+  generator.fill(other.data(), 0, size, 2.0f, 1);
+  EXPECT_NE(samples, other);
+  generator.seed(43);
+  generator.fill(other.data(), 0, size, 2.0f, 0);
+  EXPECT_NE(samples, other);
+}
+
+TEST(NoiseGeneratorTest, NoiseGeneratorThreads)
+{
+  // Noises only depend on the seed, not the number of threads generating them
+  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("node");
+  node->declare_parameter("single.regenerate_noises", rclcpp::ParameterValue(false));
+  node->declare_parameter("multi.regenerate_noises", rclcpp::ParameterValue(false));
+  node->declare_parameter("multi.noise_threads", rclcpp::ParameterValue(4));
+  ParametersHandler handler(node);
+  mppi::models::OptimizerSettings settings;
+  settings.batch_size = 1000;
+  settings.time_steps = 56;
+  settings.sampling_std.vx = 0.2;
+  settings.sampling_std.vy = 0.2;
+  settings.sampling_std.wz = 0.4;
+
+  mppi::models::ControlSequence control_sequence;
+  control_sequence.reset(settings.time_steps);
+  mppi::models::State single_state, multi_state;
+  single_state.reset(settings.batch_size, settings.time_steps);
+  multi_state.reset(settings.batch_size, settings.time_steps);
+
+  NoiseGenerator single, multi;
+  single.initialize(settings, true, "single", &handler);
+  multi.initialize(settings, true, "multi", &handler);
+  single.setNoisedControls(single_state, control_sequence);
+  multi.setNoisedControls(multi_state, control_sequence);
+  EXPECT_EQ(single_state.cvx, multi_state.cvx);
+  EXPECT_EQ(single_state.cvy, multi_state.cvy);
+  EXPECT_EQ(single_state.cwz, multi_state.cwz);
+  EXPECT_NE(single_state.cvx, single_state.cwz);
+  single.shutdown();
+  multi.shutdown();
+}
+
+TEST(NoiseGeneratorTest, NormalGeneratorQuantile)
+{
+  EXPECT_NEAR(NormalGenerator::quantile(0.5f), 0.0f, 1e-6);
+  EXPECT_NEAR(NormalGenerator::quantile(0.975f), 1.959964f, 1e-4);
+  EXPECT_NEAR(NormalGenerator::quantile(0.025f), -1.959964f, 1e-4);
+  EXPECT_NEAR(NormalGenerator::quantile(0.001f), -3.090232f, 1e-4);
+  EXPECT_NEAR(NormalGenerator::quantile(0.8413447f), 1.0f, 1e-4);
+}
+
+TEST(NoiseGeneratorTest, NoiseGeneratorModes)
+{
+  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("node");
+  node->declare_parameter("correlated.noise_mode", rclcpp::ParameterValue("Correlated"));
+  node->declare_parameter("correlated.noise_correlation", rclcpp::ParameterValue(0.9));
+  node->declare_parameter("halton.noise_mode", rclcpp::ParameterValue("Halton"));
+  node->declare_parameter("halton.noise_knots", rclcpp::ParameterValue(3));
+  node->declare_parameter("invalid.noise_mode", rclcpp::ParameterValue("Invalid"));
+  ParametersHandler handler(node);
+  mppi::models::OptimizerSettings settings;
+  settings.batch_size = 2000;
+  settings.time_steps = 21;
+  settings.sampling_std.vx = 0.5;
+  settings.sampling_std.vy = 0.5;
+  settings.sampling_std.wz = 0.5;
+
+  mppi::models::ControlSequence control_sequence;
+  control_sequence.reset(settings.time_steps);
+  mppi::models::State state;
+  state.reset(settings.batch_size, settings.time_steps);
+
+  // Returns the variance of the noises at a time step and their correlation with the next
+  auto statistics = [&](const xt::xtensor<float, 2> & noises, size_t t) {
+      double variance = 0.0, covariance = 0.0;
+      for (size_t i = 0; i != settings.batch_size; i++) {
+        variance += noises(i, t) * noises(i, t);
+        covariance += noises(i, t) * noises(i, t + 1);
+      }
+      return std::make_pair(variance / settings.batch_size, covariance / variance);
+    };
+
+  // Correlated noises keep the variance of the gaussian noises
+  NoiseGenerator correlated;
+  correlated.initialize(settings, false, "correlated", &handler);
+  correlated.setNoisedControls(state, control_sequence);
+  auto result = statistics(state.cvx, 10);
+  EXPECT_NEAR(result.first, 0.25, 0.03);
+  EXPECT_NEAR(result.second, 0.9, 0.03);
+  correlated.shutdown();
+
+  // Halton noises are linear between the knots, at the first, middle and last time steps
+  NoiseGenerator halton;
+  halton.initialize(settings, false, "halton", &handler);
+  halton.setNoisedControls(state, control_sequence);
+  result = statistics(state.cwz, 0);
+  EXPECT_NEAR(result.first, 0.25, 0.03);
+  result = statistics(state.cwz, 10);
+  EXPECT_NEAR(result.first, 0.25, 0.03);
+  EXPECT_NEAR(state.cvx(7, 5), (state.cvx(7, 0) + state.cvx(7, 10)) / 2, 1e-5);
+  EXPECT_NE(state.cvx(7, 0), state.cvx(8, 0));
+  halton.shutdown();
+
+  NoiseGenerator invalid;
+  EXPECT_THROW(
+    invalid.initialize(settings, false, "invalid", &handler), nav2_core::ControllerException);
+}
+
+TEST(NoiseGeneratorTest, NoiseGeneratorInt16Storage)
+{
+  // Quantized noises only differ from the float noises by half a quantization step
+  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("node");
+  node->declare_parameter("quantized.noise_storage", rclcpp::ParameterValue("Int16"));
+  node->declare_parameter("invalid.noise_storage", rclcpp::ParameterValue("Invalid"));
+  ParametersHandler handler(node);
+  mppi::models::OptimizerSettings settings;
+  settings.batch_size = 1000;
+  settings.time_steps = 56;
+  settings.sampling_std.vx = 0.2;
+  settings.sampling_std.vy = 0.2;
+  settings.sampling_std.wz = 0.4;
+
+  mppi::models::ControlSequence control_sequence;
+  control_sequence.reset(settings.time_steps);
+  mppi::models::State float_state, quantized_state;
+  float_state.reset(settings.batch_size, settings.time_steps);
+  quantized_state.reset(settings.batch_size, settings.time_steps);
+
+  NoiseGenerator float_generator, quantized_generator;
+  float_generator.initialize(settings, true, "float", &handler);
+  quantized_generator.initialize(settings, true, "quantized", &handler);
+  float_generator.setNoisedControls(float_state, control_sequence);
+  quantized_generator.setNoisedControls(quantized_state, control_sequence);
+  EXPECT_LE(xt::amax(xt::abs(float_state.cvx - quantized_state.cvx))(), 0.2f / 8192 + 1e-6f);
+  EXPECT_LE(xt::amax(xt::abs(float_state.cvy - quantized_state.cvy))(), 0.2f / 8192 + 1e-6f);
+  EXPECT_LE(xt::amax(xt::abs(float_state.cwz - quantized_state.cwz))(), 0.4f / 8192 + 1e-6f);
+  float_generator.shutdown();
+  quantized_generator.shutdown();
+
+  NoiseGenerator invalid;
+  EXPECT_THROW(
+    invalid.initialize(settings, false, "invalid", &handler), nav2_core::ControllerException);
+}
@@ -17,6 +17,7 @@
 
 #include "gtest/gtest.h"
 #include "rclcpp/rclcpp.hpp"
+#include "xtensor/xrandom.hpp"
 #include "nav2_mppi_controller/optimizer.hpp"
 
 // Tests main optimizer functions
@@ -222,6 +223,27 @@ public:
   {
     return integrateStateVelocities(traj, state);
   }
+
+  void setRolloutThreads(unsigned int rollout_threads)
+  {
+    rollout_threads_ = rollout_threads;
+  }
+
+  size_t optimizeWrapper(float convergence_threshold)
+  {
+    convergence_threshold_ = convergence_threshold;
+    optimize();
+    return iterations_;
+  }
+
+  unsigned int adaptBatchSizeWrapper(double compute_time)
+  {
+    adaptBatchSize(compute_time);
+    EXPECT_EQ(state_.vx.shape(0), settings_.batch_size);
+    EXPECT_EQ(costs_.shape(0), settings_.batch_size);
+    EXPECT_EQ(generated_trajectories_.x.shape(0), settings_.batch_size);
+    return settings_.batch_size;
+  }
 };
 
 TEST(OptimizerTests, BasicInitializedFunctions)
@@ -652,3 +674,90 @@ TEST(OptimizerTests, integrateStateVelocitiesTests)
     EXPECT_NEAR(traj.y(1, i), y, 1e-6);
   }
 }
+
+TEST(OptimizerTests, integrateStateVelocitiesThreadsTests)
+{
+  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("my_node");
+  OptimizerTester optimizer_tester;
+  node->declare_parameter("controller_frequency", rclcpp::ParameterValue(30.0));
+  node->declare_parameter("mppic.batch_size", rclcpp::ParameterValue(1000));
+  node->declare_parameter("mppic.model_dt", rclcpp::ParameterValue(0.1));
+  node->declare_parameter("mppic.time_steps", rclcpp::ParameterValue(50));
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>(
+    "dummy_costmap", "", "dummy_costmap", true);
+  ParametersHandler param_handler(node);
+  rclcpp_lifecycle::State lstate;
+  costmap_ros->on_configure(lstate);
+  optimizer_tester.initialize(node, "mppic", costmap_ros, &param_handler);
+  optimizer_tester.resetMotionModel();
+  optimizer_tester.testSetOmniModel();
+
+  // Rolling out batches on several threads should give the same trajectories,
+  // including when batches do not split evenly over the threads
+  models::State state;
+  state.reset(1001, 50);
+  state.vx = xt::random::randn<float>({1001, 50}, 0.0f, 0.5f);
+  state.vy = xt::random::randn<float>({1001, 50}, 0.0f, 0.5f);
+  state.wz = xt::random::randn<float>({1001, 50}, 0.0f, 1.0f);
+
+  models::Trajectories traj, threaded_traj;
+  optimizer_tester.integrateStateVelocitiesWrapper(traj, state);
+  for (unsigned int threads : {2u, 3u, 8u}) {
+    optimizer_tester.setRolloutThreads(threads);
+    optimizer_tester.integrateStateVelocitiesWrapper(threaded_traj, state);
+    EXPECT_EQ(traj.x, threaded_traj.x);
+    EXPECT_EQ(traj.y, threaded_traj.y);
+    EXPECT_EQ(traj.yaws, threaded_traj.yaws);
+  }
+}
+
+TEST(OptimizerTests, convergenceTests)
+{
+  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("my_node");
+  OptimizerTester optimizer_tester;
+  node->declare_parameter("controller_frequency", rclcpp::ParameterValue(30.0));
+  node->declare_parameter("mppic.batch_size", rclcpp::ParameterValue(100));
+  node->declare_parameter("mppic.time_steps", rclcpp::ParameterValue(20));
+  node->declare_parameter("mppic.iteration_count", rclcpp::ParameterValue(5));
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>(
+    "dummy_costmap", "", "dummy_costmap", true);
+  ParametersHandler param_handler(node);
+  rclcpp_lifecycle::State lstate;
+  costmap_ros->on_configure(lstate);
+  optimizer_tester.initialize(node, "mppic", costmap_ros, &param_handler);
+
+  // Without a threshold all iterations run, with a large one the first converges
+  EXPECT_EQ(optimizer_tester.optimizeWrapper(0.0f), 5u);
+  EXPECT_EQ(optimizer_tester.optimizeWrapper(1000.0f), 1u);
+}
+
+TEST(OptimizerTests, adaptBatchSizeTests)
+{
+  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("my_node");
+  OptimizerTester optimizer_tester;
+  node->declare_parameter("controller_frequency", rclcpp::ParameterValue(10.0));
+  node->declare_parameter("mppic.model_dt", rclcpp::ParameterValue(0.1));
+  node->declare_parameter("mppic.batch_size", rclcpp::ParameterValue(1000));
+  node->declare_parameter("mppic.time_steps", rclcpp::ParameterValue(20));
+  node->declare_parameter("mppic.adaptive_batch_size", rclcpp::ParameterValue(true));
+  node->declare_parameter("mppic.min_batch_size", rclcpp::ParameterValue(300));
+  node->declare_parameter("mppic.max_batch_size", rclcpp::ParameterValue(3000));
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>(
+    "dummy_costmap", "", "dummy_costmap", true);
+  ParametersHandler param_handler(node);
+  rclcpp_lifecycle::State lstate;
+  costmap_ros->on_configure(lstate);
+  optimizer_tester.initialize(node, "mppic", costmap_ros, &param_handler);
+
+  // Targets half of the 0.1s period: on target or nearly so the batch is kept
+  EXPECT_EQ(optimizer_tester.adaptBatchSizeWrapper(0.05), 1000u);
+  EXPECT_EQ(optimizer_tester.adaptBatchSizeWrapper(0.048), 1000u);
+
+  // Too slow scales down, by at most half, and too fast scales up, by at most twice
+  EXPECT_EQ(optimizer_tester.adaptBatchSizeWrapper(1.0), 500u);
+  EXPECT_EQ(optimizer_tester.adaptBatchSizeWrapper(1.0), 300u);
+  EXPECT_EQ(optimizer_tester.adaptBatchSizeWrapper(0.001), 600u);
+  EXPECT_EQ(optimizer_tester.adaptBatchSizeWrapper(0.001), 1200u);
+  EXPECT_EQ(optimizer_tester.adaptBatchSizeWrapper(0.001), 2400u);
+  EXPECT_EQ(optimizer_tester.adaptBatchSizeWrapper(0.001), 3000u);
+}
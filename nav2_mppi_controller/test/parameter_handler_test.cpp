@@ -122,6 +122,36 @@ TEST(ParameterHandlerTest, PrePostDynamicCallbackTest)
   EXPECT_TRUE(post_triggered);
 }
 
+TEST(ParameterHandlerTest, StagedDynamicParametersTest)
+{
+  int post_triggered = 0;
+  int val = 0;
+  ParametersHandlerWrapper a;
+  a.addPostCallback([&]() {post_triggered++;});
+  a.setDynamicParamCallback(val, "val");
+
+  // While the parameters are locked, the changes are staged rather than applied
+  {
+    std::lock_guard<std::mutex> lock(*a.getLock());
+    a.dynamicParamsCallback({rclcpp::Parameter("val", 1)});
+    a.dynamicParamsCallback({rclcpp::Parameter("val", 2)});
+    EXPECT_EQ(val, 0);
+    EXPECT_EQ(post_triggered, 0);
+
+    // Applied in order at the start of the next cycle
+    a.applyStagedParameters();
+    EXPECT_EQ(val, 2);
+    EXPECT_EQ(post_triggered, 1);
+    a.applyStagedParameters();
+    EXPECT_EQ(post_triggered, 1);
+  }
+
+  // Applied right away otherwise
+  a.dynamicParamsCallback({rclcpp::Parameter("val", 3)});
+  EXPECT_EQ(val, 3);
+  EXPECT_EQ(post_triggered, 2);
+}
+
 TEST(ParameterHandlerTest, GetSystemParamsTest)
 {
   auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("my_node");
@@ -31,6 +31,16 @@ RosLockGuard g_rclcpp;
 
 using namespace mppi;  // NOLINT
 
+// Markers are published from a thread of the visualizer, so spin until received
+template<typename NodeT, typename PredicateT>
+void spinUntil(NodeT node, PredicateT predicate)
+{
+  for (int i = 0; i != 100 && !predicate(); i++) {
+    rclcpp::spin_some(node->get_node_base_interface());
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+}
+
 TEST(TrajectoryVisualizerTests, StateTransition)
 {
   auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("my_node");
@@ -72,9 +82,13 @@ TEST(TrajectoryVisualizerTests, VisOptimalTrajectory)
   auto parameters_handler = std::make_unique<ParametersHandler>(node);
 
   visualization_msgs::msg::MarkerArray recieved_msg;
+  unsigned int recieved_count = 0;
   auto my_sub = node->create_subscription<visualization_msgs::msg::MarkerArray>(
     "/trajectories", 10,
-    [&](const visualization_msgs::msg::MarkerArray msg) {recieved_msg = msg;});
+    [&](const visualization_msgs::msg::MarkerArray msg) {
+      recieved_msg = msg;
+      recieved_count++;
+    });
 
   // optimal_trajectory empty, should fail to publish
   xt::xtensor<float, 2> optimal_trajectory;
@@ -85,7 +99,8 @@ TEST(TrajectoryVisualizerTests, VisOptimalTrajectory)
   nav_msgs::msg::Path bogus_path;
   vis.visualize(bogus_path);
 
-  rclcpp::spin_some(node->get_node_base_interface());
+  spinUntil(node, [&]() {return recieved_count == 1;});
+  EXPECT_EQ(recieved_count, 1u);
   EXPECT_EQ(recieved_msg.markers.size(), 0u);
 
   // Now populated with content, should publish
@@ -93,7 +108,8 @@ TEST(TrajectoryVisualizerTests, VisOptimalTrajectory)
   vis.add(optimal_trajectory, "Optimal Trajectory");
   vis.visualize(bogus_path);
 
-  rclcpp::spin_some(node->get_node_base_interface());
+  spinUntil(node, [&]() {return recieved_count == 2;});
+  EXPECT_EQ(recieved_count, 2u);
 
   // Should have 20 trajectory points in the map frame
   EXPECT_EQ(recieved_msg.markers.size(), 20u);
@@ -149,7 +165,22 @@ TEST(TrajectoryVisualizerTests, VisCandidateTrajectories)
   nav_msgs::msg::Path bogus_path;
   vis.visualize(bogus_path);
 
-  rclcpp::spin_some(node->get_node_base_interface());
-  // 40 * 4, for 5 trajectory steps + 3 point steps
-  EXPECT_EQ(recieved_msg.markers.size(), 160u);
+  spinUntil(node, [&]() {return recieved_msg.markers.size() != 0;});
+  // A single line list of 40 * 3 segments, for 5 trajectory steps + 3 point steps
+  ASSERT_EQ(recieved_msg.markers.size(), 1u);
+  EXPECT_EQ(recieved_msg.markers[0].type, visualization_msgs::msg::Marker::LINE_LIST);
+  EXPECT_EQ(recieved_msg.markers[0].header.frame_id, "fkmap");
+  EXPECT_EQ(recieved_msg.markers[0].points.size(), 240u);
+  EXPECT_EQ(recieved_msg.markers[0].colors.size(), 240u);
+  EXPECT_EQ(recieved_msg.markers[0].points[1].x, 1.0);
+  EXPECT_LT(recieved_msg.markers[0].colors[0].g, recieved_msg.markers[0].colors[1].g);
+
+  // Markers are reused by the next cycle, with the same content
+  vis.add(candidate_trajectories, "Candidate Trajectories");
+  vis.visualize(bogus_path);
+  recieved_msg.markers.clear();
+  spinUntil(node, [&]() {return recieved_msg.markers.size() != 0;});
+  ASSERT_EQ(recieved_msg.markers.size(), 1u);
+  EXPECT_EQ(recieved_msg.markers[0].id, 0);
+  EXPECT_EQ(recieved_msg.markers[0].points.size(), 240u);
 }
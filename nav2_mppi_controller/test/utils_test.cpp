@@ -13,7 +13,9 @@
 // limitations under the License.
 
 #include <chrono>
+#include <cmath>
 #include <thread>
+#include <vector>
 
 #pragma GCC diagnostic ignored "-Warray-bounds"
 #pragma GCC diagnostic ignored "-Wstringop-overflow"
@@ -23,6 +25,8 @@
 #include "gtest/gtest.h"
 #include "rclcpp/rclcpp.hpp"
 #include "nav2_mppi_controller/tools/utils.hpp"
+#include "nav2_mppi_controller/tools/path_point_field.hpp"
+#include "nav2_mppi_controller/tools/costmap_view.hpp"
 #include "nav2_mppi_controller/models/path.hpp"
 
 // Tests noise generator object
@@ -446,3 +450,71 @@ TEST(UtilsTests, RemovePosesAfterPathInversionTest)
   EXPECT_EQ(path.poses.size(), 11u);
   EXPECT_EQ(path.poses.back().pose.position.x, 10);
 }
+
+TEST(UtilsTests, PathPointFieldTest)
+{
+  PathPointField field;
+  EXPECT_EQ(field.nearestPoint(0.0f, 0.0f), -1);
+
+  // A straight path along X, with its middle point invalid
+  std::vector<utils::Pose2D> path;
+  std::vector<bool> valid;
+  for (unsigned int i = 0; i != 21; i++) {
+    path.push_back({0.1f * i, 0.0f, 0.0f});
+    valid.push_back(i != 10);
+  }
+  field.update(path, valid, 0.05f, 0.5f);
+
+  // Nearest points are found to within a cell, skipping invalid points
+  EXPECT_EQ(field.nearestPoint(0.0f, 0.3f), 0);
+  EXPECT_EQ(field.nearestPoint(0.51f, -0.2f), 5);
+  EXPECT_EQ(field.nearestPoint(2.0f, 0.1f), 20);
+  int nearest = field.nearestPoint(1.0f, 0.0f);
+  EXPECT_TRUE(nearest == 9 || nearest == 11);
+
+  // Positions outside of the field use its closest cell
+  EXPECT_EQ(field.nearestPoint(-5.0f, 0.0f), 0);
+  EXPECT_EQ(field.nearestPoint(5.0f, 3.0f), 20);
+
+  // Without valid points, there is no nearest point
+  field.update(path, std::vector<bool>(path.size(), false), 0.05f, 0.5f);
+  EXPECT_EQ(field.nearestPoint(1.0f, 0.0f), -1);
+}
+
+TEST(UtilsTests, CostmapViewTest)
+{
+  CostmapView view;
+  EXPECT_FALSE(view.isInitialized());
+
+  auto costmap = std::make_shared<nav2_costmap_2d::Costmap2D>(10, 20, 0.1, -1.0, 2.0, 0);
+  for (unsigned int i = 0; i != 10; i++) {
+    costmap->setCost(i, 2 * i, static_cast<unsigned char>(20 * i + 1));
+  }
+  view.update(*costmap);
+  EXPECT_TRUE(view.isInitialized());
+
+  // Costs inside of the costmap are those of its cells
+  for (unsigned int i = 0; i != 10; i++) {
+    double wx, wy;
+    costmap->mapToWorld(i, 2 * i, wx, wy);
+    EXPECT_EQ(view.getCost(wx, wy), costmap->getCost(i, 2 * i));
+  }
+  EXPECT_EQ(view.getCost(-0.95f, 3.95f), 0.0f);
+
+  // Points outside of the costmap are outside, not a number included
+  EXPECT_EQ(view.getCost(-1.05f, 2.5f), CostmapView::OUTSIDE);
+  EXPECT_EQ(view.getCost(0.05f, 2.5f), CostmapView::OUTSIDE);
+  EXPECT_EQ(view.getCost(-0.5f, 1.95f), CostmapView::OUTSIDE);
+  EXPECT_EQ(view.getCost(-0.5f, 4.05f), CostmapView::OUTSIDE);
+  EXPECT_EQ(view.getCost(-100.0f, 100.0f), CostmapView::OUTSIDE);
+  EXPECT_EQ(view.getCost(std::nanf(""), 2.5f), CostmapView::OUTSIDE);
+
+  // Costs of strided points, as for trajectories with a point step
+  std::vector<float> xs{-0.95f, 0.0f, -0.85f, 0.0f, 5.0f};
+  std::vector<float> ys{2.05f, 0.0f, 2.25f, 0.0f, 2.05f};
+  std::vector<float> costs(3);
+  view.getCosts(xs.data(), ys.data(), 3, 2, costs.data());
+  EXPECT_EQ(costs[0], 1.0f);
+  EXPECT_EQ(costs[1], 21.0f);
+  EXPECT_EQ(costs[2], CostmapView::OUTSIDE);
+}
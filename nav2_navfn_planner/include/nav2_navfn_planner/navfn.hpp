@@ -44,6 +44,7 @@
 #include <string.h>
 #include <stdio.h>
 #include <functional>
+#include <vector>
 
 namespace nav2_navfn_planner
 {
@@ -252,6 +253,7 @@ public:
 
   /** gradient and paths */
   float * gradx, * grady;  /**< gradient arrays, size of potential array */
+  std::vector<int> gradcells;  /**< cells with a gradient set, reset for the next propagation */
   float * pathx, * pathy;  /**< path points, as subpixel cell coordinates */
   int npath;  /**< number of path points */
   int npathbuf;  /**< size of pathx, pathy buffers */
@@ -89,6 +89,21 @@ public:
     const geometry_msgs::msg::PoseStamped & goal,
     std::function<bool()> cancel_checker) override;
 
+  /**
+   * @brief Creating a plan from a start pose to the best of a set of goal poses, with a
+   * single propagation of the potential from the start
+   * @param start Start pose
+   * @param goals Set of goal poses
+   * @param cancel_checker Function to check if the task has been canceled
+   * @param goal_index Index in the set of the goal reached by the path
+   * @return nav_msgs::Path of the generated path
+   */
+  nav_msgs::msg::Path createPlanToGoalSet(
+    const geometry_msgs::msg::PoseStamped & start,
+    const std::vector<geometry_msgs::msg::PoseStamped> & goals,
+    std::function<bool()> cancel_checker,
+    size_t & goal_index) override;
+
 protected:
   /**
    * @brief Compute a plan given start and goal poses, provided in global world frame.
@@ -105,6 +120,87 @@ protected:
     std::function<bool()> cancel_checker,
     nav_msgs::msg::Path & plan);
 
+  /**
+   * @brief Compute a plan to the best of a set of goals, provided in global world frame.
+   * The potential is propagated from the start over the whole map, so that the potential
+   * of each goal is the cost of its best path.
+   * @param start Start pose
+   * @param goals Set of goal poses
+   * @param candidates Indices of the goals of the set to consider
+   * @param tolerance Relaxation constraint in x and y
+   * @param cancel_checker Function to check if the task has been canceled
+   * @param plan Path to be computed
+   * @param goal_index Index in the set of the goal reached by the path
+   * @return true if can find the path
+   */
+  bool makePlanToGoalSet(
+    const geometry_msgs::msg::Pose & start,
+    const std::vector<geometry_msgs::msg::PoseStamped> & goals,
+    const std::vector<size_t> & candidates, double tolerance,
+    std::function<bool()> cancel_checker,
+    nav_msgs::msg::Path & plan, size_t & goal_index);
+
+  /**
+   * @brief Set the costmap of the planner to propagate a potential from a start
+   * @param mx int of map X coordinate of the start
+   * @param my int of map Y coordinate of the start
+   */
+  void setPlannerCostmap(unsigned int mx, unsigned int my);
+
+  /**
+   * @brief Find the pose closest to a goal within tolerance with a potential,
+   * must compute the potential first
+   * @param goal Goal pose
+   * @param tolerance Relaxation constraint in x and y
+   * @param reachable_pose Goal if it has a potential, else the closest pose which has
+   * @return true if a pose with a potential was found
+   */
+  bool findReachablePose(
+    const geometry_msgs::msg::Pose & goal, double tolerance,
+    geometry_msgs::msg::Pose & reachable_pose);
+
+  /**
+   * @brief Compute a plan by descending the potential cached for the goal, computing the
+   * potential first if there is none for the goal or costmap cells its descent may cross
+   * changed since it was computed
+   * @param start Start pose
+   * @param goal Goal pose
+   * @param cancel_checker Function to check if the task has been canceled
+   * @param plan Path to be computed
+   * @return true if a path was found from the cached potential
+   */
+  bool makePlanFromCachedPotential(
+    const geometry_msgs::msg::Pose & start,
+    const geometry_msgs::msg::Pose & goal,
+    std::function<bool()> cancel_checker,
+    nav_msgs::msg::Path & plan);
+
+  /**
+   * @brief Check whether the cached potential can still be descended from a start to a goal,
+   * costmap changes only mattering where the potential is below the start's
+   * @param costs Current costmap costs
+   * @param mx_start int of map X coordinate of the start
+   * @param my_start int of map Y coordinate of the start
+   * @param mx_goal int of map X coordinate of the goal
+   * @param my_goal int of map Y coordinate of the goal
+   * @return true if the cached potential is valid
+   */
+  bool isCachedPotentialValid(
+    const unsigned char * costs,
+    unsigned int mx_start, unsigned int my_start,
+    unsigned int mx_goal, unsigned int my_goal);
+
+  /**
+   * @brief Set the end of a plan extracted from the potential on the goal
+   * @param start Start pose
+   * @param goal Goal pose the plan was extracted to
+   * @param plan Computed path
+   */
+  void finalizePlan(
+    const geometry_msgs::msg::Pose & start,
+    const geometry_msgs::msg::Pose & goal,
+    nav_msgs::msg::Path & plan);
+
   /**
    * @brief Compute the navigation function given a seed point in the world to start from
    * @param world_point Point in world coordinate frame
@@ -220,6 +316,15 @@ protected:
   // Whether to use the astar planner or default dijkstras
   bool use_astar_;
 
+  // Whether to keep the potential of the goal to serve plans from new starts
+  bool use_potential_cache_;
+
+  // Planner holding the potential of the cached goal, with the costs it was computed on
+  std::unique_ptr<NavFn> cached_planner_;
+  std::vector<unsigned char> cached_costs_;
+  unsigned int cached_goal_[2];
+  bool cached_allow_unknown_;
+
   // parent node weak ptr
   rclcpp_lifecycle::LifecycleNode::WeakPtr node_;
 
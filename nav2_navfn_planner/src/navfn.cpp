@@ -208,34 +208,44 @@ NavFn::setNavArr(int xs, int ys)
 {
   RCLCPP_DEBUG(rclcpp::get_logger("rclcpp"), "[NavFn] Array is %d x %d\n", xs, ys);
 
+  // Keep the arrays when their size is unchanged, as when replanning on the same costmap,
+  // rather than allocating and first touching every page of them again on each plan
+  const bool resize = costarr == NULL || xs * ys != ns;
+
   nx = xs;
   ny = ys;
   ns = nx * ny;
 
-  if (costarr) {
-    delete[] costarr;
-  }
-  if (potarr) {
-    delete[] potarr;
-  }
-  if (pending) {
-    delete[] pending;
-  }
+  if (resize) {
+    if (costarr) {
+      delete[] costarr;
+    }
+    if (potarr) {
+      delete[] potarr;
+    }
+    if (pending) {
+      delete[] pending;
+    }
 
-  if (gradx) {
-    delete[] gradx;
-  }
-  if (grady) {
-    delete[] grady;
+    if (gradx) {
+      delete[] gradx;
+    }
+    if (grady) {
+      delete[] grady;
+    }
+
+    costarr = new COSTTYPE[ns];  // cost array, 2d config space
+    potarr = new float[ns];  // navigation potential array
+    pending = new bool[ns];
+    gradx = new float[ns];
+    grady = new float[ns];
+    std::fill(gradx, gradx + ns, 0.0f);
+    std::fill(grady, grady + ns, 0.0f);
+    gradcells.clear();
   }
 
-  costarr = new COSTTYPE[ns];  // cost array, 2d config space
   memset(costarr, 0, ns * sizeof(COSTTYPE));
-  potarr = new float[ns];  // navigation potential array
-  pending = new bool[ns];
   memset(pending, 0, ns * sizeof(bool));
-  gradx = new float[ns];
-  grady = new float[ns];
 }
 
 
@@ -248,27 +258,29 @@ NavFn::setCostmap(const COSTTYPE * cmap, bool isROS, bool allow_unknown)
 {
   COSTTYPE * cm = costarr;
   if (isROS) {  // ROS-type cost array
-    for (int i = 0; i < ny; i++) {
-      int k = i * nx;
-      for (int j = 0; j < nx; j++, k++, cmap++, cm++) {
-        // This transforms the incoming cost values:
-        // COST_OBS                 -> COST_OBS (incoming "lethal obstacle")
-        // COST_OBS_ROS             -> COST_OBS (incoming "inscribed inflated obstacle")
-        // values in range 0 to 252 -> values from COST_NEUTRAL to COST_OBS_ROS.
-        *cm = COST_OBS;
-        int v = *cmap;
-        if (v < COST_OBS_ROS) {
-          v = COST_NEUTRAL + COST_FACTOR * v;
-          if (v >= COST_OBS) {
-            v = COST_OBS - 1;
-          }
-          *cm = v;
-        } else if (v == COST_UNKNOWN_ROS && allow_unknown) {
-          v = COST_OBS - 1;
-          *cm = v;
+    // This transforms the incoming cost values:
+    // COST_OBS                 -> COST_OBS (incoming "lethal obstacle")
+    // COST_OBS_ROS             -> COST_OBS (incoming "inscribed inflated obstacle")
+    // values in range 0 to 252 -> values from COST_NEUTRAL to COST_OBS_ROS.
+    // Each value is only transformed once, into a table then read per cell
+    COSTTYPE translation[COST_UNKNOWN_ROS + 1];
+    for (int v = 0; v <= COST_UNKNOWN_ROS; v++) {
+      translation[v] = COST_OBS;
+      if (v < COST_OBS_ROS) {
+        int t = COST_NEUTRAL + COST_FACTOR * v;
+        if (t >= COST_OBS) {
+          t = COST_OBS - 1;
         }
+        translation[v] = t;
+      } else if (v == COST_UNKNOWN_ROS && allow_unknown) {
+        translation[v] = COST_OBS - 1;
       }
     }
+
+    for (int k = 0; k < ns; k++, cmap++, cm++) {
+      const int v = *cmap;
+      *cm = v <= COST_UNKNOWN_ROS ? translation[v] : COST_OBS;
+    }
   } else {  // not a ROS map, just a PGM
     for (int i = 0; i < ny; i++) {
       int k = i * nx;
@@ -341,15 +353,18 @@ int NavFn::getPathLen() {return npath;}
 void
 NavFn::setupNavFn(bool keepit)
 {
-  // reset values in propagation arrays
-  for (int i = 0; i < ns; i++) {
-    potarr[i] = POT_HIGH;
-    if (!keepit) {
-      costarr[i] = COST_NEUTRAL;
-    }
-    gradx[i] = grady[i] = 0.0;
+  // reset values in propagation arrays, an array at a time
+  std::fill(potarr, potarr + ns, static_cast<float>(POT_HIGH));
+  if (!keepit) {
+    std::fill(costarr, costarr + ns, static_cast<COSTTYPE>(COST_NEUTRAL));
   }
 
+  // only the gradients set following the last propagation need resetting
+  for (const int n : gradcells) {
+    gradx[n] = grady[n] = 0.0;
+  }
+  gradcells.clear();
+
   // outer bounds of cost array
   COSTTYPE * pc;
   pc = costarr;
@@ -387,9 +402,7 @@ NavFn::setupNavFn(bool keepit)
   pc = costarr;
   int ntot = 0;
   for (int i = 0; i < ns; i++, pc++) {
-    if (*pc >= COST_OBS) {
-      ntot++;  // number of cells that are obstacles
-    }
+    ntot += *pc >= COST_OBS;  // number of cells that are obstacles
   }
   nobs = ntot;
 }
@@ -982,6 +995,7 @@ NavFn::gradCell(int n)
     norm = 1.0 / norm;
     gradx[n] = norm * dx;
     grady[n] = norm * dy;
+    gradcells.push_back(n);
   }
   return norm;
 }
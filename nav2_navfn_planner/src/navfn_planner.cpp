@@ -23,6 +23,7 @@
 
 #include "nav2_navfn_planner/navfn_planner.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <iomanip>
@@ -90,6 +91,9 @@ NavfnPlanner::configure(
   declare_parameter_if_not_declared(
     node, name + ".use_final_approach_orientation", rclcpp::ParameterValue(false));
   node->get_parameter(name + ".use_final_approach_orientation", use_final_approach_orientation_);
+  declare_parameter_if_not_declared(
+    node, name + ".use_potential_cache", rclcpp::ParameterValue(false));
+  node->get_parameter(name + ".use_potential_cache", use_potential_cache_);
 
   // Create a planner based on the new costmap size
   planner_ = std::make_unique<NavFn>(
@@ -125,6 +129,8 @@ NavfnPlanner::cleanup()
     logger_, "Cleaning up plugin %s of type NavfnPlanner",
     name_.c_str());
   planner_.reset();
+  cached_planner_.reset();
+  cached_costs_.clear();
 }
 
 nav_msgs::msg::Path NavfnPlanner::createPlan(
@@ -199,6 +205,75 @@ nav_msgs::msg::Path NavfnPlanner::createPlan(
   return path;
 }
 
+nav_msgs::msg::Path NavfnPlanner::createPlanToGoalSet(
+  const geometry_msgs::msg::PoseStamped & start,
+  const std::vector<geometry_msgs::msg::PoseStamped> & goals,
+  std::function<bool()> cancel_checker,
+  size_t & goal_index)
+{
+  if (goals.size() == 1) {
+    goal_index = 0;
+    return createPlan(start, goals.front(), cancel_checker);
+  }
+
+  unsigned int mx, my;
+  if (!costmap_->worldToMap(start.pose.position.x, start.pose.position.y, mx, my)) {
+    throw nav2_core::StartOutsideMapBounds(
+            "Start Coordinates of(" + std::to_string(start.pose.position.x) + ", " +
+            std::to_string(start.pose.position.y) + ") was outside bounds");
+  }
+
+  // Goals outside bounds or in lethal cost are left out, failing only if all are
+  std::vector<size_t> candidates;
+  bool goal_occupied = false;
+  for (size_t i = 0; i != goals.size(); i++) {
+    const geometry_msgs::msg::PoseStamped & goal = goals[i];
+    if (!costmap_->worldToMap(goal.pose.position.x, goal.pose.position.y, mx, my)) {
+      continue;
+    }
+
+    if (tolerance_ == 0 && costmap_->getCost(mx, my) == nav2_costmap_2d::LETHAL_OBSTACLE) {
+      goal_occupied = true;
+      continue;
+    }
+
+    // Corner case of the start(x,y) = goal(x,y)
+    if (start.pose.position.x == goal.pose.position.x &&
+      start.pose.position.y == goal.pose.position.y)
+    {
+      goal_index = i;
+      return createPlan(start, goal, cancel_checker);
+    }
+
+    candidates.push_back(i);
+  }
+
+  if (candidates.empty()) {
+    if (goal_occupied) {
+      throw nav2_core::GoalOccupied("All goals were in lethal cost or outside bounds");
+    }
+    throw nav2_core::GoalOutsideMapBounds("All goals were outside bounds");
+  }
+
+  // Update planner based on the new costmap size
+  if (isPlannerOutOfDate()) {
+    planner_->setNavArr(
+      costmap_->getSizeInCellsX(),
+      costmap_->getSizeInCellsY());
+  }
+
+  nav_msgs::msg::Path path;
+  if (!makePlanToGoalSet(
+      start.pose, goals, candidates, tolerance_, cancel_checker, path, goal_index))
+  {
+    throw nav2_core::NoValidPathCouldBeFound(
+            "Failed to create plan to any goal with tolerance of: " +
+            std::to_string(tolerance_));
+  }
+
+  return path;
+}
+
 bool
 NavfnPlanner::isPlannerOutOfDate()
 {
@@ -231,22 +306,16 @@ NavfnPlanner::makePlan(
     logger_, "Making plan from (%.2f,%.2f) to (%.2f,%.2f)",
     start.position.x, start.position.y, goal.position.x, goal.position.y);
 
+  if (use_potential_cache_) {
+    if (makePlanFromCachedPotential(start, goal, cancel_checker, plan)) {
+      return true;
+    }
+    RCLCPP_DEBUG(logger_, "No path from the cached potential, planning from the start");
+  }
+
   unsigned int mx, my;
   worldToMap(wx, wy, mx, my);
-
-  // clear the starting cell within the costmap because we know it can't be an obstacle
-  clearRobotCell(mx, my);
-
-  std::unique_lock<nav2_costmap_2d::Costmap2D::mutex_t> lock(*(costmap_->getMutex()));
-
-  // make sure to resize the underlying array that Navfn uses
-  planner_->setNavArr(
-    costmap_->getSizeInCellsX(),
-    costmap_->getSizeInCellsY());
-
-  planner_->setCostmap(costmap_->getCharMap(), true, allow_unknown_);
-
-  lock.unlock();
+  setPlannerCostmap(mx, my);
 
   int map_start[2];
   map_start[0] = mx;
@@ -268,8 +337,103 @@ NavfnPlanner::makePlan(
     planner_->calcNavFnDijkstra(cancel_checker, true);
   }
 
+  geometry_msgs::msg::Pose best_pose;
+  if (findReachablePose(goal, tolerance, best_pose)) {
+    // extract the plan
+    if (getPlanFromPotential(best_pose, plan)) {
+      finalizePlan(start, best_pose, plan);
+    } else {
+      RCLCPP_ERROR(
+        logger_,
+        "Failed to create a plan from potential when a legal"
+        " potential was found. This shouldn't happen.");
+    }
+  }
+
+  return !plan.poses.empty();
+}
+
+bool
+NavfnPlanner::makePlanToGoalSet(
+  const geometry_msgs::msg::Pose & start,
+  const std::vector<geometry_msgs::msg::PoseStamped> & goals,
+  const std::vector<size_t> & candidates, double tolerance,
+  std::function<bool()> cancel_checker,
+  nav_msgs::msg::Path & plan, size_t & goal_index)
+{
+  // clear the plan, just in case
+  plan.poses.clear();
+
+  plan.header.stamp = clock_->now();
+  plan.header.frame_id = global_frame_;
+
+  unsigned int mx, my;
+  worldToMap(start.position.x, start.position.y, mx, my);
+  setPlannerCostmap(mx, my);
+
+  // Rather than stopping at a goal, the potential covers the whole map, so that the goal
+  // of lowest potential is the one of the best path
+  int map_start[2];
+  map_start[0] = mx;
+  map_start[1] = my;
+  planner_->setStart(map_start);
+  planner_->setGoal(map_start);
+  planner_->calcNavFnDijkstra(cancel_checker, false);
+
+  double best_potential = POT_HIGH;
+  geometry_msgs::msg::Pose best_pose;
+  for (const size_t i : candidates) {
+    geometry_msgs::msg::Pose pose;
+    if (!findReachablePose(goals[i].pose, tolerance, pose)) {
+      continue;
+    }
+
+    const double potential = getPointPotential(pose.position);
+    if (potential < best_potential) {
+      best_potential = potential;
+      best_pose = pose;
+      goal_index = i;
+    }
+  }
+
+  if (best_potential < POT_HIGH) {
+    // extract the plan
+    if (getPlanFromPotential(best_pose, plan)) {
+      finalizePlan(start, best_pose, plan);
+    } else {
+      RCLCPP_ERROR(
+        logger_,
+        "Failed to create a plan from potential when a legal"
+        " potential was found. This shouldn't happen.");
+    }
+  }
+
+  return !plan.poses.empty();
+}
+
+void
+NavfnPlanner::setPlannerCostmap(unsigned int mx, unsigned int my)
+{
+  // clear the starting cell within the costmap because we know it can't be an obstacle
+  clearRobotCell(mx, my);
+
+  std::unique_lock<nav2_costmap_2d::Costmap2D::mutex_t> lock(*(costmap_->getMutex()));
+
+  // make sure to resize the underlying array that Navfn uses
+  planner_->setNavArr(
+    costmap_->getSizeInCellsX(),
+    costmap_->getSizeInCellsY());
+
+  planner_->setCostmap(costmap_->getCharMap(), true, allow_unknown_);
+}
+
+bool
+NavfnPlanner::findReachablePose(
+  const geometry_msgs::msg::Pose & goal, double tolerance,
+  geometry_msgs::msg::Pose & reachable_pose)
+{
   double resolution = costmap_->getResolution();
-  geometry_msgs::msg::Pose p, best_pose;
+  geometry_msgs::msg::Pose p;
 
   bool found_legal = false;
 
@@ -277,7 +441,7 @@ NavfnPlanner::makePlan(
   double potential = getPointPotential(p.position);
   if (potential < POT_HIGH) {
     // Goal is reachable by itself
-    best_pose = p;
+    reachable_pose = p;
     found_legal = true;
   } else {
     // Goal is not reachable. Trying to find nearest to the goal
@@ -292,7 +456,7 @@ NavfnPlanner::makePlan(
         double sdist = squared_distance(p, goal);
         if (potential < POT_HIGH && sdist < best_sdist) {
           best_sdist = sdist;
-          best_pose = p;
+          reachable_pose = p;
           found_legal = true;
         }
         p.position.x += resolution;
@@ -301,45 +465,177 @@ NavfnPlanner::makePlan(
     }
   }
 
-  if (found_legal) {
-    // extract the plan
-    if (getPlanFromPotential(best_pose, plan)) {
-      smoothApproachToGoal(best_pose, plan);
-
-      // If use_final_approach_orientation=true, interpolate the last pose orientation from the
-      // previous pose to set the orientation to the 'final approach' orientation of the robot so
-      // it does not rotate.
-      // And deal with corner case of plan of length 1
-      if (use_final_approach_orientation_) {
-        size_t plan_size = plan.poses.size();
-        if (plan_size == 1) {
-          plan.poses.back().pose.orientation = start.orientation;
-        } else if (plan_size > 1) {
-          double dx, dy, theta;
-          auto last_pose = plan.poses.back().pose.position;
-          auto approach_pose = plan.poses[plan_size - 2].pose.position;
-          // Deal with the case of NavFn producing a path with two equal last poses
-          if (std::abs(last_pose.x - approach_pose.x) < 0.0001 &&
-            std::abs(last_pose.y - approach_pose.y) < 0.0001 && plan_size > 2)
-          {
-            approach_pose = plan.poses[plan_size - 3].pose.position;
-          }
-          dx = last_pose.x - approach_pose.x;
-          dy = last_pose.y - approach_pose.y;
-          theta = atan2(dy, dx);
-          plan.poses.back().pose.orientation =
-            nav2_util::geometry_utils::orientationAroundZAxis(theta);
+  return found_legal;
+}
+
+bool
+NavfnPlanner::makePlanFromCachedPotential(
+  const geometry_msgs::msg::Pose & start,
+  const geometry_msgs::msg::Pose & goal,
+  std::function<bool()> cancel_checker,
+  nav_msgs::msg::Path & plan)
+{
+  unsigned int mx_start, my_start, mx_goal, my_goal;
+  if (!worldToMap(start.position.x, start.position.y, mx_start, my_start) ||
+    !worldToMap(goal.position.x, goal.position.y, mx_goal, my_goal))
+  {
+    return false;
+  }
+
+  std::unique_lock<nav2_costmap_2d::Costmap2D::mutex_t> lock(*(costmap_->getMutex()));
+  const unsigned char * costs = costmap_->getCharMap();
+
+  if (!isCachedPotentialValid(costs, mx_start, my_start, mx_goal, my_goal)) {
+    // The potential is rooted at the goal and covers the whole map, rather than stopping
+    // at the start as when planning from the start, so that any new start can descend it
+    const int nx = costmap_->getSizeInCellsX();
+    const int ny = costmap_->getSizeInCellsY();
+    if (!cached_planner_) {
+      cached_planner_ = std::make_unique<NavFn>(nx, ny);
+    }
+    cached_planner_->setNavArr(nx, ny);
+    cached_planner_->setCostmap(costs, true, allow_unknown_);
+    cached_costs_.assign(costs, costs + static_cast<size_t>(nx) * ny);
+    lock.unlock();
+
+    // An obstructed goal is left to the tolerance search of planning from the start
+    if (cached_planner_->costarr[my_goal * nx + mx_goal] >= COST_OBS) {
+      cached_costs_.clear();
+      return false;
+    }
+
+    cached_goal_[0] = mx_goal;
+    cached_goal_[1] = my_goal;
+    cached_allow_unknown_ = allow_unknown_;
+    int map_goal[2] = {static_cast<int>(mx_goal), static_cast<int>(my_goal)};
+    cached_planner_->setGoal(map_goal);
+    cached_planner_->setStart(map_goal);
+    try {
+      cached_planner_->calcNavFnDijkstra(cancel_checker, false);
+    } catch (...) {
+      cached_costs_.clear();
+      throw;
+    }
+    RCLCPP_DEBUG(logger_, "Computed the potential of the goal (%d,%d)", mx_goal, my_goal);
+  } else {
+    lock.unlock();
+  }
+
+  int map_start[2] = {static_cast<int>(mx_start), static_cast<int>(my_start)};
+  cached_planner_->setStart(map_start);
+
+  const int max_cycles = 4 * std::max(cached_planner_->nx, cached_planner_->ny);
+  const int len = cached_planner_->calcPath(max_cycles);
+  if (len == 0) {
+    return false;
+  }
+
+  // The descent goes from the start to the goal already
+  float * x = cached_planner_->getPathX();
+  float * y = cached_planner_->getPathY();
+  plan.poses.clear();
+  for (int i = 0; i < len; ++i) {
+    double world_x, world_y;
+    mapToWorld(x[i], y[i], world_x, world_y);
+
+    geometry_msgs::msg::PoseStamped pose;
+    pose.pose.position.x = world_x;
+    pose.pose.position.y = world_y;
+    pose.pose.position.z = 0.0;
+    pose.pose.orientation.w = 1.0;
+    plan.poses.push_back(pose);
+  }
+
+  finalizePlan(start, goal, plan);
+  return true;
+}
+
+bool
+NavfnPlanner::isCachedPotentialValid(
+  const unsigned char * costs,
+  unsigned int mx_start, unsigned int my_start,
+  unsigned int mx_goal, unsigned int my_goal)
+{
+  if (!cached_planner_ || cached_costs_.empty() ||
+    cached_goal_[0] != mx_goal || cached_goal_[1] != my_goal ||
+    cached_allow_unknown_ != allow_unknown_ ||
+    cached_planner_->nx != static_cast<int>(costmap_->getSizeInCellsX()) ||
+    cached_planner_->ny != static_cast<int>(costmap_->getSizeInCellsY()))
+  {
+    return false;
+  }
+
+  const int nx = cached_planner_->nx;
+  const int ny = cached_planner_->ny;
+  const float * pot = cached_planner_->potarr;
+
+  // Lowest potential around a cell, as the descent steps to the lowest neighbor of a cell
+  // with no potential, such as a start in an obstacle
+  auto lowest_potential = [&](int mx, int my) {
+      float lowest = POT_HIGH;
+      for (int j = std::max(my - 1, 0); j <= std::min(my + 1, ny - 1); ++j) {
+        for (int i = std::max(mx - 1, 0); i <= std::min(mx + 1, nx - 1); ++i) {
+          lowest = std::min(lowest, pot[j * nx + i]);
         }
       }
-    } else {
-      RCLCPP_ERROR(
-        logger_,
-        "Failed to create a plan from potential when a legal"
-        " potential was found. This shouldn't happen.");
+      return lowest;
+    };
+
+  const float start_potential = lowest_potential(mx_start, my_start);
+  if (start_potential >= POT_HIGH) {
+    return false;
+  }
+
+  // The descent from the start only crosses cells of lower potential. A cost raised on a
+  // cell of higher potential only raises potentials above it, and a cost lowered on a cell
+  // keeps its potential above its neighbors', so only changes around cells of lower
+  // potential may change the path
+  const unsigned char * cached = cached_costs_.data();
+  const unsigned char * end = costs + cached_costs_.size();
+  const unsigned char * it = costs;
+  while ((it = std::mismatch(it, end, cached + (it - costs)).first) != end) {
+    const int index = it - costs;
+    if (lowest_potential(index % nx, index / nx) <= start_potential) {
+      return false;
     }
+    ++it;
   }
+  return true;
+}
 
-  return !plan.poses.empty();
+void
+NavfnPlanner::finalizePlan(
+  const geometry_msgs::msg::Pose & start,
+  const geometry_msgs::msg::Pose & goal,
+  nav_msgs::msg::Path & plan)
+{
+  smoothApproachToGoal(goal, plan);
+
+  // If use_final_approach_orientation=true, interpolate the last pose orientation from the
+  // previous pose to set the orientation to the 'final approach' orientation of the robot so
+  // it does not rotate.
+  // And deal with corner case of plan of length 1
+  if (use_final_approach_orientation_) {
+    size_t plan_size = plan.poses.size();
+    if (plan_size == 1) {
+      plan.poses.back().pose.orientation = start.orientation;
+    } else if (plan_size > 1) {
+      double dx, dy, theta;
+      auto last_pose = plan.poses.back().pose.position;
+      auto approach_pose = plan.poses[plan_size - 2].pose.position;
+      // Deal with the case of NavFn producing a path with two equal last poses
+      if (std::abs(last_pose.x - approach_pose.x) < 0.0001 &&
+        std::abs(last_pose.y - approach_pose.y) < 0.0001 && plan_size > 2)
+      {
+        approach_pose = plan.poses[plan_size - 3].pose.position;
+      }
+      dx = last_pose.x - approach_pose.x;
+      dy = last_pose.y - approach_pose.y;
+      theta = atan2(dy, dx);
+      plan.poses.back().pose.orientation =
+        nav2_util::geometry_utils::orientationAroundZAxis(theta);
+    }
+  }
 }
 
 void
@@ -531,6 +827,8 @@ NavfnPlanner::dynamicParametersCallback(std::vector<rclcpp::Parameter> parameter
         allow_unknown_ = parameter.as_bool();
       } else if (name == name_ + ".use_final_approach_orientation") {
         use_final_approach_orientation_ = parameter.as_bool();
+      } else if (name == name_ + ".use_potential_cache") {
+        use_potential_cache_ = parameter.as_bool();
       }
     }
   }
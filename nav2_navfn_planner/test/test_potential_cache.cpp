@@ -0,0 +1,106 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License. Reserved.
+
+#include <math.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "nav2_util/lifecycle_node.hpp"
+#include "nav2_navfn_planner/navfn_planner.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+class RclCppFixture
+{
+public:
+  RclCppFixture() {rclcpp::init(0, nullptr);}
+  ~RclCppFixture() {rclcpp::shutdown();}
+};
+RclCppFixture g_rclcppfixture;
+
+class NavfnShim : public nav2_navfn_planner::NavfnPlanner
+{
+public:
+  bool isCachedPotentialValid(
+    unsigned int mx_start, unsigned int my_start,
+    unsigned int mx_goal, unsigned int my_goal)
+  {
+    return NavfnPlanner::isCachedPotentialValid(
+      costmap_->getCharMap(), mx_start, my_start, mx_goal, my_goal);
+  }
+};
+
+geometry_msgs::msg::PoseStamped pose(double x, double y)
+{
+  geometry_msgs::msg::PoseStamped pose;
+  pose.pose.position.x = x;
+  pose.pose.position.y = y;
+  pose.pose.orientation.w = 1.0;
+  return pose;
+}
+
+TEST(NavfnTest, testPotentialCache)
+{
+  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("Navfntest");
+  node->declare_parameter("test.use_potential_cache", true);
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>("global_costmap");
+  costmap_ros->on_configure(rclcpp_lifecycle::State());
+  auto costmap = costmap_ros->getCostmap();
+  *costmap = nav2_costmap_2d::Costmap2D(100, 100, 0.1, 0.0, 0.0, 0);
+  // wall across the costmap with a gap at its top
+  for (unsigned int j = 0; j < 80; ++j) {
+    costmap->setCost(50, j, 254);
+  }
+
+  auto planner = std::make_unique<NavfnShim>();
+  auto tf = std::make_shared<tf2_ros::Buffer>(node->get_clock());
+  planner->configure(node, "test", tf, costmap_ros);
+  planner->activate();
+
+  auto path = planner->createPlan(pose(1.0, 1.0), pose(9.0, 1.0), []() {return false;});
+  ASSERT_GT(path.poses.size(), 2u);
+  EXPECT_NEAR(path.poses.front().pose.position.x, 1.0, 0.1);
+  EXPECT_NEAR(path.poses.front().pose.position.y, 1.0, 0.1);
+  EXPECT_NEAR(path.poses.back().pose.position.x, 9.0, 1e-6);
+  EXPECT_NEAR(path.poses.back().pose.position.y, 1.0, 1e-6);
+  EXPECT_TRUE(planner->isCachedPotentialValid(10, 10, 90, 10));
+  EXPECT_TRUE(planner->isCachedPotentialValid(30, 60, 90, 10));
+  EXPECT_FALSE(planner->isCachedPotentialValid(30, 60, 10, 90));
+
+  // Changes of higher potential than the start's keep the potential, lower ones do not
+  costmap->setCost(10, 30, 254);
+  EXPECT_TRUE(planner->isCachedPotentialValid(80, 10, 90, 10));
+  EXPECT_FALSE(planner->isCachedPotentialValid(10, 10, 90, 10));
+
+  // Plans from the cached potential go around the wall
+  path = planner->createPlan(pose(8.0, 1.0), pose(9.0, 1.0), []() {return false;});
+  EXPECT_LT(path.poses.size(), 20u);
+  path = planner->createPlan(pose(2.0, 2.0), pose(9.0, 1.0), []() {return false;});
+  bool through_gap = false;
+  for (const auto & p : path.poses) {
+    through_gap |= p.pose.position.y > 8.0;
+  }
+  EXPECT_TRUE(through_gap);
+
+  // Closing the gap invalidates the potential, and no path is found then
+  for (unsigned int j = 80; j < 100; ++j) {
+    costmap->setCost(50, j, 254);
+  }
+  EXPECT_FALSE(planner->isCachedPotentialValid(20, 20, 90, 10));
+  EXPECT_THROW(
+    planner->createPlan(pose(2.0, 2.0), pose(9.0, 1.0), []() {return false;}),
+    nav2_core::NoValidPathCouldBeFound);
+}
@@ -0,0 +1,283 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "geometry_msgs/msg/pose_stamped.hpp"
+#include "nav_msgs/msg/occupancy_grid.hpp"
+#include "nav_msgs/msg/path.hpp"
+#include "nav2_core/global_planner.hpp"
+#include "nav2_core/planner_exceptions.hpp"
+#include "nav2_costmap_2d/cost_values.hpp"
+#include "nav2_costmap_2d/costmap_2d.hpp"
+#include "nav2_costmap_2d/costmap_2d_ros.hpp"
+#include "nav2_costmap_2d/costmap_snapshot.hpp"
+#include "nav2_map_server/map_io.hpp"
+#include "pluginlib/class_loader.hpp"
+#include "rclcpp_lifecycle/lifecycle_node.hpp"
+#include "tf2_ros/buffer.h"
+
+class RosLockGuard
+{
+public:
+  RosLockGuard() {rclcpp::init(0, nullptr);}
+  ~RosLockGuard() {rclcpp::shutdown();}
+};
+
+RosLockGuard g_rclcpp;
+
+using Task = std::pair<geometry_msgs::msg::PoseStamped, geometry_msgs::msg::PoseStamped>;
+
+// Planners benchmarked, by name and plugin type
+const std::vector<std::pair<std::string, std::string>> g_planners = {
+  {"NavFn", "nav2_navfn_planner::NavfnPlanner"},
+  {"ThetaStar", "nav2_theta_star_planner::ThetaStarPlanner"},
+  {"Smac2D", "nav2_smac_planner::SmacPlanner2D"},
+  {"SmacHybrid", "nav2_smac_planner::SmacPlannerHybrid"},
+  {"SmacLattice", "nav2_smac_planner::SmacPlannerLattice"}};
+
+std::shared_ptr<nav2_costmap_2d::Costmap2DROS> g_costmap_ros;
+std::shared_ptr<tf2_ros::Buffer> g_tf;
+pluginlib::ClassLoader<nav2_core::GlobalPlanner> * g_loader;
+
+// Planners are configured on their first task, and kept for the following ones
+std::map<std::string, std::pair<rclcpp_lifecycle::LifecycleNode::SharedPtr,
+  nav2_core::GlobalPlanner::Ptr>> g_configured_planners;
+
+geometry_msgs::msg::PoseStamped getPose(double x, double y)
+{
+  geometry_msgs::msg::PoseStamped pose;
+  pose.header.frame_id = "map";
+  pose.pose.position.x = x;
+  pose.pose.position.y = y;
+  pose.pose.orientation.w = 1.0;
+  return pose;
+}
+
+// Draw start and goal pairs in free space from a fixed seed, far enough apart
+// for the plans to cross a good part of the map
+std::vector<Task> getTasks(
+  nav2_costmap_2d::Costmap2D * costmap, unsigned int count, unsigned int seed)
+{
+  std::mt19937 generator(seed);
+  std::uniform_int_distribution<unsigned int> x_distribution(0, costmap->getSizeInCellsX() - 1);
+  std::uniform_int_distribution<unsigned int> y_distribution(0, costmap->getSizeInCellsY() - 1);
+  const double min_distance = 0.25 * std::hypot(
+    costmap->getSizeInMetersX(), costmap->getSizeInMetersY());
+
+  auto getFreePose = [&]() {
+      unsigned int mx, my;
+      do {
+        mx = x_distribution(generator);
+        my = y_distribution(generator);
+      } while (costmap->getCost(mx, my) != nav2_costmap_2d::FREE_SPACE);
+      double wx, wy;
+      costmap->mapToWorld(mx, my, wx, wy);
+      return getPose(wx, wy);
+    };
+
+  std::vector<Task> tasks;
+  while (tasks.size() < count) {
+    auto start = getFreePose();
+    auto goal = getFreePose();
+    if (std::hypot(
+        goal.pose.position.x - start.pose.position.x,
+        goal.pose.position.y - start.pose.position.y) >= min_distance)
+    {
+      tasks.emplace_back(start, goal);
+    }
+  }
+  return tasks;
+}
+
+double getPathLength(const nav_msgs::msg::Path & path)
+{
+  double length = 0.0;
+  for (unsigned int i = 1; i < path.poses.size(); i++) {
+    length += std::hypot(
+      path.poses[i].pose.position.x - path.poses[i - 1].pose.position.x,
+      path.poses[i].pose.position.y - path.poses[i - 1].pose.position.y);
+  }
+  return length;
+}
+
+// Peak resident memory of the process so far, in kB
+double getMemoryHighWaterMark()
+{
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.rfind("VmHWM:", 0) == 0) {
+      return std::stod(line.substr(6));
+    }
+  }
+  return 0.0;
+}
+
+nav2_core::GlobalPlanner::Ptr getPlanner(const std::string & name, const std::string & type)
+{
+  auto it = g_configured_planners.find(name);
+  if (it != g_configured_planners.end()) {
+    return it->second.second;
+  }
+
+  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>(name + "_benchmark");
+  auto planner = g_loader->createSharedInstance(type);
+  planner->configure(node, "GridBased", g_tf, g_costmap_ros);
+  planner->activate();
+  g_configured_planners[name] = {node, planner};
+  return planner;
+}
+
+void planTask(
+  benchmark::State & state, const std::string & name, const std::string & type,
+  const Task & task)
+{
+  auto planner = getPlanner(name, type);
+  nav_msgs::msg::Path path;
+  bool found = true;
+
+  for (auto _ : state) {
+    try {
+      path = planner->createPlan(task.first, task.second, []() {return false;});
+    } catch (const nav2_core::PlannerException & ex) {
+      found = false;
+      state.SkipWithError(ex.what());
+      break;
+    }
+    benchmark::DoNotOptimize(path);
+  }
+
+  if (found) {
+    state.counters["path_length"] = getPathLength(path);
+    state.counters["path_poses"] = path.poses.size();
+  }
+  state.counters["memory_hwm_kb"] = getMemoryHighWaterMark();
+}
+
+// Flags of the benchmark, after those of google-benchmark
+struct Options
+{
+  std::string map_yaml;
+  std::string snapshot;
+  unsigned int tasks = 10;
+  unsigned int seed = 0;
+};
+
+bool parseOptions(int argc, char ** argv, Options & options)
+{
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    const auto value = arg.substr(arg.find('=') + 1);
+    if (arg.rfind("--map=", 0) == 0) {
+      options.map_yaml = value;
+    } else if (arg.rfind("--snapshot=", 0) == 0) {
+      options.snapshot = value;
+    } else if (arg.rfind("--tasks=", 0) == 0) {
+      options.tasks = std::stoul(value);
+    } else if (arg.rfind("--seed=", 0) == 0) {
+      options.seed = std::stoul(value);
+    } else {
+      std::cerr << "Unknown argument: " << arg << std::endl;
+      return false;
+    }
+  }
+  return options.map_yaml.empty() != options.snapshot.empty();
+}
+
+int main(int argc, char ** argv)
+{
+  benchmark::Initialize(&argc, argv);
+  Options options;
+  if (!parseOptions(argc, argv, options)) {
+    std::cerr << "Usage: " << argv[0] << " --map=<map yaml> | --snapshot=<costmap snapshot>"
+      " [--tasks=10] [--seed=0] [google-benchmark flags]" << std::endl;
+    return 1;
+  }
+
+  // The costmap is not activated, so its layers leave the loaded map as is
+  g_costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>("global_costmap");
+  g_costmap_ros->on_configure(rclcpp_lifecycle::State());
+  g_tf = std::make_shared<tf2_ros::Buffer>(g_costmap_ros->get_clock());
+
+  std::vector<Task> tasks;
+  if (!options.snapshot.empty()) {
+    // Replay the plan of a saved costmap, from the robot to the end of its path, or random
+    // tasks in the costmap if it has no path
+    nav2_msgs::msg::CostmapSnapshot snapshot;
+    if (!nav2_costmap_2d::loadCostmapSnapshot(options.snapshot, snapshot) ||
+      !nav2_costmap_2d::decodeCostmap(
+        snapshot.metadata, snapshot.data, *g_costmap_ros->getCostmap()))
+    {
+      std::cerr << "Failed to load costmap snapshot " << options.snapshot << std::endl;
+      return 1;
+    }
+    if (!snapshot.footprint.points.empty()) {
+      g_costmap_ros->setRobotFootprintPolygon(
+        std::make_shared<geometry_msgs::msg::Polygon>(snapshot.footprint));
+    }
+    if (!snapshot.path.poses.empty()) {
+      const bool has_pose = rclcpp::Time(snapshot.robot_pose.header.stamp).nanoseconds() != 0;
+      tasks.emplace_back(
+        has_pose ? snapshot.robot_pose : snapshot.path.poses.front(),
+        snapshot.path.poses.back());
+    }
+  } else {
+    nav_msgs::msg::OccupancyGrid map;
+    if (nav2_map_server::loadMapFromYaml(options.map_yaml, map) !=
+      nav2_map_server::LOAD_MAP_SUCCESS)
+    {
+      std::cerr << "Failed to load map " << options.map_yaml << std::endl;
+      return 1;
+    }
+    *g_costmap_ros->getCostmap() = nav2_costmap_2d::Costmap2D(map);
+  }
+
+  pluginlib::ClassLoader<nav2_core::GlobalPlanner> loader("nav2_core", "nav2_core::GlobalPlanner");
+  g_loader = &loader;
+
+  if (tasks.empty()) {
+    tasks = getTasks(g_costmap_ros->getCostmap(), options.tasks, options.seed);
+  }
+  for (const auto & planner : g_planners) {
+    for (unsigned int i = 0; i < tasks.size(); i++) {
+      benchmark::RegisterBenchmark(
+        (planner.first + "/task:" + std::to_string(i)).c_str(),
+        [planner, task = tasks[i]](benchmark::State & state) {
+          planTask(state, planner.first, planner.second, task);
+        })->Unit(benchmark::kMillisecond);
+    }
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+
+  for (auto & planner : g_configured_planners) {
+    planner.second.second->deactivate();
+    planner.second.second->cleanup();
+  }
+  g_configured_planners.clear();
+  g_costmap_ros->on_cleanup(rclcpp_lifecycle::State());
+  g_costmap_ros.reset();
+  return 0;
+}
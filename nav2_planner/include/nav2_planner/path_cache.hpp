@@ -0,0 +1,134 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_PLANNER__PATH_CACHE_HPP_
+#define NAV2_PLANNER__PATH_CACHE_HPP_
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <utility>
+
+#include "geometry_msgs/msg/pose_stamped.hpp"
+#include "nav_msgs/msg/path.hpp"
+
+namespace nav2_planner
+{
+
+/**
+ * @class nav2_planner::PathCache
+ * @brief Least recently used cache of paths, keyed by their planner and their start and
+ * goal quantized, so that routes planned again and again are reused while still valid
+ */
+class PathCache
+{
+public:
+  /**
+   * @brief A constructor for nav2_planner::PathCache
+   * @param position_resolution Resolution starts and goals positions are quantized to (m)
+   * @param orientation_resolution Resolution starts and goals orientations are
+   * quantized to (rad)
+   * @param max_size Maximum number of paths kept
+   */
+  PathCache(double position_resolution, double orientation_resolution, size_t max_size);
+
+  /**
+   * @brief Find a cached path, counting a hit if it is found and still valid, else a miss.
+   * The first and last poses of the path are moved to the start and goal, which may differ
+   * from those the path was planned for by up to the resolutions.
+   * @param start starting pose
+   * @param goal goal pose
+   * @param planner_id The planner the path was planned with
+   * @param is_valid A function to check if the cached path, moved to the start and goal,
+   * is still valid, dropping it if not
+   * @param path The cached path, if found
+   * @return bool If a valid path was found
+   */
+  bool find(
+    const geometry_msgs::msg::PoseStamped & start,
+    const geometry_msgs::msg::PoseStamped & goal,
+    const std::string & planner_id,
+    std::function<bool(const nav_msgs::msg::Path &)> is_valid,
+    nav_msgs::msg::Path & path);
+
+  /**
+   * @brief Cache a path, evicting the least recently used path if full
+   * @param start starting pose
+   * @param goal goal pose
+   * @param planner_id The planner the path was planned with
+   * @param path The path to cache
+   */
+  void insert(
+    const geometry_msgs::msg::PoseStamped & start,
+    const geometry_msgs::msg::PoseStamped & goal,
+    const std::string & planner_id,
+    const nav_msgs::msg::Path & path);
+
+  /**
+   * @brief Drop all cached paths
+   */
+  void clear();
+
+  /**
+   * @brief Get the number of paths cached
+   * @return size_t Number of paths
+   */
+  size_t size();
+
+  /**
+   * @brief Get the number of finds returning a valid path
+   * @return uint64_t Number of hits
+   */
+  uint64_t getHits();
+
+  /**
+   * @brief Get the number of finds not returning a path
+   * @return uint64_t Number of misses
+   */
+  uint64_t getMisses();
+
+protected:
+  using Key = std::tuple<std::string, int64_t, int64_t, int64_t, int64_t, int64_t, int64_t>;
+  using Entry = std::pair<Key, nav_msgs::msg::Path>;
+
+  /**
+   * @brief Quantize a start and goal into the key of their path
+   * @param start starting pose
+   * @param goal goal pose
+   * @param planner_id The planner the path was planned with
+   * @return Key The key
+   */
+  Key makeKey(
+    const geometry_msgs::msg::PoseStamped & start,
+    const geometry_msgs::msg::PoseStamped & goal,
+    const std::string & planner_id) const;
+
+  double position_resolution_;
+  double orientation_resolution_;
+  size_t max_size_;
+  uint64_t hits_;
+  uint64_t misses_;
+  // Most recently used first
+  std::list<Entry> entries_;
+  std::map<Key, std::list<Entry>::iterator> index_;
+  std::mutex mutex_;
+};
+
+}  // namespace nav2_planner
+
+#endif  // NAV2_PLANNER__PATH_CACHE_HPP_
@@ -15,7 +15,12 @@
 #ifndef NAV2_PLANNER__PLANNER_SERVER_HPP_
 #define NAV2_PLANNER__PLANNER_SERVER_HPP_
 
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <list>
 #include <string>
 #include <memory>
 #include <vector>
@@ -25,12 +30,16 @@
 #include "geometry_msgs/msg/point.hpp"
 #include "geometry_msgs/msg/pose_stamped.hpp"
 #include "nav_msgs/msg/path.hpp"
+#include "nav2_msgs/msg/compact_path.hpp"
 #include "nav2_util/lifecycle_node.hpp"
 #include "nav2_msgs/action/compute_path_to_pose.hpp"
 #include "nav2_msgs/action/compute_path_through_poses.hpp"
+#include "nav2_msgs/action/compute_path_to_poses.hpp"
 #include "nav2_msgs/msg/costmap.hpp"
+#include "nav2_planner/path_cache.hpp"
 #include "nav2_util/robot_utils.hpp"
 #include "nav2_util/simple_action_server.hpp"
+#include "std_msgs/msg/u_int64_multi_array.hpp"
 #include "visualization_msgs/msg/marker.hpp"
 #include "tf2_ros/transform_listener.h"
 #include "tf2_ros/create_timer_ros.h"
@@ -39,6 +48,7 @@
 #include "pluginlib/class_list_macros.hpp"
 #include "nav2_core/global_planner.hpp"
 #include "nav2_msgs/srv/is_path_valid.hpp"
+#include "nav2_msgs/srv/compute_path.hpp"
 #include "nav2_costmap_2d/footprint_collision_checker.hpp"
 #include "nav2_core/planner_exceptions.hpp"
 
@@ -64,11 +74,24 @@ public:
 
   using PlannerMap = std::unordered_map<std::string, nav2_core::GlobalPlanner::Ptr>;
 
+  /**
+   * @struct nav2_planner::PlannerServer::PlannerPool
+   * @brief Instances of a planner plugin, each planning a single request at a time, so
+   * that requests to the same planner run concurrently up to the number of instances
+   */
+  struct PlannerPool
+  {
+    std::vector<nav2_core::GlobalPlanner::Ptr> instances;
+    std::vector<bool> busy;
+    std::mutex mutex;
+    std::condition_variable available;
+  };
+
   /**
    * @brief Method to get plan from the desired plugin
    * @param start starting pose
    * @param goal goal request
-   * @param planner_id The planner to plan with
+   * @param planner_id The planner, or race of planners, to plan with
    * @param cancel_checker A function to check if the action has been canceled
    * @return Path
    */
@@ -78,7 +101,80 @@ public:
     const std::string & planner_id,
     std::function<bool()> cancel_checker);
 
+  /**
+   * @brief Method to get plan to the best of a set of goals from the desired plugin
+   * @param start starting pose
+   * @param goals set of goals to reach any of
+   * @param planner_id The planner to plan with, races of planners do not plan to goal sets
+   * @param cancel_checker A function to check if the action has been canceled
+   * @param goal_index Index in the set of the goal reached by the path
+   * @return Path
+   */
+  nav_msgs::msg::Path getPlanToGoalSet(
+    const geometry_msgs::msg::PoseStamped & start,
+    const std::vector<geometry_msgs::msg::PoseStamped> & goals,
+    const std::string & planner_id,
+    std::function<bool()> cancel_checker,
+    size_t & goal_index);
+
 protected:
+  /**
+   * @brief Call a free instance of a planner, waiting for one if all are busy
+   * @param planner_id The planner to plan with
+   * @param cancel_checker A function to check if the action has been canceled
+   * @param plan Function planning with the instance
+   * @return Path
+   */
+  nav_msgs::msg::Path callFreeInstance(
+    const std::string & planner_id,
+    std::function<bool()> cancel_checker,
+    const std::function<nav_msgs::msg::Path(nav2_core::GlobalPlanner &)> & plan);
+
+  /**
+   * @brief Plan with a free instance of a planner, waiting for one if all are busy
+   * @param planner_id The planner to plan with
+   * @param start starting pose
+   * @param goal goal request
+   * @param cancel_checker A function to check if the action has been canceled
+   * @return Path
+   */
+  nav_msgs::msg::Path planWithInstance(
+    const std::string & planner_id,
+    const geometry_msgs::msg::PoseStamped & start,
+    const geometry_msgs::msg::PoseStamped & goal,
+    std::function<bool()> cancel_checker);
+
+  /**
+   * @brief Plan with all the planners of a race concurrently, returning the first
+   * valid path found and canceling the others
+   * @param race_id The race of planners to plan with
+   * @param start starting pose
+   * @param goal goal request
+   * @param cancel_checker A function to check if the action has been canceled
+   * @return Path
+   */
+  nav_msgs::msg::Path racePlanners(
+    const std::string & race_id,
+    const geometry_msgs::msg::PoseStamped & start,
+    const geometry_msgs::msg::PoseStamped & goal,
+    std::function<bool()> cancel_checker);
+
+  /**
+   * @brief Plan the legs between consecutive poses concurrently
+   * @param starts Starting pose of each leg
+   * @param goals Goal pose of each leg
+   * @param planner_id The planner, or race of planners, to plan with
+   * @param cancel_checker A function to check if the action has been canceled
+   * @param failed_leg Index of the leg which failed to plan, set if throwing
+   * @return Path of each leg, in order
+   */
+  std::vector<nav_msgs::msg::Path> planLegsConcurrently(
+    const std::vector<geometry_msgs::msg::PoseStamped> & starts,
+    const std::vector<geometry_msgs::msg::PoseStamped> & goals,
+    const std::string & planner_id,
+    std::function<bool()> cancel_checker,
+    size_t & failed_leg);
+
   /**
    * @brief Configure member variables and initializes planner
    * @param state Reference to LifeCycle node state
@@ -116,6 +212,9 @@ protected:
   using ActionThroughPosesResult = ActionThroughPoses::Result;
   using ActionServerToPose = nav2_util::SimpleActionServer<ActionToPose>;
   using ActionServerThroughPoses = nav2_util::SimpleActionServer<ActionThroughPoses>;
+  using ActionToPoses = nav2_msgs::action::ComputePathToPoses;
+  using ActionToPosesResult = ActionToPoses::Result;
+  using ActionServerToPoses = nav2_util::SimpleActionServer<ActionToPoses>;
 
   /**
    * @brief Check if an action server is valid / active
@@ -199,6 +298,12 @@ protected:
    */
   void computePlanThroughPoses();
 
+  /**
+   * @brief The action server callback which calls planner to get the path
+   * ComputePathToPoses
+   */
+  void computePlanToPoses();
+
   /**
    * @brief The service callback to determine if the path is still valid
    * @param request to the service
@@ -208,12 +313,47 @@ protected:
     const std::shared_ptr<nav2_msgs::srv::IsPathValid::Request> request,
     std::shared_ptr<nav2_msgs::srv::IsPathValid::Response> response);
 
+  /**
+   * @brief The service callback to plan a path, planning it on a thread of its own and
+   * responding once planned, so that requests are planned concurrently
+   * @param service Service to respond with
+   * @param request_header Header of the request to respond to
+   * @param request to the service
+   */
+  void computePath(
+    const std::shared_ptr<rclcpp::Service<nav2_msgs::srv::ComputePath>> service,
+    const std::shared_ptr<rmw_request_id_t> request_header,
+    const std::shared_ptr<nav2_msgs::srv::ComputePath::Request> request);
+
+  /**
+   * @brief Plan the path of a compute_path request, reporting failures in the response
+   * @param request to the service
+   * @param response from the service
+   */
+  void planPathQuery(
+    const nav2_msgs::srv::ComputePath::Request & request,
+    nav2_msgs::srv::ComputePath::Response & response);
+
+  /**
+   * @brief Find the first pose of a path in collision in the costmap, checking the
+   * footprint with its kernels if is_path_valid_footprint_headings is set
+   * @param path Path to check
+   * @param start_index Index of the first pose of the path to check
+   * @return int Index of the first pose in collision, or -1 if the path is collision free
+   */
+  int findPathCollision(const nav_msgs::msg::Path & path, unsigned int start_index);
+
   /**
    * @brief Publish a path for visualization purposes
    * @param path Reference to Global Path
    */
   void publishPlan(const nav_msgs::msg::Path & path);
 
+  /**
+   * @brief Publish the hits and misses of the path cache
+   */
+  void publishPathCacheStats();
+
   void exceptionWarning(
     const geometry_msgs::msg::PoseStamped & start,
     const geometry_msgs::msg::PoseStamped & goal,
@@ -230,6 +370,7 @@ protected:
   // Our action server implements the ComputePathToPose action
   std::unique_ptr<ActionServerToPose> action_server_pose_;
   std::unique_ptr<ActionServerThroughPoses> action_server_poses_;
+  std::unique_ptr<ActionServerToPoses> action_server_goal_set_;
 
   // Dynamic parameters handler
   rclcpp::node_interfaces::OnSetParametersCallbackHandle::SharedPtr dyn_params_handler_;
@@ -243,7 +384,13 @@ protected:
   std::vector<std::string> planner_ids_;
   std::vector<std::string> planner_types_;
   double max_planner_duration_;
+  bool plan_through_poses_concurrently_;
+  bool preempt_planning_;
   std::string planner_ids_concat_;
+  int planner_instances_;
+  unsigned int is_path_valid_footprint_headings_;
+  std::unordered_map<std::string, std::shared_ptr<PlannerPool>> planner_pools_;
+  std::unordered_map<std::string, std::vector<std::string>> planner_races_;
 
   // TF buffer
   std::shared_ptr<tf2_ros::Buffer> tf_;
@@ -257,9 +404,22 @@ protected:
 
   // Publishers for the path
   rclcpp_lifecycle::LifecyclePublisher<nav_msgs::msg::Path>::SharedPtr plan_publisher_;
+  rclcpp_lifecycle::LifecyclePublisher<nav2_msgs::msg::CompactPath>::SharedPtr
+    compact_plan_publisher_;
+
+  // Cache of planned paths, with its hits and misses publisher
+  std::unique_ptr<PathCache> path_cache_;
+  rclcpp_lifecycle::LifecyclePublisher<std_msgs::msg::UInt64MultiArray>::SharedPtr
+    path_cache_stats_publisher_;
 
   // Service to determine if the path is valid
   rclcpp::Service<nav2_msgs::srv::IsPathValid>::SharedPtr is_path_valid_service_;
+
+  // Service to plan paths concurrently, with the requests being planned
+  rclcpp::Service<nav2_msgs::srv::ComputePath>::SharedPtr compute_path_service_;
+  std::atomic<bool> path_queries_active_{false};
+  std::list<std::future<void>> path_queries_;
+  std::mutex path_queries_mutex_;
 };
 
 }  // namespace nav2_planner
@@ -0,0 +1,147 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <utility>
+
+#include "nav2_util/geometry_utils.hpp"
+#include "nav2_planner/path_cache.hpp"
+
+namespace nav2_planner
+{
+
+PathCache::PathCache(
+  double position_resolution, double orientation_resolution, size_t max_size)
+: position_resolution_(std::max(position_resolution, 1e-3)),
+  orientation_resolution_(std::max(orientation_resolution, 1e-3)),
+  max_size_(std::max(max_size, static_cast<size_t>(1))),
+  hits_(0),
+  misses_(0)
+{
+}
+
+PathCache::Key PathCache::makeKey(
+  const geometry_msgs::msg::PoseStamped & start,
+  const geometry_msgs::msg::PoseStamped & goal,
+  const std::string & planner_id) const
+{
+  auto position = [this](double value) {
+      return static_cast<int64_t>(std::round(value / position_resolution_));
+    };
+  // Wrap the yaw into [0, 2 pi) with the last bin wrapping into the first, so that
+  // headings either side of the wrap share their key
+  auto orientation = [this](const geometry_msgs::msg::Quaternion & q) {
+      double yaw = std::fmod(tf2::getYaw(q), 2.0 * M_PI);
+      if (yaw < 0.0) {
+        yaw += 2.0 * M_PI;
+      }
+      const int64_t bins = std::max(
+        static_cast<int64_t>(std::round(2.0 * M_PI / orientation_resolution_)),
+        static_cast<int64_t>(1));
+      return static_cast<int64_t>(std::round(yaw / (2.0 * M_PI) * bins)) % bins;
+    };
+
+  return Key(
+    planner_id,
+    position(start.pose.position.x), position(start.pose.position.y),
+    orientation(start.pose.orientation),
+    position(goal.pose.position.x), position(goal.pose.position.y),
+    orientation(goal.pose.orientation));
+}
+
+bool PathCache::find(
+  const geometry_msgs::msg::PoseStamped & start,
+  const geometry_msgs::msg::PoseStamped & goal,
+  const std::string & planner_id,
+  std::function<bool(const nav_msgs::msg::Path &)> is_valid,
+  nav_msgs::msg::Path & path)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = index_.find(makeKey(start, goal, planner_id));
+  if (it == index_.end()) {
+    misses_++;
+    return false;
+  }
+
+  // The path must start and end exactly where requested, for the goal checker and smoothers
+  nav_msgs::msg::Path cached_path = it->second->second;
+  if (!cached_path.poses.empty()) {
+    cached_path.poses.front().pose = start.pose;
+    cached_path.poses.back().pose = goal.pose;
+  }
+
+  if (!is_valid(cached_path)) {
+    entries_.erase(it->second);
+    index_.erase(it);
+    misses_++;
+    return false;
+  }
+
+  entries_.splice(entries_.begin(), entries_, it->second);
+  path = std::move(cached_path);
+  hits_++;
+  return true;
+}
+
+void PathCache::insert(
+  const geometry_msgs::msg::PoseStamped & start,
+  const geometry_msgs::msg::PoseStamped & goal,
+  const std::string & planner_id,
+  const nav_msgs::msg::Path & path)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  Key key = makeKey(start, goal, planner_id);
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    it->second->second = path;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return;
+  }
+
+  if (entries_.size() >= max_size_) {
+    index_.erase(entries_.back().first);
+    entries_.pop_back();
+  }
+  entries_.emplace_front(key, path);
+  index_[key] = entries_.begin();
+}
+
+void PathCache::clear()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  index_.clear();
+}
+
+size_t PathCache::size()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+uint64_t PathCache::getHits()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return hits_;
+}
+
+uint64_t PathCache::getMisses()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return misses_;
+}
+
+}  // namespace nav2_planner
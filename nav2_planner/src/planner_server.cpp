@@ -13,8 +13,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cmath>
+#include <future>
 #include <iomanip>
 #include <iostream>
 #include <limits>
@@ -26,9 +29,11 @@
 
 #include "builtin_interfaces/msg/duration.hpp"
 #include "lifecycle_msgs/msg/state.hpp"
+#include "nav2_util/compact_path.hpp"
 #include "nav2_util/costmap.hpp"
 #include "nav2_util/node_utils.hpp"
 #include "nav2_util/geometry_utils.hpp"
+#include "nav2_util/tracing.hpp"
 #include "nav2_costmap_2d/cost_values.hpp"
 
 #include "nav2_planner/planner_server.hpp"
@@ -45,6 +50,10 @@ PlannerServer::PlannerServer(const rclcpp::NodeOptions & options)
   gp_loader_("nav2_core", "nav2_core::GlobalPlanner"),
   default_ids_{"GridBased"},
   default_types_{"nav2_navfn_planner::NavfnPlanner"},
+  plan_through_poses_concurrently_(false),
+  preempt_planning_(false),
+  planner_instances_(1),
+  is_path_valid_footprint_headings_(0),
   costmap_(nullptr)
 {
   RCLCPP_INFO(get_logger(), "Creating");
@@ -53,6 +62,16 @@ PlannerServer::PlannerServer(const rclcpp::NodeOptions & options)
   declare_parameter("planner_plugins", default_ids_);
   declare_parameter("expected_planner_frequency", 1.0);
   declare_parameter("action_server_result_timeout", 10.0);
+  declare_parameter("planner_instances", 1);
+  declare_parameter("planner_races", std::vector<std::string>());
+  declare_parameter("plan_through_poses_concurrently", false);
+  declare_parameter("preempt_planning", false);
+  declare_parameter("is_path_valid_footprint_headings", 0);
+  declare_parameter("use_path_cache", false);
+  declare_parameter("path_cache_size", 100);
+  declare_parameter("path_cache_position_resolution", 0.1);
+  declare_parameter("path_cache_orientation_resolution", 0.1);
+  declare_parameter("publish_compact_plan", false);
 
   get_parameter("planner_plugins", planner_ids_);
   if (planner_ids_ == default_ids_) {
@@ -73,6 +92,7 @@ PlannerServer::~PlannerServer()
    * Backstop ensuring this state is destroyed, even if deactivate/cleanup are
    * never called.
    */
+  planner_pools_.clear();
   planners_.clear();
   costmap_thread_.reset();
 }
@@ -92,7 +112,9 @@ PlannerServer::on_configure(const rclcpp_lifecycle::State & /*state*/)
   }
 
   // Launch a thread to run the costmap node
-  costmap_thread_ = std::make_unique<nav2_util::NodeThread>(costmap_ros_);
+  costmap_thread_ = std::make_unique<nav2_util::NodeThread>(
+    costmap_ros_->get_node_base_interface(),
+    nav2_util::declareThreadSettings(shared_from_this(), "costmap_thread"));
 
   RCLCPP_DEBUG(
     get_logger(), "Costmap size: %d,%d",
@@ -104,17 +126,31 @@ PlannerServer::on_configure(const rclcpp_lifecycle::State & /*state*/)
 
   auto node = shared_from_this();
 
+  get_parameter("planner_instances", planner_instances_);
+  if (planner_instances_ < 1) {
+    RCLCPP_WARN(
+      get_logger(), "The planner instances parameter is %i. The value should be at least 1,"
+      " using a single instance of each planner", planner_instances_);
+    planner_instances_ = 1;
+  }
+
   for (size_t i = 0; i != planner_ids_.size(); i++) {
     try {
       planner_types_[i] = nav2_util::get_plugin_type_param(
         node, planner_ids_[i]);
-      nav2_core::GlobalPlanner::Ptr planner =
-        gp_loader_.createUniqueInstance(planner_types_[i]);
+      auto pool = std::make_shared<PlannerPool>();
+      for (int j = 0; j != planner_instances_; j++) {
+        nav2_core::GlobalPlanner::Ptr planner =
+          gp_loader_.createUniqueInstance(planner_types_[i]);
+        planner->configure(node, planner_ids_[i], tf_, costmap_ros_);
+        pool->instances.push_back(planner);
+        pool->busy.push_back(false);
+      }
       RCLCPP_INFO(
-        get_logger(), "Created global planner plugin %s of type %s",
-        planner_ids_[i].c_str(), planner_types_[i].c_str());
-      planner->configure(node, planner_ids_[i], tf_, costmap_ros_);
-      planners_.insert({planner_ids_[i], planner});
+        get_logger(), "Created %i instance(s) of global planner plugin %s of type %s",
+        planner_instances_, planner_ids_[i].c_str(), planner_types_[i].c_str());
+      planners_.insert({planner_ids_[i], pool->instances.front()});
+      planner_pools_.insert({planner_ids_[i], pool});
     } catch (const std::exception & ex) {
       RCLCPP_FATAL(
         get_logger(), "Failed to create global planner. Exception: %s",
@@ -131,6 +167,31 @@ PlannerServer::on_configure(const rclcpp_lifecycle::State & /*state*/)
     get_logger(),
     "Planner Server has %s planners available.", planner_ids_concat_.c_str());
 
+  std::vector<std::string> race_ids;
+  get_parameter("planner_races", race_ids);
+  for (const auto & race_id : race_ids) {
+    std::vector<std::string> race_planners;
+    nav2_util::declare_parameter_if_not_declared(
+      node, race_id + ".planners", rclcpp::ParameterValue(std::vector<std::string>()));
+    get_parameter(race_id + ".planners", race_planners);
+    if (planners_.find(race_id) != planners_.end() || race_planners.empty()) {
+      RCLCPP_FATAL(
+        get_logger(), "Planner race %s must have planners and not share a planner's name",
+        race_id.c_str());
+      return nav2_util::CallbackReturn::FAILURE;
+    }
+    for (const auto & race_planner : race_planners) {
+      if (planners_.find(race_planner) == planners_.end()) {
+        RCLCPP_FATAL(
+          get_logger(), "Planner race %s has invalid planner %s. Planner names are: %s",
+          race_id.c_str(), race_planner.c_str(), planner_ids_concat_.c_str());
+        return nav2_util::CallbackReturn::FAILURE;
+      }
+    }
+    planner_races_[race_id] = race_planners;
+    RCLCPP_INFO(get_logger(), "Created planner race %s", race_id.c_str());
+  }
+
   double expected_planner_frequency;
   get_parameter("expected_planner_frequency", expected_planner_frequency);
   if (expected_planner_frequency > 0) {
@@ -143,8 +204,35 @@ PlannerServer::on_configure(const rclcpp_lifecycle::State & /*state*/)
     max_planner_duration_ = 0.0;
   }
 
+  get_parameter("plan_through_poses_concurrently", plan_through_poses_concurrently_);
+  get_parameter("preempt_planning", preempt_planning_);
+
+  int footprint_headings;
+  get_parameter("is_path_valid_footprint_headings", footprint_headings);
+  is_path_valid_footprint_headings_ = static_cast<unsigned int>(std::max(footprint_headings, 0));
+
+  bool use_path_cache;
+  get_parameter("use_path_cache", use_path_cache);
+  if (use_path_cache) {
+    int path_cache_size;
+    double position_resolution, orientation_resolution;
+    get_parameter("path_cache_size", path_cache_size);
+    get_parameter("path_cache_position_resolution", position_resolution);
+    get_parameter("path_cache_orientation_resolution", orientation_resolution);
+    path_cache_ = std::make_unique<PathCache>(
+      position_resolution, orientation_resolution,
+      static_cast<size_t>(std::max(path_cache_size, 1)));
+  }
+
   // Initialize pubs & subs
   plan_publisher_ = create_publisher<nav_msgs::msg::Path>("plan", 1);
+  if (get_parameter("publish_compact_plan").as_bool()) {
+    compact_plan_publisher_ = create_publisher<nav2_msgs::msg::CompactPath>("plan_compact", 1);
+  }
+  if (path_cache_) {
+    path_cache_stats_publisher_ =
+      create_publisher<std_msgs::msg::UInt64MultiArray>("path_cache_stats", 1);
+  }
 
   double action_server_result_timeout;
   get_parameter("action_server_result_timeout", action_server_result_timeout);
@@ -168,6 +256,21 @@ PlannerServer::on_configure(const rclcpp_lifecycle::State & /*state*/)
     std::chrono::milliseconds(500),
     true, server_options);
 
+  action_server_goal_set_ = std::make_unique<ActionServerToPoses>(
+    shared_from_this(),
+    "compute_path_to_poses",
+    std::bind(&PlannerServer::computePlanToPoses, this),
+    nullptr,
+    std::chrono::milliseconds(500),
+    true, server_options);
+
+  // The goals of each action server are computed on their own worker thread
+  const auto planner_thread_settings =
+    nav2_util::declareThreadSettings(shared_from_this(), "planner_thread");
+  action_server_pose_->setWorkerThreadSettings(planner_thread_settings);
+  action_server_poses_->setWorkerThreadSettings(planner_thread_settings);
+  action_server_goal_set_->setWorkerThreadSettings(planner_thread_settings);
+
   return nav2_util::CallbackReturn::SUCCESS;
 }
 
@@ -177,16 +280,24 @@ PlannerServer::on_activate(const rclcpp_lifecycle::State & /*state*/)
   RCLCPP_INFO(get_logger(), "Activating");
 
   plan_publisher_->on_activate();
+  if (compact_plan_publisher_) {
+    compact_plan_publisher_->on_activate();
+  }
+  if (path_cache_stats_publisher_) {
+    path_cache_stats_publisher_->on_activate();
+  }
   action_server_pose_->activate();
   action_server_poses_->activate();
+  action_server_goal_set_->activate();
   const auto costmap_ros_state = costmap_ros_->activate();
   if (costmap_ros_state.id() != lifecycle_msgs::msg::State::PRIMARY_STATE_ACTIVE) {
     return nav2_util::CallbackReturn::FAILURE;
   }
 
-  PlannerMap::iterator it;
-  for (it = planners_.begin(); it != planners_.end(); ++it) {
-    it->second->activate();
+  for (auto & pool : planner_pools_) {
+    for (auto & planner : pool.second->instances) {
+      planner->activate();
+    }
   }
 
   auto node = shared_from_this();
@@ -197,6 +308,16 @@ PlannerServer::on_activate(const rclcpp_lifecycle::State & /*state*/)
       &PlannerServer::isPathValid, this,
       std::placeholders::_1, std::placeholders::_2));
 
+  path_queries_active_ = true;
+  compute_path_service_ = node->create_service<nav2_msgs::srv::ComputePath>(
+    "compute_path",
+    [this](
+      const std::shared_ptr<rclcpp::Service<nav2_msgs::srv::ComputePath>> service,
+      const std::shared_ptr<rmw_request_id_t> request_header,
+      const std::shared_ptr<nav2_msgs::srv::ComputePath::Request> request) {
+      computePath(service, request_header, request);
+    });
+
   // Add callback for dynamic parameters
   dyn_params_handler_ = node->add_on_set_parameters_callback(
     std::bind(&PlannerServer::dynamicParametersCallback, this, _1));
@@ -212,9 +333,27 @@ PlannerServer::on_deactivate(const rclcpp_lifecycle::State & /*state*/)
 {
   RCLCPP_INFO(get_logger(), "Deactivating");
 
+  // Cancel the paths being planned for compute_path and wait for them to be responded to
+  compute_path_service_.reset();
+  path_queries_active_ = false;
+  {
+    std::lock_guard<std::mutex> lock(path_queries_mutex_);
+    for (auto & query : path_queries_) {
+      query.wait();
+    }
+    path_queries_.clear();
+  }
+
   action_server_pose_->deactivate();
   action_server_poses_->deactivate();
+  action_server_goal_set_->deactivate();
   plan_publisher_->on_deactivate();
+  if (compact_plan_publisher_) {
+    compact_plan_publisher_->on_deactivate();
+  }
+  if (path_cache_stats_publisher_) {
+    path_cache_stats_publisher_->on_deactivate();
+  }
 
   /*
    * The costmap is also a lifecycle node, so it may have already fired on_deactivate
@@ -225,9 +364,10 @@ PlannerServer::on_deactivate(const rclcpp_lifecycle::State & /*state*/)
    */
   costmap_ros_->deactivate();
 
-  PlannerMap::iterator it;
-  for (it = planners_.begin(); it != planners_.end(); ++it) {
-    it->second->deactivate();
+  for (auto & pool : planner_pools_) {
+    for (auto & planner : pool.second->instances) {
+      planner->deactivate();
+    }
   }
 
   dyn_params_handler_.reset();
@@ -245,16 +385,23 @@ PlannerServer::on_cleanup(const rclcpp_lifecycle::State & /*state*/)
 
   action_server_pose_.reset();
   action_server_poses_.reset();
+  action_server_goal_set_.reset();
   plan_publisher_.reset();
+  compact_plan_publisher_.reset();
+  path_cache_stats_publisher_.reset();
+  path_cache_.reset();
   tf_.reset();
 
   costmap_ros_->cleanup();
 
-  PlannerMap::iterator it;
-  for (it = planners_.begin(); it != planners_.end(); ++it) {
-    it->second->cleanup();
+  for (auto & pool : planner_pools_) {
+    for (auto & planner : pool.second->instances) {
+      planner->cleanup();
+    }
   }
 
+  planner_pools_.clear();
+  planner_races_.clear();
   planners_.clear();
   costmap_thread_.reset();
   costmap_ = nullptr;
@@ -364,8 +511,6 @@ bool PlannerServer::validatePath(
 
 void PlannerServer::computePlanThroughPoses()
 {
-  std::lock_guard<std::mutex> lock(dynamic_params_lock_);
-
   auto start_time = this->now();
 
   // Initialize the ComputePathThroughPoses goal and result
@@ -394,41 +539,80 @@ void PlannerServer::computePlanThroughPoses()
       throw nav2_core::PlannerTFError("Unable to get start pose");
     }
 
-    auto cancel_checker = [this]() {
-        return action_server_poses_->is_cancel_requested();
+    bool plan_concurrently, preempt;
+    {
+      std::lock_guard<std::mutex> lock(dynamic_params_lock_);
+      plan_concurrently = plan_through_poses_concurrently_;
+      preempt = preempt_planning_;
+    }
+    auto cancel_checker = [this, preempt]() {
+        return action_server_poses_->is_cancel_requested() ||
+               (preempt && action_server_poses_->is_preempt_requested());
       };
 
-    // Get consecutive paths through these points
-    for (unsigned int i = 0; i != goal->goals.size(); i++) {
-      // Get starting point
-      if (i == 0) {
-        curr_start = start;
-      } else {
-        // pick the end of the last planning task as the start for the next one
-        // to allow for path tolerance deviations
-        curr_start = concat_path.poses.back();
-        curr_start.header = concat_path.header;
+    // Legs start at the previous viapoint rather than at the end of the previous leg's path,
+    // so that they are independent and planned concurrently, then stitched in order
+    if (plan_concurrently) {
+      std::vector<geometry_msgs::msg::PoseStamped> starts, goals;
+      for (unsigned int j = 0; j != goal->goals.size(); j++) {
+        curr_start = j == 0 ? start : goal->goals[j - 1];
+        curr_goal = goal->goals[j];
+        if (!transformPosesToGlobalFrame(curr_start, curr_goal)) {
+          throw nav2_core::PlannerTFError("Unable to transform poses to global frame");
+        }
+        starts.push_back(curr_start);
+        goals.push_back(curr_goal);
       }
-      curr_goal = goal->goals[i];
 
-      // Transform them into the global frame
-      if (!transformPosesToGlobalFrame(curr_start, curr_goal)) {
-        throw nav2_core::PlannerTFError("Unable to transform poses to global frame");
+      size_t failed_leg = 0;
+      std::vector<nav_msgs::msg::Path> paths;
+      try {
+        paths = planLegsConcurrently(
+          starts, goals, goal->planner_id, cancel_checker, failed_leg);
+      } catch (...) {
+        curr_start = starts[failed_leg];
+        curr_goal = goals[failed_leg];
+        throw;
       }
 
-      // Get plan from start -> goal
-      nav_msgs::msg::Path curr_path = getPlan(
-        curr_start, curr_goal, goal->planner_id,
-        cancel_checker);
-
-      if (!validatePath<ActionThroughPoses>(curr_goal, curr_path, goal->planner_id)) {
-        throw nav2_core::NoValidPathCouldBeFound(goal->planner_id + " generated a empty path");
+      for (const auto & curr_path : paths) {
+        concat_path.poses.insert(
+          concat_path.poses.end(), curr_path.poses.begin(), curr_path.poses.end());
+        concat_path.header = curr_path.header;
       }
+    } else {
+      // Get consecutive paths through these points
+      for (unsigned int i = 0; i != goal->goals.size(); i++) {
+        // Get starting point
+        if (i == 0) {
+          curr_start = start;
+        } else {
+          // pick the end of the last planning task as the start for the next one
+          // to allow for path tolerance deviations
+          curr_start = concat_path.poses.back();
+          curr_start.header = concat_path.header;
+        }
+        curr_goal = goal->goals[i];
+
+        // Transform them into the global frame
+        if (!transformPosesToGlobalFrame(curr_start, curr_goal)) {
+          throw nav2_core::PlannerTFError("Unable to transform poses to global frame");
+        }
+
+        // Get plan from start -> goal
+        nav_msgs::msg::Path curr_path = getPlan(
+          curr_start, curr_goal, goal->planner_id,
+          cancel_checker);
 
-      // Concatenate paths together
-      concat_path.poses.insert(
-        concat_path.poses.end(), curr_path.poses.begin(), curr_path.poses.end());
-      concat_path.header = curr_path.header;
+        if (!validatePath<ActionThroughPoses>(curr_goal, curr_path, goal->planner_id)) {
+          throw nav2_core::NoValidPathCouldBeFound(goal->planner_id + " generated a empty path");
+        }
+
+        // Concatenate paths together
+        concat_path.poses.insert(
+          concat_path.poses.end(), curr_path.poses.begin(), curr_path.poses.end());
+        concat_path.header = curr_path.header;
+      }
     }
 
     // Publish the plan for visualization purposes
@@ -438,11 +622,17 @@ void PlannerServer::computePlanThroughPoses()
     auto cycle_duration = this->now() - start_time;
     result->planning_time = cycle_duration;
 
-    if (max_planner_duration_ && cycle_duration.seconds() > max_planner_duration_) {
+    // Only the parameters are locked, so both actions may plan concurrently
+    double max_planner_duration;
+    {
+      std::lock_guard<std::mutex> lock(dynamic_params_lock_);
+      max_planner_duration = max_planner_duration_;
+    }
+    if (max_planner_duration && cycle_duration.seconds() > max_planner_duration) {
       RCLCPP_WARN(
         get_logger(),
         "Planner loop missed its desired rate of %.4f Hz. Current loop rate is %.4f Hz",
-        1 / max_planner_duration_, 1 / cycle_duration.seconds());
+        1 / max_planner_duration, 1 / cycle_duration.seconds());
     }
 
     action_server_poses_->succeeded_current(result);
@@ -483,6 +673,11 @@ void PlannerServer::computePlanThroughPoses()
     result->error_code = ActionThroughPosesResult::NO_VIAPOINTS_GIVEN;
     action_server_poses_->terminate_current(result);
   } catch (nav2_core::PlannerCancelled &) {
+    if (action_server_poses_->is_preempt_requested()) {
+      // The action server aborts the goal and plans the new one
+      RCLCPP_INFO(get_logger(), "Goal was preempted. Planning the new goal.");
+      return;
+    }
     RCLCPP_INFO(get_logger(), "Goal was canceled. Canceling planning action.");
     action_server_poses_->terminate_all();
   } catch (std::exception & ex) {
@@ -495,8 +690,6 @@ void PlannerServer::computePlanThroughPoses()
 void
 PlannerServer::computePlan()
 {
-  std::lock_guard<std::mutex> lock(dynamic_params_lock_);
-
   auto start_time = this->now();
 
   // Initialize the ComputePathToPose goal and result
@@ -525,8 +718,14 @@ PlannerServer::computePlan()
       throw nav2_core::PlannerTFError("Unable to transform poses to global frame");
     }
 
-    auto cancel_checker = [this]() {
-        return action_server_pose_->is_cancel_requested();
+    bool preempt;
+    {
+      std::lock_guard<std::mutex> lock(dynamic_params_lock_);
+      preempt = preempt_planning_;
+    }
+    auto cancel_checker = [this, preempt]() {
+        return action_server_pose_->is_cancel_requested() ||
+               (preempt && action_server_pose_->is_preempt_requested());
       };
 
     result->path = getPlan(start, goal_pose, goal->planner_id, cancel_checker);
@@ -541,11 +740,17 @@ PlannerServer::computePlan()
     auto cycle_duration = this->now() - start_time;
     result->planning_time = cycle_duration;
 
-    if (max_planner_duration_ && cycle_duration.seconds() > max_planner_duration_) {
+    // Only the parameters are locked, so both actions may plan concurrently
+    double max_planner_duration;
+    {
+      std::lock_guard<std::mutex> lock(dynamic_params_lock_);
+      max_planner_duration = max_planner_duration_;
+    }
+    if (max_planner_duration && cycle_duration.seconds() > max_planner_duration) {
       RCLCPP_WARN(
         get_logger(),
         "Planner loop missed its desired rate of %.4f Hz. Current loop rate is %.4f Hz",
-        1 / max_planner_duration_, 1 / cycle_duration.seconds());
+        1 / max_planner_duration, 1 / cycle_duration.seconds());
     }
     action_server_pose_->succeeded_current(result);
   } catch (nav2_core::InvalidPlanner & ex) {
@@ -581,6 +786,11 @@ PlannerServer::computePlan()
     result->error_code = ActionToPoseResult::TF_ERROR;
     action_server_pose_->terminate_current(result);
   } catch (nav2_core::PlannerCancelled &) {
+    if (action_server_pose_->is_preempt_requested()) {
+      // The action server aborts the goal and plans the new one
+      RCLCPP_INFO(get_logger(), "Goal was preempted. Planning the new goal.");
+      return;
+    }
     RCLCPP_INFO(get_logger(), "Goal was canceled. Canceling planning action.");
     action_server_pose_->terminate_all();
   } catch (std::exception & ex) {
@@ -590,6 +800,129 @@ PlannerServer::computePlan()
   }
 }
 
+void
+PlannerServer::computePlanToPoses()
+{
+  auto start_time = this->now();
+
+  // Initialize the ComputePathToPoses goal and result
+  auto goal = action_server_goal_set_->get_current_goal();
+  auto result = std::make_shared<ActionToPoses::Result>();
+
+  geometry_msgs::msg::PoseStamped start;
+  std::vector<geometry_msgs::msg::PoseStamped> goal_poses;
+
+  // Failures are reported against the first goal of the set
+  auto first_goal = [&goal]() {
+      return goal->goals.empty() ? geometry_msgs::msg::PoseStamped() : goal->goals.front();
+    };
+
+  try {
+    if (isServerInactive(action_server_goal_set_) || isCancelRequested(action_server_goal_set_)) {
+      return;
+    }
+
+    waitForCostmap();
+
+    getPreemptedGoalIfRequested(action_server_goal_set_, goal);
+
+    if (goal->goals.empty()) {
+      throw nav2_core::NoViapointsGiven("No goals given");
+    }
+
+    // Use start pose if provided otherwise use current robot pose
+    if (!getStartPose<ActionToPoses>(goal, start)) {
+      throw nav2_core::PlannerTFError("Unable to get start pose");
+    }
+
+    // Transform them into the global frame
+    goal_poses = goal->goals;
+    for (auto & goal_pose : goal_poses) {
+      if (!transformPosesToGlobalFrame(start, goal_pose)) {
+        throw nav2_core::PlannerTFError("Unable to transform poses to global frame");
+      }
+    }
+
+    auto cancel_checker = [this]() {
+        return action_server_goal_set_->is_cancel_requested();
+      };
+
+    size_t goal_index = 0;
+    result->path = getPlanToGoalSet(
+      start, goal_poses, goal->planner_id, cancel_checker, goal_index);
+    result->goal_index = static_cast<uint32_t>(goal_index);
+
+    if (!validatePath<ActionToPoses>(
+        goal_poses[goal_index], result->path, goal->planner_id))
+    {
+      throw nav2_core::NoValidPathCouldBeFound(goal->planner_id + " generated a empty path");
+    }
+
+    // Publish the plan for visualization purposes
+    publishPlan(result->path);
+
+    auto cycle_duration = this->now() - start_time;
+    result->planning_time = cycle_duration;
+
+    // Only the parameters are locked, so the actions may plan concurrently
+    double max_planner_duration;
+    {
+      std::lock_guard<std::mutex> lock(dynamic_params_lock_);
+      max_planner_duration = max_planner_duration_;
+    }
+    if (max_planner_duration && cycle_duration.seconds() > max_planner_duration) {
+      RCLCPP_WARN(
+        get_logger(),
+        "Planner loop missed its desired rate of %.4f Hz. Current loop rate is %.4f Hz",
+        1 / max_planner_duration, 1 / cycle_duration.seconds());
+    }
+    action_server_goal_set_->succeeded_current(result);
+  } catch (nav2_core::InvalidPlanner & ex) {
+    exceptionWarning(start, first_goal(), goal->planner_id, ex);
+    result->error_code = ActionToPosesResult::INVALID_PLANNER;
+    action_server_goal_set_->terminate_current(result);
+  } catch (nav2_core::StartOccupied & ex) {
+    exceptionWarning(start, first_goal(), goal->planner_id, ex);
+    result->error_code = ActionToPosesResult::START_OCCUPIED;
+    action_server_goal_set_->terminate_current(result);
+  } catch (nav2_core::GoalOccupied & ex) {
+    exceptionWarning(start, first_goal(), goal->planner_id, ex);
+    result->error_code = ActionToPosesResult::GOAL_OCCUPIED;
+    action_server_goal_set_->terminate_current(result);
+  } catch (nav2_core::NoValidPathCouldBeFound & ex) {
+    exceptionWarning(start, first_goal(), goal->planner_id, ex);
+    result->error_code = ActionToPosesResult::NO_VALID_PATH;
+    action_server_goal_set_->terminate_current(result);
+  } catch (nav2_core::PlannerTimedOut & ex) {
+    exceptionWarning(start, first_goal(), goal->planner_id, ex);
+    result->error_code = ActionToPosesResult::TIMEOUT;
+    action_server_goal_set_->terminate_current(result);
+  } catch (nav2_core::StartOutsideMapBounds & ex) {
+    exceptionWarning(start, first_goal(), goal->planner_id, ex);
+    result->error_code = ActionToPosesResult::START_OUTSIDE_MAP;
+    action_server_goal_set_->terminate_current(result);
+  } catch (nav2_core::GoalOutsideMapBounds & ex) {
+    exceptionWarning(start, first_goal(), goal->planner_id, ex);
+    result->error_code = ActionToPosesResult::GOAL_OUTSIDE_MAP;
+    action_server_goal_set_->terminate_current(result);
+  } catch (nav2_core::PlannerTFError & ex) {
+    exceptionWarning(start, first_goal(), goal->planner_id, ex);
+    result->error_code = ActionToPosesResult::TF_ERROR;
+    action_server_goal_set_->terminate_current(result);
+  } catch (nav2_core::NoViapointsGiven & ex) {
+    exceptionWarning(start, first_goal(), goal->planner_id, ex);
+    result->error_code = ActionToPosesResult::NO_VIAPOINTS_GIVEN;
+    action_server_goal_set_->terminate_current(result);
+  } catch (nav2_core::PlannerCancelled &) {
+    RCLCPP_INFO(get_logger(), "Goal was canceled. Canceling planning action.");
+    action_server_goal_set_->terminate_all();
+  } catch (std::exception & ex) {
+    exceptionWarning(start, first_goal(), goal->planner_id, ex);
+    result->error_code = ActionToPosesResult::UNKNOWN;
+    action_server_goal_set_->terminate_current(result);
+  }
+}
+
 nav_msgs::msg::Path
 PlannerServer::getPlan(
   const geometry_msgs::msg::PoseStamped & start,
@@ -597,20 +930,39 @@ PlannerServer::getPlan(
   const std::string & planner_id,
   std::function<bool()> cancel_checker)
 {
+  NAV2_TRACE_SCOPE("PlannerServer::getPlan");
   RCLCPP_DEBUG(
     get_logger(), "Attempting to a find path from (%.2f, %.2f) to "
     "(%.2f, %.2f).", start.pose.position.x, start.pose.position.y,
     goal.pose.position.x, goal.pose.position.y);
 
+  // Reuse a path cached for about the same start and goal if still collision free
+  nav_msgs::msg::Path path;
+  if (path_cache_) {
+    bool found = path_cache_->find(
+      start, goal, planner_id,
+      [this](const nav_msgs::msg::Path & cached_path) {
+        return findPathCollision(cached_path, 0) < 0;
+      }, path);
+    publishPathCacheStats();
+    if (found) {
+      RCLCPP_DEBUG(get_logger(), "Reusing a cached path of size %zu", path.poses.size());
+      path.header.stamp = now();
+      return path;
+    }
+  }
+
   if (planners_.find(planner_id) != planners_.end()) {
-    return planners_[planner_id]->createPlan(start, goal, cancel_checker);
+    path = planWithInstance(planner_id, start, goal, cancel_checker);
+  } else if (planner_races_.find(planner_id) != planner_races_.end()) {
+    path = racePlanners(planner_id, start, goal, cancel_checker);
   } else {
     if (planners_.size() == 1 && planner_id.empty()) {
       RCLCPP_WARN_ONCE(
         get_logger(), "No planners specified in action call. "
         "Server will use only plugin %s in server."
         " This warning will appear once.", planner_ids_concat_.c_str());
-      return planners_[planners_.begin()->first]->createPlan(start, goal, cancel_checker);
+      path = planWithInstance(planners_.begin()->first, start, goal, cancel_checker);
     } else {
       RCLCPP_ERROR(
         get_logger(), "planner %s is not a valid planner. "
@@ -620,15 +972,248 @@ PlannerServer::getPlan(
     }
   }
 
-  return nav_msgs::msg::Path();
+  if (path_cache_ && !path.poses.empty()) {
+    path_cache_->insert(start, goal, planner_id, path);
+  }
+
+  return path;
+}
+
+nav_msgs::msg::Path
+PlannerServer::getPlanToGoalSet(
+  const geometry_msgs::msg::PoseStamped & start,
+  const std::vector<geometry_msgs::msg::PoseStamped> & goals,
+  const std::string & planner_id,
+  std::function<bool()> cancel_checker,
+  size_t & goal_index)
+{
+  NAV2_TRACE_SCOPE("PlannerServer::getPlanToGoalSet");
+  RCLCPP_DEBUG(
+    get_logger(), "Attempting to a find path from (%.2f, %.2f) to the best of %zu goals.",
+    start.pose.position.x, start.pose.position.y, goals.size());
+
+  std::string goal_set_planner_id = planner_id;
+  if (planners_.find(planner_id) == planners_.end()) {
+    if (planners_.size() == 1 && planner_id.empty()) {
+      goal_set_planner_id = planners_.begin()->first;
+    } else {
+      RCLCPP_ERROR(
+        get_logger(), "planner %s is not a valid planner to plan to a goal set. "
+        "Planner names are: %s", planner_id.c_str(),
+        planner_ids_concat_.c_str());
+      throw nav2_core::InvalidPlanner("Planner id " + planner_id + " is invalid");
+    }
+  }
+
+  return callFreeInstance(
+    goal_set_planner_id, cancel_checker,
+    [&](nav2_core::GlobalPlanner & planner) {
+      return planner.createPlanToGoalSet(start, goals, cancel_checker, goal_index);
+    });
+}
+
+nav_msgs::msg::Path
+PlannerServer::planWithInstance(
+  const std::string & planner_id,
+  const geometry_msgs::msg::PoseStamped & start,
+  const geometry_msgs::msg::PoseStamped & goal,
+  std::function<bool()> cancel_checker)
+{
+  return callFreeInstance(
+    planner_id, cancel_checker,
+    [&](nav2_core::GlobalPlanner & planner) {
+      return planner.createPlan(start, goal, cancel_checker);
+    });
+}
+
+nav_msgs::msg::Path
+PlannerServer::callFreeInstance(
+  const std::string & planner_id,
+  std::function<bool()> cancel_checker,
+  const std::function<nav_msgs::msg::Path(nav2_core::GlobalPlanner &)> & plan)
+{
+  auto pool_it = planner_pools_.find(planner_id);
+  if (pool_it == planner_pools_.end()) {
+    return plan(*planners_[planner_id]);
+  }
+
+  // Queue the request until an instance is free, as an instance plans a request at a time
+  PlannerPool & pool = *pool_it->second;
+  size_t index = 0;
+  {
+    std::unique_lock<std::mutex> lock(pool.mutex);
+    while (true) {
+      auto free_it = std::find(pool.busy.begin(), pool.busy.end(), false);
+      if (free_it != pool.busy.end()) {
+        index = static_cast<size_t>(std::distance(pool.busy.begin(), free_it));
+        break;
+      }
+      if (cancel_checker()) {
+        throw nav2_core::PlannerCancelled("Planner " + planner_id + " canceled while queued");
+      }
+      pool.available.wait_for(lock, 10ms);
+    }
+    pool.busy[index] = true;
+  }
+
+  auto release = [&pool, index]() {
+      {
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        pool.busy[index] = false;
+      }
+      pool.available.notify_one();
+    };
+
+  try {
+    nav_msgs::msg::Path path = plan(*pool.instances[index]);
+    release();
+    return path;
+  } catch (...) {
+    release();
+    throw;
+  }
+}
+
+nav_msgs::msg::Path
+PlannerServer::racePlanners(
+  const std::string & race_id,
+  const geometry_msgs::msg::PoseStamped & start,
+  const geometry_msgs::msg::PoseStamped & goal,
+  std::function<bool()> cancel_checker)
+{
+  const std::vector<std::string> & race_planners = planner_races_[race_id];
+
+  // The first planner to find a valid path wins, canceling the others
+  auto winner = std::make_shared<std::atomic<int>>(-1);
+  auto race_cancel_checker = [winner, cancel_checker]() {
+      return winner->load() >= 0 || cancel_checker();
+    };
+
+  std::vector<std::future<nav_msgs::msg::Path>> plans;
+  for (size_t i = 0; i != race_planners.size(); i++) {
+    plans.push_back(
+      std::async(
+        std::launch::async,
+        [this, i, &race_planners, &start, &goal, winner, race_cancel_checker]() {
+          nav_msgs::msg::Path path =
+          planWithInstance(race_planners[i], start, goal, race_cancel_checker);
+          int no_winner = -1;
+          if (!path.poses.empty()) {
+            winner->compare_exchange_strong(no_winner, static_cast<int>(i));
+          }
+          return path;
+        }));
+  }
+
+  nav_msgs::msg::Path path;
+  std::exception_ptr failure;
+  for (size_t i = 0; i != plans.size(); i++) {
+    try {
+      nav_msgs::msg::Path race_path = plans[i].get();
+      if (winner->load() == static_cast<int>(i)) {
+        path = race_path;
+      }
+    } catch (const nav2_core::PlannerCancelled &) {
+      // Canceled when losing the race, or with the request which is checked below
+    } catch (...) {
+      if (!failure) {
+        failure = std::current_exception();
+      }
+    }
+  }
+
+  if (winner->load() >= 0) {
+    RCLCPP_DEBUG(
+      get_logger(), "Planner %s won planner race %s",
+      race_planners[winner->load()].c_str(), race_id.c_str());
+    return path;
+  }
+
+  if (cancel_checker()) {
+    throw nav2_core::PlannerCancelled("Planner race " + race_id + " was canceled");
+  }
+
+  // With no valid path, report the failure of the first listed planner that threw
+  if (failure) {
+    std::rethrow_exception(failure);
+  }
+
+  return path;
+}
+
+std::vector<nav_msgs::msg::Path>
+PlannerServer::planLegsConcurrently(
+  const std::vector<geometry_msgs::msg::PoseStamped> & starts,
+  const std::vector<geometry_msgs::msg::PoseStamped> & goals,
+  const std::string & planner_id,
+  std::function<bool()> cancel_checker,
+  size_t & failed_leg)
+{
+  // A leg failing fails the request, canceling the other legs
+  auto failed = std::make_shared<std::atomic<bool>>(false);
+  auto leg_cancel_checker = [failed, cancel_checker]() {
+      return failed->load() || cancel_checker();
+    };
+
+  std::vector<std::future<nav_msgs::msg::Path>> legs;
+  for (size_t i = 0; i != starts.size(); i++) {
+    legs.push_back(
+      std::async(
+        std::launch::async,
+        [this, i, &starts, &goals, &planner_id, failed, leg_cancel_checker]() {
+          try {
+            nav_msgs::msg::Path path =
+            getPlan(starts[i], goals[i], planner_id, leg_cancel_checker);
+            if (!validatePath<ActionThroughPoses>(goals[i], path, planner_id)) {
+              throw nav2_core::NoValidPathCouldBeFound(planner_id + " generated a empty path");
+            }
+            return path;
+          } catch (...) {
+            failed->store(true);
+            throw;
+          }
+        }));
+  }
+
+  std::vector<nav_msgs::msg::Path> paths(legs.size());
+  std::exception_ptr failure;
+  for (size_t i = 0; i != legs.size(); i++) {
+    try {
+      paths[i] = legs[i].get();
+    } catch (const nav2_core::PlannerCancelled &) {
+      // Canceled by another leg failing, or with the request which is checked below
+    } catch (...) {
+      if (!failure) {
+        failure = std::current_exception();
+        failed_leg = i;
+      }
+    }
+  }
+
+  if (failure) {
+    std::rethrow_exception(failure);
+  }
+
+  if (failed->load()) {
+    throw nav2_core::PlannerCancelled("Planning through poses was canceled");
+  }
+
+  return paths;
 }
 
 void
 PlannerServer::publishPlan(const nav_msgs::msg::Path & path)
 {
-  auto msg = std::make_unique<nav_msgs::msg::Path>(path);
   if (plan_publisher_->is_activated() && plan_publisher_->get_subscription_count() > 0) {
-    plan_publisher_->publish(std::move(msg));
+    plan_publisher_->publish(std::make_unique<nav_msgs::msg::Path>(path));
+  }
+
+  if (compact_plan_publisher_ && compact_plan_publisher_->is_activated() &&
+    compact_plan_publisher_->get_subscription_count() > 0)
+  {
+    auto msg = std::make_unique<nav2_msgs::msg::CompactPath>();
+    nav2_util::toCompactPath(path, *msg);
+    compact_plan_publisher_->publish(std::move(msg));
   }
 }
 
@@ -664,43 +1249,177 @@ void PlannerServer::isPathValid(
 
     /**
      * The lethal check starts at the closest point to avoid points that have already been passed
-     * and may have become occupied. The method for collision detection is based on the shape of
-     * the footprint.
+     * and may have become occupied.
      */
-    std::unique_lock<nav2_costmap_2d::Costmap2D::mutex_t> lock(*(costmap_->getMutex()));
-    unsigned int mx = 0;
-    unsigned int my = 0;
-
-    bool use_radius = costmap_ros_->getUseRadius();
-
-    unsigned int cost = nav2_costmap_2d::FREE_SPACE;
-    for (unsigned int i = closest_point_index; i < request->path.poses.size(); ++i) {
-      auto & position = request->path.poses[i].pose.position;
-      if (use_radius) {
-        if (costmap_->worldToMap(position.x, position.y, mx, my)) {
-          cost = costmap_->getCost(mx, my);
-        } else {
-          cost = nav2_costmap_2d::LETHAL_OBSTACLE;
-        }
-      } else {
-        nav2_costmap_2d::Footprint footprint = costmap_ros_->getRobotFootprint();
-        auto theta = tf2::getYaw(request->path.poses[i].pose.orientation);
-        cost = static_cast<unsigned int>(collision_checker_->footprintCostAtPose(
-            position.x, position.y, theta, footprint));
+    const int invalid_index = findPathCollision(request->path, closest_point_index);
+    if (invalid_index >= 0) {
+      response->is_valid = false;
+      response->invalid_pose_indices.push_back(invalid_index);
+    }
+  }
+}
+
+void PlannerServer::computePath(
+  const std::shared_ptr<rclcpp::Service<nav2_msgs::srv::ComputePath>> service,
+  const std::shared_ptr<rmw_request_id_t> request_header,
+  const std::shared_ptr<nav2_msgs::srv::ComputePath::Request> request)
+{
+  std::lock_guard<std::mutex> lock(path_queries_mutex_);
+  path_queries_.remove_if(
+    [](const std::future<void> & query) {
+      return query.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    });
+  path_queries_.push_back(
+    std::async(
+      std::launch::async, [this, service, request_header, request]() {
+        nav2_msgs::srv::ComputePath::Response response;
+        planPathQuery(*request, response);
+        service->send_response(*request_header, response);
+      }));
+}
+
+void PlannerServer::planPathQuery(
+  const nav2_msgs::srv::ComputePath::Request & request,
+  nav2_msgs::srv::ComputePath::Response & response)
+{
+  using Response = nav2_msgs::srv::ComputePath::Response;
+  auto start_time = this->now();
+  geometry_msgs::msg::PoseStamped start = request.start;
+  geometry_msgs::msg::PoseStamped goal = request.goal;
+
+  // Queries are only canceled by the server deactivating
+  auto cancel_checker = [this]() {
+      return !path_queries_active_;
+    };
+  auto fail = [&](uint16_t error_code, const std::exception & ex) {
+      exceptionWarning(start, goal, request.planner_id, ex);
+      response.error_code = error_code;
+      response.error_msg = ex.what();
+    };
+
+  try {
+    rclcpp::Rate r(100);
+    while (!costmap_ros_->isCurrent()) {
+      if (cancel_checker()) {
+        throw nav2_core::PlannerCancelled("Planner server deactivated");
       }
+      r.sleep();
+    }
 
-      if (use_radius &&
-        (cost == nav2_costmap_2d::LETHAL_OBSTACLE ||
-        cost == nav2_costmap_2d::INSCRIBED_INFLATED_OBSTACLE))
-      {
-        response->is_valid = false;
-        break;
-      } else if (cost == nav2_costmap_2d::LETHAL_OBSTACLE) {
-        response->is_valid = false;
-        break;
+    if (!request.use_start && !costmap_ros_->getRobotPose(start)) {
+      throw nav2_core::PlannerTFError("Unable to get start pose");
+    }
+    if (!transformPosesToGlobalFrame(start, goal)) {
+      throw nav2_core::PlannerTFError("Unable to transform poses to global frame");
+    }
+
+    response.path = getPlan(start, goal, request.planner_id, cancel_checker);
+    if (response.path.poses.empty()) {
+      throw nav2_core::NoValidPathCouldBeFound(request.planner_id + " generated a empty path");
+    }
+    response.planning_time = this->now() - start_time;
+    response.error_code = Response::NONE;
+  } catch (nav2_core::InvalidPlanner & ex) {
+    fail(Response::INVALID_PLANNER, ex);
+  } catch (nav2_core::StartOccupied & ex) {
+    fail(Response::START_OCCUPIED, ex);
+  } catch (nav2_core::GoalOccupied & ex) {
+    fail(Response::GOAL_OCCUPIED, ex);
+  } catch (nav2_core::NoValidPathCouldBeFound & ex) {
+    fail(Response::NO_VALID_PATH, ex);
+  } catch (nav2_core::PlannerTimedOut & ex) {
+    fail(Response::TIMEOUT, ex);
+  } catch (nav2_core::StartOutsideMapBounds & ex) {
+    fail(Response::START_OUTSIDE_MAP, ex);
+  } catch (nav2_core::GoalOutsideMapBounds & ex) {
+    fail(Response::GOAL_OUTSIDE_MAP, ex);
+  } catch (nav2_core::PlannerTFError & ex) {
+    fail(Response::TF_ERROR, ex);
+  } catch (std::exception & ex) {
+    fail(Response::UNKNOWN, ex);
+  }
+}
+
+int PlannerServer::findPathCollision(
+  const nav_msgs::msg::Path & path,
+  unsigned int start_index)
+{
+  // The method for collision detection is based on the shape of the footprint
+  std::unique_lock<nav2_costmap_2d::Costmap2D::mutex_t> lock(*(costmap_->getMutex()));
+  unsigned int mx = 0;
+  unsigned int my = 0;
+
+  bool use_radius = costmap_ros_->getUseRadius();
+  nav2_costmap_2d::Footprint footprint;
+  if (!use_radius) {
+    footprint = costmap_ros_->getRobotFootprint();
+  }
+
+  // Consecutive poses in the same cell, and at the same heading for the footprint
+  // kernels, have the same cost so are only checked once. Exact footprints depend on
+  // the position in the cell, so are checked at each pose.
+  const bool skip_repeated = use_radius || is_path_valid_footprint_headings_ > 0;
+  unsigned int last_mx = std::numeric_limits<unsigned int>::max();
+  unsigned int last_my = std::numeric_limits<unsigned int>::max();
+  unsigned int last_heading = 0;
+
+  unsigned int cost = nav2_costmap_2d::FREE_SPACE;
+  for (unsigned int i = start_index; i < path.poses.size(); ++i) {
+    auto & position = path.poses[i].pose.position;
+    if (!costmap_->worldToMap(position.x, position.y, mx, my)) {
+      return static_cast<int>(i);
+    }
+
+    unsigned int heading = 0;
+    double theta = 0.0;
+    if (!use_radius) {
+      theta = tf2::getYaw(path.poses[i].pose.orientation);
+      if (is_path_valid_footprint_headings_ > 0) {
+        const double turns = theta / (2.0 * M_PI);
+        heading = static_cast<unsigned int>(
+          std::lround((turns - std::floor(turns)) * is_path_valid_footprint_headings_)) %
+          is_path_valid_footprint_headings_;
       }
     }
+
+    if (skip_repeated && mx == last_mx && my == last_my && heading == last_heading) {
+      continue;
+    }
+    last_mx = mx;
+    last_my = my;
+    last_heading = heading;
+
+    if (use_radius) {
+      cost = costmap_->getCost(mx, my);
+    } else {
+      cost = static_cast<unsigned int>(collision_checker_->footprintCostAtPoseQuantized(
+          position.x, position.y, theta, footprint, is_path_valid_footprint_headings_));
+    }
+
+    if (use_radius &&
+      (cost == nav2_costmap_2d::LETHAL_OBSTACLE ||
+      cost == nav2_costmap_2d::INSCRIBED_INFLATED_OBSTACLE))
+    {
+      return static_cast<int>(i);
+    } else if (cost == nav2_costmap_2d::LETHAL_OBSTACLE) {
+      return static_cast<int>(i);
+    }
+  }
+
+  return -1;
+}
+
+void PlannerServer::publishPathCacheStats()
+{
+  if (!path_cache_stats_publisher_ || !path_cache_stats_publisher_->is_activated() ||
+    path_cache_stats_publisher_->get_subscription_count() == 0)
+  {
+    return;
   }
+
+  auto msg = std::make_unique<std_msgs::msg::UInt64MultiArray>();
+  msg->data = {path_cache_->getHits(), path_cache_->getMisses()};
+  path_cache_stats_publisher_->publish(std::move(msg));
 }
 
 rcl_interfaces::msg::SetParametersResult
@@ -724,6 +1443,12 @@ PlannerServer::dynamicParametersCallback(std::vector<rclcpp::Parameter> paramete
           max_planner_duration_ = 0.0;
         }
       }
+    } else if (type == ParameterType::PARAMETER_BOOL) {
+      if (name == "plan_through_poses_concurrently") {
+        plan_through_poses_concurrently_ = parameter.as_bool();
+      } else if (name == "preempt_planning") {
+        preempt_planning_ = parameter.as_bool();
+      }
     }
   }
 
@@ -0,0 +1,286 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License. Reserved.
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "nav2_planner/planner_server.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+using namespace std::chrono_literals;
+
+// Planner taking some time to plan a path of a given size, or failing after it when
+// set to or for goals below the ground
+class FakePlanner : public nav2_core::GlobalPlanner
+{
+public:
+  FakePlanner(
+    std::chrono::milliseconds duration, size_t path_size,
+    std::shared_ptr<std::atomic<int>> active, std::shared_ptr<std::atomic<int>> max_active,
+    bool fail = false)
+  : duration_(duration), path_size_(path_size), active_(active), max_active_(max_active),
+    fail_(fail)
+  {
+  }
+
+  void configure(
+    const rclcpp_lifecycle::LifecycleNode::WeakPtr &, std::string,
+    std::shared_ptr<tf2_ros::Buffer>, std::shared_ptr<nav2_costmap_2d::Costmap2DROS>) override {}
+  void cleanup() override {}
+  void activate() override {}
+  void deactivate() override {}
+
+  nav_msgs::msg::Path createPlan(
+    const geometry_msgs::msg::PoseStamped & start,
+    const geometry_msgs::msg::PoseStamped & goal,
+    std::function<bool()> cancel_checker) override
+  {
+    int active = ++(*active_);
+    int max_active = max_active_->load();
+    while (active > max_active && !max_active_->compare_exchange_weak(max_active, active)) {
+    }
+
+    auto end = std::chrono::steady_clock::now() + duration_;
+    while (std::chrono::steady_clock::now() < end) {
+      if (cancel_checker()) {
+        --(*active_);
+        throw nav2_core::PlannerCancelled("Canceled");
+      }
+      std::this_thread::sleep_for(1ms);
+    }
+    --(*active_);
+
+    if (fail_ || goal.pose.position.z < 0.0) {
+      throw nav2_core::GoalOccupied("Goal occupied");
+    }
+    nav_msgs::msg::Path path;
+    path.poses.resize(path_size_, start);
+    path.poses.back() = goal;
+    return path;
+  }
+
+protected:
+  std::chrono::milliseconds duration_;
+  size_t path_size_;
+  std::shared_ptr<std::atomic<int>> active_;
+  std::shared_ptr<std::atomic<int>> max_active_;
+  bool fail_;
+};
+
+class PlannerShim : public nav2_planner::PlannerServer
+{
+public:
+  PlannerShim()
+  : nav2_planner::PlannerServer(rclcpp::NodeOptions())
+  {
+  }
+
+  // Since we cannot call configure/activate due to costmaps
+  // requiring TF
+  void addPlanner(
+    const std::string & planner_id, std::vector<nav2_core::GlobalPlanner::Ptr> instances)
+  {
+    auto pool = std::make_shared<PlannerPool>();
+    pool->instances = instances;
+    pool->busy.resize(instances.size(), false);
+    planners_[planner_id] = instances.front();
+    planner_pools_[planner_id] = pool;
+  }
+
+  void addRace(const std::string & race_id, const std::vector<std::string> & race_planners)
+  {
+    planner_races_[race_id] = race_planners;
+  }
+
+  std::vector<nav_msgs::msg::Path> planLegs(
+    const std::vector<geometry_msgs::msg::PoseStamped> & starts,
+    const std::vector<geometry_msgs::msg::PoseStamped> & goals,
+    const std::string & planner_id, size_t & failed_leg)
+  {
+    return planLegsConcurrently(
+      starts, goals, planner_id, []() {return false;}, failed_leg);
+  }
+};
+
+class RclCppFixture
+{
+public:
+  RclCppFixture() {rclcpp::init(0, nullptr);}
+  ~RclCppFixture() {rclcpp::shutdown();}
+};
+RclCppFixture g_rclcppfixture;
+
+TEST(PlannerServerTest, test_planner_instances)
+{
+  auto active = std::make_shared<std::atomic<int>>(0);
+  auto max_active = std::make_shared<std::atomic<int>>(0);
+  auto single_max_active = std::make_shared<std::atomic<int>>(0);
+  auto planner = std::make_shared<PlannerShim>();
+  planner->addPlanner(
+    "Pooled", {std::make_shared<FakePlanner>(200ms, 3, active, max_active),
+      std::make_shared<FakePlanner>(200ms, 3, active, max_active)});
+  planner->addPlanner(
+    "Single", {std::make_shared<FakePlanner>(200ms, 3, active, single_max_active)});
+
+  geometry_msgs::msg::PoseStamped start, goal;
+  goal.pose.position.x = 1.0;
+  auto plan = [&](const std::string & planner_id, std::function<bool()> cancel_checker) {
+      return std::async(
+        std::launch::async, [&, planner_id, cancel_checker]() {
+          return planner->getPlan(start, goal, planner_id, cancel_checker);
+        });
+    };
+  auto not_canceled = []() {return false;};
+
+  // Requests to a planner run concurrently on its instances
+  auto first = plan("Pooled", not_canceled);
+  auto second = plan("Pooled", not_canceled);
+  EXPECT_EQ(first.get().poses.size(), 3u);
+  EXPECT_EQ(second.get().poses.size(), 3u);
+  EXPECT_EQ(max_active->load(), 2);
+
+  // Or are queued with a single instance
+  first = plan("Single", not_canceled);
+  second = plan("Single", not_canceled);
+  EXPECT_EQ(first.get().poses.size(), 3u);
+  EXPECT_EQ(second.get().poses.size(), 3u);
+  EXPECT_EQ(single_max_active->load(), 1);
+
+  // Where they can be canceled before planning
+  auto canceled = std::make_shared<std::atomic<bool>>(false);
+  first = plan("Single", not_canceled);
+  std::this_thread::sleep_for(50ms);
+  second = plan("Single", [canceled]() {return canceled->load();});
+  canceled->store(true);
+  EXPECT_THROW(second.get(), nav2_core::PlannerCancelled);
+  EXPECT_EQ(first.get().poses.size(), 3u);
+}
+
+TEST(PlannerServerTest, test_planner_races)
+{
+  auto active = std::make_shared<std::atomic<int>>(0);
+  auto max_active = std::make_shared<std::atomic<int>>(0);
+  auto planner = std::make_shared<PlannerShim>();
+  planner->addPlanner("Fast", {std::make_shared<FakePlanner>(10ms, 2, active, max_active)});
+  planner->addPlanner("Slow", {std::make_shared<FakePlanner>(5000ms, 5, active, max_active)});
+  planner->addPlanner(
+    "Failing", {std::make_shared<FakePlanner>(10ms, 2, active, max_active, true)});
+  planner->addRace("Race", {"Slow", "Fast"});
+  planner->addRace("FailingRace", {"Failing", "Failing"});
+  planner->addRace("SlowRace", {"Slow", "Failing"});
+
+  geometry_msgs::msg::PoseStamped start, goal;
+  goal.pose.position.x = 1.0;
+
+  // The first valid path wins, canceling the slower planners
+  auto start_time = std::chrono::steady_clock::now();
+  auto path = planner->getPlan(start, goal, "Race", []() {return false;});
+  EXPECT_EQ(path.poses.size(), 2u);
+  EXPECT_LT(std::chrono::steady_clock::now() - start_time, 2s);
+  EXPECT_EQ(active->load(), 0);
+
+  // Failures are reported when no planner finds a path
+  EXPECT_THROW(
+    planner->getPlan(start, goal, "FailingRace", []() {return false;}),
+    nav2_core::GoalOccupied);
+
+  // Canceling the request cancels all planners
+  start_time = std::chrono::steady_clock::now();
+  EXPECT_THROW(
+    planner->getPlan(start, goal, "SlowRace", [start_time]() {
+      return std::chrono::steady_clock::now() - start_time > 100ms;
+    }),
+    nav2_core::PlannerCancelled);
+  EXPECT_LT(std::chrono::steady_clock::now() - start_time, 2s);
+
+  EXPECT_THROW(
+    planner->getPlan(start, goal, "Missing", []() {return false;}),
+    nav2_core::InvalidPlanner);
+}
+
+TEST(PlannerServerTest, test_concurrent_legs)
+{
+  auto active = std::make_shared<std::atomic<int>>(0);
+  auto max_active = std::make_shared<std::atomic<int>>(0);
+  auto planner = std::make_shared<PlannerShim>();
+  std::vector<nav2_core::GlobalPlanner::Ptr> instances;
+  for (unsigned int i = 0; i != 4; i++) {
+    instances.push_back(std::make_shared<FakePlanner>(200ms, 3, active, max_active));
+  }
+  planner->addPlanner("Pooled", instances);
+
+  std::vector<geometry_msgs::msg::PoseStamped> starts(4), goals(4);
+  for (unsigned int i = 0; i != 4; i++) {
+    starts[i].pose.position.x = i;
+    goals[i].pose.position.x = i + 1;
+  }
+
+  // The legs are planned concurrently and returned in order
+  size_t failed_leg = 0;
+  auto paths = planner->planLegs(starts, goals, "Pooled", failed_leg);
+  ASSERT_EQ(paths.size(), 4u);
+  for (unsigned int i = 0; i != 4; i++) {
+    EXPECT_EQ(paths[i].poses.front().pose.position.x, i);
+    EXPECT_EQ(paths[i].poses.back().pose.position.x, i + 1);
+  }
+  EXPECT_EQ(max_active->load(), 4);
+
+  // A leg failing fails all and is reported
+  goals[2].pose.position.z = -1.0;
+  EXPECT_THROW(
+    planner->planLegs(starts, goals, "Pooled", failed_leg), nav2_core::GoalOccupied);
+  EXPECT_EQ(failed_leg, 2u);
+  EXPECT_EQ(active->load(), 0);
+}
+
+TEST(PlannerServerTest, test_goal_set)
+{
+  auto active = std::make_shared<std::atomic<int>>(0);
+  auto max_active = std::make_shared<std::atomic<int>>(0);
+  auto planner = std::make_shared<PlannerShim>();
+  planner->addPlanner("Fast", {std::make_shared<FakePlanner>(10ms, 3, active, max_active)});
+  planner->addRace("Race", {"Fast", "Fast"});
+
+  geometry_msgs::msg::PoseStamped start;
+  std::vector<geometry_msgs::msg::PoseStamped> goals(3);
+  goals[0].pose.position.x = 5.0;
+  goals[1].pose.position.x = 2.0;
+  goals[2].pose.position.x = 1.0;
+  goals[2].pose.position.z = -1.0;
+
+  // The shortest path to a goal reached is kept, failing goals are skipped
+  size_t goal_index = 0;
+  auto path = planner->getPlanToGoalSet(start, goals, "Fast", []() {return false;}, goal_index);
+  EXPECT_EQ(goal_index, 1u);
+  ASSERT_EQ(path.poses.size(), 3u);
+  EXPECT_EQ(path.poses.back().pose.position.x, 2.0);
+
+  // Failures are reported when no goal is reached
+  goals[0].pose.position.z = -1.0;
+  goals[1].pose.position.z = -1.0;
+  EXPECT_THROW(
+    planner->getPlanToGoalSet(start, goals, "Fast", []() {return false;}, goal_index),
+    nav2_core::GoalOccupied);
+
+  // Races of planners do not plan to goal sets
+  EXPECT_THROW(
+    planner->getPlanToGoalSet(start, goals, "Race", []() {return false;}, goal_index),
+    nav2_core::InvalidPlanner);
+}
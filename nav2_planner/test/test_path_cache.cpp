@@ -0,0 +1,108 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License. Reserved.
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "nav2_util/geometry_utils.hpp"
+#include "nav2_planner/path_cache.hpp"
+
+geometry_msgs::msg::PoseStamped makePose(double x, double y, double yaw)
+{
+  geometry_msgs::msg::PoseStamped pose;
+  pose.pose.position.x = x;
+  pose.pose.position.y = y;
+  pose.pose.orientation = nav2_util::geometry_utils::orientationAroundZAxis(yaw);
+  return pose;
+}
+
+nav_msgs::msg::Path makePath(size_t size)
+{
+  nav_msgs::msg::Path path;
+  path.poses.resize(size);
+  return path;
+}
+
+TEST(PathCacheTest, test_path_cache)
+{
+  nav2_planner::PathCache cache(0.1, 0.1, 2);
+  auto valid = [](const nav_msgs::msg::Path &) {return true;};
+  auto invalid = [](const nav_msgs::msg::Path &) {return false;};
+  nav_msgs::msg::Path path;
+
+  EXPECT_FALSE(cache.find(makePose(0, 0, 0), makePose(5, 5, 0), "GridBased", valid, path));
+  cache.insert(makePose(0, 0, 0), makePose(5, 5, 0), "GridBased", makePath(3));
+  EXPECT_EQ(cache.size(), 1u);
+
+  // Starts and goals within the resolution share the path, for the same planner only
+  EXPECT_TRUE(
+    cache.find(makePose(0.02, -0.03, 0.02), makePose(5.04, 5, -0.02), "GridBased", valid, path));
+  EXPECT_EQ(path.poses.size(), 3u);
+  EXPECT_FALSE(cache.find(makePose(0.2, 0, 0), makePose(5, 5, 0), "GridBased", valid, path));
+  EXPECT_FALSE(cache.find(makePose(0, 0, 0.2), makePose(5, 5, 0), "GridBased", valid, path));
+  EXPECT_FALSE(cache.find(makePose(0, 0, 0), makePose(5, 5, 0), "Other", valid, path));
+
+  // Headings either side of the wrap share their path
+  cache.insert(makePose(0, 0, -0.03), makePose(1, 1, 0), "GridBased", makePath(4));
+  EXPECT_TRUE(cache.find(makePose(0, 0, 0.03), makePose(1, 1, 0), "GridBased", valid, path));
+  EXPECT_EQ(path.poses.size(), 4u);
+  EXPECT_EQ(cache.getHits(), 2u);
+  EXPECT_EQ(cache.getMisses(), 4u);
+
+  // The least recently used path is evicted
+  cache.insert(makePose(2, 2, 0), makePose(3, 3, 0), "GridBased", makePath(5));
+  EXPECT_EQ(cache.size(), 2u);
+  EXPECT_FALSE(cache.find(makePose(0, 0, 0), makePose(5, 5, 0), "GridBased", valid, path));
+  EXPECT_TRUE(cache.find(makePose(2, 2, 0), makePose(3, 3, 0), "GridBased", valid, path));
+  EXPECT_EQ(path.poses.size(), 5u);
+
+  // Paths no longer valid are dropped
+  EXPECT_FALSE(cache.find(makePose(2, 2, 0), makePose(3, 3, 0), "GridBased", invalid, path));
+  EXPECT_EQ(cache.size(), 1u);
+  EXPECT_FALSE(cache.find(makePose(2, 2, 0), makePose(3, 3, 0), "GridBased", valid, path));
+
+  cache.clear();
+  EXPECT_EQ(cache.size(), 0u);
+}
+
+TEST(PathCacheTest, test_path_cache_endpoints)
+{
+  nav2_planner::PathCache cache(0.1, 0.1, 2);
+  nav_msgs::msg::Path planned = makePath(3);
+  planned.poses[0] = makePose(0, 0, 0);
+  planned.poses[1] = makePose(2.5, 2.5, 0.5);
+  planned.poses[2] = makePose(5, 5, 0);
+  cache.insert(makePose(0, 0, 0), makePose(5, 5, 0), "GridBased", planned);
+
+  // A hit starts and ends exactly at the start and goal requested, which are checked
+  auto start = makePose(0.02, -0.03, 0.02);
+  auto goal = makePose(5.04, 5, -0.02);
+  nav_msgs::msg::Path checked, path;
+  auto valid = [&checked](const nav_msgs::msg::Path & candidate) {
+      checked = candidate;
+      return true;
+    };
+  ASSERT_TRUE(cache.find(start, goal, "GridBased", valid, path));
+  ASSERT_EQ(path.poses.size(), 3u);
+  EXPECT_EQ(path.poses.front().pose, start.pose);
+  EXPECT_EQ(path.poses[1].pose, planned.poses[1].pose);
+  EXPECT_EQ(path.poses.back().pose, goal.pose);
+  EXPECT_EQ(checked, path);
+
+  // The cached path is unchanged, for other starts and goals
+  auto other_goal = makePose(4.96, 5.02, 0.01);
+  ASSERT_TRUE(cache.find(makePose(0, 0, 0), other_goal, "GridBased", valid, path));
+  EXPECT_EQ(path.poses.front().pose, planned.poses[0].pose);
+  EXPECT_EQ(path.poses.back().pose, other_goal.pose);
+}
@@ -15,6 +15,7 @@
 #ifndef NAV2_REGULATED_PURE_PURSUIT_CONTROLLER__COLLISION_CHECKER_HPP_
 #define NAV2_REGULATED_PURE_PURSUIT_CONTROLLER__COLLISION_CHECKER_HPP_
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <memory>
@@ -23,6 +24,7 @@
 
 #include "rclcpp/rclcpp.hpp"
 #include "nav2_costmap_2d/costmap_2d_ros.hpp"
+#include "nav2_costmap_2d/cost_pyramid.hpp"
 #include "nav2_costmap_2d/footprint_collision_checker.hpp"
 #include "nav2_util/odometry_utils.hpp"
 #include "geometry_msgs/msg/pose2_d.hpp"
@@ -90,6 +92,26 @@ public:
   double costAtPose(const double & x, const double & y);
 
 protected:
+  /**
+   * @brief checks for collision of a footprint at projected pose
+   * @param x Pose of pose x
+   * @param y Pose of pose y
+   * @param theta orientation of Yaw
+   * @param footprint Unoriented footprint of the robot
+   * @return Whether in collision
+   */
+  bool inCollision(
+    const double & x,
+    const double & y,
+    const double & theta,
+    const nav2_costmap_2d::Footprint & footprint);
+
+  /**
+   * @brief Update the cost pyramid with the costmap cells changed since its last update,
+   * if it is used
+   */
+  void updateCostPyramid();
+
   rclcpp::Logger logger_ {rclcpp::get_logger("RPPCollisionChecker")};
   std::shared_ptr<nav2_costmap_2d::Costmap2DROS> costmap_ros_;
   nav2_costmap_2d::Costmap2D * costmap_;
@@ -98,6 +120,15 @@ protected:
   Parameters * params_;
   std::shared_ptr<rclcpp_lifecycle::LifecyclePublisher<nav_msgs::msg::Path>> carrot_arc_pub_;
   rclcpp::Clock::SharedPtr clock_;
+
+  // Projected poses of the arc in the robot's frame, for the distance and rotation of each step
+  std::vector<geometry_msgs::msg::Pose2D> arc_;
+  double arc_step_distance_{0.0};
+  double arc_step_rotation_{0.0};
+
+  // Maximum costs over blocks of the costmap, to skip checking footprints far from obstacles
+  nav2_costmap_2d::CostPyramid cost_pyramid_;
+  uint64_t cost_pyramid_update_count_{0};
 };
 
 }  // namespace nav2_regulated_pure_pursuit_controller
@@ -42,6 +42,9 @@ struct Parameters
   double min_approach_linear_velocity;
   double approach_velocity_scaling_dist;
   double max_allowed_time_to_collision_up_to_carrot;
+  double collision_arc_curvature_tolerance;
+  int collision_check_headings;
+  bool use_cost_pyramid;
   bool use_regulated_linear_velocity_scaling;
   bool use_cost_regulated_linear_velocity_scaling;
   double cost_scaling_dist;
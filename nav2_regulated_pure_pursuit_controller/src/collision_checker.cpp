@@ -40,6 +40,7 @@ CollisionChecker::CollisionChecker(
   footprint_collision_checker_ = std::make_unique<nav2_costmap_2d::
       FootprintCollisionChecker<nav2_costmap_2d::Costmap2D *>>(costmap_);
   footprint_collision_checker_->setCostmap(costmap_);
+  footprint_collision_checker_->setCostPyramid(&cost_pyramid_);
 
   carrot_arc_pub_ = node->create_publisher<nav_msgs::msg::Path>("lookahead_collision_arc", 1);
   carrot_arc_pub_->on_activate();
@@ -53,21 +54,26 @@ bool CollisionChecker::isCollisionImminent(
   // Note(stevemacenski): This may be a bit unusual, but the robot_pose is in
   // odom frame and the carrot_pose is in robot base frame. Just how the data comes to us
 
+  updateCostPyramid();
+
   // check current point is OK
-  if (inCollision(
-      robot_pose.pose.position.x, robot_pose.pose.position.y,
-      tf2::getYaw(robot_pose.pose.orientation)))
-  {
+  const Footprint footprint = costmap_ros_->getRobotFootprint();
+  const geometry_msgs::msg::Point & robot_xy = robot_pose.pose.position;
+  const double robot_yaw = tf2::getYaw(robot_pose.pose.orientation);
+  if (inCollision(robot_xy.x, robot_xy.y, robot_yaw, footprint)) {
     return true;
   }
 
-  // visualization messages
+  // visualization messages, only built for subscribers
+  const bool publish_arc = carrot_arc_pub_->get_subscription_count() > 0;
   nav_msgs::msg::Path arc_pts_msg;
-  arc_pts_msg.header.frame_id = costmap_ros_->getGlobalFrameID();
-  arc_pts_msg.header.stamp = robot_pose.header.stamp;
   geometry_msgs::msg::PoseStamped pose_msg;
-  pose_msg.header.frame_id = arc_pts_msg.header.frame_id;
-  pose_msg.header.stamp = arc_pts_msg.header.stamp;
+  if (publish_arc) {
+    arc_pts_msg.header.frame_id = costmap_ros_->getGlobalFrameID();
+    arc_pts_msg.header.stamp = robot_pose.header.stamp;
+    pose_msg.header.frame_id = arc_pts_msg.header.frame_id;
+    pose_msg.header.stamp = arc_pts_msg.header.stamp;
+  }
 
   double projection_time = 0.0;
   if (fabs(linear_vel) < 0.01 && fabs(angular_vel) > 0.01) {
@@ -85,41 +91,68 @@ bool CollisionChecker::isCollisionImminent(
     projection_time = costmap_->getResolution() / fabs(linear_vel);
   }
 
-  const geometry_msgs::msg::Point & robot_xy = robot_pose.pose.position;
+  // The projected poses relative to the robot only depend on the distance and rotation
+  // of each step, so the arc of the last cycle is reused while the distance is the same
+  // and the curvature changed less than the tolerance
+  const double step_distance = projection_time * linear_vel;
+  const double step_rotation = projection_time * angular_vel;
+  if (fabs(step_distance - arc_step_distance_) > 1e-6 * fabs(step_distance) ||
+    fabs(step_rotation - arc_step_rotation_) >
+    params_->collision_arc_curvature_tolerance * fabs(step_distance))
+  {
+    arc_.clear();
+    arc_step_distance_ = step_distance;
+    arc_step_rotation_ = step_rotation;
+  }
+
+  const double cos_yaw = cos(robot_yaw);
+  const double sin_yaw = sin(robot_yaw);
   geometry_msgs::msg::Pose2D curr_pose;
-  curr_pose.x = robot_pose.pose.position.x;
-  curr_pose.y = robot_pose.pose.position.y;
-  curr_pose.theta = tf2::getYaw(robot_pose.pose.orientation);
 
   // only forward simulate within time requested
-  int i = 1;
+  unsigned int i = 1;
   while (i * projection_time < params_->max_allowed_time_to_collision_up_to_carrot) {
     i++;
 
-    // apply velocity at curr_pose over distance
-    curr_pose.x += projection_time * (linear_vel * cos(curr_pose.theta));
-    curr_pose.y += projection_time * (linear_vel * sin(curr_pose.theta));
-    curr_pose.theta += projection_time * angular_vel;
+    // apply velocity at the last pose of the arc over distance
+    if (arc_.size() < i - 1) {
+      geometry_msgs::msg::Pose2D step = arc_.empty() ? geometry_msgs::msg::Pose2D() : arc_.back();
+      step.x += arc_step_distance_ * cos(step.theta);
+      step.y += arc_step_distance_ * sin(step.theta);
+      step.theta += arc_step_rotation_;
+      arc_.push_back(step);
+    }
+    const geometry_msgs::msg::Pose2D & step = arc_[i - 2];
 
     // check if past carrot pose, where no longer a thoughtfully valid command
-    if (hypot(curr_pose.x - robot_xy.x, curr_pose.y - robot_xy.y) > carrot_dist) {
+    if (hypot(step.x, step.y) > carrot_dist) {
       break;
     }
 
+    curr_pose.x = robot_xy.x + step.x * cos_yaw - step.y * sin_yaw;
+    curr_pose.y = robot_xy.y + step.x * sin_yaw + step.y * cos_yaw;
+    curr_pose.theta = robot_yaw + step.theta;
+
     // store it for visualization
-    pose_msg.pose.position.x = curr_pose.x;
-    pose_msg.pose.position.y = curr_pose.y;
-    pose_msg.pose.position.z = 0.01;
-    arc_pts_msg.poses.push_back(pose_msg);
+    if (publish_arc) {
+      pose_msg.pose.position.x = curr_pose.x;
+      pose_msg.pose.position.y = curr_pose.y;
+      pose_msg.pose.position.z = 0.01;
+      arc_pts_msg.poses.push_back(pose_msg);
+    }
 
     // check for collision at the projected pose
-    if (inCollision(curr_pose.x, curr_pose.y, curr_pose.theta)) {
-      carrot_arc_pub_->publish(arc_pts_msg);
+    if (inCollision(curr_pose.x, curr_pose.y, curr_pose.theta, footprint)) {
+      if (publish_arc) {
+        carrot_arc_pub_->publish(arc_pts_msg);
+      }
       return true;
     }
   }
 
-  carrot_arc_pub_->publish(arc_pts_msg);
+  if (publish_arc) {
+    carrot_arc_pub_->publish(arc_pts_msg);
+  }
 
   return false;
 }
@@ -128,6 +161,16 @@ bool CollisionChecker::inCollision(
   const double & x,
   const double & y,
   const double & theta)
+{
+  updateCostPyramid();
+  return inCollision(x, y, theta, costmap_ros_->getRobotFootprint());
+}
+
+bool CollisionChecker::inCollision(
+  const double & x,
+  const double & y,
+  const double & theta,
+  const Footprint & footprint)
 {
   unsigned int mx, my;
 
@@ -140,8 +183,19 @@ bool CollisionChecker::inCollision(
     return false;
   }
 
-  double footprint_cost = footprint_collision_checker_->footprintCostAtPose(
-    x, y, theta, costmap_ros_->getRobotFootprint());
+  // Footprints whose bounding box is below lethal cannot be in collision
+  const unsigned int num_headings = std::max(params_->collision_check_headings, 0);
+  if (params_->use_cost_pyramid &&
+    footprint_collision_checker_->isFootprintBoxBelowCost(
+      x, y, theta, footprint, LETHAL_OBSTACLE, num_headings))
+  {
+    return false;
+  }
+
+  double footprint_cost = params_->collision_check_headings > 0 ?
+    footprint_collision_checker_->footprintCostAtPoseQuantized(
+    x, y, theta, footprint, params_->collision_check_headings) :
+    footprint_collision_checker_->footprintCostAtPose(x, y, theta, footprint);
   if (footprint_cost == static_cast<double>(NO_INFORMATION) &&
     costmap_ros_->getLayeredCostmap()->isTrackingUnknown())
   {
@@ -153,6 +207,26 @@ bool CollisionChecker::inCollision(
 }
 
 
+void CollisionChecker::updateCostPyramid()
+{
+  if (!params_->use_cost_pyramid) {
+    return;
+  }
+
+  // Only the blocks of the cells changed since the last update are recomputed
+  nav2_costmap_2d::LayeredCostmap * layered_costmap = costmap_ros_->getLayeredCostmap();
+  const uint64_t update_count = layered_costmap->getUpdateCount();
+  unsigned int x0, xn, y0, yn;
+  if (!cost_pyramid_.isInitialized() ||
+    !layered_costmap->getUpdatedWindowSince(cost_pyramid_update_count_, x0, xn, y0, yn))
+  {
+    cost_pyramid_.update(*costmap_);
+  } else {
+    cost_pyramid_.update(*costmap_, x0, xn, y0, yn);
+  }
+  cost_pyramid_update_count_ = update_count;
+}
+
 double CollisionChecker::costAtPose(const double & x, const double & y)
 {
   unsigned int mx, my;
@@ -60,6 +60,12 @@ ParameterHandler::ParameterHandler(
   declare_parameter_if_not_declared(
     node, plugin_name_ + ".max_allowed_time_to_collision_up_to_carrot",
     rclcpp::ParameterValue(1.0));
+  declare_parameter_if_not_declared(
+    node, plugin_name_ + ".collision_arc_curvature_tolerance", rclcpp::ParameterValue(0.0));
+  declare_parameter_if_not_declared(
+    node, plugin_name_ + ".collision_check_headings", rclcpp::ParameterValue(0));
+  declare_parameter_if_not_declared(
+    node, plugin_name_ + ".use_cost_pyramid", rclcpp::ParameterValue(false));
   declare_parameter_if_not_declared(
     node, plugin_name_ + ".use_regulated_linear_velocity_scaling", rclcpp::ParameterValue(true));
   declare_parameter_if_not_declared(
@@ -128,6 +134,13 @@ ParameterHandler::ParameterHandler(
   node->get_parameter(
     plugin_name_ + ".max_allowed_time_to_collision_up_to_carrot",
     params_.max_allowed_time_to_collision_up_to_carrot);
+  node->get_parameter(
+    plugin_name_ + ".collision_arc_curvature_tolerance",
+    params_.collision_arc_curvature_tolerance);
+  node->get_parameter(
+    plugin_name_ + ".collision_check_headings",
+    params_.collision_check_headings);
+  node->get_parameter(plugin_name_ + ".use_cost_pyramid", params_.use_cost_pyramid);
   node->get_parameter(
     plugin_name_ + ".use_regulated_linear_velocity_scaling",
     params_.use_regulated_linear_velocity_scaling);
@@ -233,6 +246,8 @@ ParameterHandler::dynamicParametersCallback(
         params_.curvature_lookahead_dist = parameter.as_double();
       } else if (name == plugin_name_ + ".max_allowed_time_to_collision_up_to_carrot") {
         params_.max_allowed_time_to_collision_up_to_carrot = parameter.as_double();
+      } else if (name == plugin_name_ + ".collision_arc_curvature_tolerance") {
+        params_.collision_arc_curvature_tolerance = parameter.as_double();
       } else if (name == plugin_name_ + ".cost_scaling_dist") {
         params_.cost_scaling_dist = parameter.as_double();
       } else if (name == plugin_name_ + ".cost_scaling_gain") {
@@ -259,6 +274,8 @@ ParameterHandler::dynamicParametersCallback(
         params_.use_cost_regulated_linear_velocity_scaling = parameter.as_bool();
       } else if (name == plugin_name_ + ".use_collision_detection") {
         params_.use_collision_detection = parameter.as_bool();
+      } else if (name == plugin_name_ + ".use_cost_pyramid") {
+        params_.use_cost_pyramid = parameter.as_bool();
       } else if (name == plugin_name_ + ".use_rotate_to_heading") {
         params_.use_rotate_to_heading = parameter.as_bool();
       } else if (name == plugin_name_ + ".use_cancel_deceleration") {
@@ -272,6 +289,10 @@ ParameterHandler::dynamicParametersCallback(
         }
         params_.allow_reversing = parameter.as_bool();
       }
+    } else if (type == ParameterType::PARAMETER_INTEGER) {
+      if (name == plugin_name_ + ".collision_check_headings") {
+        params_.collision_check_headings = parameter.as_int();
+      }
     }
   }
 
@@ -701,6 +701,8 @@ TEST(RegulatedPurePursuitTest, testDynamicParameter)
       rclcpp::Parameter("test.rotate_to_heading_angular_vel", 18.0),
       rclcpp::Parameter("test.min_approach_linear_velocity", 1.0),
       rclcpp::Parameter("test.max_allowed_time_to_collision_up_to_carrot", 2.0),
+      rclcpp::Parameter("test.collision_arc_curvature_tolerance", 0.1),
+      rclcpp::Parameter("test.collision_check_headings", 36),
       rclcpp::Parameter("test.cost_scaling_dist", 2.0),
       rclcpp::Parameter("test.cost_scaling_gain", 4.0),
       rclcpp::Parameter("test.regulated_linear_scaling_min_radius", 10.0),
@@ -729,6 +731,8 @@ TEST(RegulatedPurePursuitTest, testDynamicParameter)
   EXPECT_EQ(
     node->get_parameter(
       "test.max_allowed_time_to_collision_up_to_carrot").as_double(), 2.0);
+  EXPECT_EQ(node->get_parameter("test.collision_arc_curvature_tolerance").as_double(), 0.1);
+  EXPECT_EQ(node->get_parameter("test.collision_check_headings").as_int(), 36);
   EXPECT_EQ(node->get_parameter("test.cost_scaling_dist").as_double(), 2.0);
   EXPECT_EQ(node->get_parameter("test.cost_scaling_gain").as_double(), 4.0);
   EXPECT_EQ(node->get_parameter("test.regulated_linear_scaling_min_radius").as_double(), 10.0);
@@ -770,6 +774,43 @@ TEST(RegulatedPurePursuitTest, testDynamicParameter)
     results4);
 }
 
+TEST(RegulatedPurePursuitTest, collisionImminent)
+{
+  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("testRPPCollision");
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>("fake_costmap");
+  costmap_ros->on_configure(rclcpp_lifecycle::State());
+  auto costmap = costmap_ros->getCostmap();
+
+  nav2_regulated_pure_pursuit_controller::Parameters params;
+  params.max_allowed_time_to_collision_up_to_carrot = 1.0;
+  params.collision_arc_curvature_tolerance = 0.0;
+  params.collision_check_headings = 0;
+  nav2_regulated_pure_pursuit_controller::CollisionChecker checker(node, costmap_ros, &params);
+
+  geometry_msgs::msg::PoseStamped pose;
+  pose.pose.position.x = 1.0;
+  pose.pose.position.y = 2.5;
+  pose.pose.orientation.w = 1.0;
+  EXPECT_FALSE(checker.isCollisionImminent(pose, 0.5, 0.0, 1.0));
+
+  // An obstacle ahead, checked on a new arc and then on the reused arc as the robot moves
+  costmap->setCost(15, 25, nav2_costmap_2d::LETHAL_OBSTACLE);
+  EXPECT_TRUE(checker.isCollisionImminent(pose, 0.5, 0.0, 1.0));
+  pose.pose.position.x = 1.2;
+  EXPECT_TRUE(checker.isCollisionImminent(pose, 0.5, 0.0, 1.0));
+
+  // Beyond the carrot, or away from a sharp turn, the obstacle is not reached
+  EXPECT_FALSE(checker.isCollisionImminent(pose, 0.5, 0.0, 0.1));
+  EXPECT_FALSE(checker.isCollisionImminent(pose, 0.5, -3.0, 1.0));
+  EXPECT_TRUE(checker.isCollisionImminent(pose, 0.5, 0.0, 1.0));
+
+  // The same with the precomputed footprint outlines
+  params.collision_check_headings = 72;
+  EXPECT_TRUE(checker.isCollisionImminent(pose, 0.5, 0.0, 1.0));
+  costmap->setCost(15, 25, nav2_costmap_2d::FREE_SPACE);
+  EXPECT_FALSE(checker.isCollisionImminent(pose, 0.5, 0.0, 1.0));
+}
+
 class TransformGlobalPlanTest : public ::testing::Test
 {
 protected:
@@ -30,6 +30,8 @@
 #include "nav2_core/controller_exceptions.hpp"
 #include "nav2_util/node_utils.hpp"
 #include "nav2_costmap_2d/footprint_collision_checker.hpp"
+#include "nav2_costmap_2d/cost_pyramid.hpp"
+#include "nav2_rotation_shim_controller/rotation_sweep_cache.hpp"
 #include "angles/angles.h"
 
 namespace nav2_rotation_shim_controller
@@ -152,6 +154,11 @@ protected:
     const double & angular_distance_to_heading,
     const geometry_msgs::msg::PoseStamped & pose);
 
+  /**
+   * @brief Recompute the blocks of the cost pyramid changed since its last update
+   */
+  void updateCostPyramid();
+
   /**
    * @brief Callback executed when a parameter change is detected
    * @param event ParameterEvent message
@@ -176,6 +183,11 @@ protected:
   double rotate_to_heading_angular_vel_, max_angular_accel_;
   double control_duration_, simulate_ahead_time_;
   bool rotate_to_goal_heading_;
+  bool use_rotation_sweep_cache_;
+
+  RotationSweepCache rotation_sweep_cache_;
+  nav2_costmap_2d::CostPyramid cost_pyramid_;
+  uint64_t cost_pyramid_update_count_{0};
 
   // Dynamic parameters handler
   std::mutex mutex_;
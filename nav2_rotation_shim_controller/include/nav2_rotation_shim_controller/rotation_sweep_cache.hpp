@@ -0,0 +1,109 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_ROTATION_SHIM_CONTROLLER__ROTATION_SWEEP_CACHE_HPP_
+#define NAV2_ROTATION_SHIM_CONTROLLER__ROTATION_SWEEP_CACHE_HPP_
+
+#include <vector>
+
+#include "nav2_costmap_2d/costmap_2d.hpp"
+#include "nav2_costmap_2d/cost_pyramid.hpp"
+#include "nav2_costmap_2d/footprint.hpp"
+
+namespace nav2_rotation_shim_controller
+{
+
+/**
+ * @class nav2_rotation_shim_controller::RotationSweepCache
+ * @brief Cells swept by the outline of the footprint while rotating in place over each of
+ * a set of intervals of headings, relative to the cell of the robot. The cells hold every
+ * cell FootprintCollisionChecker::footprintCostAtPose() reads at a heading of the interval,
+ * wherever the robot is in its cell, so a rotation whose swept cells are all below a cost
+ * has all of its footprint costs below it too. They are computed once and reused until the
+ * footprint or the costmap resolution change.
+ */
+class RotationSweepCache
+{
+public:
+  /**
+   * @brief A constructor for nav2_rotation_shim_controller::RotationSweepCache
+   */
+  RotationSweepCache() = default;
+
+  /**
+   * @brief Set the number of intervals of headings, evenly splitting a full turn.
+   * Forces a recomputation of the swept cells on the next update.
+   * @param num_intervals Number of intervals, at least 1
+   */
+  void setNumIntervals(unsigned int num_intervals);
+
+  /**
+   * @brief Recompute the swept cells if the footprint or the resolution changed
+   * @param footprint Unoriented footprint
+   * @param resolution Resolution of the costmap
+   */
+  void update(const nav2_costmap_2d::Footprint & footprint, double resolution);
+
+  /**
+   * @brief Whether the footprint is below a cost all along a rotation in place. The bounding
+   * box of the whole sweep, then of each interval rotated over, is checked in the cost
+   * pyramid first, and only the swept cells of the intervals whose box is not below the
+   * cost are read.
+   * @param costmap Costmap to check, of the resolution of the last update
+   * @param cost_pyramid Cost pyramid of the costmap, or nullptr for none
+   * @param x X of the robot
+   * @param y Y of the robot
+   * @param start_yaw Heading the rotation starts from
+   * @param end_yaw Heading the rotation ends at, either side of the start
+   * @param cost Cost to compare to
+   * @return False if a swept cell is not below the cost, the sweep leaves the costmap or
+   * there are no swept cells, in which case the footprint costs are to be checked
+   */
+  bool isRotationBelowCost(
+    const nav2_costmap_2d::Costmap2D & costmap, const nav2_costmap_2d::CostPyramid * cost_pyramid,
+    double x, double y, double start_yaw, double end_yaw, unsigned char cost) const;
+
+protected:
+  /**
+   * @brief Cells swept over an interval of headings, relative to the robot's cell
+   */
+  struct SweptCells
+  {
+    std::vector<int> dx, dy;
+    int min_dx{0}, max_dx{0}, min_dy{0}, max_dy{0};
+  };
+
+  /**
+   * @brief Rasterize the outline of the footprint over each interval of headings
+   */
+  void computeSweptCells();
+
+  /**
+   * @brief Whether the cells of a box around the robot's cell are all below a cost
+   * @return False if they are not, the box leaves the costmap or there is no cost pyramid
+   */
+  bool isBoxBelowCost(
+    const nav2_costmap_2d::CostPyramid * cost_pyramid, unsigned int mx, unsigned int my,
+    int min_dx, int min_dy, int max_dx, int max_dy, unsigned char cost) const;
+
+  unsigned int num_intervals_{16};
+  nav2_costmap_2d::Footprint footprint_;
+  double resolution_{0.0};
+  std::vector<SweptCells> intervals_;
+  int min_dx_{0}, max_dx_{0}, min_dy_{0}, max_dy_{0};
+};
+
+}  // namespace nav2_rotation_shim_controller
+
+#endif  // NAV2_ROTATION_SHIM_CONTROLLER__ROTATION_SWEEP_CACHE_HPP_
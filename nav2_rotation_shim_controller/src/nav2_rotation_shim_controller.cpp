@@ -63,6 +63,10 @@ void RotationShimController::configure(
     node, plugin_name_ + ".primary_controller", rclcpp::PARAMETER_STRING);
   nav2_util::declare_parameter_if_not_declared(
     node, plugin_name_ + ".rotate_to_goal_heading", rclcpp::ParameterValue(false));
+  nav2_util::declare_parameter_if_not_declared(
+    node, plugin_name_ + ".use_rotation_sweep_cache", rclcpp::ParameterValue(false));
+  nav2_util::declare_parameter_if_not_declared(
+    node, plugin_name_ + ".rotation_sweep_intervals", rclcpp::ParameterValue(16));
 
   node->get_parameter(plugin_name_ + ".angular_dist_threshold", angular_dist_threshold_);
   node->get_parameter(plugin_name_ + ".forward_sampling_distance", forward_sampling_distance_);
@@ -77,6 +81,10 @@ void RotationShimController::configure(
   control_duration_ = 1.0 / control_frequency;
 
   node->get_parameter(plugin_name_ + ".rotate_to_goal_heading", rotate_to_goal_heading_);
+  node->get_parameter(plugin_name_ + ".use_rotation_sweep_cache", use_rotation_sweep_cache_);
+  int rotation_sweep_intervals;
+  node->get_parameter(plugin_name_ + ".rotation_sweep_intervals", rotation_sweep_intervals);
+  rotation_sweep_cache_.setNumIntervals(std::max(rotation_sweep_intervals, 1));
 
   try {
     primary_controller_ = lp_loader_.createUniqueInstance(primary_controller);
@@ -292,6 +300,7 @@ void RotationShimController::isCollisionFree(
   double remaining_rotation_before_thresh =
     fabs(angular_distance_to_heading) - angular_dist_threshold_;
 
+  std::vector<double> yaws;
   while (simulated_time < simulate_ahead_time_) {
     simulated_time += control_duration_;
     yaw = initial_yaw + cmd_vel.twist.angular.z * simulated_time;
@@ -300,11 +309,32 @@ void RotationShimController::isCollisionFree(
     if (angles::shortest_angular_distance(yaw, initial_yaw) >= remaining_rotation_before_thresh) {
       break;
     }
+    yaws.push_back(yaw);
+  }
+
+  if (yaws.empty()) {
+    return;
+  }
 
-    using namespace nav2_costmap_2d;  // NOLINT
+  using namespace nav2_costmap_2d;  // NOLINT
+  const Footprint footprint = costmap_ros_->getRobotFootprint();
+  if (use_rotation_sweep_cache_) {
+    // The whole rotation is free if the cells swept by the footprint are below lethal
+    Costmap2D * costmap = costmap_ros_->getCostmap();
+    std::unique_lock<Costmap2D::mutex_t> lock(*(costmap->getMutex()));
+    updateCostPyramid();
+    rotation_sweep_cache_.update(footprint, costmap->getResolution());
+    if (rotation_sweep_cache_.isRotationBelowCost(
+        *costmap, &cost_pyramid_, pose.pose.position.x, pose.pose.position.y,
+        yaws.front(), yaws.back(), LETHAL_OBSTACLE))
+    {
+      return;
+    }
+  }
+
+  for (const double & simulated_yaw : yaws) {
     footprint_cost = collision_checker_->footprintCostAtPose(
-      pose.pose.position.x, pose.pose.position.y,
-      yaw, costmap_ros_->getRobotFootprint());
+      pose.pose.position.x, pose.pose.position.y, simulated_yaw, footprint);
 
     if (footprint_cost == static_cast<double>(NO_INFORMATION) &&
       costmap_ros_->getLayeredCostmap()->isTrackingUnknown())
@@ -319,6 +349,22 @@ void RotationShimController::isCollisionFree(
   }
 }
 
+void RotationShimController::updateCostPyramid()
+{
+  // Only the blocks of the cells changed since the last update are recomputed
+  nav2_costmap_2d::LayeredCostmap * layered_costmap = costmap_ros_->getLayeredCostmap();
+  const uint64_t update_count = layered_costmap->getUpdateCount();
+  unsigned int x0, xn, y0, yn;
+  if (!cost_pyramid_.isInitialized() ||
+    !layered_costmap->getUpdatedWindowSince(cost_pyramid_update_count_, x0, xn, y0, yn))
+  {
+    cost_pyramid_.update(*costmap_ros_->getCostmap());
+  } else {
+    cost_pyramid_.update(*costmap_ros_->getCostmap(), x0, xn, y0, yn);
+  }
+  cost_pyramid_update_count_ = update_count;
+}
+
 void RotationShimController::setPlan(const nav_msgs::msg::Path & path)
 {
   path_updated_ = true;
@@ -356,6 +402,12 @@ RotationShimController::dynamicParametersCallback(std::vector<rclcpp::Parameter>
     } else if (type == ParameterType::PARAMETER_BOOL) {
       if (name == plugin_name_ + ".rotate_to_goal_heading") {
         rotate_to_goal_heading_ = parameter.as_bool();
+      } else if (name == plugin_name_ + ".use_rotation_sweep_cache") {
+        use_rotation_sweep_cache_ = parameter.as_bool();
+      }
+    } else if (type == ParameterType::PARAMETER_INTEGER) {
+      if (name == plugin_name_ + ".rotation_sweep_intervals") {
+        rotation_sweep_cache_.setNumIntervals(std::max<int>(parameter.as_int(), 1));
       }
     }
   }
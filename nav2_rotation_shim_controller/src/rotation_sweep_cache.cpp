@@ -0,0 +1,202 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_rotation_shim_controller/rotation_sweep_cache.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace nav2_rotation_shim_controller
+{
+
+// Spacing, in cells, of the points sampled along the outline and between its headings,
+// such that any point of the outline at a heading of an interval is within this distance
+// of a sampled one
+constexpr double SAMPLE_SPACING = 0.25;
+
+// The cells of the edges rasterized from the cells of the vertices have their center
+// within a cell of the edge in each axis, and the robot is anywhere in its cell, so each
+// sampled point marks the cells within this distance of it
+constexpr double CELL_MARGIN = 1.5 + SAMPLE_SPACING;
+
+void RotationSweepCache::setNumIntervals(unsigned int num_intervals)
+{
+  num_intervals_ = std::max(num_intervals, 1u);
+  intervals_.clear();
+}
+
+void RotationSweepCache::update(const nav2_costmap_2d::Footprint & footprint, double resolution)
+{
+  if (!intervals_.empty() && footprint == footprint_ && resolution == resolution_) {
+    return;
+  }
+  footprint_ = footprint;
+  resolution_ = resolution;
+  computeSweptCells();
+}
+
+void RotationSweepCache::computeSweptCells()
+{
+  intervals_.assign(num_intervals_, SweptCells());
+  min_dx_ = min_dy_ = max_dx_ = max_dy_ = 0;
+  if (footprint_.empty() || resolution_ <= 0.0) {
+    return;
+  }
+
+  // Vertices in cells, relative to the robot
+  double radius = 0.0;
+  std::vector<double> vx, vy;
+  for (const auto & point : footprint_) {
+    vx.push_back(point.x / resolution_);
+    vy.push_back(point.y / resolution_);
+    radius = std::max(radius, std::hypot(vx.back(), vy.back()));
+  }
+
+  const double interval_width = 2.0 * M_PI / num_intervals_;
+  const int num_steps = std::max(
+    1, static_cast<int>(std::ceil(interval_width * radius / SAMPLE_SPACING)));
+  const int half_size = static_cast<int>(std::ceil(radius)) + 2;
+  const int size = 2 * half_size + 1;
+  std::vector<unsigned char> marked(size * size);
+  std::vector<double> rx(vx.size()), ry(vy.size());
+
+  min_dx_ = min_dy_ = std::numeric_limits<int>::max();
+  max_dx_ = max_dy_ = std::numeric_limits<int>::min();
+  for (unsigned int k = 0; k < num_intervals_; k++) {
+    std::fill(marked.begin(), marked.end(), 0);
+    for (int step = 0; step <= num_steps; step++) {
+      const double theta = (k + static_cast<double>(step) / num_steps) * interval_width;
+      const double cos_th = std::cos(theta);
+      const double sin_th = std::sin(theta);
+      for (size_t i = 0; i < vx.size(); i++) {
+        rx[i] = vx[i] * cos_th - vy[i] * sin_th;
+        ry[i] = vx[i] * sin_th + vy[i] * cos_th;
+      }
+
+      for (size_t i = 0; i < rx.size(); i++) {
+        const size_t j = (i + 1) % rx.size();
+        const int num_points = std::max(
+          1, static_cast<int>(std::ceil(std::hypot(rx[j] - rx[i], ry[j] - ry[i]) /
+          SAMPLE_SPACING)));
+        for (int p = 0; p <= num_points; p++) {
+          const double t = static_cast<double>(p) / num_points;
+          const double px = rx[i] + t * (rx[j] - rx[i]);
+          const double py = ry[i] + t * (ry[j] - ry[i]);
+          const int x_end = static_cast<int>(std::floor(px + CELL_MARGIN));
+          const int y_end = static_cast<int>(std::floor(py + CELL_MARGIN));
+          for (int dy = static_cast<int>(std::ceil(py - CELL_MARGIN)); dy <= y_end; dy++) {
+            for (int dx = static_cast<int>(std::ceil(px - CELL_MARGIN)); dx <= x_end; dx++) {
+              marked[(dy + half_size) * size + dx + half_size] = 1;
+            }
+          }
+        }
+      }
+    }
+
+    SweptCells & cells = intervals_[k];
+    cells.min_dx = cells.min_dy = std::numeric_limits<int>::max();
+    cells.max_dx = cells.max_dy = std::numeric_limits<int>::min();
+    for (int dy = -half_size; dy <= half_size; dy++) {
+      for (int dx = -half_size; dx <= half_size; dx++) {
+        if (!marked[(dy + half_size) * size + dx + half_size]) {
+          continue;
+        }
+        cells.dx.push_back(dx);
+        cells.dy.push_back(dy);
+        cells.min_dx = std::min(cells.min_dx, dx);
+        cells.max_dx = std::max(cells.max_dx, dx);
+        cells.min_dy = std::min(cells.min_dy, dy);
+        cells.max_dy = std::max(cells.max_dy, dy);
+      }
+    }
+    min_dx_ = std::min(min_dx_, cells.min_dx);
+    max_dx_ = std::max(max_dx_, cells.max_dx);
+    min_dy_ = std::min(min_dy_, cells.min_dy);
+    max_dy_ = std::max(max_dy_, cells.max_dy);
+  }
+}
+
+bool RotationSweepCache::isBoxBelowCost(
+  const nav2_costmap_2d::CostPyramid * cost_pyramid, unsigned int mx, unsigned int my,
+  int min_dx, int min_dy, int max_dx, int max_dy, unsigned char cost) const
+{
+  if (!cost_pyramid || !cost_pyramid->isInitialized()) {
+    return false;
+  }
+  const int cx = static_cast<int>(mx);
+  const int cy = static_cast<int>(my);
+  if (cx + min_dx < 0 || cy + min_dy < 0) {
+    return false;
+  }
+  return cost_pyramid->isRegionBelow(cx + min_dx, cy + min_dy, cx + max_dx, cy + max_dy, cost);
+}
+
+bool RotationSweepCache::isRotationBelowCost(
+  const nav2_costmap_2d::Costmap2D & costmap, const nav2_costmap_2d::CostPyramid * cost_pyramid,
+  double x, double y, double start_yaw, double end_yaw, unsigned char cost) const
+{
+  if (intervals_.empty() || intervals_.front().dx.empty()) {
+    return false;
+  }
+
+  unsigned int mx, my;
+  if (!costmap.worldToMap(x, y, mx, my)) {
+    return false;
+  }
+
+  // A full turn about the robot's cell is below the cost in a few blocks of the pyramid
+  if (isBoxBelowCost(cost_pyramid, mx, my, min_dx_, min_dy_, max_dx_, max_dy_, cost)) {
+    return true;
+  }
+
+  // Otherwise, each interval rotated over, from the lowest heading to the highest
+  const double interval_width = 2.0 * M_PI / num_intervals_;
+  const double first = std::floor(std::min(start_yaw, end_yaw) / interval_width);
+  const double last = std::floor(std::max(start_yaw, end_yaw) / interval_width);
+  const unsigned int count = static_cast<unsigned int>(
+    std::min(last - first + 1.0, static_cast<double>(num_intervals_)));
+  const long long n = num_intervals_;
+  const unsigned int first_interval =
+    static_cast<unsigned int>(((static_cast<long long>(first) % n) + n) % n);
+
+  const int cx = static_cast<int>(mx);
+  const int cy = static_cast<int>(my);
+  const int size_x = static_cast<int>(costmap.getSizeInCellsX());
+  const int size_y = static_cast<int>(costmap.getSizeInCellsY());
+  const unsigned char * charmap = costmap.getCharMap();
+  for (unsigned int i = 0; i < count; i++) {
+    const SweptCells & cells = intervals_[(first_interval + i) % num_intervals_];
+    if (isBoxBelowCost(
+        cost_pyramid, mx, my, cells.min_dx, cells.min_dy, cells.max_dx, cells.max_dy, cost))
+    {
+      continue;
+    }
+
+    if (cx + cells.min_dx < 0 || cy + cells.min_dy < 0 ||
+      cx + cells.max_dx >= size_x || cy + cells.max_dy >= size_y)
+    {
+      return false;
+    }
+    for (size_t j = 0; j < cells.dx.size(); j++) {
+      if (charmap[(cy + cells.dy[j]) * size_x + cx + cells.dx[j]] >= cost) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace nav2_rotation_shim_controller
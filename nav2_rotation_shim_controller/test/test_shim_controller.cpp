@@ -17,13 +17,17 @@
 #include <string>
 #include <vector>
 #include <limits>
+#include <random>
 
 #include "gtest/gtest.h"
 #include "rclcpp/rclcpp.hpp"
 #include "nav2_costmap_2d/costmap_2d.hpp"
+#include "nav2_costmap_2d/cost_pyramid.hpp"
+#include "nav2_costmap_2d/footprint_collision_checker.hpp"
 #include "nav2_util/lifecycle_node.hpp"
 #include "nav2_controller/plugins/simple_goal_checker.hpp"
 #include "nav2_rotation_shim_controller/nav2_rotation_shim_controller.hpp"
+#include "nav2_rotation_shim_controller/rotation_sweep_cache.hpp"
 #include "tf2_ros/transform_broadcaster.h"
 
 class RclCppFixture
@@ -382,6 +386,80 @@ TEST(RotationShimControllerTest, computeVelocityGoalRotationTests) {
   EXPECT_EQ(cmd_vel.twist.angular.z, 1.8);
 }
 
+TEST(RotationShimControllerTest, rotationSweepCacheTests)
+{
+  using nav2_costmap_2d::LETHAL_OBSTACLE;
+
+  // An off-center rectangular footprint among scattered lethal cells
+  nav2_costmap_2d::Costmap2D costmap(100, 100, 0.05, 0.0, 0.0);
+  std::mt19937 generator(3);
+  for (int i = 0; i < 40; i++) {
+    costmap.setCost(generator() % 100, generator() % 100, LETHAL_OBSTACLE);
+  }
+  nav2_costmap_2d::CostPyramid cost_pyramid;
+  cost_pyramid.update(costmap);
+  nav2_costmap_2d::FootprintCollisionChecker<nav2_costmap_2d::Costmap2D *> checker(&costmap);
+
+  nav2_costmap_2d::Footprint footprint(4);
+  footprint[0].x = 0.25;
+  footprint[0].y = 0.1;
+  footprint[1].x = 0.25;
+  footprint[1].y = -0.1;
+  footprint[2].x = -0.1;
+  footprint[2].y = -0.1;
+  footprint[3].x = -0.1;
+  footprint[3].y = 0.1;
+
+  nav2_rotation_shim_controller::RotationSweepCache cache;
+  EXPECT_FALSE(cache.isRotationBelowCost(costmap, nullptr, 2.5, 2.5, 0.0, 1.0, LETHAL_OBSTACLE));
+  cache.setNumIntervals(16);
+  cache.update(footprint, costmap.getResolution());
+
+  // Rotations found below lethal have the footprint below lethal at all of their headings
+  std::uniform_real_distribution<double> position(0.5, 4.5), yaw(-7.0, 7.0), span(-3.0, 3.0);
+  const nav2_costmap_2d::CostPyramid * pyramids[] = {nullptr, &cost_pyramid};
+  unsigned int num_below = 0;
+  for (int round = 0; round < 500; round++) {
+    const double x = position(generator), y = position(generator);
+    const double start_yaw = yaw(generator), end_yaw = start_yaw + span(generator);
+    for (const nav2_costmap_2d::CostPyramid * pyramid : pyramids) {
+      if (!cache.isRotationBelowCost(
+          costmap, pyramid, x, y, start_yaw, end_yaw, LETHAL_OBSTACLE))
+      {
+        continue;
+      }
+      num_below++;
+      for (int step = 0; step <= 100; step++) {
+        const double theta = start_yaw + (end_yaw - start_yaw) * step / 100.0;
+        EXPECT_LT(
+          checker.footprintCostAtPose(x, y, theta, footprint),
+          static_cast<double>(LETHAL_OBSTACLE));
+      }
+    }
+  }
+  EXPECT_GT(num_below, 100u);
+
+  // A lethal cell ahead of the robot is swept only by rotations facing it
+  nav2_costmap_2d::Costmap2D empty_costmap(100, 100, 0.05, 0.0, 0.0);
+  cost_pyramid.update(empty_costmap);
+  EXPECT_TRUE(
+    cache.isRotationBelowCost(
+      empty_costmap, &cost_pyramid, 2.5, 2.5, 0.0, 6.0, LETHAL_OBSTACLE));
+  empty_costmap.setCost(55, 50, LETHAL_OBSTACLE);
+  cost_pyramid.update(empty_costmap);
+  EXPECT_FALSE(
+    cache.isRotationBelowCost(
+      empty_costmap, &cost_pyramid, 2.51, 2.51, -0.2, 0.2, LETHAL_OBSTACLE));
+  EXPECT_TRUE(
+    cache.isRotationBelowCost(
+      empty_costmap, &cost_pyramid, 2.51, 2.51, 2.0, 4.0, LETHAL_OBSTACLE));
+
+  // The sweep may not leave the costmap
+  EXPECT_FALSE(
+    cache.isRotationBelowCost(
+      empty_costmap, &cost_pyramid, 0.1, 2.5, 2.0, 4.0, LETHAL_OBSTACLE));
+}
+
 TEST(RotationShimControllerTest, testDynamicParameter)
 {
   auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("ShimControllerTest");
@@ -412,7 +490,9 @@ TEST(RotationShimControllerTest, testDynamicParameter)
       rclcpp::Parameter("test.max_angular_accel", 7.0),
       rclcpp::Parameter("test.simulate_ahead_time", 7.0),
       rclcpp::Parameter("test.primary_controller", std::string("HI")),
-      rclcpp::Parameter("test.rotate_to_goal_heading", true)});
+      rclcpp::Parameter("test.rotate_to_goal_heading", true),
+      rclcpp::Parameter("test.use_rotation_sweep_cache", true),
+      rclcpp::Parameter("test.rotation_sweep_intervals", 8)});
 
   rclcpp::spin_until_future_complete(
     node->get_node_base_interface(),
@@ -84,6 +84,7 @@ private:
   rclcpp::Node::SharedPtr client_node_;
   // Timeout value when waiting for action servers to respond
   std::chrono::milliseconds server_timeout_;
+  std::chrono::steady_clock::time_point last_feedback_label_update_;
 
   // Flags to indicate if the plugins have been loaded
   bool plugins_loaded_ = false;
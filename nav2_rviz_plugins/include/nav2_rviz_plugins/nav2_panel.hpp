@@ -111,6 +111,7 @@ private:
 
   // Timeout value when waiting for action servers to respnd
   std::chrono::milliseconds server_timeout_;
+  std::chrono::steady_clock::time_point last_feedback_label_update_;
 
   // A timer used to check on the completion status of the action
   QBasicTimer timer_;
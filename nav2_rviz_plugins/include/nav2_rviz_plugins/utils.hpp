@@ -18,6 +18,7 @@
 
 #include <QtWidgets>
 
+#include <chrono>
 #include <string>
 
 #include "rclcpp/rclcpp.hpp"
@@ -41,6 +42,20 @@ void pluginLoader(
 // Create label string from goal status msg
 QString getGoalStatusLabel(
   std::string title = "Feedback", int8_t status = action_msgs::msg::GoalStatus::STATUS_UNKNOWN);
+
+// Minimum period between two updates of the feedback labels, which need not follow the
+// rate of the action feedback
+constexpr std::chrono::milliseconds feedback_label_period(200);
+
+/**
+   * @brief Throttle the updates of a label
+   * @param last_update Time of the last update, set to now if an update is due
+   * @param period Minimum period between two updates
+   * @return true if an update is due
+   */
+bool isLabelUpdateDue(
+  std::chrono::steady_clock::time_point & last_update,
+  std::chrono::milliseconds period = feedback_label_period);
 }  // namespace nav2_rviz_plugins
 
 #endif  // NAV2_RVIZ_PLUGINS__UTILS_HPP_
@@ -121,7 +121,9 @@ void DockingPanel::onInitialize()
     "dock_robot/_action/feedback",
     rclcpp::SystemDefaultsQoS(),
     [this](const Dock::Impl::FeedbackMessage::SharedPtr msg) {
-      docking_feedback_indicator_->setText(getDockFeedbackLabel(msg->feedback));
+      if (isLabelUpdateDue(last_feedback_label_update_)) {
+        docking_feedback_indicator_->setText(getDockFeedbackLabel(msg->feedback));
+      }
       docking_button_->setText("Cancel docking");
       undocking_button_->setEnabled(false);
       docking_in_progress_ = true;
@@ -193,7 +195,7 @@ void DockingPanel::onUndockingButtonPressed()
 void DockingPanel::startDocking()
 {
   auto is_action_server_ready =
-    dock_client_->wait_for_action_server(std::chrono::seconds(5));
+    dock_client_->wait_for_action_server(server_timeout_);
   if (!is_action_server_ready) {
     RCLCPP_ERROR(client_node_->get_logger(), "dock_robot action server is not available.");
     return;
@@ -279,7 +281,7 @@ void DockingPanel::startDocking()
 void DockingPanel::startUndocking()
 {
   auto is_action_server_ready =
-    undock_client_->wait_for_action_server(std::chrono::seconds(5));
+    undock_client_->wait_for_action_server(server_timeout_);
   if (!is_action_server_ready) {
     RCLCPP_ERROR(client_node_->get_logger(), "undock_robot action server is not available.");
     return;
@@ -789,7 +789,8 @@ Nav2Panel::onInitialize()
     "navigate_to_pose/_action/feedback",
     rclcpp::SystemDefaultsQoS(),
     [this](const nav2_msgs::action::NavigateToPose::Impl::FeedbackMessage::SharedPtr msg) {
-      if (stoi(nr_of_loops_->displayText().toStdString()) > 0) {
+      const bool looping = stoi(nr_of_loops_->displayText().toStdString()) > 0;
+      if (looping) {
         if (goal_index_ == 0 && !loop_counter_stop_) {
           loop_count_++;
           loop_counter_stop_ = true;
@@ -797,6 +798,11 @@ Nav2Panel::onInitialize()
         if (goal_index_ != 0) {
           loop_counter_stop_ = false;
         }
+      }
+      if (!isLabelUpdateDue(last_feedback_label_update_)) {
+        return;
+      }
+      if (looping) {
         navigation_feedback_indicator_->setText(
           getNavToPoseFeedbackLabel(msg->feedback) + QString(
             std::string(
@@ -814,7 +820,9 @@ Nav2Panel::onInitialize()
     "navigate_through_poses/_action/feedback",
     rclcpp::SystemDefaultsQoS(),
     [this](const nav2_msgs::action::NavigateThroughPoses::Impl::FeedbackMessage::SharedPtr msg) {
-      navigation_feedback_indicator_->setText(getNavThroughPosesFeedbackLabel(msg->feedback));
+      if (isLabelUpdateDue(last_feedback_label_update_)) {
+        navigation_feedback_indicator_->setText(getNavThroughPosesFeedbackLabel(msg->feedback));
+      }
     });
 
   // create action goal status subscribers
@@ -1190,7 +1198,7 @@ void
 Nav2Panel::startWaypointFollowing(std::vector<geometry_msgs::msg::PoseStamped> poses)
 {
   auto is_action_server_ready =
-    waypoint_follower_action_client_->wait_for_action_server(std::chrono::seconds(5));
+    waypoint_follower_action_client_->wait_for_action_server(server_timeout_);
   if (!is_action_server_ready) {
     RCLCPP_ERROR(
       client_node_->get_logger(), "follow_waypoints action server is not available."
@@ -1248,7 +1256,7 @@ void
 Nav2Panel::startNavThroughPoses(std::vector<geometry_msgs::msg::PoseStamped> poses)
 {
   auto is_action_server_ready =
-    nav_through_poses_action_client_->wait_for_action_server(std::chrono::seconds(5));
+    nav_through_poses_action_client_->wait_for_action_server(server_timeout_);
   if (!is_action_server_ready) {
     RCLCPP_ERROR(
       client_node_->get_logger(), "navigate_through_poses action server is not available."
@@ -1300,7 +1308,7 @@ void
 Nav2Panel::startNavigation(geometry_msgs::msg::PoseStamped pose)
 {
   auto is_action_server_ready =
-    navigation_action_client_->wait_for_action_server(std::chrono::seconds(5));
+    navigation_action_client_->wait_for_action_server(server_timeout_);
   if (!is_action_server_ready) {
     RCLCPP_ERROR(
       client_node_->get_logger(),
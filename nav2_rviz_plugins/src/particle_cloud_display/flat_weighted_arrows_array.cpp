@@ -81,14 +81,20 @@ void FlatWeightedArrowsArray::updateManualObject(
   float max_length,
   const std::vector<nav2_rviz_plugins::OgrePoseWithWeight> & poses)
 {
-  clear();
-
   color.a = alpha;
-  setManualObjectMaterial();
+  if (!material_) {
+    setManualObjectMaterial();
+  }
   rviz_rendering::MaterialManager::enableAlphaBlending(material_, alpha);
 
-  manual_object_->begin(
-    material_->getName(), Ogre::RenderOperation::OT_LINE_LIST, "rviz_rendering");
+  // Rewrite the vertices of the existing section in place, its hardware buffer is only
+  // reallocated when the cloud outgrows it
+  if (manual_object_->getNumSections() > 0) {
+    manual_object_->beginUpdate(0);
+  } else {
+    manual_object_->begin(
+      material_->getName(), Ogre::RenderOperation::OT_LINE_LIST, "rviz_rendering");
+  }
   setManualObjectVertices(color, min_length, max_length, poses);
   manual_object_->end();
 }
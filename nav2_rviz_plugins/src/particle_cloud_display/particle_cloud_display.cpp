@@ -57,6 +57,7 @@
 #include "rviz_common/properties/enum_property.hpp"
 #include "rviz_common/properties/color_property.hpp"
 #include "rviz_common/properties/float_property.hpp"
+#include "rviz_common/properties/int_property.hpp"
 #include "rviz_common/validate_floats.hpp"
 
 #include "rviz_rendering/objects/arrow.hpp"
@@ -131,6 +132,12 @@ void ParticleCloudDisplay::initializeProperties()
   arrow_max_length_property_ = new rviz_common::properties::FloatProperty(
     "Max Arrow Length", max_length_, "Maximum length of the arrows.", this, SLOT(updateGeometry()));
 
+  max_particles_property_ = new rviz_common::properties::IntProperty(
+    "Max Particles", 5000,
+    "Maximum number of particles to display, larger clouds are evenly subsampled. "
+    "0 displays all particles.", this);
+  max_particles_property_->setMin(0);
+
   // Scales are set based on initial values
   length_scale_ = max_length_ - min_length_;
   shaft_radius_scale_ = 0.0435;
@@ -168,12 +175,20 @@ void ParticleCloudDisplay::processMessage(const nav2_msgs::msg::ParticleCloud::C
     return;
   }
 
-  poses_.resize(msg->particles.size());
+  // Large clouds are evenly subsampled, as each shape drawn costs a few objects or vertices
+  const std::size_t num_particles = msg->particles.size();
+  const std::size_t max_particles = static_cast<std::size_t>(max_particles_property_->getInt());
+  std::size_t num_poses = num_particles;
+  if (max_particles > 0 && num_particles > max_particles) {
+    num_poses = max_particles;
+  }
+  poses_.resize(num_poses);
 
-  for (std::size_t i = 0; i < msg->particles.size(); ++i) {
-    poses_[i].position = rviz_common::pointMsgToOgre(msg->particles[i].pose.position);
-    poses_[i].orientation = rviz_common::quaternionMsgToOgre(msg->particles[i].pose.orientation);
-    poses_[i].weight = static_cast<float>(msg->particles[i].weight);
+  for (std::size_t i = 0; i < num_poses; ++i) {
+    const auto & particle = msg->particles[i * num_particles / num_poses];
+    poses_[i].position = rviz_common::pointMsgToOgre(particle.pose.position);
+    poses_[i].orientation = rviz_common::quaternionMsgToOgre(particle.pose.orientation);
+    poses_[i].weight = static_cast<float>(particle.weight);
   }
 
   updateDisplay();
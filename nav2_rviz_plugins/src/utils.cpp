@@ -51,8 +51,16 @@ void pluginLoader(
   if (server_unavailable) {
     return;
   }
+  // Do not block the GUI on an unresponsive server
+  auto parameters = parameter_client->get_parameters({plugin_type}, std::chrono::seconds(1));
+  if (parameters.empty()) {
+    RCLCPP_INFO(
+      node->get_logger(),
+      "%s did not return its %s", server_name.c_str(), plugin_type.c_str());
+    server_failed = true;
+    return;
+  }
   combo_box->addItem("Default");
-  auto parameters = parameter_client->get_parameters({plugin_type});
   auto str_arr = parameters[0].as_string_array();
   for (auto str : str_arr) {
     combo_box->addItem(QString::fromStdString(str));
@@ -60,6 +68,18 @@ void pluginLoader(
   combo_box->setCurrentText("Default");
 }
 
+bool isLabelUpdateDue(
+  std::chrono::steady_clock::time_point & last_update,
+  std::chrono::milliseconds period)
+{
+  const auto now = std::chrono::steady_clock::now();
+  if (now - last_update < period) {
+    return false;
+  }
+  last_update = now;
+  return true;
+}
+
 QString getGoalStatusLabel(std::string title, int8_t status)
 {
   std::string status_str;
@@ -27,19 +27,25 @@
 
 #include "nav2_costmap_2d/costmap_2d.hpp"
 #include "nav2_core/planner_exceptions.hpp"
+#include "nav2_util/memory_registry.hpp"
 
 #include "nav2_smac_planner/thirdparty/robin_hood.h"
 #include "nav2_smac_planner/analytic_expansion.hpp"
+#include "nav2_smac_planner/expansions_log.hpp"
 #include "nav2_smac_planner/node_2d.hpp"
 #include "nav2_smac_planner/node_hybrid.hpp"
 #include "nav2_smac_planner/node_lattice.hpp"
 #include "nav2_smac_planner/node_basic.hpp"
+#include "nav2_smac_planner/node_pool.hpp"
+#include "nav2_smac_planner/node_queue.hpp"
 #include "nav2_smac_planner/types.hpp"
 #include "nav2_smac_planner/constants.hpp"
 
 namespace nav2_smac_planner
 {
 
+class SearchCorridor;
+
 /**
  * @class nav2_smac_planner::AStarAlgorithm
  * @brief An A* implementation for planning in a costmap. Templated based on the Node type.
@@ -56,6 +62,7 @@ public:
   typedef typename NodeT::CoordinateVector CoordinateVector;
   typedef typename NodeVector::iterator NeighborIterator;
   typedef std::function<bool (const uint64_t &, NodeT * &)> NodeGetter;
+  typedef std::function<void (const CoordinateVector &)> PartialPathCallback;
 
   /**
    * @struct nav2_smac_planner::NodeComparator
@@ -69,7 +76,7 @@ public:
     }
   };
 
-  typedef std::priority_queue<NodeElement, std::vector<NodeElement>, NodeComparator> NodeQueue;
+  typedef DAryHeap<NodeElement, NodeComparator> NodeQueue;
 
   /**
    * @brief A constructor for nav2_smac_planner::AStarAlgorithm
@@ -92,6 +99,10 @@ public:
    * or planning time exceeded
    * @param max_planning_time Maximum time (in seconds) to wait for a plan, createPath returns
    * false after this timeout
+   * @param use_node_pool Whether to keep the graph nodes in a dense pool reused across plans
+   * rather than in a hash map rebuilt for each plan
+   * @param open_list_arity Number of children of each node of the open list heap, 2 for a
+   * binary heap
    */
   void initialize(
     const bool & allow_unknown,
@@ -100,10 +111,15 @@ public:
     const int & terminal_checking_interval,
     const double & max_planning_time,
     const float & lookup_table_size,
-    const unsigned int & dim_3_size);
+    const unsigned int & dim_3_size,
+    const bool & use_node_pool = false,
+    const unsigned int & open_list_arity = 2);
 
   /**
-   * @brief Creating path from given costmap, start, and goal
+   * @brief Creating path from given costmap, start, and goal. With an anytime heuristic
+   * weight above 1, the search is a weighted A* whose first path is refined by searching
+   * on with lower weights, reusing the open set, until the weight reaches 1 or the
+   * refinement time runs out (ARA*)
    * @param path Reference to a vector of indicies of generated path
    * @param num_iterations Reference to number of iterations to create plan
    * @param tolerance Reference to tolerance in costmap nodes
@@ -114,7 +130,7 @@ public:
   bool createPath(
     CoordinateVector & path, int & num_iterations, const float & tolerance,
     std::function<bool()> cancel_checker,
-    std::vector<std::tuple<float, float, float>> * expansions_log = nullptr);
+    ExpansionsLog * expansions_log = nullptr);
 
   /**
    * @brief Sets the collision checker to use
@@ -122,6 +138,22 @@ public:
    */
   void setCollisionChecker(GridCollisionChecker * collision_checker);
 
+  /**
+   * @brief Restrict the search to a corridor of cells, as found by a coarser search
+   * @param search_corridor Corridor to restrict the search to, or nullptr to search
+   * the whole costmap. It must outlive the searches it is set for.
+   */
+  void setSearchCorridor(const SearchCorridor * search_corridor);
+
+  /**
+   * @brief Stream best-effort paths while searching, to the expanded node of lowest heuristic,
+   * or to the goal once an anytime search found a path. Paths are given on the thread of the
+   * search, at most every terminal checking interval, from their end back to the start.
+   * @param callback Callback to give the partial paths to
+   * @param period Time between partial paths in seconds, 0 not to stream them
+   */
+  void setPartialPathCallback(PartialPathCallback callback, const double & period);
+
   /**
    * @brief Set the goal for planning, as a node index
    * @param mx The node X index of the goal
@@ -133,6 +165,19 @@ public:
     const float & my,
     const unsigned int & dim_3);
 
+  /**
+   * @brief Add a goal to plan to, after the one set with setGoal, the search stopping
+   * at the first goal of the set it reaches. Only Node2D plans to goal sets, the
+   * heuristics of the other nodes are precomputed for a single goal.
+   * @param mx The node X index of the goal
+   * @param my The node Y index of the goal
+   * @param dim_3 The node dim_3 index of the goal
+   */
+  void addGoal(
+    const float & mx,
+    const float & my,
+    const unsigned int & dim_3);
+
   /**
    * @brief Set the starting pose for planning, as a node index
    * @param mx The node X index of the goal
@@ -174,6 +219,14 @@ public:
    */
   float & getToleranceHeuristic();
 
+  /**
+   * @brief Get the bound on the suboptimality of the last path created, as a factor of
+   * the cost of the best path. It is 1 unless the anytime search ran out of time and is
+   * only nominal, since the heuristics weigh costs the search does not
+   * @return Suboptimality bound of the last path
+   */
+  float getSuboptimalityBound() const;
+
   /**
    * @brief Get size of graph in X
    * @return Size in X
@@ -226,6 +279,43 @@ protected:
    */
   inline float getHeuristicCost(const NodePtr & node);
 
+  /**
+   * @brief Get the priority of a node in the open set for the current heuristic weight
+   * @param node Node pointer to get priority for
+   * @return Sum of the node cost and the weighted heuristic
+   */
+  inline float getPriority(const NodePtr & node);
+
+  /**
+   * @brief Lower the heuristic weight of the anytime search for the next iteration:
+   * requeue the open set with the new weight, dropping entries superseded by a cheaper
+   * one, and reopen the nodes visited so far
+   * @param heuristic_weight New weight of the heuristic
+   */
+  inline void reweightOpenSet(const float & heuristic_weight);
+
+  /**
+   * @brief Get the lowest unweighted cost of the nodes in the open set, a lower bound of
+   * the best path's cost
+   * @return Lowest sum of node cost and heuristic
+   */
+  inline float getOpenSetLowerBound();
+
+  /**
+   * @brief Get the path of the analytic expansions run on a helper thread if one was
+   * found, else start them from the expanded node and the best nodes of the open list
+   * when due
+   * @param current_node The node expanded by the search
+   * @param getter Gets a node at a set of coordinates
+   * @param analytic_iterations Iterations left until the next expansion
+   * @param closest_distance Closest heuristic distance to the goal expanded yet
+   * @return Node pointer reference to goal node if an expansion succeeded, else
+   * return nullptr
+   */
+  inline NodePtr tryAsyncAnalyticExpansion(
+    const NodePtr & current_node, const NodeGetter & getter,
+    int & analytic_iterations, int & closest_distance);
+
   /**
    * @brief Check if inputs to planner are valid
    * @return Are valid
@@ -242,13 +332,23 @@ protected:
    */
   inline void clearGraph();
 
+  /**
+   * @brief Select the graph backend, dropping the nodes of the previous one
+   * @param use_node_pool Whether to use the dense node pool rather than the hash map
+   */
+  void setNodePoolUsage(const bool & use_node_pool);
+
+  /**
+   * @brief Account for the bytes of the graph in the nav2_util::MemoryRegistry
+   */
+  void updateGraphMemory();
+
   /**
    * @brief Populate a debug log of expansions for Hybrid-A* for visualization
    * @param node Node expanded
    * @param expansions_log Log to add not expanded to
    */
-  inline void populateExpansionsLog(
-    const NodePtr & node, std::vector<std::tuple<float, float, float>> * expansions_log);
+  inline void populateExpansionsLog(const NodePtr & node, ExpansionsLog * expansions_log);
 
   bool _traverse_unknown;
   bool _is_initialized;
@@ -265,15 +365,27 @@ protected:
   Coordinates _goal_coordinates;
   NodePtr _start;
   NodePtr _goal;
+  std::vector<Coordinates> _other_goals_coordinates;
+  NodeVector _other_goals;
 
+  bool _use_node_pool;
   Graph _graph;
+  NodePool<NodeT> _node_pool;
+  nav2_util::MemoryTracker _graph_memory{"smac_planner/graph"};
   NodeQueue _queue;
+  std::vector<NodeElement> _requeued_elements;
+  NodeVector _closed_nodes;
+  float _heuristic_weight;
+  float _suboptimality_bound;
 
   MotionModel _motion_model;
   NodeHeuristicPair _best_heuristic_node;
 
   GridCollisionChecker * _collision_checker;
   nav2_costmap_2d::Costmap2D * _costmap;
+  const SearchCorridor * _search_corridor;
+  PartialPathCallback _partial_path_callback;
+  double _partial_path_period;
   std::unique_ptr<AnalyticExpansion<NodeT>> _expander;
 };
 
@@ -15,12 +15,16 @@
 #ifndef NAV2_SMAC_PLANNER__ANALYTIC_EXPANSION_HPP_
 #define NAV2_SMAC_PLANNER__ANALYTIC_EXPANSION_HPP_
 
+#include <atomic>
+#include <future>
 #include <string>
 #include <vector>
 #include <list>
 #include <memory>
 
+#include "nav2_smac_planner/curve_solver.hpp"
 #include "nav2_smac_planner/node_2d.hpp"
+#include "nav2_smac_planner/node_basic.hpp"
 #include "nav2_smac_planner/node_hybrid.hpp"
 #include "nav2_smac_planner/node_lattice.hpp"
 #include "nav2_smac_planner/types.hpp"
@@ -69,6 +73,11 @@ public:
     const bool & traverse_unknown,
     const unsigned int & dim_3_size);
 
+  /**
+   * @brief Destructor for analytic expansion object, stopping its helper thread
+   */
+  ~AnalyticExpansion();
+
   /**
    * @brief Sets the collision checker and costmap to use in expansion validation
    * @param collision_checker Collision checker to use
@@ -90,17 +99,58 @@ public:
     const NodePtr & goal_node,
     const NodeGetter & getter, int & iterations, int & best_cost);
 
+  /**
+   * @brief Check whether an analytic expansion is due, counting down iterations
+   * between expansions which get more frequent closer to the goal
+   * @param current_node The node expanded by the search
+   * @param goal_node The goal node to plan to
+   * @param iterations Iterations left until the next expansion, reset when due
+   * @param closest_distance Closest heuristic distance to the goal expanded yet
+   * @return If an analytic expansion should be attempted now
+   */
+  bool isAnalyticExpansionDue(
+    const NodePtr & current_node, const NodePtr & goal_node,
+    int & iterations, int & closest_distance);
+
+  /**
+   * @brief Start analytic expansions from a set of candidate nodes on a helper thread,
+   * unless the ones started before are still running. Candidates are checked in order
+   * and the first one with a valid expansion is refined as in tryAnalyticExpansion.
+   * The helper thread does not touch the graph, it checks poses against its own copy
+   * of the collision checker.
+   * @param candidates Queue entries of the nodes to start from, in order of preference
+   * @param goal_node The goal node to plan to
+   */
+  void startAsyncAnalyticExpansion(
+    const std::vector<NodeBasic<NodeT>> & candidates, const NodePtr & goal_node);
+
+  /**
+   * @brief Get the path of the analytic expansions run on the helper thread, if done.
+   * The path is set in the graph from the node found by the helper thread.
+   * @param goal_node The goal node to plan to
+   * @param getter Gets a node at a set of coordinates
+   * @return Node pointer reference to goal node if an expansion succeeded, else
+   * return nullptr
+   */
+  NodePtr getAsyncAnalyticExpansion(const NodePtr & goal_node, const NodeGetter & getter);
+
+  /**
+   * @brief Stop the analytic expansions run on the helper thread, if any, waiting for
+   * it to no longer use the costmap
+   */
+  void stopAsyncAnalyticExpansion();
+
   /**
    * @brief Perform an analytic path expansion to the goal
    * @param node The node to start the analytic path from
    * @param goal The goal node to plan to
    * @param getter The function object that gets valid nodes from the graph
-   * @param state_space State space to use for computing analytic expansions
+   * @param curve_solver Dubins or Reeds-Shepp solver to use for computing analytic expansions
    * @return A set of analytically expanded nodes to the goal from current node, if possible
    */
   AnalyticExpansionNodes getAnalyticPath(
     const NodePtr & node, const NodePtr & goal,
-    const NodeGetter & getter, const ompl::base::StateSpacePtr & state_space);
+    const NodeGetter & getter, const CurveSolver & curve_solver);
 
   /**
    * @brief Takes final analytic expansion and appends to current expanded node
@@ -113,6 +163,19 @@ public:
     const NodePtr & node, const NodePtr & goal,
     const AnalyticExpansionNodes & expanded_nodes);
 
+  /**
+   * @brief Appends the final analytic expansion to current expanded node with nodes
+   * detached from the graph, costed like the expansion's scoring function, so a search
+   * going on after the path is found is not disturbed by it
+   * @param node The node to start the analytic path from
+   * @param goal The goal node to plan to
+   * @param expanded_nodes Expanded nodes to append to end of current search path
+   * @return Node pointer to a detached copy of the goal node with the cost of the path
+   */
+  NodePtr setDetachedAnalyticPath(
+    const NodePtr & node, const NodePtr & goal,
+    const AnalyticExpansionNodes & expanded_nodes);
+
   /**
    * @brief Takes an expanded nodes to clean up, if necessary, of any state
    * information that may be poluting it from a prior search iteration
@@ -121,12 +184,74 @@ public:
   void cleanNode(const NodePtr & nodes);
 
 protected:
+  /**
+   * @struct nav2_smac_planner::AnalyticExpansion::AsyncCandidate
+   * @brief Candidate for the analytic expansions run on the helper thread
+   */
+  struct AsyncCandidate
+  {
+    // Queue entry of the node, restoring its queued pose if not yet visited
+    NodeBasic<NodeT> entry;
+    // The node and its ancestors to refine the expansion from, with their poses
+    std::vector<NodePtr> nodes;
+    std::vector<Coordinates> poses;
+  };
+
+  /**
+   * @struct nav2_smac_planner::AnalyticExpansion::AsyncResult
+   * @brief Best analytic expansion found by the helper thread
+   */
+  struct AsyncResult
+  {
+    int candidate{-1};
+    unsigned int start{0};
+    CurveSolver curve_solver;
+  };
+
+  /**
+   * @brief Run the analytic expansions of the candidates, on the helper thread
+   * @param goal_pose Pose of the goal to plan to
+   * @return Best expansion found, with no candidate if none succeeded
+   */
+  AsyncResult runAsyncAnalyticExpansion(const Coordinates goal_pose);
+
+  /**
+   * @brief Check an analytic expansion between poses without using the graph, against
+   * the collision checker of the helper thread
+   * @param start Pose to start the expansion from
+   * @param goal Pose of the goal to plan to
+   * @param curve_solver Dubins or Reeds-Shepp solver to use for computing analytic expansions
+   * @param scratch Node, out of the graph, to check the expansion's poses with
+   * @param score Score of the expansion if valid, as in tryAnalyticExpansion
+   * @return If the expansion is valid
+   */
+  bool checkAnalyticPath(
+    const Coordinates & start, const Coordinates & goal,
+    const CurveSolver & curve_solver, NodeT & scratch, float & score);
+
+  /**
+   * @brief Check the costs along an analytic expansion against the maximum cost
+   * @param node_costs Costs of the poses of the expansion
+   * @param distance Length of the expansion
+   * @param min_turning_radius Minimum turning radius of the motion model
+   * @return If the expansion's costs are admissible
+   */
+  bool isAnalyticPathCostAdmissible(
+    const std::vector<float> & node_costs, const float & distance,
+    const float & min_turning_radius);
+
   MotionModel _motion_model;
   SearchInfo _search_info;
   bool _traverse_unknown;
   unsigned int _dim_3_size;
   GridCollisionChecker * _collision_checker;
   std::list<std::unique_ptr<NodeT>> _detached_nodes;
+
+  std::vector<AsyncCandidate> _async_candidates;
+  std::unique_ptr<GridCollisionChecker> _async_collision_checker;
+  uint64_t _async_max_index{0};
+  std::future<AsyncResult> _async_expansion;
+  std::atomic<bool> _async_expansion_stop{false};
 };
 
 }  // namespace nav2_smac_planner
@@ -0,0 +1,210 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef NAV2_SMAC_PLANNER__BIDIRECTIONAL_A_STAR_HPP_
+#define NAV2_SMAC_PLANNER__BIDIRECTIONAL_A_STAR_HPP_
+
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "nav2_smac_planner/collision_checker.hpp"
+#include "nav2_smac_planner/node_2d.hpp"
+#include "nav2_smac_planner/node_queue.hpp"
+
+namespace nav2_smac_planner
+{
+
+/**
+ * @class nav2_smac_planner::BidirectionalAStar
+ * @brief A bidirectional A* search of the 2D grid, searching from the start and from the
+ * goal at once until the frontiers meet, expanding the side with the smaller open set.
+ * Paths and their costs are the same as those of the 2D A* search, for about half of its
+ * expansions on long routes, and an unreachable goal is found as soon as the frontier of
+ * either side runs out of cells.
+ */
+class BidirectionalAStar
+{
+public:
+  typedef Node2D::Coordinates Coordinates;
+  typedef Node2D::CoordinateVector CoordinateVector;
+  typedef std::pair<double, unsigned int> QueueElement;
+
+  /**
+   * @struct nav2_smac_planner::BidirectionalAStar::QueueComparator
+   * @brief Priority comparison for priority queue sorting
+   */
+  struct QueueComparator
+  {
+    bool operator()(const QueueElement & a, const QueueElement & b) const
+    {
+      return a.first > b.first;
+    }
+  };
+
+  typedef DAryHeap<QueueElement, QueueComparator> Queue;
+
+  /**
+   * @enum nav2_smac_planner::BidirectionalAStar::Outcome
+   * @brief Outcome of a search
+   */
+  enum class Outcome
+  {
+    PATH_FOUND,
+    START_BLOCKED,
+    GOAL_OCCUPIED,
+    NO_PATH,
+    LIMIT_REACHED
+  };
+
+  /**
+   * @brief A constructor for nav2_smac_planner::BidirectionalAStar
+   */
+  BidirectionalAStar();
+
+  /**
+   * @brief Initialization of the planner
+   * @param allow_unknown Allow search in unknown space, good for navigation while mapping
+   * @param max_iterations Maximum number of iterations to use while expanding search
+   * @param terminal_checking_interval Number of iterations to check if the task has been
+   * canceled or planning time exceeded
+   * @param max_planning_time Maximum time (in seconds) to wait for a plan
+   * @param cost_penalty Penalty on the costmap cost of cells travelled, as for Node2D
+   * @param open_list_arity Number of children of each node of the open list heaps
+   */
+  void initialize(
+    const bool & allow_unknown,
+    const int & max_iterations,
+    const int & terminal_checking_interval,
+    const double & max_planning_time,
+    const float & cost_penalty,
+    const unsigned int & open_list_arity = 2);
+
+  /**
+   * @brief Sets the collision checker to use
+   * @param collision_checker Collision checker to use for checking state validity
+   */
+  void setCollisionChecker(GridCollisionChecker * collision_checker);
+
+  /**
+   * @brief Set the goal for planning
+   * @param mx The node X index of the goal
+   * @param my The node Y index of the goal
+   */
+  void setGoal(const unsigned int & mx, const unsigned int & my);
+
+  /**
+   * @brief Set the start for planning
+   * @param mx The node X index of the start
+   * @param my The node Y index of the start
+   */
+  void setStart(const unsigned int & mx, const unsigned int & my);
+
+  /**
+   * @brief Creating path from the start to the goal
+   * @param path Reference to a vector of coordinates of the path, from the goal to the start
+   * @param num_iterations Reference to number of iterations, on both sides, to create plan
+   * @param cancel_checker Function to check if the task has been canceled
+   * @return Outcome of the search, PATH_FOUND if the path was created
+   */
+  Outcome createPath(
+    CoordinateVector & path, int & num_iterations, std::function<bool()> cancel_checker);
+
+  /**
+   * @brief Get maximum number of iterations to plan
+   * @return Maximum number of iterations
+   */
+  int & getMaxIterations();
+
+protected:
+  /**
+   * @struct nav2_smac_planner::BidirectionalAStar::Side
+   * @brief Search from one end of the path: its costs from that end, the parents the cells
+   * were reached from and its open set
+   */
+  struct Side
+  {
+    std::vector<double> g;
+    std::vector<unsigned int> parents;
+    Queue queue;
+    unsigned int root;
+    unsigned int target;
+    uint8_t closed_flag;
+    bool forward;
+  };
+
+  /**
+   * @brief Get the heuristic cost between two cells
+   * @param a Index of the first cell
+   * @param b Index of the second cell
+   * @return Heuristic cost
+   */
+  inline double getHeuristicCost(const unsigned int & a, const unsigned int & b);
+
+  /**
+   * @brief Get the cost factor of travelling into a cell, evaluating it on first use
+   * @param index Cell index
+   * @return Cost factor of the cell, infinite if it is not traversable
+   */
+  inline double getCellFactor(const unsigned int & index);
+
+  /**
+   * @brief Drop the queue entries of cells the side closed since queued
+   * @param side Side of the search
+   * @return Whether the queue still has entries
+   */
+  inline bool cleanQueueTop(Side & side);
+
+  /**
+   * @brief Expand the best cell of the open set of a side, updating the best meeting
+   * of the frontiers found
+   * @param side Side of the search to expand
+   * @param other Other side of the search
+   */
+  inline void expand(Side & side, const Side & other);
+
+  /**
+   * @brief Resize the search to the costmap, if needed, and reset its contents
+   */
+  void resetSearch();
+
+  GridCollisionChecker * _collision_checker;
+  bool _traverse_unknown;
+  int _max_iterations;
+  int _terminal_checking_interval;
+  double _max_planning_time;
+  float _cost_penalty;
+
+  unsigned int _x_size;
+  unsigned int _y_size;
+  unsigned int _start;
+  unsigned int _goal;
+
+  // Cost of the best path through a cell reached by both sides, and that cell
+  double _best_cost;
+  unsigned int _meeting;
+
+  Side _forward;
+  Side _backward;
+  // Closed flags of the sides of each cell, and the cost factor of each cell, which
+  // is NaN until evaluated
+  std::vector<uint8_t> _closed;
+  std::vector<float> _cell_factors;
+};
+
+}  // namespace nav2_smac_planner
+
+#endif  // NAV2_SMAC_PLANNER__BIDIRECTIONAL_A_STAR_HPP_
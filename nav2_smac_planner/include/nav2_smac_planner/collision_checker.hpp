@@ -18,6 +18,7 @@
 #include "nav2_costmap_2d/footprint_collision_checker.hpp"
 #include "nav2_costmap_2d/costmap_2d_ros.hpp"
 #include "nav2_smac_planner/constants.hpp"
+#include "nav2_smac_planner/types.hpp"
 #include "rclcpp_lifecycle/lifecycle_node.hpp"
 
 #ifndef NAV2_SMAC_PLANNER__COLLISION_CHECKER_HPP_
@@ -82,6 +83,69 @@ public:
     const float & theta,
     const bool & traverse_unknown);
 
+  /**
+   * @brief Poses to collision check at once, and the results of the check
+   */
+  struct PoseBatch
+  {
+    /**
+     * @brief Clear the poses, keeping the buffers' capacity
+     */
+    void clear()
+    {
+      x.clear();
+      y.clear();
+      angle_bin.clear();
+      ids.clear();
+    }
+
+    /**
+     * @brief Add a pose to check
+     * @param pose_x X coordinate of the pose
+     * @param pose_y Y coordinate of the pose
+     * @param pose_angle_bin Angle bin number of the pose (NOT radians)
+     * @param id Identifier of the pose for the caller
+     */
+    void add(
+      const float & pose_x, const float & pose_y, const float & pose_angle_bin,
+      const unsigned int & id)
+    {
+      x.push_back(pose_x);
+      y.push_back(pose_y);
+      angle_bin.push_back(pose_angle_bin);
+      ids.push_back(id);
+    }
+
+    size_t size() const {return x.size();}
+
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> angle_bin;
+    std::vector<unsigned int> ids;
+    // Results, by pose: whether in collision and the cost getCost() would give
+    std::vector<unsigned char> in_collision;
+    std::vector<float> costs;
+    // Cell of each pose, or 0 if outside the map
+    std::vector<unsigned int> cells;
+  };
+
+  /**
+   * @brief Check a batch of poses at once, such as all the neighbors of an expansion,
+   * as inCollision would check them one by one. The center costs of all poses are
+   * gathered first, then the footprints are only checked about the centers possibly
+   * in collision.
+   * @param batch Poses to check, in which the results are set
+   * @param traverse_unknown Whether or not to traverse in unknown space
+   */
+  void inCollision(PoseBatch & batch, const bool & traverse_unknown);
+
+  /**
+   * @brief Get a batch of poses to check owned by the collision checker, to reuse its
+   * buffers across checks
+   * @return The batch, holding the poses of the last use
+   */
+  PoseBatch & getPoseBatch() {return pose_batch_;}
+
   /**
    * @brief Check if in collision with costmap and footprint at pose
    * @param i Index to search collision status of
@@ -92,6 +156,51 @@ public:
     const unsigned int & i,
     const bool & traverse_unknown);
 
+  /**
+   * @brief Cells swept by the footprint along a motion primitive, relative to the cell
+   * of its end pose
+   */
+  struct SweptFootprint
+  {
+    bool computed{false};
+    // Offsets of the cells of the poses checked and of the footprint's outline at them
+    std::vector<int> centers;
+    std::vector<int> outline;
+    int min_dx{0}, max_dx{0}, min_dy{0}, max_dy{0};
+  };
+
+  /**
+   * @brief Get the cells swept by the footprint along a lattice primitive, computed on
+   * first use for the current footprint and costmap from the poses more than a cell
+   * apart, as isNodeValid checked them one by one
+   * @param primitive Motion primitive, identified by its trajectory ID
+   * @param backwards Whether the robot is reversing along the primitive
+   * @param end_angle_bin Angle bin of the end pose in the collision checker
+   * @param grid_resolution Resolution of the primitive's poses
+   * @return Swept footprint, valid until the next call
+   */
+  const SweptFootprint & getSweptFootprint(
+    const MotionPrimitive & primitive,
+    const bool & backwards,
+    const float & end_angle_bin,
+    const float & grid_resolution);
+
+  /**
+   * @brief Check if in collision with costmap along a swept footprint. The poses are in
+   * collision as inCollision would find them, all at once: the footprint's outline is
+   * only gathered if any of their cells is possibly in collision.
+   * @param swept Swept footprint to check
+   * @param mx X of the cell the footprint was swept relative to
+   * @param my Y of the cell the footprint was swept relative to
+   * @param traverse_unknown Whether or not to traverse in unknown space
+   * @return boolean if in collision or not.
+   */
+  bool inCollision(
+    const SweptFootprint & swept,
+    const unsigned int & mx,
+    const unsigned int & my,
+    const bool & traverse_unknown);
+
   /**
    * @brief Get cost at footprint pose in costmap
    * @return the cost at the pose in costmap
@@ -123,13 +232,48 @@ private:
    */
   bool outsideRange(const unsigned int & max, const float & value);
 
+  /**
+   * @brief Check if in collision at a pose inside the map, given the cost of its cell
+   * @param mx X of the pose's cell
+   * @param my Y of the pose's cell
+   * @param angle_bin Angle bin number of the pose
+   * @param center_cost Cost of the pose's cell
+   * @param traverse_unknown Whether or not to traverse in unknown space
+   * @return boolean if in collision or not.
+   */
+  bool poseInCollision(
+    const unsigned int & mx,
+    const unsigned int & my,
+    const unsigned int & angle_bin,
+    const unsigned char & center_cost,
+    const bool & traverse_unknown);
+
+  /**
+   * @brief Gather the cells of a primitive's poses and their outlines into a swept footprint
+   */
+  void computeSweptFootprint(
+    const MotionPrimitive & primitive,
+    const bool & backwards,
+    const float & end_angle_bin,
+    const float & grid_resolution,
+    SweptFootprint & swept);
+
+  /**
+   * @brief Report that the inflation does not allow to skip footprint checks
+   */
+  void reportInsufficientInflation();
+
 protected:
   std::shared_ptr<nav2_costmap_2d::Costmap2DROS> costmap_ros_;
-  std::vector<nav2_costmap_2d::Footprint> oriented_footprints_;
   nav2_costmap_2d::Footprint unoriented_footprint_;
   float footprint_cost_;
-  bool footprint_is_radius_;
+  bool footprint_is_radius_{false};
   std::vector<float> angles_;
+  // Swept footprints by trajectory ID and direction, for the costmap's width and resolution
+  std::vector<SweptFootprint> swept_footprints_;
+  unsigned int swept_size_x_{0};
+  double swept_resolution_{0.0};
+  PoseBatch pose_batch_;
   float possible_collision_cost_{-1};
   rclcpp::Logger logger_{rclcpp::get_logger("SmacPlannerCollisionChecker")};
   rclcpp::Clock::SharedPtr clock_;
@@ -0,0 +1,681 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// The Dubins and Reeds-Shepp solvers are derived from the DubinsStateSpace and
+// ReedsSheppStateSpace of the Open Motion Planning Library, distributed under the
+// following license:
+//
+// Software License Agreement (BSD License)
+//
+// Copyright (c) 2010, Rice University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//  * Neither the name of the Rice University nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+// ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef NAV2_SMAC_PLANNER__CURVE_SOLVER_HPP_
+#define NAV2_SMAC_PLANNER__CURVE_SOLVER_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace nav2_smac_planner
+{
+
+/**
+ * @enum nav2_smac_planner::CurveSegment
+ * @brief Type of a segment of a Dubins or Reeds-Shepp path
+ */
+enum class CurveSegment : uint8_t
+{
+  LEFT = 0,
+  STRAIGHT = 1,
+  RIGHT = 2,
+  NONE = 3
+};
+
+/**
+ * @struct nav2_smac_planner::CurvePose
+ * @brief A pose of a Dubins or Reeds-Shepp path, angle in radians
+ */
+struct CurvePose
+{
+  double x;
+  double y;
+  double theta;
+};
+
+/**
+ * @struct nav2_smac_planner::CurvePath
+ * @brief A Dubins or Reeds-Shepp path of up to 5 segments, with lengths normalized by the
+ * turning radius, negative for segments travelled in reverse
+ */
+struct CurvePath
+{
+  const CurveSegment * segments{nullptr};
+  double lengths[5]{std::numeric_limits<double>::max(), 0.0, 0.0, 0.0, 0.0};
+  double length{std::numeric_limits<double>::max()};
+};
+
+/**
+ * @class nav2_smac_planner::CurveSolver
+ * @brief Closed-form shortest Dubins (forward only) or Reeds-Shepp (forward and reverse)
+ * paths between poses for a turning radius, evaluating all path types and sampling poses
+ * along a path with no allocation. Paths, distances and poses are those of the OMPL
+ * DubinsStateSpace and ReedsSheppStateSpace, after Shkel & Lumelsky for Dubins paths and
+ * Reeds & Shepp for Reeds-Shepp paths.
+ */
+class CurveSolver
+{
+public:
+  /**
+   * @brief A constructor for nav2_smac_planner::CurveSolver
+   * @param turning_radius Turning radius of the paths
+   * @param allow_reverse Whether to find Reeds-Shepp paths rather than Dubins paths
+   */
+  explicit CurveSolver(const double & turning_radius = 1.0, const bool & allow_reverse = false)
+  : _turning_radius(turning_radius), _allow_reverse(allow_reverse)
+  {
+  }
+
+  /**
+   * @brief Get the turning radius of the paths
+   * @return Turning radius
+   */
+  const double & getTurningRadius() const
+  {
+    return _turning_radius;
+  }
+
+  /**
+   * @brief Whether the paths are Reeds-Shepp paths, travelling in reverse too
+   * @return If reversing is allowed
+   */
+  const bool & isReverseAllowed() const
+  {
+    return _allow_reverse;
+  }
+
+  /**
+   * @brief Find the shortest path between two poses
+   * @param from Pose to start from
+   * @param to Pose to reach
+   * @return Shortest path
+   */
+  CurvePath solve(const CurvePose & from, const CurvePose & to) const
+  {
+    const double dx = to.x - from.x;
+    const double dy = to.y - from.y;
+    if (_allow_reverse) {
+      // In the frame of the start, normalized by the turning radius
+      const double c = std::cos(from.theta);
+      const double s = std::sin(from.theta);
+      return reedsShepp(
+        (c * dx + s * dy) / _turning_radius, (-s * dx + c * dy) / _turning_radius,
+        to.theta - from.theta);
+    }
+    const double d = std::sqrt(dx * dx + dy * dy) / _turning_radius;
+    const double th = std::atan2(dy, dx);
+    return dubins(d, dubinsMod2Pi(from.theta - th), dubinsMod2Pi(to.theta - th));
+  }
+
+  /**
+   * @brief Get the length of the shortest path between two poses
+   * @param from Pose to start from
+   * @param to Pose to reach
+   * @return Length of the shortest path
+   */
+  double distance(const CurvePose & from, const CurvePose & to) const
+  {
+    return _turning_radius * solve(from, to).length;
+  }
+
+  /**
+   * @brief Get the pose at a fraction of the length of a path
+   * @param path Path between the poses, from solve()
+   * @param from Pose the path starts from
+   * @param to Pose the path reaches
+   * @param t Fraction of the length of the path
+   * @return Pose along the path, its angle in [-pi, pi) unless at an end of the path
+   */
+  CurvePose interpolate(
+    const CurvePath & path, const CurvePose & from, const CurvePose & to, const double & t) const
+  {
+    if (t >= 1.0) {
+      return to;
+    }
+    if (t <= 0.0) {
+      return from;
+    }
+
+    // Travel the segments in the frame of the start, normalized by the turning radius
+    double seg = t * path.length;
+    double x = 0.0, y = 0.0, phi = from.theta, v;
+    for (unsigned int i = 0; i != 5 && seg > 0.0; i++) {
+      if (path.lengths[i] < 0.0) {
+        v = std::max(-seg, path.lengths[i]);
+        seg += v;
+      } else {
+        v = std::min(seg, path.lengths[i]);
+        seg -= v;
+      }
+      switch (path.segments[i]) {
+        case CurveSegment::LEFT:
+          x += std::sin(phi + v) - std::sin(phi);
+          y += -std::cos(phi + v) + std::cos(phi);
+          phi += v;
+          break;
+        case CurveSegment::RIGHT:
+          x += -std::sin(phi - v) + std::sin(phi);
+          y += std::cos(phi - v) - std::cos(phi);
+          phi -= v;
+          break;
+        case CurveSegment::STRAIGHT:
+          x += v * std::cos(phi);
+          y += v * std::sin(phi);
+          break;
+        case CurveSegment::NONE:
+          break;
+      }
+    }
+
+    CurvePose pose;
+    pose.x = x * _turning_radius + from.x;
+    pose.y = y * _turning_radius + from.y;
+    pose.theta = std::fmod(phi, 2.0 * M_PI);
+    if (pose.theta < -M_PI) {
+      pose.theta += 2.0 * M_PI;
+    } else if (pose.theta >= M_PI) {
+      pose.theta -= 2.0 * M_PI;
+    }
+    return pose;
+  }
+
+  /**
+   * @brief Sample poses evenly along a path, at the fractions 1/n, 2/n ... 1 of its length
+   * @param path Path between the poses, from solve()
+   * @param from Pose the path starts from
+   * @param to Pose the path reaches
+   * @param num_intervals Number n of intervals to sample the path at
+   * @param poses Buffer of at least n poses to store the poses in, the last being the goal
+   */
+  void sample(
+    const CurvePath & path, const CurvePose & from, const CurvePose & to,
+    const unsigned int & num_intervals, CurvePose * poses) const
+  {
+    for (unsigned int i = 1; i <= num_intervals; i++) {
+      poses[i - 1] = interpolate(
+        path, from, to, static_cast<double>(i) / static_cast<double>(num_intervals));
+    }
+  }
+
+protected:
+  static constexpr double DUBINS_EPS = 1e-6;
+  static constexpr double DUBINS_ZERO = -1e-7;
+  static constexpr double RS_ZERO = 10.0 * std::numeric_limits<double>::epsilon();
+
+  static inline const CurveSegment * dubinsSegments(const unsigned int & type)
+  {
+    static constexpr CurveSegment L = CurveSegment::LEFT;
+    static constexpr CurveSegment S = CurveSegment::STRAIGHT;
+    static constexpr CurveSegment R = CurveSegment::RIGHT;
+    static constexpr CurveSegment N = CurveSegment::NONE;
+    static constexpr CurveSegment TYPES[6][5] = {
+      {L, S, L, N, N}, {R, S, R, N, N}, {R, S, L, N, N},
+      {L, S, R, N, N}, {R, L, R, N, N}, {L, R, L, N, N}};
+    return TYPES[type];
+  }
+
+  static inline const CurveSegment * rsSegments(const unsigned int & type)
+  {
+    static constexpr CurveSegment L = CurveSegment::LEFT;
+    static constexpr CurveSegment S = CurveSegment::STRAIGHT;
+    static constexpr CurveSegment R = CurveSegment::RIGHT;
+    static constexpr CurveSegment N = CurveSegment::NONE;
+    static constexpr CurveSegment TYPES[18][5] = {
+      {L, R, L, N, N}, {R, L, R, N, N}, {L, R, L, R, N}, {R, L, R, L, N},
+      {L, R, S, L, N}, {R, L, S, R, N}, {L, S, R, L, N}, {R, S, L, R, N},
+      {L, R, S, R, N}, {R, L, S, L, N}, {R, S, R, L, N}, {L, S, L, R, N},
+      {L, S, R, N, N}, {R, S, L, N, N}, {L, S, L, N, N}, {R, S, R, N, N},
+      {L, R, S, L, R}, {R, L, S, R, L}};
+    return TYPES[type];
+  }
+
+  static inline CurvePath makePath(
+    const CurveSegment * segments, const double & t, const double & u, const double & v,
+    const double & w = 0.0, const double & x = 0.0)
+  {
+    CurvePath path;
+    path.segments = segments;
+    path.lengths[0] = t;
+    path.lengths[1] = u;
+    path.lengths[2] = v;
+    path.lengths[3] = w;
+    path.lengths[4] = x;
+    path.length = std::fabs(t) + std::fabs(u) + std::fabs(v) + std::fabs(w) + std::fabs(x);
+    return path;
+  }
+
+  // Dubins paths
+
+  static inline double dubinsMod2Pi(const double & x)
+  {
+    if (x < 0.0 && x > DUBINS_ZERO) {
+      return 0.0;
+    }
+    double xm = x - 2.0 * M_PI * std::floor(x / (2.0 * M_PI));
+    if (2.0 * M_PI - xm < 0.5 * DUBINS_EPS) {
+      xm = 0.0;
+    }
+    return xm;
+  }
+
+  static inline CurvePath dubins(const double & d, const double & alpha, const double & beta)
+  {
+    if (d < DUBINS_EPS && std::fabs(alpha - beta) < DUBINS_EPS) {
+      return makePath(dubinsSegments(0), 0.0, d, 0.0);
+    }
+
+    const double ca = std::cos(alpha), sa = std::sin(alpha);
+    const double cb = std::cos(beta), sb = std::sin(beta);
+    CurvePath path;
+    path.segments = dubinsSegments(0);
+    double tmp, theta, t, p, q;
+
+    // LSL
+    tmp = 2.0 + d * d - 2.0 * (ca * cb + sa * sb - d * (sa - sb));
+    if (tmp >= DUBINS_ZERO) {
+      theta = std::atan2(cb - ca, d + sa - sb);
+      t = dubinsMod2Pi(-alpha + theta);
+      p = std::sqrt(std::max(tmp, 0.0));
+      q = dubinsMod2Pi(beta - theta);
+      keepShortest(path, makePath(dubinsSegments(0), t, p, q));
+    }
+
+    // RSR
+    tmp = 2.0 + d * d - 2.0 * (ca * cb + sa * sb - d * (sb - sa));
+    if (tmp >= DUBINS_ZERO) {
+      theta = std::atan2(ca - cb, d - sa + sb);
+      t = dubinsMod2Pi(alpha - theta);
+      p = std::sqrt(std::max(tmp, 0.0));
+      q = dubinsMod2Pi(-beta + theta);
+      keepShortest(path, makePath(dubinsSegments(1), t, p, q));
+    }
+
+    // RSL
+    tmp = d * d - 2.0 + 2.0 * (ca * cb + sa * sb - d * (sa + sb));
+    if (tmp >= DUBINS_ZERO) {
+      p = std::sqrt(std::max(tmp, 0.0));
+      theta = std::atan2(ca + cb, d - sa - sb) - std::atan2(2.0, p);
+      t = dubinsMod2Pi(alpha - theta);
+      q = dubinsMod2Pi(beta - theta);
+      keepShortest(path, makePath(dubinsSegments(2), t, p, q));
+    }
+
+    // LSR
+    tmp = -2.0 + d * d + 2.0 * (ca * cb + sa * sb + d * (sa + sb));
+    if (tmp >= DUBINS_ZERO) {
+      p = std::sqrt(std::max(tmp, 0.0));
+      theta = std::atan2(-ca - cb, d + sa + sb) - std::atan2(-2.0, p);
+      t = dubinsMod2Pi(-alpha + theta);
+      q = dubinsMod2Pi(-beta + theta);
+      keepShortest(path, makePath(dubinsSegments(3), t, p, q));
+    }
+
+    // RLR
+    tmp = 0.125 * (6.0 - d * d + 2.0 * (ca * cb + sa * sb + d * (sa - sb)));
+    if (std::fabs(tmp) < 1.0) {
+      p = 2.0 * M_PI - std::acos(tmp);
+      theta = std::atan2(ca - cb, d - sa + sb);
+      t = dubinsMod2Pi(alpha - theta + 0.5 * p);
+      q = dubinsMod2Pi(alpha - beta - t + p);
+      keepShortest(path, makePath(dubinsSegments(4), t, p, q));
+    }
+
+    // LRL
+    tmp = 0.125 * (6.0 - d * d + 2.0 * (ca * cb + sa * sb - d * (sa - sb)));
+    if (std::fabs(tmp) < 1.0) {
+      p = 2.0 * M_PI - std::acos(tmp);
+      theta = std::atan2(-ca + cb, d + sa - sb);
+      t = dubinsMod2Pi(-alpha + theta + 0.5 * p);
+      q = dubinsMod2Pi(beta - alpha - t + p);
+      keepShortest(path, makePath(dubinsSegments(5), t, p, q));
+    }
+
+    return path;
+  }
+
+  // Reeds-Shepp paths, numbered after the formulas of the paper. Each is tried as is, time
+  // flipped (travelled in reverse), reflected (turning the other way) and both.
+
+  static inline double rsMod2Pi(const double & x)
+  {
+    double v = std::fmod(x, 2.0 * M_PI);
+    if (v < -M_PI) {
+      v += 2.0 * M_PI;
+    } else if (v > M_PI) {
+      v -= 2.0 * M_PI;
+    }
+    return v;
+  }
+
+  static inline void polar(const double & x, const double & y, double & r, double & theta)
+  {
+    r = std::sqrt(x * x + y * y);
+    theta = std::atan2(y, x);
+  }
+
+  static inline void tauOmega(
+    const double & u, const double & v, const double & xi, const double & eta,
+    const double & phi, double & tau, double & omega)
+  {
+    const double delta = rsMod2Pi(u - v);
+    const double a = std::sin(u) - std::sin(delta);
+    const double b = std::cos(u) - std::cos(delta) - 1.0;
+    const double t1 = std::atan2(eta * a - xi * b, xi * a + eta * b);
+    const double t2 = 2.0 * (std::cos(delta) - std::cos(v) - std::cos(u)) + 3.0;
+    tau = (t2 < 0.0) ? rsMod2Pi(t1 + M_PI) : rsMod2Pi(t1);
+    omega = rsMod2Pi(tau - u + v - phi);
+  }
+
+  // Formula 8.1
+  static inline bool LpSpLp(
+    const double & x, const double & y, const double & phi, double & t, double & u, double & v)
+  {
+    polar(x - std::sin(phi), y - 1.0 + std::cos(phi), u, t);
+    if (t >= -RS_ZERO) {
+      v = rsMod2Pi(phi - t);
+      if (v >= -RS_ZERO) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Formula 8.2
+  static inline bool LpSpRp(
+    const double & x, const double & y, const double & phi, double & t, double & u, double & v)
+  {
+    double t1, u1;
+    polar(x + std::sin(phi), y - 1.0 - std::cos(phi), u1, t1);
+    u1 = u1 * u1;
+    if (u1 >= 4.0) {
+      u = std::sqrt(u1 - 4.0);
+      const double theta = std::atan2(2.0, u);
+      t = rsMod2Pi(t1 + theta);
+      v = rsMod2Pi(t - phi);
+      return t >= -RS_ZERO && v >= -RS_ZERO;
+    }
+    return false;
+  }
+
+  // Formulas 8.3 and 8.4, correcting a typo of the paper
+  static inline bool LpRmL(
+    const double & x, const double & y, const double & phi, double & t, double & u, double & v)
+  {
+    const double xi = x - std::sin(phi), eta = y - 1.0 + std::cos(phi);
+    double u1, theta;
+    polar(xi, eta, u1, theta);
+    if (u1 <= 4.0) {
+      u = -2.0 * std::asin(0.25 * u1);
+      t = rsMod2Pi(theta + 0.5 * u + M_PI);
+      v = rsMod2Pi(phi - t + u);
+      return t >= -RS_ZERO && u <= RS_ZERO;
+    }
+    return false;
+  }
+
+  // Formula 8.7
+  static inline bool LpRupLumRm(
+    const double & x, const double & y, const double & phi, double & t, double & u, double & v)
+  {
+    const double xi = x + std::sin(phi), eta = y - 1.0 - std::cos(phi);
+    const double rho = 0.25 * (2.0 + std::sqrt(xi * xi + eta * eta));
+    if (rho <= 1.0) {
+      u = std::acos(rho);
+      tauOmega(u, -u, xi, eta, phi, t, v);
+      return t >= -RS_ZERO && v <= RS_ZERO;
+    }
+    return false;
+  }
+
+  // Formula 8.8
+  static inline bool LpRumLumRp(
+    const double & x, const double & y, const double & phi, double & t, double & u, double & v)
+  {
+    const double xi = x + std::sin(phi), eta = y - 1.0 - std::cos(phi);
+    const double rho = (20.0 - xi * xi - eta * eta) / 16.0;
+    if (rho >= 0.0 && rho <= 1.0) {
+      u = -std::acos(rho);
+      if (u >= -0.5 * M_PI) {
+        tauOmega(u, u, xi, eta, phi, t, v);
+        return t >= -RS_ZERO && v >= -RS_ZERO;
+      }
+    }
+    return false;
+  }
+
+  // Formula 8.9
+  static inline bool LpRmSmLm(
+    const double & x, const double & y, const double & phi, double & t, double & u, double & v)
+  {
+    const double xi = x - std::sin(phi), eta = y - 1.0 + std::cos(phi);
+    double rho, theta;
+    polar(xi, eta, rho, theta);
+    if (rho >= 2.0) {
+      const double r = std::sqrt(rho * rho - 4.0);
+      u = 2.0 - r;
+      t = rsMod2Pi(theta + std::atan2(r, -2.0));
+      v = rsMod2Pi(phi - 0.5 * M_PI - t);
+      return t >= -RS_ZERO && u <= RS_ZERO && v <= RS_ZERO;
+    }
+    return false;
+  }
+
+  // Formula 8.10
+  static inline bool LpRmSmRm(
+    const double & x, const double & y, const double & phi, double & t, double & u, double & v)
+  {
+    const double xi = x + std::sin(phi), eta = y - 1.0 - std::cos(phi);
+    double rho, theta;
+    polar(-eta, xi, rho, theta);
+    if (rho >= 2.0) {
+      t = theta;
+      u = 2.0 - rho;
+      v = rsMod2Pi(t + 0.5 * M_PI - phi);
+      return t >= -RS_ZERO && u <= RS_ZERO && v <= RS_ZERO;
+    }
+    return false;
+  }
+
+  // Formula 8.11, correcting a typo of the paper
+  static inline bool LpRmSLmRp(
+    const double & x, const double & y, const double & phi, double & t, double & u, double & v)
+  {
+    const double xi = x + std::sin(phi), eta = y - 1.0 - std::cos(phi);
+    double rho, theta;
+    polar(xi, eta, rho, theta);
+    if (rho >= 2.0) {
+      u = 4.0 - std::sqrt(rho * rho - 4.0);
+      if (u <= RS_ZERO) {
+        t = rsMod2Pi(std::atan2((4.0 - u) * xi - 2.0 * eta, -2.0 * xi + (u - 4.0) * eta));
+        v = rsMod2Pi(t - phi);
+        return t >= -RS_ZERO && v >= -RS_ZERO;
+      }
+    }
+    return false;
+  }
+
+  static inline void keepShortest(CurvePath & path, const CurvePath & candidate)
+  {
+    if (candidate.length < path.length) {
+      path = candidate;
+    }
+  }
+
+  static inline CurvePath reedsShepp(const double & x, const double & y, const double & phi)
+  {
+    static constexpr double H = 0.5 * M_PI;
+    CurvePath path;
+    path.segments = rsSegments(0);
+    double t, u, v;
+
+    // CSC
+    if (LpSpLp(x, y, phi, t, u, v)) {keepShortest(path, makePath(rsSegments(14), t, u, v));}
+    if (LpSpLp(-x, y, -phi, t, u, v)) {keepShortest(path, makePath(rsSegments(14), -t, -u, -v));}
+    if (LpSpLp(x, -y, -phi, t, u, v)) {keepShortest(path, makePath(rsSegments(15), t, u, v));}
+    if (LpSpLp(-x, -y, phi, t, u, v)) {keepShortest(path, makePath(rsSegments(15), -t, -u, -v));}
+    if (LpSpRp(x, y, phi, t, u, v)) {keepShortest(path, makePath(rsSegments(12), t, u, v));}
+    if (LpSpRp(-x, y, -phi, t, u, v)) {keepShortest(path, makePath(rsSegments(12), -t, -u, -v));}
+    if (LpSpRp(x, -y, -phi, t, u, v)) {keepShortest(path, makePath(rsSegments(13), t, u, v));}
+    if (LpSpRp(-x, -y, phi, t, u, v)) {keepShortest(path, makePath(rsSegments(13), -t, -u, -v));}
+
+    // CCC, also backwards from the goal
+    const double xb = x * std::cos(phi) + y * std::sin(phi);
+    const double yb = x * std::sin(phi) - y * std::cos(phi);
+    if (LpRmL(x, y, phi, t, u, v)) {keepShortest(path, makePath(rsSegments(0), t, u, v));}
+    if (LpRmL(-x, y, -phi, t, u, v)) {keepShortest(path, makePath(rsSegments(0), -t, -u, -v));}
+    if (LpRmL(x, -y, -phi, t, u, v)) {keepShortest(path, makePath(rsSegments(1), t, u, v));}
+    if (LpRmL(-x, -y, phi, t, u, v)) {keepShortest(path, makePath(rsSegments(1), -t, -u, -v));}
+    if (LpRmL(xb, yb, phi, t, u, v)) {keepShortest(path, makePath(rsSegments(0), v, u, t));}
+    if (LpRmL(-xb, yb, -phi, t, u, v)) {keepShortest(path, makePath(rsSegments(0), -v, -u, -t));}
+    if (LpRmL(xb, -yb, -phi, t, u, v)) {keepShortest(path, makePath(rsSegments(1), v, u, t));}
+    if (LpRmL(-xb, -yb, phi, t, u, v)) {keepShortest(path, makePath(rsSegments(1), -v, -u, -t));}
+
+    // CCCC
+    if (LpRupLumRm(x, y, phi, t, u, v)) {
+      keepShortest(path, makePath(rsSegments(2), t, u, -u, v));
+    }
+    if (LpRupLumRm(-x, y, -phi, t, u, v)) {
+      keepShortest(path, makePath(rsSegments(2), -t, -u, u, -v));
+    }
+    if (LpRupLumRm(x, -y, -phi, t, u, v)) {
+      keepShortest(path, makePath(rsSegments(3), t, u, -u, v));
+    }
+    if (LpRupLumRm(-x, -y, phi, t, u, v)) {
+      keepShortest(path, makePath(rsSegments(3), -t, -u, u, -v));
+    }
+    if (LpRumLumRp(x, y, phi, t, u, v)) {
+      keepShortest(path, makePath(rsSegments(2), t, u, u, v));
+    }
+    if (LpRumLumRp(-x, y, -phi, t, u, v)) {
+      keepShortest(path, makePath(rsSegments(2), -t, -u, -u, -v));
+    }
+    if (LpRumLumRp(x, -y, -phi, t, u, v)) {
+      keepShortest(path, makePath(rsSegments(3), t, u, u, v));
+    }
+    if (LpRumLumRp(-x, -y, phi, t, u, v)) {
+      keepShortest(path, makePath(rsSegments(3), -t, -u, -u, -v));
+    }
+
+    // CCSC with a quarter turn, also backwards from the goal
+    if (LpRmSmLm(x, y, phi, t, u, v)) {
+      keepShortest(path, makePath(rsSegments(4), t, -H, u, v));
+    }
+    if (LpRmSmLm(-x, y, -phi, t, u, v)) {
+      keepShortest(path, makePath(rsSegments(4), -t, H, -u, -v));
+    }
+    if (LpRmSmLm(x, -y, -phi, t, u, v)) {
+      keepShortest(path, makePath(rsSegments(5), t, -H, u, v));
+    }
+    if (LpRmSmLm(-x, -y, phi, t, u, v)) {
+      keepShortest(path, makePath(rsSegments(5), -t, H, -u, -v));
+    }
+    if (LpRmSmRm(x, y, phi, t, u, v)) {
+      keepShortest(path, makePath(rsSegments(8), t, -H, u, v));
+    }
+    if (LpRmSmRm(-x, y, -phi, t, u, v)) {
+      keepShortest(path, makePath(rsSegments(8), -t, H, -u, -v));
+    }
+    if (LpRmSmRm(x, -y, -phi, t, u, v)) {
+      keepShortest(path, makePath(rsSegments(9), t, -H, u, v));
+    }
+    if (LpRmSmRm(-x, -y, phi, t, u, v)) {
+      keepShortest(path, makePath(rsSegments(9), -t, H, -u, -v));
+    }
+    if (LpRmSmLm(xb, yb, phi, t, u, v)) {
+      keepShortest(path, makePath(rsSegments(6), v, u, -H, t));
+    }
+    if (LpRmSmLm(-xb, yb, -phi, t, u, v)) {
+      keepShortest(path, makePath(rsSegments(6), -v, -u, H, -t));
+    }
+    if (LpRmSmLm(xb, -yb, -phi, t, u, v)) {
+      keepShortest(path, makePath(rsSegments(7), v, u, -H, t));
+    }
+    if (LpRmSmLm(-xb, -yb, phi, t, u, v)) {
+      keepShortest(path, makePath(rsSegments(7), -v, -u, H, -t));
+    }
+    if (LpRmSmRm(xb, yb, phi, t, u, v)) {
+      keepShortest(path, makePath(rsSegments(10), v, u, -H, t));
+    }
+    if (LpRmSmRm(-xb, yb, -phi, t, u, v)) {
+      keepShortest(path, makePath(rsSegments(10), -v, -u, H, -t));
+    }
+    if (LpRmSmRm(xb, -yb, -phi, t, u, v)) {
+      keepShortest(path, makePath(rsSegments(11), v, u, -H, t));
+    }
+    if (LpRmSmRm(-xb, -yb, phi, t, u, v)) {
+      keepShortest(path, makePath(rsSegments(11), -v, -u, H, -t));
+    }
+
+    // CCSCC with two quarter turns
+    if (LpRmSLmRp(x, y, phi, t, u, v)) {
+      keepShortest(path, makePath(rsSegments(16), t, -H, u, -H, v));
+    }
+    if (LpRmSLmRp(-x, y, -phi, t, u, v)) {
+      keepShortest(path, makePath(rsSegments(16), -t, H, -u, H, -v));
+    }
+    if (LpRmSLmRp(x, -y, -phi, t, u, v)) {
+      keepShortest(path, makePath(rsSegments(17), t, -H, u, -H, v));
+    }
+    if (LpRmSLmRp(-x, -y, phi, t, u, v)) {
+      keepShortest(path, makePath(rsSegments(17), -t, H, -u, H, -v));
+    }
+
+    return path;
+  }
+
+  double _turning_radius;
+  bool _allow_reverse;
+};
+
+}  // namespace nav2_smac_planner
+
+#endif  // NAV2_SMAC_PLANNER__CURVE_SOLVER_HPP_
@@ -0,0 +1,223 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License. Reserved.
+
+#ifndef NAV2_SMAC_PLANNER__D_STAR_LITE_HPP_
+#define NAV2_SMAC_PLANNER__D_STAR_LITE_HPP_
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "nav2_smac_planner/collision_checker.hpp"
+#include "nav2_smac_planner/node_2d.hpp"
+#include "nav2_smac_planner/node_queue.hpp"
+
+namespace nav2_smac_planner
+{
+
+/**
+ * @class nav2_smac_planner::DStarLite
+ * @brief An incremental search of the 2D grid (D* Lite) for replanning to a fixed goal
+ * from a moving start. The search runs from the goal and is kept across plans, so that
+ * a plan only repairs it where costmap cells changed since the last one. Paths and their
+ * costs are the same as those of the 2D A* search.
+ */
+class DStarLite
+{
+public:
+  typedef Node2D::Coordinates Coordinates;
+  typedef Node2D::CoordinateVector CoordinateVector;
+  typedef std::pair<double, double> Key;
+  typedef std::pair<Key, unsigned int> QueueElement;
+
+  /**
+   * @struct nav2_smac_planner::DStarLite::QueueComparator
+   * @brief Key comparison for priority queue sorting
+   */
+  struct QueueComparator
+  {
+    bool operator()(const QueueElement & a, const QueueElement & b) const
+    {
+      return a.first > b.first;
+    }
+  };
+
+  typedef DAryHeap<QueueElement, QueueComparator> Queue;
+
+  /**
+   * @brief A constructor for nav2_smac_planner::DStarLite
+   */
+  DStarLite();
+
+  /**
+   * @brief Initialization of the planner, dropping any search kept
+   * @param allow_unknown Allow search in unknown space, good for navigation while mapping
+   * @param max_iterations Maximum number of iterations to use while expanding search
+   * @param terminal_checking_interval Number of iterations to check if the task has been
+   * canceled or planning time exceeded
+   * @param max_planning_time Maximum time (in seconds) to wait for a plan, createPath returns
+   * false after this timeout
+   * @param cost_penalty Penalty on the costmap cost of cells travelled, as for Node2D
+   * @param open_list_arity Number of children of each node of the open list heap
+   */
+  void initialize(
+    const bool & allow_unknown,
+    const int & max_iterations,
+    const int & terminal_checking_interval,
+    const double & max_planning_time,
+    const float & cost_penalty,
+    const unsigned int & open_list_arity = 2);
+
+  /**
+   * @brief Sets the collision checker to use, dropping the search kept if the size
+   * of its costmap changed
+   * @param collision_checker Collision checker to use for checking state validity
+   */
+  void setCollisionChecker(GridCollisionChecker * collision_checker);
+
+  /**
+   * @brief Set the goal for planning, dropping the search kept if it is another cell
+   * @param mx The node X index of the goal
+   * @param my The node Y index of the goal
+   */
+  void setGoal(const unsigned int & mx, const unsigned int & my);
+
+  /**
+   * @brief Set the start for planning
+   * @param mx The node X index of the start
+   * @param my The node Y index of the start
+   */
+  void setStart(const unsigned int & mx, const unsigned int & my);
+
+  /**
+   * @brief Notify the search of costmap cells which may have changed since the last plan
+   * @param x0 Lower x-boundary of the changed cells (inclusive)
+   * @param xn Upper x-boundary of the changed cells (exclusive)
+   * @param y0 Lower y-boundary of the changed cells (inclusive)
+   * @param yn Upper y-boundary of the changed cells (exclusive)
+   */
+  void updateCells(
+    const unsigned int & x0, const unsigned int & xn,
+    const unsigned int & y0, const unsigned int & yn);
+
+  /**
+   * @brief Drop the search kept, for the next plan to search from scratch
+   */
+  void clear();
+
+  /**
+   * @brief Creating path from the start to the goal, repairing the search kept. If it
+   * runs out of iterations or time its progress is kept for the next plan.
+   * @param path Reference to a vector of coordinates of the path, from the goal to the start
+   * @param num_iterations Reference to number of iterations to create plan
+   * @param cancel_checker Function to check if the task has been canceled
+   * @return if plan was successful
+   */
+  bool createPath(
+    CoordinateVector & path, int & num_iterations, std::function<bool()> cancel_checker);
+
+  /**
+   * @brief Get maximum number of iterations to plan
+   * @return Maximum number of iterations
+   */
+  int & getMaxIterations();
+
+protected:
+  /**
+   * @brief Get the key of a cell in the open set
+   * @param index Cell index
+   * @return Key of the cell
+   */
+  inline Key calculateKey(const unsigned int & index);
+
+  /**
+   * @brief Get the heuristic cost between two cells
+   * @param a Index of the first cell
+   * @param b Index of the second cell
+   * @return Heuristic cost
+   */
+  inline double getHeuristicCost(const unsigned int & a, const unsigned int & b);
+
+  /**
+   * @brief Get the cost factor of travelling into a cell, evaluating it on first use
+   * @param index Cell index
+   * @return Cost factor of the cell, infinite if it is not traversable
+   */
+  inline double getCellFactor(const unsigned int & index);
+
+  /**
+   * @brief Evaluate the cost factor of travelling into a cell in the costmap
+   * @param index Cell index
+   * @return Cost factor of the cell, infinite if it is not traversable
+   */
+  inline double evaluateCellFactor(const unsigned int & index);
+
+  /**
+   * @brief Recompute the lookahead cost of a cell and queue it if inconsistent
+   * @param index Cell index
+   */
+  inline void updateVertex(const unsigned int & index);
+
+  /**
+   * @brief Update the lookahead costs of the neighbors of a cell
+   * @param index Cell index
+   */
+  inline void updateNeighbors(const unsigned int & index);
+
+  /**
+   * @brief Drop the queue entries of cells which became consistent since queued
+   * @return Whether the queue still has entries
+   */
+  inline bool cleanQueueTop();
+
+  /**
+   * @brief Run the search until the cost of the start is consistent
+   * @param num_iterations Reference to number of iterations run
+   * @param cancel_checker Function to check if the task has been canceled
+   * @return Whether the search completed within its iterations and time
+   */
+  bool computeShortestPath(int & num_iterations, std::function<bool()> & cancel_checker);
+
+  /**
+   * @brief Resize the search to the costmap, if needed, and drop its contents
+   */
+  void resetSearch();
+
+  GridCollisionChecker * _collision_checker;
+  nav2_costmap_2d::Costmap2D * _costmap;
+  bool _traverse_unknown;
+  int _max_iterations;
+  int _terminal_checking_interval;
+  double _max_planning_time;
+  float _cost_penalty;
+
+  unsigned int _x_size;
+  unsigned int _y_size;
+  bool _search_valid;
+  unsigned int _start;
+  unsigned int _goal;
+  unsigned int _last_start;
+  double _key_modifier;
+
+  // Cost to the goal, lookahead cost to the goal and cost factor of each cell, the factor
+  // is NaN until evaluated. Costs are summed over long paths, so they are kept in doubles.
+  std::vector<double> _g;
+  std::vector<double> _rhs;
+  std::vector<float> _cell_factors;
+  Queue _queue;
+};
+
+}  // namespace nav2_smac_planner
+
+#endif  // NAV2_SMAC_PLANNER__D_STAR_LITE_HPP_
@@ -0,0 +1,125 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef NAV2_SMAC_PLANNER__EXPANSIONS_LOG_HPP_
+#define NAV2_SMAC_PLANNER__EXPANSIONS_LOG_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace nav2_smac_planner
+{
+
+/**
+ * @class nav2_smac_planner::ExpansionsLog
+ * @brief Debug log of the poses expanded by a search, kept in a ring buffer allocated once,
+ * so logging costs the search a few stores per expansion. Every stride-th expansion is
+ * logged, and once full the oldest ones are overwritten, keeping those which led to the end
+ * of the search.
+ */
+class ExpansionsLog
+{
+public:
+  /**
+   * @brief Pose expanded, in the global frame
+   */
+  struct Expansion
+  {
+    float x;
+    float y;
+    float theta;
+  };
+
+  /**
+   * @brief A constructor for nav2_smac_planner::ExpansionsLog
+   * @param capacity Number of expansions kept
+   * @param stride Log one expansion in this many
+   */
+  explicit ExpansionsLog(size_t capacity = 0, unsigned int stride = 1)
+  : expansions_(capacity), stride_(std::max(stride, 1u))
+  {
+  }
+
+  /**
+   * @brief Log an expansion
+   * @param x X of the pose in the global frame
+   * @param y Y of the pose in the global frame
+   * @param theta Orientation of the pose in radians
+   */
+  inline void add(float x, float y, float theta)
+  {
+    if (num_expansions_++ % stride_ != 0 || expansions_.empty()) {
+      return;
+    }
+    expansions_[next_] = Expansion{x, y, theta};
+    next_ = next_ + 1 == expansions_.size() ? 0 : next_ + 1;
+    size_ = std::min(size_ + 1, expansions_.size());
+  }
+
+  /**
+   * @brief Drop the expansions logged, keeping the buffer
+   */
+  void clear()
+  {
+    next_ = size_ = num_expansions_ = 0;
+  }
+
+  /**
+   * @brief Get the number of expansions kept
+   * @return Number of expansions
+   */
+  size_t size() const {return size_;}
+
+  /**
+   * @brief Get the number of expansions since the last clear(), logged or not
+   * @return Number of expansions
+   */
+  size_t getNumExpansions() const {return num_expansions_;}
+
+  /**
+   * @brief Get an expansion kept
+   * @param i Index of the expansion, from the oldest kept
+   * @return Expansion
+   */
+  const Expansion & operator[](size_t i) const
+  {
+    return expansions_[(next_ + expansions_.size() - size_ + i) % expansions_.size()];
+  }
+
+  /**
+   * @brief Exchange the expansions and buffers of two logs, without copying them
+   * @param other Log to exchange with
+   */
+  void swap(ExpansionsLog & other)
+  {
+    expansions_.swap(other.expansions_);
+    std::swap(stride_, other.stride_);
+    std::swap(next_, other.next_);
+    std::swap(size_, other.size_);
+    std::swap(num_expansions_, other.num_expansions_);
+  }
+
+protected:
+  std::vector<Expansion> expansions_;
+  unsigned int stride_;
+  size_t next_{0};
+  size_t size_{0};
+  size_t num_expansions_{0};
+};
+
+}  // namespace nav2_smac_planner
+
+#endif  // NAV2_SMAC_PLANNER__EXPANSIONS_LOG_HPP_
@@ -0,0 +1,102 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef NAV2_SMAC_PLANNER__EXPANSIONS_PUBLISHER_HPP_
+#define NAV2_SMAC_PLANNER__EXPANSIONS_PUBLISHER_HPP_
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "nav2_smac_planner/expansions_log.hpp"
+#include "nav2_util/lifecycle_node.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp_lifecycle/lifecycle_publisher.hpp"
+#include "sensor_msgs/msg/point_cloud2.hpp"
+
+namespace nav2_smac_planner
+{
+
+/**
+ * @class nav2_smac_planner::ExpansionsPublisher
+ * @brief Publishes the expansions of the searches of a planner as a point cloud of their
+ * x, y and yaw, from a thread of its own. The planning thread only exchanges its log with
+ * the one last published, so publishing does not change the timing of the plans.
+ */
+class ExpansionsPublisher
+{
+public:
+  /**
+   * @brief A constructor for nav2_smac_planner::ExpansionsPublisher, starting its thread
+   * @param node Node to publish on the expansions topic of
+   * @param global_frame Frame of the expansions
+   * @param capacity Number of expansions kept of each search
+   * @param stride Log one expansion in this many
+   */
+  ExpansionsPublisher(
+    const rclcpp_lifecycle::LifecycleNode::SharedPtr & node, const std::string & global_frame,
+    size_t capacity, unsigned int stride);
+
+  /**
+   * @brief A destructor for nav2_smac_planner::ExpansionsPublisher, stopping its thread
+   */
+  ~ExpansionsPublisher();
+
+  /**
+   * @brief Activate the publisher
+   */
+  void on_activate();
+
+  /**
+   * @brief Deactivate the publisher
+   */
+  void on_deactivate();
+
+  /**
+   * @brief Get the log for the next search, cleared
+   * @return Log, owned by the publisher, to be filled by the planning thread only
+   */
+  ExpansionsLog * startLog();
+
+  /**
+   * @brief Hand the log over to the thread for publication. The log is dropped if the
+   * previous one is still being published or no one subscribes to the expansions.
+   * @param stamp Stamp of the expansions
+   */
+  void publish(const rclcpp::Time & stamp);
+
+protected:
+  /**
+   * @brief Publish the logs handed over, until the publisher is destroyed
+   */
+  void publishLoop();
+
+  rclcpp_lifecycle::LifecyclePublisher<sensor_msgs::msg::PointCloud2>::SharedPtr publisher_;
+  std::string global_frame_;
+  ExpansionsLog log_;
+  ExpansionsLog pending_log_;
+  rclcpp::Time pending_stamp_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool publish_requested_{false};
+  bool shutdown_{false};
+  std::unique_ptr<std::thread> thread_;
+};
+
+}  // namespace nav2_smac_planner
+
+#endif  // NAV2_SMAC_PLANNER__EXPANSIONS_PUBLISHER_HPP_
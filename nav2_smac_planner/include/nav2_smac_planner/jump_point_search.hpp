@@ -0,0 +1,258 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef NAV2_SMAC_PLANNER__JUMP_POINT_SEARCH_HPP_
+#define NAV2_SMAC_PLANNER__JUMP_POINT_SEARCH_HPP_
+
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "nav2_smac_planner/collision_checker.hpp"
+#include "nav2_smac_planner/node_2d.hpp"
+#include "nav2_smac_planner/node_queue.hpp"
+
+namespace nav2_smac_planner
+{
+
+/**
+ * @class nav2_smac_planner::JumpPointSearch
+ * @brief A Jump Point Search of the 2D grid. Within regions of identical cost, only the
+ * cells where the direction of an optimal path may change are expanded, jumping over the
+ * runs of cells in between, while cells next to a change of cost are expanded as by A*.
+ * Paths and their costs are the same as those of the 2D A* search. The distances of the
+ * straight jumps from each cell are kept between plans and updated where the costmap
+ * changed.
+ */
+class JumpPointSearch
+{
+public:
+  typedef Node2D::Coordinates Coordinates;
+  typedef Node2D::CoordinateVector CoordinateVector;
+  typedef std::pair<double, unsigned int> QueueElement;
+
+  /**
+   * @struct nav2_smac_planner::JumpPointSearch::QueueComparator
+   * @brief Priority comparison for priority queue sorting
+   */
+  struct QueueComparator
+  {
+    bool operator()(const QueueElement & a, const QueueElement & b) const
+    {
+      return a.first > b.first;
+    }
+  };
+
+  typedef DAryHeap<QueueElement, QueueComparator> Queue;
+
+  /**
+   * @brief A constructor for nav2_smac_planner::JumpPointSearch
+   */
+  JumpPointSearch();
+
+  /**
+   * @brief Initialization of the planner
+   * @param allow_unknown Allow search in unknown space, good for navigation while mapping
+   * @param max_iterations Maximum number of iterations to use while expanding search
+   * @param terminal_checking_interval Number of iterations to check if the task has been
+   * canceled or planning time exceeded
+   * @param max_planning_time Maximum time (in seconds) to wait for a plan
+   * @param cost_penalty Penalty on the costmap cost of cells travelled, as for Node2D
+   * @param open_list_arity Number of children of each node of the open list heap
+   */
+  void initialize(
+    const bool & allow_unknown,
+    const int & max_iterations,
+    const int & terminal_checking_interval,
+    const double & max_planning_time,
+    const float & cost_penalty,
+    const unsigned int & open_list_arity = 2);
+
+  /**
+   * @brief Sets the collision checker to use, dropping the jump distances if the size
+   * of its costmap changed
+   * @param collision_checker Collision checker to use for checking state validity
+   */
+  void setCollisionChecker(GridCollisionChecker * collision_checker);
+
+  /**
+   * @brief Set the goal for planning
+   * @param mx The node X index of the goal
+   * @param my The node Y index of the goal
+   */
+  void setGoal(const unsigned int & mx, const unsigned int & my);
+
+  /**
+   * @brief Set the start for planning
+   * @param mx The node X index of the start
+   * @param my The node Y index of the start
+   */
+  void setStart(const unsigned int & mx, const unsigned int & my);
+
+  /**
+   * @brief Notify the search of costmap cells which may have changed since the last plan
+   * @param x0 Lower x-boundary of the changed cells (inclusive)
+   * @param xn Upper x-boundary of the changed cells (exclusive)
+   * @param y0 Lower y-boundary of the changed cells (inclusive)
+   * @param yn Upper y-boundary of the changed cells (exclusive)
+   */
+  void updateCells(
+    const unsigned int & x0, const unsigned int & xn,
+    const unsigned int & y0, const unsigned int & yn);
+
+  /**
+   * @brief Drop the jump distances kept, for the next plan to compute them from scratch
+   */
+  void clear();
+
+  /**
+   * @brief Creating path from the start to the goal
+   * @param path Reference to a vector of coordinates of the path, from the goal to the start
+   * @param num_iterations Reference to number of iterations to create plan
+   * @param cancel_checker Function to check if the task has been canceled
+   * @return if plan was successful
+   */
+  bool createPath(
+    CoordinateVector & path, int & num_iterations, std::function<bool()> cancel_checker);
+
+  /**
+   * @brief Get maximum number of iterations to plan
+   * @return Maximum number of iterations
+   */
+  int & getMaxIterations();
+
+protected:
+  /**
+   * @brief Get the heuristic cost between two cells
+   * @param a Index of the first cell
+   * @param b Index of the second cell
+   * @return Heuristic cost
+   */
+  inline double getHeuristicCost(const unsigned int & a, const unsigned int & b);
+
+  /**
+   * @brief Evaluate the cost factor of travelling into a cell
+   * @param index Cell index
+   * @return Cost factor of the cell, infinite if it is not traversable
+   */
+  inline float evaluateCellFactor(const unsigned int & index);
+
+  /**
+   * @brief Get the cost factor of travelling into a cell, infinite if it is outside
+   * of the costmap or not traversable
+   * @param x Cell X index
+   * @param y Cell Y index
+   * @return Cost factor of the cell
+   */
+  inline float getCellFactor(const int & x, const int & y);
+
+  /**
+   * @brief Whether the traversable cells around a cell all have its cost
+   * @param x Cell X index
+   * @param y Cell Y index
+   * @return if the neighborhood of the cell is uniform
+   */
+  inline bool isUniform(const int & x, const int & y);
+
+  /**
+   * @brief Whether a cell has neighbors an optimal path entering it in a direction may
+   * only reach through it, due to cells that are not traversable
+   * @param x Cell X index
+   * @param y Cell Y index
+   * @param dir Index of the direction the cell is entered in
+   * @return if the cell has forced neighbors
+   */
+  inline bool hasForcedNeighbors(const int & x, const int & y, const unsigned int & dir);
+
+  /**
+   * @brief Compute the straight jump distances of a row of cells
+   * @param y Row index
+   */
+  void computeRowJumps(const unsigned int & y);
+
+  /**
+   * @brief Compute the straight jump distances of a column of cells
+   * @param x Column index
+   */
+  void computeColumnJumps(const unsigned int & x);
+
+  /**
+   * @brief Evaluate the costmap and compute the jump distances of all cells
+   */
+  void computeJumps();
+
+  /**
+   * @brief Find the jump point a straight jump from a cell reaches, if any
+   * @param index Index of the cell jumped from
+   * @param dir Index of the straight direction of the jump
+   * @param jump_point Index of the jump point reached
+   * @param steps Number of cells travelled to the jump point
+   * @return if a jump point was reached
+   */
+  inline bool jumpStraight(
+    const unsigned int & index, const unsigned int & dir,
+    unsigned int & jump_point, unsigned int & steps);
+
+  /**
+   * @brief Find the jump point a jump from a cell reaches, if any
+   * @param index Index of the cell jumped from
+   * @param dir Index of the direction of the jump
+   * @param jump_point Index of the jump point reached
+   * @param cost Cost of travelling to the jump point
+   * @return if a jump point was reached
+   */
+  inline bool jump(
+    const unsigned int & index, const unsigned int & dir,
+    unsigned int & jump_point, double & cost);
+
+  /**
+   * @brief Get the directions to jump in from a jump point
+   * @param index Index of the jump point
+   * @return Bit mask of the indices of the directions
+   */
+  inline unsigned int getJumpDirections(const unsigned int & index);
+
+  GridCollisionChecker * _collision_checker;
+  bool _traverse_unknown;
+  int _max_iterations;
+  int _terminal_checking_interval;
+  double _max_planning_time;
+  float _cost_penalty;
+
+  unsigned int _x_size;
+  unsigned int _y_size;
+  unsigned int _start;
+  unsigned int _goal;
+
+  // Cost factor of each cell, whether the neighborhood of each cell is uniform and
+  // the straight jump distances of each cell in each straight direction: the number of
+  // cells to the first jump point if positive, else to the last traversable cell
+  bool _jumps_valid;
+  std::vector<float> _cell_factors;
+  std::vector<uint8_t> _uniform;
+  std::vector<int> _jump_distances[4];
+
+  std::vector<double> _g;
+  std::vector<unsigned int> _parents;
+  // Direction each jump point was reached in, or none, and whether it was expanded
+  std::vector<uint8_t> _directions;
+  std::vector<uint8_t> _closed;
+  Queue _queue;
+};
+
+}  // namespace nav2_smac_planner
+
+#endif  // NAV2_SMAC_PLANNER__JUMP_POINT_SEARCH_HPP_
@@ -0,0 +1,46 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License. Reserved.
+
+#ifndef NAV2_SMAC_PLANNER__LATTICE_BINARY_HPP_
+#define NAV2_SMAC_PLANNER__LATTICE_BINARY_HPP_
+
+#include <string>
+
+#include "nav2_smac_planner/types.hpp"
+
+namespace nav2_smac_planner
+{
+
+/**
+ * @brief Check whether a lattice file is in the binary format written by
+ * lattice_primitives/binary_format.py rather than json
+ * @param filepath Path of the lattice file
+ * @return If the file starts with the binary format magic
+ */
+bool isBinaryLatticeFile(const std::string & filepath);
+
+/**
+ * @brief Load a lattice file in the binary format by memory mapping it,
+ * throws a std::runtime_error if it is missing or malformed
+ * @param filepath Path of the lattice file
+ * @param metadata Metadata of the lattice to fill
+ * @param primitives Primitives to fill in the file order, not loaded if nullptr
+ */
+void loadBinaryLattice(
+  const std::string & filepath, LatticeMetadata & metadata,
+  MotionPrimitives * primitives = nullptr);
+
+}  // namespace nav2_smac_planner
+
+#endif  // NAV2_SMAC_PLANNER__LATTICE_BINARY_HPP_
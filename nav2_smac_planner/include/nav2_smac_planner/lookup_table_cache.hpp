@@ -0,0 +1,56 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License. Reserved.
+
+#ifndef NAV2_SMAC_PLANNER__LOOKUP_TABLE_CACHE_HPP_
+#define NAV2_SMAC_PLANNER__LOOKUP_TABLE_CACHE_HPP_
+
+#include <string>
+#include <vector>
+
+namespace nav2_smac_planner
+{
+
+/**
+ * @brief Get the path of the cache file of a lookup table
+ * @param directory Directory of the cache files
+ * @param key Description of all the inputs the table is computed from
+ * @return Path of the cache file, named after a hash of the key
+ */
+std::string getLookupTableCachePath(const std::string & directory, const std::string & key);
+
+/**
+ * @brief Load a lookup table from its cache file by memory mapping it
+ * @param filepath Path of the cache file
+ * @param key Description of all the inputs the table is computed from,
+ * which must match the key the file was saved with
+ * @param table Table to fill, left unchanged if not loaded
+ * @return If the file exists, is complete and was saved with the same key
+ */
+bool loadLookupTable(
+  const std::string & filepath, const std::string & key, std::vector<float> & table);
+
+/**
+ * @brief Save a lookup table to its cache file. The file is written next to its path
+ * then renamed, so concurrent readers never see a partial file
+ * @param filepath Path of the cache file, its directory is created if needed
+ * @param key Description of all the inputs the table is computed from
+ * @param table Table to save
+ * @return If the file was saved
+ */
+bool saveLookupTable(
+  const std::string & filepath, const std::string & key, const std::vector<float> & table);
+
+}  // namespace nav2_smac_planner
+
+#endif  // NAV2_SMAC_PLANNER__LOOKUP_TABLE_CACHE_HPP_
@@ -137,6 +137,14 @@ public:
     _is_queued = false;
   }
 
+  /**
+   * @brief Sets cell as not visited, so a later search iteration may expand it again
+   */
+  inline void clearVisited()
+  {
+    _was_visited = false;
+  }
+
   /**
    * @brief Gets if cell is currently queued in search
    * @param If cell was queued
@@ -247,15 +255,16 @@ public:
     SearchInfo & search_info);
 
   /**
-   * @brief Retrieve all valid neighbors of a node.
-   * @param validity_checker Functor for state validity checking
+   * @brief Retrieve all valid neighbors of a node. Inlined with the getter in the
+   * search loop, rather than calling it through a std::function.
+   * @param NeighborGetter Functor giving the node of an index, if it may be expanded
    * @param collision_checker Collision checker to use
    * @param traverse_unknown If unknown costs are valid to traverse
    * @param neighbors Vector of neighbors to be filled
    */
+  template<typename NeighborGetterT>
   void getNeighbors(
-    std::function<bool(const uint64_t &,
-    nav2_smac_planner::Node2D * &)> & validity_checker,
+    const NeighborGetterT & NeighborGetter,
     GridCollisionChecker * collision_checker,
     const bool & traverse_unknown,
     NodeVector & neighbors);
@@ -279,6 +288,47 @@ private:
   bool _is_queued;
 };
 
+template<typename NeighborGetterT>
+void Node2D::getNeighbors(
+  const NeighborGetterT & NeighborGetter,
+  GridCollisionChecker * collision_checker,
+  const bool & traverse_unknown,
+  NodeVector & neighbors)
+{
+  // NOTE(stevemacenski): Irritatingly, the order here matters. If you start in free
+  // space and then expand 8-connected, the first set of neighbors will be all cost
+  // 1.0. Then its expansion will all be 2 * 1.0 but now multiple
+  // nodes are touching that node so the last cell to update the back pointer wins.
+  // Thusly, the ordering ends with the cardinal directions for both sets such that
+  // behavior is consistent in large free spaces between them.
+  // 100  50   0
+  // 100  50  50
+  // 100 100 100   where lower-middle '100' is visited with same cost by both bottom '50' nodes
+  // Therefore, it is valuable to have some low-potential across the entire map
+  // rather than a small inflation around the obstacles
+  uint64_t index;
+  NodePtr neighbor;
+  uint64_t node_i = this->getIndex();
+  const Coordinates parent = getCoords(this->getIndex());
+  Coordinates child;
+
+  for (unsigned int i = 0; i != _neighbors_grid_offsets.size(); ++i) {
+    index = node_i + _neighbors_grid_offsets[i];
+
+    // Check for wrap around conditions
+    child = getCoords(index);
+    if (fabs(parent.x - child.x) > 1 || fabs(parent.y - child.y) > 1) {
+      continue;
+    }
+
+    if (NeighborGetter(index, neighbor)) {
+      if (neighbor->isNodeValid(traverse_unknown, collision_checker) && !neighbor->wasVisited()) {
+        neighbors.push_back(neighbor);
+      }
+    }
+  }
+}
+
 }  // namespace nav2_smac_planner
 
 #endif  // NAV2_SMAC_PLANNER__NODE_2D_HPP_
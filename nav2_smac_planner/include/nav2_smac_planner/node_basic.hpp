@@ -25,8 +25,6 @@
 #include <utility>
 #include <limits>
 
-#include "ompl/base/StateSpace.h"
-
 #include "nav2_smac_planner/constants.hpp"
 #include "nav2_smac_planner/node_hybrid.hpp"
 #include "nav2_smac_planner/node_lattice.hpp"
@@ -24,15 +24,16 @@
 #include <memory>
 #include <utility>
 #include <limits>
-
-#include "ompl/base/StateSpace.h"
+#include <list>
 
 #include "nav2_smac_planner/constants.hpp"
+#include "nav2_smac_planner/curve_solver.hpp"
 #include "nav2_smac_planner/types.hpp"
 #include "nav2_smac_planner/collision_checker.hpp"
 #include "nav2_smac_planner/costmap_downsampler.hpp"
 #include "nav2_costmap_2d/costmap_2d_ros.hpp"
 #include "nav2_costmap_2d/inflation_layer.hpp"
+#include "nav2_util/memory_registry.hpp"
 
 namespace nav2_smac_planner
 {
@@ -51,6 +52,21 @@ struct ObstacleHeuristicComparator
 
 typedef std::vector<ObstacleHeuristicElement> ObstacleHeuristicQueue;
 
+/**
+ * @struct nav2_smac_planner::ObstacleHeuristicField
+ * @brief Obstacle heuristic of a whole grid to a goal, with the travel costs it was computed on
+ */
+struct ObstacleHeuristicField
+{
+  uint64_t goal_index;
+  unsigned int size_x;
+  unsigned int size_y;
+  std::vector<float> travel_costs;
+  std::vector<float> costs;
+};
+
+typedef std::list<ObstacleHeuristicField> ObstacleHeuristicCache;
+
 // Must forward declare
 class NodeHybrid;
 
@@ -98,6 +114,14 @@ struct HybridMotionTable
    */
   MotionPoses getProjections(const NodeHybrid * node);
 
+  /**
+   * @brief Get the projection of a node by one motion model, without building the set
+   * @param node Ptr to NodeHybrid
+   * @param i Index of the motion model
+   * @return The motion pose
+   */
+  inline MotionPose getProjection(const NodeHybrid * node, const unsigned int & i) const;
+
   /**
    * @brief Get the angular bin to use from a raw orientation
    * @param theta Angle in radians
@@ -126,7 +150,7 @@ struct HybridMotionTable
   float travel_distance_reward;
   bool downsample_obstacle_heuristic;
   bool use_quadratic_cost_penalty;
-  ompl::base::StateSpacePtr state_space;
+  CurveSolver curve_solver;
   std::vector<std::vector<double>> delta_xs;
   std::vector<std::vector<double>> delta_ys;
   std::vector<TrigValues> trig_values;
@@ -287,6 +311,14 @@ public:
     _was_visited = true;
   }
 
+  /**
+   * @brief Sets cell as not visited, so a later search iteration may expand it again
+   */
+  inline void clearVisited()
+  {
+    _was_visited = false;
+  }
+
   /**
    * @brief Gets cell index
    * @return Reference to cell index
@@ -434,6 +466,24 @@ public:
     const unsigned int & start_x, const unsigned int & start_y,
     const unsigned int & goal_x, const unsigned int & goal_y);
 
+  /**
+   * @brief Compute the obstacle heuristic of every cell to the goal set by the last
+   * resetObstacleHeuristic(), across obstacle_heuristic_threads horizontal stripes of the
+   * grid. Each stripe runs a Dijkstra expansion of its own cells, then costs are passed
+   * across the stripe borders until no cell improves, which gives the same costs as a
+   * single expansion of the whole grid. With obstacle_heuristic_cache_size, the heuristics
+   * of the last goals are kept and a kept heuristic is only repaired where the travel costs
+   * of cells changed since it was computed.
+   * @param cost_penalty Penalty to apply to the cost of cells
+   */
+  static void precomputeObstacleHeuristic(const float & cost_penalty);
+
+  /**
+   * @brief Account for the bytes of the obstacle heuristic lookup table, queue and kept
+   * wavefronts in the nav2_util::MemoryRegistry
+   */
+  static void updateObstacleHeuristicMemory();
+
   /**
    * @brief Using the inflation layer, find the footprint's adjusted cost
    * if the robot is non-circular
@@ -443,15 +493,16 @@ public:
   static float adjustedFootprintCost(const float & cost);
 
   /**
-   * @brief Retrieve all valid neighbors of a node.
-   * @param validity_checker Functor for state validity checking
+   * @brief Retrieve all valid neighbors of a node. Inlined with the getter in the
+   * search loop, rather than calling it through a std::function.
+   * @param NeighborGetter Functor giving the node of an index, if it may be expanded
    * @param collision_checker Collision checker to use
    * @param traverse_unknown If unknown costs are valid to traverse
    * @param neighbors Vector of neighbors to be filled
    */
+  template<typename NeighborGetterT>
   void getNeighbors(
-    std::function<bool(const uint64_t &,
-    nav2_smac_planner::NodeHybrid * &)> & validity_checker,
+    const NeighborGetterT & NeighborGetter,
     GridCollisionChecker * collision_checker,
     const bool & traverse_unknown,
     NodeVector & neighbors);
@@ -471,6 +522,7 @@ public:
   {
     inflation_layer.reset();
     costmap_ros.reset();
+    obstacle_heuristic_cache.clear();
   }
 
   NodeHybrid * parent;
@@ -482,6 +534,13 @@ public:
   // Wavefront lookup and queue for continuing to expand as needed
   static LookupTable obstacle_heuristic_lookup_table;
   static ObstacleHeuristicQueue obstacle_heuristic_queue;
+  // Threads computing the whole wavefront at once and wavefronts kept for the last goals,
+  // 1 thread and no wavefront kept expands it lazily during search
+  static unsigned int obstacle_heuristic_threads;
+  static bool obstacle_heuristic_precomputed;
+  static ObstacleHeuristicCache obstacle_heuristic_cache;
+  static unsigned int obstacle_heuristic_cache_size;
+  static nav2_util::MemoryTracker obstacle_heuristic_memory;
 
   static std::shared_ptr<nav2_costmap_2d::Costmap2DROS> costmap_ros;
   static std::shared_ptr<nav2_costmap_2d::InflationLayer> inflation_layer;
@@ -498,6 +557,78 @@ private:
   TurnDirection _turn_dir;
 };
 
+inline MotionPose HybridMotionTable::getProjection(
+  const NodeHybrid * node, const unsigned int & i) const
+{
+  const MotionPose & motion_model = projections[i];
+
+  // normalize theta, I know its overkill, but I've been burned before...
+  const float & node_heading = node->pose.theta;
+  float new_heading = node_heading + motion_model._theta;
+
+  if (new_heading < 0.0) {
+    new_heading += num_angle_quantization_float;
+  }
+
+  if (new_heading >= num_angle_quantization_float) {
+    new_heading -= num_angle_quantization_float;
+  }
+
+  return MotionPose(
+    delta_xs[i][node_heading] + node->pose.x,
+    delta_ys[i][node_heading] + node->pose.y,
+    new_heading, motion_model._turn_dir);
+}
+
+template<typename NeighborGetterT>
+void NodeHybrid::getNeighbors(
+  const NeighborGetterT & NeighborGetter,
+  GridCollisionChecker * collision_checker,
+  const bool & traverse_unknown,
+  NodeVector & neighbors)
+{
+  uint64_t index = 0;
+  NodePtr neighbor = nullptr;
+
+  // Projections are computed one at a time rather than into a new set per expansion,
+  // and those to expand are collision checked all at once
+  GridCollisionChecker::PoseBatch & batch = collision_checker->getPoseBatch();
+  batch.clear();
+  const size_t first_candidate = neighbors.size();
+  const unsigned int num_projections = motion_table.projections.size();
+  for (unsigned int i = 0; i != num_projections; i++) {
+    const MotionPose motion_projection = motion_table.getProjection(this, i);
+    index = NodeHybrid::getIndex(
+      static_cast<unsigned int>(motion_projection._x),
+      static_cast<unsigned int>(motion_projection._y),
+      static_cast<unsigned int>(motion_projection._theta),
+      motion_table.size_x, motion_table.num_angle_quantization);
+
+    if (NeighborGetter(index, neighbor) && !neighbor->wasVisited()) {
+      neighbors.push_back(neighbor);
+      batch.add(motion_projection._x, motion_projection._y, motion_projection._theta, i);
+    }
+  }
+
+  collision_checker->inCollision(batch, traverse_unknown);
+
+  // Only valid neighbors take their projection, in the continuous coordinates expanded,
+  // so that a node reached but in collision keeps its pose
+  size_t num_valid = first_candidate;
+  for (size_t i = 0; i != batch.size(); i++) {
+    if (batch.in_collision[i]) {
+      continue;
+    }
+    neighbor = neighbors[first_candidate + i];
+    neighbor->setPose(Coordinates(batch.x[i], batch.y[i], batch.angle_bin[i]));
+    neighbor->_cell_cost = batch.costs[i];
+    neighbor->setMotionPrimitiveIndex(
+      batch.ids[i], motion_table.projections[batch.ids[i]]._turn_dir);
+    neighbors[num_valid++] = neighbor;
+  }
+  neighbors.resize(num_valid);
+}
+
 }  // namespace nav2_smac_planner
 
 #endif  // NAV2_SMAC_PLANNER__NODE_HYBRID_HPP_
@@ -28,7 +28,6 @@
 #include <string>
 
 #include "nlohmann/json.hpp"
-#include "ompl/base/StateSpace.h"
 #include "angles/angles.h"
 
 #include "nav2_smac_planner/constants.hpp"
@@ -74,6 +73,13 @@ struct LatticeMotionTable
     const NodeLattice * node,
     unsigned int & direction_change_index);
 
+  /**
+   * @brief Get the heading bin whose primitives expand a node in reverse
+   * @param heading Heading bin of the node
+   * @return Heading bin of the reverse expansion
+   */
+  unsigned int getReverseHeading(const float & heading) const;
+
   /**
    * @brief Get file metadata needed
    * @param lattice_filepath Filepath to the lattice file
@@ -108,7 +114,7 @@ struct LatticeMotionTable
   float min_turning_radius;
   bool allow_reverse_expansion;
   std::vector<std::vector<MotionPrimitive>> motion_primitives;
-  ompl::base::StateSpacePtr state_space;
+  CurveSolver curve_solver;
   std::vector<TrigValues> trig_values;
   std::string current_lattice_filepath;
   LatticeMetadata lattice_metadata;
@@ -225,6 +231,14 @@ public:
     _was_visited = true;
   }
 
+  /**
+   * @brief Sets cell as not visited, so a later search iteration may expand it again
+   */
+  inline void clearVisited()
+  {
+    _was_visited = false;
+  }
+
   /**
    * @brief Gets cell index
    * @return Reference to cell index
@@ -389,15 +403,16 @@ public:
     const float & obstacle_heuristic);
 
   /**
-   * @brief Retrieve all valid neighbors of a node.
-   * @param validity_checker Functor for state validity checking
+   * @brief Retrieve all valid neighbors of a node. Inlined with the getter in the
+   * search loop, rather than calling it through a std::function.
+   * @param NeighborGetter Functor giving the node of an index, if it may be expanded
    * @param collision_checker Collision checker to use
    * @param traverse_unknown If unknown costs are valid to traverse
    * @param neighbors Vector of neighbors to be filled
    */
+  template<typename NeighborGetterT>
   void getNeighbors(
-    std::function<bool(const uint64_t &,
-    nav2_smac_planner::NodeLattice * &)> & validity_checker,
+    const NeighborGetterT & NeighborGetter,
     GridCollisionChecker * collision_checker,
     const bool & traverse_unknown,
     NodeVector & neighbors);
@@ -431,6 +446,81 @@ private:
   bool _backwards;
 };
 
+template<typename NeighborGetterT>
+void NodeLattice::getNeighbors(
+  const NeighborGetterT & NeighborGetter,
+  GridCollisionChecker * collision_checker,
+  const bool & traverse_unknown,
+  NodeVector & neighbors)
+{
+  uint64_t index = 0;
+  float angle;
+  NodePtr neighbor = nullptr;
+  Coordinates initial_node_coords, motion_projection;
+  const float & grid_resolution = motion_table.lattice_metadata.grid_resolution;
+
+  // The primitives at the node's heading, then those at the reverse heading if reversing
+  // is allowed, read in place rather than gathered into a new set per expansion
+  const unsigned int num_directions = motion_table.allow_reverse_expansion ? 2 : 1;
+  for (unsigned int direction = 0; direction != num_directions; ++direction) {
+    const bool backwards = direction == 1;
+    MotionPrimitives & primitives = motion_table.motion_primitives[
+      backwards ? motion_table.getReverseHeading(this->pose.theta) :
+      static_cast<unsigned int>(this->pose.theta)];
+
+    for (MotionPrimitive & primitive : primitives) {
+      const MotionPose & end_pose = primitive.poses.back();
+      motion_projection.x = this->pose.x + (end_pose._x / grid_resolution);
+      motion_projection.y = this->pose.y + (end_pose._y / grid_resolution);
+      motion_projection.theta = primitive.end_angle /*this is the ending angular bin*/;
+
+      index = NodeLattice::getIndex(
+        static_cast<unsigned int>(motion_projection.x),
+        static_cast<unsigned int>(motion_projection.y),
+        static_cast<unsigned int>(motion_projection.theta));
+
+      if (!NeighborGetter(index, neighbor) || neighbor->wasVisited()) {
+        continue;
+      }
+
+      // Cache the initial pose in case it was visited but valid
+      // don't want to disrupt continuous coordinate expansion
+      initial_node_coords = neighbor->pose;
+      // if backwards, then we're in a reversing primitive. In that situation,
+      // the orientation of the robot is mirrored from what it would otherwise
+      // appear to be from the motion primitives file. We want to take this into
+      // account in case the robot base footprint is asymmetric.
+      angle = motion_projection.theta;
+      if (backwards) {
+        angle = motion_projection.theta - (motion_table.num_angle_quantization / 2);
+        if (angle < 0) {
+          angle += motion_table.num_angle_quantization;
+        }
+        if (angle > motion_table.num_angle_quantization) {
+          angle -= motion_table.num_angle_quantization;
+        }
+      }
+
+      neighbor->setPose(
+        Coordinates(
+          motion_projection.x,
+          motion_projection.y,
+          angle));
+
+      // Using a special isNodeValid API here, giving the motion primitive to use to
+      // validity check the transition of the current node to the new node over
+      if (neighbor->isNodeValid(traverse_unknown, collision_checker, &primitive, backwards)) {
+        neighbor->setMotionPrimitive(&primitive);
+        // Marking if this search was obtained in the reverse direction
+        neighbor->backwards(backwards);
+        neighbors.push_back(neighbor);
+      } else {
+        neighbor->setPose(initial_node_coords);
+      }
+    }
+  }
+}
+
 }  // namespace nav2_smac_planner
 
 #endif  // NAV2_SMAC_PLANNER__NODE_LATTICE_HPP_
@@ -0,0 +1,147 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License. Reserved.
+
+#ifndef NAV2_SMAC_PLANNER__NODE_POOL_HPP_
+#define NAV2_SMAC_PLANNER__NODE_POOL_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace nav2_smac_planner
+{
+
+/**
+ * @class nav2_smac_planner::NodePool
+ * @brief Graph of search nodes stored densely by index, in pages allocated on first use.
+ * Nodes are kept across searches and stamped with the generation of the search they were
+ * last used in, so clearing the graph does not touch the nodes: a node is reset the first
+ * time it is used in a new generation.
+ */
+template<typename NodeT>
+class NodePool
+{
+public:
+  static constexpr unsigned int PAGE_BITS = 12;
+  static constexpr uint64_t PAGE_SIZE = static_cast<uint64_t>(1) << PAGE_BITS;
+
+  /**
+   * @brief Get the node of an index, reset if it was not used since the last clear()
+   * @param index Node index
+   * @return Pointer to the node, valid until reset()
+   */
+  NodeT * get(const uint64_t & index)
+  {
+    const uint64_t page_index = index >> PAGE_BITS;
+    if (page_index >= _pages.size()) {
+      _pages.resize(page_index + 1);
+    }
+
+    std::unique_ptr<Page> & page = _pages[page_index];
+    if (!page) {
+      page = std::make_unique<Page>();
+      page->nodes.reserve(PAGE_SIZE);
+      for (uint64_t i = 0; i != PAGE_SIZE; i++) {
+        page->nodes.emplace_back((page_index << PAGE_BITS) | i);
+      }
+      page->generations.assign(PAGE_SIZE, 0);
+    }
+
+    const uint64_t slot = index & (PAGE_SIZE - 1);
+    NodeT * node = &page->nodes[slot];
+    if (page->generations[slot] != _generation) {
+      page->generations[slot] = _generation;
+      node->reset();
+      _size++;
+    }
+    return node;
+  }
+
+  /**
+   * @brief Mark all nodes as unused, keeping their memory for the next search
+   */
+  void clear()
+  {
+    _size = 0;
+    if (++_generation == 0) {
+      // Generation counter wrapped around, stamps of old searches could match again
+      for (auto & page : _pages) {
+        if (page) {
+          std::fill(page->generations.begin(), page->generations.end(), 0u);
+        }
+      }
+      _generation = 1;
+    }
+  }
+
+  /**
+   * @brief Release the memory of all nodes
+   */
+  void reset()
+  {
+    _pages.clear();
+    _size = 0;
+    _generation = 1;
+  }
+
+  /**
+   * @brief Get the number of nodes used since the last clear()
+   * @return Number of nodes
+   */
+  uint64_t size() const
+  {
+    return _size;
+  }
+
+  /**
+   * @brief Check whether no node was used since the last clear()
+   * @return If empty
+   */
+  bool empty() const
+  {
+    return _size == 0;
+  }
+
+  /**
+   * @brief Get the bytes of the pages allocated
+   * @return Number of bytes
+   */
+  size_t getMemoryUsage() const
+  {
+    size_t bytes = _pages.capacity() * sizeof(std::unique_ptr<Page>);
+    for (const auto & page : _pages) {
+      if (page) {
+        bytes += sizeof(Page) + PAGE_SIZE * (sizeof(NodeT) + sizeof(uint32_t));
+      }
+    }
+    return bytes;
+  }
+
+protected:
+  struct Page
+  {
+    std::vector<NodeT> nodes;
+    std::vector<uint32_t> generations;
+  };
+
+  std::vector<std::unique_ptr<Page>> _pages;
+  uint32_t _generation{1};
+  uint64_t _size{0};
+};
+
+}  // namespace nav2_smac_planner
+
+#endif  // NAV2_SMAC_PLANNER__NODE_POOL_HPP_
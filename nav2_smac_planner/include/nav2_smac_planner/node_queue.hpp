@@ -0,0 +1,219 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License. Reserved.
+
+#ifndef NAV2_SMAC_PLANNER__NODE_QUEUE_HPP_
+#define NAV2_SMAC_PLANNER__NODE_QUEUE_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace nav2_smac_planner
+{
+
+/**
+ * @class nav2_smac_planner::DAryHeap
+ * @brief Priority queue on a d-ary heap, with the interface of std::priority_queue.
+ * With an arity of 2 it orders elements exactly like std::priority_queue. Larger
+ * arities make the heap shallower, so a push moves elements fewer levels and a pop
+ * compares siblings which share cache lines.
+ */
+template<typename T, typename Compare>
+class DAryHeap
+{
+public:
+  /**
+   * @brief A constructor for nav2_smac_planner::DAryHeap
+   * @param arity Number of children of each heap node, values under 2 are used as 2
+   */
+  explicit DAryHeap(unsigned int arity = 2)
+  {
+    setArity(arity);
+  }
+
+  /**
+   * @brief Set the number of children of each heap node, reordering the elements
+   * @param arity Number of children of each heap node, values under 2 are used as 2
+   */
+  void setArity(unsigned int arity)
+  {
+    _arity = std::max(arity, 2u);
+    if (_data.empty()) {
+      return;
+    }
+    std::vector<T> data;
+    std::swap(data, _data);
+    for (auto & element : data) {
+      push(std::move(element));
+    }
+  }
+
+  /**
+   * @brief Get the number of children of each heap node
+   * @return Arity of the heap
+   */
+  unsigned int getArity() const
+  {
+    return _arity;
+  }
+
+  /**
+   * @brief Check whether the queue is empty
+   * @return If empty
+   */
+  bool empty() const
+  {
+    return _data.empty();
+  }
+
+  /**
+   * @brief Get the number of queued elements
+   * @return Number of elements
+   */
+  size_t size() const
+  {
+    return _data.size();
+  }
+
+  /**
+   * @brief Get the element with the highest priority
+   * @return Reference to the element, the queue must not be empty
+   */
+  const T & top() const
+  {
+    return _data.front();
+  }
+
+  /**
+   * @brief Queue an element
+   * @param element Element to queue
+   */
+  void push(T element)
+  {
+    _data.push_back(std::move(element));
+    siftUp();
+  }
+
+  /**
+   * @brief Queue an element constructed in place
+   * @param args Arguments to construct the element from
+   */
+  template<typename ... Args>
+  void emplace(Args && ... args)
+  {
+    _data.emplace_back(std::forward<Args>(args)...);
+    siftUp();
+  }
+
+  /**
+   * @brief Remove the element with the highest priority, the queue must not be empty
+   */
+  void pop()
+  {
+    if (_arity == 2) {
+      std::pop_heap(_data.begin(), _data.end(), _compare);
+      _data.pop_back();
+      return;
+    }
+
+    T value = std::move(_data.back());
+    _data.pop_back();
+    const size_t n = _data.size();
+    if (n == 0) {
+      return;
+    }
+
+    // Move the hole left at the top down to where the last element fits
+    size_t hole = 0;
+    while (true) {
+      const size_t first_child = hole * _arity + 1;
+      if (first_child >= n) {
+        break;
+      }
+      const size_t last_child = std::min(first_child + _arity, n);
+      size_t best = first_child;
+      for (size_t child = first_child + 1; child < last_child; ++child) {
+        if (_compare(_data[best], _data[child])) {
+          best = child;
+        }
+      }
+      if (!_compare(value, _data[best])) {
+        break;
+      }
+      _data[hole] = std::move(_data[best]);
+      hole = best;
+    }
+    _data[hole] = std::move(value);
+  }
+
+  /**
+   * @brief Get the queued elements, in heap order
+   * @return Elements of the queue
+   */
+  const std::vector<T> & elements() const
+  {
+    return _data;
+  }
+
+  /**
+   * @brief Move all elements out of the queue, in heap order
+   * @param elements Vector to move the elements into, replacing its contents
+   */
+  void extract(std::vector<T> & elements)
+  {
+    elements.clear();
+    std::swap(elements, _data);
+  }
+
+  /**
+   * @brief Remove all elements, keeping the memory for the next ones
+   */
+  void clear()
+  {
+    _data.clear();
+  }
+
+protected:
+  /**
+   * @brief Move the last element up to its place in the heap
+   */
+  void siftUp()
+  {
+    if (_arity == 2) {
+      std::push_heap(_data.begin(), _data.end(), _compare);
+      return;
+    }
+
+    size_t hole = _data.size() - 1;
+    T value = std::move(_data[hole]);
+    while (hole > 0) {
+      const size_t parent = (hole - 1) / _arity;
+      if (!_compare(_data[parent], value)) {
+        break;
+      }
+      _data[hole] = std::move(_data[parent]);
+      hole = parent;
+    }
+    _data[hole] = std::move(value);
+  }
+
+  std::vector<T> _data;
+  unsigned int _arity;
+  Compare _compare;
+};
+
+}  // namespace nav2_smac_planner
+
+#endif  // NAV2_SMAC_PLANNER__NODE_QUEUE_HPP_
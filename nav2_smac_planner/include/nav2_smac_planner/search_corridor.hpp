@@ -0,0 +1,149 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License. Reserved.
+
+#ifndef NAV2_SMAC_PLANNER__SEARCH_CORRIDOR_HPP_
+#define NAV2_SMAC_PLANNER__SEARCH_CORRIDOR_HPP_
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "nav2_costmap_2d/costmap_2d.hpp"
+#include "nav2_costmap_2d/costmap_2d_ros.hpp"
+#include "nav2_smac_planner/a_star.hpp"
+#include "nav2_smac_planner/collision_checker.hpp"
+#include "nav2_smac_planner/costmap_downsampler.hpp"
+#include "nav2_smac_planner/node_2d.hpp"
+
+namespace nav2_smac_planner
+{
+
+/**
+ * @class nav2_smac_planner::SearchCorridor
+ * @brief Corridor of cells to restrict a search to, found by a 2D search on a costmap
+ * downsampled from the search's. Planning long routes on the coarse grid first bounds
+ * the nodes the full resolution search expands, and so its time and memory.
+ */
+class SearchCorridor
+{
+public:
+  /**
+   * @brief A constructor for nav2_smac_planner::SearchCorridor
+   */
+  SearchCorridor();
+
+  /**
+   * @brief Configure the coarse search
+   * @param node Lifecycle node pointer
+   * @param costmap_ros Costmap2DROS object of the planner
+   * @param costmap The full resolution costmap to downsample
+   * @param search_downsampling_factor Factor the search's costmap is downsampled by
+   * from the full resolution costmap
+   * @param downsampling_factor Factor the coarse costmap is downsampled by from the
+   * search's costmap
+   * @param use_min_cost_neighbor If true, the coarse cells take the minimum cost of the
+   * cells they cover instead of the maximum
+   * @param corridor_width Distance on each side of the coarse path kept in the corridor (m)
+   * @param cost_penalty Penalty on costmap costs of the coarse search, as for Node2D
+   * @param allow_unknown Allow the coarse search in unknown space
+   * @param max_iterations Maximum number of iterations of the coarse search
+   * @param terminal_checking_interval Number of iterations to check if the task has been
+   * canceled or planning time exceeded
+   * @param max_planning_time Maximum time (in seconds) of the coarse search
+   */
+  void on_configure(
+    const rclcpp_lifecycle::LifecycleNode::SharedPtr & node,
+    const std::shared_ptr<nav2_costmap_2d::Costmap2DROS> & costmap_ros,
+    nav2_costmap_2d::Costmap2D * const costmap,
+    const unsigned int & search_downsampling_factor,
+    const unsigned int & downsampling_factor,
+    const bool & use_min_cost_neighbor,
+    const double & corridor_width,
+    const float & cost_penalty,
+    const bool & allow_unknown,
+    const int & max_iterations,
+    const int & terminal_checking_interval,
+    const double & max_planning_time);
+
+  /**
+   * @brief Cleanup the coarse search
+   */
+  void on_cleanup();
+
+  /**
+   * @brief Find the corridor between a start and a goal with the coarse search
+   * @param start_mx X of the start in the search's costmap
+   * @param start_my Y of the start in the search's costmap
+   * @param goal_mx X of the goal in the search's costmap
+   * @param goal_my Y of the goal in the search's costmap
+   * @param cancel_checker Function to check if the task has been canceled
+   * @return If a coarse path was found, else the corridor is cleared
+   */
+  bool update(
+    const float & start_mx, const float & start_my,
+    const float & goal_mx, const float & goal_my,
+    std::function<bool()> cancel_checker);
+
+  /**
+   * @brief Clear the corridor, so that it contains all cells
+   */
+  void clear();
+
+  /**
+   * @brief Check whether the corridor restricts any cell
+   * @return If the corridor is empty, containing all cells
+   */
+  bool empty() const
+  {
+    return _cells.empty();
+  }
+
+  /**
+   * @brief Check whether a cell of the search's costmap is in the corridor
+   * @param mx X of the cell in the search's costmap
+   * @param my Y of the cell in the search's costmap
+   * @return If the cell is in the corridor
+   */
+  inline bool contains(const unsigned int & mx, const unsigned int & my) const
+  {
+    if (_cells.empty()) {
+      return true;
+    }
+    const unsigned int cx = mx / _downsampling_factor;
+    const unsigned int cy = my / _downsampling_factor;
+    return cx < _size_x && cy < _size_y && _cells[cy * _size_x + cx];
+  }
+
+protected:
+  /**
+   * @brief Set the cells of the corridor about a path of the coarse search
+   * @param path Path of the coarse search, in the coarse costmap
+   * @param radius Radius of the corridor about the path, in coarse cells
+   */
+  void setCells(const Node2D::CoordinateVector & path, const int & radius);
+
+  std::unique_ptr<CostmapDownsampler> _costmap_downsampler;
+  std::unique_ptr<AStarAlgorithm<Node2D>> _a_star;
+  GridCollisionChecker _collision_checker;
+  unsigned int _total_downsampling_factor;
+  unsigned int _downsampling_factor;
+  double _corridor_width;
+  unsigned int _size_x;
+  unsigned int _size_y;
+  std::vector<unsigned char> _cells;
+};
+
+}  // namespace nav2_smac_planner
+
+#endif  // NAV2_SMAC_PLANNER__SEARCH_CORRIDOR_HPP_
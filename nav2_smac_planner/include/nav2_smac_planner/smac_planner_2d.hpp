@@ -21,6 +21,9 @@
 #include <mutex>
 
 #include "nav2_smac_planner/a_star.hpp"
+#include "nav2_smac_planner/bidirectional_a_star.hpp"
+#include "nav2_smac_planner/jump_point_search.hpp"
+#include "nav2_smac_planner/d_star_lite.hpp"
 #include "nav2_smac_planner/smoother.hpp"
 #include "nav2_smac_planner/utils.hpp"
 #include "nav2_smac_planner/costmap_downsampler.hpp"
@@ -90,7 +93,28 @@ public:
     const geometry_msgs::msg::PoseStamped & goal,
     std::function<bool()> cancel_checker) override;
 
+  /**
+   * @brief Creating a plan from a start pose to the closest of a set of goal poses,
+   * searching to all the goals at once
+   * @param start Start pose
+   * @param goals Set of goal poses
+   * @param cancel_checker Function to check if the action has been canceled
+   * @param goal_index Index in the set of the goal reached by the plan
+   * @return nav2_msgs::Path of the generated path
+   */
+  nav_msgs::msg::Path createPlanToGoalSet(
+    const geometry_msgs::msg::PoseStamped & start,
+    const std::vector<geometry_msgs::msg::PoseStamped> & goals,
+    std::function<bool()> cancel_checker,
+    size_t & goal_index) override;
+
 protected:
+  /**
+   * @brief Initialize the A* search, and the incremental, bidirectional and jump point
+   * searches if enabled
+   */
+  void initializeSearch();
+
   /**
    * @brief Callback executed when a parameter change is detected
    * @param event ParameterEvent message
@@ -99,9 +123,15 @@ protected:
   dynamicParametersCallback(std::vector<rclcpp::Parameter> parameters);
 
   std::unique_ptr<AStarAlgorithm<Node2D>> _a_star;
+  std::unique_ptr<DStarLite> _d_star_lite;
+  std::unique_ptr<BidirectionalAStar> _bidirectional_a_star;
+  std::unique_ptr<JumpPointSearch> _jump_point_searcher;
   GridCollisionChecker _collision_checker;
   std::unique_ptr<Smoother> _smoother;
   nav2_costmap_2d::Costmap2D * _costmap;
+  nav2_costmap_2d::LayeredCostmap * _layered_costmap;
+  uint64_t _costmap_update_count;
+  uint64_t _jump_point_update_count;
   std::unique_ptr<CostmapDownsampler> _costmap_downsampler;
   rclcpp::Clock::SharedPtr _clock;
   rclcpp::Logger _logger{rclcpp::get_logger("SmacPlanner2D")};
@@ -115,7 +145,12 @@ protected:
   int _max_iterations;
   int _max_on_approach_iterations;
   int _terminal_checking_interval;
+  bool _use_node_pool;
+  int _open_list_arity;
   bool _use_final_approach_orientation;
+  bool _incremental_replanning;
+  bool _bidirectional_search;
+  bool _jump_point_search;
   SearchInfo _search_info;
   std::string _motion_model_for_search;
   MotionModel _motion_model;
@@ -20,9 +20,11 @@
 #include <string>
 
 #include "nav2_smac_planner/a_star.hpp"
+#include "nav2_smac_planner/expansions_publisher.hpp"
 #include "nav2_smac_planner/smoother.hpp"
 #include "nav2_smac_planner/utils.hpp"
 #include "nav2_smac_planner/costmap_downsampler.hpp"
+#include "nav2_smac_planner/search_corridor.hpp"
 #include "nav_msgs/msg/occupancy_grid.hpp"
 #include "nav2_core/global_planner.hpp"
 #include "nav_msgs/msg/path.hpp"
@@ -105,6 +107,7 @@ protected:
   nav2_costmap_2d::Costmap2D * _costmap;
   std::shared_ptr<nav2_costmap_2d::Costmap2DROS> _costmap_ros;
   std::unique_ptr<CostmapDownsampler> _costmap_downsampler;
+  std::unique_ptr<SearchCorridor> _search_corridor;
   std::string _global_frame, _name;
   float _lookup_table_dim;
   float _tolerance;
@@ -116,8 +119,13 @@ protected:
   int _max_iterations;
   int _max_on_approach_iterations;
   int _terminal_checking_interval;
+  bool _use_node_pool;
+  int _open_list_arity;
   SearchInfo _search_info;
   double _max_planning_time;
+  int _hierarchical_downsampling_factor;
+  bool _hierarchical_use_min_cost;
+  double _hierarchical_corridor_width;
   double _lookup_table_size;
   double _minimum_turning_radius_global_coords;
   bool _debug_visualizations;
@@ -126,8 +134,11 @@ protected:
   rclcpp_lifecycle::LifecyclePublisher<nav_msgs::msg::Path>::SharedPtr _raw_plan_publisher;
   rclcpp_lifecycle::LifecyclePublisher<visualization_msgs::msg::MarkerArray>::SharedPtr
     _planned_footprints_publisher;
-  rclcpp_lifecycle::LifecyclePublisher<geometry_msgs::msg::PoseArray>::SharedPtr
-    _expansions_publisher;
+  int _expansions_log_size;
+  int _expansions_log_stride;
+  std::unique_ptr<ExpansionsPublisher> _expansions_publisher;
+  double _partial_plan_period;
+  rclcpp_lifecycle::LifecyclePublisher<nav_msgs::msg::Path>::SharedPtr _partial_plan_publisher;
   std::mutex _mutex;
   rclcpp_lifecycle::LifecycleNode::WeakPtr _node;
 
@@ -15,6 +15,7 @@
 #ifndef NAV2_SMAC_PLANNER__SMOOTHER_HPP_
 #define NAV2_SMAC_PLANNER__SMOOTHER_HPP_
 
+#include <algorithm>
 #include <cmath>
 #include <vector>
 #include <iostream>
@@ -25,12 +26,11 @@
 #include "nav2_costmap_2d/costmap_2d.hpp"
 #include "nav2_smac_planner/types.hpp"
 #include "nav2_smac_planner/constants.hpp"
+#include "nav2_smac_planner/curve_solver.hpp"
 #include "nav2_util/geometry_utils.hpp"
 #include "nav_msgs/msg/path.hpp"
 #include "angles/angles.h"
 #include "tf2/utils.h"
-#include "ompl/base/StateSpace.h"
-#include "ompl/base/spaces/DubinsStateSpace.h"
 
 namespace nav2_smac_planner
 {
@@ -77,6 +77,52 @@ struct BoundaryExpansion
 };
 
 typedef std::vector<BoundaryExpansion> BoundaryExpansions;
+
+/**
+ * @struct nav2_smac_planner::SmoothingBuffer
+ * @brief Positions of a path segment being smoothed, contiguous in each dimension
+ */
+struct SmoothingBuffer
+{
+  /**
+   * @brief Set the positions from those of a path
+   * @param path Path to take the positions of
+   */
+  void fromPath(const nav_msgs::msg::Path & path)
+  {
+    x.resize(path.poses.size());
+    y.resize(path.poses.size());
+    for (unsigned int i = 0; i != path.poses.size(); i++) {
+      x[i] = path.poses[i].pose.position.x;
+      y[i] = path.poses[i].pose.position.y;
+    }
+  }
+
+  /**
+   * @brief Set the positions of a path of the same size
+   * @param path Path to set the positions of
+   */
+  void toPath(nav_msgs::msg::Path & path) const
+  {
+    for (unsigned int i = 0; i != path.poses.size(); i++) {
+      path.poses[i].pose.position.x = x[i];
+      path.poses[i].pose.position.y = y[i];
+    }
+  }
+
+  /**
+   * @brief Set the positions from those of another buffer of the same size, in place
+   * @param other Buffer to take the positions of
+   */
+  void assign(const SmoothingBuffer & other)
+  {
+    std::copy(other.x.begin(), other.x.end(), x.begin());
+    std::copy(other.y.begin(), other.y.end(), y.begin());
+  }
+
+  std::vector<double> x;
+  std::vector<double> y;
+};
 typedef std::vector<geometry_msgs::msg::PoseStamped>::iterator PathIterator;
 typedef std::vector<geometry_msgs::msg::PoseStamped>::reverse_iterator ReversePathIterator;
 
@@ -106,7 +152,8 @@ public:
     const double & min_turning_radius);
 
   /**
-   * @brief Smoother API method
+   * @brief Smoother API method, smoothing the segments of the path split at cusps
+   * in parallel
    * @param path Reference to path
    * @param costmap Pointer to minimal costmap
    * @param max_time Maximum time to compute, stop early if over limit
@@ -119,7 +166,8 @@ public:
 
 protected:
   /**
-   * @brief Smoother method - does the smoothing on a segment
+   * @brief Smoother method - does the smoothing on a segment, followed by the
+   * refinement passes on the smoothed positions
    * @param path Reference to path
    * @param reversing_segment Return if this is a reversing segment
    * @param costmap Pointer to minimal costmap
@@ -133,24 +181,27 @@ protected:
     const double & max_time);
 
   /**
-   * @brief Get the field value for a given dimension
-   * @param msg Current pose to sample
-   * @param dim Dimension ID of interest
-   * @return dim value
+   * @brief Run one smoothing step on the points of a parity in a dimension, which only
+   * depends on the points of the other parity so that it has no loop-carried dependency
+   * @param data Data positions in the dimension to be attracted to
+   * @param smoothed Smoothed positions in the dimension to update
+   * @param first Index of the first point to update, 1 or 2
+   * @return Sum of the absolute position changes
    */
-  inline double getFieldByDim(
-    const geometry_msgs::msg::PoseStamped & msg,
-    const unsigned int & dim);
+  inline double smoothingStep(
+    const std::vector<double> & data,
+    std::vector<double> & smoothed,
+    const unsigned int & first) const;
 
   /**
-   * @brief Set the field value for a given dimension
-   * @param msg Current pose to sample
-   * @param dim Dimension ID of interest
-   * @param value to set the dimention to for the pose
+   * @brief Check all the points of a smoothing sweep for collision at once
+   * @param smoothed Smoothed positions to check
+   * @param costmap Pointer to minimal costmap, no check is done if null
+   * @return If all points are collision free
    */
-  inline void setFieldByDim(
-    geometry_msgs::msg::PoseStamped & msg, const unsigned int dim,
-    const double & value);
+  inline bool isCollisionFree(
+    const SmoothingBuffer & smoothed,
+    const nav2_costmap_2d::Costmap2D * costmap) const;
 
   /**
    * @brief Finds the starting and end indices of path segments where
@@ -232,10 +283,10 @@ protected:
     bool & reversing_segment);
 
   double min_turning_rad_, tolerance_, data_w_, smooth_w_;
-  int max_its_, refinement_ctr_, refinement_num_;
+  int max_its_, refinement_num_;
   bool is_holonomic_, do_refinement_;
   MotionModel motion_model_;
-  ompl::base::StateSpacePtr state_space_;
+  CurveSolver curve_solver_;
 };
 
 }  // namespace nav2_smac_planner
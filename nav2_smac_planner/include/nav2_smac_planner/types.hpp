@@ -45,12 +45,19 @@ struct SearchInfo
   float analytic_expansion_max_length{60.0};
   float analytic_expansion_max_cost{200.0};
   bool analytic_expansion_max_cost_override{false};
+  int analytic_expansion_candidates{0};
   std::string lattice_filepath;
   bool cache_obstacle_heuristic{false};
   bool allow_reverse_expansion{false};
   bool allow_primitive_interpolation{false};
   bool downsample_obstacle_heuristic{true};
   bool use_quadratic_cost_penalty{false};
+  int obstacle_heuristic_threads{1};
+  int obstacle_heuristic_cache_size{0};
+  std::string distance_heuristic_cache_directory;
+  float anytime_heuristic_weight{1.0};
+  float anytime_weight_step{0.5};
+  double anytime_refinement_time{0.05};
 };
 
 /**
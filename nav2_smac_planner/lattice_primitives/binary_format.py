@@ -0,0 +1,179 @@
+# Copyright (c) 2024 Open Navigation LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License. Reserved.
+
+"""
+Binary format of the motion primitive files, loaded without parsing.
+
+All values are little endian and 4 bytes wide, in this order:
+
+- magic: the 8 characters N2SMLAT1
+- turning_radius, grid_resolution: float
+- num_of_headings, number_of_trajectories, motion_model length, number of poses: uint
+- motion_model: characters, zero padded to a multiple of 4 bytes
+- heading_angles: num_of_headings floats
+- one record per primitive: trajectory_id, start_angle_index, end_angle_index as uint,
+  trajectory_radius, trajectory_length, arc_length, straight_length as float,
+  left_turn, index of its first pose, number of poses as uint
+- poses: x, y and yaw floats of the poses of all primitives
+"""
+
+import argparse
+import json
+from pathlib import Path
+import struct
+
+MAGIC = b'N2SMLAT1'
+HEADER = struct.Struct('<8sffIIII')
+PRIMITIVE = struct.Struct('<IIIffffIII')
+POSE = struct.Struct('<fff')
+
+
+def write_to_binary(output_path: Path, output_dict: dict) -> None:
+    """
+    Write the motion primitives to a binary file.
+
+    Args:
+    ----
+    output_path: Path
+        The output file for the binary data
+    output_dict: dict
+        The motion primitives, in the layout of the json output
+
+    """
+    metadata = output_dict['lattice_metadata']
+    primitives = output_dict['primitives']
+    motion_model = metadata['motion_model'].encode()
+    heading_angles = metadata['heading_angles']
+    num_poses = sum(len(primitive['poses']) for primitive in primitives)
+
+    data = bytearray(
+        HEADER.pack(
+            MAGIC,
+            metadata['turning_radius'],
+            metadata['grid_resolution'],
+            metadata['num_of_headings'],
+            len(primitives),
+            len(motion_model),
+            num_poses,
+        )
+    )
+    data += motion_model + bytes(-len(motion_model) % 4)
+    data += struct.pack(f'<{len(heading_angles)}f', *heading_angles)
+
+    first_pose = 0
+    for primitive in primitives:
+        data += PRIMITIVE.pack(
+            primitive['trajectory_id'],
+            primitive['start_angle_index'],
+            primitive['end_angle_index'],
+            primitive['trajectory_radius'],
+            primitive['trajectory_length'],
+            primitive['arc_length'],
+            primitive['straight_length'],
+            primitive['left_turn'],
+            first_pose,
+            len(primitive['poses']),
+        )
+        first_pose += len(primitive['poses'])
+
+    for primitive in primitives:
+        for pose in primitive['poses']:
+            data += POSE.pack(*pose)
+
+    with open(output_path, 'wb') as output_file:
+        output_file.write(data)
+
+
+def read_from_binary(input_path: Path) -> dict:
+    """
+    Read the motion primitives of a binary file.
+
+    Args:
+    ----
+    input_path: Path
+        The binary file to read
+
+    Returns
+    -------
+    dict
+        The motion primitives, in the layout of the json output
+
+    """
+    with open(input_path, 'rb') as input_file:
+        data = input_file.read()
+
+    (
+        magic,
+        turning_radius,
+        grid_resolution,
+        num_of_headings,
+        number_of_trajectories,
+        motion_model_length,
+        num_poses,
+    ) = HEADER.unpack_from(data)
+    if magic != MAGIC:
+        raise ValueError(f'{input_path} is not a binary motion primitive file')
+
+    offset = HEADER.size
+    motion_model = data[offset:offset + motion_model_length].decode()
+    offset += motion_model_length + (-motion_model_length % 4)
+    heading_angles = list(struct.unpack_from(f'<{num_of_headings}f', data, offset))
+    offset += 4 * num_of_headings
+    poses_offset = offset + PRIMITIVE.size * number_of_trajectories
+
+    primitives = []
+    for _ in range(number_of_trajectories):
+        fields = PRIMITIVE.unpack_from(data, offset)
+        offset += PRIMITIVE.size
+        poses = [
+            list(POSE.unpack_from(data, poses_offset + POSE.size * (fields[8] + i)))
+            for i in range(fields[9])
+        ]
+        primitives.append(
+            {
+                'trajectory_id': fields[0],
+                'start_angle_index': fields[1],
+                'end_angle_index': fields[2],
+                'trajectory_radius': fields[3],
+                'trajectory_length': fields[4],
+                'arc_length': fields[5],
+                'straight_length': fields[6],
+                'left_turn': bool(fields[7]),
+                'poses': poses,
+            }
+        )
+
+    return {
+        'lattice_metadata': {
+            'motion_model': motion_model,
+            'turning_radius': turning_radius,
+            'grid_resolution': grid_resolution,
+            'num_of_headings': num_of_headings,
+            'heading_angles': heading_angles,
+            'number_of_trajectories': number_of_trajectories,
+        },
+        'primitives': primitives,
+    }
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(
+        description='Convert a json motion primitive file to the binary format'
+    )
+    parser.add_argument('input', type=Path, help='The json motion primitive file')
+    parser.add_argument('output', type=Path, help='The binary file to write')
+    args = parser.parse_args()
+
+    with open(args.input) as json_file:
+        write_to_binary(args.output, json.load(json_file))
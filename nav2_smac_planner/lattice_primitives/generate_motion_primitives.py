@@ -19,6 +19,7 @@ import logging
 from pathlib import Path
 import time
 
+from binary_format import write_to_binary
 import constants
 from lattice_generator import LatticeGenerator
 
@@ -55,6 +56,13 @@ def handle_arg_parsing():
         default='./output.json',
         help='The output file containing the ' 'trajectory data',
     )
+    parser.add_argument(
+        '--binary_output',
+        type=Path,
+        default=None,
+        help='An optional output file for the trajectory data in the binary '
+        'format, which the planner loads without parsing',
+    )
     parser.add_argument(
         '--visualizations',
         type=Path,
@@ -145,7 +153,7 @@ def create_header(config: dict, minimal_set_trajectories: dict) -> dict:
 
 def write_to_json(
     output_path: Path, minimal_set_trajectories: dict, config: dict
-) -> None:
+) -> dict:
     """
     Write the minimal spanning set to an output file.
 
@@ -158,6 +166,11 @@ def write_to_json(
     config: dict
         The dict containing user specified parameters
 
+    Returns
+    -------
+    dict
+        The data written to the output file
+
     """
     output_dict = create_header(config, minimal_set_trajectories)
 
@@ -202,6 +215,8 @@ def write_to_json(
     with open(output_path, 'w') as output_file:
         json.dump(output_dict, output_file, indent='\t')
 
+    return output_dict
+
 
 def save_visualizations(
     visualizations_folder: Path, minimal_set_trajectories: dict
@@ -263,5 +278,7 @@ if __name__ == '__main__':
     minimal_set_trajectories = lattice_gen.run()
     print(f'Finished Generating. Took {time.time() - start} seconds')
 
-    write_to_json(args.output, minimal_set_trajectories, config)
+    output_dict = write_to_json(args.output, minimal_set_trajectories, config)
+    if args.binary_output is not None:
+        write_to_binary(args.binary_output, output_dict)
     save_visualizations(args.visualizations, minimal_set_trajectories)
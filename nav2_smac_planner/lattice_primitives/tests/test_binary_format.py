@@ -0,0 +1,101 @@
+# Copyright (c) 2024 Open Navigation LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License. Reserved.
+
+from pathlib import Path
+import tempfile
+import unittest
+
+from binary_format import read_from_binary, write_to_binary
+
+OUTPUT_DICT = {
+    'lattice_metadata': {
+        'motion_model': 'diff',
+        'turning_radius': 0.5,
+        'grid_resolution': 0.05,
+        'num_of_headings': 2,
+        'heading_angles': [0.0, 3.14159],
+        'number_of_trajectories': 2,
+    },
+    'primitives': [
+        {
+            'trajectory_id': 0,
+            'start_angle_index': 0,
+            'end_angle_index': 0,
+            'left_turn': True,
+            'trajectory_radius': 0.0,
+            'trajectory_length': 0.1,
+            'arc_length': 0.0,
+            'straight_length': 0.1,
+            'poses': [[0.05, 0.0, 0.0], [0.1, 0.0, 0.0]],
+        },
+        {
+            'trajectory_id': 1,
+            'start_angle_index': 1,
+            'end_angle_index': 0,
+            'left_turn': False,
+            'trajectory_radius': 0.5,
+            'trajectory_length': 0.8,
+            'arc_length': 0.7,
+            'straight_length': 0.1,
+            'poses': [[0.0, 0.1, 1.5], [0.0, 0.2, 1.6], [0.1, 0.3, 3.1]],
+        },
+    ],
+}
+
+
+class TestBinaryFormat(unittest.TestCase):
+    """Contains the unit tests for the binary motion primitive format."""
+
+    def test_write_read(self):
+        # Test that the binary file reads back as the written primitives
+
+        with tempfile.TemporaryDirectory() as directory:
+            path = Path(directory) / 'output.bin'
+            write_to_binary(path, OUTPUT_DICT)
+            read_dict = read_from_binary(path)
+
+        metadata = OUTPUT_DICT['lattice_metadata']
+        read_metadata = read_dict['lattice_metadata']
+        for key, value in metadata.items():
+            if isinstance(value, list):
+                for a, b in zip(value, read_metadata[key]):
+                    self.assertAlmostEqual(a, b, places=5)
+            elif isinstance(value, float):
+                self.assertAlmostEqual(value, read_metadata[key], places=5)
+            else:
+                self.assertEqual(value, read_metadata[key])
+
+        self.assertEqual(len(read_dict['primitives']), 2)
+        for primitive, read_primitive in zip(
+            OUTPUT_DICT['primitives'], read_dict['primitives']
+        ):
+            self.assertEqual(len(primitive['poses']), len(read_primitive['poses']))
+            for pose, read_pose in zip(primitive['poses'], read_primitive['poses']):
+                for a, b in zip(pose, read_pose):
+                    self.assertAlmostEqual(a, b, places=5)
+            for key in primitive.keys() - {'poses'}:
+                self.assertAlmostEqual(primitive[key], read_primitive[key], places=5)
+
+    def test_not_binary(self):
+        # Test that files of another format are rejected
+
+        with tempfile.TemporaryDirectory() as directory:
+            path = Path(directory) / 'output.json'
+            path.write_text('{"lattice_metadata": {}, "primitives": []}')
+            with self.assertRaises(ValueError):
+                read_from_binary(path)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -26,6 +26,7 @@
 #include <vector>
 
 #include "nav2_smac_planner/a_star.hpp"
+#include "nav2_smac_planner/search_corridor.hpp"
 using namespace std::chrono;  // NOLINT
 
 namespace nav2_smac_planner
@@ -46,7 +47,12 @@ AStarAlgorithm<NodeT>::AStarAlgorithm(
   _goal_coordinates(Coordinates()),
   _start(nullptr),
   _goal(nullptr),
-  _motion_model(motion_model)
+  _use_node_pool(false),
+  _heuristic_weight(1.0f),
+  _suboptimality_bound(1.0f),
+  _motion_model(motion_model),
+  _search_corridor(nullptr),
+  _partial_path_period(0.0)
 {
   _graph.reserve(100000);
 }
@@ -64,13 +70,17 @@ void AStarAlgorithm<NodeT>::initialize(
   const int & terminal_checking_interval,
   const double & max_planning_time,
   const float & lookup_table_size,
-  const unsigned int & dim_3_size)
+  const unsigned int & dim_3_size,
+  const bool & use_node_pool,
+  const unsigned int & open_list_arity)
 {
   _traverse_unknown = allow_unknown;
   _max_iterations = max_iterations;
   _max_on_approach_iterations = max_on_approach_iterations;
   _terminal_checking_interval = terminal_checking_interval;
   _max_planning_time = max_planning_time;
+  setNodePoolUsage(use_node_pool);
+  _queue.setArity(open_list_arity);
   if(!_is_initialized) {
     NodeT::precomputeDistanceHeuristic(lookup_table_size, _motion_model, dim_3_size, _search_info);
   }
@@ -88,13 +98,17 @@ void AStarAlgorithm<Node2D>::initialize(
   const int & terminal_checking_interval,
   const double & max_planning_time,
   const float & /*lookup_table_size*/,
-  const unsigned int & dim_3_size)
+  const unsigned int & dim_3_size,
+  const bool & use_node_pool,
+  const unsigned int & open_list_arity)
 {
   _traverse_unknown = allow_unknown;
   _max_iterations = max_iterations;
   _max_on_approach_iterations = max_on_approach_iterations;
   _terminal_checking_interval = terminal_checking_interval;
   _max_planning_time = max_planning_time;
+  setNodePoolUsage(use_node_pool);
+  _queue.setArity(open_list_arity);
 
   if (dim_3_size != 1) {
     throw std::runtime_error("Node type Node2D cannot be given non-1 dim 3 quantization.");
@@ -122,10 +136,28 @@ void AStarAlgorithm<NodeT>::setCollisionChecker(GridCollisionChecker * collision
   _expander->setCollisionChecker(_collision_checker);
 }
 
+template<typename NodeT>
+void AStarAlgorithm<NodeT>::setSearchCorridor(const SearchCorridor * search_corridor)
+{
+  _search_corridor = search_corridor;
+}
+
+template<typename NodeT>
+void AStarAlgorithm<NodeT>::setPartialPathCallback(
+  PartialPathCallback callback, const double & period)
+{
+  _partial_path_callback = callback;
+  _partial_path_period = period;
+}
+
 template<typename NodeT>
 typename AStarAlgorithm<NodeT>::NodePtr AStarAlgorithm<NodeT>::addToGraph(
   const uint64_t & index)
 {
+  if (_use_node_pool) {
+    return _node_pool.get(index);
+  }
+
   auto iter = _graph.find(index);
   if (iter != _graph.end()) {
     return &(iter->second);
@@ -167,10 +199,10 @@ void AStarAlgorithm<NodeT>::setStart(
 template<>
 void AStarAlgorithm<Node2D>::populateExpansionsLog(
   const NodePtr & node,
-  std::vector<std::tuple<float, float, float>> * expansions_log)
+  ExpansionsLog * expansions_log)
 {
   Node2D::Coordinates coords = node->getCoords(node->getIndex());
-  expansions_log->emplace_back(
+  expansions_log->add(
     _costmap->getOriginX() + ((coords.x + 0.5) * _costmap->getResolution()),
     _costmap->getOriginY() + ((coords.y + 0.5) * _costmap->getResolution()),
     0.0);
@@ -179,10 +211,10 @@ void AStarAlgorithm<Node2D>::populateExpansionsLog(
 template<typename NodeT>
 void AStarAlgorithm<NodeT>::populateExpansionsLog(
   const NodePtr & node,
-  std::vector<std::tuple<float, float, float>> * expansions_log)
+  ExpansionsLog * expansions_log)
 {
   typename NodeT::Coordinates coords = node->pose;
-  expansions_log->emplace_back(
+  expansions_log->add(
     _costmap->getOriginX() + ((coords.x + 0.5) * _costmap->getResolution()),
     _costmap->getOriginY() + ((coords.y + 0.5) * _costmap->getResolution()),
     NodeT::motion_table.getAngleFromBin(coords.theta));
@@ -204,6 +236,40 @@ void AStarAlgorithm<Node2D>::setGoal(
       static_cast<unsigned int>(my),
       getSizeX()));
   _goal_coordinates = Node2D::Coordinates(mx, my);
+  _other_goals.clear();
+  _other_goals_coordinates.clear();
+}
+
+template<>
+void AStarAlgorithm<Node2D>::addGoal(
+  const float & mx,
+  const float & my,
+  const unsigned int & dim_3)
+{
+  if (dim_3 != 0) {
+    throw std::runtime_error("Node type Node2D cannot be given non-zero goal dim 3.");
+  }
+
+  if (!_goal) {
+    throw std::runtime_error("Goal must be set before adding goals.");
+  }
+
+  _other_goals.push_back(
+    addToGraph(
+      Node2D::getIndex(
+        static_cast<unsigned int>(mx),
+        static_cast<unsigned int>(my),
+        getSizeX())));
+  _other_goals_coordinates.emplace_back(mx, my);
+}
+
+template<typename NodeT>
+void AStarAlgorithm<NodeT>::addGoal(
+  const float &,
+  const float &,
+  const unsigned int &)
+{
+  throw std::runtime_error("Only node type Node2D can plan to a set of goals.");
 }
 
 template<typename NodeT>
@@ -237,7 +303,7 @@ template<typename NodeT>
 bool AStarAlgorithm<NodeT>::areInputsValid()
 {
   // Check if graph was filled in
-  if (_graph.empty()) {
+  if (_graph.empty() && _node_pool.empty()) {
     throw std::runtime_error("Failed to compute path, no costmap given.");
   }
 
@@ -262,12 +328,16 @@ bool AStarAlgorithm<NodeT>::createPath(
   CoordinateVector & path, int & iterations,
   const float & tolerance,
   std::function<bool()> cancel_checker,
-  std::vector<std::tuple<float, float, float>> * expansions_log)
+  ExpansionsLog * expansions_log)
 {
   steady_clock::time_point start_time = steady_clock::now();
   _tolerance = tolerance;
   _best_heuristic_node = {std::numeric_limits<float>::max(), 0};
   clearQueue();
+  _closed_nodes.clear();
+  _heuristic_weight = std::max(_search_info.anytime_heuristic_weight, 1.0f);
+  _suboptimality_bound = 1.0f;
+  const bool anytime = _heuristic_weight > 1.0f;
 
   if (!areInputsValid()) {
     return false;
@@ -287,21 +357,61 @@ bool AStarAlgorithm<NodeT>::createPath(
   NeighborIterator neighbor_iterator;
   int analytic_iterations = 0;
   int closest_distance = std::numeric_limits<int>::max();
-
-  // Given an index, return a node ptr reference if its collision-free and valid
+  bool path_found = false;
+  float path_cost = std::numeric_limits<float>::max();
+  float completed_weight = std::numeric_limits<float>::max();
+  const bool stream_partial_paths = _partial_path_callback && _partial_path_period > 0.0;
+  steady_clock::time_point partial_path_time = start_time;
+  CoordinateVector partial_path;
+
+  // Given an index, return a node ptr reference if its collision-free and valid.
+  // Expansions inline it, analytic expansions take it as a NodeGetter made once here.
   const uint64_t max_index = static_cast<uint64_t>(getSizeX()) *
     static_cast<uint64_t>(getSizeY()) *
     static_cast<uint64_t>(getSizeDim3());
-  NodeGetter neighborGetter =
+  auto neighborGetter =
     [&, this](const uint64_t & index, NodePtr & neighbor_rtn) -> bool
     {
       if (index >= max_index) {
         return false;
       }
 
+      if (_search_corridor) {
+        const uint64_t cell = index / getSizeDim3();
+        if (!_search_corridor->contains(cell % getSizeX(), cell / getSizeX())) {
+          return false;
+        }
+      }
+
       neighbor_rtn = addToGraph(index);
       return true;
     };
+  const NodeGetter nodeGetter = neighborGetter;
+
+  // Analytic expansions run on a helper thread must not outlive the search,
+  // as the costmap may change once it returns
+  struct AsyncExpansionStopper
+  {
+    AnalyticExpansion<NodeT> * expander;
+    ~AsyncExpansionStopper() {expander->stopAsyncAnalyticExpansion();}
+  } async_expansion_stopper{_expander.get()};
+
+  // The graph is largest when the search returns
+  struct GraphMemoryRecorder
+  {
+    AStarAlgorithm<NodeT> * planner;
+    ~GraphMemoryRecorder() {planner->updateGraphMemory();}
+  } graph_memory_recorder{this};
+
+  // Anytime search keeps the cheapest path to the goal found and goes on to refine it
+  auto keepPath = [&](const NodePtr & goal_node)
+    {
+      if (goal_node->getAccumulatedCost() < path_cost) {
+        path_cost = goal_node->getAccumulatedCost();
+        path.clear();
+        path_found = goal_node->backtracePath(path);
+      }
+    };
 
   while (iterations < getMaxIterations() && !_queue.empty()) {
     // Check for planning timeout and cancel only on every Nth iteration
@@ -312,7 +422,47 @@ bool AStarAlgorithm<NodeT>::createPath(
       std::chrono::duration<double> planning_duration =
         std::chrono::duration_cast<std::chrono::duration<double>>(steady_clock::now() - start_time);
       if (static_cast<double>(planning_duration.count()) >= _max_planning_time) {
-        return false;
+        if (!path_found) {
+          return false;
+        }
+        break;
+      }
+
+      // Stream the path found so far, or the path to the node closest to the goal
+      std::chrono::duration<double> partial_path_duration =
+        std::chrono::duration_cast<std::chrono::duration<double>>(
+        steady_clock::now() - partial_path_time);
+      if (stream_partial_paths && partial_path_duration.count() >= _partial_path_period) {
+        partial_path_time = steady_clock::now();
+        if (path_found) {
+          _partial_path_callback(path);
+        } else if (_best_heuristic_node.first < std::numeric_limits<float>::max()) {
+          partial_path.clear();
+          if (addToGraph(_best_heuristic_node.second)->backtracePath(partial_path)) {
+            _partial_path_callback(partial_path);
+          }
+        }
+      }
+    }
+
+    if (path_found) {
+      std::chrono::duration<double> planning_duration =
+        std::chrono::duration_cast<std::chrono::duration<double>>(steady_clock::now() - start_time);
+      if (static_cast<double>(planning_duration.count()) >= _search_info.anytime_refinement_time) {
+        break;
+      }
+
+      // No node left to expand with this weight leads to a cheaper path,
+      // so the path is within the weight of the best path
+      if (_queue.top().first >= path_cost) {
+        completed_weight = _heuristic_weight;
+        if (_heuristic_weight <= 1.0f) {
+          break;
+        }
+        reweightOpenSet(
+          _search_info.anytime_weight_step > 0.0f ?
+          std::max(_heuristic_weight - _search_info.anytime_weight_step, 1.0f) : 1.0f);
+        continue;
       }
     }
 
@@ -334,23 +484,39 @@ bool AStarAlgorithm<NodeT>::createPath(
 
     // 2) Mark Nbest as visited
     current_node->visited();
+    if (anytime) {
+      _closed_nodes.push_back(current_node);
+    }
 
     // 2.1) Use an analytic expansion (if available) to generate a path
     expansion_result = nullptr;
-    expansion_result = _expander->tryAnalyticExpansion(
-      current_node, getGoal(), neighborGetter, analytic_iterations, closest_distance);
+    if (_search_info.analytic_expansion_candidates > 0) {
+      expansion_result = tryAsyncAnalyticExpansion(
+        current_node, nodeGetter, analytic_iterations, closest_distance);
+    } else {
+      expansion_result = _expander->tryAnalyticExpansion(
+        current_node, getGoal(), nodeGetter, analytic_iterations, closest_distance);
+    }
     if (expansion_result != nullptr) {
-      current_node = expansion_result;
+      if (!anytime) {
+        current_node = expansion_result;
+      } else {
+        keepPath(expansion_result);
+      }
     }
 
     // 3) Check if we're at the goal, backtrace if required
     if (isGoal(current_node)) {
-      return current_node->backtracePath(path);
-    } else if (_best_heuristic_node.first < getToleranceHeuristic()) {
+      if (!anytime) {
+        return current_node->backtracePath(path);
+      }
+      keepPath(current_node);
+      continue;
+    } else if (!path_found && _best_heuristic_node.first < getToleranceHeuristic()) {
       // Optimization: Let us find when in tolerance and refine within reason
       approach_iterations++;
       if (approach_iterations >= getOnApproachMaxIterations()) {
-        return _graph.at(_best_heuristic_node.second).backtracePath(path);
+        return addToGraph(_best_heuristic_node.second)->backtracePath(path);
       }
     }
 
@@ -372,23 +538,86 @@ bool AStarAlgorithm<NodeT>::createPath(
         neighbor->parent = current_node;
 
         // 4.3) Add to queue with heuristic cost
-        addNode(g_cost + getHeuristicCost(neighbor), neighbor);
+        addNode(getPriority(neighbor), neighbor);
       }
     }
   }
 
+  if (path_found) {
+    // Bounded by the weight of the last completed iteration and the open set's lower bound
+    _suboptimality_bound = std::max(
+      1.0f, std::min(completed_weight, path_cost / getOpenSetLowerBound()));
+    return true;
+  }
+
   if (_best_heuristic_node.first < getToleranceHeuristic()) {
     // If we run out of search options, return the path that is closest, if within tolerance.
-    return _graph.at(_best_heuristic_node.second).backtracePath(path);
+    return addToGraph(_best_heuristic_node.second)->backtracePath(path);
   }
 
   return false;
 }
 
+template<typename NodeT>
+typename AStarAlgorithm<NodeT>::NodePtr AStarAlgorithm<NodeT>::tryAsyncAnalyticExpansion(
+  const NodePtr & current_node, const NodeGetter & getter,
+  int & analytic_iterations, int & closest_distance)
+{
+  NodePtr expansion_result = _expander->getAsyncAnalyticExpansion(getGoal(), getter);
+  if (expansion_result != nullptr) {
+    return expansion_result;
+  }
+
+  if (_expander->isAnalyticExpansionDue(
+      current_node, getGoal(), analytic_iterations, closest_distance))
+  {
+    // Candidates are the expanded node, then the best queued nodes not visited yet,
+    // taken from the top levels of the open list's heap
+    const size_t num_candidates =
+      static_cast<size_t>(_search_info.analytic_expansion_candidates);
+    std::vector<NodeBasic<NodeT>> candidates;
+    candidates.reserve(num_candidates);
+    NodePtr node = current_node;
+    candidates.emplace_back(node->getIndex());
+    candidates.back().populateSearchNode(node);
+
+    const std::vector<NodeElement> & elements = _queue.elements();
+    std::vector<const NodeElement *> top_elements;
+    const size_t num_top_elements =
+      std::min(elements.size(), num_candidates * _queue.getArity());
+    for (size_t i = 0; i != num_top_elements; i++) {
+      top_elements.push_back(&elements[i]);
+    }
+    std::sort(
+      top_elements.begin(), top_elements.end(),
+      [](const NodeElement * a, const NodeElement * b) {return a->first < b->first;});
+    for (const NodeElement * element : top_elements) {
+      if (candidates.size() == num_candidates) {
+        break;
+      }
+      const NodePtr & queued_node = element->second.graph_node_ptr;
+      if (queued_node->wasVisited() ||
+        std::any_of(
+          candidates.begin(), candidates.end(),
+          [&](const NodeBasic<NodeT> & c) {return c.graph_node_ptr == queued_node;}))
+      {
+        continue;
+      }
+      candidates.push_back(element->second);
+    }
+    _expander->startAsyncAnalyticExpansion(candidates, getGoal());
+  }
+
+  analytic_iterations--;
+  return NodePtr(nullptr);
+}
+
 template<typename NodeT>
 bool AStarAlgorithm<NodeT>::isGoal(NodePtr & node)
 {
-  return node == getGoal();
+  return node == getGoal() ||
+         (!_other_goals.empty() &&
+         std::find(_other_goals.begin(), _other_goals.end(), node) != _other_goals.end());
 }
 
 template<typename NodeT>
@@ -427,6 +656,9 @@ float AStarAlgorithm<NodeT>::getHeuristicCost(const NodePtr & node)
     NodeT::getCoords(node->getIndex(), getSizeX(), getSizeDim3());
   float heuristic = NodeT::getHeuristicCost(
     node_coords, _goal_coordinates);
+  for (const Coordinates & goal_coords : _other_goals_coordinates) {
+    heuristic = std::min(heuristic, NodeT::getHeuristicCost(node_coords, goal_coords));
+  }
 
   if (heuristic < _best_heuristic_node.first) {
     _best_heuristic_node = {heuristic, node->getIndex()};
@@ -435,19 +667,123 @@ float AStarAlgorithm<NodeT>::getHeuristicCost(const NodePtr & node)
   return heuristic;
 }
 
+template<typename NodeT>
+float AStarAlgorithm<NodeT>::getPriority(const NodePtr & node)
+{
+  return node->getAccumulatedCost() + _heuristic_weight * getHeuristicCost(node);
+}
+
+template<typename NodeT>
+void AStarAlgorithm<NodeT>::reweightOpenSet(const float & heuristic_weight)
+{
+  // Node costs only decrease, so the lowest entry of a node is the one queued with its
+  // current cost. Higher entries would otherwise restore the pose of a superseded branch
+  // once the node is reopened, so only the lowest is requeued, using the visited flag to
+  // mark the nodes already requeued
+  _queue.extract(_requeued_elements);
+  std::sort(
+    _requeued_elements.begin(), _requeued_elements.end(),
+    [](const NodeElement & a, const NodeElement & b) {return a.first < b.first;});
+  _heuristic_weight = heuristic_weight;
+  const size_t num_closed_nodes = _closed_nodes.size();
+  for (auto & element : _requeued_elements) {
+    NodePtr node = element.second.graph_node_ptr;
+    if (node->wasVisited()) {
+      continue;
+    }
+    node->visited();
+    _closed_nodes.push_back(node);
+    element.first = getPriority(node);
+    _queue.push(std::move(element));
+  }
+
+  for (auto & node : _closed_nodes) {
+    node->clearVisited();
+  }
+
+  // Nodes are not reopened within an iteration, so the nodes visited may have costs
+  // the iteration found cheaper ways to. They are all requeued with their cost to be
+  // expanded again, if the lower weight gets to them before the path's cost
+  for (size_t i = 0; i != num_closed_nodes; i++) {
+    addNode(getPriority(_closed_nodes[i]), _closed_nodes[i]);
+  }
+  _closed_nodes.clear();
+}
+
+template<typename NodeT>
+float AStarAlgorithm<NodeT>::getOpenSetLowerBound()
+{
+  // Entries of superseded costs are higher than a node's current entry, so do not
+  // change the minimum
+  float lower_bound = std::numeric_limits<float>::max();
+  for (const auto & element : _queue.elements()) {
+    NodePtr node = element.second.graph_node_ptr;
+    if (!node->wasVisited()) {
+      lower_bound = std::min(lower_bound, node->getAccumulatedCost() + getHeuristicCost(node));
+    }
+  }
+  return lower_bound;
+}
+
+template<typename NodeT>
+float AStarAlgorithm<NodeT>::getSuboptimalityBound() const
+{
+  return _suboptimality_bound;
+}
+
 template<typename NodeT>
 void AStarAlgorithm<NodeT>::clearQueue()
 {
-  NodeQueue q;
-  std::swap(_queue, q);
+  _queue.clear();
 }
 
 template<typename NodeT>
 void AStarAlgorithm<NodeT>::clearGraph()
 {
+  if (_use_node_pool) {
+    _node_pool.clear();
+    return;
+  }
+
   Graph g;
   std::swap(_graph, g);
   _graph.reserve(100000);
+  updateGraphMemory();
+}
+
+template<typename NodeT>
+void AStarAlgorithm<NodeT>::setNodePoolUsage(const bool & use_node_pool)
+{
+  if (use_node_pool == _use_node_pool) {
+    return;
+  }
+
+  // Nodes only live in the backend in use
+  _use_node_pool = use_node_pool;
+  if (_use_node_pool) {
+    Graph g;
+    std::swap(_graph, g);
+  } else {
+    _node_pool.reset();
+    _graph.reserve(100000);
+  }
+  _start = nullptr;
+  _goal = nullptr;
+  _other_goals.clear();
+  _other_goals_coordinates.clear();
+  updateGraphMemory();
+}
+
+template<typename NodeT>
+void AStarAlgorithm<NodeT>::updateGraphMemory()
+{
+  // Nodes of the map are allocated one by one next to their key, with a bucket per slot
+  size_t bytes = _node_pool.getMemoryUsage();
+  if (!_use_node_pool) {
+    bytes += _graph.size() * sizeof(typename Graph::value_type) +
+      (_graph.mask() + 1) * (sizeof(void *) + 1);
+  }
+  _graph_memory.update(bytes);
 }
 
 template<typename NodeT>
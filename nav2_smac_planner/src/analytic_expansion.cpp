@@ -12,11 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License. Reserved.
 
-#include <ompl/base/ScopedState.h>
-#include <ompl/base/spaces/DubinsStateSpace.h>
-#include <ompl/base/spaces/ReedsSheppStateSpace.h>
-
 #include <algorithm>
+#include <chrono>
 #include <vector>
 #include <memory>
 
@@ -39,6 +36,12 @@ AnalyticExpansion<NodeT>::AnalyticExpansion(
 {
 }
 
+template<typename NodeT>
+AnalyticExpansion<NodeT>::~AnalyticExpansion()
+{
+  stopAsyncAnalyticExpansion();
+}
+
 template<typename NodeT>
 void AnalyticExpansion<NodeT>::setCollisionChecker(
   GridCollisionChecker * collision_checker)
@@ -46,6 +49,47 @@ void AnalyticExpansion<NodeT>::setCollisionChecker(
   _collision_checker = collision_checker;
 }
 
+template<typename NodeT>
+bool AnalyticExpansion<NodeT>::isAnalyticExpansionDue(
+  const NodePtr & current_node, const NodePtr & goal_node,
+  int & analytic_iterations, int & closest_distance)
+{
+  // This must be a valid motion model for analytic expansion to be attempted
+  if (_motion_model != MotionModel::DUBIN && _motion_model != MotionModel::REEDS_SHEPP &&
+    _motion_model != MotionModel::STATE_LATTICE)
+  {
+    return false;
+  }
+
+  // See if we are closer and should be expanding more often
+  const Coordinates node_coords =
+    NodeT::getCoords(
+    current_node->getIndex(), _collision_checker->getCostmap()->getSizeInCellsX(), _dim_3_size);
+  closest_distance = std::min(
+    closest_distance,
+    static_cast<int>(NodeT::getHeuristicCost(node_coords, goal_node->pose)));
+
+  // We want to expand at a rate of d/expansion_ratio,
+  // but check to see if we are so close that we would be expanding every iteration
+  // If so, limit it to the expansion ratio (rounded up)
+  int desired_iterations = std::max(
+    static_cast<int>(closest_distance / _search_info.analytic_expansion_ratio),
+    static_cast<int>(std::ceil(_search_info.analytic_expansion_ratio)));
+
+  // If we are closer now, we should update the target number of iterations to go
+  analytic_iterations =
+    std::min(analytic_iterations, desired_iterations);
+
+  // Always run the expansion on the first run in case there is a
+  // trivial path to be found
+  if (analytic_iterations <= 0) {
+    // Reset the counter for the analytic path expansion to try
+    analytic_iterations = desired_iterations;
+    return true;
+  }
+  return false;
+}
+
 template<typename NodeT>
 typename AnalyticExpansion<NodeT>::NodePtr AnalyticExpansion<NodeT>::tryAnalyticExpansion(
   const NodePtr & current_node, const NodePtr & goal_node,
@@ -56,32 +100,9 @@ typename AnalyticExpansion<NodeT>::NodePtr AnalyticExpansion<NodeT>::tryAnalytic
   if (_motion_model == MotionModel::DUBIN || _motion_model == MotionModel::REEDS_SHEPP ||
     _motion_model == MotionModel::STATE_LATTICE)
   {
-    // See if we are closer and should be expanding more often
-    const Coordinates node_coords =
-      NodeT::getCoords(
-      current_node->getIndex(), _collision_checker->getCostmap()->getSizeInCellsX(), _dim_3_size);
-    closest_distance = std::min(
-      closest_distance,
-      static_cast<int>(NodeT::getHeuristicCost(node_coords, goal_node->pose)));
-
-    // We want to expand at a rate of d/expansion_ratio,
-    // but check to see if we are so close that we would be expanding every iteration
-    // If so, limit it to the expansion ratio (rounded up)
-    int desired_iterations = std::max(
-      static_cast<int>(closest_distance / _search_info.analytic_expansion_ratio),
-      static_cast<int>(std::ceil(_search_info.analytic_expansion_ratio)));
-
-    // If we are closer now, we should update the target number of iterations to go
-    analytic_iterations =
-      std::min(analytic_iterations, desired_iterations);
-
-    // Always run the expansion on the first run in case there is a
-    // trivial path to be found
-    if (analytic_iterations <= 0) {
-      // Reset the counter and try the analytic path expansion
-      analytic_iterations = desired_iterations;
+    if (isAnalyticExpansionDue(current_node, goal_node, analytic_iterations, closest_distance)) {
       AnalyticExpansionNodes analytic_nodes =
-        getAnalyticPath(current_node, goal_node, getter, current_node->motion_table.state_space);
+        getAnalyticPath(current_node, goal_node, getter, current_node->motion_table.curve_solver);
       if (!analytic_nodes.empty()) {
         // If we have a valid path, attempt to refine it
         NodePtr node = current_node;
@@ -96,7 +117,7 @@ typename AnalyticExpansion<NodeT>::NodePtr AnalyticExpansion<NodeT>::tryAnalytic
           {
             test_node = test_node->parent->parent->parent->parent->parent;
             refined_analytic_nodes =
-              getAnalyticPath(test_node, goal_node, getter, test_node->motion_table.state_space);
+              getAnalyticPath(test_node, goal_node, getter, test_node->motion_table.curve_solver);
             if (refined_analytic_nodes.empty()) {
               break;
             }
@@ -137,13 +158,9 @@ typename AnalyticExpansion<NodeT>::NodePtr AnalyticExpansion<NodeT>::tryAnalytic
         const float max_min_turn_rad = 4.0 * min_turn_rad;  // Up to 4x the turning radius
         while (min_turn_rad < max_min_turn_rad) {
           min_turn_rad += 0.5;  // In Grid Coords, 1/2 cell steps
-          ompl::base::StateSpacePtr state_space;
-          if (node->motion_table.motion_model == MotionModel::DUBIN) {
-            state_space = std::make_shared<ompl::base::DubinsStateSpace>(min_turn_rad);
-          } else {
-            state_space = std::make_shared<ompl::base::ReedsSheppStateSpace>(min_turn_rad);
-          }
-          refined_analytic_nodes = getAnalyticPath(node, goal_node, getter, state_space);
+          const CurveSolver curve_solver(
+            min_turn_rad, node->motion_table.curve_solver.isReverseAllowed());
+          refined_analytic_nodes = getAnalyticPath(node, goal_node, getter, curve_solver);
           score = scoringFn(refined_analytic_nodes);
           if (score <= best_score) {
             analytic_nodes = refined_analytic_nodes;
@@ -167,17 +184,16 @@ typename AnalyticExpansion<NodeT>::AnalyticExpansionNodes AnalyticExpansion<Node
   const NodePtr & node,
   const NodePtr & goal,
   const NodeGetter & node_getter,
-  const ompl::base::StateSpacePtr & state_space)
+  const CurveSolver & curve_solver)
 {
-  static ompl::base::ScopedState<> from(state_space), to(state_space), s(state_space);
-  from[0] = node->pose.x;
-  from[1] = node->pose.y;
-  from[2] = node->motion_table.getAngleFromBin(node->pose.theta);
-  to[0] = goal->pose.x;
-  to[1] = goal->pose.y;
-  to[2] = node->motion_table.getAngleFromBin(goal->pose.theta);
+  const CurvePose from{node->pose.x, node->pose.y,
+    node->motion_table.getAngleFromBin(node->pose.theta)};
+  const CurvePose to{goal->pose.x, goal->pose.y,
+    node->motion_table.getAngleFromBin(goal->pose.theta)};
 
-  float d = state_space->distance(from(), to());
+  // The path is solved once, the poses sampled along it
+  const CurvePath path = curve_solver.solve(from, to);
+  float d = curve_solver.getTurningRadius() * path.length;
 
   // A move of sqrt(2) is guaranteed to be in a new cell
   static const float sqrt_2 = sqrtf(2.0f);
@@ -196,7 +212,7 @@ typename AnalyticExpansion<NodeT>::AnalyticExpansionNodes AnalyticExpansion<Node
   // When "from" and "to" are zero or one cell away,
   // num_intervals == 0
   possible_nodes.reserve(num_intervals);  // We won't store this node or the goal
-  std::vector<double> reals;
+  CurvePose s;
   double theta;
 
   // Pre-allocate
@@ -211,22 +227,21 @@ typename AnalyticExpansion<NodeT>::AnalyticExpansionNodes AnalyticExpansion<Node
 
   // Check intermediary poses (non-goal, non-start)
   for (float i = 1; i <= num_intervals; i++) {
-    state_space->interpolate(from(), to(), i / num_intervals, s());
-    reals = s.reals();
+    s = curve_solver.interpolate(path, from, to, i / num_intervals);
     // Make sure in range [0, 2PI)
-    theta = (reals[2] < 0.0) ? (reals[2] + 2.0 * M_PI) : reals[2];
+    theta = (s.theta < 0.0) ? (s.theta + 2.0 * M_PI) : s.theta;
     theta = (theta > 2.0 * M_PI) ? (theta - 2.0 * M_PI) : theta;
     angle = node->motion_table.getClosestAngularBin(theta);
 
     // Turn the pose into a node, and check if it is valid
     index = NodeT::getIndex(
-      static_cast<unsigned int>(reals[0]),
-      static_cast<unsigned int>(reals[1]),
+      static_cast<unsigned int>(s.x),
+      static_cast<unsigned int>(s.y),
       static_cast<unsigned int>(angle));
     // Get the node from the graph
     if (node_getter(index, next)) {
       Coordinates initial_node_coords = next->pose;
-      proposed_coordinates = {static_cast<float>(reals[0]), static_cast<float>(reals[1]), angle};
+      proposed_coordinates = {static_cast<float>(s.x), static_cast<float>(s.y), angle};
       next->setPose(proposed_coordinates);
       if (next->isNodeValid(_traverse_unknown, _collision_checker) && next != prev) {
         // Save the node, and its previous coordinates in case we need to abort
@@ -248,35 +263,7 @@ typename AnalyticExpansion<NodeT>::AnalyticExpansionNodes AnalyticExpansion<Node
 
   if (!failure) {
     // We found 'a' valid expansion. Now to tell if its a quality option...
-    const float max_cost = _search_info.analytic_expansion_max_cost;
-    auto max_cost_it = std::max_element(node_costs.begin(), node_costs.end());
-    if (max_cost_it != node_costs.end() && *max_cost_it > max_cost) {
-      // If any element is above the comfortable cost limit, check edge cases:
-      // (1) Check if goal is in greater than max_cost space requiring
-      //  entering it, but only entering it on final approach, not in-and-out
-      // (2) Checks if goal is in normal space, but enters costed space unnecessarily
-      //  mid-way through, skirting obstacle or in non-globally confined space
-      bool cost_exit_high_cost_region = false;
-      for (auto iter = node_costs.rbegin(); iter != node_costs.rend(); ++iter) {
-        const float & curr_cost = *iter;
-        if (curr_cost <= max_cost) {
-          cost_exit_high_cost_region = true;
-        } else if (curr_cost > max_cost && cost_exit_high_cost_region) {
-          failure = true;
-          break;
-        }
-      }
-
-      // (3) Handle exception: there may be no other option close to goal
-      // if max cost is set too low (optional)
-      if (failure) {
-        if (d < 2.0f * M_PI * goal->motion_table.min_turning_radius &&
-          _search_info.analytic_expansion_max_cost_override)
-        {
-          failure = false;
-        }
-      }
-    }
+    failure = !isAnalyticPathCostAdmissible(node_costs, d, goal->motion_table.min_turning_radius);
   }
 
   // Reset to initial poses to not impact future searches
@@ -292,6 +279,248 @@ typename AnalyticExpansion<NodeT>::AnalyticExpansionNodes AnalyticExpansion<Node
   return possible_nodes;
 }
 
+template<typename NodeT>
+bool AnalyticExpansion<NodeT>::isAnalyticPathCostAdmissible(
+  const std::vector<float> & node_costs, const float & d, const float & min_turning_radius)
+{
+  const float max_cost = _search_info.analytic_expansion_max_cost;
+  auto max_cost_it = std::max_element(node_costs.begin(), node_costs.end());
+  if (max_cost_it == node_costs.end() || *max_cost_it <= max_cost) {
+    return true;
+  }
+
+  // If any element is above the comfortable cost limit, check edge cases:
+  // (1) Check if goal is in greater than max_cost space requiring
+  //  entering it, but only entering it on final approach, not in-and-out
+  // (2) Checks if goal is in normal space, but enters costed space unnecessarily
+  //  mid-way through, skirting obstacle or in non-globally confined space
+  bool cost_exit_high_cost_region = false;
+  for (auto iter = node_costs.rbegin(); iter != node_costs.rend(); ++iter) {
+    const float & curr_cost = *iter;
+    if (curr_cost <= max_cost) {
+      cost_exit_high_cost_region = true;
+    } else if (curr_cost > max_cost && cost_exit_high_cost_region) {
+      // (3) Handle exception: there may be no other option close to goal
+      // if max cost is set too low (optional)
+      return d < 2.0f * M_PI * min_turning_radius &&
+             _search_info.analytic_expansion_max_cost_override;
+    }
+  }
+  return true;
+}
+
+template<typename NodeT>
+void AnalyticExpansion<NodeT>::startAsyncAnalyticExpansion(
+  const std::vector<NodeBasic<NodeT>> & candidates, const NodePtr & goal_node)
+{
+  if (_async_expansion.valid() || candidates.empty()) {
+    return;
+  }
+
+  // The helper thread only reads the costmap, with a collision checker of its own,
+  // copied once per search as the footprint may change between searches
+  if (!_async_collision_checker) {
+    _async_collision_checker = std::make_unique<GridCollisionChecker>(*_collision_checker);
+    nav2_costmap_2d::Costmap2D * costmap = _collision_checker->getCostmap();
+    _async_max_index = static_cast<uint64_t>(costmap->getSizeInCellsX()) *
+      static_cast<uint64_t>(costmap->getSizeInCellsY()) * static_cast<uint64_t>(_dim_3_size);
+  }
+
+  // Snapshot the poses to expand from, as the search goes on changing the graph
+  _async_candidates.clear();
+  for (const auto & entry : candidates) {
+    _async_candidates.push_back(AsyncCandidate{entry, {entry.graph_node_ptr}, {entry.pose}});
+    AsyncCandidate & candidate = _async_candidates.back();
+
+    // Ancestors in 5 node increments to attempt better paths from, as in
+    // tryAnalyticExpansion (maximum of 40 points back)
+    NodePtr test_node = entry.graph_node_ptr;
+    for (int i = 0; i < 8; i++) {
+      int steps = 0;
+      while (steps < 5 && test_node->parent) {
+        test_node = test_node->parent;
+        steps++;
+      }
+      if (steps < 5) {
+        break;
+      }
+      candidate.nodes.push_back(test_node);
+      candidate.poses.push_back(test_node->pose);
+    }
+  }
+
+  const Coordinates goal_pose = goal_node->pose;
+  _async_expansion = std::async(
+    std::launch::async, [this, goal_pose]() {return runAsyncAnalyticExpansion(goal_pose);});
+}
+
+template<typename NodeT>
+typename AnalyticExpansion<NodeT>::NodePtr AnalyticExpansion<NodeT>::getAsyncAnalyticExpansion(
+  const NodePtr & goal_node, const NodeGetter & getter)
+{
+  if (!_async_expansion.valid() ||
+    _async_expansion.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+  {
+    return NodePtr(nullptr);
+  }
+
+  AsyncResult result = _async_expansion.get();
+  if (result.candidate < 0) {
+    return NodePtr(nullptr);
+  }
+
+  // Set the path in the graph from the node found, from its queued pose if it was
+  // not visited since. The costmap did not change, so the expansion is valid again
+  // unless the node's pose changed since.
+  AsyncCandidate & candidate = _async_candidates[result.candidate];
+  NodePtr node = candidate.nodes[result.start];
+  if (result.start == 0) {
+    candidate.entry.processSearchNode();
+  }
+  AnalyticExpansionNodes analytic_nodes =
+    getAnalyticPath(node, goal_node, getter, result.curve_solver);
+  if (analytic_nodes.empty()) {
+    return NodePtr(nullptr);
+  }
+  return setAnalyticPath(node, goal_node, analytic_nodes);
+}
+
+template<typename NodeT>
+void AnalyticExpansion<NodeT>::stopAsyncAnalyticExpansion()
+{
+  if (_async_expansion.valid()) {
+    _async_expansion_stop = true;
+    _async_expansion.wait();
+    _async_expansion = std::future<AsyncResult>();
+  }
+  _async_expansion_stop = false;
+  _async_candidates.clear();
+  _async_collision_checker.reset();
+}
+
+template<typename NodeT>
+typename AnalyticExpansion<NodeT>::AsyncResult
+AnalyticExpansion<NodeT>::runAsyncAnalyticExpansion(const Coordinates goal_pose)
+{
+  AsyncResult result;
+  NodeT scratch(0);
+  float score = 0.0f;
+  for (unsigned int i = 0; i != _async_candidates.size(); i++) {
+    const std::vector<Coordinates> & poses = _async_candidates[i].poses;
+    if (_async_expansion_stop) {
+      return result;
+    }
+    if (!checkAnalyticPath(poses[0], goal_pose, NodeT::motion_table.curve_solver, scratch, score)) {
+      continue;
+    }
+
+    // Attempt to create better paths from further back, while they are valid
+    float best_score = score;
+    result.candidate = static_cast<int>(i);
+    result.curve_solver = NodeT::motion_table.curve_solver;
+    for (unsigned int j = 1; j < poses.size() && !_async_expansion_stop; j++) {
+      if (!checkAnalyticPath(poses[j], goal_pose, result.curve_solver, scratch, score)) {
+        break;
+      }
+      best_score = score;
+      result.start = j;
+    }
+
+    // Refine it by increasing the possible radius higher than the minimum turning radius,
+    // using the best solution based on the same scoring function as tryAnalyticExpansion
+    float min_turn_rad = NodeT::motion_table.min_turning_radius;
+    const float max_min_turn_rad = 4.0 * min_turn_rad;  // Up to 4x the turning radius
+    while (min_turn_rad < max_min_turn_rad && !_async_expansion_stop) {
+      min_turn_rad += 0.5;  // In Grid Coords, 1/2 cell steps
+      const CurveSolver curve_solver(
+        min_turn_rad, NodeT::motion_table.curve_solver.isReverseAllowed());
+      if (checkAnalyticPath(poses[result.start], goal_pose, curve_solver, scratch, score) &&
+        score <= best_score)
+      {
+        result.curve_solver = curve_solver;
+        best_score = score;
+      }
+    }
+    return result;
+  }
+  return result;
+}
+
+template<typename NodeT>
+bool AnalyticExpansion<NodeT>::checkAnalyticPath(
+  const Coordinates & start, const Coordinates & goal,
+  const CurveSolver & curve_solver, NodeT & scratch, float & score)
+{
+  const CurvePose from{start.x, start.y, NodeT::motion_table.getAngleFromBin(start.theta)};
+  const CurvePose to{goal.x, goal.y, NodeT::motion_table.getAngleFromBin(goal.theta)};
+
+  // Same limits and poses as getAnalyticPath, see there
+  const CurvePath path = curve_solver.solve(from, to);
+  float d = curve_solver.getTurningRadius() * path.length;
+  static const float sqrt_2 = sqrtf(2.0f);
+  if (d > _search_info.analytic_expansion_max_length || d < sqrt_2) {
+    return false;
+  }
+
+  unsigned int num_intervals = static_cast<unsigned int>(std::floor(d / sqrt_2));
+  std::vector<float> node_costs;
+  node_costs.reserve(num_intervals);
+  CurvePose s;
+  double theta;
+  float angle = 0.0;
+  float distance = 0.0;
+  uint64_t prev_index = NodeT::getIndex(
+    static_cast<unsigned int>(start.x), static_cast<unsigned int>(start.y),
+    static_cast<unsigned int>(start.theta));
+  Coordinates prev_coordinates = start;
+
+  for (float i = 1; i <= num_intervals; i++) {
+    s = curve_solver.interpolate(path, from, to, i / num_intervals);
+    // Make sure in range [0, 2PI)
+    theta = (s.theta < 0.0) ? (s.theta + 2.0 * M_PI) : s.theta;
+    theta = (theta > 2.0 * M_PI) ? (theta - 2.0 * M_PI) : theta;
+    angle = NodeT::motion_table.getClosestAngularBin(theta);
+
+    const uint64_t index = NodeT::getIndex(
+      static_cast<unsigned int>(s.x),
+      static_cast<unsigned int>(s.y),
+      static_cast<unsigned int>(angle));
+    if (index >= _async_max_index || index == prev_index) {
+      return false;
+    }
+
+    const Coordinates coordinates(static_cast<float>(s.x), static_cast<float>(s.y), angle);
+    scratch.setPose(coordinates);
+    if (!scratch.isNodeValid(_traverse_unknown, _async_collision_checker.get())) {
+      return false;
+    }
+    node_costs.push_back(scratch.getCost());
+
+    // Analytic expansions are consistently spaced
+    if (node_costs.size() == 2) {
+      distance = hypotf(
+        coordinates.x - prev_coordinates.x, coordinates.y - prev_coordinates.y);
+    }
+    prev_coordinates = coordinates;
+    prev_index = index;
+  }
+
+  if (!isAnalyticPathCostAdmissible(node_costs, d, NodeT::motion_table.min_turning_radius)) {
+    return false;
+  }
+
+  // Search's Traversal Cost Function
+  score = std::numeric_limits<float>::max();
+  if (node_costs.size() >= 2) {
+    const float & weight = NodeT::motion_table.cost_penalty;
+    score = 0.0f;
+    for (const float & cost : node_costs) {
+      score += distance * (1.0 + weight * cost / 252.0f);
+    }
+  }
+  return true;
+}
+
 template<typename NodeT>
 typename AnalyticExpansion<NodeT>::NodePtr AnalyticExpansion<NodeT>::setAnalyticPath(
   const NodePtr & node,
@@ -299,6 +528,10 @@ typename AnalyticExpansion<NodeT>::NodePtr AnalyticExpansion<NodeT>::setAnalytic
   const AnalyticExpansionNodes & expanded_nodes)
 {
   _detached_nodes.clear();
+  if (_search_info.anytime_heuristic_weight > 1.0f) {
+    return setDetachedAnalyticPath(node, goal_node, expanded_nodes);
+  }
+
   // Legitimate final path - set the parent relationships, states, and poses
   NodePtr prev = node;
   for (const auto & node_pose : expanded_nodes) {
@@ -323,6 +556,45 @@ typename AnalyticExpansion<NodeT>::NodePtr AnalyticExpansion<NodeT>::setAnalytic
   return goal_node;
 }
 
+template<typename NodeT>
+typename AnalyticExpansion<NodeT>::NodePtr AnalyticExpansion<NodeT>::setDetachedAnalyticPath(
+  const NodePtr & node,
+  const NodePtr & goal_node,
+  const AnalyticExpansionNodes & expanded_nodes)
+{
+  // Same traversal cost as the expansion's scoring function, from the node's cost
+  const float & weight = node->motion_table.cost_penalty;
+  auto traversalCost = [&](const NodePtr & from, const Coordinates & to, const float & cost) {
+      return hypotf(to.x - from->pose.x, to.y - from->pose.y) * (1.0f + weight * cost / 252.0f);
+    };
+
+  NodePtr prev = node;
+  for (const auto & node_pose : expanded_nodes) {
+    if (node_pose.node->getIndex() != goal_node->getIndex()) {
+      _detached_nodes.push_back(std::make_unique<NodeT>(-1));
+      NodePtr n = _detached_nodes.back().get();
+      n->parent = prev;
+      n->pose = node_pose.proposed_coords;
+      n->setAccumulatedCost(
+        prev->getAccumulatedCost() +
+        traversalCost(prev, node_pose.proposed_coords, node_pose.node->getCost()));
+      n->visited();
+      prev = n;
+    }
+  }
+
+  _detached_nodes.push_back(std::make_unique<NodeT>(goal_node->getIndex()));
+  NodePtr goal = _detached_nodes.back().get();
+  goal->parent = prev;
+  goal->pose = goal_node->pose;
+  // The goal's cell cost is only known if it was checked, the expansion ends next to it
+  const float goal_cost = expanded_nodes.empty() ? 0.0f : expanded_nodes.back().node->getCost();
+  goal->setAccumulatedCost(
+    prev->getAccumulatedCost() + traversalCost(prev, goal_node->pose, goal_cost));
+  goal->visited();
+  return goal;
+}
+
 template<>
 void AnalyticExpansion<NodeLattice>::cleanNode(const NodePtr & node)
 {
@@ -340,7 +612,7 @@ getAnalyticPath(
   const NodePtr & node,
   const NodePtr & goal,
   const NodeGetter & node_getter,
-  const ompl::base::StateSpacePtr & state_space)
+  const CurveSolver & curve_solver)
 {
   return AnalyticExpansionNodes();
 }
@@ -354,6 +626,15 @@ typename AnalyticExpansion<Node2D>::NodePtr AnalyticExpansion<Node2D>::setAnalyt
   return NodePtr(nullptr);
 }
 
+template<>
+typename AnalyticExpansion<Node2D>::NodePtr AnalyticExpansion<Node2D>::setDetachedAnalyticPath(
+  const NodePtr & /*node*/,
+  const NodePtr & /*goal_node*/,
+  const AnalyticExpansionNodes & /*expanded_nodes*/)
+{
+  return NodePtr(nullptr);
+}
+
 template<>
 typename AnalyticExpansion<Node2D>::NodePtr AnalyticExpansion<Node2D>::tryAnalyticExpansion(
   const NodePtr & current_node, const NodePtr & goal_node,
@@ -363,6 +644,35 @@ typename AnalyticExpansion<Node2D>::NodePtr AnalyticExpansion<Node2D>::tryAnalyt
   return NodePtr(nullptr);
 }
 
+template<>
+bool AnalyticExpansion<Node2D>::isAnalyticExpansionDue(
+  const NodePtr & /*current_node*/, const NodePtr & /*goal_node*/,
+  int & /*analytic_iterations*/, int & /*closest_distance*/)
+{
+  return false;
+}
+
+template<>
+void AnalyticExpansion<Node2D>::startAsyncAnalyticExpansion(
+  const std::vector<NodeBasic<Node2D>> & /*candidates*/, const NodePtr & /*goal_node*/)
+{
+}
+
+template<>
+typename AnalyticExpansion<Node2D>::AsyncResult
+AnalyticExpansion<Node2D>::runAsyncAnalyticExpansion(const Coordinates /*goal_pose*/)
+{
+  return AsyncResult();
+}
+
+template<>
+bool AnalyticExpansion<Node2D>::checkAnalyticPath(
+  const Coordinates & /*start*/, const Coordinates & /*goal*/,
+  const CurveSolver & /*curve_solver*/, Node2D & /*scratch*/, float & /*score*/)
+{
+  return false;
+}
+
 template class AnalyticExpansion<Node2D>;
 template class AnalyticExpansion<NodeHybrid>;
 template class AnalyticExpansion<NodeLattice>;
@@ -0,0 +1,291 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "nav2_smac_planner/bidirectional_a_star.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <initializer_list>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "nav2_core/planner_exceptions.hpp"
+
+namespace nav2_smac_planner
+{
+
+using namespace std::chrono;  // NOLINT
+
+namespace
+{
+
+constexpr double INF = std::numeric_limits<double>::infinity();
+
+// Moore neighborhood, in the order of Node2D
+constexpr int NEIGHBORS_DX[8] = {-1, 1, 0, 0, -1, 1, -1, 1};
+constexpr int NEIGHBORS_DY[8] = {0, 0, -1, 1, -1, -1, 1, 1};
+constexpr double NEIGHBORS_LENGTH[8] = {1.0, 1.0, 1.0, 1.0, M_SQRT2, M_SQRT2, M_SQRT2, M_SQRT2};
+
+}  // namespace
+
+BidirectionalAStar::BidirectionalAStar()
+: _collision_checker(nullptr),
+  _traverse_unknown(true),
+  _max_iterations(std::numeric_limits<int>::max()),
+  _terminal_checking_interval(5000),
+  _max_planning_time(0.0),
+  _cost_penalty(2.0),
+  _x_size(0),
+  _y_size(0),
+  _start(0),
+  _goal(0),
+  _best_cost(INF),
+  _meeting(0)
+{
+  _forward.closed_flag = 1;
+  _forward.forward = true;
+  _backward.closed_flag = 2;
+  _backward.forward = false;
+}
+
+void BidirectionalAStar::initialize(
+  const bool & allow_unknown,
+  const int & max_iterations,
+  const int & terminal_checking_interval,
+  const double & max_planning_time,
+  const float & cost_penalty,
+  const unsigned int & open_list_arity)
+{
+  _traverse_unknown = allow_unknown;
+  _max_iterations = max_iterations;
+  _terminal_checking_interval = std::max(terminal_checking_interval, 1);
+  _max_planning_time = max_planning_time;
+  _cost_penalty = cost_penalty;
+  _forward.queue.setArity(open_list_arity);
+  _backward.queue.setArity(open_list_arity);
+}
+
+void BidirectionalAStar::setCollisionChecker(GridCollisionChecker * collision_checker)
+{
+  _collision_checker = collision_checker;
+  _x_size = collision_checker->getCostmap()->getSizeInCellsX();
+  _y_size = collision_checker->getCostmap()->getSizeInCellsY();
+}
+
+void BidirectionalAStar::setGoal(const unsigned int & mx, const unsigned int & my)
+{
+  _goal = my * _x_size + mx;
+}
+
+void BidirectionalAStar::setStart(const unsigned int & mx, const unsigned int & my)
+{
+  _start = my * _x_size + mx;
+}
+
+int & BidirectionalAStar::getMaxIterations()
+{
+  return _max_iterations;
+}
+
+void BidirectionalAStar::resetSearch()
+{
+  const size_t size = static_cast<size_t>(_x_size) * static_cast<size_t>(_y_size);
+  _closed.assign(size, 0);
+  _cell_factors.assign(size, std::numeric_limits<float>::quiet_NaN());
+  _best_cost = INF;
+  _meeting = _start;
+
+  // The forward side searches from the start to the goal, the backward side the reverse
+  for (Side * side : {&_forward, &_backward}) {
+    side->g.assign(size, INF);
+    side->parents.resize(size);
+    side->queue.clear();
+    side->root = side->forward ? _start : _goal;
+    side->target = side->forward ? _goal : _start;
+    side->g[side->root] = 0.0;
+    side->parents[side->root] = side->root;
+    side->queue.emplace(getHeuristicCost(side->root, side->target), side->root);
+  }
+}
+
+double BidirectionalAStar::getHeuristicCost(const unsigned int & a, const unsigned int & b)
+{
+  const double dx = static_cast<double>(a % _x_size) - static_cast<double>(b % _x_size);
+  const double dy = static_cast<double>(a / _x_size) - static_cast<double>(b / _x_size);
+  return std::sqrt(dx * dx + dy * dy);
+}
+
+double BidirectionalAStar::getCellFactor(const unsigned int & index)
+{
+  float & factor = _cell_factors[index];
+  if (std::isnan(factor)) {
+    if (_collision_checker->inCollision(index, _traverse_unknown)) {
+      factor = std::numeric_limits<float>::infinity();
+    } else {
+      factor = static_cast<float>(1.0 + _cost_penalty * _collision_checker->getCost() / 252.0);
+    }
+  }
+  return factor;
+}
+
+bool BidirectionalAStar::cleanQueueTop(Side & side)
+{
+  while (!side.queue.empty()) {
+    if (!(_closed[side.queue.top().second] & side.closed_flag)) {
+      return true;
+    }
+    side.queue.pop();
+  }
+  return false;
+}
+
+void BidirectionalAStar::expand(Side & side, const Side & other)
+{
+  const unsigned int index = side.queue.top().second;
+  side.queue.pop();
+  _closed[index] |= side.closed_flag;
+
+  const unsigned int x = index % _x_size;
+  const unsigned int y = index / _x_size;
+  for (unsigned int i = 0; i != 8; i++) {
+    const unsigned int nx = x + NEIGHBORS_DX[i];
+    const unsigned int ny = y + NEIGHBORS_DY[i];
+    if (nx >= _x_size || ny >= _y_size) {
+      continue;
+    }
+    const unsigned int neighbor = ny * _x_size + nx;
+    if (_closed[neighbor] & side.closed_flag) {
+      continue;
+    }
+
+    // Travel costs are those of moving into a cell, the forward side moving into the
+    // neighbor and the backward side from it. The start is traversable, as it is cleared.
+    double step;
+    if (side.forward) {
+      step = NEIGHBORS_LENGTH[i] * getCellFactor(neighbor);
+    } else if (neighbor != _start && getCellFactor(neighbor) == INF) {
+      continue;
+    } else {
+      step = NEIGHBORS_LENGTH[i] * getCellFactor(index);
+    }
+    if (step == INF) {
+      continue;
+    }
+
+    const double g = side.g[index] + step;
+    if (g >= side.g[neighbor]) {
+      continue;
+    }
+    side.g[neighbor] = g;
+    side.parents[neighbor] = index;
+    side.queue.emplace(g + getHeuristicCost(neighbor, side.target), neighbor);
+
+    // The frontiers meet where the other side reached too
+    if (other.g[neighbor] != INF && g + other.g[neighbor] < _best_cost) {
+      _best_cost = g + other.g[neighbor];
+      _meeting = neighbor;
+    }
+  }
+}
+
+BidirectionalAStar::Outcome BidirectionalAStar::createPath(
+  CoordinateVector & path, int & num_iterations, std::function<bool()> cancel_checker)
+{
+  if (!_collision_checker) {
+    throw std::runtime_error("Failed to compute path, no costmap given.");
+  }
+
+  steady_clock::time_point start_time = steady_clock::now();
+  resetSearch();
+
+  if (getCellFactor(_goal) == INF) {
+    return Outcome::GOAL_OCCUPIED;
+  }
+
+  if (_start == _goal) {
+    _best_cost = 0.0;
+  }
+
+  int forward_iterations = 0;
+  bool exhausted = false;
+  while (true) {
+    if (!cleanQueueTop(_forward) || !cleanQueueTop(_backward)) {
+      exhausted = true;
+      break;
+    }
+
+    // With consistent heuristics, no path through a cell not expanded by a side is cheaper
+    // than the best priority of its open set
+    if (_forward.queue.top().first >= _best_cost || _backward.queue.top().first >= _best_cost) {
+      break;
+    }
+
+    if (num_iterations >= _max_iterations) {
+      return Outcome::LIMIT_REACHED;
+    }
+
+    // Check for planning timeout and cancel only on every Nth iteration
+    if (num_iterations % _terminal_checking_interval == 0) {
+      if (cancel_checker()) {
+        throw nav2_core::PlannerCancelled("Planner was cancelled");
+      }
+      duration<double> planning_duration =
+        duration_cast<duration<double>>(steady_clock::now() - start_time);
+      if (static_cast<double>(planning_duration.count()) >= _max_planning_time) {
+        return Outcome::LIMIT_REACHED;
+      }
+    }
+
+    num_iterations++;
+
+    // Expanding the side with the smaller open set runs out the frontier of an enclosed
+    // start or goal first
+    if (_forward.queue.size() <= _backward.queue.size()) {
+      forward_iterations++;
+      expand(_forward, _backward);
+    } else {
+      expand(_backward, _forward);
+    }
+  }
+
+  if (_best_cost == INF) {
+    // The start is blocked if no neighbor of it is traversable
+    if (exhausted && forward_iterations == 1 && !cleanQueueTop(_forward)) {
+      return Outcome::START_BLOCKED;
+    }
+    return Outcome::NO_PATH;
+  }
+
+  // From the goal to the meeting cell along the backward parents, reversed, then to the
+  // start along the forward parents
+  path.clear();
+  for (unsigned int index = _meeting; ; index = _backward.parents[index]) {
+    path.push_back(Coordinates(index % _x_size, index / _x_size));
+    if (index == _goal) {
+      break;
+    }
+  }
+  std::reverse(path.begin(), path.end());
+  for (unsigned int index = _meeting; index != _start; ) {
+    index = _forward.parents[index];
+    path.push_back(Coordinates(index % _x_size, index / _x_size));
+  }
+
+  return Outcome::PATH_FOUND;
+}
+
+}  // namespace nav2_smac_planner
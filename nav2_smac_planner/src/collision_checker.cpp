@@ -12,7 +12,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License. Reserved.
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 #include "nav2_smac_planner/collision_checker.hpp"
+#include "nav2_costmap_2d/cost_values.hpp"
 
 namespace nav2_smac_planner
 {
@@ -54,6 +59,9 @@ void GridCollisionChecker::setFootprint(
   const double & possible_collision_cost)
 {
   possible_collision_cost_ = static_cast<float>(possible_collision_cost);
+  if (radius != footprint_is_radius_ || (!radius && footprint != unoriented_footprint_)) {
+    swept_footprints_.clear();
+  }
   footprint_is_radius_ = radius;
 
   // Use radius, no caching required
@@ -66,29 +74,11 @@ void GridCollisionChecker::setFootprint(
     return;
   }
 
-  oriented_footprints_.clear();
-  oriented_footprints_.reserve(angles_.size());
-  double sin_th, cos_th;
-  geometry_msgs::msg::Point new_pt;
-  const unsigned int footprint_size = footprint.size();
-
-  // Precompute the orientation bins for checking to use
-  for (unsigned int i = 0; i != angles_.size(); i++) {
-    sin_th = sin(angles_[i]);
-    cos_th = cos(angles_[i]);
-    nav2_costmap_2d::Footprint oriented_footprint;
-    oriented_footprint.reserve(footprint_size);
-
-    for (unsigned int j = 0; j < footprint_size; j++) {
-      new_pt.x = footprint[j].x * cos_th - footprint[j].y * sin_th;
-      new_pt.y = footprint[j].x * sin_th + footprint[j].y * cos_th;
-      oriented_footprint.push_back(new_pt);
-    }
-
-    oriented_footprints_.push_back(oriented_footprint);
-  }
-
+  // Precompute the outline cells of the footprint at each orientation bin for checking to use
   unoriented_footprint_ = footprint;
+  if (costmap_) {
+    updateFootprintKernels(unoriented_footprint_, angles_.size());
+  }
 }
 
 bool GridCollisionChecker::inCollision(
@@ -104,27 +94,68 @@ bool GridCollisionChecker::inCollision(
     return true;
   }
 
-  // Assumes setFootprint already set
-  double wx, wy;
-  costmap_->mapToWorld(static_cast<double>(x), static_cast<double>(y), wx, wy);
+  const unsigned int mx = static_cast<unsigned int>(x + 0.5f);
+  const unsigned int my = static_cast<unsigned int>(y + 0.5f);
+  return poseInCollision(
+    mx, my, static_cast<unsigned int>(angle_bin), costmap_->getCost(mx, my), traverse_unknown);
+}
+
+void GridCollisionChecker::inCollision(PoseBatch & batch, const bool & traverse_unknown)
+{
+  const size_t num_poses = batch.x.size();
+  batch.costs.resize(num_poses);
+  batch.in_collision.resize(num_poses);
+  batch.cells.resize(num_poses);
+
+  // Gather the center costs of all poses first, without branching on them so the loops
+  // can be vectorized. Poses outside of the map read the first cell instead.
+  const float size_x = static_cast<float>(costmap_->getSizeInCellsX());
+  const float size_y = static_cast<float>(costmap_->getSizeInCellsY());
+  const unsigned int width = costmap_->getSizeInCellsX();
+  for (size_t i = 0; i < num_poses; ++i) {
+    const float cx = batch.x[i] + 0.5f;
+    const float cy = batch.y[i] + 0.5f;
+    const bool inside = cx >= 0.5f && cy >= 0.5f && cx < size_x && cy < size_y;
+    batch.in_collision[i] = static_cast<unsigned char>(!inside);
+    batch.cells[i] = inside ?
+      static_cast<unsigned int>(cy) * width + static_cast<unsigned int>(cx) : 0u;
+  }
+  const unsigned char * data = costmap_->getCharMap();
+  for (size_t i = 0; i < num_poses; ++i) {
+    batch.costs[i] = static_cast<float>(data[batch.cells[i]]);
+  }
+
+  // Then check the footprints of the poses whose centers may be in collision
+  for (size_t i = 0; i < num_poses; ++i) {
+    if (batch.in_collision[i]) {
+      continue;
+    }
+    batch.in_collision[i] = static_cast<unsigned char>(poseInCollision(
+        batch.cells[i] % width, batch.cells[i] / width,
+        static_cast<unsigned int>(batch.angle_bin[i]), static_cast<unsigned char>(batch.costs[i]),
+        traverse_unknown));
+    batch.costs[i] = footprint_cost_;
+  }
+}
 
+bool GridCollisionChecker::poseInCollision(
+  const unsigned int & mx,
+  const unsigned int & my,
+  const unsigned int & angle_bin,
+  const unsigned char & center_cost,
+  const bool & traverse_unknown)
+{
+  footprint_cost_ = static_cast<float>(center_cost);
+
+  // Assumes setFootprint already set
   if (!footprint_is_radius_) {
     // if footprint, then we check for the footprint's points, but first see
     // if the robot is even potentially in an inscribed collision
-    footprint_cost_ = static_cast<float>(costmap_->getCost(
-        static_cast<unsigned int>(x + 0.5f), static_cast<unsigned int>(y + 0.5f)));
-
     if (footprint_cost_ < possible_collision_cost_) {
       if (possible_collision_cost_ > 0.0f) {
         return false;
       } else {
-        RCLCPP_ERROR_THROTTLE(
-          logger_, *clock_, 1000,
-          "Inflation layer either not found or inflation is not set sufficiently for "
-          "optimized non-circular collision checking capabilities. It is HIGHLY recommended to set"
-          " the inflation radius to be at MINIMUM half of the robot's largest cross-section. See "
-          "github.com/ros-planning/navigation2/tree/main/nav2_smac_planner#potential-fields"
-          " for full instructions. This will substantially impact run-time performance.");
+        reportInsufficientInflation();
       }
     }
 
@@ -139,19 +170,12 @@ bool GridCollisionChecker::inCollision(
     }
 
     // if possible inscribed, need to check actual footprint pose.
-    // Use precomputed oriented footprints are done on initialization,
-    // offset by translation value to collision check
-    geometry_msgs::msg::Point new_pt;
-    const nav2_costmap_2d::Footprint & oriented_footprint = oriented_footprints_[angle_bin];
-    nav2_costmap_2d::Footprint current_footprint;
-    current_footprint.reserve(oriented_footprint.size());
-    for (unsigned int i = 0; i < oriented_footprint.size(); ++i) {
-      new_pt.x = wx + oriented_footprint[i].x;
-      new_pt.y = wy + oriented_footprint[i].y;
-      current_footprint.push_back(new_pt);
+    // Use the outline cells of the orientation bin precomputed in setFootprint,
+    // laid about the pose's cell to collision check
+    if (!footprintKernelsMatchCostmap()) {
+      updateFootprintKernels(unoriented_footprint_, angles_.size());
     }
-
-    footprint_cost_ = static_cast<float>(footprintCost(current_footprint));
+    footprint_cost_ = static_cast<float>(footprintKernelCost(mx, my, kernels_[angle_bin]));
 
     if (footprint_cost_ == UNKNOWN && traverse_unknown) {
       return false;
@@ -161,9 +185,6 @@ bool GridCollisionChecker::inCollision(
     return footprint_cost_ >= OCCUPIED;
   } else {
     // if radius, then we can check the center of the cost assuming inflation is used
-    footprint_cost_ = static_cast<float>(costmap_->getCost(
-        static_cast<unsigned int>(x + 0.5f), static_cast<unsigned int>(y + 0.5f)));
-
     if (footprint_cost_ == UNKNOWN && traverse_unknown) {
       return false;
     }
@@ -186,6 +207,167 @@ bool GridCollisionChecker::inCollision(
   return footprint_cost_ >= INSCRIBED;
 }
 
+const GridCollisionChecker::SweptFootprint & GridCollisionChecker::getSweptFootprint(
+  const MotionPrimitive & primitive,
+  const bool & backwards,
+  const float & end_angle_bin,
+  const float & grid_resolution)
+{
+  // Offsets depend on the costmap's width, outlines on its resolution
+  if (swept_size_x_ != costmap_->getSizeInCellsX() ||
+    swept_resolution_ != costmap_->getResolution())
+  {
+    swept_footprints_.clear();
+    swept_size_x_ = costmap_->getSizeInCellsX();
+    swept_resolution_ = costmap_->getResolution();
+  }
+  if (!footprint_is_radius_ && !footprintKernelsMatchCostmap()) {
+    updateFootprintKernels(unoriented_footprint_, angles_.size());
+  }
+
+  const size_t key = 2 * static_cast<size_t>(primitive.trajectory_id) + (backwards ? 1 : 0);
+  if (key >= swept_footprints_.size()) {
+    swept_footprints_.resize(key + 1);
+  }
+  SweptFootprint & swept = swept_footprints_[key];
+  if (!swept.computed) {
+    computeSweptFootprint(primitive, backwards, end_angle_bin, grid_resolution, swept);
+  }
+  return swept;
+}
+
+void GridCollisionChecker::computeSweptFootprint(
+  const MotionPrimitive & primitive,
+  const bool & backwards,
+  const float & end_angle_bin,
+  const float & grid_resolution,
+  SweptFootprint & swept)
+{
+  const int size_x = static_cast<int>(costmap_->getSizeInCellsX());
+  const unsigned int num_bins = angles_.size();
+  const float bin_size = 2.0f * M_PI / num_bins;
+  swept = SweptFootprint();
+
+  // Cells are relative to the end pose's, exact when it is at the center of its cell
+  auto add_pose = [&](const float & x, const float & y, const float & angle_bin) {
+      const int dx = static_cast<int>(std::floor(x + 0.5f));
+      const int dy = static_cast<int>(std::floor(y + 0.5f));
+      const int center = dy * size_x + dx;
+      swept.centers.push_back(center);
+      swept.min_dx = std::min(swept.min_dx, dx);
+      swept.max_dx = std::max(swept.max_dx, dx);
+      swept.min_dy = std::min(swept.min_dy, dy);
+      swept.max_dy = std::max(swept.max_dy, dy);
+      if (footprint_is_radius_) {
+        return;
+      }
+
+      const FootprintKernel & kernel = kernels_[static_cast<unsigned int>(angle_bin) % num_bins];
+      for (const int & offset : kernel.offsets) {
+        swept.outline.push_back(center + offset);
+      }
+      swept.min_dx = std::min(swept.min_dx, dx + kernel.min_dx);
+      swept.max_dx = std::max(swept.max_dx, dx + kernel.max_dx);
+      swept.min_dy = std::min(swept.min_dy, dy + kernel.min_dy);
+      swept.max_dy = std::max(swept.max_dy, dy + kernel.max_dy);
+    };
+
+  add_pose(0.0f, 0.0f, end_angle_bin);
+
+  // Intermediate poses more than a cell apart
+  const float resolution_diag_sq = 2.0f * grid_resolution * grid_resolution;
+  const MotionPose & end_pose = primitive.poses.back();
+  MotionPose last_pose(1e9, 1e9, 1e9, TurnDirection::UNKNOWN);
+  for (const MotionPose & pose : primitive.poses) {
+    const float dist_x = pose._x - last_pose._x;
+    const float dist_y = pose._y - last_pose._y;
+    if (dist_x * dist_x + dist_y * dist_y <= resolution_diag_sq) {
+      continue;
+    }
+    last_pose = pose;
+    // If reversing, the robot is backing into the primitive
+    const float theta = backwards ? std::fmod(pose._theta + M_PI, 2.0 * M_PI) : pose._theta;
+    add_pose(
+      (pose._x - end_pose._x) / grid_resolution, (pose._y - end_pose._y) / grid_resolution,
+      theta / bin_size);
+  }
+
+  // Read each cell once, row by row
+  for (std::vector<int> * offsets : {&swept.centers, &swept.outline}) {
+    std::sort(offsets->begin(), offsets->end());
+    offsets->erase(std::unique(offsets->begin(), offsets->end()), offsets->end());
+  }
+  swept.computed = true;
+}
+
+bool GridCollisionChecker::inCollision(
+  const SweptFootprint & swept,
+  const unsigned int & mx,
+  const unsigned int & my,
+  const bool & traverse_unknown)
+{
+  const int cx = static_cast<int>(mx);
+  const int cy = static_cast<int>(my);
+  const int size_x = static_cast<int>(costmap_->getSizeInCellsX());
+  const int size_y = static_cast<int>(costmap_->getSizeInCellsY());
+  if (cx + swept.min_dx < 0 || cx + swept.max_dx >= size_x ||
+    cy + swept.min_dy < 0 || cy + swept.max_dy >= size_y)
+  {
+    footprint_cost_ = OCCUPIED;
+    return true;
+  }
+
+  // The cells are gathered without branching on their cost, so the loops can be vectorized
+  const unsigned char * center = costmap_->getCharMap() + cy * size_x + cx;
+  const unsigned char unknown = nav2_costmap_2d::NO_INFORMATION;
+  const unsigned char inscribed = nav2_costmap_2d::INSCRIBED_INFLATED_OBSTACLE;
+  const unsigned char lethal = nav2_costmap_2d::LETHAL_OBSTACLE;
+  const unsigned char skip_unknown = traverse_unknown ? 1 : 0;
+  unsigned char center_cost = 0;
+  unsigned char blocked = 0;
+  for (const int & offset : swept.centers) {
+    const unsigned char cost = center[offset];
+    center_cost = std::max(center_cost, cost);
+    blocked |= static_cast<unsigned char>(cost >= inscribed) &
+      static_cast<unsigned char>(!(skip_unknown & (cost == unknown)));
+  }
+  footprint_cost_ = static_cast<float>(center_cost);
+  if (blocked) {
+    return true;
+  }
+  if (footprint_is_radius_) {
+    return false;
+  }
+
+  // if none is possibly inscribed, no need to check the footprint's outline
+  if (footprint_cost_ < possible_collision_cost_) {
+    if (possible_collision_cost_ > 0.0f) {
+      return false;
+    }
+    reportInsufficientInflation();
+  }
+
+  unsigned char outline_cost = 0;
+  unsigned char outline_lethal = 0;
+  for (const int & offset : swept.outline) {
+    const unsigned char cost = center[offset];
+    outline_cost = std::max(outline_cost, cost);
+    outline_lethal |= static_cast<unsigned char>(cost == lethal);
+  }
+  if (outline_lethal) {
+    footprint_cost_ = OCCUPIED;
+    return true;
+  }
+  footprint_cost_ = std::max(footprint_cost_, static_cast<float>(outline_cost));
+
+  if (footprint_cost_ == UNKNOWN && traverse_unknown) {
+    return false;
+  }
+
+  // if occupied or unknown and not to traverse unknown space
+  return footprint_cost_ >= OCCUPIED;
+}
+
 float GridCollisionChecker::getCost()
 {
   // Assumes inCollision called prior
@@ -197,4 +379,15 @@ bool GridCollisionChecker::outsideRange(const unsigned int & max, const float &
   return value < 0.0f || value > max;
 }
 
+void GridCollisionChecker::reportInsufficientInflation()
+{
+  RCLCPP_ERROR_THROTTLE(
+    logger_, *clock_, 1000,
+    "Inflation layer either not found or inflation is not set sufficiently for "
+    "optimized non-circular collision checking capabilities. It is HIGHLY recommended to set"
+    " the inflation radius to be at MINIMUM half of the robot's largest cross-section. See "
+    "github.com/ros-planning/navigation2/tree/main/nav2_smac_planner#potential-fields"
+    " for full instructions. This will substantially impact run-time performance.");
+}
+
 }  // namespace nav2_smac_planner
@@ -0,0 +1,368 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License. Reserved.
+
+#include "nav2_smac_planner/d_star_lite.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "nav2_core/planner_exceptions.hpp"
+
+namespace nav2_smac_planner
+{
+
+using namespace std::chrono;  // NOLINT
+
+namespace
+{
+
+constexpr double INF = std::numeric_limits<double>::infinity();
+
+// Keys use a heuristic slightly under the distance, so that the cells on the best path
+// from the start get keys strictly under that of the start despite rounding
+constexpr double HEURISTIC_SCALE = 1.0 - 1e-6;
+
+// Moore neighborhood, in the order of Node2D
+constexpr int NEIGHBORS_DX[8] = {-1, 1, 0, 0, -1, 1, -1, 1};
+constexpr int NEIGHBORS_DY[8] = {0, 0, -1, 1, -1, -1, 1, 1};
+constexpr double NEIGHBORS_LENGTH[8] = {1.0, 1.0, 1.0, 1.0, M_SQRT2, M_SQRT2, M_SQRT2, M_SQRT2};
+
+}  // namespace
+
+DStarLite::DStarLite()
+: _collision_checker(nullptr),
+  _costmap(nullptr),
+  _traverse_unknown(true),
+  _max_iterations(std::numeric_limits<int>::max()),
+  _terminal_checking_interval(5000),
+  _max_planning_time(0.0),
+  _cost_penalty(2.0),
+  _x_size(0),
+  _y_size(0),
+  _search_valid(false),
+  _start(0),
+  _goal(0),
+  _last_start(0),
+  _key_modifier(0.0)
+{
+}
+
+void DStarLite::initialize(
+  const bool & allow_unknown,
+  const int & max_iterations,
+  const int & terminal_checking_interval,
+  const double & max_planning_time,
+  const float & cost_penalty,
+  const unsigned int & open_list_arity)
+{
+  _traverse_unknown = allow_unknown;
+  _max_iterations = max_iterations;
+  _terminal_checking_interval = std::max(terminal_checking_interval, 1);
+  _max_planning_time = max_planning_time;
+  _cost_penalty = cost_penalty;
+  _queue.setArity(open_list_arity);
+  clear();
+}
+
+void DStarLite::setCollisionChecker(GridCollisionChecker * collision_checker)
+{
+  _collision_checker = collision_checker;
+  _costmap = collision_checker->getCostmap();
+  if (_costmap->getSizeInCellsX() != _x_size || _costmap->getSizeInCellsY() != _y_size) {
+    _x_size = _costmap->getSizeInCellsX();
+    _y_size = _costmap->getSizeInCellsY();
+    clear();
+  }
+}
+
+void DStarLite::setGoal(const unsigned int & mx, const unsigned int & my)
+{
+  const unsigned int goal = my * _x_size + mx;
+  if (goal != _goal) {
+    _goal = goal;
+    clear();
+  }
+}
+
+void DStarLite::setStart(const unsigned int & mx, const unsigned int & my)
+{
+  _start = my * _x_size + mx;
+}
+
+void DStarLite::clear()
+{
+  _search_valid = false;
+}
+
+int & DStarLite::getMaxIterations()
+{
+  return _max_iterations;
+}
+
+void DStarLite::resetSearch()
+{
+  const size_t size = static_cast<size_t>(_x_size) * static_cast<size_t>(_y_size);
+  _g.assign(size, INF);
+  _rhs.assign(size, INF);
+  _cell_factors.assign(size, std::numeric_limits<float>::quiet_NaN());
+  _queue.clear();
+
+  _key_modifier = 0.0;
+  _last_start = _start;
+  _rhs[_goal] = 0.0;
+  _queue.emplace(calculateKey(_goal), _goal);
+  _search_valid = true;
+}
+
+DStarLite::Key DStarLite::calculateKey(const unsigned int & index)
+{
+  const double cost = std::min(_g[index], _rhs[index]);
+  return Key(cost + getHeuristicCost(index, _start) + _key_modifier, cost);
+}
+
+double DStarLite::getHeuristicCost(const unsigned int & a, const unsigned int & b)
+{
+  const double dx = static_cast<double>(a % _x_size) - static_cast<double>(b % _x_size);
+  const double dy = static_cast<double>(a / _x_size) - static_cast<double>(b / _x_size);
+  return HEURISTIC_SCALE * std::sqrt(dx * dx + dy * dy);
+}
+
+double DStarLite::evaluateCellFactor(const unsigned int & index)
+{
+  if (_collision_checker->inCollision(index, _traverse_unknown)) {
+    return INF;
+  }
+  return 1.0 + _cost_penalty * _collision_checker->getCost() / 252.0;
+}
+
+double DStarLite::getCellFactor(const unsigned int & index)
+{
+  float & factor = _cell_factors[index];
+  if (std::isnan(factor)) {
+    factor = static_cast<float>(evaluateCellFactor(index));
+  }
+  return factor;
+}
+
+void DStarLite::updateVertex(const unsigned int & index)
+{
+  if (index == _goal) {
+    return;
+  }
+
+  // Lookahead cost is the best cost to the goal through a neighbor
+  const unsigned int x = index % _x_size;
+  const unsigned int y = index / _x_size;
+  double rhs = INF;
+  for (unsigned int i = 0; i != 8; i++) {
+    const unsigned int nx = x + NEIGHBORS_DX[i];
+    const unsigned int ny = y + NEIGHBORS_DY[i];
+    if (nx >= _x_size || ny >= _y_size) {
+      continue;
+    }
+    const unsigned int neighbor = ny * _x_size + nx;
+    if (_g[neighbor] == INF) {
+      continue;
+    }
+    rhs = std::min(rhs, _g[neighbor] + NEIGHBORS_LENGTH[i] * getCellFactor(neighbor));
+  }
+
+  // Cells are queued whenever they become inconsistent or their key changes,
+  // entries left behind are dropped when they reach the top
+  const bool was_consistent = _g[index] == _rhs[index];
+  if (rhs == _rhs[index] && !was_consistent) {
+    return;
+  }
+  _rhs[index] = rhs;
+  if (_g[index] != rhs) {
+    _queue.emplace(calculateKey(index), index);
+  }
+}
+
+void DStarLite::updateNeighbors(const unsigned int & index)
+{
+  const unsigned int x = index % _x_size;
+  const unsigned int y = index / _x_size;
+  for (unsigned int i = 0; i != 8; i++) {
+    const unsigned int nx = x + NEIGHBORS_DX[i];
+    const unsigned int ny = y + NEIGHBORS_DY[i];
+    if (nx < _x_size && ny < _y_size) {
+      updateVertex(ny * _x_size + nx);
+    }
+  }
+}
+
+bool DStarLite::cleanQueueTop()
+{
+  while (!_queue.empty()) {
+    // A cell has an entry at or under its current key for as long as it is inconsistent
+    const unsigned int & index = _queue.top().second;
+    if (_g[index] != _rhs[index]) {
+      return true;
+    }
+    _queue.pop();
+  }
+  return false;
+}
+
+void DStarLite::updateCells(
+  const unsigned int & x0, const unsigned int & xn,
+  const unsigned int & y0, const unsigned int & yn)
+{
+  if (!_search_valid) {
+    return;
+  }
+
+  const unsigned int x_end = std::min(xn, _x_size);
+  const unsigned int y_end = std::min(yn, _y_size);
+  for (unsigned int y = y0; y < y_end; y++) {
+    for (unsigned int x = x0; x < x_end; x++) {
+      const unsigned int index = y * _x_size + x;
+      float & factor = _cell_factors[index];
+      // Cells never evaluated are not part of the search yet
+      if (std::isnan(factor)) {
+        continue;
+      }
+      const float new_factor = static_cast<float>(evaluateCellFactor(index));
+      if (new_factor == factor) {
+        continue;
+      }
+      // The cost of a cell is that of moving into it, which changes for its neighbors
+      factor = new_factor;
+      updateNeighbors(index);
+    }
+  }
+}
+
+bool DStarLite::computeShortestPath(int & num_iterations, std::function<bool()> & cancel_checker)
+{
+  steady_clock::time_point start_time = steady_clock::now();
+
+  while (cleanQueueTop()) {
+    const QueueElement top = _queue.top();
+    if (!(top.first < calculateKey(_start)) && _rhs[_start] <= _g[_start]) {
+      return true;
+    }
+
+    if (num_iterations >= _max_iterations) {
+      return false;
+    }
+
+    // Check for planning timeout and cancel only on every Nth iteration
+    if (num_iterations % _terminal_checking_interval == 0) {
+      if (cancel_checker()) {
+        throw nav2_core::PlannerCancelled("Planner was cancelled");
+      }
+      duration<double> planning_duration =
+        duration_cast<duration<double>>(steady_clock::now() - start_time);
+      if (static_cast<double>(planning_duration.count()) >= _max_planning_time) {
+        return false;
+      }
+    }
+
+    num_iterations++;
+    _queue.pop();
+
+    const unsigned int & index = top.second;
+    const Key key = calculateKey(index);
+    if (top.first < key) {
+      // Queued before the start moved
+      _queue.emplace(key, index);
+    } else if (_g[index] > _rhs[index]) {
+      _g[index] = _rhs[index];
+      if (getCellFactor(index) != INF) {
+        updateNeighbors(index);
+      }
+    } else {
+      _g[index] = INF;
+      updateVertex(index);
+      if (_g[index] != _rhs[index]) {
+        _queue.emplace(calculateKey(index), index);
+      }
+      if (getCellFactor(index) != INF) {
+        updateNeighbors(index);
+      }
+    }
+  }
+
+  return true;
+}
+
+bool DStarLite::createPath(
+  CoordinateVector & path, int & num_iterations, std::function<bool()> cancel_checker)
+{
+  if (!_collision_checker) {
+    throw std::runtime_error("Failed to compute path, no costmap given.");
+  }
+
+  if (!_search_valid) {
+    resetSearch();
+  } else if (_start != _last_start) {
+    // Keys of the queued cells are kept as lower bounds relative to the new start
+    _key_modifier += getHeuristicCost(_start, _last_start);
+    _last_start = _start;
+  }
+
+  // The search may stop with the start overconsistent, its lookahead cost is then exact
+  if (!computeShortestPath(num_iterations, cancel_checker) || _rhs[_start] == INF) {
+    return false;
+  }
+
+  // Follow the best neighbors from the start, whose costs to the goal only decrease
+  path.clear();
+  unsigned int index = _start;
+  const size_t max_length = _g.size();
+  while (index != _goal) {
+    path.push_back(Coordinates(index % _x_size, index / _x_size));
+    if (path.size() > max_length) {
+      return false;
+    }
+
+    const unsigned int x = index % _x_size;
+    const unsigned int y = index / _x_size;
+    double best_cost = INF;
+    unsigned int best = index;
+    for (unsigned int i = 0; i != 8; i++) {
+      const unsigned int nx = x + NEIGHBORS_DX[i];
+      const unsigned int ny = y + NEIGHBORS_DY[i];
+      if (nx >= _x_size || ny >= _y_size) {
+        continue;
+      }
+      const unsigned int neighbor = ny * _x_size + nx;
+      if (_g[neighbor] == INF) {
+        continue;
+      }
+      const double cost = _g[neighbor] + NEIGHBORS_LENGTH[i] * getCellFactor(neighbor);
+      if (cost < best_cost) {
+        best_cost = cost;
+        best = neighbor;
+      }
+    }
+
+    if (best_cost == INF) {
+      return false;
+    }
+    index = best;
+  }
+  path.push_back(Coordinates(_goal % _x_size, _goal / _x_size));
+
+  // Paths are given from the goal to the start, as backtraced by A*
+  std::reverse(path.begin(), path.end());
+  return true;
+}
+
+}  // namespace nav2_smac_planner
@@ -0,0 +1,141 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "nav2_smac_planner/expansions_publisher.hpp"
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace nav2_smac_planner
+{
+
+namespace
+{
+
+// Layout of the points, 16 bytes rather than the 56 of a Pose
+struct ExpansionPoint
+{
+  float x;
+  float y;
+  float z;
+  float yaw;
+};
+
+}  // namespace
+
+ExpansionsPublisher::ExpansionsPublisher(
+  const rclcpp_lifecycle::LifecycleNode::SharedPtr & node, const std::string & global_frame,
+  size_t capacity, unsigned int stride)
+: global_frame_(global_frame),
+  log_(capacity, stride),
+  pending_log_(capacity, stride)
+{
+  publisher_ = node->create_publisher<sensor_msgs::msg::PointCloud2>("expansions", 1);
+  thread_ = std::make_unique<std::thread>(&ExpansionsPublisher::publishLoop, this);
+}
+
+ExpansionsPublisher::~ExpansionsPublisher()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  cv_.notify_one();
+  thread_->join();
+}
+
+void ExpansionsPublisher::on_activate()
+{
+  publisher_->on_activate();
+}
+
+void ExpansionsPublisher::on_deactivate()
+{
+  publisher_->on_deactivate();
+}
+
+ExpansionsLog * ExpansionsPublisher::startLog()
+{
+  log_.clear();
+  return &log_;
+}
+
+void ExpansionsPublisher::publish(const rclcpp::Time & stamp)
+{
+  if (publisher_->get_subscription_count() == 0) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (publish_requested_) {
+      return;
+    }
+    log_.swap(pending_log_);
+    pending_stamp_ = stamp;
+    publish_requested_ = true;
+  }
+  cv_.notify_one();
+}
+
+void ExpansionsPublisher::publishLoop()
+{
+  while (true) {
+    rclcpp::Time stamp;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]() {return publish_requested_ || shutdown_;});
+      if (shutdown_) {
+        return;
+      }
+      stamp = pending_stamp_;
+    }
+
+    // The log is left alone by the planning thread until publish_requested_ is reset
+    auto msg = std::make_unique<sensor_msgs::msg::PointCloud2>();
+    msg->header.frame_id = global_frame_;
+    msg->header.stamp = stamp;
+    msg->height = 1;
+    msg->width = pending_log_.size();
+    msg->fields.resize(4);
+    const char * names[] = {"x", "y", "z", "yaw"};
+    for (size_t i = 0; i != msg->fields.size(); i++) {
+      msg->fields[i].name = names[i];
+      msg->fields[i].offset = i * sizeof(float);
+      msg->fields[i].datatype = sensor_msgs::msg::PointField::FLOAT32;
+      msg->fields[i].count = 1;
+    }
+    msg->is_bigendian = false;
+    msg->is_dense = true;
+    msg->point_step = sizeof(ExpansionPoint);
+    msg->row_step = msg->point_step * msg->width;
+    msg->data.resize(msg->row_step);
+    for (size_t i = 0; i != pending_log_.size(); i++) {
+      const ExpansionsLog::Expansion & expansion = pending_log_[i];
+      const ExpansionPoint point{expansion.x, expansion.y, 0.0f, expansion.theta};
+      std::memcpy(&msg->data[i * sizeof(ExpansionPoint)], &point, sizeof(ExpansionPoint));
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      publish_requested_ = false;
+    }
+    publisher_->publish(std::move(msg));
+  }
+}
+
+}  // namespace nav2_smac_planner
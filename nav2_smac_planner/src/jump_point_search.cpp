@@ -0,0 +1,515 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "nav2_smac_planner/jump_point_search.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "nav2_core/planner_exceptions.hpp"
+
+namespace nav2_smac_planner
+{
+
+using namespace std::chrono;  // NOLINT
+
+namespace
+{
+
+constexpr double INF = std::numeric_limits<double>::infinity();
+constexpr float FACTOR_INF = std::numeric_limits<float>::infinity();
+constexpr uint8_t NO_DIRECTION = 8;
+constexpr unsigned int ALL_DIRECTIONS = 0xFF;
+
+// Moore neighborhood, in the order of Node2D: straight directions first, then diagonals
+constexpr int NEIGHBORS_DX[8] = {-1, 1, 0, 0, -1, 1, -1, 1};
+constexpr int NEIGHBORS_DY[8] = {0, 0, -1, 1, -1, -1, 1, 1};
+
+// Index of the direction of a move
+inline unsigned int directionIndex(const int & dx, const int & dy)
+{
+  if (dy == 0) {
+    return dx < 0 ? 0 : 1;
+  }
+  if (dx == 0) {
+    return dy < 0 ? 2 : 3;
+  }
+  return 4 + (dx > 0 ? 1 : 0) + (dy > 0 ? 2 : 0);
+}
+
+}  // namespace
+
+JumpPointSearch::JumpPointSearch()
+: _collision_checker(nullptr),
+  _traverse_unknown(true),
+  _max_iterations(std::numeric_limits<int>::max()),
+  _terminal_checking_interval(5000),
+  _max_planning_time(0.0),
+  _cost_penalty(2.0),
+  _x_size(0),
+  _y_size(0),
+  _start(0),
+  _goal(0),
+  _jumps_valid(false)
+{
+}
+
+void JumpPointSearch::initialize(
+  const bool & allow_unknown,
+  const int & max_iterations,
+  const int & terminal_checking_interval,
+  const double & max_planning_time,
+  const float & cost_penalty,
+  const unsigned int & open_list_arity)
+{
+  _traverse_unknown = allow_unknown;
+  _max_iterations = max_iterations;
+  _terminal_checking_interval = std::max(terminal_checking_interval, 1);
+  _max_planning_time = max_planning_time;
+  _cost_penalty = cost_penalty;
+  _queue.setArity(open_list_arity);
+  clear();
+}
+
+void JumpPointSearch::setCollisionChecker(GridCollisionChecker * collision_checker)
+{
+  _collision_checker = collision_checker;
+  nav2_costmap_2d::Costmap2D * costmap = collision_checker->getCostmap();
+  if (costmap->getSizeInCellsX() != _x_size || costmap->getSizeInCellsY() != _y_size) {
+    _x_size = costmap->getSizeInCellsX();
+    _y_size = costmap->getSizeInCellsY();
+    clear();
+  }
+}
+
+void JumpPointSearch::setGoal(const unsigned int & mx, const unsigned int & my)
+{
+  _goal = my * _x_size + mx;
+}
+
+void JumpPointSearch::setStart(const unsigned int & mx, const unsigned int & my)
+{
+  _start = my * _x_size + mx;
+}
+
+void JumpPointSearch::clear()
+{
+  _jumps_valid = false;
+}
+
+int & JumpPointSearch::getMaxIterations()
+{
+  return _max_iterations;
+}
+
+double JumpPointSearch::getHeuristicCost(const unsigned int & a, const unsigned int & b)
+{
+  const double dx = static_cast<double>(a % _x_size) - static_cast<double>(b % _x_size);
+  const double dy = static_cast<double>(a / _x_size) - static_cast<double>(b / _x_size);
+  return std::sqrt(dx * dx + dy * dy);
+}
+
+float JumpPointSearch::evaluateCellFactor(const unsigned int & index)
+{
+  if (_collision_checker->inCollision(index, _traverse_unknown)) {
+    return FACTOR_INF;
+  }
+  return static_cast<float>(1.0 + _cost_penalty * _collision_checker->getCost() / 252.0);
+}
+
+float JumpPointSearch::getCellFactor(const int & x, const int & y)
+{
+  if (x < 0 || y < 0 || x >= static_cast<int>(_x_size) || y >= static_cast<int>(_y_size)) {
+    return FACTOR_INF;
+  }
+  return _cell_factors[y * _x_size + x];
+}
+
+bool JumpPointSearch::isUniform(const int & x, const int & y)
+{
+  const float factor = getCellFactor(x, y);
+  for (unsigned int i = 0; i != 8; i++) {
+    const float neighbor_factor = getCellFactor(x + NEIGHBORS_DX[i], y + NEIGHBORS_DY[i]);
+    if (neighbor_factor != FACTOR_INF && neighbor_factor != factor) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool JumpPointSearch::hasForcedNeighbors(const int & x, const int & y, const unsigned int & dir)
+{
+  const int dx = NEIGHBORS_DX[dir];
+  const int dy = NEIGHBORS_DY[dir];
+  if (dy == 0) {
+    return (getCellFactor(x, y - 1) == FACTOR_INF && getCellFactor(x + dx, y - 1) != FACTOR_INF) ||
+           (getCellFactor(x, y + 1) == FACTOR_INF && getCellFactor(x + dx, y + 1) != FACTOR_INF);
+  }
+  if (dx == 0) {
+    return (getCellFactor(x - 1, y) == FACTOR_INF && getCellFactor(x - 1, y + dy) != FACTOR_INF) ||
+           (getCellFactor(x + 1, y) == FACTOR_INF && getCellFactor(x + 1, y + dy) != FACTOR_INF);
+  }
+  return (getCellFactor(x - dx, y) == FACTOR_INF && getCellFactor(x - dx, y + dy) != FACTOR_INF) ||
+         (getCellFactor(x, y - dy) == FACTOR_INF && getCellFactor(x + dx, y - dy) != FACTOR_INF);
+}
+
+void JumpPointSearch::computeRowJumps(const unsigned int & y)
+{
+  // The distance from a cell is that of the next cell plus one, unless the next cell is
+  // not traversable or is a jump point: not uniform or with forced neighbors
+  const int row = static_cast<int>(y);
+  std::vector<int> & left = _jump_distances[0];
+  std::vector<int> & right = _jump_distances[1];
+  const unsigned int begin = y * _x_size;
+  const unsigned int end = begin + _x_size - 1;
+  left[begin] = 0;
+  for (unsigned int index = begin + 1; index <= end; index++) {
+    const unsigned int next = index - 1;
+    if (_cell_factors[next] == FACTOR_INF) {
+      left[index] = 0;
+    } else if (!_uniform[next] || hasForcedNeighbors(next - begin, row, 0)) {
+      left[index] = 1;
+    } else {
+      left[index] = left[next] > 0 ? left[next] + 1 : left[next] - 1;
+    }
+  }
+  right[end] = 0;
+  for (unsigned int index = end; index-- > begin; ) {
+    const unsigned int next = index + 1;
+    if (_cell_factors[next] == FACTOR_INF) {
+      right[index] = 0;
+    } else if (!_uniform[next] || hasForcedNeighbors(next - begin, row, 1)) {
+      right[index] = 1;
+    } else {
+      right[index] = right[next] > 0 ? right[next] + 1 : right[next] - 1;
+    }
+  }
+}
+
+void JumpPointSearch::computeColumnJumps(const unsigned int & x)
+{
+  const int column = static_cast<int>(x);
+  std::vector<int> & up = _jump_distances[2];
+  std::vector<int> & down = _jump_distances[3];
+  up[x] = 0;
+  for (unsigned int y = 1; y < _y_size; y++) {
+    const unsigned int index = y * _x_size + x;
+    const unsigned int next = index - _x_size;
+    if (_cell_factors[next] == FACTOR_INF) {
+      up[index] = 0;
+    } else if (!_uniform[next] || hasForcedNeighbors(column, y - 1, 2)) {
+      up[index] = 1;
+    } else {
+      up[index] = up[next] > 0 ? up[next] + 1 : up[next] - 1;
+    }
+  }
+  down[(_y_size - 1) * _x_size + x] = 0;
+  for (unsigned int y = _y_size - 1; y-- > 0; ) {
+    const unsigned int index = y * _x_size + x;
+    const unsigned int next = index + _x_size;
+    if (_cell_factors[next] == FACTOR_INF) {
+      down[index] = 0;
+    } else if (!_uniform[next] || hasForcedNeighbors(column, y + 1, 3)) {
+      down[index] = 1;
+    } else {
+      down[index] = down[next] > 0 ? down[next] + 1 : down[next] - 1;
+    }
+  }
+}
+
+void JumpPointSearch::computeJumps()
+{
+  const size_t size = static_cast<size_t>(_x_size) * static_cast<size_t>(_y_size);
+  _cell_factors.resize(size);
+  _uniform.resize(size);
+  for (std::vector<int> & distances : _jump_distances) {
+    distances.resize(size);
+  }
+
+  for (unsigned int index = 0; index != size; index++) {
+    _cell_factors[index] = evaluateCellFactor(index);
+  }
+  for (unsigned int y = 0; y != _y_size; y++) {
+    for (unsigned int x = 0; x != _x_size; x++) {
+      _uniform[y * _x_size + x] = isUniform(x, y);
+    }
+  }
+  for (unsigned int y = 0; y != _y_size; y++) {
+    computeRowJumps(y);
+  }
+  for (unsigned int x = 0; x != _x_size; x++) {
+    computeColumnJumps(x);
+  }
+  _jumps_valid = true;
+}
+
+void JumpPointSearch::updateCells(
+  const unsigned int & x0, const unsigned int & xn,
+  const unsigned int & y0, const unsigned int & yn)
+{
+  if (!_jumps_valid) {
+    return;
+  }
+
+  // Bounds of the cells whose cost changed
+  unsigned int min_x = _x_size, max_x = 0, min_y = _y_size, max_y = 0;
+  const unsigned int x_end = std::min(xn, _x_size);
+  const unsigned int y_end = std::min(yn, _y_size);
+  for (unsigned int y = y0; y < y_end; y++) {
+    for (unsigned int x = x0; x < x_end; x++) {
+      const unsigned int index = y * _x_size + x;
+      const float factor = evaluateCellFactor(index);
+      if (factor == _cell_factors[index]) {
+        continue;
+      }
+      _cell_factors[index] = factor;
+      min_x = std::min(min_x, x);
+      max_x = std::max(max_x, x);
+      min_y = std::min(min_y, y);
+      max_y = std::max(max_y, y);
+    }
+  }
+  if (min_x > max_x) {
+    return;
+  }
+
+  // Whether a cell is a jump point depends on its neighbors, and the distances of
+  // the rows and columns through these cells on them
+  min_x = min_x > 0 ? min_x - 1 : 0;
+  min_y = min_y > 0 ? min_y - 1 : 0;
+  max_x = std::min(max_x + 1, _x_size - 1);
+  max_y = std::min(max_y + 1, _y_size - 1);
+  for (unsigned int y = min_y; y <= max_y; y++) {
+    for (unsigned int x = min_x; x <= max_x; x++) {
+      _uniform[y * _x_size + x] = isUniform(x, y);
+    }
+  }
+  for (unsigned int y = min_y; y <= max_y; y++) {
+    computeRowJumps(y);
+  }
+  for (unsigned int x = min_x; x <= max_x; x++) {
+    computeColumnJumps(x);
+  }
+}
+
+bool JumpPointSearch::jumpStraight(
+  const unsigned int & index, const unsigned int & dir,
+  unsigned int & jump_point, unsigned int & steps)
+{
+  const int distance = _jump_distances[dir][index];
+  const int reach = std::abs(distance);
+  const int dx = NEIGHBORS_DX[dir];
+  const int dy = NEIGHBORS_DY[dir];
+
+  // The goal is a jump point, if the jump passes it
+  const int goal_dx = static_cast<int>(_goal % _x_size) - static_cast<int>(index % _x_size);
+  const int goal_dy = static_cast<int>(_goal / _x_size) - static_cast<int>(index / _x_size);
+  const int goal_steps = dx != 0 ? goal_dx * dx : goal_dy * dy;
+  if ((dx != 0 ? goal_dy : goal_dx) == 0 && goal_steps > 0 && goal_steps <= reach) {
+    jump_point = _goal;
+    steps = goal_steps;
+    return true;
+  }
+
+  if (distance <= 0) {
+    return false;
+  }
+  jump_point = index + distance * (dy * static_cast<int>(_x_size) + dx);
+  steps = distance;
+  return true;
+}
+
+bool JumpPointSearch::jump(
+  const unsigned int & index, const unsigned int & dir,
+  unsigned int & jump_point, double & cost)
+{
+  int x = index % _x_size;
+  int y = index / _x_size;
+  const int dx = NEIGHBORS_DX[dir];
+  const int dy = NEIGHBORS_DY[dir];
+
+  // The cells travelled by a straight jump all have the cost of the first one
+  if (dir < 4) {
+    unsigned int steps;
+    if (!jumpStraight(index, dir, jump_point, steps)) {
+      return false;
+    }
+    cost = steps * getCellFactor(x + dx, y + dy);
+    return true;
+  }
+
+  // A diagonal jump stops where a straight jump from its cells reaches a jump point
+  const unsigned int x_dir = directionIndex(dx, 0);
+  const unsigned int y_dir = directionIndex(0, dy);
+  unsigned int straight_jump_point, steps;
+  cost = 0.0;
+  while (true) {
+    x += dx;
+    y += dy;
+    const float factor = getCellFactor(x, y);
+    if (factor == FACTOR_INF) {
+      return false;
+    }
+    cost += M_SQRT2 * factor;
+    jump_point = y * _x_size + x;
+    if (jump_point == _goal || !_uniform[jump_point] || hasForcedNeighbors(x, y, dir) ||
+      jumpStraight(jump_point, x_dir, straight_jump_point, steps) ||
+      jumpStraight(jump_point, y_dir, straight_jump_point, steps))
+    {
+      return true;
+    }
+  }
+}
+
+unsigned int JumpPointSearch::getJumpDirections(const unsigned int & index)
+{
+  const uint8_t dir = _directions[index];
+  if (dir == NO_DIRECTION || !_uniform[index]) {
+    return ALL_DIRECTIONS;
+  }
+
+  // Within a uniform region, only the natural neighbors of the direction the jump point
+  // was reached in and its forced neighbors are jumped to
+  const int x = index % _x_size;
+  const int y = index / _x_size;
+  const int dx = NEIGHBORS_DX[dir];
+  const int dy = NEIGHBORS_DY[dir];
+  unsigned int directions = 1u << dir;
+  if (dy == 0) {
+    for (const int side : {-1, 1}) {
+      if (getCellFactor(x, y + side) == FACTOR_INF) {
+        directions |= 1u << directionIndex(dx, side);
+      }
+    }
+  } else if (dx == 0) {
+    for (const int side : {-1, 1}) {
+      if (getCellFactor(x + side, y) == FACTOR_INF) {
+        directions |= 1u << directionIndex(side, dy);
+      }
+    }
+  } else {
+    directions |= 1u << directionIndex(dx, 0);
+    directions |= 1u << directionIndex(0, dy);
+    if (getCellFactor(x - dx, y) == FACTOR_INF) {
+      directions |= 1u << directionIndex(-dx, dy);
+    }
+    if (getCellFactor(x, y - dy) == FACTOR_INF) {
+      directions |= 1u << directionIndex(dx, -dy);
+    }
+  }
+  return directions;
+}
+
+bool JumpPointSearch::createPath(
+  CoordinateVector & path, int & num_iterations, std::function<bool()> cancel_checker)
+{
+  if (!_collision_checker) {
+    throw std::runtime_error("Failed to compute path, no costmap given.");
+  }
+
+  steady_clock::time_point start_time = steady_clock::now();
+  if (!_jumps_valid) {
+    computeJumps();
+  }
+  if (_cell_factors[_goal] == FACTOR_INF) {
+    return false;
+  }
+
+  const size_t size = static_cast<size_t>(_x_size) * static_cast<size_t>(_y_size);
+  _g.assign(size, INF);
+  _parents.resize(size);
+  _directions.assign(size, NO_DIRECTION);
+  _closed.assign(size, 0);
+  _queue.clear();
+  _g[_start] = 0.0;
+  _parents[_start] = _start;
+  _queue.emplace(getHeuristicCost(_start, _goal), _start);
+
+  unsigned int jump_point;
+  double cost;
+  while (!_queue.empty()) {
+    const unsigned int index = _queue.top().second;
+    if (_closed[index]) {
+      _queue.pop();
+      continue;
+    }
+
+    if (num_iterations >= _max_iterations) {
+      return false;
+    }
+
+    // Check for planning timeout and cancel only on every Nth iteration
+    if (num_iterations % _terminal_checking_interval == 0) {
+      if (cancel_checker()) {
+        throw nav2_core::PlannerCancelled("Planner was cancelled");
+      }
+      duration<double> planning_duration =
+        duration_cast<duration<double>>(steady_clock::now() - start_time);
+      if (static_cast<double>(planning_duration.count()) >= _max_planning_time) {
+        return false;
+      }
+    }
+
+    num_iterations++;
+    _queue.pop();
+    _closed[index] = 1;
+
+    if (index == _goal) {
+      // Jump points are joined by straight or diagonal runs of cells
+      path.clear();
+      for (unsigned int cell = _goal; ; ) {
+        path.push_back(Coordinates(cell % _x_size, cell / _x_size));
+        if (cell == _start) {
+          break;
+        }
+        const unsigned int parent = _parents[cell];
+        const int step_x = static_cast<int>(parent % _x_size) - static_cast<int>(cell % _x_size);
+        const int step_y = static_cast<int>(parent / _x_size) - static_cast<int>(cell / _x_size);
+        const int step = (step_x > 0) - (step_x < 0) +
+          ((step_y > 0) - (step_y < 0)) * static_cast<int>(_x_size);
+        for (cell += step; cell != parent; cell += step) {
+          path.push_back(Coordinates(cell % _x_size, cell / _x_size));
+        }
+      }
+      return true;
+    }
+
+    const unsigned int directions = getJumpDirections(index);
+    for (unsigned int dir = 0; dir != 8; dir++) {
+      if (!(directions & (1u << dir)) || !jump(index, dir, jump_point, cost) ||
+        _closed[jump_point])
+      {
+        continue;
+      }
+      const double g = _g[index] + cost;
+      if (g >= _g[jump_point]) {
+        continue;
+      }
+      _g[jump_point] = g;
+      _parents[jump_point] = index;
+      _directions[jump_point] = static_cast<uint8_t>(dir);
+      _queue.emplace(g + getHeuristicCost(jump_point, _goal), jump_point);
+    }
+  }
+
+  return false;
+}
+
+}  // namespace nav2_smac_planner
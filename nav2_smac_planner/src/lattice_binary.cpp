@@ -0,0 +1,189 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License. Reserved.
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "nav2_smac_planner/lattice_binary.hpp"
+
+namespace nav2_smac_planner
+{
+
+namespace
+{
+
+// Layout documented in lattice_primitives/binary_format.py
+const char MAGIC[8] = {'N', '2', 'S', 'M', 'L', 'A', 'T', '1'};
+
+struct BinaryHeader
+{
+  char magic[8];
+  float turning_radius;
+  float grid_resolution;
+  uint32_t num_of_headings;
+  uint32_t number_of_trajectories;
+  uint32_t motion_model_length;
+  uint32_t num_poses;
+};
+
+struct BinaryPrimitive
+{
+  uint32_t trajectory_id;
+  uint32_t start_angle_index;
+  uint32_t end_angle_index;
+  float trajectory_radius;
+  float trajectory_length;
+  float arc_length;
+  float straight_length;
+  uint32_t left_turn;
+  uint32_t first_pose;
+  uint32_t num_poses;
+};
+
+static_assert(sizeof(BinaryHeader) == 32, "Binary lattice header must not be padded");
+static_assert(sizeof(BinaryPrimitive) == 40, "Binary lattice primitive must not be padded");
+
+/**
+ * @class MappedFile
+ * @brief Read only memory mapping of a whole file, unmapped on destruction
+ */
+class MappedFile
+{
+public:
+  explicit MappedFile(const std::string & filepath)
+  {
+    const int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return;
+    }
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) == 0 && file_stat.st_size > 0) {
+      void * mapping = mmap(
+        nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+      if (mapping != MAP_FAILED) {
+        data_ = static_cast<const char *>(mapping);
+        size_ = static_cast<size_t>(file_stat.st_size);
+      }
+    }
+    close(fd);
+  }
+
+  ~MappedFile()
+  {
+    if (data_) {
+      munmap(const_cast<char *>(data_), size_);
+    }
+  }
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile & operator=(const MappedFile &) = delete;
+
+  const char * data_{nullptr};
+  size_t size_{0};
+};
+
+}  // namespace
+
+bool isBinaryLatticeFile(const std::string & filepath)
+{
+  std::ifstream file(filepath, std::ios::binary);
+  char magic[sizeof(MAGIC)];
+  return file.read(magic, sizeof(magic)) && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+void loadBinaryLattice(
+  const std::string & filepath, LatticeMetadata & metadata, MotionPrimitives * primitives)
+{
+  const MappedFile file(filepath);
+  if (!file.data_) {
+    throw std::runtime_error("Could not open lattice file!");
+  }
+
+  BinaryHeader header;
+  if (file.size_ < sizeof(header)) {
+    throw std::runtime_error("Binary lattice file is truncated!");
+  }
+  std::memcpy(&header, file.data_, sizeof(header));
+  if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+    throw std::runtime_error("Lattice file is not in the binary format!");
+  }
+
+  // Sections are validated against the file size before any is read
+  const uint64_t motion_model_offset = sizeof(header);
+  const uint64_t headings_offset =
+    motion_model_offset + (header.motion_model_length + 3u) / 4u * 4u;
+  const uint64_t primitives_offset =
+    headings_offset + static_cast<uint64_t>(header.num_of_headings) * sizeof(float);
+  const uint64_t poses_offset = primitives_offset +
+    static_cast<uint64_t>(header.number_of_trajectories) * sizeof(BinaryPrimitive);
+  const uint64_t end_offset =
+    poses_offset + static_cast<uint64_t>(header.num_poses) * 3u * sizeof(float);
+  if (end_offset != file.size_) {
+    throw std::runtime_error("Binary lattice file is truncated!");
+  }
+
+  metadata.min_turning_radius = header.turning_radius;
+  metadata.grid_resolution = header.grid_resolution;
+  metadata.number_of_headings = header.num_of_headings;
+  metadata.number_of_trajectories = header.number_of_trajectories;
+  metadata.motion_model.assign(file.data_ + motion_model_offset, header.motion_model_length);
+  metadata.heading_angles.resize(header.num_of_headings);
+  std::memcpy(
+    metadata.heading_angles.data(), file.data_ + headings_offset,
+    header.num_of_headings * sizeof(float));
+
+  if (!primitives) {
+    return;
+  }
+
+  primitives->clear();
+  primitives->reserve(header.number_of_trajectories);
+  BinaryPrimitive record;
+  for (uint32_t i = 0; i != header.number_of_trajectories; i++) {
+    std::memcpy(&record, file.data_ + primitives_offset + i * sizeof(record), sizeof(record));
+    if (static_cast<uint64_t>(record.first_pose) + record.num_poses > header.num_poses) {
+      throw std::runtime_error("Binary lattice file has primitive poses out of range!");
+    }
+
+    MotionPrimitive primitive;
+    primitive.trajectory_id = record.trajectory_id;
+    primitive.start_angle = static_cast<float>(record.start_angle_index);
+    primitive.end_angle = static_cast<float>(record.end_angle_index);
+    primitive.turning_radius = record.trajectory_radius;
+    primitive.trajectory_length = record.trajectory_length;
+    primitive.arc_length = record.arc_length;
+    primitive.straight_length = record.straight_length;
+    primitive.left_turn = record.left_turn != 0u;
+    primitive.poses.reserve(record.num_poses);
+    const char * pose_data = file.data_ + poses_offset +
+      static_cast<uint64_t>(record.first_pose) * 3u * sizeof(float);
+    float pose[3];
+    for (uint32_t j = 0; j != record.num_poses; j++) {
+      std::memcpy(pose, pose_data + j * sizeof(pose), sizeof(pose));
+      primitive.poses.emplace_back(pose[0], pose[1], pose[2], TurnDirection::UNKNOWN);
+    }
+    primitives->push_back(std::move(primitive));
+  }
+}
+
+}  // namespace nav2_smac_planner
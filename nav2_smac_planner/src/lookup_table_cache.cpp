@@ -0,0 +1,145 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License. Reserved.
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "nav2_smac_planner/lookup_table_cache.hpp"
+
+namespace nav2_smac_planner
+{
+
+namespace
+{
+
+// File layout: magic, key size, key, number of values, values
+const char MAGIC[8] = {'N', '2', 'S', 'M', 'L', 'U', 'T', '1'};
+
+uint64_t hashKey(const std::string & key)
+{
+  // FNV-1a, stable across builds unlike std::hash
+  uint64_t hash = 14695981039346656037ull;
+  for (const char c : key) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+}  // namespace
+
+std::string getLookupTableCachePath(const std::string & directory, const std::string & key)
+{
+  char name[40];
+  std::snprintf(
+    name, sizeof(name), "lookup_table_%016llx.bin",
+    static_cast<unsigned long long>(hashKey(key)));  // NOLINT
+  return (std::filesystem::path(directory) / name).string();
+}
+
+bool loadLookupTable(
+  const std::string & filepath, const std::string & key, std::vector<float> & table)
+{
+  const int fd = open(filepath.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 || file_stat.st_size <= 0) {
+    close(fd);
+    return false;
+  }
+  const size_t file_size = static_cast<size_t>(file_stat.st_size);
+  void * mapping = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    return false;
+  }
+
+  const char * data = static_cast<const char *>(mapping);
+  bool loaded = false;
+  uint64_t key_size = 0;
+  uint64_t count = 0;
+  size_t offset = sizeof(MAGIC) + sizeof(key_size);
+  if (file_size >= offset && std::memcmp(data, MAGIC, sizeof(MAGIC)) == 0) {
+    std::memcpy(&key_size, data + sizeof(MAGIC), sizeof(key_size));
+    if (key_size == key.size() && file_size - offset >= key_size + sizeof(count) &&
+      std::memcmp(data + offset, key.data(), key_size) == 0)
+    {
+      offset += key_size;
+      std::memcpy(&count, data + offset, sizeof(count));
+      offset += sizeof(count);
+      if ((file_size - offset) / sizeof(float) == count &&
+        (file_size - offset) % sizeof(float) == 0)
+      {
+        table.resize(count);
+        std::memcpy(table.data(), data + offset, count * sizeof(float));
+        loaded = true;
+      }
+    }
+  }
+
+  munmap(mapping, file_size);
+  return loaded;
+}
+
+bool saveLookupTable(
+  const std::string & filepath, const std::string & key, const std::vector<float> & table)
+{
+  std::error_code error;
+  const std::filesystem::path path(filepath);
+  if (path.has_parent_path()) {
+    std::filesystem::create_directories(path.parent_path(), error);
+    if (error) {
+      return false;
+    }
+  }
+
+  const std::string temporary_path = filepath + ".tmp" + std::to_string(getpid());
+  {
+    std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+    const uint64_t key_size = key.size();
+    const uint64_t count = table.size();
+    file.write(MAGIC, sizeof(MAGIC));
+    file.write(reinterpret_cast<const char *>(&key_size), sizeof(key_size));
+    file.write(key.data(), key.size());
+    file.write(reinterpret_cast<const char *>(&count), sizeof(count));
+    file.write(reinterpret_cast<const char *>(table.data()), table.size() * sizeof(float));
+    file.close();
+    if (file.fail()) {
+      std::remove(temporary_path.c_str());
+      return false;
+    }
+  }
+
+  std::filesystem::rename(temporary_path, path, error);
+  if (error) {
+    std::remove(temporary_path.c_str());
+    return false;
+  }
+  return true;
+}
+
+}  // namespace nav2_smac_planner
@@ -107,47 +107,6 @@ void Node2D::initMotionModel(
     -x_size + 1, +x_size - 1, +x_size + 1};
 }
 
-void Node2D::getNeighbors(
-  std::function<bool(const uint64_t &,
-  nav2_smac_planner::Node2D * &)> & NeighborGetter,
-  GridCollisionChecker * collision_checker,
-  const bool & traverse_unknown,
-  NodeVector & neighbors)
-{
-  // NOTE(stevemacenski): Irritatingly, the order here matters. If you start in free
-  // space and then expand 8-connected, the first set of neighbors will be all cost
-  // 1.0. Then its expansion will all be 2 * 1.0 but now multiple
-  // nodes are touching that node so the last cell to update the back pointer wins.
-  // Thusly, the ordering ends with the cardinal directions for both sets such that
-  // behavior is consistent in large free spaces between them.
-  // 100  50   0
-  // 100  50  50
-  // 100 100 100   where lower-middle '100' is visited with same cost by both bottom '50' nodes
-  // Therefore, it is valuable to have some low-potential across the entire map
-  // rather than a small inflation around the obstacles
-  uint64_t index;
-  NodePtr neighbor;
-  uint64_t node_i = this->getIndex();
-  const Coordinates parent = getCoords(this->getIndex());
-  Coordinates child;
-
-  for (unsigned int i = 0; i != _neighbors_grid_offsets.size(); ++i) {
-    index = node_i + _neighbors_grid_offsets[i];
-
-    // Check for wrap around conditions
-    child = getCoords(index);
-    if (fabs(parent.x - child.x) > 1 || fabs(parent.y - child.y) > 1) {
-      continue;
-    }
-
-    if (NeighborGetter(index, neighbor)) {
-      if (neighbor->isNodeValid(traverse_unknown, collision_checker) && !neighbor->wasVisited()) {
-        neighbors.push_back(neighbor);
-      }
-    }
-  }
-}
-
 bool Node2D::backtracePath(CoordinateVector & path)
 {
   if (!this->parent) {
@@ -15,19 +15,22 @@
 // limitations under the License. Reserved.
 
 #include <math.h>
+#include <array>
 #include <chrono>
 #include <vector>
 #include <memory>
 #include <algorithm>
+#include <functional>
 #include <queue>
 #include <limits>
+#include <sstream>
+#include <string>
+#include <thread>
 #include <utility>
 
-#include "ompl/base/ScopedState.h"
-#include "ompl/base/spaces/DubinsStateSpace.h"
-#include "ompl/base/spaces/ReedsSheppStateSpace.h"
 
 #include "nav2_smac_planner/node_hybrid.hpp"
+#include "nav2_smac_planner/lookup_table_cache.hpp"
 
 using namespace std::chrono;  // NOLINT
 
@@ -44,6 +47,11 @@ std::shared_ptr<nav2_costmap_2d::Costmap2DROS> NodeHybrid::costmap_ros = nullptr
 std::shared_ptr<nav2_costmap_2d::InflationLayer> NodeHybrid::inflation_layer = nullptr;
 
 ObstacleHeuristicQueue NodeHybrid::obstacle_heuristic_queue;
+unsigned int NodeHybrid::obstacle_heuristic_threads = 1;
+bool NodeHybrid::obstacle_heuristic_precomputed = false;
+ObstacleHeuristicCache NodeHybrid::obstacle_heuristic_cache;
+unsigned int NodeHybrid::obstacle_heuristic_cache_size = 0;
+nav2_util::MemoryTracker NodeHybrid::obstacle_heuristic_memory("smac_planner/obstacle_heuristic");
 
 // Each of these tables are the projected motion models through
 // time and space applied to the search on the current node in
@@ -139,8 +147,8 @@ void HybridMotionTable::initDubin(
     }
   }
 
-  // Create the correct OMPL state space
-  state_space = std::make_shared<ompl::base::DubinsStateSpace>(min_turning_radius);
+  // Create the Dubins curve solver
+  curve_solver = CurveSolver(min_turning_radius, false);
 
   // Precompute projection deltas
   delta_xs.resize(projections.size());
@@ -260,8 +268,8 @@ void HybridMotionTable::initReedsShepp(
     }
   }
 
-  // Create the correct OMPL state space
-  state_space = std::make_shared<ompl::base::ReedsSheppStateSpace>(min_turning_radius);
+  // Create the Reeds-Shepp curve solver
+  curve_solver = CurveSolver(min_turning_radius, true);
 
   // Precompute projection deltas
   delta_xs.resize(projections.size());
@@ -305,24 +313,7 @@ MotionPoses HybridMotionTable::getProjections(const NodeHybrid * node)
   projection_list.reserve(projections.size());
 
   for (unsigned int i = 0; i != projections.size(); i++) {
-    const MotionPose & motion_model = projections[i];
-
-    // normalize theta, I know its overkill, but I've been burned before...
-    const float & node_heading = node->pose.theta;
-    float new_heading = node_heading + motion_model._theta;
-
-    if (new_heading < 0.0) {
-      new_heading += num_angle_quantization_float;
-    }
-
-    if (new_heading >= num_angle_quantization_float) {
-      new_heading -= num_angle_quantization_float;
-    }
-
-    projection_list.emplace_back(
-      delta_xs[i][node_heading] + node->pose.x,
-      delta_ys[i][node_heading] + node->pose.y,
-      new_heading, motion_model._turn_dir);
+    projection_list.push_back(getProjection(node, i));
   }
 
   return projection_list;
@@ -466,6 +457,10 @@ void NodeHybrid::initMotionModel(
   }
 
   travel_distance_cost = motion_table.projections[0]._x;
+  obstacle_heuristic_threads =
+    static_cast<unsigned int>(std::max(1, search_info.obstacle_heuristic_threads));
+  obstacle_heuristic_cache_size =
+    static_cast<unsigned int>(std::max(0, search_info.obstacle_heuristic_cache_size));
 }
 
 inline float distanceHeuristic2D(
@@ -477,6 +472,151 @@ inline float distanceHeuristic2D(
   return std::sqrt(dx * dx + dy * dy);
 }
 
+// Cost of a cell of the obstacle heuristic grid, or the lowest cost of
+// the 2x2 costmap cells it covers if downsampled
+inline float obstacleHeuristicCellCost(
+  const nav2_costmap_2d::Costmap2D * costmap, const unsigned int idx,
+  const unsigned int size_x, const bool downsample)
+{
+  if (!downsample) {
+    return static_cast<float>(costmap->getCost(idx));
+  }
+
+  // Get costmap values as if downsampled
+  unsigned int y_offset = (idx / size_x) * 2;
+  unsigned int x_offset = (idx - ((idx / size_x) * size_x)) * 2;
+  float cost = costmap->getCost(x_offset, y_offset);
+  for (unsigned int i = 0; i < 2u; ++i) {
+    unsigned int mxd = x_offset + i;
+    if (mxd >= costmap->getSizeInCellsX()) {
+      continue;
+    }
+    for (unsigned int j = 0; j < 2u; ++j) {
+      unsigned int myd = y_offset + j;
+      if (myd >= costmap->getSizeInCellsY()) {
+        continue;
+      }
+      if (i == 0 && j == 0) {
+        continue;
+      }
+      cost = std::min(cost, static_cast<float>(costmap->getCost(mxd, myd)));
+    }
+  }
+  return cost;
+}
+
+// Dijkstra expansion of a wavefront from its queued cells, not leaving the cells [begin, end)
+inline void expandObstacleHeuristic(
+  LookupTable & costs, const std::vector<float> & travel_costs,
+  const std::array<int, 8> & neighborhood, const uint64_t begin, const uint64_t end,
+  ObstacleHeuristicQueue & queue)
+{
+  const float sqrt2 = sqrtf(2.0f);
+  std::make_heap(queue.begin(), queue.end(), ObstacleHeuristicComparator{});
+  while (!queue.empty()) {
+    const float c_cost = queue.front().first;
+    const uint64_t idx = queue.front().second;
+    std::pop_heap(queue.begin(), queue.end(), ObstacleHeuristicComparator{});
+    queue.pop_back();
+    if (c_cost > costs[idx]) {
+      // cell was improved after it was queued
+      continue;
+    }
+
+    for (unsigned int i = 0; i != neighborhood.size(); i++) {
+      const uint64_t new_idx = idx + neighborhood[i];
+      if (new_idx < begin || new_idx >= end || travel_costs[new_idx] < 0.0f) {
+        continue;
+      }
+      const float new_cost = c_cost + (i <= 3 ? 1.0f : sqrt2) * travel_costs[new_idx];
+      const float existing_cost = costs[new_idx];
+      if (existing_cost == 0.0f || new_cost < existing_cost) {
+        costs[new_idx] = new_cost;
+        queue.emplace_back(new_cost, new_idx);
+        std::push_heap(queue.begin(), queue.end(), ObstacleHeuristicComparator{});
+      }
+    }
+  }
+}
+
+// Repair a wavefront to the goal after the travel costs of some cells changed. Cells whose
+// cost was reached through a cell now costlier are unset, then the unset and cheaper cells
+// are expanded again from their neighbors.
+inline void repairObstacleHeuristic(
+  LookupTable & costs, const std::vector<float> & old_travel_costs,
+  const std::vector<float> & travel_costs, const std::array<int, 8> & neighborhood,
+  const uint64_t goal_index)
+{
+  const uint64_t size = costs.size();
+  const float sqrt2 = sqrtf(2.0f);
+  std::vector<uint64_t> changed;
+  std::vector<uint64_t> invalid;
+  for (uint64_t idx = 0; idx != size; idx++) {
+    if (idx == goal_index || travel_costs[idx] == old_travel_costs[idx]) {
+      continue;
+    }
+    changed.push_back(idx);
+    if (old_travel_costs[idx] >= 0.0f &&
+      (travel_costs[idx] < 0.0f || travel_costs[idx] > old_travel_costs[idx]))
+    {
+      invalid.push_back(idx);
+    }
+  }
+
+  // Unset the costlier cells and, in turn, the cells whose cost came from an unset cell
+  std::vector<uint64_t> unset;
+  while (!invalid.empty()) {
+    const uint64_t idx = invalid.back();
+    invalid.pop_back();
+    const float cost = costs[idx];
+    if (cost == 0.0f) {
+      continue;
+    }
+    costs[idx] = 0.0f;
+    unset.push_back(idx);
+    for (unsigned int i = 0; i != neighborhood.size(); i++) {
+      const uint64_t new_idx = idx + neighborhood[i];
+      if (new_idx >= size || new_idx == goal_index || old_travel_costs[new_idx] < 0.0f) {
+        continue;
+      }
+      if (costs[new_idx] == cost + (i <= 3 ? 1.0f : sqrt2) * old_travel_costs[new_idx]) {
+        invalid.push_back(new_idx);
+      }
+    }
+  }
+
+  // Queue the cells which can improve from their neighbors
+  ObstacleHeuristicQueue queue;
+  auto seed = [&](const uint64_t idx) {
+      if (idx == goal_index || travel_costs[idx] < 0.0f) {
+        return;
+      }
+      float best_cost = costs[idx];
+      for (unsigned int i = 0; i != neighborhood.size(); i++) {
+        const uint64_t new_idx = idx + neighborhood[i];
+        if (new_idx >= size || costs[new_idx] == 0.0f) {
+          continue;
+        }
+        const float new_cost = costs[new_idx] + (i <= 3 ? 1.0f : sqrt2) * travel_costs[idx];
+        if (best_cost == 0.0f || new_cost < best_cost) {
+          best_cost = new_cost;
+        }
+      }
+      if (best_cost != costs[idx]) {
+        costs[idx] = best_cost;
+        queue.emplace_back(best_cost, idx);
+      }
+    };
+  for (const uint64_t idx : unset) {
+    seed(idx);
+  }
+  for (const uint64_t idx : changed) {
+    seed(idx);
+  }
+
+  expandObstacleHeuristic(costs, travel_costs, neighborhood, 0, size, queue);
+}
+
 void NodeHybrid::resetObstacleHeuristic(
   std::shared_ptr<nav2_costmap_2d::Costmap2DROS> costmap_ros_i,
   const unsigned int & start_x, const unsigned int & start_y,
@@ -532,6 +672,199 @@ void NodeHybrid::resetObstacleHeuristic(
   // initialize goal cell with a very small value to differentiate it from 0.0 (~uninitialized)
   // the negative value means the cell is in the open set
   obstacle_heuristic_lookup_table[goal_index] = -0.00001f;
+  obstacle_heuristic_precomputed = false;
+  updateObstacleHeuristicMemory();
+}
+
+void NodeHybrid::precomputeObstacleHeuristic(const float & cost_penalty)
+{
+  auto costmap = costmap_ros->getCostmap();
+  const bool is_circular = costmap_ros->getUseRadius();
+  const bool & downsample_H = motion_table.downsample_obstacle_heuristic;
+  unsigned int size_x = 0u;
+  unsigned int size_y = 0u;
+  if (downsample_H) {
+    size_x = ceil(static_cast<float>(costmap->getSizeInCellsX()) / 2.0f);
+    size_y = ceil(static_cast<float>(costmap->getSizeInCellsY()) / 2.0f);
+  } else {
+    size_x = costmap->getSizeInCellsX();
+    size_y = costmap->getSizeInCellsY();
+  }
+
+  obstacle_heuristic_precomputed = true;
+  if (obstacle_heuristic_queue.empty()) {
+    return;
+  }
+  const uint64_t goal_index = obstacle_heuristic_queue.front().second;
+  obstacle_heuristic_queue.clear();
+
+  LookupTable & costs = obstacle_heuristic_lookup_table;
+  const uint64_t size = static_cast<uint64_t>(size_x) * size_y;
+  const int size_x_int = static_cast<int>(size_x);
+  const float sqrt2 = sqrtf(2.0f);
+  const std::array<int, 8> neighborhood = {1, -1,  // left right
+    size_x_int, -size_x_int,  // up down
+    size_x_int + 1, size_x_int - 1,  // upper diagonals
+    -size_x_int + 1, -size_x_int - 1};  // lower diagonals
+
+  // Split the grid in horizontal stripes, each only written by one thread at a time
+  const unsigned int num_stripes = std::max(1u, std::min(obstacle_heuristic_threads, size_y));
+  const unsigned int stripe_rows = (size_y + num_stripes - 1) / num_stripes;
+  auto stripe_begin = [&](const unsigned int stripe) {
+      return static_cast<uint64_t>(std::min(stripe * stripe_rows, size_y)) * size_x;
+    };
+  auto stripe_end = [&](const unsigned int stripe) {
+      return static_cast<uint64_t>(std::min((stripe + 1) * stripe_rows, size_y)) * size_x;
+    };
+  auto run = [&](const std::function<void(unsigned int)> & task) {
+      std::vector<std::thread> threads;
+      for (unsigned int stripe = 1; stripe < num_stripes; stripe++) {
+        threads.emplace_back(task, stripe);
+      }
+      task(0);
+      for (auto & thread : threads) {
+        thread.join();
+      }
+    };
+
+  // Cost of travelling one cell into each cell, negative if it cannot be entered
+  std::vector<float> travel_costs(size);
+  run(
+    [&](const unsigned int stripe) {
+      for (uint64_t idx = stripe_begin(stripe); idx != stripe_end(stripe); idx++) {
+        const unsigned int my = idx / size_x;
+        const unsigned int mx = idx - (my * size_x);
+        if (mx >= size_x - 3 || mx <= 3 || my >= size_y - 3 || my <= 3) {
+          travel_costs[idx] = -1.0f;
+          continue;
+        }
+
+        float cost = obstacleHeuristicCellCost(costmap, idx, size_x, downsample_H);
+        if (!is_circular) {
+          // Adjust cost value if using SE2 footprint checks
+          cost = adjustedFootprintCost(cost);
+          if (cost >= OCCUPIED) {
+            travel_costs[idx] = -1.0f;
+            continue;
+          }
+        } else if (cost >= INSCRIBED) {
+          travel_costs[idx] = -1.0f;
+          continue;
+        }
+
+        if (motion_table.use_quadratic_cost_penalty) {
+          travel_costs[idx] = 1.0f + (cost_penalty * cost * cost / 63504.0f);  // 252^2
+        } else {
+          travel_costs[idx] = 1.0f + (cost_penalty * cost / 252.0f);
+        }
+      }
+    });
+
+  // A wavefront kept for the same goal only needs repairs where travel costs changed
+  if (obstacle_heuristic_cache_size > 0u) {
+    for (auto it = obstacle_heuristic_cache.begin(); it != obstacle_heuristic_cache.end(); ++it) {
+      if (it->goal_index != goal_index || it->size_x != size_x || it->size_y != size_y) {
+        continue;
+      }
+      if (it->travel_costs != travel_costs) {
+        repairObstacleHeuristic(
+          it->costs, it->travel_costs, travel_costs, neighborhood, goal_index);
+        it->travel_costs.swap(travel_costs);
+      }
+      costs = it->costs;
+      obstacle_heuristic_cache.splice(
+        obstacle_heuristic_cache.begin(), obstacle_heuristic_cache, it);
+      return;
+    }
+  }
+
+  // Costs of 0.0 are unset, the goal gets a very small value to differentiate it
+  std::vector<ObstacleHeuristicQueue> queues(num_stripes);
+  std::vector<ObstacleHeuristicQueue> seeds(num_stripes);
+  costs[goal_index] = 0.00001f;
+  seeds[goal_index / size_x / stripe_rows].emplace_back(costs[goal_index], goal_index);
+
+  // Expansion of a stripe from its improved cells, not leaving the stripe
+  auto expand = [&](const unsigned int stripe) {
+      ObstacleHeuristicQueue & queue = queues[stripe];
+      for (const auto & seed : seeds[stripe]) {
+        costs[seed.second] = seed.first;
+        queue.push_back(seed);
+      }
+      seeds[stripe].clear();
+      expandObstacleHeuristic(
+        costs, travel_costs, neighborhood, stripe_begin(stripe), stripe_end(stripe), queue);
+    };
+
+  // Find the first and last rows of a stripe improved from the neighboring stripes
+  auto exchange = [&](const unsigned int stripe) {
+      const uint64_t begin = stripe_begin(stripe);
+      const uint64_t end = stripe_end(stripe);
+      if (begin == end) {
+        return;
+      }
+      for (uint64_t row : {begin, end - size_x}) {
+        for (uint64_t idx = row; idx != row + size_x; idx++) {
+          if (travel_costs[idx] < 0.0f) {
+            continue;
+          }
+          float best_cost = costs[idx];
+          for (unsigned int i = 0; i != neighborhood.size(); i++) {
+            const uint64_t new_idx = idx + neighborhood[i];
+            if ((new_idx >= begin && new_idx < end) || new_idx >= size ||
+              costs[new_idx] == 0.0f)
+            {
+              continue;
+            }
+            const float new_cost = costs[new_idx] + (i <= 3 ? 1.0f : sqrt2) * travel_costs[idx];
+            if (best_cost == 0.0f || new_cost < best_cost) {
+              best_cost = new_cost;
+            }
+          }
+          if (best_cost != costs[idx]) {
+            seeds[stripe].emplace_back(best_cost, idx);
+          }
+        }
+        if (row == end - size_x) {
+          break;
+        }
+      }
+    };
+
+  bool improved = true;
+  while (improved) {
+    run(expand);
+    run(exchange);
+    improved = false;
+    for (const auto & stripe_seeds : seeds) {
+      improved |= !stripe_seeds.empty();
+    }
+  }
+
+  if (obstacle_heuristic_cache_size > 0u) {
+    // Keep the wavefront as the most recently used, dropping the least recently used
+    ObstacleHeuristicField field;
+    field.goal_index = goal_index;
+    field.size_x = size_x;
+    field.size_y = size_y;
+    field.travel_costs.swap(travel_costs);
+    field.costs = costs;
+    obstacle_heuristic_cache.push_front(std::move(field));
+    while (obstacle_heuristic_cache.size() > obstacle_heuristic_cache_size) {
+      obstacle_heuristic_cache.pop_back();
+    }
+    updateObstacleHeuristicMemory();
+  }
+}
+
+void NodeHybrid::updateObstacleHeuristicMemory()
+{
+  size_t bytes = obstacle_heuristic_lookup_table.capacity() * sizeof(float) +
+    obstacle_heuristic_queue.capacity() * sizeof(ObstacleHeuristicElement);
+  for (const auto & field : obstacle_heuristic_cache) {
+    bytes += (field.travel_costs.capacity() + field.costs.capacity()) * sizeof(float);
+  }
+  obstacle_heuristic_memory.update(bytes);
 }
 
 float NodeHybrid::adjustedFootprintCost(const float & cost)
@@ -593,6 +926,14 @@ float NodeHybrid::getObstacleHeuristic(
     return downsample_H ? 2.0f * requested_node_cost : requested_node_cost;
   }
 
+  if (obstacle_heuristic_threads > 1u || obstacle_heuristic_cache_size > 0u) {
+    // The whole wavefront is computed once per goal, cells left unset are unreachable
+    if (!obstacle_heuristic_precomputed) {
+      precomputeObstacleHeuristic(cost_penalty);
+    }
+    return downsample_H ? 2.0f * requested_node_cost : requested_node_cost;
+  }
+
   // If not, expand until it is included. This dynamic programming ensures that
   // we only expand the MINIMUM spanning set of the costmap per planning request.
   // Rather than naively expanding the entire (potentially massive) map for a limited
@@ -641,30 +982,7 @@ float NodeHybrid::getObstacleHeuristic(
 
       // if neighbor path is better and non-lethal, set new cost and add to queue
       if (new_idx < size_x * size_y) {
-        if (downsample_H) {
-          // Get costmap values as if downsampled
-          unsigned int y_offset = (new_idx / size_x) * 2;
-          unsigned int x_offset = (new_idx - ((new_idx / size_x) * size_x)) * 2;
-          cost = costmap->getCost(x_offset, y_offset);
-          for (unsigned int i = 0; i < 2u; ++i) {
-            unsigned int mxd = x_offset + i;
-            if (mxd >= costmap->getSizeInCellsX()) {
-              continue;
-            }
-            for (unsigned int j = 0; j < 2u; ++j) {
-              unsigned int myd = y_offset + j;
-              if (myd >= costmap->getSizeInCellsY()) {
-                continue;
-              }
-              if (i == 0 && j == 0) {
-                continue;
-              }
-              cost = std::min(cost, static_cast<float>(costmap->getCost(mxd, myd)));
-            }
-          }
-        } else {
-          cost = static_cast<float>(costmap->getCost(new_idx));
-        }
+        cost = obstacleHeuristicCellCost(costmap, new_idx, size_x, downsample_H);
 
         if (!is_circular) {
           // Adjust cost value if using SE2 footprint checks
@@ -793,14 +1111,11 @@ float NodeHybrid::getDistanceHeuristic(
   } else if (obstacle_heuristic <= 0.0) {
     // If no obstacle heuristic value, must have some H to use
     // In nominal situations, this should never be called.
-    static ompl::base::ScopedState<> from(motion_table.state_space), to(motion_table.state_space);
-    to[0] = goal_coords.x;
-    to[1] = goal_coords.y;
-    to[2] = goal_coords.theta * motion_table.num_angle_quantization;
-    from[0] = node_coords.x;
-    from[1] = node_coords.y;
-    from[2] = node_coords.theta * motion_table.num_angle_quantization;
-    motion_heuristic = motion_table.state_space->distance(from(), to());
+    const CurvePose from{node_coords.x, node_coords.y,
+      node_coords.theta * motion_table.num_angle_quantization};
+    const CurvePose to{goal_coords.x, goal_coords.y,
+      goal_coords.theta * motion_table.num_angle_quantization};
+    motion_heuristic = motion_table.curve_solver.distance(from, to);
   }
 
   return motion_heuristic;
@@ -814,82 +1129,64 @@ void NodeHybrid::precomputeDistanceHeuristic(
 {
   // Dubin or Reeds-Shepp shortest distances
   if (motion_model == MotionModel::DUBIN) {
-    motion_table.state_space = std::make_shared<ompl::base::DubinsStateSpace>(
-      search_info.minimum_turning_radius);
+    motion_table.curve_solver = CurveSolver(search_info.minimum_turning_radius, false);
   } else if (motion_model == MotionModel::REEDS_SHEPP) {
-    motion_table.state_space = std::make_shared<ompl::base::ReedsSheppStateSpace>(
-      search_info.minimum_turning_radius);
+    motion_table.curve_solver = CurveSolver(search_info.minimum_turning_radius, true);
   } else {
     throw std::runtime_error(
             "Node attempted to precompute distance heuristics "
             "with invalid motion model!");
   }
 
-  ompl::base::ScopedState<> from(motion_table.state_space), to(motion_table.state_space);
-  to[0] = 0.0;
-  to[1] = 0.0;
-  to[2] = 0.0;
+  CurvePose from{0.0, 0.0, 0.0};
+  const CurvePose to{0.0, 0.0, 0.0};
   size_lookup = lookup_table_dim;
   float motion_heuristic = 0.0;
   unsigned int index = 0;
   int dim_3_size_int = static_cast<int>(dim_3_size);
   float angular_bin_size = 2 * M_PI / static_cast<float>(dim_3_size);
+  const size_t table_size = size_lookup * ceil(size_lookup / 2.0) * dim_3_size_int;
+
+  // Load the table saved by a previous run from the same inputs
+  std::string cache_filepath, cache_key;
+  if (!search_info.distance_heuristic_cache_directory.empty()) {
+    std::ostringstream key;
+    key << std::hexfloat << "distance_heuristic " << toString(motion_model) << " " <<
+      search_info.minimum_turning_radius << " " << size_lookup;
+    for (int heading = 0; heading != dim_3_size_int; heading++) {
+      key << " " << heading * angular_bin_size;
+    }
+    cache_key = key.str();
+    cache_filepath =
+      getLookupTableCachePath(search_info.distance_heuristic_cache_directory, cache_key);
+    if (loadLookupTable(cache_filepath, cache_key, dist_heuristic_lookup_table) &&
+      dist_heuristic_lookup_table.size() == table_size)
+    {
+      return;
+    }
+  }
 
   // Create a lookup table of Dubin/Reeds-Shepp distances in a window around the goal
   // to help drive the search towards admissible approaches. Deu to symmetries in the
   // Heuristic space, we need to only store 2 of the 4 quadrants and simply mirror
   // around the X axis any relative node lookup. This reduces memory overhead and increases
   // the size of a window a platform can store in memory.
-  dist_heuristic_lookup_table.resize(size_lookup * ceil(size_lookup / 2.0) * dim_3_size_int);
+  dist_heuristic_lookup_table.resize(table_size);
   for (float x = ceil(-size_lookup / 2.0); x <= floor(size_lookup / 2.0); x += 1.0) {
     for (float y = 0.0; y <= floor(size_lookup / 2.0); y += 1.0) {
       for (int heading = 0; heading != dim_3_size_int; heading++) {
-        from[0] = x;
-        from[1] = y;
-        from[2] = heading * angular_bin_size;
-        motion_heuristic = motion_table.state_space->distance(from(), to());
+        from.x = x;
+        from.y = y;
+        from.theta = heading * angular_bin_size;
+        motion_heuristic = motion_table.curve_solver.distance(from, to);
         dist_heuristic_lookup_table[index] = motion_heuristic;
         index++;
       }
     }
   }
-}
 
-void NodeHybrid::getNeighbors(
-  std::function<bool(const uint64_t &,
-  nav2_smac_planner::NodeHybrid * &)> & NeighborGetter,
-  GridCollisionChecker * collision_checker,
-  const bool & traverse_unknown,
-  NodeVector & neighbors)
-{
-  uint64_t index = 0;
-  NodePtr neighbor = nullptr;
-  Coordinates initial_node_coords;
-  const MotionPoses motion_projections = motion_table.getProjections(this);
-
-  for (unsigned int i = 0; i != motion_projections.size(); i++) {
-    index = NodeHybrid::getIndex(
-      static_cast<unsigned int>(motion_projections[i]._x),
-      static_cast<unsigned int>(motion_projections[i]._y),
-      static_cast<unsigned int>(motion_projections[i]._theta),
-      motion_table.size_x, motion_table.num_angle_quantization);
-
-    if (NeighborGetter(index, neighbor) && !neighbor->wasVisited()) {
-      // Cache the initial pose in case it was visited but valid
-      // don't want to disrupt continuous coordinate expansion
-      initial_node_coords = neighbor->pose;
-      neighbor->setPose(
-        Coordinates(
-          motion_projections[i]._x,
-          motion_projections[i]._y,
-          motion_projections[i]._theta));
-      if (neighbor->isNodeValid(traverse_unknown, collision_checker)) {
-        neighbor->setMotionPrimitiveIndex(i, motion_projections[i]._turn_dir);
-        neighbors.push_back(neighbor);
-      } else {
-        neighbor->setPose(initial_node_coords);
-      }
-    }
+  if (!cache_filepath.empty()) {
+    saveLookupTable(cache_filepath, cache_key, dist_heuristic_lookup_table);
   }
 }
 
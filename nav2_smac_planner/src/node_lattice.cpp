@@ -19,15 +19,16 @@
 #include <algorithm>
 #include <queue>
 #include <limits>
+#include <utility>
 #include <string>
+#include <sstream>
 #include <fstream>
 #include <cmath>
 
-#include "ompl/base/ScopedState.h"
-#include "ompl/base/spaces/DubinsStateSpace.h"
-#include "ompl/base/spaces/ReedsSheppStateSpace.h"
 
 #include "nav2_smac_planner/node_lattice.hpp"
+#include "nav2_smac_planner/lookup_table_cache.hpp"
+#include "nav2_smac_planner/lattice_binary.hpp"
 
 using namespace std::chrono;  // NOLINT
 
@@ -66,42 +67,42 @@ void LatticeMotionTable::initMotionModel(
   rotation_penalty = search_info.rotation_penalty;
   min_turning_radius = search_info.minimum_turning_radius;
 
-  // Get the metadata about this minimum control set
-  lattice_metadata = getLatticeMetadata(current_lattice_filepath);
-  std::ifstream latticeFile(current_lattice_filepath);
-  if (!latticeFile.is_open()) {
-    throw std::runtime_error("Could not open lattice file");
+  // Get the metadata and primitives of this minimum control set,
+  // binary lattice files are memory mapped rather than parsed
+  MotionPrimitives file_primitives;
+  if (isBinaryLatticeFile(current_lattice_filepath)) {
+    loadBinaryLattice(current_lattice_filepath, lattice_metadata, &file_primitives);
+  } else {
+    lattice_metadata = getLatticeMetadata(current_lattice_filepath);
+    std::ifstream latticeFile(current_lattice_filepath);
+    if (!latticeFile.is_open()) {
+      throw std::runtime_error("Could not open lattice file");
+    }
+    nlohmann::json json;
+    latticeFile >> json;
+    nlohmann::json json_primitives = json["primitives"];
+    file_primitives.resize(json_primitives.size());
+    for (unsigned int i = 0; i < json_primitives.size(); ++i) {
+      fromJsonToMotionPrimitive(json_primitives[i], file_primitives[i]);
+    }
   }
-  nlohmann::json json;
-  latticeFile >> json;
   num_angle_quantization = lattice_metadata.number_of_headings;
 
-  if (!state_space) {
-    if (!allow_reverse_expansion) {
-      state_space = std::make_shared<ompl::base::DubinsStateSpace>(
-        lattice_metadata.min_turning_radius);
-      motion_model = MotionModel::DUBIN;
-    } else {
-      state_space = std::make_shared<ompl::base::ReedsSheppStateSpace>(
-        lattice_metadata.min_turning_radius);
-      motion_model = MotionModel::REEDS_SHEPP;
-    }
+  if (motion_model == MotionModel::UNKNOWN) {
+    curve_solver = CurveSolver(lattice_metadata.min_turning_radius, allow_reverse_expansion);
+    motion_model = allow_reverse_expansion ? MotionModel::REEDS_SHEPP : MotionModel::DUBIN;
   }
 
   // Populate the motion primitives at each heading angle
   float prev_start_angle = 0.0;
   std::vector<MotionPrimitive> primitives;
-  nlohmann::json json_primitives = json["primitives"];
-  for (unsigned int i = 0; i < json_primitives.size(); ++i) {
-    MotionPrimitive new_primitive;
-    fromJsonToMotionPrimitive(json_primitives[i], new_primitive);
-
+  for (auto & new_primitive : file_primitives) {
     if (prev_start_angle != new_primitive.start_angle) {
       motion_primitives.push_back(primitives);
       primitives.clear();
       prev_start_angle = new_primitive.start_angle;
     }
-    primitives.push_back(new_primitive);
+    primitives.push_back(std::move(new_primitive));
   }
   motion_primitives.push_back(primitives);
 
@@ -128,16 +129,8 @@ MotionPrimitivePtrs LatticeMotionTable::getMotionPrimitives(
   direction_change_index = static_cast<unsigned int>(primitive_projection_list.size());
 
   if (allow_reverse_expansion) {
-    // Find normalized heading bin of the reverse expansion
-    double reserve_heading = node->pose.theta - (num_angle_quantization / 2);
-    if (reserve_heading < 0) {
-      reserve_heading += num_angle_quantization;
-    }
-    if (reserve_heading > num_angle_quantization) {
-      reserve_heading -= num_angle_quantization;
-    }
-
-    MotionPrimitives & prims_at_reverse_heading = motion_primitives[reserve_heading];
+    MotionPrimitives & prims_at_reverse_heading =
+      motion_primitives[getReverseHeading(node->pose.theta)];
     for (unsigned int i = 0; i != prims_at_reverse_heading.size(); i++) {
       primitive_projection_list.push_back(&prims_at_reverse_heading[i]);
     }
@@ -146,8 +139,27 @@ MotionPrimitivePtrs LatticeMotionTable::getMotionPrimitives(
   return primitive_projection_list;
 }
 
+unsigned int LatticeMotionTable::getReverseHeading(const float & heading) const
+{
+  // Find normalized heading bin of the reverse expansion
+  double reserve_heading = heading - (num_angle_quantization / 2);
+  if (reserve_heading < 0) {
+    reserve_heading += num_angle_quantization;
+  }
+  if (reserve_heading > num_angle_quantization) {
+    reserve_heading -= num_angle_quantization;
+  }
+  return static_cast<unsigned int>(reserve_heading);
+}
+
 LatticeMetadata LatticeMotionTable::getLatticeMetadata(const std::string & lattice_filepath)
 {
+  if (isBinaryLatticeFile(lattice_filepath)) {
+    LatticeMetadata metadata;
+    loadBinaryLattice(lattice_filepath, metadata);
+    return metadata;
+  }
+
   std::ifstream lattice_file(lattice_filepath);
   if (!lattice_file.is_open()) {
     throw std::runtime_error("Could not open lattice file!");
@@ -216,62 +228,38 @@ bool NodeLattice::isNodeValid(
   MotionPrimitive * motion_primitive,
   bool is_backwards)
 {
-  // Check primitive end pose
   // Convert grid quantization of primitives to radians, then collision checker quantization
   static const double bin_size = 2.0 * M_PI / collision_checker->getPrecomputedAngles().size();
   const double & angle = motion_table.getAngleFromBin(this->pose.theta) / bin_size;
+
+  // If valid motion primitives are set, check the end pose and intermediary poses > 1 cell
+  // apart at once, through the cells swept by the footprint along the primitive
+  if (motion_primitive) {
+    if (this->pose.x < 0.0f || this->pose.y < 0.0f) {
+      return false;
+    }
+    const GridCollisionChecker::SweptFootprint & swept = collision_checker->getSweptFootprint(
+      *motion_primitive, is_backwards, angle /*bin in collision checker*/,
+      motion_table.lattice_metadata.grid_resolution);
+    if (collision_checker->inCollision(
+        swept, static_cast<unsigned int>(this->pose.x + 0.5f),
+        static_cast<unsigned int>(this->pose.y + 0.5f), traverse_unknown))
+    {
+      return false;
+    }
+    // Set the cost of a node to the highest cost across the primitive
+    _cell_cost = collision_checker->getCost();
+    return true;
+  }
+
+  // Check primitive end pose
   if (collision_checker->inCollision(
       this->pose.x, this->pose.y, angle /*bin in collision checker*/, traverse_unknown))
   {
     return false;
   }
 
-  // Set the cost of a node to the highest cost across the primitive
-  float max_cell_cost = collision_checker->getCost();
-
-  // If valid motion primitives are set, check intermediary poses > 1 cell apart
-  if (motion_primitive) {
-    const float & grid_resolution = motion_table.lattice_metadata.grid_resolution;
-    const float & resolution_diag_sq = 2.0 * grid_resolution * grid_resolution;
-    MotionPose last_pose(1e9, 1e9, 1e9, TurnDirection::UNKNOWN);
-    MotionPose pose_dist(0.0, 0.0, 0.0, TurnDirection::UNKNOWN);
-
-    // Back out the initial node starting point to move motion primitive relative to
-    MotionPose initial_pose, prim_pose;
-    initial_pose._x = this->pose.x - (motion_primitive->poses.back()._x / grid_resolution);
-    initial_pose._y = this->pose.y - (motion_primitive->poses.back()._y / grid_resolution);
-    initial_pose._theta = motion_table.getAngleFromBin(motion_primitive->start_angle);
-
-    for (auto it = motion_primitive->poses.begin(); it != motion_primitive->poses.end(); ++it) {
-      // poses are in metric coordinates from (0, 0), not grid space yet
-      pose_dist = *it - last_pose;
-      // Avoid square roots by (hypot(x, y) > res) == (x*x+y*y > diag*diag)
-      if (pose_dist._x * pose_dist._x + pose_dist._y * pose_dist._y > resolution_diag_sq) {
-        last_pose = *it;
-        // Convert primitive pose into grid space if it should be checked
-        prim_pose._x = initial_pose._x + (it->_x / grid_resolution);
-        prim_pose._y = initial_pose._y + (it->_y / grid_resolution);
-        // If reversing, invert the angle because the robot is backing into the primitive
-        // not driving forward with it
-        if (is_backwards) {
-          prim_pose._theta = std::fmod(it->_theta + M_PI, 2.0 * M_PI);
-        } else {
-          prim_pose._theta = it->_theta;
-        }
-        if (collision_checker->inCollision(
-            prim_pose._x,
-            prim_pose._y,
-            prim_pose._theta / bin_size /*bin in collision checker*/,
-            traverse_unknown))
-        {
-          return false;
-        }
-        max_cell_cost = std::max(max_cell_cost, collision_checker->getCost());
-      }
-    }
-  }
-
-  _cell_cost = max_cell_cost;
+  _cell_cost = collision_checker->getCost();
   return true;
 }
 
@@ -351,6 +339,12 @@ void NodeLattice::initMotionModel(
   }
 
   motion_table.initMotionModel(size_x, search_info);
+
+  // State Lattice and Hybrid-A* share the obstacle heuristic
+  NodeHybrid::obstacle_heuristic_threads =
+    static_cast<unsigned int>(std::max(1, search_info.obstacle_heuristic_threads));
+  NodeHybrid::obstacle_heuristic_cache_size =
+    static_cast<unsigned int>(std::max(0, search_info.obstacle_heuristic_cache_size));
 }
 
 float NodeLattice::getDistanceHeuristic(
@@ -407,14 +401,11 @@ float NodeLattice::getDistanceHeuristic(
       theta_pos;
     motion_heuristic = dist_heuristic_lookup_table[index];
   } else if (obstacle_heuristic == 0.0) {
-    static ompl::base::ScopedState<> from(motion_table.state_space), to(motion_table.state_space);
-    to[0] = goal_coords.x;
-    to[1] = goal_coords.y;
-    to[2] = motion_table.getAngleFromBin(goal_coords.theta);
-    from[0] = node_coords.x;
-    from[1] = node_coords.y;
-    from[2] = motion_table.getAngleFromBin(node_coords.theta);
-    motion_heuristic = motion_table.state_space->distance(from(), to());
+    const CurvePose from{node_coords.x, node_coords.y,
+      motion_table.getAngleFromBin(node_coords.theta)};
+    const CurvePose to{goal_coords.x, goal_coords.y,
+      motion_table.getAngleFromBin(goal_coords.theta)};
+    motion_heuristic = motion_table.curve_solver.distance(from, to);
   }
 
   return motion_heuristic;
@@ -428,115 +419,64 @@ void NodeLattice::precomputeDistanceHeuristic(
 {
   // Dubin or Reeds-Shepp shortest distances
   if (!search_info.allow_reverse_expansion) {
-    motion_table.state_space = std::make_shared<ompl::base::DubinsStateSpace>(
-      search_info.minimum_turning_radius);
+    motion_table.curve_solver = CurveSolver(search_info.minimum_turning_radius, false);
     motion_table.motion_model = MotionModel::DUBIN;
   } else {
-    motion_table.state_space = std::make_shared<ompl::base::ReedsSheppStateSpace>(
-      search_info.minimum_turning_radius);
+    motion_table.curve_solver = CurveSolver(search_info.minimum_turning_radius, true);
     motion_table.motion_model = MotionModel::REEDS_SHEPP;
   }
   motion_table.lattice_metadata =
     LatticeMotionTable::getLatticeMetadata(search_info.lattice_filepath);
 
-  ompl::base::ScopedState<> from(motion_table.state_space), to(motion_table.state_space);
-  to[0] = 0.0;
-  to[1] = 0.0;
-  to[2] = 0.0;
+  CurvePose from{0.0, 0.0, 0.0};
+  const CurvePose to{0.0, 0.0, 0.0};
   size_lookup = lookup_table_dim;
   float motion_heuristic = 0.0;
   unsigned int index = 0;
   int dim_3_size_int = static_cast<int>(dim_3_size);
+  const size_t table_size = size_lookup * ceil(size_lookup / 2.0) * dim_3_size_int;
+
+  // Load the table saved by a previous run from the same inputs
+  std::string cache_filepath, cache_key;
+  if (!search_info.distance_heuristic_cache_directory.empty()) {
+    std::ostringstream key;
+    key << std::hexfloat << "lattice_distance_heuristic " <<
+      toString(motion_table.motion_model) << " " << search_info.minimum_turning_radius <<
+      " " << size_lookup;
+    for (int heading = 0; heading != dim_3_size_int; heading++) {
+      key << " " << motion_table.getAngleFromBin(heading);
+    }
+    cache_key = key.str();
+    cache_filepath =
+      getLookupTableCachePath(search_info.distance_heuristic_cache_directory, cache_key);
+    if (loadLookupTable(cache_filepath, cache_key, dist_heuristic_lookup_table) &&
+      dist_heuristic_lookup_table.size() == table_size)
+    {
+      return;
+    }
+  }
 
   // Create a lookup table of Dubin/Reeds-Shepp distances in a window around the goal
   // to help drive the search towards admissible approaches. Deu to symmetries in the
   // Heuristic space, we need to only store 2 of the 4 quadrants and simply mirror
   // around the X axis any relative node lookup. This reduces memory overhead and increases
   // the size of a window a platform can store in memory.
-  dist_heuristic_lookup_table.resize(size_lookup * ceil(size_lookup / 2.0) * dim_3_size_int);
+  dist_heuristic_lookup_table.resize(table_size);
   for (float x = ceil(-size_lookup / 2.0); x <= floor(size_lookup / 2.0); x += 1.0) {
     for (float y = 0.0; y <= floor(size_lookup / 2.0); y += 1.0) {
       for (int heading = 0; heading != dim_3_size_int; heading++) {
-        from[0] = x;
-        from[1] = y;
-        from[2] = motion_table.getAngleFromBin(heading);
-        motion_heuristic = motion_table.state_space->distance(from(), to());
+        from.x = x;
+        from.y = y;
+        from.theta = motion_table.getAngleFromBin(heading);
+        motion_heuristic = motion_table.curve_solver.distance(from, to);
         dist_heuristic_lookup_table[index] = motion_heuristic;
         index++;
       }
     }
   }
-}
-
-void NodeLattice::getNeighbors(
-  std::function<bool(const uint64_t &,
-  nav2_smac_planner::NodeLattice * &)> & NeighborGetter,
-  GridCollisionChecker * collision_checker,
-  const bool & traverse_unknown,
-  NodeVector & neighbors)
-{
-  uint64_t index = 0;
-  float angle;
-  bool backwards = false;
-  NodePtr neighbor = nullptr;
-  Coordinates initial_node_coords, motion_projection;
-  unsigned int direction_change_index = 0;
-  MotionPrimitivePtrs motion_primitives = motion_table.getMotionPrimitives(
-    this,
-    direction_change_index);
-  const float & grid_resolution = motion_table.lattice_metadata.grid_resolution;
-
-  for (unsigned int i = 0; i != motion_primitives.size(); i++) {
-    const MotionPose & end_pose = motion_primitives[i]->poses.back();
-    motion_projection.x = this->pose.x + (end_pose._x / grid_resolution);
-    motion_projection.y = this->pose.y + (end_pose._y / grid_resolution);
-    motion_projection.theta = motion_primitives[i]->end_angle /*this is the ending angular bin*/;
-
-    index = NodeLattice::getIndex(
-      static_cast<unsigned int>(motion_projection.x),
-      static_cast<unsigned int>(motion_projection.y),
-      static_cast<unsigned int>(motion_projection.theta));
-
-    if (NeighborGetter(index, neighbor) && !neighbor->wasVisited()) {
-      // Cache the initial pose in case it was visited but valid
-      // don't want to disrupt continuous coordinate expansion
-      initial_node_coords = neighbor->pose;
-      // if i >= idx, then we're in a reversing primitive. In that situation,
-      // the orientation of the robot is mirrored from what it would otherwise
-      // appear to be from the motion primitives file. We want to take this into
-      // account in case the robot base footprint is asymmetric.
-      backwards = false;
-      angle = motion_projection.theta;
-      if (i >= direction_change_index) {
-        backwards = true;
-        angle = motion_projection.theta - (motion_table.num_angle_quantization / 2);
-        if (angle < 0) {
-          angle += motion_table.num_angle_quantization;
-        }
-        if (angle > motion_table.num_angle_quantization) {
-          angle -= motion_table.num_angle_quantization;
-        }
-      }
 
-      neighbor->setPose(
-        Coordinates(
-          motion_projection.x,
-          motion_projection.y,
-          angle));
-
-      // Using a special isNodeValid API here, giving the motion primitive to use to
-      // validity check the transition of the current node to the new node over
-      if (neighbor->isNodeValid(
-          traverse_unknown, collision_checker, motion_primitives[i], backwards))
-      {
-        neighbor->setMotionPrimitive(motion_primitives[i]);
-        // Marking if this search was obtained in the reverse direction
-        neighbor->backwards(backwards);
-        neighbors.push_back(neighbor);
-      } else {
-        neighbor->setPose(initial_node_coords);
-      }
-    }
+  if (!cache_filepath.empty()) {
+    saveLookupTable(cache_filepath, cache_key, dist_heuristic_lookup_table);
   }
 }
 
@@ -0,0 +1,158 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License. Reserved.
+
+#include "nav2_smac_planner/search_corridor.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace nav2_smac_planner
+{
+
+SearchCorridor::SearchCorridor()
+: _costmap_downsampler(nullptr),
+  _a_star(nullptr),
+  _collision_checker(nullptr, 1, nullptr),
+  _total_downsampling_factor(1),
+  _downsampling_factor(1),
+  _corridor_width(0.0),
+  _size_x(0),
+  _size_y(0)
+{
+}
+
+void SearchCorridor::on_configure(
+  const rclcpp_lifecycle::LifecycleNode::SharedPtr & node,
+  const std::shared_ptr<nav2_costmap_2d::Costmap2DROS> & costmap_ros,
+  nav2_costmap_2d::Costmap2D * const costmap,
+  const unsigned int & search_downsampling_factor,
+  const unsigned int & downsampling_factor,
+  const bool & use_min_cost_neighbor,
+  const double & corridor_width,
+  const float & cost_penalty,
+  const bool & allow_unknown,
+  const int & max_iterations,
+  const int & terminal_checking_interval,
+  const double & max_planning_time)
+{
+  _downsampling_factor = std::max(downsampling_factor, 1u);
+  _total_downsampling_factor = std::max(search_downsampling_factor, 1u) * _downsampling_factor;
+  _corridor_width = corridor_width;
+  clear();
+
+  // The coarse costmap is not published, it is only an intermediate step of the plan
+  _costmap_downsampler = std::make_unique<CostmapDownsampler>();
+  _costmap_downsampler->on_configure(
+    nav2_util::LifecycleNode::WeakPtr(), costmap_ros->getGlobalFrameID(), "", costmap,
+    _total_downsampling_factor, use_min_cost_neighbor);
+
+  _collision_checker = GridCollisionChecker(costmap_ros, 1 /*for 2D, most be 1*/, node);
+  _collision_checker.setFootprint(
+    costmap_ros->getRobotFootprint(),
+    true /*for 2D, most use radius*/,
+    0.0 /*for 2D cost at inscribed isn't relevent*/);
+
+  SearchInfo search_info;
+  search_info.cost_penalty = cost_penalty;
+  int coarse_max_iterations = max_iterations;
+  _a_star = std::make_unique<AStarAlgorithm<Node2D>>(MotionModel::TWOD, search_info);
+  _a_star->initialize(
+    allow_unknown,
+    coarse_max_iterations,
+    std::numeric_limits<int>::max(),
+    terminal_checking_interval,
+    max_planning_time,
+    0.0,
+    1);
+}
+
+void SearchCorridor::on_cleanup()
+{
+  clear();
+  _a_star.reset();
+  if (_costmap_downsampler) {
+    _costmap_downsampler->on_cleanup();
+    _costmap_downsampler.reset();
+  }
+}
+
+void SearchCorridor::clear()
+{
+  _cells.clear();
+}
+
+bool SearchCorridor::update(
+  const float & start_mx, const float & start_my,
+  const float & goal_mx, const float & goal_my,
+  std::function<bool()> cancel_checker)
+{
+  clear();
+
+  nav2_costmap_2d::Costmap2D * costmap =
+    _costmap_downsampler->downsample(_total_downsampling_factor);
+  _collision_checker.setCostmap(costmap);
+  _a_star->setCollisionChecker(&_collision_checker);
+
+  const float factor = static_cast<float>(_downsampling_factor);
+  _a_star->setStart(start_mx / factor, start_my / factor, 0);
+  _a_star->setGoal(goal_mx / factor, goal_my / factor, 0);
+
+  Node2D::CoordinateVector path;
+  int num_iterations = 0;
+  try {
+    if (!_a_star->createPath(path, num_iterations, 0.0, cancel_checker)) {
+      return false;
+    }
+  } catch (const nav2_core::GoalOccupied &) {
+    // Pooling may fill the goal's coarse cell, leaving the full resolution search to it
+    return false;
+  }
+
+  // Keep the corridor's width at least a coarse cell on each side of the path,
+  // as the path crosses the coarse cells anywhere within them
+  const int radius = std::max(
+    static_cast<int>(std::ceil(_corridor_width / costmap->getResolution())), 1);
+  _size_x = costmap->getSizeInCellsX();
+  _size_y = costmap->getSizeInCellsY();
+  setCells(path, radius);
+  return true;
+}
+
+void SearchCorridor::setCells(const Node2D::CoordinateVector & path, const int & radius)
+{
+  _cells.assign(static_cast<size_t>(_size_x) * static_cast<size_t>(_size_y), 0);
+  const int size_x = static_cast<int>(_size_x);
+  const int size_y = static_cast<int>(_size_y);
+  const int radius_sq = radius * radius;
+
+  for (const auto & coords : path) {
+    const int x = static_cast<int>(coords.x);
+    const int y = static_cast<int>(coords.y);
+    const int y_min = std::max(y - radius, 0);
+    const int y_max = std::min(y + radius, size_y - 1);
+    for (int cy = y_min; cy <= y_max; cy++) {
+      const int dy = cy - y;
+      const int dx_max = static_cast<int>(std::sqrt(static_cast<float>(radius_sq - dy * dy)));
+      const int x_min = std::max(x - dx_max, 0);
+      const int x_max = std::min(x + dx_max, size_x - 1);
+      std::fill(
+        _cells.begin() + cy * size_x + x_min, _cells.begin() + cy * size_x + x_max + 1, 1);
+    }
+  }
+}
+
+}  // namespace nav2_smac_planner
@@ -17,6 +17,7 @@
 #include <vector>
 #include <limits>
 #include <algorithm>
+#include <utility>
 
 #include "nav2_smac_planner/smac_planner_2d.hpp"
 #include "nav2_util/geometry_utils.hpp"
@@ -34,6 +35,9 @@ SmacPlanner2D::SmacPlanner2D()
   _collision_checker(nullptr, 1, nullptr),
   _smoother(nullptr),
   _costmap(nullptr),
+  _layered_costmap(nullptr),
+  _costmap_update_count(0),
+  _jump_point_update_count(0),
   _costmap_downsampler(nullptr)
 {
 }
@@ -55,6 +59,7 @@ void SmacPlanner2D::configure(
   _logger = node->get_logger();
   _clock = node->get_clock();
   _costmap = costmap_ros->getCostmap();
+  _layered_costmap = costmap_ros->getLayeredCostmap();
   _name = name;
   _global_frame = costmap_ros->getGlobalFrameID();
 
@@ -86,9 +91,29 @@ void SmacPlanner2D::configure(
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".terminal_checking_interval", rclcpp::ParameterValue(5000));
   node->get_parameter(name + ".terminal_checking_interval", _terminal_checking_interval);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".use_node_pool", rclcpp::ParameterValue(false));
+  node->get_parameter(name + ".use_node_pool", _use_node_pool);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".open_list_arity", rclcpp::ParameterValue(2));
+  node->get_parameter(name + ".open_list_arity", _open_list_arity);
+  if (_open_list_arity < 2) {
+    RCLCPP_WARN(
+      _logger, "open list arity selected as < 2, using a binary heap.");
+    _open_list_arity = 2;
+  }
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".use_final_approach_orientation", rclcpp::ParameterValue(false));
   node->get_parameter(name + ".use_final_approach_orientation", _use_final_approach_orientation);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".incremental_replanning", rclcpp::ParameterValue(false));
+  node->get_parameter(name + ".incremental_replanning", _incremental_replanning);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".bidirectional_search", rclcpp::ParameterValue(false));
+  node->get_parameter(name + ".bidirectional_search", _bidirectional_search);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".jump_point_search", rclcpp::ParameterValue(false));
+  node->get_parameter(name + ".jump_point_search", _jump_point_search);
 
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".max_planning_time", rclcpp::ParameterValue(2.0));
@@ -118,15 +143,7 @@ void SmacPlanner2D::configure(
     0.0 /*for 2D cost at inscribed isn't relevent*/);
 
   // Initialize A* template
-  _a_star = std::make_unique<AStarAlgorithm<Node2D>>(_motion_model, _search_info);
-  _a_star->initialize(
-    _allow_unknown,
-    _max_iterations,
-    _max_on_approach_iterations,
-    _terminal_checking_interval,
-    _max_planning_time,
-    0.0 /*unused for 2D*/,
-    1.0 /*unused for 2D*/);
+  initializeSearch();
 
   // Initialize path smoother
   SmootherParams params;
@@ -186,6 +203,9 @@ void SmacPlanner2D::cleanup()
     _logger, "Cleaning up plugin %s of type SmacPlanner2D",
     _name.c_str());
   _a_star.reset();
+  _d_star_lite.reset();
+  _bidirectional_a_star.reset();
+  _jump_point_searcher.reset();
   _smoother.reset();
   if (_costmap_downsampler) {
     _costmap_downsampler->on_cleanup();
@@ -198,6 +218,16 @@ nav_msgs::msg::Path SmacPlanner2D::createPlan(
   const geometry_msgs::msg::PoseStamped & start,
   const geometry_msgs::msg::PoseStamped & goal,
   std::function<bool()> cancel_checker)
+{
+  size_t goal_index = 0;
+  return createPlanToGoalSet(start, {goal}, cancel_checker, goal_index);
+}
+
+nav_msgs::msg::Path SmacPlanner2D::createPlanToGoalSet(
+  const geometry_msgs::msg::PoseStamped & start,
+  const std::vector<geometry_msgs::msg::PoseStamped> & goals,
+  std::function<bool()> cancel_checker,
+  size_t & goal_index)
 {
   std::lock_guard<std::mutex> lock_reinit(_mutex);
   steady_clock::time_point a = steady_clock::now();
@@ -228,18 +258,52 @@ nav_msgs::msg::Path SmacPlanner2D::createPlan(
   }
   _a_star->setStart(mx_start, my_start, 0);
 
-  // Set goal point
-  if (!costmap->worldToMapContinuous(
-      goal.pose.position.x,
-      goal.pose.position.y,
-      mx_goal,
-      my_goal))
-  {
-    throw nav2_core::GoalOutsideMapBounds(
-            "Goal Coordinates of(" + std::to_string(goal.pose.position.x) + ", " +
-            std::to_string(goal.pose.position.y) + ") was outside bounds");
+  // Set goal points, the goals of a set outside bounds or occupied are left out
+  std::vector<size_t> candidates;
+  std::vector<std::pair<float, float>> map_goals;
+  bool goal_occupied = false;
+  for (size_t i = 0; i != goals.size(); i++) {
+    const geometry_msgs::msg::PoseStamped & goal = goals[i];
+    if (!costmap->worldToMapContinuous(
+        goal.pose.position.x,
+        goal.pose.position.y,
+        mx_goal,
+        my_goal))
+    {
+      if (goals.size() == 1) {
+        throw nav2_core::GoalOutsideMapBounds(
+                "Goal Coordinates of(" + std::to_string(goal.pose.position.x) + ", " +
+                std::to_string(goal.pose.position.y) + ") was outside bounds");
+      }
+      continue;
+    }
+
+    // A single goal occupied is reported by the search
+    if (goals.size() > 1 && _tolerance == 0.0f &&
+      _collision_checker.inCollision(
+        Node2D::getIndex(
+          static_cast<unsigned int>(mx_goal), static_cast<unsigned int>(my_goal),
+          costmap->getSizeInCellsX()), _allow_unknown))
+    {
+      goal_occupied = true;
+      continue;
+    }
+
+    candidates.push_back(i);
+    map_goals.emplace_back(mx_goal, my_goal);
+  }
+
+  if (candidates.empty()) {
+    if (goal_occupied) {
+      throw nav2_core::GoalOccupied("All goals were occupied or outside bounds");
+    }
+    throw nav2_core::GoalOutsideMapBounds("All goals were outside bounds");
+  }
+
+  _a_star->setGoal(map_goals.front().first, map_goals.front().second, 0);
+  for (size_t i = 1; i < map_goals.size(); i++) {
+    _a_star->addGoal(map_goals[i].first, map_goals[i].second, 0);
   }
-  _a_star->setGoal(mx_goal, my_goal, 0);
 
   // Setup message
   nav_msgs::msg::Path plan;
@@ -254,7 +318,14 @@ nav_msgs::msg::Path SmacPlanner2D::createPlan(
   pose.pose.orientation.w = 1.0;
 
   // Corner case of start and goal beeing on the same cell
-  if (std::floor(mx_start) == std::floor(mx_goal) && std::floor(my_start) == std::floor(my_goal)) {
+  for (size_t i = 0; i != candidates.size(); i++) {
+    if (std::floor(mx_start) != std::floor(map_goals[i].first) ||
+      std::floor(my_start) != std::floor(map_goals[i].second))
+    {
+      continue;
+    }
+    goal_index = candidates[i];
+    const geometry_msgs::msg::PoseStamped & goal = goals[goal_index];
     pose.pose = start.pose;
     // if we have a different start and goal orientation, set the unique path pose to the goal
     // orientation, unless use_final_approach_orientation=true where we need it to be the start
@@ -266,11 +337,118 @@ nav_msgs::msg::Path SmacPlanner2D::createPlan(
     return plan;
   }
 
+  // Repair the search kept from the last plan where the costmap changed since,
+  // it only plans to a single goal
+  const bool use_d_star_lite = _d_star_lite && candidates.size() == 1;
+  if (use_d_star_lite) {
+    _d_star_lite->setCollisionChecker(&_collision_checker);
+    unsigned int x0, xn, y0, yn;
+    if (_layered_costmap->getUpdatedWindowSince(_costmap_update_count, x0, xn, y0, yn)) {
+      if (_costmap_downsampler) {
+        const unsigned int factor = static_cast<unsigned int>(_downsampling_factor);
+        x0 /= factor;
+        y0 /= factor;
+        xn = (xn + factor - 1) / factor;
+        yn = (yn + factor - 1) / factor;
+      }
+      _d_star_lite->updateCells(x0, xn, y0, yn);
+    } else {
+      _d_star_lite->clear();
+    }
+    _costmap_update_count = _layered_costmap->getUpdateCount();
+    _d_star_lite->setStart(
+      static_cast<unsigned int>(mx_start), static_cast<unsigned int>(my_start));
+    _d_star_lite->setGoal(
+      static_cast<unsigned int>(map_goals.front().first),
+      static_cast<unsigned int>(map_goals.front().second));
+  }
+
   // Compute plan
   Node2D::CoordinateVector path;
   int num_iterations = 0;
+  bool path_found = false;
+  if (use_d_star_lite) {
+    path_found = _d_star_lite->createPath(path, num_iterations, cancel_checker);
+    if (!path_found) {
+      // A* reports why no path was found, or finds one within tolerance of the goal
+      RCLCPP_DEBUG(_logger, "Incremental search found no path, searching with A*.");
+      path.clear();
+      num_iterations = 0;
+    }
+  }
+
+  // Jump over the regions of identical cost, with the jump distances kept from the last plan
+  // updated where the costmap changed since
+  if (!path_found && _jump_point_searcher && candidates.size() == 1) {
+    _jump_point_searcher->setCollisionChecker(&_collision_checker);
+    unsigned int x0, xn, y0, yn;
+    if (_layered_costmap->getUpdatedWindowSince(_jump_point_update_count, x0, xn, y0, yn)) {
+      if (_costmap_downsampler) {
+        const unsigned int factor = static_cast<unsigned int>(_downsampling_factor);
+        x0 /= factor;
+        y0 /= factor;
+        xn = (xn + factor - 1) / factor;
+        yn = (yn + factor - 1) / factor;
+      }
+      _jump_point_searcher->updateCells(x0, xn, y0, yn);
+    } else {
+      _jump_point_searcher->clear();
+    }
+    _jump_point_update_count = _layered_costmap->getUpdateCount();
+    _jump_point_searcher->setStart(
+      static_cast<unsigned int>(mx_start), static_cast<unsigned int>(my_start));
+    _jump_point_searcher->setGoal(
+      static_cast<unsigned int>(map_goals.front().first),
+      static_cast<unsigned int>(map_goals.front().second));
+    path.clear();
+    num_iterations = 0;
+    path_found = _jump_point_searcher->createPath(path, num_iterations, cancel_checker);
+    if (!path_found) {
+      RCLCPP_DEBUG(_logger, "Jump point search found no path, searching with A*.");
+      path.clear();
+      num_iterations = 0;
+    }
+  }
+
   // Note: All exceptions thrown are handled by the planner server and returned to the action
-  if (!_a_star->createPath(
+  if (!path_found && _bidirectional_a_star && candidates.size() == 1) {
+    _bidirectional_a_star->setCollisionChecker(&_collision_checker);
+    _bidirectional_a_star->setStart(
+      static_cast<unsigned int>(mx_start), static_cast<unsigned int>(my_start));
+    _bidirectional_a_star->setGoal(
+      static_cast<unsigned int>(map_goals.front().first),
+      static_cast<unsigned int>(map_goals.front().second));
+    path.clear();
+    num_iterations = 0;
+    switch (_bidirectional_a_star->createPath(path, num_iterations, cancel_checker)) {
+      case BidirectionalAStar::Outcome::PATH_FOUND:
+        path_found = true;
+        break;
+      case BidirectionalAStar::Outcome::START_BLOCKED:
+        throw nav2_core::StartOccupied("Start occupied");
+      case BidirectionalAStar::Outcome::LIMIT_REACHED:
+        if (num_iterations < _bidirectional_a_star->getMaxIterations()) {
+          throw nav2_core::NoValidPathCouldBeFound("no valid path found");
+        }
+        throw nav2_core::PlannerTimedOut("exceeded maximum iterations");
+      case BidirectionalAStar::Outcome::GOAL_OCCUPIED:
+        if (_tolerance == 0.0f) {
+          throw nav2_core::GoalOccupied("Goal was in lethal cost");
+        }
+        [[fallthrough]];
+      case BidirectionalAStar::Outcome::NO_PATH:
+        // A* finds a path within tolerance of the goal, if any
+        if (_tolerance == 0.0f) {
+          throw nav2_core::NoValidPathCouldBeFound("no valid path found");
+        }
+        RCLCPP_DEBUG(_logger, "Bidirectional search found no path, searching with A*.");
+        path.clear();
+        num_iterations = 0;
+        break;
+    }
+  }
+
+  if (!path_found && !_a_star->createPath(
       path, num_iterations,
       _tolerance / static_cast<float>(costmap->getResolution()), cancel_checker))
   {
@@ -286,6 +464,19 @@ nav_msgs::msg::Path SmacPlanner2D::createPlan(
     }
   }
 
+  // The goal reached is the closest to the end of the path, which is first
+  goal_index = candidates.front();
+  float closest_distance = std::numeric_limits<float>::max();
+  for (size_t i = 0; i != candidates.size(); i++) {
+    const float dx = map_goals[i].first - path.front().x;
+    const float dy = map_goals[i].second - path.front().y;
+    if (dx * dx + dy * dy < closest_distance) {
+      closest_distance = dx * dx + dy * dy;
+      goal_index = candidates[i];
+    }
+  }
+  const geometry_msgs::msg::PoseStamped & goal = goals[goal_index];
+
   // Convert to world coordinates
   plan.poses.reserve(path.size());
   for (int i = path.size() - 1; i >= 0; --i) {
@@ -337,6 +528,57 @@ nav_msgs::msg::Path SmacPlanner2D::createPlan(
   return plan;
 }
 
+void SmacPlanner2D::initializeSearch()
+{
+  _a_star = std::make_unique<AStarAlgorithm<Node2D>>(_motion_model, _search_info);
+  _a_star->initialize(
+    _allow_unknown,
+    _max_iterations,
+    _max_on_approach_iterations,
+    _terminal_checking_interval,
+    _max_planning_time,
+    0.0 /*unused for 2D*/,
+    1.0 /*unused for 2D*/,
+    _use_node_pool,
+    _open_list_arity);
+
+  _bidirectional_a_star.reset();
+  if (_bidirectional_search) {
+    _bidirectional_a_star = std::make_unique<BidirectionalAStar>();
+    _bidirectional_a_star->initialize(
+      _allow_unknown,
+      _max_iterations,
+      _terminal_checking_interval,
+      _max_planning_time,
+      _search_info.cost_penalty,
+      _open_list_arity);
+  }
+
+  _jump_point_searcher.reset();
+  if (_jump_point_search) {
+    _jump_point_searcher = std::make_unique<JumpPointSearch>();
+    _jump_point_searcher->initialize(
+      _allow_unknown,
+      _max_iterations,
+      _terminal_checking_interval,
+      _max_planning_time,
+      _search_info.cost_penalty,
+      _open_list_arity);
+  }
+
+  _d_star_lite.reset();
+  if (_incremental_replanning) {
+    _d_star_lite = std::make_unique<DStarLite>();
+    _d_star_lite->initialize(
+      _allow_unknown,
+      _max_iterations,
+      _terminal_checking_interval,
+      _max_planning_time,
+      _search_info.cost_penalty,
+      _open_list_arity);
+  }
+}
+
 rcl_interfaces::msg::SetParametersResult
 SmacPlanner2D::dynamicParametersCallback(std::vector<rclcpp::Parameter> parameters)
 {
@@ -369,6 +611,15 @@ SmacPlanner2D::dynamicParametersCallback(std::vector<rclcpp::Parameter> paramete
         _allow_unknown = parameter.as_bool();
       } else if (name == _name + ".use_final_approach_orientation") {
         _use_final_approach_orientation = parameter.as_bool();
+      } else if (name == _name + ".incremental_replanning") {
+        reinit_a_star = true;
+        _incremental_replanning = parameter.as_bool();
+      } else if (name == _name + ".bidirectional_search") {
+        reinit_a_star = true;
+        _bidirectional_search = parameter.as_bool();
+      } else if (name == _name + ".jump_point_search") {
+        reinit_a_star = true;
+        _jump_point_search = parameter.as_bool();
       }
     } else if (type == ParameterType::PARAMETER_INTEGER) {
       if (name == _name + ".downsampling_factor") {
@@ -403,15 +654,7 @@ SmacPlanner2D::dynamicParametersCallback(std::vector<rclcpp::Parameter> paramete
   if (reinit_a_star || reinit_downsampler) {
     // Re-Initialize A* template
     if (reinit_a_star) {
-      _a_star = std::make_unique<AStarAlgorithm<Node2D>>(_motion_model, _search_info);
-      _a_star->initialize(
-        _allow_unknown,
-        _max_iterations,
-        _max_on_approach_iterations,
-        _terminal_checking_interval,
-        _max_planning_time,
-        0.0 /*unused for 2D*/,
-        1.0 /*unused for 2D*/);
+      initializeSearch();
     }
 
     // Re-Initialize costmap downsampler
@@ -423,6 +666,9 @@ SmacPlanner2D::dynamicParametersCallback(std::vector<rclcpp::Parameter> paramete
         _costmap_downsampler->on_configure(
           node, _global_frame, topic_name, _costmap, _downsampling_factor);
       }
+      if (_d_star_lite) {
+        _d_star_lite->clear();
+      }
     }
   }
   result.successful = true;
@@ -37,7 +37,8 @@ SmacPlannerHybrid::SmacPlannerHybrid()
   _smoother(nullptr),
   _costmap(nullptr),
   _costmap_ros(nullptr),
-  _costmap_downsampler(nullptr)
+  _costmap_downsampler(nullptr),
+  _search_corridor(nullptr)
 {
 }
 
@@ -97,6 +98,17 @@ void SmacPlannerHybrid::configure(
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".terminal_checking_interval", rclcpp::ParameterValue(5000));
   node->get_parameter(name + ".terminal_checking_interval", _terminal_checking_interval);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".use_node_pool", rclcpp::ParameterValue(false));
+  node->get_parameter(name + ".use_node_pool", _use_node_pool);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".open_list_arity", rclcpp::ParameterValue(2));
+  node->get_parameter(name + ".open_list_arity", _open_list_arity);
+  if (_open_list_arity < 2) {
+    RCLCPP_WARN(
+      _logger, "open list arity selected as < 2, using a binary heap.");
+    _open_list_arity = 2;
+  }
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".smooth_path", rclcpp::ParameterValue(true));
   node->get_parameter(name + ".smooth_path", smooth_path);
@@ -111,6 +123,19 @@ void SmacPlannerHybrid::configure(
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".cache_obstacle_heuristic", rclcpp::ParameterValue(false));
   node->get_parameter(name + ".cache_obstacle_heuristic", _search_info.cache_obstacle_heuristic);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".obstacle_heuristic_threads", rclcpp::ParameterValue(1));
+  node->get_parameter(
+    name + ".obstacle_heuristic_threads", _search_info.obstacle_heuristic_threads);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".obstacle_heuristic_cache_size", rclcpp::ParameterValue(0));
+  node->get_parameter(
+    name + ".obstacle_heuristic_cache_size", _search_info.obstacle_heuristic_cache_size);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".distance_heuristic_cache_directory", rclcpp::ParameterValue(std::string("")));
+  node->get_parameter(
+    name + ".distance_heuristic_cache_directory",
+    _search_info.distance_heuristic_cache_directory);
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".reverse_penalty", rclcpp::ParameterValue(2.0));
   node->get_parameter(name + ".reverse_penalty", _search_info.reverse_penalty);
@@ -138,6 +163,10 @@ void SmacPlannerHybrid::configure(
   node->get_parameter(
     name + ".analytic_expansion_max_cost_override",
     _search_info.analytic_expansion_max_cost_override);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".analytic_expansion_candidates", rclcpp::ParameterValue(0));
+  node->get_parameter(
+    name + ".analytic_expansion_candidates", _search_info.analytic_expansion_candidates);
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".use_quadratic_cost_penalty", rclcpp::ParameterValue(false));
   node->get_parameter(
@@ -147,6 +176,20 @@ void SmacPlannerHybrid::configure(
   node->get_parameter(
     name + ".downsample_obstacle_heuristic", _search_info.downsample_obstacle_heuristic);
 
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".anytime_heuristic_weight", rclcpp::ParameterValue(1.0));
+  node->get_parameter(name + ".anytime_heuristic_weight", _search_info.anytime_heuristic_weight);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".anytime_weight_step", rclcpp::ParameterValue(0.5));
+  node->get_parameter(name + ".anytime_weight_step", _search_info.anytime_weight_step);
+  if (_search_info.anytime_weight_step <= 0.0f) {
+    RCLCPP_WARN(
+      _logger, "anytime weight step selected as <= 0, refining with a weight of 1 directly.");
+  }
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".anytime_refinement_time", rclcpp::ParameterValue(0.05));
+  node->get_parameter(name + ".anytime_refinement_time", _search_info.anytime_refinement_time);
+
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".analytic_expansion_max_length", rclcpp::ParameterValue(3.0));
   node->get_parameter(name + ".analytic_expansion_max_length", analytic_expansion_max_length_m);
@@ -156,6 +199,16 @@ void SmacPlannerHybrid::configure(
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".max_planning_time", rclcpp::ParameterValue(5.0));
   node->get_parameter(name + ".max_planning_time", _max_planning_time);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".hierarchical_downsampling_factor", rclcpp::ParameterValue(0));
+  node->get_parameter(
+    name + ".hierarchical_downsampling_factor", _hierarchical_downsampling_factor);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".hierarchical_use_min_cost", rclcpp::ParameterValue(false));
+  node->get_parameter(name + ".hierarchical_use_min_cost", _hierarchical_use_min_cost);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".hierarchical_corridor_width", rclcpp::ParameterValue(2.0));
+  node->get_parameter(name + ".hierarchical_corridor_width", _hierarchical_corridor_width);
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".lookup_table_size", rclcpp::ParameterValue(20.0));
   node->get_parameter(name + ".lookup_table_size", _lookup_table_size);
@@ -163,6 +216,15 @@ void SmacPlannerHybrid::configure(
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".debug_visualizations", rclcpp::ParameterValue(false));
   node->get_parameter(name + ".debug_visualizations", _debug_visualizations);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".expansions_log_size", rclcpp::ParameterValue(100000));
+  node->get_parameter(name + ".expansions_log_size", _expansions_log_size);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".expansions_log_stride", rclcpp::ParameterValue(1));
+  node->get_parameter(name + ".expansions_log_stride", _expansions_log_stride);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".partial_plan_period", rclcpp::ParameterValue(0.0));
+  node->get_parameter(name + ".partial_plan_period", _partial_plan_period);
 
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".motion_model_for_search", rclcpp::ParameterValue(std::string("DUBIN")));
@@ -234,7 +296,9 @@ void SmacPlannerHybrid::configure(
     _terminal_checking_interval,
     _max_planning_time,
     _lookup_table_dim,
-    _angle_quantizations);
+    _angle_quantizations,
+    _use_node_pool,
+    _open_list_arity);
 
   // Initialize path smoother
   if (smooth_path) {
@@ -252,10 +316,24 @@ void SmacPlannerHybrid::configure(
       node, _global_frame, topic_name, _costmap, _downsampling_factor);
   }
 
+  // Initialize coarse search of the corridor to search in, if hierarchical
+  if (_hierarchical_downsampling_factor > 1) {
+    _search_corridor = std::make_unique<SearchCorridor>();
+    _search_corridor->on_configure(
+      node, _costmap_ros, _costmap, _downsampling_factor, _hierarchical_downsampling_factor,
+      _hierarchical_use_min_cost, _hierarchical_corridor_width, _search_info.cost_penalty,
+      _allow_unknown, _max_iterations, _terminal_checking_interval, _max_planning_time);
+  }
+
   _raw_plan_publisher = node->create_publisher<nav_msgs::msg::Path>("unsmoothed_plan", 1);
+  if (_partial_plan_period > 0.0) {
+    _partial_plan_publisher = node->create_publisher<nav_msgs::msg::Path>("partial_plan", 1);
+  }
 
   if (_debug_visualizations) {
-    _expansions_publisher = node->create_publisher<geometry_msgs::msg::PoseArray>("expansions", 1);
+    _expansions_publisher = std::make_unique<ExpansionsPublisher>(
+      node, _global_frame, std::max(_expansions_log_size, 0),
+      std::max(_expansions_log_stride, 1));
     _planned_footprints_publisher = node->create_publisher<visualization_msgs::msg::MarkerArray>(
       "planned_footprints", 1);
   }
@@ -275,6 +353,9 @@ void SmacPlannerHybrid::activate()
     _logger, "Activating plugin %s of type SmacPlannerHybrid",
     _name.c_str());
   _raw_plan_publisher->on_activate();
+  if (_partial_plan_publisher) {
+    _partial_plan_publisher->on_activate();
+  }
   if (_debug_visualizations) {
     _expansions_publisher->on_activate();
     _planned_footprints_publisher->on_activate();
@@ -304,6 +385,9 @@ void SmacPlannerHybrid::deactivate()
     _logger, "Deactivating plugin %s of type SmacPlannerHybrid",
     _name.c_str());
   _raw_plan_publisher->on_deactivate();
+  if (_partial_plan_publisher) {
+    _partial_plan_publisher->on_deactivate();
+  }
   if (_debug_visualizations) {
     _expansions_publisher->on_deactivate();
     _planned_footprints_publisher->on_deactivate();
@@ -326,7 +410,12 @@ void SmacPlannerHybrid::cleanup()
     _costmap_downsampler->on_cleanup();
     _costmap_downsampler.reset();
   }
+  if (_search_corridor) {
+    _search_corridor->on_cleanup();
+    _search_corridor.reset();
+  }
   _raw_plan_publisher.reset();
+  _partial_plan_publisher.reset();
   _expansions_publisher.reset();
   _planned_footprints_publisher.reset();
 }
@@ -373,6 +462,9 @@ nav_msgs::msg::Path SmacPlannerHybrid::createPlan(
   }
   unsigned int orientation_bin_id = static_cast<unsigned int>(floor(orientation_bin));
   _a_star->setStart(mx, my, orientation_bin_id);
+  const float start_mx = mx;
+  const float start_my = my;
+  const unsigned int start_bin_id = orientation_bin_id;
 
   // Set goal point, in A* bin search coordinates
   if (!costmap->worldToMapContinuous(goal.pose.position.x, goal.pose.position.y, mx, my)) {
@@ -391,6 +483,16 @@ nav_msgs::msg::Path SmacPlannerHybrid::createPlan(
   orientation_bin_id = static_cast<unsigned int>(floor(orientation_bin));
   _a_star->setGoal(mx, my, orientation_bin_id);
 
+  // Restrict the search to the corridor of a coarse search, if hierarchical
+  bool use_corridor = false;
+  if (_search_corridor) {
+    use_corridor = _search_corridor->update(start_mx, start_my, mx, my, cancel_checker);
+    if (!use_corridor) {
+      RCLCPP_DEBUG(_logger, "Coarse search found no corridor, searching the whole costmap.");
+    }
+  }
+  _a_star->setSearchCorridor(use_corridor ? _search_corridor.get() : nullptr);
+
   // Setup message
   nav_msgs::msg::Path plan;
   plan.header.stamp = _clock->now();
@@ -403,31 +505,63 @@ nav_msgs::msg::Path SmacPlannerHybrid::createPlan(
   pose.pose.orientation.z = 0.0;
   pose.pose.orientation.w = 1.0;
 
+  // Stream best-effort plans while searching, for consumers to start moving on
+  if (_partial_plan_publisher) {
+    auto publish_partial_plan =
+      [this, costmap, pose](const NodeHybrid::CoordinateVector & partial_path) mutable
+      {
+        if (_partial_plan_publisher->get_subscription_count() == 0) {
+          return;
+        }
+        auto partial_plan = std::make_unique<nav_msgs::msg::Path>();
+        partial_plan->header.stamp = _clock->now();
+        partial_plan->header.frame_id = _global_frame;
+        partial_plan->poses.reserve(partial_path.size());
+        pose.header = partial_plan->header;
+        for (int i = partial_path.size() - 1; i >= 0; --i) {
+          pose.pose = getWorldCoords(partial_path[i].x, partial_path[i].y, costmap);
+          pose.pose.orientation = getWorldOrientation(partial_path[i].theta);
+          partial_plan->poses.push_back(pose);
+        }
+        _partial_plan_publisher->publish(std::move(partial_plan));
+      };
+    _a_star->setPartialPathCallback(publish_partial_plan, _partial_plan_period);
+  }
+
   // Compute plan
   NodeHybrid::CoordinateVector path;
   int num_iterations = 0;
   std::string error;
-  std::unique_ptr<std::vector<std::tuple<float, float, float>>> expansions = nullptr;
+  ExpansionsLog * expansions = nullptr;
   if (_debug_visualizations) {
-    expansions = std::make_unique<std::vector<std::tuple<float, float, float>>>();
+    expansions = _expansions_publisher->startLog();
   }
   // Note: All exceptions thrown are handled by the planner server and returned to the action
-  if (!_a_star->createPath(
+  bool path_found = _a_star->createPath(
+    path, num_iterations,
+    _tolerance / static_cast<float>(costmap->getResolution()), cancel_checker, expansions);
+  if (!path_found && use_corridor) {
+    // The coarse costmap may hide passages or open ones the robot cannot take
+    RCLCPP_WARN(
+      _logger, "No path found in the corridor of the coarse search, "
+      "searching the whole costmap.");
+    _a_star->setSearchCorridor(nullptr);
+    _a_star->setCollisionChecker(&_collision_checker);
+    _a_star->setStart(start_mx, start_my, start_bin_id);
+    _a_star->setGoal(mx, my, orientation_bin_id);
+    num_iterations = 0;
+    if (expansions) {
+      expansions->clear();
+    }
+    path_found = _a_star->createPath(
       path, num_iterations,
-      _tolerance / static_cast<float>(costmap->getResolution()), cancel_checker, expansions.get()))
-  {
+      _tolerance / static_cast<float>(costmap->getResolution()), cancel_checker,
+      expansions);
+  }
+
+  if (!path_found) {
     if (_debug_visualizations) {
-      geometry_msgs::msg::PoseArray msg;
-      geometry_msgs::msg::Pose msg_pose;
-      msg.header.stamp = _clock->now();
-      msg.header.frame_id = _global_frame;
-      for (auto & e : *expansions) {
-        msg_pose.position.x = std::get<0>(e);
-        msg_pose.position.y = std::get<1>(e);
-        msg_pose.orientation = getWorldOrientation(std::get<2>(e));
-        msg.poses.push_back(msg_pose);
-      }
-      _expansions_publisher->publish(msg);
+      _expansions_publisher->publish(_clock->now());
     }
 
     // Note: If the start is blocked only one iteration will occur before failure
@@ -442,6 +576,12 @@ nav_msgs::msg::Path SmacPlannerHybrid::createPlan(
     }
   }
 
+  if (_search_info.anytime_heuristic_weight > 1.0f) {
+    RCLCPP_DEBUG(
+      _logger, "Anytime search found a path within %.2f times the best path's cost.",
+      _a_star->getSuboptimalityBound());
+  }
+
   // Convert to world coordinates
   plan.poses.reserve(path.size());
   for (int i = path.size() - 1; i >= 0; --i) {
@@ -457,17 +597,7 @@ nav_msgs::msg::Path SmacPlannerHybrid::createPlan(
 
   if (_debug_visualizations) {
     // Publish expansions for debug
-    geometry_msgs::msg::PoseArray msg;
-    geometry_msgs::msg::Pose msg_pose;
-    msg.header.stamp = _clock->now();
-    msg.header.frame_id = _global_frame;
-    for (auto & e : *expansions) {
-      msg_pose.position.x = std::get<0>(e);
-      msg_pose.position.y = std::get<1>(e);
-      msg_pose.orientation = getWorldOrientation(std::get<2>(e));
-      msg.poses.push_back(msg_pose);
-    }
-    _expansions_publisher->publish(msg);
+    _expansions_publisher->publish(_clock->now());
 
     // plot footprint path planned for debug
     if (_planned_footprints_publisher->get_subscription_count() > 0) {
@@ -571,6 +701,15 @@ SmacPlannerHybrid::dynamicParametersCallback(std::vector<rclcpp::Parameter> para
       } else if (name == _name + ".analytic_expansion_max_cost") {
         reinit_a_star = true;
         _search_info.analytic_expansion_max_cost = static_cast<float>(parameter.as_double());
+      } else if (name == _name + ".anytime_heuristic_weight") {
+        reinit_a_star = true;
+        _search_info.anytime_heuristic_weight = static_cast<float>(parameter.as_double());
+      } else if (name == _name + ".anytime_weight_step") {
+        reinit_a_star = true;
+        _search_info.anytime_weight_step = static_cast<float>(parameter.as_double());
+      } else if (name == _name + ".anytime_refinement_time") {
+        reinit_a_star = true;
+        _search_info.anytime_refinement_time = parameter.as_double();
       } else if (name == "resolution") {
         // Special case: When the costmap's resolution changes, need to reinitialize
         // the controller to have new resolution information
@@ -687,7 +826,9 @@ SmacPlannerHybrid::dynamicParametersCallback(std::vector<rclcpp::Parameter> para
         _terminal_checking_interval,
         _max_planning_time,
         _lookup_table_dim,
-        _angle_quantizations);
+        _angle_quantizations,
+        _use_node_pool,
+        _open_list_arity);
     }
 
     // Re-Initialize costmap downsampler
@@ -700,6 +841,14 @@ SmacPlannerHybrid::dynamicParametersCallback(std::vector<rclcpp::Parameter> para
       }
     }
 
+    // Re-Initialize coarse search, following the search's costmap and parameters
+    if (_search_corridor && (reinit_a_star || reinit_downsampler)) {
+      _search_corridor->on_configure(
+        node, _costmap_ros, _costmap, _downsampling_factor, _hierarchical_downsampling_factor,
+        _hierarchical_use_min_cost, _hierarchical_corridor_width, _search_info.cost_penalty,
+        _allow_unknown, _max_iterations, _terminal_checking_interval, _max_planning_time);
+    }
+
     // Re-Initialize collision checker
     if (reinit_collision_checker) {
       _collision_checker = GridCollisionChecker(_costmap_ros, _angle_quantizations, node);
@@ -33,7 +33,8 @@ SmacPlannerLattice::SmacPlannerLattice()
 : _a_star(nullptr),
   _collision_checker(nullptr, 1, nullptr),
   _smoother(nullptr),
-  _costmap(nullptr)
+  _costmap(nullptr),
+  _search_corridor(nullptr)
 {
 }
 
@@ -80,6 +81,17 @@ void SmacPlannerLattice::configure(
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".terminal_checking_interval", rclcpp::ParameterValue(5000));
   node->get_parameter(name + ".terminal_checking_interval", _terminal_checking_interval);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".use_node_pool", rclcpp::ParameterValue(false));
+  node->get_parameter(name + ".use_node_pool", _use_node_pool);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".open_list_arity", rclcpp::ParameterValue(2));
+  node->get_parameter(name + ".open_list_arity", _open_list_arity);
+  if (_open_list_arity < 2) {
+    RCLCPP_WARN(
+      _logger, "open list arity selected as < 2, using a binary heap.");
+    _open_list_arity = 2;
+  }
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".smooth_path", rclcpp::ParameterValue(true));
   node->get_parameter(name + ".smooth_path", smooth_path);
@@ -93,6 +105,19 @@ void SmacPlannerLattice::configure(
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".cache_obstacle_heuristic", rclcpp::ParameterValue(false));
   node->get_parameter(name + ".cache_obstacle_heuristic", _search_info.cache_obstacle_heuristic);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".obstacle_heuristic_threads", rclcpp::ParameterValue(1));
+  node->get_parameter(
+    name + ".obstacle_heuristic_threads", _search_info.obstacle_heuristic_threads);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".obstacle_heuristic_cache_size", rclcpp::ParameterValue(0));
+  node->get_parameter(
+    name + ".obstacle_heuristic_cache_size", _search_info.obstacle_heuristic_cache_size);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".distance_heuristic_cache_directory", rclcpp::ParameterValue(std::string("")));
+  node->get_parameter(
+    name + ".distance_heuristic_cache_directory",
+    _search_info.distance_heuristic_cache_directory);
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".reverse_penalty", rclcpp::ParameterValue(2.0));
   node->get_parameter(name + ".reverse_penalty", _search_info.reverse_penalty);
@@ -123,6 +148,10 @@ void SmacPlannerLattice::configure(
   node->get_parameter(
     name + ".analytic_expansion_max_cost_override",
     _search_info.analytic_expansion_max_cost_override);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".analytic_expansion_candidates", rclcpp::ParameterValue(0));
+  node->get_parameter(
+    name + ".analytic_expansion_candidates", _search_info.analytic_expansion_candidates);
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".analytic_expansion_max_length", rclcpp::ParameterValue(3.0));
   node->get_parameter(name + ".analytic_expansion_max_length", analytic_expansion_max_length_m);
@@ -132,6 +161,16 @@ void SmacPlannerLattice::configure(
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".max_planning_time", rclcpp::ParameterValue(5.0));
   node->get_parameter(name + ".max_planning_time", _max_planning_time);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".hierarchical_downsampling_factor", rclcpp::ParameterValue(0));
+  node->get_parameter(
+    name + ".hierarchical_downsampling_factor", _hierarchical_downsampling_factor);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".hierarchical_use_min_cost", rclcpp::ParameterValue(false));
+  node->get_parameter(name + ".hierarchical_use_min_cost", _hierarchical_use_min_cost);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".hierarchical_corridor_width", rclcpp::ParameterValue(2.0));
+  node->get_parameter(name + ".hierarchical_corridor_width", _hierarchical_corridor_width);
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".lookup_table_size", rclcpp::ParameterValue(20.0));
   node->get_parameter(name + ".lookup_table_size", _lookup_table_size);
@@ -141,6 +180,12 @@ void SmacPlannerLattice::configure(
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".debug_visualizations", rclcpp::ParameterValue(false));
   node->get_parameter(name + ".debug_visualizations", _debug_visualizations);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".expansions_log_size", rclcpp::ParameterValue(100000));
+  node->get_parameter(name + ".expansions_log_size", _expansions_log_size);
+  nav2_util::declare_parameter_if_not_declared(
+    node, name + ".expansions_log_stride", rclcpp::ParameterValue(1));
+  node->get_parameter(name + ".expansions_log_stride", _expansions_log_stride);
 
   _metadata = LatticeMotionTable::getLatticeMetadata(_search_info.lattice_filepath);
   _search_info.minimum_turning_radius =
@@ -199,7 +244,9 @@ void SmacPlannerLattice::configure(
     _terminal_checking_interval,
     _max_planning_time,
     lookup_table_dim,
-    _metadata.number_of_headings);
+    _metadata.number_of_headings,
+    _use_node_pool,
+    _open_list_arity);
 
   // Initialize path smoother
   if (smooth_path) {
@@ -209,8 +256,19 @@ void SmacPlannerLattice::configure(
     _smoother->initialize(_metadata.min_turning_radius);
   }
 
+  // Initialize coarse search of the corridor to search in, if hierarchical
+  if (_hierarchical_downsampling_factor > 1) {
+    _search_corridor = std::make_unique<SearchCorridor>();
+    _search_corridor->on_configure(
+      node, _costmap_ros, _costmap, 1, _hierarchical_downsampling_factor,
+      _hierarchical_use_min_cost, _hierarchical_corridor_width, _search_info.cost_penalty,
+      _allow_unknown, _max_iterations, _terminal_checking_interval, _max_planning_time);
+  }
+
   if (_debug_visualizations) {
-    _expansions_publisher = node->create_publisher<geometry_msgs::msg::PoseArray>("expansions", 1);
+    _expansions_publisher = std::make_unique<ExpansionsPublisher>(
+      node, _global_frame, std::max(_expansions_log_size, 0),
+      std::max(_expansions_log_stride, 1));
     _planned_footprints_publisher = node->create_publisher<visualization_msgs::msg::MarkerArray>(
       "planned_footprints", 1);
   }
@@ -261,7 +319,13 @@ void SmacPlannerLattice::cleanup()
   nav2_smac_planner::NodeHybrid::destroyStaticAssets();
   _a_star.reset();
   _smoother.reset();
+  if (_search_corridor) {
+    _search_corridor->on_cleanup();
+    _search_corridor.reset();
+  }
   _raw_plan_publisher.reset();
+  _expansions_publisher.reset();
+  _planned_footprints_publisher.reset();
 }
 
 nav_msgs::msg::Path SmacPlannerLattice::createPlan(
@@ -288,9 +352,11 @@ nav_msgs::msg::Path SmacPlannerLattice::createPlan(
             "Start Coordinates of(" + std::to_string(start.pose.position.x) + ", " +
             std::to_string(start.pose.position.y) + ") was outside bounds");
   }
-  _a_star->setStart(
-    mx, my,
-    NodeLattice::motion_table.getClosestAngularBin(tf2::getYaw(start.pose.orientation)));
+  const float start_mx = mx;
+  const float start_my = my;
+  const unsigned int start_bin_id =
+    NodeLattice::motion_table.getClosestAngularBin(tf2::getYaw(start.pose.orientation));
+  _a_star->setStart(start_mx, start_my, start_bin_id);
 
   // Set goal point, in A* bin search coordinates
   if (!_costmap->worldToMapContinuous(goal.pose.position.x, goal.pose.position.y, mx, my)) {
@@ -298,9 +364,19 @@ nav_msgs::msg::Path SmacPlannerLattice::createPlan(
             "Goal Coordinates of(" + std::to_string(goal.pose.position.x) + ", " +
             std::to_string(goal.pose.position.y) + ") was outside bounds");
   }
-  _a_star->setGoal(
-    mx, my,
-    NodeLattice::motion_table.getClosestAngularBin(tf2::getYaw(goal.pose.orientation)));
+  const unsigned int goal_bin_id =
+    NodeLattice::motion_table.getClosestAngularBin(tf2::getYaw(goal.pose.orientation));
+  _a_star->setGoal(mx, my, goal_bin_id);
+
+  // Restrict the search to the corridor of a coarse search, if hierarchical
+  bool use_corridor = false;
+  if (_search_corridor) {
+    use_corridor = _search_corridor->update(start_mx, start_my, mx, my, cancel_checker);
+    if (!use_corridor) {
+      RCLCPP_DEBUG(_logger, "Coarse search found no corridor, searching the whole costmap.");
+    }
+  }
+  _a_star->setSearchCorridor(use_corridor ? _search_corridor.get() : nullptr);
 
   // Setup message
   nav_msgs::msg::Path plan;
@@ -318,28 +394,37 @@ nav_msgs::msg::Path SmacPlannerLattice::createPlan(
   NodeLattice::CoordinateVector path;
   int num_iterations = 0;
   std::string error;
-  std::unique_ptr<std::vector<std::tuple<float, float, float>>> expansions = nullptr;
+  ExpansionsLog * expansions = nullptr;
   if (_debug_visualizations) {
-    expansions = std::make_unique<std::vector<std::tuple<float, float, float>>>();
+    expansions = _expansions_publisher->startLog();
   }
 
   // Note: All exceptions thrown are handled by the planner server and returned to the action
-  if (!_a_star->createPath(
+  bool path_found = _a_star->createPath(
+    path, num_iterations,
+    _tolerance / static_cast<float>(_costmap->getResolution()), cancel_checker, expansions);
+  if (!path_found && use_corridor) {
+    // The coarse costmap may hide passages or open ones the robot cannot take
+    RCLCPP_WARN(
+      _logger, "No path found in the corridor of the coarse search, "
+      "searching the whole costmap.");
+    _a_star->setSearchCorridor(nullptr);
+    _a_star->setCollisionChecker(&_collision_checker);
+    _a_star->setStart(start_mx, start_my, start_bin_id);
+    _a_star->setGoal(mx, my, goal_bin_id);
+    num_iterations = 0;
+    if (expansions) {
+      expansions->clear();
+    }
+    path_found = _a_star->createPath(
       path, num_iterations,
-      _tolerance / static_cast<float>(_costmap->getResolution()), cancel_checker, expansions.get()))
-  {
+      _tolerance / static_cast<float>(_costmap->getResolution()), cancel_checker,
+      expansions);
+  }
+
+  if (!path_found) {
     if (_debug_visualizations) {
-      geometry_msgs::msg::PoseArray msg;
-      geometry_msgs::msg::Pose msg_pose;
-      msg.header.stamp = _clock->now();
-      msg.header.frame_id = _global_frame;
-      for (auto & e : *expansions) {
-        msg_pose.position.x = std::get<0>(e);
-        msg_pose.position.y = std::get<1>(e);
-        msg_pose.orientation = getWorldOrientation(std::get<2>(e));
-        msg.poses.push_back(msg_pose);
-      }
-      _expansions_publisher->publish(msg);
+      _expansions_publisher->publish(_clock->now());
     }
 
     // Note: If the start is blocked only one iteration will occur before failure
@@ -381,17 +466,7 @@ nav_msgs::msg::Path SmacPlannerLattice::createPlan(
 
   if (_debug_visualizations) {
     // Publish expansions for debug
-    geometry_msgs::msg::PoseArray msg;
-    geometry_msgs::msg::Pose msg_pose;
-    msg.header.stamp = _clock->now();
-    msg.header.frame_id = _global_frame;
-    for (auto & e : *expansions) {
-      msg_pose.position.x = std::get<0>(e);
-      msg_pose.position.y = std::get<1>(e);
-      msg_pose.orientation = getWorldOrientation(std::get<2>(e));
-      msg.poses.push_back(msg_pose);
-    }
-    _expansions_publisher->publish(msg);
+    _expansions_publisher->publish(_clock->now());
 
     // plot footprint path planned for debug
     if (_planned_footprints_publisher->get_subscription_count() > 0) {
@@ -581,7 +656,18 @@ SmacPlannerLattice::dynamicParametersCallback(std::vector<rclcpp::Parameter> par
         _terminal_checking_interval,
         _max_planning_time,
         lookup_table_dim,
-        _metadata.number_of_headings);
+        _metadata.number_of_headings,
+        _use_node_pool,
+        _open_list_arity);
+
+      // Re-Initialize coarse search, following the search's parameters
+      if (_search_corridor) {
+        auto node = _node.lock();
+        _search_corridor->on_configure(
+          node, _costmap_ros, _costmap, 1, _hierarchical_downsampling_factor,
+          _hierarchical_use_min_cost, _hierarchical_corridor_width, _search_info.cost_penalty,
+          _allow_unknown, _max_iterations, _terminal_checking_interval, _max_planning_time);
+      }
     }
   }
 
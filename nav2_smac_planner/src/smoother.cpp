@@ -12,8 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License. Reserved.
 
-#include <ompl/base/ScopedState.h>
-#include <ompl/base/spaces/DubinsStateSpace.h>
+#include <algorithm>
+#include <future>
 #include <vector>
 #include <memory>
 #include "nav2_smac_planner/smoother.hpp"
@@ -37,7 +37,7 @@ Smoother::Smoother(const SmootherParams & params)
 void Smoother::initialize(const double & min_turning_radius)
 {
   min_turning_rad_ = min_turning_radius;
-  state_space_ = std::make_unique<ompl::base::DubinsStateSpace>(min_turning_rad_);
+  curve_solver_ = CurveSolver(min_turning_rad_, false);
 }
 
 bool Smoother::smooth(
@@ -51,45 +51,64 @@ bool Smoother::smooth(
   }
 
   steady_clock::time_point start = steady_clock::now();
-  double time_remaining = max_time;
-  bool success = true, reversing_segment;
-  nav_msgs::msg::Path curr_path_segment;
-  curr_path_segment.header = path.header;
   std::vector<PathSegment> path_segments = findDirectionalPathSegments(path);
-
-  for (unsigned int i = 0; i != path_segments.size(); i++) {
-    if (path_segments[i].end - path_segments[i].start > 10) {
+  path_segments.erase(
+    std::remove_if(
+      path_segments.begin(), path_segments.end(),
+      [](const PathSegment & segment) {return segment.end - segment.start <= 10;}),
+    path_segments.end());
+
+  // Segments split at cusps only share their fixed end points, so they are smoothed
+  // independently of each other
+  std::vector<nav_msgs::msg::Path> smoothed_segments(path_segments.size());
+  std::vector<char> segments_success(path_segments.size(), false);
+  auto smooth_segment = [&](const unsigned int i) {
       // Populate path segment
-      curr_path_segment.poses.clear();
-      std::copy(
+      nav_msgs::msg::Path & curr_path_segment = smoothed_segments[i];
+      curr_path_segment.header = path.header;
+      curr_path_segment.poses.assign(
         path.poses.begin() + path_segments[i].start,
-        path.poses.begin() + path_segments[i].end + 1,
-        std::back_inserter(curr_path_segment.poses));
+        path.poses.begin() + path_segments[i].end + 1);
 
       // Make sure we're still able to smooth with time remaining
       steady_clock::time_point now = steady_clock::now();
-      time_remaining = max_time - duration_cast<duration<double>>(now - start).count();
-      refinement_ctr_ = 0;
+      double time_remaining = max_time - duration_cast<duration<double>>(now - start).count();
 
       // Smooth path segment naively
+      bool reversing_segment;
       const geometry_msgs::msg::Pose start_pose = curr_path_segment.poses.front().pose;
       const geometry_msgs::msg::Pose goal_pose = curr_path_segment.poses.back().pose;
       bool local_success =
         smoothImpl(curr_path_segment, reversing_segment, costmap, time_remaining);
-      success = success && local_success;
+      segments_success[i] = local_success;
 
       // Enforce boundary conditions
       if (!is_holonomic_ && local_success) {
         enforceStartBoundaryConditions(start_pose, curr_path_segment, costmap, reversing_segment);
         enforceEndBoundaryConditions(goal_pose, curr_path_segment, costmap, reversing_segment);
       }
+    };
 
-      // Assemble the path changes to the main path
-      std::copy(
-        curr_path_segment.poses.begin(),
-        curr_path_segment.poses.end(),
-        path.poses.begin() + path_segments[i].start);
-    }
+  std::vector<std::future<void>> smoothings;
+  for (unsigned int i = 1; i < path_segments.size(); i++) {
+    smoothings.push_back(std::async(std::launch::async, smooth_segment, i));
+  }
+  if (!path_segments.empty()) {
+    smooth_segment(0);
+  }
+  for (auto & smoothing : smoothings) {
+    smoothing.get();
+  }
+
+  // Assemble the path changes to the main path, in order so that the poses shared
+  // by two segments are those of the later one
+  bool success = true;
+  for (unsigned int i = 0; i != path_segments.size(); i++) {
+    success = success && segments_success[i];
+    std::copy(
+      smoothed_segments[i].poses.begin(),
+      smoothed_segments[i].poses.end(),
+      path.poses.begin() + path_segments[i].start);
   }
 
   return success;
@@ -101,117 +120,120 @@ bool Smoother::smoothImpl(
   const nav2_costmap_2d::Costmap2D * costmap,
   const double & max_time)
 {
-  steady_clock::time_point a = steady_clock::now();
   rclcpp::Duration max_dur = rclcpp::Duration::from_seconds(max_time);
 
-  int its = 0;
-  double change = tolerance_;
-  const unsigned int & path_size = path.poses.size();
-  double x_i, y_i, y_m1, y_ip1, y_i_org;
-  unsigned int mx, my;
-
-  nav_msgs::msg::Path new_path = path;
-  nav_msgs::msg::Path last_path = path;
-
-  while (change >= tolerance_) {
-    its += 1;
-    change = 0.0;
-
-    // Make sure the smoothing function will converge
-    if (its >= max_its_) {
-      RCLCPP_DEBUG(
-        rclcpp::get_logger("SmacPlannerSmoother"),
-        "Number of iterations has exceeded limit of %i.", max_its_);
-      path = last_path;
-      updateApproximatePathOrientations(path, reversing_segment);
-      return false;
+  // Data positions to be attracted to, smoothed positions and those of the last
+  // collision free sweep
+  SmoothingBuffer data, smoothed, last;
+  data.fromPath(path);
+  smoothed.fromPath(path);
+  last.fromPath(path);
+
+  // Refinement passes smooth again the positions converged to, which shouldn't take more
+  // than a couple milliseconds but really puts the path quality over the top.
+  bool success = true;
+  const int num_passes = do_refinement_ ? refinement_num_ + 1 : 1;
+  for (int pass = 0; pass != num_passes; pass++) {
+    if (pass > 0) {
+      data.assign(smoothed);
     }
 
-    // Make sure still have time left to process
-    steady_clock::time_point b = steady_clock::now();
-    rclcpp::Duration timespan(duration_cast<duration<double>>(b - a));
-    if (timespan > max_dur) {
-      RCLCPP_DEBUG(
-        rclcpp::get_logger("SmacPlannerSmoother"),
-        "Smoothing time exceeded allowed duration of %0.2f.", max_time);
-      path = last_path;
-      updateApproximatePathOrientations(path, reversing_segment);
-      return false;
-    }
+    steady_clock::time_point a = steady_clock::now();
+    int its = 0;
+    double change = tolerance_;
+    bool converged = true;
+    while (change >= tolerance_) {
+      its += 1;
+      change = 0.0;
 
-    for (unsigned int i = 1; i != path_size - 1; i++) {
-      for (unsigned int j = 0; j != 2; j++) {
-        x_i = getFieldByDim(path.poses[i], j);
-        y_i = getFieldByDim(new_path.poses[i], j);
-        y_m1 = getFieldByDim(new_path.poses[i - 1], j);
-        y_ip1 = getFieldByDim(new_path.poses[i + 1], j);
-        y_i_org = y_i;
-
-        // Smooth based on local 3 point neighborhood and original data locations
-        y_i += data_w_ * (x_i - y_i) + smooth_w_ * (y_ip1 + y_m1 - (2.0 * y_i));
-        setFieldByDim(new_path.poses[i], j, y_i);
-        change += abs(y_i - y_i_org);
+      // Make sure the smoothing function will converge
+      if (its >= max_its_) {
+        RCLCPP_DEBUG(
+          rclcpp::get_logger("SmacPlannerSmoother"),
+          "Number of iterations has exceeded limit of %i.", max_its_);
+        converged = false;
+        break;
       }
 
-      // validate update is admissible, only checks cost if a valid costmap pointer is provided
-      float cost = 0.0;
-      if (costmap) {
-        costmap->worldToMap(
-          getFieldByDim(new_path.poses[i], 0),
-          getFieldByDim(new_path.poses[i], 1),
-          mx, my);
-        cost = static_cast<float>(costmap->getCost(mx, my));
+      // Make sure still have time left to process
+      steady_clock::time_point b = steady_clock::now();
+      rclcpp::Duration timespan(duration_cast<duration<double>>(b - a));
+      if (timespan > max_dur) {
+        RCLCPP_DEBUG(
+          rclcpp::get_logger("SmacPlannerSmoother"),
+          "Smoothing time exceeded allowed duration of %0.2f.", max_time);
+        converged = false;
+        break;
       }
 
-      if (cost > MAX_NON_OBSTACLE && cost != UNKNOWN) {
+      // Smooth based on local 3 point neighborhood and original data locations,
+      // odd points first and then even points using the odd points just updated
+      for (unsigned int first = 1; first != 3; first++) {
+        change += smoothingStep(data.x, smoothed.x, first);
+        change += smoothingStep(data.y, smoothed.y, first);
+      }
+
+      // validate update is admissible, only checks cost if a valid costmap pointer is provided
+      if (!isCollisionFree(smoothed, costmap)) {
         RCLCPP_DEBUG(
           rclcpp::get_logger("SmacPlannerSmoother"),
           "Smoothing process resulted in an infeasible collision. "
           "Returning the last path before the infeasibility was introduced.");
-        path = last_path;
-        updateApproximatePathOrientations(path, reversing_segment);
-        return false;
+        converged = false;
+        break;
       }
-    }
 
-    last_path = new_path;
-  }
+      last.assign(smoothed);
+    }
 
-  // Lets do additional refinement, it shouldn't take more than a couple milliseconds
-  // but really puts the path quality over the top.
-  if (do_refinement_ && refinement_ctr_ < refinement_num_) {
-    refinement_ctr_++;
-    smoothImpl(new_path, reversing_segment, costmap, max_time);
+    // A refinement pass not converging keeps the positions of its last collision free sweep
+    if (!converged) {
+      success = pass > 0;
+      break;
+    }
   }
 
-  updateApproximatePathOrientations(new_path, reversing_segment);
-  path = new_path;
-  return true;
+  last.toPath(path);
+  updateApproximatePathOrientations(path, reversing_segment);
+  return success;
 }
 
-double Smoother::getFieldByDim(
-  const geometry_msgs::msg::PoseStamped & msg, const unsigned int & dim)
+double Smoother::smoothingStep(
+  const std::vector<double> & data,
+  std::vector<double> & smoothed,
+  const unsigned int & first) const
 {
-  if (dim == 0) {
-    return msg.pose.position.x;
-  } else if (dim == 1) {
-    return msg.pose.position.y;
-  } else {
-    return msg.pose.position.z;
+  const double * x = data.data();
+  double * y = smoothed.data();
+  const size_t end = smoothed.size() - 1;
+  double change = 0.0;
+  for (size_t i = first; i < end; i += 2) {
+    const double delta = data_w_ * (x[i] - y[i]) + smooth_w_ * (y[i + 1] + y[i - 1] - 2.0 * y[i]);
+    y[i] += delta;
+    change += std::fabs(delta);
   }
+  return change;
 }
 
-void Smoother::setFieldByDim(
-  geometry_msgs::msg::PoseStamped & msg, const unsigned int dim,
-  const double & value)
+bool Smoother::isCollisionFree(
+  const SmoothingBuffer & smoothed,
+  const nav2_costmap_2d::Costmap2D * costmap) const
 {
-  if (dim == 0) {
-    msg.pose.position.x = value;
-  } else if (dim == 1) {
-    msg.pose.position.y = value;
-  } else {
-    msg.pose.position.z = value;
+  if (!costmap) {
+    return true;
   }
+
+  unsigned int mx, my;
+  for (unsigned int i = 1; i + 1 < smoothed.x.size(); i++) {
+    if (!costmap->worldToMap(smoothed.x[i], smoothed.y[i], mx, my)) {
+      return false;
+    }
+    float cost = static_cast<float>(costmap->getCost(mx, my));
+    if (cost > MAX_NON_OBSTACLE && cost != UNKNOWN) {
+      return false;
+    }
+  }
+  return true;
 }
 
 std::vector<PathSegment> Smoother::findDirectionalPathSegments(const nav_msgs::msg::Path & path)
@@ -328,16 +350,11 @@ void Smoother::findBoundaryExpansion(
   BoundaryExpansion & expansion,
   const nav2_costmap_2d::Costmap2D * costmap)
 {
-  static ompl::base::ScopedState<> from(state_space_), to(state_space_), s(state_space_);
-
-  from[0] = start.position.x;
-  from[1] = start.position.y;
-  from[2] = tf2::getYaw(start.orientation);
-  to[0] = end.position.x;
-  to[1] = end.position.y;
-  to[2] = tf2::getYaw(end.orientation);
+  const CurvePose from{start.position.x, start.position.y, tf2::getYaw(start.orientation)};
+  const CurvePose to{end.position.x, end.position.y, tf2::getYaw(end.orientation)};
+  const CurvePath curve = curve_solver_.solve(from, to);
 
-  double d = state_space_->distance(from(), to());
+  double d = curve_solver_.getTurningRadius() * curve.length;
   // If this path is too long compared to the original, then this is probably
   // a loop-de-loop, treat as invalid as to not deviate too far from the original path.
   // 2.0 selected from prinicipled choice of boundary test points
@@ -349,20 +366,19 @@ void Smoother::findBoundaryExpansion(
     return;
   }
 
-  std::vector<double> reals;
+  CurvePose s;
   double theta(0.0), x(0.0), y(0.0);
   double x_m = start.position.x;
   double y_m = start.position.y;
 
   // Get intermediary poses
   for (double i = 0; i <= expansion.path_end_idx; i++) {
-    state_space_->interpolate(from(), to(), i / expansion.path_end_idx, s());
-    reals = s.reals();
+    s = curve_solver_.interpolate(curve, from, to, i / expansion.path_end_idx);
     // Make sure in range [0, 2PI)
-    theta = (reals[2] < 0.0) ? (reals[2] + 2.0 * M_PI) : reals[2];
+    theta = (s.theta < 0.0) ? (s.theta + 2.0 * M_PI) : s.theta;
     theta = (theta > 2.0 * M_PI) ? (theta - 2.0 * M_PI) : theta;
-    x = reals[0];
-    y = reals[1];
+    x = s.x;
+    y = s.y;
 
     // Check for collision
     unsigned int mx, my;
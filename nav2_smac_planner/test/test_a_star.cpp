@@ -138,6 +138,20 @@ TEST(AStarTest, test_a_star_2d)
   EXPECT_EQ(a_star_2.getToleranceHeuristic(), 20.0);
   EXPECT_EQ(a_star_2.getOnApproachMaxIterations(), 10);
 
+  // goal set, the search stops at the closest goal reached
+  path.clear();
+  num_it = 0;
+  a_star.setCollisionChecker(checker.get());
+  a_star.setStart(20u, 20u, 0);
+  a_star.setGoal(80u, 80u, 0);
+  a_star.addGoal(25u, 30u, 0);
+  EXPECT_TRUE(a_star.createPath(path, num_it, tolerance, dummy_cancel_checker));
+  ASSERT_FALSE(path.empty());
+  EXPECT_EQ(path.front().x, 25.0f);
+  EXPECT_EQ(path.front().y, 30.0f);
+  EXPECT_LT(path.size(), 82u);
+  EXPECT_THROW(a_star.addGoal(0, 0, 10), std::runtime_error);
+
   delete costmapA;
 }
 
@@ -191,14 +205,13 @@ TEST(AStarTest, test_a_star_se2)
   a_star.setStart(10u, 10u, 0u);
   a_star.setGoal(80u, 80u, 40u);
   nav2_smac_planner::NodeHybrid::CoordinateVector path;
-  std::unique_ptr<std::vector<std::tuple<float, float, float>>> expansions = nullptr;
-  expansions = std::make_unique<std::vector<std::tuple<float, float, float>>>();
+  nav2_smac_planner::ExpansionsLog expansions(100000);
 
   auto dummy_cancel_checker = []() {
       return false;
     };
 
-  EXPECT_TRUE(a_star.createPath(path, num_it, tolerance, dummy_cancel_checker, expansions.get()));
+  EXPECT_TRUE(a_star.createPath(path, num_it, tolerance, dummy_cancel_checker, &expansions));
 
   // check path is the right size and collision free
   EXPECT_EQ(num_it, 3146);
@@ -212,7 +225,319 @@ TEST(AStarTest, test_a_star_se2)
   }
 
   // Expansions properly recorded
-  EXPECT_GT(expansions->size(), 5u);
+  EXPECT_GT(expansions.size(), 5u);
+  EXPECT_EQ(expansions.size(), expansions.getNumExpansions());
+
+  delete costmapA;
+  nav2_smac_planner::NodeHybrid::destroyStaticAssets();
+}
+
+TEST(AStarTest, test_a_star_se2_node_pool)
+{
+  auto lnode = std::make_shared<rclcpp_lifecycle::LifecycleNode>("test");
+  nav2_smac_planner::SearchInfo info;
+  info.change_penalty = 0.1;
+  info.non_straight_penalty = 1.1;
+  info.reverse_penalty = 2.0;
+  info.minimum_turning_radius = 8;  // in grid coordinates
+  info.retrospective_penalty = 0.015;
+  info.analytic_expansion_max_length = 20.0;  // in grid coordinates
+  info.analytic_expansion_ratio = 3.5;
+  unsigned int size_theta = 72;
+  info.cost_penalty = 1.7;
+  nav2_smac_planner::AStarAlgorithm<nav2_smac_planner::NodeHybrid> a_star(
+    nav2_smac_planner::MotionModel::DUBIN, info);
+  int max_iterations = 10000;
+  float tolerance = 10.0;
+  int it_on_approach = 10;
+  int terminal_checking_interval = 5000;
+  double max_planning_time = 120.0;
+
+  a_star.initialize(
+    false, max_iterations, it_on_approach, terminal_checking_interval,
+    max_planning_time, 401, size_theta, true);
+
+  nav2_costmap_2d::Costmap2D * costmapA =
+    new nav2_costmap_2d::Costmap2D(100, 100, 0.1, 0.0, 0.0, 0);
+  // island in the middle of lethal cost to cross
+  for (unsigned int i = 40; i <= 60; ++i) {
+    for (unsigned int j = 40; j <= 60; ++j) {
+      costmapA->setCost(i, j, 254);
+    }
+  }
+
+  // Convert raw costmap into a costmap ros object
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>();
+  costmap_ros->on_configure(rclcpp_lifecycle::State());
+  auto costmap = costmap_ros->getCostmap();
+  *costmap = *costmapA;
+
+  std::unique_ptr<nav2_smac_planner::GridCollisionChecker> checker =
+    std::make_unique<nav2_smac_planner::GridCollisionChecker>(costmap_ros, size_theta, lnode);
+  checker->setFootprint(nav2_costmap_2d::Footprint(), true, 0.0);
+
+  auto dummy_cancel_checker = []() {
+      return false;
+    };
+
+  // Same search as with the hash map graph, also when reusing the nodes of a previous plan
+  for (int plan = 0; plan < 2; plan++) {
+    a_star.setCollisionChecker(checker.get());
+    a_star.setStart(10u, 10u, 0u);
+    a_star.setGoal(80u, 80u, 40u);
+    nav2_smac_planner::NodeHybrid::CoordinateVector path;
+    int num_it = 0;
+    EXPECT_TRUE(a_star.createPath(path, num_it, tolerance, dummy_cancel_checker));
+    EXPECT_EQ(num_it, 3146);
+    EXPECT_EQ(path.size(), 63u);
+    for (unsigned int i = 0; i != path.size(); i++) {
+      EXPECT_EQ(costmapA->getCost(path[i].x, path[i].y), 0);
+    }
+  }
+
+  delete costmapA;
+  nav2_smac_planner::NodeHybrid::destroyStaticAssets();
+}
+
+TEST(AStarTest, test_a_star_se2_anytime)
+{
+  auto lnode = std::make_shared<rclcpp_lifecycle::LifecycleNode>("test");
+  nav2_smac_planner::SearchInfo info;
+  info.change_penalty = 0.1;
+  info.non_straight_penalty = 1.1;
+  info.reverse_penalty = 2.0;
+  info.minimum_turning_radius = 8;  // in grid coordinates
+  info.retrospective_penalty = 0.015;
+  info.analytic_expansion_max_length = 20.0;  // in grid coordinates
+  info.analytic_expansion_ratio = 3.5;
+  info.anytime_heuristic_weight = 3.0;
+  info.anytime_weight_step = 1.0;
+  unsigned int size_theta = 72;
+  info.cost_penalty = 1.7;
+  int max_iterations = 10000;
+  float tolerance = 10.0;
+  int it_on_approach = 10;
+  int terminal_checking_interval = 5000;
+  double max_planning_time = 120.0;
+
+  nav2_costmap_2d::Costmap2D * costmapA =
+    new nav2_costmap_2d::Costmap2D(100, 100, 0.1, 0.0, 0.0, 0);
+  // island in the middle of lethal cost to cross
+  for (unsigned int i = 40; i <= 60; ++i) {
+    for (unsigned int j = 40; j <= 60; ++j) {
+      costmapA->setCost(i, j, 254);
+    }
+  }
+
+  // Convert raw costmap into a costmap ros object
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>();
+  costmap_ros->on_configure(rclcpp_lifecycle::State());
+  auto costmap = costmap_ros->getCostmap();
+  *costmap = *costmapA;
+
+  std::unique_ptr<nav2_smac_planner::GridCollisionChecker> checker =
+    std::make_unique<nav2_smac_planner::GridCollisionChecker>(costmap_ros, size_theta, lnode);
+  checker->setFootprint(nav2_costmap_2d::Footprint(), true, 0.0);
+
+  auto dummy_cancel_checker = []() {
+      return false;
+    };
+
+  // Without refinement time the first path of the weighted search is returned,
+  // found in fewer iterations than the unweighted search's 3146
+  std::vector<int> iterations;
+  for (const double refinement_time : {0.0, 60.0}) {
+    info.anytime_refinement_time = refinement_time;
+    nav2_smac_planner::AStarAlgorithm<nav2_smac_planner::NodeHybrid> a_star(
+      nav2_smac_planner::MotionModel::DUBIN, info);
+    a_star.initialize(
+      false, max_iterations, it_on_approach, terminal_checking_interval,
+      max_planning_time, 401, size_theta);
+    a_star.setCollisionChecker(checker.get());
+    a_star.setStart(10u, 10u, 0u);
+    a_star.setGoal(80u, 80u, 40u);
+    nav2_smac_planner::NodeHybrid::CoordinateVector path;
+    int num_it = 0;
+    EXPECT_TRUE(a_star.createPath(path, num_it, tolerance, dummy_cancel_checker));
+    iterations.push_back(num_it);
+
+    EXPECT_GT(path.size(), 1u);
+    for (unsigned int i = 0; i != path.size(); i++) {
+      EXPECT_EQ(costmapA->getCost(path[i].x, path[i].y), 0);
+    }
+    // Path ends at the start and in the goal's cell
+    EXPECT_NEAR(path.back().x, 10.0, 0.01);
+    EXPECT_NEAR(path.back().y, 10.0, 0.01);
+    EXPECT_NEAR(path.front().x, 80.0, 1.0);
+    EXPECT_NEAR(path.front().y, 80.0, 1.0);
+    EXPECT_GE(a_star.getSuboptimalityBound(), 1.0f);
+  }
+  EXPECT_LT(iterations[0], 3146);
+  EXPECT_GT(iterations[1], iterations[0]);
+
+  delete costmapA;
+  nav2_smac_planner::NodeHybrid::destroyStaticAssets();
+}
+
+TEST(AStarTest, test_a_star_se2_async_analytic_expansion)
+{
+  auto lnode = std::make_shared<rclcpp_lifecycle::LifecycleNode>("test");
+  nav2_smac_planner::SearchInfo info;
+  info.change_penalty = 0.1;
+  info.non_straight_penalty = 1.1;
+  info.reverse_penalty = 2.0;
+  info.minimum_turning_radius = 8;  // in grid coordinates
+  info.retrospective_penalty = 0.015;
+  info.analytic_expansion_max_length = 20.0;  // in grid coordinates
+  info.analytic_expansion_ratio = 3.5;
+  info.analytic_expansion_candidates = 3;
+  unsigned int size_theta = 72;
+  info.cost_penalty = 1.7;
+  nav2_smac_planner::AStarAlgorithm<nav2_smac_planner::NodeHybrid> a_star(
+    nav2_smac_planner::MotionModel::DUBIN, info);
+  int max_iterations = 10000;
+  float tolerance = 10.0;
+  int it_on_approach = 10;
+  int terminal_checking_interval = 5000;
+  double max_planning_time = 120.0;
+
+  a_star.initialize(
+    false, max_iterations, it_on_approach, terminal_checking_interval,
+    max_planning_time, 401, size_theta);
+
+  nav2_costmap_2d::Costmap2D * costmapA =
+    new nav2_costmap_2d::Costmap2D(100, 100, 0.1, 0.0, 0.0, 0);
+  // island in the middle of lethal cost to cross
+  for (unsigned int i = 40; i <= 60; ++i) {
+    for (unsigned int j = 40; j <= 60; ++j) {
+      costmapA->setCost(i, j, 254);
+    }
+  }
+
+  // Convert raw costmap into a costmap ros object
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>();
+  costmap_ros->on_configure(rclcpp_lifecycle::State());
+  auto costmap = costmap_ros->getCostmap();
+  *costmap = *costmapA;
+
+  std::unique_ptr<nav2_smac_planner::GridCollisionChecker> checker =
+    std::make_unique<nav2_smac_planner::GridCollisionChecker>(costmap_ros, size_theta, lnode);
+  checker->setFootprint(nav2_costmap_2d::Footprint(), true, 0.0);
+
+  auto dummy_cancel_checker = []() {
+      return false;
+    };
+
+  // The iterations depend on when the helper thread finishes, so only the
+  // path is checked, over a few plans reusing the same expander
+  a_star.setCollisionChecker(checker.get());
+  for (unsigned int plan = 0; plan != 3; plan++) {
+    a_star.setStart(10u, 10u, 0u);
+    a_star.setGoal(80u, 80u, 40u);
+    nav2_smac_planner::NodeHybrid::CoordinateVector path;
+    int num_it = 0;
+    EXPECT_TRUE(a_star.createPath(path, num_it, tolerance, dummy_cancel_checker));
+
+    EXPECT_GT(path.size(), 1u);
+    for (unsigned int i = 0; i != path.size(); i++) {
+      EXPECT_EQ(costmapA->getCost(path[i].x, path[i].y), 0);
+    }
+    // no skipped nodes
+    for (unsigned int i = 1; i != path.size(); i++) {
+      EXPECT_LT(hypotf(path[i].x - path[i - 1].x, path[i].y - path[i - 1].y), 2.1f);
+    }
+    // Path ends at the start and in the goal's cell
+    EXPECT_NEAR(path.back().x, 10.0, 0.01);
+    EXPECT_NEAR(path.back().y, 10.0, 0.01);
+    EXPECT_NEAR(path.front().x, 80.0, 1.0);
+    EXPECT_NEAR(path.front().y, 80.0, 1.0);
+  }
+
+  delete costmapA;
+  nav2_smac_planner::NodeHybrid::destroyStaticAssets();
+}
+
+TEST(AStarTest, test_a_star_se2_partial_paths)
+{
+  auto lnode = std::make_shared<rclcpp_lifecycle::LifecycleNode>("test");
+  nav2_smac_planner::SearchInfo info;
+  info.change_penalty = 0.1;
+  info.non_straight_penalty = 1.1;
+  info.reverse_penalty = 2.0;
+  info.minimum_turning_radius = 8;  // in grid coordinates
+  info.retrospective_penalty = 0.015;
+  info.analytic_expansion_max_length = 20.0;  // in grid coordinates
+  info.analytic_expansion_ratio = 3.5;
+  unsigned int size_theta = 72;
+  info.cost_penalty = 1.7;
+  nav2_smac_planner::AStarAlgorithm<nav2_smac_planner::NodeHybrid> a_star(
+    nav2_smac_planner::MotionModel::DUBIN, info);
+  int max_iterations = 10000;
+  float tolerance = 10.0;
+  int it_on_approach = 10;
+  // Check often, so that the search streams several partial paths
+  int terminal_checking_interval = 100;
+  double max_planning_time = 120.0;
+  int num_it = 0;
+
+  a_star.initialize(
+    false, max_iterations, it_on_approach, terminal_checking_interval,
+    max_planning_time, 401, size_theta);
+
+  nav2_costmap_2d::Costmap2D * costmapA =
+    new nav2_costmap_2d::Costmap2D(100, 100, 0.1, 0.0, 0.0, 0);
+  // island in the middle of lethal cost to cross
+  for (unsigned int i = 40; i <= 60; ++i) {
+    for (unsigned int j = 40; j <= 60; ++j) {
+      costmapA->setCost(i, j, 254);
+    }
+  }
+
+  // Convert raw costmap into a costmap ros object
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>();
+  costmap_ros->on_configure(rclcpp_lifecycle::State());
+  auto costmap = costmap_ros->getCostmap();
+  *costmap = *costmapA;
+
+  std::unique_ptr<nav2_smac_planner::GridCollisionChecker> checker =
+    std::make_unique<nav2_smac_planner::GridCollisionChecker>(costmap_ros, size_theta, lnode);
+  checker->setFootprint(nav2_costmap_2d::Footprint(), true, 0.0);
+
+  a_star.setCollisionChecker(checker.get());
+  a_star.setStart(10u, 10u, 0u);
+  a_star.setGoal(80u, 80u, 40u);
+  nav2_smac_planner::NodeHybrid::CoordinateVector path;
+
+  // Partial paths run back to the start and are collision free
+  unsigned int num_partial_paths = 0;
+  a_star.setPartialPathCallback(
+    [&](const nav2_smac_planner::NodeHybrid::CoordinateVector & partial_path)
+    {
+      num_partial_paths++;
+      ASSERT_FALSE(partial_path.empty());
+      EXPECT_NEAR(partial_path.back().x, 10.0, 0.01);
+      EXPECT_NEAR(partial_path.back().y, 10.0, 0.01);
+      for (unsigned int i = 0; i != partial_path.size(); i++) {
+        EXPECT_EQ(costmapA->getCost(partial_path[i].x, partial_path[i].y), 0);
+      }
+    }, 1e-9);
+
+  auto dummy_cancel_checker = []() {
+      return false;
+    };
+
+  EXPECT_TRUE(a_star.createPath(path, num_it, tolerance, dummy_cancel_checker));
+  EXPECT_GT(num_partial_paths, 1u);
+
+  // No partial paths once streaming is disabled
+  num_partial_paths = 0;
+  a_star.setPartialPathCallback(nullptr, 0.0);
+  a_star.setStart(10u, 10u, 0u);
+  a_star.setGoal(80u, 80u, 40u);
+  path.clear();
+  num_it = 0;
+  EXPECT_TRUE(a_star.createPath(path, num_it, tolerance, dummy_cancel_checker));
+  EXPECT_EQ(num_partial_paths, 0u);
 
   delete costmapA;
   nav2_smac_planner::NodeHybrid::destroyStaticAssets();
@@ -373,3 +698,29 @@ TEST(AStarTest, test_constants)
       "REEDS_SHEPP"), nav2_smac_planner::MotionModel::REEDS_SHEPP);
   EXPECT_EQ(nav2_smac_planner::fromString("NONE"), nav2_smac_planner::MotionModel::UNKNOWN);
 }
+
+TEST(AStarTest, test_expansions_log)
+{
+  // Logs one expansion in 3, keeping the last 4
+  nav2_smac_planner::ExpansionsLog log(4, 3);
+  for (int i = 0; i != 20; i++) {
+    log.add(static_cast<float>(i), 0.0f, 0.0f);
+  }
+  EXPECT_EQ(log.getNumExpansions(), 20u);
+  ASSERT_EQ(log.size(), 4u);
+  EXPECT_EQ(log[0].x, 9.0f);
+  EXPECT_EQ(log[1].x, 12.0f);
+  EXPECT_EQ(log[2].x, 15.0f);
+  EXPECT_EQ(log[3].x, 18.0f);
+
+  nav2_smac_planner::ExpansionsLog other(4, 3);
+  log.swap(other);
+  EXPECT_EQ(log.size(), 0u);
+  EXPECT_EQ(other[3].x, 18.0f);
+
+  other.clear();
+  other.add(1.0f, 2.0f, 3.0f);
+  ASSERT_EQ(other.size(), 1u);
+  EXPECT_EQ(other[0].y, 2.0f);
+  EXPECT_EQ(other[0].theta, 3.0f);
+}
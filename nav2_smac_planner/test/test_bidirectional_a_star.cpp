@@ -0,0 +1,153 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <math.h>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "rclcpp/rclcpp.hpp"
+#include "nav2_costmap_2d/costmap_2d.hpp"
+#include "nav2_costmap_2d/costmap_2d_ros.hpp"
+#include "nav2_smac_planner/a_star.hpp"
+#include "nav2_smac_planner/bidirectional_a_star.hpp"
+#include "nav2_smac_planner/collision_checker.hpp"
+
+class RclCppFixture
+{
+public:
+  RclCppFixture() {rclcpp::init(0, nullptr);}
+  ~RclCppFixture() {rclcpp::shutdown();}
+};
+RclCppFixture g_rclcppfixture;
+
+using nav2_smac_planner::Node2D;
+using Outcome = nav2_smac_planner::BidirectionalAStar::Outcome;
+
+// Travel cost of a path given from the goal to the start, as in Node2D
+float pathCost(const Node2D::CoordinateVector & path, nav2_costmap_2d::Costmap2D * costmap)
+{
+  float cost = 0.0f;
+  for (unsigned int i = 0; i + 1 < path.size(); i++) {
+    const float dx = path[i].x - path[i + 1].x;
+    const float dy = path[i].y - path[i + 1].y;
+    EXPECT_LE(fabs(dx), 1.0f);
+    EXPECT_LE(fabs(dy), 1.0f);
+    const float length = dx * dx + dy * dy > 1.05f ? sqrtf(2.0f) : 1.0f;
+    cost += length * (1.0f + 2.0f * costmap->getCost(path[i].x, path[i].y) / 252.0f);
+  }
+  return cost;
+}
+
+bool aStarPath(
+  nav2_smac_planner::GridCollisionChecker * checker,
+  unsigned int start_x, unsigned int start_y, unsigned int goal_x, unsigned int goal_y,
+  Node2D::CoordinateVector & path, int & num_it)
+{
+  nav2_smac_planner::SearchInfo info;
+  info.cost_penalty = 2.0;
+  nav2_smac_planner::AStarAlgorithm<Node2D> a_star(nav2_smac_planner::MotionModel::TWOD, info);
+  int max_iterations = 100000;
+  a_star.initialize(false, max_iterations, 10, 5000, 120.0, 0.0, 1);
+  a_star.setCollisionChecker(checker);
+  a_star.setStart(start_x, start_y, 0);
+  a_star.setGoal(goal_x, goal_y, 0);
+  num_it = 0;
+  return a_star.createPath(path, num_it, 0.0, []() {return false;});
+}
+
+TEST(BidirectionalAStarTest, test_bidirectional_a_star)
+{
+  auto lnode = std::make_shared<rclcpp_lifecycle::LifecycleNode>("test");
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>();
+  costmap_ros->on_configure(rclcpp_lifecycle::State());
+  auto costmap = costmap_ros->getCostmap();
+  *costmap = nav2_costmap_2d::Costmap2D(100, 100, 0.1, 0.0, 0.0, 0);
+  // island in the middle of lethal cost to cross, with some cost around it
+  for (unsigned int i = 35; i <= 65; ++i) {
+    for (unsigned int j = 35; j <= 65; ++j) {
+      costmap->setCost(i, j, i < 40 || i > 60 || j < 40 || j > 60 ? 100 : 254);
+    }
+  }
+
+  nav2_smac_planner::GridCollisionChecker checker(costmap_ros, 1, lnode);
+  checker.setFootprint(nav2_costmap_2d::Footprint(), true, 0.0);
+
+  nav2_smac_planner::BidirectionalAStar search;
+  search.initialize(false, 100000, 5000, 120.0, 2.0);
+  search.setCollisionChecker(&checker);
+  search.setStart(20u, 20u);
+  search.setGoal(80u, 80u);
+
+  // Same cost as A*
+  Node2D::CoordinateVector path, a_star_path;
+  int num_it = 0, a_star_num_it = 0;
+  EXPECT_EQ(search.createPath(path, num_it, []() {return false;}), Outcome::PATH_FOUND);
+  EXPECT_GT(num_it, 0);
+  EXPECT_EQ(path.front().x, 80.0f);
+  EXPECT_EQ(path.front().y, 80.0f);
+  EXPECT_EQ(path.back().x, 20.0f);
+  EXPECT_EQ(path.back().y, 20.0f);
+  EXPECT_TRUE(aStarPath(&checker, 20, 20, 80, 80, a_star_path, a_star_num_it));
+  EXPECT_NEAR(pathCost(path, costmap), pathCost(a_star_path, costmap), 1e-3);
+
+  // A goal walled in is found unreachable once its frontier runs out of cells,
+  // while A* expands all the rest of the map
+  for (unsigned int i = 75; i <= 85; ++i) {
+    costmap->setCost(i, 75, 254);
+    costmap->setCost(i, 85, 254);
+    costmap->setCost(75, i, 254);
+    costmap->setCost(85, i, 254);
+  }
+  num_it = 0;
+  EXPECT_EQ(search.createPath(path, num_it, []() {return false;}), Outcome::NO_PATH);
+  EXPECT_FALSE(aStarPath(&checker, 20, 20, 80, 80, a_star_path, a_star_num_it));
+  EXPECT_LT(num_it * 10, a_star_num_it);
+
+  // Goal occupied
+  search.setGoal(75u, 75u);
+  num_it = 0;
+  EXPECT_EQ(search.createPath(path, num_it, []() {return false;}), Outcome::GOAL_OCCUPIED);
+
+  // Start with no traversable neighbor
+  for (unsigned int i = 9; i <= 11; ++i) {
+    for (unsigned int j = 9; j <= 11; ++j) {
+      costmap->setCost(i, j, i == 10 && j == 10 ? 0 : 254);
+    }
+  }
+  search.setStart(10u, 10u);
+  search.setGoal(20u, 20u);
+  num_it = 0;
+  EXPECT_EQ(search.createPath(path, num_it, []() {return false;}), Outcome::START_BLOCKED);
+
+  // Start on the goal
+  search.setStart(20u, 20u);
+  num_it = 0;
+  EXPECT_EQ(search.createPath(path, num_it, []() {return false;}), Outcome::PATH_FOUND);
+  EXPECT_EQ(path.size(), 1u);
+
+  // Running out of iterations
+  search.setGoal(10u, 90u);
+  search.getMaxIterations() = 10;
+  num_it = 0;
+  EXPECT_EQ(search.createPath(path, num_it, []() {return false;}), Outcome::LIMIT_REACHED);
+  EXPECT_EQ(num_it, 10);
+  search.getMaxIterations() = 100000;
+
+  // Cancellation is checked
+  num_it = 0;
+  EXPECT_THROW(
+    search.createPath(path, num_it, []() {return true;}), nav2_core::PlannerCancelled);
+}
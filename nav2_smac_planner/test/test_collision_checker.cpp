@@ -13,6 +13,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cmath>
 #include <string>
 #include <vector>
 #include <memory>
@@ -213,3 +214,202 @@ TEST(collision_footprint, test_point_and_line_cost)
   EXPECT_NEAR(right_value, 254.0, 0.001);
   delete costmap_;
 }
+
+TEST(collision_footprint, test_footprint_kernels_match_outline)
+{
+  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("testF");
+  nav2_costmap_2d::Costmap2D * costmap_ = new nav2_costmap_2d::Costmap2D(
+    100, 100, 0.05, 0, 0.0, 0);
+  for (unsigned int i = 0; i != 100; ++i) {
+    for (unsigned int j = 0; j != 100; ++j) {
+      costmap_->setCost(i, j, (i * 7 + j * 13) % 200);
+    }
+  }
+  costmap_->setCost(31, 55, 254);
+
+  geometry_msgs::msg::Point p1;
+  p1.x = -0.5;
+  p1.y = 0.3;
+  geometry_msgs::msg::Point p2;
+  p2.x = 0.6;
+  p2.y = 0.2;
+  geometry_msgs::msg::Point p3;
+  p3.x = 0.4;
+  p3.y = -0.35;
+  geometry_msgs::msg::Point p4;
+  p4.x = -0.45;
+  p4.y = -0.25;
+
+  nav2_costmap_2d::Footprint footprint = {p1, p2, p3, p4};
+
+  // Convert raw costmap into a costmap ros object
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>();
+  costmap_ros->on_configure(rclcpp_lifecycle::State());
+  auto costmap = costmap_ros->getCostmap();
+  *costmap = *costmap_;
+
+  nav2_smac_planner::GridCollisionChecker collision_checker(costmap_ros, 72, node);
+  collision_checker.setFootprint(footprint, false /*use footprint*/, 0.0);
+
+  // The precomputed outline cells match walking the outline's edges at cell poses
+  const std::vector<float> & angles = collision_checker.getPrecomputedAngles();
+  for (unsigned int x = 20; x <= 80; x += 5) {
+    for (unsigned int y = 20; y <= 80; y += 7) {
+      for (unsigned int bin = 0; bin < angles.size(); bin += 5) {
+        double wx, wy;
+        costmap->mapToWorld(x, y, wx, wy);
+        collision_checker.inCollision(x, y, bin, false);
+        EXPECT_NEAR(
+          collision_checker.getCost(),
+          collision_checker.footprintCostAtPose(wx, wy, angles[bin], footprint), 0.001);
+      }
+    }
+  }
+
+  // Leaving the costmap is a collision
+  EXPECT_TRUE(collision_checker.inCollision(5, 50, 0.0, false));
+  EXPECT_NEAR(collision_checker.getCost(), 254.0, 0.001);
+  delete costmap_;
+}
+
+TEST(collision_footprint, test_pose_batch_matches_poses)
+{
+  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("testH");
+  nav2_costmap_2d::Costmap2D * costmap_ = new nav2_costmap_2d::Costmap2D(
+    100, 100, 0.05, 0, 0.0, 0);
+  for (unsigned int i = 0; i != 100; ++i) {
+    for (unsigned int j = 0; j != 100; ++j) {
+      costmap_->setCost(i, j, (i * 7 + j * 13) % 256);
+    }
+  }
+
+  geometry_msgs::msg::Point p1;
+  p1.x = -0.2;
+  p1.y = 0.15;
+  geometry_msgs::msg::Point p2;
+  p2.x = 0.3;
+  p2.y = 0.15;
+  geometry_msgs::msg::Point p3;
+  p3.x = 0.3;
+  p3.y = -0.15;
+  geometry_msgs::msg::Point p4;
+  p4.x = -0.2;
+  p4.y = -0.15;
+
+  nav2_costmap_2d::Footprint footprint = {p1, p2, p3, p4};
+
+  // Convert raw costmap into a costmap ros object
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>();
+  costmap_ros->on_configure(rclcpp_lifecycle::State());
+  auto costmap = costmap_ros->getCostmap();
+  *costmap = *costmap_;
+
+  nav2_smac_planner::GridCollisionChecker collision_checker(costmap_ros, 72, node);
+
+  // Checking poses at once gives the results of checking them one by one
+  for (const bool radius : {false, true}) {
+    collision_checker.setFootprint(footprint, radius, 100.0);
+    for (const bool traverse_unknown : {false, true}) {
+      auto & batch = collision_checker.getPoseBatch();
+      batch.clear();
+      for (unsigned int i = 0; i != 200; ++i) {
+        batch.add(-0.9f + 0.5f * i, 97.1f - 0.49f * i, static_cast<float>(i % 72), i);
+      }
+      collision_checker.inCollision(batch, traverse_unknown);
+      ASSERT_EQ(batch.size(), 200u);
+
+      for (unsigned int i = 0; i != batch.size(); ++i) {
+        const bool in_collision = collision_checker.inCollision(
+          batch.x[i], batch.y[i], batch.angle_bin[i], traverse_unknown);
+        EXPECT_EQ(in_collision, static_cast<bool>(batch.in_collision[i]));
+        if (!in_collision) {
+          EXPECT_NEAR(collision_checker.getCost(), batch.costs[i], 0.001);
+        }
+      }
+    }
+  }
+  delete costmap_;
+}
+
+TEST(collision_footprint, test_swept_footprint_matches_poses)
+{
+  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("testG");
+  nav2_costmap_2d::Costmap2D * costmap_ = new nav2_costmap_2d::Costmap2D(
+    100, 100, 0.05, 0, 0.0, 0);
+
+  geometry_msgs::msg::Point p1;
+  p1.x = -0.15;
+  p1.y = 0.1;
+  geometry_msgs::msg::Point p2;
+  p2.x = 0.25;
+  p2.y = 0.1;
+  geometry_msgs::msg::Point p3;
+  p3.x = 0.25;
+  p3.y = -0.1;
+  geometry_msgs::msg::Point p4;
+  p4.x = -0.15;
+  p4.y = -0.1;
+
+  nav2_costmap_2d::Footprint footprint = {p1, p2, p3, p4};
+
+  // Convert raw costmap into a costmap ros object
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>();
+  costmap_ros->on_configure(rclcpp_lifecycle::State());
+  auto costmap = costmap_ros->getCostmap();
+  *costmap = *costmap_;
+
+  nav2_smac_planner::GridCollisionChecker collision_checker(costmap_ros, 72, node);
+  collision_checker.setFootprint(footprint, false /*use footprint*/, 0.0);
+
+  // A left turn of a quarter circle of 0.5m radius
+  nav2_smac_planner::MotionPrimitive primitive;
+  primitive.trajectory_id = 3;
+  for (unsigned int i = 0; i <= 20; ++i) {
+    const float theta = M_PI_2 * i / 20.0;
+    primitive.poses.emplace_back(
+      0.5 * sin(theta), 0.5 * (1.0 - cos(theta)), theta,
+      nav2_smac_planner::TurnDirection::LEFT);
+  }
+  const float grid_resolution = 0.05;
+  const float bin_size = 2.0 * M_PI / 72.0;
+  const float end_bin = M_PI_2 / bin_size;
+
+  // Checking the swept cells at once matches checking the poses more than a cell apart
+  const unsigned int mx = 60, my = 40;
+  for (const bool backwards : {false, true}) {
+    const auto & swept =
+      collision_checker.getSweptFootprint(primitive, backwards, end_bin, grid_resolution);
+    for (unsigned int ox = 30; ox < 70; ++ox) {
+      for (unsigned int oy = 25; oy < 65; ++oy) {
+        costmap->setCost(ox, oy, 254);
+
+        bool poses_collide = collision_checker.inCollision(mx, my, end_bin, false);
+        nav2_smac_planner::MotionPose last_pose(1e9, 1e9, 1e9,
+          nav2_smac_planner::TurnDirection::UNKNOWN);
+        for (const auto & pose : primitive.poses) {
+          nav2_smac_planner::MotionPose dist = pose;
+          dist = dist - last_pose;
+          if (dist._x * dist._x + dist._y * dist._y <= 2.0 * grid_resolution * grid_resolution) {
+            continue;
+          }
+          last_pose = pose;
+          const float theta = backwards ? std::fmod(pose._theta + M_PI, 2.0 * M_PI) : pose._theta;
+          poses_collide |= collision_checker.inCollision(
+            mx + (pose._x - primitive.poses.back()._x) / grid_resolution,
+            my + (pose._y - primitive.poses.back()._y) / grid_resolution,
+            theta / bin_size, false);
+        }
+
+        EXPECT_EQ(poses_collide, collision_checker.inCollision(swept, mx, my, false));
+        costmap->setCost(ox, oy, 0);
+      }
+    }
+  }
+
+  // Leaving the costmap is a collision
+  const auto & swept =
+    collision_checker.getSweptFootprint(primitive, false, end_bin, grid_resolution);
+  EXPECT_TRUE(collision_checker.inCollision(swept, 3, 50, false));
+  EXPECT_FALSE(collision_checker.inCollision(swept, 50, 50, false));
+  delete costmap_;
+}
@@ -0,0 +1,78 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License. Reserved.
+
+#include <cmath>
+#include <random>
+
+#include "gtest/gtest.h"
+#include "nav2_smac_planner/curve_solver.hpp"
+
+using nav2_smac_planner::CurvePath;
+using nav2_smac_planner::CurvePose;
+using nav2_smac_planner::CurveSolver;
+
+TEST(CurveSolverTest, test_known_distances)
+{
+  CurveSolver dubins(2.0, false);
+  CurveSolver reeds_shepp(2.0, true);
+
+  // Straight ahead
+  EXPECT_NEAR(dubins.distance({0.0, 0.0, 0.0}, {5.0, 0.0, 0.0}), 5.0, 1e-6);
+  EXPECT_NEAR(reeds_shepp.distance({0.0, 0.0, 0.0}, {5.0, 0.0, 0.0}), 5.0, 1e-6);
+
+  // Straight behind, which only Reeds-Shepp may reverse to
+  EXPECT_NEAR(reeds_shepp.distance({0.0, 0.0, 0.0}, {-5.0, 0.0, 0.0}), 5.0, 1e-6);
+  EXPECT_GT(dubins.distance({0.0, 0.0, 0.0}, {-5.0, 0.0, 0.0}), 5.0);
+
+  // Quarter turn to the left
+  EXPECT_NEAR(dubins.distance({0.0, 0.0, 0.0}, {2.0, 2.0, M_PI_2}), M_PI, 1e-6);
+
+  // Identical poses
+  EXPECT_NEAR(dubins.distance({1.0, 1.0, 1.0}, {1.0, 1.0, 1.0}), 0.0, 1e-6);
+  EXPECT_NEAR(reeds_shepp.distance({1.0, 1.0, 1.0}, {1.0, 1.0, 1.0}), 0.0, 1e-6);
+}
+
+TEST(CurveSolverTest, test_random_paths)
+{
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<double> position(-10.0, 10.0);
+  std::uniform_real_distribution<double> heading(-M_PI, M_PI);
+  const unsigned int num_intervals = 200;
+  CurvePose poses[num_intervals];
+
+  for (const bool & allow_reverse : {false, true}) {
+    CurveSolver solver(1.5, allow_reverse);
+    for (unsigned int i = 0; i != 1000; i++) {
+      const CurvePose from{position(generator), position(generator), heading(generator)};
+      const CurvePose to{position(generator), position(generator), heading(generator)};
+      const CurvePath path = solver.solve(from, to);
+      const double distance = solver.getTurningRadius() * path.length;
+      EXPECT_NEAR(solver.distance(from, to), distance, 1e-9);
+      if (allow_reverse) {
+        EXPECT_NEAR(solver.distance(to, from), distance, 1e-6);
+      }
+
+      // The poses sampled along the path span no more than its length and reach the goal
+      solver.sample(path, from, to, num_intervals, poses);
+      double arc_length = std::hypot(poses[0].x - from.x, poses[0].y - from.y);
+      for (unsigned int j = 1; j != num_intervals; j++) {
+        arc_length += std::hypot(poses[j].x - poses[j - 1].x, poses[j].y - poses[j - 1].y);
+      }
+      EXPECT_LE(arc_length, distance + 1e-6);
+      const CurvePose end = solver.interpolate(path, from, to, 1.0 - 1e-9);
+      EXPECT_NEAR(end.x, to.x, 1e-6);
+      EXPECT_NEAR(end.y, to.y, 1e-6);
+    }
+  }
+}
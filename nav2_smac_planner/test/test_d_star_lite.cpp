@@ -0,0 +1,157 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License. Reserved.
+
+#include <math.h>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "rclcpp/rclcpp.hpp"
+#include "nav2_costmap_2d/costmap_2d.hpp"
+#include "nav2_costmap_2d/costmap_2d_ros.hpp"
+#include "nav2_smac_planner/a_star.hpp"
+#include "nav2_smac_planner/collision_checker.hpp"
+#include "nav2_smac_planner/d_star_lite.hpp"
+
+class RclCppFixture
+{
+public:
+  RclCppFixture() {rclcpp::init(0, nullptr);}
+  ~RclCppFixture() {rclcpp::shutdown();}
+};
+RclCppFixture g_rclcppfixture;
+
+using nav2_smac_planner::Node2D;
+
+// Travel cost of a path given from the goal to the start, as in Node2D
+float pathCost(const Node2D::CoordinateVector & path, nav2_costmap_2d::Costmap2D * costmap)
+{
+  float cost = 0.0f;
+  for (unsigned int i = 0; i + 1 < path.size(); i++) {
+    const float dx = path[i].x - path[i + 1].x;
+    const float dy = path[i].y - path[i + 1].y;
+    EXPECT_LE(fabs(dx), 1.0f);
+    EXPECT_LE(fabs(dy), 1.0f);
+    const float length = dx * dx + dy * dy > 1.05f ? sqrtf(2.0f) : 1.0f;
+    cost += length * (1.0f + 2.0f * costmap->getCost(path[i].x, path[i].y) / 252.0f);
+  }
+  return cost;
+}
+
+float aStarPathCost(
+  nav2_smac_planner::GridCollisionChecker * checker,
+  unsigned int start_x, unsigned int start_y, unsigned int goal_x, unsigned int goal_y)
+{
+  nav2_smac_planner::SearchInfo info;
+  info.cost_penalty = 2.0;
+  nav2_smac_planner::AStarAlgorithm<Node2D> a_star(nav2_smac_planner::MotionModel::TWOD, info);
+  int max_iterations = 100000;
+  a_star.initialize(false, max_iterations, 10, 5000, 120.0, 0.0, 1);
+  a_star.setCollisionChecker(checker);
+  a_star.setStart(start_x, start_y, 0);
+  a_star.setGoal(goal_x, goal_y, 0);
+  Node2D::CoordinateVector path;
+  int num_it = 0;
+  EXPECT_TRUE(a_star.createPath(path, num_it, 0.0, []() {return false;}));
+  return pathCost(path, checker->getCostmap());
+}
+
+TEST(DStarLiteTest, test_d_star_lite_replanning)
+{
+  auto lnode = std::make_shared<rclcpp_lifecycle::LifecycleNode>("test");
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>();
+  costmap_ros->on_configure(rclcpp_lifecycle::State());
+  auto costmap = costmap_ros->getCostmap();
+  *costmap = nav2_costmap_2d::Costmap2D(100, 100, 0.1, 0.0, 0.0, 0);
+  // island in the middle of lethal cost to cross, with some cost around it
+  for (unsigned int i = 35; i <= 65; ++i) {
+    for (unsigned int j = 35; j <= 65; ++j) {
+      costmap->setCost(i, j, i < 40 || i > 60 || j < 40 || j > 60 ? 100 : 254);
+    }
+  }
+
+  nav2_smac_planner::GridCollisionChecker checker(costmap_ros, 1, lnode);
+  checker.setFootprint(nav2_costmap_2d::Footprint(), true, 0.0);
+
+  nav2_smac_planner::DStarLite d_star;
+  d_star.initialize(false, 100000, 5000, 120.0, 2.0);
+  d_star.setCollisionChecker(&checker);
+  d_star.setStart(20u, 20u);
+  d_star.setGoal(80u, 80u);
+
+  // Same cost as A* from scratch
+  Node2D::CoordinateVector path;
+  int num_it = 0;
+  EXPECT_TRUE(d_star.createPath(path, num_it, []() {return false;}));
+  EXPECT_GT(num_it, 0);
+  EXPECT_EQ(path.front().x, 80.0f);
+  EXPECT_EQ(path.front().y, 80.0f);
+  EXPECT_EQ(path.back().x, 20.0f);
+  EXPECT_EQ(path.back().y, 20.0f);
+  EXPECT_NEAR(pathCost(path, costmap), aStarPathCost(&checker, 20, 20, 80, 80), 1e-3);
+
+  // Moving along the path with no changes needs little to no search
+  const unsigned int next_x = path[path.size() - 11].x;
+  const unsigned int next_y = path[path.size() - 11].y;
+  d_star.setStart(next_x, next_y);
+  num_it = 0;
+  EXPECT_TRUE(d_star.createPath(path, num_it, []() {return false;}));
+  EXPECT_LT(num_it, 10);
+
+  // Blocking the path is repaired where cells changed
+  const unsigned int block_x = path[path.size() / 2].x;
+  const unsigned int block_y = path[path.size() / 2].y;
+  for (unsigned int i = block_x - 2; i <= block_x + 2; ++i) {
+    for (unsigned int j = block_y - 2; j <= block_y + 2; ++j) {
+      costmap->setCost(i, j, 254);
+    }
+  }
+  d_star.updateCells(block_x - 2, block_x + 3, block_y - 2, block_y + 3);
+  num_it = 0;
+  EXPECT_TRUE(d_star.createPath(path, num_it, []() {return false;}));
+  for (unsigned int i = 0; i != path.size(); i++) {
+    EXPECT_LT(costmap->getCost(path[i].x, path[i].y), 253);
+  }
+  EXPECT_NEAR(
+    pathCost(path, costmap), aStarPathCost(&checker, next_x, next_y, 80, 80), 1e-3);
+
+  // No path once the goal is walled in
+  for (unsigned int i = 75; i <= 85; ++i) {
+    costmap->setCost(i, 75, 254);
+    costmap->setCost(i, 85, 254);
+    costmap->setCost(75, i, 254);
+    costmap->setCost(85, i, 254);
+  }
+  d_star.updateCells(75, 86, 75, 86);
+  num_it = 0;
+  EXPECT_FALSE(d_star.createPath(path, num_it, []() {return false;}));
+
+  // Or when running out of iterations, keeping the progress for the next plan
+  d_star.setGoal(10u, 90u);
+  d_star.getMaxIterations() = 10;
+  num_it = 0;
+  EXPECT_FALSE(d_star.createPath(path, num_it, []() {return false;}));
+  EXPECT_EQ(num_it, 10);
+  d_star.getMaxIterations() = 100000;
+  num_it = 0;
+  EXPECT_TRUE(d_star.createPath(path, num_it, []() {return false;}));
+  EXPECT_NEAR(
+    pathCost(path, costmap), aStarPathCost(&checker, next_x, next_y, 10, 90), 1e-3);
+
+  // Cancellation is checked
+  d_star.setGoal(90u, 10u);
+  num_it = 0;
+  EXPECT_THROW(
+    d_star.createPath(path, num_it, []() {return true;}), nav2_core::PlannerCancelled);
+}
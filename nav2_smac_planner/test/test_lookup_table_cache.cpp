@@ -0,0 +1,61 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License. Reserved.
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "nav2_smac_planner/lookup_table_cache.hpp"
+
+TEST(LookupTableCacheTest, test_save_load)
+{
+  const std::filesystem::path directory =
+    std::filesystem::temp_directory_path() / "nav2_smac_planner_test_lookup_table_cache";
+  std::filesystem::remove_all(directory);
+
+  const std::string key = "distance_heuristic Dubin 0x1p+3 0x1.4p+4";
+  const std::string path = nav2_smac_planner::getLookupTableCachePath(directory, key);
+  EXPECT_EQ(path, nav2_smac_planner::getLookupTableCachePath(directory, key));
+  EXPECT_NE(path, nav2_smac_planner::getLookupTableCachePath(directory, key + " 0x1p+0"));
+
+  // Nothing to load before the table was saved
+  std::vector<float> table = {1.0f};
+  EXPECT_FALSE(nav2_smac_planner::loadLookupTable(path, key, table));
+  EXPECT_EQ(table.size(), 1u);
+
+  // Directory is created on save and the table loads back identically
+  std::vector<float> saved_table;
+  for (unsigned int i = 0; i != 1000; i++) {
+    saved_table.push_back(static_cast<float>(i) * 0.37f);
+  }
+  EXPECT_TRUE(nav2_smac_planner::saveLookupTable(path, key, saved_table));
+  EXPECT_TRUE(nav2_smac_planner::loadLookupTable(path, key, table));
+  EXPECT_EQ(table, saved_table);
+
+  // Tables saved with another key are not loaded
+  std::vector<float> other_table;
+  EXPECT_FALSE(nav2_smac_planner::loadLookupTable(path, key + " 0x1p+0", other_table));
+  EXPECT_TRUE(other_table.empty());
+
+  // Incomplete files are not loaded
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) - 2);
+  EXPECT_FALSE(nav2_smac_planner::loadLookupTable(path, key, other_table));
+  std::ofstream(path, std::ios::trunc) << "not a table";
+  EXPECT_FALSE(nav2_smac_planner::loadLookupTable(path, key, other_table));
+  EXPECT_TRUE(other_table.empty());
+
+  std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,60 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License. Reserved.
+
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "nav2_smac_planner/node_pool.hpp"
+
+struct TestNode
+{
+  explicit TestNode(const uint64_t i)
+  : cost(-1.0f), index(i) {}
+
+  void reset() {cost = -1.0f;}
+
+  float cost;
+  uint64_t index;
+};
+
+TEST(NodePoolTest, test_node_pool)
+{
+  nav2_smac_planner::NodePool<TestNode> pool;
+  EXPECT_TRUE(pool.empty());
+
+  // Nodes are created with their index, on pages allocated on first use
+  TestNode * node = pool.get(5);
+  EXPECT_EQ(node->index, 5u);
+  node->cost = 3.0f;
+  TestNode * far_node = pool.get(1000000);
+  EXPECT_EQ(far_node->index, 1000000u);
+  EXPECT_EQ(pool.size(), 2u);
+
+  // Getting a node again returns it as is
+  EXPECT_EQ(pool.get(5), node);
+  EXPECT_EQ(node->cost, 3.0f);
+  EXPECT_EQ(pool.size(), 2u);
+
+  // Clearing keeps the memory, nodes are reset when used again
+  pool.clear();
+  EXPECT_TRUE(pool.empty());
+  EXPECT_EQ(pool.get(5), node);
+  EXPECT_EQ(node->cost, -1.0f);
+  EXPECT_EQ(node->index, 5u);
+  EXPECT_EQ(pool.size(), 1u);
+
+  pool.reset();
+  EXPECT_TRUE(pool.empty());
+  EXPECT_EQ(pool.get(4097)->index, 4097u);
+}
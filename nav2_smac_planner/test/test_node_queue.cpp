@@ -0,0 +1,119 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License. Reserved.
+
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "nav2_smac_planner/node_queue.hpp"
+
+typedef std::pair<float, int> Element;
+
+struct ElementComparator
+{
+  bool operator()(const Element & a, const Element & b) const
+  {
+    return a.first > b.first;
+  }
+};
+
+typedef nav2_smac_planner::DAryHeap<Element, ElementComparator> Queue;
+
+std::vector<Element> makeElements(unsigned int count)
+{
+  // Few distinct costs so that ties between equal costs are common
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<int> cost(0, 50);
+  std::vector<Element> elements;
+  for (unsigned int i = 0; i != count; i++) {
+    elements.emplace_back(static_cast<float>(cost(generator)), static_cast<int>(i));
+  }
+  return elements;
+}
+
+TEST(NodeQueueTest, test_binary_heap_order)
+{
+  // A binary heap breaks ties exactly like std::priority_queue
+  std::priority_queue<Element, std::vector<Element>, ElementComparator> reference;
+  Queue queue;
+  EXPECT_EQ(queue.getArity(), 2u);
+  for (const auto & element : makeElements(2000)) {
+    reference.push(element);
+    queue.emplace(element.first, element.second);
+    if (element.second % 3 == 0) {
+      reference.pop();
+      queue.pop();
+    }
+  }
+
+  EXPECT_EQ(queue.size(), reference.size());
+  while (!reference.empty()) {
+    ASSERT_FALSE(queue.empty());
+    EXPECT_EQ(queue.top(), reference.top());
+    reference.pop();
+    queue.pop();
+  }
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(NodeQueueTest, test_d_ary_heap_order)
+{
+  for (unsigned int arity : {3u, 4u, 8u}) {
+    Queue queue(arity);
+    EXPECT_EQ(queue.getArity(), arity);
+    const std::vector<Element> elements = makeElements(2000);
+    for (const auto & element : elements) {
+      queue.push(element);
+    }
+    EXPECT_EQ(queue.size(), elements.size());
+
+    float last_cost = -1.0f;
+    while (!queue.empty()) {
+      EXPECT_GE(queue.top().first, last_cost);
+      last_cost = queue.top().first;
+      queue.pop();
+    }
+  }
+}
+
+TEST(NodeQueueTest, test_set_arity)
+{
+  // Arities under 2 are used as a binary heap
+  Queue queue(0);
+  EXPECT_EQ(queue.getArity(), 2u);
+
+  for (const auto & element : makeElements(500)) {
+    queue.push(element);
+  }
+
+  // Changing the arity keeps the queued elements in order
+  queue.setArity(4);
+  EXPECT_EQ(queue.getArity(), 4u);
+  EXPECT_EQ(queue.size(), 500u);
+  float last_cost = -1.0f;
+  while (!queue.empty()) {
+    EXPECT_GE(queue.top().first, last_cost);
+    last_cost = queue.top().first;
+    queue.pop();
+  }
+
+  queue.push(Element(1.0f, 1));
+  queue.push(Element(0.0f, 2));
+  EXPECT_EQ(queue.top().second, 2);
+  queue.clear();
+  EXPECT_TRUE(queue.empty());
+  EXPECT_EQ(queue.size(), 0u);
+}
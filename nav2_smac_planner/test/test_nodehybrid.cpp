@@ -14,6 +14,7 @@
 
 #include <math.h>
 #include <cmath>
+#include <filesystem>
 #include <memory>
 #include <string>
 #include <vector>
@@ -239,6 +240,200 @@ TEST(NodeHybridTest, test_obstacle_heuristic)
   nav2_smac_planner::NodeHybrid::destroyStaticAssets();
 }
 
+TEST(NodeHybridTest, test_obstacle_heuristic_threads)
+{
+  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("test");
+  nav2_smac_planner::SearchInfo info;
+  info.minimum_turning_radius = 8;
+  info.cost_penalty = 1.7;
+  unsigned int size_x = 100;
+  unsigned int size_y = 100;
+  unsigned int size_theta = 72;
+
+  // Convert raw costmap into a costmap ros object
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>();
+  costmap_ros->on_configure(rclcpp_lifecycle::State());
+  auto costmap = costmap_ros->getCostmap();
+  *costmap = nav2_costmap_2d::Costmap2D(100, 100, 0.1, 0.0, 0.0, 0);
+  // walls with openings at alternating ends, the path crosses the stripes many times
+  for (unsigned int j = 15; j <= 85; j += 10) {
+    const unsigned int opening = (j / 10) % 2 == 0 ? 15 : 80;
+    for (unsigned int i = 5; i < 95; ++i) {
+      if (i < opening || i > opening + 5) {
+        costmap->setCost(i, j, 254);
+      }
+    }
+  }
+  for (unsigned int i = 30; i <= 70; ++i) {
+    costmap->setCost(i, 50, 200);
+  }
+
+  std::vector<nav2_smac_planner::NodeHybrid::Coordinates> queries;
+  for (unsigned int j = 8; j < 92; j += 7) {
+    for (unsigned int i = 8; i < 92; i += 9) {
+      queries.emplace_back(i, j, 0);
+    }
+  }
+  const nav2_smac_planner::NodeHybrid::Coordinates goal(40, 90, 0);
+
+  for (bool downsample : {true, false}) {
+    info.downsample_obstacle_heuristic = downsample;
+
+    // Lazy expansion during search
+    info.obstacle_heuristic_threads = 1;
+    nav2_smac_planner::NodeHybrid::initMotionModel(
+      nav2_smac_planner::MotionModel::DUBIN, size_x, size_y, size_theta, info);
+    std::vector<float> lazy_costs;
+    nav2_smac_planner::NodeHybrid::resetObstacleHeuristic(
+      costmap_ros, queries[0].x, queries[0].y, goal.x, goal.y);
+    for (const auto & query : queries) {
+      lazy_costs.push_back(
+        nav2_smac_planner::NodeHybrid::getObstacleHeuristic(query, goal, info.cost_penalty));
+    }
+
+    // Whole wavefront computed up front must give the same costs
+    info.obstacle_heuristic_threads = 4;
+    nav2_smac_planner::NodeHybrid::initMotionModel(
+      nav2_smac_planner::MotionModel::DUBIN, size_x, size_y, size_theta, info);
+    nav2_smac_planner::NodeHybrid::resetObstacleHeuristic(
+      costmap_ros, queries[0].x, queries[0].y, goal.x, goal.y);
+    for (unsigned int i = 0; i != queries.size(); i++) {
+      EXPECT_NEAR(
+        nav2_smac_planner::NodeHybrid::getObstacleHeuristic(
+          queries[i], goal, info.cost_penalty), lazy_costs[i], 1e-3f);
+    }
+    EXPECT_TRUE(nav2_smac_planner::NodeHybrid::obstacle_heuristic_precomputed);
+    EXPECT_TRUE(nav2_smac_planner::NodeHybrid::obstacle_heuristic_queue.empty());
+  }
+
+  nav2_smac_planner::NodeHybrid::obstacle_heuristic_threads = 1;
+  nav2_smac_planner::NodeHybrid::destroyStaticAssets();
+}
+
+TEST(NodeHybridTest, test_obstacle_heuristic_cache)
+{
+  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("test");
+  nav2_smac_planner::SearchInfo info;
+  info.minimum_turning_radius = 8;
+  info.cost_penalty = 1.7;
+  unsigned int size_x = 100;
+  unsigned int size_y = 100;
+  unsigned int size_theta = 72;
+
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>();
+  costmap_ros->on_configure(rclcpp_lifecycle::State());
+  auto costmap = costmap_ros->getCostmap();
+  *costmap = nav2_costmap_2d::Costmap2D(100, 100, 0.1, 0.0, 0.0, 0);
+  for (unsigned int i = 20; i <= 80; ++i) {
+    for (unsigned int j = 40; j <= 60; ++j) {
+      costmap->setCost(i, j, 254);
+    }
+  }
+
+  std::vector<nav2_smac_planner::NodeHybrid::Coordinates> queries;
+  for (unsigned int j = 8; j < 92; j += 7) {
+    for (unsigned int i = 8; i < 92; i += 9) {
+      queries.emplace_back(i, j, 0);
+    }
+  }
+  const nav2_smac_planner::NodeHybrid::Coordinates goal(50, 85, 0);
+  const nav2_smac_planner::NodeHybrid::Coordinates other_goal(50, 15, 0);
+
+  auto get_costs = [&](const int cache_size) {
+      info.obstacle_heuristic_cache_size = cache_size;
+      nav2_smac_planner::NodeHybrid::initMotionModel(
+        nav2_smac_planner::MotionModel::DUBIN, size_x, size_y, size_theta, info);
+      nav2_smac_planner::NodeHybrid::resetObstacleHeuristic(
+        costmap_ros, queries[0].x, queries[0].y, goal.x, goal.y);
+      std::vector<float> costs;
+      for (const auto & query : queries) {
+        costs.push_back(
+          nav2_smac_planner::NodeHybrid::getObstacleHeuristic(query, goal, info.cost_penalty));
+      }
+      return costs;
+    };
+
+  // Keep the heuristic of the goal
+  get_costs(2);
+  EXPECT_EQ(nav2_smac_planner::NodeHybrid::obstacle_heuristic_cache.size(), 1u);
+
+  // Planning to another goal keeps both, up to the cache size
+  info.obstacle_heuristic_cache_size = 2;
+  nav2_smac_planner::NodeHybrid::initMotionModel(
+    nav2_smac_planner::MotionModel::DUBIN, size_x, size_y, size_theta, info);
+  nav2_smac_planner::NodeHybrid::resetObstacleHeuristic(
+    costmap_ros, queries[0].x, queries[0].y, other_goal.x, other_goal.y);
+  nav2_smac_planner::NodeHybrid::getObstacleHeuristic(queries[0], other_goal, info.cost_penalty);
+  EXPECT_EQ(nav2_smac_planner::NodeHybrid::obstacle_heuristic_cache.size(), 2u);
+
+  // Block the left passage, open a gap in the island and raise costs on the right,
+  // the kept heuristic is repaired to the lazily expanded one
+  for (unsigned int i = 0; i < 20; ++i) {
+    costmap->setCost(i, 50, 254);
+  }
+  for (unsigned int j = 40; j <= 60; ++j) {
+    costmap->setCost(30, j, 0);
+  }
+  for (unsigned int i = 81; i < 100; ++i) {
+    costmap->setCost(i, 45, 200);
+  }
+
+  const std::vector<float> repaired_costs = get_costs(2);
+  EXPECT_EQ(nav2_smac_planner::NodeHybrid::obstacle_heuristic_cache.size(), 2u);
+  const std::vector<float> lazy_costs = get_costs(0);
+  for (unsigned int i = 0; i != queries.size(); i++) {
+    EXPECT_NEAR(repaired_costs[i], lazy_costs[i], 1e-3f);
+  }
+
+  nav2_smac_planner::NodeHybrid::obstacle_heuristic_cache_size = 0;
+  nav2_smac_planner::NodeHybrid::destroyStaticAssets();
+  EXPECT_TRUE(nav2_smac_planner::NodeHybrid::obstacle_heuristic_cache.empty());
+}
+
+TEST(NodeHybridTest, test_distance_heuristic_cache)
+{
+  const std::filesystem::path directory =
+    std::filesystem::temp_directory_path() / "nav2_smac_planner_test_distance_heuristic_cache";
+  std::filesystem::remove_all(directory);
+
+  nav2_smac_planner::SearchInfo info;
+  info.minimum_turning_radius = 8;
+  info.distance_heuristic_cache_directory = directory.string();
+
+  // Table is saved on the first computation
+  nav2_smac_planner::NodeHybrid::precomputeDistanceHeuristic(
+    21.0f, nav2_smac_planner::MotionModel::DUBIN, 72, info);
+  const nav2_smac_planner::LookupTable computed_table =
+    nav2_smac_planner::NodeHybrid::dist_heuristic_lookup_table;
+  EXPECT_EQ(computed_table.size(), 21u * 11u * 72u);
+  EXPECT_FALSE(std::filesystem::is_empty(directory));
+
+  // Then loaded back, or recomputed without the cache, identically
+  nav2_smac_planner::NodeHybrid::dist_heuristic_lookup_table.clear();
+  nav2_smac_planner::NodeHybrid::precomputeDistanceHeuristic(
+    21.0f, nav2_smac_planner::MotionModel::DUBIN, 72, info);
+  EXPECT_EQ(nav2_smac_planner::NodeHybrid::dist_heuristic_lookup_table, computed_table);
+
+  info.distance_heuristic_cache_directory.clear();
+  nav2_smac_planner::NodeHybrid::precomputeDistanceHeuristic(
+    21.0f, nav2_smac_planner::MotionModel::DUBIN, 72, info);
+  EXPECT_EQ(nav2_smac_planner::NodeHybrid::dist_heuristic_lookup_table, computed_table);
+
+  // Other inputs use their own table
+  info.distance_heuristic_cache_directory = directory.string();
+  nav2_smac_planner::NodeHybrid::precomputeDistanceHeuristic(
+    21.0f, nav2_smac_planner::MotionModel::REEDS_SHEPP, 72, info);
+  EXPECT_NE(nav2_smac_planner::NodeHybrid::dist_heuristic_lookup_table, computed_table);
+  unsigned int num_files = 0;
+  for (const auto & entry : std::filesystem::directory_iterator(directory)) {
+    (void)entry;
+    num_files++;
+  }
+  EXPECT_EQ(num_files, 2u);
+
+  std::filesystem::remove_all(directory);
+}
+
 TEST(NodeHybridTest, test_node_debin_neighbors)
 {
   nav2_smac_planner::SearchInfo info;
@@ -13,6 +13,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License. Reserved.
 
+#include <cstdint>
+#include <filesystem>
 #include <fstream>
 #include <string>
 #include <vector>
@@ -20,6 +22,7 @@
 #include <unordered_map>
 #include <limits>
 #include "nav2_smac_planner/node_lattice.hpp"
+#include "nav2_smac_planner/lattice_binary.hpp"
 #include "gtest/gtest.h"
 #include "ament_index_cpp/get_package_share_directory.hpp"
 #include "nav2_util/lifecycle_node.hpp"
@@ -138,6 +141,127 @@ TEST(NodeLatticeTest, test_node_lattice_neighbors_and_parsing)
     0.05, 0.005);
 }
 
+// Write primitives in the layout of lattice_primitives/binary_format.py
+void writeBinaryLattice(
+  const std::string & filepath, const nav2_smac_planner::LatticeMetadata & metadata,
+  const nav2_smac_planner::MotionPrimitives & primitives)
+{
+  std::ofstream file(filepath, std::ios::binary);
+  auto write_u32 = [&](uint32_t value) {file.write(reinterpret_cast<char *>(&value), 4);};
+  auto write_f32 = [&](float value) {file.write(reinterpret_cast<char *>(&value), 4);};
+  uint32_t num_poses = 0;
+  for (const auto & primitive : primitives) {
+    num_poses += primitive.poses.size();
+  }
+
+  file.write("N2SMLAT1", 8);
+  write_f32(metadata.min_turning_radius);
+  write_f32(metadata.grid_resolution);
+  write_u32(metadata.number_of_headings);
+  write_u32(primitives.size());
+  write_u32(metadata.motion_model.size());
+  write_u32(num_poses);
+  file.write(metadata.motion_model.data(), metadata.motion_model.size());
+  file.write("\0\0\0", (4 - metadata.motion_model.size() % 4) % 4);
+  for (const float angle : metadata.heading_angles) {
+    write_f32(angle);
+  }
+  uint32_t first_pose = 0;
+  for (const auto & primitive : primitives) {
+    write_u32(primitive.trajectory_id);
+    write_u32(static_cast<uint32_t>(primitive.start_angle));
+    write_u32(static_cast<uint32_t>(primitive.end_angle));
+    write_f32(primitive.turning_radius);
+    write_f32(primitive.trajectory_length);
+    write_f32(primitive.arc_length);
+    write_f32(primitive.straight_length);
+    write_u32(primitive.left_turn);
+    write_u32(first_pose);
+    write_u32(primitive.poses.size());
+    first_pose += primitive.poses.size();
+  }
+  for (const auto & primitive : primitives) {
+    for (const auto & pose : primitive.poses) {
+      write_f32(pose._x);
+      write_f32(pose._y);
+      write_f32(pose._theta);
+    }
+  }
+}
+
+TEST(NodeLatticeTest, test_binary_lattice_file)
+{
+  std::string pkg_share_dir = ament_index_cpp::get_package_share_directory("nav2_smac_planner");
+  std::string filePath =
+    pkg_share_dir +
+    "/sample_primitives/5cm_resolution/0.5m_turning_radius/ackermann" +
+    "/output.json";
+  const std::string binaryFilePath =
+    (std::filesystem::temp_directory_path() / "nav2_smac_planner_test_lattice.bin").string();
+
+  // Convert the json lattice to the binary format
+  std::ifstream myJsonFile(filePath);
+  json j;
+  myJsonFile >> j;
+  nav2_smac_planner::LatticeMetadata metaData =
+    nav2_smac_planner::LatticeMotionTable::getLatticeMetadata(filePath);
+  nav2_smac_planner::MotionPrimitives primitives(j["primitives"].size());
+  for (unsigned int i = 0; i != primitives.size(); i++) {
+    nav2_smac_planner::fromJsonToMotionPrimitive(j["primitives"][i], primitives[i]);
+  }
+  writeBinaryLattice(binaryFilePath, metaData, primitives);
+  EXPECT_FALSE(nav2_smac_planner::isBinaryLatticeFile(filePath));
+  EXPECT_TRUE(nav2_smac_planner::isBinaryLatticeFile(binaryFilePath));
+
+  // Both formats load the same lattice
+  nav2_smac_planner::LatticeMetadata binaryMetaData =
+    nav2_smac_planner::LatticeMotionTable::getLatticeMetadata(binaryFilePath);
+  EXPECT_EQ(binaryMetaData.min_turning_radius, metaData.min_turning_radius);
+  EXPECT_EQ(binaryMetaData.grid_resolution, metaData.grid_resolution);
+  EXPECT_EQ(binaryMetaData.number_of_headings, metaData.number_of_headings);
+  EXPECT_EQ(binaryMetaData.heading_angles, metaData.heading_angles);
+  EXPECT_EQ(binaryMetaData.number_of_trajectories, metaData.number_of_trajectories);
+  EXPECT_EQ(binaryMetaData.motion_model, metaData.motion_model);
+
+  nav2_smac_planner::SearchInfo info;
+  info.lattice_filepath = filePath;
+  unsigned int size_x = 100;
+  nav2_smac_planner::LatticeMotionTable jsonTable, binaryTable;
+  jsonTable.initMotionModel(size_x, info);
+  info.lattice_filepath = binaryFilePath;
+  binaryTable.initMotionModel(size_x, info);
+
+  ASSERT_EQ(binaryTable.motion_primitives.size(), jsonTable.motion_primitives.size());
+  for (unsigned int i = 0; i != jsonTable.motion_primitives.size(); i++) {
+    ASSERT_EQ(binaryTable.motion_primitives[i].size(), jsonTable.motion_primitives[i].size());
+    for (unsigned int k = 0; k != jsonTable.motion_primitives[i].size(); k++) {
+      const auto & a = binaryTable.motion_primitives[i][k];
+      const auto & b = jsonTable.motion_primitives[i][k];
+      EXPECT_EQ(a.trajectory_id, b.trajectory_id);
+      EXPECT_EQ(a.start_angle, b.start_angle);
+      EXPECT_EQ(a.end_angle, b.end_angle);
+      EXPECT_EQ(a.turning_radius, b.turning_radius);
+      EXPECT_EQ(a.trajectory_length, b.trajectory_length);
+      EXPECT_EQ(a.arc_length, b.arc_length);
+      EXPECT_EQ(a.straight_length, b.straight_length);
+      EXPECT_EQ(a.left_turn, b.left_turn);
+      ASSERT_EQ(a.poses.size(), b.poses.size());
+      for (unsigned int p = 0; p != a.poses.size(); p++) {
+        EXPECT_EQ(a.poses[p]._x, b.poses[p]._x);
+        EXPECT_EQ(a.poses[p]._y, b.poses[p]._y);
+        EXPECT_EQ(a.poses[p]._theta, b.poses[p]._theta);
+      }
+    }
+  }
+
+  // Truncated files are rejected
+  std::filesystem::resize_file(binaryFilePath, std::filesystem::file_size(binaryFilePath) - 4);
+  EXPECT_THROW(
+    nav2_smac_planner::loadBinaryLattice(binaryFilePath, binaryMetaData, &primitives),
+    std::runtime_error);
+  std::filesystem::remove(binaryFilePath);
+}
+
 TEST(NodeLatticeTest, test_node_lattice_conversions)
 {
   std::string pkg_share_dir = ament_index_cpp::get_package_share_directory("nav2_smac_planner");
@@ -0,0 +1,111 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License. Reserved.
+
+#include <math.h>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "rclcpp/rclcpp.hpp"
+#include "nav2_costmap_2d/costmap_2d.hpp"
+#include "nav2_costmap_2d/costmap_2d_ros.hpp"
+#include "nav2_smac_planner/a_star.hpp"
+#include "nav2_smac_planner/collision_checker.hpp"
+#include "nav2_smac_planner/search_corridor.hpp"
+
+class RclCppFixture
+{
+public:
+  RclCppFixture() {rclcpp::init(0, nullptr);}
+  ~RclCppFixture() {rclcpp::shutdown();}
+};
+RclCppFixture g_rclcppfixture;
+
+TEST(SearchCorridorTest, test_search_corridor)
+{
+  auto lnode = std::make_shared<rclcpp_lifecycle::LifecycleNode>("test");
+  auto costmap_ros = std::make_shared<nav2_costmap_2d::Costmap2DROS>();
+  costmap_ros->on_configure(rclcpp_lifecycle::State());
+  auto costmap = costmap_ros->getCostmap();
+  *costmap = nav2_costmap_2d::Costmap2D(100, 100, 0.1, 0.0, 0.0, 0);
+  // wall across the costmap with a gap at its top
+  for (unsigned int j = 0; j < 100; ++j) {
+    if (j < 80 || j >= 90) {
+      costmap->setCost(50, j, 254);
+    }
+  }
+
+  // Coarse cells of 5 cells, with a corridor of a coarse cell on each side of the path
+  nav2_smac_planner::SearchCorridor corridor;
+  corridor.on_configure(
+    lnode, costmap_ros, costmap, 1, 5, false, 0.5, 2.0, false, 100000, 5000, 120.0);
+  EXPECT_TRUE(corridor.empty());
+  EXPECT_TRUE(corridor.contains(50u, 20u));
+
+  // With max pooling the wall stays, so the corridor goes through the gap
+  EXPECT_TRUE(corridor.update(10.0, 10.0, 90.0, 10.0, []() {return false;}));
+  EXPECT_FALSE(corridor.empty());
+  EXPECT_TRUE(corridor.contains(10u, 10u));
+  EXPECT_TRUE(corridor.contains(90u, 10u));
+  EXPECT_TRUE(corridor.contains(50u, 85u));
+  EXPECT_FALSE(corridor.contains(10u, 90u));
+  EXPECT_FALSE(corridor.contains(90u, 90u));
+  EXPECT_FALSE(corridor.contains(1000u, 10u));
+
+  // The search restricted to the corridor stays in it
+  nav2_smac_planner::SearchInfo info;
+  info.minimum_turning_radius = 2;  // in grid coordinates
+  info.analytic_expansion_max_length = 20.0;  // in grid coordinates
+  info.analytic_expansion_ratio = 3.5;
+  info.cost_penalty = 2.0;
+  unsigned int size_theta = 72;
+  nav2_smac_planner::AStarAlgorithm<nav2_smac_planner::NodeHybrid> a_star(
+    nav2_smac_planner::MotionModel::DUBIN, info);
+  int max_iterations = 100000;
+  a_star.initialize(false, max_iterations, 1000, 5000, 120.0, 21, size_theta);
+  nav2_smac_planner::GridCollisionChecker checker(costmap_ros, size_theta, lnode);
+  checker.setFootprint(nav2_costmap_2d::Footprint(), true, 0.0);
+  a_star.setCollisionChecker(&checker);
+  a_star.setSearchCorridor(&corridor);
+  a_star.setStart(10u, 10u, 0u);
+  a_star.setGoal(90u, 10u, 0u);
+  nav2_smac_planner::NodeHybrid::CoordinateVector path;
+  int num_it = 0;
+  EXPECT_TRUE(a_star.createPath(path, num_it, 0.0, []() {return false;}));
+  EXPECT_GT(path.size(), 1u);
+  for (unsigned int i = 0; i != path.size(); i++) {
+    EXPECT_TRUE(corridor.contains(path[i].x, path[i].y));
+    EXPECT_LT(costmap->getCost(path[i].x, path[i].y), 253);
+  }
+
+  // With min pooling the wall is too thin to be kept, so the corridor crosses it
+  corridor.on_configure(
+    lnode, costmap_ros, costmap, 1, 5, true, 0.5, 2.0, false, 100000, 5000, 120.0);
+  EXPECT_TRUE(corridor.update(10.0, 10.0, 90.0, 10.0, []() {return false;}));
+  EXPECT_TRUE(corridor.contains(50u, 10u));
+  EXPECT_FALSE(corridor.contains(50u, 85u));
+
+  // No corridor once the gap is closed
+  for (unsigned int j = 80; j < 90; ++j) {
+    costmap->setCost(50, j, 254);
+  }
+  corridor.on_configure(
+    lnode, costmap_ros, costmap, 1, 5, false, 0.5, 2.0, false, 100000, 5000, 120.0);
+  EXPECT_FALSE(corridor.update(10.0, 10.0, 90.0, 10.0, []() {return false;}));
+  EXPECT_TRUE(corridor.empty());
+  EXPECT_TRUE(corridor.contains(50u, 20u));
+
+  corridor.on_cleanup();
+  nav2_smac_planner::NodeHybrid::destroyStaticAssets();
+}
@@ -113,7 +113,8 @@ TEST(SmacTest, test_smac_2d_reconfigure) {
       rclcpp::Parameter("test.max_iterations", -1),
       rclcpp::Parameter("test.max_on_approach_iterations", -1),
       rclcpp::Parameter("test.terminal_checking_interval", 100),
-      rclcpp::Parameter("test.use_final_approach_orientation", false)});
+      rclcpp::Parameter("test.use_final_approach_orientation", false),
+      rclcpp::Parameter("test.incremental_replanning", true)});
 
   rclcpp::spin_until_future_complete(
     node2D->get_node_base_interface(),
@@ -129,6 +130,7 @@ TEST(SmacTest, test_smac_2d_reconfigure) {
   EXPECT_EQ(node2D->get_parameter("test.downsampling_factor").as_int(), 2);
   EXPECT_EQ(node2D->get_parameter("test.max_iterations").as_int(), -1);
   EXPECT_EQ(node2D->get_parameter("test.use_final_approach_orientation").as_bool(), false);
+  EXPECT_EQ(node2D->get_parameter("test.incremental_replanning").as_bool(), true);
   EXPECT_EQ(
     node2D->get_parameter("test.max_on_approach_iterations").as_int(),
     -1);
@@ -0,0 +1,87 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp_lifecycle/lifecycle_node.hpp"
+#include "nav2_smoother/savitzky_golay_smoother.hpp"
+#include "nav2_util/geometry_utils.hpp"
+
+// A noisy path of poses 5 cm apart, going back and forth over segments of the given
+// number of poses, as planned with reversing
+nav_msgs::msg::Path makePath(size_t poses, size_t segment_poses)
+{
+  std::mt19937 generator(0);
+  std::normal_distribution<double> noise(0.0, 0.01);
+  nav_msgs::msg::Path path;
+  path.header.frame_id = "map";
+  path.poses.resize(poses);
+  double x = 0.0, y = 0.0, yaw = 0.0, direction = 1.0;
+  for (size_t i = 0; i < poses; i++) {
+    if (i > 0 && i % segment_poses == 0) {
+      direction = -direction;
+    }
+    yaw += 0.01 * std::sin(i * 0.01);
+    x += direction * 0.05 * std::cos(yaw);
+    y += direction * 0.05 * std::sin(yaw);
+    path.poses[i].pose.position.x = x + noise(generator);
+    path.poses[i].pose.position.y = y + noise(generator);
+    path.poses[i].pose.orientation = nav2_util::geometry_utils::orientationAroundZAxis(yaw);
+  }
+  return path;
+}
+
+static void BM_SavitzkyGolaySmoother(benchmark::State & state)
+{
+  const size_t poses = state.range(0);
+  const size_t segments = state.range(1);
+  const int threads = state.range(2);
+
+  auto node = std::make_shared<rclcpp_lifecycle::LifecycleNode>("smoother_benchmark");
+  node->declare_parameter("sg.segment_threads", rclcpp::ParameterValue(threads));
+  auto smoother = std::make_unique<nav2_smoother::SavitzkyGolaySmoother>();
+  smoother->configure(node, "sg", nullptr, nullptr, nullptr);
+  smoother->activate();
+
+  const nav_msgs::msg::Path path = makePath(poses, (poses + segments - 1) / segments);
+  const rclcpp::Duration max_time = rclcpp::Duration::from_seconds(10.0);
+  for (auto _ : state) {
+    state.PauseTiming();
+    nav_msgs::msg::Path smoothed = path;
+    state.ResumeTiming();
+    smoother->smooth(smoothed, max_time);
+    benchmark::DoNotOptimize(smoothed.poses.data());
+  }
+  state.SetItemsProcessed(state.iterations() * poses);
+}
+
+BENCHMARK(BM_SavitzkyGolaySmoother)
+->ArgNames({"poses", "segments", "threads"})
+->ArgsProduct({{1000, 20000}, {1, 8}, {1, 4}})
+->Unit(benchmark::kMicrosecond);
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  rclcpp::shutdown();
+  return 0;
+}
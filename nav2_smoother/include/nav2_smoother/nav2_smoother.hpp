@@ -17,6 +17,7 @@
 #define NAV2_SMOOTHER__NAV2_SMOOTHER_HPP_
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <unordered_map>
@@ -28,9 +29,11 @@
 #include "nav2_costmap_2d/costmap_topic_collision_checker.hpp"
 #include "nav2_costmap_2d/footprint_subscriber.hpp"
 #include "nav2_msgs/action/smooth_path.hpp"
+#include "nav2_msgs/action/smooth_paths.hpp"
 #include "nav2_util/lifecycle_node.hpp"
 #include "nav2_util/robot_utils.hpp"
 #include "nav2_util/simple_action_server.hpp"
+#include "nav2_util/thread_pool.hpp"
 #include "pluginlib/class_list_macros.hpp"
 #include "pluginlib/class_loader.hpp"
 
@@ -76,6 +79,13 @@ protected:
    */
   bool loadSmootherPlugins();
 
+  /**
+   * @brief Loads an instance of each smoother plugin for each batch smoothing worker,
+   * plugins not being safe to use from several threads at once
+   * @return bool if successfully loaded the plugins
+   */
+  bool loadBatchSmootherPlugins();
+
   /**
    * @brief Activates member variables
    *
@@ -127,6 +137,46 @@ protected:
    */
   void smoothPlan();
 
+  using BatchAction = nav2_msgs::action::SmoothPaths;
+  using BatchActionResult = BatchAction::Result;
+  using BatchActionServer = nav2_util::SimpleActionServer<BatchAction>;
+
+  /**
+   * @brief SmoothPaths action server callback. Smooths the paths of the goal
+   * concurrently on the batch smoothing workers, streaming each path back as
+   * feedback as soon as it is done
+   */
+  void smoothPlans();
+
+  /**
+   * @brief Smooth one path of a batch and check it for collisions
+   * @param smoother Smoother to use
+   * @param collision_checker Collision checker to use
+   * @param goal Goal of the batch
+   * @param path Path to smooth, smoothed in place
+   * @param was_completed Output whether the smoother completed in time
+   * @return Error code of the path
+   */
+  uint16_t smoothBatchPath(
+    nav2_core::Smoother & smoother,
+    nav2_costmap_2d::CostmapTopicCollisionChecker & collision_checker,
+    const BatchAction::Goal & goal,
+    nav_msgs::msg::Path & path,
+    bool & was_completed);
+
+  /**
+   * @brief Check a smoothed path for collisions. When the smoother kept the poses of
+   * the path, the poses it left unchanged are not checked again.
+   * @param original Path before smoothing
+   * @param smoothed Smoothed path
+   * @param collision_checker Collision checker to use
+   * @throw nav2_core::SmoothedPathInCollision
+   */
+  void checkChangedPosesForCollisions(
+    const nav_msgs::msg::Path & original,
+    const nav_msgs::msg::Path & smoothed,
+    nav2_costmap_2d::CostmapTopicCollisionChecker & collision_checker);
+
   /**
    * @brief Find the valid smoother ID name for the given request
    *
@@ -145,6 +195,7 @@ protected:
 
   // Our action server implements the SmoothPath action
   std::unique_ptr<ActionServer> action_server_;
+  std::unique_ptr<BatchActionServer> batch_action_server_;
 
   // Transforms
   std::shared_ptr<tf2_ros::Buffer> tf_;
@@ -162,6 +213,14 @@ protected:
   std::vector<std::string> smoother_types_;
   std::string smoother_ids_concat_, current_smoother_;
 
+  // Batch smoothing workers, each with its own instance of the smoother plugins,
+  // checked out by the tasks of the pool while they smooth a path
+  int batch_smoothing_threads_{0};
+  std::unique_ptr<nav2_util::ThreadPool> batch_pool_;
+  std::vector<SmootherMap> batch_smoothers_;
+  std::vector<size_t> idle_batch_workers_;
+  std::mutex batch_mutex_;
+
   // Utilities
   std::shared_ptr<nav2_costmap_2d::CostmapSubscriber> costmap_sub_;
   std::shared_ptr<nav2_costmap_2d::FootprintSubscriber> footprint_sub_;
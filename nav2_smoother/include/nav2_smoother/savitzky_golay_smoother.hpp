@@ -29,6 +29,7 @@
 #include "nav2_costmap_2d/cost_values.hpp"
 #include "nav2_util/geometry_utils.hpp"
 #include "nav2_util/node_utils.hpp"
+#include "nav2_util/thread_pool.hpp"
 #include "nav_msgs/msg/path.hpp"
 #include "angles/angles.h"
 #include "tf2/utils.h"
@@ -87,19 +88,30 @@ public:
 
 protected:
   /**
-   * @brief Smoother method - does the smoothing on a segment
+   * @brief Smoother method - does the smoothing on a segment of the path in place,
+   * writing only its inner positions and its orientations but the last one
    * @param path Reference to path
+   * @param segment Segment of the path to smooth
    * @param reversing_segment Return if this is a reversing segment
-   * @param costmap Pointer to minimal costmap
-   * @param max_time Maximum time to compute, stop early if over limit
-   * @return If smoothing was successful
    */
-  bool smoothImpl(
+  void smoothSegment(
     nav_msgs::msg::Path & path,
+    const smoother_utils::PathSegment & segment,
     bool & reversing_segment);
 
+  /**
+   * @brief Applies the filter once to coordinates, in place, the first and last
+   * points being fixed
+   * @param xs X coordinates
+   * @param ys Y coordinates
+   * @param size Number of points, at least 11
+   */
+  static void applyFilter(double * xs, double * ys, size_t size);
+
   bool do_refinement_;
   int refinement_num_;
+  // Smooths the segments of a path in parallel
+  std::unique_ptr<nav2_util::ThreadPool> segments_pool_;
   rclcpp::Logger logger_{rclcpp::get_logger("SGSmoother")};
 };
 
@@ -91,26 +91,33 @@ inline std::vector<PathSegment> findDirectionalPathSegments(
   return segments;
 }
 
+/**
+ * @brief Set the orientations of the poses of a path segment along the path,
+ * all but the last one
+ * @param begin First pose of the segment
+ * @param end Past the last pose of the segment
+ * @param reversing_segment Return if this is a reversing segment
+ */
 inline void updateApproximatePathOrientations(
-  nav_msgs::msg::Path & path,
+  PathIterator begin, PathIterator end,
   bool & reversing_segment)
 {
   double dx, dy, theta, pt_yaw;
   reversing_segment = false;
 
   // Find if this path segment is in reverse
-  dx = path.poses[2].pose.position.x - path.poses[1].pose.position.x;
-  dy = path.poses[2].pose.position.y - path.poses[1].pose.position.y;
+  dx = begin[2].pose.position.x - begin[1].pose.position.x;
+  dy = begin[2].pose.position.y - begin[1].pose.position.y;
   theta = atan2(dy, dx);
-  pt_yaw = tf2::getYaw(path.poses[1].pose.orientation);
+  pt_yaw = tf2::getYaw(begin[1].pose.orientation);
   if (fabs(angles::shortest_angular_distance(pt_yaw, theta)) > M_PI_2) {
     reversing_segment = true;
   }
 
   // Find the angle relative the path position vectors
-  for (unsigned int i = 0; i != path.poses.size() - 1; i++) {
-    dx = path.poses[i + 1].pose.position.x - path.poses[i].pose.position.x;
-    dy = path.poses[i + 1].pose.position.y - path.poses[i].pose.position.y;
+  for (auto it = begin; it + 1 != end; ++it) {
+    dx = it[1].pose.position.x - it->pose.position.x;
+    dy = it[1].pose.position.y - it->pose.position.y;
     theta = atan2(dy, dx);
 
     // If points are overlapping, pass
@@ -123,10 +130,17 @@ inline void updateApproximatePathOrientations(
       theta += M_PI;  // orientationAroundZAxis will normalize
     }
 
-    path.poses[i].pose.orientation = nav2_util::geometry_utils::orientationAroundZAxis(theta);
+    it->pose.orientation = nav2_util::geometry_utils::orientationAroundZAxis(theta);
   }
 }
 
+inline void updateApproximatePathOrientations(
+  nav_msgs::msg::Path & path,
+  bool & reversing_segment)
+{
+  updateApproximatePathOrientations(path.poses.begin(), path.poses.end(), reversing_segment);
+}
+
 }  // namespace smoother_utils
 
 #endif  // NAV2_SMOOTHER__SMOOTHER_UTILS_HPP_
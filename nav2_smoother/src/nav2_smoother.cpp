@@ -55,6 +55,7 @@ SmootherServer::SmootherServer(const rclcpp::NodeOptions & options)
   declare_parameter("smoother_plugins", default_ids_);
 
   declare_parameter("action_server_result_timeout", 10.0);
+  declare_parameter("batch_smoothing_threads", 0);
 }
 
 SmootherServer::~SmootherServer()
@@ -103,6 +104,11 @@ SmootherServer::on_configure(const rclcpp_lifecycle::State &)
     return nav2_util::CallbackReturn::FAILURE;
   }
 
+  get_parameter("batch_smoothing_threads", batch_smoothing_threads_);
+  if (batch_smoothing_threads_ > 0 && !loadBatchSmootherPlugins()) {
+    return nav2_util::CallbackReturn::FAILURE;
+  }
+
   // Initialize pubs & subs
   plan_publisher_ = create_publisher<nav_msgs::msg::Path>("plan_smoothed", 1);
 
@@ -120,6 +126,18 @@ SmootherServer::on_configure(const rclcpp_lifecycle::State &)
     std::chrono::milliseconds(500),
     true, server_options);
 
+  // Create the batch action server, smoothing many paths at once, if there are workers for it
+  if (batch_smoothing_threads_ > 0) {
+    batch_pool_ = std::make_unique<nav2_util::ThreadPool>(batch_smoothing_threads_ - 1);
+    batch_action_server_ = std::make_unique<BatchActionServer>(
+      shared_from_this(),
+      "smooth_paths",
+      std::bind(&SmootherServer::smoothPlans, this),
+      nullptr,
+      std::chrono::milliseconds(500),
+      true, server_options);
+  }
+
   return nav2_util::CallbackReturn::SUCCESS;
 }
 
@@ -161,6 +179,38 @@ bool SmootherServer::loadSmootherPlugins()
   return true;
 }
 
+bool SmootherServer::loadBatchSmootherPlugins()
+{
+  auto node = shared_from_this();
+
+  batch_smoothers_.resize(batch_smoothing_threads_);
+  idle_batch_workers_.clear();
+  for (size_t worker = 0; worker != batch_smoothers_.size(); worker++) {
+    for (size_t i = 0; i != smoother_ids_.size(); i++) {
+      try {
+        nav2_core::Smoother::Ptr smoother =
+          lp_loader_.createUniqueInstance(smoother_types_[i]);
+        smoother->configure(
+          node, smoother_ids_[i], tf_, costmap_sub_,
+          footprint_sub_);
+        batch_smoothers_[worker].insert({smoother_ids_[i], smoother});
+      } catch (const std::exception & ex) {
+        RCLCPP_FATAL(
+          get_logger(), "Failed to create batch smoother. Exception: %s",
+          ex.what());
+        return false;
+      }
+    }
+    idle_batch_workers_.push_back(worker);
+  }
+
+  RCLCPP_INFO(
+    get_logger(), "Smoother Server smooths batches of paths on %i threads.",
+    batch_smoothing_threads_);
+
+  return true;
+}
+
 nav2_util::CallbackReturn
 SmootherServer::on_activate(const rclcpp_lifecycle::State &)
 {
@@ -171,7 +221,15 @@ SmootherServer::on_activate(const rclcpp_lifecycle::State &)
   for (it = smoothers_.begin(); it != smoothers_.end(); ++it) {
     it->second->activate();
   }
+  for (auto & smoothers : batch_smoothers_) {
+    for (it = smoothers.begin(); it != smoothers.end(); ++it) {
+      it->second->activate();
+    }
+  }
   action_server_->activate();
+  if (batch_action_server_) {
+    batch_action_server_->activate();
+  }
 
   // create bond connection
   createBond();
@@ -185,10 +243,18 @@ SmootherServer::on_deactivate(const rclcpp_lifecycle::State &)
   RCLCPP_INFO(get_logger(), "Deactivating");
 
   action_server_->deactivate();
+  if (batch_action_server_) {
+    batch_action_server_->deactivate();
+  }
   SmootherMap::iterator it;
   for (it = smoothers_.begin(); it != smoothers_.end(); ++it) {
     it->second->deactivate();
   }
+  for (auto & smoothers : batch_smoothers_) {
+    for (it = smoothers.begin(); it != smoothers.end(); ++it) {
+      it->second->deactivate();
+    }
+  }
   plan_publisher_->on_deactivate();
 
   // destroy bond connection
@@ -208,9 +274,18 @@ SmootherServer::on_cleanup(const rclcpp_lifecycle::State &)
     it->second->cleanup();
   }
   smoothers_.clear();
+  for (auto & smoothers : batch_smoothers_) {
+    for (it = smoothers.begin(); it != smoothers.end(); ++it) {
+      it->second->cleanup();
+    }
+  }
+  batch_smoothers_.clear();
+  idle_batch_workers_.clear();
 
   // Release any allocated resources
   action_server_.reset();
+  batch_action_server_.reset();
+  batch_pool_.reset();
   plan_publisher_.reset();
   transform_listener_.reset();
   tf_.reset();
@@ -364,6 +439,151 @@ void SmootherServer::smoothPlan()
   }
 }
 
+void SmootherServer::smoothPlans()
+{
+  auto start_time = this->now();
+  auto goal = batch_action_server_->get_current_goal();
+
+  RCLCPP_INFO(get_logger(), "Received %zu paths to smooth.", goal->paths.size());
+
+  auto result = std::make_shared<BatchAction::Result>();
+  std::string current_smoother;
+  if (!findSmootherId(goal->smoother_id, current_smoother)) {
+    result->error_code = BatchActionResult::INVALID_SMOOTHER;
+    result->error_msg = "Invalid Smoother: " + goal->smoother_id;
+    RCLCPP_ERROR(this->get_logger(), "%s", result->error_msg.c_str());
+    batch_action_server_->terminate_current(result);
+    return;
+  }
+
+  // The collision checkers only refer to the subscribers, one per worker
+  std::vector<std::unique_ptr<nav2_costmap_2d::CostmapTopicCollisionChecker>> collision_checkers;
+  for (size_t worker = 0; worker != batch_smoothers_.size(); worker++) {
+    collision_checkers.push_back(
+      std::make_unique<nav2_costmap_2d::CostmapTopicCollisionChecker>(
+        *costmap_sub_, *footprint_sub_, this->get_name()));
+  }
+
+  const size_t count = goal->paths.size();
+  result->paths = goal->paths;
+  result->path_error_codes.assign(count, BatchActionResult::NONE);
+  // Not a std::vector<bool>, whose elements can't be written concurrently
+  std::vector<uint8_t> was_completed(count, false);
+
+  batch_pool_->parallelFor(
+    count, [&](size_t i) {
+      size_t worker;
+      {
+        std::lock_guard<std::mutex> lock(batch_mutex_);
+        worker = idle_batch_workers_.back();
+        idle_batch_workers_.pop_back();
+      }
+
+      bool completed = false;
+      uint16_t error_code = BatchActionResult::UNKNOWN;
+      if (!batch_action_server_->is_cancel_requested()) {
+        error_code = smoothBatchPath(
+          *batch_smoothers_[worker].at(current_smoother), *collision_checkers[worker],
+          *goal, result->paths[i], completed);
+      }
+
+      auto feedback = std::make_shared<BatchAction::Feedback>();
+      feedback->path_index = static_cast<uint32_t>(i);
+      feedback->path = result->paths[i];
+      feedback->was_completed = completed;
+      feedback->error_code = error_code;
+
+      std::lock_guard<std::mutex> lock(batch_mutex_);
+      idle_batch_workers_.push_back(worker);
+      was_completed[i] = completed;
+      result->path_error_codes[i] = error_code;
+      batch_action_server_->publish_feedback(feedback);
+    });
+
+  result->was_completed.assign(was_completed.begin(), was_completed.end());
+  result->smoothing_duration = this->now() - start_time;
+
+  if (batch_action_server_->is_cancel_requested()) {
+    RCLCPP_INFO(get_logger(), "Batch smoothing canceled.");
+    batch_action_server_->terminate_all(result);
+    return;
+  }
+
+  RCLCPP_DEBUG(
+    get_logger(), "Batch smoothing done (time: %lf), setting result",
+    rclcpp::Duration(result->smoothing_duration).seconds());
+
+  batch_action_server_->succeeded_current(result);
+}
+
+uint16_t SmootherServer::smoothBatchPath(
+  nav2_core::Smoother & smoother,
+  nav2_costmap_2d::CostmapTopicCollisionChecker & collision_checker,
+  const BatchAction::Goal & goal,
+  nav_msgs::msg::Path & path,
+  bool & was_completed)
+{
+  try {
+    if (!validate(path)) {
+      throw nav2_core::InvalidPath("Requested path to smooth is invalid");
+    }
+
+    const nav_msgs::msg::Path original = goal.check_for_collisions ? path : nav_msgs::msg::Path();
+    was_completed = smoother.smooth(path, goal.max_smoothing_duration);
+
+    if (goal.check_for_collisions) {
+      checkChangedPosesForCollisions(original, path, collision_checker);
+    }
+    return BatchActionResult::NONE;
+  } catch (nav2_core::SmootherTimedOut & ex) {
+    RCLCPP_ERROR(this->get_logger(), "%s", ex.what());
+    return BatchActionResult::TIMEOUT;
+  } catch (nav2_core::SmoothedPathInCollision & ex) {
+    RCLCPP_ERROR(this->get_logger(), "%s", ex.what());
+    return BatchActionResult::SMOOTHED_PATH_IN_COLLISION;
+  } catch (nav2_core::FailedToSmoothPath & ex) {
+    RCLCPP_ERROR(this->get_logger(), "%s", ex.what());
+    return BatchActionResult::FAILED_TO_SMOOTH_PATH;
+  } catch (nav2_core::InvalidPath & ex) {
+    RCLCPP_ERROR(this->get_logger(), "%s", ex.what());
+    return BatchActionResult::INVALID_PATH;
+  } catch (std::exception & ex) {
+    RCLCPP_ERROR(this->get_logger(), "%s", ex.what());
+    return BatchActionResult::UNKNOWN;
+  }
+}
+
+void SmootherServer::checkChangedPosesForCollisions(
+  const nav_msgs::msg::Path & original,
+  const nav_msgs::msg::Path & smoothed,
+  nav2_costmap_2d::CostmapTopicCollisionChecker & collision_checker)
+{
+  // Poses can only be matched when the smoother didn't add or remove any
+  const bool same_poses = original.poses.size() == smoothed.poses.size();
+
+  geometry_msgs::msg::Pose2D pose2d;
+  bool fetch_data = true;
+  for (size_t i = 0; i < smoothed.poses.size(); i++) {
+    const auto & pose = smoothed.poses[i].pose;
+    if (same_poses && pose == original.poses[i].pose) {
+      continue;
+    }
+
+    pose2d.x = pose.position.x;
+    pose2d.y = pose.position.y;
+    pose2d.theta = tf2::getYaw(pose.orientation);
+
+    if (!collision_checker.isCollisionFree(pose2d, fetch_data)) {
+      throw nav2_core::SmoothedPathInCollision(
+              "Smoothed Path collided at"
+              "X: " + std::to_string(pose2d.x) +
+              "Y: " + std::to_string(pose2d.y) +
+              "Theta: " + std::to_string(pose2d.theta));
+    }
+    fetch_data = false;
+  }
+}
+
 bool SmootherServer::validate(const nav_msgs::msg::Path & path)
 {
   if (path.poses.empty()) {
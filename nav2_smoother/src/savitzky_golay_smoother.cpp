@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License. Reserved.
 
+#include <algorithm>
+#include <atomic>
 #include <vector>
 #include <memory>
 #include "nav2_smoother/savitzky_golay_smoother.hpp"
@@ -40,6 +42,12 @@ void SavitzkyGolaySmoother::configure(
     node, name + ".refinement_num", rclcpp::ParameterValue(2));
   node->get_parameter(name + ".do_refinement", do_refinement_);
   node->get_parameter(name + ".refinement_num", refinement_num_);
+
+  int segment_threads;
+  declare_parameter_if_not_declared(
+    node, name + ".segment_threads", rclcpp::ParameterValue(1));
+  node->get_parameter(name + ".segment_threads", segment_threads);
+  segments_pool_ = std::make_unique<nav2_util::ThreadPool>(std::max(segment_threads - 1, 0));
 }
 
 bool SavitzkyGolaySmoother::smooth(
@@ -47,55 +55,75 @@ bool SavitzkyGolaySmoother::smooth(
   const rclcpp::Duration & max_time)
 {
   steady_clock::time_point start = steady_clock::now();
-  double time_remaining = max_time.seconds();
-
-  bool success = true, reversing_segment;
-  nav_msgs::msg::Path curr_path_segment;
-  curr_path_segment.header = path.header;
+  const duration<double> max_duration(max_time.seconds());
 
+  // Segments must be at least 10 in length to be smoothed
   std::vector<PathSegment> path_segments = findDirectionalPathSegments(path);
-
-  for (unsigned int i = 0; i != path_segments.size(); i++) {
-    if (path_segments[i].end - path_segments[i].start > 9) {
-      // Populate path segment
-      curr_path_segment.poses.clear();
-      std::copy(
-        path.poses.begin() + path_segments[i].start,
-        path.poses.begin() + path_segments[i].end + 1,
-        std::back_inserter(curr_path_segment.poses));
-
+  path_segments.erase(
+    std::remove_if(
+      path_segments.begin(), path_segments.end(),
+      [](const PathSegment & segment) {return segment.end - segment.start <= 9;}),
+    path_segments.end());
+
+  // Segments only share their ends, which each of them writes at most once, so they
+  // are smoothed in parallel
+  std::atomic<bool> timed_out{false};
+  segments_pool_->parallelFor(
+    path_segments.size(), [&](size_t i) {
       // Make sure we're still able to smooth with time remaining
-      steady_clock::time_point now = steady_clock::now();
-      time_remaining = max_time.seconds() - duration_cast<duration<double>>(now - start).count();
-
-      if (time_remaining <= 0.0) {
-        RCLCPP_WARN(
-          logger_,
-          "Smoothing time exceeded allowed duration of %0.2f.", max_time.seconds());
-        throw nav2_core::SmootherTimedOut("Smoothing time exceed allowed duration");
+      if (timed_out || steady_clock::now() - start >= max_duration) {
+        timed_out = true;
+        return;
       }
-
-      // Smooth path segment
-      success = success && smoothImpl(curr_path_segment, reversing_segment);
-
-      // Assemble the path changes to the main path
-      std::copy(
-        curr_path_segment.poses.begin(),
-        curr_path_segment.poses.end(),
-        path.poses.begin() + path_segments[i].start);
-    }
+      bool reversing_segment;
+      smoothSegment(path, path_segments[i], reversing_segment);
+    });
+
+  if (timed_out) {
+    RCLCPP_WARN(
+      logger_,
+      "Smoothing time exceeded allowed duration of %0.2f.", max_time.seconds());
+    throw nav2_core::SmootherTimedOut("Smoothing time exceed allowed duration");
   }
 
-  return success;
+  return true;
 }
 
-bool SavitzkyGolaySmoother::smoothImpl(
+void SavitzkyGolaySmoother::smoothSegment(
   nav_msgs::msg::Path & path,
+  const PathSegment & segment,
   bool & reversing_segment)
 {
-  // Must be at least 10 in length to enter function
-  const unsigned int & path_size = path.poses.size();
+  // The coordinates are filtered as contiguous arrays rather than through the poses
+  const size_t size = segment.end - segment.start + 1;
+  std::vector<double> xs(size), ys(size);
+  for (size_t i = 0; i < size; i++) {
+    xs[i] = path.poses[segment.start + i].pose.position.x;
+    ys[i] = path.poses[segment.start + i].pose.position.y;
+  }
 
+  applyFilter(xs.data(), ys.data(), size);
+
+  // Lets do additional refinement, it shouldn't take more than a couple milliseconds
+  if (do_refinement_) {
+    for (int i = 0; i < refinement_num_; i++) {
+      applyFilter(xs.data(), ys.data(), size);
+    }
+  }
+
+  // The first and last points are fixed
+  for (size_t i = 1; i + 1 < size; i++) {
+    path.poses[segment.start + i].pose.position.x = xs[i];
+    path.poses[segment.start + i].pose.position.y = ys[i];
+  }
+
+  updateApproximatePathOrientations(
+    path.poses.begin() + segment.start, path.poses.begin() + segment.end + 1,
+    reversing_segment);
+}
+
+void SavitzkyGolaySmoother::applyFilter(double * xs, double * ys, size_t size)
+{
   // 7-point SG filter
   const std::array<double, 7> filter = {
     -2.0 / 21.0,
@@ -106,91 +134,42 @@ bool SavitzkyGolaySmoother::smoothImpl(
     3.0 / 21.0,
     -2.0 / 21.0};
 
-  auto applyFilter = [&](const std::vector<geometry_msgs::msg::Point> & data)
-    -> geometry_msgs::msg::Point
-    {
-      geometry_msgs::msg::Point val;
-      for (unsigned int i = 0; i != filter.size(); i++) {
-        val.x += filter[i] * data[i].x;
-        val.y += filter[i] * data[i].y;
+  // The filter is applied in place, so that each point is filtered with the points
+  // before it already filtered. Near the boundaries, the window repeats the first or
+  // last point.
+  auto filterPoint = [&](size_t idx, const std::array<size_t, 7> & window) {
+      double x = 0.0, y = 0.0;
+      for (size_t k = 0; k != filter.size(); k++) {
+        x += filter[k] * xs[window[k]];
+        y += filter[k] * ys[window[k]];
       }
-      return val;
+      xs[idx] = x;
+      ys[idx] = y;
     };
 
-  auto applyFilterOverAxes =
-    [&](std::vector<geometry_msgs::msg::PoseStamped> & plan_pts) -> void
-    {
-      // Handle initial boundary conditions, first point is fixed
-      unsigned int idx = 1;
-      plan_pts[idx].pose.position = applyFilter(
-      {
-        plan_pts[idx - 1].pose.position,
-        plan_pts[idx - 1].pose.position,
-        plan_pts[idx - 1].pose.position,
-        plan_pts[idx].pose.position,
-        plan_pts[idx + 1].pose.position,
-        plan_pts[idx + 2].pose.position,
-        plan_pts[idx + 3].pose.position});
-
-      idx++;
-      plan_pts[idx].pose.position = applyFilter(
-      {
-        plan_pts[idx - 2].pose.position,
-        plan_pts[idx - 2].pose.position,
-        plan_pts[idx - 1].pose.position,
-        plan_pts[idx].pose.position,
-        plan_pts[idx + 1].pose.position,
-        plan_pts[idx + 2].pose.position,
-        plan_pts[idx + 3].pose.position});
-
-      // Apply nominal filter
-      for (idx = 3; idx < path_size - 4; ++idx) {
-        plan_pts[idx].pose.position = applyFilter(
-        {
-          plan_pts[idx - 3].pose.position,
-          plan_pts[idx - 2].pose.position,
-          plan_pts[idx - 1].pose.position,
-          plan_pts[idx].pose.position,
-          plan_pts[idx + 1].pose.position,
-          plan_pts[idx + 2].pose.position,
-          plan_pts[idx + 3].pose.position});
-      }
-
-      // Handle terminal boundary conditions, last point is fixed
-      idx++;
-      plan_pts[idx].pose.position = applyFilter(
-      {
-        plan_pts[idx - 3].pose.position,
-        plan_pts[idx - 2].pose.position,
-        plan_pts[idx - 1].pose.position,
-        plan_pts[idx].pose.position,
-        plan_pts[idx + 1].pose.position,
-        plan_pts[idx + 2].pose.position,
-        plan_pts[idx + 2].pose.position});
-
-      idx++;
-      plan_pts[idx].pose.position = applyFilter(
-      {
-        plan_pts[idx - 3].pose.position,
-        plan_pts[idx - 2].pose.position,
-        plan_pts[idx - 1].pose.position,
-        plan_pts[idx].pose.position,
-        plan_pts[idx + 1].pose.position,
-        plan_pts[idx + 1].pose.position,
-        plan_pts[idx + 1].pose.position});
-    };
-
-  applyFilterOverAxes(path.poses);
-
-  // Lets do additional refinement, it shouldn't take more than a couple milliseconds
-  if (do_refinement_) {
-    for (int i = 0; i < refinement_num_; i++) {
-      applyFilterOverAxes(path.poses);
+  // Handle initial boundary conditions, first point is fixed
+  filterPoint(1, {0, 0, 0, 1, 2, 3, 4});
+  filterPoint(2, {0, 0, 1, 2, 3, 4, 5});
+
+  // Apply nominal filter, both axes in the same pass
+  for (size_t idx = 3; idx < size - 4; ++idx) {
+    const double * x = xs + idx - 3;
+    const double * y = ys + idx - 3;
+    double fx = 0.0, fy = 0.0;
+    for (size_t k = 0; k != filter.size(); k++) {
+      fx += filter[k] * x[k];
+      fy += filter[k] * y[k];
     }
+    xs[idx] = fx;
+    ys[idx] = fy;
   }
 
-  updateApproximatePathOrientations(path, reversing_segment);
-  return true;
+  // Handle terminal boundary conditions, last point is fixed. As always done by this
+  // filter, the point before the terminal ones is left as it is.
+  size_t idx = size - 3;
+  filterPoint(idx, {idx - 3, idx - 2, idx - 1, idx, idx + 1, idx + 2, idx + 2});
+  idx++;
+  filterPoint(idx, {idx - 3, idx - 2, idx - 1, idx, idx + 1, idx + 1, idx + 1});
 }
 
 }  // namespace nav2_smoother
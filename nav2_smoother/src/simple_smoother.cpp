@@ -60,6 +60,7 @@ bool SimpleSmoother::smooth(
   nav_msgs::msg::Path & path,
   const rclcpp::Duration & max_time)
 {
+  // The costmap is a read-only snapshot, it needs no lock
   auto costmap = costmap_sub_->getCostmap();
 
   steady_clock::time_point start = steady_clock::now();
@@ -72,8 +73,6 @@ bool SimpleSmoother::smooth(
 
   std::vector<PathSegment> path_segments = findDirectionalPathSegments(path);
 
-  std::lock_guard<nav2_costmap_2d::Costmap2D::mutex_t> lock(*(costmap->getMutex()));
-
   for (unsigned int i = 0; i != path_segments.size(); i++) {
     if (path_segments[i].end - path_segments[i].start > 9) {
       // Populate path segment
@@ -26,9 +26,11 @@
 #include "nav2_core/smoother.hpp"
 #include "nav2_core/planner_exceptions.hpp"
 #include "nav2_msgs/action/smooth_path.hpp"
+#include "nav2_msgs/action/smooth_paths.hpp"
 #include "nav2_smoother/nav2_smoother.hpp"
 
 using SmoothAction = nav2_msgs::action::SmoothPath;
+using SmoothBatchAction = nav2_msgs::action::SmoothPaths;
 using ClientGoalHandle = rclcpp_action::ClientGoalHandle<SmoothAction>;
 
 using namespace std::chrono_literals;
@@ -145,13 +147,7 @@ public:
 
   void setCostmap(nav2_msgs::msg::Costmap::SharedPtr msg)
   {
-    costmap_msg_ = msg;
-    costmap_ = std::make_shared<nav2_costmap_2d::Costmap2D>(
-      msg->metadata.size_x, msg->metadata.size_y,
-      msg->metadata.resolution, msg->metadata.origin.position.x,
-      msg->metadata.origin.position.y);
-
-    processCurrentCostmapMsg();
+    costmapCallback(msg);
   }
 };
 
@@ -246,6 +242,7 @@ public:
     smoother_server_->declare_parameter(
       "DummySmoothPath.plugin",
       rclcpp::ParameterValue(std::string("DummySmoother")));
+    smoother_server_->set_parameter(rclcpp::Parameter("batch_smoothing_threads", 2));
     smoother_server_->configure();
     smoother_server_->activate();
 
@@ -254,6 +251,11 @@ public:
       node_->get_node_graph_interface(),
       node_->get_node_logging_interface(),
       node_->get_node_waitables_interface(), "smooth_path");
+    batch_client_ = rclcpp_action::create_client<SmoothBatchAction>(
+      node_->get_node_base_interface(),
+      node_->get_node_graph_interface(),
+      node_->get_node_logging_interface(),
+      node_->get_node_waitables_interface(), "smooth_paths");
     std::cout << "Setup complete." << std::endl;
   }
 
@@ -264,6 +266,7 @@ public:
     smoother_server_->shutdown();
     smoother_server_.reset();
     client_.reset();
+    batch_client_.reset();
     node_.reset();
   }
 
@@ -324,6 +327,7 @@ public:
   std::shared_ptr<rclcpp::Node> node_;
   std::shared_ptr<DummySmootherServer> smoother_server_;
   std::shared_ptr<rclcpp_action::Client<SmoothAction>> client_;
+  std::shared_ptr<rclcpp_action::Client<SmoothBatchAction>> batch_client_;
   std::shared_ptr<rclcpp_action::ClientGoalHandle<SmoothAction>> goal_handle_;
 };
 
@@ -388,6 +392,51 @@ TEST_F(SmootherTest, testingCollisionCheckDisabled)
   SUCCEED();
 }
 
+TEST_F(SmootherTest, testingBatchSmoothing)
+{
+  ASSERT_TRUE(batch_client_->wait_for_action_server(4s));
+
+  geometry_msgs::msg::PoseStamped pose;
+  pose.pose.orientation.w = 1.0;
+  auto goal = SmoothBatchAction::Goal();
+  goal.smoother_id = "DummySmoothPath";
+  goal.max_smoothing_duration = rclcpp::Duration(500ms);
+  goal.check_for_collisions = true;
+  // the second path fails, its start and goal being the same
+  for (double x_goal : {1.0, 0.0, 2.0}) {
+    nav_msgs::msg::Path path;
+    path.poses.push_back(pose);
+    pose.pose.position.x = x_goal;
+    path.poses.push_back(pose);
+    pose.pose.position.x = 0.0;
+    goal.paths.push_back(path);
+  }
+
+  size_t feedback_count = 0;
+  auto send_goal_options = rclcpp_action::Client<SmoothBatchAction>::SendGoalOptions();
+  send_goal_options.feedback_callback =
+    [&](auto, const std::shared_ptr<const SmoothBatchAction::Feedback>) {feedback_count++;};
+  auto future_goal = batch_client_->async_send_goal(goal, send_goal_options);
+  ASSERT_EQ(
+    rclcpp::spin_until_future_complete(node_, future_goal),
+    rclcpp::FutureReturnCode::SUCCESS);
+  auto goal_handle = future_goal.get();
+  ASSERT_TRUE(goal_handle);
+
+  auto future_result = batch_client_->async_get_result(goal_handle);
+  rclcpp::spin_until_future_complete(node_, future_result);
+  auto result = future_result.get();
+  EXPECT_EQ(result.code, rclcpp_action::ResultCode::SUCCEEDED);
+  ASSERT_EQ(result.result->paths.size(), 3u);
+  EXPECT_EQ(result.result->path_error_codes[0], SmoothBatchAction::Result::NONE);
+  EXPECT_EQ(result.result->path_error_codes[1], SmoothBatchAction::Result::UNKNOWN);
+  EXPECT_EQ(result.result->path_error_codes[2], SmoothBatchAction::Result::NONE);
+  EXPECT_EQ(result.result->paths[0].poses.size(), 3u);
+  EXPECT_EQ(result.result->paths[2].poses.size(), 3u);
+  EXPECT_TRUE(result.result->was_completed[0]);
+  EXPECT_EQ(feedback_count, 3u);
+}
+
 TEST(SmootherConfigTest, testingConfigureSuccessWithValidSmootherPlugin)
 {
   auto smoother_server = std::make_shared<DummySmootherServer>();
@@ -0,0 +1,130 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "latency_recorder.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace nav2_system_tests
+{
+
+void LatencyRecorder::add(const std::string & name, std::chrono::nanoseconds latency)
+{
+  latencies_[name].push_back(std::chrono::duration<double, std::milli>(latency).count());
+}
+
+double LatencyRecorder::percentile(const std::string & name, double percentile) const
+{
+  auto it = latencies_.find(name);
+  if (it == latencies_.end() || it->second.empty()) {
+    return 0.0;
+  }
+
+  // Nearest rank, so that the percentile is always a measured latency
+  std::vector<double> sorted = it->second;
+  std::sort(sorted.begin(), sorted.end());
+  const double rank = std::ceil(percentile / 100.0 * static_cast<double>(sorted.size()));
+  const size_t index = static_cast<size_t>(std::max(rank, 1.0)) - 1;
+  return sorted[std::min(index, sorted.size() - 1)];
+}
+
+LatencyRecorder::Baseline LatencyRecorder::summary() const
+{
+  Baseline result;
+  for (const auto & latencies : latencies_) {
+    auto & values = result[latencies.first];
+    for (size_t i = 0; i < percentiles.size(); ++i) {
+      values[i] = percentile(latencies.first, percentiles[i]);
+    }
+  }
+  return result;
+}
+
+void LatencyRecorder::report(std::ostream & stream) const
+{
+  const Baseline values = summary();
+  for (const auto & value : values) {
+    stream << std::left << std::setw(32) << value.first << " samples: " <<
+      std::setw(6) << latencies_.at(value.first).size();
+    for (size_t i = 0; i < percentiles.size(); ++i) {
+      stream << " p" << percentiles[i] << ": " << std::fixed << std::setprecision(3) <<
+        value.second[i] << " ms";
+    }
+    stream << std::endl;
+  }
+}
+
+std::vector<std::string> LatencyRecorder::findRegressions(
+  const std::string & name, const Baseline & baseline, double threshold) const
+{
+  std::vector<std::string> regressions;
+  auto reference = baseline.find(name);
+  if (reference == baseline.end()) {
+    return regressions;
+  }
+
+  for (size_t i = 0; i < percentiles.size(); ++i) {
+    const double measured = percentile(name, percentiles[i]);
+    const double allowed = reference->second[i] * (1.0 + threshold);
+    if (measured > allowed) {
+      std::stringstream ss;
+      ss << name << " p" << percentiles[i] << " of " << measured << " ms exceeds " << allowed <<
+        " ms (baseline " << reference->second[i] << " ms)";
+      regressions.push_back(ss.str());
+    }
+  }
+  return regressions;
+}
+
+LatencyRecorder::Baseline LatencyRecorder::loadBaseline(const std::string & filename)
+{
+  Baseline baseline;
+  std::ifstream file(filename);
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream iss(line);
+    std::string name;
+    std::array<double, 3> values;
+    if (iss >> name >> values[0] >> values[1] >> values[2]) {
+      baseline[name] = values;
+    }
+  }
+  return baseline;
+}
+
+bool LatencyRecorder::writeBaseline(const std::string & filename) const
+{
+  std::ofstream file(filename);
+  if (!file.good()) {
+    return false;
+  }
+  file << "# operation p50_ms p90_ms p99_ms" << std::endl;
+  for (const auto & value : summary()) {
+    file << value.first << " " << value.second[0] << " " << value.second[1] << " " <<
+      value.second[2] << std::endl;
+  }
+  return file.good();
+}
+
+}  // namespace nav2_system_tests
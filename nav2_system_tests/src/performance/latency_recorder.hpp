@@ -0,0 +1,96 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef PERFORMANCE__LATENCY_RECORDER_HPP_
+#define PERFORMANCE__LATENCY_RECORDER_HPP_
+
+#include <array>
+#include <chrono>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace nav2_system_tests
+{
+
+/**
+ * @class LatencyRecorder
+ * @brief Collects the latencies of named operations and compares their
+ * percentiles against a baseline recorded on a previous run
+ */
+class LatencyRecorder
+{
+public:
+  // Percentiles reported and compared, in percent
+  static constexpr std::array<double, 3> percentiles{50.0, 90.0, 99.0};
+
+  // Latency percentiles of each operation, in milliseconds, ordered as percentiles
+  using Baseline = std::map<std::string, std::array<double, 3>>;
+
+  /**
+   * @brief Record a latency of an operation
+   * @param name Name of the operation
+   * @param latency Measured latency
+   */
+  void add(const std::string & name, std::chrono::nanoseconds latency);
+
+  /**
+   * @brief Get a percentile of the latencies of an operation
+   * @param name Name of the operation
+   * @param percentile Percentile, in percent
+   * @return Latency in milliseconds, 0 if none was recorded
+   */
+  double percentile(const std::string & name, double percentile) const;
+
+  /**
+   * @brief Get the percentiles of the latencies recorded for each operation
+   */
+  Baseline summary() const;
+
+  /**
+   * @brief Print the number of samples and percentiles of each operation
+   */
+  void report(std::ostream & stream) const;
+
+  /**
+   * @brief Compare the percentiles of an operation with a baseline
+   * @param name Name of the operation
+   * @param baseline Baseline to compare with
+   * @param threshold Allowed relative increase over the baseline, e.g. 0.25 for 25%
+   * @return Description of each percentile exceeding the baseline by more than the threshold
+   */
+  std::vector<std::string> findRegressions(
+    const std::string & name, const Baseline & baseline, double threshold) const;
+
+  /**
+   * @brief Load a baseline written by writeBaseline()
+   * @return The baseline, empty if the file could not be read
+   */
+  static Baseline loadBaseline(const std::string & filename);
+
+  /**
+   * @brief Write the percentiles of the recorded operations as a baseline
+   * @return false if the file could not be written
+   */
+  bool writeBaseline(const std::string & filename) const;
+
+private:
+  std::map<std::string, std::vector<double>> latencies_;
+};
+
+}  // namespace nav2_system_tests
+
+#endif  // PERFORMANCE__LATENCY_RECORDER_HPP_
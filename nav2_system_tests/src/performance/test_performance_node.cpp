@@ -0,0 +1,192 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "behaviortree_cpp/bt_factory.h"
+#include "behaviortree_cpp/utils/shared_library.h"
+#include "ament_index_cpp/get_package_share_directory.hpp"
+#include "nav2_behavior_tree/plugins_list.hpp"
+#include "nav2_util/odometry_utils.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "tf2_ros/buffer.h"
+#include "tf2_ros/create_timer_ros.h"
+#include "tf2_ros/transform_listener.h"
+
+#include "../behavior_tree/server_handler.hpp"
+#include "../planning/planner_tester.hpp"
+#include "latency_recorder.hpp"
+
+using namespace std::chrono_literals;
+
+using nav2_system_tests::LatencyRecorder;
+using nav2_system_tests::PlannerTester;
+using nav2_system_tests::ServerHandler;
+
+// Latencies of all the scenarios, compared against the baseline as each one completes
+// and written to PERF_RESULTS at the end of the run
+LatencyRecorder recorder;
+
+std::string getEnv(const char * name, const std::string & default_value = "")
+{
+  const char * value = std::getenv(name);
+  return value == nullptr ? default_value : std::string(value);
+}
+
+// Fails the current test if the latencies of an operation regressed from PERF_BASELINE
+void expectWithinBaseline(const std::string & name)
+{
+  const std::string baseline_file = getEnv("PERF_BASELINE");
+  if (baseline_file.empty()) {
+    return;
+  }
+
+  const auto baseline = LatencyRecorder::loadBaseline(baseline_file);
+  if (baseline.find(name) == baseline.end()) {
+    std::cout << "No baseline for " << name << " in " << baseline_file << std::endl;
+    return;
+  }
+
+  const double threshold = std::stod(getEnv("PERF_THRESHOLD", "0.25"));
+  for (const auto & regression : recorder.findRegressions(name, baseline, threshold)) {
+    ADD_FAILURE() << regression;
+  }
+}
+
+TEST(PerformanceTest, PlannerLatency)
+{
+  auto tester = std::make_shared<PlannerTester>();
+  tester->activate();
+  tester->loadDefaultMap();
+  tester->clearPlanLatencies();
+
+  EXPECT_TRUE(tester->defaultPlannerRandomTests(200, 0.1));
+  for (const auto & latency : tester->getPlanLatencies()) {
+    recorder.add("planner_server.create_plan", latency);
+  }
+  expectWithinBaseline("planner_server.create_plan");
+  tester->deactivate();
+}
+
+TEST(PerformanceTest, CostmapUpdateLatency)
+{
+  auto tester = std::make_shared<PlannerTester>();
+  tester->activate();
+  tester->loadDefaultMap();
+
+  // Let the static layer receive the map before measuring full updates
+  std::this_thread::sleep_for(2s);
+  for (int i = 0; i < 200; ++i) {
+    recorder.add("planner_server.costmap_update", tester->updateCostmap());
+  }
+  expectWithinBaseline("planner_server.costmap_update");
+  tester->deactivate();
+}
+
+TEST(PerformanceTest, BehaviorTreeTickLatency)
+{
+  auto server_handler = std::make_shared<ServerHandler>();
+  server_handler->activate();
+
+  auto node = rclcpp::Node::make_shared("performance_bt_handler");
+  auto tf = std::make_shared<tf2_ros::Buffer>(node->get_clock());
+  auto timer_interface = std::make_shared<tf2_ros::CreateTimerROS>(
+    node->get_node_base_interface(), node->get_node_timers_interface());
+  tf->setCreateTimerInterface(timer_interface);
+  tf->setUsingDedicatedThread(true);
+  auto tf_listener = std::make_shared<tf2_ros::TransformListener>(*tf, node, false);
+  auto odom_smoother = std::make_shared<nav2_util::OdomSmoother>(node);
+
+  BT::BehaviorTreeFactory factory;
+  std::stringstream plugin_libs(nav2::details::BT_BUILTIN_PLUGINS);
+  std::string plugin;
+  while (std::getline(plugin_libs, plugin, ';')) {
+    factory.registerFromPlugin(BT::SharedLibrary::getOSName(plugin));
+  }
+
+  const std::string bt_file =
+    ament_index_cpp::get_package_share_directory("nav2_bt_navigator") +
+    "/behavior_trees/navigate_to_pose_w_replanning_and_recovery.xml";
+  std::ifstream xml_file(bt_file);
+  ASSERT_TRUE(xml_file.good());
+  std::stringstream xml;
+  xml << xml_file.rdbuf();
+
+  // Navigate repeatedly to a goal with the planner and controller servers replaced by dummies
+  for (int run = 0; run < 10; ++run) {
+    server_handler->reset();
+
+    auto blackboard = BT::Blackboard::create();
+    blackboard->set("node", node);  // NOLINT
+    blackboard->set<std::chrono::milliseconds>("server_timeout", 20ms);  // NOLINT
+    blackboard->set<std::chrono::milliseconds>("bt_loop_duration", 10ms);  // NOLINT
+    blackboard->set<std::chrono::milliseconds>("wait_for_service_timeout", 1000ms);  // NOLINT
+    blackboard->set("tf_buffer", tf);  // NOLINT
+    blackboard->set("initial_pose_received", false);  // NOLINT
+    blackboard->set("number_recoveries", 0);  // NOLINT
+    blackboard->set("odom_smoother", odom_smoother);  // NOLINT
+
+    geometry_msgs::msg::PoseStamped goal;
+    goal.header.stamp = node->now();
+    goal.header.frame_id = "map";
+    goal.pose.orientation.w = 1.0;
+    blackboard->set("goal", goal);  // NOLINT
+
+    auto tree = factory.createTreeFromText(xml.str(), blackboard);
+
+    BT::NodeStatus result = BT::NodeStatus::RUNNING;
+    while (result == BT::NodeStatus::RUNNING) {
+      auto start = std::chrono::steady_clock::now();
+      result = tree.tickOnce();
+      recorder.add("bt_navigator.tick", std::chrono::steady_clock::now() - start);
+      std::this_thread::sleep_for(10ms);
+    }
+    EXPECT_EQ(result, BT::NodeStatus::SUCCESS);
+  }
+  expectWithinBaseline("bt_navigator.tick");
+
+  server_handler->deactivate();
+}
+
+int main(int argc, char ** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+
+  // initialize ROS
+  rclcpp::init(argc, argv);
+
+  bool all_successful = RUN_ALL_TESTS();
+
+  recorder.report(std::cout);
+  const std::string results_file = getEnv("PERF_RESULTS");
+  if (!results_file.empty() && !recorder.writeBaseline(results_file)) {
+    std::cerr << "Failed to write the results to " << results_file << std::endl;
+  }
+
+  // shutdown ROS
+  rclcpp::shutdown();
+
+  return all_successful;
+}
@@ -390,13 +390,21 @@ TaskStatus PlannerTester::createPlan(
   planner_tester_->setCostmap(costmap_.get());
 
   // Call planning algorithm
-  if (planner_tester_->createPath(goal, path)) {
+  auto start = steady_clock::now();
+  bool created = planner_tester_->createPath(goal, path);
+  plan_latencies_.push_back(steady_clock::now() - start);
+  if (created) {
     return TaskStatus::SUCCEEDED;
   }
 
   return TaskStatus::FAILED;
 }
 
+nanoseconds PlannerTester::updateCostmap()
+{
+  return planner_tester_->updateCostmap();
+}
+
 bool PlannerTester::isPathValid(nav_msgs::msg::Path & path)
 {
   planner_tester_->setCostmap(costmap_.get());
@@ -16,10 +16,12 @@
 #define PLANNING__PLANNER_TESTER_HPP_
 
 #include <gtest/gtest.h>
+#include <chrono>
 #include <memory>
 #include <string>
 #include <thread>
 #include <algorithm>
+#include <vector>
 
 #include "rclcpp/rclcpp.hpp"
 #include "rclcpp_action/rclcpp_action.hpp"
@@ -101,6 +103,14 @@ public:
     return true;
   }
 
+  // Runs one update of the costmap layers and returns its duration
+  std::chrono::nanoseconds updateCostmap()
+  {
+    auto start = std::chrono::steady_clock::now();
+    costmap_ros_->updateMap();
+    return std::chrono::steady_clock::now() - start;
+  }
+
   void onCleanup(const rclcpp_lifecycle::State & state)
   {
     on_cleanup(state);
@@ -163,6 +173,20 @@ public:
 
   bool isPathValid(nav_msgs::msg::Path & path);
 
+  // Durations of the planner calls made since the last call to clearPlanLatencies()
+  const std::vector<std::chrono::nanoseconds> & getPlanLatencies() const
+  {
+    return plan_latencies_;
+  }
+
+  void clearPlanLatencies()
+  {
+    plan_latencies_.clear();
+  }
+
+  // Runs one update of the costmap of the planner and returns its duration
+  std::chrono::nanoseconds updateCostmap();
+
 private:
   void setCostmap();
 
@@ -191,6 +215,7 @@ private:
 
   // The global planner
   std::shared_ptr<NavFnPlannerTester> planner_tester_;
+  std::vector<std::chrono::nanoseconds> plan_latencies_;
 
   // The is path valid client
   rclcpp::Client<nav2_msgs::srv::IsPathValid>::SharedPtr path_valid_client_;
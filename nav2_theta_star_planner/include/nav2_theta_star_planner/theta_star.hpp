@@ -27,6 +27,9 @@ const double INF_COST = DBL_MAX;
 const int UNKNOWN_COST = 255;
 const int OBS_COST = 254;
 const int LETHAL_COST = 252;
+/// axis-aligned line of sight checks shorter than this only compute a visibility line
+/// if it was already computed during the search
+const int MIN_VISIBILITY_LENGTH = 8;
 
 struct coordsM
 {
@@ -48,6 +51,15 @@ struct tree_node
   double f = INF_COST;
 };
 
+struct visibility_line
+{
+  int search_id = -1;
+  /// number of consecutive cells with a line of sight along the line from each cell
+  std::vector<int> run;
+  /// traversal cost summed along the line up to each cell
+  std::vector<double> cost;
+};
+
 struct comp
 {
   bool operator()(const tree_node * p1, const tree_node * p2)
@@ -78,6 +90,8 @@ public:
   int size_x_, size_y_;
   /// the interval at which the planner checks if it has been cancelled
   int terminal_checking_interval_;
+  /// parameter to set whether axis-aligned line of sight checks use visibility lines
+  bool use_visibility_cache_;
 
   ThetaStar();
 
@@ -146,6 +160,13 @@ protected:
   /// consecutively in nodes_data_
   int index_generated_;
 
+  /// the visibility lines of the rows and columns of the costmap, computed when first checked
+  /// during a search and kept allocated across searches
+  std::vector<visibility_line> row_visibility_, column_visibility_;
+
+  /// the index of the current search, to know which visibility lines are up to date
+  int search_id_;
+
   const coordsM moves[8] = {{0, 1},
     {0, -1},
     {1, 0},
@@ -181,7 +202,26 @@ protected:
    */
   bool losCheck(
     const int & x0, const int & y0, const int & x1, const int & y1,
-    double & sl_cost) const;
+    double & sl_cost);
+
+  /**
+   * @brief performs the line of sight check between two points on the same row or column
+   *            from the visibility line of that row or column, in constant time once computed
+   * @param sl_cost is used to return the cost thus incurred
+   * @return true if a line of sight exists between the points
+   */
+  bool axisLosCheck(
+    const int & x0, const int & y0, const int & x1, const int & y1,
+    double & sl_cost);
+
+  /**
+   * @brief computes the visibility line of a row or a column, with the cells and costs
+   *            losCheck uses for a line along it
+   * @param along_row whether the line is a row, else a column
+   * @param index the y of the row or the x of the column
+   * @param line used to return the visibility line
+   */
+  void computeVisibilityLine(const bool & along_row, const int & index, visibility_line & line);
 
   /**
    * @brief it returns the path by backtracking from the goal to the start, by using their parent nodes
@@ -306,6 +346,7 @@ protected:
 
   /**
    * @brief initialises the values of global variables at beginning of the execution of the generatePath function
+   *            only clearing the node_position_ entries of the last search on the same map size
    */
   void resetContainers();
 
@@ -12,6 +12,7 @@
 //  See the License for the specific language governing permissions and
 //  limitations under the License.
 
+#include <algorithm>
 #include <vector>
 #include "nav2_core/planner_exceptions.hpp"
 #include "nav2_theta_star_planner/theta_star.hpp"
@@ -28,7 +29,9 @@ ThetaStar::ThetaStar()
   size_x_(0),
   size_y_(0),
   terminal_checking_interval_(5000),
-  index_generated_(0)
+  use_visibility_cache_(false),
+  index_generated_(0),
+  search_id_(0)
 {
   exp_node = new tree_node;
 }
@@ -96,9 +99,15 @@ void ThetaStar::resetParent(tree_node * curr_data)
   const tree_node * curr_par = curr_data->parent_id;
   const tree_node * maybe_par = curr_par->parent_id;
 
+  // the traversal cost of the line of sight is positive, so skip checking it when the
+  // distance alone would not make the parent of the parent a better parent
+  const double euc_cost = getEuclideanCost(curr_data->x, curr_data->y, maybe_par->x, maybe_par->y);
+  if (maybe_par->g + euc_cost >= curr_data->g) {
+    return;
+  }
+
   if (losCheck(curr_data->x, curr_data->y, maybe_par->x, maybe_par->y, los_cost)) {
-    g_cost = maybe_par->g +
-      getEuclideanCost(curr_data->x, curr_data->y, maybe_par->x, maybe_par->y) + los_cost;
+    g_cost = maybe_par->g + euc_cost + los_cost;
 
     if (g_cost < curr_data->g) {
       curr_data->parent_id = maybe_par;
@@ -179,8 +188,19 @@ void ThetaStar::backtrace(std::vector<coordsW> & raw_points, const tree_node * c
 
 bool ThetaStar::losCheck(
   const int & x0, const int & y0, const int & x1, const int & y1,
-  double & sl_cost) const
+  double & sl_cost)
 {
+  if (use_visibility_cache_ && (x0 == x1) != (y0 == y1) &&
+    static_cast<int>(row_visibility_.size()) == size_y_ &&
+    static_cast<int>(column_visibility_.size()) == size_x_)
+  {
+    // a short check is not worth computing the whole line, unless it already is
+    const visibility_line & line = y0 == y1 ? row_visibility_[y0] : column_visibility_[x0];
+    if (line.search_id == search_id_ || abs(x1 - x0) + abs(y1 - y0) >= MIN_VISIBILITY_LENGTH) {
+      return axisLosCheck(x0, y0, x1, y1, sl_cost);
+    }
+  }
+
   sl_cost = 0;
 
   int cx, cy;
@@ -234,23 +254,78 @@ bool ThetaStar::losCheck(
   return true;
 }
 
+bool ThetaStar::axisLosCheck(
+  const int & x0, const int & y0, const int & x1, const int & y1,
+  double & sl_cost)
+{
+  const bool along_row = y0 == y1;
+  visibility_line & line = along_row ? row_visibility_[y0] : column_visibility_[x0];
+  const int begin = along_row ? std::min(x0, x1) : std::min(y0, y1);
+  const int end = along_row ? std::max(x0, x1) : std::max(y0, y1);
+
+  if (line.search_id != search_id_) {
+    computeVisibilityLine(along_row, along_row ? y0 : x0, line);
+  }
+
+  sl_cost = 0;
+  if (line.run[begin] < end - begin) {
+    return false;
+  }
+  sl_cost = line.cost[end] - line.cost[begin];
+  return true;
+}
+
+void ThetaStar::computeVisibilityLine(
+  const bool & along_row, const int & index, visibility_line & line)
+{
+  // as in losCheck, the cells crossed between two points on a row are those from the lower
+  // one (excluded) of the two, on that row or else on the row below, and likewise for columns
+  const int length = along_row ? size_x_ : size_y_;
+  line.run.resize(length + 1);
+  line.cost.resize(length + 1);
+  line.cost[0] = 0;
+  for (int i = 0; i < length; i++) {
+    const int cx = along_row ? i : index;
+    const int cy = along_row ? index : i;
+    const int bx = along_row ? cx : cx - 1;
+    const int by = along_row ? cy - 1 : cy;
+    double cost = 0;
+    line.run[i] = isSafe(cx, cy, cost) || (withinLimits(bx, by) && isSafe(bx, by, cost));
+    line.cost[i + 1] = line.cost[i] + cost;
+  }
+  line.run[length] = 0;
+  for (int i = length - 1; i >= 0; i--) {
+    line.run[i] = line.run[i] ? line.run[i + 1] + 1 : 0;
+  }
+  line.search_id = search_id_;
+}
+
 void ThetaStar::resetContainers()
 {
-  index_generated_ = 0;
-  int last_size_x = size_x_;
-  int last_size_y = size_y_;
   int curr_size_x = static_cast<int>(costmap_->getSizeInCellsX());
   int curr_size_y = static_cast<int>(costmap_->getSizeInCellsY());
-  if (((last_size_x != curr_size_x) || (last_size_y != curr_size_y)) &&
-    static_cast<int>(node_position_.size()) < (curr_size_x * curr_size_y))
+  size_t curr_size = static_cast<size_t>(curr_size_x) * curr_size_y;
+  if (curr_size_x != size_x_ || curr_size_y != size_y_ ||
+    node_position_.size() < curr_size || nodes_data_.capacity() < curr_size)
   {
-    initializePosn(curr_size_y * curr_size_x - last_size_y * last_size_x);
-    nodes_data_.reserve(curr_size_x * curr_size_y);
+    node_position_.assign(curr_size, nullptr);
+    nodes_data_.reserve(curr_size);
   } else {
-    initializePosn();
+    // only the nodes of the last search were set, so the rest of the map is left untouched
+    const int last_nodes = std::min(index_generated_, static_cast<int>(nodes_data_.size()));
+    for (int i = 0; i < last_nodes; i++) {
+      node_position_[size_x_ * nodes_data_[i].y + nodes_data_[i].x] = nullptr;
+    }
   }
+  index_generated_ = 0;
   size_x_ = curr_size_x;
   size_y_ = curr_size_y;
+
+  search_id_++;
+  if (use_visibility_cache_) {
+    row_visibility_.resize(size_y_);
+    column_visibility_.resize(size_x_);
+  }
 }
 
 void ThetaStar::initializePosn(int size_inc)
@@ -63,6 +63,10 @@ void ThetaStarPlanner::configure(
     node, name_ + ".terminal_checking_interval", rclcpp::ParameterValue(5000));
   node->get_parameter(name_ + ".terminal_checking_interval", planner_->terminal_checking_interval_);
 
+  nav2_util::declare_parameter_if_not_declared(
+    node, name_ + ".use_visibility_cache", rclcpp::ParameterValue(false));
+  node->get_parameter(name_ + ".use_visibility_cache", planner_->use_visibility_cache_);
+
   nav2_util::declare_parameter_if_not_declared(
     node, name + ".use_final_approach_orientation", rclcpp::ParameterValue(false));
   node->get_parameter(name + ".use_final_approach_orientation", use_final_approach_orientation_);
@@ -250,6 +254,8 @@ ThetaStarPlanner::dynamicParametersCallback(std::vector<rclcpp::Parameter> param
         use_final_approach_orientation_ = parameter.as_bool();
       } else if (name == name_ + ".allow_unknown") {
         planner_->allow_unknown_ = parameter.as_bool();
+      } else if (name == name_ + ".use_visibility_cache") {
+        planner_->use_visibility_cache_ = parameter.as_bool();
       }
     }
   }
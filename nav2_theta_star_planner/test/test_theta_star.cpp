@@ -144,6 +144,42 @@ TEST(ThetaStarTest, test_theta_star) {
   planner_->src_ = {10, 10};
   EXPECT_FALSE(planner_->runAlgo(path));
   EXPECT_EQ(static_cast<int>(path.size()), 0);
+
+  /// Check that the visibility lines give the same path, also when reusing the nodes of the last
+  /// search
+  planner_->src_ = s;
+  std::vector<coordsW> path_without_cache;
+  EXPECT_TRUE(planner_->runAlgo(path_without_cache));
+  planner_->use_visibility_cache_ = true;
+  path.clear();
+  EXPECT_TRUE(planner_->runAlgo(path));
+  ASSERT_EQ(path.size(), path_without_cache.size());
+  for (unsigned int i = 0; i < path.size(); i++) {
+    EXPECT_EQ(path[i].x, path_without_cache[i].x);
+    EXPECT_EQ(path[i].y, path_without_cache[i].y);
+  }
+  /// and the same line of sight checks along rows and columns
+  auto uncachedLosCheck = [&](const int & x0, const int & y0, const int & x1, const int & y1) {
+      planner_->use_visibility_cache_ = false;
+      bool los = planner_->ulosCheck(x0, y0, x1, y1, sl_cost);
+      planner_->use_visibility_cache_ = true;
+      return los;
+    };
+  double cached_sl_cost = 0.0;
+  for (int i = 1; i < 50; i += 3) {
+    for (int j = 0; j < 50; j += 7) {
+      bool los = planner_->ulosCheck(2, i, j, i, cached_sl_cost);
+      EXPECT_EQ(los, uncachedLosCheck(2, i, j, i));
+      if (los) {
+        EXPECT_NEAR(cached_sl_cost, sl_cost, 1e-9);
+      }
+      los = planner_->ulosCheck(i, 2, i, j, cached_sl_cost);
+      EXPECT_EQ(los, uncachedLosCheck(i, 2, i, j));
+      if (los) {
+        EXPECT_NEAR(cached_sl_cost, sl_cost, 1e-9);
+      }
+    }
+  }
 }
 
 // Smoke tests meant to detect issues arising from the plugin part rather than the algorithm
@@ -219,7 +255,8 @@ TEST(ThetaStarPlanner, test_theta_star_reconfigure)
       rclcpp::Parameter("test.w_traversal_cost", 2.0),
       rclcpp::Parameter("test.use_final_approach_orientation", false),
       rclcpp::Parameter("test.allow_unknown", false),
-      rclcpp::Parameter("test.terminal_checking_interval", 100)});
+      rclcpp::Parameter("test.terminal_checking_interval", 100),
+      rclcpp::Parameter("test.use_visibility_cache", true)});
 
   rclcpp::spin_until_future_complete(
     life_node->get_node_base_interface(),
@@ -233,6 +270,7 @@ TEST(ThetaStarPlanner, test_theta_star_reconfigure)
   EXPECT_EQ(life_node->get_parameter("test.use_final_approach_orientation").as_bool(), false);
   EXPECT_EQ(life_node->get_parameter("test.allow_unknown").as_bool(), false);
   EXPECT_EQ(life_node->get_parameter("test.terminal_checking_interval").as_int(), 100);
+  EXPECT_EQ(life_node->get_parameter("test.use_visibility_cache").as_bool(), true);
 
   rclcpp::spin_until_future_complete(
     life_node->get_node_base_interface(),
@@ -0,0 +1,50 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_UTIL__COMPACT_PATH_HPP_
+#define NAV2_UTIL__COMPACT_PATH_HPP_
+
+#include "nav2_msgs/msg/compact_path.hpp"
+#include "nav_msgs/msg/path.hpp"
+
+namespace nav2_util
+{
+
+/**
+ * @brief Convert a path to its compact form, with the header of the path. The poses are
+ * projected in the plane of the frame and their own headers are dropped.
+ * @param path Path to convert
+ * @param compact_path Output path, with no curvature nor velocity
+ */
+void toCompactPath(const nav_msgs::msg::Path & path, nav2_msgs::msg::CompactPath & compact_path);
+
+/**
+ * @brief Convert a compact path to a path, each pose given the header of the path
+ * @param compact_path Path to convert
+ * @param path Output path
+ * @return False if the arrays of the compact path are not of the same size
+ */
+bool fromCompactPath(
+  const nav2_msgs::msg::CompactPath & compact_path, nav_msgs::msg::Path & path);
+
+/**
+ * @brief Number of poses of a compact path
+ * @param compact_path Compact path
+ * @return Number of poses, or 0 if the arrays of the compact path are not of the same size
+ */
+size_t compactPathSize(const nav2_msgs::msg::CompactPath & compact_path);
+
+}  // namespace nav2_util
+
+#endif  // NAV2_UTIL__COMPACT_PATH_HPP_
@@ -0,0 +1,83 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef NAV2_UTIL__HEARTBEAT_REGISTRY_HPP_
+#define NAV2_UTIL__HEARTBEAT_REGISTRY_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace nav2_util
+{
+
+/**
+ * @class nav2_util::HeartbeatRegistry
+ * @brief Process-wide table of the heartbeat counters of the lifecycle nodes of this
+ * process, so that a lifecycle manager composed in the same process as the nodes it
+ * manages can check their liveness from a counter in memory instead of a bond, without
+ * heartbeat topics or timers on its side.
+ */
+class HeartbeatRegistry
+{
+public:
+  using Counter = std::atomic<uint64_t>;
+
+  /**
+   * @brief Announce that a lifecycle manager of this process checks the heartbeat
+   * of a node in memory
+   * @param node_name Fully qualified name of the node
+   */
+  static void manage(const std::string & node_name);
+
+  /**
+   * @brief Withdraw an announcement of manage()
+   * @param node_name Fully qualified name of the node
+   */
+  static void unmanage(const std::string & node_name);
+
+  /**
+   * @brief Whether a lifecycle manager of this process checks the heartbeat of a node
+   * @param node_name Fully qualified name of the node
+   * @return bool true if the node should beat its counter rather than create a bond
+   */
+  static bool isManaged(const std::string & node_name);
+
+  /**
+   * @brief Register the heartbeat counter of a node, replacing any previous one
+   * @param node_name Fully qualified name of the node
+   * @return Counter the node increments at its heartbeat period
+   */
+  static std::shared_ptr<Counter> add(const std::string & node_name);
+
+  /**
+   * @brief Unregister the heartbeat counter of a node. Holders of the counter keep it,
+   * but it no longer advances.
+   * @param node_name Fully qualified name of the node
+   */
+  static void remove(const std::string & node_name);
+
+  /**
+   * @brief Get the heartbeat counter of a node
+   * @param node_name Fully qualified name of the node
+   * @return Counter of the node, nullptr if it is not registered
+   */
+  static std::shared_ptr<const Counter> get(const std::string & node_name);
+};
+
+}  // namespace nav2_util
+
+#endif  // NAV2_UTIL__HEARTBEAT_REGISTRY_HPP_
@@ -21,6 +21,7 @@
 
 #include "rcl_interfaces/msg/parameter_descriptor.hpp"
 #include "nav2_util/node_thread.hpp"
+#include "nav2_util/heartbeat_registry.hpp"
 #include "rclcpp_lifecycle/lifecycle_node.hpp"
 #include "rclcpp/rclcpp.hpp"
 #include "bondcpp/bond.hpp"
@@ -176,7 +177,8 @@ public:
   virtual void on_rcl_preshutdown();
 
   /**
-   * @brief Create bond connection to lifecycle manager
+   * @brief Create bond connection to lifecycle manager, or beat a heartbeat counter
+   * in memory if a lifecycle manager of this process checks it instead
    */
   void createBond();
 
@@ -191,6 +193,12 @@ protected:
    */
   void printLifecycleNodeNotification();
 
+  /**
+   * @brief Log the current and peak bytes of the buffers tracked in the
+   * nav2_util::MemoryRegistry of the process, on activation and deactivation
+   */
+  void logMemoryUsage();
+
   /**
    * Register our preshutdown callback for this Node's rcl Context.
    * The callback fires before this Node's Context is shutdown.
@@ -207,6 +215,9 @@ protected:
   // Connection to tell that server is still up
   std::unique_ptr<bond::Bond> bond_{nullptr};
   double bond_heartbeat_period;
+  // Heartbeat in memory to a lifecycle manager in the same process, replacing the bond
+  std::shared_ptr<HeartbeatRegistry::Counter> heartbeat_;
+  rclcpp::TimerBase::SharedPtr heartbeat_timer_;
 };
 
 }  // namespace nav2_util
@@ -0,0 +1,141 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_UTIL__MEMORY_REGISTRY_HPP_
+#define NAV2_UTIL__MEMORY_REGISTRY_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace nav2_util
+{
+
+/**
+ * @class nav2_util::MemoryRegistry
+ * @brief Process-wide table of the bytes held by the large buffers of Nav2, such as the
+ * costmaps and the planner graphs, summed by tag, with the peak each tag reached since it
+ * was first used. Buffers report their size through a nav2_util::MemoryTracker.
+ */
+class MemoryRegistry
+{
+public:
+  /**
+   * @brief Current and peak bytes of a tag
+   */
+  struct Counter
+  {
+    /**
+     * @brief Account for bytes allocated, raising the peak if needed
+     * @param bytes Number of bytes
+     */
+    void add(size_t bytes);
+
+    /**
+     * @brief Account for bytes released
+     * @param bytes Number of bytes, at most those added
+     */
+    void subtract(size_t bytes);
+
+    /**
+     * @brief Get the bytes currently held
+     * @return Number of bytes
+     */
+    size_t current() const {return current_.load(std::memory_order_relaxed);}
+
+    /**
+     * @brief Get the highest number of bytes held at once
+     * @return Number of bytes
+     */
+    size_t peak() const {return peak_.load(std::memory_order_relaxed);}
+
+    std::atomic<size_t> current_{0};
+    std::atomic<size_t> peak_{0};
+  };
+
+  /**
+   * @brief Bytes of a tag at the time of a snapshot()
+   */
+  struct Usage
+  {
+    std::string tag;
+    size_t current;
+    size_t peak;
+  };
+
+  /**
+   * @brief Get the counter of a tag, creating it on first use
+   * @param tag Name of the buffers accounted for, e.g. "costmap_2d"
+   * @return Counter of the tag, kept for the lifetime of the process
+   */
+  static std::shared_ptr<Counter> get(const std::string & tag);
+
+  /**
+   * @brief Get the bytes of all tags
+   * @return Usage of each tag, sorted by tag
+   */
+  static std::vector<Usage> snapshot();
+
+  /**
+   * @brief Format the bytes of all tags used, for logs and diagnostics
+   * @return One "tag: current MiB (peak MiB)" entry per tag, separated by commas
+   */
+  static std::string summary();
+};
+
+/**
+ * @class nav2_util::MemoryTracker
+ * @brief Accounts for the size of a buffer in the counter of a tag of the
+ * nav2_util::MemoryRegistry, from its last update() until it is destroyed. Copies account
+ * for the same bytes again, as for the copy of the buffer they are held next to.
+ */
+class MemoryTracker
+{
+public:
+  /**
+   * @brief A constructor for nav2_util::MemoryTracker
+   * @param tag Tag to account the bytes to
+   */
+  explicit MemoryTracker(const std::string & tag);
+
+  MemoryTracker(const MemoryTracker & other);
+  MemoryTracker & operator=(const MemoryTracker & other);
+
+  /**
+   * @brief A destructor for nav2_util::MemoryTracker, releasing its bytes
+   */
+  ~MemoryTracker();
+
+  /**
+   * @brief Set the size of the buffer
+   * @param bytes Number of bytes the buffer holds now
+   */
+  void update(size_t bytes);
+
+  /**
+   * @brief Get the size of the buffer
+   * @return Number of bytes of the last update()
+   */
+  size_t bytes() const {return bytes_;}
+
+protected:
+  std::shared_ptr<MemoryRegistry::Counter> counter_;
+  size_t bytes_{0};
+};
+
+}  // namespace nav2_util
+
+#endif  // NAV2_UTIL__MEMORY_REGISTRY_HPP_
@@ -18,6 +18,7 @@
 #include <memory>
 
 #include "rclcpp/rclcpp.hpp"
+#include "nav2_util/node_utils.hpp"
 
 namespace nav2_util
 {
@@ -42,6 +43,23 @@ public:
   explicit NodeThread(
     rclcpp::executors::SingleThreadedExecutor::SharedPtr executor);
 
+  /**
+   * @brief A background thread to process node callbacks constructor, spinning a
+   * multi-threaded executor if the settings have more than one thread
+   * @param node_base Interface to Node to spin in thread
+   * @param settings Scheduling of the thread and number of threads of the executor
+   */
+  NodeThread(
+    rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_base,
+    const ThreadSettings & settings);
+
+  /**
+   * @brief A background thread to process executor's callbacks constructor
+   * @param executor Interface to executor to spin in thread
+   * @param settings Scheduling of the thread, the number of threads being unused
+   */
+  NodeThread(rclcpp::Executor::SharedPtr executor, const ThreadSettings & settings);
+
   /**
    * @brief A background thread to process node callbacks constructor
    * @param node Node pointer to spin in thread
@@ -57,6 +75,12 @@ public:
   ~NodeThread();
 
 protected:
+  /**
+   * @brief Applies the settings to the calling thread, logging failures
+   * @param settings Scheduling of the thread
+   */
+  static void applySettings(const ThreadSettings & settings);
+
   rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_;
   std::unique_ptr<std::thread> thread_;
   rclcpp::Executor::SharedPtr executor_;
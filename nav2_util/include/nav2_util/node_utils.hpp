@@ -16,6 +16,8 @@
 #ifndef NAV2_UTIL__NODE_UTILS_HPP_
 #define NAV2_UTIL__NODE_UTILS_HPP_
 
+#include <algorithm>
+#include <cstdint>
 #include <vector>
 #include <string>
 #include "rclcpp/rclcpp.hpp"
@@ -157,8 +159,66 @@ std::string get_plugin_type_param(
  * @brief Sets the caller thread to have a soft-realtime prioritization by
  * increasing the priority level of the host thread.
  * May throw exception if unable to set prioritization successfully
+ * @param priority SCHED_FIFO priority of the thread, from 1 to 99
  */
-void setSoftRealTimePriority();
+void setSoftRealTimePriority(int priority = 49);
+
+/**
+ * @brief Pins the caller thread to a CPU core.
+ * May throw exception if unable to set the affinity successfully
+ * @param cpu Index of the CPU core
+ */
+void setCpuAffinity(int cpu);
+
+/**
+ * @brief Restricts the caller thread to a set of CPU cores.
+ * May throw exception if unable to set the affinity successfully
+ * @param cpus Indices of the CPU cores
+ */
+void setCpuAffinity(const std::vector<int64_t> & cpus);
+
+/**
+ * @struct nav2_util::ThreadSettings
+ * @brief Scheduling of a thread of a server, and number of threads of the executor it spins.
+ * Threads started by a thread, such as those of a multi-threaded executor, inherit its
+ * scheduling.
+ */
+struct ThreadSettings
+{
+  int num_threads{1};  ///< Threads of the executor spun, if the thread creates it
+  int priority{0};  ///< SCHED_FIFO priority, or 0 to keep the default scheduling
+  std::vector<int64_t> cpu_affinity;  ///< CPU cores the thread may run on, or empty for any
+};
+
+/**
+ * @brief Declares the parameters <name>.num_threads, <name>.priority and
+ * <name>.cpu_affinity of a thread, if not declared, and gets its settings from them
+ * @param node Node to declare the parameters on
+ * @param name Name of the thread
+ * @return Settings of the thread
+ */
+template<typename NodeT>
+ThreadSettings declareThreadSettings(NodeT node, const std::string & name)
+{
+  declare_parameter_if_not_declared(node, name + ".num_threads", rclcpp::ParameterValue(1));
+  declare_parameter_if_not_declared(node, name + ".priority", rclcpp::ParameterValue(0));
+  declare_parameter_if_not_declared(
+    node, name + ".cpu_affinity", rclcpp::ParameterValue(std::vector<int64_t>()));
+
+  ThreadSettings settings;
+  settings.num_threads = std::max(
+    1, static_cast<int>(node->get_parameter(name + ".num_threads").as_int()));
+  settings.priority = static_cast<int>(node->get_parameter(name + ".priority").as_int());
+  settings.cpu_affinity = node->get_parameter(name + ".cpu_affinity").as_integer_array();
+  return settings;
+}
+
+/**
+ * @brief Applies the priority and CPU affinity of settings to the caller thread.
+ * May throw exception if unable to set either successfully
+ * @param settings Settings of the thread
+ */
+void applyThreadSettings(const ThreadSettings & settings);
 
 }  // namespace nav2_util
 
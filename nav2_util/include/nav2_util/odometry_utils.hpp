@@ -29,6 +29,7 @@
 #include "nav2_util/lifecycle_node.hpp"
 #include "rclcpp/rclcpp.hpp"
 #include "nav2_util/node_utils.hpp"
+#include "nav2_util/seqlock.hpp"
 
 namespace nav2_util
 {
@@ -36,7 +37,7 @@ namespace nav2_util
 /**
  * @class OdomSmoother
  * Wrapper for getting smooth odometry readings using a simple moving avergae.
- * Subscribes to the topic with a mutex.
+ * Subscribes to the topic with a mutex, the latest twist being read without it.
  */
 class OdomSmoother
 {
@@ -65,16 +66,16 @@ public:
     const std::string & odom_topic = "odom");
 
   /**
-   * @brief Get twist msg from smoother
+   * @brief Get twist msg from smoother, without waiting for the odometry callback
    * @return twist Twist msg
    */
-  inline geometry_msgs::msg::Twist getTwist() {return vel_smooth_.twist;}
+  geometry_msgs::msg::Twist getTwist() const;
 
   /**
    * @brief Get twist stamped msg from smoother
    * @return twist TwistStamped msg
    */
-  inline geometry_msgs::msg::TwistStamped getTwistStamped() {return vel_smooth_;}
+  geometry_msgs::msg::TwistStamped getTwistStamped();
 
 protected:
   /**
@@ -93,6 +94,14 @@ protected:
   geometry_msgs::msg::TwistStamped vel_smooth_;
   std::mutex odom_mutex_;
 
+  // Copy of the twist of vel_smooth_ for readers not to wait on the mutex
+  struct TwistValue
+  {
+    double linear[3];
+    double angular[3];
+  };
+  SeqLock<TwistValue> twist_smooth_{TwistValue{}};
+
   rclcpp::Duration odom_history_duration_;
   std::deque<nav_msgs::msg::Odometry> odom_history_;
 };
@@ -0,0 +1,166 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_UTIL__PATH_TRACKER_HPP_
+#define NAV2_UTIL__PATH_TRACKER_HPP_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "builtin_interfaces/msg/time.hpp"
+#include "geometry_msgs/msg/pose.hpp"
+#include "geometry_msgs/msg/pose_stamped.hpp"
+#include "nav_msgs/msg/path.hpp"
+#include "tf2/time.h"
+#include "tf2_ros/buffer.h"
+
+namespace nav2_util
+{
+
+using PoseConstIterator = std::vector<geometry_msgs::msg::PoseStamped>::const_iterator;
+
+/**
+ * @brief Transform a range of poses into a target frame with a single transform,
+ * looked up once for all the poses rather than once per pose
+ * @param begin First pose to transform
+ * @param end Pose after the last one to transform
+ * @param source_frame Frame of the poses
+ * @param target_frame Frame to transform into
+ * @param stamp Time of the transform, also set as the stamp of the output poses
+ * @param transform_tolerance TF Timeout to use for the transformation
+ * @param tf_buffer TF buffer to use for the transformation
+ * @param transformed_poses Output poses, to which the transformed poses are appended
+ * @return bool Whether the poses could be transformed successfully
+ */
+bool transformPoses(
+  PoseConstIterator begin, PoseConstIterator end,
+  const std::string & source_frame, const std::string & target_frame,
+  const builtin_interfaces::msg::Time & stamp, const tf2::Duration & transform_tolerance,
+  const std::shared_ptr<tf2_ros::Buffer> tf_buffer,
+  std::vector<geometry_msgs::msg::PoseStamped> & transformed_poses);
+
+/**
+ * @class nav2_util::PathTracker
+ * @brief Tracks the progress of a robot along a path. The cumulative arc length of
+ * the poses is kept with the path so that integrated distances are binary searched,
+ * and passed poses are skipped by a progress index rather than erased from the path.
+ */
+class PathTracker
+{
+public:
+  /**
+   * @brief Constructor for nav2_util::PathTracker
+   */
+  PathTracker() = default;
+
+  /**
+   * @brief Set a new path to track, resetting the progress to its first pose
+   * @param path Path to track
+   */
+  void setPath(const nav_msgs::msg::Path & path);
+
+  /**
+   * @brief Get the whole path, including the poses already passed
+   * @return Path being tracked
+   */
+  const nav_msgs::msg::Path & getPath() const {return path_;}
+
+  /**
+   * @brief Get the path from the progress to its end
+   * @return Poses of the path not passed yet
+   */
+  nav_msgs::msg::Path getRemainingPath() const;
+
+  /**
+   * @brief Get the number of poses of the path
+   * @return Size of the path
+   */
+  size_t size() const {return path_.poses.size();}
+
+  /**
+   * @brief Get the index of the first pose of the path not passed yet
+   * @return Progress along the path
+   */
+  size_t getProgress() const {return progress_;}
+
+  /**
+   * @brief Advance the progress along the path, which never moves backwards
+   * @param index Index of the first pose not passed yet
+   */
+  void setProgress(size_t index);
+
+  /**
+   * @brief Get the integrated distance along the path between two poses
+   * @param begin Index of the first pose
+   * @param end Index of the last pose, not before begin
+   * @return Arc length between the poses
+   */
+  double getDistance(size_t begin, size_t end) const;
+
+  /**
+   * @brief Find the first pose after begin further than an integrated distance
+   * from it, as nav2_util::geometry_utils::first_after_integrated_distance
+   * @param begin Index of the pose to integrate the distance from
+   * @param distance Integrated distance along the path
+   * @return Index of the pose, or the size of the path if there is none
+   */
+  size_t getIndexAfterDistance(size_t begin, double distance) const;
+
+  /**
+   * @brief Find the closest pose to a pose in a window of the path, the last one
+   * of equally close poses as nav2_util::geometry_utils::min_by
+   * @param pose Pose in the frame of the path
+   * @param begin Index of the first pose of the window
+   * @param end Index of the pose after the window
+   * @return Index of the closest pose, or end if the window is empty
+   */
+  size_t findClosestPose(const geometry_msgs::msg::Pose & pose, size_t begin, size_t end) const;
+
+  /**
+   * @brief Find the first pose after begin further than a distance from a pose
+   * @param pose Pose in the frame of the path
+   * @param begin Index of the first pose to check
+   * @param max_dist Euclidean distance from the pose
+   * @return Index of the pose, or the size of the path if there is none
+   */
+  size_t findWindowEnd(const geometry_msgs::msg::Pose & pose, size_t begin, double max_dist) const;
+
+  /**
+   * @brief Transform a window of the path into a target frame with a single transform
+   * @param begin Index of the first pose of the window
+   * @param end Index of the pose after the window
+   * @param target_frame Frame to transform into
+   * @param stamp Time of the transform
+   * @param transform_tolerance TF Timeout to use for the transformation
+   * @param tf_buffer TF buffer to use for the transformation
+   * @param transformed_path Output path holding the transformed window
+   * @return bool Whether the window could be transformed successfully
+   */
+  bool transformWindow(
+    size_t begin, size_t end, const std::string & target_frame,
+    const builtin_interfaces::msg::Time & stamp, const tf2::Duration & transform_tolerance,
+    const std::shared_ptr<tf2_ros::Buffer> tf_buffer,
+    nav_msgs::msg::Path & transformed_path) const;
+
+protected:
+  nav_msgs::msg::Path path_;
+  // Integrated distance from the first pose of the path to each pose
+  std::vector<double> lengths_;
+  size_t progress_{0};
+};
+
+}  // namespace nav2_util
+
+#endif  // NAV2_UTIL__PATH_TRACKER_HPP_
@@ -0,0 +1,138 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef NAV2_UTIL__ROBOT_POSE_CACHE_HPP_
+#define NAV2_UTIL__ROBOT_POSE_CACHE_HPP_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_set>
+
+#include "geometry_msgs/msg/pose_stamped.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "tf2_msgs/msg/tf_message.hpp"
+#include "tf2_ros/buffer.h"
+#include "nav2_util/node_thread.hpp"
+#include "nav2_util/seqlock.hpp"
+
+namespace nav2_util
+{
+
+/**
+ * @class nav2_util::RobotPoseCache
+ * @brief Keeps the latest transform from a global frame to the robot frame of the
+ * process, updated from its own TF subscription whenever a transform of the chain
+ * between them changes, so that the pose of the robot is read without locks and
+ * without looking it up in the TF tree. There is one cache per pair of frames and
+ * TF topics of the process, shared by the users which acquire it.
+ */
+class RobotPoseCache
+{
+public:
+  /**
+   * @brief Get the cache of a pair of frames on the TF topics of a node, starting it
+   * if it has no user yet
+   * @param node_topics Topics interface of the node, whose remappings of /tf and
+   * /tf_static the cache follows
+   * @param clock Clock of the node, to which the age of the pose is measured
+   * @param global_frame Frame of the pose
+   * @param robot_frame Frame of the robot
+   * @return Cache of the frames, running as long as a user holds it
+   */
+  static std::shared_ptr<RobotPoseCache> acquire(
+    const rclcpp::node_interfaces::NodeTopicsInterface::SharedPtr & node_topics,
+    const rclcpp::Clock::SharedPtr & clock,
+    const std::string & global_frame, const std::string & robot_frame);
+
+  /**
+   * @brief Constructor for nav2_util::RobotPoseCache, use acquire() instead
+   * @param tf_topic Fully qualified topic of the transforms
+   * @param tf_static_topic Fully qualified topic of the static transforms
+   * @param clock Clock to which the age of the pose is measured
+   * @param global_frame Frame of the pose
+   * @param robot_frame Frame of the robot
+   */
+  RobotPoseCache(
+    const std::string & tf_topic, const std::string & tf_static_topic,
+    const rclcpp::Clock::SharedPtr & clock,
+    const std::string & global_frame, const std::string & robot_frame);
+
+  /**
+   * @brief Destructor for nav2_util::RobotPoseCache, stopping its subscription
+   */
+  ~RobotPoseCache();
+
+  /**
+   * @brief Get the latest pose of the robot in the global frame
+   * @param pose Output pose
+   * @param now Current time, to which the age of the pose is measured
+   * @param max_age Maximum age of the pose, not checked if zero
+   * @return bool false if there is no pose yet or it is too old
+   */
+  bool getPose(
+    geometry_msgs::msg::PoseStamped & pose,
+    const rclcpp::Time & now = rclcpp::Time(),
+    const rclcpp::Duration & max_age = rclcpp::Duration(0, 0)) const;
+
+  /**
+   * @brief Get the current time of the clock of the cache
+   * @return Current time
+   */
+  rclcpp::Time now() const {return clock_->now();}
+
+protected:
+  /**
+   * @brief Adds the transforms received to the buffer and updates the pose
+   * if one of them is on the chain from the robot frame to the global frame
+   * @param msg Transforms received
+   * @param is_static Whether they are static transforms
+   */
+  void transformCallback(const tf2_msgs::msg::TFMessage::ConstSharedPtr msg, bool is_static);
+
+  /**
+   * @brief Looks the pose of the robot up in the buffer and stores it
+   */
+  void updatePose();
+
+  // Pose as plain values, to be read without locks
+  struct CachedPose
+  {
+    double position[3];
+    double orientation[4];
+    int32_t sec;
+    uint32_t nanosec;
+    bool valid;
+  };
+
+  std::string global_frame_;
+  std::string robot_frame_;
+  rclcpp::Clock::SharedPtr clock_;
+
+  rclcpp::Node::SharedPtr node_;
+  std::shared_ptr<tf2_ros::Buffer> tf_buffer_;
+  rclcpp::Subscription<tf2_msgs::msg::TFMessage>::SharedPtr tf_sub_;
+  rclcpp::Subscription<tf2_msgs::msg::TFMessage>::SharedPtr tf_static_sub_;
+  std::unique_ptr<nav2_util::NodeThread> node_thread_;
+
+  // Frames on the chain from the robot frame to the global frame, only used by
+  // the subscription thread. Empty until the chain is known.
+  std::unordered_set<std::string> chain_frames_;
+  SeqLock<CachedPose> pose_;
+};
+
+}  // namespace nav2_util
+
+#endif  // NAV2_UTIL__ROBOT_POSE_CACHE_HPP_
@@ -32,6 +32,8 @@
 
 namespace nav2_util
 {
+class RobotPoseCache;
+
 /**
 * @brief get the current pose of the robot
 * @param global_pose Pose to transform
@@ -39,13 +41,17 @@ namespace nav2_util
 * @param global_frame Frame to transform into
 * @param robot_frame Frame to transform from
 * @param transform_timeout TF Timeout to use for transformation
+* @param stamp Time of the pose, the latest available if zero
+* @param pose_cache Cache of the frames to read the latest pose from, while it is no older
+* than transform_timeout, rather than from the TF buffer. Not used if null.
 * @return bool Whether it could be transformed successfully
 */
 bool getCurrentPose(
   geometry_msgs::msg::PoseStamped & global_pose,
   tf2_ros::Buffer & tf_buffer, const std::string global_frame = "map",
   const std::string robot_frame = "base_link", const double transform_timeout = 0.1,
-  const rclcpp::Time stamp = rclcpp::Time());
+  const rclcpp::Time stamp = rclcpp::Time(),
+  const std::shared_ptr<RobotPoseCache> & pose_cache = nullptr);
 
 /**
 * @brief get an arbitrary pose in a target frame
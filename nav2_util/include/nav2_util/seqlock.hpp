@@ -0,0 +1,110 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_UTIL__SEQLOCK_HPP_
+#define NAV2_UTIL__SEQLOCK_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace nav2_util
+{
+
+/**
+ * @class nav2_util::SeqLock
+ * @brief Holds the latest value written by a single writer for any number of readers,
+ * without locks. The writer never waits, and readers copy the value again only if it
+ * was written while they were copying it. The value is stored in atomic words, so
+ * that torn copies are discarded rather than being data races.
+ */
+template<typename T>
+class SeqLock
+{
+  static_assert(
+    std::is_trivially_copyable<T>::value,
+    "SeqLock values are copied word by word and must be trivially copyable");
+
+public:
+  /**
+   * @brief Constructor for nav2_util::SeqLock
+   * @param value Initial value
+   */
+  explicit SeqLock(const T & value = T())
+  {
+    store(value);
+  }
+
+  /**
+   * @brief Write a new value, from a single writer at a time
+   * @param value Value to write
+   */
+  void store(const T & value)
+  {
+    std::array<uint64_t, kWords> words{};
+    std::memcpy(words.data(), &value, sizeof(T));
+
+    // An odd sequence marks a write in progress
+    const uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+    sequence_.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i != kWords; i++) {
+      words_[i].store(words[i], std::memory_order_relaxed);
+    }
+    sequence_.store(sequence + 2, std::memory_order_release);
+  }
+
+  /**
+   * @brief Read the latest value
+   * @return Copy of the value
+   */
+  T load() const
+  {
+    std::array<uint64_t, kWords> words;
+    uint64_t before, after;
+    do {
+      before = sequence_.load(std::memory_order_acquire);
+      for (size_t i = 0; i != kWords; i++) {
+        words[i] = words_[i].load(std::memory_order_relaxed);
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      after = sequence_.load(std::memory_order_relaxed);
+    } while (before != after || (before & 1u));
+
+    T value;
+    std::memcpy(&value, words.data(), sizeof(T));
+    return value;
+  }
+
+  /**
+   * @brief Get the number of values written, to tell whether the value changed
+   * @return Number of writes, including the initial value
+   */
+  uint64_t writes() const
+  {
+    return sequence_.load(std::memory_order_acquire) / 2;
+  }
+
+protected:
+  static constexpr size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+  std::atomic<uint64_t> sequence_{0};
+  std::array<std::atomic<uint64_t>, kWords> words_{};
+};
+
+}  // namespace nav2_util
+
+#endif  // NAV2_UTIL__SEQLOCK_HPP_
@@ -19,7 +19,7 @@
 #include <mutex>
 #include <string>
 #include <thread>
-#include <future>
+#include <condition_variable>
 #include <chrono>
 
 #include "rclcpp/rclcpp.hpp"
@@ -32,7 +32,9 @@ namespace nav2_util
 
 /**
  * @class nav2_util::SimpleActionServer
- * @brief An action server wrapper to make applications simpler using Actions
+ * @brief An action server wrapper to make applications simpler using Actions.
+ * Goals are executed on a persistent worker thread, started with the first goal,
+ * so that servers receiving many short goals do not create a thread for each.
  */
 template<typename ActionT>
 class SimpleActionServer
@@ -137,6 +139,33 @@ public:
     }
   }
 
+  /**
+   * @brief A destructor for SimpleActionServer, waiting for the goal executing
+   * and stopping the worker thread
+   */
+  ~SimpleActionServer()
+  {
+    {
+      std::lock_guard<std::mutex> lock(worker_mutex_);
+      worker_stop_ = true;
+    }
+    worker_cv_.notify_all();
+    if (worker_thread_.joinable()) {
+      worker_thread_.join();
+    }
+  }
+
+  /**
+   * @brief Sets the priority and CPU affinity of the worker thread executing the goals,
+   * the priority taking over the soft realtime one if set.
+   * Must be called before the first goal is received.
+   * @param settings Scheduling of the worker thread
+   */
+  void setWorkerThreadSettings(const nav2_util::ThreadSettings & settings)
+  {
+    worker_settings_ = settings;
+  }
+
   /**
    * @brief handle the goal requested: accept or reject. This implementation always accepts.
    * @param uuid Goal ID
@@ -220,13 +249,53 @@ public:
 
       current_handle_ = handle;
 
-      // Return quickly to avoid blocking the executor, so spin up a new thread
+      // Return quickly to avoid blocking the executor, so hand over to the worker thread
       debug_msg("Executing goal asynchronously.");
-      execution_future_ = std::async(
-        std::launch::async, [this]() {
-          setSoftRealTimePriority();
-          work();
-        });
+      {
+        std::lock_guard<std::mutex> lock(worker_mutex_);
+        if (!worker_thread_.joinable()) {
+          worker_thread_ = std::thread(&SimpleActionServer::workerLoop, this);
+        }
+        working_ = true;
+      }
+      worker_cv_.notify_all();
+    }
+  }
+
+  /**
+   * @brief Worker thread waiting for goals to execute
+   */
+  void workerLoop()
+  {
+    // Set once for the lifetime of the thread rather than for each goal
+    try {
+      setSoftRealTimePriority();
+      nav2_util::applyThreadSettings(worker_settings_);
+    } catch (const std::runtime_error & ex) {
+      error_msg(ex.what());
+    }
+
+    std::unique_lock<std::mutex> lock(worker_mutex_);
+    while (true) {
+      worker_cv_.wait(lock, [this]() {return working_ || worker_stop_;});
+      if (worker_stop_) {
+        return;
+      }
+
+      lock.unlock();
+      work();
+      {
+        // A goal may have been moved to the pending slot while work() was returning
+        std::lock_guard<std::recursive_mutex> update_lock(update_mutex_);
+        const bool pending = !stop_execution_ && is_active(pending_handle_);
+        if (pending) {
+          debug_msg("Executing a pending handle on the existing thread.");
+          accept_pending_goal();
+        }
+        lock.lock();
+        working_ = pending;
+      }
+      worker_done_cv_.notify_all();
     }
   }
 
@@ -298,25 +367,26 @@ public:
       stop_execution_ = true;
     }
 
-    if (!execution_future_.valid()) {
+    if (!is_running()) {
       return;
     }
 
-    if (is_running()) {
-      warn_msg(
-        "Requested to deactivate server but goal is still executing."
-        " Should check if action server is running before deactivating.");
-    }
+    warn_msg(
+      "Requested to deactivate server but goal is still executing."
+      " Should check if action server is running before deactivating.");
 
     using namespace std::chrono;  //NOLINT
     auto start_time = steady_clock::now();
-    while (execution_future_.wait_for(milliseconds(100)) != std::future_status::ready) {
+    std::unique_lock<std::mutex> lock(worker_mutex_);
+    while (!worker_done_cv_.wait_for(lock, milliseconds(100), [this]() {return !working_;})) {
+      lock.unlock();
       info_msg("Waiting for async process to finish.");
       if (steady_clock::now() - start_time >= server_timeout_) {
         terminate_all();
         if (completion_callback_) {completion_callback_();}
         error_msg("Action callback is still running and missed deadline to stop");
       }
+      lock.lock();
     }
 
     debug_msg("Deactivation completed.");
@@ -328,9 +398,8 @@ public:
    */
   bool is_running()
   {
-    return execution_future_.valid() &&
-           (execution_future_.wait_for(std::chrono::milliseconds(0)) ==
-           std::future_status::timeout);
+    std::lock_guard<std::mutex> lock(worker_mutex_);
+    return working_;
   }
 
   /**
@@ -531,10 +600,19 @@ protected:
 
   ExecuteCallback execute_callback_;
   CompletionCallback completion_callback_;
-  std::future<void> execution_future_;
   bool stop_execution_{false};
   bool use_realtime_prioritization_{false};
 
+  // Worker thread executing the goals, waiting for the next one in between
+  std::thread worker_thread_;
+  std::mutex worker_mutex_;
+  std::condition_variable worker_cv_;
+  std::condition_variable worker_done_cv_;
+  // Whether the worker has a goal to execute or is executing one, guarded by worker_mutex_
+  bool working_{false};
+  bool worker_stop_{false};
+  nav2_util::ThreadSettings worker_settings_;
+
   mutable std::recursive_mutex update_mutex_;
   bool server_active_{false};
   bool preempt_requested_{false};
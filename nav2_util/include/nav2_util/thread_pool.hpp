@@ -0,0 +1,100 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_UTIL__THREAD_POOL_HPP_
+#define NAV2_UTIL__THREAD_POOL_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nav2_util
+{
+
+/**
+ * @class nav2_util::ThreadPool
+ * @brief Fixed set of worker threads running the iterations of a loop together with
+ * the calling thread. The threads are started once and wait between loops, so that
+ * short loops run every control cycle do not pay for creating threads.
+ */
+class ThreadPool
+{
+public:
+  /**
+   * @brief Constructor for nav2_util::ThreadPool
+   * @param threads Number of worker threads, in addition to the calling thread.
+   * With no worker threads, the loops run in the calling thread only.
+   */
+  explicit ThreadPool(size_t threads);
+
+  /**
+   * @brief Destructor for nav2_util::ThreadPool, joining the worker threads
+   */
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool & operator=(const ThreadPool &) = delete;
+
+  /**
+   * @brief Get the number of worker threads
+   * @return Number of worker threads
+   */
+  size_t size() const {return threads_.size();}
+
+  /**
+   * @brief Run task(i) for each i in [0, count), returning once all of them are done.
+   * Loops are run one at a time: parallelFor must not be called concurrently or from a task.
+   * The first exception thrown by a task is rethrown once the loop is done.
+   * @param count Number of iterations
+   * @param task Function called with the index of each iteration
+   */
+  void parallelFor(size_t count, const std::function<void(size_t)> & task);
+
+protected:
+  /**
+   * @brief Worker thread loop
+   */
+  void work();
+
+  /**
+   * @brief Run iterations of the current loop until there are none left
+   */
+  void runTasks();
+
+  std::vector<std::thread> threads_;
+
+  std::mutex mutex_;
+  std::condition_variable start_cv_;
+  std::condition_variable done_cv_;
+  // Loop being run, guarded by mutex_ until the workers are started
+  const std::function<void(size_t)> * task_{nullptr};
+  size_t count_{0};
+  // Next iteration to run
+  std::atomic<size_t> next_{0};
+  // Number of loops started, for the workers to tell a new loop
+  size_t loops_{0};
+  // Number of workers still running the current loop
+  size_t busy_{0};
+  bool stop_{false};
+  std::exception_ptr error_;
+};
+
+}  // namespace nav2_util
+
+#endif  // NAV2_UTIL__THREAD_POOL_HPP_
@@ -0,0 +1,66 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef NAV2_UTIL__TRACING_HPP_
+#define NAV2_UTIL__TRACING_HPP_
+
+namespace nav2_util
+{
+
+/**
+ * @class nav2_util::TraceScope
+ * @brief Emits the LTTng events nav2:scope_begin on construction and nav2:scope_end on
+ * destruction with the name of the scope, to be recorded together with the ROS 2 events,
+ * e.g. with `ros2 trace -u 'ros2:*' 'nav2:*'`. The events are only emitted when Nav2 is
+ * built with NAV2_TRACING_ENABLED, use NAV2_TRACE_SCOPE so that they are compiled out otherwise.
+ */
+class TraceScope
+{
+public:
+  /**
+   * @brief Begins a trace scope
+   * @param name Name of the scope, which must outlive it
+   */
+  explicit TraceScope(const char * name);
+
+  /**
+   * @brief Ends the trace scope
+   */
+  ~TraceScope();
+
+  TraceScope(const TraceScope &) = delete;
+  TraceScope & operator=(const TraceScope &) = delete;
+
+protected:
+  const char * name_;
+};
+
+}  // namespace nav2_util
+
+#define NAV2_TRACE_CONCAT_(a, b) a ## b
+#define NAV2_TRACE_CONCAT(a, b) NAV2_TRACE_CONCAT_(a, b)
+
+/**
+ * @brief Traces the rest of the enclosing block under a name, compiled out
+ * unless NAV2_TRACING_ENABLED is defined
+ */
+#ifdef NAV2_TRACING_ENABLED
+#define NAV2_TRACE_SCOPE(name) \
+  const nav2_util::TraceScope NAV2_TRACE_CONCAT(nav2_trace_scope_, __LINE__)(name)
+#else
+#define NAV2_TRACE_SCOPE(name)
+#endif
+
+#endif  // NAV2_UTIL__TRACING_HPP_
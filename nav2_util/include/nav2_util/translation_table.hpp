@@ -0,0 +1,95 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_UTIL__TRANSLATION_TABLE_HPP_
+#define NAV2_UTIL__TRANSLATION_TABLE_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace nav2_util
+{
+
+/**
+ * @brief Table translating each of the 256 values of a byte
+ */
+template<typename OutT>
+using ByteTranslationTable = std::array<OutT, 256>;
+
+/**
+ * @brief Build the table of a byte translation
+ * @param translate Function computing the translation of a byte, from 0 to 255
+ * @return The table of the translation
+ */
+template<typename OutT, typename TranslateT>
+ByteTranslationTable<OutT> makeByteTranslationTable(TranslateT translate)
+{
+  ByteTranslationTable<OutT> table;
+  for (unsigned int value = 0; value < table.size(); value++) {
+    table[value] = static_cast<OutT>(translate(static_cast<uint8_t>(value)));
+  }
+  return table;
+}
+
+/**
+ * @brief Translate values through a table, out[i] = table[in[i]], with signed
+ * values indexing the table as their unsigned representation (e.g. -1 as 255)
+ * @param table Table with an entry for each value of in
+ * @param in Values to translate
+ * @param size Number of values
+ * @param out Output for the translations, may be in itself if of the same type
+ */
+template<typename InT, typename OutT>
+inline void translateValues(const OutT * table, const InT * in, size_t size, OutT * out)
+{
+  static_assert(std::is_integral<InT>::value, "Translated values must be integers");
+  using IndexT = typename std::make_unsigned<InT>::type;
+
+  // Branch-free lookups, unrolled so that the independent loads overlap
+  size_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    const OutT out0 = table[static_cast<IndexT>(in[i])];
+    const OutT out1 = table[static_cast<IndexT>(in[i + 1])];
+    const OutT out2 = table[static_cast<IndexT>(in[i + 2])];
+    const OutT out3 = table[static_cast<IndexT>(in[i + 3])];
+    out[i] = out0;
+    out[i + 1] = out1;
+    out[i + 2] = out2;
+    out[i + 3] = out3;
+  }
+  for (; i < size; i++) {
+    out[i] = table[static_cast<IndexT>(in[i])];
+  }
+}
+
+/**
+ * @brief Translate bytes through a byte translation table
+ * @param table Table of the translation
+ * @param in Bytes to translate
+ * @param size Number of bytes
+ * @param out Output for the translations
+ */
+template<typename InT, typename OutT>
+inline void translateValues(
+  const ByteTranslationTable<OutT> & table, const InT * in, size_t size, OutT * out)
+{
+  static_assert(sizeof(InT) == 1, "Byte translation tables translate bytes");
+  translateValues(table.data(), in, size, out);
+}
+
+}  // namespace nav2_util
+
+#endif  // NAV2_UTIL__TRANSLATION_TABLE_HPP_
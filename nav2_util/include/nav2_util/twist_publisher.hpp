@@ -30,6 +30,7 @@
 
 #include "lifecycle_node.hpp"
 #include "node_utils.hpp"
+#include "twist_registry.hpp"
 
 namespace nav2_util
 {
@@ -41,6 +42,10 @@ namespace nav2_util
  * The default is to publish Twist to preserve backwards compatibility, but it can be overridden
  * using the "enable_stamped_cmd_vel" parameter to publish TwistStamped.
  *
+ * With the "direct_in_process_cmd_vel" parameter, commands are handed directly to the
+ * filter of this process registered for the topic in nav2_util::TwistRegistry, if any,
+ * within the call to publish, instead of being published on the topic.
+ *
  */
 
 class TwistPublisher
@@ -63,6 +68,13 @@ public:
       node, "enable_stamped_cmd_vel",
       rclcpp::ParameterValue{false});
     node->get_parameter("enable_stamped_cmd_vel", is_stamped_);
+    declare_parameter_if_not_declared(
+      node, "direct_in_process_cmd_vel",
+      rclcpp::ParameterValue{false});
+    node->get_parameter("direct_in_process_cmd_vel", is_direct_);
+    if (is_direct_) {
+      resolved_topic_ = node->get_node_topics_interface()->resolve_topic_name(topic_);
+    }
     if (is_stamped_) {
       twist_stamped_pub_ = node->create_publisher<geometry_msgs::msg::TwistStamped>(
         topic_,
@@ -103,6 +115,10 @@ public:
 
   void publish(std::unique_ptr<geometry_msgs::msg::TwistStamped> velocity)
   {
+    if (is_direct_ && is_activated() && TwistRegistry::dispatch(resolved_topic_, velocity)) {
+      return;
+    }
+
     if (is_stamped_) {
       twist_stamped_pub_->publish(std::move(velocity));
     } else {
@@ -123,6 +139,8 @@ public:
 protected:
   std::string topic_;
   bool is_stamped_;
+  bool is_direct_{false};
+  std::string resolved_topic_;
   rclcpp_lifecycle::LifecyclePublisher<geometry_msgs::msg::Twist>::SharedPtr twist_pub_;
   rclcpp_lifecycle::LifecyclePublisher<geometry_msgs::msg::TwistStamped>::SharedPtr
     twist_stamped_pub_;
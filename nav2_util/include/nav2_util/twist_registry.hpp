@@ -0,0 +1,67 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_UTIL__TWIST_REGISTRY_HPP_
+#define NAV2_UTIL__TWIST_REGISTRY_HPP_
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "geometry_msgs/msg/twist_stamped.hpp"
+
+namespace nav2_util
+{
+
+/**
+ * @class nav2_util::TwistRegistry
+ * @brief Process-wide table of the velocity command filters of this process by their
+ * input topic, so that the command chain composed in one process (controller, velocity
+ * smoother, collision monitor) can hand commands directly from stage to stage within
+ * the publisher's call, without serializing them or waiting for an executor
+ */
+class TwistRegistry
+{
+public:
+  using Handler = std::function<void (std::unique_ptr<geometry_msgs::msg::TwistStamped>)>;
+
+  /**
+   * @brief Register the filter consuming a velocity topic, replacing any previous one
+   * @param topic_name Fully resolved name of the input topic
+   * @param handler Takes the commands, from the thread of the publisher. Not called once
+   * the topic is removed.
+   */
+  static void add(const std::string & topic_name, Handler handler);
+
+  /**
+   * @brief Unregister the filter consuming a velocity topic, waiting for calls
+   * to its handler in progress
+   * @param topic_name Fully resolved name of the input topic
+   */
+  static void remove(const std::string & topic_name);
+
+  /**
+   * @brief Hand a command to the filter consuming a topic in this process, if any
+   * @param topic_name Fully resolved name of the topic
+   * @param velocity Command, moved to the filter if there is one
+   * @return bool true if handed to a filter, false to publish it on the topic instead
+   */
+  static bool dispatch(
+    const std::string & topic_name,
+    std::unique_ptr<geometry_msgs::msg::TwistStamped> & velocity);
+};
+
+}  // namespace nav2_util
+
+#endif  // NAV2_UTIL__TWIST_REGISTRY_HPP_
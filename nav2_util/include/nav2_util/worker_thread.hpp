@@ -0,0 +1,90 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef NAV2_UTIL__WORKER_THREAD_HPP_
+#define NAV2_UTIL__WORKER_THREAD_HPP_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace nav2_util
+{
+
+/**
+ * @class nav2_util::WorkerThread
+ * @brief Thread started once that runs the tasks posted to it one at a time, in order,
+ * so that work handed off every control cycle does not pay for creating a thread.
+ */
+class WorkerThread
+{
+public:
+  /**
+   * @brief Constructor for nav2_util::WorkerThread
+   * @param on_start Function run first in the thread, such as to apply its thread settings
+   */
+  explicit WorkerThread(std::function<void()> on_start = nullptr);
+
+  /**
+   * @brief Destructor for nav2_util::WorkerThread, running the tasks already posted
+   * then joining the thread
+   */
+  ~WorkerThread();
+
+  WorkerThread(const WorkerThread &) = delete;
+  WorkerThread & operator=(const WorkerThread &) = delete;
+
+  /**
+   * @brief Post a task to run in the thread after the ones already posted
+   * @param task Function to run
+   * @return Future of the result of the task, holding its exception if it throws
+   */
+  template<typename Task>
+  auto post(Task && task) -> std::future<decltype(task())>
+  {
+    using Result = decltype(task());
+    auto packaged_task = std::make_shared<std::packaged_task<Result()>>(std::forward<Task>(task));
+    std::future<Result> result = packaged_task->get_future();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks_.emplace_back([packaged_task]() {(*packaged_task)();});
+    }
+    cv_.notify_one();
+    return result;
+  }
+
+protected:
+  /**
+   * @brief Thread loop
+   * @param on_start Function run first in the thread
+   */
+  void work(const std::function<void()> & on_start);
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::function<void()>> tasks_;
+  bool stop_{false};
+  // Started last, once the members it uses are constructed
+  std::thread thread_;
+};
+
+}  // namespace nav2_util
+
+#endif  // NAV2_UTIL__WORKER_THREAD_HPP_
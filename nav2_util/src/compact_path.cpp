@@ -0,0 +1,79 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_util/compact_path.hpp"
+
+#include <cmath>
+
+#include "tf2/utils.h"
+#include "tf2_geometry_msgs/tf2_geometry_msgs.hpp"
+
+namespace nav2_util
+{
+
+void toCompactPath(const nav_msgs::msg::Path & path, nav2_msgs::msg::CompactPath & compact_path)
+{
+  compact_path.header = path.header;
+  const size_t size = path.poses.size();
+  compact_path.x.resize(size);
+  compact_path.y.resize(size);
+  compact_path.yaw.resize(size);
+  compact_path.curvature.clear();
+  compact_path.velocity.clear();
+  for (size_t i = 0; i < size; i++) {
+    const auto & pose = path.poses[i].pose;
+    compact_path.x[i] = static_cast<float>(pose.position.x);
+    compact_path.y[i] = static_cast<float>(pose.position.y);
+    compact_path.yaw[i] = static_cast<float>(tf2::getYaw(pose.orientation));
+  }
+}
+
+size_t compactPathSize(const nav2_msgs::msg::CompactPath & compact_path)
+{
+  const size_t size = compact_path.x.size();
+  if (compact_path.y.size() != size || compact_path.yaw.size() != size ||
+    (!compact_path.curvature.empty() && compact_path.curvature.size() != size) ||
+    (!compact_path.velocity.empty() && compact_path.velocity.size() != size))
+  {
+    return 0;
+  }
+  return size;
+}
+
+bool fromCompactPath(
+  const nav2_msgs::msg::CompactPath & compact_path, nav_msgs::msg::Path & path)
+{
+  const size_t size = compactPathSize(compact_path);
+  if (size == 0 && !compact_path.x.empty()) {
+    return false;
+  }
+
+  path.header = compact_path.header;
+  path.poses.resize(size);
+  for (size_t i = 0; i < size; i++) {
+    auto & pose = path.poses[i];
+    pose.header = compact_path.header;
+    pose.pose.position.x = compact_path.x[i];
+    pose.pose.position.y = compact_path.y[i];
+    pose.pose.position.z = 0.0;
+    const double half_yaw = 0.5 * compact_path.yaw[i];
+    pose.pose.orientation.x = 0.0;
+    pose.pose.orientation.y = 0.0;
+    pose.pose.orientation.z = std::sin(half_yaw);
+    pose.pose.orientation.w = std::cos(half_yaw);
+  }
+  return true;
+}
+
+}  // namespace nav2_util
@@ -0,0 +1,97 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "nav2_util/heartbeat_registry.hpp"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace nav2_util
+{
+
+namespace
+{
+
+struct Registry
+{
+  std::mutex mutex;
+  // Number of lifecycle managers checking each node in memory
+  std::unordered_map<std::string, unsigned int> managed;
+  std::unordered_map<std::string, std::shared_ptr<HeartbeatRegistry::Counter>> counters;
+};
+
+Registry & registry()
+{
+  static Registry instance;
+  return instance;
+}
+
+}  // namespace
+
+void HeartbeatRegistry::manage(const std::string & node_name)
+{
+  Registry & reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  reg.managed[node_name]++;
+}
+
+void HeartbeatRegistry::unmanage(const std::string & node_name)
+{
+  Registry & reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  auto it = reg.managed.find(node_name);
+  if (it != reg.managed.end() && --it->second == 0) {
+    reg.managed.erase(it);
+  }
+}
+
+bool HeartbeatRegistry::isManaged(const std::string & node_name)
+{
+  Registry & reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  return reg.managed.find(node_name) != reg.managed.end();
+}
+
+std::shared_ptr<HeartbeatRegistry::Counter> HeartbeatRegistry::add(const std::string & node_name)
+{
+  auto counter = std::make_shared<Counter>(0);
+  Registry & reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  reg.counters[node_name] = counter;
+  return counter;
+}
+
+void HeartbeatRegistry::remove(const std::string & node_name)
+{
+  Registry & reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  reg.counters.erase(node_name);
+}
+
+std::shared_ptr<const HeartbeatRegistry::Counter> HeartbeatRegistry::get(
+  const std::string & node_name)
+{
+  Registry & reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  auto it = reg.counters.find(node_name);
+  if (it == reg.counters.end()) {
+    return nullptr;
+  }
+  return it->second;
+}
+
+}  // namespace nav2_util
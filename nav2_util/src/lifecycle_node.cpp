@@ -14,11 +14,13 @@
 
 #include "nav2_util/lifecycle_node.hpp"
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "lifecycle_msgs/msg/state.hpp"
+#include "nav2_util/memory_registry.hpp"
 #include "nav2_util/node_utils.hpp"
 
 namespace nav2_util
@@ -60,7 +62,22 @@ LifecycleNode::~LifecycleNode()
 
 void LifecycleNode::createBond()
 {
-  if (bond_heartbeat_period > 0.0) {
+  logMemoryUsage();
+
+  if (bond_heartbeat_period > 0.0 &&
+    HeartbeatRegistry::isManaged(this->get_fully_qualified_name()))
+  {
+    RCLCPP_INFO(
+      get_logger(), "Creating in-process heartbeat (%s) to lifecycle manager.", this->get_name());
+
+    heartbeat_ = HeartbeatRegistry::add(this->get_fully_qualified_name());
+    heartbeat_timer_ = this->create_wall_timer(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::duration<double>(bond_heartbeat_period)),
+      [heartbeat = heartbeat_]() {
+        heartbeat->fetch_add(1, std::memory_order_relaxed);
+      });
+  } else if (bond_heartbeat_period > 0.0) {
     RCLCPP_INFO(get_logger(), "Creating bond (%s) to lifecycle manager.", this->get_name());
 
     bond_ = std::make_unique<bond::Bond>(
@@ -117,12 +134,28 @@ void LifecycleNode::register_rcl_preshutdown_callback()
 
 void LifecycleNode::destroyBond()
 {
+  logMemoryUsage();
+
   if (bond_heartbeat_period > 0.0) {
     RCLCPP_INFO(get_logger(), "Destroying bond (%s) to lifecycle manager.", this->get_name());
 
     if (bond_) {
       bond_.reset();
     }
+    if (heartbeat_timer_) {
+      heartbeat_timer_->cancel();
+      heartbeat_timer_.reset();
+      HeartbeatRegistry::remove(this->get_fully_qualified_name());
+      heartbeat_.reset();
+    }
+  }
+}
+
+void LifecycleNode::logMemoryUsage()
+{
+  const std::string summary = MemoryRegistry::summary();
+  if (!summary.empty()) {
+    RCLCPP_INFO(get_logger(), "Tracked memory of the process: %s", summary.c_str());
   }
 }
 
@@ -0,0 +1,135 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_util/memory_registry.hpp"
+
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace nav2_util
+{
+
+namespace
+{
+
+struct Registry
+{
+  std::mutex mutex;
+  // Ordered, so that snapshots list the tags the same way every time
+  std::map<std::string, std::shared_ptr<MemoryRegistry::Counter>> counters;
+};
+
+Registry & registry()
+{
+  static Registry instance;
+  return instance;
+}
+
+}  // namespace
+
+void MemoryRegistry::Counter::add(size_t bytes)
+{
+  const size_t current = current_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  size_t peak = peak_.load(std::memory_order_relaxed);
+  while (current > peak &&
+    !peak_.compare_exchange_weak(peak, current, std::memory_order_relaxed))
+  {
+  }
+}
+
+void MemoryRegistry::Counter::subtract(size_t bytes)
+{
+  current_.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+std::shared_ptr<MemoryRegistry::Counter> MemoryRegistry::get(const std::string & tag)
+{
+  Registry & reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  auto & counter = reg.counters[tag];
+  if (!counter) {
+    counter = std::make_shared<Counter>();
+  }
+  return counter;
+}
+
+std::vector<MemoryRegistry::Usage> MemoryRegistry::snapshot()
+{
+  Registry & reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  std::vector<Usage> usages;
+  usages.reserve(reg.counters.size());
+  for (const auto & [tag, counter] : reg.counters) {
+    usages.push_back(Usage{tag, counter->current(), counter->peak()});
+  }
+  return usages;
+}
+
+std::string MemoryRegistry::summary()
+{
+  std::string text;
+  for (const auto & usage : snapshot()) {
+    if (usage.peak == 0) {
+      continue;
+    }
+    char entry[256];
+    snprintf(
+      entry, sizeof(entry), "%s%s: %.1f MiB (peak %.1f MiB)", text.empty() ? "" : ", ",
+      usage.tag.c_str(), usage.current / 1048576.0, usage.peak / 1048576.0);
+    text += entry;
+  }
+  return text;
+}
+
+MemoryTracker::MemoryTracker(const std::string & tag)
+: counter_(MemoryRegistry::get(tag))
+{
+}
+
+MemoryTracker::MemoryTracker(const MemoryTracker & other)
+: counter_(other.counter_)
+{
+  update(other.bytes_);
+}
+
+MemoryTracker & MemoryTracker::operator=(const MemoryTracker & other)
+{
+  if (this != &other) {
+    update(0);
+    counter_ = other.counter_;
+    update(other.bytes_);
+  }
+  return *this;
+}
+
+MemoryTracker::~MemoryTracker()
+{
+  update(0);
+}
+
+void MemoryTracker::update(size_t bytes)
+{
+  if (bytes > bytes_) {
+    counter_->add(bytes - bytes_);
+  } else if (bytes < bytes_) {
+    counter_->subtract(bytes_ - bytes);
+  }
+  bytes_ = bytes;
+}
+
+}  // namespace nav2_util
@@ -20,12 +20,25 @@ namespace nav2_util
 
 NodeThread::NodeThread(
   rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_base)
+: NodeThread(node_base, ThreadSettings())
+{}
+
+NodeThread::NodeThread(
+  rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_base,
+  const ThreadSettings & settings)
 : node_(node_base)
 {
-  executor_ = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+  if (settings.num_threads > 1) {
+    executor_ = std::make_shared<rclcpp::executors::MultiThreadedExecutor>(
+      rclcpp::ExecutorOptions(), settings.num_threads);
+  } else {
+    executor_ = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+  }
   thread_ = std::make_unique<std::thread>(
-    [&]()
+    [this, settings]()
     {
+      // Set before spinning, for the threads of the executor to inherit it
+      applySettings(settings);
       executor_->add_node(node_);
       executor_->spin();
       executor_->remove_node(node_);
@@ -33,14 +46,28 @@ NodeThread::NodeThread(
 }
 
 NodeThread::NodeThread(rclcpp::executors::SingleThreadedExecutor::SharedPtr executor)
+: NodeThread(rclcpp::Executor::SharedPtr(executor), ThreadSettings())
+{}
+
+NodeThread::NodeThread(rclcpp::Executor::SharedPtr executor, const ThreadSettings & settings)
 : executor_(executor)
 {
   thread_ = std::make_unique<std::thread>(
-    [&]() {
+    [this, settings]() {
+      applySettings(settings);
       executor_->spin();
     });
 }
 
+void NodeThread::applySettings(const ThreadSettings & settings)
+{
+  try {
+    applyThreadSettings(settings);
+  } catch (const std::runtime_error & ex) {
+    RCLCPP_ERROR(rclcpp::get_logger("NodeThread"), "%s", ex.what());
+  }
+}
+
 NodeThread::~NodeThread()
 {
   executor_->cancel();
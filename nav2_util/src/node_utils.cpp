@@ -18,6 +18,11 @@
 #include <string>
 #include <algorithm>
 #include <cctype>
+#include <cstring>
+#include <stdexcept>
+
+#include <pthread.h>
+#include <sched.h>
 
 using std::chrono::high_resolution_clock;
 using std::to_string;
@@ -90,10 +95,10 @@ rclcpp::Node::SharedPtr generate_internal_node(const std::string & prefix)
   return rclcpp::Node::make_shared("_", options);
 }
 
-void setSoftRealTimePriority()
+void setSoftRealTimePriority(int priority)
 {
   sched_param sch;
-  sch.sched_priority = 49;
+  sch.sched_priority = priority;
   if (sched_setscheduler(0, SCHED_FIFO, &sch) == -1) {
     std::string errmsg(
       "Cannot set as real-time thread. Users must set: <username> hard rtprio 99 and "
@@ -103,4 +108,38 @@ void setSoftRealTimePriority()
   }
 }
 
+void setCpuAffinity(int cpu)
+{
+  setCpuAffinity(std::vector<int64_t>{cpu});
+}
+
+void setCpuAffinity(const std::vector<int64_t> & cpus)
+{
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  std::string cpus_str;
+  for (const int64_t cpu : cpus) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+      throw std::runtime_error("Cannot pin thread to invalid CPU " + std::to_string(cpu));
+    }
+    CPU_SET(cpu, &cpu_set);
+    cpus_str += (cpus_str.empty() ? "" : ", ") + std::to_string(cpu);
+  }
+  const int error = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+  if (error != 0) {
+    throw std::runtime_error(
+      "Cannot pin thread to CPUs [" + cpus_str + "]. Error: " + std::strerror(error));
+  }
+}
+
+void applyThreadSettings(const ThreadSettings & settings)
+{
+  if (settings.priority > 0) {
+    setSoftRealTimePriority(settings.priority);
+  }
+  if (!settings.cpu_affinity.empty()) {
+    setCpuAffinity(settings.cpu_affinity);
+  }
+}
+
 }  // namespace nav2_util
@@ -116,6 +116,30 @@ void OdomSmoother::updateState()
   vel_smooth_.twist.angular.x = odom_cumulate_.twist.twist.angular.x / odom_history_.size();
   vel_smooth_.twist.angular.y = odom_cumulate_.twist.twist.angular.y / odom_history_.size();
   vel_smooth_.twist.angular.z = odom_cumulate_.twist.twist.angular.z / odom_history_.size();
+
+  const auto & twist = vel_smooth_.twist;
+  twist_smooth_.store(
+    TwistValue{{twist.linear.x, twist.linear.y, twist.linear.z},
+      {twist.angular.x, twist.angular.y, twist.angular.z}});
+}
+
+geometry_msgs::msg::Twist OdomSmoother::getTwist() const
+{
+  const TwistValue value = twist_smooth_.load();
+  geometry_msgs::msg::Twist twist;
+  twist.linear.x = value.linear[0];
+  twist.linear.y = value.linear[1];
+  twist.linear.z = value.linear[2];
+  twist.angular.x = value.angular[0];
+  twist.angular.y = value.angular[1];
+  twist.angular.z = value.angular[2];
+  return twist;
+}
+
+geometry_msgs::msg::TwistStamped OdomSmoother::getTwistStamped()
+{
+  std::lock_guard<std::mutex> lock(odom_mutex_);
+  return vel_smooth_;
 }
 
 }  // namespace nav2_util
@@ -0,0 +1,156 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "nav2_util/path_tracker.hpp"
+#include "nav2_util/geometry_utils.hpp"
+#include "rclcpp/logging.hpp"
+#include "tf2_geometry_msgs/tf2_geometry_msgs.hpp"
+
+namespace nav2_util
+{
+
+using geometry_utils::euclidean_distance;
+
+bool transformPoses(
+  PoseConstIterator begin, PoseConstIterator end,
+  const std::string & source_frame, const std::string & target_frame,
+  const builtin_interfaces::msg::Time & stamp, const tf2::Duration & transform_tolerance,
+  const std::shared_ptr<tf2_ros::Buffer> tf_buffer,
+  std::vector<geometry_msgs::msg::PoseStamped> & transformed_poses)
+{
+  geometry_msgs::msg::TransformStamped transform;
+  const bool identity = source_frame == target_frame;
+  if (!identity) {
+    try {
+      transform = tf_buffer->lookupTransform(
+        target_frame, source_frame, tf2_ros::fromMsg(stamp), transform_tolerance);
+    } catch (tf2::TransformException & ex) {
+      RCLCPP_ERROR(
+        rclcpp::get_logger("transformPoses"),
+        "Failed to get \"%s\"->\"%s\" frame transform: %s",
+        source_frame.c_str(), target_frame.c_str(), ex.what());
+      return false;
+    }
+  }
+
+  transformed_poses.reserve(transformed_poses.size() + std::distance(begin, end));
+  for (auto it = begin; it != end; ++it) {
+    geometry_msgs::msg::PoseStamped transformed_pose;
+    transformed_pose.header.frame_id = target_frame;
+    transformed_pose.header.stamp = stamp;
+    if (identity) {
+      transformed_pose.pose = it->pose;
+    } else {
+      tf2::doTransform(it->pose, transformed_pose.pose, transform);
+    }
+    transformed_poses.push_back(std::move(transformed_pose));
+  }
+  return true;
+}
+
+void PathTracker::setPath(const nav_msgs::msg::Path & path)
+{
+  path_ = path;
+  progress_ = 0;
+  lengths_.resize(path_.poses.size());
+  double length = 0.0;
+  for (size_t i = 0; i < path_.poses.size(); ++i) {
+    if (i > 0) {
+      length += euclidean_distance(path_.poses[i - 1], path_.poses[i]);
+    }
+    lengths_[i] = length;
+  }
+}
+
+nav_msgs::msg::Path PathTracker::getRemainingPath() const
+{
+  nav_msgs::msg::Path path;
+  path.header = path_.header;
+  path.poses.assign(path_.poses.begin() + progress_, path_.poses.end());
+  return path;
+}
+
+void PathTracker::setProgress(size_t index)
+{
+  progress_ = std::max(progress_, std::min(index, path_.poses.size()));
+}
+
+double PathTracker::getDistance(size_t begin, size_t end) const
+{
+  if (lengths_.empty()) {
+    return 0.0;
+  }
+  end = std::min(end, lengths_.size() - 1);
+  begin = std::min(begin, end);
+  return lengths_[end] - lengths_[begin];
+}
+
+size_t PathTracker::getIndexAfterDistance(size_t begin, double distance) const
+{
+  if (begin >= lengths_.size()) {
+    return lengths_.size();
+  }
+  auto it = std::upper_bound(
+    lengths_.begin() + begin + 1, lengths_.end(), lengths_[begin] + distance);
+  return static_cast<size_t>(it - lengths_.begin());
+}
+
+size_t PathTracker::findClosestPose(
+  const geometry_msgs::msg::Pose & pose, size_t begin, size_t end) const
+{
+  end = std::min(end, path_.poses.size());
+  size_t closest = end;
+  double closest_dist = 0.0;
+  for (size_t i = begin; i < end; ++i) {
+    const double dist = euclidean_distance(pose, path_.poses[i].pose);
+    if (closest == end || dist <= closest_dist) {
+      closest = i;
+      closest_dist = dist;
+    }
+  }
+  return closest;
+}
+
+size_t PathTracker::findWindowEnd(
+  const geometry_msgs::msg::Pose & pose, size_t begin, double max_dist) const
+{
+  size_t end = begin;
+  while (end < path_.poses.size() && euclidean_distance(pose, path_.poses[end].pose) <= max_dist) {
+    ++end;
+  }
+  return end;
+}
+
+bool PathTracker::transformWindow(
+  size_t begin, size_t end, const std::string & target_frame,
+  const builtin_interfaces::msg::Time & stamp, const tf2::Duration & transform_tolerance,
+  const std::shared_ptr<tf2_ros::Buffer> tf_buffer,
+  nav_msgs::msg::Path & transformed_path) const
+{
+  end = std::min(end, path_.poses.size());
+  begin = std::min(begin, end);
+  transformed_path.header.frame_id = target_frame;
+  transformed_path.header.stamp = stamp;
+  transformed_path.poses.clear();
+  return transformPoses(
+    path_.poses.begin() + begin, path_.poses.begin() + end, path_.header.frame_id,
+    target_frame, stamp, transform_tolerance, tf_buffer, transformed_path.poses);
+}
+
+}  // namespace nav2_util
@@ -0,0 +1,190 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "nav2_util/robot_pose_cache.hpp"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "tf2_ros/qos.hpp"
+#include "nav2_util/node_utils.hpp"
+
+namespace nav2_util
+{
+
+namespace
+{
+
+struct Registry
+{
+  std::mutex mutex;
+  // Caches by TF topic, static TF topic, global frame and robot frame
+  std::map<
+    std::tuple<std::string, std::string, std::string, std::string>,
+    std::weak_ptr<RobotPoseCache>> caches;
+};
+
+Registry & registry()
+{
+  static Registry instance;
+  return instance;
+}
+
+}  // namespace
+
+std::shared_ptr<RobotPoseCache> RobotPoseCache::acquire(
+  const rclcpp::node_interfaces::NodeTopicsInterface::SharedPtr & node_topics,
+  const rclcpp::Clock::SharedPtr & clock,
+  const std::string & global_frame, const std::string & robot_frame)
+{
+  // Resolved with the remappings of the node, as its own TF listener would be, so that
+  // the robots of a process each get the cache of their TF tree
+  const std::string tf_topic = node_topics->resolve_topic_name("/tf");
+  const std::string tf_static_topic = node_topics->resolve_topic_name("/tf_static");
+
+  Registry & reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  auto & entry = reg.caches[{tf_topic, tf_static_topic, global_frame, robot_frame}];
+  auto cache = entry.lock();
+  if (!cache) {
+    cache = std::make_shared<RobotPoseCache>(
+      tf_topic, tf_static_topic, clock, global_frame, robot_frame);
+    entry = cache;
+  }
+  return cache;
+}
+
+RobotPoseCache::RobotPoseCache(
+  const std::string & tf_topic, const std::string & tf_static_topic,
+  const rclcpp::Clock::SharedPtr & clock,
+  const std::string & global_frame, const std::string & robot_frame)
+: global_frame_(global_frame), robot_frame_(robot_frame), clock_(clock)
+{
+  node_ = generate_internal_node("robot_pose_cache");
+  tf_buffer_ = std::make_shared<tf2_ros::Buffer>(clock_);
+  tf_sub_ = node_->create_subscription<tf2_msgs::msg::TFMessage>(
+    tf_topic, tf2_ros::DynamicListenerQoS(),
+    [this](const tf2_msgs::msg::TFMessage::ConstSharedPtr msg) {
+      transformCallback(msg, false);
+    });
+  tf_static_sub_ = node_->create_subscription<tf2_msgs::msg::TFMessage>(
+    tf_static_topic, tf2_ros::StaticListenerQoS(),
+    [this](const tf2_msgs::msg::TFMessage::ConstSharedPtr msg) {
+      transformCallback(msg, true);
+    });
+  node_thread_ = std::make_unique<nav2_util::NodeThread>(node_->get_node_base_interface());
+}
+
+RobotPoseCache::~RobotPoseCache()
+{
+  // Stop the subscription thread before the members it uses go away
+  node_thread_.reset();
+}
+
+void RobotPoseCache::transformCallback(
+  const tf2_msgs::msg::TFMessage::ConstSharedPtr msg, bool is_static)
+{
+  bool on_chain = chain_frames_.empty();
+  for (const auto & transform : msg->transforms) {
+    try {
+      tf_buffer_->setTransform(transform, "robot_pose_cache", is_static);
+    } catch (const tf2::TransformException & ex) {
+      RCLCPP_ERROR(
+        node_->get_logger(), "Failed to set transform from %s to %s: %s",
+        transform.header.frame_id.c_str(), transform.child_frame_id.c_str(), ex.what());
+      continue;
+    }
+    on_chain = on_chain || chain_frames_.count(transform.child_frame_id) != 0;
+  }
+
+  if (on_chain) {
+    updatePose();
+  }
+}
+
+void RobotPoseCache::updatePose()
+{
+  CachedPose cached{};
+  cached.valid = false;
+
+  if (tf_buffer_->canTransform(global_frame_, robot_frame_, tf2::TimePointZero)) {
+    try {
+      const geometry_msgs::msg::TransformStamped transform =
+        tf_buffer_->lookupTransform(global_frame_, robot_frame_, tf2::TimePointZero);
+      cached.position[0] = transform.transform.translation.x;
+      cached.position[1] = transform.transform.translation.y;
+      cached.position[2] = transform.transform.translation.z;
+      cached.orientation[0] = transform.transform.rotation.x;
+      cached.orientation[1] = transform.transform.rotation.y;
+      cached.orientation[2] = transform.transform.rotation.z;
+      cached.orientation[3] = transform.transform.rotation.w;
+      cached.sec = transform.header.stamp.sec;
+      cached.nanosec = transform.header.stamp.nanosec;
+      cached.valid = true;
+
+      if (chain_frames_.empty()) {
+        std::vector<std::string> frames;
+        tf_buffer_->_chainAsVector(
+          global_frame_, tf2::TimePointZero, robot_frame_, tf2::TimePointZero,
+          global_frame_, frames);
+        chain_frames_.insert(frames.begin(), frames.end());
+      }
+    } catch (const tf2::TransformException &) {
+      // Left invalid, the callers look the pose up in the TF tree instead
+    }
+  }
+
+  if (!cached.valid) {
+    // Look the chain up again once it is back, it may have changed
+    chain_frames_.clear();
+  }
+  pose_.store(cached);
+}
+
+bool RobotPoseCache::getPose(
+  geometry_msgs::msg::PoseStamped & pose,
+  const rclcpp::Time & now,
+  const rclcpp::Duration & max_age) const
+{
+  const CachedPose cached = pose_.load();
+  if (!cached.valid) {
+    return false;
+  }
+
+  pose.header.frame_id = global_frame_;
+  pose.header.stamp.sec = cached.sec;
+  pose.header.stamp.nanosec = cached.nanosec;
+  if (max_age.nanoseconds() > 0 &&
+    now.nanoseconds() - rclcpp::Time(pose.header.stamp, now.get_clock_type()).nanoseconds() >
+    max_age.nanoseconds())
+  {
+    return false;
+  }
+
+  pose.pose.position.x = cached.position[0];
+  pose.pose.position.y = cached.position[1];
+  pose.pose.position.z = cached.position[2];
+  pose.pose.orientation.x = cached.orientation[0];
+  pose.pose.orientation.y = cached.orientation[1];
+  pose.pose.orientation.z = cached.orientation[2];
+  pose.pose.orientation.w = cached.orientation[3];
+  return true;
+}
+
+}  // namespace nav2_util
@@ -20,6 +20,7 @@
 
 #include "tf2/convert.h"
 #include "nav2_util/robot_utils.hpp"
+#include "nav2_util/robot_pose_cache.hpp"
 #include "rclcpp/logger.hpp"
 
 namespace nav2_util
@@ -29,8 +30,16 @@ bool getCurrentPose(
   geometry_msgs::msg::PoseStamped & global_pose,
   tf2_ros::Buffer & tf_buffer, const std::string global_frame,
   const std::string robot_frame, const double transform_timeout,
-  const rclcpp::Time stamp)
+  const rclcpp::Time stamp, const std::shared_ptr<RobotPoseCache> & pose_cache)
 {
+  // The latest pose is served by the cache while no older than the timeout
+  if (pose_cache && stamp.nanoseconds() == 0 && transform_timeout > 0.0 &&
+    pose_cache->getPose(
+      global_pose, pose_cache->now(), rclcpp::Duration::from_seconds(transform_timeout)))
+  {
+    return true;
+  }
+
   tf2::toMsg(tf2::Transform::getIdentity(), global_pose.pose);
   global_pose.header.frame_id = robot_frame;
   global_pose.header.stamp = stamp;
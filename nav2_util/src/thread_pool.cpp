@@ -0,0 +1,112 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_util/thread_pool.hpp"
+
+namespace nav2_util
+{
+
+ThreadPool::ThreadPool(size_t threads)
+{
+  threads_.reserve(threads);
+  for (size_t i = 0; i != threads; i++) {
+    threads_.emplace_back(&ThreadPool::work, this);
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  start_cv_.notify_all();
+  for (std::thread & thread : threads_) {
+    thread.join();
+  }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)> & task)
+{
+  if (threads_.empty() || count <= 1) {
+    for (size_t i = 0; i != count; i++) {
+      task(i);
+    }
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    task_ = &task;
+    count_ = count;
+    next_.store(0, std::memory_order_relaxed);
+    busy_ = threads_.size();
+    error_ = nullptr;
+    loops_++;
+  }
+  start_cv_.notify_all();
+
+  runTasks();
+
+  std::exception_ptr error;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this]() {return busy_ == 0;});
+    task_ = nullptr;
+    std::swap(error, error_);
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+void ThreadPool::work()
+{
+  size_t loops = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      start_cv_.wait(lock, [this, loops]() {return stop_ || loops_ != loops;});
+      if (stop_) {
+        return;
+      }
+      loops = loops_;
+    }
+
+    runTasks();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--busy_ == 0) {
+      done_cv_.notify_one();
+    }
+  }
+}
+
+void ThreadPool::runTasks()
+{
+  for (size_t i = next_.fetch_add(1, std::memory_order_relaxed); i < count_;
+    i = next_.fetch_add(1, std::memory_order_relaxed))
+  {
+    try {
+      (*task_)(i);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!error_) {
+        error_ = std::current_exception();
+      }
+    }
+  }
+}
+
+}  // namespace nav2_util
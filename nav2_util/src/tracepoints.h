@@ -0,0 +1,45 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// LTTng-UST tracepoint provider of the nav2 events, see nav2_util/tracing.hpp
+
+#undef TRACEPOINT_PROVIDER
+#define TRACEPOINT_PROVIDER nav2
+
+#undef TRACEPOINT_INCLUDE
+#define TRACEPOINT_INCLUDE "./tracepoints.h"
+
+#if !defined(NAV2_UTIL__TRACEPOINTS_H_) || defined(TRACEPOINT_HEADER_MULTI_READ)
+#define NAV2_UTIL__TRACEPOINTS_H_
+
+#include <lttng/tracepoint.h>
+
+TRACEPOINT_EVENT(
+  nav2,
+  scope_begin,
+  TP_ARGS(const char *, name_arg),
+  TP_FIELDS(ctf_string(name, name_arg))
+)
+
+TRACEPOINT_EVENT(
+  nav2,
+  scope_end,
+  TP_ARGS(const char *, name_arg),
+  TP_FIELDS(ctf_string(name, name_arg))
+)
+
+#endif  // NAV2_UTIL__TRACEPOINTS_H_
+
+#include <lttng/tracepoint-event.h>
@@ -0,0 +1,42 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "nav2_util/tracing.hpp"
+
+#ifdef NAV2_TRACING_ENABLED
+#define TRACEPOINT_CREATE_PROBES
+#define TRACEPOINT_DEFINE
+#include "tracepoints.h"
+#endif
+
+namespace nav2_util
+{
+
+TraceScope::TraceScope(const char * name)
+: name_(name)
+{
+#ifdef NAV2_TRACING_ENABLED
+  tracepoint(nav2, scope_begin, name_);
+#endif
+}
+
+TraceScope::~TraceScope()
+{
+#ifdef NAV2_TRACING_ENABLED
+  tracepoint(nav2, scope_end, name_);
+#endif
+}
+
+}  // namespace nav2_util
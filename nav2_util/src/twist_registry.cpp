@@ -0,0 +1,92 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_util/twist_registry.hpp"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+namespace nav2_util
+{
+
+namespace
+{
+
+struct Registry
+{
+  // Not held while calling handlers, which may dispatch to the next stage of the chain
+  // or wait on locks of their node held by threads dispatching to it. The calls in
+  // progress hold a reference to their handler instead.
+  std::mutex mutex;
+  std::unordered_map<std::string, std::shared_ptr<TwistRegistry::Handler>> handlers;
+};
+
+Registry & registry()
+{
+  static Registry instance;
+  return instance;
+}
+
+}  // namespace
+
+void TwistRegistry::add(const std::string & topic_name, Handler handler)
+{
+  Registry & reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  reg.handlers[topic_name] = std::make_shared<Handler>(std::move(handler));
+}
+
+void TwistRegistry::remove(const std::string & topic_name)
+{
+  std::shared_ptr<Handler> handler;
+  {
+    Registry & reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    auto it = reg.handlers.find(topic_name);
+    if (it == reg.handlers.end()) {
+      return;
+    }
+    handler = std::move(it->second);
+    reg.handlers.erase(it);
+  }
+
+  // Wait for the calls in progress to release the handler
+  while (handler.use_count() > 1) {
+    std::this_thread::yield();
+  }
+}
+
+bool TwistRegistry::dispatch(
+  const std::string & topic_name,
+  std::unique_ptr<geometry_msgs::msg::TwistStamped> & velocity)
+{
+  std::shared_ptr<Handler> handler;
+  {
+    Registry & reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    auto it = reg.handlers.find(topic_name);
+    if (it == reg.handlers.end()) {
+      return false;
+    }
+    handler = it->second;
+  }
+  (*handler)(std::move(velocity));
+  return true;
+}
+
+}  // namespace nav2_util
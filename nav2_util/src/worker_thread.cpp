@@ -0,0 +1,58 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "nav2_util/worker_thread.hpp"
+
+namespace nav2_util
+{
+
+WorkerThread::WorkerThread(std::function<void()> on_start)
+: thread_(&WorkerThread::work, this, std::move(on_start))
+{
+}
+
+WorkerThread::~WorkerThread()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_one();
+  thread_.join();
+}
+
+void WorkerThread::work(const std::function<void()> & on_start)
+{
+  if (on_start) {
+    on_start();
+  }
+
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]() {return stop_ || !tasks_.empty();});
+      if (tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    // The exceptions of the task are stored in its future
+    task();
+  }
+}
+
+}  // namespace nav2_util
@@ -12,7 +12,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <atomic>
 #include <chrono>
+#include <functional>
+#include <future>
 #include <memory>
 #include <thread>
 
@@ -563,6 +566,192 @@ TEST_F(ActionTest, test_handle_cancel)
   SUCCEED();
 }
 
+// A server executing its goals with the callback of each test, spun on its own thread
+class WorkerTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    server_node_ = std::make_shared<rclcpp::Node>("worker_server_node");
+    server_ = std::make_unique<nav2_util::SimpleActionServer<Fibonacci>>(
+      server_node_, "worker_fibonacci", [this]() {execute_();});
+    server_->activate();
+    executor_.add_node(server_node_);
+    spin_thread_ = std::thread([this]() {executor_.spin();});
+
+    client_node_ = std::make_shared<rclcpp::Node>(
+      nav2_util::generate_internal_node_name("worker_client_node"));
+    client_ = rclcpp_action::create_client<Fibonacci>(client_node_, "worker_fibonacci");
+    ASSERT_TRUE(client_->wait_for_action_server(5s));
+  }
+
+  void TearDown() override
+  {
+    executor_.cancel();
+    spin_thread_.join();
+    if (server_) {
+      server_->deactivate();
+      server_.reset();
+    }
+  }
+
+  std::shared_future<rclcpp_action::ClientGoalHandle<Fibonacci>::SharedPtr> sendGoal(int order)
+  {
+    auto goal = Fibonacci::Goal();
+    goal.order = order;
+    return client_->async_send_goal(goal);
+  }
+
+  rclcpp_action::ClientGoalHandle<Fibonacci>::SharedPtr getHandle(
+    std::shared_future<rclcpp_action::ClientGoalHandle<Fibonacci>::SharedPtr> future)
+  {
+    if (rclcpp::spin_until_future_complete(client_node_, future, 5s) !=
+      rclcpp::FutureReturnCode::SUCCESS)
+    {
+      return nullptr;
+    }
+    return future.get();
+  }
+
+  rclcpp_action::ResultCode getResultCode(
+    const rclcpp_action::ClientGoalHandle<Fibonacci>::SharedPtr & handle)
+  {
+    if (!handle) {
+      return rclcpp_action::ResultCode::UNKNOWN;
+    }
+    auto future = client_->async_get_result(handle);
+    if (rclcpp::spin_until_future_complete(client_node_, future, 5s) !=
+      rclcpp::FutureReturnCode::SUCCESS)
+    {
+      return rclcpp_action::ResultCode::UNKNOWN;
+    }
+    return future.get().code;
+  }
+
+  static bool waitFor(const std::function<bool()> & predicate)
+  {
+    const auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (!predicate()) {
+      if (std::chrono::steady_clock::now() > deadline) {
+        return false;
+      }
+      std::this_thread::sleep_for(1ms);
+    }
+    return true;
+  }
+
+  // Succeeds the current goal, with its order as result
+  void succeedCurrent()
+  {
+    auto result = std::make_shared<Fibonacci::Result>();
+    result->sequence.push_back(server_->get_current_goal()->order);
+    server_->succeeded_current(result);
+  }
+
+  rclcpp::Node::SharedPtr server_node_;
+  std::unique_ptr<nav2_util::SimpleActionServer<Fibonacci>> server_;
+  rclcpp::executors::SingleThreadedExecutor executor_;
+  std::thread spin_thread_;
+  std::function<void()> execute_;
+
+  rclcpp::Node::SharedPtr client_node_;
+  rclcpp_action::Client<Fibonacci>::SharedPtr client_;
+};
+
+TEST_F(WorkerTest, test_pending_goal_after_work_returns)
+{
+  execute_ = [this]() {succeedCurrent();};
+
+  // Goals sent back to back land either in the idle worker, in the pending slot while the
+  // callback executes, or in the pending slot once work() returned. None may be left behind.
+  for (int i = 0; i < 50; i++) {
+    auto first = sendGoal(1);
+    auto second = sendGoal(2);
+    EXPECT_EQ(getResultCode(getHandle(first)), rclcpp_action::ResultCode::SUCCEEDED);
+    EXPECT_EQ(getResultCode(getHandle(second)), rclcpp_action::ResultCode::SUCCEEDED);
+  }
+
+  EXPECT_TRUE(waitFor([this]() {return !server_->is_running();}));
+}
+
+TEST_F(WorkerTest, test_preemption_while_worker_busy)
+{
+  std::atomic<int> calls{0};
+  std::atomic<int> preemptions{0};
+  execute_ = [&]() {
+      calls++;
+      while (server_->is_server_active() && !server_->is_cancel_requested()) {
+        if (server_->is_preempt_requested()) {
+          server_->accept_pending_goal();
+          preemptions++;
+        }
+        if (server_->get_current_goal()->order == 1) {
+          succeedCurrent();
+          return;
+        }
+        std::this_thread::sleep_for(5ms);
+      }
+    };
+
+  auto busy = getHandle(sendGoal(100));
+  ASSERT_TRUE(busy);
+  ASSERT_TRUE(waitFor([this]() {return server_->is_running();}));
+
+  auto preempting = getHandle(sendGoal(1));
+  EXPECT_EQ(getResultCode(preempting), rclcpp_action::ResultCode::SUCCEEDED);
+  EXPECT_EQ(getResultCode(busy), rclcpp_action::ResultCode::ABORTED);
+
+  // The preempting goal is taken over by the callback executing the busy one
+  EXPECT_EQ(calls, 1);
+  EXPECT_EQ(preemptions, 1);
+  EXPECT_TRUE(waitFor([this]() {return !server_->is_running();}));
+}
+
+TEST_F(WorkerTest, test_deactivate_waits_for_worker)
+{
+  std::atomic<bool> returned{false};
+  execute_ = [&]() {
+      while (server_->is_server_active()) {
+        std::this_thread::sleep_for(5ms);
+      }
+      std::this_thread::sleep_for(50ms);
+      returned = true;
+    };
+
+  auto goal = getHandle(sendGoal(100));
+  ASSERT_TRUE(goal);
+  ASSERT_TRUE(waitFor([this]() {return server_->is_running();}));
+
+  server_->deactivate();
+  EXPECT_TRUE(returned);
+  EXPECT_FALSE(server_->is_running());
+  EXPECT_EQ(getResultCode(goal), rclcpp_action::ResultCode::ABORTED);
+}
+
+TEST_F(WorkerTest, test_destructor_joins_worker)
+{
+  std::atomic<bool> started{false};
+  std::atomic<bool> release{false};
+  std::atomic<bool> returned{false};
+  execute_ = [&]() {
+      started = true;
+      while (!release) {
+        std::this_thread::sleep_for(1ms);
+      }
+      returned = true;
+    };
+
+  ASSERT_TRUE(getHandle(sendGoal(100)));
+  ASSERT_TRUE(waitFor([&]() {return started.load();}));
+
+  auto destroyed = std::async(std::launch::async, [this]() {server_.reset();});
+  EXPECT_EQ(destroyed.wait_for(100ms), std::future_status::timeout);
+
+  release = true;
+  EXPECT_EQ(destroyed.wait_for(5s), std::future_status::ready);
+  EXPECT_TRUE(returned);
+}
+
 int main(int argc, char ** argv)
 {
   rclcpp::init(argc, argv);
@@ -0,0 +1,76 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cmath>
+
+#include "nav2_util/compact_path.hpp"
+#include "nav2_util/geometry_utils.hpp"
+#include "tf2/utils.h"
+#include "tf2_geometry_msgs/tf2_geometry_msgs.hpp"
+#include "gtest/gtest.h"
+
+TEST(CompactPath, RoundTrip)
+{
+  nav_msgs::msg::Path path;
+  path.header.frame_id = "map";
+  path.header.stamp.sec = 12;
+  for (int i = 0; i != 100; i++) {
+    geometry_msgs::msg::PoseStamped pose;
+    pose.header = path.header;
+    pose.pose.position.x = 0.05 * i;
+    pose.pose.position.y = std::sin(0.1 * i);
+    pose.pose.orientation = nav2_util::geometry_utils::orientationAroundZAxis(0.06 * i - 3.0);
+    path.poses.push_back(pose);
+  }
+
+  nav2_msgs::msg::CompactPath compact_path;
+  nav2_util::toCompactPath(path, compact_path);
+  EXPECT_EQ(nav2_util::compactPathSize(compact_path), path.poses.size());
+  EXPECT_EQ(compact_path.header, path.header);
+  EXPECT_TRUE(compact_path.curvature.empty());
+  EXPECT_TRUE(compact_path.velocity.empty());
+
+  nav_msgs::msg::Path converted;
+  ASSERT_TRUE(nav2_util::fromCompactPath(compact_path, converted));
+  EXPECT_EQ(converted.header, path.header);
+  ASSERT_EQ(converted.poses.size(), path.poses.size());
+  for (size_t i = 0; i != path.poses.size(); i++) {
+    EXPECT_EQ(converted.poses[i].header, path.header);
+    EXPECT_NEAR(converted.poses[i].pose.position.x, path.poses[i].pose.position.x, 1e-5);
+    EXPECT_NEAR(converted.poses[i].pose.position.y, path.poses[i].pose.position.y, 1e-5);
+    const double yaw_error = tf2::getYaw(converted.poses[i].pose.orientation) -
+      tf2::getYaw(path.poses[i].pose.orientation);
+    EXPECT_NEAR(std::remainder(yaw_error, 2.0 * M_PI), 0.0, 1e-5);
+  }
+}
+
+TEST(CompactPath, Malformed)
+{
+  nav2_msgs::msg::CompactPath compact_path;
+  nav_msgs::msg::Path path;
+  EXPECT_TRUE(nav2_util::fromCompactPath(compact_path, path));
+  EXPECT_TRUE(path.poses.empty());
+
+  compact_path.x = {0.0f, 1.0f};
+  compact_path.y = {0.0f, 1.0f};
+  compact_path.yaw = {0.0f, 1.0f};
+  compact_path.velocity = {0.5f};
+  EXPECT_EQ(nav2_util::compactPathSize(compact_path), 0u);
+  EXPECT_FALSE(nav2_util::fromCompactPath(compact_path, path));
+
+  compact_path.velocity.push_back(0.5f);
+  EXPECT_EQ(nav2_util::compactPathSize(compact_path), 2u);
+  compact_path.yaw.pop_back();
+  EXPECT_FALSE(nav2_util::fromCompactPath(compact_path, path));
+}
@@ -0,0 +1,71 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <string>
+
+#include "nav2_util/heartbeat_registry.hpp"
+#include "gtest/gtest.h"
+
+using nav2_util::HeartbeatRegistry;
+
+TEST(HeartbeatRegistry, managedUntilEveryManagerWithdraws)
+{
+  const std::string node = "/managed_node";
+  EXPECT_FALSE(HeartbeatRegistry::isManaged(node));
+
+  HeartbeatRegistry::manage(node);
+  HeartbeatRegistry::manage(node);
+  EXPECT_TRUE(HeartbeatRegistry::isManaged(node));
+  EXPECT_FALSE(HeartbeatRegistry::isManaged("/other_node"));
+
+  HeartbeatRegistry::unmanage(node);
+  EXPECT_TRUE(HeartbeatRegistry::isManaged(node));
+  HeartbeatRegistry::unmanage(node);
+  EXPECT_FALSE(HeartbeatRegistry::isManaged(node));
+
+  // Withdrawing more than announced does not underflow the count
+  HeartbeatRegistry::unmanage(node);
+  HeartbeatRegistry::manage(node);
+  EXPECT_TRUE(HeartbeatRegistry::isManaged(node));
+  HeartbeatRegistry::unmanage(node);
+  EXPECT_FALSE(HeartbeatRegistry::isManaged(node));
+}
+
+TEST(HeartbeatRegistry, sharesTheCounterOfANode)
+{
+  const std::string node = "/beating_node";
+  EXPECT_EQ(HeartbeatRegistry::get(node), nullptr);
+
+  auto counter = HeartbeatRegistry::add(node);
+  ASSERT_NE(counter, nullptr);
+  EXPECT_EQ(counter->load(), 0u);
+  auto observed = HeartbeatRegistry::get(node);
+  EXPECT_EQ(observed, counter);
+  counter->fetch_add(1);
+  EXPECT_EQ(observed->load(), 1u);
+  EXPECT_EQ(HeartbeatRegistry::get("/other_node"), nullptr);
+
+  // A node registering again replaces its counter
+  auto replacement = HeartbeatRegistry::add(node);
+  EXPECT_NE(replacement, counter);
+  EXPECT_EQ(HeartbeatRegistry::get(node), replacement);
+  EXPECT_EQ(HeartbeatRegistry::get(node)->load(), 0u);
+
+  // Holders of a removed counter keep it, but the node is no longer found
+  HeartbeatRegistry::remove(node);
+  EXPECT_EQ(HeartbeatRegistry::get(node), nullptr);
+  EXPECT_EQ(observed->load(), 1u);
+  HeartbeatRegistry::remove(node);
+}
@@ -0,0 +1,75 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+
+#include "nav2_util/memory_registry.hpp"
+#include "gtest/gtest.h"
+
+using nav2_util::MemoryRegistry;
+using nav2_util::MemoryTracker;
+
+TEST(MemoryRegistry, tracksCurrentAndPeakBytes)
+{
+  auto counter = MemoryRegistry::get("test/buffers");
+  EXPECT_EQ(counter, MemoryRegistry::get("test/buffers"));
+  {
+    MemoryTracker first("test/buffers");
+    first.update(100);
+    MemoryTracker second("test/buffers");
+    second.update(50);
+    EXPECT_EQ(counter->current(), 150u);
+    first.update(20);
+    EXPECT_EQ(counter->current(), 70u);
+    EXPECT_EQ(counter->peak(), 150u);
+  }
+  EXPECT_EQ(counter->current(), 0u);
+  EXPECT_EQ(counter->peak(), 150u);
+}
+
+TEST(MemoryRegistry, copiesTrackTheirOwnBytes)
+{
+  auto counter = MemoryRegistry::get("test/copies");
+  MemoryTracker tracker("test/copies");
+  tracker.update(10);
+  {
+    MemoryTracker copy(tracker);
+    EXPECT_EQ(copy.bytes(), 10u);
+    EXPECT_EQ(counter->current(), 20u);
+
+    MemoryTracker other("test/other");
+    other.update(5);
+    other = tracker;
+    EXPECT_EQ(MemoryRegistry::get("test/other")->current(), 0u);
+    EXPECT_EQ(counter->current(), 30u);
+  }
+  EXPECT_EQ(counter->current(), 10u);
+}
+
+TEST(MemoryRegistry, snapshotsAllTags)
+{
+  MemoryTracker tracker("test/snapshot");
+  tracker.update(3 * 1048576);
+  bool found = false;
+  for (const auto & usage : MemoryRegistry::snapshot()) {
+    if (usage.tag == "test/snapshot") {
+      found = true;
+      EXPECT_EQ(usage.current, 3u * 1048576u);
+      EXPECT_EQ(usage.peak, 3u * 1048576u);
+    }
+  }
+  EXPECT_TRUE(found);
+  EXPECT_NE(
+    MemoryRegistry::summary().find("test/snapshot: 3.0 MiB (peak 3.0 MiB)"), std::string::npos);
+}
@@ -14,6 +14,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "nav2_util/node_utils.hpp"
 #include "gtest/gtest.h"
@@ -94,3 +95,24 @@ TEST(GetPluginTypeParam, GetPluginTypeParam)
   ASSERT_EQ(get_plugin_type_param(node, "Foo"), "bar");
   EXPECT_THROW(get_plugin_type_param(node, "Waldo"), std::runtime_error);
 }
+
+TEST(DeclareThreadSettings, DeclareThreadSettings)
+{
+  auto node = std::make_shared<rclcpp::Node>("test_node");
+
+  // Defaults keep the default scheduling
+  auto settings = nav2_util::declareThreadSettings(node, "default_thread");
+  EXPECT_EQ(settings.num_threads, 1);
+  EXPECT_EQ(settings.priority, 0);
+  EXPECT_TRUE(settings.cpu_affinity.empty());
+  EXPECT_NO_THROW(nav2_util::applyThreadSettings(settings));
+
+  node->declare_parameter("worker_thread.num_threads", 0);
+  node->declare_parameter("worker_thread.cpu_affinity", std::vector<int64_t>{1, 3});
+  settings = nav2_util::declareThreadSettings(node, "worker_thread");
+  EXPECT_EQ(settings.num_threads, 1);
+  EXPECT_EQ(settings.cpu_affinity, (std::vector<int64_t>{1, 3}));
+
+  settings.cpu_affinity = {-1};
+  EXPECT_THROW(nav2_util::applyThreadSettings(settings), std::runtime_error);
+}
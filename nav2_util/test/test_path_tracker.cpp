@@ -0,0 +1,136 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cmath>
+#include <memory>
+
+#include "nav2_util/path_tracker.hpp"
+#include "nav2_util/geometry_utils.hpp"
+#include "geometry_msgs/msg/transform_stamped.hpp"
+#include "nav_msgs/msg/path.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "gtest/gtest.h"
+
+nav_msgs::msg::Path makeStraightPath(unsigned int size, double spacing)
+{
+  nav_msgs::msg::Path path;
+  path.header.frame_id = "map";
+  path.poses.resize(size);
+  for (unsigned int i = 0; i != size; i++) {
+    path.poses[i].header.frame_id = "map";
+    path.poses[i].pose.position.x = i * spacing;
+    path.poses[i].pose.orientation.w = 1.0;
+  }
+  return path;
+}
+
+TEST(PathTracker, distances)
+{
+  nav2_util::PathTracker tracker;
+  auto path = makeStraightPath(41, 0.05);
+  tracker.setPath(path);
+  EXPECT_EQ(tracker.size(), 41u);
+  EXPECT_NEAR(tracker.getDistance(0, 40), 2.0, 1e-9);
+  EXPECT_NEAR(tracker.getDistance(10, 20), 0.5, 1e-9);
+  EXPECT_NEAR(tracker.getDistance(10, 100), 1.5, 1e-9);
+
+  // Same as integrating the distance over the poses
+  for (double dist : {0.0, 0.12, 0.51, 1.01, 3.0}) {
+    for (size_t begin : {0u, 7u, 39u}) {
+      auto expected = nav2_util::geometry_utils::first_after_integrated_distance(
+        path.poses.begin() + begin, path.poses.end(), dist);
+      EXPECT_EQ(
+        tracker.getIndexAfterDistance(begin, dist),
+        static_cast<size_t>(expected - path.poses.begin()));
+    }
+  }
+  EXPECT_EQ(tracker.getIndexAfterDistance(41, 1.0), 41u);
+}
+
+TEST(PathTracker, progress)
+{
+  nav2_util::PathTracker tracker;
+  tracker.setPath(makeStraightPath(100, 0.1));
+
+  geometry_msgs::msg::Pose pose;
+  pose.position.x = 2.52;
+  pose.position.y = 0.3;
+  EXPECT_EQ(tracker.findClosestPose(pose, 0, 100), 25u);
+  EXPECT_EQ(tracker.findClosestPose(pose, 0, 10), 9u);
+  EXPECT_EQ(tracker.findClosestPose(pose, 10, 10), 10u);
+  EXPECT_EQ(tracker.findWindowEnd(pose, 25, 1.0), 35u);
+  EXPECT_EQ(tracker.findWindowEnd(pose, 25, 100.0), 100u);
+
+  // The progress never moves backwards
+  tracker.setProgress(25);
+  EXPECT_EQ(tracker.getProgress(), 25u);
+  tracker.setProgress(10);
+  EXPECT_EQ(tracker.getProgress(), 25u);
+  auto remaining = tracker.getRemainingPath();
+  EXPECT_EQ(remaining.header.frame_id, "map");
+  ASSERT_EQ(remaining.poses.size(), 75u);
+  EXPECT_NEAR(remaining.poses.front().pose.position.x, 2.5, 1e-9);
+
+  tracker.setProgress(1000);
+  EXPECT_EQ(tracker.getProgress(), 100u);
+  EXPECT_TRUE(tracker.getRemainingPath().poses.empty());
+
+  tracker.setPath(makeStraightPath(10, 0.1));
+  EXPECT_EQ(tracker.getProgress(), 0u);
+}
+
+TEST(PathTracker, transformWindow)
+{
+  auto clock = std::make_shared<rclcpp::Clock>();
+  auto tf_buffer = std::make_shared<tf2_ros::Buffer>(clock);
+  geometry_msgs::msg::TransformStamped transform;
+  transform.header.frame_id = "map";
+  transform.child_frame_id = "base_link";
+  transform.transform.translation.x = 1.0;
+  transform.transform.translation.y = 2.0;
+  // Rotated by 90 degrees
+  transform.transform.rotation.z = std::sqrt(0.5);
+  transform.transform.rotation.w = std::sqrt(0.5);
+  tf_buffer->setTransform(transform, "test", true);
+
+  nav2_util::PathTracker tracker;
+  tracker.setPath(makeStraightPath(20, 0.5));
+
+  nav_msgs::msg::Path transformed;
+  builtin_interfaces::msg::Time stamp;
+  ASSERT_TRUE(
+    tracker.transformWindow(
+      4, 8, "base_link", stamp, tf2::durationFromSec(0.1), tf_buffer, transformed));
+  EXPECT_EQ(transformed.header.frame_id, "base_link");
+  ASSERT_EQ(transformed.poses.size(), 4u);
+  for (unsigned int i = 0; i != 4; i++) {
+    // Pose (x, 0) of the map is (-2, 1 - x) in base_link
+    const double x = (i + 4) * 0.5;
+    EXPECT_EQ(transformed.poses[i].header.frame_id, "base_link");
+    EXPECT_NEAR(transformed.poses[i].pose.position.x, -2.0, 1e-6);
+    EXPECT_NEAR(transformed.poses[i].pose.position.y, 1.0 - x, 1e-6);
+  }
+
+  // Same frame, copied as is
+  ASSERT_TRUE(
+    tracker.transformWindow(
+      0, 100, "map", stamp, tf2::durationFromSec(0.1), tf_buffer, transformed));
+  EXPECT_EQ(transformed.poses.size(), 20u);
+  EXPECT_NEAR(transformed.poses.back().pose.position.x, 9.5, 1e-9);
+
+  // Unknown frame
+  EXPECT_FALSE(
+    tracker.transformWindow(
+      0, 10, "unknown", stamp, tf2::durationFromSec(0.0), tf_buffer, transformed));
+}
@@ -12,8 +12,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <chrono>
 #include <memory>
 #include <cmath>
+#include <string>
+#include <thread>
 #include "rclcpp/rclcpp.hpp"
 #include "nav2_util/robot_utils.hpp"
 #include "tf2_ros/transform_listener.h"
@@ -21,6 +24,7 @@
 #include "geometry_msgs/msg/pose_stamped.hpp"
 #include "gtest/gtest.h"
 #include "nav2_util/node_thread.hpp"
+#include "nav2_util/robot_pose_cache.hpp"
 #include "tf2_ros/create_timer_ros.h"
 
 TEST(RobotUtils, LookupExceptionError)
@@ -58,3 +62,119 @@ TEST(RobotUtils, validateTwist)
   msg.angular.z = NAN;
   EXPECT_FALSE(nav2_util::validateTwist(msg));
 }
+
+geometry_msgs::msg::TransformStamped makeTransform(
+  const std::string & parent, const std::string & child, double x, const rclcpp::Time & stamp)
+{
+  geometry_msgs::msg::TransformStamped transform;
+  transform.header.frame_id = parent;
+  transform.header.stamp = stamp;
+  transform.child_frame_id = child;
+  transform.transform.translation.x = x;
+  transform.transform.rotation.w = 1.0;
+  return transform;
+}
+
+// Waits for the cache to hold a pose at the given x
+bool waitForPose(const nav2_util::RobotPoseCache & cache, double x)
+{
+  geometry_msgs::msg::PoseStamped pose;
+  for (int i = 0; i != 200; i++) {
+    if (cache.getPose(pose) && std::abs(pose.pose.position.x - x) < 1e-6) {
+      return true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return false;
+}
+
+TEST(RobotPoseCache, ServesTheLatestPose)
+{
+  auto node = std::make_shared<rclcpp::Node>("pose_cache_hit", rclcpp::NodeOptions());
+  auto cache = nav2_util::RobotPoseCache::acquire(
+    node->get_node_topics_interface(), node->get_clock(), "map", "base_link");
+  EXPECT_EQ(
+    cache, nav2_util::RobotPoseCache::acquire(
+      node->get_node_topics_interface(), node->get_clock(), "map", "base_link"));
+  geometry_msgs::msg::PoseStamped pose;
+  EXPECT_FALSE(cache->getPose(pose));
+
+  tf2_ros::TransformBroadcaster broadcaster(node);
+  broadcaster.sendTransform(makeTransform("map", "odom", 1.0, node->now()));
+  broadcaster.sendTransform(makeTransform("odom", "base_link", 2.0, node->now()));
+  ASSERT_TRUE(waitForPose(*cache, 3.0));
+
+  // Served by getCurrentPose when given the cache, without the TF buffer of the caller
+  tf2_ros::Buffer tf(node->get_clock());
+  EXPECT_FALSE(nav2_util::getCurrentPose(pose, tf, "map", "base_link", 1.0));
+  ASSERT_TRUE(
+    nav2_util::getCurrentPose(pose, tf, "map", "base_link", 1.0, rclcpp::Time(), cache));
+  EXPECT_EQ(pose.header.frame_id, "map");
+  EXPECT_DOUBLE_EQ(pose.pose.position.x, 3.0);
+}
+
+TEST(RobotPoseCache, RejectsStalePoses)
+{
+  auto node = std::make_shared<rclcpp::Node>("pose_cache_stale", rclcpp::NodeOptions());
+  auto cache = nav2_util::RobotPoseCache::acquire(
+    node->get_node_topics_interface(), node->get_clock(), "stale_map", "stale_base_link");
+
+  tf2_ros::TransformBroadcaster broadcaster(node);
+  const rclcpp::Time stamp = node->now() - rclcpp::Duration::from_seconds(10.0);
+  broadcaster.sendTransform(makeTransform("stale_map", "stale_base_link", 1.0, stamp));
+  ASSERT_TRUE(waitForPose(*cache, 1.0));
+
+  geometry_msgs::msg::PoseStamped pose;
+  EXPECT_FALSE(cache->getPose(pose, node->now(), rclcpp::Duration::from_seconds(1.0)));
+  EXPECT_TRUE(cache->getPose(pose, node->now(), rclcpp::Duration::from_seconds(20.0)));
+
+  // getCurrentPose falls back to the TF buffer of the caller, empty here
+  tf2_ros::Buffer tf(node->get_clock());
+  EXPECT_FALSE(
+    nav2_util::getCurrentPose(
+      pose, tf, "stale_map", "stale_base_link", 1.0, rclcpp::Time(), cache));
+}
+
+TEST(RobotPoseCache, FollowsChangesOfTheFrameChain)
+{
+  auto node = std::make_shared<rclcpp::Node>("pose_cache_chain", rclcpp::NodeOptions());
+  auto cache = nav2_util::RobotPoseCache::acquire(
+    node->get_node_topics_interface(), node->get_clock(), "chain_map", "chain_base_link");
+
+  tf2_ros::TransformBroadcaster broadcaster(node);
+  broadcaster.sendTransform(makeTransform("chain_map", "chain_odom", 1.0, node->now()));
+  broadcaster.sendTransform(makeTransform("chain_odom", "chain_base_link", 2.0, node->now()));
+  ASSERT_TRUE(waitForPose(*cache, 3.0));
+
+  // The robot frame is attached to another parent
+  broadcaster.sendTransform(makeTransform("chain_map", "chain_other", 4.0, node->now()));
+  broadcaster.sendTransform(makeTransform("chain_other", "chain_base_link", 1.0, node->now()));
+  EXPECT_TRUE(waitForPose(*cache, 5.0));
+
+  // Moving the new parent moves the robot
+  broadcaster.sendTransform(makeTransform("chain_map", "chain_other", 6.0, node->now()));
+  EXPECT_TRUE(waitForPose(*cache, 7.0));
+}
+
+TEST(RobotPoseCache, KeyedByTheRemappedTopics)
+{
+  auto make_node = [](const std::string & name, const std::string & ns, bool remap) {
+      rclcpp::NodeOptions options;
+      if (remap) {
+        options.arguments({"--ros-args", "-r", "/tf:=tf", "-r", "/tf_static:=tf_static"});
+      }
+      return std::make_shared<rclcpp::Node>(name, ns, options);
+    };
+  auto acquire = [](const rclcpp::Node::SharedPtr & node) {
+      return nav2_util::RobotPoseCache::acquire(
+        node->get_node_topics_interface(), node->get_clock(), "map", "base_link");
+    };
+
+  auto robot1 = acquire(make_node("controller", "robot1", true));
+  auto robot2 = acquire(make_node("controller", "robot2", true));
+  auto robot1_planner = acquire(make_node("planner", "robot1", true));
+  auto global = acquire(make_node("controller", "robot3", false));
+  EXPECT_NE(robot1, robot2);
+  EXPECT_EQ(robot1, robot1_planner);
+  EXPECT_NE(robot1, global);
+}
@@ -0,0 +1,64 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cmath>
+#include <memory>
+#include <thread>
+
+#include "nav2_util/seqlock.hpp"
+#include "gtest/gtest.h"
+
+struct Value
+{
+  double a;
+  double b;
+  bool flag;
+};
+
+TEST(SeqLock, storeAndLoad)
+{
+  nav2_util::SeqLock<Value> value(Value{1.0, 2.0, true});
+  EXPECT_EQ(value.writes(), 1u);
+  EXPECT_EQ(value.load().a, 1.0);
+  EXPECT_EQ(value.load().b, 2.0);
+  EXPECT_TRUE(value.load().flag);
+
+  value.store(Value{3.0, 4.0, false});
+  EXPECT_EQ(value.writes(), 2u);
+  EXPECT_EQ(value.load().a, 3.0);
+  EXPECT_EQ(value.load().b, 4.0);
+  EXPECT_FALSE(value.load().flag);
+}
+
+TEST(SeqLock, concurrentReads)
+{
+  // Values are always written with b = -a, so a torn read would be detected
+  nav2_util::SeqLock<Value> value(Value{0.0, 0.0, false});
+  std::thread writer([&value]() {
+      for (int i = 1; i <= 100000; i++) {
+        value.store(Value{static_cast<double>(i), -static_cast<double>(i), true});
+      }
+    });
+
+  double last = 0.0;
+  for (int i = 0; i < 100000; i++) {
+    const Value read = value.load();
+    EXPECT_EQ(read.a, -read.b);
+    EXPECT_GE(read.a, last);
+    last = read.a;
+  }
+  writer.join();
+  EXPECT_EQ(value.load().a, 100000.0);
+  EXPECT_EQ(value.writes(), 100001u);
+}
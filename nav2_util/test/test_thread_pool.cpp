@@ -0,0 +1,64 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include "nav2_util/thread_pool.hpp"
+#include "gtest/gtest.h"
+
+TEST(ThreadPool, runsEachIterationOnce)
+{
+  for (size_t threads : {0u, 1u, 3u}) {
+    nav2_util::ThreadPool pool(threads);
+    EXPECT_EQ(pool.size(), threads);
+    // Several loops in a row reuse the same threads
+    for (size_t count : {0u, 1u, 2u, 7u, 100u}) {
+      std::vector<std::atomic<int>> runs(count);
+      pool.parallelFor(
+        count, [&runs](size_t i) {
+          runs[i]++;
+        });
+      for (size_t i = 0; i != count; i++) {
+        EXPECT_EQ(runs[i].load(), 1);
+      }
+    }
+  }
+}
+
+TEST(ThreadPool, rethrowsTaskException)
+{
+  nav2_util::ThreadPool pool(2);
+  std::atomic<int> runs{0};
+  EXPECT_THROW(
+    pool.parallelFor(
+      10, [&runs](size_t i) {
+        runs++;
+        if (i == 5) {
+          throw std::runtime_error("task failed");
+        }
+      }),
+    std::runtime_error);
+  // The other iterations still ran
+  EXPECT_EQ(runs.load(), 10);
+
+  // The pool is still usable
+  runs = 0;
+  pool.parallelFor(
+    10, [&runs](size_t) {
+      runs++;
+    });
+  EXPECT_EQ(runs.load(), 10);
+}
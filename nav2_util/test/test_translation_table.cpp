@@ -0,0 +1,63 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <vector>
+
+#include "nav2_util/translation_table.hpp"
+#include "gtest/gtest.h"
+
+TEST(TranslationTable, TranslatesBytes)
+{
+  auto table = nav2_util::makeByteTranslationTable<int8_t>(
+    [](uint8_t value) {return value == 255 ? -1 : value / 3;});
+  EXPECT_EQ(table[0], 0);
+  EXPECT_EQ(table[254], 84);
+  EXPECT_EQ(table[255], -1);
+
+  // Every length around the unrolled steps
+  for (size_t size = 0; size < 10; size++) {
+    std::vector<uint8_t> in(size);
+    for (size_t i = 0; i < size; i++) {
+      in[i] = static_cast<uint8_t>(250 + i);
+    }
+    std::vector<int8_t> out(size, 100);
+    nav2_util::translateValues(table, in.data(), size, out.data());
+    for (size_t i = 0; i < size; i++) {
+      EXPECT_EQ(out[i], table[in[i]]);
+    }
+  }
+}
+
+TEST(TranslationTable, SignedValuesIndexAsUnsigned)
+{
+  auto table = nav2_util::makeByteTranslationTable<uint8_t>(
+    [](uint8_t value) {return 255 - value;});
+  std::vector<int8_t> in = {-1, 0, 100, -128, 127};
+  std::vector<uint8_t> out(in.size());
+  nav2_util::translateValues(table, in.data(), in.size(), out.data());
+  EXPECT_EQ(out, (std::vector<uint8_t>{0, 255, 155, 127, 128}));
+}
+
+TEST(TranslationTable, WideIndices)
+{
+  std::vector<int8_t> table(1000);
+  for (size_t i = 0; i < table.size(); i++) {
+    table[i] = static_cast<int8_t>(i % 101);
+  }
+  std::vector<uint32_t> in = {0, 999, 101, 505, 42};
+  std::vector<int8_t> out(in.size());
+  nav2_util::translateValues(table.data(), in.data(), in.size(), out.data());
+  EXPECT_EQ(out, (std::vector<int8_t>{0, 90, 0, 0, 42}));
+}
@@ -0,0 +1,66 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "nav2_util/worker_thread.hpp"
+#include "gtest/gtest.h"
+
+TEST(WorkerThread, runsTasksInOrderInItsThread)
+{
+  std::thread::id worker_id;
+  nav2_util::WorkerThread worker([&worker_id]() {worker_id = std::this_thread::get_id();});
+
+  std::vector<int> order;
+  std::vector<std::future<std::thread::id>> results;
+  for (int i = 0; i != 5; i++) {
+    results.push_back(
+      worker.post(
+        [&order, i]() {
+          order.push_back(i);
+          return std::this_thread::get_id();
+        }));
+  }
+  for (auto & result : results) {
+    EXPECT_EQ(result.get(), worker_id);
+  }
+  EXPECT_NE(worker_id, std::this_thread::get_id());
+  EXPECT_EQ(order, std::vector<int>({0, 1, 2, 3, 4}));
+}
+
+TEST(WorkerThread, storesTaskException)
+{
+  nav2_util::WorkerThread worker;
+  auto failed = worker.post([]() -> int {throw std::runtime_error("task failed");});
+  EXPECT_THROW(failed.get(), std::runtime_error);
+
+  // The thread is still usable
+  EXPECT_EQ(worker.post([]() {return 42;}).get(), 42);
+}
+
+TEST(WorkerThread, runsPostedTasksBeforeStopping)
+{
+  int runs = 0;
+  {
+    nav2_util::WorkerThread worker;
+    for (int i = 0; i != 10; i++) {
+      worker.post([&runs]() {runs++;});
+    }
+  }
+  EXPECT_EQ(runs, 10);
+}
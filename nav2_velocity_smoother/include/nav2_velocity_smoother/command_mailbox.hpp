@@ -0,0 +1,77 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_VELOCITY_SMOOTHER__COMMAND_MAILBOX_HPP_
+#define NAV2_VELOCITY_SMOOTHER__COMMAND_MAILBOX_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+namespace nav2_velocity_smoother
+{
+
+/**
+ * @class nav2_velocity_smoother::CommandMailbox
+ * @brief Lock-free single slot passing the latest value from one writer thread to one
+ * reader thread, as a triple buffer: the writer fills its own slot then swaps it with
+ * the shared one, which the reader swaps with its own slot when it holds a new value.
+ * Neither side ever waits for the other.
+ */
+template<typename T>
+class CommandMailbox
+{
+public:
+  /**
+   * @brief Posts a value, replacing the one not read yet if any. Only called by the writer.
+   * @param value Value to post
+   */
+  void write(const T & value)
+  {
+    slots_[back_] = value;
+    back_ = shared_.exchange(back_ | FRESH, std::memory_order_acq_rel) & INDEX;
+  }
+
+  /**
+   * @brief Takes the latest value posted, if not taken yet. Only called by the reader.
+   * @param value Output value
+   * @return bool true if there was a new value
+   */
+  bool read(T & value)
+  {
+    if (!(shared_.load(std::memory_order_relaxed) & FRESH)) {
+      return false;
+    }
+    front_ = shared_.exchange(front_, std::memory_order_acq_rel) & INDEX;
+    value = std::move(slots_[front_]);
+    return true;
+  }
+
+protected:
+  // The shared index holds the index of the shared slot and whether it holds a new value
+  static constexpr uint8_t INDEX = 3;
+  static constexpr uint8_t FRESH = 4;
+
+  std::array<T, 3> slots_;
+  std::atomic<uint8_t> shared_{1};
+  // Slot of the writer
+  uint8_t back_{0};
+  // Slot of the reader
+  uint8_t front_{2};
+};
+
+}  // namespace nav2_velocity_smoother
+
+#endif  // NAV2_VELOCITY_SMOOTHER__COMMAND_MAILBOX_HPP_
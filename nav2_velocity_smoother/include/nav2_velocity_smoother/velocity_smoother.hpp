@@ -15,21 +15,28 @@
 #ifndef NAV2_VELOCITY_SMOOTHER__VELOCITY_SMOOTHER_HPP_
 #define NAV2_VELOCITY_SMOOTHER__VELOCITY_SMOOTHER_HPP_
 
+#include <atomic>
 #include <chrono>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
+#include "diagnostic_updater/diagnostic_updater.hpp"
+
 #include "nav2_util/lifecycle_node.hpp"
 #include "nav2_util/node_utils.hpp"
 #include "nav2_util/odometry_utils.hpp"
 #include "nav2_util/robot_utils.hpp"
 #include "nav2_util/twist_publisher.hpp"
+#include "nav2_util/twist_registry.hpp"
 #include "nav2_util/twist_subscriber.hpp"
 #include "geometry_msgs/msg/twist.hpp"
 #include "geometry_msgs/msg/twist_stamped.hpp"
+#include "nav2_velocity_smoother/command_mailbox.hpp"
 
 namespace nav2_velocity_smoother
 {
@@ -125,6 +132,24 @@ protected:
    */
   void smootherTimer();
 
+  /**
+   * @brief Loop of the dedicated smoothing thread, smoothing at absolute deadlines
+   * of the smoothing period until deactivated
+   */
+  void smoothingThreadLoop();
+
+  /**
+   * @brief Records how late a smoothing cycle started
+   * @param lateness Time between the deadline and the start of the cycle
+   */
+  void recordJitter(std::chrono::nanoseconds lateness);
+
+  /**
+   * @brief Reports the jitter of the smoothing cycles since the last report
+   * @param stat Diagnostic status to fill
+   */
+  void fillJitterDiagnostics(diagnostic_updater::DiagnosticStatusWrapper & stat);
+
   /**
    * @brief Dynamic reconfigure callback
    * @param parameters Parameter list to change
@@ -138,6 +163,36 @@ protected:
   std::unique_ptr<nav2_util::TwistSubscriber> cmd_sub_;
   rclcpp::TimerBase::SharedPtr timer_;
 
+  // Dedicated smoothing thread, taking commands from the mailbox rather than
+  // sharing command_ with the subscription callback
+  struct ReceivedCommand
+  {
+    geometry_msgs::msg::TwistStamped command;
+    rclcpp::Time time;
+  };
+  bool use_smoothing_thread_{false};
+  bool use_realtime_priority_{false};
+  std::thread smoothing_thread_;
+  std::atomic<bool> smoothing_thread_active_{false};
+  CommandMailbox<ReceivedCommand> command_mailbox_;
+  // Keeps a single writer to the mailbox when commands are also handed in directly
+  std::mutex command_write_mutex_;
+  // Guards the parameters against dynamic updates while the smoothing thread runs,
+  // and the command against direct in-process input while the timer runs
+  std::mutex params_mutex_;
+
+  // Input topic registered to take commands directly from publishers in this process
+  std::string direct_input_topic_;
+
+  // Jitter of the smoothing cycles since the last diagnostics report
+  diagnostic_updater::Updater diagnostics_updater_;
+  std::mutex jitter_mutex_;
+  std::chrono::steady_clock::time_point last_cycle_time_;
+  unsigned int jitter_count_{0};
+  double jitter_sum_{0.0};
+  double jitter_max_{0.0};
+  unsigned int overruns_{0};
+
   rclcpp::Clock::SharedPtr clock_;
   geometry_msgs::msg::TwistStamped last_cmd_;
   geometry_msgs::msg::TwistStamped::SharedPtr command_;
@@ -12,7 +12,14 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#ifdef __linux__
+#include <time.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
 #include <chrono>
+#include <cmath>
 #include <limits>
 #include <memory>
 #include <string>
@@ -31,8 +38,15 @@ namespace nav2_velocity_smoother
 
 VelocitySmoother::VelocitySmoother(const rclcpp::NodeOptions & options)
 : LifecycleNode("velocity_smoother", "", options),
+  diagnostics_updater_(this),
   last_command_time_{0, 0, get_clock()->get_clock_type()}
 {
+  diagnostics_updater_.setHardwareID("Nav2");
+  diagnostics_updater_.add(
+    "Velocity Smoother Jitter",
+    [this](diagnostic_updater::DiagnosticStatusWrapper & stat) {
+      fillJitterDiagnostics(stat);
+    });
 }
 
 VelocitySmoother::~VelocitySmoother()
@@ -41,6 +55,13 @@ VelocitySmoother::~VelocitySmoother()
     timer_->cancel();
     timer_.reset();
   }
+  if (!direct_input_topic_.empty()) {
+    nav2_util::TwistRegistry::remove(direct_input_topic_);
+  }
+  smoothing_thread_active_ = false;
+  if (smoothing_thread_.joinable()) {
+    smoothing_thread_.join();
+  }
 }
 
 nav2_util::CallbackReturn
@@ -137,9 +158,10 @@ VelocitySmoother::on_configure(const rclcpp_lifecycle::State &)
   );
 
   declare_parameter_if_not_declared(node, "use_realtime_priority", rclcpp::ParameterValue(false));
-  bool use_realtime_priority = false;
-  node->get_parameter("use_realtime_priority", use_realtime_priority);
-  if (use_realtime_priority) {
+  declare_parameter_if_not_declared(node, "use_smoothing_thread", rclcpp::ParameterValue(false));
+  node->get_parameter("use_realtime_priority", use_realtime_priority_);
+  node->get_parameter("use_smoothing_thread", use_smoothing_thread_);
+  if (use_realtime_priority_) {
     try {
       nav2_util::setSoftRealTimePriority();
     } catch (const std::runtime_error & e) {
@@ -156,14 +178,33 @@ VelocitySmoother::on_activate(const rclcpp_lifecycle::State &)
 {
   RCLCPP_INFO(get_logger(), "Activating");
   smoothed_cmd_pub_->on_activate();
-  double timer_duration_ms = 1000.0 / smoothing_frequency_;
-  timer_ = this->create_wall_timer(
-    std::chrono::milliseconds(static_cast<int>(timer_duration_ms)),
-    std::bind(&VelocitySmoother::smootherTimer, this));
+  last_cycle_time_ = std::chrono::steady_clock::time_point();
+  if (use_smoothing_thread_) {
+    smoothing_thread_active_ = true;
+    smoothing_thread_ = std::thread(&VelocitySmoother::smoothingThreadLoop, this);
+  } else {
+    double timer_duration_ms = 1000.0 / smoothing_frequency_;
+    timer_ = this->create_wall_timer(
+      std::chrono::milliseconds(static_cast<int>(timer_duration_ms)),
+      std::bind(&VelocitySmoother::smootherTimer, this));
+  }
 
   dyn_params_handler_ = this->add_on_set_parameters_callback(
     std::bind(&VelocitySmoother::dynamicParametersCallback, this, _1));
 
+  // Take commands directly from the publishers of this process, such as a composed
+  // controller server, without serializing them or going through the executor
+  bool direct_in_process = false;
+  get_parameter("direct_in_process_cmd_vel", direct_in_process);
+  if (direct_in_process) {
+    direct_input_topic_ = get_node_topics_interface()->resolve_topic_name("cmd_vel");
+    nav2_util::TwistRegistry::add(
+      direct_input_topic_,
+      [this](std::unique_ptr<geometry_msgs::msg::TwistStamped> msg) {
+        inputCommandStampedCallback(geometry_msgs::msg::TwistStamped::SharedPtr(std::move(msg)));
+      });
+  }
+
   // create bond connection
   createBond();
   return nav2_util::CallbackReturn::SUCCESS;
@@ -173,10 +214,18 @@ nav2_util::CallbackReturn
 VelocitySmoother::on_deactivate(const rclcpp_lifecycle::State &)
 {
   RCLCPP_INFO(get_logger(), "Deactivating");
+  if (!direct_input_topic_.empty()) {
+    nav2_util::TwistRegistry::remove(direct_input_topic_);
+    direct_input_topic_.clear();
+  }
   if (timer_) {
     timer_->cancel();
     timer_.reset();
   }
+  smoothing_thread_active_ = false;
+  if (smoothing_thread_.joinable()) {
+    smoothing_thread_.join();
+  }
   smoothed_cmd_pub_->on_deactivate();
   dyn_params_handler_.reset();
 
@@ -211,6 +260,18 @@ void VelocitySmoother::inputCommandStampedCallback(
     return;
   }
 
+  // Hand the command over to the smoothing thread without waiting on it
+  if (use_smoothing_thread_) {
+    ReceivedCommand received{*msg, now()};
+    if (msg->header.stamp.sec != 0 || msg->header.stamp.nanosec != 0) {
+      received.time = msg->header.stamp;
+    }
+    std::lock_guard<std::mutex> lock(command_write_mutex_);
+    command_mailbox_.write(received);
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(params_mutex_);
   command_ = msg;
   if (msg->header.stamp.sec == 0 && msg->header.stamp.nanosec == 0) {
     last_command_time_ = now();
@@ -281,8 +342,109 @@ double VelocitySmoother::applyConstraints(
   return v_curr + std::clamp(eta * dv, v_component_min, v_component_max);
 }
 
+void VelocitySmoother::smoothingThreadLoop()
+{
+  if (use_realtime_priority_) {
+    try {
+      nav2_util::setSoftRealTimePriority();
+    } catch (const std::runtime_error & e) {
+      RCLCPP_ERROR(get_logger(), "%s", e.what());
+    }
+  }
+
+  auto deadline = std::chrono::steady_clock::now();
+  while (smoothing_thread_active_) {
+    std::chrono::nanoseconds period;
+    {
+      std::lock_guard<std::mutex> lock(params_mutex_);
+      period = std::chrono::nanoseconds(static_cast<int64_t>(1e9 / smoothing_frequency_));
+    }
+    deadline += period;
+
+    // Sleep until the absolute deadline, so that the time spent smoothing doesn't
+    // drift the period. steady_clock is CLOCK_MONOTONIC on Linux.
+#ifdef __linux__
+    const auto since_epoch = deadline.time_since_epoch();
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(since_epoch);
+    struct timespec deadline_ts;
+    deadline_ts.tv_sec = seconds.count();
+    deadline_ts.tv_nsec = (since_epoch - seconds).count();
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline_ts, nullptr) == EINTR) {
+    }
+#else
+    std::this_thread::sleep_until(deadline);
+#endif
+    if (!smoothing_thread_active_) {
+      break;
+    }
+
+    recordJitter(std::chrono::steady_clock::now() - deadline);
+    smootherTimer();
+
+    // After an overrun, restart from now rather than catching up with a burst of cycles
+    const auto end = std::chrono::steady_clock::now();
+    if (end > deadline + period) {
+      deadline = end;
+      std::lock_guard<std::mutex> lock(jitter_mutex_);
+      overruns_++;
+    }
+  }
+}
+
+void VelocitySmoother::recordJitter(std::chrono::nanoseconds lateness)
+{
+  const double jitter = std::abs(std::chrono::duration<double, std::micro>(lateness).count());
+  std::lock_guard<std::mutex> lock(jitter_mutex_);
+  jitter_count_++;
+  jitter_sum_ += jitter;
+  jitter_max_ = std::max(jitter_max_, jitter);
+}
+
+void VelocitySmoother::fillJitterDiagnostics(diagnostic_updater::DiagnosticStatusWrapper & stat)
+{
+  std::lock_guard<std::mutex> lock(jitter_mutex_);
+  if (jitter_count_ == 0) {
+    stat.summary(diagnostic_msgs::msg::DiagnosticStatus::OK, "No cycles since the last report");
+  } else {
+    stat.summaryf(
+      diagnostic_msgs::msg::DiagnosticStatus::OK, "%u cycles since the last report",
+      jitter_count_);
+  }
+  stat.add("Smoothing thread", use_smoothing_thread_);
+  stat.addf("Jitter mean (us)", "%.1f", jitter_count_ > 0 ? jitter_sum_ / jitter_count_ : 0.0);
+  stat.addf("Jitter max (us)", "%.1f", jitter_max_);
+  stat.addf("Overruns", "%u", overruns_);
+
+  jitter_count_ = 0;
+  jitter_sum_ = 0.0;
+  jitter_max_ = 0.0;
+  overruns_ = 0;
+}
+
 void VelocitySmoother::smootherTimer()
 {
+  std::lock_guard<std::mutex> lock(params_mutex_);
+
+  if (use_smoothing_thread_) {
+    ReceivedCommand received;
+    if (command_mailbox_.read(received)) {
+      if (!command_) {
+        command_ = std::make_shared<geometry_msgs::msg::TwistStamped>();
+      }
+      *command_ = std::move(received.command);
+      last_command_time_ = received.time;
+    }
+  } else {
+    // Jitter of the timer, as the deviation of its periods
+    const auto cycle_time = std::chrono::steady_clock::now();
+    if (last_cycle_time_ != std::chrono::steady_clock::time_point()) {
+      recordJitter(
+        cycle_time - last_cycle_time_ -
+        std::chrono::nanoseconds(static_cast<int64_t>(1e9 / smoothing_frequency_)));
+    }
+    last_cycle_time_ = cycle_time;
+  }
+
   // Wait until the first command is received
   if (!command_) {
     return;
@@ -371,6 +533,7 @@ void VelocitySmoother::smootherTimer()
 rcl_interfaces::msg::SetParametersResult
 VelocitySmoother::dynamicParametersCallback(std::vector<rclcpp::Parameter> parameters)
 {
+  std::lock_guard<std::mutex> lock(params_mutex_);
   rcl_interfaces::msg::SetParametersResult result;
   result.successful = true;
 
@@ -381,6 +544,10 @@ VelocitySmoother::dynamicParametersCallback(std::vector<rclcpp::Parameter> param
     if (type == ParameterType::PARAMETER_DOUBLE) {
       if (name == "smoothing_frequency") {
         smoothing_frequency_ = parameter.as_double();
+        // The smoothing thread picks the new period up on its next cycle
+        if (use_smoothing_thread_) {
+          continue;
+        }
         if (timer_) {
           timer_->cancel();
           timer_.reset();
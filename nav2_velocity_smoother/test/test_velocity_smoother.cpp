@@ -110,6 +110,47 @@ TEST(VelocitySmootherTest, openLoopTestTimer)
   }
 }
 
+TEST(VelocitySmootherTest, openLoopTestSmoothingThread)
+{
+  auto smoother =
+    std::make_shared<VelSmootherShim>();
+  smoother->declare_parameter("use_smoothing_thread", rclcpp::ParameterValue(true));
+  smoother->set_parameter(rclcpp::Parameter("use_smoothing_thread", true));
+  rclcpp_lifecycle::State state;
+  smoother->configure(state);
+  smoother->activate(state);
+
+  std::vector<double> linear_vels;
+  auto subscription = nav2_util::TwistSubscriber(
+    smoother,
+    "cmd_vel_smoothed",
+    1,
+    [&](geometry_msgs::msg::Twist::SharedPtr msg) {
+      linear_vels.push_back(msg->linear.x);
+    }, [&](geometry_msgs::msg::TwistStamped::SharedPtr msg) {
+      linear_vels.push_back(msg->twist.linear.x);
+    });
+
+  // The command goes through the mailbox to the smoothing thread
+  auto cmd = std::make_shared<geometry_msgs::msg::Twist>();
+  cmd->linear.x = 1.0;  // Max is 0.5, so should threshold
+  smoother->sendCommandMsg(cmd);
+
+  auto start = smoother->now();
+  while (smoother->now() - start < 1.5s) {
+    rclcpp::spin_some(smoother->get_node_base_interface());
+  }
+  smoother->deactivate(state);
+
+  // Published at the smoothing frequency until stopped by the timeout, as with the timer
+  EXPECT_GT(linear_vels.size(), 19u);
+  EXPECT_LT(linear_vels.size(), 30u);
+  EXPECT_EQ(linear_vels.back(), 0.0);
+  for (unsigned int i = 0; i != linear_vels.size(); i++) {
+    EXPECT_TRUE(linear_vels[i] <= 0.5);
+  }
+}
+
 TEST(VelocitySmootherTest, approxClosedLoopTestTimer)
 {
   auto smoother =
@@ -0,0 +1,108 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "nav2_voxel_grid/voxel_grid.hpp"
+
+// A sweep of a 3D lidar with 128 rings of 1024 points at the center of a 20 m wide grid of
+// 5 cm cells, as the voxel layer of a local costmap clears it
+const unsigned int g_size_xy = 400;
+const unsigned int g_size_z = 16;
+const double g_sensor_x = 200.5, g_sensor_y = 200.5, g_sensor_z = 4.5;
+const unsigned int g_max_range = 200;
+const unsigned int g_min_range = 0;
+
+std::vector<std::array<double, 3>> createSweep()
+{
+  std::mt19937 generator(0);
+  std::uniform_real_distribution<double> range_dist(20.0, 199.0);
+  std::vector<std::array<double, 3>> ends;
+  for (int ring = 0; ring < 128; ++ring) {
+    const double elevation = -0.4 + 0.5 * ring / 127.0;
+    for (int i = 0; i < 1024; ++i) {
+      const double azimuth = 2.0 * M_PI * i / 1024.0;
+      const double range = range_dist(generator);
+      const double z = std::min(
+        std::max(g_sensor_z + range * std::sin(elevation), 0.0), g_size_z - 0.01);
+      ends.push_back(
+        {g_sensor_x + range * std::cos(elevation) * std::cos(azimuth),
+          g_sensor_y + range * std::cos(elevation) * std::sin(azimuth), z});
+    }
+  }
+  return ends;
+}
+
+const std::vector<std::array<double, 3>> g_sweep = createSweep();
+
+static void BM_ClearSerially(benchmark::State & state)
+{
+  nav2_voxel_grid::VoxelGrid grid(g_size_xy, g_size_xy, g_size_z);
+  std::vector<unsigned char> costmap(g_size_xy * g_size_xy, 255);
+  for (auto _ : state) {
+    state.PauseTiming();
+    grid.reset();
+    state.ResumeTiming();
+    for (const auto & end : g_sweep) {
+      grid.clearVoxelLineInMap(
+        g_sensor_x, g_sensor_y, g_sensor_z, end[0], end[1], end[2], costmap.data(),
+        0, 0, 0, 255, g_max_range, g_min_range);
+    }
+    benchmark::DoNotOptimize(costmap.data());
+  }
+  state.SetItemsProcessed(state.iterations() * g_sweep.size());
+}
+
+static void BM_ClearConcurrently(benchmark::State & state)
+{
+  const size_t num_threads = state.range(0);
+  nav2_voxel_grid::VoxelGrid grid(g_size_xy, g_size_xy, g_size_z);
+  std::vector<unsigned char> costmap(g_size_xy * g_size_xy, 255);
+  for (auto _ : state) {
+    state.PauseTiming();
+    grid.reset();
+    state.ResumeTiming();
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < num_threads; ++t) {
+      threads.emplace_back(
+        [&grid, t, num_threads]() {
+          const size_t begin = g_sweep.size() * t / num_threads;
+          const size_t end = g_sweep.size() * (t + 1) / num_threads;
+          for (size_t i = begin; i < end; ++i) {
+            grid.clearVoxelLineConcurrently(
+              g_sensor_x, g_sensor_y, g_sensor_z, g_sweep[i][0], g_sweep[i][1], g_sweep[i][2],
+              g_max_range, g_min_range);
+          }
+        });
+    }
+    for (auto & thread : threads) {
+      thread.join();
+    }
+    grid.updateClearedColumnsInMap(costmap.data(), 0, 0, 0, 255);
+    benchmark::DoNotOptimize(costmap.data());
+  }
+  state.SetItemsProcessed(state.iterations() * g_sweep.size());
+}
+
+BENCHMARK(BM_ClearSerially)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_ClearConcurrently)->RangeMultiplier(2)->Range(1, 8)
+  ->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
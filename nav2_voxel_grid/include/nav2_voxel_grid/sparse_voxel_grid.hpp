@@ -0,0 +1,359 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NAV2_VOXEL_GRID__SPARSE_VOXEL_GRID_HPP_
+#define NAV2_VOXEL_GRID__SPARSE_VOXEL_GRID_HPP_
+
+#include <stdint.h>
+#include <limits.h>
+#include <math.h>
+#include <array>
+#include <cstdlib>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "nav2_voxel_grid/voxel_grid.hpp"
+
+namespace nav2_voxel_grid
+{
+
+/**
+ * @class SparseVoxelGrid
+ * @brief A 3D grid storing voxels in 8x8x8 bricks which are only allocated once one of
+ * their voxels is observed, so its height is not limited and the memory grows with the
+ * observed space rather than the grid volume. Voxels of unallocated bricks are unknown.
+ * The number of marked and known voxels of each column is kept to answer the column
+ * queries of the VoxelLayer without walking the column. Marking, clearing and column
+ * semantics match nav2_voxel_grid::VoxelGrid, except that unknown voxels are only
+ * counted up to the grid height.
+ */
+class SparseVoxelGrid
+{
+public:
+  /**
+   * @brief  Constructor for a sparse voxel grid
+   * @param size_x The x size of the grid
+   * @param size_y The y size of the grid
+   * @param size_z The z size of the grid
+   */
+  SparseVoxelGrid(unsigned int size_x, unsigned int size_y, unsigned int size_z);
+
+  /**
+   * @brief  Resizes the grid to the desired size, leaving all voxels unknown
+   * @param size_x The x size of the grid
+   * @param size_y The y size of the grid
+   * @param size_z The z size of the grid
+   */
+  void resize(unsigned int size_x, unsigned int size_y, unsigned int size_z);
+
+  /**
+   * @brief  Set all voxels to unknown, releasing all bricks
+   */
+  void reset();
+
+  /**
+   * @brief  Mark a voxel and check if its column is marked
+   * @param x The x coordinate of the voxel
+   * @param y The y coordinate of the voxel
+   * @param z The z coordinate of the voxel
+   * @param marked_threshold Number of marked voxels a column may have and still be free
+   * @return True if the column has more than marked_threshold marked voxels
+   */
+  inline bool markVoxelInMap(
+    unsigned int x, unsigned int y, unsigned int z,
+    unsigned int marked_threshold)
+  {
+    if (x >= size_x_ || y >= size_y_ || z >= size_z_) {
+      RCLCPP_DEBUG(logger, "Error, voxel out of bounds.\n");
+      return false;
+    }
+
+    markVoxel(x, y, z);
+    return marked_counts_[y * size_x_ + x] > marked_threshold;
+  }
+
+  /**
+   * @brief  Clear the voxels along a line, updating the 2D map of each cleared column
+   * as nav2_voxel_grid::VoxelGrid::clearVoxelLineInMap does
+   * @param map_2d The 2D map to update, if NULL only the voxels are cleared
+   * @param unknown_threshold Number of unknown voxels a column may have and still be free
+   * @param mark_threshold Number of marked voxels a column may have and still be free
+   * @param free_cost Cost of free columns
+   * @param unknown_cost Cost of unknown columns
+   * @param max_length Maximum length of the line (voxels)
+   * @param min_length Length at the start of the line which is not cleared (voxels)
+   */
+  void clearVoxelLineInMap(
+    double x0, double y0, double z0, double x1, double y1, double z1, unsigned char * map_2d,
+    unsigned int unknown_threshold, unsigned int mark_threshold,
+    unsigned char free_cost = 0, unsigned char unknown_cost = 255,
+    unsigned int max_length = UINT_MAX, unsigned int min_length = 0);
+
+  /**
+   * @brief  Get the status of a voxel
+   * @return Status of the voxel, UNKNOWN if out of bounds
+   */
+  VoxelStatus getVoxel(unsigned int x, unsigned int y, unsigned int z) const;
+
+  /**
+   * @brief  Get the status of a column, in the same way as VoxelGrid::getVoxelColumn
+   * @return MARKED if more than marked_threshold voxels are marked, otherwise UNKNOWN if
+   * more than unknown_threshold voxels are unknown, FREE otherwise
+   */
+  VoxelStatus getVoxelColumn(
+    unsigned int x, unsigned int y,
+    unsigned int unknown_threshold = 0, unsigned int marked_threshold = 0) const;
+
+  /**
+   * @brief  Shift the grid, the voxels of column (x, y) move to (x - cell_ox, y - cell_oy).
+   * Columns shifted out of the grid are dropped and exposed columns are unknown.
+   * @param cell_ox Shift in x (cells)
+   * @param cell_oy Shift in y (cells)
+   */
+  void shift(int cell_ox, int cell_oy);
+
+  /**
+   * @brief  Pack the lowest 16 levels in the column format of VoxelGrid::getData,
+   * e.g. to publish them in a nav2_msgs::msg::VoxelGrid
+   * @param data Output with one element per column
+   */
+  void getColumnData(uint32_t * data) const;
+
+  unsigned int sizeX() const {return size_x_;}
+  unsigned int sizeY() const {return size_y_;}
+  unsigned int sizeZ() const {return size_z_;}
+
+  /**
+   * @brief  Get the number of allocated bricks
+   */
+  unsigned int numBricks() const {return bricks_.size() - free_bricks_.size();}
+
+  static constexpr unsigned int BRICK_BITS = 3;
+  static constexpr unsigned int BRICK_SIZE = 1 << BRICK_BITS;
+
+protected:
+  /**
+   * @brief  Known and marked flags of a brick, one 64 bit row along x per (y, z)
+   */
+  struct Brick
+  {
+    std::array<uint64_t, BRICK_SIZE * BRICK_SIZE> known;
+    std::array<uint64_t, BRICK_SIZE * BRICK_SIZE> marked;
+  };
+
+  static constexpr int NO_BRICK = -1;
+
+  inline int & brickIndex(unsigned int x, unsigned int y, unsigned int z)
+  {
+    return brick_index_[((z >> BRICK_BITS) * bricks_y_ + (y >> BRICK_BITS)) * bricks_x_ +
+             (x >> BRICK_BITS)];
+  }
+
+  inline int brickIndex(unsigned int x, unsigned int y, unsigned int z) const
+  {
+    return brick_index_[((z >> BRICK_BITS) * bricks_y_ + (y >> BRICK_BITS)) * bricks_x_ +
+             (x >> BRICK_BITS)];
+  }
+
+  /**
+   * @brief  Get the brick of a voxel, allocating it with all voxels unknown if needed
+   */
+  inline Brick & getBrick(unsigned int x, unsigned int y, unsigned int z)
+  {
+    int & index = brickIndex(x, y, z);
+    if (index == NO_BRICK) {
+      index = allocateBrick();
+    }
+    return bricks_[index];
+  }
+
+  /**
+   * @brief  Get the row of a voxel within a brick
+   */
+  static inline unsigned int brickRow(unsigned int y, unsigned int z)
+  {
+    return ((z & (BRICK_SIZE - 1)) << BRICK_BITS) | (y & (BRICK_SIZE - 1));
+  }
+
+  /**
+   * @brief  Allocate a brick with all voxels unknown
+   * @return Index of the brick
+   */
+  int allocateBrick();
+
+  inline void markVoxel(unsigned int x, unsigned int y, unsigned int z)
+  {
+    Brick & brick = getBrick(x, y, z);
+    const unsigned int row = brickRow(y, z);
+    const uint64_t bit = (uint64_t)1 << (x & (BRICK_SIZE - 1));
+    if (brick.marked[row] & bit) {
+      return;
+    }
+
+    const unsigned int column = y * size_x_ + x;
+    if (!(brick.known[row] & bit)) {
+      brick.known[row] |= bit;
+      known_counts_[column]++;
+    }
+    brick.marked[row] |= bit;
+    marked_counts_[column]++;
+  }
+
+  inline void clearVoxel(unsigned int x, unsigned int y, unsigned int z)
+  {
+    const unsigned int column = y * size_x_ + x;
+    Brick & brick = getBrick(x, y, z);
+    const unsigned int row = brickRow(y, z);
+    const uint64_t bit = (uint64_t)1 << (x & (BRICK_SIZE - 1));
+    if (brick.marked[row] & bit) {
+      brick.marked[row] &= ~bit;
+      marked_counts_[column]--;
+    } else if (!(brick.known[row] & bit)) {
+      brick.known[row] |= bit;
+      known_counts_[column]++;
+    }
+  }
+
+  /**
+   * @brief  The 3D Bresenham line of VoxelGrid::raytraceLine, applying an action to the
+   * coordinates of each voxel
+   */
+  template<class ActionType>
+  inline void raytraceLine(
+    ActionType at, double x0, double y0, double z0,
+    double x1, double y1, double z1, unsigned int max_length = UINT_MAX,
+    unsigned int min_length = 0)
+  {
+    double dist = sqrt((x0 - x1) * (x0 - x1) + (y0 - y1) * (y0 - y1) + (z0 - z1) * (z0 - z1));
+    if ((unsigned int)(dist) < min_length) {
+      return;
+    }
+    double scale, min_x0, min_y0, min_z0;
+    if (dist > 0.0) {
+      scale = std::min(1.0, max_length / dist);
+
+      // Updating starting point to the point at distance min_length from the initial point
+      min_x0 = x0 + (x1 - x0) / dist * min_length;
+      min_y0 = y0 + (y1 - y0) / dist * min_length;
+      min_z0 = z0 + (z1 - z0) / dist * min_length;
+    } else {
+      scale = 1.0;
+      min_x0 = x0;
+      min_y0 = y0;
+      min_z0 = z0;
+    }
+
+    int delta[3] = {
+      int(x1) - int(min_x0),  // NOLINT
+      int(y1) - int(min_y0),  // NOLINT
+      int(z1) - int(min_z0)  // NOLINT
+    };
+    int voxel[3] = {
+      static_cast<int>((unsigned int)min_x0),
+      static_cast<int>((unsigned int)min_y0),
+      static_cast<int>((unsigned int)min_z0)
+    };
+
+    // Order the axes by dominance, ties in the same order as VoxelGrid::raytraceLine
+    unsigned int a = 2, b = 0, c = 1;
+    const unsigned int abs_dx = std::abs(delta[0]);
+    const unsigned int abs_dy = std::abs(delta[1]);
+    const unsigned int abs_dz = std::abs(delta[2]);
+    if (abs_dx >= std::max(abs_dy, abs_dz)) {
+      a = 0, b = 1, c = 2;
+    } else if (abs_dy >= abs_dz) {
+      a = 1, b = 0, c = 2;
+    }
+
+    const unsigned int abs_da = std::abs(delta[a]);
+    const unsigned int abs_db = std::abs(delta[b]);
+    const unsigned int abs_dc = std::abs(delta[c]);
+    const int step_a = delta[a] > 0 ? 1 : -1;
+    const int step_b = delta[b] > 0 ? 1 : -1;
+    const int step_c = delta[c] > 0 ? 1 : -1;
+    int error_b = abs_da / 2;
+    int error_c = abs_da / 2;
+
+    const unsigned int end = std::min((unsigned int)(scale * abs_da), abs_da);
+    for (unsigned int i = 0; i < end; ++i) {
+      at(voxel[0], voxel[1], voxel[2]);
+      voxel[a] += step_a;
+      error_b += abs_db;
+      error_c += abs_dc;
+      if ((unsigned int)error_b >= abs_da) {
+        voxel[b] += step_b;
+        error_b -= abs_da;
+      }
+      if ((unsigned int)error_c >= abs_da) {
+        voxel[c] += step_c;
+        error_c -= abs_da;
+      }
+    }
+    at(voxel[0], voxel[1], voxel[2]);
+  }
+
+  class ClearVoxelInMap
+  {
+public:
+    ClearVoxelInMap(
+      SparseVoxelGrid & grid, unsigned char * costmap,
+      unsigned int unknown_clear_threshold, unsigned int marked_clear_threshold,
+      unsigned char free_cost, unsigned char unknown_cost)
+    : grid_(grid), costmap_(costmap),
+      unknown_clear_threshold_(unknown_clear_threshold),
+      marked_clear_threshold_(marked_clear_threshold),
+      free_cost_(free_cost), unknown_cost_(unknown_cost)
+    {
+    }
+
+    inline void operator()(unsigned int x, unsigned int y, unsigned int z)
+    {
+      grid_.clearVoxel(x, y, z);
+      if (costmap_ == NULL) {
+        return;
+      }
+
+      // make sure the number of voxels in each is below our thresholds
+      const unsigned int column = y * grid_.size_x_ + x;
+      if (grid_.marked_counts_[column] <= marked_clear_threshold_) {
+        const unsigned int unknown = grid_.size_z_ - grid_.known_counts_[column];
+        costmap_[column] = unknown <= unknown_clear_threshold_ ? free_cost_ : unknown_cost_;
+      }
+    }
+
+private:
+    SparseVoxelGrid & grid_;
+    unsigned char * costmap_;
+    unsigned int unknown_clear_threshold_, marked_clear_threshold_;
+    unsigned char free_cost_, unknown_cost_;
+  };
+
+  unsigned int size_x_, size_y_, size_z_;
+  unsigned int bricks_x_, bricks_y_, bricks_z_;
+
+  // Index of the brick in bricks_ of each brick location, NO_BRICK if unallocated
+  std::vector<int> brick_index_;
+  std::vector<Brick> bricks_;
+  std::vector<int> free_bricks_;
+
+  // Number of known and marked voxels of each column
+  std::vector<uint16_t> known_counts_;
+  std::vector<uint16_t> marked_counts_;
+
+  rclcpp::Logger logger;
+};
+
+}  // namespace nav2_voxel_grid
+
+#endif  // NAV2_VOXEL_GRID__SPARSE_VOXEL_GRID_HPP_
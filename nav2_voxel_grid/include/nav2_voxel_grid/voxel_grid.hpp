@@ -44,6 +44,7 @@
 #include <math.h>
 #include <limits.h>
 #include <algorithm>
+#include <vector>
 #include "rclcpp/rclcpp.hpp"
 
 /**
@@ -207,6 +208,24 @@ public:
     unsigned char free_cost = 0, unsigned char unknown_cost = 255,
     unsigned int max_length = UINT_MAX, unsigned int min_length = 0);
 
+  /**
+   * @brief  Clears the voxels of a line as clearVoxelLineInMap does, leaving the 2D map to
+   * updateClearedColumnsInMap. Lines may be cleared from several threads at once, the voxels
+   * being cleared atomically and the columns crossed recorded for the update of the map.
+   */
+  void clearVoxelLineConcurrently(
+    double x0, double y0, double z0, double x1, double y1, double z1,
+    unsigned int max_length = UINT_MAX, unsigned int min_length = 0);
+
+  /**
+   * @brief  Sets the costs of the columns crossed by clearVoxelLineConcurrently since the last
+   * call, to those clearVoxelLineInMap sets clearing the same lines one after the other.
+   * Must not be called while lines are cleared.
+   */
+  void updateClearedColumnsInMap(
+    unsigned char * map_2d, unsigned int unknown_threshold, unsigned int mark_threshold,
+    unsigned char free_cost = 0, unsigned char unknown_cost = 255);
+
   VoxelStatus getVoxel(unsigned int x, unsigned int y, unsigned int z);
 
   // Are there any obstacles at that (x, y) location in the grid?
@@ -339,6 +358,8 @@ private:
   uint32_t * data_;
   unsigned char * costmap;
   rclcpp::Logger logger;
+  // One bit per column crossed by clearVoxelLineConcurrently since its costs were last set
+  std::vector<uint32_t> cleared_columns_;
 
   // Aren't functors so much fun... used to recreate the Bresenham macro Eric
   // wrote in the original version, but in "proper" c++
@@ -370,6 +391,32 @@ private:
     uint32_t * data_;
   };
 
+  class ClearVoxelConcurrently
+  {
+public:
+    ClearVoxelConcurrently(uint32_t * data, uint32_t * cleared_columns)
+    : data_(data), cleared_columns_(cleared_columns) {}
+    inline void operator()(unsigned int offset, unsigned int z_mask)
+    {
+      // clear unknown and clear cell, the final column not depending on the order of the lines.
+      // Voxels and columns crossed by many lines are only written the first time.
+      uint32_t * col = &data_[offset];
+      if (__atomic_load_n(col, __ATOMIC_RELAXED) & z_mask) {
+        __atomic_fetch_and(col, ~z_mask, __ATOMIC_RELAXED);
+      }
+
+      uint32_t * word = &cleared_columns_[offset >> 5];
+      const uint32_t bit = 1u << (offset & 31);
+      if (!(__atomic_load_n(word, __ATOMIC_RELAXED) & bit)) {
+        __atomic_fetch_or(word, bit, __ATOMIC_RELAXED);
+      }
+    }
+
+private:
+    uint32_t * data_;
+    uint32_t * cleared_columns_;
+  };
+
   class ClearVoxelInMap
   {
 public:
@@ -0,0 +1,247 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "nav2_voxel_grid/sparse_voxel_grid.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace nav2_voxel_grid
+{
+
+SparseVoxelGrid::SparseVoxelGrid(unsigned int size_x, unsigned int size_y, unsigned int size_z)
+: size_x_(0), size_y_(0), size_z_(0), bricks_x_(0), bricks_y_(0), bricks_z_(0),
+  logger(rclcpp::get_logger("sparse_voxel_grid"))
+{
+  resize(size_x, size_y, size_z);
+}
+
+void SparseVoxelGrid::resize(unsigned int size_x, unsigned int size_y, unsigned int size_z)
+{
+  // Column counts are 16 bits
+  if (size_z > UINT16_MAX) {
+    RCLCPP_INFO(
+      logger, "Error, this implementation can only support up to %u z values (%u)",
+      UINT16_MAX, size_z);
+    size_z = UINT16_MAX;
+  }
+
+  size_x_ = size_x;
+  size_y_ = size_y;
+  size_z_ = size_z;
+  bricks_x_ = (size_x_ + BRICK_SIZE - 1) >> BRICK_BITS;
+  bricks_y_ = (size_y_ + BRICK_SIZE - 1) >> BRICK_BITS;
+  bricks_z_ = (size_z_ + BRICK_SIZE - 1) >> BRICK_BITS;
+  reset();
+}
+
+void SparseVoxelGrid::reset()
+{
+  brick_index_.assign(bricks_x_ * bricks_y_ * bricks_z_, NO_BRICK);
+  bricks_.clear();
+  free_bricks_.clear();
+  known_counts_.assign(size_x_ * size_y_, 0);
+  marked_counts_.assign(size_x_ * size_y_, 0);
+}
+
+int SparseVoxelGrid::allocateBrick()
+{
+  int index;
+  if (!free_bricks_.empty()) {
+    index = free_bricks_.back();
+    free_bricks_.pop_back();
+  } else {
+    index = bricks_.size();
+    bricks_.emplace_back();
+  }
+
+  bricks_[index].known.fill(0);
+  bricks_[index].marked.fill(0);
+  return index;
+}
+
+void SparseVoxelGrid::clearVoxelLineInMap(
+  double x0, double y0, double z0, double x1, double y1, double z1, unsigned char * map_2d,
+  unsigned int unknown_threshold, unsigned int mark_threshold, unsigned char free_cost,
+  unsigned char unknown_cost, unsigned int max_length, unsigned int min_length)
+{
+  if (x0 >= size_x_ || y0 >= size_y_ || z0 >= size_z_ || x1 >= size_x_ || y1 >= size_y_ ||
+    z1 >= size_z_)
+  {
+    RCLCPP_DEBUG(
+      logger,
+      "Error, line endpoint out of bounds. "
+      "(%.2f, %.2f, %.2f) to (%.2f, %.2f, %.2f),  size: (%d, %d, %d)",
+      x0, y0, z0, x1, y1, z1, size_x_, size_y_, size_z_);
+    return;
+  }
+
+  ClearVoxelInMap cvm(*this, map_2d, unknown_threshold, mark_threshold, free_cost, unknown_cost);
+  raytraceLine(cvm, x0, y0, z0, x1, y1, z1, max_length, min_length);
+}
+
+VoxelStatus SparseVoxelGrid::getVoxel(unsigned int x, unsigned int y, unsigned int z) const
+{
+  if (x >= size_x_ || y >= size_y_ || z >= size_z_) {
+    RCLCPP_DEBUG(logger, "Error, voxel out of bounds. (%d, %d, %d)\n", x, y, z);
+    return UNKNOWN;
+  }
+
+  const int index = brickIndex(x, y, z);
+  if (index == NO_BRICK) {
+    return UNKNOWN;
+  }
+
+  const Brick & brick = bricks_[index];
+  const unsigned int row = brickRow(y, z);
+  const uint64_t bit = (uint64_t)1 << (x & (BRICK_SIZE - 1));
+  if (brick.marked[row] & bit) {
+    return MARKED;
+  }
+  return (brick.known[row] & bit) ? FREE : UNKNOWN;
+}
+
+VoxelStatus SparseVoxelGrid::getVoxelColumn(
+  unsigned int x, unsigned int y,
+  unsigned int unknown_threshold, unsigned int marked_threshold) const
+{
+  if (x >= size_x_ || y >= size_y_) {
+    RCLCPP_DEBUG(logger, "Error, voxel out of bounds. (%d, %d)\n", x, y);
+    return UNKNOWN;
+  }
+
+  const unsigned int column = y * size_x_ + x;
+  if (marked_counts_[column] > marked_threshold) {
+    return MARKED;
+  }
+  if (size_z_ - known_counts_[column] > unknown_threshold) {
+    return UNKNOWN;
+  }
+  return FREE;
+}
+
+void SparseVoxelGrid::shift(int cell_ox, int cell_oy)
+{
+  const int size_x = size_x_;
+  const int size_y = size_y_;
+  std::vector<int> old_brick_index;
+  std::vector<Brick> old_bricks;
+  std::vector<uint16_t> old_known_counts, old_marked_counts;
+  old_brick_index.swap(brick_index_);
+  old_bricks.swap(bricks_);
+  old_known_counts.swap(known_counts_);
+  old_marked_counts.swap(marked_counts_);
+  reset();
+
+  // Column (x, y) in the new grid was column (x + cell_ox, y + cell_oy) in the old one
+  const int min_x = std::max(0, -cell_ox), max_x = std::min(size_x, size_x - cell_ox);
+  const int min_y = std::max(0, -cell_oy), max_y = std::min(size_y, size_y - cell_oy);
+  if (min_x >= max_x || min_y >= max_y) {
+    return;
+  }
+
+  for (int y = min_y; y < max_y; y++) {
+    const int old_row = (y + cell_oy) * size_x + cell_ox;
+    std::copy(
+      old_known_counts.begin() + old_row + min_x, old_known_counts.begin() + old_row + max_x,
+      known_counts_.begin() + y * size_x + min_x);
+    std::copy(
+      old_marked_counts.begin() + old_row + min_x, old_marked_counts.begin() + old_row + max_x,
+      marked_counts_.begin() + y * size_x + min_x);
+  }
+
+  // Move the known voxels of the allocated bricks, brick by brick
+  for (unsigned int bz = 0; bz < bricks_z_; bz++) {
+    for (unsigned int by = 0; by < bricks_y_; by++) {
+      for (unsigned int bx = 0; bx < bricks_x_; bx++) {
+        const int index = old_brick_index[(bz * bricks_y_ + by) * bricks_x_ + bx];
+        if (index == NO_BRICK) {
+          continue;
+        }
+
+        const Brick & old_brick = old_bricks[index];
+        for (unsigned int row = 0; row < BRICK_SIZE * BRICK_SIZE; row++) {
+          uint64_t known = old_brick.known[row];
+          const int y = static_cast<int>((by << BRICK_BITS) | (row & (BRICK_SIZE - 1))) - cell_oy;
+          if (!known || y < min_y || y >= max_y) {
+            continue;
+          }
+
+          const unsigned int z = (bz << BRICK_BITS) | (row >> BRICK_BITS);
+          while (known) {
+            const unsigned int lx = __builtin_ctzll(known);
+            known &= known - 1;
+            const int x = static_cast<int>((bx << BRICK_BITS) | lx) - cell_ox;
+            if (x < min_x || x >= max_x) {
+              continue;
+            }
+
+            Brick & brick = getBrick(x, y, z);
+            const unsigned int new_row = brickRow(y, z);
+            const uint64_t bit = (uint64_t)1 << (x & (BRICK_SIZE - 1));
+            brick.known[new_row] |= bit;
+            if (old_brick.marked[row] & ((uint64_t)1 << lx)) {
+              brick.marked[new_row] |= bit;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+void SparseVoxelGrid::getColumnData(uint32_t * data) const
+{
+  // Levels above the grid are unknown, as in VoxelGrid
+  const unsigned int levels = std::min(size_z_, 16u);
+  const uint32_t unknown_col = ~((uint32_t)0) >> 16;
+  std::fill(data, data + size_x_ * size_y_, unknown_col);
+
+  for (unsigned int bz = 0; bz < (levels + BRICK_SIZE - 1) >> BRICK_BITS; bz++) {
+    for (unsigned int by = 0; by < bricks_y_; by++) {
+      for (unsigned int bx = 0; bx < bricks_x_; bx++) {
+        const int index = brick_index_[(bz * bricks_y_ + by) * bricks_x_ + bx];
+        if (index == NO_BRICK) {
+          continue;
+        }
+
+        const Brick & brick = bricks_[index];
+        for (unsigned int row = 0; row < BRICK_SIZE * BRICK_SIZE; row++) {
+          const unsigned int y = (by << BRICK_BITS) | (row & (BRICK_SIZE - 1));
+          const unsigned int z = (bz << BRICK_BITS) | (row >> BRICK_BITS);
+          if (y >= size_y_ || z >= levels) {
+            continue;
+          }
+
+          uint64_t known = brick.known[row];
+          while (known) {
+            const unsigned int lx = __builtin_ctzll(known);
+            known &= known - 1;
+            const unsigned int x = (bx << BRICK_BITS) | lx;
+
+            // known marked: 11, unknown: 01, known free: 00
+            uint32_t & col = data[y * size_x_ + x];
+            if (brick.marked[row] & ((uint64_t)1 << lx)) {
+              col |= (uint32_t)1 << z << 16;
+            } else {
+              col &= ~((uint32_t)1 << z);
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace nav2_voxel_grid
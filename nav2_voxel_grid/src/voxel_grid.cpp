@@ -59,6 +59,7 @@ VoxelGrid::VoxelGrid(unsigned int size_x, unsigned int size_y, unsigned int size
     *col = unknown_col;
     ++col;
   }
+  cleared_columns_.assign((size_x_ * size_y_ + 31) / 32, 0);
 }
 
 void VoxelGrid::resize(unsigned int size_x, unsigned int size_y, unsigned int size_z)
@@ -88,6 +89,7 @@ void VoxelGrid::resize(unsigned int size_x, unsigned int size_y, unsigned int si
     *col = unknown_col;
     ++col;
   }
+  cleared_columns_.assign((size_x_ * size_y_ + 31) / 32, 0);
 }
 
 VoxelGrid::~VoxelGrid()
@@ -169,6 +171,57 @@ void VoxelGrid::clearVoxelLineInMap(
   raytraceLine(cvm, x0, y0, z0, x1, y1, z1, max_length, min_length);
 }
 
+void VoxelGrid::clearVoxelLineConcurrently(
+  double x0, double y0, double z0, double x1, double y1, double z1,
+  unsigned int max_length, unsigned int min_length)
+{
+  if (x0 >= size_x_ || y0 >= size_y_ || z0 >= size_z_ || x1 >= size_x_ || y1 >= size_y_ ||
+    z1 >= size_z_)
+  {
+    RCLCPP_DEBUG(
+      logger,
+      "Error, line endpoint out of bounds. "
+      "(%.2f, %.2f, %.2f) to (%.2f, %.2f, %.2f),  size: (%d, %d, %d)",
+      x0, y0, z0, x1, y1, z1, size_x_, size_y_, size_z_);
+    return;
+  }
+
+  ClearVoxelConcurrently cvc(data_, cleared_columns_.data());
+  raytraceLine(cvc, x0, y0, z0, x1, y1, z1, max_length, min_length);
+}
+
+void VoxelGrid::updateClearedColumnsInMap(
+  unsigned char * map_2d, unsigned int unknown_threshold, unsigned int mark_threshold,
+  unsigned char free_cost, unsigned char unknown_cost)
+{
+  // Voxels are only ever cleared, so clearing lines in order leaves each column crossed with
+  // the cost of its final state, set by the last line crossing it
+  for (unsigned int w = 0; w < cleared_columns_.size(); ++w) {
+    uint32_t word = cleared_columns_[w];
+    if (word == 0) {
+      continue;
+    }
+    cleared_columns_[w] = 0;
+    if (map_2d == NULL) {
+      continue;
+    }
+    for (; word; word &= word - 1) {
+      const unsigned int offset = w * 32 + __builtin_ctz(word);
+      const uint32_t col = data_[offset];
+      unsigned int unknown_bits = uint16_t(col >> 16) ^ uint16_t(col);
+      unsigned int marked_bits = col >> 16;
+
+      if (bitsBelowThreshold(marked_bits, mark_threshold)) {
+        if (bitsBelowThreshold(unknown_bits, unknown_threshold)) {
+          map_2d[offset] = free_cost;
+        } else {
+          map_2d[offset] = unknown_cost;
+        }
+      }
+    }
+  }
+}
+
 VoxelStatus VoxelGrid::getVoxel(unsigned int x, unsigned int y, unsigned int z)
 {
   if (x >= size_x_ || y >= size_y_ || z >= size_z_) {
@@ -0,0 +1,122 @@
+// Copyright (c) 2024 Open Navigation LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "nav2_voxel_grid/sparse_voxel_grid.hpp"
+#include "nav2_voxel_grid/voxel_grid.hpp"
+
+TEST(sparse_voxel_grid, MatchesVoxelGrid) {
+  const unsigned int size_x = 37, size_y = 29, size_z = 16;
+  std::mt19937 rng(3);
+  std::uniform_real_distribution<double> ux(0, size_x - 0.01);
+  std::uniform_real_distribution<double> uy(0, size_y - 0.01);
+  std::uniform_real_distribution<double> uz(0, size_z - 0.01);
+
+  for (int trial = 0; trial < 20; ++trial) {
+    nav2_voxel_grid::VoxelGrid dense(size_x, size_y, size_z);
+    nav2_voxel_grid::SparseVoxelGrid sparse(size_x, size_y, size_z);
+    std::vector<unsigned char> dense_map(size_x * size_y, 100);
+    std::vector<unsigned char> sparse_map(size_x * size_y, 100);
+    const unsigned int unknown_threshold = rng() % 17;
+    const unsigned int mark_threshold = rng() % 3;
+
+    for (int i = 0; i < 400; ++i) {
+      if (rng() % 2) {
+        unsigned int x = rng() % size_x, y = rng() % size_y, z = rng() % size_z;
+        EXPECT_EQ(
+          dense.markVoxelInMap(x, y, z, mark_threshold),
+          sparse.markVoxelInMap(x, y, z, mark_threshold));
+      } else {
+        double x0 = ux(rng), y0 = uy(rng), z0 = uz(rng);
+        double x1 = ux(rng), y1 = uy(rng), z1 = uz(rng);
+        unsigned int max_length = rng() % 3 ? UINT_MAX : rng() % 30;
+        unsigned int min_length = rng() % 3 ? 0 : rng() % 5;
+        dense.clearVoxelLineInMap(
+          x0, y0, z0, x1, y1, z1, dense_map.data(), unknown_threshold, mark_threshold,
+          0, 255, max_length, min_length);
+        sparse.clearVoxelLineInMap(
+          x0, y0, z0, x1, y1, z1, sparse_map.data(), unknown_threshold, mark_threshold,
+          0, 255, max_length, min_length);
+      }
+    }
+
+    ASSERT_EQ(dense_map, sparse_map);
+    std::vector<uint32_t> columns(size_x * size_y);
+    sparse.getColumnData(columns.data());
+    for (unsigned int y = 0; y < size_y; ++y) {
+      for (unsigned int x = 0; x < size_x; ++x) {
+        ASSERT_EQ(columns[y * size_x + x], dense.getData()[y * size_x + x]);
+        ASSERT_EQ(dense.getVoxelColumn(x, y, 8, 1), sparse.getVoxelColumn(x, y, 8, 1));
+        for (unsigned int z = 0; z < size_z; ++z) {
+          ASSERT_EQ(dense.getVoxel(x, y, z), sparse.getVoxel(x, y, z));
+        }
+      }
+    }
+  }
+}
+
+TEST(sparse_voxel_grid, TallGrid) {
+  // 2 m of height at 2 cm
+  nav2_voxel_grid::SparseVoxelGrid grid(200, 200, 100);
+  EXPECT_EQ(grid.numBricks(), 0u);
+  EXPECT_EQ(grid.getVoxel(10, 10, 99), nav2_voxel_grid::UNKNOWN);
+  EXPECT_EQ(grid.getVoxelColumn(10, 10, 99, 0), nav2_voxel_grid::UNKNOWN);
+
+  EXPECT_TRUE(grid.markVoxelInMap(10, 10, 99, 0));
+  EXPECT_FALSE(grid.markVoxelInMap(10, 10, 99, 1));
+  EXPECT_EQ(grid.getVoxel(10, 10, 99), nav2_voxel_grid::MARKED);
+  EXPECT_EQ(grid.numBricks(), 1u);
+
+  // Clear the full column, up to the marked voxel
+  unsigned char map_2d[200 * 200];
+  map_2d[10 * 200 + 10] = 254;
+  grid.clearVoxelLineInMap(10, 10, 0, 10, 10, 99.5, map_2d, 0, 0);
+  EXPECT_EQ(map_2d[10 * 200 + 10], 0);
+  EXPECT_EQ(grid.getVoxel(10, 10, 99), nav2_voxel_grid::FREE);
+  EXPECT_EQ(grid.getVoxelColumn(10, 10, 0, 0), nav2_voxel_grid::FREE);
+  EXPECT_EQ(grid.numBricks(), 13u);
+
+  grid.reset();
+  EXPECT_EQ(grid.numBricks(), 0u);
+  EXPECT_EQ(grid.getVoxel(10, 10, 99), nav2_voxel_grid::UNKNOWN);
+}
+
+TEST(sparse_voxel_grid, Shift) {
+  nav2_voxel_grid::SparseVoxelGrid grid(20, 20, 20);
+  grid.markVoxelInMap(5, 6, 17, 0);
+  grid.markVoxelInMap(1, 1, 1, 0);
+
+  grid.shift(3, -2);
+  EXPECT_EQ(grid.getVoxel(2, 8, 17), nav2_voxel_grid::MARKED);
+  EXPECT_EQ(grid.getVoxel(5, 6, 17), nav2_voxel_grid::UNKNOWN);
+  EXPECT_EQ(grid.getVoxelColumn(2, 8, 20, 0), nav2_voxel_grid::MARKED);
+  // (1, 1) was shifted out of the grid
+  for (unsigned int y = 0; y < 20; ++y) {
+    for (unsigned int x = 0; x < 20; ++x) {
+      if (x != 2 || y != 8) {
+        EXPECT_EQ(grid.getVoxelColumn(x, y, 19, 0), nav2_voxel_grid::UNKNOWN);
+      }
+    }
+  }
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -34,6 +34,10 @@
 *
 * Author: Eitan Marder-Eppstein
 *********************************************************************/
+#include <array>
+#include <random>
+#include <thread>
+#include <vector>
 #include <nav2_voxel_grid/voxel_grid.hpp>
 #include <gtest/gtest.h>
 
@@ -197,6 +201,55 @@ TEST(voxel_grid, GetVoxelData) {
   delete[] data;
 }
 
+TEST(voxel_grid, clearVoxelLineConcurrently) {
+  const unsigned int size_x = 100, size_y = 80, size_z = 16;
+  nav2_voxel_grid::VoxelGrid serial(size_x, size_y, size_z);
+  nav2_voxel_grid::VoxelGrid concurrent(size_x, size_y, size_z);
+  std::vector<unsigned char> serial_map(size_x * size_y, 100);
+  std::vector<unsigned char> concurrent_map(size_x * size_y, 100);
+
+  // Mark obstacles in both grids, some of which the lines clear
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<double> x_dist(0.0, size_x - 0.01);
+  std::uniform_real_distribution<double> y_dist(0.0, size_y - 0.01);
+  std::uniform_real_distribution<double> z_dist(0.0, size_z - 0.01);
+  for (int i = 0; i < 2000; ++i) {
+    const unsigned int x = x_dist(generator), y = y_dist(generator), z = z_dist(generator);
+    serial.markVoxel(x, y, z);
+    concurrent.markVoxel(x, y, z);
+  }
+
+  std::vector<std::array<double, 3>> ends(20000);
+  for (auto & end : ends) {
+    end = {x_dist(generator), y_dist(generator), z_dist(generator)};
+  }
+  for (const auto & end : ends) {
+    serial.clearVoxelLineInMap(
+      50.5, 40.5, 8.5, end[0], end[1], end[2], serial_map.data(), 14, 1, 0, 255, 60, 2);
+  }
+
+  const size_t num_threads = 4;
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < num_threads; ++t) {
+    threads.emplace_back(
+      [&, t]() {
+        for (size_t i = t; i < ends.size(); i += num_threads) {
+          concurrent.clearVoxelLineConcurrently(
+            50.5, 40.5, 8.5, ends[i][0], ends[i][1], ends[i][2], 60, 2);
+        }
+      });
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+  concurrent.updateClearedColumnsInMap(concurrent_map.data(), 14, 1, 0, 255);
+
+  for (unsigned int i = 0; i < size_x * size_y; ++i) {
+    ASSERT_EQ(serial.getData()[i], concurrent.getData()[i]);
+    ASSERT_EQ(serial_map[i], concurrent_map[i]);
+  }
+}
+
 int main(int argc, char ** argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -22,9 +22,13 @@
 #define _LIBCPP_NO_EXPERIMENTAL_DEPRECATION_WARNING_FILESYSTEM
 
 
+#include <condition_variable>
+#include <deque>
 #include <filesystem>
 #include <mutex>
 #include <string>
+#include <thread>
+#include <utility>
 #include <exception>
 
 #include "rclcpp/rclcpp.hpp"
@@ -94,6 +98,22 @@ public:
   static void deepCopyMsg2Mat(const sensor_msgs::msg::Image::SharedPtr & msg, cv::Mat & mat);
 
 protected:
+  /**
+   * @brief Converts and writes the queued images to disk, in the background
+   */
+  void writerLoop();
+
+  /**
+   * @brief Converts an image and writes it to disk
+   *
+   * @param msg image to write
+   * @param path of the image file
+   * @return true if the image was written
+   */
+  bool writeImage(
+    const sensor_msgs::msg::Image::SharedPtr & msg,
+    const std::filesystem::path & path);
+
   // to ensure safety when accessing global var curr_frame_
   std::mutex global_mutex_;
   // the taken photos will be saved under this directory
@@ -110,6 +130,16 @@ protected:
   rclcpp::Logger logger_{rclcpp::get_logger("nav2_waypoint_follower")};
   // ros subscriber to get camera image
   rclcpp::Subscription<sensor_msgs::msg::Image>::SharedPtr camera_image_subscriber_;
+  // whether the images are encoded and written on a background thread
+  bool async_write_;
+  // bound of the images waiting to be written, processAtWaypoint waits while it is reached
+  int max_queued_images_;
+  // images waiting to be written, with their file path
+  std::deque<std::pair<sensor_msgs::msg::Image::SharedPtr, std::filesystem::path>> write_queue_;
+  std::mutex write_mutex_;
+  std::condition_variable write_cv_;
+  bool writer_stop_{false};
+  std::thread writer_thread_;
 };
 }  // namespace nav2_waypoint_follower
 
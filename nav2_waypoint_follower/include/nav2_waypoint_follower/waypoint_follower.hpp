@@ -15,6 +15,8 @@
 #ifndef NAV2_WAYPOINT_FOLLOWER__WAYPOINT_FOLLOWER_HPP_
 #define NAV2_WAYPOINT_FOLLOWER__WAYPOINT_FOLLOWER_HPP_
 
+#include <deque>
+#include <future>
 #include <memory>
 #include <string>
 #include <vector>
@@ -58,6 +60,28 @@ struct GoalStatus
   int error_code;
 };
 
+/**
+ * @brief First order expansion of the fromLL conversion around a reference point,
+ * in map coordinates per degree of latitude and longitude
+ */
+struct LocalGPSConversion
+{
+  bool valid{false};
+  double latitude;
+  double longitude;
+  double altitude;
+  geometry_msgs::msg::Point origin;
+  geometry_msgs::msg::Point per_latitude;
+  geometry_msgs::msg::Point per_longitude;
+};
+
+struct PendingTask
+{
+  uint32_t index;
+  geometry_msgs::msg::PoseStamped pose;
+  std::shared_future<bool> executed;
+};
+
 /**
  * @class nav2_waypoint_follower::WaypointFollower
  * @brief An action server that uses behavior tree for navigating a robot to its
@@ -171,6 +195,26 @@ protected:
   std::vector<geometry_msgs::msg::PoseStamped> convertGPSPosesToMapPoses(
     const std::vector<geographic_msgs::msg::GeoPose> & gps_poses);
 
+  /**
+   * @brief converts a GPS point to map frame using robot_localization's service `fromLL`
+   *
+   * @param latitude, longitude, altitude of the GPS point
+   * @param map_point converted point
+   * @return true if the service converted the point
+   */
+  bool convertLLToMap(
+    const double latitude, const double longitude, const double altitude,
+    geometry_msgs::msg::Point & map_point);
+
+  /**
+   * @brief prepares local_gps_conversion_ around a GPS pose, reusing the previous one
+   * if the conversion of its reference point is unchanged
+   *
+   * @param reference GPS pose to convert around if a new conversion is needed
+   * @return true if local_gps_conversion_ is usable
+   */
+  bool updateLocalGPSConversion(const geographic_msgs::msg::GeoPose & reference);
+
 
   /**
    * @brief get the latest poses on the action server goal. If they are GPS poses,
@@ -183,6 +227,45 @@ protected:
   template<typename T>
   std::vector<geometry_msgs::msg::PoseStamped> getLatestGoalPoses(const T & action_server);
 
+  /**
+   * @brief Records the outcome of the task executed at a waypoint in the result
+   *
+   * @param result, of the action
+   * @param index of the waypoint
+   * @param pose of the waypoint
+   * @param is_task_executed whether the task execution succeeded
+   * @return false if the task failed and stop_on_failure is set
+   */
+  template<typename Z>
+  bool handleTaskResult(
+    const Z & result, const uint32_t index,
+    const geometry_msgs::msg::PoseStamped & pose, const bool is_task_executed);
+
+  /**
+   * @brief Starts the task at a waypoint in the background, after the tasks at the
+   * previous waypoints, while the robot proceeds to the next waypoint
+   *
+   * @param pose of the waypoint
+   * @param index of the waypoint
+   */
+  void queueTask(const geometry_msgs::msg::PoseStamped & pose, const uint32_t index);
+
+  /**
+   * @brief Records the outcome of the background tasks that finished, in arrival order,
+   * waiting for the oldest ones while more than max_pending are left
+   *
+   * @param result, of the action
+   * @param max_pending Number of tasks left running
+   * @return false if a task failed and stop_on_failure is set
+   */
+  template<typename Z>
+  bool collectTaskResults(const Z & result, const size_t max_pending);
+
+  /**
+   * @brief Waits for the background tasks, discarding their outcome
+   */
+  void clearTasks();
+
   // Common vars used for both GPS and cartesian point following
   std::vector<int> failed_ids_;
   std::string global_frame_id_{"map"};
@@ -208,11 +291,20 @@ protected:
   std::unique_ptr<ActionServerGPS> gps_action_server_;
   std::unique_ptr<nav2_util::ServiceClient<robot_localization::srv::FromLL,
     std::shared_ptr<nav2_util::LifecycleNode>>> from_ll_to_map_client_;
+  // Converts the GPS waypoints near a reference locally rather than one service call each
+  bool gps_local_conversion_;
+  double gps_local_conversion_radius_;
+  LocalGPSConversion local_gps_conversion_;
 
   bool stop_on_failure_;
   int loop_rate_;
   GoalStatus current_goal_status_;
 
+  // Tasks at waypoints executed while navigating to the next ones
+  bool async_task_execution_;
+  int max_pending_tasks_;
+  std::deque<PendingTask> pending_tasks_;
+
   // Task Execution At Waypoint Plugin
   pluginlib::ClassLoader<nav2_core::WaypointTaskExecutor>
   waypoint_task_executor_loader_;
@@ -14,8 +14,10 @@
 
 #include "nav2_waypoint_follower/plugins/photo_at_waypoint.hpp"
 
+#include <algorithm>
 #include <string>
 #include <memory>
+#include <utility>
 
 #include "pluginlib/class_list_macros.hpp"
 
@@ -29,6 +31,14 @@ PhotoAtWaypoint::PhotoAtWaypoint()
 
 PhotoAtWaypoint::~PhotoAtWaypoint()
 {
+  if (writer_thread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(write_mutex_);
+      writer_stop_ = true;
+    }
+    write_cv_.notify_all();
+    writer_thread_.join();
+  }
 }
 
 void PhotoAtWaypoint::initialize(
@@ -51,12 +61,21 @@ void PhotoAtWaypoint::initialize(
   nav2_util::declare_parameter_if_not_declared(
     node, plugin_name + ".image_format",
     rclcpp::ParameterValue("png"));
+  nav2_util::declare_parameter_if_not_declared(
+    node, plugin_name + ".async_write",
+    rclcpp::ParameterValue(false));
+  nav2_util::declare_parameter_if_not_declared(
+    node, plugin_name + ".max_queued_images",
+    rclcpp::ParameterValue(10));
 
   std::string save_dir_as_string;
   node->get_parameter(plugin_name + ".enabled", is_enabled_);
   node->get_parameter(plugin_name + ".image_topic", image_topic_);
   node->get_parameter(plugin_name + ".save_dir", save_dir_as_string);
   node->get_parameter(plugin_name + ".image_format", image_format_);
+  node->get_parameter(plugin_name + ".async_write", async_write_);
+  node->get_parameter(plugin_name + ".max_queued_images", max_queued_images_);
+  max_queued_images_ = std::max(1, max_queued_images_);
 
   // get inputted save directory and make sure it exists, if not log and create  it
   save_dir_ = save_dir_as_string;
@@ -95,6 +114,9 @@ void PhotoAtWaypoint::initialize(
     camera_image_subscriber_ = node->create_subscription<sensor_msgs::msg::Image>(
       image_topic_, rclcpp::SystemDefaultsQoS(),
       std::bind(&PhotoAtWaypoint::imageCallback, this, std::placeholders::_1));
+    if (async_write_) {
+      writer_thread_ = std::thread(&PhotoAtWaypoint::writerLoop, this);
+    }
   }
 }
 
@@ -115,11 +137,37 @@ bool PhotoAtWaypoint::processAtWaypoint(
       std::to_string(curr_pose.header.stamp.sec) + "." + image_format_;
     std::filesystem::path full_path_image_path = save_dir_ / file_name;
 
+    // images are not modified once received, so holding on to the latest one takes the photo
+    sensor_msgs::msg::Image::SharedPtr curr_frame_msg;
+    {
+      std::lock_guard<std::mutex> guard(global_mutex_);
+      curr_frame_msg = curr_frame_msg_;
+    }
+    if (curr_frame_msg->data.empty()) {
+      throw std::runtime_error("No image received yet");
+    }
+
+    if (async_write_) {
+      // the encoding and writing is left to the writer thread, waiting for room if it lags
+      std::unique_lock<std::mutex> lock(write_mutex_);
+      write_cv_.wait(
+        lock, [this]() {
+          return write_queue_.size() < static_cast<size_t>(max_queued_images_);
+        });
+      write_queue_.emplace_back(curr_frame_msg, full_path_image_path);
+      lock.unlock();
+      write_cv_.notify_all();
+      RCLCPP_INFO(
+        logger_,
+        "Photo has been taken sucessfully at waypoint %i, queued for writing",
+        curr_waypoint_index);
+      return true;
+    }
+
     // save the taken photo at this waypoint to given directory
-    std::lock_guard<std::mutex> guard(global_mutex_);
-    cv::Mat curr_frame_mat;
-    deepCopyMsg2Mat(curr_frame_msg_, curr_frame_mat);
-    cv::imwrite(full_path_image_path.c_str(), curr_frame_mat);
+    if (!writeImage(curr_frame_msg, full_path_image_path)) {
+      throw std::runtime_error("Failed to write " + full_path_image_path.string());
+    }
     RCLCPP_INFO(
       logger_,
       "Photo has been taken sucessfully at waypoint %i", curr_waypoint_index);
@@ -135,6 +183,43 @@ bool PhotoAtWaypoint::processAtWaypoint(
   return true;
 }
 
+bool PhotoAtWaypoint::writeImage(
+  const sensor_msgs::msg::Image::SharedPtr & msg,
+  const std::filesystem::path & path)
+{
+  cv::Mat curr_frame_mat;
+  deepCopyMsg2Mat(msg, curr_frame_mat);
+  return cv::imwrite(path.c_str(), curr_frame_mat);
+}
+
+void PhotoAtWaypoint::writerLoop()
+{
+  std::unique_lock<std::mutex> lock(write_mutex_);
+  while (true) {
+    write_cv_.wait(lock, [this]() {return writer_stop_ || !write_queue_.empty();});
+    // the queued images are still written when stopping
+    if (write_queue_.empty()) {
+      return;
+    }
+
+    auto image = std::move(write_queue_.front());
+    write_queue_.pop_front();
+    lock.unlock();
+    write_cv_.notify_all();
+
+    try {
+      if (!writeImage(image.first, image.second)) {
+        RCLCPP_ERROR(logger_, "Failed to write photo %s", image.second.c_str());
+      }
+    } catch (const std::exception & e) {
+      RCLCPP_ERROR(
+        logger_, "Couldn't write photo %s! Caught exception: %s",
+        image.second.c_str(), e.what());
+    }
+    lock.lock();
+  }
+}
+
 void PhotoAtWaypoint::imageCallback(const sensor_msgs::msg::Image::SharedPtr msg)
 {
   std::lock_guard<std::mutex> guard(global_mutex_);
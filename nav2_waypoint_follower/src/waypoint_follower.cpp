@@ -14,6 +14,9 @@
 
 #include "nav2_waypoint_follower/waypoint_follower.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <fstream>
 #include <memory>
 #include <streambuf>
@@ -41,6 +44,12 @@ WaypointFollower::WaypointFollower(const rclcpp::NodeOptions & options)
 
   declare_parameter("global_frame_id", "map");
 
+  declare_parameter("async_task_execution", false);
+  declare_parameter("max_pending_tasks", 3);
+
+  declare_parameter("gps_local_conversion", false);
+  declare_parameter("gps_local_conversion_radius", 1000.0);
+
   nav2_util::declare_parameter_if_not_declared(
     this, std::string("waypoint_task_executor_plugin"),
     rclcpp::ParameterValue(std::string("wait_at_waypoint")));
@@ -51,6 +60,7 @@ WaypointFollower::WaypointFollower(const rclcpp::NodeOptions & options)
 
 WaypointFollower::~WaypointFollower()
 {
+  clearTasks();
 }
 
 nav2_util::CallbackReturn
@@ -65,6 +75,11 @@ WaypointFollower::on_configure(const rclcpp_lifecycle::State & /*state*/)
   waypoint_task_executor_id_ = get_parameter("waypoint_task_executor_plugin").as_string();
   global_frame_id_ = get_parameter("global_frame_id").as_string();
   global_frame_id_ = nav2_util::strip_leading_slash(global_frame_id_);
+  async_task_execution_ = get_parameter("async_task_execution").as_bool();
+  max_pending_tasks_ = std::max(1, static_cast<int>(get_parameter("max_pending_tasks").as_int()));
+  gps_local_conversion_ = get_parameter("gps_local_conversion").as_bool();
+  gps_local_conversion_radius_ = get_parameter("gps_local_conversion_radius").as_double();
+  local_gps_conversion_.valid = false;
 
   callback_group_ = create_callback_group(
     rclcpp::CallbackGroupType::MutuallyExclusive,
@@ -166,6 +181,7 @@ WaypointFollower::on_cleanup(const rclcpp_lifecycle::State & /*state*/)
 {
   RCLCPP_INFO(get_logger(), "Cleaning up");
 
+  clearTasks();
   xyz_action_server_.reset();
   nav_to_pose_client_.reset();
   gps_action_server_.reset();
@@ -205,6 +221,90 @@ std::vector<geometry_msgs::msg::PoseStamped> WaypointFollower::getLatestGoalPose
   return poses;
 }
 
+template<typename Z>
+bool WaypointFollower::handleTaskResult(
+  const Z & result, const uint32_t index,
+  const geometry_msgs::msg::PoseStamped & pose, const bool is_task_executed)
+{
+  RCLCPP_INFO(
+    get_logger(), "Task execution at waypoint %i %s", index,
+    is_task_executed ? "succeeded" : "failed!");
+
+  if (!is_task_executed) {
+    nav2_msgs::msg::MissedWaypoint missedWaypoint;
+    missedWaypoint.index = index;
+    missedWaypoint.goal = pose;
+    missedWaypoint.error_code =
+      nav2_msgs::action::FollowWaypoints::Result::TASK_EXECUTOR_FAILED;
+    result->missed_waypoints.push_back(missedWaypoint);
+  }
+  // if task execution was failed and stop_on_failure_ is on , terminate action
+  if (!is_task_executed && stop_on_failure_) {
+    RCLCPP_WARN(
+      get_logger(), "Failed to execute task at waypoint %i "
+      " stop on failure is enabled."
+      " Terminating action.", index);
+    return false;
+  }
+
+  RCLCPP_INFO(
+    get_logger(), "Handled task execution on waypoint %i,"
+    " moving to next.", index);
+  return true;
+}
+
+void WaypointFollower::queueTask(
+  const geometry_msgs::msg::PoseStamped & pose, const uint32_t index)
+{
+  // Tasks run one at a time in arrival order, as plugins are not required to be reentrant
+  std::shared_future<bool> previous;
+  if (!pending_tasks_.empty()) {
+    previous = pending_tasks_.back().executed;
+  }
+
+  PendingTask task;
+  task.index = index;
+  task.pose = pose;
+  task.executed = std::async(
+    std::launch::async, [this, previous, pose, index]() {
+      if (previous.valid()) {
+        previous.wait();
+      }
+      return waypoint_task_executor_->processAtWaypoint(pose, static_cast<int>(index));
+    }).share();
+  pending_tasks_.push_back(std::move(task));
+}
+
+template<typename Z>
+bool WaypointFollower::collectTaskResults(const Z & result, const size_t max_pending)
+{
+  while (!pending_tasks_.empty()) {
+    PendingTask & task = pending_tasks_.front();
+    if (pending_tasks_.size() <= max_pending &&
+      task.executed.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+      break;
+    }
+
+    const bool is_task_executed = task.executed.get();
+    const uint32_t index = task.index;
+    const geometry_msgs::msg::PoseStamped pose = task.pose;
+    pending_tasks_.pop_front();
+    if (!handleTaskResult(result, index, pose, is_task_executed)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void WaypointFollower::clearTasks()
+{
+  for (auto & task : pending_tasks_) {
+    task.executed.wait();
+  }
+  pending_tasks_.clear();
+}
+
 template<typename T, typename V, typename Z>
 void WaypointFollower::followWaypointsHandler(
   const T & action_server,
@@ -252,6 +352,7 @@ void WaypointFollower::followWaypointsHandler(
       callback_group_executor_.spin_until_future_complete(cancel_future);
       // for result callback processing
       callback_group_executor_.spin_some();
+      clearTasks();
       action_server->terminate_all();
       return;
     }
@@ -259,6 +360,8 @@ void WaypointFollower::followWaypointsHandler(
     // Check if asked to process another action
     if (action_server->is_preempt_requested()) {
       RCLCPP_INFO(get_logger(), "Preempting the goal pose.");
+      // The outcome of the tasks of the previous goal is still reported
+      collectTaskResults(result, 0);
       goal = action_server->accept_pending_goal();
       poses = getLatestGoalPoses<T>(action_server);
       if (poses.empty()) {
@@ -311,6 +414,7 @@ void WaypointFollower::followWaypointsHandler(
           get_logger(), "Failed to process waypoint %i in waypoint "
           "list and stop on failure is enabled."
           " Terminating action.", goal_index);
+        clearTasks();
         action_server->terminate_current(result);
         current_goal_status_.error_code = 0;
         return;
@@ -323,43 +427,47 @@ void WaypointFollower::followWaypointsHandler(
       RCLCPP_INFO(
         get_logger(), "Succeeded processing waypoint %i, processing waypoint task execution",
         goal_index);
-      bool is_task_executed = waypoint_task_executor_->processAtWaypoint(
-        poses[goal_index], goal_index);
-      RCLCPP_INFO(
-        get_logger(), "Task execution at waypoint %i %s", goal_index,
-        is_task_executed ? "succeeded" : "failed!");
-
-      if (!is_task_executed) {
-        nav2_msgs::msg::MissedWaypoint missedWaypoint;
-        missedWaypoint.index = goal_index;
-        missedWaypoint.goal = poses[goal_index];
-        missedWaypoint.error_code =
-          nav2_msgs::action::FollowWaypoints::Result::TASK_EXECUTOR_FAILED;
-        result->missed_waypoints.push_back(missedWaypoint);
+      bool is_task_handled;
+      if (async_task_execution_) {
+        // Bound the tasks left behind the robot
+        is_task_handled = collectTaskResults(result, max_pending_tasks_ - 1);
+        if (is_task_handled) {
+          queueTask(poses[goal_index], goal_index);
+        }
+      } else {
+        bool is_task_executed = waypoint_task_executor_->processAtWaypoint(
+          poses[goal_index], goal_index);
+        is_task_handled = handleTaskResult(result, goal_index, poses[goal_index], is_task_executed);
       }
-      // if task execution was failed and stop_on_failure_ is on , terminate action
-      if (!is_task_executed && stop_on_failure_) {
-        RCLCPP_WARN(
-          get_logger(), "Failed to execute task at waypoint %i "
-          " stop on failure is enabled."
-          " Terminating action.", goal_index);
 
+      if (!is_task_handled) {
+        clearTasks();
         action_server->terminate_current(result);
         current_goal_status_.error_code = 0;
         return;
-      } else {
-        RCLCPP_INFO(
-          get_logger(), "Handled task execution on waypoint %i,"
-          " moving to next.", goal_index);
       }
     }
 
+    // Record the background tasks which finished meanwhile
+    if (!collectTaskResults(result, pending_tasks_.size())) {
+      clearTasks();
+      action_server->terminate_current(result);
+      current_goal_status_.error_code = 0;
+      return;
+    }
+
     if (current_goal_status_.status != ActionStatus::PROCESSING) {
       // Update server state
       goal_index++;
       new_goal = true;
       if (goal_index >= poses.size()) {
         if (current_loop_no == no_of_loops) {
+          if (!collectTaskResults(result, 0)) {
+            clearTasks();
+            action_server->terminate_current(result);
+            current_goal_status_.error_code = 0;
+            return;
+          }
           RCLCPP_INFO(
             get_logger(), "Completed all %zu waypoints requested.",
             poses.size());
@@ -459,10 +567,20 @@ WaypointFollower::dynamicParametersCallback(std::vector<rclcpp::Parameter> param
     if (type == ParameterType::PARAMETER_INTEGER) {
       if (name == "loop_rate") {
         loop_rate_ = parameter.as_int();
+      } else if (name == "max_pending_tasks") {
+        max_pending_tasks_ = std::max(1, static_cast<int>(parameter.as_int()));
       }
     } else if (type == ParameterType::PARAMETER_BOOL) {
       if (name == "stop_on_failure") {
         stop_on_failure_ = parameter.as_bool();
+      } else if (name == "async_task_execution") {
+        async_task_execution_ = parameter.as_bool();
+      } else if (name == "gps_local_conversion") {
+        gps_local_conversion_ = parameter.as_bool();
+      }
+    } else if (type == ParameterType::PARAMETER_DOUBLE) {
+      if (name == "gps_local_conversion_radius") {
+        gps_local_conversion_radius_ = parameter.as_double();
       }
     }
   }
@@ -480,16 +598,38 @@ WaypointFollower::convertGPSPosesToMapPoses(
     global_frame_id_.c_str());
 
   std::vector<geometry_msgs::msg::PoseStamped> poses_in_map_frame_vector;
+  poses_in_map_frame_vector.reserve(gps_poses.size());
+  const bool use_local_conversion =
+    gps_local_conversion_ && !gps_poses.empty() && updateLocalGPSConversion(gps_poses.front());
+  const LocalGPSConversion & conv = local_gps_conversion_;
+  int local_conversions = 0;
+
   int waypoint_index = 0;
   for (auto && curr_geopose : gps_poses) {
-    auto request = std::make_shared<robot_localization::srv::FromLL::Request>();
-    auto response = std::make_shared<robot_localization::srv::FromLL::Response>();
-    request->ll_point.latitude = curr_geopose.position.latitude;
-    request->ll_point.longitude = curr_geopose.position.longitude;
-    request->ll_point.altitude = curr_geopose.position.altitude;
-
-    from_ll_to_map_client_->wait_for_service((std::chrono::seconds(1)));
-    if (!from_ll_to_map_client_->invoke(request, response)) {
+    geometry_msgs::msg::Point map_point;
+    bool converted = false;
+    if (use_local_conversion) {
+      const double d_lat = curr_geopose.position.latitude - conv.latitude;
+      const double d_lon = curr_geopose.position.longitude - conv.longitude;
+      const double dx = conv.per_latitude.x * d_lat + conv.per_longitude.x * d_lon;
+      const double dy = conv.per_latitude.y * d_lat + conv.per_longitude.y * d_lon;
+      // The error of the expansion grows with the distance from the reference
+      if (std::hypot(dx, dy) <= gps_local_conversion_radius_) {
+        map_point.x = conv.origin.x + dx;
+        map_point.y = conv.origin.y + dy;
+        map_point.z = conv.origin.z +
+          conv.per_latitude.z * d_lat + conv.per_longitude.z * d_lon +
+          (curr_geopose.position.altitude - conv.altitude);
+        converted = true;
+        local_conversions++;
+      }
+    }
+
+    if (!converted &&
+      !convertLLToMap(
+        curr_geopose.position.latitude, curr_geopose.position.longitude,
+        curr_geopose.position.altitude, map_point))
+    {
       RCLCPP_ERROR(
         this->get_logger(),
         "fromLL service of robot_localization could not convert %i th GPS waypoint to"
@@ -510,7 +650,7 @@ WaypointFollower::convertGPSPosesToMapPoses(
       geometry_msgs::msg::PoseStamped curr_pose_map_frame;
       curr_pose_map_frame.header.frame_id = global_frame_id_;
       curr_pose_map_frame.header.stamp = this->now();
-      curr_pose_map_frame.pose.position = response->map_point;
+      curr_pose_map_frame.pose.position = map_point;
       curr_pose_map_frame.pose.orientation = curr_geopose.orientation;
       poses_in_map_frame_vector.push_back(curr_pose_map_frame);
     }
@@ -518,11 +658,75 @@ WaypointFollower::convertGPSPosesToMapPoses(
   }
   RCLCPP_INFO(
     this->get_logger(),
-    "Converted all %i GPS waypoint to %s frame",
-    static_cast<int>(poses_in_map_frame_vector.size()), global_frame_id_.c_str());
+    "Converted all %i GPS waypoint to %s frame, %i of them locally",
+    static_cast<int>(poses_in_map_frame_vector.size()), global_frame_id_.c_str(),
+    local_conversions);
   return poses_in_map_frame_vector;
 }
 
+bool WaypointFollower::convertLLToMap(
+  const double latitude, const double longitude, const double altitude,
+  geometry_msgs::msg::Point & map_point)
+{
+  auto request = std::make_shared<robot_localization::srv::FromLL::Request>();
+  auto response = std::make_shared<robot_localization::srv::FromLL::Response>();
+  request->ll_point.latitude = latitude;
+  request->ll_point.longitude = longitude;
+  request->ll_point.altitude = altitude;
+
+  from_ll_to_map_client_->wait_for_service((std::chrono::seconds(1)));
+  if (!from_ll_to_map_client_->invoke(request, response)) {
+    return false;
+  }
+  map_point = response->map_point;
+  return true;
+}
+
+bool WaypointFollower::updateLocalGPSConversion(const geographic_msgs::msg::GeoPose & reference)
+{
+  // About 100 m, short enough for the expansion to hold and long enough for precision
+  const double step = 1e-3;
+  LocalGPSConversion & conv = local_gps_conversion_;
+
+  // The previous conversion holds as long as the datum did not move its reference point
+  if (conv.valid) {
+    geometry_msgs::msg::Point origin;
+    if (!convertLLToMap(conv.latitude, conv.longitude, conv.altitude, origin)) {
+      conv.valid = false;
+      return false;
+    }
+    if (std::hypot(origin.x - conv.origin.x, origin.y - conv.origin.y) < 1e-3 &&
+      std::fabs(origin.z - conv.origin.z) < 1e-3)
+    {
+      return true;
+    }
+  }
+
+  conv.valid = false;
+  conv.latitude = reference.position.latitude;
+  conv.longitude = reference.position.longitude;
+  conv.altitude = reference.position.altitude;
+  geometry_msgs::msg::Point north, east;
+  if (!convertLLToMap(conv.latitude, conv.longitude, conv.altitude, conv.origin) ||
+    !convertLLToMap(conv.latitude + step, conv.longitude, conv.altitude, north) ||
+    !convertLLToMap(conv.latitude, conv.longitude + step, conv.altitude, east))
+  {
+    RCLCPP_WARN(
+      get_logger(), "Could not prepare the local conversion of GPS waypoints, "
+      "converting each of them with the fromLL service.");
+    return false;
+  }
+
+  conv.per_latitude.x = (north.x - conv.origin.x) / step;
+  conv.per_latitude.y = (north.y - conv.origin.y) / step;
+  conv.per_latitude.z = (north.z - conv.origin.z) / step;
+  conv.per_longitude.x = (east.x - conv.origin.x) / step;
+  conv.per_longitude.y = (east.y - conv.origin.y) / step;
+  conv.per_longitude.z = (east.z - conv.origin.z) / step;
+  conv.valid = true;
+  return true;
+}
+
 }  // namespace nav2_waypoint_follower
 
 #include "rclcpp_components/register_node_macro.hpp"
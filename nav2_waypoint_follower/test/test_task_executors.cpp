@@ -14,6 +14,7 @@
 
 #include <math.h>
 #include <condition_variable>
+#include <filesystem>
 #include <memory>
 #include <string>
 #include <vector>
@@ -155,6 +156,19 @@ TEST(WaypointFollowerTest, PhotoAtWaypoint)
   EXPECT_TRUE(paw->processAtWaypoint(pose, 0));
   t1.join();
 
+  // writes the image on the background thread, done at the latest on destruction
+  std::filesystem::remove("/tmp/waypoint_images/1_0.png");
+  paw.reset(new nav2_waypoint_follower::PhotoAtWaypoint);
+  node->set_parameter(rclcpp::Parameter("PAW.async_write", true));
+  paw->initialize(node, std::string("PAW"));
+  EXPECT_FALSE(paw->processAtWaypoint(pose, 1));
+  lck.unlock();
+  std::thread t2(publish_message);
+  t2.join();
+  EXPECT_TRUE(paw->processAtWaypoint(pose, 1));
+  paw.reset();
+  EXPECT_TRUE(std::filesystem::exists("/tmp/waypoint_images/1_0.png"));
+
   paw.reset(new nav2_waypoint_follower::PhotoAtWaypoint);
   node->set_parameter(rclcpp::Parameter("PAW.enabled", false));
   paw->initialize(node, std::string("PAW"));